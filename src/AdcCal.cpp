@@ -0,0 +1,69 @@
+#include "AdcCal.h"
+
+/**
+ * AdcCal - Implementation
+ *
+ * @file AdcCal.cpp
+ */
+
+#define SEGMENT (1u << ADC_CAL_LUT_SHIFT)
+
+static uint16_t clamp_mv(int64_t mv) {
+    return (uint16_t)(mv < 0 ? 0 : (mv > 0xFFFF ? 0xFFFF : mv));
+}
+
+// ============================================================================
+// Table
+// ============================================================================
+
+void AdcCal_build(AdcCalLut* lut, AdcCalCurve curve, void* ctx) {
+    for (uint16_t i = 0; i + 1 < ADC_CAL_LUT_POINTS; i++)
+        lut->mv[i] = clamp_mv(curve((uint32_t)i * SEGMENT, ctx));
+
+    // Code 4096 does not exist: continue the slope of the last segment
+    int64_t top = curve(ADC_CAL_RAW_MAX, ctx);
+    int64_t start = lut->mv[ADC_CAL_LUT_POINTS - 2];
+    int64_t span = ADC_CAL_RAW_MAX - (ADC_CAL_LUT_POINTS - 2) * SEGMENT;
+    lut->mv[ADC_CAL_LUT_POINTS - 1] = clamp_mv(start + ((top - start) * SEGMENT + span / 2) / span);
+}
+
+static uint32_t linear_curve(uint32_t raw, void* ctx) {
+    uint32_t fullScale = *(const uint16_t*)ctx;
+    return (raw * fullScale + ADC_CAL_RAW_MAX / 2) / ADC_CAL_RAW_MAX;
+}
+
+void AdcCal_buildLinear(AdcCalLut* lut, uint16_t fullScaleMv) {
+    AdcCal_build(lut, linear_curve, &fullScaleMv);
+}
+
+// ============================================================================
+// Conversion
+// ============================================================================
+
+uint16_t AdcCal_toMillivolts(const AdcCalLut* lut, uint16_t raw) {
+    if (raw > ADC_CAL_RAW_MAX)
+        raw = ADC_CAL_RAW_MAX;
+    uint16_t i = raw >> ADC_CAL_LUT_SHIFT;
+    int32_t lo = lut->mv[i];
+    int32_t hi = lut->mv[i + 1];
+    int32_t frac = raw & (SEGMENT - 1);
+    return (uint16_t)(lo + (((hi - lo) * frac + (int32_t)(SEGMENT / 2)) >> ADC_CAL_LUT_SHIFT));
+}
+
+uint16_t AdcCal_average(uint32_t sum, uint8_t count) {
+    if (count == 0)
+        return 0;
+    return (uint16_t)((sum + count / 2) / count);
+}
+
+uint8_t AdcCal_sanitizeOversample(uint8_t samples) {
+    if (samples < 1)
+        return 1;
+    return samples > ADC_CAL_MAX_OVERSAMPLE ? ADC_CAL_MAX_OVERSAMPLE : samples;
+}
+
+uint16_t AdcCal_scale(uint16_t mv, uint16_t num, uint16_t den) {
+    if (den == 0)
+        return 0xFFFF;
+    return clamp_mv(((uint64_t)mv * num + den / 2) / den);
+}
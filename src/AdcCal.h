@@ -0,0 +1,79 @@
+#ifndef ADC_CAL_H
+#define ADC_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * AdcCal - Integer linearization of 12-bit ADC codes to millivolts
+ *
+ * The ESP32 ADC is neither linear nor does it share one reference
+ * between chips: with 11 dB attenuation a fixed "code / 4095 * 3.3 V"
+ * is off by 100-200 mV, most of it at the top of the range. The chip's
+ * eFuse holds a per-unit characterization (two-point or measured Vref)
+ * that esp_adc_cal turns into a calibrated curve, but evaluating that
+ * curve costs a 64-bit multiply and, at 11 dB, a LUT interpolation per
+ * sample.
+ *
+ * At boot the curve is sampled once per channel into a table of
+ * ADC_CAL_LUT_POINTS knots, one every 64 codes; a conversion is then a
+ * table read and a shift:
+ *
+ *   mv = lut[raw >> 6] + ((lut[(raw >> 6) + 1] - lut[raw >> 6]) * (raw & 63)) >> 6
+ *
+ * The last knot (code 4096) is extrapolated from the end of the curve.
+ * Samples are averaged before conversion (oversampling) with rounding,
+ * and a divider ratio is applied as an integer fraction.
+ *
+ * Pure: no globals, no RTOS. The curve is a callback so tests (and a
+ * chip without eFuse data) can supply their own.
+ *
+ * @file AdcCal.h
+ */
+
+#define ADC_CAL_RAW_MAX         4095
+#define ADC_CAL_LUT_SHIFT       6
+#define ADC_CAL_LUT_POINTS      ((ADC_CAL_RAW_MAX + 1) / (1 << ADC_CAL_LUT_SHIFT) + 1)  // 65
+#define ADC_CAL_MAX_OVERSAMPLE  64      // Samples averaged per reading
+
+/**
+ * Calibrated millivolts of one raw code
+ */
+typedef uint32_t (*AdcCalCurve)(uint32_t raw, void* ctx);
+
+typedef struct {
+    uint16_t mv[ADC_CAL_LUT_POINTS];
+} AdcCalLut;
+
+/**
+ * Sample a calibration curve into a table
+ */
+void AdcCal_build(AdcCalLut* lut, AdcCalCurve curve, void* ctx);
+
+/**
+ * Plain linear table (no characterization available)
+ * @param fullScaleMv Millivolts at code 4095
+ */
+void AdcCal_buildLinear(AdcCalLut* lut, uint16_t fullScaleMv);
+
+/**
+ * Millivolts of a raw code (clamped to 0..4095)
+ */
+uint16_t AdcCal_toMillivolts(const AdcCalLut* lut, uint16_t raw);
+
+/**
+ * Rounded average of an oversampled sum
+ */
+uint16_t AdcCal_average(uint32_t sum, uint8_t count);
+
+/**
+ * Oversampling count in its valid range (1..ADC_CAL_MAX_OVERSAMPLE)
+ */
+uint8_t AdcCal_sanitizeOversample(uint8_t samples);
+
+/**
+ * mv * num / den, rounded, saturating at 65535 (voltage dividers)
+ */
+uint16_t AdcCal_scale(uint16_t mv, uint16_t num, uint16_t den);
+
+#endif // ADC_CAL_H
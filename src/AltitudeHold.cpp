@@ -0,0 +1,108 @@
+#include "AltitudeHold.h"
+#include "FastMath.h"
+#include <string.h>
+
+/**
+ * AltitudeHold - Implementation
+ *
+ * @file AltitudeHold.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// ============================================================================
+// Config
+// ============================================================================
+
+void AltitudeHold_defaultConfig(AltHoldConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->enabled = false;
+    config->posKp = 1.0f;
+    config->maxClimbMps = 2.0f;
+    config->maxSinkMps = 1.5f;
+    config->rateKp = 0.15f;
+    config->rateKi = 0.1f;
+    config->iLimit = 0.2f;
+    config->hoverThrottle = 0.45f;
+    config->deadband = 0.1f;
+}
+
+void AltitudeHold_sanitize(AltHoldConfig* config) {
+    memset(config->reserved, 0, sizeof(config->reserved));
+    config->posKp = clampf(config->posKp, 0.1f, 5.0f);
+    config->maxClimbMps = clampf(config->maxClimbMps, 0.2f, 10.0f);
+    config->maxSinkMps = clampf(config->maxSinkMps, 0.2f, 10.0f);
+    config->rateKp = clampf(config->rateKp, 0.0f, 2.0f);
+    config->rateKi = clampf(config->rateKi, 0.0f, 2.0f);
+    config->iLimit = clampf(config->iLimit, 0.0f, 0.5f);
+    config->hoverThrottle = clampf(config->hoverThrottle, 0.1f, 0.9f);
+    config->deadband = clampf(config->deadband, 0.0f, 0.4f);
+}
+
+void AltitudeHold_init(AltitudeHold* hold, const AltHoldConfig* config) {
+    memset(hold, 0, sizeof(*hold));
+    hold->config = *config;
+}
+
+void AltitudeHold_setConfig(AltitudeHold* hold, const AltHoldConfig* config) {
+    hold->config = *config;
+    hold->integral = clampf(hold->integral, -config->iLimit, config->iLimit);
+}
+
+void AltitudeHold_engage(AltitudeHold* hold, float altitude) {
+    hold->engaged = true;
+    hold->target = altitude;
+    hold->climbSp = 0.0f;
+    hold->integral = 0.0f;
+    hold->throttle = hold->config.hoverThrottle;
+}
+
+void AltitudeHold_release(AltitudeHold* hold) {
+    hold->engaged = false;
+    hold->climbSp = 0.0f;
+    hold->integral = 0.0f;
+}
+
+// ============================================================================
+// Update
+// ============================================================================
+
+float AltitudeHold_stickRate(const AltHoldConfig* config, float stick) {
+    float d = clampf(stick, 0.0f, 1.0f) - 0.5f;
+    float span = 0.5f - config->deadband;
+    if (span <= 0.0f) return 0.0f;
+    if (d > config->deadband) return (d - config->deadband) / span * config->maxClimbMps;
+    if (d < -config->deadband) return (d + config->deadband) / span * config->maxSinkMps;
+    return 0.0f;
+}
+
+float AltitudeHold_update(AltitudeHold* hold, float pilotRate, float altitude,
+                          float climbRate, float cosTilt, float dt) {
+    const AltHoldConfig* c = &hold->config;
+    if (!hold->engaged || dt <= 0.0f) return hold->throttle;
+
+    // Pilot moves the target, on a leash the position loop can keep up with
+    if (pilotRate != 0.0f) {
+        hold->target += pilotRate * dt;
+        hold->target = clampf(hold->target, altitude - c->maxSinkMps / c->posKp,
+                              altitude + c->maxClimbMps / c->posKp);
+    }
+
+    hold->climbSp = clampf(pilotRate + c->posKp * (hold->target - altitude),
+                           -c->maxSinkMps, c->maxClimbMps);
+
+    float err = hold->climbSp - climbRate;
+    float tilt = cosTilt > ALT_HOLD_MIN_COS_TILT ? cosTilt : ALT_HOLD_MIN_COS_TILT;
+    float out = (c->hoverThrottle + c->rateKp * err + hold->integral) / tilt;
+
+    // Integrate unless the output is pinned the same way
+    if (!((out >= 1.0f && err > 0.0f) || (out <= 0.0f && err < 0.0f)))
+        hold->integral = clampf(hold->integral + c->rateKi * err * dt, -c->iLimit, c->iLimit);
+
+    hold->throttle = clampf(out, 0.0f, 1.0f);
+    return hold->throttle;
+}
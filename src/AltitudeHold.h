@@ -0,0 +1,111 @@
+#ifndef ALTITUDE_HOLD_H
+#define ALTITUDE_HOLD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * AltitudeHold - Copter throttle from a target altitude
+ *
+ * Two loops on the BaroAltitude estimate:
+ *
+ *   climb setpoint = pilot rate + posKp (target - altitude)
+ *                    (clamped to +maxClimb / -maxSink)
+ *   throttle = (hover + rateKp (setpoint - climb) + I) / cos(tilt)
+ *
+ * - Pilot: the throttle stick becomes a climb rate. Around the centre
+ *   (+-deadband) it holds; towards either end it climbs or sinks up to
+ *   the limits, and the target moves with it. The target stays within
+ *   a leash of the altitude (what the position loop can ask for at full
+ *   rate), so it does not run off while the airframe cannot follow.
+ * - Mission: setTarget() with the leg altitude and no pilot rate; the
+ *   rate limits turn a big step into a steady climb or descent.
+ * - hoverThrottle is the feed-forward; the integrator takes up the rest
+ *   (battery sag, payload) and stops winding while the output is pinned
+ *   the same way
+ * - Tilted, the thrust's vertical share is cos(tilt): the throttle is
+ *   raised to match, up to 60 degrees
+ *
+ * Plain struct, no hardware. Throttle 0..1, heights in m, up positive.
+ *
+ * @file AltitudeHold.h
+ */
+
+#define ALT_HOLD_CONFIG_KEY     "cfg_alt"
+#define ALT_HOLD_MIN_COS_TILT   0.5f
+
+typedef struct {
+    bool enabled;
+    uint8_t reserved[3];
+    float posKp;                // 1/s, height error to climb rate
+    float maxClimbMps;
+    float maxSinkMps;
+    float rateKp;               // Throttle per m/s of climb rate error
+    float rateKi;
+    float iLimit;               // Throttle units
+    float hoverThrottle;        // 0..1
+    float deadband;             // Stick share either side of the centre
+} AltHoldConfig;
+
+typedef struct {
+    AltHoldConfig config;
+    bool engaged;
+    float target;               // m
+    float climbSp;              // m/s, last setpoint
+    float integral;             // Throttle units
+    float throttle;             // Output, 0..1
+} AltitudeHold;
+
+/**
+ * Default: off, position 1.0 /s, +2 / -1.5 m/s, rate PI 0.15 / 0.1
+ * (limit 0.2), hover 0.45, deadband 0.1
+ */
+void AltitudeHold_defaultConfig(AltHoldConfig* config);
+
+void AltitudeHold_sanitize(AltHoldConfig* config);
+
+void AltitudeHold_init(AltitudeHold* hold, const AltHoldConfig* config);
+
+/**
+ * Replace the configuration, keeping the integrator (clamped to the
+ * new limit)
+ */
+void AltitudeHold_setConfig(AltitudeHold* hold, const AltHoldConfig* config);
+
+/**
+ * Start holding the current altitude from hover throttle
+ */
+void AltitudeHold_engage(AltitudeHold* hold, float altitude);
+
+/**
+ * Stop holding; the next engage starts over
+ */
+void AltitudeHold_release(AltitudeHold* hold);
+
+/**
+ * Hold a given altitude (mission leg)
+ */
+static inline void AltitudeHold_setTarget(AltitudeHold* hold, float altitude) {
+    hold->target = altitude;
+}
+
+/**
+ * Throttle stick to climb rate
+ * @param stick 0..1, centre 0.5
+ * @return m/s, 0 inside the deadband
+ */
+float AltitudeHold_stickRate(const AltHoldConfig* config, float stick);
+
+/**
+ * One control step (engaged only)
+ * @param pilotRate Climb rate from the pilot, m/s (moves the target)
+ * @param altitude Estimate, m
+ * @param climbRate Estimate, m/s
+ * @param cosTilt Cosine of the angle between body z and up
+ * @param dt Step, s
+ * @return Throttle 0..1 (also in hold->throttle)
+ */
+float AltitudeHold_update(AltitudeHold* hold, float pilotRate, float altitude,
+                          float climbRate, float cosTilt, float dt);
+
+#endif // ALTITUDE_HOLD_H
@@ -0,0 +1,265 @@
+#include "AttitudeEstimator.h"
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+FAST_MATH_FLOAT_ONLY
+
+/**
+ * AttitudeEstimator - Implementation
+ *
+ * @file AttitudeEstimator.cpp
+ */
+
+#define GRAVITY_MS2 9.80665f
+#define ATTITUDE_MAX_BIAS 0.5f  // rad/s, integral clamp
+
+// Cycle counter: CCOUNT on Xtensa, nanoseconds on host builds
+#if defined(__XTENSA__)
+#include <xtensa/hal.h>
+#define ATTITUDE_CYCLES() xthal_get_ccount()
+#else
+#include <time.h>
+static inline uint32_t attitude_host_cycles(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#define ATTITUDE_CYCLES() attitude_host_cycles()
+#endif
+
+static float clampf(float v, float lo, float hi) {
+  return v < lo ? lo : (v > hi ? hi : v);
+}
+
+#if ATTITUDE_FIXED_POINT
+
+// ============================================================================
+// Fixed Point (Q16.16 inputs, Q2.30 state)
+// ============================================================================
+
+#define Q16_ONE (1L << 16)
+#define Q30_ONE (1L << 30)
+#define Q30_HALF (1L << 29)
+
+static inline int32_t to_q16(float v) { return (int32_t)lroundf(v * 65536.0f); }
+static inline int32_t mul_q30(int32_t a, int32_t b) {
+  return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+static uint32_t isqrt64(uint64_t v) {
+  uint64_t res = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= res + bit) {
+      v -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)res;
+}
+
+static void update_impl(AttitudeEstimator *est, const float gyro[3],
+                        const float accel[3], float dt) {
+  int32_t *q = est->q;
+  int32_t g[3], a[3];
+  for (int i = 0; i < 3; i++) {
+    g[i] = to_q16(gyro[i]);
+    a[i] = to_q16(accel[i]);
+  }
+  int64_t dtQ32 = (int64_t)(dt * 4294967296.0f);
+
+  // |a| in Q16 from a Q32 sum of squares
+  uint64_t a2 = (uint64_t)((int64_t)a[0] * a[0]) + (uint64_t)((int64_t)a[1] * a[1]) +
+                (uint64_t)((int64_t)a[2] * a[2]);
+  int32_t norm = (int32_t)isqrt64(a2);
+  const int32_t minNorm = (int32_t)(ATTITUDE_ACCEL_MIN_G * GRAVITY_MS2 * Q16_ONE);
+  const int32_t maxNorm = (int32_t)(ATTITUDE_ACCEL_MAX_G * GRAVITY_MS2 * Q16_ONE);
+
+  if (norm >= minNorm && norm <= maxNorm) {
+    int32_t ax = (int32_t)(((int64_t)a[0] << 30) / norm);
+    int32_t ay = (int32_t)(((int64_t)a[1] << 30) / norm);
+    int32_t az = (int32_t)(((int64_t)a[2] << 30) / norm);
+
+    // Half the estimated gravity direction in body frame
+    int32_t vx = mul_q30(q[1], q[3]) - mul_q30(q[0], q[2]);
+    int32_t vy = mul_q30(q[0], q[1]) + mul_q30(q[2], q[3]);
+    int32_t vz = mul_q30(q[0], q[0]) - Q30_HALF + mul_q30(q[3], q[3]);
+
+    // Error = measured x estimated
+    int32_t e[3] = {mul_q30(ay, vz) - mul_q30(az, vy),
+                    mul_q30(az, vx) - mul_q30(ax, vz),
+                    mul_q30(ax, vy) - mul_q30(ay, vx)};
+
+    const int32_t maxBias = (int32_t)(ATTITUDE_MAX_BIAS * Q30_ONE);
+    int64_t kiDt = ((int64_t)est->twoKi * dtQ32) >> 16;   // Q32
+    for (int i = 0; i < 3; i++) {
+      if (est->twoKi > 0) {
+        int32_t bias = est->integral[i] + (int32_t)(((int64_t)e[i] * kiDt) >> 32);
+        est->integral[i] = bias > maxBias ? maxBias : (bias < -maxBias ? -maxBias : bias);
+        g[i] += est->integral[i] >> 14;
+      }
+      g[i] += (int32_t)(((int64_t)est->twoKp * e[i]) >> 30);
+    }
+  } else {
+    est->accelRejected++;
+  }
+
+  // Half rotation this step, Q30 rad: Q16 * Q32 >> 18, halved
+  int32_t hx = (int32_t)(((int64_t)g[0] * dtQ32) >> 19);
+  int32_t hy = (int32_t)(((int64_t)g[1] * dtQ32) >> 19);
+  int32_t hz = (int32_t)(((int64_t)g[2] * dtQ32) >> 19);
+
+  int32_t w = q[0], x = q[1], y = q[2], z = q[3];
+  q[0] = w - mul_q30(x, hx) - mul_q30(y, hy) - mul_q30(z, hz);
+  q[1] = x + mul_q30(w, hx) + mul_q30(y, hz) - mul_q30(z, hy);
+  q[2] = y + mul_q30(w, hy) - mul_q30(x, hz) + mul_q30(z, hx);
+  q[3] = z + mul_q30(w, hz) + mul_q30(x, hy) - mul_q30(y, hx);
+
+  // Renormalise with one Newton step: q *= (3 - |q|^2) / 2, |q| stays near 1
+  int64_t n2 = (int64_t)mul_q30(q[0], q[0]) + mul_q30(q[1], q[1]) +
+               mul_q30(q[2], q[2]) + mul_q30(q[3], q[3]);
+  int32_t k = (int32_t)(((3LL << 30) - n2) >> 1);
+  for (int i = 0; i < 4; i++) q[i] = mul_q30(q[i], k);
+}
+
+void AttitudeEstimator_setGains(AttitudeEstimator *est, float kp, float ki) {
+  est->twoKp = to_q16(2.0f * kp);
+  est->twoKi = to_q16(2.0f * ki);
+}
+
+void AttitudeEstimator_getQuaternion(const AttitudeEstimator *est, float q[4]) {
+  for (int i = 0; i < 4; i++) q[i] = est->q[i] * (1.0f / Q30_ONE);
+}
+
+static void reset_state(AttitudeEstimator *est) {
+  est->q[0] = Q30_ONE;
+}
+
+#else
+
+// ============================================================================
+// Float
+// ============================================================================
+
+static void update_impl(AttitudeEstimator *est, const float gyro[3],
+                        const float accel[3], float dt) {
+  float *q = est->q;
+  float gx = gyro[0], gy = gyro[1], gz = gyro[2];
+
+  float a2 = accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2];
+  const float minA2 = (ATTITUDE_ACCEL_MIN_G * GRAVITY_MS2) * (ATTITUDE_ACCEL_MIN_G * GRAVITY_MS2);
+  const float maxA2 = (ATTITUDE_ACCEL_MAX_G * GRAVITY_MS2) * (ATTITUDE_ACCEL_MAX_G * GRAVITY_MS2);
+
+  if (a2 >= minA2 && a2 <= maxA2) {
+    float inv = FastMath_invSqrt(a2);
+    float ax = accel[0] * inv, ay = accel[1] * inv, az = accel[2] * inv;
+
+    // Half the estimated gravity direction in body frame
+    float vx = q[1] * q[3] - q[0] * q[2];
+    float vy = q[0] * q[1] + q[2] * q[3];
+    float vz = q[0] * q[0] - 0.5f + q[3] * q[3];
+
+    // Error = measured x estimated
+    float ex = ay * vz - az * vy;
+    float ey = az * vx - ax * vz;
+    float ez = ax * vy - ay * vx;
+
+    if (est->twoKi > 0.0f) {
+      float kiDt = est->twoKi * dt;
+      est->integral[0] = clampf(est->integral[0] + ex * kiDt, -ATTITUDE_MAX_BIAS, ATTITUDE_MAX_BIAS);
+      est->integral[1] = clampf(est->integral[1] + ey * kiDt, -ATTITUDE_MAX_BIAS, ATTITUDE_MAX_BIAS);
+      est->integral[2] = clampf(est->integral[2] + ez * kiDt, -ATTITUDE_MAX_BIAS, ATTITUDE_MAX_BIAS);
+      gx += est->integral[0];
+      gy += est->integral[1];
+      gz += est->integral[2];
+    }
+    gx += est->twoKp * ex;
+    gy += est->twoKp * ey;
+    gz += est->twoKp * ez;
+  } else {
+    est->accelRejected++;
+  }
+
+  // Half rotation this step
+  float hx = gx * 0.5f * dt, hy = gy * 0.5f * dt, hz = gz * 0.5f * dt;
+  float w = q[0], x = q[1], y = q[2], z = q[3];
+  q[0] = w - x * hx - y * hy - z * hz;
+  q[1] = x + w * hx + y * hz - z * hy;
+  q[2] = y + w * hy - x * hz + z * hx;
+  q[3] = z + w * hz + x * hy - y * hx;
+
+  float inv = FastMath_invSqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  for (int i = 0; i < 4; i++) q[i] *= inv;
+}
+
+void AttitudeEstimator_setGains(AttitudeEstimator *est, float kp, float ki) {
+  est->twoKp = 2.0f * kp;
+  est->twoKi = 2.0f * ki;
+}
+
+void AttitudeEstimator_getQuaternion(const AttitudeEstimator *est, float q[4]) {
+  for (int i = 0; i < 4; i++) q[i] = est->q[i];
+}
+
+static void reset_state(AttitudeEstimator *est) {
+  est->q[0] = 1.0f;
+}
+
+#endif // ATTITUDE_FIXED_POINT
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void AttitudeEstimator_init(AttitudeEstimator *est, float kp, float ki) {
+  memset(est, 0, sizeof(*est));
+  reset_state(est);
+  AttitudeEstimator_setGains(est, kp, ki);
+}
+
+void AttitudeEstimator_update(AttitudeEstimator *est, const float gyro[3],
+                              const float accel[3], float dt) {
+  uint32_t start = ATTITUDE_CYCLES();
+  update_impl(est, gyro, accel, clampf(dt, 0.0f, ATTITUDE_MAX_DT));
+  uint32_t cycles = ATTITUDE_CYCLES() - start;
+
+  est->updates++;
+  est->lastCycles = cycles;
+  est->totalCycles += cycles;
+  if (cycles > est->maxCycles) est->maxCycles = cycles;
+}
+
+void AttitudeEstimator_getEuler(const AttitudeEstimator *est, float *roll,
+                                float *pitch, float *yaw) {
+  float q[4];
+  AttitudeEstimator_getQuaternion(est, q);
+  *roll = FastMath_atan2(2.0f * (q[0] * q[1] + q[2] * q[3]),
+                         1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]));
+  // asin(s) = atan2(s, sqrt(1 - s^2))
+  float s = clampf(2.0f * (q[0] * q[2] - q[3] * q[1]), -1.0f, 1.0f);
+  *pitch = FastMath_atan2(s, FastMath_sqrt(1.0f - s * s));
+  *yaw = FastMath_atan2(2.0f * (q[0] * q[3] + q[1] * q[2]),
+                        1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]));
+}
+
+void AttitudeEstimator_toEarth(const AttitudeEstimator *est, const float body[3],
+                               float earth[3]) {
+  float q[4];
+  AttitudeEstimator_getQuaternion(est, q);
+  float w = q[0], x = q[1], y = q[2], z = q[3];
+  earth[0] = (1.0f - 2.0f * (y * y + z * z)) * body[0] +
+             2.0f * (x * y - w * z) * body[1] + 2.0f * (x * z + w * y) * body[2];
+  earth[1] = 2.0f * (x * y + w * z) * body[0] +
+             (1.0f - 2.0f * (x * x + z * z)) * body[1] + 2.0f * (y * z - w * x) * body[2];
+  earth[2] = 2.0f * (x * z - w * y) * body[0] + 2.0f * (y * z + w * x) * body[1] +
+             (1.0f - 2.0f * (x * x + y * y)) * body[2];
+}
+
+uint32_t AttitudeEstimator_getAvgCycles(const AttitudeEstimator *est) {
+  return est->updates ? (uint32_t)(est->totalCycles / est->updates) : 0;
+}
@@ -0,0 +1,118 @@
+#ifndef ATTITUDE_ESTIMATOR_H
+#define ATTITUDE_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * AttitudeEstimator - Mahony quaternion complementary filter
+ *
+ * Integrates the gyro into a body-to-earth quaternion every IMU sample and
+ * pulls roll/pitch toward the accelerometer's gravity vector with a PI
+ * correction (kp: convergence, ki: gyro bias). There is no magnetometer,
+ * so yaw is gyro-only and drifts slowly; callers align it to an external
+ * heading (GPS course) when one is available.
+ *
+ * Two implementations, selected at compile time with ATTITUDE_FIXED_POINT:
+ * - 0 (default): float, uses the ESP32 FPU
+ * - 1: fixed point. Gyro, accel and gains are Q16.16; the quaternion and
+ *   bias integral are kept in Q2.30, because a 1 kHz step (about 5e-4 rad
+ *   at 1 rad/s) is only ~30 LSB in Q16 and would lose heading over minutes
+ *
+ * Accel correction is skipped while |a| is outside ATTITUDE_ACCEL_MIN_G ..
+ * ATTITUDE_ACCEL_MAX_G (free fall, hard manoeuvres), so the filter coasts
+ * on the gyro instead of trusting a vector that isn't gravity.
+ *
+ * Frame: MPU6050 body axes, z up when level. Angles are radians; yaw is
+ * counter-clockwise about z (compass heading = -yaw).
+ *
+ * Each update is timed in CPU cycles (CCOUNT on Xtensa, ns on host) so
+ * both implementations can be compared on core 1 with get_att.
+ *
+ * @file AttitudeEstimator.h
+ */
+
+#ifndef ATTITUDE_FIXED_POINT
+#define ATTITUDE_FIXED_POINT        0
+#endif
+
+#define ATTITUDE_DEFAULT_KP         1.0f
+#define ATTITUDE_DEFAULT_KI         0.02f
+#define ATTITUDE_ACCEL_MIN_G        0.7f
+#define ATTITUDE_ACCEL_MAX_G        1.3f
+#define ATTITUDE_MAX_DT             0.05f   // Longer gaps are clamped (s)
+
+/**
+ * Estimator state
+ */
+typedef struct {
+#if ATTITUDE_FIXED_POINT
+    int32_t q[4];           // w, x, y, z (Q2.30)
+    int32_t integral[3];    // Gyro bias correction, rad/s (Q2.30)
+    int32_t twoKp;          // Q16.16
+    int32_t twoKi;          // Q16.16
+#else
+    float q[4];             // w, x, y, z
+    float integral[3];      // Gyro bias correction, rad/s
+    float twoKp;
+    float twoKi;
+#endif
+    uint32_t updates;
+    uint32_t accelRejected; // Updates that skipped the accel correction
+    uint32_t lastCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+} AttitudeEstimator;
+
+/**
+ * Reset to level, zero bias
+ * @param est Estimator state
+ * @param kp Proportional gain (1/s)
+ * @param ki Integral gain (1/s^2), 0 disables bias estimation
+ */
+void AttitudeEstimator_init(AttitudeEstimator* est, float kp, float ki);
+
+/**
+ * Change gains without resetting the attitude
+ */
+void AttitudeEstimator_setGains(AttitudeEstimator* est, float kp, float ki);
+
+/**
+ * Advance by one IMU sample
+ * @param est Estimator state
+ * @param gyro Body rates, rad/s
+ * @param accel Specific force, m/s^2
+ * @param dt Time since the previous sample, s
+ */
+void AttitudeEstimator_update(AttitudeEstimator* est, const float gyro[3],
+                              const float accel[3], float dt);
+
+/**
+ * Current quaternion (w, x, y, z), unit length
+ */
+void AttitudeEstimator_getQuaternion(const AttitudeEstimator* est, float q[4]);
+
+/**
+ * Current attitude as Euler angles (ZYX), radians
+ * @param roll About x, -pi..pi
+ * @param pitch About y, -pi/2..pi/2
+ * @param yaw About z (counter-clockwise), -pi..pi
+ */
+void AttitudeEstimator_getEuler(const AttitudeEstimator* est, float* roll,
+                                float* pitch, float* yaw);
+
+/**
+ * Rotate a body-frame vector into the estimator's earth frame
+ * (z up, x along the yaw reference)
+ * @param body Vector in MPU6050 body axes (e.g. specific force)
+ * @param earth Output vector
+ */
+void AttitudeEstimator_toEarth(const AttitudeEstimator* est, const float body[3],
+                               float earth[3]);
+
+/**
+ * Mean cycles per update since init (0 before the first update)
+ */
+uint32_t AttitudeEstimator_getAvgCycles(const AttitudeEstimator* est);
+
+#endif // ATTITUDE_ESTIMATOR_H
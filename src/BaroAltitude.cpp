@@ -0,0 +1,70 @@
+#include "BaroAltitude.h"
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * BaroAltitude - Implementation
+ *
+ * @file BaroAltitude.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+#define ISA_HEIGHT_SCALE_M  44330.0f    // T0 / L
+#define ISA_EXPONENT        0.190263f   // R L / (g M)
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+float BaroAltitude_pressureAltitude(float pa, float refPa) {
+    if (pa <= 0.0f || refPa <= 0.0f) return 0.0f;
+    return ISA_HEIGHT_SCALE_M * (1.0f - powf(pa / refPa, ISA_EXPONENT));
+}
+
+void BaroAltitude_init(BaroAltitude* f, float timeConst) {
+    memset(f, 0, sizeof(*f));
+    float tau = timeConst > 0.1f ? timeConst : 0.1f;
+    f->k1 = 3.0f / tau;
+    f->k2 = 3.0f / (tau * tau);
+    f->k3 = 1.0f / (tau * tau * tau);
+}
+
+void BaroAltitude_zero(BaroAltitude* f) {
+    f->ready = false;
+    f->primed = false;
+    f->groundSum = 0.0f;
+    f->groundCount = 0;
+}
+
+void BaroAltitude_updateBaro(BaroAltitude* f, float pa) {
+    f->samples++;
+    if (!f->ready) {
+        f->groundSum += pa;
+        if (++f->groundCount < BARO_ALT_GROUND_SAMPLES) return;
+        f->groundPa = f->groundSum / f->groundCount;
+        f->ready = true;
+        f->baroAlt = 0.0f;      // This sample is part of the reference
+    } else {
+        f->baroAlt = BaroAltitude_pressureAltitude(pa, f->groundPa);
+    }
+    if (!f->primed) {
+        // Start on the barometer at rest: the bias is learnt from there
+        f->altitude = f->baroAlt;
+        f->climbRate = 0.0f;
+        f->accelBias = 0.0f;
+        f->primed = true;
+    }
+}
+
+void BaroAltitude_predict(BaroAltitude* f, float accelUp, float dt) {
+    if (!f->primed || dt <= 0.0f) return;
+
+    float err = f->baroAlt - f->altitude;
+    f->accelBias = clampf(f->accelBias + f->k3 * err * dt, -BARO_ALT_MAX_BIAS,
+                          BARO_ALT_MAX_BIAS);
+    float accel = accelUp + f->accelBias;
+    f->altitude += (f->climbRate + 0.5f * accel * dt) * dt + f->k1 * err * dt;
+    f->climbRate += accel * dt + f->k2 * err * dt;
+}
@@ -0,0 +1,89 @@
+#ifndef BARO_ALTITUDE_H
+#define BARO_ALTITUDE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * BaroAltitude - Barometric altitude blended with vertical acceleration
+ *
+ * A barometer alone is slow and noisy (10-20 cm of noise, prop wash and
+ * gusts on top); the accelerometer alone drifts off within seconds.
+ * The third order complementary filter takes the low frequencies from
+ * the barometer and the high ones from the earth-frame vertical
+ * acceleration, and learns the accelerometer's bias on the way:
+ *
+ *   e = baro - h
+ *   bias += k3 e dt,  v += (a + bias) dt + k2 e dt,  h += v dt + k1 e dt
+ *   k1 = 3 / tau, k2 = 3 / tau^2, k3 = 1 / tau^3
+ *
+ * predict() runs at the control rate with the tick's mean vertical
+ * acceleration; updateBaro() only stores the latest sample, so altitude
+ * and climb rate come out at the control rate whatever the barometer's
+ * rate is.
+ *
+ * Altitude is relative to the ground pressure: the mean of the first
+ * BARO_ALT_GROUND_SAMPLES samples after init() or zero(). Until then
+ * the estimate is not ready.
+ *
+ * Plain struct, no hardware. Pressures in Pa, heights in m, up positive.
+ *
+ * @file BaroAltitude.h
+ */
+
+#ifndef BARO_ALT_TIME_CONST_S
+#define BARO_ALT_TIME_CONST_S   2.0f    // Crossover: shorter trusts the baro more
+#endif
+#define BARO_ALT_GROUND_SAMPLES 32      // Ground reference average
+#define BARO_ALT_MAX_BIAS       2.0f    // m/s^2, accelerometer bias bound
+
+typedef struct {
+    float k1, k2, k3;           // From the time constant
+    float groundPa;             // Reference pressure
+    float groundSum;
+    uint16_t groundCount;
+    bool ready;                 // Ground reference taken
+    bool primed;                // State started from a baro sample
+    float baroAlt;              // Latest baro altitude, m
+    float altitude;             // Estimate, m
+    float climbRate;            // m/s
+    float accelBias;            // m/s^2, added to the measured acceleration
+    uint32_t samples;           // Baro samples taken in
+} BaroAltitude;
+
+/**
+ * Height above the reference pressure (ISA troposphere)
+ * @param pa Pressure, Pa
+ * @param refPa Pressure at height 0, Pa
+ * @return m
+ */
+float BaroAltitude_pressureAltitude(float pa, float refPa);
+
+/**
+ * @param timeConst Crossover time constant, s (BARO_ALT_TIME_CONST_S)
+ */
+void BaroAltitude_init(BaroAltitude* f, float timeConst);
+
+/**
+ * Take a new ground reference from the next samples (altitude 0 here)
+ */
+void BaroAltitude_zero(BaroAltitude* f);
+
+/**
+ * A barometer sample
+ * @param pa Pressure, Pa
+ */
+void BaroAltitude_updateBaro(BaroAltitude* f, float pa);
+
+/**
+ * One control step
+ * @param accelUp Earth-frame vertical acceleration, gravity removed, m/s^2
+ * @param dt Step, s
+ */
+void BaroAltitude_predict(BaroAltitude* f, float accelUp, float dt);
+
+static inline bool BaroAltitude_isReady(const BaroAltitude* f) {
+    return f->ready && f->primed;
+}
+
+#endif // BARO_ALTITUDE_H
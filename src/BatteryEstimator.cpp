@@ -0,0 +1,132 @@
+#include "BatteryEstimator.h"
+#include <string.h>
+
+/**
+ * BatteryEstimator - Implementation
+ *
+ * @file BatteryEstimator.cpp
+ */
+
+// ============================================================================
+// Discharge Curve
+// ============================================================================
+
+// Resting LiPo cell voltage at 0, 10, ... 100 % charge
+static const uint16_t LIPO_OCV_MV[11] = {
+    3300, 3690, 3730, 3770, 3800, 3840, 3870, 3950, 4020, 4110, 4200,
+};
+
+float BatteryEstimator_socFromCellMv(float cellMv) {
+    if (cellMv <= LIPO_OCV_MV[0]) return 0.0f;
+    if (cellMv >= LIPO_OCV_MV[10]) return 100.0f;
+    uint8_t i = 0;
+    while (cellMv > LIPO_OCV_MV[i + 1]) i++;
+    float t = (cellMv - LIPO_OCV_MV[i]) / (float)(LIPO_OCV_MV[i + 1] - LIPO_OCV_MV[i]);
+    return (i + t) * 10.0f;
+}
+
+// ============================================================================
+// Estimator
+// ============================================================================
+
+void BatteryEstimator_init(BatteryEstimator* est, uint8_t cells) {
+    memset(est, 0, sizeof(*est));
+    est->cells = cells ? cells : 1;
+    est->sagMv = BATTERY_DEFAULT_SAG_MV * est->cells;
+}
+
+static void updateSag(BatteryEstimator* est, float packMv, float load, float dt) {
+    float a = dt / (BATTERY_SAG_TAU_S + dt);
+    float dLoad = load - est->meanLoad;
+    float dMv = packMv - est->meanMv;
+    est->meanLoad += a * dLoad;
+    est->meanMv += a * dMv;
+    est->varLoad = (1.0f - a) * (est->varLoad + a * dLoad * dLoad);
+    est->covLoadMv = (1.0f - a) * (est->covLoadMv + a * dLoad * dMv);
+
+    // Only learn from samples where the load actually moved
+    if (est->varLoad < BATTERY_SAG_MIN_VAR) return;
+    float slope = -est->covLoadMv / est->varLoad;
+    float maxSag = BATTERY_MAX_SAG_MV * est->cells;
+    if (slope < 0.0f) slope = 0.0f;
+    if (slope > maxSag) slope = maxSag;
+    est->sagMv = slope;
+}
+
+static void updateRate(BatteryEstimator* est, uint32_t nowMs) {
+    uint32_t elapsed = nowMs - est->windowStartMs;
+    if (elapsed < BATTERY_RATE_WINDOW_MS) return;
+
+    float rate = (est->windowSoc - est->soc) / (elapsed * 0.001f);
+    if (rate < 0.0f) rate = 0.0f;   // Recovering at rest / charging
+    est->rate += 0.3f * (rate - est->rate);
+    est->windowSoc = est->soc;
+    est->windowStartMs = nowMs;
+}
+
+static void updateRTL(BatteryEstimator* est, uint32_t nowMs) {
+    int32_t remaining = BatteryEstimator_getRemainingSeconds(est);
+    bool low;
+    if (est->rtl) {
+        // Stay low until clearly recovered (e.g. a fresh pack)
+        low = est->soc < BATTERY_RTL_PERCENT + BATTERY_RTL_HYST_PERCENT ||
+              (remaining >= 0 && remaining < 2 * BATTERY_RTL_RESERVE_S);
+    } else {
+        low = est->soc < BATTERY_RTL_PERCENT ||
+              (remaining >= 0 && remaining < BATTERY_RTL_RESERVE_S);
+    }
+
+    if (low != est->conditionLow) {
+        est->conditionLow = low;
+        est->conditionSinceMs = nowMs;
+    }
+    if (low != est->rtl && nowMs - est->conditionSinceMs >= BATTERY_RTL_HOLD_MS) {
+        est->rtl = low;
+    }
+}
+
+void BatteryEstimator_update(BatteryEstimator* est, float packMv, float load, uint32_t nowMs) {
+    if (load < 0.0f) load = 0.0f;
+    est->mv = packMv;
+
+    if (!est->primed) {
+        est->meanLoad = load;
+        est->meanMv = packMv;
+        est->ocvMv = packMv + est->sagMv * load;
+        est->soc = BatteryEstimator_socFromCellMv(est->ocvMv / est->cells);
+        est->windowSoc = est->soc;
+        est->windowStartMs = nowMs;
+        est->conditionLow = est->soc < BATTERY_RTL_PERCENT;
+        est->conditionSinceMs = nowMs;
+        est->lastMs = nowMs;
+        est->primed = true;
+        return;
+    }
+
+    float dt = (nowMs - est->lastMs) * 0.001f;
+    est->lastMs = nowMs;
+    if (dt <= 0.0f) return;
+
+    updateSag(est, packMv, load, dt);
+    est->ocvMv = packMv + est->sagMv * load;
+
+    float soc = BatteryEstimator_socFromCellMv(est->ocvMv / est->cells);
+    est->soc += (soc - est->soc) * (dt / (BATTERY_SOC_TAU_S + dt));
+
+    updateRate(est, nowMs);
+    updateRTL(est, nowMs);
+}
+
+uint8_t BatteryEstimator_getPercent(const BatteryEstimator* est) {
+    float soc = est->soc + 0.5f;
+    return soc >= 100.0f ? 100 : (uint8_t)soc;
+}
+
+int32_t BatteryEstimator_getRemainingSeconds(const BatteryEstimator* est) {
+    if (est->rate < BATTERY_MIN_RATE) return -1;
+    return (int32_t)(est->soc / est->rate);
+}
+
+bool BatteryEstimator_rtlRequired(const BatteryEstimator* est) {
+    return est->rtl;
+}
@@ -0,0 +1,108 @@
+#ifndef BATTERY_ESTIMATOR_H
+#define BATTERY_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * BatteryEstimator - LiPo state of charge with load sag compensation
+ *
+ * There is no current sensor, so load is the summed motor output
+ * (1.0 = one motor at full speed) and the pack is modelled as
+ *
+ *   V = OCV - sag * load
+ *
+ * - sag (mV per unit load, i.e. internal resistance times the current
+ *   one motor draws) is learned from exponentially weighted voltage /
+ *   load covariance; it only moves while the load varies enough
+ * - OCV = V + sag * load, mapped to state of charge through a per-cell
+ *   LiPo resting-voltage table
+ * - Discharge rate is measured over BATTERY_RATE_WINDOW_MS windows and
+ *   gives the remaining time
+ * - RTL is requested once the charge (or the remaining time) stays
+ *   below its threshold for BATTERY_RTL_HOLD_MS, and released only
+ *   after it recovers past a hysteresis band for as long, so a throttle
+ *   punch can't trigger it and a noisy estimate can't chatter
+ *
+ * Plain struct, no hardware access; update at a fixed rate with each
+ * new battery reading.
+ *
+ * @file BatteryEstimator.h
+ */
+
+#define BATTERY_DEFAULT_SAG_MV      100.0f  // Per cell per unit load, until learned
+#define BATTERY_MAX_SAG_MV          1000.0f
+#define BATTERY_SAG_TAU_S           20.0f   // Covariance memory
+#define BATTERY_SAG_MIN_VAR         0.01f   // Load variance needed to learn (std 0.1)
+#define BATTERY_SOC_TAU_S           5.0f
+#define BATTERY_RATE_WINDOW_MS      10000
+#define BATTERY_MIN_RATE            0.005f  // %/s, slower reads as "not discharging"
+
+#define BATTERY_RTL_PERCENT         10.0f
+#define BATTERY_RTL_HYST_PERCENT    5.0f
+#define BATTERY_RTL_RESERVE_S       60      // Also RTL when less flight time is left
+#define BATTERY_RTL_HOLD_MS         3000
+
+typedef struct {
+    uint8_t cells;
+
+    // Exponentially weighted load / voltage statistics
+    float meanLoad;
+    float meanMv;
+    float varLoad;
+    float covLoadMv;
+    float sagMv;                // Pack mV per unit load
+
+    float mv;                   // Last measured pack voltage
+    float ocvMv;                // Sag-compensated pack voltage
+    float soc;                  // Filtered state of charge, %
+    float rate;                 // Discharge rate, %/s
+
+    float windowSoc;
+    uint32_t windowStartMs;
+
+    bool rtl;
+    uint32_t conditionSinceMs;  // Start of the current low / recovered streak
+    bool conditionLow;
+
+    bool primed;
+    uint32_t lastMs;
+} BatteryEstimator;
+
+/**
+ * Reset the estimator
+ * @param cells Cells in series
+ */
+void BatteryEstimator_init(BatteryEstimator* est, uint8_t cells);
+
+/**
+ * Feed one reading
+ * @param packMv Measured pack voltage
+ * @param load Load proxy: summed motor output, 1.0 per motor at full speed
+ * @param nowMs Reading time (millis)
+ */
+void BatteryEstimator_update(BatteryEstimator* est, float packMv, float load, uint32_t nowMs);
+
+/**
+ * Resting cell voltage to state of charge (LiPo table)
+ * @return 0-100 %
+ */
+float BatteryEstimator_socFromCellMv(float cellMv);
+
+/**
+ * @return Filtered state of charge, 0-100
+ */
+uint8_t BatteryEstimator_getPercent(const BatteryEstimator* est);
+
+/**
+ * @return Estimated flight time left in seconds, -1 while unknown
+ *         (not discharging or no rate measured yet)
+ */
+int32_t BatteryEstimator_getRemainingSeconds(const BatteryEstimator* est);
+
+/**
+ * @return true while the battery calls for RTL (latched with hysteresis)
+ */
+bool BatteryEstimator_rtlRequired(const BatteryEstimator* est);
+
+#endif // BATTERY_ESTIMATOR_H
@@ -1,60 +1,198 @@
 #include "BatteryManager.h"
+#include "AdcCal.h"
+#include "HAL.h"
+#include "MemoryProfiler.h"
+#include <driver/adc.h>
 
-const float BatteryManager::DIVIDER_RATIO = 3.5f;
-const float BatteryManager::ADC_REF_VOLTAGE = 3.3f;
-const uint16_t BatteryManager::ADC_MAX = 4095;
+const uint16_t BatteryManager::DIVIDER_NUM = 7;
+const uint16_t BatteryManager::DIVIDER_DEN = 2;
 const uint16_t BatteryManager::MIN_VOLTAGE_MV = 3000;
 const uint16_t BatteryManager::MAX_VOLTAGE_MV = 4200;
 const uint16_t BatteryManager::RTL_VOLTAGE_MV = 3400;
 
-BatteryManager::BatteryManager() : sampleIndex(0) {
-    memset(adcSamples, 0, sizeof(adcSamples));
+// ADC1 channel and GPIO per filter slot (slot 0 = battery voltage,
+// slot 1 = current sense). ADC1_CH6 / CH7 are GPIO 34 / 35 on the
+// ESP32, GPIO 7 / 8 on the S3, whose DMA also writes the wider TYPE2
+// result words
+#define CURRENT_SLOT 1
+#if BATTERY_CURRENT_SENSE
+static const adc1_channel_t ADC_CHANNELS[BATTERY_ADC_CHANNELS] = {ADC1_CHANNEL_6, ADC1_CHANNEL_7};
+#else
+static const adc1_channel_t ADC_CHANNELS[BATTERY_ADC_CHANNELS] = {ADC1_CHANNEL_6};
+#endif
+#if CONFIG_IDF_TARGET_ESP32S3
+static const uint8_t ADC_PINS[] = {7, 8};
+#define ADC_OUTPUT_FORMAT ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define ADC_RESULT(sample) ((sample)->type2)
+#else
+static const uint8_t ADC_PINS[] = {34, 35};
+#define ADC_OUTPUT_FORMAT ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define ADC_RESULT(sample) ((sample)->type1)
+#endif
+
+#define ADC_FRAME_SAMPLES 256    // Per DMA read (12.8 ms at 20 kHz)
+#define ADC_BLOCK_SAMPLES (BATTERY_ADC_SAMPLE_HZ / 1000 * BATTERY_BLOCK_MS / BATTERY_ADC_CHANNELS)
+
+BatteryManager::BatteryManager() : _task(nullptr), _continuous(false), _blockCount(0) {
+    memset(_filters, 0, sizeof(_filters));
 }
 
-void BatteryManager::setup() {
-    // Configure ADC for battery voltage
-    pinMode(BATTERY_PIN, INPUT);
-    analogSetPinAttenuation(BATTERY_PIN, ADC_11db);  // 11dB attenuation = max 3.3V
-    
-    // Take initial samples to fill buffer
-    for (int i = 0; i < SMOOTH_SAMPLES; i++) {
-        adcSamples[i] = analogRead(BATTERY_PIN);
-        delay(5);
+void BatteryManager::setup(uint8_t priority, uint8_t core) {
+    // Configure ADC for battery voltage (11 dB, calibration table per channel)
+    for (uint8_t i = 0; i < BATTERY_ADC_CHANNELS; i++) {
+        if (!HAL_ADCInit(ADC_PINS[i], 12)) {
+            Serial.printf("[Battery] ADC init failed on GPIO %u\n", ADC_PINS[i]);
+        }
+        HAL_ADCSetOversampling(ADC_PINS[i], BATTERY_OVERSAMPLE);
+    }
+
+    // Seed the filters so the first readings aren't 0 (would trigger RTL)
+    for (uint8_t i = 0; i < BATTERY_ADC_CHANNELS; i++) {
+        uint32_t sum = 0;
+        for (int n = 0; n < SMOOTH_SAMPLES; n++) {
+            uint16_t raw = 0;
+            HAL_ADCRead(ADC_PINS[i], &raw);
+            sum += raw;
+            delay(5);
+        }
+        seed(i, sum / SMOOTH_SAMPLES);
+    }
+
+    _continuous = startContinuous();
+    MemoryProfiler_setTaskStackSize("battery", BATTERY_TASK_STACK);
+    if (xTaskCreatePinnedToCore(taskEntry, "battery", BATTERY_TASK_STACK, this, priority, &_task, core) != pdPASS) {
+        Serial.println("[Battery] Task create failed");
     }
     
-    Serial.println("{\"msg\":\"BatteryManager initialized\"}");
+    Serial.printf("{\"msg\":\"BatteryManager initialized\",\"dma\":%d,\"cal\":%d}\n", _continuous,
+                  (int)HAL_ADCGetCalSource());
 }
 
-uint16_t BatteryManager::getRawADC() {
-    return analogRead(BATTERY_PIN);
+bool BatteryManager::startContinuous() {
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = ADC_FRAME_SAMPLES * ADC_RESULT_BYTE * 4;
+    initConfig.conv_num_each_intr = ADC_FRAME_SAMPLES * ADC_RESULT_BYTE;
+    for (uint8_t i = 0; i < BATTERY_ADC_CHANNELS; i++) {
+        initConfig.adc1_chan_mask |= 1UL << ADC_CHANNELS[i];
+    }
+    if (adc_digi_initialize(&initConfig) != ESP_OK) return false;
+
+    adc_digi_pattern_config_t pattern[BATTERY_ADC_CHANNELS];
+    for (uint8_t i = 0; i < BATTERY_ADC_CHANNELS; i++) {
+        pattern[i].atten = ADC_ATTEN_DB_11;
+        pattern[i].channel = ADC_CHANNELS[i];
+        pattern[i].unit = 0;    // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = ADC_CONV_LIMIT_EN;
+    config.conv_limit_num = 250;
+    config.pattern_num = BATTERY_ADC_CHANNELS;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = BATTERY_ADC_SAMPLE_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_OUTPUT_FORMAT;
+    if (adc_digi_controller_configure(&config) != ESP_OK) return false;
+
+    return adc_digi_start() == ESP_OK;
 }
 
-uint16_t BatteryManager::smoothADC() {
-    // Replace oldest sample with new reading
-    adcSamples[sampleIndex] = analogRead(BATTERY_PIN);
-    sampleIndex = (sampleIndex + 1) % SMOOTH_SAMPLES;
-    
-    // Calculate average
-    uint32_t sum = 0;
-    for (int i = 0; i < SMOOTH_SAMPLES; i++) {
-        sum += adcSamples[i];
+// ============================================================================
+// Filtering (sampling task)
+// ============================================================================
+
+void BatteryManager::seed(uint8_t slot, uint16_t value) {
+    ChannelFilter& f = _filters[slot];
+    for (int i = 0; i < SMOOTH_SAMPLES; i++) f.blocks[i] = value;
+    f.sum = (uint32_t)value * SMOOTH_SAMPLES;
+    f.raw = value;
+    f.rawMv = toMillivolts(slot, value);
+    f.filteredMv = f.rawMv;
+}
+
+void BatteryManager::pushBlock(uint8_t slot, uint16_t value) {
+    // Replace oldest block with the new one
+    ChannelFilter& f = _filters[slot];
+    f.sum += value;
+    f.sum -= f.blocks[f.index];
+    f.blocks[f.index] = value;
+    f.index = (f.index + 1) % SMOOTH_SAMPLES;
+    f.raw = value;
+    f.rawMv = toMillivolts(slot, value);
+    f.filteredMv = toMillivolts(slot, AdcCal_average(f.sum, SMOOTH_SAMPLES));
+    if (slot == BATTERY_ADC_CHANNELS - 1) _blockCount++;
+}
+
+void BatteryManager::readContinuous() {
+    static uint8_t frame[ADC_FRAME_SAMPLES * ADC_RESULT_BYTE];
+    uint32_t length = 0;
+    if (adc_digi_read_bytes(frame, sizeof(frame), &length, BATTERY_BLOCK_MS) != ESP_OK) return;
+
+    for (uint32_t i = 0; i + ADC_RESULT_BYTE <= length; i += ADC_RESULT_BYTE) {
+        const adc_digi_output_data_t* sample = (const adc_digi_output_data_t*)&frame[i];
+        for (uint8_t slot = 0; slot < BATTERY_ADC_CHANNELS; slot++) {
+            if (ADC_RESULT(sample).channel != ADC_CHANNELS[slot]) continue;
+            ChannelFilter& f = _filters[slot];
+            f.blockSum += ADC_RESULT(sample).data;
+            if (++f.blockCount >= ADC_BLOCK_SAMPLES) {
+                pushBlock(slot, f.blockSum / f.blockCount);
+                f.blockSum = 0;
+                f.blockCount = 0;
+            }
+        }
     }
-    return sum / SMOOTH_SAMPLES;
+}
+
+void BatteryManager::readFallback() {
+    vTaskDelay(pdMS_TO_TICKS(BATTERY_BLOCK_MS));
+    for (uint8_t slot = 0; slot < BATTERY_ADC_CHANNELS; slot++) {
+        uint16_t raw = 0;
+        if (HAL_ADCRead(ADC_PINS[slot], &raw)) pushBlock(slot, raw);
+    }
+}
+
+void BatteryManager::taskEntry(void* arg) {
+    BatteryManager* battery = (BatteryManager*)arg;
+    for (;;) {
+        if (battery->_continuous) {
+            battery->readContinuous();
+        } else {
+            battery->readFallback();
+        }
+    }
+}
+
+// ============================================================================
+// Getters (cached, no ADC access)
+// ============================================================================
+
+uint16_t BatteryManager::getRawADC() {
+    return _filters[0].raw;
 }
 
 uint16_t BatteryManager::getVoltageMillivolts() {
-    uint16_t adcValue = smoothADC();
-    
-    // Convert ADC to voltage
-    // ADC: 0-4095 maps to 0-3.3V
-    // Actual voltage: ADC_voltage * divider_ratio
-    float adcVoltage = (adcValue / (float)ADC_MAX) * ADC_REF_VOLTAGE;
-    float batteryVoltage = adcVoltage * DIVIDER_RATIO;
-    
-    // Convert to millivolts
-    uint16_t voltageMillivolts = (uint16_t)(batteryVoltage * 1000.0f);
-    
-    return voltageMillivolts;
+    return _filters[0].filteredMv;
+}
+
+uint16_t BatteryManager::getBlockMillivolts() {
+    return _filters[0].rawMv;
+}
+
+uint16_t BatteryManager::getCurrentSenseMillivolts() {
+#if BATTERY_CURRENT_SENSE
+    return _filters[CURRENT_SLOT].rawMv;
+#else
+    return 0;
+#endif
+}
+
+uint16_t BatteryManager::toMillivolts(uint8_t slot, uint16_t adcValue) {
+    // Calibrated pin millivolts (table lookup), then the divider on the
+    // battery channel; the current sensor drives its pin directly
+    uint16_t pinMv = HAL_ADCToMillivolts(ADC_PINS[slot], adcValue);
+    if (slot == CURRENT_SLOT) return pinMv;
+    return AdcCal_scale(pinMv, DIVIDER_NUM, DIVIDER_DEN);
 }
 
 uint8_t BatteryManager::getBatteryPercentage() {
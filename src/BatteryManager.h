@@ -2,30 +2,64 @@
 #define BATTERY_MANAGER_H
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 /**
  * BatteryManager - Voltage monitoring and ADC management
  * 
  * Hardware:
- * - ADC GPIO: 34 (ADC1_CH6) - 12-bit reading (0-4095 range)
+ * - ADC GPIO: 34 (ADC1_CH6) - 12-bit reading (0-4095 range), 11 dB
  * - Voltage divider: 100k + 47k = 3.5:1 ratio
  * - Battery voltage range: 3.0V to 4.2V (LiPo)
- * - Max ADC voltage: 3.3V
- * - Max battery voltage: 3.3V * 3.5 = 11.55V (but limit to ~5V for testing)
- * 
- * Formula: Voltage = (ADC_reading / 4095) * 3.3 * divider_ratio
+ * - Max ADC voltage: ~3.1V calibrated
+ * - Max battery voltage: 3.1V * 3.5 = ~10.9V (but limit to ~5V for testing)
+ *
+ * Formula: mV = HAL_ADCToMillivolts(code) * 7 / 2
+ * (eFuse-calibrated table per channel, see AdcCal.h; integer only)
+ *
+ * Sampling:
+ * - ADC1 runs in continuous (DMA) mode at BATTERY_ADC_SAMPLE_HZ; a
+ *   background task averages each channel over BATTERY_BLOCK_MS blocks
+ *   and runs the moving average over the last SMOOTH_SAMPLES blocks
+ * - Each block is converted to millivolts once, by the sampling task
+ * - Getters only read the cached millivolts (no ADC access), so
+ *   they cost nothing on the control path and the filter advances at a
+ *   fixed rate however often they are called
+ * - If the DMA driver can't start, the task falls back to one
+ *   oversampled HAL_ADCRead per block
+ * - Further channels are added to the channel table in
+ *   BatteryManager.cpp
+ *
+ * Current sense (BATTERY_CURRENT_SENSE=1): a Hall or shunt-amplifier
+ * output on GPIO 35 (ADC1_CH7; GPIO 8 on the S3) is sampled as a second
+ * channel in the same DMA pattern. Its pin millivolts are reported
+ * as-is; the sensor offset and gain are runtime settings (PowerMonitor).
  */
+
+#ifndef BATTERY_CURRENT_SENSE
+#define BATTERY_CURRENT_SENSE   0       // 1 = current sensor on ADC1_CH7
+#endif
+
+#define BATTERY_ADC_SAMPLE_HZ   20000   // Lowest continuous rate of the ESP32 ADC
+#define BATTERY_BLOCK_MS        100     // Filter update period
+#define BATTERY_ADC_CHANNELS    (1 + BATTERY_CURRENT_SENSE)     // Voltage, current
+#define BATTERY_TASK_STACK      3072    // bytes
+#define BATTERY_OVERSAMPLE      16      // Samples per seed / fallback reading
+
 class BatteryManager {
 public:
     BatteryManager();
     
     /**
-     * Initialize ADC for battery voltage reading
+     * Initialize ADC and start the sampling task
+     * @param priority FreeRTOS priority of the sampling task
+     * @param core Core to pin the sampling task to
      */
-    void setup();
+    void setup(uint8_t priority, uint8_t core);
     
     /**
-     * Read battery voltage from ADC
+     * Filtered battery voltage
      * @return voltage in millivolts
      */
     uint16_t getVoltageMillivolts();
@@ -44,26 +78,75 @@ public:
     bool isLow();
     
     /**
-     * Get raw ADC reading
+     * Latest unfiltered block average (one BATTERY_BLOCK_MS block)
      */
     uint16_t getRawADC();
+
+    /**
+     * Latest block average in millivolts (unsmoothed, tracks load sag)
+     */
+    uint16_t getBlockMillivolts();
+
+    /**
+     * true if the current sensor channel is sampled
+     */
+    bool hasCurrentSense() const { return BATTERY_CURRENT_SENSE; }
+
+    /**
+     * Latest block average of the current sensor pin in millivolts
+     * (unsmoothed, for integration), 0 without the sensor
+     */
+    uint16_t getCurrentSenseMillivolts();
+
+    /**
+     * Blocks completed so far; changes once per BATTERY_BLOCK_MS
+     */
+    uint32_t getBlockCount() const { return _blockCount; }
+
+    /**
+     * true if the ADC runs in DMA mode (false = analogRead fallback)
+     */
+    bool isContinuous() const { return _continuous; }
     
 private:
     static const uint8_t BATTERY_PIN = 34;      // GPIO 34 (ADC1_CH6)
-    static const float DIVIDER_RATIO;           // 3.5:1 voltage divider
-    static const float ADC_REF_VOLTAGE;         // 3.3V ESP32 reference
-    static const uint16_t ADC_MAX;              // 12-bit: 4095
+    static const uint16_t DIVIDER_NUM;          // 3.5:1 voltage divider
+    static const uint16_t DIVIDER_DEN;          //   as 7 / 2
     static const uint16_t MIN_VOLTAGE_MV;      // 3000mV (3.0V)
     static const uint16_t MAX_VOLTAGE_MV;      // 4200mV (4.2V)
     static const uint16_t RTL_VOLTAGE_MV;      // 3400mV (3.4V) - Phase 14
     
+    static const uint8_t SMOOTH_SAMPLES = 10;
+
     /**
-     * Smooth ADC readings with moving average
+     * Per-channel moving average over block averages
+     * Written by the sampling task only
      */
-    uint16_t smoothADC();
-    static const uint8_t SMOOTH_SAMPLES = 10;
-    uint16_t adcSamples[SMOOTH_SAMPLES];
-    uint8_t sampleIndex;
+    struct ChannelFilter {
+        uint16_t blocks[SMOOTH_SAMPLES];
+        uint8_t index;
+        uint32_t sum;                   // Running sum of blocks[]
+        uint32_t blockSum;              // Current block accumulators
+        uint32_t blockCount;
+        volatile uint16_t raw;          // Last block average
+        volatile uint16_t rawMv;        // ...in millivolts (after the divider)
+        volatile uint16_t filteredMv;   // Moving average in millivolts
+    };
+    ChannelFilter _filters[BATTERY_ADC_CHANNELS];
+
+    TaskHandle_t _task;
+    bool _continuous;
+    volatile uint32_t _blockCount;
+
+    static uint16_t toMillivolts(uint8_t slot, uint16_t adcValue);
+
+    bool startContinuous();
+    void seed(uint8_t slot, uint16_t value);
+    void pushBlock(uint8_t slot, uint16_t value);
+    void readContinuous();
+    void readFallback();
+
+    static void taskEntry(void* arg);
 };
 
 #endif // BATTERY_MANAGER_H
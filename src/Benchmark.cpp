@@ -0,0 +1,112 @@
+#include "Benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Benchmark - Implementation
+ *
+ * One static sample buffer: benchmarks run one at a time from the bench
+ * firmware's loop task, and 4 KB on that task's stack would not fit.
+ *
+ * @file Benchmark.cpp
+ */
+
+#if defined(__XTENSA__)
+#include <xtensa/hal.h>
+#include <esp_rom_sys.h>
+#define BENCH_CYCLES() xthal_get_ccount()
+#define BENCH_CYCLES_PER_US() esp_rom_get_cpu_ticks_per_us()
+#else
+#include <time.h>
+static inline uint32_t bench_host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#define BENCH_CYCLES() bench_host_ns()
+#define BENCH_CYCLES_PER_US() 1000
+#endif
+
+static uint32_t samples[BENCH_MAX_SAMPLES];
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void Bench_computeStats(uint32_t* values, uint32_t count, BenchStats* stats) {
+    *stats = BenchStats{};
+    if (count == 0) return;
+    qsort(values, count, sizeof(values[0]), compare_u32);
+    stats->count = count;
+    stats->min = values[0];
+    stats->median = values[count / 2];
+    // Nearest rank: the smallest sample with at least 99% at or below it
+    stats->p99 = values[(count * 99 + 99) / 100 - 1];
+    stats->max = values[count - 1];
+}
+
+bool Bench_run(BenchFn fn, void* ctx, uint32_t iterations, BenchStats* stats) {
+    if (!fn || iterations == 0 || iterations > BENCH_MAX_SAMPLES) return false;
+    fn(ctx);
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t start = BENCH_CYCLES();
+        fn(ctx);
+        samples[i] = BENCH_CYCLES() - start;
+    }
+    Bench_computeStats(samples, iterations, stats);
+    return true;
+}
+
+size_t Bench_formatJson(const char* name, const BenchStats* stats, uint32_t cyclesPerUs,
+                        char* out, size_t outSize) {
+    if (cyclesPerUs == 0) cyclesPerUs = 1;
+    // Median in ns, printed as us with three decimals (no float printf)
+    uint64_t medNs = (uint64_t)stats->median * 1000ULL / cyclesPerUs;
+    int n = snprintf(out, outSize,
+                     "{\"bench\":\"%s\",\"n\":%lu,\"min\":%lu,\"med\":%lu,\"p99\":%lu,"
+                     "\"max\":%lu,\"med_us\":%lu.%03lu}",
+                     name, (unsigned long)stats->count, (unsigned long)stats->min,
+                     (unsigned long)stats->median, (unsigned long)stats->p99,
+                     (unsigned long)stats->max, (unsigned long)(medNs / 1000),
+                     (unsigned long)(medNs % 1000));
+    return (n < 0 || (size_t)n >= outSize) ? 0 : (size_t)n;
+}
+
+uint32_t Bench_cyclesPerUs(void) {
+    return BENCH_CYCLES_PER_US();
+}
+
+bool Bench_withinBudget(const BenchStats* stats, uint32_t cyclesPerUs, uint32_t budgetNs,
+                        uint32_t marginPct) {
+    if (marginPct == 0) return true;
+    if (cyclesPerUs == 0) cyclesPerUs = 1;
+    uint64_t medNs = (uint64_t)stats->median * 1000ULL / cyclesPerUs;
+    return medNs * 100 <= (uint64_t)budgetNs * (100 + marginPct);
+}
+
+bool Bench_checkBudget(const char* name, BenchFn fn, void* ctx, uint32_t iterations,
+                       uint32_t budgetNs, char* msg, size_t msgSize) {
+    BenchStats stats;
+    if (!Bench_run(fn, ctx, iterations, &stats)) {
+        if (msgSize) snprintf(msg, msgSize, "%s: bad iterations", name);
+        return false;
+    }
+    uint32_t cyclesPerUs = Bench_cyclesPerUs();
+    size_t n = Bench_formatJson(name, &stats, cyclesPerUs, msg, msgSize);
+    if (n > 0) {
+        // Reopen the object for the budget
+        snprintf(msg + n - 1, msgSize - (n - 1), ",\"budget_us\":%lu.%03lu}",
+                 (unsigned long)(budgetNs / 1000), (unsigned long)(budgetNs % 1000));
+    }
+    return Bench_withinBudget(&stats, cyclesPerUs, budgetNs, BENCH_BUDGET_MARGIN_PCT);
+}
@@ -0,0 +1,125 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Benchmark - Cycle-counter microbenchmarks with JSON results
+ *
+ * Bench_run() calls a function once to warm the caches, then times each
+ * of N calls on its own with PROFILE_CYCLES() (CCOUNT on the ESP32,
+ * nanoseconds on host builds) and reduces the samples to min / median /
+ * p99 / max. Per-call samples rather than one total keep an interrupt or
+ * flash cache miss in one call from skewing the median.
+ *
+ * Results are one JSON object per line so a release-over-release script
+ * can diff them:
+ *
+ *   {"bench":"crc16","n":1000,"min":412,"med":418,"p99":440,"max":2210,"med_us":1.74}
+ *
+ * The timing overhead (two counter reads and the indirect call) is in
+ * every sample; the runner reports it as its own "empty" case.
+ *
+ * Unity tests hold hot paths to a budget with Bench_checkBudget(), the
+ * budget declared next to the test with BENCH_BUDGET_NS(target, host):
+ *
+ *   char msg[BENCH_LINE_MAX];
+ *   TEST_ASSERT_TRUE_MESSAGE(Bench_checkBudget("hmac_validate", validateOnce, NULL, 200,
+ *                                              BENCH_BUDGET_NS(40000, 3000), msg,
+ *                                              sizeof(msg)), msg);
+ *
+ * so a change that puts work back on the hot path (a key schedule per
+ * call, a String per frame) fails a test instead of showing up on the
+ * water. The median is compared, so a preempted call does not fail it.
+ *
+ * @file Benchmark.h
+ */
+
+#define BENCH_MAX_SAMPLES   1000
+#define BENCH_LINE_MAX      192     // Bench_checkBudget() message
+
+// Slack over a budget before Bench_checkBudget() fails, percent; 0 turns
+// the check off, e.g. for sanitizer builds (Tunable; -D overrides)
+#ifndef BENCH_BUDGET_MARGIN_PCT
+#define BENCH_BUDGET_MARGIN_PCT 25
+#endif
+
+// Per-call budget in ns: the target figure on the ESP32, the host one in
+// native tests (a desktop core, with mbedtls in software)
+#if defined(__XTENSA__)
+#define BENCH_BUDGET_NS(target, host) (target)
+#else
+#define BENCH_BUDGET_NS(target, host) (host)
+#endif
+
+/**
+ * Function under test
+ */
+typedef void (*BenchFn)(void* ctx);
+
+/**
+ * Reduced samples, in cycles
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t median;
+    uint32_t p99;
+    uint32_t max;
+} BenchStats;
+
+/**
+ * Reduce samples to stats (sorts samples in place)
+ * @param samples Per-call cycle counts
+ * @param count Number of samples (0 gives all-zero stats)
+ * @param stats Output
+ */
+void Bench_computeStats(uint32_t* samples, uint32_t count, BenchStats* stats);
+
+/**
+ * Time a function
+ * @param fn Function under test
+ * @param ctx Passed to fn
+ * @param iterations Timed calls (1-BENCH_MAX_SAMPLES)
+ * @param stats Output
+ * @return false if iterations is out of range
+ */
+bool Bench_run(BenchFn fn, void* ctx, uint32_t iterations, BenchStats* stats);
+
+/**
+ * Format one result line (no newline)
+ * @param name Case name
+ * @param stats Result of Bench_run()
+ * @param cyclesPerUs Counter ticks per microsecond (CPU MHz; 1000 on host)
+ * @param out Output buffer
+ * @param outSize Output buffer size
+ * @return Line length, 0 if out is too small
+ */
+size_t Bench_formatJson(const char* name, const BenchStats* stats, uint32_t cyclesPerUs,
+                        char* out, size_t outSize);
+
+/**
+ * Counter ticks per microsecond (CPU MHz on the ESP32, 1000 on host)
+ */
+uint32_t Bench_cyclesPerUs(void);
+
+/**
+ * Whether a median fits a budget plus a margin
+ * @param marginPct Slack over budgetNs, percent (0: always true)
+ */
+bool Bench_withinBudget(const BenchStats* stats, uint32_t cyclesPerUs, uint32_t budgetNs,
+                        uint32_t marginPct);
+
+/**
+ * Time a function and hold its median to a budget
+ * @param name Case name for the message
+ * @param budgetNs Median per call allowed, BENCH_BUDGET_NS()
+ * @param msg Bench_formatJson() line plus "budget_us", for the test log
+ * @return false past budgetNs + BENCH_BUDGET_MARGIN_PCT, or on bad iterations
+ */
+bool Bench_checkBudget(const char* name, BenchFn fn, void* ctx, uint32_t iterations,
+                       uint32_t budgetNs, char* msg, size_t msgSize);
+
+#endif // BENCHMARK_H
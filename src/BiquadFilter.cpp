@@ -0,0 +1,274 @@
+#include "BiquadFilter.h"
+#include "FastMath.h"
+#include <string.h>
+
+/**
+ * BiquadFilter - Implementation
+ *
+ * The block loops run stage-outermost: one stage filters the whole block
+ * for every channel before the next stage starts, so a stage's
+ * coefficients stay in registers and its state is loaded and stored once
+ * per block instead of once per sample.
+ *
+ * @file BiquadFilter.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+#define LIMIT_FRACTION  0.45f       // Highest corner, as a fraction of the sample rate
+
+static uint8_t clampChannels(uint8_t channels) {
+    if (channels < 1) return 1;
+    if (channels > BIQUAD_MAX_CHANNELS) return BIQUAD_MAX_CHANNELS;
+    return channels;
+}
+
+static bool validCorner(float hz, float sampleHz) {
+    return hz > 0.0f && sampleHz > 0.0f && hz < 0.5f * sampleHz;
+}
+
+// ============================================================================
+// Design
+// ============================================================================
+
+void Biquad_passthrough(BiquadCoefs* c) {
+    c->b0 = 1.0f;
+    c->b1 = 0.0f;
+    c->b2 = 0.0f;
+    c->a1 = 0.0f;
+    c->a2 = 0.0f;
+}
+
+bool Biquad_lowpass(BiquadCoefs* c, float cutoffHz, float sampleHz, float q) {
+    if (!validCorner(cutoffHz, sampleHz) || !(q > 0.0f)) {
+        Biquad_passthrough(c);
+        return false;
+    }
+    float s, cs;
+    FastMath_sinCos(FAST_MATH_TWO_PI * cutoffHz / sampleHz, &s, &cs);
+    float alpha = s / (2.0f * q);
+    float inv = 1.0f / (1.0f + alpha);
+    c->b0 = (1.0f - cs) * 0.5f * inv;
+    c->b1 = (1.0f - cs) * inv;
+    c->b2 = c->b0;
+    c->a1 = -2.0f * cs * inv;
+    c->a2 = (1.0f - alpha) * inv;
+    return true;
+}
+
+bool Biquad_notch(BiquadCoefs* c, float centerHz, float sampleHz, float q) {
+    if (!validCorner(centerHz, sampleHz) || !(q > 0.0f)) {
+        Biquad_passthrough(c);
+        return false;
+    }
+    float s, cs;
+    FastMath_sinCos(FAST_MATH_TWO_PI * centerHz / sampleHz, &s, &cs);
+    float alpha = s / (2.0f * q);
+    float inv = 1.0f / (1.0f + alpha);
+    c->b0 = inv;
+    c->b1 = -2.0f * cs * inv;
+    c->b2 = inv;
+    c->a1 = c->b1;
+    c->a2 = (1.0f - alpha) * inv;
+    return true;
+}
+
+float Biquad_gain(const BiquadCoefs* c, float freqHz, float sampleHz) {
+    float w = FAST_MATH_TWO_PI * freqHz / sampleHz;
+    float s1, c1, s2, c2;
+    FastMath_sinCos(w, &s1, &c1);
+    FastMath_sinCos(2.0f * w, &s2, &c2);
+    float nr = c->b0 + c->b1 * c1 + c->b2 * c2;
+    float ni = c->b1 * s1 + c->b2 * s2;
+    float dr = 1.0f + c->a1 * c1 + c->a2 * c2;
+    float di = c->a1 * s1 + c->a2 * s2;
+    float den = dr * dr + di * di;
+    if (!(den > 0.0f)) return 0.0f;
+    return FastMath_sqrt((nr * nr + ni * ni) / den);
+}
+
+static int32_t toQ(float v) {
+    float scaled = v * (float)(1L << BIQUAD_FRAC_BITS);
+    if (scaled >= 2147483520.0f) return INT32_MAX;  // Largest float below 2^31
+    if (scaled <= -2147483648.0f) return INT32_MIN;
+    return (int32_t)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+}
+
+void Biquad_toFixed(const BiquadCoefs* c, BiquadCoefsQ* q) {
+    q->b0 = toQ(c->b0);
+    q->b1 = toQ(c->b1);
+    q->b2 = toQ(c->b2);
+    q->a1 = toQ(c->a1);
+    q->a2 = toQ(c->a2);
+}
+
+// ============================================================================
+// Float cascade
+// ============================================================================
+
+void BiquadCascade_init(BiquadCascade* f, uint8_t channels) {
+    memset(f, 0, sizeof(*f));
+    f->channels = clampChannels(channels);
+}
+
+bool BiquadCascade_addStage(BiquadCascade* f, const BiquadCoefs* c) {
+    if (f->stages >= BIQUAD_MAX_STAGES) return false;
+    f->coefs[f->stages] = *c;
+    memset(f->s1[f->stages], 0, sizeof(f->s1[0]));
+    memset(f->s2[f->stages], 0, sizeof(f->s2[0]));
+    f->stages++;
+    return true;
+}
+
+bool BiquadCascade_setStage(BiquadCascade* f, uint8_t stage, const BiquadCoefs* c) {
+    if (stage >= f->stages) return false;
+    f->coefs[stage] = *c;
+    return true;
+}
+
+void BiquadCascade_reset(BiquadCascade* f) {
+    memset(f->s1, 0, sizeof(f->s1));
+    memset(f->s2, 0, sizeof(f->s2));
+}
+
+void BiquadCascade_settle(BiquadCascade* f, const float* frame) {
+    for (uint8_t ch = 0; ch < f->channels; ch++) {
+        float x = frame[ch];
+        for (uint8_t st = 0; st < f->stages; st++) {
+            const BiquadCoefs* c = &f->coefs[st];
+            float den = 1.0f + c->a1 + c->a2;
+            float y = den != 0.0f ? x * (c->b0 + c->b1 + c->b2) / den : x;
+            f->s2[st][ch] = c->b2 * x - c->a2 * y;
+            f->s1[st][ch] = c->b1 * x - c->a1 * y + f->s2[st][ch];
+            x = y;
+        }
+    }
+}
+
+void BiquadCascade_applyBlock(BiquadCascade* f, float* frames, size_t count) {
+    const uint8_t channels = f->channels;
+    for (uint8_t st = 0; st < f->stages; st++) {
+        const float b0 = f->coefs[st].b0, b1 = f->coefs[st].b1, b2 = f->coefs[st].b2;
+        const float a1 = f->coefs[st].a1, a2 = f->coefs[st].a2;
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            float s1 = f->s1[st][ch];
+            float s2 = f->s2[st][ch];
+            float* x = frames + ch;
+            for (size_t i = 0; i < count; i++, x += channels) {
+                float in = *x;
+                float y = b0 * in + s1;
+                s1 = b1 * in - a1 * y + s2;
+                s2 = b2 * in - a2 * y;
+                *x = y;
+            }
+            f->s1[st][ch] = s1;
+            f->s2[st][ch] = s2;
+        }
+    }
+}
+
+// ============================================================================
+// Fixed-point cascade
+// ============================================================================
+
+void BiquadCascadeQ_init(BiquadCascadeQ* f, uint8_t channels) {
+    memset(f, 0, sizeof(*f));
+    f->channels = clampChannels(channels);
+}
+
+bool BiquadCascadeQ_addStage(BiquadCascadeQ* f, const BiquadCoefs* c) {
+    if (f->stages >= BIQUAD_MAX_STAGES) return false;
+    uint8_t st = f->stages++;
+    Biquad_toFixed(c, &f->coefs[st]);
+    memset(f->x1[st], 0, sizeof(f->x1[0]));
+    memset(f->x2[st], 0, sizeof(f->x2[0]));
+    memset(f->y1[st], 0, sizeof(f->y1[0]));
+    memset(f->y2[st], 0, sizeof(f->y2[0]));
+    return true;
+}
+
+void BiquadCascadeQ_reset(BiquadCascadeQ* f) {
+    memset(f->x1, 0, sizeof(f->x1));
+    memset(f->x2, 0, sizeof(f->x2));
+    memset(f->y1, 0, sizeof(f->y1));
+    memset(f->y2, 0, sizeof(f->y2));
+}
+
+void BiquadCascadeQ_applyBlock(BiquadCascadeQ* f, int32_t* frames, size_t count) {
+    const uint8_t channels = f->channels;
+    const int64_t round = (int64_t)1 << (BIQUAD_FRAC_BITS - 1);
+    for (uint8_t st = 0; st < f->stages; st++) {
+        const BiquadCoefsQ c = f->coefs[st];
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            int32_t x1 = f->x1[st][ch], x2 = f->x2[st][ch];
+            int32_t y1 = f->y1[st][ch], y2 = f->y2[st][ch];
+            int32_t* x = frames + ch;
+            for (size_t i = 0; i < count; i++, x += channels) {
+                int32_t in = *x;
+                int64_t acc = (int64_t)c.b0 * in + (int64_t)c.b1 * x1 + (int64_t)c.b2 * x2 -
+                              (int64_t)c.a1 * y1 - (int64_t)c.a2 * y2;
+                int64_t y = (acc + round) >> BIQUAD_FRAC_BITS;
+                if (y > INT32_MAX) y = INT32_MAX;
+                else if (y < INT32_MIN) y = INT32_MIN;
+                x2 = x1;
+                x1 = in;
+                y2 = y1;
+                y1 = (int32_t)y;
+                *x = y1;
+            }
+            f->x1[st][ch] = x1;
+            f->x2[st][ch] = x2;
+            f->y1[st][ch] = y1;
+            f->y2[st][ch] = y2;
+        }
+    }
+}
+
+// ============================================================================
+// Chain configuration
+// ============================================================================
+
+void BiquadChain_defaultConfig(BiquadChainConfig* config) {
+    config->lowpassHz = 0.0f;
+    config->lowpassStages = 1;
+    config->notchHz = 0.0f;
+    config->notchQ = 5.0f;
+}
+
+static float clampCorner(float hz, float sampleHz) {
+    if (!(hz > 0.0f))
+        return 0.0f;        // Also NaN
+    float limit = LIMIT_FRACTION * sampleHz;
+    return hz > limit ? limit : hz;
+}
+
+void BiquadChain_sanitize(BiquadChainConfig* config, float sampleHz) {
+    config->lowpassHz = clampCorner(config->lowpassHz, sampleHz);
+    config->notchHz = clampCorner(config->notchHz, sampleHz);
+    if (config->lowpassStages < 1)
+        config->lowpassStages = 1;
+    else if (config->lowpassStages > BIQUAD_MAX_LOWPASS_STAGES)
+        config->lowpassStages = BIQUAD_MAX_LOWPASS_STAGES;
+    if (!(config->notchQ >= BIQUAD_MIN_NOTCH_Q))
+        config->notchQ = BIQUAD_MIN_NOTCH_Q;
+    else if (config->notchQ > BIQUAD_MAX_NOTCH_Q)
+        config->notchQ = BIQUAD_MAX_NOTCH_Q;
+}
+
+void BiquadChain_build(BiquadCascade* f, const BiquadChainConfig* config, float sampleHz,
+                       uint8_t channels) {
+    BiquadCascade_init(f, channels);
+    BiquadCoefs c;
+    if (config->lowpassHz > 0.0f) {
+        // 4th order Butterworth as two sections with Q 0.541 and 1.307;
+        // 2nd order is one section at 0.707
+        static const float Q2[2] = {0.54119610f, 1.30656296f};
+        for (uint8_t i = 0; i < config->lowpassStages; i++) {
+            float q = config->lowpassStages == 2 ? Q2[i] : BIQUAD_Q_BUTTERWORTH;
+            if (Biquad_lowpass(&c, config->lowpassHz, sampleHz, q))
+                BiquadCascade_addStage(f, &c);
+        }
+    }
+    if (config->notchHz > 0.0f && Biquad_notch(&c, config->notchHz, sampleHz, config->notchQ))
+        BiquadCascade_addStage(f, &c);
+}
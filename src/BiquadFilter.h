@@ -0,0 +1,200 @@
+#ifndef BIQUAD_FILTER_H
+#define BIQUAD_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * BiquadFilter - Cascaded biquads for gyro / D-term / actuator chains
+ *
+ * A cascade is up to BIQUAD_MAX_STAGES second-order sections run in
+ * series over up to BIQUAD_MAX_CHANNELS channels (x / y / z) that share
+ * the coefficients. Coefficients are designed once (RBJ cookbook
+ * low-pass and notch) and stay in the cascade; per-sample work is
+ * multiply-adds only.
+ *
+ * State is structure-of-arrays, state[stage][channel], so the channel
+ * loop of one stage touches consecutive words, and whole blocks are
+ * filtered at once: a FIFO burst of N frames (interleaved x y z x y z
+ * ...) goes through BiquadCascade_applyBlock in place.
+ *
+ * Two variants with the same structure:
+ * - float, transposed direct form II (two state words per section)
+ * - fixed point, direct form I on int32 samples with Q4.28 coefficients
+ *   and a 64-bit accumulator: no float unit needed, bit-exact on any
+ *   core, and the rounding error does not build up in the state. Samples
+ *   must stay within +-2^23 (raw 16-bit sensor counts have 128x
+ *   headroom). bench_main.cpp times both in cycles per sample.
+ *
+ * A chain for one signal is described by BiquadChainConfig (low-pass
+ * order and cutoff, one notch) and stored as a config blob; the gyro
+ * chain uses GYRO_FILTER_CONFIG_KEY.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file BiquadFilter.h
+ */
+
+#define BIQUAD_MAX_STAGES       4
+#define BIQUAD_MAX_CHANNELS     3
+#define BIQUAD_Q_BUTTERWORTH    0.70710678f
+#define BIQUAD_FRAC_BITS        28          // Fixed-point coefficients, Q4.28
+#define BIQUAD_FIXED_MAX_SAMPLE (1L << 23)
+
+#define GYRO_FILTER_CONFIG_KEY  "cfg_gyro_filt"
+#define BIQUAD_MAX_LOWPASS_STAGES 2         // 4th order
+#define BIQUAD_MIN_NOTCH_Q      0.5f
+#define BIQUAD_MAX_NOTCH_Q      20.0f
+
+/**
+ * One section: y = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2) x
+ */
+typedef struct {
+    float b0, b1, b2, a1, a2;
+} BiquadCoefs;
+
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;             // Q4.28
+} BiquadCoefsQ;
+
+typedef struct {
+    uint8_t stages;
+    uint8_t channels;
+    BiquadCoefs coefs[BIQUAD_MAX_STAGES];
+    float s1[BIQUAD_MAX_STAGES][BIQUAD_MAX_CHANNELS];
+    float s2[BIQUAD_MAX_STAGES][BIQUAD_MAX_CHANNELS];
+} BiquadCascade;
+
+typedef struct {
+    uint8_t stages;
+    uint8_t channels;
+    BiquadCoefsQ coefs[BIQUAD_MAX_STAGES];
+    int32_t x1[BIQUAD_MAX_STAGES][BIQUAD_MAX_CHANNELS];
+    int32_t x2[BIQUAD_MAX_STAGES][BIQUAD_MAX_CHANNELS];
+    int32_t y1[BIQUAD_MAX_STAGES][BIQUAD_MAX_CHANNELS];
+    int32_t y2[BIQUAD_MAX_STAGES][BIQUAD_MAX_CHANNELS];
+} BiquadCascadeQ;
+
+/**
+ * A filter chain: low-pass (0-2 Butterworth sections) then one notch
+ */
+typedef struct {
+    float lowpassHz;            // 0 = off
+    uint8_t lowpassStages;      // 1 = 2nd order, 2 = 4th order
+    float notchHz;              // 0 = off
+    float notchQ;               // Center / bandwidth
+} BiquadChainConfig;
+
+// ============================================================================
+// Design
+// ============================================================================
+
+/**
+ * Coefficients that pass the signal unchanged
+ */
+void Biquad_passthrough(BiquadCoefs* c);
+
+/**
+ * Second-order low-pass
+ * @param q BIQUAD_Q_BUTTERWORTH for a flat pass band
+ * @return false (and passthrough) if cutoff is not in (0, sampleHz / 2)
+ */
+bool Biquad_lowpass(BiquadCoefs* c, float cutoffHz, float sampleHz, float q);
+
+/**
+ * Notch, unity gain away from the center
+ * @param q Center / -3 dB bandwidth
+ * @return false (and passthrough) if center is not in (0, sampleHz / 2)
+ */
+bool Biquad_notch(BiquadCoefs* c, float centerHz, float sampleHz, float q);
+
+/**
+ * Magnitude response of one section at a frequency
+ */
+float Biquad_gain(const BiquadCoefs* c, float freqHz, float sampleHz);
+
+/**
+ * Round coefficients to Q4.28
+ */
+void Biquad_toFixed(const BiquadCoefs* c, BiquadCoefsQ* q);
+
+// ============================================================================
+// Float cascade
+// ============================================================================
+
+/**
+ * Empty cascade (no stages: passes through) over 1..BIQUAD_MAX_CHANNELS
+ */
+void BiquadCascade_init(BiquadCascade* f, uint8_t channels);
+
+/**
+ * Append a section
+ * @return false if the cascade is full
+ */
+bool BiquadCascade_addStage(BiquadCascade* f, const BiquadCoefs* c);
+
+/**
+ * Replace the coefficients of a section, keeping its state (e.g. a notch
+ * that follows a frequency)
+ */
+bool BiquadCascade_setStage(BiquadCascade* f, uint8_t stage, const BiquadCoefs* c);
+
+/**
+ * Zero the state
+ */
+void BiquadCascade_reset(BiquadCascade* f);
+
+/**
+ * Set the state to the steady state of a constant input, so the first
+ * outputs do not ramp up from zero
+ */
+void BiquadCascade_settle(BiquadCascade* f, const float* frame);
+
+/**
+ * Filter frames in place
+ * @param frames count frames of f->channels values each, interleaved
+ */
+void BiquadCascade_applyBlock(BiquadCascade* f, float* frames, size_t count);
+
+/**
+ * Filter one frame in place
+ */
+static inline void BiquadCascade_apply(BiquadCascade* f, float* frame) {
+    BiquadCascade_applyBlock(f, frame, 1);
+}
+
+// ============================================================================
+// Fixed-point cascade
+// ============================================================================
+
+void BiquadCascadeQ_init(BiquadCascadeQ* f, uint8_t channels);
+bool BiquadCascadeQ_addStage(BiquadCascadeQ* f, const BiquadCoefs* c);
+void BiquadCascadeQ_reset(BiquadCascadeQ* f);
+
+/**
+ * Filter frames in place (samples within +-BIQUAD_FIXED_MAX_SAMPLE)
+ */
+void BiquadCascadeQ_applyBlock(BiquadCascadeQ* f, int32_t* frames, size_t count);
+
+// ============================================================================
+// Chain configuration
+// ============================================================================
+
+/**
+ * Default gyro chain: everything off (the IMU's own DLPF only)
+ */
+void BiquadChain_defaultConfig(BiquadChainConfig* config);
+
+/**
+ * Clamp a configuration into its valid ranges for a sample rate
+ */
+void BiquadChain_sanitize(BiquadChainConfig* config, float sampleHz);
+
+/**
+ * Build a cascade from a configuration (state cleared)
+ */
+void BiquadChain_build(BiquadCascade* f, const BiquadChainConfig* config, float sampleHz,
+                       uint8_t channels);
+
+#endif // BIQUAD_FILTER_H
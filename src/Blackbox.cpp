@@ -0,0 +1,403 @@
+#include "Blackbox.h"
+#include <string.h>
+#include "BlackboxCodec.h"
+#include "Crc16.h"
+#include "MemPlacement.h"
+
+/**
+ * Blackbox - Implementation
+ *
+ * Sector format helpers are pure (host tests); the partition writer below
+ * is target only. The writer owns two sector images: one filling from the
+ * ring through the block encoder, one being programmed page by page. If
+ * both are busy (no erased sector in flight), further records are
+ * dropped.
+ *
+ * @file Blackbox.cpp
+ */
+
+#define HEADER_SIZE sizeof(BlackboxSectorHeader)
+#define BLOCK_SIZE sizeof(BlackboxBlockHeader)
+
+static const BlackboxField SCHEMA[] = {
+    {"time_ms", BLACKBOX_TYPE_U32, 1},   {"seq", BLACKBOX_TYPE_U32, 1},
+    {"throttle", BLACKBOX_TYPE_I16, 1},  {"roll", BLACKBOX_TYPE_I16, 1},
+    {"pitch", BLACKBOX_TYPE_I16, 1},     {"yaw", BLACKBOX_TYPE_I16, 1},
+    {"mode", BLACKBOX_TYPE_U8, 1},       {"failsafe", BLACKBOX_TYPE_U8, 1},
+    {"outputs", BLACKBOX_TYPE_U8, 4},    {"att_roll", BLACKBOX_TYPE_I16, 1},
+    {"att_pitch", BLACKBOX_TYPE_I16, 1}, {"heading", BLACKBOX_TYPE_U16, 1},
+    {"nav_dist", BLACKBOX_TYPE_U16, 1},  {"waypoint", BLACKBOX_TYPE_U16, 1},
+    {"nav_flags", BLACKBOX_TYPE_U8, 1},  {"depth", BLACKBOX_TYPE_I16, 1},
+    {"battery", BLACKBOX_TYPE_U16, 1},   {"loop_us", BLACKBOX_TYPE_U16, 1},
+    {"time_sync", BLACKBOX_TYPE_U8, 1},  {"utc_s", BLACKBOX_TYPE_U32, 1},
+    {"utc_ms", BLACKBOX_TYPE_U16, 1},    {"pilot", BLACKBOX_TYPE_I16, 4},
+    {"pmode", BLACKBOX_TYPE_U8, 1},      {"link_age", BLACKBOX_TYPE_U16, 1},
+    {"nav_lat", BLACKBOX_TYPE_I32, 1},   {"nav_lng", BLACKBOX_TYPE_I32, 1},
+    {"gyro", BLACKBOX_TYPE_I16, 3},      {"depth_tgt", BLACKBOX_TYPE_I16, 1},
+    {"inputs", BLACKBOX_TYPE_U8, 1},
+};
+#define SCHEMA_COUNT (sizeof(SCHEMA) / sizeof(SCHEMA[0]))
+
+static_assert(sizeof(BlackboxRecord) == 74, "record layout changed: bump BLACKBOX_VERSION");
+static_assert(sizeof(BlackboxSectorHeader) == 16, "header layout changed");
+static_assert(sizeof(BlackboxBlockHeader) == 12, "block header layout changed");
+static_assert(HEADER_SIZE + SCHEMA_COUNT * sizeof(BlackboxField) <= BLACKBOX_SECTOR_SIZE,
+              "schema does not fit a sector");
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static BlackboxBlockHeader block_at(const uint8_t *sector) {
+  BlackboxBlockHeader b;
+  memcpy(&b, sector + HEADER_SIZE, BLOCK_SIZE);
+  return b;
+}
+
+static size_t payload_size(const uint8_t *sector, const BlackboxSectorHeader *h) {
+  if (h->kind == BLACKBOX_KIND_SCHEMA)
+    return h->count * sizeof(BlackboxField);
+  if (h->kind == BLACKBOX_KIND_PACKED)
+    return BLOCK_SIZE + block_at(sector).bytes;
+  return h->count * (size_t)h->recordSize;
+}
+
+static uint16_t sector_crc(const uint8_t *sector, const BlackboxSectorHeader *h) {
+  return Crc16_compute(sector + HEADER_SIZE, payload_size(sector, h));
+}
+
+// ============================================================================
+// Sector Format
+// ============================================================================
+
+const BlackboxField *Blackbox_getSchema(uint8_t *count) {
+  if (count)
+    *count = (uint8_t)SCHEMA_COUNT;
+  return SCHEMA;
+}
+
+uint8_t Blackbox_typeSize(uint8_t type) {
+  switch (type) {
+  case BLACKBOX_TYPE_U8:
+  case BLACKBOX_TYPE_I8:
+    return 1;
+  case BLACKBOX_TYPE_U16:
+  case BLACKBOX_TYPE_I16:
+    return 2;
+  case BLACKBOX_TYPE_U32:
+  case BLACKBOX_TYPE_I32:
+  case BLACKBOX_TYPE_F32:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+void Blackbox_startSector(uint8_t *sector, uint8_t kind, uint16_t session, uint32_t sequence) {
+  memset(sector, 0xFF, BLACKBOX_SECTOR_SIZE);
+  BlackboxSectorHeader h;
+  h.magic = BLACKBOX_MAGIC;
+  h.sequence = sequence;
+  h.session = session;
+  h.kind = kind;
+  h.count = 0;
+  h.version = BLACKBOX_VERSION;
+  h.recordSize = (uint8_t)sizeof(BlackboxRecord);
+  h.crc = 0;
+  memcpy(sector, &h, HEADER_SIZE);
+}
+
+void Blackbox_writeSchema(uint8_t *sector, uint16_t session, uint32_t sequence) {
+  Blackbox_startSector(sector, BLACKBOX_KIND_SCHEMA, session, sequence);
+  memcpy(sector + HEADER_SIZE, SCHEMA, sizeof(SCHEMA));
+  BlackboxSectorHeader *h = (BlackboxSectorHeader *)sector;
+  h->count = (uint8_t)SCHEMA_COUNT;
+}
+
+bool Blackbox_appendRecord(uint8_t *sector, const BlackboxRecord *record) {
+  BlackboxSectorHeader *h = (BlackboxSectorHeader *)sector;
+  if (h->kind != BLACKBOX_KIND_DATA || h->count >= BLACKBOX_RECORDS_PER_SECTOR)
+    return false;
+  memcpy(sector + HEADER_SIZE + h->count * sizeof(BlackboxRecord), record,
+         sizeof(BlackboxRecord));
+  h->count++;
+  return true;
+}
+
+void Blackbox_startPacked(uint8_t *sector, BlackboxCodec *codec, uint16_t session,
+                          uint32_t sequence) {
+  Blackbox_startSector(sector, BLACKBOX_KIND_PACKED, session, sequence);
+  BlackboxBlockHeader b = {};
+  memcpy(sector + HEADER_SIZE, &b, BLOCK_SIZE);
+  BlackboxCodec_begin(codec, SCHEMA, (uint8_t)SCHEMA_COUNT, sector + HEADER_SIZE + BLOCK_SIZE,
+                      (uint16_t)BLACKBOX_BLOCK_CAPACITY);
+}
+
+bool Blackbox_appendPacked(uint8_t *sector, BlackboxCodec *codec, const BlackboxRecord *record) {
+  const BlackboxSectorHeader *h = (const BlackboxSectorHeader *)sector;
+  if (h->kind != BLACKBOX_KIND_PACKED || !BlackboxCodec_append(codec, (const uint8_t *)record))
+    return false;
+  BlackboxBlockHeader b = block_at(sector);
+  if (b.count == 0)
+    b.firstMs = record->timeMs;
+  b.lastMs = record->timeMs;
+  b.count = codec->count;
+  b.bytes = BlackboxCodec_size(codec);
+  memcpy(sector + HEADER_SIZE, &b, BLOCK_SIZE);
+  return true;
+}
+
+void Blackbox_sealSector(uint8_t *sector) {
+  BlackboxSectorHeader *h = (BlackboxSectorHeader *)sector;
+  h->crc = sector_crc(sector, h);
+}
+
+bool Blackbox_checkSector(const uint8_t *sector, BlackboxSectorHeader *header) {
+  BlackboxSectorHeader h;
+  memcpy(&h, sector, HEADER_SIZE);
+  if (h.magic != BLACKBOX_MAGIC || h.version != BLACKBOX_VERSION)
+    return false;
+  if (h.kind == BLACKBOX_KIND_SCHEMA) {
+    if (HEADER_SIZE + h.count * sizeof(BlackboxField) > BLACKBOX_SECTOR_SIZE)
+      return false;
+  } else if (h.kind == BLACKBOX_KIND_DATA) {
+    if (h.recordSize == 0 || HEADER_SIZE + h.count * (size_t)h.recordSize > BLACKBOX_SECTOR_SIZE)
+      return false;
+  } else if (h.kind == BLACKBOX_KIND_PACKED) {
+    if (h.recordSize == 0 || block_at(sector).bytes > BLACKBOX_BLOCK_CAPACITY)
+      return false;
+  } else {
+    return false;
+  }
+  if (sector_crc(sector, &h) != h.crc)
+    return false;
+  if (header)
+    *header = h;
+  return true;
+}
+
+const BlackboxRecord *Blackbox_sectorRecord(const uint8_t *sector, uint8_t i) {
+  const BlackboxSectorHeader *h = (const BlackboxSectorHeader *)sector;
+  if (h->kind != BLACKBOX_KIND_DATA || h->recordSize != sizeof(BlackboxRecord) || i >= h->count)
+    return NULL;
+  return (const BlackboxRecord *)(sector + HEADER_SIZE + i * sizeof(BlackboxRecord));
+}
+
+bool Blackbox_openPacked(const uint8_t *sector, BlackboxCodec *codec) {
+  const BlackboxSectorHeader *h = (const BlackboxSectorHeader *)sector;
+  if (h->kind != BLACKBOX_KIND_PACKED || h->recordSize != sizeof(BlackboxRecord))
+    return false;
+  BlackboxBlockHeader b = block_at(sector);
+  return BlackboxCodec_open(codec, SCHEMA, (uint8_t)SCHEMA_COUNT,
+                            sector + HEADER_SIZE + BLOCK_SIZE, b.bytes, b.count);
+}
+
+bool Blackbox_sectorSpan(const uint8_t *sector, uint16_t *count, uint32_t *firstMs,
+                         uint32_t *lastMs) {
+  const BlackboxSectorHeader *h = (const BlackboxSectorHeader *)sector;
+  if (h->kind == BLACKBOX_KIND_PACKED) {
+    BlackboxBlockHeader b = block_at(sector);
+    if (b.count == 0 || b.bytes > BLACKBOX_BLOCK_CAPACITY)
+      return false;
+    *count = b.count;
+    *firstMs = b.firstMs;
+    *lastMs = b.lastMs;
+    return true;
+  }
+  const BlackboxRecord *first = Blackbox_sectorRecord(sector, 0);
+  if (!first)
+    return false;
+  *count = h->count;
+  *firstMs = first->timeMs;
+  *lastMs = Blackbox_sectorRecord(sector, h->count - 1)->timeMs;
+  return true;
+}
+
+void Blackbox_scan(BlackboxScan *scan, uint16_t index, const BlackboxSectorHeader *header) {
+  if (!header || header->magic != BLACKBOX_MAGIC || header->version != BLACKBOX_VERSION)
+    return;
+  if (!scan->found || (int32_t)(header->sequence - scan->sequence) > 0) {
+    scan->found = true;
+    scan->index = index;
+    scan->sequence = header->sequence;
+    scan->session = header->session;
+  }
+}
+
+// ============================================================================
+// Writer (target only)
+// ============================================================================
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "SPSCRing.h"
+
+#define PAGES_PER_SECTOR (BLACKBOX_SECTOR_SIZE / BLACKBOX_PAGE_SIZE)
+#define PAGE_DONE 0xFF
+
+static SPSCRing<BlackboxRecord, BLACKBOX_RING_SIZE> ring;
+static volatile bool active = false;
+
+// Blackbox task only
+static struct {
+  const esp_partition_t *part;
+  uint16_t sectors;
+  uint16_t head;
+  uint16_t erasedAhead;
+  uint16_t session;
+  uint32_t nextSequence;
+  uint8_t fill;       // Image being filled
+  bool writing;       // The other image is being programmed
+  uint8_t nextPage;   // 1..15, then 0 (header last), PAGE_DONE
+  bool idle;          // Last record had every output at zero
+  uint32_t records;
+  uint32_t lostFull;
+  uint32_t sectorsWritten;
+  uint32_t erases;
+} bb;
+static uint8_t images[2][BLACKBOX_SECTOR_SIZE];
+static BlackboxCodec codec;     // Encoder of images[bb.fill]
+
+static BlackboxStats stats;
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t sector_offset(uint16_t index) { return (uint32_t)index * BLACKBOX_SECTOR_SIZE; }
+
+static void start_data_sector(void) {
+  Blackbox_startPacked(images[bb.fill], &codec, bb.session, bb.nextSequence++);
+}
+
+// Hand the filled image to the programmer, keep filling the other one
+static void swap_images(void) {
+  Blackbox_sealSector(images[bb.fill]);
+  bb.writing = true;
+  bb.nextPage = 1;
+  bb.fill ^= 1;
+  start_data_sector();
+}
+
+static bool erase_at(uint16_t index) {
+  if (esp_partition_erase_range(bb.part, sector_offset(index), BLACKBOX_SECTOR_SIZE) != ESP_OK)
+    return false;
+  bb.erases++;
+  return true;
+}
+
+// One flash operation per call: erase the head if needed, else one page
+static void program_step(void) {
+  if (bb.erasedAhead == 0) {
+    if (bb.idle && erase_at(bb.head))
+      bb.erasedAhead = 1;
+    return;
+  }
+  const uint8_t *image = images[bb.fill ^ 1];
+  uint32_t offset = sector_offset(bb.head) + bb.nextPage * BLACKBOX_PAGE_SIZE;
+  if (esp_partition_write(bb.part, offset, image + bb.nextPage * BLACKBOX_PAGE_SIZE,
+                          BLACKBOX_PAGE_SIZE) != ESP_OK)
+    return; // Retried next tick
+  if (bb.nextPage == 0) {
+    bb.nextPage = PAGE_DONE;
+    bb.writing = false;
+    uint16_t count;
+    uint32_t firstMs, lastMs;
+    if (Blackbox_sectorSpan(image, &count, &firstMs, &lastMs))
+      bb.records += count;
+    bb.sectorsWritten++;
+    bb.erasedAhead--;
+    bb.head = (bb.head + 1) % bb.sectors;
+  } else {
+    bb.nextPage = (bb.nextPage + 1) % PAGES_PER_SECTOR;
+  }
+}
+
+bool Blackbox_begin(void) {
+  bb.part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                     BLACKBOX_PARTITION_LABEL);
+  if (!bb.part || bb.part->size < 2 * BLACKBOX_SECTOR_SIZE) {
+    Serial.println("[BB] No blackbox partition, logging off");
+    return false;
+  }
+  bb.sectors = bb.part->size / BLACKBOX_SECTOR_SIZE;
+
+  // Continue after the newest sector of any earlier session
+  BlackboxScan scan = {};
+  for (uint16_t i = 0; i < bb.sectors; i++) {
+    BlackboxSectorHeader h;
+    if (esp_partition_read(bb.part, sector_offset(i), &h, sizeof(h)) == ESP_OK)
+      Blackbox_scan(&scan, i, &h);
+  }
+  bb.head = scan.found ? (scan.index + 1) % bb.sectors : 0;
+  bb.session = scan.found ? scan.session + 1 : 1;
+  bb.nextSequence = scan.found ? scan.sequence + 1 : 0;
+  bb.erasedAhead = 0; // Nothing known erased: a sector may be half programmed
+
+  // The session opens with its schema
+  bb.fill = 0;
+  Blackbox_writeSchema(images[0], bb.session, bb.nextSequence++);
+  swap_images();
+  bb.idle = true;
+  MemPlacement_note("blackbox", images, sizeof(images), MEM_CLASS_INTERNAL);
+
+  Serial.printf("[BB] Session %u, %u sectors, head %u\n", bb.session, bb.sectors, bb.head);
+  portENTER_CRITICAL(&statsMux);
+  stats.active = true;
+  stats.session = bb.session;
+  stats.sectors = bb.sectors;
+  stats.head = bb.head;
+  portEXIT_CRITICAL(&statsMux);
+  active = true;
+  return true;
+}
+
+void Blackbox_log(const BlackboxRecord *record) {
+  if (active)
+    ring.push(*record);
+}
+
+void Blackbox_service(void) {
+  if (!active)
+    return;
+
+  BlackboxRecord rec;
+  while (ring.readNext(rec)) {
+    bb.idle = (rec.outputs[0] | rec.outputs[1] | rec.outputs[2] | rec.outputs[3]) == 0;
+    if (Blackbox_appendPacked(images[bb.fill], &codec, &rec))
+      continue;
+    if (bb.writing) {
+      bb.lostFull++; // Both images busy: no erased sector while flying
+      continue;
+    }
+    swap_images();
+    Blackbox_appendPacked(images[bb.fill], &codec, &rec);
+  }
+
+  if (bb.writing) {
+    program_step();
+  } else if (bb.idle && bb.erasedAhead < BLACKBOX_ERASE_AHEAD &&
+             bb.erasedAhead < bb.sectors - 1) {
+    if (erase_at((bb.head + bb.erasedAhead) % bb.sectors))
+      bb.erasedAhead++;
+  }
+
+  portENTER_CRITICAL(&statsMux);
+  stats.active = true;
+  stats.session = bb.session;
+  stats.sectors = bb.sectors;
+  stats.head = bb.head;
+  stats.erasedAhead = bb.erasedAhead;
+  stats.records = bb.records;
+  stats.dropped = ring.getDroppedCount() + bb.lostFull;
+  stats.sectorsWritten = bb.sectorsWritten;
+  stats.erases = bb.erases;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+BlackboxStats Blackbox_getStats(void) {
+  portENTER_CRITICAL(&statsMux);
+  BlackboxStats s = stats;
+  portEXIT_CRITICAL(&statsMux);
+  return s;
+}
+
+#endif // __XTENSA__
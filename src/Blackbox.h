@@ -0,0 +1,284 @@
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Blackbox - On-board flight log in a dedicated flash partition
+ *
+ * The control task hands one BlackboxRecord per tick to Blackbox_log(),
+ * a wait-free push into an SPSC ring. The blackbox task (lowest priority,
+ * background core) drains the ring into 4 KB sector images and programs
+ * them into the "blackbox" data partition, which is used as a circular
+ * log: the oldest sectors are overwritten.
+ *
+ * Each sector starts with a BlackboxSectorHeader. A boot opens a new
+ * session whose first sector is a SCHEMA sector: the field table of the
+ * record (name, type, count, in struct order), so a reader can decode
+ * logs from firmware with a different record layout. PACKED sectors then
+ * carry one compressed block each (BlackboxCodec.h): a BlackboxBlockHeader
+ * with the record count and time span, so a reader seeks by time from
+ * the headers alone, then the bit stream. Every block starts from a full
+ * record, so each sector decodes on its own. DATA sectors (records back
+ * to back, uncompressed) are still read. Unused bytes stay 0xFF (erased).
+ *
+ * Flash erase / program suspends the instruction cache on both cores, so
+ * the control loop would stall behind it. Page programs are spread one
+ * per blackbox tick (well under a millisecond each) and the header page
+ * goes last, so a sector is only valid once complete. Sector erases
+ * (tens of ms) only run while the vehicle is idle - every output of the
+ * last record at zero - and keep BLACKBOX_ERASE_AHEAD sectors ready; when
+ * a flight outlasts that reserve, records are dropped and counted rather
+ * than erasing mid-flight.
+ *
+ * @file Blackbox.h
+ */
+
+#define BLACKBOX_PARTITION_LABEL "blackbox"
+#define BLACKBOX_SECTOR_SIZE    4096
+#define BLACKBOX_PAGE_SIZE      256
+#define BLACKBOX_MAGIC          0x4242414EUL    // "NABB"
+#define BLACKBOX_VERSION        3
+#define BLACKBOX_ERASE_AHEAD    192             // ~15 min of flight at 50 Hz (packed)
+#define BLACKBOX_RING_SIZE      64              // Records between drains (1.3 s)
+#define BLACKBOX_FIELD_NAME_LEN 10
+
+// Sector kinds
+#define BLACKBOX_KIND_SCHEMA    1
+#define BLACKBOX_KIND_DATA      2
+#define BLACKBOX_KIND_PACKED    3
+
+// Field types of the schema
+#define BLACKBOX_TYPE_U8        1
+#define BLACKBOX_TYPE_I8        2
+#define BLACKBOX_TYPE_U16       3
+#define BLACKBOX_TYPE_I16       4
+#define BLACKBOX_TYPE_U32       5
+#define BLACKBOX_TYPE_I32       6
+#define BLACKBOX_TYPE_F32       7
+
+// BlackboxRecord.navFlags
+#define BLACKBOX_NAV_MISSION    0x01
+#define BLACKBOX_NAV_RTL        0x02
+#define BLACKBOX_NAV_LOITER     0x04
+#define BLACKBOX_NAV_SURVEY     0x08
+#define BLACKBOX_NAV_DIVING     0x10
+
+// BlackboxRecord.inputs
+#define BLACKBOX_IN_GPS         0x01            // GPS locked this tick
+#define BLACKBOX_IN_ATTITUDE    0x02            // IMU attitude given to the vehicle
+
+#pragma pack(push, 1)
+
+/**
+ * One control tick (74 bytes, little endian)
+ *
+ * The fields from pilot on are what the control stack was given, so a
+ * flight can be run through it again on the host (BlackboxReplay.h).
+ */
+typedef struct {
+    uint32_t timeMs;
+    uint32_t sequence;      // Control frame sequence number
+    int16_t throttle;       // Inputs given to the vehicle (after failsafe / auto)
+    int16_t roll;
+    int16_t pitch;
+    int16_t yaw;
+    uint8_t mode;
+    uint8_t failsafe;       // FailsafeState
+    uint8_t outputs[4];     // Vehicle::getMixedOutput(), 0-100 %
+    int16_t attRoll;        // Centidegrees
+    int16_t attPitch;
+    uint16_t heading;       // Centidegrees, 0-35999
+    uint16_t navDistance;   // Decimeters to the target (saturated)
+    uint16_t waypoint;
+    uint8_t navFlags;       // BLACKBOX_NAV_*
+    int16_t depth;          // Centimeters
+    uint16_t battery;       // Millivolts
+    uint16_t loopUs;        // Control tick duration
+    uint8_t timeSync;       // TimeSyncState of utcS / utcMs
+    uint32_t utcS;          // UTC of timeMs, s since 1970 (0 = no time yet)
+    uint16_t utcMs;         // Millisecond part
+    int16_t pilot[4];       // Sticks before failsafe / auto (throttle, roll, pitch, yaw)
+    uint8_t pilotMode;
+    uint16_t linkAgeMs;     // Since the last valid packet (saturated)
+    int32_t navLat;         // Position given to NavigationManager, deg * 1e7
+    int32_t navLng;
+    int16_t gyro[3];        // Body rates given to the vehicle, mrad/s (IMU axes)
+    int16_t depthTarget;    // Centimeters (depth hold)
+    uint8_t inputs;         // BLACKBOX_IN_*
+} BlackboxRecord;
+
+/**
+ * Start of every sector (16 bytes)
+ */
+typedef struct {
+    uint32_t magic;         // BLACKBOX_MAGIC
+    uint32_t sequence;      // Sectors written before this one, never reused
+    uint16_t session;       // Boot number
+    uint8_t kind;           // BLACKBOX_KIND_*
+    uint8_t count;          // Records (DATA) / fields (SCHEMA) / 0 (PACKED)
+    uint8_t version;        // BLACKBOX_VERSION
+    uint8_t recordSize;     // sizeof(BlackboxRecord) of the writer
+    uint16_t crc;           // NA_CRC16 of the payload in use
+} BlackboxSectorHeader;
+
+/**
+ * Start of a PACKED sector's payload (12 bytes)
+ */
+typedef struct {
+    uint16_t count;         // Records in the block
+    uint16_t bytes;         // Bit stream length
+    uint32_t firstMs;       // time_ms of the first / last record
+    uint32_t lastMs;
+} BlackboxBlockHeader;
+
+/**
+ * Schema entry (12 bytes)
+ */
+typedef struct {
+    char name[BLACKBOX_FIELD_NAME_LEN]; // NUL padded
+    uint8_t type;           // BLACKBOX_TYPE_*
+    uint8_t count;          // Array length (1 = scalar)
+} BlackboxField;
+
+#pragma pack(pop)
+
+#define BLACKBOX_RECORDS_PER_SECTOR \
+    ((BLACKBOX_SECTOR_SIZE - sizeof(BlackboxSectorHeader)) / sizeof(BlackboxRecord))
+#define BLACKBOX_BLOCK_CAPACITY \
+    (BLACKBOX_SECTOR_SIZE - sizeof(BlackboxSectorHeader) - sizeof(BlackboxBlockHeader))
+
+typedef struct BlackboxCodec BlackboxCodec;    // BlackboxCodec.h
+
+/**
+ * Newest sector found by a partition scan
+ */
+typedef struct {
+    bool found;
+    uint16_t index;         // Sector index in the partition
+    uint32_t sequence;
+    uint16_t session;
+} BlackboxScan;
+
+/**
+ * Writer statistics
+ */
+typedef struct {
+    bool active;            // Partition found, logging
+    uint16_t session;
+    uint16_t sectors;       // Partition size in sectors
+    uint16_t head;          // Next sector to write
+    uint16_t erasedAhead;   // Sectors ready at head
+    uint32_t records;       // Records written to sectors
+    uint32_t dropped;       // Lost in the ring or with no erased sector
+    uint32_t sectorsWritten;
+    uint32_t erases;
+} BlackboxStats;
+
+// ============================================================================
+// Sector Format (pure)
+// ============================================================================
+
+/**
+ * Field table of BlackboxRecord
+ * @param count Output: number of fields
+ */
+const BlackboxField* Blackbox_getSchema(uint8_t* count);
+
+/**
+ * Bytes of one value of a field type (0 if unknown)
+ */
+uint8_t Blackbox_typeSize(uint8_t type);
+
+/**
+ * Start an empty sector image (payload 0xFF)
+ */
+void Blackbox_startSector(uint8_t* sector, uint8_t kind, uint16_t session, uint32_t sequence);
+
+/**
+ * Start a SCHEMA sector holding the field table
+ */
+void Blackbox_writeSchema(uint8_t* sector, uint16_t session, uint32_t sequence);
+
+/**
+ * Append a record to a DATA sector image
+ * @return false if the sector is full
+ */
+bool Blackbox_appendRecord(uint8_t* sector, const BlackboxRecord* record);
+
+/**
+ * Start a PACKED sector and its block encoder
+ */
+void Blackbox_startPacked(uint8_t* sector, BlackboxCodec* codec, uint16_t session,
+                          uint32_t sequence);
+
+/**
+ * Compress a record into a PACKED sector image
+ * @return false if the block is full
+ */
+bool Blackbox_appendPacked(uint8_t* sector, BlackboxCodec* codec, const BlackboxRecord* record);
+
+/**
+ * Fill in the header CRC (after the last append)
+ */
+void Blackbox_sealSector(uint8_t* sector);
+
+/**
+ * Validate a sector image (magic, version, kind / count bounds, payload CRC)
+ * @param header Output (may be NULL)
+ */
+bool Blackbox_checkSector(const uint8_t* sector, BlackboxSectorHeader* header);
+
+/**
+ * Record i of a checked DATA sector
+ */
+const BlackboxRecord* Blackbox_sectorRecord(const uint8_t* sector, uint8_t i);
+
+/**
+ * Start decoding a checked PACKED sector of this firmware's record layout
+ * (BlackboxCodec_next() then yields BlackboxRecords)
+ */
+bool Blackbox_openPacked(const uint8_t* sector, BlackboxCodec* codec);
+
+/**
+ * Records and time span of a DATA or PACKED sector, from its headers
+ * @return false for other kinds, an empty sector or a foreign DATA layout
+ */
+bool Blackbox_sectorSpan(const uint8_t* sector, uint16_t* count, uint32_t* firstMs,
+                         uint32_t* lastMs);
+
+/**
+ * Track the newest sector while scanning headers in index order
+ * @param header Header read at index, NULL if the sector is not valid
+ *               (only magic / version are checked: the CRC covers the payload)
+ */
+void Blackbox_scan(BlackboxScan* scan, uint16_t index, const BlackboxSectorHeader* header);
+
+// ============================================================================
+// Writer (target)
+// ============================================================================
+
+/**
+ * Find the partition, continue after the newest sector, open a session
+ * @return false without a "blackbox" partition (logging stays off)
+ */
+bool Blackbox_begin(void);
+
+/**
+ * Queue one record (control task, wait-free)
+ */
+void Blackbox_log(const BlackboxRecord* record);
+
+/**
+ * Drain, program and erase-ahead (blackbox task only)
+ */
+void Blackbox_service(void);
+
+/**
+ * Current statistics
+ */
+BlackboxStats Blackbox_getStats(void);
+
+#endif // BLACKBOX_H
@@ -0,0 +1,332 @@
+#include "BlackboxCodec.h"
+#include <string.h>
+
+/**
+ * BlackboxCodec - Implementation
+ *
+ * The encoder writes straight into the sector image. A record that runs
+ * past the capacity is rolled back: its bits are cleared and the bytes
+ * it touched return to 0xFF, as erased flash.
+ *
+ * @file BlackboxCodec.cpp
+ */
+
+#define NO_WINDOW 0xFF
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static bool is_signed(uint8_t type) {
+  return type == BLACKBOX_TYPE_I8 || type == BLACKBOX_TYPE_I16 || type == BLACKBOX_TYPE_I32;
+}
+
+static uint32_t load(uint8_t type, const uint8_t *p) {
+  switch (type) {
+  case BLACKBOX_TYPE_U8:
+    return p[0];
+  case BLACKBOX_TYPE_I8:
+    return (uint32_t)(int32_t)(int8_t)p[0];
+  case BLACKBOX_TYPE_U16:
+    return (uint32_t)(p[0] | (p[1] << 8));
+  case BLACKBOX_TYPE_I16:
+    return (uint32_t)(int32_t)(int16_t)(p[0] | (p[1] << 8));
+  default:
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+  }
+}
+
+static void store(uint8_t type, uint8_t *p, uint32_t v) {
+  uint8_t size = Blackbox_typeSize(type);
+  for (uint8_t i = 0; i < size; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+
+static int32_t unzigzag(uint32_t z) { return (int32_t)(z >> 1) ^ -(int32_t)(z & 1); }
+
+static void put_bits(BlackboxCodec *c, uint32_t v, uint8_t n) {
+  uint32_t limit = (uint32_t)c->capacity * 8;
+  for (int i = n - 1; i >= 0; i--, c->bitPos++) {
+    if (c->bitPos >= limit)
+      continue; // Overflow: counted, rolled back by the caller
+    uint8_t *byte = &c->data[c->bitPos >> 3];
+    if ((c->bitPos & 7) == 0)
+      *byte = 0;
+    if ((v >> i) & 1)
+      *byte |= (uint8_t)(0x80 >> (c->bitPos & 7));
+  }
+}
+
+static bool get_bits(BlackboxCodec *c, uint8_t n, uint32_t *v) {
+  if (c->bitPos + n > (uint32_t)c->capacity * 8)
+    return false;
+  uint32_t out = 0;
+  for (uint8_t i = 0; i < n; i++, c->bitPos++)
+    out = (out << 1) | ((c->data[c->bitPos >> 3] >> (7 - (c->bitPos & 7))) & 1);
+  *v = out;
+  return true;
+}
+
+static void put_varint(BlackboxCodec *c, uint32_t v) {
+  while (v >= 0x80) {
+    put_bits(c, (v & 0x7F) | 0x80, 8);
+    v >>= 7;
+  }
+  put_bits(c, v, 8);
+}
+
+static bool get_varint(BlackboxCodec *c, uint32_t *v) {
+  uint32_t out = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    uint32_t byte;
+    if (!get_bits(c, 8, &byte))
+      return false;
+    out |= (byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      *v = out;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void put_bucket(BlackboxCodec *c, uint32_t z) {
+  if (z == 0) {
+    put_bits(c, 0, 1);
+  } else if (z < 16) {
+    put_bits(c, 0x2, 2);
+    put_bits(c, z, 4);
+  } else if (z < 256) {
+    put_bits(c, 0x6, 3);
+    put_bits(c, z, 8);
+  } else if (z < 65536) {
+    put_bits(c, 0xE, 4);
+    put_bits(c, z, 16);
+  } else {
+    put_bits(c, 0xF, 4);
+    put_bits(c, z, 32);
+  }
+}
+
+static bool get_bucket(BlackboxCodec *c, uint32_t *z) {
+  static const uint8_t WIDTH[] = {4, 8, 16, 32};
+  uint32_t bit;
+  uint8_t ones = 0;
+  // Unary prefix, at most four ones
+  while (ones < 4) {
+    if (!get_bits(c, 1, &bit))
+      return false;
+    if (!bit)
+      break;
+    ones++;
+  }
+  if (ones == 0) {
+    *z = 0;
+    return true;
+  }
+  return get_bits(c, WIDTH[ones - 1], z);
+}
+
+static void put_xor(BlackboxCodec *c, uint32_t x, uint8_t *lead, uint8_t *trail) {
+  if (x == 0) {
+    put_bits(c, 0, 1);
+    return;
+  }
+  uint8_t lz = (uint8_t)__builtin_clz(x); // x != 0: at most 31
+  uint8_t tz = (uint8_t)__builtin_ctz(x);
+  if (*lead != NO_WINDOW && lz >= *lead && tz >= *trail) {
+    put_bits(c, 0x2, 2);
+    put_bits(c, x >> *trail, (uint8_t)(32 - *lead - *trail));
+    return;
+  }
+  uint8_t len = (uint8_t)(32 - lz - tz);
+  put_bits(c, 0x3, 2);
+  put_bits(c, lz, 5);
+  put_bits(c, len - 1, 5);
+  put_bits(c, x >> tz, len);
+  *lead = lz;
+  *trail = tz;
+}
+
+static bool get_xor(BlackboxCodec *c, uint32_t *x, uint8_t *lead, uint8_t *trail) {
+  uint32_t bit, v;
+  if (!get_bits(c, 1, &bit))
+    return false;
+  if (!bit) {
+    *x = 0;
+    return true;
+  }
+  if (!get_bits(c, 1, &bit))
+    return false;
+  if (!bit) {
+    if (*lead == NO_WINDOW || !get_bits(c, (uint8_t)(32 - *lead - *trail), &v))
+      return false;
+    *x = v << *trail;
+    return true;
+  }
+  uint32_t lz, len;
+  if (!get_bits(c, 5, &lz) || !get_bits(c, 5, &len))
+    return false;
+  len++;
+  if (lz + len > 32 || !get_bits(c, (uint8_t)len, &v))
+    return false;
+  *lead = (uint8_t)lz;
+  *trail = (uint8_t)(32 - lz - len);
+  *x = v << *trail;
+  return true;
+}
+
+// Count the scalars of a field table; false if it cannot be coded
+static bool setup(BlackboxCodec *c, const BlackboxField *fields, uint8_t fieldCount) {
+  memset(c, 0, sizeof(*c));
+  c->fields = fields;
+  c->fieldCount = fieldCount;
+  for (uint8_t f = 0; f < fieldCount; f++) {
+    uint8_t size = Blackbox_typeSize(fields[f].type);
+    if (size == 0)
+      return false;
+    c->values += fields[f].count;
+    c->recordSize += (uint16_t)(size * fields[f].count);
+  }
+  if (c->values == 0 || c->values > BLACKBOX_CODEC_MAX_VALUES)
+    return false;
+  memset(c->lead, NO_WINDOW, sizeof(c->lead));
+  return true;
+}
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+bool BlackboxCodec_begin(BlackboxCodec *codec, const BlackboxField *fields, uint8_t fieldCount,
+                         uint8_t *out, uint16_t capacity) {
+  if (!setup(codec, fields, fieldCount))
+    return false;
+  codec->data = out;
+  codec->capacity = capacity;
+  return true;
+}
+
+bool BlackboxCodec_append(BlackboxCodec *codec, const uint8_t *record) {
+  if (codec->count == 0xFFFF)
+    return false;
+  uint32_t start = codec->bitPos;
+  uint32_t cur[BLACKBOX_CODEC_MAX_VALUES];
+  uint8_t lead[BLACKBOX_CODEC_MAX_VALUES];
+  uint8_t trail[BLACKBOX_CODEC_MAX_VALUES];
+  memcpy(lead, codec->lead, sizeof(lead));
+  memcpy(trail, codec->trail, sizeof(trail));
+  int32_t delta = codec->prevDelta;
+
+  uint16_t k = 0;
+  const uint8_t *p = record;
+  for (uint8_t f = 0; f < codec->fieldCount; f++) {
+    uint8_t type = codec->fields[f].type;
+    uint8_t size = Blackbox_typeSize(type);
+    for (uint8_t e = 0; e < codec->fields[f].count; e++, k++, p += size) {
+      cur[k] = load(type, p);
+      if (codec->count == 0) {
+        // Keyframe
+        if (type == BLACKBOX_TYPE_F32)
+          put_bits(codec, cur[k], 32);
+        else
+          put_varint(codec, is_signed(type) ? zigzag((int32_t)cur[k]) : cur[k]);
+      } else if (type == BLACKBOX_TYPE_F32) {
+        put_xor(codec, cur[k] ^ codec->prev[k], &lead[k], &trail[k]);
+      } else if (k == 0) {
+        delta = (int32_t)(cur[k] - codec->prev[k]);
+        put_bucket(codec, zigzag((int32_t)((uint32_t)delta - (uint32_t)codec->prevDelta)));
+      } else {
+        put_bucket(codec, zigzag((int32_t)(cur[k] - codec->prev[k])));
+      }
+    }
+  }
+
+  if (codec->bitPos > (uint32_t)codec->capacity * 8) {
+    // Roll back: clear this record's bits, give its bytes back
+    uint32_t end = (codec->bitPos + 7) / 8;
+    if (end > codec->capacity)
+      end = codec->capacity;
+    if (start & 7)
+      codec->data[start >> 3] &= (uint8_t)~(0xFF >> (start & 7));
+    uint32_t first = (start + 7) / 8;
+    if (end > first)
+      memset(codec->data + first, 0xFF, end - first);
+    codec->bitPos = start;
+    return false;
+  }
+  memcpy(codec->prev, cur, codec->values * sizeof(uint32_t));
+  memcpy(codec->lead, lead, sizeof(lead));
+  memcpy(codec->trail, trail, sizeof(trail));
+  codec->prevDelta = delta;
+  codec->count++;
+  return true;
+}
+
+uint16_t BlackboxCodec_size(const BlackboxCodec *codec) {
+  return (uint16_t)((codec->bitPos + 7) / 8);
+}
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+bool BlackboxCodec_open(BlackboxCodec *codec, const BlackboxField *fields, uint8_t fieldCount,
+                        const uint8_t *data, uint16_t size, uint16_t count) {
+  if (!setup(codec, fields, fieldCount))
+    return false;
+  codec->data = (uint8_t *)data;
+  codec->capacity = size;
+  codec->count = count;
+  return true;
+}
+
+bool BlackboxCodec_next(BlackboxCodec *codec, uint8_t *record) {
+  if (codec->count == 0)
+    return false;
+  bool keyframe = codec->bitPos == 0;
+
+  uint16_t k = 0;
+  uint8_t *p = record;
+  for (uint8_t f = 0; f < codec->fieldCount; f++) {
+    uint8_t type = codec->fields[f].type;
+    uint8_t size = Blackbox_typeSize(type);
+    for (uint8_t e = 0; e < codec->fields[f].count; e++, k++, p += size) {
+      uint32_t v;
+      if (keyframe) {
+        if (type == BLACKBOX_TYPE_F32) {
+          if (!get_bits(codec, 32, &v))
+            return false;
+        } else {
+          if (!get_varint(codec, &v))
+            return false;
+          if (is_signed(type))
+            v = (uint32_t)unzigzag(v);
+        }
+      } else if (type == BLACKBOX_TYPE_F32) {
+        uint32_t x;
+        if (!get_xor(codec, &x, &codec->lead[k], &codec->trail[k]))
+          return false;
+        v = codec->prev[k] ^ x;
+      } else if (k == 0) {
+        uint32_t z;
+        if (!get_bucket(codec, &z))
+          return false;
+        codec->prevDelta = (int32_t)((uint32_t)codec->prevDelta + (uint32_t)unzigzag(z));
+        v = codec->prev[k] + (uint32_t)codec->prevDelta;
+      } else {
+        uint32_t z;
+        if (!get_bucket(codec, &z))
+          return false;
+        v = codec->prev[k] + (uint32_t)unzigzag(z);
+      }
+      codec->prev[k] = v;
+      store(type, p, v);
+    }
+  }
+  codec->count--;
+  return true;
+}
@@ -0,0 +1,95 @@
+#ifndef BLACKBOX_CODEC_H
+#define BLACKBOX_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Blackbox.h"
+
+/**
+ * BlackboxCodec - Time-series compression of blackbox records
+ *
+ * Packs a run of records into one self-contained block. The codec walks
+ * the schema field table, not BlackboxRecord, so a reader holding a
+ * session's SCHEMA sector decodes blocks of any record layout.
+ *
+ * Bit stream, MSB first:
+ *   - first record (the block's keyframe): every value as a varint,
+ *     zig-zag for signed types; F32 as its 32 raw bits
+ *   - every later value against the previous record:
+ *       field 0 (time_ms, the record clock)  delta-of-delta
+ *       other integers                        delta
+ *       F32                                   XOR of the bits (Gorilla)
+ *
+ * Integer deltas are zig-zag coded and bucketed:
+ *
+ *   0 -> '0'   < 16 -> '10' + 4 bits   < 256 -> '110' + 8
+ *   < 65536 -> '1110' + 16             else '1111' + 32
+ *
+ * An XOR of 0 is '0'; one that fits the previous value's window of
+ * meaningful bits is '10' + those bits; otherwise '11', 5 bits of leading
+ * zeros, 5 bits of length - 1, then the meaningful bits.
+ *
+ * A steady 50 Hz clock costs one bit a record and a field that did not
+ * change one bit. Arithmetic is modulo 2^32, so counters that wrap cost
+ * nothing extra. A block never refers to another: any sector decodes on
+ * its own and a damaged one loses only its own records.
+ *
+ * Pure: no globals, no RTOS. Owned by the blackbox task.
+ *
+ * @file BlackboxCodec.h
+ */
+
+#define BLACKBOX_CODEC_MAX_VALUES   64      // Scalars per record (arrays expanded)
+
+/**
+ * Encoder or decoder of one block
+ */
+typedef struct BlackboxCodec {
+    const BlackboxField* fields;
+    uint8_t fieldCount;
+    uint8_t* data;                  // Block bytes (decoder: read only)
+    uint16_t capacity;              // Bytes available (decoder: block length)
+    uint32_t bitPos;
+    uint16_t count;                 // Records encoded / left to decode
+    uint16_t values;                // Scalars per record
+    uint16_t recordSize;            // Bytes per record
+    // History, rolled back when a record does not fit
+    uint32_t prev[BLACKBOX_CODEC_MAX_VALUES];
+    int32_t prevDelta;              // Of field 0
+    uint8_t lead[BLACKBOX_CODEC_MAX_VALUES];    // F32 XOR window
+    uint8_t trail[BLACKBOX_CODEC_MAX_VALUES];
+} BlackboxCodec;
+
+/**
+ * Start encoding into an empty block
+ * @return false if the field table has an unknown type or too many values
+ */
+bool BlackboxCodec_begin(BlackboxCodec* codec, const BlackboxField* fields, uint8_t fieldCount,
+                         uint8_t* out, uint16_t capacity);
+
+/**
+ * Append one record (laid out as the field table, little endian)
+ * @return false if it does not fit: the block is left as it was
+ */
+bool BlackboxCodec_append(BlackboxCodec* codec, const uint8_t* record);
+
+/**
+ * Bytes of the block so far
+ */
+uint16_t BlackboxCodec_size(const BlackboxCodec* codec);
+
+/**
+ * Start decoding a block of count records
+ */
+bool BlackboxCodec_open(BlackboxCodec* codec, const BlackboxField* fields, uint8_t fieldCount,
+                        const uint8_t* data, uint16_t size, uint16_t count);
+
+/**
+ * Decode the next record
+ * @param record Output, codec->recordSize bytes
+ * @return false after the last record or on a truncated block
+ */
+bool BlackboxCodec_next(BlackboxCodec* codec, uint8_t* record);
+
+#endif // BLACKBOX_CODEC_H
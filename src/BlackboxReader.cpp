@@ -0,0 +1,271 @@
+#include "BlackboxReader.h"
+#include <string.h>
+#include <stdlib.h>
+
+/**
+ * BlackboxReader - Implementation
+ *
+ * The index only reads sector headers (16 bytes each) and the block
+ * header of PACKED sectors (first / last record of DATA ones); payload
+ * CRCs are left to the ground station, which has to check them anyway
+ * after the transfer.
+ *
+ * @file BlackboxReader.cpp
+ */
+
+#define HEADER_SIZE sizeof(BlackboxSectorHeader)
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+// Header plausible enough to list: complete, known kind, payload in bounds
+static bool header_at(const uint8_t *base, uint16_t index, BlackboxSectorHeader *h) {
+  const uint8_t *sector = base + (uint32_t)index * BLACKBOX_SECTOR_SIZE;
+  memcpy(h, sector, HEADER_SIZE);
+  if (h->magic != BLACKBOX_MAGIC || h->version != BLACKBOX_VERSION)
+    return false;
+  if (h->kind == BLACKBOX_KIND_SCHEMA)
+    return HEADER_SIZE + h->count * sizeof(BlackboxField) <= BLACKBOX_SECTOR_SIZE;
+  if (h->kind == BLACKBOX_KIND_DATA)
+    return HEADER_SIZE + h->count * (size_t)h->recordSize <= BLACKBOX_SECTOR_SIZE;
+  if (h->kind == BLACKBOX_KIND_PACKED)
+    return h->recordSize != 0;
+  return false;
+}
+
+static BlackboxFlight *open_flight(BlackboxIndex *index, const BlackboxSectorHeader *h,
+                                   uint16_t sector) {
+  if (index->count == BLACKBOX_MAX_FLIGHTS) {
+    // Walked oldest first: drop the oldest
+    memmove(&index->flights[0], &index->flights[1],
+            (BLACKBOX_MAX_FLIGHTS - 1) * sizeof(BlackboxFlight));
+    index->count--;
+  }
+  BlackboxFlight *f = &index->flights[index->count++];
+  memset(f, 0, sizeof(*f));
+  f->session = h->session;
+  f->firstSector = sector;
+  f->sectorCount = 1;
+  f->firstSequence = h->sequence;
+  f->hasSchema = h->kind == BLACKBOX_KIND_SCHEMA;
+  return f;
+}
+
+static bool parse_number(const char **p, uint32_t *value) {
+  if (**p < '0' || **p > '9')
+    return false;
+  char *end;
+  unsigned long v = strtoul(*p, &end, 10);
+  *p = end;
+  *value = (uint32_t)v;
+  return true;
+}
+
+// ============================================================================
+// Index and Ranges
+// ============================================================================
+
+void BlackboxReader_buildIndex(BlackboxIndex *index, const uint8_t *base, uint16_t sectors) {
+  memset(index, 0, sizeof(*index));
+  index->sectors = sectors;
+
+  BlackboxScan scan = {};
+  BlackboxSectorHeader h;
+  for (uint16_t i = 0; i < sectors; i++)
+    Blackbox_scan(&scan, i, header_at(base, i, &h) ? &h : NULL);
+  if (!scan.found)
+    return;
+
+  // Oldest first: the sector after the newest, around the partition once.
+  // Anything unlisted (erased, half programmed) ends the current run.
+  BlackboxFlight *flight = NULL;
+  for (uint16_t k = 0; k < sectors; k++) {
+    uint16_t i = (uint16_t)((scan.index + 1 + k) % sectors);
+    if (!header_at(base, i, &h)) {
+      flight = NULL;
+      continue;
+    }
+    if (flight && flight->session == h.session)
+      flight->sectorCount++;
+    else
+      flight = open_flight(index, &h, i);
+
+    uint16_t count;
+    uint32_t firstMs, lastMs;
+    if (!Blackbox_sectorSpan(base + (uint32_t)i * BLACKBOX_SECTOR_SIZE, &count, &firstMs,
+                             &lastMs))
+      continue;
+    if (flight->records == 0)
+      flight->startMs = firstMs;
+    flight->endMs = lastMs;
+    flight->records += count;
+  }
+}
+
+const BlackboxFlight *BlackboxReader_findFlight(const BlackboxIndex *index, uint16_t session) {
+  // Newest match: an old session number can survive a partition wipe
+  for (int i = index->count - 1; i >= 0; i--) {
+    if (index->flights[i].session == session)
+      return &index->flights[i];
+  }
+  return NULL;
+}
+
+uint32_t BlackboxReader_flightOffset(const BlackboxFlight *flight, uint16_t sectors,
+                                     uint32_t offset) {
+  uint32_t sector = (flight->firstSector + offset / BLACKBOX_SECTOR_SIZE) % sectors;
+  return sector * BLACKBOX_SECTOR_SIZE + offset % BLACKBOX_SECTOR_SIZE;
+}
+
+bool BlackboxReader_parseRange(const char *value, uint32_t total, uint32_t *first,
+                               uint32_t *last) {
+  if (!value || total == 0 || strncmp(value, "bytes=", 6) != 0)
+    return false;
+  const char *p = value + 6;
+  uint32_t a, b;
+
+  if (*p == '-') {
+    // Suffix: the last n bytes
+    p++;
+    if (!parse_number(&p, &b) || *p != '\0' || b == 0)
+      return false;
+    *first = b >= total ? 0 : total - b;
+    *last = total - 1;
+    return true;
+  }
+
+  if (!parse_number(&p, &a) || *p != '-')
+    return false;
+  p++;
+  if (*p == '\0') {
+    b = total - 1;
+  } else if (!parse_number(&p, &b) || *p != '\0' || b < a) {
+    return false; // Also rejects "a-b,c-d"
+  }
+  if (a >= total)
+    return false;
+  *first = a;
+  *last = b >= total ? total - 1 : b;
+  return true;
+}
+
+// ============================================================================
+// HTTP Routes (target only)
+// ============================================================================
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <esp_partition.h>
+
+static const uint8_t *mapped = NULL;
+static uint16_t mappedSectors = 0;
+static spi_flash_mmap_handle_t mapHandle;
+
+// Routes run one at a time on the async_tcp task
+static BlackboxIndex flightIndex;
+
+static void send_span(AsyncWebServerRequest *request, const BlackboxFlight &span,
+                      const String &filename) {
+  uint32_t total = (uint32_t)span.sectorCount * BLACKBOX_SECTOR_SIZE;
+  uint32_t first = 0, last = total - 1;
+  bool partial = request->hasHeader("Range");
+  if (partial && !BlackboxReader_parseRange(request->getHeader("Range")->value().c_str(), total,
+                                            &first, &last)) {
+    AsyncWebServerResponse *response = request->beginResponse(416);
+    response->addHeader("Content-Range", "bytes */" + String(total));
+    request->send(response);
+    return;
+  }
+
+  uint16_t sectors = mappedSectors;
+  AsyncWebServerResponse *response = request->beginResponse(
+      "application/octet-stream", last - first + 1,
+      [span, sectors, first, last](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+        // Straight from the mapping, split at sector (wrap) boundaries
+        size_t filled = 0;
+        uint32_t pos = first + index;
+        while (filled < maxLen && pos <= last) {
+          size_t n = BLACKBOX_SECTOR_SIZE - pos % BLACKBOX_SECTOR_SIZE;
+          if (n > maxLen - filled)
+            n = maxLen - filled;
+          if (n > last - pos + 1)
+            n = last - pos + 1;
+          memcpy(buffer + filled, mapped + BlackboxReader_flightOffset(&span, sectors, pos), n);
+          filled += n;
+          pos += n;
+        }
+        return filled;
+      });
+  response->addHeader("Accept-Ranges", "bytes");
+  response->addHeader("Content-Disposition", "attachment; filename=\"" + filename + "\"");
+  if (partial) {
+    response->setCode(206);
+    response->addHeader("Content-Range", "bytes " + String(first) + "-" + String(last) + "/" +
+                                             String(total));
+  }
+  request->send(response);
+}
+
+static void handle_index(AsyncWebServerRequest *request) {
+  BlackboxReader_buildIndex(&flightIndex, mapped, mappedSectors);
+  AsyncResponseStream *out = request->beginResponseStream("application/json");
+  out->printf("{\"sectors\":%u,\"sector_size\":%u,\"flights\":[", mappedSectors,
+              BLACKBOX_SECTOR_SIZE);
+  for (uint8_t i = 0; i < flightIndex.count; i++) {
+    const BlackboxFlight *f = &flightIndex.flights[i];
+    out->printf("%s{\"s\":%u,\"first\":%u,\"count\":%u,\"bytes\":%lu,\"schema\":%s,"
+                "\"rec\":%lu,\"start_ms\":%lu,\"end_ms\":%lu}",
+                i ? "," : "", f->session, f->firstSector, f->sectorCount,
+                (unsigned long)f->sectorCount * BLACKBOX_SECTOR_SIZE,
+                f->hasSchema ? "true" : "false", (unsigned long)f->records,
+                (unsigned long)f->startMs, (unsigned long)f->endMs);
+  }
+  out->print("]}");
+  request->send(out);
+}
+
+static void handle_raw(AsyncWebServerRequest *request) {
+  BlackboxFlight all = {};
+  all.sectorCount = mappedSectors;
+  send_span(request, all, "blackbox.bin");
+}
+
+static void handle_flight(AsyncWebServerRequest *request) {
+  if (!request->hasParam("s")) {
+    request->send(400, "text/plain", "missing s");
+    return;
+  }
+  uint16_t session = (uint16_t)request->getParam("s")->value().toInt();
+  BlackboxReader_buildIndex(&flightIndex, mapped, mappedSectors);
+  const BlackboxFlight *flight = BlackboxReader_findFlight(&flightIndex, session);
+  if (!flight) {
+    request->send(404, "text/plain", "no such flight");
+    return;
+  }
+  send_span(request, *flight, "flight_" + String(session) + ".nabb");
+}
+
+bool BlackboxReader_begin(AsyncWebServer *server) {
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, BLACKBOX_PARTITION_LABEL);
+  if (!part)
+    return false;
+  const void *ptr;
+  if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &ptr, &mapHandle) != ESP_OK) {
+    Serial.println("[BB] Log mmap failed, download off");
+    return false;
+  }
+  mapped = (const uint8_t *)ptr;
+  mappedSectors = part->size / BLACKBOX_SECTOR_SIZE;
+
+  // "/log" also matches "/log/..." prefixes: register it last
+  server->on("/log/raw", HTTP_GET, handle_raw);
+  server->on("/log/flight", HTTP_GET, handle_flight);
+  server->on("/log", HTTP_GET, handle_index);
+  Serial.println("[BB] Log download at /log");
+  return true;
+}
+
+#endif // __XTENSA__
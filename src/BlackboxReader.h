@@ -0,0 +1,104 @@
+#ifndef BLACKBOX_READER_H
+#define BLACKBOX_READER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Blackbox.h"
+
+/**
+ * BlackboxReader - Log download over the web server (port 80)
+ *
+ * The "blackbox" partition is mapped once with esp_partition_mmap, so a
+ * download is served straight out of the flash cache: the response filler
+ * copies from the mapping into the TCP buffer, with no read buffer or
+ * esp_partition_read in between, and the writer keeps running.
+ *
+ *   GET /log              Flight index (JSON)
+ *   GET /log/raw          Whole partition, physical sector order
+ *   GET /log/flight?s=N   Sectors of session N in write order
+ *
+ * Both binary routes honour a single "Range: bytes=a-b" request (206 with
+ * Content-Range, 416 if unsatisfiable), so a ground station can fetch one
+ * flight, or resume one, without reading the whole partition.
+ *
+ * A flight is a session: the sectors written between two boots. The
+ * writer fills the partition circularly, so walking it from the sector
+ * after the newest one visits sessions oldest first, each as one
+ * contiguous (possibly wrapping) run of sectors. Sectors still being
+ * programmed have no header yet and are not listed.
+ *
+ * @file BlackboxReader.h
+ */
+
+#define BLACKBOX_MAX_FLIGHTS    32      // Newest kept when there are more
+
+class AsyncWebServer;
+
+/**
+ * One session in the partition
+ */
+typedef struct {
+    uint16_t session;
+    uint16_t firstSector;   // Physical index of its oldest sector
+    uint16_t sectorCount;   // Contiguous, wrapping at the partition end
+    uint32_t firstSequence;
+    bool hasSchema;         // Oldest sector is the schema (not overwritten)
+    uint32_t records;
+    uint32_t startMs;       // First / last record time (0 without records)
+    uint32_t endMs;
+} BlackboxFlight;
+
+/**
+ * Flight index of a partition image
+ */
+typedef struct {
+    uint16_t sectors;       // Partition size in sectors
+    uint8_t count;
+    BlackboxFlight flights[BLACKBOX_MAX_FLIGHTS];
+} BlackboxIndex;
+
+// ============================================================================
+// Index and Ranges (pure)
+// ============================================================================
+
+/**
+ * Build the flight index of a partition image (headers only, no CRC pass)
+ * @param base    Start of the partition (mapping or host buffer)
+ * @param sectors Partition size in sectors
+ */
+void BlackboxReader_buildIndex(BlackboxIndex* index, const uint8_t* base, uint16_t sectors);
+
+/**
+ * Flight of a session, NULL if not in the index
+ */
+const BlackboxFlight* BlackboxReader_findFlight(const BlackboxIndex* index, uint16_t session);
+
+/**
+ * Partition offset of a byte of a flight
+ * @param offset Byte offset within the flight (< sectorCount * sector size)
+ */
+uint32_t BlackboxReader_flightOffset(const BlackboxFlight* flight, uint16_t sectors,
+                                     uint32_t offset);
+
+/**
+ * Parse a single-range "bytes=a-b" / "bytes=a-" / "bytes=-n" header value
+ * @param total Size of the resource
+ * @param first Output: first byte
+ * @param last  Output: last byte (inclusive, clamped to total - 1)
+ * @return false if malformed, multi-range or unsatisfiable
+ */
+bool BlackboxReader_parseRange(const char* value, uint32_t total, uint32_t* first,
+                               uint32_t* last);
+
+// ============================================================================
+// HTTP Routes (target)
+// ============================================================================
+
+/**
+ * Map the partition and register the /log routes (before server->begin())
+ * @return false without a "blackbox" partition or if the mapping fails
+ */
+bool BlackboxReader_begin(AsyncWebServer* server);
+
+#endif // BLACKBOX_READER_H
@@ -0,0 +1,169 @@
+#include "BlackboxReplay.h"
+#include <string.h>
+#include <math.h>
+
+/**
+ * BlackboxReplay - Implementation
+ *
+ * Unlike the flight index, the cursor checks every payload CRC: a replay
+ * fed a torn record would report a control bug that is not there.
+ *
+ * @file BlackboxReplay.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static void open_cursor(BlackboxReplayCursor *cursor, const uint8_t *image, uint16_t sectors) {
+  memset(cursor, 0, sizeof(*cursor));
+  cursor->image = image;
+  cursor->sectors = sectors;
+}
+
+static uint16_t abs_diff(int32_t a, int32_t b) {
+  int32_t d = a - b;
+  return (uint16_t)(d < 0 ? -d : d);
+}
+
+// ============================================================================
+// Cursor
+// ============================================================================
+
+bool BlackboxReplay_openFlight(BlackboxReplayCursor *cursor, const uint8_t *image, size_t size) {
+  if (size == 0 || size % BLACKBOX_SECTOR_SIZE != 0 || size / BLACKBOX_SECTOR_SIZE > 0xFFFF)
+    return false;
+  open_cursor(cursor, image, (uint16_t)(size / BLACKBOX_SECTOR_SIZE));
+  cursor->flight.firstSector = 0;
+  cursor->flight.sectorCount = cursor->sectors;
+  return true;
+}
+
+bool BlackboxReplay_openSession(BlackboxReplayCursor *cursor, const uint8_t *image,
+                                size_t size, uint16_t session) {
+  if (size == 0 || size % BLACKBOX_SECTOR_SIZE != 0 || size / BLACKBOX_SECTOR_SIZE > 0xFFFF)
+    return false;
+  uint16_t sectors = (uint16_t)(size / BLACKBOX_SECTOR_SIZE);
+  static BlackboxIndex index;
+  BlackboxReader_buildIndex(&index, image, sectors);
+  const BlackboxFlight *flight = BlackboxReader_findFlight(&index, session);
+  if (!flight)
+    return false;
+  open_cursor(cursor, image, sectors);
+  cursor->flight = *flight;
+  return true;
+}
+
+const BlackboxRecord *BlackboxReplay_next(BlackboxReplayCursor *cursor) {
+  while (cursor->sector < cursor->flight.sectorCount) {
+    uint32_t offset = BlackboxReader_flightOffset(&cursor->flight, cursor->sectors,
+                                                  (uint32_t)cursor->sector * BLACKBOX_SECTOR_SIZE);
+    const uint8_t *sector = cursor->image + offset;
+    BlackboxSectorHeader h;
+
+    if (cursor->record == 0) {
+      // First visit: schema sectors carry no records, others must check out
+      bool ok = Blackbox_checkSector(sector, &h);
+      if (ok && h.kind == BLACKBOX_KIND_SCHEMA) {
+        cursor->sector++;
+        continue;
+      }
+      if (ok && h.kind == BLACKBOX_KIND_PACKED)
+        ok = Blackbox_openPacked(sector, &cursor->codec);
+      else
+        ok = ok && Blackbox_sectorRecord(sector, 0);
+      if (!ok) {
+        cursor->skipped++;
+        cursor->sector++;
+        continue;
+      }
+    }
+
+    const BlackboxRecord *record;
+    if (((const BlackboxSectorHeader *)sector)->kind == BLACKBOX_KIND_PACKED)
+      record = BlackboxCodec_next(&cursor->codec, (uint8_t *)&cursor->current) ? &cursor->current
+                                                                              : NULL;
+    else
+      record = Blackbox_sectorRecord(sector, (uint8_t)cursor->record);
+    if (record) {
+      cursor->record++;
+      cursor->records++;
+      return record;
+    }
+    cursor->record = 0;
+    cursor->sector++;
+  }
+  return NULL;
+}
+
+// ============================================================================
+// Comparison
+// ============================================================================
+
+uint8_t BlackboxReplay_compare(BlackboxReplayStats *stats, const BlackboxReplayTolerance *tol,
+                               const BlackboxRecord *logged, const BlackboxRecord *replayed) {
+  uint8_t diff = 0;
+
+  // Packed record: copy the axes out rather than walk them by pointer
+  const int16_t a[4] = {logged->throttle, logged->roll, logged->pitch, logged->yaw};
+  const int16_t b[4] = {replayed->throttle, replayed->roll, replayed->pitch, replayed->yaw};
+  for (int i = 0; i < 4; i++) {
+    uint16_t d = abs_diff(a[i], b[i]);
+    if ((int16_t)d > stats->maxInput)
+      stats->maxInput = (int16_t)d;
+    if (d > (uint16_t)tol->input)
+      diff |= BLACKBOX_REPLAY_DIFF_INPUTS;
+  }
+  if (logged->mode != replayed->mode)
+    diff |= BLACKBOX_REPLAY_DIFF_INPUTS;
+
+  for (int i = 0; i < BLACKBOX_REPLAY_OUTPUTS; i++) {
+    uint16_t d = abs_diff(logged->outputs[i], replayed->outputs[i]);
+    if (d > stats->maxOutput[i])
+      stats->maxOutput[i] = (uint8_t)d;
+    stats->sumSqOutput[i] += (float)d * (float)d;
+    if (d > tol->output)
+      diff |= BLACKBOX_REPLAY_DIFF_OUTPUTS;
+  }
+
+  if (logged->failsafe != replayed->failsafe)
+    diff |= BLACKBOX_REPLAY_DIFF_FAILSAFE;
+
+  if (logged->waypoint != replayed->waypoint || logged->navFlags != replayed->navFlags)
+    diff |= BLACKBOX_REPLAY_DIFF_NAV;
+
+  stats->ticks++;
+  if (diff) {
+    if (stats->mismatches == 0) {
+      stats->firstMs = logged->timeMs;
+      stats->firstDiff = diff;
+    }
+    stats->mismatches++;
+    for (int k = 0; k < BLACKBOX_REPLAY_DIFF_KINDS; k++) {
+      if (diff & (1 << k))
+        stats->kinds[k]++;
+    }
+  }
+  return diff;
+}
+
+float BlackboxReplay_outputRms(const BlackboxReplayStats *stats, uint8_t output) {
+  if (stats->ticks == 0 || output >= BLACKBOX_REPLAY_OUTPUTS)
+    return 0.0f;
+  return sqrtf(stats->sumSqOutput[output] / (float)stats->ticks);
+}
+
+const char *BlackboxReplay_diffName(uint8_t diff) {
+  switch (diff) {
+  case BLACKBOX_REPLAY_DIFF_INPUTS:
+    return "inputs";
+  case BLACKBOX_REPLAY_DIFF_OUTPUTS:
+    return "outputs";
+  case BLACKBOX_REPLAY_DIFF_FAILSAFE:
+    return "failsafe";
+  case BLACKBOX_REPLAY_DIFF_NAV:
+    return "nav";
+  default:
+    return "?";
+  }
+}
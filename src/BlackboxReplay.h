@@ -0,0 +1,119 @@
+#ifndef BLACKBOX_REPLAY_H
+#define BLACKBOX_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Blackbox.h"
+#include "BlackboxCodec.h"
+#include "BlackboxReader.h"
+
+/**
+ * BlackboxReplay - Walk a downloaded flight and diff a replay against it
+ *
+ * The host replay (src/replay_main.cpp, tools/replay.py) feeds each
+ * record's inputs (pilot sticks, link age, position, heading, attitude,
+ * depth) back through NavigationManager, DepthManager, the failsafe
+ * logic and the vehicle, then builds the record the firmware would have
+ * logged and hands both to BlackboxReplay_compare(). These are the pure
+ * parts: the record cursor over a log image and the comparison.
+ *
+ * A log is either a /log/flight download (the session's sectors in
+ * write order) or a /log/raw partition image plus a session number.
+ * Sectors that fail their check or come from another record layout are
+ * skipped and counted, not fatal: a flight overwritten while it was
+ * downloaded still replays up to the gap.
+ *
+ * @file BlackboxReplay.h
+ */
+
+#define BLACKBOX_REPLAY_OUTPUTS     4
+
+// Differences of one tick (BlackboxReplay_compare() result)
+#define BLACKBOX_REPLAY_DIFF_INPUTS     0x01    // Vehicle inputs (after failsafe / auto)
+#define BLACKBOX_REPLAY_DIFF_OUTPUTS    0x02    // Mixed outputs
+#define BLACKBOX_REPLAY_DIFF_FAILSAFE   0x04    // Failsafe state
+#define BLACKBOX_REPLAY_DIFF_NAV        0x08    // Waypoint / mission / RTL / diving
+#define BLACKBOX_REPLAY_DIFF_KINDS      4
+
+/**
+ * Records of one flight, in write order
+ */
+typedef struct {
+    const uint8_t* image;
+    uint16_t sectors;       // Image size in sectors
+    BlackboxFlight flight;  // Sectors to walk (wrapping at the image end)
+    uint16_t sector;        // Next sector of the flight
+    uint16_t record;        // Next record in it
+    uint32_t records;       // Returned so far
+    uint32_t skipped;       // Sectors that failed the check or the layout
+    BlackboxCodec codec;    // Decoder of a PACKED sector
+    BlackboxRecord current; // Its last record
+} BlackboxReplayCursor;
+
+/**
+ * Differences allowed before a tick counts as a mismatch
+ */
+typedef struct {
+    uint8_t output;         // Percent per output
+    int16_t input;          // Stick units per axis
+} BlackboxReplayTolerance;
+
+/**
+ * Comparison totals
+ */
+typedef struct {
+    uint32_t ticks;
+    uint32_t mismatches;    // Ticks with any difference past tolerance
+    uint32_t kinds[BLACKBOX_REPLAY_DIFF_KINDS]; // Ticks per difference kind
+    uint32_t firstMs;       // time_ms of the first mismatch
+    uint8_t firstDiff;      // BLACKBOX_REPLAY_DIFF_* of it (0 = none yet)
+    uint8_t maxOutput[BLACKBOX_REPLAY_OUTPUTS];
+    float sumSqOutput[BLACKBOX_REPLAY_OUTPUTS];
+    int16_t maxInput;
+} BlackboxReplayStats;
+
+// ============================================================================
+// Cursor
+// ============================================================================
+
+/**
+ * Walk a /log/flight download: every sector of the file, in order
+ * @return false if the size is not a whole number of sectors
+ */
+bool BlackboxReplay_openFlight(BlackboxReplayCursor* cursor, const uint8_t* image, size_t size);
+
+/**
+ * Walk one session of a /log/raw partition image
+ * @return false if the session is not in the image
+ */
+bool BlackboxReplay_openSession(BlackboxReplayCursor* cursor, const uint8_t* image,
+                                size_t size, uint16_t session);
+
+/**
+ * Next record, NULL at the end of the flight (valid until the next call)
+ */
+const BlackboxRecord* BlackboxReplay_next(BlackboxReplayCursor* cursor);
+
+// ============================================================================
+// Comparison
+// ============================================================================
+
+/**
+ * Compare the replayed record of a tick with the logged one
+ * @return BLACKBOX_REPLAY_DIFF_* past tolerance (0 = match)
+ */
+uint8_t BlackboxReplay_compare(BlackboxReplayStats* stats, const BlackboxReplayTolerance* tol,
+                               const BlackboxRecord* logged, const BlackboxRecord* replayed);
+
+/**
+ * RMS difference of an output over the compared ticks, percent
+ */
+float BlackboxReplay_outputRms(const BlackboxReplayStats* stats, uint8_t output);
+
+/**
+ * Name of a difference kind bit ("inputs", "outputs", "failsafe", "nav")
+ */
+const char* BlackboxReplay_diffName(uint8_t diff);
+
+#endif // BLACKBOX_REPLAY_H
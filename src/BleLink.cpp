@@ -0,0 +1,131 @@
+#include "BleLink.h"
+#include <string.h>
+
+/**
+ * BleLink - Implementation
+ *
+ * @file BleLink.cpp
+ */
+
+static const char REPLY_TOO_LONG[] = "{\"err\":\"Reply too long for BLE\"}\r\n";
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void BleBatch_init(BleBatch* b) {
+    memset(b, 0, sizeof(*b));
+    b->payload = BLE_LINK_DEFAULT_MTU - 3;
+}
+
+void BleBatch_setMtu(BleBatch* b, uint16_t mtu) {
+    if (mtu < BLE_LINK_DEFAULT_MTU) mtu = BLE_LINK_DEFAULT_MTU;
+    if (mtu > BLE_LINK_MTU) mtu = BLE_LINK_MTU;
+    b->payload = (uint16_t)(mtu - 3);
+}
+
+bool BleBatch_fits(const BleBatch* b, size_t len) {
+    return b->len + len <= b->payload;
+}
+
+bool BleBatch_add(BleBatch* b, const uint8_t* frame, size_t len, uint32_t nowMs) {
+    if (len > b->payload || !BleBatch_fits(b, len)) {
+        b->oversize++;
+        return false;
+    }
+    if (b->frames == 0) b->firstMs = nowMs;
+    memcpy(b->buf + b->len, frame, len);
+    b->len += (uint16_t)len;
+    b->frames++;
+    b->framesIn++;
+    return true;
+}
+
+bool BleBatch_due(const BleBatch* b, uint32_t nowMs) {
+    if (b->frames == 0) return false;
+    return b->frames >= BLE_BATCH_FRAMES || nowMs - b->firstMs >= BLE_BATCH_MAX_AGE_MS;
+}
+
+void BleBatch_clear(BleBatch* b) {
+    if (b->frames) b->batches++;
+    b->len = 0;
+    b->frames = 0;
+}
+
+void BleLineReader_init(BleLineReader* r) {
+    memset(r, 0, sizeof(*r));
+}
+
+size_t BleLineReader_feed(BleLineReader* r, const uint8_t* data, size_t len,
+                          const char** line, uint16_t* lineLen) {
+    *line = NULL;
+    size_t i = 0;
+    while (i < len) {
+        char c = (char)data[i++];
+        if (c == '\n' || c == '\r') {
+            bool complete = !r->discarding && r->len > 0;
+            r->discarding = false;
+            if (!complete) {
+                r->len = 0;
+                continue;
+            }
+            r->line[r->len] = '\0';
+            *line = r->line;
+            *lineLen = r->len;
+            r->len = 0;
+            r->lines++;
+            return i;
+        }
+        if (r->discarding) continue;
+        if (r->len >= BLE_LINE_MAX - 1) {
+            r->discarding = true;
+            r->len = 0;
+            r->overflowed++;
+            continue;
+        }
+        r->line[r->len++] = c;
+    }
+    return i;
+}
+
+void BleReply_init(BleReply* r) {
+    memset(r, 0, sizeof(*r));
+}
+
+void BleReply_begin(BleReply* r) {
+    r->len = 0;
+    r->sent = 0;
+    r->overflow = false;
+}
+
+void BleReply_write(BleReply* r, const uint8_t* data, size_t len) {
+    if (r->overflow) return;
+    if (r->len + len > BLE_REPLY_MAX) {
+        r->overflow = true;
+        return;
+    }
+    memcpy(r->buf + r->len, data, len);
+    r->len += (uint16_t)len;
+}
+
+void BleReply_end(BleReply* r) {
+    if (r->overflow) {
+        memcpy(r->buf, REPLY_TOO_LONG, sizeof(REPLY_TOO_LONG) - 1);
+        r->len = sizeof(REPLY_TOO_LONG) - 1;
+        r->truncated++;
+    }
+    r->sent = 0;
+    r->replies++;
+}
+
+size_t BleReply_next(BleReply* r, uint16_t payload, const uint8_t** chunk) {
+    size_t n = r->len - r->sent;
+    if (n > payload) n = payload;
+    *chunk = (const uint8_t*)r->buf + r->sent;
+    r->sent += (uint16_t)n;
+    return n;
+}
+
+bool BleReply_idle(const BleReply* r) {
+    return r->sent >= r->len;
+}
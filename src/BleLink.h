@@ -0,0 +1,141 @@
+#ifndef BLE_LINK_H
+#define BLE_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * BleLink - Framing for the BLE phone link (see BleService)
+ *
+ * Three buffers between the GATT characteristics and the tasks:
+ *
+ * - BleBatch packs whole telemetry frames (HostProtocol, 0x00 delimited,
+ *   so the phone splits them again) into one notification until the
+ *   next would not fit, BLE_BATCH_FRAMES are in or the oldest has waited
+ *   BLE_BATCH_MAX_AGE_MS. At 20 Hz telemetry that is one notification
+ *   every 200 ms instead of 20 a second: fewer connection events carry
+ *   data, so the radio is free for ESP-NOW / Wi-Fi in between
+ * - BleLineReader puts JSON command lines back together from writes of
+ *   any size (a line may span several, a write may hold several lines);
+ *   an over-long line is dropped up to its newline
+ * - BleReply collects what a command handler prints and hands it out in
+ *   notification-sized chunks; a reply that does not fit is replaced by
+ *   an error line rather than sent cut short
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file BleLink.h
+ */
+
+#define BLE_LINK_MTU            247     // Requested ATT MTU (one LL data PDU with DLE)
+#define BLE_LINK_DEFAULT_MTU    23      // Until the phone negotiates
+#define BLE_LINK_MAX_PAYLOAD    (BLE_LINK_MTU - 3)  // Notification bytes at most
+#define BLE_BATCH_FRAMES        4
+#define BLE_BATCH_MAX_AGE_MS    200
+#define BLE_LINE_MAX            512     // Longest command line incl. NUL
+#define BLE_REPLY_MAX           4096    // Longest reply (get_cmd_stats fits)
+
+typedef struct {
+    uint8_t buf[BLE_LINK_MAX_PAYLOAD];
+    uint16_t len;
+    uint16_t payload;           // Notification size: MTU - 3
+    uint8_t frames;
+    uint32_t firstMs;           // When the oldest frame went in
+
+    // Statistics
+    uint32_t batches;
+    uint32_t framesIn;
+    uint32_t oversize;          // Frames larger than a notification
+} BleBatch;
+
+typedef struct {
+    char line[BLE_LINE_MAX];
+    uint16_t len;
+    bool discarding;            // Over-long line: skip to its newline
+
+    // Statistics
+    uint32_t lines;
+    uint32_t overflowed;
+} BleLineReader;
+
+typedef struct {
+    char buf[BLE_REPLY_MAX];
+    uint16_t len;
+    uint16_t sent;              // Handed out so far
+    bool overflow;
+
+    // Statistics
+    uint32_t replies;
+    uint32_t truncated;
+} BleReply;
+
+void BleBatch_init(BleBatch* b);
+
+/**
+ * Notification size after an MTU exchange (pending frames are kept if
+ * they still fit, else the caller flushes first)
+ */
+void BleBatch_setMtu(BleBatch* b, uint16_t mtu);
+
+/**
+ * Room for a frame of len bytes without flushing first
+ */
+bool BleBatch_fits(const BleBatch* b, size_t len);
+
+/**
+ * Append a frame (call BleBatch_fits() first)
+ * @return false if the frame can never fit a notification (dropped)
+ */
+bool BleBatch_add(BleBatch* b, const uint8_t* frame, size_t len, uint32_t nowMs);
+
+/**
+ * Time to send what is batched
+ */
+bool BleBatch_due(const BleBatch* b, uint32_t nowMs);
+
+/**
+ * Batch sent: start the next one
+ */
+void BleBatch_clear(BleBatch* b);
+
+void BleLineReader_init(BleLineReader* r);
+
+/**
+ * Consume written bytes up to and including the next complete line
+ * @param line Output; NULL if none completed, else the NUL-terminated
+ *             line (no newline), valid until the next call
+ * @return Bytes consumed (call again with the rest while it is < len)
+ */
+size_t BleLineReader_feed(BleLineReader* r, const uint8_t* data, size_t len,
+                          const char** line, uint16_t* lineLen);
+
+void BleReply_init(BleReply* r);
+
+/**
+ * Start collecting the reply to the next command (the last one must
+ * have been handed out)
+ */
+void BleReply_begin(BleReply* r);
+
+void BleReply_write(BleReply* r, const uint8_t* data, size_t len);
+
+/**
+ * Command done: an overflowed reply becomes an error line
+ */
+void BleReply_end(BleReply* r);
+
+/**
+ * Next chunk to notify
+ * @param payload Notification size
+ * @param chunk Output, points into the reply
+ * @return Chunk length, 0 when everything has been handed out
+ */
+size_t BleReply_next(BleReply* r, uint16_t payload, const uint8_t** chunk);
+
+/**
+ * Everything handed out (ready for BleReply_begin)
+ */
+bool BleReply_idle(const BleReply* r);
+
+#endif // BLE_LINK_H
@@ -0,0 +1,222 @@
+#include "Features.h"
+
+#if FEATURE_BLE
+
+#include "BleService.h"
+#include "Log.h"
+#include "MemPlacement.h"
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR < 5
+#include <esp_coexist.h>
+#endif
+
+// ============================================================================
+// Stack Callbacks
+// ============================================================================
+
+class BleServerCallbacks : public BLEServerCallbacks {
+    void onConnect(BLEServer* server, esp_ble_gatts_cb_param_t* param) override {
+        BleService::getInstance().onConnect(server, param->connect.remote_bda);
+    }
+    void onDisconnect(BLEServer* server) override {
+        BleService::getInstance().onDisconnect();
+    }
+    void onMtuChanged(BLEServer* server, esp_ble_gatts_cb_param_t* param) override {
+        BleService::getInstance().onMtu(param->mtu.mtu);
+    }
+};
+
+class BleCommandCallbacks : public BLECharacteristicCallbacks {
+    void onWrite(BLECharacteristic* characteristic) override {
+        BleService::getInstance().onCommandWrite(characteristic->getData(), characteristic->getLength());
+    }
+};
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+BleService& BleService::getInstance() {
+    // Reply, line and batch buffers (~7 KB)
+    BULK_BSS static BleService instance;
+    return instance;
+}
+
+BleService::BleService()
+    : _started(false), _ok(false), _connected(false), _mtu(BLE_LINK_DEFAULT_MTU), _connections(0),
+      _telemetry(nullptr), _command(nullptr), _batchMtu(BLE_LINK_DEFAULT_MTU), _batchConnection(0),
+      _commandsTaken(0) {
+    BleBatch_init(&_batch);
+    BleLineReader_init(&_reader);
+    BleReply_init(&_reply);
+    _replyPrint.reply = &_reply;
+    MemPlacement_note("ble", this, sizeof(*this), MEM_CLASS_BULK);
+}
+
+bool BleService::begin(const char* name) {
+    if (_started) return _ok;
+    _started = true;
+
+    BLEDevice::init(name);
+    BLEDevice::setMTU(BLE_LINK_MTU);
+#if ESP_IDF_VERSION_MAJOR < 5
+    // Share the radio evenly: neither ESP-NOW control nor the phone starves
+    esp_coex_preference_set(ESP_COEX_PREFER_BALANCE);
+#endif
+
+    BLEServer* server = BLEDevice::createServer();
+    if (!server) {
+        LOG_ERROR("[BLE] Server create failed\n");
+        return false;
+    }
+    server->setCallbacks(new BleServerCallbacks());
+
+    BLEService* service = server->createService(BLE_SERVICE_UUID);
+    BLECharacteristic* telemetry = service->createCharacteristic(
+        BLE_TELEMETRY_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+    telemetry->addDescriptor(new BLE2902());
+    BLECharacteristic* command = service->createCharacteristic(
+        BLE_COMMAND_UUID, BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_WRITE_NR |
+        BLECharacteristic::PROPERTY_NOTIFY);
+    command->addDescriptor(new BLE2902());
+    command->setCallbacks(new BleCommandCallbacks());
+    service->start();
+    _telemetry = telemetry;
+    _command = command;
+
+    BLEAdvertising* advertising = BLEDevice::getAdvertising();
+    advertising->addServiceUUID(BLE_SERVICE_UUID);
+    advertising->setScanResponse(true);
+    advertising->setMinInterval(BLE_ADV_MIN_INTERVAL);
+    advertising->setMaxInterval(BLE_ADV_MAX_INTERVAL);
+    BLEDevice::startAdvertising();
+
+    _ok = true;
+    LOG_INFO("[BLE] Advertising as %s\n", name);
+    return true;
+}
+
+void BleService::sendTelemetry(const uint8_t* frame, size_t len, uint32_t nowMs) {
+    if (!_ok || !_connected) return;
+
+    // Frames left from the last connection are stale
+    if (_batchConnection != _connections) {
+        BleBatch_clear(&_batch);
+        _batchConnection = _connections;
+    }
+
+    // After an MTU exchange: send what was packed for the old size first
+    uint16_t mtu = _mtu;
+    if (mtu != _batchMtu) {
+        if (_batch.frames) notify(_telemetry, _batch.buf, _batch.len);
+        BleBatch_clear(&_batch);
+        BleBatch_setMtu(&_batch, mtu);
+        _batchMtu = mtu;
+    }
+
+    if (!BleBatch_fits(&_batch, len) && _batch.frames) {
+        notify(_telemetry, _batch.buf, _batch.len);
+        BleBatch_clear(&_batch);
+    }
+    BleBatch_add(&_batch, frame, len, nowMs);
+    if (BleBatch_due(&_batch, nowMs)) {
+        notify(_telemetry, _batch.buf, _batch.len);
+        BleBatch_clear(&_batch);
+    }
+}
+
+bool BleService::takeCommand(BleCommandLine& line) {
+    if (!_ok || !BleReply_idle(&_reply)) return false;
+    if (!_commands.readNext(line)) return false;
+    _commandsTaken++;
+    return true;
+}
+
+Print& BleService::beginReply() {
+    BleReply_begin(&_reply);
+    return _replyPrint;
+}
+
+void BleService::endReply() {
+    BleReply_end(&_reply);
+    if (!_connected) BleReply_begin(&_reply);     // Nobody left to read it
+}
+
+void BleService::serviceReplies() {
+    if (!_ok) return;
+    uint16_t payload = (uint16_t)(_mtu - 3);
+    for (int i = 0; i < BLE_REPLY_BURST && !BleReply_idle(&_reply); i++) {
+        const uint8_t* chunk;
+        size_t n = BleReply_next(&_reply, payload, &chunk);
+        notify(_command, chunk, n);
+    }
+}
+
+BleStats BleService::getStats() {
+    BleStats s;
+    s.started = _ok;
+    s.connected = _connected;
+    s.mtu = _mtu;
+    s.connections = _connections;
+    s.batches = _batch.batches;
+    s.frames = _batch.framesIn;
+    s.commands = _commandsTaken;
+    s.commandsDropped = _commands.getDroppedCount() + _reader.overflowed;
+    s.replies = _reply.replies;
+    s.repliesTruncated = _reply.truncated;
+    return s;
+}
+
+// ============================================================================
+// Stack Callbacks (BLE task)
+// ============================================================================
+
+void BleService::onConnect(void* server, const uint8_t* peer) {
+    _connections++;
+    _connected = true;
+    ((BLEServer*)server)->updateConnParams((uint8_t*)peer, BLE_CONN_MIN_INTERVAL, BLE_CONN_MAX_INTERVAL,
+                                           BLE_CONN_LATENCY, BLE_CONN_TIMEOUT);
+    LOG_INFO("[BLE] Connected\n");
+}
+
+void BleService::onDisconnect() {
+    _connected = false;
+    _mtu = BLE_LINK_DEFAULT_MTU;
+    BLEDevice::startAdvertising();
+    LOG_INFO("[BLE] Disconnected, advertising\n");
+}
+
+void BleService::onMtu(uint16_t mtu) {
+    if (mtu > BLE_LINK_MTU) mtu = BLE_LINK_MTU;
+    _mtu = mtu;
+}
+
+void BleService::onCommandWrite(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        const char* text;
+        uint16_t textLen;
+        size_t used = BleLineReader_feed(&_reader, data, len, &text, &textLen);
+        data += used;
+        len -= used;
+        if (!text) continue;
+
+        _written.len = textLen;
+        memcpy(_written.text, text, textLen + 1);
+        _commands.push(_written);
+    }
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+void BleService::notify(void* characteristic, const uint8_t* data, size_t len) {
+    BLECharacteristic* c = (BLECharacteristic*)characteristic;
+    c->setValue((uint8_t*)data, len);
+    c->notify();
+}
+
+#endif // FEATURE_BLE
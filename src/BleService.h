@@ -0,0 +1,151 @@
+#ifndef BLE_SERVICE_H
+#define BLE_SERVICE_H
+
+#include <Arduino.h>
+#include "BleLink.h"
+#include "SPSCRing.h"
+
+/**
+ * BleService - BLE GATT fallback link for phones (telemetry + commands)
+ *
+ * For a phone that cannot join the vehicle's Wi-Fi and has no cable for
+ * Web Serial. One primary service with two characteristics:
+ *
+ *   telemetry  notify  HostProtocol telemetry frames (0x00 delimited),
+ *                      several per notification (BleBatch)
+ *   command    write   JSON command lines, as on the serial port, run by
+ *              notify  the same command router; the reply comes back as
+ *                      notifications on this characteristic
+ *
+ * - MTU: BLE_LINK_MTU is offered; until the phone exchanges MTUs every
+ *   notification is 20 bytes
+ * - Connection interval: 7.5-30 ms is requested with a slave latency of
+ *   BLE_CONN_LATENCY, so command replies drain fast while an idle link
+ *   skips connection events and leaves the radio to ESP-NOW
+ * - Advertising every 100-200 ms, only while nobody is connected
+ * - The stack calls back on its own task: written lines are queued
+ *   (SPSCRing) for the comms task, replies are sent by the comms task
+ *   and telemetry by the telemetry task, so no command handler ever runs
+ *   on the BLE task
+ *
+ * Built with FEATURE_BLE only (Bluedroid is large); coexistence with
+ * Wi-Fi needs modem sleep, so WifiLink's lowLatency is not available
+ * once BLE is up.
+ */
+
+#define BLE_CONFIG_KEY          "cfg_ble"   // Stored on / off (set_ble)
+#define BLE_SERVICE_UUID        "6e61b100-6e61-4c6b-9000-000000000001"
+#define BLE_TELEMETRY_UUID      "6e61b100-6e61-4c6b-9000-000000000002"
+#define BLE_COMMAND_UUID        "6e61b100-6e61-4c6b-9000-000000000003"
+
+#define BLE_CONN_MIN_INTERVAL   6       // 1.25 ms units: 7.5 ms
+#define BLE_CONN_MAX_INTERVAL   24      // 30 ms
+#define BLE_CONN_LATENCY        4       // Events the vehicle may skip when idle
+#define BLE_CONN_TIMEOUT        400     // 10 ms units: 4 s
+#define BLE_ADV_MIN_INTERVAL    160     // 0.625 ms units: 100 ms
+#define BLE_ADV_MAX_INTERVAL    320     // 200 ms
+#define BLE_COMMAND_QUEUE       4       // Lines waiting for the comms task
+#define BLE_REPLY_BURST         2       // Notifications per service call
+
+struct BleCommandLine {
+    uint16_t len;
+    char text[BLE_LINE_MAX];
+};
+
+struct BleStats {
+    bool started;
+    bool connected;
+    uint16_t mtu;
+    uint32_t connections;
+    uint32_t batches;           // Telemetry notifications
+    uint32_t frames;            // Telemetry frames in them
+    uint32_t commands;
+    uint32_t commandsDropped;   // Queue full / line too long
+    uint32_t replies;
+    uint32_t repliesTruncated;
+};
+
+class BleService {
+public:
+    static BleService& getInstance();
+
+    /**
+     * Start the controller, the GATT service and advertising (once;
+     * later calls return the first result)
+     * @param name Advertised device name
+     */
+    bool begin(const char* name);
+
+    bool isStarted() const { return _started; }
+    bool isConnected() const { return _connected; }
+
+    /**
+     * Telemetry task: queue one frame; notifies when the batch is full
+     * or due (call only while connected)
+     */
+    void sendTelemetry(const uint8_t* frame, size_t len, uint32_t nowMs);
+
+    /**
+     * Comms task: next command line written by the phone, once the last
+     * reply is out
+     */
+    bool takeCommand(BleCommandLine& line);
+
+    /**
+     * Comms task: output for the command taken (until endReply)
+     */
+    Print& beginReply();
+    void endReply();
+
+    /**
+     * Comms task: notify the next reply chunks
+     */
+    void serviceReplies();
+
+    BleStats getStats();
+
+    // Stack callbacks (BLE task)
+    void onConnect(void* server, const uint8_t* peer);
+    void onDisconnect();
+    void onMtu(uint16_t mtu);
+    void onCommandWrite(const uint8_t* data, size_t len);
+
+private:
+    BleService();
+
+    class ReplyPrint : public Print {
+    public:
+        BleReply* reply;
+        size_t write(uint8_t c) override {
+            BleReply_write(reply, &c, 1);
+            return 1;
+        }
+        size_t write(const uint8_t* data, size_t len) override {
+            BleReply_write(reply, data, len);
+            return len;
+        }
+    };
+
+    bool _started;
+    bool _ok;
+    volatile bool _connected;
+    volatile uint16_t _mtu;
+    volatile uint32_t _connections;
+
+    void* _telemetry;           // BLECharacteristic*
+    void* _command;
+
+    BleBatch _batch;            // Telemetry task
+    uint16_t _batchMtu;         // MTU _batch is sized for
+    uint32_t _batchConnection;  // Connection _batch was packed for
+    BleLineReader _reader;      // BLE task
+    BleCommandLine _written;    // BLE task: line being queued
+    SPSCRing<BleCommandLine, BLE_COMMAND_QUEUE> _commands;
+    uint32_t _commandsTaken;
+    BleReply _reply;            // Comms task
+    ReplyPrint _replyPrint;
+
+    void notify(void* characteristic, const uint8_t* data, size_t len);
+};
+
+#endif // BLE_SERVICE_H
@@ -0,0 +1,201 @@
+#include "BootSequence.h"
+#include "HAL.h"
+#include <string.h>
+
+/**
+ * BootSequence - Implementation
+ *
+ * The planner is pure and single threaded; the runner serializes claim /
+ * finish of both lanes with one spinlock and runs the stage bodies
+ * outside it.
+ *
+ * @file BootSequence.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint16_t finished_mask(const BootSequence *seq) {
+  uint16_t mask = 0;
+  for (uint8_t i = 0; i < seq->count; i++) {
+    if (seq->state[i] == BOOT_STAGE_OK || seq->state[i] == BOOT_STAGE_FAILED)
+      mask |= BOOT_AFTER(i);
+  }
+  return mask;
+}
+
+static bool has_cycle(const BootStage *stages, uint8_t count) {
+  // Peel off stages whose dependencies are all peeled; a cycle never peels
+  uint16_t done = 0;
+  for (uint8_t round = 0; round < count; round++) {
+    bool progress = false;
+    for (uint8_t i = 0; i < count; i++) {
+      if (!(done & BOOT_AFTER(i)) && (stages[i].after & ~done) == 0) {
+        done |= BOOT_AFTER(i);
+        progress = true;
+      }
+    }
+    if (!progress)
+      break;
+  }
+  return done != (uint16_t)((1UL << count) - 1);
+}
+
+// ============================================================================
+// Planner
+// ============================================================================
+
+bool BootSequence_init(BootSequence *seq, const BootStage *stages, uint8_t count) {
+  memset(seq, 0, sizeof(*seq));
+  if (!stages || count == 0 || count > BOOT_MAX_STAGES)
+    return false;
+  uint16_t valid = (uint16_t)((1UL << count) - 1);
+  for (uint8_t i = 0; i < count; i++) {
+    if (!stages[i].fn || stages[i].lane >= BOOT_LANE_COUNT)
+      return false;
+    if ((stages[i].after & ~valid) || (stages[i].after & BOOT_AFTER(i)))
+      return false;
+  }
+  if (has_cycle(stages, count))
+    return false;
+  seq->stages = stages;
+  seq->count = count;
+  return true;
+}
+
+int BootSequence_claim(BootSequence *seq, uint8_t lane, uint32_t nowUs) {
+  if (seq->halted)
+    return BOOT_NEXT_DONE;
+  uint16_t finished = finished_mask(seq);
+  bool pending = false;
+  for (uint8_t i = 0; i < seq->count; i++) {
+    if (seq->stages[i].lane != lane || seq->state[i] != BOOT_STAGE_PENDING)
+      continue;
+    if ((seq->stages[i].after & ~finished) == 0) {
+      seq->state[i] = BOOT_STAGE_RUNNING;
+      seq->startUs[i] = nowUs;
+      return i;
+    }
+    pending = true;
+  }
+  return pending ? BOOT_NEXT_WAIT : BOOT_NEXT_DONE;
+}
+
+void BootSequence_finish(BootSequence *seq, uint8_t index, bool ok, uint32_t nowUs) {
+  if (index >= seq->count || seq->state[index] != BOOT_STAGE_RUNNING)
+    return;
+  seq->state[index] = ok ? BOOT_STAGE_OK : BOOT_STAGE_FAILED;
+  seq->durationUs[index] = nowUs - seq->startUs[index];
+  if (!ok && (seq->stages[index].flags & BOOT_FLAG_CRITICAL)) {
+    seq->halted = true;
+    for (uint8_t i = 0; i < seq->count; i++) {
+      if (seq->state[i] == BOOT_STAGE_PENDING)
+        seq->state[i] = BOOT_STAGE_SKIPPED;
+    }
+  }
+}
+
+bool BootSequence_isComplete(const BootSequence *seq) {
+  for (uint8_t i = 0; i < seq->count; i++) {
+    if (seq->state[i] == BOOT_STAGE_PENDING || seq->state[i] == BOOT_STAGE_RUNNING)
+      return false;
+  }
+  return true;
+}
+
+uint32_t BootSequence_laneEndUs(const BootSequence *seq, uint8_t lane) {
+  uint32_t end = 0;
+  for (uint8_t i = 0; i < seq->count; i++) {
+    if (seq->stages[i].lane != lane ||
+        (seq->state[i] != BOOT_STAGE_OK && seq->state[i] != BOOT_STAGE_FAILED))
+      continue;
+    uint32_t e = seq->startUs[i] + seq->durationUs[i];
+    if (e > end)
+      end = e;
+  }
+  return end;
+}
+
+// ============================================================================
+// Runner (target only)
+// ============================================================================
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+
+#define LANE_MASK(lane) (1u << (lane))
+
+static portMUX_TYPE bootMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void report(const BootSequence *seq) {
+  static const char *const STATE[] = {"pending", "running", "ok", "FAILED", "skipped"};
+  for (uint8_t i = 0; i < seq->count; i++) {
+    Serial.printf("[Boot] %-10s %s %-7s at %7.1f ms, %7.1f ms\n", seq->stages[i].name,
+                  seq->stages[i].lane == BOOT_LANE_MAIN ? "main" : "bg  ", STATE[seq->state[i]],
+                  seq->startUs[i] / 1000.0f, seq->durationUs[i] / 1000.0f);
+  }
+  Serial.printf("[Boot] main lane done at %.1f ms, all at %.1f ms\n",
+                BootSequence_laneEndUs(seq, BOOT_LANE_MAIN) / 1000.0f,
+                BootSequence_laneEndUs(seq, BOOT_LANE_BACKGROUND) / 1000.0f);
+}
+
+// Run every stage of the masked lanes, waiting on the other lane as needed
+static void run_lanes(BootSequence *seq, uint8_t lanes) {
+  while (true) {
+    int index = BOOT_NEXT_DONE;
+    bool waiting = false;
+    portENTER_CRITICAL(&bootMux);
+    for (uint8_t lane = 0; lane < BOOT_LANE_COUNT; lane++) {
+      if (!(lanes & LANE_MASK(lane)))
+        continue;
+      index = BootSequence_claim(seq, lane, HAL_GetMicros());
+      if (index >= 0)
+        break;
+      waiting = waiting || index == BOOT_NEXT_WAIT;
+    }
+    portEXIT_CRITICAL(&bootMux);
+
+    if (index < 0) {
+      if (!waiting)
+        return;
+      vTaskDelay(1);
+      continue;
+    }
+
+    bool ok = seq->stages[index].fn();
+    portENTER_CRITICAL(&bootMux);
+    BootSequence_finish(seq, (uint8_t)index, ok, HAL_GetMicros());
+    bool complete = BootSequence_isComplete(seq);
+    portEXIT_CRITICAL(&bootMux);
+    if (!ok)
+      Serial.printf("[Boot] %s failed\n", seq->stages[index].name);
+    if (complete)
+      report(seq);
+  }
+}
+
+static void worker_entry(void *arg) {
+  run_lanes((BootSequence *)arg, LANE_MASK(BOOT_LANE_BACKGROUND));
+  vTaskDelete(NULL);
+}
+
+bool BootSequence_run(BootSequence *seq, uint8_t workerPriority, uint8_t workerCore) {
+  if (xTaskCreatePinnedToCore(worker_entry, "boot", BOOT_WORKER_STACK, seq, workerPriority,
+                              NULL, workerCore) == pdPASS) {
+    run_lanes(seq, LANE_MASK(BOOT_LANE_MAIN));
+  } else {
+    // No worker: both lanes here, still in dependency order
+    Serial.println("[Boot] Worker create failed, booting in line");
+    run_lanes(seq, LANE_MASK(BOOT_LANE_MAIN) | LANE_MASK(BOOT_LANE_BACKGROUND));
+  }
+  return !seq->halted;
+}
+
+void BootSequence_snapshot(const BootSequence *seq, BootSequence *out) {
+  portENTER_CRITICAL(&bootMux);
+  *out = *seq;
+  portEXIT_CRITICAL(&bootMux);
+}
+
+#endif // __XTENSA__
@@ -0,0 +1,125 @@
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * BootSequence - Subsystem bring-up as a dependency graph on two lanes
+ *
+ * setup() used to initialize everything in one line, so the radio waited
+ * for servo settling, ADC seeding, the IMU reset and the MS5837 PROM
+ * read. Here every subsystem is a stage with a lane and the stages it
+ * must follow:
+ *
+ *   MAIN        Run by setup() in table order: actuators at neutral,
+ *               config and crypto, radio - what the first control frame
+ *               needs. setup() starts the scheduler when this lane ends.
+ *   BACKGROUND  Run by a boot worker task on the background core,
+ *               concurrently with MAIN and with the running scheduler:
+ *               slow or optional devices (I2C sensors, GPS, ADC, web
+ *               server, flash scans). Their users must already cope with
+ *               a subsystem that is not up yet (null manager, !ready).
+ *
+ * A stage becomes runnable when every stage in its `after` mask has
+ * finished, in either lane, whether it succeeded or not. A CRITICAL stage
+ * that fails halts the boot: nothing else is started.
+ *
+ * Each stage records its start and duration (microseconds since app
+ * start), reported once at the end and by {"c":"get_boot"}.
+ *
+ * @file BootSequence.h
+ */
+
+#define BOOT_MAX_STAGES     16
+#define BOOT_NEXT_WAIT      -1      // Stages left in the lane, none runnable yet
+#define BOOT_NEXT_DONE      -2      // Lane finished (or boot halted)
+#define BOOT_WORKER_STACK   8192    // Background lane task (bytes)
+
+#define BOOT_LANE_MAIN          0
+#define BOOT_LANE_BACKGROUND    1
+#define BOOT_LANE_COUNT         2
+
+#define BOOT_FLAG_CRITICAL  0x01    // Failure halts the boot
+
+#define BOOT_AFTER(stage)   ((uint16_t)(1u << (stage)))
+
+/**
+ * Stage body
+ * @return false on failure (logged, dependents still run unless CRITICAL)
+ */
+typedef bool (*BootStageFn)(void);
+
+typedef struct {
+    const char* name;
+    BootStageFn fn;
+    uint8_t lane;           // BOOT_LANE_*
+    uint8_t flags;          // BOOT_FLAG_*
+    uint16_t after;         // BOOT_AFTER() of stages to finish first
+} BootStage;
+
+typedef enum {
+    BOOT_STAGE_PENDING = 0,
+    BOOT_STAGE_RUNNING,
+    BOOT_STAGE_OK,
+    BOOT_STAGE_FAILED,
+    BOOT_STAGE_SKIPPED      // Not run: boot halted
+} BootStageState;
+
+typedef struct {
+    const BootStage* stages;
+    uint8_t count;
+    bool halted;
+    uint8_t state[BOOT_MAX_STAGES];     // BootStageState
+    uint32_t startUs[BOOT_MAX_STAGES];
+    uint32_t durationUs[BOOT_MAX_STAGES];
+} BootSequence;
+
+// ============================================================================
+// Planner (pure)
+// ============================================================================
+
+/**
+ * Bind a stage table
+ * @return false if too many stages, a lane or dependency is out of range,
+ *         or the dependencies form a cycle
+ */
+bool BootSequence_init(BootSequence* seq, const BootStage* stages, uint8_t count);
+
+/**
+ * Take the first runnable stage of a lane (marks it running)
+ * @return Stage index, BOOT_NEXT_WAIT or BOOT_NEXT_DONE
+ */
+int BootSequence_claim(BootSequence* seq, uint8_t lane, uint32_t nowUs);
+
+/**
+ * Record the result of a claimed stage
+ */
+void BootSequence_finish(BootSequence* seq, uint8_t index, bool ok, uint32_t nowUs);
+
+/**
+ * True once every stage of every lane has finished or was skipped
+ */
+bool BootSequence_isComplete(const BootSequence* seq);
+
+/**
+ * End of the last finished stage of a lane (0 if none ran)
+ */
+uint32_t BootSequence_laneEndUs(const BootSequence* seq, uint8_t lane);
+
+// ============================================================================
+// Runner (target)
+// ============================================================================
+
+/**
+ * Start the background worker, then run the MAIN lane in the caller
+ * @return false if a CRITICAL stage failed
+ */
+bool BootSequence_run(BootSequence* seq, uint8_t workerPriority, uint8_t workerCore);
+
+/**
+ * Consistent copy of the sequence state (for reports while booting)
+ */
+void BootSequence_snapshot(const BootSequence* seq, BootSequence* out);
+
+#endif // BOOT_SEQUENCE_H
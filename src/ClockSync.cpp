@@ -0,0 +1,184 @@
+#include "ClockSync.h"
+#include <string.h>
+#include "Crc16.h"
+
+/**
+ * ClockSync - Implementation
+ *
+ * The estimate only moves when the minimum of the window changes: a new
+ * sample with a smaller rtt, or the old minimum ageing out (then every
+ * remaining sample is newer), so anchors only ever move forward.
+ *
+ * @file ClockSync.cpp
+ */
+
+#define FRAME_CRC_OFFSET (CLOCK_SYNC_FRAME_SIZE - 2)
+
+// Offset the model gives at a local time
+static int64_t predicted_offset(const ClockSync* cs, HAL_Micros localUs) {
+    return cs->offsetUs + (int64_t)cs->driftPpb * (localUs - cs->anchorUs) / 1000000000LL;
+}
+
+static void put_i64(uint8_t* out, int64_t v) {
+    for (uint8_t i = 0; i < 8; i++)
+        out[i] = (uint8_t)((uint64_t)v >> (8 * i));
+}
+
+static int64_t get_i64(const uint8_t* in) {
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < 8; i++)
+        v |= (uint64_t)in[i] << (8 * i);
+    return (int64_t)v;
+}
+
+// ============================================================================
+// Exchange
+// ============================================================================
+
+void ClockSync_init(ClockSync* cs) {
+    memset(cs, 0, sizeof(*cs));
+}
+
+bool ClockSync_takeRequest(ClockSync* cs, HAL_Micros nowUs, ClockSyncFrame* request) {
+    bool valid = ClockSync_isValid(cs, nowUs);
+    int64_t period = valid ? CLOCK_SYNC_PERIOD_US : CLOCK_SYNC_FAST_PERIOD_US;
+    if (cs->requests && nowUs - cs->lastRequestUs < period)
+        return false;
+
+    // An unanswered request is simply superseded
+    cs->sequence++;
+    cs->sentUs = nowUs;
+    cs->lastRequestUs = nowUs;
+    cs->requests++;
+
+    request->flags = valid ? CLOCK_SYNC_FLAG_VALID : 0;
+    request->sequence = cs->sequence;
+    request->t1 = nowUs;
+    request->t2 = valid ? predicted_offset(cs, nowUs) : 0;
+    request->t3 = valid ? cs->rttUs : 0;
+    return true;
+}
+
+// Move the estimate to the window's minimum-rtt sample
+static void update_estimate(ClockSync* cs) {
+    const ClockSyncSample* best = NULL;
+    uint8_t oldest = (uint8_t)((cs->head + CLOCK_SYNC_WINDOW - cs->count) % CLOCK_SYNC_WINDOW);
+    for (uint8_t i = 0; i < cs->count; i++) {
+        const ClockSyncSample* s = &cs->window[(oldest + i) % CLOCK_SYNC_WINDOW];
+        if (!best || s->rttUs <= best->rttUs)
+            best = s;
+    }
+    if (cs->valid && best->localUs == cs->anchorUs)
+        return;
+
+    if (!cs->valid) {
+        cs->baseOffsetUs = best->offsetUs;
+        cs->baseUs = best->localUs;
+    } else if (best->localUs - cs->baseUs >= CLOCK_SYNC_DRIFT_MIN_US) {
+        int64_t ppb = (best->offsetUs - cs->baseOffsetUs) * 1000000000LL /
+                      (best->localUs - cs->baseUs);
+        if (ppb <= CLOCK_SYNC_MAX_DRIFT_PPB && ppb >= -CLOCK_SYNC_MAX_DRIFT_PPB) {
+            if (cs->driftKnown)
+                cs->driftPpb += (int32_t)((ppb - cs->driftPpb) / CLOCK_SYNC_DRIFT_GAIN);
+            else
+                cs->driftPpb = (int32_t)ppb;
+            cs->driftKnown = true;
+        }
+        cs->baseOffsetUs = best->offsetUs;
+        cs->baseUs = best->localUs;
+    }
+
+    cs->offsetUs = best->offsetUs;
+    cs->anchorUs = best->localUs;
+    cs->rttUs = best->rttUs;
+    cs->valid = true;
+}
+
+bool ClockSync_onReply(ClockSync* cs, const ClockSyncFrame* reply, HAL_Micros rxUs) {
+    if (!(reply->flags & CLOCK_SYNC_FLAG_REPLY) || !cs->sentUs ||
+        reply->sequence != cs->sequence || reply->t1 != cs->sentUs) {
+        cs->rejected++;
+        return false;
+    }
+    cs->sentUs = 0;
+
+    int64_t rtt = (rxUs - reply->t1) - (reply->t3 - reply->t2);
+    if (rxUs - reply->t1 > CLOCK_SYNC_TIMEOUT_US || rtt < 0 || rtt > CLOCK_SYNC_MAX_RTT_US) {
+        cs->rejected++;
+        return false;
+    }
+
+    ClockSyncSample* s = &cs->window[cs->head];
+    s->offsetUs = ((reply->t2 - reply->t1) + (reply->t3 - rxUs)) / 2;
+    s->localUs = reply->t1 + (rxUs - reply->t1) / 2;
+    s->rttUs = (uint32_t)rtt;
+    cs->head = (uint8_t)((cs->head + 1) % CLOCK_SYNC_WINDOW);
+    if (cs->count < CLOCK_SYNC_WINDOW)
+        cs->count++;
+    cs->replies++;
+
+    if (cs->count >= CLOCK_SYNC_MIN_SAMPLES)
+        update_estimate(cs);
+    return true;
+}
+
+// ============================================================================
+// Conversion
+// ============================================================================
+
+bool ClockSync_isValid(const ClockSync* cs, HAL_Micros localUs) {
+    return cs->valid && localUs - cs->anchorUs < CLOCK_SYNC_STALE_US;
+}
+
+bool ClockSync_toRemote(const ClockSync* cs, HAL_Micros localUs, int64_t* remoteUs) {
+    if (!ClockSync_isValid(cs, localUs))
+        return false;
+    *remoteUs = localUs + predicted_offset(cs, localUs);
+    return true;
+}
+
+bool ClockSync_toLocal(const ClockSync* cs, int64_t remoteUs, HAL_Micros* localUs) {
+    if (!cs->valid)
+        return false;
+    // One correction step: the drift term barely changes over the offset
+    HAL_Micros guess = remoteUs - cs->offsetUs;
+    HAL_Micros local = remoteUs - predicted_offset(cs, guess);
+    if (!ClockSync_isValid(cs, local))
+        return false;
+    *localUs = local;
+    return true;
+}
+
+// ============================================================================
+// Wire Format
+// ============================================================================
+
+size_t ClockSync_encode(const ClockSyncFrame* frame, uint8_t* out, size_t outSize) {
+    if (outSize < CLOCK_SYNC_FRAME_SIZE)
+        return 0;
+    out[0] = CLOCK_SYNC_TYPE;
+    out[1] = frame->flags;
+    out[2] = (uint8_t)(frame->sequence & 0xFF);
+    out[3] = (uint8_t)(frame->sequence >> 8);
+    put_i64(out + 4, frame->t1);
+    put_i64(out + 12, frame->t2);
+    put_i64(out + 20, frame->t3);
+    uint16_t crc = Crc16_compute(out, FRAME_CRC_OFFSET);
+    out[FRAME_CRC_OFFSET] = (uint8_t)(crc & 0xFF);
+    out[FRAME_CRC_OFFSET + 1] = (uint8_t)(crc >> 8);
+    return CLOCK_SYNC_FRAME_SIZE;
+}
+
+bool ClockSync_decode(const uint8_t* data, size_t len, ClockSyncFrame* frame) {
+    if (!data || len != CLOCK_SYNC_FRAME_SIZE || data[0] != CLOCK_SYNC_TYPE)
+        return false;
+    uint16_t crc = (uint16_t)data[FRAME_CRC_OFFSET] | ((uint16_t)data[FRAME_CRC_OFFSET + 1] << 8);
+    if (crc != Crc16_compute(data, FRAME_CRC_OFFSET))
+        return false;
+    frame->flags = data[1];
+    frame->sequence = (uint16_t)data[2] | ((uint16_t)data[3] << 8);
+    frame->t1 = get_i64(data + 4);
+    frame->t2 = get_i64(data + 12);
+    frame->t3 = get_i64(data + 20);
+    return true;
+}
@@ -0,0 +1,161 @@
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "HAL.h"
+
+/**
+ * ClockSync - Controller clock offset and drift over the control link
+ *
+ * NTP-style four-timestamp exchange, started by the vehicle so the
+ * estimate lives where the control frames land:
+ *
+ *   T1 vehicle sends the request        (HAL_Now())
+ *   T2 controller receives it           (controller's own us clock)
+ *   T3 controller sends the reply
+ *   T4 vehicle receives the reply       (HAL_Now() in OnDataRecv)
+ *
+ *   offset = ((T2 - T1) + (T3 - T4)) / 2      controller - vehicle
+ *   rtt    = (T4 - T1) - (T3 - T2)
+ *
+ * The offset is exact when both directions take equally long; queueing
+ * and retries only ever add delay, so of the last CLOCK_SYNC_WINDOW
+ * samples the one with the smallest rtt is the least wrong and becomes
+ * the estimate (error at most rtt / 2). Successive estimates at least
+ * CLOCK_SYNC_DRIFT_MIN_US apart give the rate between the two crystals:
+ *
+ *   controller(local) = local + offset + drift * (local - anchor)
+ *
+ * Both directions use one frame, little endian:
+ *
+ *   | type (0xD4) | flags | sequence (2) | t1 (8) | t2 (8) | t3 (8) |
+ *   | crc16 (2) |
+ *
+ * The controller answers a request by setting REPLY, keeping sequence
+ * and t1, and filling t2 / t3. A request carries the vehicle's current
+ * estimate in t2 (offset) and t3 (rtt) with VALID set, so the controller
+ * can put latency echoes and its own logs on the vehicle clock without
+ * running a filter of its own.
+ *
+ * Only a reply to the outstanding request (same sequence and t1) counts,
+ * so a stale or forged reply is dropped.
+ *
+ * Pure: no globals, no RTOS. One task owns a ClockSync; readers on other
+ * tasks take a copy under the owner's lock.
+ *
+ * @file ClockSync.h
+ */
+
+#define CLOCK_SYNC_TYPE             0xD4
+#define CLOCK_SYNC_FRAME_SIZE       30
+#define CLOCK_SYNC_FLAG_REPLY       0x01
+#define CLOCK_SYNC_FLAG_VALID       0x02    // Request: t2 / t3 hold the estimate
+
+#define CLOCK_SYNC_PERIOD_US        1000000LL   // Request interval once valid
+#define CLOCK_SYNC_FAST_PERIOD_US   200000LL    // Until then
+#define CLOCK_SYNC_TIMEOUT_US       500000LL    // Reply later than this is dropped
+#define CLOCK_SYNC_MAX_RTT_US       50000       // Slower exchanges carry no information
+#define CLOCK_SYNC_WINDOW           8           // Samples the min-rtt filter picks from
+#define CLOCK_SYNC_MIN_SAMPLES      3           // Before the estimate is used
+#define CLOCK_SYNC_STALE_US         30000000LL  // Estimate dropped without replies
+#define CLOCK_SYNC_DRIFT_MIN_US     5000000LL   // Baseline of a drift measurement
+#define CLOCK_SYNC_DRIFT_GAIN       4           // Drift EMA: 1/N of each new measurement
+#define CLOCK_SYNC_MAX_DRIFT_PPB    200000      // 200 ppm, anything more is a bad sample
+
+/**
+ * One frame, either direction
+ */
+typedef struct {
+    uint8_t flags;
+    uint16_t sequence;
+    int64_t t1;
+    int64_t t2;
+    int64_t t3;
+} ClockSyncFrame;
+
+/**
+ * One completed exchange
+ */
+typedef struct {
+    int64_t offsetUs;           // Controller - vehicle
+    HAL_Micros localUs;         // Vehicle time the offset belongs to (T1 + T4) / 2
+    uint32_t rttUs;
+} ClockSyncSample;
+
+typedef struct {
+    ClockSyncSample window[CLOCK_SYNC_WINDOW];
+    uint8_t count;
+    uint8_t head;               // Next slot to overwrite
+
+    // Outstanding request
+    uint16_t sequence;
+    HAL_Micros sentUs;          // T1, 0 = none outstanding
+    HAL_Micros lastRequestUs;
+
+    // Estimate
+    bool valid;
+    int64_t offsetUs;           // Controller - vehicle at anchorUs
+    HAL_Micros anchorUs;
+    uint32_t rttUs;             // Of the sample the estimate came from
+    int32_t driftPpb;           // Controller clock rate relative to ours
+    bool driftKnown;
+    int64_t baseOffsetUs;       // Start of the current drift measurement
+    HAL_Micros baseUs;
+
+    // Statistics
+    uint32_t requests;
+    uint32_t replies;           // Samples taken
+    uint32_t rejected;          // Stale, late or implausible replies
+} ClockSync;
+
+/**
+ * Forget the estimate (new controller or a controller reboot)
+ */
+void ClockSync_init(ClockSync* cs);
+
+/**
+ * Next request, when one is due
+ * @param nowUs Send time, becomes T1
+ * @return false: not due yet
+ */
+bool ClockSync_takeRequest(ClockSync* cs, HAL_Micros nowUs, ClockSyncFrame* request);
+
+/**
+ * A reply from the controller
+ * @param rxUs Reception time (T4)
+ * @return true if it became a sample
+ */
+bool ClockSync_onReply(ClockSync* cs, const ClockSyncFrame* reply, HAL_Micros rxUs);
+
+/**
+ * Whether the estimate can be used at a local time
+ */
+bool ClockSync_isValid(const ClockSync* cs, HAL_Micros localUs);
+
+/**
+ * Controller time of a local time
+ * @return false without a valid estimate (remoteUs untouched)
+ */
+bool ClockSync_toRemote(const ClockSync* cs, HAL_Micros localUs, int64_t* remoteUs);
+
+/**
+ * Local time of a controller time
+ * @return false without a valid estimate (localUs untouched)
+ */
+bool ClockSync_toLocal(const ClockSync* cs, int64_t remoteUs, HAL_Micros* localUs);
+
+/**
+ * Serialize a frame
+ * @return CLOCK_SYNC_FRAME_SIZE, 0 if out is too small
+ */
+size_t ClockSync_encode(const ClockSyncFrame* frame, uint8_t* out, size_t outSize);
+
+/**
+ * Parse a frame
+ * @return false on wrong length, type or CRC
+ */
+bool ClockSync_decode(const uint8_t* data, size_t len, ClockSyncFrame* frame);
+
+#endif // CLOCK_SYNC_H
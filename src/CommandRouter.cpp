@@ -0,0 +1,178 @@
+#include "CommandRouter.h"
+#include <string.h>
+
+/**
+ * CommandRouter - Implementation
+ *
+ * Linear probing over COMMAND_ROUTER_SLOTS; with the table at most
+ * COMMAND_ROUTER_MAX / COMMAND_ROUTER_SLOTS full a probe sequence is a
+ * slot or two, and a miss stops at the first empty slot.
+ *
+ * @file CommandRouter.cpp
+ */
+
+#define SLOT_MASK (COMMAND_ROUTER_SLOTS - 1)
+
+static_assert((COMMAND_ROUTER_SLOTS & SLOT_MASK) == 0, "slots must be a power of two");
+static_assert(COMMAND_ROUTER_SLOTS >= 2 * COMMAND_ROUTER_MAX, "index too full");
+
+bool CommandRouter_init(CommandRouter* router, const CommandSpec* specs, uint8_t count) {
+    memset(router, 0, sizeof(*router));
+    if (count > COMMAND_ROUTER_MAX)
+        return false;
+    router->specs = specs;
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t hash = CommandRouter_hash(specs[i].name);
+        uint32_t slot = hash & SLOT_MASK;
+        while (router->slots[slot]) {
+            if (router->hashes[router->slots[slot] - 1] == hash)
+                return false;
+            slot = (slot + 1) & SLOT_MASK;
+        }
+        router->slots[slot] = i + 1;
+        router->hashes[i] = hash;
+        router->count = i + 1;
+    }
+    return true;
+}
+
+static int lookup(const CommandRouter* router, const char* name) {
+    uint32_t hash = CommandRouter_hash(name);
+    for (uint32_t slot = hash & SLOT_MASK; router->slots[slot]; slot = (slot + 1) & SLOT_MASK) {
+        uint8_t index = router->slots[slot] - 1;
+        if (router->hashes[index] != hash)
+            continue;
+        // Hashes are unique in the table: this is the only candidate
+        if (strcmp(router->specs[index].name, name) == 0)
+            return index;
+        break;
+    }
+    return -1;
+}
+
+int CommandRouter_find(CommandRouter* router, const char* name) {
+    int index = lookup(router, name);
+    if (index < 0)
+        router->unknown++;
+    return index;
+}
+
+const CommandSpec* CommandRouter_spec(const CommandRouter* router, const char* name) {
+    int index = lookup(router, name);
+    return index >= 0 ? &router->specs[index] : NULL;
+}
+
+// ============================================================================
+// Filtered Parsing
+// ============================================================================
+
+static size_t skipWs(const char* s, size_t i, size_t len) {
+    while (i < len && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n'))
+        i++;
+    return i;
+}
+
+/**
+ * Index just past the string opening at s[i] ('"'), len if unterminated
+ */
+static size_t skipString(const char* s, size_t i, size_t len) {
+    for (i++; i < len; i++) {
+        if (s[i] == '\\')
+            i++;
+        else if (s[i] == '"')
+            return i + 1;
+    }
+    return len;
+}
+
+/**
+ * Index just past the value starting at s[i]; nested containers are
+ * skipped by depth, strings with their escapes
+ */
+static size_t skipValue(const char* s, size_t i, size_t len) {
+    int depth = 0;
+    while (i < len) {
+        char ch = s[i];
+        if (ch == '"') {
+            i = skipString(s, i, len);
+        } else if (ch == '{' || ch == '[') {
+            depth++;
+            i++;
+        } else if (ch == '}' || ch == ']') {
+            if (depth == 0)
+                return i;
+            depth--;
+            i++;
+        } else if (ch == ',' && depth == 0) {
+            return i;
+        } else {
+            i++;
+        }
+        if (depth == 0 && (ch == '"' || ch == '}' || ch == ']'))
+            return i;
+    }
+    return len;
+}
+
+bool CommandRouter_peekName(const char* line, size_t len, char* out, size_t outSize) {
+    size_t i = skipWs(line, 0, len);
+    if (i >= len || line[i] != '{')
+        return false;
+    for (i = skipWs(line, i + 1, len); i < len && line[i] == '"';) {
+        size_t keyEnd = skipString(line, i, len);
+        bool isName = keyEnd - i == 3 && line[i + 1] == 'c';
+        i = skipWs(line, keyEnd, len);
+        if (i >= len || line[i] != ':')
+            return false;
+        i = skipWs(line, i + 1, len);
+        if (isName) {
+            if (i >= len || line[i] != '"')
+                return false;
+            size_t start = i + 1;
+            size_t end = start;
+            while (end < len && line[end] != '"' && line[end] != '\\')
+                end++;
+            if (end >= len || line[end] != '"' || end - start >= outSize)
+                return false;
+            memcpy(out, line + start, end - start);
+            out[end - start] = '\0';
+            return true;
+        }
+        i = skipWs(line, skipValue(line, i, len), len);
+        if (i >= len || line[i] != ',')
+            return false;
+        i = skipWs(line, i + 1, len);
+    }
+    return false;
+}
+
+bool CommandRouter_buildFilter(const CommandSpec* spec, JsonDocument& filter) {
+    if (!spec || !spec->fields)
+        return false;
+    filter["c"] = true;
+    filter["hmac"] = true;
+    for (const char* p = spec->fields; *p;) {
+        const char* end = strchr(p, ' ');
+        size_t n = end ? (size_t)(end - p) : strlen(p);
+        if (n)
+            filter[JsonString(p, n)] = true;
+        p += n + (end ? 1 : 0);
+    }
+    return true;
+}
+
+void CommandRouter_recordCall(CommandRouter* router, int index, uint32_t elapsedUs) {
+    if (index < 0 || index >= router->count)
+        return;
+    CommandStats* s = &router->stats[index];
+    s->calls++;
+    s->totalUs += elapsedUs;
+    if (elapsedUs > s->maxUs)
+        s->maxUs = elapsedUs;
+}
+
+void CommandRouter_recordReject(CommandRouter* router, int index) {
+    if (index < 0 || index >= router->count)
+        return;
+    router->stats[index].rejected++;
+}
@@ -0,0 +1,131 @@
+#ifndef COMMAND_ROUTER_H
+#define COMMAND_ROUTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ArduinoJson.h>
+
+/**
+ * CommandRouter - Hash-dispatched serial JSON command table
+ *
+ * Commands are declared once in a constexpr table (name, handler, rate
+ * class, auth requirement). Names are hashed with 32-bit FNV-1a at
+ * compile time; CommandRouter_uniqueHashes() lets the table static_assert
+ * that no two names collide, so a lookup is one hash of the incoming name,
+ * a probe of an open-addressed index built at boot and a single strcmp to
+ * reject unknown names that happen to share a hash.
+ *
+ * Per command the router counts calls, rejections (rate limit / auth) and
+ * handler time. Plain struct, no hardware access.
+ *
+ * A spec may also list the top-level members its handler reads. The name
+ * is peeked from the raw line first, so the line is then parsed once
+ * through a filter built from that list: members the handler never reads
+ * are skipped by the parser instead of being copied into the document.
+ *
+ * @file CommandRouter.h
+ */
+
+#define COMMAND_ROUTER_MAX      120     // Commands in one table
+#define COMMAND_ROUTER_SLOTS    256     // Index size, power of two, > 2x MAX
+#define COMMAND_NAME_MAX        32      // Peeked name, with the NUL
+
+typedef enum {
+    COMMAND_AUTH_NONE = 0,      // Accepted with or without "hmac"
+    COMMAND_AUTH_HMAC = 1,      // Needs a valid "hmac" once the link is secured
+} CommandAuth;
+
+typedef void (*CommandHandler)(JsonDocument& doc);
+
+typedef struct {
+    const char* name;
+    CommandHandler handler;
+    uint8_t rateClass;          // RateLimitClass
+    uint8_t auth;               // CommandAuth
+    const char* fields;         // Members read, space separated; NULL = all
+} CommandSpec;
+
+typedef struct {
+    uint32_t calls;
+    uint32_t rejected;          // Rate limited or unauthenticated
+    uint32_t totalUs;           // Handler time
+    uint32_t maxUs;
+} CommandStats;
+
+typedef struct {
+    const CommandSpec* specs;
+    uint8_t count;
+    uint8_t slots[COMMAND_ROUTER_SLOTS];    // Spec index + 1, 0 = empty
+    uint32_t hashes[COMMAND_ROUTER_MAX];
+    CommandStats stats[COMMAND_ROUTER_MAX];
+    uint32_t unknown;           // Names not in the table
+} CommandRouter;
+
+/**
+ * FNV-1a of a NUL-terminated name (usable in constant expressions)
+ */
+constexpr uint32_t CommandRouter_hash(const char* name, uint32_t h = 2166136261u) {
+    return *name ? CommandRouter_hash(name + 1, (h ^ (uint8_t)*name) * 16777619u) : h;
+}
+
+/**
+ * true if no name in specs[0..count) hashes to hash
+ */
+constexpr bool CommandRouter_hashAbsent(const CommandSpec* specs, size_t count, uint32_t hash) {
+    return count == 0 || (CommandRouter_hash(specs->name) != hash &&
+                          CommandRouter_hashAbsent(specs + 1, count - 1, hash));
+}
+
+/**
+ * true if no two names in the table share a hash (for static_assert)
+ */
+constexpr bool CommandRouter_uniqueHashes(const CommandSpec* specs, size_t count) {
+    return count < 2 ||
+           (CommandRouter_hashAbsent(specs + 1, count - 1, CommandRouter_hash(specs->name)) &&
+            CommandRouter_uniqueHashes(specs + 1, count - 1));
+}
+
+/**
+ * Build the index over a command table (kept by reference)
+ * @return false if the table is too large or a name hash repeats
+ */
+bool CommandRouter_init(CommandRouter* router, const CommandSpec* specs, uint8_t count);
+
+/**
+ * Look up a command name
+ * @return Index into the table, -1 if unknown (counted)
+ */
+int CommandRouter_find(CommandRouter* router, const char* name);
+
+/**
+ * Look up a command name without counting a miss
+ * @return Spec, NULL if unknown
+ */
+const CommandSpec* CommandRouter_spec(const CommandRouter* router, const char* name);
+
+/**
+ * Command name of a JSON line without parsing it: the string value of the
+ * top-level "c" member
+ * @return false if there is none, it is escaped or does not fit outSize
+ */
+bool CommandRouter_peekName(const char* line, size_t len, char* out, size_t outSize);
+
+/**
+ * Parse filter for a spec: its fields plus "c" and "hmac"
+ * @return false if the handler reads the whole document (parse unfiltered)
+ */
+bool CommandRouter_buildFilter(const CommandSpec* spec, JsonDocument& filter);
+
+/**
+ * Account one handler run
+ * @param index From CommandRouter_find()
+ * @param elapsedUs Handler time
+ */
+void CommandRouter_recordCall(CommandRouter* router, int index, uint32_t elapsedUs);
+
+/**
+ * Account one rejected command (rate limit / auth)
+ */
+void CommandRouter_recordReject(CommandRouter* router, int index);
+
+#endif // COMMAND_ROUTER_H
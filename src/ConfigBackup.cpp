@@ -0,0 +1,96 @@
+#include "ConfigBackup.h"
+
+/**
+ * ConfigBackup - Implementation
+ *
+ * The image (CONFIG_IMAGE_MAX at most) is held whole in heap for the
+ * length of one request: the backup buffer lives as long as its
+ * response filler, the restore body in the request's _tempObject, which
+ * the server frees with the request.
+ *
+ * @file ConfigBackup.cpp
+ */
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <memory>
+#include "ConfigManager.h"
+
+static ConfigManager *configManager = NULL;
+static ConfigBackupHooks backupHooks;
+
+static void send_result(AsyncWebServerRequest *request, int code, const char *err) {
+  char body[64];
+  snprintf(body, sizeof(body), "{\"ok\":%s,\"err\":\"%s\"}", code == 200 ? "true" : "false",
+           err);
+  request->send(code, "application/json", body);
+}
+
+static void handle_backup(AsyncWebServerRequest *request) {
+  std::shared_ptr<uint8_t> image((uint8_t *)malloc(CONFIG_IMAGE_MAX), free);
+  size_t len = image ? configManager->backup(image.get(), CONFIG_IMAGE_MAX) : 0;
+  if (len == 0) {
+    send_result(request, 500, image ? "too_large" : "no_memory");
+    return;
+  }
+
+  AsyncWebServerResponse *response = request->beginResponse(
+      "application/octet-stream", len,
+      [image, len](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+        size_t n = len - index < maxLen ? len - index : maxLen;
+        memcpy(buffer, image.get() + index, n);
+        return n;
+      });
+  response->addHeader("Content-Disposition", "attachment; filename=\"config.nacfg\"");
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
+}
+
+static void handle_restore_body(AsyncWebServerRequest *request, uint8_t *data, size_t len,
+                                size_t index, size_t total) {
+  if (index == 0 && total <= CONFIG_IMAGE_MAX)
+    request->_tempObject = malloc(total);
+  if (request->_tempObject && index + len <= total)
+    memcpy((uint8_t *)request->_tempObject + index, data, len);
+}
+
+static void handle_restore(AsyncWebServerRequest *request) {
+  const uint8_t *image = (const uint8_t *)request->_tempObject;
+  size_t len = request->contentLength();
+  if (!image) {
+    send_result(request, len > CONFIG_IMAGE_MAX ? 413 : 400, "bad_body");
+    return;
+  }
+  if (!backupHooks.canRestore()) {
+    send_result(request, 409, "busy");
+    return;
+  }
+  const char *hmac = request->hasHeader(CONFIG_BACKUP_HMAC_HEADER)
+                         ? request->getHeader(CONFIG_BACKUP_HMAC_HEADER)->value().c_str()
+                         : NULL;
+  if (!backupHooks.authorize(image, len, hmac)) {
+    send_result(request, 401, "bad_hmac");
+    return;
+  }
+
+  ConfigImageStatus status = configManager->restore(image, len);
+  if (status != CONFIG_IMAGE_OK) {
+    send_result(request, status == CONFIG_IMAGE_WRITE_FAILED ? 500 : 400,
+                ConfigImage_statusName(status));
+    return;
+  }
+  // Applied by the restart, once the client has the answer
+  request->onDisconnect([]() { backupHooks.restored(); });
+  send_result(request, 200, "");
+}
+
+void ConfigBackup_begin(AsyncWebServer *server, ConfigManager *config,
+                        const ConfigBackupHooks *hooks) {
+  configManager = config;
+  backupHooks = *hooks;
+  server->on("/config/backup", HTTP_GET, handle_backup);
+  server->on("/config/restore", HTTP_POST, handle_restore, NULL, handle_restore_body);
+}
+
+#endif // __XTENSA__
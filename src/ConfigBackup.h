@@ -0,0 +1,48 @@
+#ifndef CONFIG_BACKUP_H
+#define CONFIG_BACKUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * ConfigBackup - Binary config backup / restore over HTTP (port 80)
+ *
+ *   GET  /config/backup    ConfigManager::backup() image, as a download
+ *   POST /config/restore   Raw image as the body; header X-Config-HMAC
+ *                          carries a base64 HMAC-SHA256 of the body
+ *
+ * Cloning a fleet: back up one tuned vehicle, restore the file on the
+ * others. The image holds every stored section with its own CRC, so a
+ * restore is all or nothing: the whole body is validated before the
+ * first NVS write, and everything goes out with one commit. It is
+ * applied by a restart once the response has been sent.
+ *
+ * A restore is refused (409) while the vehicle is armed or running a
+ * mission, and (401) when the hooks' authorize() rejects the HMAC.
+ *
+ * @file ConfigBackup.h
+ */
+
+#define CONFIG_BACKUP_HMAC_HEADER "X-Config-HMAC"
+
+class AsyncWebServer;
+class ConfigManager;
+
+/**
+ * Firmware side of a restore, all called on the async_tcp task
+ */
+typedef struct {
+    bool (*canRestore)(void);   // false while armed or on a mission
+    // hmacB64 is NULL when the header is missing
+    bool (*authorize)(const uint8_t* image, size_t len, const char* hmacB64);
+    void (*restored)(void);     // After the response is out (restart)
+} ConfigBackupHooks;
+
+/**
+ * Register both routes (before server->begin())
+ */
+void ConfigBackup_begin(AsyncWebServer* server, ConfigManager* config,
+                        const ConfigBackupHooks* hooks);
+
+#endif // CONFIG_BACKUP_H
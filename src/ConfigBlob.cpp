@@ -0,0 +1,113 @@
+#include "ConfigBlob.h"
+#include "Crc16.h"
+#include <string.h>
+
+/**
+ * ConfigBlob - Implementation
+ *
+ * @file ConfigBlob.cpp
+ */
+
+// Header + payload, built / read in one piece (NVS blobs are all-or-nothing)
+static uint8_t gBlobScratch[sizeof(ConfigBlobHeader) + CONFIG_BLOB_MAX_PAYLOAD];
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint16_t blob_crc(const ConfigBlobHeader *hdr, const uint8_t *payload) {
+  // version + reserved + length, then payload
+  uint8_t meta[4] = {hdr->version, hdr->reserved,
+                     (uint8_t)(hdr->length & 0xFF), (uint8_t)(hdr->length >> 8)};
+  uint16_t crc = Crc16_compute(meta, sizeof(meta));
+  return Crc16_update(crc, payload, hdr->length);
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+size_t ConfigBlob_encode(uint8_t version, const void *data, size_t len, uint8_t *out,
+                         size_t outSize) {
+  if ((!data && len) || len > CONFIG_BLOB_MAX_PAYLOAD || outSize < sizeof(ConfigBlobHeader) + len)
+    return 0;
+
+  ConfigBlobHeader hdr;
+  hdr.magic = CONFIG_BLOB_MAGIC;
+  hdr.version = version;
+  hdr.reserved = 0;
+  hdr.length = (uint16_t)len;
+  hdr.crc = blob_crc(&hdr, (const uint8_t *)data);
+
+  memmove(out + sizeof(hdr), data, len);
+  memcpy(out, &hdr, sizeof(hdr));
+  return sizeof(hdr) + len;
+}
+
+const uint8_t *ConfigBlob_verify(const uint8_t *blob, size_t len, ConfigBlobHeader *hdr) {
+  ConfigBlobHeader h;
+  if (!blob || len < sizeof(h))
+    return NULL;
+  memcpy(&h, blob, sizeof(h));
+  const uint8_t *payload = blob + sizeof(h);
+  if (h.magic != CONFIG_BLOB_MAGIC || sizeof(h) + h.length != len ||
+      h.crc != blob_crc(&h, payload))
+    return NULL;
+  if (hdr)
+    *hdr = h;
+  return payload;
+}
+
+bool ConfigBlob_save(Preferences &prefs, const char *key, uint8_t version,
+                     const void *data, size_t len) {
+  if (!key)
+    return false;
+  size_t total = ConfigBlob_encode(version, data, len, gBlobScratch, sizeof(gBlobScratch));
+  if (total == 0)
+    return false;
+  return prefs.putBytes(key, gBlobScratch, total) == total;
+}
+
+ConfigBlobStatus ConfigBlob_load(Preferences &prefs, const char *key,
+                                 uint8_t version, void *data, size_t dataSize,
+                                 size_t *loadedLen,
+                                 ConfigBlobMigrateFn migrate) {
+  if (loadedLen)
+    *loadedLen = 0;
+  if (!key || !data)
+    return CONFIG_BLOB_CORRUPT;
+
+  size_t stored = prefs.getBytesLength(key);
+  if (stored == 0)
+    return CONFIG_BLOB_MISSING;
+  if (stored < sizeof(ConfigBlobHeader) || stored > sizeof(gBlobScratch))
+    return CONFIG_BLOB_CORRUPT;
+
+  if (prefs.getBytes(key, gBlobScratch, stored) != stored)
+    return CONFIG_BLOB_CORRUPT;
+
+  ConfigBlobHeader hdr;
+  const uint8_t *payload = ConfigBlob_verify(gBlobScratch, stored, &hdr);
+  if (!payload)
+    return CONFIG_BLOB_CORRUPT;
+
+  if (hdr.version == version) {
+    if (hdr.length > dataSize)
+      return CONFIG_BLOB_CORRUPT;
+    memcpy(data, payload, hdr.length);
+    if (loadedLen)
+      *loadedLen = hdr.length;
+    return CONFIG_BLOB_OK;
+  }
+
+  // Older (or newer) schema: only accepted through a migration hook
+  if (!migrate)
+    return CONFIG_BLOB_CORRUPT;
+
+  size_t n = migrate(hdr.version, payload, hdr.length, data, dataSize);
+  if (n == 0)
+    return CONFIG_BLOB_CORRUPT;
+  if (loadedLen)
+    *loadedLen = n;
+  return CONFIG_BLOB_MIGRATED;
+}
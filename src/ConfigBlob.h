@@ -0,0 +1,106 @@
+#ifndef CONFIG_BLOB_H
+#define CONFIG_BLOB_H
+
+#include <Preferences.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * ConfigBlob - Versioned, CRC-checked binary sections in NVS
+ *
+ * Each config section (or a whole mission) is stored as a single NVS blob:
+ *
+ *   | magic (2) | version (1) | reserved (1) | length (2) | crc16 (2) | payload |
+ *
+ * so a section load or save is one flash transaction instead of one per
+ * field. The CRC (NA_CRC16) covers version, length and payload. When the
+ * stored schema version differs from the caller's, an optional migration
+ * hook converts the old payload; otherwise the blob is rejected and the
+ * caller falls back to defaults / legacy keys.
+ *
+ * Uses one shared scratch buffer: call from boot or the comms task only.
+ *
+ * @file ConfigBlob.h
+ */
+
+#define CONFIG_BLOB_MAGIC       0xC0F1
+#define CONFIG_BLOB_MAX_PAYLOAD 3584    // Fits a MAX_WAYPOINTS mission (14 B each)
+
+/**
+ * Blob header (stored little endian, packed)
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t length;
+    uint16_t crc;
+} ConfigBlobHeader;
+
+/**
+ * Load result
+ */
+typedef enum {
+    CONFIG_BLOB_OK = 0,         // Current version, payload copied
+    CONFIG_BLOB_MIGRATED = 1,   // Older version converted, caller should re-save
+    CONFIG_BLOB_MISSING = 2,    // Key not present
+    CONFIG_BLOB_CORRUPT = 3,    // Bad magic / CRC / size, or no migration path
+} ConfigBlobStatus;
+
+/**
+ * Migration hook: convert an old payload into the current layout
+ * @param fromVersion Stored schema version
+ * @param oldData Stored payload
+ * @param oldLen Stored payload length
+ * @param out Current-layout output (pre-filled with caller defaults)
+ * @param outSize Size of out
+ * @return Bytes of out now valid, or 0 if migration is impossible
+ */
+typedef size_t (*ConfigBlobMigrateFn)(uint8_t fromVersion,
+                                      const uint8_t* oldData, size_t oldLen,
+                                      void* out, size_t outSize);
+
+/**
+ * Build a blob (header + payload) in memory, as ConfigBlob_save() stores it
+ * @param out Output, at least sizeof(ConfigBlobHeader) + len
+ * @return Blob length, 0 if it does not fit or len is too large
+ */
+size_t ConfigBlob_encode(uint8_t version, const void* data, size_t len, uint8_t* out,
+                         size_t outSize);
+
+/**
+ * Check a stored blob (magic, length and CRC), any version
+ * @param hdr Output: the header (may be NULL)
+ * @return Payload inside blob, NULL if the blob is corrupt
+ */
+const uint8_t* ConfigBlob_verify(const uint8_t* blob, size_t len, ConfigBlobHeader* hdr);
+
+/**
+ * Write a section as one blob
+ * @param prefs Open Preferences namespace (read/write)
+ * @param key NVS key (max 15 chars)
+ * @param version Schema version of data
+ * @param data Payload
+ * @param len Payload length (max CONFIG_BLOB_MAX_PAYLOAD)
+ * @return true if the blob was written
+ */
+bool ConfigBlob_save(Preferences& prefs, const char* key, uint8_t version,
+                     const void* data, size_t len);
+
+/**
+ * Read a section blob
+ * @param prefs Open Preferences namespace
+ * @param key NVS key
+ * @param version Schema version the caller expects
+ * @param data Output payload (only valid when OK / MIGRATED)
+ * @param dataSize Size of data
+ * @param loadedLen Output: payload bytes written (may be NULL)
+ * @param migrate Migration hook for older versions (may be NULL)
+ * @return Load status
+ */
+ConfigBlobStatus ConfigBlob_load(Preferences& prefs, const char* key,
+                                 uint8_t version, void* data, size_t dataSize,
+                                 size_t* loadedLen,
+                                 ConfigBlobMigrateFn migrate);
+
+#endif // CONFIG_BLOB_H
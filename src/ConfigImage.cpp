@@ -0,0 +1,158 @@
+#include "ConfigImage.h"
+#include "ConfigBlob.h"
+#include "Crc16.h"
+#include <string.h>
+
+/**
+ * ConfigImage - Implementation
+ *
+ * @file ConfigImage.cpp
+ */
+
+#define CRC_OFFSET 8    // Header bytes covered by the CRC
+
+static const char* const STATUS_NAMES[] = {
+    "ok", "truncated", "bad_magic", "bad_version", "bad_crc", "bad_entry", "bad_blob",
+    "unknown_key", "write_failed",
+};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t imageCrc(const uint8_t* image, size_t len) {
+    uint16_t crc = Crc16_compute(image, CRC_OFFSET);
+    return Crc16_update(crc, image + CONFIG_IMAGE_HEADER, len - CONFIG_IMAGE_HEADER);
+}
+
+/**
+ * Parse the entry at offset without trusting it
+ * @return Offset past the entry, 0 if malformed
+ */
+static size_t parseEntry(const uint8_t* image, size_t len, size_t offset,
+                         ConfigImageEntry* entry) {
+    if (offset + 1 > len) return 0;
+    uint8_t keyLen = image[offset++];
+    if (keyLen == 0 || keyLen > CONFIG_IMAGE_KEY_MAX || offset + keyLen + 2 > len)
+        return 0;
+    memcpy(entry->key, image + offset, keyLen);
+    entry->key[keyLen] = '\0';
+    if (strlen(entry->key) != keyLen) return 0;
+    offset += keyLen;
+    entry->blobLen = get16(image + offset);
+    offset += 2;
+    if (offset + entry->blobLen > len) return 0;
+    entry->blob = image + offset;
+    return offset + entry->blobLen;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void ConfigImage_begin(ConfigImageWriter* w, uint8_t* buf, size_t size) {
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->size = size;
+    w->len = CONFIG_IMAGE_HEADER;
+    w->overflow = size < CONFIG_IMAGE_HEADER;
+}
+
+bool ConfigImage_add(ConfigImageWriter* w, const char* key, const uint8_t* blob, size_t len) {
+    size_t keyLen = key ? strlen(key) : 0;
+    if (keyLen == 0 || keyLen > CONFIG_IMAGE_KEY_MAX || !ConfigBlob_verify(blob, len, NULL))
+        return false;
+    size_t need = 1 + keyLen + 2 + len;
+    if (w->overflow || w->count == 0xFF || w->len + need > w->size) {
+        w->overflow = true;
+        return false;
+    }
+    uint8_t* p = w->buf + w->len;
+    *p++ = (uint8_t)keyLen;
+    memcpy(p, key, keyLen);
+    p += keyLen;
+    put16(p, (uint16_t)len);
+    memmove(p + 2, blob, len);
+    w->len += need;
+    w->count++;
+    return true;
+}
+
+size_t ConfigImage_finish(ConfigImageWriter* w) {
+    if (w->overflow) return 0;
+    uint8_t* h = w->buf;
+    put16(h, CONFIG_IMAGE_MAGIC);
+    h[2] = CONFIG_IMAGE_VERSION;
+    h[3] = w->count;
+    put32(h + 4, (uint32_t)(w->len - CONFIG_IMAGE_HEADER));
+    put16(h + CRC_OFFSET, imageCrc(w->buf, w->len));
+    return w->len;
+}
+
+ConfigImageStatus ConfigImage_validate(const uint8_t* image, size_t len) {
+    if (!image || len < CONFIG_IMAGE_HEADER) return CONFIG_IMAGE_TRUNCATED;
+    if (get16(image) != CONFIG_IMAGE_MAGIC) return CONFIG_IMAGE_BAD_MAGIC;
+    if (image[2] != CONFIG_IMAGE_VERSION) return CONFIG_IMAGE_BAD_VERSION;
+    if (CONFIG_IMAGE_HEADER + get32(image + 4) != len) return CONFIG_IMAGE_TRUNCATED;
+    if (get16(image + CRC_OFFSET) != imageCrc(image, len)) return CONFIG_IMAGE_BAD_CRC;
+
+    uint8_t count = image[3];
+    size_t offset = CONFIG_IMAGE_HEADER;
+    for (uint8_t i = 0; i < count; i++) {
+        ConfigImageEntry entry;
+        size_t next = parseEntry(image, len, offset, &entry);
+        if (next == 0) return CONFIG_IMAGE_BAD_ENTRY;
+        if (!ConfigBlob_verify(entry.blob, entry.blobLen, NULL)) return CONFIG_IMAGE_BAD_BLOB;
+
+        // A key twice would make the restore order matter
+        ConfigImageReader r;
+        ConfigImageEntry earlier;
+        ConfigImage_open(&r, image, len);
+        for (uint8_t j = 0; j < i && ConfigImage_next(&r, &earlier); j++) {
+            if (strcmp(earlier.key, entry.key) == 0) return CONFIG_IMAGE_BAD_ENTRY;
+        }
+        offset = next;
+    }
+    return offset == len ? CONFIG_IMAGE_OK : CONFIG_IMAGE_BAD_ENTRY;
+}
+
+void ConfigImage_open(ConfigImageReader* r, const uint8_t* image, size_t len) {
+    r->image = image;
+    r->len = len;
+    r->offset = CONFIG_IMAGE_HEADER;
+    r->index = 0;
+    r->count = len >= CONFIG_IMAGE_HEADER ? image[3] : 0;
+}
+
+bool ConfigImage_next(ConfigImageReader* r, ConfigImageEntry* entry) {
+    if (r->index >= r->count) return false;
+    size_t next = parseEntry(r->image, r->len, r->offset, entry);
+    if (next == 0) return false;
+    r->offset = next;
+    r->index++;
+    return true;
+}
+
+const char* ConfigImage_statusName(ConfigImageStatus status) {
+    return (unsigned)status < sizeof(STATUS_NAMES) / sizeof(STATUS_NAMES[0])
+               ? STATUS_NAMES[status] : "?";
+}
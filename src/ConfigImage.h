@@ -0,0 +1,108 @@
+#ifndef CONFIG_IMAGE_H
+#define CONFIG_IMAGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * ConfigImage - Every stored config blob of a vehicle as one binary image
+ *
+ * The backup / restore format for cloning a vehicle's settings (see
+ * ConfigManager::backup()): a header, then one entry per NVS key holding
+ * that key's blob exactly as ConfigBlob stores it, so each section keeps
+ * its own schema version and CRC and is checked again on restore:
+ *
+ *   | magic (2) | version (1) | count (1) | length (4) | crc16 (2) |
+ *   | keyLen (1) | key | blobLen (2) | blob |  ... count entries
+ *
+ * length covers the entries, the CRC (NA_CRC16) the header bytes before
+ * it and every entry. All fields little endian.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file ConfigImage.h
+ */
+
+#define CONFIG_IMAGE_MAGIC      0xC1A6
+#define CONFIG_IMAGE_VERSION    1
+#define CONFIG_IMAGE_HEADER     10
+#define CONFIG_IMAGE_KEY_MAX    15      // NVS key limit
+#define CONFIG_IMAGE_MAX        8192    // Sections, mission, fence and the rest
+#define CONFIG_IMAGE_ENTRY_MAX_OVERHEAD (1 + CONFIG_IMAGE_KEY_MAX + 2)
+
+/**
+ * Validation result
+ */
+typedef enum {
+    CONFIG_IMAGE_OK = 0,
+    CONFIG_IMAGE_TRUNCATED,     // Shorter than its header says
+    CONFIG_IMAGE_BAD_MAGIC,
+    CONFIG_IMAGE_BAD_VERSION,
+    CONFIG_IMAGE_BAD_CRC,
+    CONFIG_IMAGE_BAD_ENTRY,     // Malformed entry or duplicate key
+    CONFIG_IMAGE_BAD_BLOB,      // An entry's blob fails its own CRC
+    CONFIG_IMAGE_UNKNOWN_KEY,   // Restore: a key this vehicle does not back up
+    CONFIG_IMAGE_WRITE_FAILED,  // Restore: NVS refused a write
+} ConfigImageStatus;
+
+typedef struct {
+    uint8_t* buf;
+    size_t size;
+    size_t len;                 // Bytes written so far
+    uint8_t count;
+    bool overflow;              // An entry did not fit
+} ConfigImageWriter;
+
+/**
+ * One entry, pointing into the image
+ */
+typedef struct {
+    char key[CONFIG_IMAGE_KEY_MAX + 1];
+    const uint8_t* blob;
+    uint16_t blobLen;
+} ConfigImageEntry;
+
+typedef struct {
+    const uint8_t* image;
+    size_t len;
+    size_t offset;
+    uint8_t index;
+    uint8_t count;
+} ConfigImageReader;
+
+void ConfigImage_begin(ConfigImageWriter* w, uint8_t* buf, size_t size);
+
+/**
+ * Append a key's stored blob
+ * @param blob May lie in the unused tail of the writer's buffer (read
+ *             straight from NVS there), CONFIG_IMAGE_ENTRY_MAX_OVERHEAD or
+ *             more bytes past len
+ * @return false if the key or blob is invalid or the image is full
+ */
+bool ConfigImage_add(ConfigImageWriter* w, const char* key, const uint8_t* blob, size_t len);
+
+/**
+ * Write the header
+ * @return Image length, 0 if an entry overflowed
+ */
+size_t ConfigImage_finish(ConfigImageWriter* w);
+
+/**
+ * Check the header, CRC, every entry and every blob's own CRC
+ */
+ConfigImageStatus ConfigImage_validate(const uint8_t* image, size_t len);
+
+/**
+ * Walk a validated image: open once, then next() per entry
+ */
+void ConfigImage_open(ConfigImageReader* r, const uint8_t* image, size_t len);
+
+/**
+ * @return false past the last entry
+ */
+bool ConfigImage_next(ConfigImageReader* r, ConfigImageEntry* entry);
+
+const char* ConfigImage_statusName(ConfigImageStatus status);
+
+#endif // CONFIG_IMAGE_H
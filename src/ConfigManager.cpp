@@ -1,4 +1,9 @@
 #include "ConfigManager.h"
+#include "ConfigBlob.h"
+#include "HAL.h"
+#if defined(__XTENSA__)
+#include <nvs.h>
+#endif
 
 const char *ConfigManager::NAMESPACE = "na_config";
 
@@ -8,6 +13,8 @@ bool ConfigManager::begin() {
   bool success = prefs.begin(NAMESPACE, false); // false = read/write mode
 
   if (success) {
+    loadAll();
+
     JsonDocument doc;
     doc["msg"] = "ConfigManager initialized";
     doc["ns"] = NAMESPACE;
@@ -23,19 +30,221 @@ bool ConfigManager::begin() {
   return success;
 }
 
+// ===== RAM Cache / Write-Back =====
+void ConfigManager::loadAll() {
+  // One blob read per section; per-key layout (pre-blob firmware) is the
+  // fallback and gets rewritten as a blob on the next flush
+  uint8_t legacy = 0;
+
+  PIDConfig pid;
+  if (!loadSection(CONFIG_KEY_PID, &pid, sizeof(pid))) {
+    pid.kp = prefs.getFloat("pid_kp", 1.2f);
+    pid.ki = prefs.getFloat("pid_ki", 0.05f);
+    pid.kd = prefs.getFloat("pid_kd", 0.4f);
+    legacy |= DIRTY_PID;
+  }
+
+  MotorConfig motor;
+  if (!loadSection(CONFIG_KEY_MOTOR, &motor, sizeof(motor))) {
+    motor.minPWM = prefs.getUChar("mot_min", 40);
+    motor.maxRamp = prefs.getUChar("mot_ramp", 5);
+    motor.deadband = prefs.getUChar("mot_db", 10);
+    legacy |= DIRTY_MOTOR;
+  }
+
+  JoystickCalibration calib;
+  if (!loadSection(CONFIG_KEY_JOYSTICK, &calib, sizeof(calib))) {
+    calib.minThrottle = prefs.getShort("cal_t_min", 0);
+    calib.centerThrottle = prefs.getShort("cal_t_ctr", 512);
+    calib.maxThrottle = prefs.getShort("cal_t_max", 1023);
+    calib.minRoll = prefs.getShort("cal_r_min", 0);
+    calib.centerRoll = prefs.getShort("cal_r_ctr", 512);
+    calib.maxRoll = prefs.getShort("cal_r_max", 1023);
+    calib.minPitch = prefs.getShort("cal_p_min", 0);
+    calib.centerPitch = prefs.getShort("cal_p_ctr", 512);
+    calib.maxPitch = prefs.getShort("cal_p_max", 1023);
+    calib.minYaw = prefs.getShort("cal_y_min", 0);
+    calib.centerYaw = prefs.getShort("cal_y_ctr", 512);
+    calib.maxYaw = prefs.getShort("cal_y_max", 1023);
+    legacy |= DIRTY_JOYSTICK;
+  }
+
+  DeadzoneConfig deadzone;
+  if (!loadSection(CONFIG_KEY_DEADZONE, &deadzone, sizeof(deadzone))) {
+    deadzone.throttle = prefs.getUChar("dz_t", 5);
+    deadzone.roll = prefs.getUChar("dz_r", 5);
+    deadzone.pitch = prefs.getUChar("dz_p", 5);
+    deadzone.yaw = prefs.getUChar("dz_y", 5);
+    legacy |= DIRTY_DEADZONE;
+  }
+
+  SecurityConfig sec;
+  if (!loadSection(CONFIG_KEY_SECURITY, &sec, sizeof(sec))) {
+    sec.encryptionEnabled = prefs.getBool("sec_enc", false);
+    prefs.getBytes("sec_key", sec.sharedSecret, 32);
+    sec.hmacEnabled = prefs.getBool("sec_hmac", true);
+    sec.rateLimitEnabled = prefs.getBool("sec_rl_en", true);
+    sec.rateLimitCPS = prefs.getUShort("sec_rl_cps", 100);
+    legacy |= DIRTY_SECURITY;
+  }
+
+  char mac[MAC_STRING_LEN] = {0};
+  prefs.getString("paired_mac", mac, sizeof(mac));
+  bool calibrated = prefs.getBool("cal_done", false);
+
+  portENTER_CRITICAL(&_cacheMux);
+  _pid = pid;
+  _pidRevision++;
+  _motor = motor;
+  _motorRevision++;
+  _joystick = calib;
+  _deadzone = deadzone;
+  _security = sec;
+  memcpy(_pairedMac, mac, sizeof(_pairedMac));
+  _pairedMac[sizeof(_pairedMac) - 1] = '\0';
+  _joystickCalibrated = calibrated;
+  _dirty = legacy;
+  portEXIT_CRITICAL(&_cacheMux);
+}
+
+bool ConfigManager::loadSection(const char *key, void *data, size_t len) {
+  size_t loaded = 0;
+  ConfigBlobStatus status = ConfigBlob_load(prefs, key, CONFIG_SCHEMA_VERSION,
+                                            data, len, &loaded, nullptr);
+  // Size mismatch means the struct changed without a schema bump
+  return status == CONFIG_BLOB_OK && loaded == len;
+}
+
+// ===== Change Observers =====
+static ConfigManager::Change sectionChange(const ConfigManager::PIDConfig &before,
+                                           const ConfigManager::PIDConfig &after) {
+  ConfigManager::Change change;
+  change.section = ConfigManager::SECTION_PID;
+  change.before.pid = &before;
+  change.after.pid = &after;
+  return change;
+}
+
+static ConfigManager::Change sectionChange(const ConfigManager::MotorConfig &before,
+                                           const ConfigManager::MotorConfig &after) {
+  ConfigManager::Change change;
+  change.section = ConfigManager::SECTION_MOTOR;
+  change.before.motor = &before;
+  change.after.motor = &after;
+  return change;
+}
+
+static ConfigManager::Change sectionChange(const ConfigManager::JoystickCalibration &before,
+                                           const ConfigManager::JoystickCalibration &after) {
+  ConfigManager::Change change;
+  change.section = ConfigManager::SECTION_JOYSTICK;
+  change.before.joystick = &before;
+  change.after.joystick = &after;
+  return change;
+}
+
+static ConfigManager::Change sectionChange(const ConfigManager::DeadzoneConfig &before,
+                                           const ConfigManager::DeadzoneConfig &after) {
+  ConfigManager::Change change;
+  change.section = ConfigManager::SECTION_DEADZONE;
+  change.before.deadzone = &before;
+  change.after.deadzone = &after;
+  return change;
+}
+
+static ConfigManager::Change sectionChange(const ConfigManager::SecurityConfig &before,
+                                           const ConfigManager::SecurityConfig &after) {
+  ConfigManager::Change change;
+  change.section = ConfigManager::SECTION_SECURITY;
+  change.before.security = &before;
+  change.after.security = &after;
+  return change;
+}
+
+bool ConfigManager::addObserver(Section section, Observer observer, void *ctx) {
+  if (!observer || section >= SECTION_COUNT || _observerCount >= CONFIG_MAX_OBSERVERS)
+    return false;
+  _observers[_observerCount].section = section;
+  _observers[_observerCount].observer = observer;
+  _observers[_observerCount].ctx = ctx;
+  _observerCount++;
+  return true;
+}
+
+void ConfigManager::notify(const Change &change) {
+  for (uint8_t i = 0; i < _observerCount; i++) {
+    if (_observers[i].section == change.section)
+      _observers[i].observer(change, _observers[i].ctx);
+  }
+}
+
+void ConfigManager::markDirty(uint8_t section) {
+  uint32_t now = HAL_GetMillis();
+  portENTER_CRITICAL(&_cacheMux);
+  _lastChangeMs = now;
+  _dirty |= section;
+  portEXIT_CRITICAL(&_cacheMux);
+}
+
+void ConfigManager::update(uint32_t nowMs) {
+  if (_dirty == 0)
+    return;
+  // Coalesce bursts (e.g. slider drags in the configurator)
+  if (nowMs - _lastChangeMs < CONFIG_FLUSH_DELAY_MS)
+    return;
+  flush();
+}
+
+void ConfigManager::flush() {
+  // Snapshot under the lock, write to flash outside it
+  portENTER_CRITICAL(&_cacheMux);
+  uint8_t dirty = _dirty;
+  _dirty = 0;
+  PIDConfig pid = _pid;
+  MotorConfig motor = _motor;
+  JoystickCalibration calib = _joystick;
+  DeadzoneConfig deadzone = _deadzone;
+  SecurityConfig sec = _security;
+  char mac[sizeof(_pairedMac)];
+  memcpy(mac, _pairedMac, sizeof(mac));
+  portEXIT_CRITICAL(&_cacheMux);
+
+  if (dirty & DIRTY_PID)
+    savePIDConfig(pid);
+  if (dirty & DIRTY_MOTOR)
+    saveMotorConfig(motor);
+  if (dirty & DIRTY_JOYSTICK)
+    saveJoystickCalibration(calib);
+  if (dirty & DIRTY_DEADZONE)
+    saveDeadzoneConfig(deadzone);
+  if (dirty & DIRTY_SECURITY)
+    saveSecurityConfig(sec);
+  if (dirty & DIRTY_PAIRING)
+    prefs.putString("paired_mac", mac);
+}
+
 // ===== PID Configuration =====
 ConfigManager::PIDConfig ConfigManager::getPIDConfig() {
-  PIDConfig config;
-  config.kp = prefs.getFloat("pid_kp", 1.2f);
-  config.ki = prefs.getFloat("pid_ki", 0.05f);
-  config.kd = prefs.getFloat("pid_kd", 0.4f);
+  portENTER_CRITICAL(&_cacheMux);
+  PIDConfig config = _pid;
+  portEXIT_CRITICAL(&_cacheMux);
   return config;
 }
 
+void ConfigManager::savePIDConfig(const PIDConfig &config) {
+  ConfigBlob_save(prefs, CONFIG_KEY_PID, CONFIG_SCHEMA_VERSION, &config,
+                  sizeof(config));
+}
+
 void ConfigManager::setPIDConfig(const PIDConfig &config) {
-  prefs.putFloat("pid_kp", config.kp);
-  prefs.putFloat("pid_ki", config.ki);
-  prefs.putFloat("pid_kd", config.kd);
+  PIDConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _pid;
+  _pid = config;
+  _pidRevision++;
+  portEXIT_CRITICAL(&_cacheMux);
+  markDirty(DIRTY_PID);
+  notify(sectionChange(before, config));
 
   JsonDocument doc;
   doc["msg"] = "PID config saved";
@@ -47,25 +256,44 @@ void ConfigManager::setPIDConfig(const PIDConfig &config) {
 }
 
 void ConfigManager::resetPIDConfig() {
+  const PIDConfig defaults;
+  PIDConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _pid;
+  _pid = defaults;
+  _pidRevision++;
+  _dirty &= ~DIRTY_PID;
+  portEXIT_CRITICAL(&_cacheMux);
+  prefs.remove(CONFIG_KEY_PID);
   prefs.remove("pid_kp");
   prefs.remove("pid_ki");
   prefs.remove("pid_kd");
+  notify(sectionChange(before, defaults));
   Serial.println("{\"msg\":\"PID config reset to defaults\"}");
 }
 
 // ===== Motor Configuration =====
 ConfigManager::MotorConfig ConfigManager::getMotorConfig() {
-  MotorConfig config;
-  config.minPWM = prefs.getUChar("mot_min", 40);
-  config.maxRamp = prefs.getUChar("mot_ramp", 5);
-  config.deadband = prefs.getUChar("mot_db", 10);
+  portENTER_CRITICAL(&_cacheMux);
+  MotorConfig config = _motor;
+  portEXIT_CRITICAL(&_cacheMux);
   return config;
 }
 
+void ConfigManager::saveMotorConfig(const MotorConfig &config) {
+  ConfigBlob_save(prefs, CONFIG_KEY_MOTOR, CONFIG_SCHEMA_VERSION, &config,
+                  sizeof(config));
+}
+
 void ConfigManager::setMotorConfig(const MotorConfig &config) {
-  prefs.putUChar("mot_min", config.minPWM);
-  prefs.putUChar("mot_ramp", config.maxRamp);
-  prefs.putUChar("mot_db", config.deadband);
+  MotorConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _motor;
+  _motor = config;
+  _motorRevision++;
+  portEXIT_CRITICAL(&_cacheMux);
+  markDirty(DIRTY_MOTOR);
+  notify(sectionChange(before, config));
 
   JsonDocument doc;
   doc["msg"] = "Motor config saved";
@@ -77,19 +305,38 @@ void ConfigManager::setMotorConfig(const MotorConfig &config) {
 }
 
 void ConfigManager::resetMotorConfig() {
+  const MotorConfig defaults;
+  MotorConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _motor;
+  _motor = defaults;
+  _motorRevision++;
+  _dirty &= ~DIRTY_MOTOR;
+  portEXIT_CRITICAL(&_cacheMux);
+  prefs.remove(CONFIG_KEY_MOTOR);
   prefs.remove("mot_min");
   prefs.remove("mot_ramp");
   prefs.remove("mot_db");
+  notify(sectionChange(before, defaults));
   Serial.println("{\"msg\":\"Motor config reset to defaults\"}");
 }
 
 // ===== Vehicle Pairing =====
-String ConfigManager::getPairedMACAddress() {
-  return prefs.getString("paired_mac", "");
+void ConfigManager::getPairedMACAddress(char *mac, size_t len) {
+  if (len == 0)
+    return;
+  portENTER_CRITICAL(&_cacheMux);
+  strncpy(mac, _pairedMac, len - 1);
+  portEXIT_CRITICAL(&_cacheMux);
+  mac[len - 1] = '\0';
 }
 
-void ConfigManager::setPairedMACAddress(const String &macAddress) {
-  prefs.putString("paired_mac", macAddress);
+void ConfigManager::setPairedMACAddress(const char *macAddress) {
+  portENTER_CRITICAL(&_cacheMux);
+  memset(_pairedMac, 0, sizeof(_pairedMac));
+  strncpy(_pairedMac, macAddress, sizeof(_pairedMac) - 1);
+  portEXIT_CRITICAL(&_cacheMux);
+  markDirty(DIRTY_PAIRING);
 
   JsonDocument doc;
   doc["msg"] = "Vehicle pairing saved";
@@ -99,58 +346,49 @@ void ConfigManager::setPairedMACAddress(const String &macAddress) {
 }
 
 void ConfigManager::clearPairing() {
+  portENTER_CRITICAL(&_cacheMux);
+  memset(_pairedMac, 0, sizeof(_pairedMac));
+  _dirty &= ~DIRTY_PAIRING;
+  portEXIT_CRITICAL(&_cacheMux);
   prefs.remove("paired_mac");
   Serial.println("{\"msg\":\"Vehicle pairing cleared\"}");
 }
 
 // ===== Joystick Calibration =====
 ConfigManager::JoystickCalibration ConfigManager::getJoystickCalibration() {
-  JoystickCalibration calib;
-
-  // Throttle
-  calib.minThrottle = prefs.getShort("cal_t_min", 0);
-  calib.centerThrottle = prefs.getShort("cal_t_ctr", 512);
-  calib.maxThrottle = prefs.getShort("cal_t_max", 1023);
-
-  // Roll
-  calib.minRoll = prefs.getShort("cal_r_min", 0);
-  calib.centerRoll = prefs.getShort("cal_r_ctr", 512);
-  calib.maxRoll = prefs.getShort("cal_r_max", 1023);
-
-  // Pitch
-  calib.minPitch = prefs.getShort("cal_p_min", 0);
-  calib.centerPitch = prefs.getShort("cal_p_ctr", 512);
-  calib.maxPitch = prefs.getShort("cal_p_max", 1023);
-
-  // Yaw
-  calib.minYaw = prefs.getShort("cal_y_min", 0);
-  calib.centerYaw = prefs.getShort("cal_y_ctr", 512);
-  calib.maxYaw = prefs.getShort("cal_y_max", 1023);
-
+  portENTER_CRITICAL(&_cacheMux);
+  JoystickCalibration calib = _joystick;
+  portEXIT_CRITICAL(&_cacheMux);
   return calib;
 }
 
-void ConfigManager::setJoystickCalibration(const JoystickCalibration &calib) {
-  prefs.putShort("cal_t_min", calib.minThrottle);
-  prefs.putShort("cal_t_ctr", calib.centerThrottle);
-  prefs.putShort("cal_t_max", calib.maxThrottle);
-
-  prefs.putShort("cal_r_min", calib.minRoll);
-  prefs.putShort("cal_r_ctr", calib.centerRoll);
-  prefs.putShort("cal_r_max", calib.maxRoll);
-
-  prefs.putShort("cal_p_min", calib.minPitch);
-  prefs.putShort("cal_p_ctr", calib.centerPitch);
-  prefs.putShort("cal_p_max", calib.maxPitch);
+void ConfigManager::saveJoystickCalibration(const JoystickCalibration &calib) {
+  ConfigBlob_save(prefs, CONFIG_KEY_JOYSTICK, CONFIG_SCHEMA_VERSION, &calib,
+                  sizeof(calib));
+}
 
-  prefs.putShort("cal_y_min", calib.minYaw);
-  prefs.putShort("cal_y_ctr", calib.centerYaw);
-  prefs.putShort("cal_y_max", calib.maxYaw);
+void ConfigManager::setJoystickCalibration(const JoystickCalibration &calib) {
+  JoystickCalibration before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _joystick;
+  _joystick = calib;
+  portEXIT_CRITICAL(&_cacheMux);
+  markDirty(DIRTY_JOYSTICK);
+  notify(sectionChange(before, calib));
 
   Serial.println("{\"msg\":\"Joystick calibration saved\"}");
 }
 
 void ConfigManager::resetJoystickCalibration() {
+  const JoystickCalibration defaults;
+  JoystickCalibration before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _joystick;
+  _joystick = defaults;
+  _joystickCalibrated = false;
+  _dirty &= ~DIRTY_JOYSTICK;
+  portEXIT_CRITICAL(&_cacheMux);
+  prefs.remove(CONFIG_KEY_JOYSTICK);
   prefs.remove("cal_t_min");
   prefs.remove("cal_t_ctr");
   prefs.remove("cal_t_max");
@@ -164,28 +402,33 @@ void ConfigManager::resetJoystickCalibration() {
   prefs.remove("cal_y_ctr");
   prefs.remove("cal_y_max");
   prefs.remove("cal_done");
+  notify(sectionChange(before, defaults));
   Serial.println("{\"msg\":\"Joystick calibration reset to defaults\"}");
 }
 
-bool ConfigManager::isJoystickCalibrated() {
-  return prefs.getBool("cal_done", false);
-}
+bool ConfigManager::isJoystickCalibrated() { return _joystickCalibrated; }
 
 // ===== Deadzone Configuration =====
 ConfigManager::DeadzoneConfig ConfigManager::getDeadzoneConfig() {
-  DeadzoneConfig config;
-  config.throttle = prefs.getUChar("dz_t", 5);
-  config.roll = prefs.getUChar("dz_r", 5);
-  config.pitch = prefs.getUChar("dz_p", 5);
-  config.yaw = prefs.getUChar("dz_y", 5);
+  portENTER_CRITICAL(&_cacheMux);
+  DeadzoneConfig config = _deadzone;
+  portEXIT_CRITICAL(&_cacheMux);
   return config;
 }
 
+void ConfigManager::saveDeadzoneConfig(const DeadzoneConfig &config) {
+  ConfigBlob_save(prefs, CONFIG_KEY_DEADZONE, CONFIG_SCHEMA_VERSION, &config,
+                  sizeof(config));
+}
+
 void ConfigManager::setDeadzoneConfig(const DeadzoneConfig &config) {
-  prefs.putUChar("dz_t", config.throttle);
-  prefs.putUChar("dz_r", config.roll);
-  prefs.putUChar("dz_p", config.pitch);
-  prefs.putUChar("dz_y", config.yaw);
+  DeadzoneConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _deadzone;
+  _deadzone = config;
+  portEXIT_CRITICAL(&_cacheMux);
+  markDirty(DIRTY_DEADZONE);
+  notify(sectionChange(before, config));
 
   JsonDocument doc;
   doc["msg"] = "Deadzone config saved";
@@ -198,30 +441,44 @@ void ConfigManager::setDeadzoneConfig(const DeadzoneConfig &config) {
 }
 
 void ConfigManager::resetDeadzoneConfig() {
+  const DeadzoneConfig defaults;
+  DeadzoneConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _deadzone;
+  _deadzone = defaults;
+  _dirty &= ~DIRTY_DEADZONE;
+  portEXIT_CRITICAL(&_cacheMux);
+  prefs.remove(CONFIG_KEY_DEADZONE);
   prefs.remove("dz_t");
   prefs.remove("dz_r");
   prefs.remove("dz_p");
   prefs.remove("dz_y");
+  notify(sectionChange(before, defaults));
   Serial.println("{\"msg\":\"Deadzone config reset to defaults\"}");
 }
 
 // ===== Security Configuration (Phase 9) =====
 ConfigManager::SecurityConfig ConfigManager::getSecurityConfig() {
-  SecurityConfig config;
-  config.encryptionEnabled = prefs.getBool("sec_enc", false);
-  prefs.getBytes("sec_key", config.sharedSecret, 32);
-  config.hmacEnabled = prefs.getBool("sec_hmac", true);
-  config.rateLimitEnabled = prefs.getBool("sec_rl_en", true);
-  config.rateLimitCPS = prefs.getUShort("sec_rl_cps", 100);
+  // Radio / telemetry hot path: RAM copy only
+  portENTER_CRITICAL(&_cacheMux);
+  SecurityConfig config = _security;
+  portEXIT_CRITICAL(&_cacheMux);
   return config;
 }
 
+void ConfigManager::saveSecurityConfig(const SecurityConfig &config) {
+  ConfigBlob_save(prefs, CONFIG_KEY_SECURITY, CONFIG_SCHEMA_VERSION, &config,
+                  sizeof(config));
+}
+
 void ConfigManager::setSecurityConfig(const SecurityConfig &config) {
-  prefs.putBool("sec_enc", config.encryptionEnabled);
-  prefs.putBytes("sec_key", config.sharedSecret, 32);
-  prefs.putBool("sec_hmac", config.hmacEnabled);
-  prefs.putBool("sec_rl_en", config.rateLimitEnabled);
-  prefs.putUShort("sec_rl_cps", config.rateLimitCPS);
+  SecurityConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _security;
+  _security = config;
+  portEXIT_CRITICAL(&_cacheMux);
+  markDirty(DIRTY_SECURITY);
+  notify(sectionChange(before, config));
 
   JsonDocument doc;
   doc["msg"] = "Security config saved";
@@ -234,47 +491,77 @@ void ConfigManager::setSecurityConfig(const SecurityConfig &config) {
 }
 
 void ConfigManager::resetSecurityConfig() {
+  const SecurityConfig defaults;
+  SecurityConfig before;
+  portENTER_CRITICAL(&_cacheMux);
+  before = _security;
+  _security = defaults;
+  _dirty &= ~DIRTY_SECURITY;
+  portEXIT_CRITICAL(&_cacheMux);
+  prefs.remove(CONFIG_KEY_SECURITY);
   prefs.remove("sec_enc");
   prefs.remove("sec_key");
   prefs.remove("sec_hmac");
   prefs.remove("sec_rl_en");
   prefs.remove("sec_rl_cps");
+  notify(sectionChange(before, defaults));
   Serial.println("{\"msg\":\"Security config reset to defaults\"}");
 }
 
+static const char *const SECTION_NAMES[ConfigManager::SECTION_COUNT] = {
+    "pid", "motor", "joystick", "deadzone", "security"};
+
+const char *ConfigManager::sectionName(Section section) {
+  return section < SECTION_COUNT ? SECTION_NAMES[section] : "";
+}
+
+void ConfigManager::exportSection(Section section, JsonObject out) {
+  switch (section) {
+  case SECTION_PID: {
+    PIDConfig pid = getPIDConfig();
+    out["kp"] = pid.kp;
+    out["ki"] = pid.ki;
+    out["kd"] = pid.kd;
+    break;
+  }
+  case SECTION_MOTOR: {
+    MotorConfig motor = getMotorConfig();
+    out["minPWM"] = motor.minPWM;
+    out["maxRamp"] = motor.maxRamp;
+    out["deadband"] = motor.deadband;
+    break;
+  }
+  case SECTION_JOYSTICK: {
+    JoystickCalibration joystick = getJoystickCalibration();
+    out["minT"] = joystick.minThrottle;
+    out["ctrT"] = joystick.centerThrottle;
+    out["maxT"] = joystick.maxThrottle;
+    break;
+  }
+  case SECTION_DEADZONE: {
+    DeadzoneConfig deadzone = getDeadzoneConfig();
+    out["t"] = deadzone.throttle;
+    out["r"] = deadzone.roll;
+    out["p"] = deadzone.pitch;
+    out["y"] = deadzone.yaw;
+    break;
+  }
+  case SECTION_SECURITY: {
+    SecurityConfig security = getSecurityConfig();
+    out["enc"] = security.encryptionEnabled;
+    out["hmac"] = security.hmacEnabled;
+    out["rl"] = security.rateLimitEnabled;
+    out["cps"] = security.rateLimitCPS;
+    break;
+  }
+  default:
+    break;
+  }
+}
+
 void ConfigManager::exportToJSON(JsonDocument &doc) {
-  PIDConfig pid = getPIDConfig();
-  MotorConfig motor = getMotorConfig();
-  JoystickCalibration joystick = getJoystickCalibration();
-  DeadzoneConfig deadzone = getDeadzoneConfig();
-  SecurityConfig security = getSecurityConfig();
-
-  JsonObject pidObj = doc["pid"].to<JsonObject>();
-  pidObj["kp"] = pid.kp;
-  pidObj["ki"] = pid.ki;
-  pidObj["kd"] = pid.kd;
-
-  JsonObject motorObj = doc["motor"].to<JsonObject>();
-  motorObj["minPWM"] = motor.minPWM;
-  motorObj["maxRamp"] = motor.maxRamp;
-  motorObj["deadband"] = motor.deadband;
-
-  JsonObject joyObj = doc["joystick"].to<JsonObject>();
-  joyObj["minT"] = joystick.minThrottle;
-  joyObj["ctrT"] = joystick.centerThrottle;
-  joyObj["maxT"] = joystick.maxThrottle;
-
-  JsonObject dzObj = doc["deadzone"].to<JsonObject>();
-  dzObj["t"] = deadzone.throttle;
-  dzObj["r"] = deadzone.roll;
-  dzObj["p"] = deadzone.pitch;
-  dzObj["y"] = deadzone.yaw;
-
-  JsonObject secObj = doc["security"].to<JsonObject>();
-  secObj["enc"] = security.encryptionEnabled;
-  secObj["hmac"] = security.hmacEnabled;
-  secObj["rl"] = security.rateLimitEnabled;
-  secObj["cps"] = security.rateLimitCPS;
+  for (uint8_t i = 0; i < SECTION_COUNT; i++)
+    exportSection((Section)i, doc[SECTION_NAMES[i]].to<JsonObject>());
 }
 
 bool ConfigManager::importFromJSON(const JsonDocument &doc) {
@@ -304,7 +591,7 @@ bool ConfigManager::importFromJSON(const JsonDocument &doc) {
   }
 
   if (!doc["security"].isNull()) {
-    SecurityConfig sec;
+    SecurityConfig sec = getSecurityConfig(); // Export carries no secret: keep it
     sec.encryptionEnabled = doc["security"]["enc"] | false;
     sec.hmacEnabled = doc["security"]["hmac"] | true;
     sec.rateLimitEnabled = doc["security"]["rl"] | true;
@@ -329,6 +616,199 @@ void ConfigManager::resetAll() {
   Serial.println();
 }
 
+// ===== Backup / Restore =====
+static const char *const SECTION_KEYS[ConfigManager::SECTION_COUNT] = {
+    CONFIG_KEY_PID, CONFIG_KEY_MOTOR, CONFIG_KEY_JOYSTICK, CONFIG_KEY_DEADZONE,
+    CONFIG_KEY_SECURITY};
+
+// One key of a restore: blob to write, or NULL to erase
+struct RestoreOp {
+  const char *key;
+  const uint8_t *blob;
+  size_t len;
+};
+
+static bool writeRestore(Preferences &prefs, const char *ns, const RestoreOp *ops,
+                         uint8_t count) {
+#if defined(__XTENSA__)
+  // Straight to NVS: one handle, one commit for the whole image
+  (void)prefs;
+  nvs_handle_t nvs;
+  if (nvs_open(ns, NVS_READWRITE, &nvs) != ESP_OK)
+    return false;
+  bool ok = true;
+  for (uint8_t i = 0; i < count && ok; i++) {
+    esp_err_t err = ops[i].blob ? nvs_set_blob(nvs, ops[i].key, ops[i].blob, ops[i].len)
+                                : nvs_erase_key(nvs, ops[i].key);
+    ok = err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND;
+  }
+  ok = ok && nvs_commit(nvs) == ESP_OK;
+  nvs_close(nvs);
+  return ok;
+#else
+  (void)ns;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!ops[i].blob)
+      prefs.remove(ops[i].key);
+    else if (prefs.putBytes(ops[i].key, ops[i].blob, ops[i].len) != ops[i].len)
+      return false;
+  }
+  return true;
+#endif
+}
+
+static bool secretIsZero(const uint8_t *secret, size_t len) {
+  uint8_t any = 0;
+  for (size_t i = 0; i < len; i++)
+    any |= secret[i];
+  return any == 0;
+}
+
+bool ConfigManager::addBackupKey(const char *key) {
+  if (_backupKeyCount >= CONFIG_MAX_BACKUP_KEYS || !key || strlen(key) > CONFIG_IMAGE_KEY_MAX)
+    return false;
+  _backupKeys[_backupKeyCount++] = key;
+  return true;
+}
+
+bool ConfigManager::isBackupKey(const char *key) const {
+  for (uint8_t i = 0; i < SECTION_COUNT; i++)
+    if (strcmp(key, SECTION_KEYS[i]) == 0)
+      return true;
+  for (uint8_t i = 0; i < _backupKeyCount; i++)
+    if (strcmp(key, _backupKeys[i]) == 0)
+      return true;
+  return false;
+}
+
+size_t ConfigManager::backup(uint8_t *image, size_t size) {
+  portENTER_CRITICAL(&_cacheMux);
+  PIDConfig pid = _pid;
+  MotorConfig motor = _motor;
+  JoystickCalibration calib = _joystick;
+  DeadzoneConfig deadzone = _deadzone;
+  SecurityConfig sec = _security;
+  portEXIT_CRITICAL(&_cacheMux);
+  memset(sec.sharedSecret, 0, sizeof(sec.sharedSecret)); // Never leaves the vehicle
+
+  const void *sections[SECTION_COUNT] = {&pid, &motor, &calib, &deadzone, &sec};
+  const size_t sizes[SECTION_COUNT] = {sizeof(pid), sizeof(motor), sizeof(calib),
+                                       sizeof(deadzone), sizeof(sec)};
+
+  // Each blob is built (or read) in the free tail of the image, then
+  // moved down into its entry
+  ConfigImageWriter w;
+  ConfigImage_begin(&w, image, size);
+  for (uint8_t i = 0; i < SECTION_COUNT; i++) {
+    size_t tail = w.len + CONFIG_IMAGE_ENTRY_MAX_OVERHEAD;
+    size_t n = tail < size ? ConfigBlob_encode(CONFIG_SCHEMA_VERSION, sections[i], sizes[i],
+                                               image + tail, size - tail)
+                           : 0;
+    if (n == 0 || !ConfigImage_add(&w, SECTION_KEYS[i], image + tail, n))
+      return 0;
+  }
+  for (uint8_t i = 0; i < _backupKeyCount; i++) {
+    size_t tail = w.len + CONFIG_IMAGE_ENTRY_MAX_OVERHEAD;
+    size_t stored = prefs.getBytesLength(_backupKeys[i]);
+    if (stored == 0)
+      continue; // Not set on this vehicle
+    if (tail + stored > size)
+      return 0;
+    if (prefs.getBytes(_backupKeys[i], image + tail, stored) != stored)
+      continue;
+    // A corrupt blob is not loaded here either: leave it out
+    ConfigImage_add(&w, _backupKeys[i], image + tail, stored);
+  }
+  return ConfigImage_finish(&w);
+}
+
+ConfigImageStatus ConfigManager::restore(const uint8_t *image, size_t len) {
+  ConfigImageStatus status = ConfigImage_validate(image, len);
+  if (status != CONFIG_IMAGE_OK)
+    return status;
+
+  ConfigImageReader reader;
+  ConfigImageEntry entry;
+  ConfigImage_open(&reader, image, len);
+  while (ConfigImage_next(&reader, &entry))
+    if (!isBackupKey(entry.key))
+      return CONFIG_IMAGE_UNKNOWN_KEY;
+
+  // Every known key: the image's blob, or erased
+  RestoreOp ops[SECTION_COUNT + CONFIG_MAX_BACKUP_KEYS];
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < SECTION_COUNT + _backupKeyCount; i++) {
+    const char *key = i < SECTION_COUNT ? SECTION_KEYS[i] : _backupKeys[i - SECTION_COUNT];
+    RestoreOp op = {key, NULL, 0};
+    ConfigImage_open(&reader, image, len);
+    while (ConfigImage_next(&reader, &entry)) {
+      if (strcmp(entry.key, key) == 0) {
+        op.blob = entry.blob;
+        op.len = entry.blobLen;
+        break;
+      }
+    }
+    ops[count++] = op;
+  }
+
+  // Backups carry no secret: keep this vehicle's
+  uint8_t secBlob[sizeof(ConfigBlobHeader) + sizeof(SecurityConfig)];
+  RestoreOp &secOp = ops[SECTION_SECURITY];
+  ConfigBlobHeader hdr;
+  const uint8_t *payload = secOp.blob ? ConfigBlob_verify(secOp.blob, secOp.len, &hdr) : NULL;
+  if (payload && hdr.version == CONFIG_SCHEMA_VERSION && hdr.length == sizeof(SecurityConfig)) {
+    SecurityConfig sec;
+    memcpy(&sec, payload, sizeof(sec));
+    if (secretIsZero(sec.sharedSecret, sizeof(sec.sharedSecret))) {
+      SecurityConfig local = getSecurityConfig();
+      memcpy(sec.sharedSecret, local.sharedSecret, sizeof(sec.sharedSecret));
+      secOp.len = ConfigBlob_encode(CONFIG_SCHEMA_VERSION, &sec, sizeof(sec), secBlob,
+                                    sizeof(secBlob));
+      secOp.blob = secBlob;
+    }
+  }
+
+  // Cached edits must not be flushed over the image
+  portENTER_CRITICAL(&_cacheMux);
+  _dirty = 0;
+  portEXIT_CRITICAL(&_cacheMux);
+  if (!writeRestore(prefs, NAMESPACE, ops, count))
+    return CONFIG_IMAGE_WRITE_FAILED;
+  loadAll();
+  return CONFIG_IMAGE_OK;
+}
+
+// ===== Hardware Profile =====
+static void hardwareKey(char *key, size_t len, const char *vehicle) {
+  snprintf(key, len, CONFIG_KEY_HARDWARE, vehicle);
+}
+
+bool ConfigManager::loadHardwareProfile(const char *vehicle, PinMapProfile &profile) {
+  char key[16];
+  hardwareKey(key, sizeof(key), vehicle);
+  PinMapProfile stored = {};
+  size_t len = loadBlob(key, &stored, sizeof(stored));
+  // A shorter profile from before PINMAP_MAX_OUTPUTS grew is the same
+  // layout with fewer slots
+  const size_t legacy = offsetof(PinMapProfile, outputs) + PINMAP_LEGACY_OUTPUTS * sizeof(PinMapOutput);
+  if (len != sizeof(stored) && !(len == legacy && stored.count <= PINMAP_LEGACY_OUTPUTS))
+    return false;
+  profile = stored;
+  return true;
+}
+
+bool ConfigManager::saveHardwareProfile(const char *vehicle, const PinMapProfile &profile) {
+  char key[16];
+  hardwareKey(key, sizeof(key), vehicle);
+  return saveBlob(key, &profile, sizeof(profile));
+}
+
+void ConfigManager::resetHardwareProfile(const char *vehicle) {
+  char key[16];
+  hardwareKey(key, sizeof(key), vehicle);
+  removeKey(key);
+}
+
 // ===== Generic Static Accessors =====
 int ConfigManager::getInt(const char *key, int defaultValue) {
   Preferences p;
@@ -359,3 +839,28 @@ void ConfigManager::setFloat(const char *key, float value) {
   p.putFloat(key, value);
   p.end();
 }
+
+bool ConfigManager::saveBlob(const char *key, const void *data, size_t len) {
+  Preferences p;
+  p.begin(NAMESPACE, false);
+  bool ok = ConfigBlob_save(p, key, CONFIG_SCHEMA_VERSION, data, len);
+  p.end();
+  return ok;
+}
+
+size_t ConfigManager::loadBlob(const char *key, void *data, size_t maxLen) {
+  Preferences p;
+  p.begin(NAMESPACE, true);
+  size_t loaded = 0;
+  ConfigBlobStatus status = ConfigBlob_load(p, key, CONFIG_SCHEMA_VERSION,
+                                            data, maxLen, &loaded, nullptr);
+  p.end();
+  return status == CONFIG_BLOB_OK ? loaded : 0;
+}
+
+void ConfigManager::removeKey(const char *key) {
+  Preferences p;
+  p.begin(NAMESPACE, false);
+  p.remove(key);
+  p.end();
+}
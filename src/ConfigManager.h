@@ -4,6 +4,27 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include "PinMap.h"
+#include "ConfigImage.h"
+
+// Quiet time after the last change before dirty sections are written back
+#define CONFIG_FLUSH_DELAY_MS 500
+
+// Section blobs (see ConfigBlob.h); bump the version when a struct changes
+#define CONFIG_SCHEMA_VERSION 1
+#define CONFIG_KEY_PID "cfg_pid"
+#define CONFIG_KEY_MOTOR "cfg_mot"
+#define CONFIG_KEY_JOYSTICK "cfg_joy"
+#define CONFIG_KEY_DEADZONE "cfg_dz"
+#define CONFIG_KEY_SECURITY "cfg_sec"
+#define CONFIG_KEY_HARDWARE "hw_%s" // + vehicle name, e.g. "hw_COPTER"
+
+// Change observers over all sections (registered at boot)
+#define CONFIG_MAX_OBSERVERS 8
+
+// Blob keys cloned by backup() / restore() besides the sections
+#define CONFIG_MAX_BACKUP_KEYS 32
 
 /**
  * ConfigManager - ESP32 NVS (Non-Volatile Storage) configuration management
@@ -14,8 +35,22 @@
  * - Vehicle pairing (MAC address of paired Land Station)
  * - Joystick calibration (min/center/max per axis)
  * - Deadzone settings (prevent stick drift)
+ * - Hardware profile per vehicle (output pins, PWM frequency / resolution)
  *
  * Uses Preferences API (NVS) - survives power cycles and resets
+ *
+ * All sections are loaded into RAM once in begin(); getters never touch
+ * flash. Setters update the cache and mark the section dirty, update()
+ * writes dirty sections back once changes have settled for
+ * CONFIG_FLUSH_DELAY_MS, so a burst of edits costs one NVS write per section.
+ *
+ * Each section is stored as one versioned, CRC-checked blob; the older
+ * per-field keys are still read when a blob is missing or corrupt.
+ *
+ * Components that hold derived state (keys, token rates, lookup tables)
+ * subscribe to their section with addObserver() and get the old and new
+ * value of every change, so they apply the delta instead of re-reading
+ * the section on each use or being re-initialised wholesale.
  */
 class ConfigManager {
 public:
@@ -29,7 +64,7 @@ public:
   // Motor configuration
   struct MotorConfig {
     uint8_t minPWM = 40;   // Minimum PWM to overcome friction
-    uint8_t maxRamp = 5;   // Max % change per 20ms
+    uint8_t maxRamp = 5;   // Max % change per 20ms (250 %/s), 0 = no limit
     uint8_t deadband = 10; // Dead zone in ±100 range
   };
 
@@ -69,27 +104,85 @@ public:
     uint16_t rateLimitCPS = 100;
   };
 
+  // Sections as exported (JSON keys of exportToJSON / importFromJSON)
+  enum Section : uint8_t {
+    SECTION_PID = 0,
+    SECTION_MOTOR,
+    SECTION_JOYSTICK,
+    SECTION_DEADZONE,
+    SECTION_SECURITY,
+    SECTION_COUNT
+  };
+
+  /**
+   * One section change: old and new value, through the member named after
+   * the section (pairing has no struct and is not published)
+   */
+  struct Change {
+    Section section;
+    union Value {
+      const PIDConfig *pid;
+      const MotorConfig *motor;
+      const JoystickCalibration *joystick;
+      const DeadzoneConfig *deadzone;
+      const SecurityConfig *security;
+    } before, after;
+  };
+
+  typedef void (*Observer)(const Change &change, void *ctx);
+
   ConfigManager();
 
+  /**
+   * Call observer after every change of section (set, reset, import).
+   * It runs on the task that made the change, outside the cache lock, and
+   * must not change config itself. Register at boot, before any change.
+   * @return false if CONFIG_MAX_OBSERVERS are registered already
+   */
+  bool addObserver(Section section, Observer observer, void *ctx);
+
   /**
    * Initialize NVS storage
    * @return true if initialization successful
    */
   bool begin();
 
+  /**
+   * Write back dirty sections once they have been idle long enough
+   * (call periodically from a background task, never the control task)
+   * @param nowMs Current time (millis)
+   */
+  void update(uint32_t nowMs);
+
+  /**
+   * Write all dirty sections to NVS immediately (e.g. before reboot)
+   */
+  void flush();
+
+  /**
+   * @return true if some cached change has not reached NVS yet
+   */
+  bool isDirty() const { return _dirty != 0; }
+
   // ===== PID Configuration =====
   PIDConfig getPIDConfig();
   void setPIDConfig(const PIDConfig &config);
   void resetPIDConfig();
+  // Bumped on every PID change, so the control task can pick up new gains
+  uint32_t getPIDRevision() const { return _pidRevision; }
 
   // ===== Motor Configuration =====
   MotorConfig getMotorConfig();
   void setMotorConfig(const MotorConfig &config);
   void resetMotorConfig();
+  // Bumped on every motor config change (same use as getPIDRevision)
+  uint32_t getMotorRevision() const { return _motorRevision; }
 
   // ===== Vehicle Pairing =====
-  String getPairedMACAddress();
-  void setPairedMACAddress(const String &macAddress);
+  static const size_t MAC_STRING_LEN = 18; // "AA:BB:CC:DD:EE:FF" + NUL
+  // Copies the paired MAC ("" when unpaired) into mac, no heap
+  void getPairedMACAddress(char *mac, size_t len);
+  void setPairedMACAddress(const char *macAddress);
   void clearPairing();
 
   // ===== Joystick Calibration =====
@@ -113,6 +206,16 @@ public:
    */
   void exportToJSON(JsonDocument &doc);
 
+  /**
+   * Export one section (no secrets), the value of its exportToJSON key
+   */
+  void exportSection(Section section, JsonObject out);
+
+  /**
+   * JSON key of a section ("pid", "motor", ...)
+   */
+  static const char *sectionName(Section section);
+
   /**
    * Import configuration from JSON
    */
@@ -123,15 +226,101 @@ public:
    */
   void resetAll();
 
+  // ===== Backup / Restore (fleet cloning, see ConfigImage.h) =====
+
+  /**
+   * Include another blob key (mission, fence, subsystem config) in
+   * backups. Per-unit data (sensor calibration, pairing) stays out.
+   * Register at boot; key must outlive the manager (a literal).
+   * @return false if CONFIG_MAX_BACKUP_KEYS are registered already
+   */
+  bool addBackupKey(const char *key);
+
+  /**
+   * Image of every section (from the cache) and every registered key
+   * that is stored. The shared secret is left out (zeroed).
+   * @return Image length, 0 if it does not fit in size
+   */
+  size_t backup(uint8_t *image, size_t size);
+
+  /**
+   * Replace the sections and registered keys with an image's: all of it
+   * or nothing. The image is validated completely first; then every key
+   * it holds is written and every registered key it lacks is erased,
+   * with one NVS commit. A zeroed shared secret keeps this vehicle's.
+   * The cache is reloaded, but components read their blobs at boot:
+   * restart to apply.
+   */
+  ConfigImageStatus restore(const uint8_t *image, size_t len);
+
+  // ===== Hardware Profile (read once by the vehicle at boot) =====
+  // load returns false (profile untouched) if none is stored for the vehicle
+  static bool loadHardwareProfile(const char *vehicle, PinMapProfile &profile);
+  static bool saveHardwareProfile(const char *vehicle, const PinMapProfile &profile);
+  static void resetHardwareProfile(const char *vehicle);
+
   // ===== Generic Static Accessors (Standard Requirement) =====
   static int getInt(const char *key, int defaultValue = 0);
   static void setInt(const char *key, int value);
   static float getFloat(const char *key, float defaultValue = 0.0f);
   static void setFloat(const char *key, float value);
 
+  // Versioned blob (CONFIG_SCHEMA_VERSION); loadBlob returns 0 if missing/bad
+  static bool saveBlob(const char *key, const void *data, size_t len);
+  static size_t loadBlob(const char *key, void *data, size_t maxLen);
+  static void removeKey(const char *key);
+
 private:
+  // Dirty section bits
+  enum : uint8_t {
+    DIRTY_PID = 1 << 0,
+    DIRTY_MOTOR = 1 << 1,
+    DIRTY_JOYSTICK = 1 << 2,
+    DIRTY_DEADZONE = 1 << 3,
+    DIRTY_SECURITY = 1 << 4,
+    DIRTY_PAIRING = 1 << 5,
+  };
+
+  void loadAll();
+  bool loadSection(const char *key, void *data, size_t len);
+  void markDirty(uint8_t section);
+  void notify(const Change &change);
+  bool isBackupKey(const char *key) const;
+
+  void savePIDConfig(const PIDConfig &config);
+  void saveMotorConfig(const MotorConfig &config);
+  void saveJoystickCalibration(const JoystickCalibration &calib);
+  void saveDeadzoneConfig(const DeadzoneConfig &config);
+  void saveSecurityConfig(const SecurityConfig &config);
+
   Preferences prefs;
   static const char *NAMESPACE;
+
+  // RAM cache, guarded by _cacheMux (readers on both cores)
+  PIDConfig _pid;
+  volatile uint32_t _pidRevision = 1;
+  MotorConfig _motor;
+  volatile uint32_t _motorRevision = 1;
+  JoystickCalibration _joystick;
+  DeadzoneConfig _deadzone;
+  SecurityConfig _security;
+  char _pairedMac[MAC_STRING_LEN] = {0};
+  bool _joystickCalibrated = false;
+
+  struct ObserverSlot {
+    Section section;
+    Observer observer;
+    void *ctx;
+  };
+  ObserverSlot _observers[CONFIG_MAX_OBSERVERS];
+  uint8_t _observerCount = 0;
+
+  const char *_backupKeys[CONFIG_MAX_BACKUP_KEYS];
+  uint8_t _backupKeyCount = 0;
+
+  portMUX_TYPE _cacheMux = portMUX_INITIALIZER_UNLOCKED;
+  volatile uint8_t _dirty = 0;
+  volatile uint32_t _lastChangeMs = 0;
 };
 
 #endif // CONFIG_MANAGER_H
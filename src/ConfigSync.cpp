@@ -0,0 +1,41 @@
+#include "ConfigSync.h"
+
+/**
+ * ConfigSync - Implementation
+ *
+ * @file ConfigSync.cpp
+ */
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME  16777619u
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint32_t fnv_update(uint32_t h, const uint8_t* p, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+uint32_t ConfigSync_hash(const void* data, size_t len) {
+    return fnv_update(FNV_OFFSET, (const uint8_t*)data, len);
+}
+
+uint32_t ConfigSync_manifest(uint8_t version, const uint32_t* hashes, uint8_t count) {
+    uint32_t h = fnv_update(FNV_OFFSET, &version, 1);
+    for (uint8_t i = 0; i < count; i++) {
+        // Little endian, independent of the host
+        uint8_t bytes[4] = {(uint8_t)hashes[i], (uint8_t)(hashes[i] >> 8),
+                            (uint8_t)(hashes[i] >> 16), (uint8_t)(hashes[i] >> 24)};
+        h = fnv_update(h, bytes, sizeof(bytes));
+    }
+    return h;
+}
@@ -0,0 +1,43 @@
+#ifndef CONFIG_SYNC_H
+#define CONFIG_SYNC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * ConfigSync - Section hashes for incremental parameter download
+ *
+ * The vehicle publishes one 32-bit FNV-1a hash per config section (of the
+ * section's serialized JSON, i.e. exactly what the configurator caches)
+ * plus a manifest hash over the schema version and every section hash.
+ * A configurator that reconnects sends what it holds; only sections
+ * whose hash differs are sent again, one JSON line each, so the whole
+ * config is never built as one document:
+ *
+ *   -> {"c":"cfg_hash"}
+ *   <- {"c":"cfg_hash","v":1,"h":M,"s":{"pid":H1,"motor":H2,...}}
+ *   -> {"c":"cfg_sync","h":M,"have":{"pid":H1,...}}
+ *   <- {"c":"cfg","s":"motor","h":H2,"d":{...}}      (per changed section)
+ *   <- {"c":"cfg_sync","h":M,"sent":1}
+ *
+ * A matching manifest answers with "sent":0 and no section lines.
+ *
+ * @file ConfigSync.h
+ */
+
+#define CONFIG_SYNC_SECTION_MAX 192     // Serialized section, bytes
+
+/**
+ * FNV-1a over a byte range
+ */
+uint32_t ConfigSync_hash(const void* data, size_t len);
+
+/**
+ * Manifest hash: schema version and section hashes, in section order
+ * @param version CONFIG_SCHEMA_VERSION
+ * @param hashes  One per section
+ * @param count   Number of sections
+ */
+uint32_t ConfigSync_manifest(uint8_t version, const uint32_t* hashes, uint8_t count);
+
+#endif // CONFIG_SYNC_H
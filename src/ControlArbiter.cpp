@@ -0,0 +1,177 @@
+#include "ControlArbiter.h"
+#include <string.h>
+
+/**
+ * ControlArbiter - Implementation
+ *
+ * Sequence numbers are compared with serial arithmetic, so a domain may
+ * wrap. A domain forgets its last sequence once every link of it has
+ * timed out: a sender that restarted counting from 0 is taken again on
+ * its first frame instead of being dropped as a duplicate.
+ *
+ * @file ControlArbiter.cpp
+ */
+
+static const char* const LINK_NAMES[CONTROL_LINK_COUNT] = {"radio", "ws", "serial", "rc"};
+static const char* const MODE_NAMES[CONTROL_ARBITER_MODE_COUNT] = {"newest", "priority"};
+
+// Sequence domain of each link: ESP-NOW and /ws carry the same controller
+static const uint8_t DOMAIN[CONTROL_LINK_COUNT] = {0, 0, 2, 3};
+
+// PRIORITY mode, highest first
+static const uint8_t PRIORITY_ORDER[CONTROL_LINK_COUNT] = {
+    CONTROL_LINK_RC, CONTROL_LINK_SERIAL, CONTROL_LINK_RADIO, CONTROL_LINK_WS};
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void ControlArbiter_defaultConfig(ControlArbiterConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->mode = CONTROL_ARBITER_NEWEST;
+    config->timeoutMs = CONTROL_ARBITER_TIMEOUT_MS;
+}
+
+void ControlArbiter_sanitize(ControlArbiterConfig* config) {
+    if (config->mode >= CONTROL_ARBITER_MODE_COUNT)
+        config->mode = CONTROL_ARBITER_NEWEST;
+    if (config->timeoutMs < CONTROL_ARBITER_TIMEOUT_MIN_MS)
+        config->timeoutMs = CONTROL_ARBITER_TIMEOUT_MIN_MS;
+    if (config->timeoutMs > CONTROL_ARBITER_TIMEOUT_MAX_MS)
+        config->timeoutMs = CONTROL_ARBITER_TIMEOUT_MAX_MS;
+}
+
+// ============================================================================
+// Arbitration
+// ============================================================================
+
+void ControlArbiter_init(ControlArbiter* arb) {
+    memset(arb, 0, sizeof(*arb));
+    arb->lastLink = CONTROL_ARBITER_NONE;
+}
+
+bool ControlArbiter_offer(ControlArbiter* arb, ControlLink link, uint32_t sender,
+                          uint32_t sequence, int64_t arrivedUs) {
+    if ((unsigned)link >= CONTROL_LINK_COUNT)
+        return false;
+    ControlLinkHealth* h = &arb->links[link];
+    h->frames++;
+    if (arrivedUs > h->lastUs)
+        h->lastUs = arrivedUs;
+
+    uint8_t d = DOMAIN[link];
+    if (arb->domainValid[d] && arb->domainSender[d] == sender &&
+        (int32_t)(sequence - arb->domainSeq[d]) <= 0) {
+        h->duplicates++;
+        return false;
+    }
+    if (arrivedUs < arb->appliedUs) {
+        h->stale++;
+        return false;
+    }
+    arb->offered[link] = true;
+    arb->offerSender[link] = sender;
+    arb->offerSeq[link] = sequence;
+    arb->offerUs[link] = arrivedUs;
+    return true;
+}
+
+int ControlArbiter_select(ControlArbiter* arb, const ControlArbiterConfig* config) {
+    int best = CONTROL_ARBITER_NONE;
+    if (config->mode == CONTROL_ARBITER_PRIORITY) {
+        for (uint8_t i = 0; i < CONTROL_LINK_COUNT && best < 0; i++) {
+            if (arb->offered[PRIORITY_ORDER[i]])
+                best = PRIORITY_ORDER[i];
+        }
+    } else {
+        for (int i = 0; i < CONTROL_LINK_COUNT; i++) {
+            if (arb->offered[i] && (best < 0 || arb->offerUs[i] > arb->offerUs[best]))
+                best = i;
+        }
+    }
+
+    // One copy of a frame on both links of a domain: drop the other
+    if (best >= 0) {
+        for (int i = 0; i < CONTROL_LINK_COUNT; i++) {
+            if (i != best && arb->offered[i] && DOMAIN[i] == DOMAIN[best] &&
+                arb->offerSender[i] == arb->offerSender[best] &&
+                arb->offerSeq[i] == arb->offerSeq[best])
+                arb->links[i].duplicates++;
+        }
+        uint8_t d = DOMAIN[best];
+        arb->domainSeq[d] = arb->offerSeq[best];
+        arb->domainSender[d] = arb->offerSender[best];
+        arb->domainValid[d] = true;
+        arb->appliedUs = arb->offerUs[best];
+        arb->links[best].applied++;
+        if (arb->lastLink != best) {
+            if (arb->lastLink != CONTROL_ARBITER_NONE)
+                arb->switches++;
+            arb->lastLink = (int8_t)best;
+        }
+    }
+    memset(arb->offered, 0, sizeof(arb->offered));
+    return best;
+}
+
+uint8_t ControlArbiter_update(ControlArbiter* arb, const ControlArbiterConfig* config,
+                              int64_t nowUs) {
+    uint8_t changed = 0;
+    int64_t timeoutUs = (int64_t)config->timeoutMs * 1000;
+    for (int i = 0; i < CONTROL_LINK_COUNT; i++) {
+        ControlLinkHealth* h = &arb->links[i];
+        bool healthy = h->lastUs != 0 && nowUs - h->lastUs <= timeoutUs;
+        if (healthy == h->healthy)
+            continue;
+        if (!healthy)
+            h->outages++;
+        h->healthy = healthy;
+        changed |= (uint8_t)(1 << i);
+    }
+
+    bool live[CONTROL_LINK_COUNT] = {false};
+    for (int i = 0; i < CONTROL_LINK_COUNT; i++)
+        live[DOMAIN[i]] |= arb->links[i].healthy;
+    for (int d = 0; d < CONTROL_LINK_COUNT; d++) {
+        if (!live[d])
+            arb->domainValid[d] = false;
+    }
+    return changed;
+}
+
+uint8_t ControlArbiter_healthyMask(const ControlArbiter* arb) {
+    uint8_t mask = 0;
+    for (int i = 0; i < CONTROL_LINK_COUNT; i++) {
+        if (arb->links[i].healthy)
+            mask |= (uint8_t)(1 << i);
+    }
+    return mask;
+}
+
+// ============================================================================
+// Names
+// ============================================================================
+
+const char* ControlArbiter_linkName(ControlLink link) {
+    if ((unsigned)link >= CONTROL_LINK_COUNT)
+        return "?";
+    return LINK_NAMES[link];
+}
+
+const char* ControlArbiter_modeName(ControlArbiterMode mode) {
+    if ((unsigned)mode >= CONTROL_ARBITER_MODE_COUNT)
+        return "?";
+    return MODE_NAMES[mode];
+}
+
+bool ControlArbiter_parseMode(const char* name, ControlArbiterMode* mode) {
+    if (!name)
+        return false;
+    for (uint8_t i = 0; i < CONTROL_ARBITER_MODE_COUNT; i++) {
+        if (strcmp(name, MODE_NAMES[i]) == 0) {
+            *mode = (ControlArbiterMode)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,157 @@
+#ifndef CONTROL_ARBITER_H
+#define CONTROL_ARBITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * ControlArbiter - One control frame per tick from redundant links
+ *
+ * The vehicle takes sticks from every link it has: ESP-NOW, /ws, the host
+ * serial port and a wired RC receiver. Each control tick offers the
+ * newest frame of every link that delivered one, and the arbiter picks
+ * the one that drives the tick:
+ *
+ *   NEWEST    the frame that arrived last, whichever link carried it
+ *   PRIORITY  a fixed order: RC, serial, ESP-NOW, /ws (the order before
+ *             the arbiter; a lower link only drives while the higher
+ *             ones deliver nothing)
+ *
+ * Links that can carry the same sender's frames share a sequence domain
+ * (ESP-NOW and /ws both carry the paired controller's NAPacket). A frame
+ * whose sequence number is not newer than the last one applied from the
+ * same sender in its domain is a duplicate and never applied, so the
+ * slower copy of a frame sent over two links cannot roll the sticks
+ * back. Another sender (a relay with its own counter) is not compared.
+ * No frame that arrived before the last one applied is taken either.
+ *
+ * Per link, a frame within timeoutMs is healthy. Health is reported and
+ * transitions are counted; FailsafeManager keeps timing the newest
+ * applied frame, so losing one of two healthy links changes nothing: the
+ * other one's next frame is applied the same tick it is read.
+ *
+ * Stored as a config blob (CONTROL_ARBITER_CONFIG_KEY).
+ *
+ * Pure: no globals, no RTOS. Owned by the control task.
+ *
+ * @file ControlArbiter.h
+ */
+
+#define CONTROL_ARBITER_CONFIG_KEY      "cfg_arbiter"
+#define CONTROL_ARBITER_NONE            -1
+#define CONTROL_ARBITER_TIMEOUT_MS      250     // Half the failsafe signal-loss time
+#define CONTROL_ARBITER_TIMEOUT_MIN_MS  20
+#define CONTROL_ARBITER_TIMEOUT_MAX_MS  2000
+
+typedef enum {
+    CONTROL_LINK_RADIO = 0,     // ESP-NOW
+    CONTROL_LINK_WS,            // WebSocket binary frames
+    CONTROL_LINK_SERIAL,        // Host "sm" / binary control
+    CONTROL_LINK_RC,            // SBUS / CRSF receiver
+    CONTROL_LINK_COUNT
+} ControlLink;
+
+typedef enum {
+    CONTROL_ARBITER_NEWEST = 0,
+    CONTROL_ARBITER_PRIORITY,
+    CONTROL_ARBITER_MODE_COUNT
+} ControlArbiterMode;
+
+/**
+ * Stored configuration
+ */
+typedef struct {
+    uint8_t mode;               // ControlArbiterMode
+    uint16_t timeoutMs;         // Link healthy while a frame is this recent
+} ControlArbiterConfig;
+
+/**
+ * Health and statistics of one link
+ */
+typedef struct {
+    int64_t lastUs;             // Arrival of the newest frame offered (0 = none)
+    uint32_t frames;            // Offered
+    uint32_t applied;           // Picked to drive a tick
+    uint32_t duplicates;        // Sequence not newer than its domain's last
+    uint32_t stale;             // Arrived before the last applied frame
+    uint32_t outages;           // Healthy -> unhealthy transitions
+    bool healthy;
+} ControlLinkHealth;
+
+typedef struct {
+    ControlLinkHealth links[CONTROL_LINK_COUNT];
+    uint32_t domainSeq[CONTROL_LINK_COUNT];     // Last applied, per domain
+    uint32_t domainSender[CONTROL_LINK_COUNT];  // ... and who sent it
+    bool domainValid[CONTROL_LINK_COUNT];
+    int64_t appliedUs;          // Arrival of the last applied frame
+    int8_t lastLink;            // Link of the last applied frame (NONE)
+    uint32_t switches;          // Applied link changed
+
+    // Offers of the current tick
+    bool offered[CONTROL_LINK_COUNT];
+    uint32_t offerSender[CONTROL_LINK_COUNT];
+    uint32_t offerSeq[CONTROL_LINK_COUNT];
+    int64_t offerUs[CONTROL_LINK_COUNT];
+} ControlArbiter;
+
+/**
+ * Newest wins, CONTROL_ARBITER_TIMEOUT_MS
+ */
+void ControlArbiter_defaultConfig(ControlArbiterConfig* config);
+
+/**
+ * Clamp a loaded / edited config into range
+ */
+void ControlArbiter_sanitize(ControlArbiterConfig* config);
+
+/**
+ * No links seen, nothing applied
+ */
+void ControlArbiter_init(ControlArbiter* arb);
+
+/**
+ * Offer a link's newest frame for this tick
+ * @param sender Sender id within the domain (0 for a single-sender link)
+ * @param sequence Frame sequence number of that sender
+ * @param arrivedUs Arrival time (monotonic, same clock for all links)
+ * @return false if it is a duplicate or stale (counted; never applied)
+ */
+bool ControlArbiter_offer(ControlArbiter* arb, ControlLink link, uint32_t sender,
+                          uint32_t sequence, int64_t arrivedUs);
+
+/**
+ * Pick this tick's frame among the offers, and clear them
+ * @return Link to apply, CONTROL_ARBITER_NONE if nothing was offered
+ */
+int ControlArbiter_select(ControlArbiter* arb, const ControlArbiterConfig* config);
+
+/**
+ * Update link health; a domain with no healthy link forgets its sequence
+ * @return Bit per link whose health changed
+ */
+uint8_t ControlArbiter_update(ControlArbiter* arb, const ControlArbiterConfig* config,
+                              int64_t nowUs);
+
+/**
+ * Bit per healthy link
+ */
+uint8_t ControlArbiter_healthyMask(const ControlArbiter* arb);
+
+/**
+ * Link name ("radio", "ws", "serial", "rc")
+ */
+const char* ControlArbiter_linkName(ControlLink link);
+
+/**
+ * Mode name ("newest", "priority")
+ */
+const char* ControlArbiter_modeName(ControlArbiterMode mode);
+
+/**
+ * Parse a mode name
+ * @return false if unknown
+ */
+bool ControlArbiter_parseMode(const char* name, ControlArbiterMode* mode);
+
+#endif // CONTROL_ARBITER_H
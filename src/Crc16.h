@@ -0,0 +1,58 @@
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Crc16 - Fast CRC-16/CCITT-FALSE, bit-identical to NA_CRC16
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, MSB first, no final XOR: the
+ * same checksum as NA_CRC16 from the shared protocol header, which shifts
+ * one bit at a time. The implementation is chosen at compile time with
+ * -DCRC16_IMPL=...:
+ *
+ *   CRC16_IMPL_SLICE4   (default) Slicing-by-4: four bytes per step from
+ *                       four 256-entry tables (2 KB) kept in DRAM, so a
+ *                       lookup never misses into flash
+ *   CRC16_IMPL_ROM      ESP32 ROM crc16_be (no tables in the image);
+ *                       falls back to SLICE4 off target
+ *   CRC16_IMPL_BITWISE  Reference loop, as NA_CRC16
+ *
+ * NAPacket / NATelemetry checksums are computed by the macros of the
+ * shared header and keep using NA_CRC16; this module covers the frames
+ * this firmware defines itself (blackbox sectors, delta telemetry, host
+ * protocol, mission upload, config blobs, latency echo).
+ *
+ * @file Crc16.h
+ */
+
+#define CRC16_IMPL_BITWISE  0
+#define CRC16_IMPL_SLICE4   1
+#define CRC16_IMPL_ROM      2
+
+#ifndef CRC16_IMPL
+#define CRC16_IMPL CRC16_IMPL_SLICE4
+#endif
+
+#define CRC16_INIT          0xFFFF
+
+/**
+ * Continue a CRC over more data
+ * @param crc CRC16_INIT to start, or the result of an earlier call
+ */
+uint16_t Crc16_update(uint16_t crc, const uint8_t* data, size_t len);
+
+/**
+ * CRC of a buffer, equal to NA_CRC16(data, len)
+ */
+static inline uint16_t Crc16_compute(const uint8_t* data, size_t len) {
+    return Crc16_update(CRC16_INIT, data, len);
+}
+
+/**
+ * Name of the compiled implementation ("slice4", "rom", "bitwise")
+ */
+const char* Crc16_implName(void);
+
+#endif // CRC16_H
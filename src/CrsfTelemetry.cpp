@@ -0,0 +1,125 @@
+#include "CrsfTelemetry.h"
+#include "RcInput.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * CrsfTelemetry - Implementation
+ *
+ * The payload is written straight after the three header bytes, then
+ * the length and CRC are filled in around it.
+ *
+ * @file CrsfTelemetry.cpp
+ */
+
+#define HEADER_SIZE             3       // Address, length, type
+#define FAILSAFE_SIGNAL_LOST    2       // FailsafeState: SIGNAL_LOSS and up
+#define DEG_TO_RAD_E4           (3.14159265f / 180.0f * 10000.0f)
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static void put_u16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)(v >> 8);
+    out[1] = (uint8_t)(v & 0xFF);
+}
+
+static void put_u32(uint8_t* out, uint32_t v) {
+    put_u16(out, (uint16_t)(v >> 16));
+    put_u16(out + 2, (uint16_t)(v & 0xFFFF));
+}
+
+static int32_t clamp(float v, int32_t lo, int32_t hi) {
+    if (v > (float)hi) return hi;
+    if (v < (float)lo) return lo;
+    return (int32_t)lroundf(v);
+}
+
+// Degrees to -180 .. 180
+static float wrap_deg(float deg) {
+    deg = fmodf(deg, 360.0f);
+    if (deg > 180.0f) deg -= 360.0f;
+    if (deg < -180.0f) deg += 360.0f;
+    return deg;
+}
+
+static uint16_t course_cdeg(float deg) {
+    float cdeg = fmodf(deg, 360.0f) * 100.0f;
+    if (cdeg < 0.0f) cdeg += 36000.0f;
+    return cdeg >= 35999.5f ? 0 : (uint16_t)lroundf(cdeg);
+}
+
+/**
+ * Payload of a stream at p
+ * @return Payload bytes, 0 if the stream has no frame
+ */
+static size_t write_payload(TelemetryStreamId id, const TelemetrySnapshot* s, uint8_t* type,
+                            uint8_t* p, size_t room) {
+    switch (id) {
+    case TELEMETRY_STREAM_ATTITUDE:
+        if (room < 6) return 0;
+        *type = CRSF_TELEMETRY_TYPE_ATTITUDE;
+        put_u16(p, (uint16_t)clamp(s->pitch * DEG_TO_RAD_E4, -32768, 32767));
+        put_u16(p + 2, (uint16_t)clamp(s->roll * DEG_TO_RAD_E4, -32768, 32767));
+        put_u16(p + 4, (uint16_t)clamp(wrap_deg(s->heading) * DEG_TO_RAD_E4, -32768, 32767));
+        return 6;
+    case TELEMETRY_STREAM_POSITION:
+        if (room < 15) return 0;
+        *type = CRSF_TELEMETRY_TYPE_GPS;
+        put_u32(p, (uint32_t)s->latE7);
+        put_u32(p + 4, (uint32_t)s->lngE7);
+        put_u16(p + 8, (uint16_t)clamp(s->groundSpeed * 36.0f, 0, 0xFFFF));
+        put_u16(p + 10, course_cdeg(s->heading));
+        put_u16(p + 12, 1000);     // 0 m: no altitude in the snapshot
+        p[14] = 0;
+        return 15;
+    case TELEMETRY_STREAM_BATTERY:
+        if (room < 8) return 0;
+        *type = CRSF_TELEMETRY_TYPE_BATTERY;
+        put_u16(p, (uint16_t)((s->batteryMv + 50) / 100));
+        memset(p + 2, 0, 6);
+        return 8;
+    case TELEMETRY_STREAM_DEPTH:
+        if (room < 4) return 0;
+        *type = CRSF_TELEMETRY_TYPE_BARO;
+        put_u16(p, (uint16_t)clamp(10000.0f - s->depth * 10.0f, 0, 0x7FFF));
+        put_u16(p + 2, 0);
+        return 4;
+    case TELEMETRY_STREAM_NAV:
+    case TELEMETRY_STREAM_EVENTS: {
+        const char* mode = CrsfTelemetry_flightMode(s);
+        size_t n = strlen(mode) + 1;
+        if (room < n) return 0;
+        *type = CRSF_TELEMETRY_TYPE_MODE;
+        memcpy(p, mode, n);
+        return n;
+    }
+    default:
+        return 0;
+    }
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+size_t CrsfTelemetry_encode(TelemetryStreamId id, const TelemetrySnapshot* snap,
+                            uint8_t* out, size_t outSize) {
+    if (outSize < HEADER_SIZE + 1) return 0;
+    uint8_t type = 0;
+    size_t n = write_payload(id, snap, &type, out + HEADER_SIZE, outSize - HEADER_SIZE - 1);
+    if (n == 0) return 0;
+    out[0] = RC_CRSF_ADDR_FC;
+    out[1] = (uint8_t)(n + 2);     // Type .. CRC
+    out[2] = type;
+    out[HEADER_SIZE + n] = RcInput_crc8(&out[2], n + 1);
+    return HEADER_SIZE + n + 1;
+}
+
+const char* CrsfTelemetry_flightMode(const TelemetrySnapshot* snap) {
+    if (snap->failsafe >= FAILSAFE_SIGNAL_LOST) return "!FS!";
+    if (snap->navFlags & TELEMETRY_NAV_RTL_ACTIVE) return "RTL";
+    if (snap->navFlags & TELEMETRY_NAV_MISSION_ACTIVE) return "AUTO";
+    return "MANU";
+}
@@ -0,0 +1,68 @@
+#ifndef CRSF_TELEMETRY_H
+#define CRSF_TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "TelemetrySnapshot.h"
+#include "TelemetryStreams.h"
+
+/**
+ * CrsfTelemetry - Telemetry frames for the CRSF downlink
+ *
+ * A CRSF receiver (ExpressLRS, Crossfire) answers every channels frame
+ * with a telemetry slot on the same wire: one frame written back into it
+ * reaches the pilot's radio. Each TelemetryStreams stream maps onto the
+ * standard frame the radio already displays, big endian:
+ *
+ *   ATTITUDE  0x1E  pitch, roll, yaw i16 rad*10000                    6
+ *   POSITION  0x02  lat, lon i32 deg*1e7, speed u16 km/h*10,
+ *                   course u16 cdeg, altitude u16 m+1000, sats u8    15
+ *   BATTERY   0x08  voltage u16 dV, current u16 dA, used u24 mAh, %   8
+ *   DEPTH     0x09  altitude u16 dm+10000 (minus the depth), vario    4
+ *   NAV       0x21  flight mode, NUL-terminated ("AUTO", "RTL", ...)
+ *   EVENTS    0x21  same: the events are mode / failsafe changes
+ *
+ * Fields the snapshot does not have (altitude, satellites, current,
+ * capacity) go out as 0. PERF has no CRSF frame and is not carried.
+ * Link statistics (0x14) are not sent either: the receiver produces them
+ * itself and forwards them to the radio, a frame from here would only
+ * shadow them.
+ *
+ * Frames are written into the caller's buffer; nothing is allocated.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file CrsfTelemetry.h
+ */
+
+#define CRSF_TELEMETRY_MAX_FRAME    24      // Address, length, type, 15 + CRC
+#define CRSF_TELEMETRY_TYPE_GPS     0x02
+#define CRSF_TELEMETRY_TYPE_BATTERY 0x08
+#define CRSF_TELEMETRY_TYPE_BARO    0x09
+#define CRSF_TELEMETRY_TYPE_ATTITUDE 0x1E
+#define CRSF_TELEMETRY_TYPE_MODE    0x21
+
+// Streams with a CRSF frame (mask for TelemetryStreams_next)
+#define CRSF_TELEMETRY_STREAMS  ((1 << TELEMETRY_STREAM_ATTITUDE) | \
+                                 (1 << TELEMETRY_STREAM_POSITION) | \
+                                 (1 << TELEMETRY_STREAM_NAV) | \
+                                 (1 << TELEMETRY_STREAM_BATTERY) | \
+                                 (1 << TELEMETRY_STREAM_DEPTH) | \
+                                 (1 << TELEMETRY_STREAM_EVENTS))
+
+/**
+ * Encode the frame of one stream
+ * @param id Stream picked by TelemetryStreams_next()
+ * @param snap Telemetry of this tick
+ * @param out Output buffer (CRSF_TELEMETRY_MAX_FRAME is always enough)
+ * @return Frame length, 0 if the stream has no frame or out is too small
+ */
+size_t CrsfTelemetry_encode(TelemetryStreamId id, const TelemetrySnapshot* snap,
+                            uint8_t* out, size_t outSize);
+
+/**
+ * Flight mode text: "!FS!" in failsafe, else "RTL", "AUTO" or "MANU"
+ */
+const char* CrsfTelemetry_flightMode(const TelemetrySnapshot* snap);
+
+#endif // CRSF_TELEMETRY_H
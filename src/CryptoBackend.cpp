@@ -0,0 +1,293 @@
+#include "CryptoBackend.h"
+#include <string.h>
+
+#include "mbedtls/sha256.h"
+#include "mbedtls/version.h"
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+#if __has_include("sha/sha_parallel_engine.h")
+#include "sha/sha_parallel_engine.h"
+#else
+#include "esp32/sha.h"
+#endif
+#endif
+
+/**
+ * CryptoBackend - Implementation
+ *
+ * ESP32_HW:
+ * - AES-CTR on the AES peripheral via esp_aes_crypt_ctr
+ * - HMAC via esp_sha() one-shot hashes of (pad || msg); the ESP32 SHA engine
+ *   cannot be loaded with a saved state, so both pads are re-hashed, but in
+ *   hardware. Long messages stream through mbedtls_sha256 (which the ESP32
+ *   port also routes to the engine when it is free).
+ *
+ * SOFTWARE:
+ * - Generic mbedtls AES / SHA-256, HMAC resumes from cloned pad states.
+ *
+ * @file CryptoBackend.cpp
+ */
+
+// Largest message hashed from a stack buffer in the HW backend
+#define CRYPTO_HW_INLINE_MAX 192
+
+// mbedtls 3.x dropped the _ret suffix
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+#define crypto_sha256_starts mbedtls_sha256_starts
+#define crypto_sha256_update mbedtls_sha256_update
+#define crypto_sha256_finish mbedtls_sha256_finish
+#else
+#define crypto_sha256_starts mbedtls_sha256_starts_ret
+#define crypto_sha256_update mbedtls_sha256_update_ret
+#define crypto_sha256_finish mbedtls_sha256_finish_ret
+#endif
+
+// Cycle counter: CCOUNT on Xtensa, nanoseconds on host builds
+#if defined(__XTENSA__)
+#include <xtensa/hal.h>
+#define CRYPTO_CYCLES() xthal_get_ccount()
+#else
+#include <time.h>
+static inline uint32_t crypto_host_cycles(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#define CRYPTO_CYCLES() crypto_host_cycles()
+#endif
+
+static CryptoBackendStats gCryptoStats = {
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+    .backend = "esp32-hw",
+#else
+    .backend = "software",
+#endif
+};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static void build_pads(const uint8_t *secret, size_t secretLen, uint8_t *ipad,
+                       uint8_t *opad) {
+  memset(ipad, 0x36, CRYPTO_SHA256_BLOCK);
+  memset(opad, 0x5C, CRYPTO_SHA256_BLOCK);
+  for (size_t i = 0; i < secretLen; i++) {
+    ipad[i] ^= secret[i];
+    opad[i] ^= secret[i];
+  }
+}
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+/**
+ * Streaming H(pad || data) using a fresh mbedtls context
+ */
+static int sha256_pad_concat(const uint8_t *pad, const uint8_t *a,
+                             size_t aLen, uint8_t *out) {
+  mbedtls_sha256_context ctx;
+  mbedtls_sha256_init(&ctx);
+  int ret = crypto_sha256_starts(&ctx, 0);
+  if (ret == 0)
+    ret = crypto_sha256_update(&ctx, pad, CRYPTO_SHA256_BLOCK);
+  if (ret == 0)
+    ret = crypto_sha256_update(&ctx, a, aLen);
+  if (ret == 0)
+    ret = crypto_sha256_finish(&ctx, out);
+  mbedtls_sha256_free(&ctx);
+  return ret;
+}
+#endif
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_SOFTWARE
+/**
+ * Absorb one pad block into a fresh state, cloned out of a temporary so a
+ * hardware-backed port never keeps its engine pinned to the template.
+ */
+static int absorb_pad(mbedtls_sha256_context *dst, const uint8_t *pad) {
+  mbedtls_sha256_context tmp;
+  mbedtls_sha256_init(&tmp);
+
+  int ret = crypto_sha256_starts(&tmp, 0);
+  if (ret == 0)
+    ret = crypto_sha256_update(&tmp, pad, CRYPTO_SHA256_BLOCK);
+  if (ret == 0) {
+    mbedtls_sha256_free(dst);
+    mbedtls_sha256_init(dst);
+    mbedtls_sha256_clone(dst, &tmp);
+  }
+
+  mbedtls_sha256_free(&tmp);
+  return ret;
+}
+#endif
+
+// ============================================================================
+// AES-CTR
+// ============================================================================
+
+int CryptoBackend_aesSetKey(CryptoAesContext *ctx, const uint8_t *key) {
+  if (!ctx || !key)
+    return -1;
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+  esp_aes_init(&ctx->aes);
+  return esp_aes_setkey(&ctx->aes, key, 256);
+#else
+  mbedtls_aes_init(&ctx->aes);
+  return mbedtls_aes_setkey_enc(&ctx->aes, key, 256);
+#endif
+}
+
+void CryptoBackend_aesFree(CryptoAesContext *ctx) {
+  if (!ctx)
+    return;
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+  esp_aes_free(&ctx->aes);
+#else
+  mbedtls_aes_free(&ctx->aes);
+#endif
+}
+
+int CryptoBackend_aesCtr(CryptoAesContext *ctx, const uint8_t *iv,
+                         const uint8_t *input, size_t len, uint8_t *output) {
+  if (!ctx || !iv || !input || !output)
+    return -1;
+
+  // Counter block and stream state are per call; ctx is only read
+  size_t nc_off = 0;
+  uint8_t stream_block[CRYPTO_AES_BLOCK_SIZE] = {0};
+  uint8_t counter[CRYPTO_AES_BLOCK_SIZE];
+  memcpy(counter, iv, CRYPTO_AES_BLOCK_SIZE);
+
+  uint32_t start = CRYPTO_CYCLES();
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+  int ret = esp_aes_crypt_ctr(&ctx->aes, len, &nc_off, counter, stream_block,
+                              input, output);
+#else
+  int ret = mbedtls_aes_crypt_ctr(&ctx->aes, len, &nc_off, counter,
+                                  stream_block, input, output);
+#endif
+  uint32_t cycles = CRYPTO_CYCLES() - start;
+
+  gCryptoStats.aesCalls++;
+  gCryptoStats.aesBytes += len;
+  gCryptoStats.aesCycles += cycles;
+  return ret;
+}
+
+// ============================================================================
+// HMAC-SHA256
+// ============================================================================
+
+int CryptoBackend_hmacSetKey(CryptoHmacKey *key, const uint8_t *secret,
+                             size_t secretLen) {
+  if (!key || !secret || secretLen == 0 || secretLen > CRYPTO_SHA256_BLOCK)
+    return -1;
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+  build_pads(secret, secretLen, key->ipad, key->opad);
+  return 0;
+#else
+  uint8_t ipad[CRYPTO_SHA256_BLOCK];
+  uint8_t opad[CRYPTO_SHA256_BLOCK];
+  build_pads(secret, secretLen, ipad, opad);
+
+  int ret = absorb_pad(&key->inner, ipad);
+  if (ret == 0)
+    ret = absorb_pad(&key->outer, opad);
+
+  memset(ipad, 0, sizeof(ipad));
+  memset(opad, 0, sizeof(opad));
+  return ret;
+#endif
+}
+
+void CryptoBackend_hmacFree(CryptoHmacKey *key) {
+  if (!key)
+    return;
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_SOFTWARE
+  mbedtls_sha256_free(&key->inner);
+  mbedtls_sha256_free(&key->outer);
+#endif
+  memset(key, 0, sizeof(*key));
+}
+
+int CryptoBackend_hmacSha256(const CryptoHmacKey *key, const uint8_t *data,
+                             size_t len, uint8_t *mac) {
+  if (!key || (!data && len) || !mac)
+    return -1;
+
+  uint8_t innerHash[CRYPTO_SHA256_SIZE];
+  int ret = 0;
+  uint32_t start = CRYPTO_CYCLES();
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+  // H((K ^ opad) || H((K ^ ipad) || data))
+  if (len <= CRYPTO_HW_INLINE_MAX) {
+    uint8_t buf[CRYPTO_SHA256_BLOCK + CRYPTO_HW_INLINE_MAX];
+    memcpy(buf, key->ipad, CRYPTO_SHA256_BLOCK);
+    memcpy(buf + CRYPTO_SHA256_BLOCK, data, len);
+    esp_sha(SHA2_256, buf, CRYPTO_SHA256_BLOCK + len, innerHash);
+
+    memcpy(buf, key->opad, CRYPTO_SHA256_BLOCK);
+    memcpy(buf + CRYPTO_SHA256_BLOCK, innerHash, CRYPTO_SHA256_SIZE);
+    esp_sha(SHA2_256, buf, CRYPTO_SHA256_BLOCK + CRYPTO_SHA256_SIZE, mac);
+    memset(buf, 0, sizeof(buf));
+  } else {
+    ret = sha256_pad_concat(key->ipad, data, len, innerHash);
+    if (ret == 0)
+      ret = sha256_pad_concat(key->opad, innerHash, CRYPTO_SHA256_SIZE, mac);
+  }
+#else
+  mbedtls_sha256_context ctx;
+  mbedtls_sha256_init(&ctx);
+
+  mbedtls_sha256_clone(&ctx, &key->inner);
+  ret = crypto_sha256_update(&ctx, data, len);
+  if (ret == 0)
+    ret = crypto_sha256_finish(&ctx, innerHash);
+
+  if (ret == 0) {
+    mbedtls_sha256_clone(&ctx, &key->outer);
+    ret = crypto_sha256_update(&ctx, innerHash, CRYPTO_SHA256_SIZE);
+  }
+  if (ret == 0)
+    ret = crypto_sha256_finish(&ctx, mac);
+
+  mbedtls_sha256_free(&ctx);
+#endif
+
+  uint32_t cycles = CRYPTO_CYCLES() - start;
+  memset(innerHash, 0, sizeof(innerHash));
+
+  gCryptoStats.shaCalls++;
+  gCryptoStats.shaBytes += len;
+  gCryptoStats.shaCycles += cycles;
+  return ret;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+const char *CryptoBackend_getName(void) { return gCryptoStats.backend; }
+
+CryptoBackendStats CryptoBackend_getStats(void) { return gCryptoStats; }
+
+float CryptoBackend_getAesCyclesPerByte(void) {
+  if (gCryptoStats.aesBytes == 0)
+    return 0.0f;
+  return (float)gCryptoStats.aesCycles / (float)gCryptoStats.aesBytes;
+}
+
+float CryptoBackend_getShaCyclesPerByte(void) {
+  if (gCryptoStats.shaBytes == 0)
+    return 0.0f;
+  return (float)gCryptoStats.shaCycles / (float)gCryptoStats.shaBytes;
+}
+
+void CryptoBackend_resetStats(void) {
+  const char *name = gCryptoStats.backend;
+  memset(&gCryptoStats, 0, sizeof(gCryptoStats));
+  gCryptoStats.backend = name;
+}
@@ -0,0 +1,162 @@
+#ifndef CRYPTO_BACKEND_H
+#define CRYPTO_BACKEND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * CryptoBackend - AES-CTR / HMAC-SHA256 primitives under the security managers
+ *
+ * Selected at compile time with -DCRYPTO_BACKEND=<id>:
+ * - CRYPTO_BACKEND_ESP32_HW: ESP32 AES and SHA peripherals (esp_aes_*,
+ *   esp_sha). Default when building for ESP_PLATFORM.
+ * - CRYPTO_BACKEND_SOFTWARE: generic mbedtls API, HMAC resumes from
+ *   precomputed ipad/opad states. Default for host/unit-test builds.
+ *
+ * Every call is timed in CPU cycles so the cost per byte of each backend
+ * (including waits for a peripheral held by TLS in OTAUpdater) can be read
+ * back at runtime.
+ *
+ * @file CryptoBackend.h
+ */
+
+#define CRYPTO_BACKEND_SOFTWARE 0
+#define CRYPTO_BACKEND_ESP32_HW 1
+
+#ifndef CRYPTO_BACKEND
+#if defined(ESP_PLATFORM)
+#define CRYPTO_BACKEND CRYPTO_BACKEND_ESP32_HW
+#else
+#define CRYPTO_BACKEND CRYPTO_BACKEND_SOFTWARE
+#endif
+#endif
+
+#define CRYPTO_AES_BLOCK_SIZE   16
+#define CRYPTO_SHA256_SIZE      32
+#define CRYPTO_SHA256_BLOCK     64
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_ESP32_HW
+#if __has_include("aes/esp_aes.h")
+#include "aes/esp_aes.h"
+#else
+#include "esp32/aes.h"
+#endif
+
+typedef struct {
+    esp_aes_context aes;
+} CryptoAesContext;
+
+typedef struct {
+    uint8_t ipad[CRYPTO_SHA256_BLOCK];  // key ^ 0x36
+    uint8_t opad[CRYPTO_SHA256_BLOCK];  // key ^ 0x5C
+} CryptoHmacKey;
+
+#elif CRYPTO_BACKEND == CRYPTO_BACKEND_SOFTWARE
+#include "mbedtls/aes.h"
+#include "mbedtls/sha256.h"
+
+typedef struct {
+    mbedtls_aes_context aes;
+} CryptoAesContext;
+
+typedef struct {
+    mbedtls_sha256_context inner;       // State after absorbing key ^ ipad
+    mbedtls_sha256_context outer;       // State after absorbing key ^ opad
+} CryptoHmacKey;
+
+#else
+#error "Unknown CRYPTO_BACKEND"
+#endif
+
+/**
+ * Per-backend cost counters
+ */
+typedef struct {
+    const char* backend;        // Backend name
+    uint32_t aesCalls;          // AES-CTR invocations
+    uint64_t aesBytes;          // Bytes processed by AES-CTR
+    uint64_t aesCycles;         // CPU cycles spent in AES-CTR
+    uint32_t shaCalls;          // HMAC-SHA256 invocations
+    uint64_t shaBytes;          // Message bytes authenticated
+    uint64_t shaCycles;         // CPU cycles spent in HMAC-SHA256
+} CryptoBackendStats;
+
+/**
+ * Expand an AES-256 key into a context
+ * @param ctx Context to initialize (free a previously keyed one first)
+ * @param key 32-byte key
+ * @return 0 on success, mbedtls error code otherwise
+ */
+int CryptoBackend_aesSetKey(CryptoAesContext* ctx, const uint8_t* key);
+
+/**
+ * Release an AES context
+ */
+void CryptoBackend_aesFree(CryptoAesContext* ctx);
+
+/**
+ * AES-CTR transform (encrypt and decrypt are identical)
+ * @param ctx Keyed context (only read, safe to share between tasks)
+ * @param iv Initial 16-byte counter block (not modified)
+ * @param input Input data
+ * @param len Data length
+ * @param output Output buffer (may equal input)
+ * @return 0 on success, mbedtls error code otherwise
+ */
+int CryptoBackend_aesCtr(CryptoAesContext* ctx, const uint8_t* iv,
+                         const uint8_t* input, size_t len, uint8_t* output);
+
+/**
+ * Prepare an HMAC-SHA256 key
+ * @param key Key state to fill
+ * @param secret Key material
+ * @param secretLen Key length (1-64 bytes)
+ * @return 0 on success, error code otherwise
+ */
+int CryptoBackend_hmacSetKey(CryptoHmacKey* key, const uint8_t* secret,
+                             size_t secretLen);
+
+/**
+ * Release and wipe an HMAC key
+ */
+void CryptoBackend_hmacFree(CryptoHmacKey* key);
+
+/**
+ * Compute HMAC-SHA256
+ * @param key Prepared key (only read, safe to share between tasks)
+ * @param data Message
+ * @param len Message length
+ * @param mac Output (32 bytes)
+ * @return 0 on success, mbedtls error code otherwise
+ */
+int CryptoBackend_hmacSha256(const CryptoHmacKey* key, const uint8_t* data,
+                             size_t len, uint8_t* mac);
+
+/**
+ * Get backend name ("esp32-hw" or "software")
+ */
+const char* CryptoBackend_getName(void);
+
+/**
+ * Get cost counters
+ * @return Snapshot of counters
+ */
+CryptoBackendStats CryptoBackend_getStats(void);
+
+/**
+ * AES-CTR cost in CPU cycles per byte (0 if nothing measured yet)
+ */
+float CryptoBackend_getAesCyclesPerByte(void);
+
+/**
+ * HMAC-SHA256 cost in CPU cycles per message byte (0 if nothing measured yet)
+ */
+float CryptoBackend_getShaCyclesPerByte(void);
+
+/**
+ * Reset cost counters
+ */
+void CryptoBackend_resetStats(void);
+
+#endif // CRYPTO_BACKEND_H
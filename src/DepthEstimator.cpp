@@ -0,0 +1,101 @@
+#include "DepthEstimator.h"
+#include <string.h>
+
+/**
+ * DepthEstimator - Implementation
+ *
+ * Process noise is white acceleration of spectral density q on depth and
+ * rate plus a random walk on the bias:
+ *
+ *   Q = [q dt^3/3  q dt^2/2  0        ]
+ *       [q dt^2/2  q dt      0        ]
+ *       [0         0         qb dt    ]
+ *
+ * so the steady-state gains depend on time, not on how the samples and
+ * control ticks happen to interleave. Without the IMU the bias does not
+ * enter the prediction (F[0][2] = F[1][2] = 0) and only moves through
+ * the covariance it built up while it did.
+ *
+ * @file DepthEstimator.cpp
+ */
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void DepthEstimator_init(DepthEstimator* est, float noiseM) {
+    memset(est, 0, sizeof(*est));
+    float sigma = noiseM > 1e-4f ? noiseM : 1e-4f;
+    est->noiseVar = sigma * sigma;
+}
+
+void DepthEstimator_reset(DepthEstimator* est) {
+    float noiseVar = est->noiseVar;
+    memset(est, 0, sizeof(*est));
+    est->noiseVar = noiseVar;
+}
+
+void DepthEstimator_predict(DepthEstimator* est, float accelDown, bool hasAccel, float dt) {
+    if (!est->primed || dt <= 0.0f) return;
+    if (dt > DEPTH_EST_MAX_DT) dt = DEPTH_EST_MAX_DT;
+
+    float accel = hasAccel ? accelDown + est->accelBias : 0.0f;
+    est->depth += (est->rate + 0.5f * accel * dt) * dt;
+    est->rate += accel * dt;
+
+    // P = F P F' + Q
+    float F[3][3] = {{1.0f, dt, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    if (hasAccel) {
+        F[0][2] = 0.5f * dt * dt;
+        F[1][2] = dt;
+    }
+    float FP[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            FP[i][j] = F[i][0] * est->P[0][j] + F[i][1] * est->P[1][j] + F[i][2] * est->P[2][j];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            est->P[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2];
+
+    float q = hasAccel ? DEPTH_EST_ACCEL_PSD : DEPTH_EST_MANEUVER_PSD;
+    est->P[0][0] += q * dt * dt * dt / 3.0f;
+    est->P[0][1] += q * dt * dt * 0.5f;
+    est->P[1][0] += q * dt * dt * 0.5f;
+    est->P[1][1] += q * dt;
+    est->P[2][2] += DEPTH_EST_BIAS_PSD * dt;
+}
+
+void DepthEstimator_correct(DepthEstimator* est, float depth) {
+    est->samples++;
+    if (!est->primed) {
+        // Start at rest on the first sample, rate and bias unknown
+        memset(est->P, 0, sizeof(est->P));
+        est->depth = depth;
+        est->rate = 0.0f;
+        est->accelBias = 0.0f;
+        est->P[0][0] = est->noiseVar;
+        est->P[1][1] = 1.0f;
+        est->P[2][2] = DEPTH_EST_BIAS_SIGMA * DEPTH_EST_BIAS_SIGMA;
+        est->lastInnovation = 0.0f;
+        est->primed = true;
+        return;
+    }
+
+    // H = [1 0 0]: K = P[:][0] / (P[0][0] + R), P -= K P[0][:]
+    float innovation = depth - est->depth;
+    float s = est->P[0][0] + est->noiseVar;
+    float k[3], row[3];
+    for (int i = 0; i < 3; i++) {
+        k[i] = est->P[i][0] / s;
+        row[i] = est->P[0][i];
+    }
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            est->P[i][j] -= k[i] * row[j];
+
+    est->depth += k[0] * innovation;
+    est->rate += k[1] * innovation;
+    est->accelBias = clampf(est->accelBias + k[2] * innovation, -DEPTH_EST_MAX_BIAS,
+                            DEPTH_EST_MAX_BIAS);
+    est->lastInnovation = innovation;
+}
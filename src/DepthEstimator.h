@@ -0,0 +1,81 @@
+#ifndef DEPTH_ESTIMATOR_H
+#define DEPTH_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * DepthEstimator - Depth and vertical speed for the depth hold D term
+ *
+ * Differencing successive MS5837 readings turns millimetres of pressure
+ * noise into centimetres per second of rate noise. This is a Kalman
+ * filter on depth, rate and accelerometer bias (down positive) instead:
+ *
+ *   predict: d += r dt + (a + b) dt^2 / 2,  r += (a + b) dt   (every control tick)
+ *   correct: d, r, b += K (z - d)                             (each new sample)
+ *
+ * predict() runs at the control rate and carries the state between
+ * pressure samples; correct() takes a sample whenever the sensor task
+ * has published one, whatever its rate. With the earth-frame vertical
+ * acceleration a from the IMU, predict() integrates it and the process
+ * noise drops to the accelerometer's (DEPTH_EST_ACCEL_PSD) while the
+ * samples learn its bias b; without it the rate is modelled as
+ * constant and diver-scale manoeuvres are the process noise
+ * (DEPTH_EST_MANEUVER_PSD).
+ *
+ * Pure: no globals, no RTOS. Metres, m/s, m/s^2; down positive.
+ *
+ * @file DepthEstimator.h
+ */
+
+// Noise model (Tunable; -D overrides, e.g. from a SITL sweep)
+#ifndef DEPTH_EST_NOISE_M
+#define DEPTH_EST_NOISE_M       0.01f   // Depth sample 1-sigma
+#endif
+#ifndef DEPTH_EST_MANEUVER_PSD
+#define DEPTH_EST_MANEUVER_PSD  0.1f    // m^2/s^3, unmodelled accel without the IMU
+#endif
+#ifndef DEPTH_EST_ACCEL_PSD
+#define DEPTH_EST_ACCEL_PSD     0.05f   // m^2/s^3, with the IMU's acceleration
+#endif
+#define DEPTH_EST_BIAS_PSD      1e-4f   // m^2/s^5, accelerometer bias drift
+#define DEPTH_EST_BIAS_SIGMA    0.5f    // m/s^2, bias uncertainty at start
+#define DEPTH_EST_MAX_BIAS      1.0f    // m/s^2
+#define DEPTH_EST_MAX_DT        0.5f    // s, longer gaps are clamped
+
+typedef struct {
+    float depth;            // m, down positive
+    float rate;             // m/s, down positive
+    float accelBias;        // m/s^2, added to the measured acceleration
+    float P[3][3];          // Depth / rate / bias covariance
+    float noiseVar;         // Sample variance, m^2
+    float lastInnovation;   // z - predicted depth at the last sample
+    uint32_t samples;       // Samples taken in
+    bool primed;            // State started from a sample
+} DepthEstimator;
+
+/**
+ * @param noiseM Depth sample 1-sigma, m (DEPTH_EST_NOISE_M)
+ */
+void DepthEstimator_init(DepthEstimator* est, float noiseM);
+
+/**
+ * Forget the state: the next sample restarts it at rest
+ */
+void DepthEstimator_reset(DepthEstimator* est);
+
+/**
+ * One control step
+ * @param accelDown Earth-frame vertical acceleration, gravity removed,
+ *                  down positive, m/s^2 (ignored if !hasAccel)
+ * @param hasAccel The IMU supplied accelDown for this tick
+ * @param dt Step, s
+ */
+void DepthEstimator_predict(DepthEstimator* est, float accelDown, bool hasAccel, float dt);
+
+/**
+ * A new depth sample
+ */
+void DepthEstimator_correct(DepthEstimator* est, float depth);
+
+#endif // DEPTH_ESTIMATOR_H
@@ -1,56 +1,117 @@
 #include "DepthManager.h"
-#include <MS5837.h>
-#include <Wire.h>
+#include "HAL.h"
 
-MS5837 sensor;
+// Integrator holds while the latest sample is older than this
+#define DEPTH_STALE_MS 500
 
 DepthManager& DepthManager::getInstance() {
     static DepthManager instance;
     return instance;
 }
 
-DepthManager::DepthManager() {}
+DepthManager::DepthManager() {
+    _gains.kp = DEPTH_KP;
+    _gains.ki = DEPTH_KI;
+    _gains.kd = DEPTH_KD;
+    _gains.kff = 0.0f;
+    _gains.dCutoffHz = DEPTH_D_CUTOFF_HZ;
+    _gains.iLimit = DEPTH_I_LIMIT;
+    _gains.outLimit = 1.0f;
+    PID_reset(&_pid);
+    DepthEstimator_init(&_est, DEPTH_EST_NOISE_M);
+}
 
 void DepthManager::begin() {
-    Wire.begin(21, 22); // Default I2C pins for ESP32
-    if (!sensor.init()) {
+    // Shared bus with SensorManager; the HAL bus task owns the port
+    HAL_I2CInit(21, 22, 400000);
+    _sensor.setModel(MS5837Async::MODEL_30BA);
+    _sensor.setFluidDensity(1029); // kg/m^3 (Saltwater)
+    _sensor.setOsr(MS5837Async::OSR_4096);
+    _sensorOk = _sensor.begin();
+    if (!_sensorOk) {
         Serial.println("[Sub] MS5837 Init Failed!");
     } else {
-        sensor.setModel(MS5837::MS5837_30BA);
-        sensor.setFluidDensity(1029); // kg/m^3 (Saltwater)
         Serial.println("[Sub] MS5837 Ready");
     }
 }
 
+bool DepthManager::setOversampling(uint16_t osr) {
+    for (int8_t i = MS5837Async::OSR_256; i <= MS5837Async::OSR_8192; i++) {
+        if (osr == (256u << i)) {
+            _pendingOsr = i;
+            return true;
+        }
+    }
+    return false;
+}
+
 void DepthManager::update() {
-    uint32_t now = millis();
-    if (now - _lastUpdate < 50) return; 
-    float dt = (now - _lastUpdate) / 1000.0f;
-    _lastUpdate = now;
+    if (!_sensorOk) return;     // updateControl() surfaces
 
-    sensor.read();
-    _actualDepth = sensor.depth();
+    if (_pendingOsr >= 0) {
+        _sensor.setOsr((MS5837Async::Osr)_pendingOsr);
+        _pendingOsr = -1;
+    }
 
-    if (!_isDiving) {
-        _verticalOutput = 1.0f; // Positive = Surface
-        return;
+    // Publish each fresh pressure sample
+    if (!_sensor.update(HAL_GetMicros())) return;
+
+    _actualDepth = _sensor.depth();
+    _lastSampleMs = HAL_GetMillis();
+    _samples++;
+}
+
+void DepthManager::replaySample(float depth) {
+    _sensorOk = true;           // The log had a sensor
+    _actualDepth = depth;
+    _lastSampleMs = HAL_GetMillis();
+    _samples++;
+}
+
+void DepthManager::setVerticalAccel(float accelUp) {
+    _accelDown = -accelUp;
+    _accelValid = true;
+}
+
+void DepthManager::setPID(float kp, float ki, float kd) {
+    _pendingGains = _gains;
+    _pendingGains.kp = kp;
+    _pendingGains.ki = ki;
+    _pendingGains.kd = kd;
+    _gainsPending = true;
+}
+
+void DepthManager::updateControl(float dt) {
+    if (_gainsPending) {
+        PID_setGains(&_gains, &_pid, &_pendingGains);
+        _gainsPending = false;
     }
 
-    // PID Calculation
-    float error = _targetDepth - _actualDepth;
-    _integral += error * dt;
-    float derivative = (error - _lastError) / dt;
-    _lastError = error;
+    // Track depth whether diving or not, so a dive starts on a settled rate
+    bool hasAccel = _accelValid;
+    _accelValid = false;
+    DepthEstimator_predict(&_est, _accelDown, hasAccel, dt);
+    uint32_t samples = _samples;
+    if (samples != _estSamples) {
+        _estSamples = samples;
+        DepthEstimator_correct(&_est, _actualDepth);
+    }
 
-    _verticalOutput = (_kp * error) + (_ki * _integral) + (_kd * derivative);
+    if (!_sensorOk || !_isDiving || _samples == 0) {
+        _verticalOutput = 1.0f; // Positive = Surface (also with no depth reading)
+        PID_reset(&_pid);       // Next dive starts clean
+        return;
+    }
 
-    // Clamp output to valid range
-    if (_verticalOutput > 1.0f) _verticalOutput = 1.0f;
-    if (_verticalOutput < -1.0f) _verticalOutput = -1.0f;
+    bool fresh = HAL_GetMillis() - _lastSampleMs < DEPTH_STALE_MS;
+    // Depth grows downward, the thrust axis points up: too shallow (error
+    // > 0) must push down
+    _verticalOutput = -PID_updateRate(&_gains, &_pid, _targetDepth, _est.depth, _est.rate,
+                                      dt, fresh);
 }
 
 bool DepthManager::checkFailsafe() {
-    // Logic to detect water ingress or signal loss
-    // If true, vehicle will override all commands to max "UP"
+    // Depth sensor faults would go here; water ingress is the Sub's
+    // interrupt-driven LeakDetector, which does not wait for this poll
     return false; 
 }
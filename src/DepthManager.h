@@ -2,22 +2,81 @@
 #define DEPTH_MANAGER_H
 
 #include <Arduino.h>
+#include "drivers/MS5837Async.h"
+#include "PIDController.h"
+#include "DepthEstimator.h"
 
+// Depth PID (To be tuned in-water; -D overrides, e.g. from a SITL sweep)
+#ifndef DEPTH_KP
+#define DEPTH_KP 1.0f
+#endif
+#ifndef DEPTH_KI
+#define DEPTH_KI 0.1f
+#endif
+#ifndef DEPTH_KD
+#define DEPTH_KD 0.5f
+#endif
+#define DEPTH_D_CUTOFF_HZ 2.0f     // Pressure noise sits above a diver's motion
+#define DEPTH_I_LIMIT 0.5f         // Integral share of the output
+
+/**
+ * DepthManager - Depth hold for the Sub (MS5837 + PID)
+ *
+ * update() is polled from the sensor task and never blocks: the driver
+ * starts a conversion, returns, and collects it on a later poll.
+ * updateControl() runs the depth PID (PIDController: D on the measured
+ * depth rate, low-passed, clamped integral) from the control task with
+ * the scheduler's fixed period as dt, so a setpoint change gives no
+ * derivative kick and loop jitter does not reach the D term.
+ *
+ * The PID sees DepthEstimator's depth and rate, not the raw samples:
+ * predicted every control tick (with the IMU's vertical acceleration
+ * when setVerticalAccel() supplied one) and corrected by each new
+ * pressure sample, so the D term gets a clean rate instead of
+ * differenced sensor noise.
+ */
 class DepthManager {
 public:
     static DepthManager& getInstance();
     
     void begin();
-    void update();
+    void update();                      // Sensor task: sample pressure
+    void updateControl(float dt);       // Control task: depth PID, dt = loop period (s)
+    void replaySample(float depth);     // Host replay: a reading as update() publishes it
+
+    /**
+     * This control tick's earth-frame vertical acceleration (control
+     * task, before updateControl(); consumed by it)
+     * @param accelUp Gravity removed, up positive, m/s^2
+     */
+    void setVerticalAccel(float accelUp);
+
+    /**
+     * Select pressure oversampling (applied by the sensor task)
+     * @param osr 256, 512, 1024, 2048, 4096 or 8192
+     * @return false if osr is not a valid setting
+     */
+    bool setOversampling(uint16_t osr);
+    uint32_t getSampleCount() const { return _samples; }
+    uint32_t getErrorCount() const { return _sensor.getErrorCount(); }
     
     void setTargetDepth(float meters) { _targetDepth = meters; }
+    float getTargetDepth() const { return _targetDepth; }
     float getActualDepth() const { return _actualDepth; }
+    float getEstimatedDepth() const { return _est.depth; }
+    float getDepthRate() const { return _est.rate; }  // m/s, down positive
     
     float getVerticalOutput() const { return _verticalOutput; }
     
     bool isDiving() const { return _isDiving; }
     void setDiving(bool diving) { _isDiving = diving; }
 
+    /**
+     * Retune without a thrust step (applied at the next control step)
+     */
+    void setPID(float kp, float ki, float kd);
+    const PIDGains& getPID() const { return _gains; }
+
     // Failsafe: Returns true if we should resurface immediately
     bool checkFailsafe();
 
@@ -28,14 +87,21 @@ private:
     float _verticalOutput = 0.0f; // -1.0 to 1.0 (Down to Up)
     bool _isDiving = false;
     
-    uint32_t _lastUpdate = 0;
-    
-    // PID Parameters (To be tuned in-water)
-    float _kp = 1.0f;
-    float _ki = 0.1f;
-    float _kd = 0.5f;
-    float _integral = 0.0f;
-    float _lastError = 0.0f;
+    MS5837Async _sensor;
+    bool _sensorOk = false;
+    volatile int8_t _pendingOsr = -1;   // Set by comms task, applied in update()
+    volatile uint32_t _lastSampleMs = 0;
+    uint32_t _samples = 0;
+
+    PIDGains _gains;
+    PIDGains _pendingGains;             // From setPID(), comms task
+    volatile bool _gainsPending = false;
+    PIDState _pid;
+
+    DepthEstimator _est;
+    uint32_t _estSamples = 0;           // _samples taken into _est
+    float _accelDown = 0.0f;
+    bool _accelValid = false;
 };
 
 #endif
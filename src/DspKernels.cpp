@@ -0,0 +1,146 @@
+#include "DspKernels.h"
+#include "FastMath.h"
+
+/**
+ * DspKernels - Implementation
+ *
+ * esp-dsp's own dispatch picks the PIE (aes3) routine when the buffers
+ * and sizes allow it and its Xtensa (ae32) or ANSI loop otherwise, so the
+ * calls below need no size checks of their own. It rejects only bad
+ * lengths, which the scalar loops treat as empty.
+ *
+ * @file DspKernels.cpp
+ */
+
+#if DSP_IMPL == DSP_IMPL_ESPDSP
+#include <esp_dsp.h>
+#endif
+
+FAST_MATH_FLOAT_ONLY
+
+// ============================================================================
+// Kernels
+// ============================================================================
+
+#if DSP_IMPL == DSP_IMPL_ESPDSP
+
+void Dsp_matMul(const float* A, const float* B, float* C, int m, int n, int k) {
+    dspm_mult_f32(A, B, C, m, n, k);
+}
+
+float Dsp_dot(const float* a, const float* b, int len) {
+    float sum = 0.0f;
+    if (len > 0) dsps_dotprod_f32(a, b, &sum, len);
+    return sum;
+}
+
+void Dsp_biquad(const float* in, float* out, int len, const float coef[DSP_BIQUAD_COEFS],
+                float w[2]) {
+    // esp-dsp takes non-const coefficients but does not write them
+    if (len > 0) dsps_biquad_f32(in, out, len, (float*)coef, w);
+}
+
+bool Dsp_fftInit(int maxLen) {
+    if (maxLen < 2 || (maxLen & (maxLen - 1)))
+        return false;
+    // Allocates the table once; a second call reports already-initialized
+    esp_err_t err = dsps_fft2r_init_fc32(NULL, maxLen);
+    return err == ESP_OK || err == ESP_ERR_DSP_REINITIALIZED;
+}
+
+void Dsp_fft(float* data, int len) {
+    dsps_fft2r_fc32(data, len);
+    dsps_bit_rev_fc32(data, len);
+}
+
+const char* Dsp_implName(void) { return "esp-dsp"; }
+
+#else
+
+void Dsp_matMul(const float* A, const float* B, float* C, int m, int n, int k) {
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < k; j++) {
+            float sum = 0.0f;
+            for (int p = 0; p < n; p++) sum += A[i * n + p] * B[p * k + j];
+            C[i * k + j] = sum;
+        }
+    }
+}
+
+float Dsp_dot(const float* a, const float* b, int len) {
+    float sum = 0.0f;
+    for (int i = 0; i < len; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+void Dsp_biquad(const float* in, float* out, int len, const float coef[DSP_BIQUAD_COEFS],
+                float w[2]) {
+    for (int i = 0; i < len; i++) {
+        float d0 = in[i] - coef[3] * w[0] - coef[4] * w[1];
+        out[i] = coef[0] * d0 + coef[1] * w[0] + coef[2] * w[1];
+        w[1] = w[0];
+        w[0] = d0;
+    }
+}
+
+bool Dsp_fftInit(int maxLen) {
+    return maxLen >= 2 && !(maxLen & (maxLen - 1));
+}
+
+void Dsp_fft(float* data, int len) {
+    // Bit-reversal permutation, then decimation-in-time butterflies with
+    // the twiddle advanced by rotation (one sin / cos per stage)
+    for (int i = 1, j = 0; i < len; i++) {
+        int bit = len >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) {
+            float re = data[2 * i], im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+    for (int span = 2; span <= len; span <<= 1) {
+        float stepSin, stepCos;
+        FastMath_sinCos(-FAST_MATH_TWO_PI / (float)span, &stepSin, &stepCos);
+        int half = span >> 1;
+        float wr = 1.0f, wi = 0.0f;
+        for (int k = 0; k < half; k++) {
+            for (int i = k; i < len; i += span) {
+                float* a = data + 2 * i;
+                float* b = data + 2 * (i + half);
+                float tr = b[0] * wr - b[1] * wi;
+                float ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+            float nr = wr * stepCos - wi * stepSin;
+            wi = wr * stepSin + wi * stepCos;
+            wr = nr;
+        }
+    }
+}
+
+const char* Dsp_implName(void) { return "scalar"; }
+
+#endif
+
+// ============================================================================
+// Design
+// ============================================================================
+
+void Dsp_biquadLowpass(float coef[DSP_BIQUAD_COEFS], float freq, float q) {
+    float s, c;
+    FastMath_sinCos(FAST_MATH_TWO_PI * freq, &s, &c);
+    float alpha = s / (2.0f * q);
+    float a0 = 1.0f + alpha;
+    coef[0] = (1.0f - c) / 2.0f / a0;
+    coef[1] = (1.0f - c) / a0;
+    coef[2] = coef[0];
+    coef[3] = -2.0f * c / a0;
+    coef[4] = (1.0f - alpha) / a0;
+}
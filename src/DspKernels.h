@@ -0,0 +1,105 @@
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * DspKernels - Float vector / matrix kernels with a per-target back-end
+ *
+ * The few block operations the estimators and filters run go through
+ * here, so the same call is plain C on the classic ESP32 and the host,
+ * and esp-dsp on the ESP32-S3, whose PIE unit does four float
+ * multiply-adds per instruction on 16-byte aligned data. The back-end is
+ * chosen at compile time with -DDSP_IMPL=...:
+ *
+ *   DSP_IMPL_SCALAR   Reference loops (default on ESP32 and the host)
+ *   DSP_IMPL_ESPDSP   esp-dsp dspm_mult / dsps_dotprod / dsps_biquad /
+ *                     dsps_fft2r
+ *                     (default on the S3 when esp-dsp is in the SDK;
+ *                     falls back to SCALAR when its headers are missing)
+ *
+ * Both back-ends give the same results up to float rounding (summation
+ * order differs); tests/test_DspKernels.cpp checks the scalar one against
+ * hand-computed values, bench_main.cpp times whichever is compiled.
+ *
+ * Matrices are row-major float arrays. Buffers for the esp-dsp fast path
+ * should be DSP_ALIGN aligned with dimensions a multiple of 4; anything
+ * else still works, esp-dsp just takes its generic loop.
+ *
+ * Not worth a call: the motor mixer (constexpr coefficients, already
+ * straight-line code) and per-sample one-pole filters.
+ *
+ * @file DspKernels.h
+ */
+
+#define DSP_IMPL_SCALAR     0
+#define DSP_IMPL_ESPDSP     1
+
+#ifndef DSP_IMPL
+#if defined(ESP_PLATFORM)
+#include <sdkconfig.h>
+#endif
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && defined(__has_include)
+#if __has_include(<esp_dsp.h>)
+#define DSP_IMPL DSP_IMPL_ESPDSP
+#endif
+#endif
+#endif
+
+#ifndef DSP_IMPL
+#define DSP_IMPL DSP_IMPL_SCALAR
+#endif
+
+#define DSP_ALIGN           16
+#define DSP_BIQUAD_COEFS    5       // b0, b1, b2, a1, a2 (a0 = 1)
+
+/**
+ * C = A * B
+ * @param A m x n
+ * @param B n x k
+ * @param C m x k, must not alias A or B
+ */
+void Dsp_matMul(const float* A, const float* B, float* C, int m, int n, int k);
+
+/**
+ * Sum of a[i] * b[i]
+ */
+float Dsp_dot(const float* a, const float* b, int len);
+
+/**
+ * Direct form II biquad over a block (in and out may be the same buffer)
+ * @param coef b0, b1, b2, a1, a2
+ * @param w Two state words, zero to start, kept between blocks
+ */
+void Dsp_biquad(const float* in, float* out, int len, const float coef[DSP_BIQUAD_COEFS],
+                float w[2]);
+
+/**
+ * Butterworth-style low-pass coefficients (RBJ cookbook)
+ * @param freq Cutoff / sample rate (0 < freq < 0.5)
+ * @param q Quality, 0.7071 for Butterworth
+ */
+void Dsp_biquadLowpass(float coef[DSP_BIQUAD_COEFS], float freq, float q);
+
+/**
+ * Prepare the FFT twiddle table (once, before the first Dsp_fft)
+ * @param maxLen Largest transform length, power of two
+ * @return false if the length is invalid or the table could not be built
+ */
+bool Dsp_fftInit(int maxLen);
+
+/**
+ * In-place forward complex FFT, radix 2, output in natural order
+ * @param data len complex values interleaved re, im (2 * len floats)
+ * @param len Power of two, at most the Dsp_fftInit length
+ */
+void Dsp_fft(float* data, int len);
+
+/**
+ * Name of the compiled back-end ("scalar", "esp-dsp")
+ */
+const char* Dsp_implName(void);
+
+#endif // DSP_KERNELS_H
@@ -0,0 +1,127 @@
+#include "DynamicNotch.h"
+#include "FastMath.h"
+#include <string.h>
+
+/**
+ * DynamicNotch - Implementation
+ *
+ * @file DynamicNotch.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+#define LIMIT_FRACTION  0.45f       // Highest frequency, as a fraction of the sample rate
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void DynamicNotch_defaultConfig(DynNotchConfig* config) {
+    config->enabled = false;
+    config->minHz = 80.0f;
+    config->maxHz = 400.0f;
+    config->q = 4.0f;
+}
+
+void DynamicNotch_sanitize(DynNotchConfig* config, float sampleHz) {
+    float bin = sampleHz / DYN_NOTCH_FFT_SIZE;
+    float lowest = 2.0f * bin;                  // Clear of the DC leakage
+    float highest = LIMIT_FRACTION * sampleHz;
+    if (!(config->minHz >= lowest))
+        config->minHz = lowest;                 // Also NaN
+    else if (config->minHz > highest - bin)
+        config->minHz = highest - bin;
+    if (!(config->maxHz <= highest))
+        config->maxHz = highest;
+    else if (!(config->maxHz >= config->minHz + bin))
+        config->maxHz = config->minHz + bin;
+    if (!(config->q >= DYN_NOTCH_MIN_Q))
+        config->q = DYN_NOTCH_MIN_Q;
+    else if (config->q > DYN_NOTCH_MAX_Q)
+        config->q = DYN_NOTCH_MAX_Q;
+}
+
+// ============================================================================
+// Tracking
+// ============================================================================
+
+bool DynamicNotch_init(DynamicNotch* dn, const DynNotchConfig* config, float sampleHz) {
+    memset(dn, 0, sizeof(*dn));
+    dn->config = *config;
+    dn->sampleHz = sampleHz;
+    DynamicNotch_sanitize(&dn->config, sampleHz);
+    dn->centerHz = dn->config.maxHz;
+    for (int i = 0; i < DYN_NOTCH_FFT_SIZE; i++)
+        dn->window[i] = 0.5f - 0.5f * FastMath_cos(FAST_MATH_TWO_PI * (float)i /
+                                                    (float)DYN_NOTCH_FFT_SIZE);
+    return Dsp_fftInit(DYN_NOTCH_FFT_SIZE);
+}
+
+bool DynamicNotch_push(DynamicNotch* dn, const float rates[3]) {
+    dn->samples[0][dn->head] = rates[0];
+    dn->samples[1][dn->head] = rates[1];
+    dn->head = (uint16_t)((dn->head + 1) % DYN_NOTCH_FFT_SIZE);
+    if (dn->filled < DYN_NOTCH_FFT_SIZE)
+        dn->filled++;
+    dn->fresh++;
+    return dn->filled == DYN_NOTCH_FFT_SIZE && dn->fresh >= DYN_NOTCH_HOP;
+}
+
+bool DynamicNotch_analyze(DynamicNotch* dn) {
+    const int N = DYN_NOTCH_FFT_SIZE;
+    dn->fresh = 0;
+    if (dn->filled < N)
+        return false;
+    dn->analyses++;
+
+    // Oldest sample first: the ring starts at head
+    for (int i = 0; i < N; i++) {
+        int s = (dn->head + i) % N;
+        dn->fft[2 * i] = dn->samples[0][s] * dn->window[i];
+        dn->fft[2 * i + 1] = dn->samples[1][s] * dn->window[i];
+    }
+    Dsp_fft(dn->fft, N);
+
+    float bin = dn->sampleHz / N;
+    int lo = (int)(dn->config.minHz / bin);
+    int hi = (int)(dn->config.maxHz / bin) + 1;
+    if (lo < 1) lo = 1;
+    if (hi > N / 2 - 1) hi = N / 2 - 1;
+
+    // Summed roll + pitch power per bin; lo - 1 and hi + 1 for the fit
+    float power[DYN_NOTCH_FFT_SIZE / 2 + 1];
+    for (int k = lo - 1; k <= hi + 1; k++) {
+        const float* a = &dn->fft[2 * k];
+        const float* b = &dn->fft[2 * (k ? N - k : 0)];
+        power[k] = a[0] * a[0] + a[1] * a[1] + b[0] * b[0] + b[1] * b[1];
+    }
+    int peak = lo;
+    float sum = 0.0f;
+    for (int k = lo; k <= hi; k++) {
+        sum += power[k];
+        if (power[k] > power[peak]) peak = k;
+    }
+    float mean = sum / (float)(hi - lo + 1);
+    dn->peakSnr = mean > 0.0f ? power[peak] / mean : 0.0f;
+    // A band edge sitting on the skirt of something outside the band
+    // (stick motion below minHz) is a slope, not a peak
+    if (dn->peakSnr < DYN_NOTCH_MIN_SNR || power[peak - 1] > power[peak] ||
+        power[peak + 1] > power[peak])
+        return false;
+
+    // Vertex of the parabola through the peak and its neighbours
+    float left = power[peak - 1], right = power[peak + 1];
+    float curve = left - 2.0f * power[peak] + right;
+    float offset = curve < 0.0f ? 0.5f * (left - right) / curve : 0.0f;
+    float freq = ((float)peak + offset) * bin;
+    if (freq < dn->config.minHz) freq = dn->config.minHz;
+    if (freq > dn->config.maxHz) freq = dn->config.maxHz;
+
+    dn->centerHz += DYN_NOTCH_SMOOTHING * (freq - dn->centerHz);
+    dn->locks++;
+    return true;
+}
+
+void DynamicNotch_coefs(const DynamicNotch* dn, BiquadCoefs* c) {
+    Biquad_notch(c, dn->centerHz, dn->sampleHz, dn->config.q);
+}
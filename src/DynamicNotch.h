@@ -0,0 +1,107 @@
+#ifndef DYNAMIC_NOTCH_H
+#define DYNAMIC_NOTCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "BiquadFilter.h"
+#include "DspKernels.h"
+
+/**
+ * DynamicNotch - FFT peak tracker that steers a gyro notch (Copter)
+ *
+ * Motor and frame noise moves with throttle, so a notch at a fixed
+ * frequency misses it most of the flight. This collects raw roll / pitch
+ * rates in a sliding window, and every DYN_NOTCH_HOP samples transforms
+ * the Hann-windowed window and finds the strongest bin between minHz and
+ * maxHz. The peak is refined by parabolic interpolation, smoothed, and
+ * turned into notch coefficients for the gyro cascade.
+ *
+ * Both axes go through one complex FFT (roll as the real part, pitch as
+ * the imaginary part); the summed power of the two real spectra is
+ * (|Z[k]|^2 + |Z[N-k]|^2) / 2, so two axes cost one transform.
+ *
+ * A peak counts only when it stands DYN_NOTCH_MIN_SNR above the mean of
+ * the search band; otherwise the notch stays where it was (on the ground
+ * with motors off it never moves from its start at maxHz).
+ *
+ * Runs outside the control task: it only needs the samples, and hands
+ * back coefficients that the control task swaps into its cascade. Pure:
+ * no globals, no RTOS.
+ *
+ * @file DynamicNotch.h
+ */
+
+#define DYN_NOTCH_FFT_SIZE      128     // 7.8 Hz bins at 1 kHz
+#define DYN_NOTCH_HOP           (DYN_NOTCH_FFT_SIZE / 2)
+#define DYN_NOTCH_MIN_SNR       8.0f    // Peak power / band mean
+#define DYN_NOTCH_SMOOTHING     0.3f    // Share of each new peak in the center
+#define DYN_NOTCH_MIN_Q         1.0f
+#define DYN_NOTCH_MAX_Q         10.0f
+
+#define DYN_NOTCH_CONFIG_KEY    "cfg_dyn_notch"
+
+typedef struct {
+    bool enabled;
+    float minHz;                // Search band
+    float maxHz;
+    float q;                    // Notch center / bandwidth
+} DynNotchConfig;
+
+typedef struct {
+    DynNotchConfig config;
+    float sampleHz;
+    float window[DYN_NOTCH_FFT_SIZE];                   // Hann
+    float samples[2][DYN_NOTCH_FFT_SIZE];               // Roll, pitch ring
+    alignas(DSP_ALIGN) float fft[2 * DYN_NOTCH_FFT_SIZE];
+    uint16_t head;              // Next sample slot
+    uint16_t filled;            // Samples in the ring, up to the FFT size
+    uint16_t fresh;             // Samples since the last analysis
+    float centerHz;             // Notch center
+    float peakSnr;              // Of the last analysis
+    uint32_t analyses;
+    uint32_t locks;             // Analyses that moved the notch
+} DynamicNotch;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+/**
+ * Default: off, 80-400 Hz band, Q 4
+ */
+void DynamicNotch_defaultConfig(DynNotchConfig* config);
+
+/**
+ * Clamp the band into (2 bins, 0.45 * sampleHz) with min < max, and Q
+ */
+void DynamicNotch_sanitize(DynNotchConfig* config, float sampleHz);
+
+// ============================================================================
+// Tracking
+// ============================================================================
+
+/**
+ * Reset the tracker with a configuration (sanitized); the notch starts
+ * at maxHz
+ * @return false if the FFT could not be prepared
+ */
+bool DynamicNotch_init(DynamicNotch* dn, const DynNotchConfig* config, float sampleHz);
+
+/**
+ * Add one raw gyro sample (x, y, z; z is not used)
+ * @return true when an analysis is due
+ */
+bool DynamicNotch_push(DynamicNotch* dn, const float rates[3]);
+
+/**
+ * Transform the window and move the center toward the dominant peak
+ * @return true if a peak was found and the center moved
+ */
+bool DynamicNotch_analyze(DynamicNotch* dn);
+
+/**
+ * Notch coefficients at the current center
+ */
+void DynamicNotch_coefs(const DynamicNotch* dn, BiquadCoefs* c);
+
+#endif // DYNAMIC_NOTCH_H
@@ -2,10 +2,10 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "mbedtls/aes.h"
-#include "mbedtls/ctr_drbg.h"
-#include "mbedtls/entropy.h"
+#include "CryptoBackend.h"
+#include "SecureRandom.h"
 #include "mbedtls/error.h"
+#include "mbedtls/gcm.h"
 #include "mbedtls/md.h"
 #include "mbedtls/pkcs5.h"
 
@@ -13,22 +13,48 @@
  * EncryptionManager - AES-256 CTR mode encryption/decryption
  *
  * Phase 9 Full Implementation:
- * - AES-256 CTR mode using hardware-accelerated mbedtls
- * - CSPRNG IV generation using mbedtls entropy + ctr_drbg
+ * - AES-256 CTR mode via CryptoBackend (ESP32 AES peripheral or software)
+ * - AES-256-GCM AEAD for compact control frames (legacy CTR+HMAC kept)
+ * - Key schedule expanded once per key and reused for every packet
+ * - Separate receive / transmit keys (session keys), one shared key for
+ *   pre-shared and legacy ECDH sessions
+ * - CSPRNG IV generation from the shared DRBG (SecureRandom), or a
+ *   counter nonce (random session prefix drawn once per key) for the hot
+ *   path
  * - PBKDF2 key derivation from passwords
  *
  * @file EncryptionManager.cpp
  */
 
+// Expanded AES-256 key schedule for one direction, built once per key
+typedef struct {
+  CryptoAesContext aes_ctx;
+  mbedtls_gcm_context gcm_ctx;
+} EncryptionKeySlot;
+
 // Internal state
 static struct {
-  uint8_t key[AES_256_KEY_SIZE];
   bool initialized;
   char lastError[128];
 
-  mbedtls_entropy_context entropy;
-  mbedtls_ctr_drbg_context ctr_drbg;
-} gEncryptionState = {.initialized = false, .lastError = {0}};
+  EncryptionKeySlot rx;   // decrypt / verify (controller -> vehicle)
+  EncryptionKeySlot tx;   // encrypt / tag (vehicle -> controller)
+  bool contextsAllocated;
+
+  // Receive keys of radio peers with their own session (PeerSessionTable)
+  EncryptionKeySlot peers[EM_PEER_KEY_SETS];
+  bool peerReady[EM_PEER_KEY_SETS];
+
+  // Counter nonce state, prefix re-drawn on every init()
+  EncryptionIVMode ivMode;
+  uint8_t ivPrefix[AES_IV_PREFIX_SIZE];
+  uint64_t ivCounter;
+} gEncryptionState = {.initialized = false,
+                      .lastError = {0},
+                      .contextsAllocated = false,
+                      .peerReady = {false},
+                      .ivMode = EM_IV_MODE_RANDOM,
+                      .ivCounter = 0};
 
 // ============================================================================
 // Internal Helpers
@@ -41,37 +67,115 @@ static void set_last_error(const char *action, int ret) {
            "%s failed: -0x%04X (%s)", action, -ret, buf);
 }
 
+/**
+ * Draw a fresh session prefix and restart the nonce counter
+ */
+static int reseed_nonce(void) {
+  int ret = SecureRandom_fill(gEncryptionState.ivPrefix, AES_IV_PREFIX_SIZE);
+  gEncryptionState.ivCounter = 0;
+  return ret;
+}
+
 // ============================================================================
 // Public API Implementation
 // ============================================================================
 
+static int set_slot_key(EncryptionKeySlot *slot, const uint8_t *key) {
+  mbedtls_gcm_init(&slot->gcm_ctx);
+
+  // Key expansion runs here once instead of per packet
+  int ret = CryptoBackend_aesSetKey(&slot->aes_ctx, key);
+  if (ret != 0) {
+    set_last_error("AES setkey", ret);
+    return ret;
+  }
+
+  ret = mbedtls_gcm_setkey(&slot->gcm_ctx, MBEDTLS_CIPHER_ID_AES, key,
+                           AES_256_KEY_SIZE * 8);
+  if (ret != 0)
+    set_last_error("GCM setkey", ret);
+  return ret;
+}
+
+static void free_slot(EncryptionKeySlot *slot) {
+  CryptoBackend_aesFree(&slot->aes_ctx);
+  mbedtls_gcm_free(&slot->gcm_ctx);
+}
+
 bool EncryptionManager_init(const uint8_t *key) {
   if (!key) {
     snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
              "NULL key provided");
     return false;
   }
+  return EncryptionManager_setKeys(key, key);
+}
+
+bool EncryptionManager_setKeys(const uint8_t *rxKey, const uint8_t *txKey) {
+  if (!rxKey || !txKey) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "NULL key provided");
+    return false;
+  }
+
+  // Entropy gathering happens once per boot; re-keys only draw
+  if (!SecureRandom_init()) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "RNG Seed failed");
+    return false;
+  }
 
-  // Initialize random number generator
-  mbedtls_entropy_init(&gEncryptionState.entropy);
-  mbedtls_ctr_drbg_init(&gEncryptionState.ctr_drbg);
+  // Re-keying (e.g. after ECDH or a ratchet step): release previous contexts
+  gEncryptionState.initialized = false;
+  if (gEncryptionState.contextsAllocated) {
+    free_slot(&gEncryptionState.rx);
+    free_slot(&gEncryptionState.tx);
+  }
+  gEncryptionState.contextsAllocated = true;
+
+  if (set_slot_key(&gEncryptionState.rx, rxKey) != 0)
+    return false;
+  if (set_slot_key(&gEncryptionState.tx, txKey) != 0)
+    return false;
 
-  const char *personalization = "NA_Framework_v1";
-  int ret = mbedtls_ctr_drbg_seed(
-      &gEncryptionState.ctr_drbg, mbedtls_entropy_func,
-      &gEncryptionState.entropy, (const uint8_t *)personalization,
-      strlen(personalization));
+  // New key (or new boot): new nonce space
+  int ret = reseed_nonce();
   if (ret != 0) {
-    set_last_error("RNG Seed", ret);
+    set_last_error("Nonce prefix", ret);
     return false;
   }
 
-  memcpy(gEncryptionState.key, key, AES_256_KEY_SIZE);
   gEncryptionState.initialized = true;
 
   return true;
 }
 
+bool EncryptionManager_setPeerKey(uint8_t set, const uint8_t *rxKey) {
+  if (set >= EM_PEER_KEY_SETS || !rxKey) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "Bad peer key set");
+    return false;
+  }
+  EncryptionManager_clearPeerKey(set);
+  if (set_slot_key(&gEncryptionState.peers[set], rxKey) != 0) {
+    free_slot(&gEncryptionState.peers[set]);
+    return false;
+  }
+  gEncryptionState.peerReady[set] = true;
+  return true;
+}
+
+void EncryptionManager_clearPeerKey(uint8_t set) {
+  if (set >= EM_PEER_KEY_SETS || !gEncryptionState.peerReady[set])
+    return;
+  gEncryptionState.peerReady[set] = false;
+  free_slot(&gEncryptionState.peers[set]);
+}
+
+bool EncryptionManager_isPeerReady(uint8_t set) {
+  return set < EM_PEER_KEY_SETS && gEncryptionState.peerReady[set];
+}
+
 bool EncryptionManager_generateIV(uint8_t *iv) {
   if (!iv) {
     snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
@@ -85,8 +189,28 @@ bool EncryptionManager_generateIV(uint8_t *iv) {
     return false;
   }
 
-  int ret =
-      mbedtls_ctr_drbg_random(&gEncryptionState.ctr_drbg, iv, AES_IV_SIZE);
+  if (gEncryptionState.ivMode == EM_IV_MODE_COUNTER) {
+    // Counter exhausted: fall back to a fresh prefix rather than wrap
+    if (gEncryptionState.ivCounter > UINT64_MAX - AES_CTR_BLOCKS_PER_IV) {
+      int ret = reseed_nonce();
+      if (ret != 0) {
+        set_last_error("Nonce prefix", ret);
+        return false;
+      }
+    }
+
+    uint64_t counter = gEncryptionState.ivCounter;
+    gEncryptionState.ivCounter += AES_CTR_BLOCKS_PER_IV;
+
+    memcpy(iv, gEncryptionState.ivPrefix, AES_IV_PREFIX_SIZE);
+    for (int i = AES_IV_SIZE - 1; i >= AES_IV_PREFIX_SIZE; i--) {
+      iv[i] = (uint8_t)(counter & 0xFF);
+      counter >>= 8;
+    }
+    return true;
+  }
+
+  int ret = SecureRandom_fill(iv, AES_IV_SIZE);
   if (ret != 0) {
     set_last_error("Generate IV", ret);
     return false;
@@ -95,12 +219,78 @@ bool EncryptionManager_generateIV(uint8_t *iv) {
   return true;
 }
 
+void EncryptionManager_setIVMode(EncryptionIVMode mode) {
+  gEncryptionState.ivMode = mode;
+}
+
+EncryptionIVMode EncryptionManager_getIVMode(void) {
+  return gEncryptionState.ivMode;
+}
+
+uint64_t EncryptionManager_getIVCounter(void) {
+  return gEncryptionState.ivCounter;
+}
+
+static bool aes_ctr(EncryptionKeySlot *slot, bool ready, const uint8_t *input,
+                    uint16_t len, const uint8_t *iv, uint8_t *output) {
+
+  if (!input || !iv || !output) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "NULL pointer in encrypt params");
+    return false;
+  }
+
+  if (len > AES_MAX_PAYLOAD) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "Payload too large: %u > %u", len, AES_MAX_PAYLOAD);
+    return false;
+  }
+
+  if (!ready) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "Encryption not initialized");
+    return false;
+  }
+
+  int ret = CryptoBackend_aesCtr(&slot->aes_ctx, iv, input, len, output);
+
+  if (ret != 0) {
+    set_last_error("AES encrypt", ret);
+    return false;
+  }
+
+  return true;
+}
+
 bool EncryptionManager_encrypt(const uint8_t *plaintext, uint16_t len,
                                const uint8_t *iv, uint8_t *ciphertext) {
+  return aes_ctr(&gEncryptionState.tx, gEncryptionState.initialized, plaintext, len,
+                 iv, ciphertext);
+}
+
+bool EncryptionManager_decrypt(const uint8_t *ciphertext, uint16_t len,
+                               const uint8_t *iv, uint8_t *plaintext) {
+  // CTR mode is symmetric: decrypt is the same operation under the rx key
+  return aes_ctr(&gEncryptionState.rx, gEncryptionState.initialized, ciphertext,
+                 len, iv, plaintext);
+}
+
+bool EncryptionManager_decryptFrom(uint8_t set, const uint8_t *ciphertext,
+                                   uint16_t len, const uint8_t *iv,
+                                   uint8_t *plaintext) {
+  if (set >= EM_PEER_KEY_SETS)
+    return false;
+  return aes_ctr(&gEncryptionState.peers[set], gEncryptionState.peerReady[set],
+                 ciphertext, len, iv, plaintext);
+}
 
-  if (!plaintext || !iv || !ciphertext) {
+bool EncryptionManager_aeadEncrypt(const uint8_t *plaintext, uint16_t len,
+                                   const uint8_t *nonce, const uint8_t *aad,
+                                   uint16_t aadLen, uint8_t *ciphertext,
+                                   uint8_t *tag) {
+  if (!plaintext || !nonce || !ciphertext || !tag || (!aad && aadLen)) {
     snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
-             "NULL pointer in encrypt params");
+             "NULL pointer in AEAD encrypt params");
     return false;
   }
 
@@ -116,38 +306,88 @@ bool EncryptionManager_encrypt(const uint8_t *plaintext, uint16_t len,
     return false;
   }
 
-  mbedtls_aes_context aes_ctx;
-  mbedtls_aes_init(&aes_ctx);
-
-  int ret = mbedtls_aes_setkey_enc(&aes_ctx, gEncryptionState.key, 256);
+  int ret = mbedtls_gcm_crypt_and_tag(
+      &gEncryptionState.tx.gcm_ctx, MBEDTLS_GCM_ENCRYPT, len, nonce,
+      AES_GCM_NONCE_SIZE, aad, aadLen, plaintext, ciphertext, AES_GCM_TAG_SIZE,
+      tag);
   if (ret != 0) {
-    set_last_error("AES setkey", ret);
-    mbedtls_aes_free(&aes_ctx);
+    set_last_error("GCM encrypt", ret);
     return false;
   }
 
-  size_t nc_off = 0;
-  uint8_t stream_block[16] = {0};
-  uint8_t iv_copy[16];
-  memcpy(iv_copy, iv, 16);
+  return true;
+}
 
-  ret = mbedtls_aes_crypt_ctr(&aes_ctx, len, &nc_off, iv_copy, stream_block,
-                              plaintext, ciphertext);
+static bool gcm_decrypt(EncryptionKeySlot *slot, bool ready,
+                        const uint8_t *ciphertext, uint16_t len,
+                        const uint8_t *nonce, const uint8_t *aad,
+                        uint16_t aadLen, const uint8_t *tag, uint8_t tagLen,
+                        uint8_t *plaintext) {
+  if (!ciphertext || !nonce || !tag || !plaintext || (!aad && aadLen)) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "NULL pointer in AEAD decrypt params");
+    return false;
+  }
 
-  mbedtls_aes_free(&aes_ctx);
+  if (len > AES_MAX_PAYLOAD) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "Payload too large: %u > %u", len, AES_MAX_PAYLOAD);
+    return false;
+  }
 
+  if (!ready) {
+    snprintf(gEncryptionState.lastError, sizeof(gEncryptionState.lastError),
+             "Encryption not initialized");
+    return false;
+  }
+
+  // Decrypt into a scratch buffer so a forged frame never reaches the
+  // caller's buffer (mbedtls zeroes the output only on tag mismatch)
+  uint8_t scratch[AES_MAX_PAYLOAD];
+  int ret = mbedtls_gcm_auth_decrypt(&slot->gcm_ctx, len, nonce,
+                                     AES_GCM_NONCE_SIZE, aad, aadLen, tag,
+                                     tagLen, ciphertext, scratch);
   if (ret != 0) {
-    set_last_error("AES encrypt", ret);
+    memset(scratch, 0, sizeof(scratch));
+    set_last_error("GCM auth decrypt", ret);
     return false;
   }
 
+  memcpy(plaintext, scratch, len);
+  memset(scratch, 0, sizeof(scratch));
   return true;
 }
 
-bool EncryptionManager_decrypt(const uint8_t *ciphertext, uint16_t len,
-                               const uint8_t *iv, uint8_t *plaintext) {
-  // CTR mode is symmetric: decrypt is identical to encrypt
-  return EncryptionManager_encrypt(ciphertext, len, iv, plaintext);
+bool EncryptionManager_aeadDecrypt(const uint8_t *ciphertext, uint16_t len,
+                                   const uint8_t *nonce, const uint8_t *aad,
+                                   uint16_t aadLen, const uint8_t *tag,
+                                   uint8_t *plaintext) {
+  return gcm_decrypt(&gEncryptionState.rx, gEncryptionState.initialized,
+                     ciphertext, len, nonce, aad, aadLen, tag, AES_GCM_TAG_SIZE,
+                     plaintext);
+}
+
+bool EncryptionManager_aeadDecryptFrom(uint8_t set, const uint8_t *ciphertext,
+                                       uint16_t len, const uint8_t *nonce,
+                                       const uint8_t *aad, uint16_t aadLen,
+                                       const uint8_t *tag, uint8_t *plaintext) {
+  if (set >= EM_PEER_KEY_SETS)
+    return false;
+  return gcm_decrypt(&gEncryptionState.peers[set],
+                     gEncryptionState.peerReady[set], ciphertext, len, nonce,
+                     aad, aadLen, tag, AES_GCM_TAG_SIZE, plaintext);
+}
+
+bool EncryptionManager_aeadDecryptFromTruncated(uint8_t set, const uint8_t *ciphertext,
+                                                uint16_t len, const uint8_t *nonce,
+                                                const uint8_t *aad, uint16_t aadLen,
+                                                const uint8_t *tag, uint8_t tagLen,
+                                                uint8_t *plaintext) {
+  if (set >= EM_PEER_KEY_SETS || tagLen < 4 || tagLen > AES_GCM_TAG_SIZE)
+    return false;
+  return gcm_decrypt(&gEncryptionState.peers[set],
+                     gEncryptionState.peerReady[set], ciphertext, len, nonce,
+                     aad, aadLen, tag, tagLen, plaintext);
 }
 
 bool EncryptionManager_deriveKey(const char *password, uint16_t passwordLen,
@@ -9,7 +9,8 @@
  * 
  * Handles:
  * - AES-256 encryption in CTR mode (stream cipher)
- * - IV generation for each packet
+ * - AES-256-GCM AEAD mode (decrypt + authenticate in one pass)
+ * - IV generation for each packet (random or counter-based nonce)
  * - Key derivation (PBKDF2)
  * - Secure memory handling
  * 
@@ -21,21 +22,97 @@
 #define AES_256_KEY_SIZE    32  // 256 bits
 #define AES_IV_SIZE         16  // 128 bits
 #define AES_MAX_PAYLOAD     64  // Max bytes to encrypt
+#define AES_GCM_NONCE_SIZE  12  // 96-bit GCM nonce
+#define AES_GCM_TAG_SIZE    16  // 128-bit GCM tag
+
+// Counter nonce layout: prefix (8 random bytes per session) || counter (64-bit BE)
+#define AES_IV_PREFIX_SIZE  8
+#define AES_CTR_BLOCKS_PER_IV (AES_MAX_PAYLOAD / 16)  // Counter step per IV
+
+// Receive key sets for peers with their own session, one per
+// PeerSessionTable slot (PEER_SESSION_MAX)
+#define EM_PEER_KEY_SETS    4
+
+/**
+ * IV generation strategy
+ */
+typedef enum {
+    EM_IV_MODE_RANDOM = 0,      // 16 bytes from the shared DRBG per packet
+    EM_IV_MODE_COUNTER = 1      // Session prefix + monotonic counter
+} EncryptionIVMode;
 
 /**
- * Initialize encryption with shared key
+ * Initialize encryption with shared key (same key both directions)
  * @param key 32-byte AES-256 key (must be from ConfigManager or ECDH)
  * @return true if initialization successful
  */
 bool EncryptionManager_init(const uint8_t* key);
 
 /**
- * Generate random IV for packet encryption
+ * Install directional session keys (SessionKeys)
+ *
+ * Only the AES / GCM key schedules are rebuilt and the nonce prefix is
+ * re-drawn from the shared DRBG (SecureRandom, seeded once per boot), so
+ * a ratchet step costs no entropy gathering.
+ *
+ * @param rxKey 32-byte key for decrypt / aeadDecrypt (controller -> vehicle)
+ * @param txKey 32-byte key for encrypt / aeadEncrypt (vehicle -> controller)
+ * @return true if both keys were installed
+ */
+bool EncryptionManager_setKeys(const uint8_t* rxKey, const uint8_t* txKey);
+
+/**
+ * Install the receive key of one radio peer (PeerSessionTable slot)
+ *
+ * Frames from that peer are then checked with decryptFrom() /
+ * aeadDecryptFrom(). The link keys from setKeys() are untouched, so a
+ * relay handshaking does not re-key the ground station.
+ *
+ * @param set Key set index (0..EM_PEER_KEY_SETS-1)
+ * @param rxKey 32-byte key (controller -> vehicle direction of that peer)
+ * @return true if installed
+ */
+bool EncryptionManager_setPeerKey(uint8_t set, const uint8_t* rxKey);
+
+/**
+ * Release the key of a peer set (peer evicted or link re-keyed)
+ */
+void EncryptionManager_clearPeerKey(uint8_t set);
+
+/**
+ * Whether a peer set holds a key
+ */
+bool EncryptionManager_isPeerReady(uint8_t set);
+
+/**
+ * Generate IV for packet encryption
+ *
+ * In EM_IV_MODE_COUNTER the counter advances by AES_CTR_BLOCKS_PER_IV so
+ * the CTR keystream blocks of consecutive packets never overlap. The prefix
+ * is re-drawn on every init() (boot and key exchange), so a counter that
+ * restarts at 0 never reuses a nonce under the same key.
+ *
  * @param iv Output buffer (16 bytes)
  * @return true if IV generated successfully
  */
 bool EncryptionManager_generateIV(uint8_t* iv);
 
+/**
+ * Select IV generation strategy (kept across re-init)
+ * @param mode EM_IV_MODE_RANDOM or EM_IV_MODE_COUNTER
+ */
+void EncryptionManager_setIVMode(EncryptionIVMode mode);
+
+/**
+ * Get current IV generation strategy
+ */
+EncryptionIVMode EncryptionManager_getIVMode(void);
+
+/**
+ * Get counter value the next counter-mode IV will carry
+ */
+uint64_t EncryptionManager_getIVCounter(void);
+
 /**
  * Encrypt plaintext data with AES-256 CTR
  * @param plaintext Input data
@@ -66,6 +143,96 @@ bool EncryptionManager_decrypt(
     uint8_t* plaintext
 );
 
+/**
+ * Decrypt with the receive key of a peer set (see decrypt())
+ */
+bool EncryptionManager_decryptFrom(
+    uint8_t set,
+    const uint8_t* ciphertext,
+    uint16_t len,
+    const uint8_t* iv,
+    uint8_t* plaintext
+);
+
+/**
+ * Encrypt and authenticate with AES-256-GCM
+ *
+ * Shares one GCM context; call from a single task (control task).
+ *
+ * @param plaintext Input data
+ * @param len Length of data (1-AES_MAX_PAYLOAD)
+ * @param nonce 12-byte nonce (must never repeat under the same key)
+ * @param aad Additional authenticated data (sent in clear), may be NULL
+ * @param aadLen Length of aad
+ * @param ciphertext Output encrypted data (same length as plaintext)
+ * @param tag Output authentication tag (16 bytes)
+ * @return true if encryption successful
+ */
+bool EncryptionManager_aeadEncrypt(
+    const uint8_t* plaintext,
+    uint16_t len,
+    const uint8_t* nonce,
+    const uint8_t* aad,
+    uint16_t aadLen,
+    uint8_t* ciphertext,
+    uint8_t* tag
+);
+
+/**
+ * Verify and decrypt with AES-256-GCM
+ *
+ * Shares one GCM context; call from a single task (control task).
+ *
+ * @param ciphertext Encrypted data
+ * @param len Length of data (1-AES_MAX_PAYLOAD)
+ * @param nonce 12-byte nonce
+ * @param aad Additional authenticated data, may be NULL
+ * @param aadLen Length of aad
+ * @param tag Received authentication tag (16 bytes)
+ * @param plaintext Output decrypted data (untouched contents on failure)
+ * @return true if the tag is valid and decryption succeeded
+ */
+bool EncryptionManager_aeadDecrypt(
+    const uint8_t* ciphertext,
+    uint16_t len,
+    const uint8_t* nonce,
+    const uint8_t* aad,
+    uint16_t aadLen,
+    const uint8_t* tag,
+    uint8_t* plaintext
+);
+
+/**
+ * Verify and decrypt with the receive key of a peer set (see aeadDecrypt())
+ */
+bool EncryptionManager_aeadDecryptFrom(
+    uint8_t set,
+    const uint8_t* ciphertext,
+    uint16_t len,
+    const uint8_t* nonce,
+    const uint8_t* aad,
+    uint16_t aadLen,
+    const uint8_t* tag,
+    uint8_t* plaintext
+);
+
+/**
+ * Verify and decrypt with a peer set's receive key and a truncated tag
+ * (NAPacketCompact); the leading tagLen bytes of the full tag are checked
+ * @param tagLen 4-16
+ */
+bool EncryptionManager_aeadDecryptFromTruncated(
+    uint8_t set,
+    const uint8_t* ciphertext,
+    uint16_t len,
+    const uint8_t* nonce,
+    const uint8_t* aad,
+    uint16_t aadLen,
+    const uint8_t* tag,
+    uint8_t tagLen,
+    uint8_t* plaintext
+);
+
 /**
  * Derive encryption key from password using PBKDF2
  * @param password User password
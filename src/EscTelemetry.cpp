@@ -0,0 +1,103 @@
+#include "EscTelemetry.h"
+#include <string.h>
+
+/**
+ * EscTelemetry - Implementation
+ *
+ * @file EscTelemetry.cpp
+ */
+
+static uint16_t be16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+uint8_t EscTelemetry_crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+bool EscTelemetry_parseKiss(const uint8_t* frame, EscSample* out) {
+    if (EscTelemetry_crc8(frame, ESC_KISS_FRAME_LEN - 1) != frame[ESC_KISS_FRAME_LEN - 1])
+        return false;
+    out->fields = ESC_FIELD_ERPM | ESC_FIELD_TEMP | ESC_FIELD_VOLTAGE | ESC_FIELD_CURRENT |
+                  ESC_FIELD_CONSUMPTION;
+    out->tempC = frame[0];
+    out->centiVolts = be16(frame + 1);
+    out->centiAmps = be16(frame + 3);
+    out->mAh = be16(frame + 5);
+    out->erpm = (uint32_t)be16(frame + 7) * 100;
+    return true;
+}
+
+// ============================================================================
+// State
+// ============================================================================
+
+void EscTelemetry_init(EscTelemetry* t, uint8_t motorCount) {
+    memset(t, 0, sizeof(*t));
+    t->motorCount = motorCount > ESC_TELEM_MAX_MOTORS ? ESC_TELEM_MAX_MOTORS : motorCount;
+}
+
+void EscTelemetry_record(EscTelemetry* t, uint8_t motor, const EscSample* sample,
+                         uint32_t nowMs) {
+    if (motor >= t->motorCount) return;
+    EscMotorTelemetry* m = &t->motors[motor];
+    if (sample->fields & ESC_FIELD_ERPM) {
+        m->last.erpm = sample->erpm;
+        m->erpmMs = nowMs;
+    }
+    if (sample->fields & ESC_FIELD_TEMP) m->last.tempC = sample->tempC;
+    if (sample->fields & ESC_FIELD_VOLTAGE) m->last.centiVolts = sample->centiVolts;
+    if (sample->fields & ESC_FIELD_CURRENT) m->last.centiAmps = sample->centiAmps;
+    if (sample->fields & ESC_FIELD_CONSUMPTION) m->last.mAh = sample->mAh;
+    m->last.fields |= sample->fields;
+    m->updatedMs = nowMs;
+    m->samples++;
+}
+
+void EscTelemetry_recordError(EscTelemetry* t, uint8_t motor) {
+    if (motor < t->motorCount) t->motors[motor].errors++;
+}
+
+// ============================================================================
+// Health
+// ============================================================================
+
+uint8_t EscTelemetry_checkHealth(EscTelemetry* t, const int16_t* commanded, uint32_t nowMs) {
+    uint8_t all = ESC_HEALTH_OK;
+    for (uint8_t i = 0; i < t->motorCount; i++) {
+        EscMotorTelemetry* m = &t->motors[i];
+        uint8_t health = ESC_HEALTH_OK;
+
+        // Nothing ever received: no telemetry on this motor, nothing to judge
+        if (m->samples && nowMs - m->updatedMs > ESC_TELEM_STALE_MS)
+            health |= ESC_HEALTH_STALE;
+
+        bool rpmFresh = (m->last.fields & ESC_FIELD_ERPM) &&
+                        nowMs - m->erpmMs <= ESC_TELEM_STALE_MS;
+        if (rpmFresh && commanded[i] >= ESC_STALL_MIN_COMMAND &&
+            m->last.erpm < ESC_STALL_MAX_ERPM) {
+            if (!m->stallSinceMs) m->stallSinceMs = nowMs ? nowMs : 1;
+            if (nowMs - m->stallSinceMs >= ESC_STALL_MS) health |= ESC_HEALTH_STALLED;
+        } else {
+            m->stallSinceMs = 0;
+        }
+
+        if ((m->last.fields & ESC_FIELD_TEMP) && !(health & ESC_HEALTH_STALE) &&
+            m->last.tempC >= ESC_HOT_C)
+            health |= ESC_HEALTH_HOT;
+
+        m->health = health;
+        all |= health;
+    }
+    return all;
+}
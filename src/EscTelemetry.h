@@ -0,0 +1,109 @@
+#ifndef ESC_TELEMETRY_H
+#define ESC_TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * EscTelemetry - Per-motor ESC feedback and motor health
+ *
+ * Collects what the ESCs report about themselves from either path:
+ * - bidirectional DShot: eRPM on the signal line after every frame
+ *   (DShotESC, RMT capture), nothing else
+ * - KISS / BLHeli32 serial telemetry: one 10-byte frame per request on a
+ *   shared telemetry wire with temperature, voltage, current, consumed
+ *   mAh and eRPM (EscTelemetry_parseKiss)
+ *
+ * Each sample carries a field mask, so a motor with both paths keeps
+ * the fast eRPM from DShot and the slower rest from the serial frames.
+ *
+ * EscTelemetry_checkHealth compares the feedback with what the motors
+ * were told to do: telemetry that stopped, a motor commanded to spin
+ * that does not turn, an ESC over temperature.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file EscTelemetry.h
+ */
+
+#define ESC_TELEM_MAX_MOTORS    4
+#define ESC_KISS_FRAME_LEN      10
+
+#define ESC_TELEM_STALE_MS      500     // No sample for this long
+#define ESC_STALL_MIN_COMMAND   20      // Speed (0-100) that must turn the motor
+#define ESC_STALL_MAX_ERPM      1000    // Below this counts as not turning
+#define ESC_STALL_MS            300     // ... for this long (spin-up)
+#define ESC_HOT_C               100
+
+// Fields present in a sample
+#define ESC_FIELD_ERPM          0x01
+#define ESC_FIELD_TEMP          0x02
+#define ESC_FIELD_VOLTAGE       0x04
+#define ESC_FIELD_CURRENT       0x08
+#define ESC_FIELD_CONSUMPTION   0x10
+
+// Health flags, per motor and ORed over all of them
+#define ESC_HEALTH_OK           0x00
+#define ESC_HEALTH_STALE        0x01
+#define ESC_HEALTH_STALLED      0x02
+#define ESC_HEALTH_HOT          0x04
+
+typedef struct {
+    uint8_t fields;             // ESC_FIELD_*
+    uint32_t erpm;              // Electrical RPM
+    int16_t tempC;
+    uint16_t centiVolts;
+    uint16_t centiAmps;
+    uint16_t mAh;               // Consumed since the ESC powered up
+} EscSample;
+
+typedef struct {
+    EscSample last;             // Newest value of each field
+    uint32_t updatedMs;         // Any field
+    uint32_t erpmMs;            // eRPM field
+    uint32_t stallSinceMs;      // 0 = turning or not commanded
+    uint32_t samples;
+    uint32_t errors;            // Frames that failed their CRC
+    uint8_t health;             // ESC_HEALTH_*
+} EscMotorTelemetry;
+
+typedef struct {
+    uint8_t motorCount;
+    EscMotorTelemetry motors[ESC_TELEM_MAX_MOTORS];
+} EscTelemetry;
+
+/**
+ * CRC-8 of a KISS telemetry frame (polynomial 0x07, initial value 0)
+ */
+uint8_t EscTelemetry_crc8(const uint8_t* data, size_t len);
+
+/**
+ * Decode a KISS / BLHeli32 telemetry frame
+ * @param frame ESC_KISS_FRAME_LEN bytes: temperature, voltage (2),
+ *              current (2), consumption (2), eRPM / 100 (2), CRC
+ * @return false if the CRC does not match (out untouched)
+ */
+bool EscTelemetry_parseKiss(const uint8_t* frame, EscSample* out);
+
+void EscTelemetry_init(EscTelemetry* t, uint8_t motorCount);
+
+/**
+ * Merge a sample into a motor's state (only the fields it carries)
+ */
+void EscTelemetry_record(EscTelemetry* t, uint8_t motor, const EscSample* sample,
+                         uint32_t nowMs);
+
+/**
+ * Count a frame that failed decoding
+ */
+void EscTelemetry_recordError(EscTelemetry* t, uint8_t motor);
+
+/**
+ * Update each motor's health from its feedback and command
+ * @param commanded Speed per motor, 0-100 (as sent to the ESCs)
+ * @return All motors' flags ORed
+ */
+uint8_t EscTelemetry_checkHealth(EscTelemetry* t, const int16_t* commanded, uint32_t nowMs);
+
+#endif // ESC_TELEMETRY_H
@@ -0,0 +1,245 @@
+#include "EspNowTx.h"
+#include "HAL.h"
+#include <esp_now.h>
+#include <freertos/FreeRTOS.h>
+#include <string.h>
+
+/**
+ * EspNowTx - Implementation
+ *
+ * State is shared between the producer task and the Wi-Fi task that runs
+ * the send callback, so every access goes through txMux.
+ *
+ * @file EspNowTx.cpp
+ */
+
+typedef struct {
+    bool used;
+    EspNowTxStats stats;
+    uint32_t lastSendMs;
+    int64_t sentAtUs;
+} TxPeer;
+
+static TxPeer peers[ESPNOW_TX_MAX_PEERS];
+static portMUX_TYPE txMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+// Caller holds txMux
+static TxPeer* find_peer(const uint8_t* mac, bool create) {
+    TxPeer* freeSlot = NULL;
+    for (int i = 0; i < ESPNOW_TX_MAX_PEERS; i++) {
+        if (peers[i].used && memcmp(peers[i].stats.mac, mac, 6) == 0)
+            return &peers[i];
+        if (!peers[i].used && !freeSlot)
+            freeSlot = &peers[i];
+    }
+    if (!create || !freeSlot)
+        return NULL;
+
+    memset(freeSlot, 0, sizeof(*freeSlot));
+    freeSlot->used = true;
+    memcpy(freeSlot->stats.mac, mac, 6);
+    freeSlot->stats.intervalMs = ESPNOW_TX_MIN_INTERVAL_MS;
+    return freeSlot;
+}
+
+// Caller holds txMux
+static void back_off(TxPeer* p) {
+    uint32_t next = (uint32_t)p->stats.intervalMs * 2;
+    p->stats.intervalMs = next > ESPNOW_TX_MAX_INTERVAL_MS ? ESPNOW_TX_MAX_INTERVAL_MS : next;
+}
+
+static void on_send(const uint8_t* mac, esp_now_send_status_t status) {
+    HAL_Micros now = HAL_Now();
+
+    portENTER_CRITICAL(&txMux);
+    TxPeer* p = mac ? find_peer(mac, false) : NULL;
+    if (p && p->stats.inFlight) {
+        p->stats.inFlight = false;
+        uint32_t latency = (uint32_t)(now - p->sentAtUs);
+        p->stats.avgLatencyUs = p->stats.avgLatencyUs
+                                    ? (p->stats.avgLatencyUs * 7 + latency) / 8
+                                    : latency;
+        if (latency > p->stats.maxLatencyUs)
+            p->stats.maxLatencyUs = latency;
+
+        if (status == ESP_NOW_SEND_SUCCESS) {
+            p->stats.delivered++;
+            // Speed back up only while the channel answers quickly
+            if (latency < ESPNOW_TX_SLOW_LATENCY_US &&
+                p->stats.intervalMs > ESPNOW_TX_MIN_INTERVAL_MS) {
+                uint16_t next = p->stats.intervalMs - ESPNOW_TX_STEP_MS;
+                p->stats.intervalMs = next < ESPNOW_TX_MIN_INTERVAL_MS ? ESPNOW_TX_MIN_INTERVAL_MS : next;
+            }
+        } else {
+            p->stats.failed++;
+            back_off(p);
+        }
+    }
+    portEXIT_CRITICAL(&txMux);
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+bool EspNowTx_init(void) {
+    EspNowTx_reset();
+    return esp_now_register_send_cb(on_send) == ESP_OK;
+}
+
+bool EspNowTx_addPeer(const uint8_t* mac) {
+    if (!mac)
+        return false;
+    if (esp_now_is_peer_exist(mac))
+        return true;
+
+    esp_now_peer_info_t peer;
+    memset(&peer, 0, sizeof(peer));
+    memcpy(peer.peer_addr, mac, 6);
+    peer.channel = 0;           // Current channel
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = false;       // Payload security above ESP-NOW unless setPeerKey()
+    return esp_now_add_peer(&peer) == ESP_OK;
+}
+
+bool EspNowTx_setMasterKey(const uint8_t* pmk) {
+    return pmk && esp_now_set_pmk(pmk) == ESP_OK;
+}
+
+bool EspNowTx_setPeerKey(const uint8_t* mac, const uint8_t* lmk) {
+    if (!mac || !lmk || !EspNowTx_addPeer(mac))
+        return false;
+    esp_now_peer_info_t peer;
+    if (esp_now_get_peer(mac, &peer) != ESP_OK)
+        return false;
+    memcpy(peer.lmk, lmk, ESPNOW_TX_KEY_SIZE);
+    peer.encrypt = true;
+    bool ok = esp_now_mod_peer(&peer) == ESP_OK;
+    memset(peer.lmk, 0, sizeof(peer.lmk));
+    return ok;
+}
+
+bool EspNowTx_clearPeerKey(const uint8_t* mac) {
+    if (!mac || !esp_now_is_peer_exist(mac))
+        return true;
+    esp_now_peer_info_t peer;
+    if (esp_now_get_peer(mac, &peer) != ESP_OK)
+        return false;
+    if (!peer.encrypt)
+        return true;
+    memset(peer.lmk, 0, sizeof(peer.lmk));
+    peer.encrypt = false;
+    return esp_now_mod_peer(&peer) == ESP_OK;
+}
+
+bool EspNowTx_enableLongRange(void) {
+    uint8_t protocols = WIFI_PROTOCOL_11B | WIFI_PROTOCOL_11G | WIFI_PROTOCOL_11N |
+                        WIFI_PROTOCOL_LR;
+    return esp_wifi_set_protocol(WIFI_IF_STA, protocols) == ESP_OK;
+}
+
+bool EspNowTx_setPhyRate(wifi_phy_rate_t rate) {
+    return esp_wifi_config_espnow_rate(WIFI_IF_STA, rate) == ESP_OK;
+}
+
+bool EspNowTx_canSend(const uint8_t* mac, uint32_t nowMs) {
+    if (!mac)
+        return false;
+
+    bool ok = true;
+    portENTER_CRITICAL(&txMux);
+    TxPeer* p = find_peer(mac, false);
+    if (p) {
+        if (p->stats.inFlight) {
+            if (nowMs - p->lastSendMs < ESPNOW_TX_TIMEOUT_MS) {
+                ok = false;
+            } else {
+                // Callback lost: free the slot and slow down
+                p->stats.inFlight = false;
+                p->stats.timeouts++;
+                back_off(p);
+            }
+        }
+        if (ok && nowMs - p->lastSendMs < p->stats.intervalMs)
+            ok = false;
+    }
+    portEXIT_CRITICAL(&txMux);
+    return ok;
+}
+
+bool EspNowTx_send(const uint8_t* mac, const uint8_t* data, size_t len,
+                   uint32_t nowMs) {
+    if (!mac || !data || len == 0 || len > ESP_NOW_MAX_DATA_LEN)
+        return false;
+    if (!EspNowTx_addPeer(mac))
+        return false;
+
+    // Mark in flight first: the callback can fire before esp_now_send returns
+    portENTER_CRITICAL(&txMux);
+    TxPeer* p = find_peer(mac, true);
+    if (p) {
+        p->stats.inFlight = true;
+        p->lastSendMs = nowMs;
+        p->sentAtUs = HAL_Now();
+    }
+    portEXIT_CRITICAL(&txMux);
+
+    esp_err_t err = esp_now_send(mac, data, len);
+
+    portENTER_CRITICAL(&txMux);
+    if (p) {
+        if (err == ESP_OK) {
+            p->stats.sent++;
+        } else {
+            p->stats.inFlight = false;
+            p->stats.failed++;
+            back_off(p);
+        }
+    }
+    portEXIT_CRITICAL(&txMux);
+    return err == ESP_OK;
+}
+
+void EspNowTx_markCoalesced(const uint8_t* mac) {
+    if (!mac)
+        return;
+    portENTER_CRITICAL(&txMux);
+    TxPeer* p = find_peer(mac, false);
+    if (p)
+        p->stats.coalesced++;
+    portEXIT_CRITICAL(&txMux);
+}
+
+bool EspNowTx_getPeerStats(const uint8_t* mac, EspNowTxStats* out) {
+    if (!mac || !out)
+        return false;
+    portENTER_CRITICAL(&txMux);
+    TxPeer* p = find_peer(mac, false);
+    if (p)
+        *out = p->stats;
+    portEXIT_CRITICAL(&txMux);
+    return p != NULL;
+}
+
+uint8_t EspNowTx_getAllStats(EspNowTxStats* out, uint8_t maxPeers) {
+    uint8_t n = 0;
+    if (!out)
+        return 0;
+    portENTER_CRITICAL(&txMux);
+    for (int i = 0; i < ESPNOW_TX_MAX_PEERS && n < maxPeers; i++) {
+        if (peers[i].used)
+            out[n++] = peers[i].stats;
+    }
+    portEXIT_CRITICAL(&txMux);
+    return n;
+}
+
+void EspNowTx_reset(void) {
+    portENTER_CRITICAL(&txMux);
+    memset(peers, 0, sizeof(peers));
+    portEXIT_CRITICAL(&txMux);
+}
@@ -0,0 +1,170 @@
+#ifndef ESPNOW_TX_H
+#define ESPNOW_TX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <esp_wifi.h>
+
+/**
+ * EspNowTx - Paced ESP-NOW transmit with send-completion tracking
+ *
+ * Keeps at most one frame in flight per peer:
+ * - esp_now_register_send_cb() reports delivery (ACK) and latency
+ * - While a frame is in flight, or the peer's interval has not elapsed,
+ *   canSend() is false; the producer keeps only its latest sample and
+ *   sends that next (updates coalesce instead of queuing)
+ * - Interval adapts per peer: doubles on failure / timeout, shrinks by
+ *   ESPNOW_TX_STEP_MS after fast ACKs, never below the producer period
+ *
+ * Broadcast frames are tracked too; the driver reports them as sent
+ * without a MAC ACK, so only latency and local failures count there.
+ * Unicast peers get hardware retries and can use a faster PHY rate.
+ *
+ * Destinations are registered with esp_now_add_peer() on first send.
+ *
+ * Long range: with ESPNOW_LONG_RANGE the station interface also speaks
+ * WIFI_PROTOCOL_LR, so frames at either PHY are received. Which one is
+ * sent is a PHY rate like any other (ESPNOW_TX_LR_RATE); LinkRate decides
+ * when, and only once the controller has said it receives LR.
+ *
+ * Link-layer encryption: a peer given a local master key (LMK) is
+ * re-registered with encrypt set, and the Wi-Fi MAC encrypts and
+ * authenticates every unicast frame to and from it with CCMP (AES-CCM,
+ * hardware). The driver drops unencrypted frames from an encrypted peer.
+ * Broadcast cannot be encrypted. All peers share the primary master key
+ * (ESPNOW_TX_PMK), which only wraps the LMKs inside the driver.
+ *
+ * @file EspNowTx.h
+ */
+
+// Add Espressif's long-range mode to the station protocols (0 = 802.11b/g/n only)
+#ifndef ESPNOW_LONG_RANGE
+#define ESPNOW_LONG_RANGE           1
+#endif
+
+// Link-layer CCMP on keyed peers, stored setting ({"c":"set_ccmp"})
+#define ESPNOW_CCMP_CONFIG_KEY      "cfg_ccmp"
+#define ESPNOW_TX_PMK               "NA espnow pmk v1"  // 16 bytes, same on the controller
+#define ESPNOW_TX_KEY_SIZE          16
+
+#define ESPNOW_TX_LR_RATE           WIFI_PHY_RATE_LORA_250K
+#define ESPNOW_TX_MAX_PEERS         4
+#define ESPNOW_TX_MIN_INTERVAL_MS   45      // Just under the 50 ms telemetry period (jitter)
+#define ESPNOW_TX_MAX_INTERVAL_MS   400
+#define ESPNOW_TX_STEP_MS           5
+#define ESPNOW_TX_TIMEOUT_MS        100     // No send callback: treat as failed
+#define ESPNOW_TX_SLOW_LATENCY_US   10000   // ACK slower than this: hold rate
+
+/**
+ * Per-peer transmit statistics
+ */
+typedef struct {
+    uint8_t mac[6];
+    uint32_t sent;              // esp_now_send() accepted
+    uint32_t delivered;         // Callback: ESP_NOW_SEND_SUCCESS
+    uint32_t failed;            // Callback: fail, or esp_now_send() error
+    uint32_t timeouts;          // No callback within ESPNOW_TX_TIMEOUT_MS
+    uint32_t coalesced;         // Samples superseded while waiting
+    uint32_t avgLatencyUs;      // EWMA send -> callback
+    uint32_t maxLatencyUs;
+    uint16_t intervalMs;        // Current adaptive interval
+    bool inFlight;
+} EspNowTxStats;
+
+/**
+ * Register the send callback (call after esp_now_init)
+ * @return true if registered
+ */
+bool EspNowTx_init(void);
+
+/**
+ * Register a destination with the ESP-NOW driver (no-op if present)
+ * @param mac Peer address (FF:..:FF for broadcast)
+ * @return true if the peer exists after the call
+ */
+bool EspNowTx_addPeer(const uint8_t* mac);
+
+/**
+ * Add WIFI_PROTOCOL_LR to the station interface (after esp_now_init);
+ * 802.11b/g/n stay on, so nothing is lost if the peer never uses LR
+ * @return true if the driver accepted it
+ */
+bool EspNowTx_enableLongRange(void);
+
+/**
+ * Set the primary master key that wraps peer LMKs (after esp_now_init)
+ * @param pmk ESPNOW_TX_KEY_SIZE bytes
+ * @return true if the driver accepted it
+ */
+bool EspNowTx_setMasterKey(const uint8_t* pmk);
+
+/**
+ * Encrypt unicast frames with a peer at the link layer (CCMP)
+ * Adds the peer if needed; from here on the driver only takes encrypted
+ * frames from it, so the peer must install the same LMK.
+ * @param lmk ESPNOW_TX_KEY_SIZE bytes
+ * @return true if the peer is encrypted after the call
+ */
+bool EspNowTx_setPeerKey(const uint8_t* mac, const uint8_t* lmk);
+
+/**
+ * Back to unencrypted frames with a peer (no-op if not registered)
+ * @return true if the peer is not encrypted after the call
+ */
+bool EspNowTx_clearPeerKey(const uint8_t* mac);
+
+/**
+ * Set the PHY rate used for ESP-NOW frames on the station interface
+ * @param rate e.g. WIFI_PHY_RATE_24M; WIFI_PHY_RATE_1M_L is the default
+ * @return true if the driver accepted it
+ */
+bool EspNowTx_setPhyRate(wifi_phy_rate_t rate);
+
+/**
+ * Check whether a new frame may go to a peer now
+ * @param mac Peer address (FF:..:FF for broadcast)
+ * @param nowMs Current time (millis)
+ * @return true if nothing is in flight and the interval has elapsed
+ */
+bool EspNowTx_canSend(const uint8_t* mac, uint32_t nowMs);
+
+/**
+ * Send a frame and mark it in flight
+ * @param mac Peer address
+ * @param data Frame
+ * @param len Frame length (max ESP_NOW_MAX_DATA_LEN)
+ * @param nowMs Current time (millis)
+ * @return true if esp_now_send() accepted the frame
+ */
+bool EspNowTx_send(const uint8_t* mac, const uint8_t* data, size_t len,
+                   uint32_t nowMs);
+
+/**
+ * Record a sample that was replaced before it could be sent
+ * @param mac Peer address
+ */
+void EspNowTx_markCoalesced(const uint8_t* mac);
+
+/**
+ * Get statistics for one peer
+ * @param mac Peer address
+ * @param out Output statistics
+ * @return false if the peer has never been used
+ */
+bool EspNowTx_getPeerStats(const uint8_t* mac, EspNowTxStats* out);
+
+/**
+ * Copy statistics for all known peers
+ * @param out Output array
+ * @param maxPeers Capacity of out
+ * @return Number of peers written
+ */
+uint8_t EspNowTx_getAllStats(EspNowTxStats* out, uint8_t maxPeers);
+
+/**
+ * Forget all peers and statistics
+ */
+void EspNowTx_reset(void);
+
+#endif // ESPNOW_TX_H
@@ -1,4 +1,6 @@
 #include "FailsafeManager.h"
+#include "HAL.h"
+#include "Log.h"
 #include <ArduinoJson.h>
 
 FailsafeManager::FailsafeManager()
@@ -9,13 +11,13 @@ FailsafeManager::FailsafeManager()
 void FailsafeManager::setup() {
   pinMode(STATUS_LED_PIN, OUTPUT);
   digitalWrite(STATUS_LED_PIN, LOW);
-  lastPacketTime = millis();
-  stateChangeTime = millis();
+  lastPacketTime = HAL_GetMillis();
+  stateChangeTime = HAL_GetMillis();
 }
 
 void FailsafeManager::recordPacketReceived(uint32_t timestamp, bool hmacValid) {
   if (timestamp == 0)
-    timestamp = millis();
+    timestamp = HAL_GetMillis();
 
   totalPackets++;
   if (!hmacValid) {
@@ -31,7 +33,7 @@ void FailsafeManager::recordPacketReceived(uint32_t timestamp, bool hmacValid) {
 
 void FailsafeManager::update(uint32_t currentTime) {
   if (currentTime == 0)
-    currentTime = millis();
+    currentTime = HAL_GetMillis();
 
   uint32_t timeSincePacket = currentTime - lastPacketTime;
   FailsafeState newState = currentState;
@@ -57,9 +59,43 @@ void FailsafeManager::update(uint32_t currentTime) {
   updateStatusLED(currentTime);
 }
 
+FailsafeAction FailsafeManager::getAction(const FailsafePolicy &policy, bool rtlAvailable,
+                                          bool criticalFault) const {
+  if (criticalFault)
+    return FAILSAFE_ACTION_SURFACE;
+
+  FailsafeAction action;
+  switch (currentState) {
+  case FAILSAFE_ARMED:
+    return FAILSAFE_ACTION_NONE;
+  case FAILSAFE_SIGNAL_LOSS:
+    action = policy.onSignalLoss;
+    break;
+  case FAILSAFE_EMERGENCY:
+    action = policy.onEmergency;
+    break;
+  default:
+    return FAILSAFE_ACTION_NEUTRAL; // No controller yet
+  }
+  if (action == FAILSAFE_ACTION_RTL && !rtlAvailable)
+    return FAILSAFE_ACTION_NEUTRAL;
+  return action;
+}
+
+void FailsafeManager::resume(FailsafeState state, uint32_t sincePacketMs) {
+  if (state == FAILSAFE_IDLE)
+    return; // No controller yet: nothing to carry over
+  uint32_t now = HAL_GetMillis();
+  previousState = currentState;
+  currentState = state;
+  lastPacketTime = now - sincePacketMs;
+  stateChangeTime = now;
+  logStateTransition(now);
+}
+
 uint32_t FailsafeManager::getTimeSinceLastPacket(uint32_t currentTime) const {
   if (currentTime == 0)
-    currentTime = millis();
+    currentTime = HAL_GetMillis();
   return currentTime - lastPacketTime;
 }
 
@@ -109,6 +145,10 @@ void FailsafeManager::logStateTransition(uint32_t currentTime) {
   doc["timeSince"] = currentTime - lastPacketTime;
   doc["badHmac"] = invalidHmacPackets;
 
-  serializeJson(doc, Serial);
-  Serial.println();
+  // Control task: queue the line instead of waiting on the UART
+  char line[LOG_SLOT_SIZE];
+  size_t len = serializeJson(doc, line, sizeof(line) - 1);
+  line[len++] = '\r';
+  line[len++] = '\n';
+  Log_write((const uint8_t *)line, len);
 }
@@ -20,6 +20,24 @@ enum FailsafeState {
   FAILSAFE_EMERGENCY = 3
 };
 
+/**
+ * What the control task does about a failsafe state
+ */
+enum FailsafeAction {
+  FAILSAFE_ACTION_NONE = 0,    // Pilot / mission in control
+  FAILSAFE_ACTION_NEUTRAL = 1, // Throttle and sticks to neutral, no auto
+  FAILSAFE_ACTION_RTL = 2,     // Navigate home (neutral if RTL is unavailable)
+  FAILSAFE_ACTION_SURFACE = 3  // Sub: neutral sticks, depth hold off (ascend)
+};
+
+/**
+ * Per-vehicle response to each failsafe state
+ */
+struct FailsafePolicy {
+  FailsafeAction onSignalLoss;
+  FailsafeAction onEmergency;
+};
+
 class FailsafeManager {
 public:
   FailsafeManager();
@@ -63,6 +81,33 @@ public:
    */
   bool isSignalLost() const { return currentState == FAILSAFE_SIGNAL_LOSS; }
 
+  /**
+   * Packets recorded (valid and invalid HMAC)
+   */
+  uint32_t getTotalPackets() const { return totalPackets; }
+
+  /**
+   * Packets rejected for an invalid HMAC
+   */
+  uint32_t getInvalidHmacPackets() const { return invalidHmacPackets; }
+
+  /**
+   * Action for the current state (evaluated every control tick, so the
+   * response is bounded to one control period)
+   * @param policy Vehicle's failsafe policy
+   * @param rtlAvailable Home set and GPS locked
+   * @param criticalFault Vehicle fault that overrides the link state
+   *        (e.g. Sub water ingress): always SURFACE
+   */
+  FailsafeAction getAction(const FailsafePolicy &policy, bool rtlAvailable,
+                           bool criticalFault) const;
+
+  /**
+   * Pick up the state of the previous run after a warm restart
+   * (the link timers continue from sincePacketMs)
+   */
+  void resume(FailsafeState state, uint32_t sincePacketMs);
+
   /**
    * Get time since last valid packet (milliseconds)
    */
@@ -76,7 +121,7 @@ public:
 private:
   FailsafeState currentState;
   FailsafeState previousState;
-  uint32_t lastPacketTime;
+  volatile uint32_t lastPacketTime; // Radio / comms task write, control task reads
   uint32_t stateChangeTime;
   uint32_t ledBlinkTime;
   uint32_t totalPackets;
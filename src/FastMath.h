@@ -0,0 +1,144 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * FastMath - Single-precision trig / sqrt kernels for nav and control
+ *
+ * The ESP32 FPU is single precision only: any double in an expression
+ * (an M_PI, a DEG_TO_RAD from Arduino.h, a 0.5 literal, cos() instead of
+ * cosf()) runs in software emulation. libm's float functions are correct
+ * to the last bit but pay for it in range reduction and special cases the
+ * control loop never needs.
+ *
+ * - Polynomials on a folded range, float only, no tables, no branches on
+ *   the common path
+ * - Worst-case error is stated below and checked on the host by
+ *   tests/test_FastMath.cpp; all are far below sensor noise (GPS heading
+ *   is good to ~0.5 deg, the estimators to ~1e-3 rad)
+ * - Inputs must be finite; wraps take any finite angle
+ *
+ * Modules that must stay float-only put FAST_MATH_FLOAT_ONLY after their
+ * includes, which turns an implicit float -> double promotion into a
+ * compile error in that translation unit.
+ *
+ * @file FastMath.h
+ */
+
+#define FAST_MATH_PI            3.14159265f
+#define FAST_MATH_TWO_PI        6.28318531f
+#define FAST_MATH_HALF_PI       1.57079633f
+#define FAST_MATH_DEG_TO_RAD    0.0174532925f
+#define FAST_MATH_RAD_TO_DEG    57.2957795f
+
+// Worst-case error over the tested range
+#define FAST_MATH_SIN_MAX_ERR       5e-6f   // sin / cos, absolute
+#define FAST_MATH_ATAN2_MAX_ERR     1e-5f   // radians
+#define FAST_MATH_INV_SQRT_MAX_ERR  5e-6f   // relative
+
+#define FAST_MATH_FLOAT_ONLY _Pragma("GCC diagnostic error \"-Wdouble-promotion\"")
+
+/**
+ * Wrap an angle to [-pi, pi) radians
+ */
+static inline float FastMath_wrapPi(float rad) {
+    if (rad >= -FAST_MATH_PI && rad < FAST_MATH_PI)
+        return rad;
+    float w = rad - FAST_MATH_TWO_PI * floorf((rad + FAST_MATH_PI) * (1.0f / FAST_MATH_TWO_PI));
+    // Rounding of large inputs can land a hair outside
+    if (w >= FAST_MATH_PI) w -= FAST_MATH_TWO_PI;
+    else if (w < -FAST_MATH_PI) w += FAST_MATH_TWO_PI;
+    return w;
+}
+
+/**
+ * Wrap an angle to [-180, 180) degrees
+ */
+static inline float FastMath_wrap180(float deg) {
+    if (deg >= -180.0f && deg < 180.0f)
+        return deg;
+    float w = deg - 360.0f * floorf((deg + 180.0f) * (1.0f / 360.0f));
+    if (w >= 180.0f) w -= 360.0f;
+    else if (w < -180.0f) w += 360.0f;
+    return w;
+}
+
+/**
+ * Sine, any finite angle in radians (FAST_MATH_SIN_MAX_ERR)
+ */
+static inline float FastMath_sin(float rad) {
+    float x = FastMath_wrapPi(rad);
+    // Fold into [-pi/2, pi/2] where the series converges fastest
+    if (x > FAST_MATH_HALF_PI)
+        x = FAST_MATH_PI - x;
+    else if (x < -FAST_MATH_HALF_PI)
+        x = -FAST_MATH_PI - x;
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-1.66666667e-1f + x2 * (8.33333333e-3f +
+                x2 * (-1.98412698e-4f + x2 * 2.75573192e-6f))));
+}
+
+/**
+ * Cosine, any finite angle in radians (FAST_MATH_SIN_MAX_ERR)
+ */
+static inline float FastMath_cos(float rad) {
+    return FastMath_sin(rad + FAST_MATH_HALF_PI);
+}
+
+/**
+ * Sine and cosine of one angle
+ */
+static inline void FastMath_sinCos(float rad, float* s, float* c) {
+    *s = FastMath_sin(rad);
+    *c = FastMath_cos(rad);
+}
+
+/**
+ * Four-quadrant arctangent in radians, (-pi, pi] (FAST_MATH_ATAN2_MAX_ERR)
+ * @return 0 for (0, 0), like atan2f
+ */
+static inline float FastMath_atan2(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float hi = ax > ay ? ax : ay;
+    float lo = ax > ay ? ay : ax;
+    if (hi == 0.0f)
+        return 0.0f;
+    // atan on [0, 1], odd minimax polynomial
+    float z = lo / hi;
+    float z2 = z * z;
+    float a = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f +
+              z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+    if (ay > ax)
+        a = FAST_MATH_HALF_PI - a;
+    if (x < 0.0f)
+        a = FAST_MATH_PI - a;
+    return y < 0.0f ? -a : a;
+}
+
+/**
+ * 1 / sqrt(x) for x > 0 (FAST_MATH_INV_SQRT_MAX_ERR, relative):
+ * bit-level first guess, two Newton steps
+ */
+static inline float FastMath_invSqrt(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5F375A86u - (bits >> 1);
+    float y;
+    memcpy(&y, &bits, sizeof(y));
+    float half = 0.5f * x;
+    y = y * (1.5f - half * y * y);
+    y = y * (1.5f - half * y * y);
+    return y;
+}
+
+/**
+ * sqrt(x) from invSqrt, 0 for x <= 0
+ */
+static inline float FastMath_sqrt(float x) {
+    return x > 0.0f ? x * FastMath_invSqrt(x) : 0.0f;
+}
+
+#endif // FAST_MATH_H
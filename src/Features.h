@@ -0,0 +1,94 @@
+#ifndef FEATURES_H
+#define FEATURES_H
+
+/**
+ * Features - Compile-time subsystem selection
+ *
+ * Each FEATURE_* is 1 (built) or 0 (compiled out: its boot stage does
+ * nothing, its task work and commands are gone and the linker drops the
+ * driver). A VEHICLE_TYPE_* build turns off the sensors its hull cannot
+ * carry; a build without one keeps everything, since the vehicle is
+ * only known at boot. Any flag can be set with -DFEATURE_X=0/1.
+ *
+ *   FEATURE_DEPTH  MS5837 depth sensor and depth hold (Sub)
+ *   FEATURE_PITOT  MS4525 airspeed for the energy controller (Plane)
+ *   FEATURE_MAG    QMC5883L magnetometer: calibrated heading at standstill
+ *   FEATURE_BARO   MS5611 barometer: altitude hold (Copter), energy
+ *                  controller height (Plane)
+ *   FEATURE_RANGE  Forward ultrasonic rangefinder: obstacle slow-down
+ *                  (Rover)
+ *   FEATURE_GPS    GPS receiver task
+ *   FEATURE_WEB    HTTP server: /ws telemetry and control, configurator,
+ *                  /log download, /metrics
+ *   FEATURE_OTA    Firmware download over Wi-Fi (start_ota_update)
+ *   FEATURE_BLE    BLE telemetry / command link for phones (set_ble).
+ *                  Off by default: Bluedroid adds several hundred KB of
+ *                  flash and ~40 KB of heap; a build with it on may need
+ *                  FEATURE_OTA=0 or a larger app partition
+ *
+ * The key exchange stays in every build: the radio link's session keys
+ * come from it.
+ *
+ * @file Features.h
+ */
+
+#if defined(VEHICLE_TYPE_ROVER) || defined(VEHICLE_TYPE_PLANE) || \
+    defined(VEHICLE_TYPE_SUB) || defined(VEHICLE_TYPE_COPTER)
+#define FEATURES_VEHICLE_FIXED 1
+#else
+#define FEATURES_VEHICLE_FIXED 0
+#endif
+
+#ifndef FEATURE_DEPTH
+#if !FEATURES_VEHICLE_FIXED || defined(VEHICLE_TYPE_SUB)
+#define FEATURE_DEPTH 1
+#else
+#define FEATURE_DEPTH 0
+#endif
+#endif
+
+#ifndef FEATURE_PITOT
+#if !FEATURES_VEHICLE_FIXED || defined(VEHICLE_TYPE_PLANE)
+#define FEATURE_PITOT 1
+#else
+#define FEATURE_PITOT 0
+#endif
+#endif
+
+#ifndef FEATURE_MAG
+#define FEATURE_MAG 1
+#endif
+
+#ifndef FEATURE_BARO
+#if !FEATURES_VEHICLE_FIXED || defined(VEHICLE_TYPE_PLANE) || defined(VEHICLE_TYPE_COPTER)
+#define FEATURE_BARO 1
+#else
+#define FEATURE_BARO 0
+#endif
+#endif
+
+#ifndef FEATURE_RANGE
+#if !FEATURES_VEHICLE_FIXED || defined(VEHICLE_TYPE_ROVER)
+#define FEATURE_RANGE 1
+#else
+#define FEATURE_RANGE 0
+#endif
+#endif
+
+#ifndef FEATURE_GPS
+#define FEATURE_GPS 1
+#endif
+
+#ifndef FEATURE_WEB
+#define FEATURE_WEB 1
+#endif
+
+#ifndef FEATURE_OTA
+#define FEATURE_OTA 1
+#endif
+
+#ifndef FEATURE_BLE
+#define FEATURE_BLE 0
+#endif
+
+#endif // FEATURES_H
@@ -0,0 +1,193 @@
+#include "FleetOta.h"
+#include <string.h>
+
+/**
+ * FleetOta - Implementation
+ *
+ * @file FleetOta.cpp
+ */
+
+#define NACK_BYTES (FLEET_OTA_NACK_BITS / 8)
+
+static bool testBit(const uint8_t* bits, uint16_t i) {
+    return bits[i >> 3] & (1u << (i & 7));
+}
+
+uint16_t FleetOta_chunkCount(uint32_t imageSize) {
+    uint32_t n = (imageSize + FLEET_OTA_CHUNK_SIZE - 1) / FLEET_OTA_CHUNK_SIZE;
+    return n > FLEET_OTA_MAX_CHUNKS ? 0 : (uint16_t)n;
+}
+
+uint16_t FleetOta_chunkLength(uint32_t imageSize, uint16_t index) {
+    uint32_t offset = (uint32_t)index * FLEET_OTA_CHUNK_SIZE;
+    if (offset >= imageSize) return 0;
+    uint32_t left = imageSize - offset;
+    return left < FLEET_OTA_CHUNK_SIZE ? (uint16_t)left : FLEET_OTA_CHUNK_SIZE;
+}
+
+// ============================================================================
+// Receiver
+// ============================================================================
+
+void FleetOtaRx_init(FleetOtaRx* rx) {
+    memset(rx, 0, sizeof(*rx));
+}
+
+bool FleetOtaRx_begin(FleetOtaRx* rx, uint32_t imageId, uint32_t imageSize, uint32_t nowMs) {
+    FleetOtaRx_init(rx);
+    rx->chunkCount = FleetOta_chunkCount(imageSize);
+    if (rx->chunkCount == 0) return false;
+    // Bits past the last chunk count as present, so gap searches stop there
+    if (rx->chunkCount & 7)
+        rx->have[rx->chunkCount >> 3] = (uint8_t)(0xFF << (rx->chunkCount & 7));
+    rx->imageId = imageId;
+    rx->imageSize = imageSize;
+    rx->lastChunkMs = nowMs;
+    rx->nackHoldMs = nowMs;
+    rx->active = true;
+    return true;
+}
+
+FleetChunkResult FleetOtaRx_accept(FleetOtaRx* rx, uint32_t imageId, uint16_t index,
+                                   uint32_t nowMs) {
+    if (!rx->active || imageId != rx->imageId || index >= rx->chunkCount)
+        return FLEET_CHUNK_FOREIGN;
+    rx->lastChunkMs = nowMs;
+    if (testBit(rx->have, index)) {
+        rx->duplicates++;
+        return FLEET_CHUNK_DUPLICATE;
+    }
+    rx->have[index >> 3] |= 1u << (index & 7);
+    rx->received++;
+    return FLEET_CHUNK_NEW;
+}
+
+void FleetOtaRx_drop(FleetOtaRx* rx, uint16_t index) {
+    if (index >= rx->chunkCount || !testBit(rx->have, index)) return;
+    rx->have[index >> 3] &= ~(1u << (index & 7));
+    rx->received--;
+}
+
+bool FleetOtaRx_complete(const FleetOtaRx* rx) {
+    return rx->active && rx->received == rx->chunkCount;
+}
+
+// First chunk of the byte holding the first gap at or after from, -1 if none
+static int32_t firstGap(const FleetOtaRx* rx, uint16_t from) {
+    uint16_t bytes = (rx->chunkCount + 7) / 8;
+    for (uint16_t byte = from / 8; byte < bytes; byte++)
+        if (rx->have[byte] != 0xFF) return byte * 8;
+    return -1;
+}
+
+// Gaps of the window starting at base, bit set = missing
+static void windowBits(const FleetOtaRx* rx, uint16_t base, uint8_t* bits) {
+    for (uint16_t j = 0; j < NACK_BYTES; j++) {
+        uint32_t first = (uint32_t)base + j * 8;
+        bits[j] = first < rx->chunkCount ? (uint8_t)~rx->have[first / 8] : 0;
+    }
+}
+
+// Window reported (or skipped): on to the next gap, or end the burst
+static void nextWindow(FleetOtaRx* rx, uint32_t from, uint32_t nowMs) {
+    if (from < rx->chunkCount && firstGap(rx, (uint16_t)from) >= 0) {
+        rx->nackBase = (uint16_t)from;
+        rx->nackDueMs = nowMs + FLEET_OTA_NACK_GAP_MS;
+    } else {
+        rx->nackScheduled = false;
+        rx->nackHoldMs = nowMs + FLEET_OTA_NACK_RETRY_MS;
+    }
+}
+
+bool FleetOtaRx_poll(FleetOtaRx* rx, uint32_t nowMs, uint32_t random, uint16_t* base,
+                     uint8_t* bits) {
+    if (!rx->active || FleetOtaRx_complete(rx)) return false;
+    if (!rx->nackScheduled) {
+        if (nowMs - rx->lastChunkMs < FLEET_OTA_QUIET_MS ||
+            (int32_t)(nowMs - rx->nackHoldMs) < 0)
+            return false;
+        rx->nackScheduled = true;
+        rx->nackBase = 0;
+        rx->nackDueMs = nowMs + random % FLEET_OTA_NACK_JITTER_MS;
+    }
+    if ((int32_t)(nowMs - rx->nackDueMs) < 0) return false;
+
+    // Gaps past the cursor may have been filled meanwhile; one is left somewhere
+    int32_t gap = firstGap(rx, rx->nackBase);
+    if (gap < 0) gap = firstGap(rx, 0);
+    *base = (uint16_t)gap;
+    windowBits(rx, *base, bits);
+    nextWindow(rx, (uint32_t)gap + FLEET_OTA_NACK_BITS, nowMs);
+    rx->nacksSent++;
+    return true;
+}
+
+void FleetOtaRx_overhear(FleetOtaRx* rx, uint32_t imageId, uint16_t base, const uint8_t* bits,
+                         uint32_t nowMs) {
+    if (!rx->active || imageId != rx->imageId || !rx->nackScheduled) return;
+    if (firstGap(rx, rx->nackBase) != base) return;
+    uint8_t ours[NACK_BYTES];
+    windowBits(rx, base, ours);
+    for (uint16_t j = 0; j < NACK_BYTES; j++)
+        if (ours[j] & ~bits[j]) return;         // Something only we miss
+    nextWindow(rx, (uint32_t)base + FLEET_OTA_NACK_BITS, nowMs);
+    rx->nacksSuppressed++;
+}
+
+// ============================================================================
+// Sender
+// ============================================================================
+
+void FleetOtaTx_init(FleetOtaTx* tx) {
+    memset(tx, 0, sizeof(*tx));
+}
+
+bool FleetOtaTx_begin(FleetOtaTx* tx, uint32_t imageSize) {
+    FleetOtaTx_init(tx);
+    tx->chunkCount = FleetOta_chunkCount(imageSize);
+    if (tx->chunkCount == 0) return false;
+    tx->imageSize = imageSize;
+    memset(tx->pending, 0xFF, (tx->chunkCount + 7) / 8);
+    if (tx->chunkCount & 7)
+        tx->pending[tx->chunkCount >> 3] = (1u << (tx->chunkCount & 7)) - 1;
+    tx->pendingCount = tx->chunkCount;
+    return true;
+}
+
+bool FleetOtaTx_next(FleetOtaTx* tx, uint16_t* index) {
+    if (tx->pendingCount == 0) return false;
+    uint16_t i = tx->cursor;
+    for (;;) {
+        if (i >= tx->chunkCount) i = 0;
+        // Skip empty bytes whole
+        if ((i & 7) == 0 && tx->pending[i >> 3] == 0) {
+            i += 8;
+            continue;
+        }
+        if (testBit(tx->pending, i)) break;
+        i++;
+    }
+    tx->pending[i >> 3] &= ~(1u << (i & 7));
+    tx->pendingCount--;
+    tx->cursor = i + 1;
+    tx->sent++;
+    *index = i;
+    return true;
+}
+
+uint16_t FleetOtaTx_nack(FleetOtaTx* tx, uint16_t base, const uint8_t* bits) {
+    tx->nacks++;
+    bool idle = tx->pendingCount == 0;
+    uint16_t queued = 0;
+    for (uint16_t i = 0; i < FLEET_OTA_NACK_BITS; i++) {
+        uint32_t chunk = (uint32_t)base + i;
+        if (chunk >= tx->chunkCount) break;
+        if (!testBit(bits, i) || testBit(tx->pending, chunk)) continue;
+        tx->pending[chunk >> 3] |= 1u << (chunk & 7);
+        tx->pendingCount++;
+        queued++;
+    }
+    if (idle && queued > 0) tx->round++;
+    tx->repairs += queued;
+    return queued;
+}
@@ -0,0 +1,169 @@
+#ifndef FLEET_OTA_H
+#define FLEET_OTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * FleetOta - One-to-many firmware distribution with NACK repair
+ *
+ * One vehicle serves the image it runs to every vehicle in radio range
+ * at once (ESP-NOW broadcast, NAFleetOta.h). The image is cut into
+ * FLEET_OTA_CHUNK_SIZE chunks, each sent once per pass; receivers write
+ * whatever arrives straight into place and keep one bit per chunk.
+ *
+ * Repair (no FEC): once the sender has been quiet for FLEET_OTA_QUIET_MS,
+ * a receiver still missing chunks reports them in a burst of NACKs, one
+ * per FLEET_OTA_NACK_BITS-chunk window with gaps, FLEET_OTA_NACK_GAP_MS
+ * apart. The burst starts after a random delay of up to
+ * FLEET_OTA_NACK_JITTER_MS; a receiver that overhears a NACK already
+ * asking for all of its own gaps in the window it is about to report
+ * skips that window (the resent chunks reach everyone), so receivers
+ * sharing the same losses mostly report them once. After a burst the
+ * receiver waits for the resends to finish (quiet again), and at least
+ * FLEET_OTA_NACK_RETRY_MS, before the next one.
+ *
+ * The sender keeps a pending bit per chunk: the first pass sets them all,
+ * a NACK sets its bits again, and chunks are taken in order from a
+ * wrapping cursor, so repair runs interleave with whatever is left.
+ *
+ * Pure: no globals, no RTOS, no radio. Integrity is not checked here:
+ * the receiver verifies the whole image's SHA-256 and its signature.
+ *
+ * @file FleetOta.h
+ */
+
+#define FLEET_OTA_CHUNK_SIZE        200     // Image bytes per frame
+#ifndef FLEET_OTA_MAX_CHUNKS
+#define FLEET_OTA_MAX_CHUNKS        10240   // 2 MB: the largest app partition
+#endif
+#define FLEET_OTA_NACK_BITS         256     // Chunks per NACK window
+#define FLEET_OTA_QUIET_MS          300     // No chunk for this long: the pass is over
+#define FLEET_OTA_NACK_JITTER_MS    200     // Spread of burst starts over receivers
+#define FLEET_OTA_NACK_GAP_MS       20      // Between the NACKs of one burst
+#define FLEET_OTA_NACK_RETRY_MS     500     // From the end of one burst to the next
+
+/**
+ * Receiver: which chunks of the image are in place
+ */
+typedef struct {
+    uint32_t imageId;
+    uint32_t imageSize;
+    uint16_t chunkCount;
+    uint16_t received;
+    uint8_t have[FLEET_OTA_MAX_CHUNKS / 8];
+    uint32_t lastChunkMs;       // Any chunk of this image, duplicates too
+    uint32_t nackDueMs;         // Next NACK of the running burst
+    uint32_t nackHoldMs;        // No new burst before this
+    uint16_t nackBase;          // Report gaps from here on in this burst
+    bool nackScheduled;         // Burst running
+    bool active;
+
+    // Statistics
+    uint32_t duplicates;
+    uint32_t nacksSent;
+    uint32_t nacksSuppressed;   // Windows skipped for an overheard NACK
+} FleetOtaRx;
+
+/**
+ * Sender: which chunks are still to go out
+ */
+typedef struct {
+    uint32_t imageSize;
+    uint16_t chunkCount;
+    uint16_t pendingCount;
+    uint16_t cursor;            // Next chunk to look at
+    uint16_t round;             // 0 = first pass, then one per repair burst
+    uint8_t pending[FLEET_OTA_MAX_CHUNKS / 8];
+
+    // Statistics
+    uint32_t sent;
+    uint32_t nacks;
+    uint32_t repairs;           // Chunks queued again by NACKs
+} FleetOtaTx;
+
+typedef enum {
+    FLEET_CHUNK_NEW = 0,        // Write it
+    FLEET_CHUNK_DUPLICATE,
+    FLEET_CHUNK_FOREIGN         // Other image, out of range or not receiving
+} FleetChunkResult;
+
+/**
+ * Chunks needed for an image
+ * @return 0 if the image is empty or larger than FLEET_OTA_MAX_CHUNKS
+ */
+uint16_t FleetOta_chunkCount(uint32_t imageSize);
+
+/**
+ * Image bytes carried by one chunk (the last one may be short)
+ */
+uint16_t FleetOta_chunkLength(uint32_t imageSize, uint16_t index);
+
+// ============================================================================
+// Receiver
+// ============================================================================
+
+void FleetOtaRx_init(FleetOtaRx* rx);
+
+/**
+ * Start collecting an image (everything missing)
+ * @return false if the image size is out of range
+ */
+bool FleetOtaRx_begin(FleetOtaRx* rx, uint32_t imageId, uint32_t imageSize, uint32_t nowMs);
+
+/**
+ * A chunk arrived; marks it in place when new
+ */
+FleetChunkResult FleetOtaRx_accept(FleetOtaRx* rx, uint32_t imageId, uint16_t index,
+                                   uint32_t nowMs);
+
+/**
+ * Take back a chunk that could not be written (asked for again)
+ */
+void FleetOtaRx_drop(FleetOtaRx* rx, uint16_t index);
+
+bool FleetOtaRx_complete(const FleetOtaRx* rx);
+
+/**
+ * Decide whether to send a NACK now (call every few ms)
+ * @param random Any random value, spreads the start of a burst
+ * @param base First chunk of the window asked for (a multiple of 8)
+ * @param bits FLEET_OTA_NACK_BITS / 8 bytes, bit set = missing; chunks
+ *        past the end of the image are never set
+ * @return true if a NACK should be sent
+ */
+bool FleetOtaRx_poll(FleetOtaRx* rx, uint32_t nowMs, uint32_t random, uint16_t* base,
+                     uint8_t* bits);
+
+/**
+ * Another receiver's NACK: skip our report of the same window if it
+ * already asks for all we miss there
+ */
+void FleetOtaRx_overhear(FleetOtaRx* rx, uint32_t imageId, uint16_t base, const uint8_t* bits,
+                         uint32_t nowMs);
+
+// ============================================================================
+// Sender
+// ============================================================================
+
+void FleetOtaTx_init(FleetOtaTx* tx);
+
+/**
+ * Queue a full pass of an image
+ * @return false if the image size is out of range
+ */
+bool FleetOtaTx_begin(FleetOtaTx* tx, uint32_t imageSize);
+
+/**
+ * Next chunk to send, taken off the pending set
+ * @return false if nothing is pending
+ */
+bool FleetOtaTx_next(FleetOtaTx* tx, uint16_t* index);
+
+/**
+ * Queue the chunks a NACK asks for
+ * @return Chunks that were not already pending
+ */
+uint16_t FleetOtaTx_nack(FleetOtaTx* tx, uint16_t base, const uint8_t* bits);
+
+#endif // FLEET_OTA_H
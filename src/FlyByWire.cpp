@@ -0,0 +1,146 @@
+#include "FlyByWire.h"
+#include "FastMath.h"
+#include <string.h>
+
+/**
+ * FlyByWire - Implementation
+ *
+ * @file FlyByWire.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+#define GRAVITY_MPS2    9.80665f
+#define D_CUTOFF_HZ     30.0f
+#define I_LIMIT         0.3f        // Surface units: trim the integrator may hold
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void buildGains(const FbwConfig* config, PIDGains* gains) {
+    gains->kp = config->rateKp;
+    gains->ki = config->rateKi;
+    gains->kd = config->rateKd;
+    gains->kff = config->rateKff;
+    gains->dCutoffHz = D_CUTOFF_HZ;
+    gains->iLimit = I_LIMIT;
+    gains->outLimit = 1.0f;
+}
+
+static float maxRate(const FbwConfig* config, int axis) {
+    return (axis == FBW_AXIS_ROLL ? config->maxRollRateDps : config->maxPitchRateDps) *
+           FAST_MATH_DEG_TO_RAD;
+}
+
+// ============================================================================
+// Config
+// ============================================================================
+
+void FlyByWire_defaultConfig(FbwConfig* config) {
+    config->enabled = true;
+    config->maxBankDeg = 45.0f;
+    config->maxPitchDeg = 20.0f;
+    config->angleGain = 4.0f;
+    config->maxRollRateDps = 120.0f;
+    config->maxPitchRateDps = 60.0f;
+    config->rateKp = 0.5f;
+    config->rateKi = 0.3f;
+    config->rateKd = 0.01f;
+    config->rateKff = 0.4f;
+    config->cruiseMps = 12.0f;
+    config->rudderMix = 0.2f;
+    config->turnYawGain = 0.5f;
+    config->slewPerSec = 4.0f;
+}
+
+void FlyByWire_sanitize(FbwConfig* config) {
+    config->maxBankDeg = clampf(config->maxBankDeg, 5.0f, 70.0f);
+    config->maxPitchDeg = clampf(config->maxPitchDeg, 5.0f, 45.0f);
+    config->angleGain = clampf(config->angleGain, 0.1f, 20.0f);
+    config->maxRollRateDps = clampf(config->maxRollRateDps, 10.0f, 360.0f);
+    config->maxPitchRateDps = clampf(config->maxPitchRateDps, 10.0f, 360.0f);
+    config->rateKp = clampf(config->rateKp, 0.0f, 10.0f);
+    config->rateKi = clampf(config->rateKi, 0.0f, 10.0f);
+    config->rateKd = clampf(config->rateKd, 0.0f, 1.0f);
+    config->rateKff = clampf(config->rateKff, 0.0f, 2.0f);
+    config->cruiseMps = clampf(config->cruiseMps, FBW_MIN_SPEED_MPS, 60.0f);
+    config->rudderMix = clampf(config->rudderMix, -1.0f, 1.0f);
+    config->turnYawGain = clampf(config->turnYawGain, 0.0f, 5.0f);
+    config->slewPerSec = clampf(config->slewPerSec, 0.0f, 100.0f);
+}
+
+void FlyByWire_init(FlyByWire* fbw, const FbwConfig* config) {
+    memset(fbw, 0, sizeof(*fbw));
+    fbw->config = *config;
+    buildGains(config, &fbw->gains);
+}
+
+void FlyByWire_setConfig(FlyByWire* fbw, const FbwConfig* config) {
+    PIDGains next;
+    buildGains(config, &next);
+    for (int a = 0; a < FBW_AXIS_COUNT; a++) {
+        PIDGains gains = fbw->gains;
+        PID_setGains(&gains, &fbw->state[a], &next);
+    }
+    fbw->gains = next;
+    fbw->config = *config;
+}
+
+void FlyByWire_reset(FlyByWire* fbw) {
+    for (int a = 0; a < FBW_AXIS_COUNT; a++) PID_reset(&fbw->state[a]);
+}
+
+// ============================================================================
+// Loops
+// ============================================================================
+
+void FlyByWire_updateAngle(FlyByWire* fbw, float rollCmd, float pitchCmd, float roll,
+                           float pitch, float speedMps) {
+    const FbwConfig* c = &fbw->config;
+    float bankSp = clampf(rollCmd, -1.0f, 1.0f) * c->maxBankDeg * FAST_MATH_DEG_TO_RAD;
+    float pitchSp = clampf(pitchCmd, -1.0f, 1.0f) * c->maxPitchDeg * FAST_MATH_DEG_TO_RAD;
+
+    // Turn at the current bank: psi' = g tan(phi) / V
+    float maxTurnBank = FBW_MAX_TURN_BANK_DEG * FAST_MATH_DEG_TO_RAD;
+    float phi = clampf(roll, -maxTurnBank, maxTurnBank);
+    float s, co;
+    FastMath_sinCos(phi, &s, &co);
+    float v = speedMps >= FBW_MIN_SPEED_MPS ? speedMps : c->cruiseMps;
+    float turnRate = GRAVITY_MPS2 * s / (co * v);
+    fbw->turnYawRate = turnRate * co;
+
+    float rollRate = c->angleGain * (bankSp - roll);
+    float pitchRate = c->angleGain * (pitchSp - pitch) + turnRate * s;
+    float rollMax = maxRate(c, FBW_AXIS_ROLL), pitchMax = maxRate(c, FBW_AXIS_PITCH);
+    fbw->rateSetpoint[FBW_AXIS_ROLL] = clampf(rollRate, -rollMax, rollMax);
+    fbw->rateSetpoint[FBW_AXIS_PITCH] = clampf(pitchRate, -pitchMax, pitchMax);
+}
+
+void FlyByWire_updateRate(FlyByWire* fbw, const float rates[FBW_AXIS_COUNT], float dt,
+                          bool integrate) {
+    for (int a = 0; a < FBW_AXIS_COUNT; a++) {
+        float scale = 1.0f / maxRate(&fbw->config, a);
+        fbw->rateOutput[a] = PID_update(&fbw->gains, &fbw->state[a],
+                                        fbw->rateSetpoint[a] * scale, rates[a] * scale, dt,
+                                        integrate);
+    }
+}
+
+void FlyByWire_output(FlyByWire* fbw, float yawCmd, float dt, float out[FBW_SURFACE_COUNT]) {
+    const FbwConfig* c = &fbw->config;
+    float target[FBW_SURFACE_COUNT];
+    target[FBW_SURFACE_AILERON] = fbw->rateOutput[FBW_AXIS_ROLL];
+    target[FBW_SURFACE_ELEVATOR] = fbw->rateOutput[FBW_AXIS_PITCH];
+    target[FBW_SURFACE_RUDDER] = clampf(yawCmd + c->rudderMix * target[FBW_SURFACE_AILERON] +
+                                            c->turnYawGain * fbw->turnYawRate,
+                                        -1.0f, 1.0f);
+
+    float step = c->slewPerSec * dt;
+    for (int i = 0; i < FBW_SURFACE_COUNT; i++) {
+        float next = target[i];
+        if (step > 0.0f) next = clampf(next, fbw->surface[i] - step, fbw->surface[i] + step);
+        fbw->surface[i] = next;
+        out[i] = next;
+    }
+}
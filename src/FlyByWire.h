@@ -0,0 +1,125 @@
+#ifndef FLY_BY_WIRE_H
+#define FLY_BY_WIRE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "PIDController.h"
+
+/**
+ * FlyByWire - Stabilized fixed-wing attitude control
+ *
+ * Sticks (or the navigation steering on the roll channel) command bank
+ * and pitch angle instead of surface deflection:
+ *
+ *   stick -> angle setpoint (+-maxBank / +-maxPitch)
+ *         -> angle P (angleGain, 1/s) -> rate setpoint (+-maxRate)
+ *         -> rate PID per axis -> aileron / elevator
+ *
+ * - Coordinated turn: at bank phi and airspeed V the turn rate is
+ *   g tan(phi) / V; its body pitch component (psi' sin phi) is fed into
+ *   the pitch rate setpoint so the nose holds up in the turn, its yaw
+ *   component (psi' cos phi) plus a share of the aileron drives the
+ *   rudder (adverse-yaw mix) on top of the pilot's yaw
+ * - The rate loop is separate so it can run at the IMU sample rate;
+ *   the angle loop and the servo write run at the control rate
+ * - Surfaces are slew limited (slewPerSec, in -1..1 units per second):
+ *   protects servos and gearing from loop noise and stick steps
+ * - Rate errors are normalized by maxRate, so the PID gains are in
+ *   surface units per full-rate error, as in RateController
+ *
+ * Axis conventions: roll + = right side down, pitch + = nose up, rudder
+ * + = nose right. Plain struct, no hardware.
+ *
+ * @file FlyByWire.h
+ */
+
+#define FBW_AXIS_ROLL       0
+#define FBW_AXIS_PITCH      1
+#define FBW_AXIS_COUNT      2
+
+#define FBW_SURFACE_AILERON     0
+#define FBW_SURFACE_ELEVATOR    1
+#define FBW_SURFACE_RUDDER      2
+#define FBW_SURFACE_COUNT       3
+
+#define FBW_MAX_TURN_BANK_DEG   60.0f   // Turn coordination stops growing here
+#define FBW_MIN_SPEED_MPS       3.0f    // Slower readings use cruiseMps
+#define FBW_CONFIG_KEY          "cfg_fbw"
+
+typedef struct {
+    bool enabled;               // false = sticks straight to the surfaces
+    float maxBankDeg;           // Full roll stick
+    float maxPitchDeg;          // Full pitch stick
+    float angleGain;            // Rate setpoint per angle error, 1/s
+    float maxRollRateDps;
+    float maxPitchRateDps;
+    float rateKp;               // Rate loop, both axes
+    float rateKi;
+    float rateKd;
+    float rateKff;              // Surface per normalized rate setpoint
+    float cruiseMps;            // Airspeed for turn coordination without a reading
+    float rudderMix;            // Rudder per aileron
+    float turnYawGain;          // Rudder per rad/s of coordinated yaw rate
+    float slewPerSec;           // Surface change limit, 0 = none
+} FbwConfig;
+
+typedef struct {
+    FbwConfig config;
+    PIDGains gains;             // Rate loop (shared by both axes)
+    PIDState state[FBW_AXIS_COUNT];
+    float rateSetpoint[FBW_AXIS_COUNT];     // rad/s
+    float turnYawRate;          // Coordinated yaw rate, rad/s
+    float rateOutput[FBW_AXIS_COUNT];       // Last rate loop outputs
+    float surface[FBW_SURFACE_COUNT];       // Slewed outputs, -1..1
+} FlyByWire;
+
+/**
+ * Default: on, 45 deg bank, 20 deg pitch, angle gain 4, 120 / 60 deg/s,
+ * rate PID 0.5 / 0.3 / 0.01 with FF 0.4, 12 m/s cruise, rudder mix 0.2,
+ * turn yaw gain 0.5, slew 4 per second (full throw in 0.25 s)
+ */
+void FlyByWire_defaultConfig(FbwConfig* config);
+
+void FlyByWire_sanitize(FbwConfig* config);
+
+void FlyByWire_init(FlyByWire* fbw, const FbwConfig* config);
+
+/**
+ * Replace the configuration without a step in the surfaces
+ */
+void FlyByWire_setConfig(FlyByWire* fbw, const FbwConfig* config);
+
+/**
+ * Zero the integrators (e.g. disarmed, on the ground)
+ */
+void FlyByWire_reset(FlyByWire* fbw);
+
+/**
+ * Angle loop: sticks and attitude to rate setpoints
+ * @param rollCmd Bank command, -1..1
+ * @param pitchCmd Pitch command, -1..1
+ * @param roll Bank angle, rad
+ * @param pitch Pitch angle (nose up), rad
+ * @param speedMps Airspeed, 0 = unknown (cruiseMps)
+ */
+void FlyByWire_updateAngle(FlyByWire* fbw, float rollCmd, float pitchCmd, float roll,
+                           float pitch, float speedMps);
+
+/**
+ * Rate loop (each gyro sample)
+ * @param rates Body rates, roll right / pitch up, rad/s
+ * @param dt Sample period, s
+ * @param integrate false to hold the integrators
+ */
+void FlyByWire_updateRate(FlyByWire* fbw, const float rates[FBW_AXIS_COUNT], float dt,
+                          bool integrate);
+
+/**
+ * Surfaces from the last rate loop outputs, slew limited
+ * @param yawCmd Pilot rudder, -1..1
+ * @param dt Time since the previous call, s
+ * @param out Aileron, elevator, rudder, -1..1
+ */
+void FlyByWire_output(FlyByWire* fbw, float yawCmd, float dt, float out[FBW_SURFACE_COUNT]);
+
+#endif // FLY_BY_WIRE_H
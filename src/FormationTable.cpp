@@ -0,0 +1,132 @@
+#include "FormationTable.h"
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+FAST_MATH_FLOAT_ONLY
+
+/**
+ * FormationTable - Implementation
+ *
+ * Eight entries: a linear MAC scan is cheaper than hashing and runs in
+ * the telemetry task, not the receive callback.
+ *
+ * @file FormationTable.cpp
+ */
+
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static int find_index(const FormationTable* table, const uint8_t* mac) {
+    for (int i = 0; i < FORMATION_MAX_NEIGHBORS; i++) {
+        const FormationNeighbor* n = &table->neighbors[i];
+        if (n->used && memcmp(n->mac, mac, FORMATION_MAC_SIZE) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void FormationTable_init(FormationTable* table) {
+    memset(table, 0, sizeof(*table));
+}
+
+bool FormationTable_isLive(const FormationNeighbor* neighbor, uint32_t nowMs) {
+    return neighbor->used && nowMs - neighbor->lastSeenMs < FORMATION_NEIGHBOR_TIMEOUT_MS;
+}
+
+FormationRxResult FormationTable_update(FormationTable* table, const uint8_t* mac,
+                                        uint32_t sequence, const FormationState* state,
+                                        uint32_t nowMs) {
+    FormationRxResult result = FORMATION_RX_UPDATED;
+    int i = find_index(table, mac);
+
+    if (i >= 0 && FormationTable_isLive(&table->neighbors[i], nowMs)) {
+        if ((int32_t)(sequence - table->neighbors[i].sequence) <= 0) {
+            table->stale++;
+            return FORMATION_RX_STALE;
+        }
+    } else {
+        // Unknown or timed out (may have rebooted): its own old entry,
+        // else a free one, else the one silent the longest
+        if (i < 0) {
+            for (int k = 0; k < FORMATION_MAX_NEIGHBORS; k++) {
+                const FormationNeighbor* n = &table->neighbors[k];
+                if (FormationTable_isLive(n, nowMs))
+                    continue;
+                if (i < 0 || !n->used ||
+                    (table->neighbors[i].used &&
+                     (int32_t)(n->lastSeenMs - table->neighbors[i].lastSeenMs) < 0))
+                    i = k;
+            }
+        }
+        if (i < 0) {
+            table->dropped++;
+            return FORMATION_RX_FULL;
+        }
+        FormationNeighbor* n = &table->neighbors[i];
+        memset(n, 0, sizeof(*n));
+        memcpy(n->mac, mac, FORMATION_MAC_SIZE);
+        n->used = true;
+        result = FORMATION_RX_NEW;
+    }
+
+    FormationNeighbor* n = &table->neighbors[i];
+    n->sequence = sequence;
+    n->lastSeenMs = nowMs;
+    n->beacons++;
+    n->state = *state;
+    return result;
+}
+
+const FormationNeighbor* FormationTable_find(const FormationTable* table, const uint8_t* mac,
+                                             uint32_t nowMs) {
+    int i = find_index(table, mac);
+    if (i < 0 || !FormationTable_isLive(&table->neighbors[i], nowMs))
+        return NULL;
+    return &table->neighbors[i];
+}
+
+uint8_t FormationTable_liveCount(const FormationTable* table, uint32_t nowMs) {
+    uint8_t count = 0;
+    for (int i = 0; i < FORMATION_MAX_NEIGHBORS; i++)
+        count += FormationTable_isLive(&table->neighbors[i], nowMs);
+    return count;
+}
+
+uint16_t FormationTable_intervalMs(uint8_t rateHz, uint32_t budgetBps, uint8_t neighbors) {
+    if (rateHz == 0)
+        rateHz = 1;
+    if (rateHz > FORMATION_MAX_RATE_HZ)
+        rateHz = FORMATION_MAX_RATE_HZ;
+    uint32_t interval = 1000 / rateHz;
+
+    if (budgetBps > 0) {
+        uint32_t shared = ((uint32_t)neighbors + 1) * FORMATION_FRAME_AIR_BYTES * 1000;
+        uint32_t budgeted = (shared + budgetBps - 1) / budgetBps;
+        if (budgeted > interval)
+            interval = budgeted;
+    }
+    if (interval > FORMATION_MAX_INTERVAL_MS)
+        interval = FORMATION_MAX_INTERVAL_MS;
+    return (uint16_t)interval;
+}
+
+NavVector Formation_followTarget(NavVector leader, const FormationState* state,
+                                 float right, float back, float leadS) {
+    // Leader's forward / right unit vectors in east / north
+    float s, c;
+    FastMath_sinCos(state->heading * FAST_MATH_DEG_TO_RAD, &s, &c);
+    float fwdEast = s, fwdNorth = c;
+    float rightEast = c, rightNorth = -s;
+
+    NavVector slot;
+    slot.east = leader.east + rightEast * right - fwdEast * back + state->velEast * leadS;
+    slot.north = leader.north + rightNorth * right - fwdNorth * back + state->velNorth * leadS;
+    return slot;
+}
@@ -0,0 +1,147 @@
+#ifndef FORMATION_TABLE_H
+#define FORMATION_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NavFrame.h"
+
+/**
+ * FormationTable - Neighbour state from vehicle-to-vehicle beacons
+ *
+ * Every vehicle of a formation group broadcasts a compact state beacon
+ * (NAFormationBeacon) and keeps the latest beacon of each neighbour in a
+ * fixed-size table:
+ *   - a neighbour is live for FORMATION_NEIGHBOR_TIMEOUT_MS after its
+ *     last beacon; a new one takes a free or timed-out entry, never a
+ *     live one (a full table drops the newcomer)
+ *   - beacon sequence numbers must increase; a neighbour that timed out
+ *     may restart its counter (reboot)
+ *
+ * The beacon interval is shared out of an airtime budget: with n live
+ * neighbours, n + 1 vehicles beacon in range, so each one waits
+ *   max(1000 / rateHz, (n + 1) * FORMATION_FRAME_AIR_BYTES * 1000 / budget)
+ * ms, capped at FORMATION_MAX_INTERVAL_MS so neighbours never time out.
+ * The swarm's beacon load therefore stays at the budget as it grows.
+ *
+ * Formation_followTarget() places a follower's slot behind / beside its
+ * leader in the leader's heading frame.
+ *
+ * Pure: no globals, no RTOS. Callers serialize access to one table.
+ *
+ * @file FormationTable.h
+ */
+
+#define FORMATION_MAX_NEIGHBORS         8
+#define FORMATION_NEIGHBOR_TIMEOUT_MS   3000
+#define FORMATION_MAC_SIZE              6
+
+#define FORMATION_DEFAULT_RATE_HZ       5
+#define FORMATION_MAX_RATE_HZ           20
+#define FORMATION_DEFAULT_BUDGET_BPS    2000    // Air bytes/s for all beacons in range
+#define FORMATION_FRAME_AIR_BYTES       76      // Beacon + ESP-NOW / 802.11 framing
+#define FORMATION_MAX_INTERVAL_MS       1000    // A third of the neighbour timeout
+
+// FormationState.flags
+#define FORMATION_FLAG_POSITION         0x01    // Position valid (GPS / EKF)
+#define FORMATION_FLAG_MISSION          0x02    // Mission / survey running
+#define FORMATION_FLAG_FOLLOWING        0x04    // Following a leader
+
+/**
+ * One vehicle's beaconed state
+ */
+typedef struct {
+    int32_t latE7;              // deg * 1e7; each receiver projects it into
+    int32_t lngE7;              // its own local frame (origins differ)
+    float velEast;              // m/s
+    float velNorth;
+    float heading;              // Degrees, 0-360
+    uint16_t missionIndex;      // Mission item being flown
+    uint8_t vehicleType;
+    uint8_t flags;              // FORMATION_FLAG_*
+} FormationState;
+
+typedef struct {
+    uint8_t mac[FORMATION_MAC_SIZE];
+    bool used;
+    uint32_t sequence;          // Last accepted beacon
+    uint32_t lastSeenMs;
+    uint32_t beacons;           // Accepted since the entry was taken
+    FormationState state;
+} FormationNeighbor;
+
+typedef struct {
+    FormationNeighbor neighbors[FORMATION_MAX_NEIGHBORS];
+    uint32_t stale;             // Repeated / older sequence numbers
+    uint32_t dropped;           // Newcomers while full of live neighbours
+} FormationTable;
+
+/**
+ * Outcome of FormationTable_update()
+ */
+typedef enum {
+    FORMATION_RX_NEW = 0,       // Neighbour (re)appeared
+    FORMATION_RX_UPDATED,
+    FORMATION_RX_STALE,         // Sequence not newer, ignored
+    FORMATION_RX_FULL           // No entry free, ignored
+} FormationRxResult;
+
+/**
+ * Empty the table
+ */
+void FormationTable_init(FormationTable* table);
+
+/**
+ * Record an authenticated beacon
+ * @param mac Sender
+ * @param sequence Beacon sequence number
+ * @param state Decoded beacon
+ * @param nowMs Current time (millis)
+ */
+FormationRxResult FormationTable_update(FormationTable* table, const uint8_t* mac,
+                                        uint32_t sequence, const FormationState* state,
+                                        uint32_t nowMs);
+
+/**
+ * Live neighbour by MAC
+ * @return Entry, or NULL if unknown or timed out
+ */
+const FormationNeighbor* FormationTable_find(const FormationTable* table, const uint8_t* mac,
+                                             uint32_t nowMs);
+
+/**
+ * Whether an entry is live
+ */
+bool FormationTable_isLive(const FormationNeighbor* neighbor, uint32_t nowMs);
+
+/**
+ * Number of live neighbours
+ */
+uint8_t FormationTable_liveCount(const FormationTable* table, uint32_t nowMs);
+
+/**
+ * Beacon interval under the airtime budget
+ * @param rateHz Configured rate (1..FORMATION_MAX_RATE_HZ)
+ * @param budgetBps Air bytes per second for all beacons in range
+ * @param neighbors Live neighbours
+ * @return Interval in ms
+ */
+uint16_t FormationTable_intervalMs(uint8_t rateHz, uint32_t budgetBps, uint8_t neighbors);
+
+/**
+ * Follower slot relative to a leader
+ *
+ * The offset is turned with the leader's heading and led by its velocity
+ * over leadS, so the follower aims where its slot will be rather than
+ * where it was when the beacon left.
+ *
+ * @param leader Leader position in the follower's local frame
+ * @param state Leader beacon (heading, velocity)
+ * @param right Meters to the leader's right (negative = left)
+ * @param back Meters behind the leader (negative = ahead)
+ * @param leadS Velocity lead in seconds (beacon age + reaction)
+ * @return Slot position in the same local frame
+ */
+NavVector Formation_followTarget(NavVector leader, const FormationState* state,
+                                 float right, float back, float leadS);
+
+#endif // FORMATION_TABLE_H
@@ -0,0 +1,308 @@
+#include "GPSManager.h"
+#include "FastMath.h"
+#include "HAL.h"
+#include "MemoryProfiler.h"
+#include <math.h>
+
+// CFG-PRT fields
+#define UBX_PORT_UART1          1
+#define UBX_MODE_8N1            0x000008D0
+#define UBX_PROTO_UBX           0x0001
+#define UBX_PROTO_NMEA          0x0002
+#define UBX_PROTO_RTCM3         0x0020
+
+// CFG-TMODE3
+#define UBX_TMODE_DISABLED      0
+#define UBX_TMODE_SURVEY_IN     1
+#define UBX_TMODE3_LEN          40
+
+// CFG-MSG ids of the base's RTCM3 output
+#define UBX_RTCM_1005           0x05    // Antenna reference point
+#define UBX_RTCM_1230           0xE6    // GLONASS code-phase biases
+static const uint8_t UBX_RTCM_MSM4[] = {
+    0x4A, 0x54, 0x5E, 0x7C,             // 1074 GPS, 1084 GLONASS, 1094 Galileo, 1124 BeiDou
+};
+
+#define GPS_BAUD_SWITCH_MS      100     // Receiver applies CFG-PRT after the ACK
+
+// Newest timepulse edge, written by the interrupt
+static portMUX_TYPE gPulseMux = portMUX_INITIALIZER_UNLOCKED;
+static HAL_Micros gPulseUs = 0;
+static uint32_t gPulses = 0;
+
+GPSManager::GPSManager()
+    : _serial(2), _pulsesTaken(0), _fixCount(0), _ubx(false), _bytesRead(0), _modeSinceMs(0),
+      _baseWanted(false), _base(false), _sink(nullptr), _sinkCtx(nullptr), _rtcmIn(0),
+      _rtcmDropped(0), _task(nullptr) {
+    _mux = portMUX_INITIALIZER_UNLOCKED;
+    memset(&_fix, 0, sizeof(_fix));
+    TimeSync_init(&_time);
+    UBXParser_init(&_parser);
+    RtcmFramer_init(&_rtcm);
+}
+
+void GPSManager::setup(uint8_t priority, uint8_t core) {
+    _serial.setRxBufferSize(GPS_RX_BUFFER);
+    _serial.setTxBufferSize(GPS_TX_BUFFER);
+    _serial.begin(GPS_NMEA_BAUD, SERIAL_8N1, GPS_RX_PIN, GPS_TX_PIN);
+    pinMode(GPS_PPS_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(GPS_PPS_PIN), onPulse, RISING);
+
+    MemoryProfiler_setTaskStackSize("gps", GPS_TASK_STACK);
+    if (xTaskCreatePinnedToCore(taskEntry, "gps", GPS_TASK_STACK, this, priority, &_task, core) != pdPASS) {
+        Serial.println("[GPS] Task create failed");
+    }
+}
+
+bool GPSManager::getFix(GPSFix& fix) {
+    if (_fixCount == 0) return false;
+    portENTER_CRITICAL(&_mux);
+    fix = _fix;
+    portEXIT_CRITICAL(&_mux);
+    return true;
+}
+
+TimeSyncState GPSManager::toUtc(HAL_Micros localUs, int64_t& utcUs) {
+    portENTER_CRITICAL(&_mux);
+    TimeSyncState state = TimeSync_state(&_time, localUs);
+    TimeSync_toUtc(&_time, localUs, &utcUs);
+    portEXIT_CRITICAL(&_mux);
+    return state;
+}
+
+TimeSync GPSManager::getTimeSync() {
+    portENTER_CRITICAL(&_mux);
+    TimeSync copy = _time;
+    portEXIT_CRITICAL(&_mux);
+    return copy;
+}
+
+void GPSManager::setBase(bool on, GPSCorrectionSink sink, void* ctx) {
+    if (on) {
+        _sink = sink;
+        _sinkCtx = ctx;
+    }
+    _baseWanted = on;
+}
+
+bool GPSManager::injectCorrections(const uint8_t* frame, size_t len) {
+    // Whole frames only: a receiver drops one that arrives cut short
+    if (!_ubx || (size_t)_serial.availableForWrite() < len) {
+        _rtcmDropped++;
+        return false;
+    }
+    _serial.write(frame, len);
+    _rtcmIn++;
+    return true;
+}
+
+// ============================================================================
+// Receiver Configuration (reader task)
+// ============================================================================
+
+void GPSManager::sendUBX(uint8_t msgClass, uint8_t msgId, const void* payload, uint16_t len) {
+    uint8_t frame[UBX_TMODE3_LEN + UBX_FRAME_OVERHEAD];   // CFG-TMODE3 is the largest
+    size_t n = UBXParser_buildFrame(msgClass, msgId, payload, len, frame, sizeof(frame));
+    if (n) _serial.write(frame, n);
+}
+
+void GPSManager::sendPortConfig(uint32_t baud, bool nmeaOut) {
+    uint8_t prt[20] = {0};
+    uint32_t mode = UBX_MODE_8N1;
+    uint16_t inProto = UBX_PROTO_UBX | UBX_PROTO_NMEA | UBX_PROTO_RTCM3;
+    uint16_t outProto = nmeaOut ? (UBX_PROTO_UBX | UBX_PROTO_NMEA) : UBX_PROTO_UBX;
+    if (_base) outProto |= UBX_PROTO_RTCM3;
+    prt[0] = UBX_PORT_UART1;
+    memcpy(&prt[4], &mode, 4);          // Little endian on both ends
+    memcpy(&prt[8], &baud, 4);
+    memcpy(&prt[12], &inProto, 2);
+    memcpy(&prt[14], &outProto, 2);
+    sendUBX(UBX_CLASS_CFG, UBX_ID_CFG_PRT, prt, sizeof(prt));
+    _serial.flush();
+}
+
+void GPSManager::configureUBX() {
+    // Factory default is 9600 NMEA; a warm reboot finds it at 115200 already
+    sendPortConfig(GPS_UBX_BAUD, false);
+    vTaskDelay(pdMS_TO_TICKS(GPS_BAUD_SWITCH_MS));
+    _serial.updateBaudRate(GPS_UBX_BAUD);
+    sendPortConfig(GPS_UBX_BAUD, false);
+
+    uint16_t measRate = 1000 / GPS_RATE_HZ;
+    uint8_t rate[6] = {(uint8_t)(measRate & 0xFF), (uint8_t)(measRate >> 8), 1, 0, 1, 0};
+    sendUBX(UBX_CLASS_CFG, UBX_ID_CFG_RATE, rate, sizeof(rate));
+
+    uint8_t msg[3] = {UBX_CLASS_NAV, UBX_ID_NAV_PVT, 1};    // Every solution
+    sendUBX(UBX_CLASS_CFG, UBX_ID_CFG_MSG, msg, sizeof(msg));
+
+    _ubx = true;
+    _modeSinceMs = HAL_GetMillis();
+}
+
+void GPSManager::fallBackToNMEA() {
+    // Undo the switch in case a u-blox took the baud change but no more
+    sendPortConfig(GPS_NMEA_BAUD, true);
+    vTaskDelay(pdMS_TO_TICKS(GPS_BAUD_SWITCH_MS));
+    _serial.updateBaudRate(GPS_NMEA_BAUD);
+    _ubx = false;
+    _modeSinceMs = HAL_GetMillis();
+    Serial.println("[GPS] No UBX response, using NMEA");
+}
+
+void GPSManager::configureBase(bool on) {
+    _base = on;
+    RtcmFramer_init(&_rtcm);
+    sendPortConfig(GPS_UBX_BAUD, false);
+
+    // Survey-in: the base averages its own position, then starts sending
+    // observables relative to it (receivers without TMODE3 NAK and stay silent)
+    uint8_t tmode[UBX_TMODE3_LEN] = {0};
+    uint16_t flags = on ? UBX_TMODE_SURVEY_IN : UBX_TMODE_DISABLED;
+    uint32_t minDur = GPS_BASE_SVIN_MIN_S;
+    uint32_t accLimit = GPS_BASE_SVIN_ACC_MM * 10;  // 0.1 mm
+    memcpy(&tmode[2], &flags, 2);
+    memcpy(&tmode[24], &minDur, 4);
+    memcpy(&tmode[28], &accLimit, 4);
+    sendUBX(UBX_CLASS_CFG, UBX_ID_CFG_TMODE3, tmode, sizeof(tmode));
+
+    // Rates count navigation epochs; 0 turns a message off
+    uint8_t msmRate = on ? GPS_BASE_MSM_EPOCHS : 0;
+    uint8_t arpRate = on ? GPS_BASE_ARP_EPOCHS : 0;
+    for (size_t i = 0; i < sizeof(UBX_RTCM_MSM4); i++) {
+        uint8_t msg[3] = {UBX_CLASS_RTCM3, UBX_RTCM_MSM4[i], msmRate};
+        sendUBX(UBX_CLASS_CFG, UBX_ID_CFG_MSG, msg, sizeof(msg));
+    }
+    const uint8_t slow[2] = {UBX_RTCM_1005, UBX_RTCM_1230};
+    for (size_t i = 0; i < sizeof(slow); i++) {
+        uint8_t msg[3] = {UBX_CLASS_RTCM3, slow[i], arpRate};
+        sendUBX(UBX_CLASS_CFG, UBX_ID_CFG_MSG, msg, sizeof(msg));
+    }
+    Serial.println(on ? "[GPS] RTK base, surveying in" : "[GPS] RTK base off");
+}
+
+// ============================================================================
+// Parsing (reader task)
+// ============================================================================
+
+void IRAM_ATTR GPSManager::onPulse() {
+    HAL_Micros now = HAL_Now();
+    portENTER_CRITICAL_ISR(&gPulseMux);
+    gPulseUs = now;
+    gPulses++;
+    portEXIT_CRITICAL_ISR(&gPulseMux);
+}
+
+void GPSManager::takePulse() {
+    portENTER_CRITICAL(&gPulseMux);
+    uint32_t pulses = gPulses;
+    HAL_Micros edgeUs = gPulseUs;
+    portEXIT_CRITICAL(&gPulseMux);
+    if (pulses == _pulsesTaken) return;
+    _pulsesTaken = pulses;
+    portENTER_CRITICAL(&_mux);
+    TimeSync_onPulse(&_time, edgeUs);
+    portEXIT_CRITICAL(&_mux);
+}
+
+void GPSManager::publish(const GPSFix& fix) {
+    HAL_Micros rxUs = HAL_Now();
+    portENTER_CRITICAL(&_mux);
+    _fix = fix;
+    _fix.timeMs = (uint32_t)(rxUs / 1000);
+    _fixCount++;
+    if (fix.utcUs) TimeSync_onUtc(&_time, fix.utcUs, fix.tAcc, rxUs);
+    portEXIT_CRITICAL(&_mux);
+}
+
+void GPSManager::handleUBX(const uint8_t* data, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        UBXFrame frame;
+        off += UBXParser_feed(&_parser, &data[off], len - off, &frame);
+        GPSFix fix;
+        if (frame.payload && UBXParser_decodeNavPvt(&frame, &fix)) {
+            publish(fix);
+        }
+    }
+}
+
+void GPSManager::handleRTCM(const uint8_t* data, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        const uint8_t* frame;
+        uint16_t frameLen;
+        off += RtcmFramer_feed(&_rtcm, &data[off], len - off, &frame, &frameLen);
+        if (frame && _sink) _sink(frame, frameLen, _sinkCtx);
+    }
+}
+
+static int32_t rawToE7(const RawDegrees& raw) {
+    // billionths -> 1e-7 deg, rounded
+    int32_t e7 = (int32_t)raw.deg * 10000000L + (int32_t)((raw.billionths + 50) / 100);
+    return raw.negative ? -e7 : e7;
+}
+
+void GPSManager::handleNMEA(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        _nmea.encode((char)data[i]);
+    }
+    if (!_nmea.location.isUpdated()) return;
+
+    GPSFix fix;
+    memset(&fix, 0, sizeof(fix));
+    fix.valid = _nmea.location.isValid();
+    fix.lat = rawToE7(_nmea.location.rawLat());
+    fix.lng = rawToE7(_nmea.location.rawLng());
+    fix.fixType = _nmea.altitude.isValid() ? 3 : 2;
+    if (_nmea.altitude.isValid()) fix.altMsl = (int32_t)(_nmea.altitude.meters() * 1000.0);
+    if (_nmea.satellites.isValid()) fix.numSV = (uint8_t)_nmea.satellites.value();
+    // HDOP times a ~5 m range error; value() is HDOP * 100
+    if (_nmea.hdop.isValid()) fix.hAcc = (uint32_t)_nmea.hdop.value() * 50;
+    if (_nmea.speed.isValid()) fix.groundSpeed = (int32_t)(_nmea.speed.mps() * 1000.0);
+    if (_nmea.date.isValid() && _nmea.time.isValid() && _nmea.date.year() >= 2000) {
+        fix.utcUs = TimeSync_unixSeconds(_nmea.date.year(), _nmea.date.month(), _nmea.date.day(),
+                                         _nmea.time.hour(), _nmea.time.minute(),
+                                         _nmea.time.second()) * 1000000LL +
+                    _nmea.time.centisecond() * 10000LL;
+    }
+    if (_nmea.course.isValid()) {
+        double course = _nmea.course.deg();
+        fix.course = (int32_t)(course * 100000.0);
+        float s, c;
+        FastMath_sinCos((float)course * FAST_MATH_DEG_TO_RAD, &s, &c);
+        fix.velN = (int32_t)(fix.groundSpeed * c);
+        fix.velE = (int32_t)(fix.groundSpeed * s);
+    }
+    publish(fix);
+}
+
+void GPSManager::run() {
+    configureUBX();
+
+    uint8_t buf[GPS_READ_CHUNK];
+    for (;;) {
+        // Before the UART: the solution of a second always follows its pulse
+        takePulse();
+        if (_ubx && _baseWanted != _base) configureBase(_baseWanted);
+        int avail;
+        while ((avail = _serial.available()) > 0) {
+            size_t n = _serial.read(buf, avail > GPS_READ_CHUNK ? GPS_READ_CHUNK : avail);
+            _bytesRead += n;
+            if (_ubx) {
+                handleUBX(buf, n);
+                if (_base) handleRTCM(buf, n);
+            } else {
+                handleNMEA(buf, n);
+            }
+        }
+
+        if (_ubx && _fixCount == 0 && HAL_GetMillis() - _modeSinceMs > GPS_UBX_TIMEOUT_MS) {
+            fallBackToNMEA();
+        }
+        vTaskDelay(pdMS_TO_TICKS(GPS_READ_PERIOD_MS));
+    }
+}
+
+void GPSManager::taskEntry(void* arg) {
+    static_cast<GPSManager*>(arg)->run();
+}
@@ -0,0 +1,167 @@
+#ifndef GPS_MANAGER_H
+#define GPS_MANAGER_H
+
+#include <Arduino.h>
+#include <TinyGPS++.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "HAL.h"
+#include "TimeSync.h"
+#include "UBXParser.h"
+#include "RtcmRelay.h"
+
+/**
+ * GPSManager - GNSS receiver driver on UART2
+ *
+ * Hardware:
+ * - UART2, RX GPIO 16, TX GPIO 17
+ * - u-blox M8 / M9 (anything that speaks UBX), or any NMEA receiver
+ *
+ * Operation:
+ * - At start the receiver is switched from its 9600 baud NMEA default
+ *   to 115200 baud, UBX output only, with NAV-PVT at GPS_RATE_HZ (CFG-PRT
+ *   is sent at both rates, so an already configured receiver after a
+ *   warm reboot follows too)
+ * - A background task drains the UART in bulk every GPS_READ_PERIOD_MS
+ *   into UBXParser; frames are decoded where they lie in the read buffer
+ * - No NAV-PVT within GPS_UBX_TIMEOUT_MS: back to 9600 baud NMEA through
+ *   TinyGPS++ (1 Hz, no accuracy estimate)
+ * - The latest fix is published under a spinlock; getFix() is a copy
+ *   and never touches the UART
+ * - UTC: the timepulse (GPS_PPS_PIN, optional) is stamped in its
+ *   interrupt and the reader task disciplines a TimeSync with it and the
+ *   UTC of each solution (NAV-PVT, or NMEA date/time without PPS);
+ *   toUtc() converts HAL_Now() stamps for telemetry and the blackbox
+ * - RTK (u-blox M8P / F9P): as a base the receiver surveys itself in and
+ *   adds RTCM3 to its output, which the reader task frames and hands to
+ *   a sink; as a rover it takes RTCM3 input, written by
+ *   injectCorrections() into the UART driver's TX ring (shifted out by
+ *   its interrupt, so no caller ever waits on the UART)
+ */
+
+#define GPS_RX_PIN              16
+#define GPS_TX_PIN              17
+#define GPS_PPS_PIN             35      // Timepulse, input only (unconnected: coarse UTC)
+#define GPS_NMEA_BAUD           9600
+#define GPS_UBX_BAUD            115200
+#define GPS_RATE_HZ             10
+#define GPS_READ_PERIOD_MS      10      // ~115 bytes per read at 115200
+#define GPS_READ_CHUNK          256
+#define GPS_RX_BUFFER           1024    // UART driver ring (~90 ms at 115200)
+#define GPS_TX_BUFFER           2048    // TX ring: two of the largest RTCM3 frames
+#define GPS_UBX_TIMEOUT_MS      3000
+#define GPS_TASK_STACK          3072    // bytes
+
+// RTK base
+#define GPS_BASE_SVIN_MIN_S     120     // Survey-in: at least this long ...
+#define GPS_BASE_SVIN_ACC_MM    2000    // ... and until the mean position is this good
+#define GPS_BASE_MSM_EPOCHS     GPS_RATE_HZ         // MSM4 observables once a second
+#define GPS_BASE_ARP_EPOCHS     (10 * GPS_RATE_HZ)  // Position / GLONASS biases every 10 s
+
+/**
+ * Receives each RTCM3 frame a base receiver sends (reader task; must not block)
+ */
+typedef void (*GPSCorrectionSink)(const uint8_t* frame, uint16_t len, void* ctx);
+
+class GPSManager {
+public:
+    GPSManager();
+
+    /**
+     * Open the UART and start the reader task (receiver setup runs there)
+     * @param priority FreeRTOS priority of the reader task
+     * @param core Core to pin the reader task to
+     */
+    void setup(uint8_t priority, uint8_t core);
+
+    /**
+     * Latest fix
+     * @return false if no fix has been received yet
+     */
+    bool getFix(GPSFix& fix);
+
+    /**
+     * Fixes received so far; changes with every NAV-PVT / NMEA fix
+     */
+    uint32_t getFixCount() const { return _fixCount; }
+
+    /**
+     * true while running UBX (false = NMEA fallback)
+     */
+    bool isUBX() const { return _ubx; }
+
+    /**
+     * UTC of a local time stamp
+     * @param localUs HAL_Now() value
+     * @return Clock quality; utcUs is set unless TIME_SYNC_NONE
+     */
+    TimeSyncState toUtc(HAL_Micros localUs, int64_t& utcUs);
+
+    /**
+     * Copy of the time discipline state (statistics)
+     */
+    TimeSync getTimeSync();
+
+    uint32_t getChecksumErrors() const { return _parser.checksumErrors; }
+    uint32_t getBytesRead() const { return _bytesRead; }
+
+    /**
+     * RTK base on / off (applied by the reader task, within GPS_READ_PERIOD_MS)
+     * @param sink Gets every RTCM3 frame from the receiver while on
+     */
+    void setBase(bool on, GPSCorrectionSink sink, void* ctx);
+    bool isBase() const { return _base; }
+
+    /**
+     * RTK rover: queue one RTCM3 frame for the receiver (any task)
+     * @return false if not running UBX or the TX ring has no room (dropped)
+     */
+    bool injectCorrections(const uint8_t* frame, size_t len);
+
+    uint32_t getCorrectionsIn() const { return _rtcmIn; }
+    uint32_t getCorrectionsDropped() const { return _rtcmDropped; }
+    uint32_t getCorrectionsOut() const { return _rtcm.frames; }
+
+private:
+    HardwareSerial _serial;
+    UBXParser _parser;
+    TinyGPSPlus _nmea;
+
+    portMUX_TYPE _mux;
+    GPSFix _fix;                // Guarded by _mux
+    TimeSync _time;             // Written by the reader task, guarded by _mux
+    uint32_t _pulsesTaken;
+    volatile uint32_t _fixCount;
+    volatile bool _ubx;
+    uint32_t _bytesRead;
+    uint32_t _modeSinceMs;
+
+    // RTK
+    volatile bool _baseWanted;
+    volatile bool _base;        // Receiver configured as base (reader task)
+    GPSCorrectionSink _sink;
+    void* _sinkCtx;
+    RtcmFramer _rtcm;           // Base output (reader task)
+    uint32_t _rtcmIn;           // Rover: frames queued for the receiver
+    uint32_t _rtcmDropped;
+
+    TaskHandle_t _task;
+
+    void sendUBX(uint8_t msgClass, uint8_t msgId, const void* payload, uint16_t len);
+    void sendPortConfig(uint32_t baud, bool nmeaOut);
+    void configureUBX();
+    void fallBackToNMEA();
+    void configureBase(bool on);
+
+    void publish(const GPSFix& fix);
+    void takePulse();
+    void handleUBX(const uint8_t* data, size_t len);
+    void handleNMEA(const uint8_t* data, size_t len);
+    void handleRTCM(const uint8_t* data, size_t len);
+
+    void run();
+    static void taskEntry(void* arg);
+    static void onPulse();
+};
+
+#endif // GPS_MANAGER_H
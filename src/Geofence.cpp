@@ -0,0 +1,122 @@
+#include "Geofence.h"
+#include <string.h>
+
+/**
+ * Geofence - Implementation
+ *
+ * @file Geofence.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+/**
+ * Project one polygon and precompute its edges and bounding box
+ */
+static void build_polygon(GeofencePolygon* p, const NavFrame* frame) {
+    NavVector v[GEOFENCE_MAX_VERTICES];
+    for (uint8_t i = 0; i < p->vertexCount; i++) {
+        v[i] = NavFrame_toLocal(frame, p->lat[i], p->lng[i]);
+        if (i == 0 || v[i].east < p->minEast) p->minEast = v[i].east;
+        if (i == 0 || v[i].east > p->maxEast) p->maxEast = v[i].east;
+        if (i == 0 || v[i].north < p->minNorth) p->minNorth = v[i].north;
+        if (i == 0 || v[i].north > p->maxNorth) p->maxNorth = v[i].north;
+    }
+
+    for (uint8_t i = 0, j = p->vertexCount - 1; i < p->vertexCount; j = i++) {
+        GeofenceEdge* e = &p->edges[i];
+        NavVector a = v[j];
+        NavVector b = v[i];
+        if (a.north == b.north) {
+            e->northLo = e->northHi = a.north;
+            e->slope = 0.0f;
+            e->offset = 0.0f;
+            continue;
+        }
+        e->slope = (b.east - a.east) / (b.north - a.north);
+        e->offset = a.east - e->slope * a.north;
+        e->northLo = a.north < b.north ? a.north : b.north;
+        e->northHi = a.north < b.north ? b.north : a.north;
+    }
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void Geofence_init(Geofence* fence) {
+    memset(fence, 0, sizeof(*fence));
+}
+
+bool Geofence_addPolygon(Geofence* fence, GeofenceType type, const int32_t* lat,
+                         const int32_t* lng, uint8_t count) {
+    if (count < 3 || count > GEOFENCE_MAX_VERTICES) return false;
+    if (fence->polygonCount >= GEOFENCE_MAX_POLYGONS) return false;
+
+    GeofencePolygon* p = &fence->polygons[fence->polygonCount++];
+    memset(p, 0, sizeof(*p));
+    p->type = type;
+    p->vertexCount = count;
+    memcpy(p->lat, lat, count * sizeof(int32_t));
+    memcpy(p->lng, lng, count * sizeof(int32_t));
+    fence->built = false;
+    return true;
+}
+
+void Geofence_setMaxDistance(Geofence* fence, float meters) {
+    if (!(meters > 0.0f)) meters = 0.0f;
+    fence->maxDistance = meters;
+    fence->maxDistanceSq = meters * meters;
+}
+
+void Geofence_clearPolygons(Geofence* fence) {
+    fence->polygonCount = 0;
+    fence->built = false;
+}
+
+void Geofence_setFrame(Geofence* fence, const NavFrame* frame) {
+    if (!frame->valid) return;
+    if (fence->built && fence->originLat == frame->originLat &&
+        fence->originLng == frame->originLng) return;
+
+    for (uint8_t i = 0; i < fence->polygonCount; i++) {
+        build_polygon(&fence->polygons[i], frame);
+    }
+    fence->originLat = frame->originLat;
+    fence->originLng = frame->originLng;
+    fence->built = true;
+}
+
+bool Geofence_contains(const GeofencePolygon* p, NavVector pos) {
+    if (pos.east < p->minEast || pos.east > p->maxEast ||
+        pos.north < p->minNorth || pos.north > p->maxNorth) return false;
+
+    // Count edges crossed by a ray from the position towards +east
+    bool inside = false;
+    const GeofenceEdge* e = p->edges;
+    for (uint8_t i = 0; i < p->vertexCount; i++, e++) {
+        if (pos.north >= e->northLo && pos.north < e->northHi &&
+            pos.east < e->slope * pos.north + e->offset) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+GeofenceResult Geofence_check(const Geofence* fence, NavVector position, const NavVector* home) {
+    if (home && fence->maxDistanceSq > 0.0f) {
+        float de = position.east - home->east;
+        float dn = position.north - home->north;
+        if (de * de + dn * dn > fence->maxDistanceSq) return GEOFENCE_BREACH_DISTANCE;
+    }
+    if (!fence->built) return GEOFENCE_OK;
+
+    for (uint8_t i = 0; i < fence->polygonCount; i++) {
+        const GeofencePolygon* p = &fence->polygons[i];
+        bool inside = Geofence_contains(p, position);
+        if (p->type == GEOFENCE_INCLUSION && !inside) return GEOFENCE_BREACH_INCLUSION;
+        if (p->type == GEOFENCE_EXCLUSION && inside) return GEOFENCE_BREACH_EXCLUSION;
+    }
+    return GEOFENCE_OK;
+}
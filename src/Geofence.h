@@ -0,0 +1,119 @@
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NavFrame.h"
+
+/**
+ * Geofence - Inclusion / exclusion polygons and a max distance from home
+ *
+ * Vertices are kept as deg * 1e7 and projected into the navigation frame
+ * by Geofence_setFrame() (again only when the frame re-anchors). Each
+ * edge is stored as its north span and the line east = slope * north +
+ * offset, so the crossing-number test is two compares and one
+ * multiply-add per edge, after a bounding-box early out:
+ *
+ *   inclusion  Breached outside the polygon (every inclusion fence
+ *              must contain the vehicle)
+ *   exclusion  Breached inside the polygon
+ *   distance   Breached further than maxDistance from home (squared,
+ *              no sqrt)
+ *
+ * Worst case at GEOFENCE_MAX_POLYGONS x GEOFENCE_MAX_VERTICES is 128
+ * edges, a few microseconds per control tick.
+ *
+ * @file Geofence.h
+ */
+
+#define GEOFENCE_MAX_POLYGONS   4
+#define GEOFENCE_MAX_VERTICES   32
+
+typedef enum {
+    GEOFENCE_INCLUSION = 0,
+    GEOFENCE_EXCLUSION = 1
+} GeofenceType;
+
+typedef enum {
+    GEOFENCE_OK = 0,
+    GEOFENCE_BREACH_INCLUSION = 1,      // Outside an inclusion polygon
+    GEOFENCE_BREACH_EXCLUSION = 2,      // Inside an exclusion polygon
+    GEOFENCE_BREACH_DISTANCE = 3        // Too far from home
+} GeofenceResult;
+
+/**
+ * Edge as the line east = slope * north + offset over [northLo, northHi)
+ */
+typedef struct {
+    float northLo;
+    float northHi;              // == northLo for an east-west edge (never crossed)
+    float slope;
+    float offset;
+} GeofenceEdge;
+
+typedef struct {
+    GeofenceType type;
+    uint8_t vertexCount;
+    int32_t lat[GEOFENCE_MAX_VERTICES];     // deg * 1e7
+    int32_t lng[GEOFENCE_MAX_VERTICES];
+    GeofenceEdge edges[GEOFENCE_MAX_VERTICES];
+    float minEast, maxEast;                 // Bounding box, local
+    float minNorth, maxNorth;
+} GeofencePolygon;
+
+typedef struct {
+    GeofencePolygon polygons[GEOFENCE_MAX_POLYGONS];
+    uint8_t polygonCount;
+    float maxDistance;          // Meters from home, 0 = off
+    float maxDistanceSq;
+
+    // Frame the edges were built in
+    int32_t originLat;
+    int32_t originLng;
+    bool built;
+} Geofence;
+
+/**
+ * Empty fence (nothing breaches)
+ */
+void Geofence_init(Geofence* fence);
+
+/**
+ * Add a polygon
+ * @param lat / lng Vertices, deg * 1e7, in order (either winding)
+ * @param count 3 to GEOFENCE_MAX_VERTICES
+ * @return false on a bad count or no free slot
+ */
+bool Geofence_addPolygon(Geofence* fence, GeofenceType type, const int32_t* lat,
+                         const int32_t* lng, uint8_t count);
+
+/**
+ * Max distance from home in meters (0 = off)
+ */
+void Geofence_setMaxDistance(Geofence* fence, float meters);
+
+/**
+ * Drop every polygon (the distance limit stays)
+ */
+void Geofence_clearPolygons(Geofence* fence);
+
+/**
+ * Project the polygons into the navigation frame
+ *
+ * Cheap to call every tick: only rebuilds after a re-anchor or an edit.
+ */
+void Geofence_setFrame(Geofence* fence, const NavFrame* frame);
+
+/**
+ * Test a position (in the frame from Geofence_setFrame())
+ * @param home Home in the same frame, NULL to skip the distance limit
+ * @return First breach found, GEOFENCE_OK inside the fence
+ */
+GeofenceResult Geofence_check(const Geofence* fence, NavVector position, const NavVector* home);
+
+/**
+ * Crossing-number point-in-polygon test on a built polygon
+ */
+bool Geofence_contains(const GeofencePolygon* polygon, NavVector position);
+
+#endif // GEOFENCE_H
@@ -6,33 +6,76 @@
  */
 
 #include "HAL.h"
+#include "AdcCal.h"
+#include "MemoryProfiler.h"
+#include "PinMap.h"
+#include "driver/adc.h"
 #include "driver/ledc.h"
+#include "driver/pcnt.h"
+#include <esp_adc_cal.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <hal/ledc_ll.h>
+#include <soc/soc_caps.h>
+#include <soc/ledc_struct.h>
 #include <Arduino.h>
 #include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <xtensa/hal.h>
 
 // ============================================================================
 // Global State
 // ============================================================================
 
-// PWM/Timer channel tracking
-#define MAX_PWM_CHANNELS 16
+// PWM/Timer channel registry (see HAL.h); the S3 has no high-speed group
+#if SOC_LEDC_SUPPORT_HS_MODE
+#define PWM_GROUPS 2
+#else
+#define PWM_GROUPS 1
+#endif
+#define PWM_CHANNELS_PER_GROUP 8
+#define PWM_TIMERS_PER_GROUP 4
+#define MAX_PWM_CHANNELS (PWM_GROUPS * PWM_CHANNELS_PER_GROUP)
 static struct {
   bool allocated;
   uint8_t pin;
+  uint8_t timer;
   uint32_t frequency;
+  uint8_t resolution;
+  uint32_t duty;
   uint8_t dutyCycle;
 } pwm_channels[MAX_PWM_CHANNELS] = {};
+static struct {
+  uint8_t users; // Channels running on this timer
+  uint32_t frequency;
+  uint8_t resolution;
+} pwm_timers[PWM_GROUPS * PWM_TIMERS_PER_GROUP] = {};
+static portMUX_TYPE pwm_mux = portMUX_INITIALIZER_UNLOCKED;
 
 // I2C state
 static bool i2c_initialized = false;
 static TwoWire *i2c_bus = nullptr;
+static QueueHandle_t i2c_queue = nullptr;
+static TaskHandle_t i2c_task = nullptr;
+static HAL_I2CQueueStats i2c_stats = {};
+static portMUX_TYPE i2c_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Quadrature encoders: PCNT unit = index, overflows folded in by the ISR
+static volatile int32_t encoder_base[HAL_ENCODER_MAX] = {};
+static uint8_t encoder_count = 0;
 
-// ADC resolution tracking
-#define MAX_ADC_PINS 8
+// ADC1 channels, indexed by channel number (see HAL_ADCInit)
 static struct {
   bool initialized;
   uint8_t resolution;
-} adc_pins[MAX_ADC_PINS] = {};
+  uint8_t oversample;
+  AdcCalLut lut;
+} adc_channels[HAL_ADC_CHANNELS] = {};
+static esp_adc_cal_characteristics_t adc_chars;
+static bool adc_characterized = false;
+static HAL_ADCCalSource adc_cal_source = HAL_ADC_CAL_DEFAULT;
 
 // ============================================================================
 // GPIO Pin Operations
@@ -79,68 +122,185 @@ bool HAL_PinDeinit(uint8_t pin) {
 // PWM / Timer Operations (ESP32 LEDC)
 // ============================================================================
 
-int HAL_TimerAllocate(uint8_t pin, uint32_t frequency, uint8_t initialDuty) {
-  // Find free channel
+static inline ledc_mode_t pwm_mode(uint8_t channel) {
+#if SOC_LEDC_SUPPORT_HS_MODE
+  return (ledc_mode_t)(channel / PWM_CHANNELS_PER_GROUP);
+#else
+  return LEDC_LOW_SPEED_MODE;
+#endif
+}
+
+static inline ledc_channel_t pwm_group_channel(uint8_t channel) {
+  return (ledc_channel_t)(channel % PWM_CHANNELS_PER_GROUP);
+}
+
+// Free channel in a group, -1 if full
+static int pwm_free_channel(uint8_t group) {
+  for (uint8_t i = 0; i < PWM_CHANNELS_PER_GROUP; i++) {
+    uint8_t ch = group * PWM_CHANNELS_PER_GROUP + i;
+    if (!pwm_channels[ch].allocated)
+      return ch;
+  }
+  return -1;
+}
+
+int HAL_PWMAllocate(uint8_t pin, uint32_t frequency, uint8_t resolution) {
+  if (frequency == 0 || resolution < 1 || resolution > 16)
+    return -1;
+
   int channel = -1;
+  int timer = -1;
+  bool newTimer = false;
+
+  portENTER_CRITICAL(&pwm_mux);
+  bool pinTaken = false;
   for (int i = 0; i < MAX_PWM_CHANNELS; i++) {
-    if (!pwm_channels[i].allocated) {
-      channel = i;
-      break;
+    if (pwm_channels[i].allocated && pwm_channels[i].pin == pin)
+      pinTaken = true;
+  }
+
+  // 1. Share a timer already running this frequency class
+  for (uint8_t t = 0; !pinTaken && t < PWM_GROUPS * PWM_TIMERS_PER_GROUP; t++) {
+    if (pwm_timers[t].users && pwm_timers[t].frequency == frequency &&
+        pwm_timers[t].resolution == resolution) {
+      channel = pwm_free_channel(t / PWM_TIMERS_PER_GROUP);
+      if (channel >= 0) {
+        timer = t;
+        break;
+      }
     }
   }
+  // 2. Otherwise take a free timer in a group with a free channel
+  for (uint8_t t = 0; !pinTaken && timer < 0 && t < PWM_GROUPS * PWM_TIMERS_PER_GROUP; t++) {
+    if (pwm_timers[t].users == 0) {
+      channel = pwm_free_channel(t / PWM_TIMERS_PER_GROUP);
+      if (channel >= 0) {
+        timer = t;
+        newTimer = true;
+      }
+    }
+  }
+  if (timer >= 0) {
+    // Reserve before configuring, so a concurrent call can't take it
+    pwm_channels[channel].allocated = true;
+    pwm_channels[channel].pin = pin;
+    pwm_timers[timer].users++;
+  }
+  portEXIT_CRITICAL(&pwm_mux);
 
-  if (channel == -1) {
-    return -1; // No free channels
+  if (timer < 0)
+    return -1;
+
+  ledc_mode_t speed_mode = pwm_mode(channel);
+  ledc_timer_t timer_num = (ledc_timer_t)(timer % PWM_TIMERS_PER_GROUP);
+  bool ok = true;
+
+  if (newTimer) {
+    ledc_timer_config_t timer_conf = {
+        .speed_mode = speed_mode,
+        .duty_resolution = (ledc_timer_bit_t)resolution,
+        .timer_num = timer_num,
+        .freq_hz = frequency,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ok = ledc_timer_config(&timer_conf) == ESP_OK;
   }
 
-  // Configure LEDC timer
-  uint32_t freq_hz = frequency;
-  uint8_t resolution = 8; // 8-bit resolution (0-255)
-  if (frequency >= 20000) {
-    resolution = 8; // 20kHz for motors
-  } else if (frequency == 50) {
-    resolution = 12; // 12-bit for servo PWM
+  if (ok) {
+    ledc_channel_config_t channel_conf = {
+        .gpio_num = pin,
+        .speed_mode = speed_mode,
+        .channel = pwm_group_channel(channel),
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = timer_num,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    ok = ledc_channel_config(&channel_conf) == ESP_OK;
+  }
+
+  portENTER_CRITICAL(&pwm_mux);
+  if (ok) {
+    pwm_timers[timer].frequency = frequency;
+    pwm_timers[timer].resolution = resolution;
+    pwm_channels[channel].timer = timer;
+    pwm_channels[channel].frequency = frequency;
+    pwm_channels[channel].resolution = resolution;
+    pwm_channels[channel].duty = 0;
+    pwm_channels[channel].dutyCycle = 0;
+  } else {
+    pwm_channels[channel].allocated = false;
+    pwm_timers[timer].users--;
   }
+  portEXIT_CRITICAL(&pwm_mux);
 
-  // Determine timer/speed mode based on frequency
-  ledc_timer_t timer = (frequency >= 20000) ? LEDC_TIMER_0 : LEDC_TIMER_1;
-  ledc_mode_t speed_mode = LEDC_LOW_SPEED_MODE;
+  return ok ? channel : -1;
+}
 
-  // Configure timer
-  ledc_timer_config_t timer_conf = {
-      .speed_mode = speed_mode,
-      .duty_resolution = (ledc_timer_bit_t)resolution,
-      .timer_num = timer,
-      .freq_hz = freq_hz,
-      .clk_cfg = LEDC_AUTO_CLK,
-  };
+int HAL_PWMAllocateMax(uint8_t pin, uint32_t frequency) {
+  uint8_t resolution = PinMap_pwmMaxResolution(frequency);
+  return resolution ? HAL_PWMAllocate(pin, frequency, resolution) : -1;
+}
 
-  if (ledc_timer_config(&timer_conf) != ESP_OK) {
-    return -1;
+bool HAL_PWMWrite(uint8_t channel, uint32_t duty) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated) {
+    return false;
   }
 
-  // Configure channel
-  ledc_channel_config_t channel_conf = {
-      .gpio_num = pin,
-      .speed_mode = speed_mode,
-      .channel = (ledc_channel_t)channel,
-      .intr_type = LEDC_INTR_DISABLE,
-      .timer_sel = timer,
-      .duty =
-          (initialDuty * ((1 << resolution) - 1)) / 100, // Convert % to counts
-      .hpoint = 0,
-  };
+  uint32_t max = 1UL << pwm_channels[channel].resolution;
+  if (duty > max)
+    duty = max;
+
+  // Register writes as in MotorBatch: channel config left the fade at one
+  // step of one cycle, so duty_start only loads the new duty, and the
+  // hardware applies it when the timer next overflows. The mux keeps a
+  // write from another core from landing between duty and start.
+  ledc_mode_t mode = pwm_mode(channel);
+  ledc_channel_t gch = pwm_group_channel(channel);
+  portENTER_CRITICAL(&pwm_mux);
+  ledc_ll_set_duty_int_part(&LEDC, mode, gch, duty);
+  ledc_ll_set_duty_start(&LEDC, mode, gch, true);
+  if (mode == LEDC_LOW_SPEED_MODE)
+    ledc_ll_ls_channel_update(&LEDC, mode, gch);
+  pwm_channels[channel].duty = duty;
+  portEXIT_CRITICAL(&pwm_mux);
+  return true;
+}
 
-  if (ledc_channel_config(&channel_conf) != ESP_OK) {
-    return -1;
+bool HAL_PWMWriteQ15(uint8_t channel, uint16_t q15) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated) {
+    return false;
+  }
+  return HAL_PWMWrite(channel, PinMap_dutyFromQ15(q15, pwm_channels[channel].resolution));
+}
+
+uint8_t HAL_PWMGetResolution(uint8_t channel) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated) {
+    return 0;
   }
+  return pwm_channels[channel].resolution;
+}
 
-  // Update channel tracking
-  pwm_channels[channel].allocated = true;
-  pwm_channels[channel].pin = pin;
-  pwm_channels[channel].frequency = frequency;
-  pwm_channels[channel].dutyCycle = initialDuty;
+bool HAL_PWMGetChannelInfo(uint8_t channel, HAL_PWMChannelInfo *info) {
+  if (channel >= MAX_PWM_CHANNELS || !info) {
+    return false;
+  }
+  portENTER_CRITICAL(&pwm_mux);
+  info->allocated = pwm_channels[channel].allocated;
+  info->pin = pwm_channels[channel].pin;
+  info->timer = pwm_channels[channel].timer;
+  info->frequency = pwm_channels[channel].frequency;
+  info->resolution = pwm_channels[channel].resolution;
+  info->duty = pwm_channels[channel].duty;
+  portEXIT_CRITICAL(&pwm_mux);
+  return true;
+}
 
+int HAL_TimerAllocate(uint8_t pin, uint32_t frequency, uint8_t initialDuty) {
+  int channel = HAL_PWMAllocateMax(pin, frequency);
+  if (channel >= 0 && initialDuty) {
+    HAL_TimerSetDuty(channel, initialDuty);
+  }
   return channel;
 }
 
@@ -149,11 +309,9 @@ bool HAL_TimerSetDuty(uint8_t channel, uint8_t dutyCycle) {
     return false;
   }
 
-  uint8_t resolution = (pwm_channels[channel].frequency >= 20000) ? 8 : 12;
-  uint32_t duty_counts = (dutyCycle * ((1 << resolution) - 1)) / 100;
-
-  ledc_set_duty(LEDC_HIGH_SPEED_MODE, (ledc_channel_t)channel, duty_counts);
-  ledc_update_duty(LEDC_HIGH_SPEED_MODE, (ledc_channel_t)channel);
+  if (dutyCycle > 100)
+    dutyCycle = 100;
+  HAL_PWMWriteQ15(channel, (uint16_t)((dutyCycle * PINMAP_Q15_ONE + 50) / 100));
 
   pwm_channels[channel].dutyCycle = dutyCycle;
   return true;
@@ -171,8 +329,8 @@ bool HAL_TimerSetFrequency(uint8_t channel, uint32_t frequency) {
     return false;
   }
 
-  // Frequency changes require timer reconfiguration - not implemented yet
-  // Return false for now to prevent runtime errors
+  // The timer may be shared with other channels of the same class;
+  // changing it would retune them too, so this is not supported
   return false;
 }
 
@@ -181,11 +339,19 @@ bool HAL_TimerRelease(uint8_t channel) {
     return false;
   }
 
-  ledc_stop(LEDC_HIGH_SPEED_MODE, (ledc_channel_t)channel, 0);
+  ledc_stop(pwm_mode(channel), pwm_group_channel(channel), 0);
+
+  portENTER_CRITICAL(&pwm_mux);
+  uint8_t timer = pwm_channels[channel].timer;
+  if (pwm_timers[timer].users)
+    pwm_timers[timer].users--;
   pwm_channels[channel].allocated = false;
   pwm_channels[channel].pin = 0;
   pwm_channels[channel].frequency = 0;
+  pwm_channels[channel].resolution = 0;
+  pwm_channels[channel].duty = 0;
   pwm_channels[channel].dutyCycle = 0;
+  portEXIT_CRITICAL(&pwm_mux);
 
   return true;
 }
@@ -200,6 +366,21 @@ uint8_t HAL_TimerReleaseAll(void) {
   return count;
 }
 
+IRAM_ATTR void HAL_PWMEmergencyStop(void) {
+  // Same as ledc_stop(.., 0) without the driver's lock: the output drops to
+  // the idle level at once instead of at the end of the PWM period
+  for (uint8_t ch = 0; ch < MAX_PWM_CHANNELS; ch++) {
+    if (!pwm_channels[ch].allocated)
+      continue;
+    ledc_mode_t mode = pwm_mode(ch);
+    ledc_channel_t gch = pwm_group_channel(ch);
+    ledc_ll_set_idle_level(&LEDC, mode, gch, 0);
+    ledc_ll_set_sig_out_en(&LEDC, mode, gch, false);
+    if (mode == LEDC_LOW_SPEED_MODE)
+      ledc_ll_ls_channel_update(&LEDC, mode, gch);
+  }
+}
+
 // ============================================================================
 // I2C Bus Operations
 // ============================================================================
@@ -216,6 +397,92 @@ bool HAL_I2CInit(uint8_t sda, uint8_t scl, uint32_t frequency) {
   return true;
 }
 
+// Runs on the bus owner (or inline before the queue is started)
+static HAL_I2CError i2c_execute(const HAL_I2CTransaction *t) {
+  if (t->timeoutMs)
+    i2c_bus->setTimeOut(t->timeoutMs);
+
+  if (t->txLen || !t->rxLen) {
+    const uint8_t *tx = t->txExt ? t->txExt : t->tx;
+    i2c_bus->beginTransmission(t->slaveAddr);
+    if (t->txLen)
+      i2c_bus->write(tx, t->txLen);
+    // Repeated start when a read follows
+    uint8_t status = i2c_bus->endTransmission(t->rxLen == 0);
+    if (status == 5)
+      return HAL_I2C_TIMEOUT;
+    if (status == 4)
+      return HAL_I2C_BUS_ERROR;
+    if (status != 0)
+      return HAL_I2C_NO_ACK;
+  }
+
+  if (t->rxLen) {
+    uint8_t received = i2c_bus->requestFrom(t->slaveAddr, t->rxLen);
+    if (received != t->rxLen)
+      return HAL_I2C_NO_ACK;
+    for (uint8_t i = 0; i < received; i++)
+      t->rx[i] = i2c_bus->read();
+  }
+  return HAL_I2C_OK;
+}
+
+static void i2c_complete(const HAL_I2CTransaction *t, HAL_I2CError result) {
+  portENTER_CRITICAL(&i2c_stats_mux);
+  if (result == HAL_I2C_OK)
+    i2c_stats.completed++;
+  else
+    i2c_stats.failed++;
+  portEXIT_CRITICAL(&i2c_stats_mux);
+
+  if (t->callback)
+    t->callback(result, t->ctx);
+}
+
+static void i2c_task_fn(void *arg) {
+  HAL_I2CTransaction t;
+  for (;;) {
+    if (xQueueReceive(i2c_queue, &t, portMAX_DELAY) == pdTRUE)
+      i2c_complete(&t, i2c_execute(&t));
+  }
+}
+
+static bool i2c_inline(void) {
+  return !i2c_queue || xTaskGetCurrentTaskHandle() == i2c_task;
+}
+
+// Blocking wrapper: queue the transaction and sleep until it completes
+typedef struct {
+  TaskHandle_t waiter;
+  HAL_I2CError result;
+} I2CSyncWait;
+
+static void i2c_sync_done(HAL_I2CError result, void *ctx) {
+  I2CSyncWait *w = (I2CSyncWait *)ctx;
+  w->result = result;
+  xTaskNotifyGive(w->waiter);
+}
+
+static HAL_I2CError i2c_run(HAL_I2CTransaction *t) {
+  if (!i2c_initialized)
+    return HAL_I2C_BUS_ERROR;
+  if (i2c_inline()) {
+    HAL_I2CError result = i2c_execute(t);
+    i2c_complete(t, result);
+    return result;
+  }
+
+  I2CSyncWait w = {xTaskGetCurrentTaskHandle(), HAL_I2C_BUS_ERROR};
+  t->callback = i2c_sync_done;
+  t->ctx = &w;
+  TickType_t wait = pdMS_TO_TICKS(t->timeoutMs ? t->timeoutMs : 100);
+  if (xQueueSend(i2c_queue, t, wait) != pdTRUE)
+    return HAL_I2C_TIMEOUT;
+  // Always completes: the driver enforces its own timeout
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  return w.result;
+}
+
 uint8_t HAL_I2CScan(uint8_t *addresses) {
   if (!i2c_initialized || !addresses) {
     return 0;
@@ -223,32 +490,32 @@ uint8_t HAL_I2CScan(uint8_t *addresses) {
 
   uint8_t count = 0;
   for (uint8_t addr = 1; addr < 127; addr++) {
-    Wire.beginTransmission(addr);
-    if (Wire.endTransmission() == 0) {
+    if (HAL_I2CProbe(addr, 10) == HAL_I2C_OK) {
       addresses[count++] = addr;
     }
   }
   return count;
 }
 
+HAL_I2CError HAL_I2CProbe(uint8_t slaveAddr, uint32_t timeout) {
+  HAL_I2CTransaction t = {};
+  t.slaveAddr = slaveAddr;
+  t.timeoutMs = (uint16_t)timeout;
+  return i2c_run(&t);
+}
+
 HAL_I2CError HAL_I2CWrite(uint8_t slaveAddr, const uint8_t *data,
                           uint8_t length, uint32_t timeout) {
   if (!i2c_initialized || !data) {
     return HAL_I2C_BUS_ERROR;
   }
 
-  uint32_t start = millis();
-  Wire.beginTransmission(slaveAddr);
-  Wire.write(data, length);
-  uint8_t status = Wire.endTransmission();
-
-  if (status == 0) {
-    return HAL_I2C_OK;
-  } else if (status == 4) {
-    return HAL_I2C_BUS_ERROR;
-  } else {
-    return HAL_I2C_NO_ACK;
-  }
+  HAL_I2CTransaction t = {};
+  t.slaveAddr = slaveAddr;
+  t.txLen = length;
+  t.txExt = data;
+  t.timeoutMs = (uint16_t)timeout;
+  return i2c_run(&t);
 }
 
 int HAL_I2CRead(uint8_t slaveAddr, uint8_t *buffer, uint8_t length,
@@ -257,27 +524,97 @@ int HAL_I2CRead(uint8_t slaveAddr, uint8_t *buffer, uint8_t length,
     return -1;
   }
 
-  size_t received = Wire.requestFrom(slaveAddr, (size_t)length);
-  if (received != length) {
+  HAL_I2CTransaction t = {};
+  t.slaveAddr = slaveAddr;
+  t.rxLen = length;
+  t.rx = buffer;
+  t.timeoutMs = (uint16_t)timeout;
+  if (i2c_run(&t) != HAL_I2C_OK) {
     return -1; // Didn't receive expected number of bytes
   }
-
-  for (int i = 0; i < received; i++) {
-    buffer[i] = Wire.read();
-  }
-
-  return (int)received;
+  return (int)length;
 }
 
 int HAL_I2CReadReg(uint8_t slaveAddr, uint8_t regAddr, uint8_t *buffer,
                    uint8_t length, uint32_t timeout) {
-  // Write register address
-  if (HAL_I2CWrite(slaveAddr, &regAddr, 1, timeout) != HAL_I2C_OK) {
+  if (!i2c_initialized || !buffer) {
     return -1;
   }
 
-  // Read data
-  return HAL_I2CRead(slaveAddr, buffer, length, timeout);
+  // Register write + read in one transaction (repeated start)
+  HAL_I2CTransaction t = {};
+  t.slaveAddr = slaveAddr;
+  t.txLen = 1;
+  t.tx[0] = regAddr;
+  t.rxLen = length;
+  t.rx = buffer;
+  t.timeoutMs = (uint16_t)timeout;
+  if (i2c_run(&t) != HAL_I2C_OK) {
+    return -1;
+  }
+  return (int)length;
+}
+
+bool HAL_I2CStartQueue(uint8_t priority, uint8_t core) {
+  if (!i2c_initialized) {
+    return false;
+  }
+  if (i2c_queue) {
+    return true; // Already running
+  }
+
+  QueueHandle_t queue =
+      xQueueCreate(HAL_I2C_QUEUE_DEPTH, sizeof(HAL_I2CTransaction));
+  if (!queue) {
+    return false;
+  }
+  i2c_queue = queue;
+  MemoryProfiler_setTaskStackSize("i2c", HAL_I2C_TASK_STACK);
+  if (xTaskCreatePinnedToCore(i2c_task_fn, "i2c", HAL_I2C_TASK_STACK, nullptr, priority,
+                              &i2c_task, core) != pdPASS) {
+    i2c_queue = nullptr;
+    vQueueDelete(queue);
+    return false;
+  }
+  return true;
+}
+
+bool HAL_I2CSubmit(const HAL_I2CTransaction *txn) {
+  if (!i2c_initialized || !txn) {
+    return false;
+  }
+  if (txn->txLen > HAL_I2C_TXN_MAX_TX && !txn->txExt) {
+    return false;
+  }
+  if (txn->rxLen && !txn->rx) {
+    return false;
+  }
+
+  if (i2c_inline()) {
+    i2c_complete(txn, i2c_execute(txn));
+    return true;
+  }
+
+  if (xQueueSend(i2c_queue, txn, 0) != pdTRUE) {
+    portENTER_CRITICAL(&i2c_stats_mux);
+    i2c_stats.rejected++;
+    portEXIT_CRITICAL(&i2c_stats_mux);
+    return false;
+  }
+
+  uint8_t waiting = (uint8_t)uxQueueMessagesWaiting(i2c_queue);
+  portENTER_CRITICAL(&i2c_stats_mux);
+  if (waiting > i2c_stats.highWater)
+    i2c_stats.highWater = waiting;
+  portEXIT_CRITICAL(&i2c_stats_mux);
+  return true;
+}
+
+HAL_I2CQueueStats HAL_I2CGetQueueStats(void) {
+  portENTER_CRITICAL(&i2c_stats_mux);
+  HAL_I2CQueueStats copy = i2c_stats;
+  portEXIT_CRITICAL(&i2c_stats_mux);
+  return copy;
 }
 
 bool HAL_I2CDeinit(void) {
@@ -287,41 +624,193 @@ bool HAL_I2CDeinit(void) {
   return true;
 }
 
+// ============================================================================
+// Quadrature Encoders (ESP32 PCNT)
+// ============================================================================
+
+static void IRAM_ATTR encoder_isr(void *arg) {
+  uint8_t unit = (uint8_t)(uintptr_t)arg;
+  uint32_t status = 0;
+  pcnt_get_event_status((pcnt_unit_t)unit, &status);
+  // The counter has already gone back to 0
+  if (status & PCNT_EVT_H_LIM)
+    encoder_base[unit] += HAL_ENCODER_LIMIT;
+  else if (status & PCNT_EVT_L_LIM)
+    encoder_base[unit] -= HAL_ENCODER_LIMIT;
+}
+
+int HAL_EncoderAttach(uint8_t pinA, uint8_t pinB, uint16_t filterNs) {
+  if (encoder_count >= HAL_ENCODER_MAX)
+    return -1;
+  pcnt_unit_t unit = (pcnt_unit_t)encoder_count;
+
+  // x4 decoding: each channel counts both edges of its pin, the other
+  // pin's level gives the direction
+  pcnt_config_t config = {};
+  config.unit = unit;
+  config.counter_h_lim = HAL_ENCODER_LIMIT;
+  config.counter_l_lim = -HAL_ENCODER_LIMIT;
+  config.channel = PCNT_CHANNEL_0;
+  config.pulse_gpio_num = pinA;
+  config.ctrl_gpio_num = pinB;
+  config.pos_mode = PCNT_COUNT_DEC;
+  config.neg_mode = PCNT_COUNT_INC;
+  config.lctrl_mode = PCNT_MODE_REVERSE;
+  config.hctrl_mode = PCNT_MODE_KEEP;
+  if (pcnt_unit_config(&config) != ESP_OK)
+    return -1;
+  config.channel = PCNT_CHANNEL_1;
+  config.pulse_gpio_num = pinB;
+  config.ctrl_gpio_num = pinA;
+  config.pos_mode = PCNT_COUNT_INC;
+  config.neg_mode = PCNT_COUNT_DEC;
+  if (pcnt_unit_config(&config) != ESP_OK)
+    return -1;
+
+  // Filter in APB cycles (12.5 ns, 10 bits)
+  uint32_t cycles = filterNs / 12.5f;
+  if (cycles) {
+    pcnt_set_filter_value(unit, cycles > 1023 ? 1023 : cycles);
+    pcnt_filter_enable(unit);
+  } else {
+    pcnt_filter_disable(unit);
+  }
+
+  pcnt_event_enable(unit, PCNT_EVT_H_LIM);
+  pcnt_event_enable(unit, PCNT_EVT_L_LIM);
+  pcnt_counter_pause(unit);
+  pcnt_counter_clear(unit);
+  encoder_base[unit] = 0;
+  static bool serviceInstalled = false;
+  if (!serviceInstalled) {
+    if (pcnt_isr_service_install(0) != ESP_OK)
+      return -1;
+    serviceInstalled = true;
+  }
+  pcnt_isr_handler_add(unit, encoder_isr, (void *)(uintptr_t)unit);
+  pcnt_intr_enable(unit);
+  pcnt_counter_resume(unit);
+  return encoder_count++;
+}
+
+int32_t HAL_EncoderRead(uint8_t encoder) {
+  if (encoder >= encoder_count)
+    return 0;
+  // Retry if an overflow landed between the two reads
+  int32_t base;
+  int16_t count;
+  do {
+    base = encoder_base[encoder];
+    pcnt_get_counter_value((pcnt_unit_t)encoder, &count);
+  } while (base != encoder_base[encoder]);
+  return base + count;
+}
+
 // ============================================================================
 // ADC / Analog Input Operations
 // ============================================================================
 
+static_assert(SOC_ADC_CHANNEL_NUM(0) <= HAL_ADC_CHANNELS, "ADC1 channel table too small");
+
+// ADC1 channel of a pin, -1 if it has none (ADC2 channels map to 10+)
+static int adc_channel(uint8_t pin) {
+  int channel = digitalPinToAnalogChannel(pin);
+  return channel >= 0 && channel < SOC_ADC_CHANNEL_NUM(0) ? channel : -1;
+}
+
+static uint32_t adc_cal_curve(uint32_t raw, void *ctx) {
+  return esp_adc_cal_raw_to_voltage(raw, (const esp_adc_cal_characteristics_t *)ctx);
+}
+
+// Oversampled 12-bit code
+static uint16_t adc_sample(int channel) {
+  uint8_t n = adc_channels[channel].oversample;
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < n; i++)
+    sum += adc1_get_raw((adc1_channel_t)channel);
+  return AdcCal_average(sum, n);
+}
+
 bool HAL_ADCInit(uint8_t pin, uint8_t resolution) {
-  if (pin >= MAX_ADC_PINS) {
+  int channel = adc_channel(pin);
+  if (channel < 0 || resolution < 8 || resolution > 12) {
+    return false;
+  }
+
+  if (!adc_characterized) {
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    esp_adc_cal_value_t source = esp_adc_cal_characterize(
+        ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, HAL_ADC_DEFAULT_VREF_MV, &adc_chars);
+    // The S3 reports its two-point eFuse data as TP_FIT
+    adc_cal_source = source == ESP_ADC_CAL_VAL_EFUSE_TP || source == ESP_ADC_CAL_VAL_EFUSE_TP_FIT
+                         ? HAL_ADC_CAL_EFUSE_TP
+                     : source == ESP_ADC_CAL_VAL_EFUSE_VREF ? HAL_ADC_CAL_EFUSE_VREF
+                                                            : HAL_ADC_CAL_DEFAULT;
+    adc_characterized = true;
+  }
+  if (adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11) != ESP_OK) {
     return false;
   }
 
-  analogReadResolution(resolution);
-  adc_pins[pin].initialized = true;
-  adc_pins[pin].resolution = resolution;
+  // Sampled once here, a table lookup per conversion afterwards
+  AdcCal_build(&adc_channels[channel].lut, adc_cal_curve, &adc_chars);
+  adc_channels[channel].resolution = resolution;
+  adc_channels[channel].oversample = 1;
+  adc_channels[channel].initialized = true;
+  return true;
+}
+
+bool HAL_ADCSetOversampling(uint8_t pin, uint8_t samples) {
+  int channel = adc_channel(pin);
+  if (channel < 0 || !adc_channels[channel].initialized) {
+    return false;
+  }
+  adc_channels[channel].oversample = AdcCal_sanitizeOversample(samples);
   return true;
 }
 
 bool HAL_ADCRead(uint8_t pin, uint16_t *rawValue) {
-  if (!adc_pins[pin].initialized || !rawValue) {
+  int channel = adc_channel(pin);
+  if (channel < 0 || !adc_channels[channel].initialized || !rawValue) {
+    return false;
+  }
+
+  *rawValue = adc_sample(channel) >> (12 - adc_channels[channel].resolution);
+  return true;
+}
+
+bool HAL_ADCReadMillivolts(uint8_t pin, uint16_t *millivolts) {
+  int channel = adc_channel(pin);
+  if (channel < 0 || !adc_channels[channel].initialized || !millivolts) {
     return false;
   }
 
-  *rawValue = analogRead(pin);
+  *millivolts = AdcCal_toMillivolts(&adc_channels[channel].lut, adc_sample(channel));
   return true;
 }
 
+uint16_t HAL_ADCToMillivolts(uint8_t pin, uint16_t rawValue) {
+  int channel = adc_channel(pin);
+  if (channel < 0 || !adc_channels[channel].initialized) {
+    return 0;
+  }
+  return AdcCal_toMillivolts(&adc_channels[channel].lut, rawValue);
+}
+
+HAL_ADCCalSource HAL_ADCGetCalSource(void) { return adc_cal_source; }
+
 float HAL_ADCToVoltage(uint16_t rawValue, float refVoltage) {
   // ESP32 is 12-bit ADC by default (0-4095)
   return (float)rawValue * refVoltage / 4095.0f;
 }
 
 bool HAL_ADCDeinit(uint8_t pin) {
-  if (pin >= MAX_ADC_PINS) {
+  int channel = adc_channel(pin);
+  if (channel < 0) {
     return false;
   }
 
-  adc_pins[pin].initialized = false;
+  adc_channels[channel].initialized = false;
   return true;
 }
 
@@ -368,9 +857,17 @@ bool HAL_SerialDeinit(void) {
 // System/Timing Functions
 // ============================================================================
 
-uint32_t HAL_GetMillis(void) { return millis(); }
+uint32_t HAL_GetMillis(void) { return (uint32_t)(esp_timer_get_time() / 1000); }
+
+uint32_t HAL_GetMicros(void) { return (uint32_t)esp_timer_get_time(); }
+
+HAL_Micros IRAM_ATTR HAL_Now(void) { return esp_timer_get_time(); }
 
-uint32_t HAL_GetMicros(void) { return micros(); }
+uint32_t IRAM_ATTR HAL_GetCycles(void) { return xthal_get_ccount(); }
+
+uint32_t HAL_CyclesToMicros(uint32_t cycles) {
+  return cycles / getCpuFrequencyMhz();
+}
 
 void HAL_Delay(uint32_t milliseconds) { delay(milliseconds); }
 
@@ -93,8 +93,79 @@ typedef struct {
     uint8_t dutyCycle;       // Duty cycle 0-100%
 } HAL_TimerChannel;
 
+/*
+ * All LEDC output goes through one registry: 16 channels in two groups
+ * (0-7 high speed, 8-15 low speed, same numbering as the Arduino ledc*
+ * API; the ESP32-S3 has only the low-speed group, channels 0-7), each
+ * group has 4 timers. A channel is placed on a timer that
+ * already runs the requested frequency and resolution if there is one,
+ * otherwise on a free timer, so e.g. all motors share one timer and all
+ * servos another. Drivers request channels here and never pick numbers.
+ *
+ * Duty is in native ticks, 0 .. 2^resolution (2^resolution = always
+ * high), or Q15 through HAL_PWMWriteQ15. A write goes to the duty
+ * register and only starts at the next period boundary, so a period is
+ * never cut short or stretched; no fade is ever programmed.
+ */
+
+/**
+ * Allocate a PWM channel with an explicit resolution
+ * @param pin GPIO pin number for PWM output
+ * @param frequency PWM frequency in Hz
+ * @param resolution Duty resolution in bits (1-16)
+ * @return Channel ID (0-15) on success, -1 if the pin is taken or no
+ *         channel / timer fits
+ */
+int HAL_PWMAllocate(uint8_t pin, uint32_t frequency, uint8_t resolution);
+
+/**
+ * Allocate a PWM channel at the finest resolution the frequency allows
+ * (floor(log2(80 MHz / frequency)), at most 16 bits)
+ * @return Channel ID (0-15), -1 as HAL_PWMAllocate or if the frequency
+ *         is above 40 MHz
+ */
+int HAL_PWMAllocateMax(uint8_t pin, uint32_t frequency);
+
+/**
+ * Write a duty in ticks (0 .. 2^resolution, larger clamps), taking
+ * effect at the next period
+ * @param channel Channel from HAL_PWMAllocate / HAL_TimerAllocate
+ * @return true on success, false if not allocated
+ */
+bool HAL_PWMWrite(uint8_t channel, uint32_t duty);
+
+/**
+ * Write a Q15 duty (0 .. 32768 = 100 %) at the channel's resolution
+ * @return true on success, false if not allocated
+ */
+bool HAL_PWMWriteQ15(uint8_t channel, uint16_t q15);
+
+/**
+ * Duty resolution of an allocated channel in bits, 0 if not allocated
+ */
+uint8_t HAL_PWMGetResolution(uint8_t channel);
+
+/**
+ * Registry snapshot of one channel
+ */
+typedef struct {
+    bool allocated;
+    uint8_t pin;
+    uint8_t timer;           // 0-3 high speed, 4-7 low speed
+    uint32_t frequency;
+    uint8_t resolution;
+    uint32_t duty;           // Raw counts
+} HAL_PWMChannelInfo;
+
+/**
+ * Read the registry entry of a channel (0-15)
+ * @return false if channel is out of range
+ */
+bool HAL_PWMGetChannelInfo(uint8_t channel, HAL_PWMChannelInfo* info);
+
 /**
  * Allocate a timer channel for PWM output
+ * (finest resolution for the frequency; see HAL_PWMAllocateMax)
  * @param pin GPIO pin number for PWM output
  * @param frequency PWM frequency in Hz (e.g., 20000 for motor, 50 for servo)
  * @param initialDuty Initial duty cycle 0-100%
@@ -138,6 +209,15 @@ bool HAL_TimerRelease(uint8_t channel);
  */
 uint8_t HAL_TimerReleaseAll(void);
 
+/**
+ * Drive every allocated PWM output low immediately (watchdog pre-reset)
+ *
+ * Register writes only: no lock, no driver call, safe from an ISR or a
+ * task that interrupted a stuck PWM update. Channels stay allocated; the
+ * next HAL_PWMWrite does not re-enable them, a reset is expected.
+ */
+void HAL_PWMEmergencyStop(void);
+
 // ============================================================================
 // I2C Bus Operations
 // ============================================================================
@@ -169,6 +249,14 @@ bool HAL_I2CInit(uint8_t sda, uint8_t scl, uint32_t frequency);
  */
 uint8_t HAL_I2CScan(uint8_t* addresses);
 
+/**
+ * Probe for a device (address-only write)
+ * @param slaveAddr 7-bit I2C slave address
+ * @param timeout Timeout in milliseconds
+ * @return HAL_I2C_OK if the device acknowledged
+ */
+HAL_I2CError HAL_I2CProbe(uint8_t slaveAddr, uint32_t timeout);
+
 /**
  * Write data to I2C device (master transmit)
  * @param slaveAddr 7-bit I2C slave address
@@ -209,20 +297,137 @@ int HAL_I2CReadReg(uint8_t slaveAddr, uint8_t regAddr, uint8_t* buffer,
  */
 bool HAL_I2CDeinit(void);
 
+// ----------------------------------------------------------------------------
+// I2C Transaction Queue
+// ----------------------------------------------------------------------------
+//
+// One bus task owns the I2C port and runs transactions in FIFO order, so
+// every device on the bus (MS5837, MPU6050, PCA9685, OLED) is serialized
+// through a single owner. Callers submit and carry on computing while the
+// bus task waits on the (interrupt driven) driver.
+//
+// The blocking calls above go through the same queue once it is started
+// and wait for their own transaction. Before HAL_I2CStartQueue(), or when
+// called from a completion callback, transactions run inline.
+
+#define HAL_I2C_QUEUE_DEPTH     16
+#define HAL_I2C_TASK_STACK      3072 // bytes
+#define HAL_I2C_TXN_MAX_TX      8   // Inline write bytes (register + data)
+
+/**
+ * Transaction completion callback (bus task context, keep it short)
+ * @param result HAL_I2C_OK or error
+ * @param ctx Caller context from the transaction
+ */
+typedef void (*HAL_I2CCallback)(HAL_I2CError result, void* ctx);
+
+/**
+ * One bus transaction: optional write, then optional read (repeated start)
+ */
+typedef struct {
+    uint8_t slaveAddr;
+    uint8_t txLen;                  // Bytes to write (0 = read only)
+    uint8_t tx[HAL_I2C_TXN_MAX_TX]; // Write data, copied at submit
+    const uint8_t* txExt;           // Longer write data, valid until callback
+    uint8_t rxLen;                  // Bytes to read (0 = write only)
+    uint8_t* rx;                    // Read buffer, valid until callback
+    uint16_t timeoutMs;
+    HAL_I2CCallback callback;       // May be NULL
+    void* ctx;
+} HAL_I2CTransaction;
+
+/**
+ * I2C queue statistics
+ */
+typedef struct {
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t rejected;      // Queue full at submit
+    uint8_t highWater;      // Most transactions waiting at once
+} HAL_I2CQueueStats;
+
+/**
+ * Start the bus owner task (call after HAL_I2CInit)
+ * @param priority FreeRTOS priority of the bus task
+ * @param core Core to pin the bus task to
+ * @return true if running
+ */
+bool HAL_I2CStartQueue(uint8_t priority, uint8_t core);
+
+/**
+ * Queue a transaction without waiting
+ * @param txn Transaction (copied; rx/txExt buffers must stay valid)
+ * @return false if the bus is not initialized or the queue is full
+ */
+bool HAL_I2CSubmit(const HAL_I2CTransaction* txn);
+
+/**
+ * Get I2C queue statistics
+ */
+HAL_I2CQueueStats HAL_I2CGetQueueStats(void);
+
+// ============================================================================
+// Quadrature Encoders (ESP32 PCNT)
+// ============================================================================
+
+// The pulse counter decodes A / B in hardware (both edges of both
+// channels: 4 counts per encoder line) with no interrupt per edge. Its
+// 16-bit counter is widened to 32 bits by an interrupt at +-limit, a few
+// per second at most.
+#define HAL_ENCODER_MAX         4       // PCNT units claimed, from unit 0
+#define HAL_ENCODER_LIMIT       30000   // Counts between overflow interrupts
+
+/**
+ * Attach a quadrature encoder
+ * @param pinA Channel A GPIO
+ * @param pinB Channel B GPIO
+ * @param filterNs Glitch filter, ignores pulses shorter than this (0-12000)
+ * @return Encoder index, or -1 if the pins / units are exhausted
+ */
+int HAL_EncoderAttach(uint8_t pinA, uint8_t pinB, uint16_t filterNs);
+
+/**
+ * Counts since attach, + when A leads B (safe on any task)
+ * @return 0 for an unknown encoder
+ */
+int32_t HAL_EncoderRead(uint8_t encoder);
+
 // ============================================================================
 // ADC / Analog Input Operations
 // ============================================================================
 
+// ADC1 only (ESP32: GPIO 32-39, 8 channels; ESP32-S3: GPIO 1-10, 10
+// channels): ADC2 belongs to the Wi-Fi driver. Each channel is read at
+// 12 bits / 11 dB and converted through its own AdcCal table, built at
+// init from the chip's eFuse characterization.
+#define HAL_ADC_CHANNELS            10
+#define HAL_ADC_DEFAULT_VREF_MV     1100    // Used when the eFuse holds nothing
+
+/**
+ * Where the ADC calibration came from
+ */
+typedef enum {
+  HAL_ADC_CAL_DEFAULT = 0,      // Nominal Vref (no eFuse data)
+  HAL_ADC_CAL_EFUSE_VREF = 1,   // Measured Vref
+  HAL_ADC_CAL_EFUSE_TP = 2      // Two-point values
+} HAL_ADCCalSource;
+
 /**
- * Initialize ADC on specified pin
- * @param pin GPIO pin number (ADC-capable)
- * @param resolution Resolution in bits (8, 10, 12)
+ * Initialize ADC on specified pin and build its calibration table
+ * @param pin GPIO pin number (ADC1: 32-39, S3: 1-10)
+ * @param resolution Resolution of HAL_ADCRead in bits (8-12)
  * @return true on success, false on error
  */
 bool HAL_ADCInit(uint8_t pin, uint8_t resolution);
 
 /**
- * Read analog value from ADC
+ * Samples averaged per HAL_ADCRead / HAL_ADCReadMillivolts (1-64, default 1)
+ * @return false if the pin is not initialized
+ */
+bool HAL_ADCSetOversampling(uint8_t pin, uint8_t samples);
+
+/**
+ * Read analog value from ADC (oversampled, at the init resolution)
  * @param pin GPIO pin number
  * @param rawValue Pointer to store raw ADC reading
  * @return true on success, false on error
@@ -230,7 +435,26 @@ bool HAL_ADCInit(uint8_t pin, uint8_t resolution);
 bool HAL_ADCRead(uint8_t pin, uint16_t* rawValue);
 
 /**
- * Convert raw ADC value to voltage
+ * Read calibrated millivolts at the pin (oversampled)
+ * @return true on success, false on error
+ */
+bool HAL_ADCReadMillivolts(uint8_t pin, uint16_t* millivolts);
+
+/**
+ * Calibrated millivolts of a 12-bit code sampled elsewhere (e.g. DMA)
+ * Integer table lookup, safe on any task.
+ * @return 0 if the pin is not initialized
+ */
+uint16_t HAL_ADCToMillivolts(uint8_t pin, uint16_t rawValue);
+
+/**
+ * Calibration source of the ADC1 / 11 dB characterization
+ */
+HAL_ADCCalSource HAL_ADCGetCalSource(void);
+
+/**
+ * Convert raw ADC value to voltage (uncalibrated, linear)
+ * Prefer HAL_ADCToMillivolts: this is off by up to ~200 mV.
  * @param rawValue Raw ADC reading
  * @param refVoltage Reference voltage (typically 3.3V)
  * @return Voltage in volts
@@ -295,13 +519,13 @@ bool HAL_SerialDeinit(void);
 
 /**
  * Get system uptime in milliseconds
- * @return Milliseconds since boot (uint32_t, will wrap after ~49 days)
+ * @return Milliseconds since boot (HAL_Now() / 1000, wraps after ~49 days)
  */
 uint32_t HAL_GetMillis(void);
 
 /**
  * Get system uptime in microseconds
- * @return Microseconds since boot (uint32_t, will wrap after ~71 minutes)
+ * @return Low 32 bits of HAL_Now() (wraps after ~71 minutes: intervals only)
  */
 uint32_t HAL_GetMicros(void);
 
@@ -329,4 +553,67 @@ const char* HAL_GetPlatformName(void);
  */
 const char* HAL_GetPlatformInfo(void);
 
+// ============================================================================
+// Time Base
+// ============================================================================
+//
+// One clock for the whole firmware: HAL_Now() is the 64-bit esp_timer
+// count, HAL_GetMillis() / HAL_GetMicros() are truncations of it. Store
+// absolute times as HAL_Micros (never wraps); subtract uint32 stamps only
+// for intervals well under the wrap. HAL_GetCycles() is the core-local
+// fast path for deltas inside one task (wraps every ~18 s at 240 MHz).
+
+typedef int64_t HAL_Micros;     // Monotonic microseconds since boot
+
+/**
+ * Get monotonic time in microseconds (64-bit, never wraps)
+ * Safe from any task or ISR.
+ */
+HAL_Micros HAL_Now(void);
+
+/**
+ * Get the CPU cycle counter of the calling core
+ * Only compare values read on the same core.
+ */
+uint32_t HAL_GetCycles(void);
+
+/**
+ * Convert a cycle delta to microseconds at the current CPU frequency
+ */
+uint32_t HAL_CyclesToMicros(uint32_t cycles);
+
+/**
+ * Microseconds from since to now, 0 if now is earlier
+ */
+static inline HAL_Micros HAL_Elapsed(HAL_Micros since, HAL_Micros now) {
+  return now > since ? now - since : 0;
+}
+
+/**
+ * Microsecond interval to milliseconds (saturates at UINT32_MAX)
+ */
+static inline uint32_t HAL_MicrosToMillis(HAL_Micros us) {
+  if (us <= 0) return 0;
+  return us / 1000 > 0xFFFFFFFFLL ? 0xFFFFFFFFUL : (uint32_t)(us / 1000);
+}
+
+/**
+ * Microsecond interval to seconds
+ */
+static inline float HAL_MicrosToSeconds(HAL_Micros us) {
+  return (float)us * 1e-6f;
+}
+
+/**
+ * Time step for an integrator or PID: seconds since *last, then *last = now
+ * @param fallbackS Step for the first call (*last == 0)
+ * @param maxS      Clamp after a stall so one step cannot explode
+ */
+static inline float HAL_StepSeconds(HAL_Micros* last, HAL_Micros now, float fallbackS,
+                                  float maxS) {
+  float dt = *last ? HAL_MicrosToSeconds(HAL_Elapsed(*last, now)) : fallbackS;
+  *last = now;
+  return dt > maxS ? maxS : dt;
+}
+
 #endif  // HAL_H
@@ -2,16 +2,22 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "CryptoBackend.h"
+#include "mbedtls/base64.h"
 #include "mbedtls/error.h"
-#include "mbedtls/md.h"
 
 /**
  * HMACValidator - HMAC-SHA256 Implementation
  *
  * Phase 9 Full Implementation:
- * - HMAC-SHA256 authentication using mbedtls
+ * - HMAC-SHA256 authentication via CryptoBackend (ESP32 SHA engine or
+ *   software with precomputed ipad/opad states)
  * - Constant-time comparison to prevent timing attacks
  *
+ * The key state is prepared once in HMACValidator_init() / setKeys() and
+ * only read per message, so concurrent callers (control + telemetry tasks)
+ * are safe. Validation uses the receive key, generation the transmit key.
+ *
  * @file HMACValidator.cpp
  */
 
@@ -19,6 +25,10 @@ static struct {
   uint8_t secret[32];
   bool initialized;
   char lastError[128];
+  CryptoHmacKey rxKey;    // validate (controller -> vehicle, serial commands)
+  CryptoHmacKey txKey;    // generate (vehicle -> controller)
+  CryptoHmacKey peerKeys[HMAC_PEER_KEY_SETS];  // validateFrom, per radio peer
+  bool peerReady[HMAC_PEER_KEY_SETS];
 } gHMACState = {.initialized = false, .lastError = {0}};
 
 // ============================================================================
@@ -32,6 +42,75 @@ static void set_last_error(const char *action, int ret) {
            "%s failed: -0x%04X (%s)", action, -ret, buf);
 }
 
+static size_t skip_ws(const char *s, size_t i, size_t len) {
+  while (i < len && (s[i] == ' ' || s[i] == '\t'))
+    i++;
+  return i;
+}
+
+/**
+ * Locate the "hmac" member of a JSON object line
+ *
+ * A literal ,"hmac" or {"hmac" cannot occur inside a JSON string (the quote
+ * would be escaped), so a plain scan is enough. A wrong match (e.g. nested
+ * object) only makes validation fail.
+ *
+ * @param cutStart Output: first byte of the span to remove
+ * @param cutEnd Output: one past the last byte to remove
+ * @param valStart Output: first base64 character
+ * @param valLen Output: base64 length
+ * @return true if found
+ */
+static bool find_hmac_member(const char *s, size_t len, size_t *cutStart,
+                             size_t *cutEnd, size_t *valStart,
+                             size_t *valLen) {
+  static const char kKey[] = "\"hmac\"";
+  const size_t keyLen = sizeof(kKey) - 1;
+
+  for (size_t i = 0; i + keyLen <= len; i++) {
+    if (memcmp(&s[i], kKey, keyLen) != 0)
+      continue;
+
+    // Must be a member name: preceded by '{' or ',' and followed by ':'
+    size_t p = i;
+    while (p > 0 && (s[p - 1] == ' ' || s[p - 1] == '\t'))
+      p--;
+    if (p == 0 || (s[p - 1] != '{' && s[p - 1] != ','))
+      continue;
+
+    size_t j = skip_ws(s, i + keyLen, len);
+    if (j >= len || s[j] != ':')
+      continue;
+    j = skip_ws(s, j + 1, len);
+    if (j >= len || s[j] != '"')
+      continue;
+
+    size_t vs = j + 1;
+    size_t ve = vs;
+    while (ve < len && s[ve] != '"')
+      ve++;
+    if (ve >= len)
+      return false;
+
+    *valStart = vs;
+    *valLen = ve - vs;
+    size_t end = ve + 1;
+
+    if (s[p - 1] == ',') {
+      // ...,"hmac":"..."  -> drop the leading comma
+      *cutStart = p - 1;
+      *cutEnd = end;
+    } else {
+      // {"hmac":"...", ... -> drop the trailing comma
+      *cutStart = i;
+      size_t k = skip_ws(s, end, len);
+      *cutEnd = (k < len && s[k] == ',') ? k + 1 : end;
+    }
+    return true;
+  }
+  return false;
+}
+
 // ============================================================================
 // Public API Implementation
 // ============================================================================
@@ -42,15 +121,58 @@ bool HMACValidator_init(const uint8_t *secret) {
              "NULL secret provided");
     return false;
   }
+  return HMACValidator_setKeys(secret, secret);
+}
+
+bool HMACValidator_setKeys(const uint8_t *rxKey, const uint8_t *txKey) {
+  if (!rxKey || !txKey) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "NULL secret provided");
+    return false;
+  }
+
+  gHMACState.initialized = false;
+  memcpy(gHMACState.secret, rxKey, 32);
+
+  int ret = CryptoBackend_hmacSetKey(&gHMACState.rxKey, rxKey, 32);
+  if (ret == 0)
+    ret = CryptoBackend_hmacSetKey(&gHMACState.txKey, txKey, 32);
+  if (ret != 0) {
+    set_last_error("HMAC key setup", ret);
+    return false;
+  }
 
-  memcpy(gHMACState.secret, secret, 32);
   gHMACState.initialized = true;
+  return true;
+}
 
+bool HMACValidator_setPeerKey(uint8_t set, const uint8_t *rxKey) {
+  if (set >= HMAC_PEER_KEY_SETS || !rxKey) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "Bad peer key set");
+    return false;
+  }
+
+  HMACValidator_clearPeerKey(set);
+  int ret = CryptoBackend_hmacSetKey(&gHMACState.peerKeys[set], rxKey, 32);
+  if (ret != 0) {
+    set_last_error("HMAC key setup", ret);
+    return false;
+  }
+
+  gHMACState.peerReady[set] = true;
   return true;
 }
 
-bool HMACValidator_generate(const uint8_t *data, uint16_t dataLen,
-                            uint8_t *hmac) {
+void HMACValidator_clearPeerKey(uint8_t set) {
+  if (set >= HMAC_PEER_KEY_SETS || !gHMACState.peerReady[set])
+    return;
+  gHMACState.peerReady[set] = false;
+  CryptoBackend_hmacFree(&gHMACState.peerKeys[set]);
+}
+
+static bool compute_hmac(const CryptoHmacKey *key, const uint8_t *data,
+                         uint16_t dataLen, uint8_t *hmac) {
 
   if (!data || !hmac) {
     snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
@@ -70,16 +192,7 @@ bool HMACValidator_generate(const uint8_t *data, uint16_t dataLen,
     return false;
   }
 
-  const mbedtls_md_info_t *md_info =
-      mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
-  if (md_info == NULL) {
-    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
-             "SHA256 not supported in mbedtls");
-    return false;
-  }
-
-  int ret =
-      mbedtls_md_hmac(md_info, gHMACState.secret, 32, data, dataLen, hmac);
+  int ret = CryptoBackend_hmacSha256(key, data, dataLen, hmac);
   if (ret != 0) {
     set_last_error("HMAC generate", ret);
     return false;
@@ -88,6 +201,11 @@ bool HMACValidator_generate(const uint8_t *data, uint16_t dataLen,
   return true;
 }
 
+bool HMACValidator_generate(const uint8_t *data, uint16_t dataLen,
+                            uint8_t *hmac) {
+  return compute_hmac(&gHMACState.txKey, data, dataLen, hmac);
+}
+
 bool HMACValidator_validate(const uint8_t *data, uint16_t dataLen,
                             const uint8_t *receivedHmac) {
 
@@ -105,7 +223,7 @@ bool HMACValidator_validate(const uint8_t *data, uint16_t dataLen,
 
   // Generate expected HMAC
   uint8_t expectedHmac[HMAC_SHA256_SIZE];
-  if (!HMACValidator_generate(data, dataLen, expectedHmac)) {
+  if (!compute_hmac(&gHMACState.rxKey, data, dataLen, expectedHmac)) {
     return false;
   }
 
@@ -113,6 +231,122 @@ bool HMACValidator_validate(const uint8_t *data, uint16_t dataLen,
   return HMACValidator_constantTimeCompare(expectedHmac, receivedHmac);
 }
 
+bool HMACValidator_validateFrom(uint8_t set, const uint8_t *data,
+                                uint16_t dataLen, const uint8_t *receivedHmac) {
+
+  if (!data || !receivedHmac) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "NULL pointer in validate params");
+    return false;
+  }
+
+  if (set >= HMAC_PEER_KEY_SETS || !gHMACState.peerReady[set]) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "No key for peer set %u", set);
+    return false;
+  }
+
+  if (dataLen > HMAC_MAX_PAYLOAD) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "Payload too large: %u > %u", dataLen, HMAC_MAX_PAYLOAD);
+    return false;
+  }
+
+  uint8_t expectedHmac[HMAC_SHA256_SIZE];
+  int ret = CryptoBackend_hmacSha256(&gHMACState.peerKeys[set], data, dataLen,
+                                     expectedHmac);
+  if (ret != 0) {
+    set_last_error("HMAC generate", ret);
+    return false;
+  }
+
+  return HMACValidator_constantTimeCompare(expectedHmac, receivedHmac);
+}
+
+bool HMACValidator_validateJsonLine(char *line, size_t *len) {
+  if (!line || !len) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "NULL pointer in validate params");
+    return false;
+  }
+
+  if (!gHMACState.initialized) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "HMAC not initialized");
+    return false;
+  }
+
+  size_t cutStart, cutEnd, valStart, valLen;
+  if (!find_hmac_member(line, *len, &cutStart, &cutEnd, &valStart, &valLen)) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "No hmac member in command");
+    return false;
+  }
+
+  uint8_t receivedHmac[HMAC_SHA256_SIZE];
+  size_t decodedLen = 0;
+  int ret = mbedtls_base64_decode(receivedHmac, sizeof(receivedHmac),
+                                  &decodedLen,
+                                  (const unsigned char *)&line[valStart],
+                                  valLen);
+  if (ret != 0 || decodedLen != HMAC_SHA256_SIZE) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "Malformed hmac member");
+    return false;
+  }
+
+  // Splice the member out in place
+  memmove(&line[cutStart], &line[cutEnd], *len - cutEnd);
+  *len -= cutEnd - cutStart;
+  line[*len] = '\0';
+
+  uint8_t expectedHmac[HMAC_SHA256_SIZE];
+  ret = CryptoBackend_hmacSha256(&gHMACState.rxKey, (const uint8_t *)line, *len,
+                                 expectedHmac);
+  if (ret != 0) {
+    set_last_error("HMAC generate", ret);
+    return false;
+  }
+
+  return HMACValidator_constantTimeCompare(expectedHmac, receivedHmac);
+}
+
+bool HMACValidator_validateBase64(const uint8_t *data, size_t len,
+                                  const char *hmacB64) {
+  if (!data || !hmacB64) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "NULL pointer in validate params");
+    return false;
+  }
+
+  if (!gHMACState.initialized) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "HMAC not initialized");
+    return false;
+  }
+
+  uint8_t receivedHmac[HMAC_SHA256_SIZE];
+  size_t decodedLen = 0;
+  int ret = mbedtls_base64_decode(receivedHmac, sizeof(receivedHmac),
+                                  &decodedLen,
+                                  (const unsigned char *)hmacB64,
+                                  strlen(hmacB64));
+  if (ret != 0 || decodedLen != HMAC_SHA256_SIZE) {
+    snprintf(gHMACState.lastError, sizeof(gHMACState.lastError),
+             "Malformed hmac");
+    return false;
+  }
+
+  uint8_t expectedHmac[HMAC_SHA256_SIZE];
+  ret = CryptoBackend_hmacSha256(&gHMACState.rxKey, data, len, expectedHmac);
+  if (ret != 0) {
+    set_last_error("HMAC generate", ret);
+    return false;
+  }
+
+  return HMACValidator_constantTimeCompare(expectedHmac, receivedHmac);
+}
+
 bool HMACValidator_constantTimeCompare(const uint8_t *hmac1,
                                        const uint8_t *hmac2) {
 
@@ -136,6 +370,10 @@ bool HMACValidator_isReady(void) { return gHMACState.initialized; }
 void HMACValidator_reset(void) {
   memset(gHMACState.secret, 0x00, 32);
   gHMACState.initialized = false;
+  CryptoBackend_hmacFree(&gHMACState.rxKey);
+  CryptoBackend_hmacFree(&gHMACState.txKey);
+  for (uint8_t i = 0; i < HMAC_PEER_KEY_SETS; i++)
+    HMACValidator_clearPeerKey(i);
   memset(gHMACState.lastError, 0x00, sizeof(gHMACState.lastError));
 }
 
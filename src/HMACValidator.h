@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * HMACValidator - HMAC-SHA256 packet authentication
@@ -18,14 +19,36 @@
 
 #define HMAC_SHA256_SIZE    32  // 256 bits / 32 bytes
 #define HMAC_MAX_PAYLOAD    64  // Max bytes to authenticate
+#define HMAC_PEER_KEY_SETS  4   // One per PeerSessionTable slot
 
 /**
- * Initialize HMAC validator with shared secret
+ * Initialize HMAC validator with shared secret (same key both directions)
  * @param secret 32-byte shared secret key
  * @return true if initialization successful
  */
 bool HMACValidator_init(const uint8_t* secret);
 
+/**
+ * Install directional session keys (SessionKeys)
+ * @param rxKey 32-byte key for validate / validateJsonLine
+ * @param txKey 32-byte key for generate
+ * @return true if initialization successful
+ */
+bool HMACValidator_setKeys(const uint8_t* rxKey, const uint8_t* txKey);
+
+/**
+ * Install the receive key of one radio peer (PeerSessionTable slot)
+ * @param set Key set index (0..HMAC_PEER_KEY_SETS-1)
+ * @param rxKey 32-byte key for validateFrom
+ * @return true if installed
+ */
+bool HMACValidator_setPeerKey(uint8_t set, const uint8_t* rxKey);
+
+/**
+ * Release the key of a peer set
+ */
+void HMACValidator_clearPeerKey(uint8_t set);
+
 /**
  * Generate HMAC-SHA256 for packet data
  * @param data Packet data to authenticate
@@ -52,6 +75,44 @@ bool HMACValidator_validate(
     const uint8_t* receivedHmac
 );
 
+/**
+ * Validate packet HMAC under the key of a peer set
+ * @return true if the set holds a key and the HMAC matches
+ */
+bool HMACValidator_validateFrom(
+    uint8_t set,
+    const uint8_t* data,
+    uint16_t dataLen,
+    const uint8_t* receivedHmac
+);
+
+/**
+ * Validate a JSON command line carrying a base64 "hmac" field
+ *
+ * The MAC covers the raw line bytes with the "hmac" member (and one
+ * separating comma) cut out, e.g. {"c":"sm","t":5,"hmac":"..."} is checked
+ * over {"c":"sm","t":5}. The span is removed in place with memmove, so no
+ * re-serialization or extra buffers are needed and key order is whatever
+ * the sender transmitted. Not limited to HMAC_MAX_PAYLOAD.
+ *
+ * @param line JSON line (modified in place, NUL-terminated on return)
+ * @param len Line length in, canonical length out
+ * @return true if an "hmac" member was found and matches
+ */
+bool HMACValidator_validateJsonLine(char* line, size_t* len);
+
+/**
+ * Validate a base64 HMAC sent apart from its data (e.g. an HTTP header)
+ *
+ * Not limited to HMAC_MAX_PAYLOAD, for bulk data such as a config image.
+ *
+ * @param data Authenticated bytes
+ * @param len Length of data
+ * @param hmacB64 Base64 HMAC-SHA256, NUL-terminated
+ * @return true if the HMAC decodes and matches
+ */
+bool HMACValidator_validateBase64(const uint8_t* data, size_t len, const char* hmacB64);
+
 /**
  * Constant-time HMAC comparison (prevents timing attacks)
  * @param hmac1 First HMAC (32 bytes)
@@ -0,0 +1,113 @@
+#include "HostProtocol.h"
+#include "Crc16.h"
+#include <string.h>
+
+/**
+ * HostProtocol - Implementation
+ *
+ * Consistent Overhead Byte Stuffing: each run of non-zero bytes is
+ * prefixed with (run length + 1); a code of 0xFF means 254 data bytes
+ * with no implied zero. The encoded body never contains 0x00, so 0x00
+ * can delimit frames on a stream shared with text.
+ *
+ * @file HostProtocol.cpp
+ */
+
+size_t HostProtocol_cobsEncode(const uint8_t *in, size_t len, uint8_t *out) {
+  size_t read = 0;
+  size_t write = 1;
+  size_t codeIndex = 0;
+  uint8_t code = 1;
+
+  while (read < len) {
+    if (in[read] == 0) {
+      out[codeIndex] = code;
+      codeIndex = write++;
+      code = 1;
+    } else {
+      out[write++] = in[read];
+      code++;
+      if (code == 0xFF) {
+        out[codeIndex] = code;
+        codeIndex = write++;
+        code = 1;
+      }
+    }
+    read++;
+  }
+
+  out[codeIndex] = code;
+  return write;
+}
+
+size_t HostProtocol_cobsDecode(const uint8_t *in, size_t len, uint8_t *out) {
+  size_t read = 0;
+  size_t write = 0;
+
+  while (read < len) {
+    uint8_t code = in[read];
+    if (code == 0 || read + code > len)
+      return 0;
+    read++;
+
+    for (uint8_t i = 1; i < code; i++) {
+      if (in[read] == 0)
+        return 0;
+      out[write++] = in[read++];
+    }
+
+    // Implied zero between groups, except after a full group or at the end
+    if (code != 0xFF && read < len)
+      out[write++] = 0;
+  }
+
+  return write;
+}
+
+size_t HostProtocol_buildFrame(uint8_t type, const void *payload,
+                               size_t payloadLen, uint8_t *out,
+                               size_t outSize) {
+  if (!out || (!payload && payloadLen) || payloadLen > HOST_FRAME_MAX_PAYLOAD)
+    return 0;
+
+  uint8_t raw[HOST_FRAME_MAX_RAW];
+  raw[0] = type;
+  if (payloadLen)
+    memcpy(&raw[1], payload, payloadLen);
+  uint16_t crc = Crc16_compute(raw, 1 + payloadLen);
+  raw[1 + payloadLen] = (uint8_t)(crc & 0xFF);
+  raw[2 + payloadLen] = (uint8_t)(crc >> 8);
+
+  size_t rawLen = payloadLen + 3;
+  if (outSize < rawLen + rawLen / 254 + 1 + 2)
+    return 0;
+
+  out[0] = 0x00;
+  size_t encLen = HostProtocol_cobsEncode(raw, rawLen, &out[1]);
+  out[1 + encLen] = 0x00;
+  return encLen + 2;
+}
+
+int HostProtocol_parseFrame(const uint8_t *encoded, size_t encodedLen,
+                            uint8_t *type, uint8_t *payload,
+                            size_t payloadMax) {
+  if (!encoded || !type || !payload || encodedLen > HOST_FRAME_MAX_ENCODED)
+    return -1;
+
+  uint8_t raw[HOST_FRAME_MAX_ENCODED];
+  size_t rawLen = HostProtocol_cobsDecode(encoded, encodedLen, raw);
+  if (rawLen < 3)
+    return -1;
+
+  size_t payloadLen = rawLen - 3;
+  if (payloadLen > payloadMax)
+    return -1;
+
+  uint16_t crc = (uint16_t)raw[rawLen - 2] | ((uint16_t)raw[rawLen - 1] << 8);
+  if (crc != Crc16_compute(raw, rawLen - 2))
+    return -1;
+
+  *type = raw[0];
+  memcpy(payload, &raw[1], payloadLen);
+  return (int)payloadLen;
+}
@@ -0,0 +1,106 @@
+#ifndef HOST_PROTOCOL_H
+#define HOST_PROTOCOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "MissionUpload.h"
+
+/**
+ * HostProtocol - COBS-framed binary serial protocol for the configurator
+ *
+ * Runs alongside the short-key JSON protocol on the same UART:
+ * - Wire format: 0x00 | COBS(type | payload | CRC16) | 0x00
+ * - CRC16 is NA_CRC16 over type + payload, little endian
+ * - Payloads are the shared NAPacket / NATelemetry structs, unchanged
+ *   (or a TelemetryStreams frame once streams are enabled)
+ *
+ * The host discovers support from the "bin" field of the JSON ping reply
+ * and enables it with {"c":"ping","bin":1}; telemetry is then streamed as
+ * binary frames instead of JSON lines.
+ *
+ * @file HostProtocol.h
+ */
+
+#define HOST_PROTOCOL_VERSION   1
+
+#define HOST_FRAME_MAX_PAYLOAD  96
+#define HOST_FRAME_MAX_RAW      (1 + HOST_FRAME_MAX_PAYLOAD + 2)
+// COBS adds one byte per 254, plus the two delimiters
+#define HOST_FRAME_MAX_ENCODED  (HOST_FRAME_MAX_RAW + HOST_FRAME_MAX_RAW / 254 + 1 + 2)
+
+/**
+ * Frame types
+ */
+typedef enum {
+    HOST_FRAME_CONTROL = 0x01,      // Host -> MCU: NAPacket
+    HOST_FRAME_TELEMETRY = 0x02,    // MCU -> Host: NATelemetry
+    HOST_FRAME_MISSION_BEGIN = 0x03,// Host -> MCU: HostMissionBegin
+    HOST_FRAME_MISSION_DATA = 0x04, // Host -> MCU: uint16 first + WaypointRecord[]
+    HOST_FRAME_MISSION_END = 0x05,  // Host -> MCU: empty, verify and commit
+    HOST_FRAME_MISSION_ACK = 0x06,  // MCU -> Host: HostMissionAck, one per mission frame
+    HOST_FRAME_STREAMS = 0x07       // MCU -> Host: TelemetryStreams frame, replaces TELEMETRY
+} HostFrameType;
+
+/**
+ * Bulk mission upload (see MissionUpload.h): BEGIN, DATA chunks in
+ * order, END. Every frame is answered with an ACK carrying the status
+ * and the next index expected, so the host resumes after a lost chunk.
+ */
+#define HOST_MISSION_CHUNK_MAX  ((HOST_FRAME_MAX_PAYLOAD - 2) / sizeof(WaypointRecord)) // 6
+
+typedef struct __attribute__((packed)) {
+    uint16_t count;                 // Waypoints to follow
+    uint16_t crc;                   // NA_CRC16 over all packed records
+} HostMissionBegin;
+
+typedef struct __attribute__((packed)) {
+    uint8_t status;                 // MissionUploadStatus
+    uint16_t next;                  // Next record index expected
+} HostMissionAck;
+
+/**
+ * COBS-encode a buffer (no delimiters)
+ * @param in Input data
+ * @param len Input length
+ * @param out Output buffer (at least len + len / 254 + 1 bytes)
+ * @return Encoded length
+ */
+size_t HostProtocol_cobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+
+/**
+ * COBS-decode a buffer (no delimiters)
+ * @param in Encoded data
+ * @param len Encoded length
+ * @param out Output buffer (at least len bytes, may equal in)
+ * @return Decoded length, or 0 if the input is malformed
+ */
+size_t HostProtocol_cobsDecode(const uint8_t* in, size_t len, uint8_t* out);
+
+/**
+ * Build a complete delimited frame
+ * @param type Frame type
+ * @param payload Payload bytes
+ * @param payloadLen Payload length (max HOST_FRAME_MAX_PAYLOAD)
+ * @param out Output buffer
+ * @param outSize Output buffer size (HOST_FRAME_MAX_ENCODED is enough)
+ * @return Bytes written, or 0 on error
+ */
+size_t HostProtocol_buildFrame(uint8_t type, const void* payload,
+                               size_t payloadLen, uint8_t* out,
+                               size_t outSize);
+
+/**
+ * Decode and verify a frame body returned by SerialLineReader_readFrame()
+ * @param encoded COBS bytes between the delimiters
+ * @param encodedLen Encoded length
+ * @param type Output frame type
+ * @param payload Output payload buffer
+ * @param payloadMax Payload buffer size
+ * @return Payload length, or -1 if malformed / CRC mismatch / too large
+ */
+int HostProtocol_parseFrame(const uint8_t* encoded, size_t encodedLen,
+                            uint8_t* type, uint8_t* payload,
+                            size_t payloadMax);
+
+#endif // HOST_PROTOCOL_H
@@ -0,0 +1,39 @@
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+/**
+ * HotPath - IRAM / DRAM placement of the control-critical leaf functions
+ *
+ * Code in flash runs through the instruction cache: the first call after
+ * other code evicted it costs a cache-line fill from SPI flash (tens of
+ * cycles per line), and while the cache is off for a flash write or
+ * erase (NVS commits, OTA, blackbox) it cannot run at all - only IRAM
+ * code and interrupts registered with ESP_INTR_FLAG_IRAM do.
+ *
+ * HOT_IRAM puts a function in IRAM and HOT_DRAM a constant table in
+ * internal RAM, so the motor output commit, the receive filter and the
+ * CRC never wait on the cache and stay callable from an IRAM interrupt.
+ * Every function marked here must only call IRAM code, inline register
+ * access or other HOT_IRAM functions. tools/check_iram.py fails the
+ * firmware build if a listed symbol ends up in flash.
+ *
+ * Build with -DHOT_PATH_IRAM=0 to leave everything in flash (to compare,
+ * or if IRAM runs short).
+ *
+ * @file HotPath.h
+ */
+
+#ifndef HOT_PATH_IRAM
+#define HOT_PATH_IRAM 1
+#endif
+
+#if defined(__XTENSA__) && HOT_PATH_IRAM
+#include <esp_attr.h>
+#define HOT_IRAM IRAM_ATTR
+#define HOT_DRAM DRAM_ATTR
+#else
+#define HOT_IRAM
+#define HOT_DRAM
+#endif
+
+#endif // HOT_PATH_H
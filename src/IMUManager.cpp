@@ -0,0 +1,195 @@
+#include "IMUManager.h"
+#include "HAL.h"
+#include "MemoryProfiler.h"
+#include "Trace.h"
+
+// MPU6050 Register Map
+#define MPU_SMPLRT_DIV      0x19
+#define MPU_CONFIG          0x1A
+#define MPU_GYRO_CONFIG     0x1B
+#define MPU_ACCEL_CONFIG    0x1C
+#define MPU_FIFO_EN         0x23
+#define MPU_INT_PIN_CFG     0x37
+#define MPU_INT_ENABLE      0x38
+#define MPU_TEMP_OUT_H      0x41
+#define MPU_USER_CTRL       0x6A
+#define MPU_PWR_MGMT_1      0x6B
+#define MPU_FIFO_COUNTH     0x72
+#define MPU_FIFO_R_W        0x74
+#define MPU_WHO_AM_I        0x75
+
+#define MPU_FIFO_SIZE       1024
+#define MPU_SAMPLE_BYTES    12      // accel xyz + gyro xyz, big endian
+
+// Full scale: +-2000 dps (16.4 LSB/dps), +-8 g (4096 LSB/g)
+#define MPU_GYRO_FS_2000    (3 << 3)
+#define MPU_ACCEL_FS_8G     (2 << 3)
+#define MPU_GYRO_SCALE      ((1.0f / 16.4f) * (PI / 180.0f))
+#define MPU_ACCEL_SCALE     (9.80665f / 4096.0f)
+#define MPU_TEMP_SCALE      (1.0f / 340.0f)
+#define MPU_TEMP_OFFSET     36.53f
+
+IMUManager& IMUManager::getInstance() {
+    static IMUManager instance;
+    return instance;
+}
+
+IMUManager::IMUManager() {}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+bool IMUManager::writeReg(uint8_t reg, uint8_t value) {
+    uint8_t buf[2] = {reg, value};
+    return HAL_I2CWrite(IMU_I2C_ADDR, buf, 2, 10) == HAL_I2C_OK;
+}
+
+bool IMUManager::configure(uint8_t dlpf) {
+    uint8_t who = 0;
+    if (HAL_I2CReadReg(IMU_I2C_ADDR, MPU_WHO_AM_I, &who, 1, 10) != 1) return false;
+    if ((who & 0x7E) != IMU_I2C_ADDR) return false;
+
+    if (!writeReg(MPU_PWR_MGMT_1, 0x80)) return false;     // Device reset
+    delay(100);
+    bool ok = writeReg(MPU_PWR_MGMT_1, 0x01);              // PLL on gyro X
+    ok = ok && writeReg(MPU_CONFIG, dlpf & 0x07);
+    ok = ok && writeReg(MPU_SMPLRT_DIV, 0);                // 1 kHz / (1 + 0)
+    ok = ok && writeReg(MPU_GYRO_CONFIG, MPU_GYRO_FS_2000);
+    ok = ok && writeReg(MPU_ACCEL_CONFIG, MPU_ACCEL_FS_8G);
+    ok = ok && writeReg(MPU_INT_PIN_CFG, 0x10);            // Push-pull, active high, clear on any read
+    ok = ok && writeReg(MPU_FIFO_EN, 0x78);                // XG, YG, ZG, ACCEL
+    ok = ok && writeReg(MPU_INT_ENABLE, 0x01);             // DATA_RDY
+    if (ok) resetFifo();
+    if (ok) readTemperature();
+    return ok;
+}
+
+void IMUManager::resetFifo() {
+    writeReg(MPU_USER_CTRL, 0x04);                         // FIFO_RESET
+    writeReg(MPU_USER_CTRL, 0x40);                         // FIFO_EN
+}
+
+bool IMUManager::begin(uint8_t dlpf, uint8_t priority, uint8_t core) {
+    if (_ready) return true;
+
+    if (dlpf < IMU_DLPF_188HZ || dlpf > IMU_DLPF_5HZ) dlpf = IMU_DLPF_42HZ;
+    if (!configure(dlpf)) {
+        Serial.println("[IMU] MPU6050 not found");
+        return false;
+    }
+
+    MemoryProfiler_setTaskStackSize("imu", IMU_TASK_STACK);
+    if (xTaskCreatePinnedToCore(taskEntry, "imu", IMU_TASK_STACK, this, priority, &_task, core) != pdPASS) {
+        Serial.println("[IMU] Task create failed");
+        return false;
+    }
+
+    pinMode(IMU_INT_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(IMU_INT_PIN), onDataReady, RISING);
+    _ready = true;
+    Serial.println("[IMU] MPU6050 Ready (1kHz FIFO)");
+    return true;
+}
+
+// ============================================================================
+// Sampling Task
+// ============================================================================
+
+void IRAM_ATTR IMUManager::onDataReady() {
+    IMUManager& imu = getInstance();
+    imu._irqUs = (uint32_t)HAL_Now();
+    TRACE_INSTANT(TRACE_EV_IMU_IRQ, 0);
+
+    BaseType_t woken = pdFALSE;
+    if (imu._task) vTaskNotifyGiveFromISR(imu._task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void IMUManager::taskEntry(void* arg) {
+    IMUManager* imu = (IMUManager*)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IMU_WAIT_TIMEOUT_MS));
+        imu->drainFifo();
+    }
+}
+
+void IMUManager::readTemperature() {
+    uint8_t raw[2];
+    if (HAL_I2CReadReg(IMU_I2C_ADDR, MPU_TEMP_OUT_H, raw, 2, 5) != 2) {
+        _i2cErrors++;
+        return;
+    }
+    int16_t t = (int16_t)((raw[0] << 8) | raw[1]);
+    _tempC = t * MPU_TEMP_SCALE + MPU_TEMP_OFFSET;
+}
+
+void IMUManager::drainFifo() {
+    uint32_t nowMs = HAL_GetMillis();
+    if (nowMs - _tempReadMs >= IMU_TEMP_PERIOD_MS) {
+        _tempReadMs = nowMs;
+        readTemperature();
+    }
+
+    uint8_t countRaw[2];
+    if (HAL_I2CReadReg(IMU_I2C_ADDR, MPU_FIFO_COUNTH, countRaw, 2, 5) != 2) {
+        _i2cErrors++;
+        return;
+    }
+    uint16_t count = ((uint16_t)countRaw[0] << 8) | countRaw[1];
+
+    // A full FIFO has wrapped: sample boundaries are lost, start clean
+    if (count >= MPU_FIFO_SIZE - MPU_SAMPLE_BYTES) {
+        _fifoOverflows++;
+        resetFifo();
+        return;
+    }
+
+    uint16_t total = count / MPU_SAMPLE_BYTES;
+    if (total == 0) return;
+    if (total > _maxBurst) _maxBurst = total > 255 ? 255 : total;
+
+    // Newest sample in the FIFO belongs to the latest data-ready edge
+    uint32_t newestUs = _irqUs;
+    uint16_t done = 0;
+    while (done < total) {
+        uint16_t n = total - done;
+        if (n > IMU_BURST_MAX) n = IMU_BURST_MAX;
+
+        uint8_t burst[IMU_BURST_MAX * MPU_SAMPLE_BYTES];
+        if (HAL_I2CReadReg(IMU_I2C_ADDR, MPU_FIFO_R_W, burst, n * MPU_SAMPLE_BYTES, 5) < 0) {
+            _i2cErrors++;
+            resetFifo();    // Partial read would misalign the FIFO
+            return;
+        }
+        for (uint16_t i = 0; i < n; i++) {
+            uint32_t age = (uint32_t)(total - 1 - (done + i)) * IMU_SAMPLE_PERIOD_US;
+            publish(burst + i * MPU_SAMPLE_BYTES, newestUs - age);
+        }
+        done += n;
+    }
+}
+
+void IMUManager::publish(const uint8_t* raw, uint32_t timestampUs) {
+    IMUSample s;
+    s.timestampUs = timestampUs;
+    s.tempC = _tempC;
+    for (int axis = 0; axis < 3; axis++) {
+        int16_t a = (int16_t)((raw[axis * 2] << 8) | raw[axis * 2 + 1]);
+        int16_t g = (int16_t)((raw[6 + axis * 2] << 8) | raw[6 + axis * 2 + 1]);
+        s.accel[axis] = a * MPU_ACCEL_SCALE;
+        s.gyro[axis] = g * MPU_GYRO_SCALE;
+    }
+    _ring.push(s);
+    _samples++;
+}
+
+IMUStats IMUManager::getStats() {
+    IMUStats stats;
+    stats.samples = _samples;
+    stats.dropped = _ring.getDroppedCount();
+    stats.fifoOverflows = _fifoOverflows;
+    stats.i2cErrors = _i2cErrors;
+    stats.maxBurst = _maxBurst;
+    return stats;
+}
@@ -0,0 +1,124 @@
+#ifndef IMU_MANAGER_H
+#define IMU_MANAGER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "SPSCRing.h"
+
+/**
+ * IMUManager - MPU6050 sample pipeline (1 kHz, FIFO burst reads)
+ *
+ * - MPU6050 runs at 1 kHz with the DLPF enabled, accel + gyro into FIFO
+ * - Data-ready interrupt (IMU_INT_PIN) wakes a dedicated task, which
+ *   reads FIFO_COUNT and drains whole samples in bursts of up to
+ *   IMU_BURST_MAX (one I2C transaction instead of 14 register reads each)
+ * - Samples are timestamped from the interrupt time, back-dated by the
+ *   sample period within a burst, and published to an SPSC ring
+ * - Die temperature (for gyro bias compensation) is read on its own every
+ *   IMU_TEMP_PERIOD_MS and stamped on each sample; it stays out of the
+ *   FIFO so a burst still fits the Wire buffer
+ *
+ * One consumer (the attitude / control path) drains the ring in order
+ * with readSample(). If it falls more than IMU_RING_SIZE samples behind,
+ * the oldest are dropped.
+ *
+ * @file IMUManager.h
+ */
+
+#define IMU_I2C_ADDR        0x68
+#define IMU_INT_PIN         5       // MPU6050 INT (data ready, active high)
+#define IMU_SAMPLE_RATE_HZ  1000
+#define IMU_SAMPLE_PERIOD_US (1000000 / IMU_SAMPLE_RATE_HZ)
+#define IMU_RING_SIZE       64      // 64 ms of samples
+#define IMU_BURST_MAX       10      // Samples per FIFO read (120 bytes < Wire buffer)
+#define IMU_WAIT_TIMEOUT_MS 5       // Drain anyway if an edge is missed
+#define IMU_TASK_STACK      3072    // bytes
+#define IMU_TEMP_PERIOD_MS  100
+
+// DLPF_CFG values (accel / gyro bandwidth); 0 and 7 would change the
+// gyro output rate to 8 kHz, so they are not offered
+#define IMU_DLPF_188HZ      1
+#define IMU_DLPF_98HZ       2
+#define IMU_DLPF_42HZ       3
+#define IMU_DLPF_20HZ       4
+#define IMU_DLPF_10HZ       5
+#define IMU_DLPF_5HZ        6
+
+/**
+ * One timestamped IMU sample (body frame)
+ */
+struct IMUSample {
+    uint32_t timestampUs;   // esp_timer time of the sample
+    float gyro[3];          // rad/s (x, y, z)
+    float accel[3];         // m/s^2 (x, y, z)
+    float tempC;            // Die temperature, latest reading
+};
+
+/**
+ * Pipeline counters
+ */
+struct IMUStats {
+    uint32_t samples;       // Published to the ring
+    uint32_t dropped;       // Lapped in the ring (consumer too slow)
+    uint32_t fifoOverflows; // FIFO filled before it was drained
+    uint32_t i2cErrors;
+    uint8_t maxBurst;       // Most samples found in the FIFO at once
+};
+
+class IMUManager {
+public:
+    static IMUManager& getInstance();
+
+    /**
+     * Detect and configure the MPU6050, then start the sampling task
+     * @param dlpf IMU_DLPF_* bandwidth
+     * @param priority FreeRTOS priority of the sampling task
+     * @param core Core to pin the sampling task to
+     * @return true if the sensor answered and the task is running
+     */
+    bool begin(uint8_t dlpf, uint8_t priority, uint8_t core);
+
+    /**
+     * Take the oldest unread sample (single consumer)
+     * @param out Sample
+     * @return true if a sample was available
+     */
+    bool readSample(IMUSample& out) { return _ring.readNext(out); }
+
+    /**
+     * Samples waiting in the ring (consumer side)
+     */
+    uint32_t available() const { return _ring.available(); }
+
+    bool isReady() const { return _ready; }
+    IMUStats getStats();
+
+private:
+    IMUManager();
+
+    bool configure(uint8_t dlpf);
+    bool writeReg(uint8_t reg, uint8_t value);
+    void resetFifo();
+    void drainFifo();
+    void readTemperature();
+    void publish(const uint8_t* raw, uint32_t timestampUs);
+
+    static void taskEntry(void* arg);
+    static void IRAM_ATTR onDataReady();
+
+    SPSCRing<IMUSample, IMU_RING_SIZE> _ring;
+    TaskHandle_t _task = nullptr;
+    volatile uint32_t _irqUs = 0;   // Time of the latest data-ready edge
+    bool _ready = false;
+
+    // Written by the sampling task only
+    uint32_t _samples = 0;
+    uint32_t _fifoOverflows = 0;
+    uint32_t _i2cErrors = 0;
+    uint8_t _maxBurst = 0;
+    float _tempC = 25.0f;
+    uint32_t _tempReadMs = 0;
+};
+
+#endif // IMU_MANAGER_H
@@ -0,0 +1,239 @@
+#include "ImuCal.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * ImuCal - Implementation
+ *
+ * Window sums are float: over IMU_CAL_WINDOW samples the gyro spread
+ * (~1e-3 rad/s) is still far above the rounding of sumSq / n - mean^2.
+ *
+ * @file ImuCal.cpp
+ */
+
+// ============================================================================
+// Record
+// ============================================================================
+
+void ImuCal_defaultRecord(ImuCalRecord* rec) {
+    memset(rec, 0, sizeof(*rec));
+    rec->version = IMU_CAL_VERSION;
+}
+
+static bool inRange(const float v[3], float limit) {
+    for (int i = 0; i < 3; i++) {
+        if (!isfinite(v[i]) || fabsf(v[i]) > limit)
+            return false;
+    }
+    return true;
+}
+
+bool ImuCal_sanitize(ImuCalRecord* rec) {
+    bool ok = rec->version == IMU_CAL_VERSION && isfinite(rec->refTempC) &&
+              inRange(rec->gyroBias, IMU_CAL_MAX_BIAS) &&
+              inRange(rec->gyroSlope, IMU_CAL_MAX_SLOPE) &&
+              inRange(rec->accelOffset, IMU_CAL_MAX_ACCEL_OFFSET);
+    if (!ok) {
+        ImuCal_defaultRecord(rec);
+        return false;
+    }
+    rec->flags &= IMU_CAL_HAVE_GYRO | IMU_CAL_HAVE_SLOPE | IMU_CAL_HAVE_ACCEL;
+    rec->reserved = 0;
+    return true;
+}
+
+// ============================================================================
+// Correction
+// ============================================================================
+
+static void clearWindow(ImuCal* cal) {
+    cal->count = 0;
+    memset(cal->gyroSum, 0, sizeof(cal->gyroSum));
+    memset(cal->gyroSq, 0, sizeof(cal->gyroSq));
+    memset(cal->accelSum, 0, sizeof(cal->accelSum));
+    cal->normMin = INFINITY;
+    cal->normMax = 0.0f;
+    cal->tempSum = 0.0f;
+}
+
+static void clearFit(ImuCal* cal) {
+    cal->fitW = 0.0f;
+    cal->fitT = 0.0f;
+    cal->fitTT = 0.0f;
+    memset(cal->fitB, 0, sizeof(cal->fitB));
+    memset(cal->fitTB, 0, sizeof(cal->fitTB));
+}
+
+void ImuCal_init(ImuCal* cal, const ImuCalRecord* rec) {
+    memset(cal, 0, sizeof(*cal));
+    cal->cal = *rec;
+    cal->saved = *rec;
+    clearWindow(cal);
+    clearFit(cal);
+}
+
+void ImuCal_gyroBias(const ImuCal* cal, float tempC, float bias[3]) {
+    float dt = tempC - cal->cal.refTempC;
+    for (int i = 0; i < 3; i++)
+        bias[i] = cal->cal.gyroBias[i] + cal->cal.gyroSlope[i] * dt;
+}
+
+void ImuCal_apply(const ImuCal* cal, float gyro[3], float accel[3], float tempC) {
+    float bias[3];
+    ImuCal_gyroBias(cal, tempC, bias);
+    for (int i = 0; i < 3; i++) {
+        gyro[i] -= bias[i];
+        accel[i] -= cal->cal.accelOffset[i];
+    }
+}
+
+// ============================================================================
+// Learning
+// ============================================================================
+
+/**
+ * Take one still window's mean rate (at temperature t) into the model
+ */
+static bool learnBias(ImuCal* cal, const float mean[3], float t) {
+    ImuCalRecord* rec = &cal->cal;
+    if (!(rec->flags & IMU_CAL_HAVE_GYRO)) {
+        memcpy(rec->gyroBias, mean, sizeof(rec->gyroBias));
+        rec->refTempC = t;
+        rec->flags |= IMU_CAL_HAVE_GYRO;
+        clearFit(cal);
+    } else {
+        float predicted[3];
+        ImuCal_gyroBias(cal, t, predicted);
+        for (int i = 0; i < 3; i++) {
+            if (fabsf(mean[i] - predicted[i]) > IMU_CAL_MAX_STEP) {
+                cal->rejectedWindows++;
+                return false;
+            }
+        }
+    }
+
+    // Weighted least squares of bias against (t - refTempC)
+    float x = t - rec->refTempC;
+    cal->fitW = cal->fitW * IMU_CAL_FORGET + 1.0f;
+    cal->fitT = cal->fitT * IMU_CAL_FORGET + x;
+    cal->fitTT = cal->fitTT * IMU_CAL_FORGET + x * x;
+    for (int i = 0; i < 3; i++) {
+        cal->fitB[i] = cal->fitB[i] * IMU_CAL_FORGET + mean[i];
+        cal->fitTB[i] = cal->fitTB[i] * IMU_CAL_FORGET + x * mean[i];
+    }
+    float meanT = cal->fitT / cal->fitW;
+    float varT = cal->fitTT / cal->fitW - meanT * meanT;
+
+    if (varT >= IMU_CAL_TEMP_MIN_SD * IMU_CAL_TEMP_MIN_SD) {
+        for (int i = 0; i < 3; i++) {
+            float meanB = cal->fitB[i] / cal->fitW;
+            float slope = (cal->fitTB[i] / cal->fitW - meanT * meanB) / varT;
+            if (slope > IMU_CAL_MAX_SLOPE)
+                slope = IMU_CAL_MAX_SLOPE;
+            if (slope < -IMU_CAL_MAX_SLOPE)
+                slope = -IMU_CAL_MAX_SLOPE;
+            rec->gyroSlope[i] = slope;
+            rec->gyroBias[i] = meanB - slope * meanT;
+        }
+        rec->flags |= IMU_CAL_HAVE_SLOPE;
+    } else {
+        // Not enough temperature spread yet: keep the slope, track the offset
+        float predicted[3];
+        ImuCal_gyroBias(cal, t, predicted);
+        for (int i = 0; i < 3; i++)
+            rec->gyroBias[i] += IMU_CAL_BIAS_GAIN * (mean[i] - predicted[i]);
+    }
+    return true;
+}
+
+bool ImuCal_feed(ImuCal* cal, const float gyro[3], const float accel[3], float tempC) {
+    float sq = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        cal->gyroSum[i] += gyro[i];
+        cal->gyroSq[i] += gyro[i] * gyro[i];
+        cal->accelSum[i] += accel[i];
+        float a = accel[i] - cal->cal.accelOffset[i];
+        sq += a * a;
+    }
+    float norm = sqrtf(sq);
+    if (norm < cal->normMin)
+        cal->normMin = norm;
+    if (norm > cal->normMax)
+        cal->normMax = norm;
+    cal->tempSum += tempC;
+    cal->lastTempC = tempC;
+    if (++cal->count < IMU_CAL_WINDOW)
+        return false;
+
+    float n = (float)cal->count;
+    float mean[3];
+    float accelMean[3];
+    float meanSq = 0.0f;
+    bool still = cal->normMax - cal->normMin < 2.0f * IMU_CAL_STILL_ACCEL;
+    for (int i = 0; i < 3; i++) {
+        mean[i] = cal->gyroSum[i] / n;
+        accelMean[i] = cal->accelSum[i] / n;
+        float var = cal->gyroSq[i] / n - mean[i] * mean[i];
+        still = still && var < IMU_CAL_STILL_GYRO_RMS * IMU_CAL_STILL_GYRO_RMS;
+        float a = accelMean[i] - cal->cal.accelOffset[i];
+        meanSq += a * a;
+    }
+    still = still && fabsf(sqrtf(meanSq) - IMU_CAL_GRAVITY) < IMU_CAL_STILL_ACCEL;
+    float t = cal->tempSum / n;
+    clearWindow(cal);
+
+    cal->still = still;
+    if (!still) {
+        cal->movingWindows++;
+        return false;
+    }
+    cal->stillWindows++;
+
+    bool changed = false;
+    if (cal->levelRequested) {
+        // Level and still: all of the specific force is +1 g on z
+        for (int i = 0; i < 3; i++)
+            cal->cal.accelOffset[i] = accelMean[i] - (i == 2 ? IMU_CAL_GRAVITY : 0.0f);
+        cal->cal.flags |= IMU_CAL_HAVE_ACCEL;
+        cal->levelRequested = false;
+        changed = true;
+    }
+    return learnBias(cal, mean, t) || changed;
+}
+
+void ImuCal_requestLevel(ImuCal* cal) {
+    cal->levelRequested = true;
+}
+
+void ImuCal_reset(ImuCal* cal) {
+    ImuCal_defaultRecord(&cal->cal);
+    cal->levelRequested = false;
+    clearWindow(cal);
+    clearFit(cal);
+}
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+static bool moved(const float a[3], const float b[3], float limit) {
+    for (int i = 0; i < 3; i++) {
+        if (fabsf(a[i] - b[i]) > limit)
+            return true;
+    }
+    return false;
+}
+
+bool ImuCal_needsSave(const ImuCal* cal) {
+    const ImuCalRecord* now = &cal->cal;
+    const ImuCalRecord* saved = &cal->saved;
+    if (now->flags != saved->flags || now->refTempC != saved->refTempC)
+        return true;
+    return moved(now->gyroBias, saved->gyroBias, IMU_CAL_SAVE_BIAS) ||
+           moved(now->gyroSlope, saved->gyroSlope, IMU_CAL_SAVE_SLOPE) ||
+           memcmp(now->accelOffset, saved->accelOffset, sizeof(now->accelOffset)) != 0;
+}
+
+void ImuCal_markSaved(ImuCal* cal) {
+    cal->saved = cal->cal;
+}
@@ -0,0 +1,155 @@
+#ifndef IMU_CAL_H
+#define IMU_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * ImuCal - Stored gyro bias / accel offsets, refined while stationary
+ *
+ * A MEMS gyro's zero-rate offset is a few tenths of a degree per second
+ * and moves with die temperature. Instead of averaging it for seconds at
+ * every boot, the last calibration is kept in NVS and applied from the
+ * first sample:
+ *
+ *   gyro  -= bias + slope * (tempC - refTempC)
+ *   accel -= accelOffset
+ *
+ * Samples are also grouped into windows of IMU_CAL_WINDOW. A window is
+ * still when every gyro axis spreads less than IMU_CAL_STILL_GYRO_RMS and
+ * the accelerometer reads a steady 1 g. Still windows refine the model:
+ *
+ * - With no stored bias, the first still window sets it (~0.5 s)
+ * - Each still window is added to a weighted least-squares fit of bias
+ *   against temperature (older windows fade by IMU_CAL_FORGET); once the
+ *   windows spread over IMU_CAL_TEMP_MIN_SD the fit sets bias and slope,
+ *   before that the bias moves toward the window by IMU_CAL_BIAS_GAIN
+ * - A window further than IMU_CAL_MAX_STEP from the model once it has a
+ *   bias is taken as a slow turn, not as drift, and ignored
+ *
+ * Accelerometer offsets cannot be told apart from tilt on one still
+ * window, so they are only taken on request with the vehicle level
+ * (requestLevel): the next still window's mean minus +1 g on z.
+ *
+ * Pure: no globals, no RTOS. Owned by the control task; the record goes
+ * to NVS (IMU_CAL_CONFIG_KEY) when needsSave() says it has moved.
+ *
+ * @file ImuCal.h
+ */
+
+#define IMU_CAL_CONFIG_KEY          "cal_imu"
+#define IMU_CAL_VERSION             1
+#define IMU_CAL_GRAVITY             9.80665f
+#define IMU_CAL_WINDOW              500     // Samples per stillness window (0.5 s at 1 kHz)
+#define IMU_CAL_STILL_GYRO_RMS      0.01f   // rad/s spread per axis within a window
+#define IMU_CAL_STILL_ACCEL         0.5f    // m/s^2 from 1 g, and spread of |a|
+#define IMU_CAL_BIAS_GAIN           0.2f    // Share of a still window taken into the bias
+#define IMU_CAL_MAX_STEP            0.05f   // rad/s from the model: a turn, not drift
+#define IMU_CAL_FORGET              0.998f  // Per still window (~3 min half-life)
+#define IMU_CAL_TEMP_MIN_SD         1.0f    // degC spread of the fit data before a slope
+#define IMU_CAL_MAX_BIAS            0.5f    // rad/s, stored values beyond are rejected
+#define IMU_CAL_MAX_SLOPE           0.005f  // rad/s per degC
+#define IMU_CAL_MAX_ACCEL_OFFSET    3.0f    // m/s^2
+#define IMU_CAL_SAVE_BIAS           0.002f  // rad/s drift from the stored bias worth a save
+#define IMU_CAL_SAVE_SLOPE          0.0002f // rad/s per degC
+
+// ImuCalRecord.flags
+#define IMU_CAL_HAVE_GYRO           0x01    // gyroBias / refTempC valid
+#define IMU_CAL_HAVE_SLOPE          0x02    // gyroSlope fitted
+#define IMU_CAL_HAVE_ACCEL          0x04    // accelOffset taken level
+
+/**
+ * Stored calibration (NVS blob)
+ */
+typedef struct {
+    uint16_t version;
+    uint8_t flags;              // IMU_CAL_HAVE_*
+    uint8_t reserved;
+    float refTempC;             // Temperature of gyroBias
+    float gyroBias[3];          // rad/s at refTempC
+    float gyroSlope[3];         // rad/s per degC
+    float accelOffset[3];       // m/s^2
+} ImuCalRecord;
+
+typedef struct {
+    ImuCalRecord cal;           // Applied to every sample
+    ImuCalRecord saved;         // As last stored
+
+    // Current window (raw samples)
+    uint16_t count;
+    float gyroSum[3];
+    float gyroSq[3];
+    float accelSum[3];
+    float normMin;
+    float normMax;
+    float tempSum;
+
+    // Bias-vs-temperature fit, temperatures relative to cal.refTempC
+    float fitW;
+    float fitT;
+    float fitTT;
+    float fitB[3];
+    float fitTB[3];
+
+    bool levelRequested;
+    bool still;                 // Last window
+    uint32_t stillWindows;
+    uint32_t movingWindows;
+    uint32_t rejectedWindows;   // Still but beyond IMU_CAL_MAX_STEP
+    float lastTempC;
+} ImuCal;
+
+/**
+ * Empty record (nothing applied)
+ */
+void ImuCal_defaultRecord(ImuCalRecord* rec);
+
+/**
+ * Check a loaded record: wrong version, non-finite or out-of-range
+ * values reset it to the default
+ * @return false if it was reset
+ */
+bool ImuCal_sanitize(ImuCalRecord* rec);
+
+/**
+ * Start from a (sanitized) stored record
+ */
+void ImuCal_init(ImuCal* cal, const ImuCalRecord* rec);
+
+/**
+ * Correct one sample in place
+ */
+void ImuCal_apply(const ImuCal* cal, float gyro[3], float accel[3], float tempC);
+
+/**
+ * Model gyro bias at a temperature, rad/s
+ */
+void ImuCal_gyroBias(const ImuCal* cal, float tempC, float bias[3]);
+
+/**
+ * Add one raw (uncorrected) sample to the current window
+ * @return true if this sample closed a still window that changed the model
+ */
+bool ImuCal_feed(ImuCal* cal, const float gyro[3], const float accel[3], float tempC);
+
+/**
+ * Take the accel offsets from the next still window (vehicle level)
+ */
+void ImuCal_requestLevel(ImuCal* cal);
+
+/**
+ * Drop the model and start learning again (stored record kept until saved)
+ */
+void ImuCal_reset(ImuCal* cal);
+
+/**
+ * The model has moved far enough from the stored record to store it
+ */
+bool ImuCal_needsSave(const ImuCal* cal);
+
+/**
+ * The current model has been stored
+ */
+void ImuCal_markSaved(ImuCal* cal);
+
+#endif // IMU_CAL_H
@@ -0,0 +1,137 @@
+#include "InputConditioner.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * InputConditioner - Implementation
+ *
+ * Extrapolation is capped at one sample interval and at the stick range,
+ * so a lost frame can at worst repeat the last change once; it cannot
+ * run a stick to its end stop.
+ *
+ * @file InputConditioner.cpp
+ */
+
+static const char* const MODE_NAMES[INPUT_COND_MODE_COUNT] = {"hold", "extrapolate", "slew"};
+
+static int16_t clamp_axis(int64_t v) {
+    return (int16_t)(v < INPUT_COND_MIN ? INPUT_COND_MIN : (v > INPUT_COND_MAX ? INPUT_COND_MAX : v));
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void InputConditioner_defaultConfig(InputCondConfig* config) {
+    config->mode = INPUT_COND_HOLD;
+    config->maxGapMs = 100;
+    config->cutoffHz = 0.0f;
+}
+
+void InputConditioner_sanitize(InputCondConfig* config) {
+    if (config->mode >= INPUT_COND_MODE_COUNT)
+        config->mode = INPUT_COND_HOLD;
+    if (config->maxGapMs > INPUT_COND_MAX_GAP_MS)
+        config->maxGapMs = INPUT_COND_MAX_GAP_MS;
+    if (!(config->cutoffHz > 0.0f))
+        config->cutoffHz = 0.0f;        // Also NaN
+    else if (config->cutoffHz > INPUT_COND_MAX_CUTOFF_HZ)
+        config->cutoffHz = INPUT_COND_MAX_CUTOFF_HZ;
+}
+
+void InputConditioner_init(InputConditioner* ic, const InputCondConfig* config) {
+    memset(ic, 0, sizeof(*ic));
+    ic->config = *config;
+    InputConditioner_sanitize(&ic->config);
+}
+
+void InputConditioner_setConfig(InputConditioner* ic, const InputCondConfig* config) {
+    ic->config = *config;
+    InputConditioner_sanitize(&ic->config);
+    ic->haveFiltered = false;
+}
+
+const char* InputConditioner_modeName(InputCondMode mode) {
+    if ((unsigned)mode >= INPUT_COND_MODE_COUNT)
+        return "?";
+    return MODE_NAMES[mode];
+}
+
+bool InputConditioner_parseMode(const char* name, InputCondMode* mode) {
+    if (!name)
+        return false;
+    for (uint8_t i = 0; i < INPUT_COND_MODE_COUNT; i++) {
+        if (strcmp(name, MODE_NAMES[i]) == 0) {
+            *mode = (InputCondMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Shaping
+// ============================================================================
+
+void InputConditioner_sample(InputConditioner* ic, const int16_t axes[INPUT_COND_AXES],
+                             HAL_Micros arrivedUs) {
+    int64_t sinceLast = arrivedUs - ic->lastUs;
+    if (ic->lastUs && sinceLast > 0 && sinceLast <= (int64_t)ic->config.maxGapMs * 1000) {
+        memcpy(ic->prev, ic->last, sizeof(ic->prev));
+        ic->prevUs = ic->lastUs;
+    } else {
+        ic->prevUs = 0;                 // First sample or after a gap: no slope
+    }
+    memcpy(ic->last, axes, sizeof(ic->last));
+    ic->lastUs = arrivedUs;
+    ic->expired = false;
+    ic->samples++;
+}
+
+bool InputConditioner_output(InputConditioner* ic, HAL_Micros nowUs, float dt,
+                             int16_t axes[INPUT_COND_AXES]) {
+    if (!ic->lastUs)
+        return false;
+
+    int64_t gap = nowUs - ic->lastUs;
+    bool stale = gap > (int64_t)ic->config.maxGapMs * 1000;
+    if (stale && !ic->expired) {
+        ic->expiredGaps++;
+        ic->expired = true;
+    }
+
+    int16_t raw[INPUT_COND_AXES];
+    memcpy(raw, ic->last, sizeof(raw));
+    if (!stale && ic->prevUs && gap >= 0 && ic->config.mode != INPUT_COND_HOLD) {
+        int64_t interval = ic->lastUs - ic->prevUs;
+        int64_t h = gap < interval ? gap : interval;
+        bool shaped = false;
+        for (uint8_t i = 0; i < INPUT_COND_AXES; i++) {
+            int64_t step = (int64_t)ic->last[i] - ic->prev[i];
+            if (ic->config.mode == INPUT_COND_EXTRAPOLATE)
+                raw[i] = clamp_axis(ic->last[i] + step * h / interval);
+            else
+                raw[i] = clamp_axis(ic->prev[i] + step * h / interval);
+            shaped |= raw[i] != ic->last[i];
+        }
+        if (shaped)
+            ic->shapedTicks++;
+    }
+
+    if (ic->config.cutoffHz > 0.0f && dt > 0.0f) {
+        float rc = 1.0f / (2.0f * (float)M_PI * ic->config.cutoffHz);
+        float alpha = dt / (rc + dt);
+        for (uint8_t i = 0; i < INPUT_COND_AXES; i++) {
+            if (!ic->haveFiltered)
+                ic->filtered[i] = raw[i];
+            else
+                ic->filtered[i] += alpha * (raw[i] - ic->filtered[i]);
+            axes[i] = clamp_axis(lroundf(ic->filtered[i]));
+        }
+        ic->haveFiltered = true;
+    } else {
+        memcpy(axes, raw, sizeof(raw));
+        ic->haveFiltered = false;
+    }
+    return !stale;
+}
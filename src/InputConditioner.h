@@ -0,0 +1,122 @@
+#ifndef INPUT_CONDITIONER_H
+#define INPUT_CONDITIONER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "HAL.h"
+
+/**
+ * InputConditioner - Stick axes between packet handoff and the vehicle
+ *
+ * Control frames arrive at the link rate (10-50 Hz) and with gaps when
+ * ESP-NOW drops a burst; the control task runs at 100 Hz. Handing the
+ * newest frame straight to the vehicle makes the sticks a staircase that
+ * steps again when frames resume. Each stick sample is stamped on
+ * arrival, and every control tick asks for the axes "now":
+ *
+ *   HOLD         newest sample (the old behaviour)
+ *   EXTRAPOLATE  newest sample plus its slope from the one before,
+ *                carried at most one sample interval ahead
+ *   SLEW         from the previous sample to the newest over one sample
+ *                interval (smooth, one interval later than HOLD)
+ *
+ * Past maxGapMs without a sample the newest one is held as is, and the
+ * failsafe timeout takes over from there. A sample after such a gap
+ * starts over: no slope across it. An optional first-order low-pass
+ * (cutoffHz, 0 = off) follows.
+ *
+ * Axes are the NAPacket sticks, -1000..1000, in the order throttle,
+ * roll, pitch, yaw.
+ *
+ * Stored as a config blob (INPUT_COND_CONFIG_KEY).
+ *
+ * Pure: no globals, no RTOS. Owned by the control task.
+ *
+ * @file InputConditioner.h
+ */
+
+#define INPUT_COND_CONFIG_KEY       "cfg_input"
+#define INPUT_COND_AXES             4
+#define INPUT_COND_MIN              (-1000)
+#define INPUT_COND_MAX              1000
+#define INPUT_COND_MAX_GAP_MS       250     // Bounded below the failsafe timeout
+#define INPUT_COND_MAX_CUTOFF_HZ    50      // Nyquist of the 100 Hz control tick
+
+typedef enum {
+    INPUT_COND_HOLD = 0,
+    INPUT_COND_EXTRAPOLATE = 1,
+    INPUT_COND_SLEW = 2,
+    INPUT_COND_MODE_COUNT
+} InputCondMode;
+
+typedef struct {
+    uint8_t mode;               // InputCondMode
+    uint16_t maxGapMs;          // Extrapolate / slew this long after a sample
+    float cutoffHz;             // Low-pass, 0 = off
+} InputCondConfig;
+
+typedef struct {
+    InputCondConfig config;
+    int16_t last[INPUT_COND_AXES];
+    int16_t prev[INPUT_COND_AXES];
+    HAL_Micros lastUs;          // Arrival of last, 0 = no sample yet
+    HAL_Micros prevUs;          // Arrival of prev, 0 = no slope
+    float filtered[INPUT_COND_AXES];
+    bool haveFiltered;
+
+    // Statistics
+    uint32_t samples;
+    uint32_t shapedTicks;       // Outputs that were not simply the newest sample
+    uint32_t expiredGaps;       // Gaps that outlived maxGapMs
+    bool expired;               // Current gap already counted
+} InputConditioner;
+
+/**
+ * Default configuration (HOLD, 100 ms, no filter)
+ */
+void InputConditioner_defaultConfig(InputCondConfig* config);
+
+/**
+ * Clamp a configuration into its valid ranges
+ */
+void InputConditioner_sanitize(InputCondConfig* config);
+
+/**
+ * Start empty with a configuration
+ */
+void InputConditioner_init(InputConditioner* ic, const InputCondConfig* config);
+
+/**
+ * Change the configuration, keeping the samples (filter restarts)
+ */
+void InputConditioner_setConfig(InputConditioner* ic, const InputCondConfig* config);
+
+/**
+ * A new stick sample
+ * @param arrivedUs When its frame arrived
+ */
+void InputConditioner_sample(InputConditioner* ic, const int16_t axes[INPUT_COND_AXES],
+                             HAL_Micros arrivedUs);
+
+/**
+ * Axes for this control tick
+ * @param nowUs Tick time
+ * @param dt    Tick period (s), for the low-pass
+ * @param axes  Out; untouched before the first sample
+ * @return false when the newest sample is older than maxGapMs (held)
+ */
+bool InputConditioner_output(InputConditioner* ic, HAL_Micros nowUs, float dt,
+                             int16_t axes[INPUT_COND_AXES]);
+
+/**
+ * Mode name for reports ("hold", "extrapolate", "slew")
+ */
+const char* InputConditioner_modeName(InputCondMode mode);
+
+/**
+ * Mode from its name
+ * @return false if the name is unknown (mode untouched)
+ */
+bool InputConditioner_parseMode(const char* name, InputCondMode* mode);
+
+#endif // INPUT_CONDITIONER_H
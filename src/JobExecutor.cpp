@@ -0,0 +1,103 @@
+#include "JobExecutor.h"
+#include <string.h>
+
+/**
+ * JobExecutor - Implementation
+ *
+ * The due set is rescanned before every job (at most
+ * JOB_EXECUTOR_MAX_JOBS entries), so a job that made another due within
+ * the same pass is picked up in order.
+ *
+ * @file JobExecutor.cpp
+ */
+
+void JobExecutor_init(JobExecutor* ex, JobClockFn clock) {
+    memset(ex, 0, sizeof(*ex));
+    ex->clock = clock;
+}
+
+int JobExecutor_add(JobExecutor* ex, const char* name, JobFn fn, uint32_t periodMs,
+                    uint32_t budgetUs, uint32_t firstDueMs) {
+    if (ex->count >= JOB_EXECUTOR_MAX_JOBS || periodMs == 0 || !fn)
+        return -1;
+    Job* job = &ex->jobs[ex->count];
+    memset(job, 0, sizeof(*job));
+    job->name = name;
+    job->fn = fn;
+    job->periodMs = periodMs;
+    job->budgetUs = budgetUs;
+    job->dueMs = firstDueMs + periodMs;
+    return ex->count++;
+}
+
+/**
+ * Most overdue job not yet run in this pass, -1 if none is due
+ */
+static int mostOverdue(const JobExecutor* ex, uint32_t nowMs, uint32_t ranMask) {
+    int best = -1;
+    int32_t bestLate = -1;
+    for (uint8_t i = 0; i < ex->count; i++) {
+        int32_t late = (int32_t)(nowMs - ex->jobs[i].dueMs);
+        if (late >= 0 && !(ranMask & (1u << i)) && late > bestLate) {
+            best = i;
+            bestLate = late;
+        }
+    }
+    return best;
+}
+
+static void runJob(JobExecutor* ex, Job* job, uint32_t nowMs) {
+    uint32_t late = nowMs - job->dueMs;
+    uint32_t start = ex->clock();
+    job->fn(nowMs);
+    uint32_t us = ex->clock() - start;
+
+    job->runs++;
+    job->lastUs = us;
+    if (us > job->maxUs) job->maxUs = us;
+    if (us > job->budgetUs) job->overruns++;
+    if (late > job->maxLateMs) job->maxLateMs = late;
+
+    // Keep the phase; a job that fell behind skips the missed periods
+    job->dueMs += job->periodMs;
+    if ((int32_t)(nowMs - job->dueMs) >= 0)
+        job->dueMs = nowMs + job->periodMs;
+}
+
+uint8_t JobExecutor_run(JobExecutor* ex, uint32_t nowMs, uint32_t sliceUs, bool controlBusy) {
+    ex->passes++;
+    if (controlBusy) ex->busyPasses++;
+
+    uint32_t start = ex->clock();
+    uint32_t ranMask = 0;
+    uint8_t ran = 0;
+    bool forcedOne = false;
+    int i;
+    while ((i = mostOverdue(ex, nowMs, ranMask)) >= 0) {
+        Job* job = &ex->jobs[i];
+        uint32_t used = ex->clock() - start;
+        bool fits = !controlBusy && used + job->budgetUs <= sliceUs;
+        bool starved = !forcedOne && nowMs - job->dueMs >= job->periodMs;
+        ranMask |= 1u << i;
+        if (!fits && !starved) {
+            job->deferrals++;
+            continue;
+        }
+        if (!fits) {
+            forcedOne = true;
+            job->forced++;
+        }
+        runJob(ex, job, nowMs);
+        ran++;
+    }
+    return ran;
+}
+
+void JobExecutor_resetStats(JobExecutor* ex) {
+    for (uint8_t i = 0; i < ex->count; i++) {
+        Job* job = &ex->jobs[i];
+        job->runs = job->overruns = job->deferrals = job->forced = 0;
+        job->lastUs = job->maxUs = job->maxLateMs = 0;
+    }
+    ex->passes = ex->busyPasses = 0;
+}
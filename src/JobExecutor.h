@@ -0,0 +1,92 @@
+#ifndef JOB_EXECUTOR_H
+#define JOB_EXECUTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * JobExecutor - Periodic housekeeping jobs under a time budget
+ *
+ * Jobs register with a period and a per-run budget; the owning task
+ * calls JobExecutor_run() once per tick, after its own work, with the
+ * slack left in that tick. Due jobs run most overdue first, and only
+ * while the job's budget still fits what is left of the slice; the rest
+ * wait for the next pass. A job that takes longer than its budget counts
+ * an overrun.
+ *
+ * While the control loop is close to its own budget the caller passes
+ * controlBusy and nothing runs. This matters even though the control
+ * task has its own core: NVS and other flash writes from a job suspend
+ * the flash cache of both cores, stalling a control tick that runs from
+ * flash.
+ *
+ * A job is held back at most one period: once it is a whole period
+ * late it runs even without slack or with the control loop busy (one
+ * such job per pass), so persistence is late but never starved.
+ *
+ * Pure: no globals, no RTOS; the clock is passed in. An executor belongs
+ * to the task that runs it.
+ *
+ * @file JobExecutor.h
+ */
+
+#define JOB_EXECUTOR_MAX_JOBS   8
+
+/**
+ * Job body
+ * @param nowMs Pass time (millis)
+ */
+typedef void (*JobFn)(uint32_t nowMs);
+
+/**
+ * Microsecond clock
+ */
+typedef uint32_t (*JobClockFn)(void);
+
+typedef struct {
+    const char* name;           // Static string
+    JobFn fn;
+    uint32_t periodMs;
+    uint32_t budgetUs;          // Expected worst run
+    uint32_t dueMs;
+
+    uint32_t runs;
+    uint32_t overruns;          // Runs over budgetUs
+    uint32_t deferrals;         // Passes where it was due but held back
+    uint32_t forced;            // Runs a whole period late (budget ignored)
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint32_t maxLateMs;         // Worst start past due
+} Job;
+
+typedef struct {
+    Job jobs[JOB_EXECUTOR_MAX_JOBS];
+    uint8_t count;
+    JobClockFn clock;
+    uint32_t passes;
+    uint32_t busyPasses;        // Passes with the control loop busy
+} JobExecutor;
+
+void JobExecutor_init(JobExecutor* ex, JobClockFn clock);
+
+/**
+ * Register a job, first due one period after firstDueMs
+ * @return Job index, -1 if the table is full or periodMs is 0
+ */
+int JobExecutor_add(JobExecutor* ex, const char* name, JobFn fn, uint32_t periodMs,
+                    uint32_t budgetUs, uint32_t firstDueMs);
+
+/**
+ * Run what is due and fits
+ * @param sliceUs Time this pass may take
+ * @param controlBusy Control loop near its budget: only jobs a period late run
+ * @return Jobs run
+ */
+uint8_t JobExecutor_run(JobExecutor* ex, uint32_t nowMs, uint32_t sliceUs, bool controlBusy);
+
+/**
+ * Clear the counters (schedule kept)
+ */
+void JobExecutor_resetStats(JobExecutor* ex);
+
+#endif // JOB_EXECUTOR_H
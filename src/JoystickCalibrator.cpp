@@ -1,11 +1,54 @@
 #include "JoystickCalibrator.h"
 
+// Stick curve NVS keys: js_expo0..3 / js_rate0..3
+static void curveKey(char* key, size_t len, const char* name, int axis) {
+    snprintf(key, len, "js_%s%d", name, axis);
+}
+
+// min / center / max of one axis
+static void axisPoints(const ConfigManager::JoystickCalibration& cal, int axis,
+                       int16_t& minVal, int16_t& centerVal, int16_t& maxVal) {
+    switch (axis) {
+        case JoystickCalibrator::AXIS_ROLL:
+            minVal = cal.minRoll;
+            centerVal = cal.centerRoll;
+            maxVal = cal.maxRoll;
+            break;
+        case JoystickCalibrator::AXIS_PITCH:
+            minVal = cal.minPitch;
+            centerVal = cal.centerPitch;
+            maxVal = cal.maxPitch;
+            break;
+        case JoystickCalibrator::AXIS_YAW:
+            minVal = cal.minYaw;
+            centerVal = cal.centerYaw;
+            maxVal = cal.maxYaw;
+            break;
+        default:
+            minVal = cal.minThrottle;
+            centerVal = cal.centerThrottle;
+            maxVal = cal.maxThrottle;
+            break;
+    }
+}
+
 JoystickCalibrator::JoystickCalibrator(ConfigManager* configManager)
     : configManager(configManager), currentAxis(AXIS_THROTTLE), currentStep(STEP_IDLE) {
     
     if (configManager) {
         tempCalibration = configManager->getJoystickCalibration();
         deadzoneConfig = configManager->getDeadzoneConfig();
+        configManager->addObserver(ConfigManager::SECTION_DEADZONE, onDeadzoneChanged, this);
+    }
+    activeCalibration = tempCalibration;
+
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++) {
+        char key[12];
+        curveKey(key, sizeof(key), "expo", axis);
+        expo[axis] = configManager ? constrain(ConfigManager::getInt(key, 0), 0, 100) : 0;
+        curveKey(key, sizeof(key), "rate", axis);
+        rate[axis] = configManager ? constrain(ConfigManager::getInt(key, 100), 0, 100) : 100;
+        buildTable((CalibrationAxis)axis);
     }
 }
 
@@ -70,10 +113,63 @@ bool JoystickCalibrator::saveCalibration() {
     }
     
     configManager->setJoystickCalibration(tempCalibration);
+    activeCalibration = tempCalibration;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++) {
+        buildTable((CalibrationAxis)axis);
+    }
     currentStep = STEP_IDLE;
     return true;
 }
 
+void JoystickCalibrator::setCurve(CalibrationAxis axis, uint8_t expoPct, uint8_t ratePct) {
+    if (axis < 0 || axis >= JOYSTICK_AXES) return;
+    expo[axis] = expoPct > 100 ? 100 : expoPct;
+    rate[axis] = ratePct > 100 ? 100 : ratePct;
+    buildTable(axis);
+
+    char key[12];
+    curveKey(key, sizeof(key), "expo", axis);
+    ConfigManager::setInt(key, expo[axis]);
+    curveKey(key, sizeof(key), "rate", axis);
+    ConfigManager::setInt(key, rate[axis]);
+}
+
+void JoystickCalibrator::reloadDeadzone() {
+    if (configManager) {
+        deadzoneConfig = configManager->getDeadzoneConfig();
+    }
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++) {
+        buildTable((CalibrationAxis)axis);
+    }
+}
+
+void JoystickCalibrator::onDeadzoneChanged(const ConfigManager::Change& change, void* ctx) {
+    // Rebuild only the axes whose deadzone moved
+    JoystickCalibrator* self = (JoystickCalibrator*)ctx;
+    const ConfigManager::DeadzoneConfig& before = *change.before.deadzone;
+    const ConfigManager::DeadzoneConfig& after = *change.after.deadzone;
+    self->deadzoneConfig = after;
+    if (after.throttle != before.throttle) self->buildTable(AXIS_THROTTLE);
+    if (after.roll != before.roll) self->buildTable(AXIS_ROLL);
+    if (after.pitch != before.pitch) self->buildTable(AXIS_PITCH);
+    if (after.yaw != before.yaw) self->buildTable(AXIS_YAW);
+}
+
+void JoystickCalibrator::buildTable(CalibrationAxis axis) {
+    int16_t minVal, centerVal, maxVal;
+    axisPoints(activeCalibration, axis, minVal, centerVal, maxVal);
+
+    // y = rate * ((1 - e) * x + e * x^3), on the dead-zoned value
+    float e = expo[axis] / 100.0f;
+    float r = rate[axis] / 100.0f;
+    for (uint16_t raw = 0; raw < JOYSTICK_LUT_SIZE; raw++) {
+        int16_t value = applyDeadzone(axis, mapAxis(raw, minVal, centerVal, maxVal));
+        float x = value / 1000.0f;
+        float y = r * ((1.0f - e) * x + e * x * x * x);
+        lut[axis][raw] = (int16_t)lroundf(y * 1000.0f);
+    }
+}
+
 void JoystickCalibrator::getAxisPointers(int16_t*& minPtr, int16_t*& centerPtr, int16_t*& maxPtr) {
     switch (currentAxis) {
         case AXIS_THROTTLE:
@@ -127,33 +223,8 @@ int16_t JoystickCalibrator::mapAxis(uint16_t rawValue, int16_t minVal, int16_t c
 }
 
 int16_t JoystickCalibrator::mapJoystickAxis(CalibrationAxis axis, uint16_t rawValue) {
-    int16_t minVal, centerVal, maxVal;
-    
-    switch (axis) {
-        case AXIS_THROTTLE:
-            minVal = tempCalibration.minThrottle;
-            centerVal = tempCalibration.centerThrottle;
-            maxVal = tempCalibration.maxThrottle;
-            break;
-        case AXIS_ROLL:
-            minVal = tempCalibration.minRoll;
-            centerVal = tempCalibration.centerRoll;
-            maxVal = tempCalibration.maxRoll;
-            break;
-        case AXIS_PITCH:
-            minVal = tempCalibration.minPitch;
-            centerVal = tempCalibration.centerPitch;
-            maxVal = tempCalibration.maxPitch;
-            break;
-        case AXIS_YAW:
-            minVal = tempCalibration.minYaw;
-            centerVal = tempCalibration.centerYaw;
-            maxVal = tempCalibration.maxYaw;
-            break;
-    }
-    
-    int16_t mapped = mapAxis(rawValue, minVal, centerVal, maxVal);
-    return applyDeadzone(axis, mapped);
+    if (axis < 0 || axis >= JOYSTICK_AXES) return 0;
+    return lut[axis][rawValue < JOYSTICK_LUT_SIZE ? rawValue : JOYSTICK_LUT_SIZE - 1];
 }
 
 int16_t JoystickCalibrator::applyDeadzone(CalibrationAxis axis, int16_t value) {
@@ -196,6 +267,10 @@ void JoystickCalibrator::resetCalibration() {
         configManager->resetJoystickCalibration();
         tempCalibration = configManager->getJoystickCalibration();
     }
+    activeCalibration = tempCalibration;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++) {
+        buildTable((CalibrationAxis)axis);
+    }
     currentStep = STEP_IDLE;
     Serial.println("{\"msg\":\"Joystick calibration reset to defaults\"}");
 }
@@ -19,7 +19,15 @@
  * - Raw ADC values (0-1023) mapped to scaled output (-1000 to +1000)
  * - Deadzone applied to prevent stick drift
  * - Smooth transitions with min/max scaling
+ * - Optional expo / rate curve per axis
+ *
+ * All of the above is compiled into one table per axis (one entry per raw
+ * ADC value) whenever calibration, deadzone or curve changes, so
+ * mapJoystickAxis() is a single indexed load.
  */
+
+#define JOYSTICK_LUT_SIZE   1024    // Raw ADC range, 10 bit
+#define JOYSTICK_AXES       4
 class JoystickCalibrator {
 public:
     enum CalibrationAxis {
@@ -72,9 +80,22 @@ public:
     
     /**
      * Convert raw ADC value to scaled output (-1000 to +1000)
-     * Applies calibration mapping and deadzone
+     * Applies calibration mapping, deadzone and stick curve (table lookup)
      */
     int16_t mapJoystickAxis(CalibrationAxis axis, uint16_t rawValue);
+
+    /**
+     * Set the stick curve of an axis and rebuild its table (saved to NVS)
+     * @param expo 0-100%: 0 = linear, 100 = pure cubic
+     * @param rate 0-100%: full-stick output
+     */
+    void setCurve(CalibrationAxis axis, uint8_t expo, uint8_t rate);
+
+    /**
+     * Re-read the deadzone from ConfigManager and rebuild all tables
+     * (deadzone changes made through ConfigManager are applied already)
+     */
+    void reloadDeadzone();
     
     /**
      * Apply deadzone to axis value
@@ -95,6 +116,8 @@ public:
     void resetCalibration();
     
 private:
+    static void onDeadzoneChanged(const ConfigManager::Change& change, void* ctx);
+
     ConfigManager* configManager;
     
     CalibrationAxis currentAxis;
@@ -103,6 +126,18 @@ private:
     // Temporary calibration data during process
     ConfigManager::JoystickCalibration tempCalibration;
     ConfigManager::DeadzoneConfig deadzoneConfig;
+
+    // Calibration the tables are built from (tempCalibration is edited
+    // point by point during a calibration run)
+    ConfigManager::JoystickCalibration activeCalibration;
+    uint8_t expo[JOYSTICK_AXES];
+    uint8_t rate[JOYSTICK_AXES];
+    int16_t lut[JOYSTICK_AXES][JOYSTICK_LUT_SIZE];
+
+    /**
+     * Rebuild the table of one axis from activeCalibration, deadzone and curve
+     */
+    void buildTable(CalibrationAxis axis);
     
     /**
      * Get min/center/max pointers for current axis
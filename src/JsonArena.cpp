@@ -0,0 +1,86 @@
+#include "JsonArena.h"
+#include <string.h>
+
+/**
+ * JsonArena - Implementation
+ *
+ * Blocks are laid out back to back as [Header][payload], each padded to
+ * JSON_ARENA_ALIGN. Only the newest block can shrink, grow or be freed
+ * in place; any other free leaves a hole until reset().
+ *
+ * @file JsonArena.cpp
+ */
+
+JsonArena::JsonArena(uint8_t* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity), _used(0), _highWater(0), _failures(0) {}
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+size_t JsonArena::blockSize(size_t size) {
+    return sizeof(Header) + ((size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1));
+}
+
+JsonArena::Header* JsonArena::header(void* ptr) const {
+    return (Header*)((uint8_t*)ptr - sizeof(Header));
+}
+
+bool JsonArena::isTop(void* ptr) const {
+    return (uint8_t*)header(ptr) + blockSize(header(ptr)->size) == _buffer + _used;
+}
+
+bool JsonArena::grow(size_t bytes) {
+    if (bytes > _capacity - _used) {
+        _failures++;
+        return false;
+    }
+    _used += bytes;
+    if (_used > _highWater) _highWater = _used;
+    return true;
+}
+
+// ============================================================================
+// Allocator Interface
+// ============================================================================
+
+void* JsonArena::allocate(size_t size) {
+    size_t offset = _used;
+    if (!grow(blockSize(size))) return nullptr;
+
+    Header* h = (Header*)(_buffer + offset);
+    h->size = (uint32_t)size;
+    return h + 1;
+}
+
+void JsonArena::deallocate(void* ptr) {
+    if (ptr && isTop(ptr)) {
+        _used = (uint8_t*)header(ptr) - _buffer;
+    }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize) {
+    if (!ptr) return allocate(newSize);
+
+    Header* h = header(ptr);
+    size_t oldBlock = blockSize(h->size);
+    size_t newBlock = blockSize(newSize);
+
+    if (isTop(ptr)) {
+        // Newest block: resize in place
+        if (newBlock > oldBlock && !grow(newBlock - oldBlock)) return nullptr;
+        if (newBlock < oldBlock) _used -= oldBlock - newBlock;
+        h->size = (uint32_t)newSize;
+        return ptr;
+    }
+
+    if (newSize <= h->size) {
+        // Shrinking an older block: keep it, the tail is reclaimed on reset
+        h->size = (uint32_t)newSize;
+        return ptr;
+    }
+
+    void* moved = allocate(newSize);
+    if (moved) memcpy(moved, ptr, h->size);
+    return moved;
+}
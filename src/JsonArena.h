@@ -0,0 +1,87 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * JsonArena - Bump allocator for short-lived ArduinoJson documents
+ *
+ * Features:
+ * - Fixed buffer owned by one task (command, telemetry), never the heap
+ * - Allocation is a pointer bump; freeing / growing the newest block
+ *   happens in place (ArduinoJson's string builder and pool shrink)
+ * - Everything is released at once with reset() at the end of a cycle
+ * - Hard cap: an allocation that does not fit fails, the document is
+ *   marked overflowed() and the failure is counted
+ *
+ *   void handleCommand() {
+ *       JsonArenaScope scope(commandArena);     // Before any document
+ *       JsonDocument doc(&commandArena);
+ *       ...
+ *   }                                           // Documents, then reset
+ *
+ * Documents must not outlive the reset (declare the scope first).
+ *
+ * @file JsonArena.h
+ */
+
+#define JSON_ARENA_ALIGN 8              // ArduinoJson slots hold doubles / int64
+
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    /**
+     * @param buffer Backing storage, JSON_ARENA_ALIGN aligned
+     * @param capacity Buffer size in bytes (the cap)
+     */
+    JsonArena(uint8_t* buffer, size_t capacity);
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    /**
+     * Release every block (no document may still use the arena)
+     */
+    void reset() { _used = 0; }
+
+    size_t used() const { return _used; }
+    size_t capacity() const { return _capacity; }
+    size_t highWater() const { return _highWater; }
+    uint32_t failures() const { return _failures; }
+
+private:
+    struct Header {
+        uint32_t size;                  // Requested size of the block
+        uint32_t reserved;              // Keeps the payload aligned
+    };
+
+    static size_t blockSize(size_t size);
+    Header* header(void* ptr) const;
+    bool isTop(void* ptr) const;
+    bool grow(size_t bytes);
+
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _used;
+    size_t _highWater;
+    uint32_t _failures;
+};
+
+/**
+ * Resets an arena when the enclosing scope ends
+ */
+class JsonArenaScope {
+public:
+    explicit JsonArenaScope(JsonArena& arena) : _arena(arena) {}
+    ~JsonArenaScope() { _arena.reset(); }
+
+    JsonArenaScope(const JsonArenaScope&) = delete;
+    JsonArenaScope& operator=(const JsonArenaScope&) = delete;
+
+private:
+    JsonArena& _arena;
+};
+
+#endif // JSON_ARENA_H
@@ -0,0 +1,117 @@
+#include "JsonTemplate.h"
+#include <string.h>
+
+/**
+ * JsonTemplate - Implementation
+ *
+ * Digits are produced right to left with one divide per digit; a 32-bit
+ * value needs at most 10 digits plus sign and point.
+ *
+ * @file JsonTemplate.cpp
+ */
+
+static const int32_t POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                                10000000, 100000000, 1000000000};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+/**
+ * Format into tmp, reversed
+ * @return Characters written
+ */
+static uint8_t format_reversed(char* tmp, uint32_t magnitude, bool negative, uint8_t decimals) {
+    uint8_t n = 0;
+    uint8_t digit = 0;
+    do {
+        if (decimals && digit == decimals) tmp[n++] = '.';
+        tmp[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+        digit++;
+    } while (magnitude || digit <= decimals);
+    if (negative) tmp[n++] = '-';
+    return n;
+}
+
+/**
+ * Largest magnitude (scaled) that fits a field
+ */
+static uint32_t max_magnitude(const JsonTemplateField* f, bool negative) {
+    uint8_t digits = f->width - (f->decimals ? 1 : 0) - (negative ? 1 : 0);
+    if (digits >= 10) return 0xFFFFFFFFu;
+    return (uint32_t)POW10[digits] - 1;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+bool JsonTemplate_init(JsonTemplate* tpl, const char* pattern) {
+    memset(tpl, 0, sizeof(*tpl));
+    size_t len = strlen(pattern);
+    if (len >= JSON_TEMPLATE_MAX_LEN) return false;
+    memcpy(tpl->text, pattern, len);
+    tpl->len = (uint8_t)len;
+
+    for (size_t i = 0; i < len;) {
+        if (pattern[i] != '#') {
+            i++;
+            continue;
+        }
+        if (tpl->fieldCount >= JSON_TEMPLATE_MAX_FIELDS) return false;
+
+        JsonTemplateField* f = &tpl->fields[tpl->fieldCount++];
+        f->pos = (uint8_t)i;
+        size_t end = i;
+        int point = -1;
+        while (end < len && (pattern[end] == '#' || (pattern[end] == '.' && point < 0))) {
+            if (pattern[end] == '.') point = (int)end;
+            end++;
+        }
+        if (point >= 0 && pattern[end - 1] == '.') {
+            point = -1;             // Trailing '.' is not part of the field
+            end--;
+        }
+        f->width = (uint8_t)(end - i);
+        f->decimals = point >= 0 ? (uint8_t)(end - point - 1) : 0;
+        if (point == (int)i || f->decimals > 9) return false;
+
+        JsonTemplate_setInt(tpl, tpl->fieldCount - 1, 0);
+        i = end;
+    }
+    return true;
+}
+
+void JsonTemplate_setInt(JsonTemplate* tpl, uint8_t field, int32_t scaled) {
+    if (field >= tpl->fieldCount) return;
+    const JsonTemplateField* f = &tpl->fields[field];
+
+    bool negative = scaled < 0;
+    uint32_t magnitude = negative ? 0u - (uint32_t)scaled : (uint32_t)scaled;
+    uint32_t limit = max_magnitude(f, negative);
+    if (magnitude > limit) magnitude = limit;
+
+    char tmp[12];
+    uint8_t n = format_reversed(tmp, magnitude, negative, f->decimals);
+    if (n > f->width) {
+        // Only a negative value in a field too narrow for its sign
+        n = format_reversed(tmp, 0, false, f->decimals);
+    }
+
+    char* out = &tpl->text[f->pos];
+    uint8_t pad = f->width - n;
+    memset(out, ' ', pad);
+    for (uint8_t i = 0; i < n; i++) out[pad + i] = tmp[n - 1 - i];
+}
+
+void JsonTemplate_setFloat(JsonTemplate* tpl, uint8_t field, float value) {
+    if (field >= tpl->fieldCount) return;
+    float scaled = value * (float)POW10[tpl->fields[field].decimals];
+    int32_t v;
+    if (scaled != scaled) v = 0;                        // NaN
+    else if (scaled >= 2147483520.0f) v = INT32_MAX;
+    else if (scaled <= -2147483520.0f) v = INT32_MIN + 1;
+    else v = (int32_t)(scaled + (scaled < 0 ? -0.5f : 0.5f));
+    JsonTemplate_setInt(tpl, field, v);
+}
@@ -0,0 +1,71 @@
+#ifndef JSON_TEMPLATE_H
+#define JSON_TEMPLATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * JsonTemplate - Fixed-layout JSON line with numeric fields patched in place
+ *
+ * The line is laid out once from a pattern in which each run of '#'
+ * (optionally with one '.') is a numeric field of that width:
+ *
+ *   {"t":2,"v":##.###,"r":###}\r\n    ->    {"t":2,"v": 0.000,"r":  0}\r\n
+ *
+ * Setting a field rewrites only its characters with a right-aligned
+ * integer / fixed-point value, padded with spaces (JSON whitespace), so
+ * the line length never changes and no serializer runs. Values that do
+ * not fit are clamped to the widest number the field can hold.
+ *
+ * @file JsonTemplate.h
+ */
+
+#define JSON_TEMPLATE_MAX_LEN       160
+#define JSON_TEMPLATE_MAX_FIELDS    16
+
+/**
+ * One numeric field of a template
+ */
+typedef struct {
+    uint8_t pos;                    // Offset of the first character
+    uint8_t width;                  // Characters, sign and point included
+    uint8_t decimals;               // Digits after the point (0 = integer)
+} JsonTemplateField;
+
+/**
+ * Template and its current text
+ */
+typedef struct {
+    char text[JSON_TEMPLATE_MAX_LEN];
+    uint8_t len;
+    uint8_t fieldCount;
+    JsonTemplateField fields[JSON_TEMPLATE_MAX_FIELDS];
+} JsonTemplate;
+
+/**
+ * Lay out a template (fields in pattern order, all set to 0)
+ * @param tpl Template state
+ * @param pattern Line with '#' placeholders
+ * @return false if the pattern is too long, has too many fields or a
+ *         field without an integer digit
+ */
+bool JsonTemplate_init(JsonTemplate* tpl, const char* pattern);
+
+/**
+ * Set a field from a scaled integer
+ * @param tpl Template state
+ * @param field Field index (pattern order)
+ * @param scaled Value times 10^decimals (e.g. millivolts for "##.###")
+ */
+void JsonTemplate_setInt(JsonTemplate* tpl, uint8_t field, int32_t scaled);
+
+/**
+ * Set a field from a float (rounded to the field's decimals, NaN -> 0)
+ * @param tpl Template state
+ * @param field Field index (pattern order)
+ * @param value Value
+ */
+void JsonTemplate_setFloat(JsonTemplate* tpl, uint8_t field, float value);
+
+#endif // JSON_TEMPLATE_H
@@ -1,32 +1,47 @@
 #include "KeyExchangeManager.h"
+#include "HAL.h"
+#include "MemoryProfiler.h"
+#include "SecureRandom.h"
+#include "Trace.h"
 
 KeyExchangeManager& KeyExchangeManager::getInstance() {
     static KeyExchangeManager instance;
     return instance;
 }
 
-KeyExchangeManager::KeyExchangeManager() : _state(KX_STATE_IDLE), _initialized(false) {
+static mbedtls_ecp_group_id groupId(KeyExchangeCurve curve) {
+    return curve == KX_CURVE_X25519 ? MBEDTLS_ECP_DP_CURVE25519 : MBEDTLS_ECP_DP_SECP256R1;
+}
+
+KeyExchangeManager::KeyExchangeManager()
+    : _state(KX_STATE_IDLE), _initialized(false), _curve(KX_CURVE_P256), _lock(NULL),
+      _nextCurve(KX_CURVE_P256), _nextReady(false),
+      _requestPending(false), _requestMux(portMUX_INITIALIZER_UNLOCKED), _worker(NULL),
+      _onDone(NULL), _lastHandshakeUs(0) {
     memset(_lastError, 0, sizeof(_lastError));
 }
 
 bool KeyExchangeManager::init() {
     if (_initialized) return true;
 
-    mbedtls_ecdh_init(&_ctx);
-    mbedtls_ctr_drbg_init(&_ctr_drbg);
-    mbedtls_entropy_init(&_entropy);
+    if (!_lock) _lock = xSemaphoreCreateMutex();
+    if (!_lock) {
+        setError("Lock Alloc Failed");
+        return false;
+    }
 
-    const char *pers = "na_key_exchange";
-    int ret = mbedtls_ctr_drbg_seed(&_ctr_drbg, mbedtls_entropy_func, &_entropy,
-                                    (const unsigned char *)pers, strlen(pers));
+    mbedtls_ecdh_init(&_ctx);
+    mbedtls_mpi_init(&_nextD);
+    mbedtls_ecp_point_init(&_nextQ);
 
-    if (ret != 0) {
+    // Shared DRBG, normally already seeded by EncryptionManager
+    if (!SecureRandom_init()) {
         setError("RNG Seed Failed");
         return false;
     }
 
-    // Setup ECDH context for secp256r1 (NIST P-256)
-    ret = mbedtls_ecdh_setup(&_ctx, MBEDTLS_ECP_DP_SECP256R1);
+    // Setup ECDH context (secp256r1 unless setCurve() chose X25519)
+    int ret = mbedtls_ecdh_setup(&_ctx, groupId(_curve));
     if (ret != 0) {
         setError("ECDH Setup Failed");
         return false;
@@ -37,24 +52,43 @@ bool KeyExchangeManager::init() {
 }
 
 void KeyExchangeManager::reset() {
+    if (_lock) xSemaphoreTake(_lock, portMAX_DELAY);
+    resetLocked();
+    if (_lock) xSemaphoreGive(_lock);
+}
+
+void KeyExchangeManager::resetLocked() {
     if (_initialized) {
         mbedtls_ecdh_free(&_ctx);
         // Re-init context for next use
         mbedtls_ecdh_init(&_ctx);
-        mbedtls_ecdh_setup(&_ctx, MBEDTLS_ECP_DP_SECP256R1);
+        mbedtls_ecdh_setup(&_ctx, groupId(_curve));
     }
     _state = KX_STATE_IDLE;
     memset(_sharedSecret, 0, KEY_EXCHANGE_SHARED_SECRET_SIZE);
 }
 
+void KeyExchangeManager::setCurve(KeyExchangeCurve curve) {
+    if (_lock) xSemaphoreTake(_lock, portMAX_DELAY);
+    _curve = curve;
+    resetLocked();
+    if (_lock) xSemaphoreGive(_lock);
+}
+
 bool KeyExchangeManager::generateKeyPair() {
     if (!_initialized && !init()) return false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool ok = generateKeyPairLocked();
+    xSemaphoreGive(_lock);
+    return ok;
+}
 
+bool KeyExchangeManager::generateKeyPairLocked() {
     _state = KX_STATE_GENERATING_KEYS;
-    
+
     int ret = mbedtls_ecp_gen_keypair(&_ctx.grp, &_ctx.d, &_ctx.Q,
-                                      mbedtls_ctr_drbg_random, &_ctr_drbg);
-    
+                                      SecureRandom_mbedtls, NULL);
+
     if (ret != 0) {
         setError("Key Gen Failed");
         _state = KX_STATE_FAILED;
@@ -66,23 +100,37 @@ bool KeyExchangeManager::generateKeyPair() {
 }
 
 bool KeyExchangeManager::getPublicKey(uint8_t* buffer) {
+    if (!_initialized) return false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool ok = getPublicKeyLocked(buffer);
+    xSemaphoreGive(_lock);
+    return ok;
+}
+
+bool KeyExchangeManager::getPublicKeyLocked(uint8_t* buffer) {
     if (_state == KX_STATE_IDLE || _state == KX_STATE_FAILED) return false;
 
-    // Export public point Q to raw bytes (X || Y)
+    // X25519: the 32-byte little-endian u coordinate is the public key
+    // P-256: export public point Q to raw bytes (X || Y)
     // mbedtls stores Q as (X, Y, Z). for affine coordinates Z=1
     size_t len = 0;
     // We write uncompressed point: 0x04 || X || Y (65 bytes)
     // But our protocol expects raw 64 bytes (X || Y) to save space if we strip 0x04 header
-    
+
     uint8_t tempBuf[65];
-    int ret = mbedtls_ecp_point_write_binary(&_ctx.grp, &_ctx.Q, MBEDTLS_ECP_PF_UNCOMPRESSED, 
+    int ret = mbedtls_ecp_point_write_binary(&_ctx.grp, &_ctx.Q, MBEDTLS_ECP_PF_UNCOMPRESSED,
                                              &len, tempBuf, sizeof(tempBuf));
-                                             
+
     if (ret != 0) {
         setError("Export PubKey Failed");
         return false;
     }
 
+    if (_curve == KX_CURVE_X25519) {
+        memcpy(buffer, tempBuf, KEY_EXCHANGE_X25519_PUBKEY_SIZE);
+        return true;
+    }
+
     // Skip the 0x04 header (uncompressed format marker)
     memcpy(buffer, tempBuf + 1, 64);
     return true;
@@ -90,16 +138,27 @@ bool KeyExchangeManager::getPublicKey(uint8_t* buffer) {
 
 bool KeyExchangeManager::computeSharedSecret(const uint8_t* peerPublicKey) {
     if (!_initialized) return false;
-    
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool ok = computeSharedSecretLocked(peerPublicKey);
+    xSemaphoreGive(_lock);
+    return ok;
+}
+
+bool KeyExchangeManager::computeSharedSecretLocked(const uint8_t* peerPublicKey) {
     _state = KX_STATE_COMPUTING_SECRET;
 
     // Import peer's public key
-    // We need to add back the 0x04 header
-    uint8_t tempBuf[65];
-    tempBuf[0] = 0x04;
-    memcpy(tempBuf + 1, peerPublicKey, 64);
-
-    int ret = mbedtls_ecp_point_read_binary(&_ctx.grp, &_ctx.Qp, tempBuf, 65);
+    // P-256: we need to add back the 0x04 header
+    int ret;
+    if (_curve == KX_CURVE_X25519) {
+        ret = mbedtls_ecp_point_read_binary(&_ctx.grp, &_ctx.Qp, peerPublicKey,
+                                            KEY_EXCHANGE_X25519_PUBKEY_SIZE);
+    } else {
+        uint8_t tempBuf[65];
+        tempBuf[0] = 0x04;
+        memcpy(tempBuf + 1, peerPublicKey, 64);
+        ret = mbedtls_ecp_point_read_binary(&_ctx.grp, &_ctx.Qp, tempBuf, 65);
+    }
     if (ret != 0) {
         setError("Import Peer Key Failed");
         _state = KX_STATE_FAILED;
@@ -109,24 +168,24 @@ bool KeyExchangeManager::computeSharedSecret(const uint8_t* peerPublicKey) {
     // Compute shared secret
     size_t len = 0;
     uint8_t secretBuf[32]; // raw X coordinate of shared point
-    
+
     ret = mbedtls_ecdh_calc_secret(&_ctx, &len, secretBuf, sizeof(secretBuf),
-                                   mbedtls_ctr_drbg_random, &_ctr_drbg);
+                                   SecureRandom_mbedtls, NULL);
 
     if (ret != 0) {
         setError("Secret Compute Failed");
         _state = KX_STATE_FAILED;
         return false;
     }
-    
+
     memcpy(_sharedSecret, secretBuf, 32);
     _state = KX_STATE_KEY_ESTABLISHED;
-    
+
     // Free contexts to save memory as soon as we are done
     // But keep the shared secret
     // Note: In a real "Zero Trust", we might want to derive session keys immediately and wipe master secret
     // For now we store the raw secret to be passed to EncryptionManager
-    
+
     return true;
 }
 
@@ -136,6 +195,144 @@ bool KeyExchangeManager::getSharedSecret(uint8_t* buffer) {
     return true;
 }
 
+// ============================================================================
+// Background Handshakes
+// ============================================================================
+
+bool KeyExchangeManager::startWorker(UBaseType_t priority, BaseType_t core,
+                                     KeyExchangeDoneFn onDone) {
+    if (_worker) return true;
+    if (!_initialized && !init()) return false;
+    _onDone = onDone;
+    MemoryProfiler_setTaskStackSize("kx", KEY_EXCHANGE_WORKER_STACK);
+    if (xTaskCreatePinnedToCore(workerEntry, "kx", KEY_EXCHANGE_WORKER_STACK, this,
+                                priority, &_worker, core) != pdPASS) {
+        _worker = NULL;
+        setError("Worker Create Failed");
+        return false;
+    }
+    return true;
+}
+
+bool KeyExchangeManager::submitHandshakeInit(const uint8_t* mac, const uint8_t* peerPublicKey,
+                                             KeyExchangeCurve curve, uint8_t tag) {
+    return submit(mac, peerPublicKey, true, curve, tag);
+}
+
+bool KeyExchangeManager::submitPeerPublicKey(const uint8_t* mac, const uint8_t* peerPublicKey,
+                                             KeyExchangeCurve curve, uint8_t tag) {
+    return submit(mac, peerPublicKey, false, curve, tag);
+}
+
+bool KeyExchangeManager::submit(const uint8_t* mac, const uint8_t* peerPublicKey, bool respond,
+                                KeyExchangeCurve curve, uint8_t tag) {
+    if (!_worker) return false;
+    portENTER_CRITICAL(&_requestMux);
+    memcpy(_request.mac, mac, 6);
+    memcpy(_request.peerPublicKey, peerPublicKey, getPublicKeySize(curve));
+    _request.respond = respond;
+    _request.curve = curve;
+    _request.tag = tag;
+    _request.postedUs = HAL_GetMicros();
+    _requestPending = true;
+    portEXIT_CRITICAL(&_requestMux);
+    xTaskNotifyGive(_worker);
+    return true;
+}
+
+// Fill the spare pair (one scalar multiplication, done while idle)
+void KeyExchangeManager::precomputeNext() {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (mbedtls_ecp_gen_keypair(&_ctx.grp, &_nextD, &_nextQ, SecureRandom_mbedtls,
+                                NULL) == 0) {
+        _nextCurve = _curve;
+        _nextReady = true;
+    } else {
+        setError("Key Pregen Failed");
+    }
+    xSemaphoreGive(_lock);
+}
+
+void KeyExchangeManager::handleRequest(const Request& req) {
+    TRACE_SCOPE(TRACE_EV_KX);
+    uint8_t secret[KEY_EXCHANGE_SHARED_SECRET_SIZE];
+    uint8_t publicKey[KEY_EXCHANGE_PUBKEY_SIZE];
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    bool ok = true;
+    if (req.respond) {
+        // New session in the initiator's curve: install the pregenerated
+        // pair if it is for that curve (or make one now)
+        _curve = req.curve;
+        resetLocked();
+        if (_nextReady && _nextCurve == _curve) {
+            ok = mbedtls_mpi_copy(&_ctx.d, &_nextD) == 0 &&
+                 mbedtls_ecp_copy(&_ctx.Q, &_nextQ) == 0;
+            _state = ok ? KX_STATE_WAIT_FOR_PEER_PUBKEY : KX_STATE_FAILED;
+        } else {
+            ok = generateKeyPairLocked();
+        }
+        _nextReady = false;
+        ok = ok && getPublicKeyLocked(publicKey);
+    } else if (req.curve != _curve) {
+        setError("Curve Mismatch");
+        _state = KX_STATE_FAILED;
+        ok = false;
+    }
+    ok = ok && computeSharedSecretLocked(req.peerPublicKey);
+    if (ok) memcpy(secret, _sharedSecret, sizeof(secret));
+    xSemaphoreGive(_lock);
+
+    _lastHandshakeUs = HAL_GetMicros() - req.postedUs;
+    if (_onDone) _onDone(req.mac, ok, req.curve, req.tag, ok ? secret : NULL,
+                         req.respond && ok ? publicKey : NULL);
+    memset(secret, 0, sizeof(secret));
+}
+
+void KeyExchangeManager::workerEntry(void* arg) {
+    KeyExchangeManager* self = (KeyExchangeManager*)arg;
+    for (;;) {
+        if (!self->_nextReady && !self->_requestPending) self->precomputeNext();
+        ulTaskNotifyTake(pdTRUE, self->_nextReady ? portMAX_DELAY : pdMS_TO_TICKS(1000));
+
+        Request req;
+        portENTER_CRITICAL(&self->_requestMux);
+        bool pending = self->_requestPending;
+        if (pending) req = self->_request;
+        self->_requestPending = false;
+        portEXIT_CRITICAL(&self->_requestMux);
+
+        if (pending) self->handleRequest(req);
+    }
+}
+
+uint32_t KeyExchangeManager::benchmark(KeyExchangeCurve curve) {
+    if (!_initialized && !init()) return 0;
+
+    mbedtls_ecdh_context a, b;
+    mbedtls_ecdh_init(&a);
+    mbedtls_ecdh_init(&b);
+    uint8_t secret[KEY_EXCHANGE_SHARED_SECRET_SIZE];
+    size_t len = 0;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    uint32_t start = HAL_GetMicros();
+    bool ok = mbedtls_ecdh_setup(&a, groupId(curve)) == 0 &&
+              mbedtls_ecdh_setup(&b, groupId(curve)) == 0 &&
+              mbedtls_ecp_gen_keypair(&a.grp, &a.d, &a.Q, SecureRandom_mbedtls, NULL) == 0 &&
+              mbedtls_ecp_gen_keypair(&b.grp, &b.d, &b.Q, SecureRandom_mbedtls, NULL) == 0 &&
+              mbedtls_ecp_copy(&a.Qp, &b.Q) == 0 &&
+              mbedtls_ecdh_calc_secret(&a, &len, secret, sizeof(secret),
+                                       SecureRandom_mbedtls, NULL) == 0;
+    uint32_t elapsed = HAL_GetMicros() - start;
+    xSemaphoreGive(_lock);
+
+    mbedtls_ecdh_free(&a);
+    mbedtls_ecdh_free(&b);
+    memset(secret, 0, sizeof(secret));
+    return ok ? elapsed : 0;
+}
+
 void KeyExchangeManager::setError(const char* msg) {
     strncpy(_lastError, msg, sizeof(_lastError) - 1);
     Serial.printf("[KeyExchange] Error: %s\n", msg);
@@ -5,17 +5,40 @@
 #include <stdint.h>
 #include "mbedtls/config.h"
 #include "mbedtls/platform.h"
-#include "mbedtls/entropy.h"
-#include "mbedtls/ctr_drbg.h"
 #include "mbedtls/ecdh.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 // Phase 10: Secure Key Exchange (ECDH)
-// Curve: secp256r1 (NIST P-256)
+// Curve: secp256r1 (NIST P-256) or X25519, chosen per exchange
 // Key Size: 256 bits (32 bytes) public point coordinates
 
 #define KEY_EXCHANGE_PUBKEY_SIZE 64 // 32 bytes X + 32 bytes Y (Raw Point)
+#define KEY_EXCHANGE_X25519_PUBKEY_SIZE 32 // u coordinate, little-endian (RFC 7748)
 #define KEY_EXCHANGE_SHARED_SECRET_SIZE 32
 #define KEY_EXCHANGE_TIMEOUT_MS 5000 
+#define KEY_EXCHANGE_WORKER_STACK 6144  // mbedtls ECP
+
+enum KeyExchangeCurve : uint8_t {
+    KX_CURVE_P256 = 1,      // Same values as the handshake kxVersion field
+    KX_CURVE_X25519 = 2     // Montgomery ladder: faster on Xtensa, constant time
+};
+
+// Radio handshakes run in a worker task: the Wi-Fi callback only posts
+// the peer's key, the next ephemeral pair is generated ahead of time,
+// and the shared secret is computed off the radio path. Completion is
+// reported from the worker task.
+// @param mac Peer address
+// @param ok Secret established
+// @param curve Curve of the exchange (sets the public key size)
+// @param tag Caller's value from the submit call, returned unchanged
+// @param secret 32-byte shared secret (ok only)
+// @param publicKey Our public key to send back, NULL if the peer
+//        already has it (it initiated with our key)
+typedef void (*KeyExchangeDoneFn)(const uint8_t* mac, bool ok, KeyExchangeCurve curve,
+                                  uint8_t tag, const uint8_t* secret,
+                                  const uint8_t* publicKey);
 
 enum KeyExchangeState {
     KX_STATE_IDLE,
@@ -34,11 +57,19 @@ public:
     bool init();
     void reset();
 
+    // Curve for the next exchange (reset() and keys switch with it)
+    void setCurve(KeyExchangeCurve curve);
+    KeyExchangeCurve getCurve() { return _curve; }
+    static size_t getPublicKeySize(KeyExchangeCurve curve) {
+        return curve == KX_CURVE_X25519 ? KEY_EXCHANGE_X25519_PUBKEY_SIZE
+                                        : KEY_EXCHANGE_PUBKEY_SIZE;
+    }
+
     // Key Generation (Step 1)
     bool generateKeyPair();
-    bool getPublicKey(uint8_t* buffer); // Writes 64 bytes (X || Y)
+    bool getPublicKey(uint8_t* buffer); // Writes getPublicKeySize(getCurve()) bytes
 
-    // Key Exchange (Step 2)
+    // Key Exchange (Step 2), peer key in the current curve's format
     bool computeSharedSecret(const uint8_t* peerPublicKey);
     bool getSharedSecret(uint8_t* buffer); // Writes 32 bytes
 
@@ -47,21 +78,69 @@ public:
     bool isEstablished() { return _state == KX_STATE_KEY_ESTABLISHED; }
     const char* getLastError() { return _lastError; }
 
+    // Background Handshakes
+    bool startWorker(UBaseType_t priority, BaseType_t core, KeyExchangeDoneFn onDone);
+    // Wi-Fi task safe: copy the request and return (a newer one replaces
+    // a request still waiting)
+    bool submitHandshakeInit(const uint8_t* mac, const uint8_t* peerPublicKey,
+                             KeyExchangeCurve curve = KX_CURVE_P256, uint8_t tag = 0);
+    bool submitPeerPublicKey(const uint8_t* mac, const uint8_t* peerPublicKey,
+                             KeyExchangeCurve curve = KX_CURVE_P256, uint8_t tag = 0);
+    bool hasPrecomputedKey() { return _nextReady; }
+    uint32_t getLastHandshakeUs() { return _lastHandshakeUs; }  // Post to secret ready
+
+    // Time one full local exchange (two key pairs + one secret), in us
+    // Scratch context: the session keys are untouched. 0 on failure.
+    uint32_t benchmark(KeyExchangeCurve curve);
+
 private:
     KeyExchangeManager();
     
     KeyExchangeState _state;
     char _lastError[64];
     
-    // mbedtls context
-    mbedtls_entropy_context _entropy;
-    mbedtls_ctr_drbg_context _ctr_drbg;
+    // mbedtls context (randomness from SecureRandom)
     mbedtls_ecdh_context _ctx;
     
     bool _initialized;
+    KeyExchangeCurve _curve;
     uint8_t _sharedSecret[KEY_EXCHANGE_SHARED_SECRET_SIZE];
-    
+
+    // All mbedtls contexts are used under _lock
+    SemaphoreHandle_t _lock;
+
+    // Next ephemeral pair, generated by the worker while idle
+    mbedtls_mpi _nextD;
+    mbedtls_ecp_point _nextQ;
+    KeyExchangeCurve _nextCurve;
+    volatile bool _nextReady;
+
+    // One-slot request mailbox (Wi-Fi task -> worker)
+    struct Request {
+        uint8_t mac[6];
+        uint8_t peerPublicKey[KEY_EXCHANGE_PUBKEY_SIZE];
+        bool respond;           // INIT: install a new pair and send our key back
+        KeyExchangeCurve curve;
+        uint8_t tag;
+        uint32_t postedUs;
+    };
+    Request _request;
+    volatile bool _requestPending;
+    portMUX_TYPE _requestMux;
+    TaskHandle_t _worker;
+    KeyExchangeDoneFn _onDone;
+    uint32_t _lastHandshakeUs;
+
     void setError(const char* msg);
+    void resetLocked();
+    bool generateKeyPairLocked();
+    bool getPublicKeyLocked(uint8_t* buffer);
+    bool computeSharedSecretLocked(const uint8_t* peerPublicKey);
+    bool submit(const uint8_t* mac, const uint8_t* peerPublicKey, bool respond,
+                KeyExchangeCurve curve, uint8_t tag);
+    void precomputeNext();
+    void handleRequest(const Request& req);
+    static void workerEntry(void* arg);
 };
 
 #endif // KEY_EXCHANGE_MANAGER_H
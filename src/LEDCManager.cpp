@@ -1,5 +1,7 @@
 #include "LEDCManager.h"
-#include "driver/ledc.h"
+#include "HAL.h"
+#include "drivers/Motor.h"
+#include "drivers/ServoDriver.h"
 #include <ArduinoJson.h>
 
 bool LEDCManager::allocateMotorChannel(uint8_t pin, LEDCChannel channel) {
@@ -13,9 +15,10 @@ bool LEDCManager::allocateMotorChannel(uint8_t pin, LEDCChannel channel) {
     return false;
   }
 
-  channelPins[channel] = pin;
-  isMotorChannel[channel] = true;
-  configureChannel(channel, pin, MOTOR_FREQUENCY, true);
+  if (!configureChannel(channel, pin, true)) {
+    Serial.println("[LEDC] Error: No PWM channel available");
+    return false;
+  }
 
   allocatedChannels |= (1 << channel);
 
@@ -40,9 +43,10 @@ bool LEDCManager::allocateServoChannel(uint8_t pin, LEDCChannel channel) {
     return false;
   }
 
-  channelPins[channel] = pin;
-  isMotorChannel[channel] = false;
-  configureChannel(channel, pin, SERVO_FREQUENCY, false);
+  if (!configureChannel(channel, pin, false)) {
+    Serial.println("[LEDC] Error: No PWM channel available");
+    return false;
+  }
 
   allocatedChannels |= (1 << channel);
 
@@ -56,31 +60,19 @@ bool LEDCManager::allocateServoChannel(uint8_t pin, LEDCChannel channel) {
   return true;
 }
 
-void LEDCManager::configureChannel(LEDCChannel channel, uint8_t pin,
-                                   uint16_t frequency, bool isMotor) {
-  ledc_timer_config_t timerConfig = {
-      .speed_mode = LEDC_LOW_SPEED_MODE,
-      .duty_resolution =
-          (ledc_timer_bit_t)(isMotor ? MOTOR_RESOLUTION : SERVO_RESOLUTION),
-      .timer_num = (ledc_timer_t)(channel / 2), // 2 channels per timer
-      .freq_hz = frequency,
-      .clk_cfg = LEDC_AUTO_CLK,
-  };
-  ledc_timer_config(&timerConfig);
-
-  ledc_channel_config_t channelConfig = {
-      .gpio_num = pin,
-      .speed_mode = LEDC_LOW_SPEED_MODE,
-      .channel = (ledc_channel_t)(channel % 8),
-      .intr_type = LEDC_INTR_DISABLE,
-      .timer_sel = (ledc_timer_t)(channel / 2),
-      .duty = 0,
-      .hpoint = 0,
-      .flags = {.output_invert = 0},
-  };
-  ledc_channel_config(&channelConfig);
+bool LEDCManager::configureChannel(LEDCChannel channel, uint8_t pin,
+                                   bool isMotor) {
+  int hal = isMotor ? HAL_PWMAllocateMax(pin, MOTOR_PWM_FREQUENCY)
+                    : HAL_PWMAllocate(pin, SERVO_FREQUENCY_HZ, SERVO_RESOLUTION);
+  if (hal < 0) {
+    return false;
+  }
 
+  channelPins[channel] = pin;
+  halChannels[channel] = (uint8_t)hal;
+  isMotorChannel[channel] = isMotor;
   channelValues[channel] = 0;
+  return true;
 }
 
 void LEDCManager::setPWM(LEDCChannel channel, uint16_t value) {
@@ -92,15 +84,16 @@ void LEDCManager::setPWM(LEDCChannel channel, uint16_t value) {
   channelValues[channel] = value;
 
   if (isMotorChannel[channel]) {
-    // Motor: 8-bit (0-255)
-    value = constrain(value, 0, 255);
-  } else {
-    // Servo: 8-bit (0-255 maps to 0-180°)
-    value = constrain(value, 0, 255);
+    // Motor: Q15, scaled to the channel's resolution by the HAL
+    HAL_PWMWriteQ15(halChannels[channel], value);
+    return;
   }
 
-  ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel, value);
-  ledc_update_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel);
+  // Servo: 0-180° to pulse width, in counts of the 20ms period
+  uint32_t us = SERVO_MIN_US + ((uint32_t)constrain(value, 0, 180) *
+                                (SERVO_MAX_US - SERVO_MIN_US)) / 180;
+  uint32_t duty = (uint32_t)(((uint64_t)us * SERVO_FREQUENCY_HZ << SERVO_RESOLUTION) / 1000000ULL);
+  HAL_PWMWrite(halChannels[channel], duty);
 }
 
 uint16_t LEDCManager::getPWM(LEDCChannel channel) {
@@ -119,7 +112,7 @@ void LEDCManager::releaseChannel(LEDCChannel channel) {
     return;
   }
 
-  ledc_stop(LEDC_LOW_SPEED_MODE, (ledc_channel_t)channel, 0);
+  HAL_TimerRelease(halChannels[channel]);
   allocatedChannels &= ~(1 << channel);
   channelValues[channel] = 0;
 
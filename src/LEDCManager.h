@@ -2,18 +2,17 @@
 #define LEDC_MANAGER_H
 
 #include <Arduino.h>
-#include <driver/ledc.h>
 
 /**
- * LEDCManager - Centralized PWM channel allocation to prevent conflicts
+ * LEDCManager - Named motor / servo PWM slots
  * 
- * ESP32 has 16 LEDC channels (8 low-speed, 8 high-speed)
- * Allocation:
- * - Channels 0-5: Motors (6 channels)
- * - Channels 6-7: Servo drivers (2 channels)
- * - Remaining: Available for future use
- * 
- * Frequency: 20kHz for motors, 50Hz for servos
+ * Thin front-end over the HAL PWM registry (HAL_PWMAllocate): the enum
+ * values are logical slots, not LEDC channel numbers. The hardware
+ * channel and timer are picked by the registry, so slots share timers
+ * with Motor / ServoDriver outputs of the same class:
+ * - Motors: MOTOR_PWM_FREQUENCY at the finest resolution it allows
+ *   (16 bits at 1 kHz), the Motor driver default
+ * - Servos: SERVO_FREQUENCY_HZ, SERVO_RESOLUTION
  */
 
 class LEDCManager {
@@ -37,7 +36,7 @@ public:
     /**
      * Allocate a LEDC channel for motor PWM
      * @param pin GPIO pin for PWM output
-     * @param channel LEDC channel (0-5 for motors)
+     * @param channel Motor slot (CHANNEL_MOTOR_0-5)
      * @return true if successful
      */
     bool allocateMotorChannel(uint8_t pin, LEDCChannel channel);
@@ -45,15 +44,16 @@ public:
     /**
      * Allocate a LEDC channel for servo PWM
      * @param pin GPIO pin for PWM output
-     * @param channel LEDC channel (6-7 for servos)
+     * @param channel Servo slot (CHANNEL_SERVO_0-1)
      * @return true if successful
      */
     bool allocateServoChannel(uint8_t pin, LEDCChannel channel);
 
     /**
      * Set PWM value for allocated channel
-     * @param channel LEDC channel
-     * @param value 0-255 for motors, 0-180 for servos
+     * @param channel Slot
+     * @param value Q15 duty for motors (0-32768 = 100 %), 0-180 degrees
+     *              for servos
      */
     void setPWM(LEDCChannel channel, uint16_t value);
 
@@ -81,20 +81,17 @@ private:
     LEDCManager() : allocatedChannels(0) {}
     
     static const uint8_t TOTAL_CHANNELS = 8;
-    static const uint16_t MOTOR_FREQUENCY = 20000;  // 20kHz for motors
-    static const uint16_t SERVO_FREQUENCY = 50;      // 50Hz for servos
-    static const uint8_t MOTOR_RESOLUTION = 8;      // 8-bit (0-255)
-    static const uint8_t SERVO_RESOLUTION = 8;      // 8-bit (0-255 maps to 0-180°)
 
-    uint8_t allocatedChannels;                        // Bitmask of allocated channels
-    uint8_t channelPins[TOTAL_CHANNELS];             // GPIO pins for each channel
+    uint8_t allocatedChannels;                        // Bitmask of allocated slots
+    uint8_t channelPins[TOTAL_CHANNELS];             // GPIO pins for each slot
+    uint8_t halChannels[TOTAL_CHANNELS];             // Registry channel of each slot
     uint16_t channelValues[TOTAL_CHANNELS];          // Current PWM values
     bool isMotorChannel[TOTAL_CHANNELS];             // true = motor, false = servo
 
     /**
-     * Configure LEDC timer and channel
+     * Request a registry channel for a slot
      */
-    void configureChannel(LEDCChannel channel, uint8_t pin, uint16_t frequency, bool isMotor);
+    bool configureChannel(LEDCChannel channel, uint8_t pin, bool isMotor);
 };
 
 #endif // LEDC_MANAGER_H
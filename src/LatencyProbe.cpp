@@ -0,0 +1,128 @@
+#include "LatencyProbe.h"
+#include <string.h>
+#include "Crc16.h"
+
+/**
+ * LatencyProbe - Implementation
+ *
+ * Stamps are unsigned microsecond counters, so differences stay right
+ * across the 32-bit wrap. A stamp earlier than the one before it (the
+ * other core's clock read raced) counts as 0 us, not as 71 minutes.
+ *
+ * @file LatencyProbe.cpp
+ */
+
+#define ECHO_CRC_OFFSET (LATENCY_ECHO_SIZE - 2)
+
+static const char *const STAGE_NAMES[LATENCY_STAGE_COUNT] = {
+    "filter", "queue", "verify", "apply", "commit", "total"};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint32_t elapsed(uint32_t from, uint32_t to) {
+  uint32_t d = to - from;
+  return (d & 0x80000000UL) ? 0 : d;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+// ============================================================================
+// Histograms
+// ============================================================================
+
+void LatencyProbe_init(LatencyProbe *probe) { memset(probe, 0, sizeof(*probe)); }
+
+uint8_t LatencyProbe_bucket(uint32_t us) {
+  uint8_t b = 0;
+  while (us >= 2 && b < LATENCY_HIST_BUCKETS - 1) {
+    us >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void LatencyProbe_add(LatencyHistogram *hist, uint32_t us) {
+  hist->count++;
+  hist->buckets[LatencyProbe_bucket(us)]++;
+  if (us > hist->maxUs)
+    hist->maxUs = us;
+}
+
+void LatencyProbe_record(LatencyProbe *probe, const LatencyTrace *trace) {
+  probe->echo.sequence = trace->sequence;
+  for (uint8_t s = 0; s < LATENCY_ECHO_STAGES; s++) {
+    uint32_t us = elapsed(trace->stampUs[s], trace->stampUs[s + 1]);
+    LatencyProbe_add(&probe->stages[s], us);
+    probe->echo.stageUs[s] = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+  }
+  LatencyProbe_add(&probe->stages[LATENCY_STAGE_TOTAL],
+             elapsed(trace->stampUs[LATENCY_POINT_RX],
+                     trace->stampUs[LATENCY_POINT_COMMIT]));
+  probe->echoPending = true;
+}
+
+uint32_t LatencyProbe_percentile(const LatencyHistogram *hist, uint8_t percent) {
+  if (hist->count == 0)
+    return 0;
+  // Nearest rank, then the bucket that holds it
+  uint32_t rank = (uint32_t)(((uint64_t)hist->count * percent + 99) / 100);
+  if (rank == 0)
+    rank = 1;
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+    seen += hist->buckets[b];
+    if (seen >= rank) {
+      uint32_t edge = 2UL << b;
+      return (b == LATENCY_HIST_BUCKETS - 1 || edge > hist->maxUs) ? hist->maxUs : edge;
+    }
+  }
+  return hist->maxUs;
+}
+
+const char *LatencyProbe_stageName(LatencyStage stage) {
+  return stage < LATENCY_STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
+
+// ============================================================================
+// Echo Frame
+// ============================================================================
+
+bool LatencyProbe_takeEcho(LatencyProbe *probe, LatencyEcho *echo) {
+  if (!probe->echoPending)
+    return false;
+  *echo = probe->echo;
+  probe->echoPending = false;
+  return true;
+}
+
+size_t LatencyProbe_encodeEcho(const LatencyEcho *echo, uint8_t *out, size_t outSize) {
+  if (outSize < LATENCY_ECHO_SIZE)
+    return 0;
+  out[0] = LATENCY_ECHO_TYPE;
+  put_u16(out + 1, (uint16_t)(echo->sequence & 0xFFFF));
+  put_u16(out + 3, (uint16_t)(echo->sequence >> 16));
+  for (uint8_t s = 0; s < LATENCY_ECHO_STAGES; s++)
+    put_u16(out + 5 + 2 * s, echo->stageUs[s]);
+  put_u16(out + ECHO_CRC_OFFSET, Crc16_compute(out, ECHO_CRC_OFFSET));
+  return LATENCY_ECHO_SIZE;
+}
+
+bool LatencyProbe_decodeEcho(const uint8_t *frame, size_t len, LatencyEcho *echo) {
+  if (!frame || len != LATENCY_ECHO_SIZE || frame[0] != LATENCY_ECHO_TYPE)
+    return false;
+  if (get_u16(frame + ECHO_CRC_OFFSET) != Crc16_compute(frame, ECHO_CRC_OFFSET))
+    return false;
+  echo->sequence = (uint32_t)get_u16(frame + 1) | ((uint32_t)get_u16(frame + 3) << 16);
+  for (uint8_t s = 0; s < LATENCY_ECHO_STAGES; s++)
+    echo->stageUs[s] = get_u16(frame + 5 + 2 * s);
+  return true;
+}
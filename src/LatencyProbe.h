@@ -0,0 +1,156 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * LatencyProbe - Per-stage latency of radio control frames on the vehicle
+ *
+ * A frame is stamped (micros(), one clock for both cores) as it moves
+ * from the ESP-NOW callback to the motors:
+ *
+ *   RX        OnDataRecv entry (Wi-Fi task)
+ *   QUEUED    passed RxFilter / replay / rate limit, pushed to the ring
+ *   DEQUEUED  taken from the ring by the rx verify worker (core 0)
+ *   VERIFIED  decrypted and authenticated (processControlPacket), handed
+ *             to the control task
+ *   INPUTS    vehicle->setInputs()
+ *   COMMIT    vehicle->loop() returned: actuator outputs committed
+ *
+ * The differences are the stages (filter, queue = worker wake-up, verify
+ * = crypto, apply = control tick alignment, commit), each kept in a log2
+ * histogram plus the total RX -> COMMIT.
+ *
+ * The controller cannot read the vehicle clock, so the newest trace is
+ * echoed back as a small ESP-NOW frame keyed by the frame's sequence
+ * number; the controller subtracts the vehicle stages from its own
+ * send -> echo round trip to get air time:
+ *
+ *   | type (0xD2) | sequence (4) | stage us (5 x 2) | crc16 (2) |
+ *
+ * Multi-byte fields are little endian; stage times saturate at 65535 us.
+ *
+ * @file LatencyProbe.h
+ */
+
+#define LATENCY_ECHO_TYPE       0xD2
+#define LATENCY_ECHO_SIZE       17
+#define LATENCY_HIST_BUCKETS    16      // [0,2) [2,4) ... [32768, inf) us
+
+/**
+ * Stamp points, in the order a frame passes them
+ */
+typedef enum {
+    LATENCY_POINT_RX = 0,
+    LATENCY_POINT_QUEUED,
+    LATENCY_POINT_DEQUEUED,
+    LATENCY_POINT_VERIFIED,
+    LATENCY_POINT_INPUTS,
+    LATENCY_POINT_COMMIT,
+    LATENCY_POINT_COUNT
+} LatencyPoint;
+
+/**
+ * Stages between consecutive points, then the total
+ */
+typedef enum {
+    LATENCY_STAGE_FILTER = 0,   // RX -> QUEUED
+    LATENCY_STAGE_QUEUE,        // QUEUED -> DEQUEUED
+    LATENCY_STAGE_VERIFY,       // DEQUEUED -> VERIFIED
+    LATENCY_STAGE_APPLY,        // VERIFIED -> INPUTS
+    LATENCY_STAGE_COMMIT,       // INPUTS -> COMMIT
+    LATENCY_STAGE_TOTAL,        // RX -> COMMIT
+    LATENCY_STAGE_COUNT
+} LatencyStage;
+
+#define LATENCY_ECHO_STAGES     LATENCY_STAGE_TOTAL
+
+/**
+ * Stamps of one frame
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t stampUs[LATENCY_POINT_COUNT];
+} LatencyTrace;
+
+/**
+ * Echo of one frame's stages (what goes back to the controller)
+ */
+typedef struct {
+    uint32_t sequence;
+    uint16_t stageUs[LATENCY_ECHO_STAGES];
+} LatencyEcho;
+
+/**
+ * Distribution of one stage
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t maxUs;
+    uint32_t buckets[LATENCY_HIST_BUCKETS];
+} LatencyHistogram;
+
+/**
+ * Probe state
+ */
+typedef struct {
+    LatencyHistogram stages[LATENCY_STAGE_COUNT];
+    LatencyEcho echo;           // Newest trace
+    bool echoPending;           // echo not taken yet
+} LatencyProbe;
+
+/**
+ * Clear histograms and the pending echo
+ */
+void LatencyProbe_init(LatencyProbe* probe);
+
+/**
+ * Add one frame's trace
+ */
+void LatencyProbe_record(LatencyProbe* probe, const LatencyTrace* trace);
+
+/**
+ * Add one duration to a histogram (also for latencies measured elsewhere)
+ */
+void LatencyProbe_add(LatencyHistogram* hist, uint32_t us);
+
+/**
+ * Histogram bucket of a duration
+ */
+uint8_t LatencyProbe_bucket(uint32_t us);
+
+/**
+ * Percentile estimate from a histogram
+ * @param hist Histogram
+ * @param percent 1-100
+ * @return Upper edge of the bucket holding the percentile (capped at the
+ *         maximum seen), 0 if empty
+ */
+uint32_t LatencyProbe_percentile(const LatencyHistogram* hist, uint8_t percent);
+
+/**
+ * Take the newest echo once
+ * @return false if no frame was recorded since the last take
+ */
+bool LatencyProbe_takeEcho(LatencyProbe* probe, LatencyEcho* echo);
+
+/**
+ * Serialize an echo frame
+ * @return LATENCY_ECHO_SIZE, 0 if out is too small
+ */
+size_t LatencyProbe_encodeEcho(const LatencyEcho* echo, uint8_t* out, size_t outSize);
+
+/**
+ * Parse an echo frame (controller side / tests)
+ * @return false on wrong length, type or CRC
+ */
+bool LatencyProbe_decodeEcho(const uint8_t* frame, size_t len, LatencyEcho* echo);
+
+/**
+ * Short stage name for reports ("filter", "queue", ...)
+ */
+const char* LatencyProbe_stageName(LatencyStage stage);
+
+#endif // LATENCY_PROBE_H
@@ -0,0 +1,124 @@
+#include "LeakDetector.h"
+#include "HotPath.h"
+#include <string.h>
+
+/**
+ * LeakDetector - Implementation
+ *
+ * The GPIO ISR and the timer callback are the only writers of the
+ * state after start; the control and telemetry tasks only read it.
+ *
+ * @file LeakDetector.cpp
+ */
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <hal/gpio_ll.h>
+#include <soc/gpio_struct.h>
+#define LEAK_IRAM IRAM_ATTR
+#else
+#define LEAK_IRAM
+#endif
+
+// ============================================================================
+// Debounce
+// ============================================================================
+
+void LeakDetector_init(LeakDetector* det, LeakHandler handler, void* arg) {
+    memset(det, 0, sizeof(*det));
+    det->handler = handler;
+    det->arg = arg;
+    det->pin = -1;
+}
+
+LEAK_IRAM bool LeakDetector_edge(LeakDetector* det, uint32_t nowUs) {
+    det->edges++;
+    if (det->pending || det->latched) return false;
+    det->pending = true;
+    det->edgeUs = nowUs;
+    return true;
+}
+
+LEAK_IRAM bool LeakDetector_confirm(LeakDetector* det, bool active, uint32_t nowUs) {
+    det->pending = false;
+    if (det->latched) return false;
+    if (!active) {
+        det->rejected++;
+        return false;
+    }
+    det->latched = true;
+    det->latchUs = det->edgeUs;
+    if (det->handler) det->handler(det->arg);
+    det->reactionUs = nowUs - det->edgeUs;
+    return true;
+}
+
+// ============================================================================
+// Hardware
+// ============================================================================
+
+#if defined(__XTENSA__)
+
+// One sensor per vehicle
+static LeakDetector* gDetector = nullptr;
+static esp_timer_handle_t gTimer = nullptr;
+
+static LEAK_IRAM bool readActive(const LeakDetector* det) {
+    // Register read: the driver call may sit in flash
+    return gpio_ll_get_level(&GPIO, (gpio_num_t)det->pin) == (det->activeHigh ? 1 : 0);
+}
+
+static LEAK_IRAM void onTimer(void* arg) {
+    LeakDetector* det = (LeakDetector*)arg;
+    bool active = readActive(det);
+    LeakDetector_confirm(det, active, (uint32_t)esp_timer_get_time());
+}
+
+static LEAK_IRAM void onEdge(void* arg) {
+    LeakDetector* det = (LeakDetector*)arg;
+    if (LeakDetector_edge(det, (uint32_t)esp_timer_get_time()))
+        esp_timer_start_once(gTimer, LEAK_DEBOUNCE_US);
+}
+
+bool LeakDetector_start(LeakDetector* det, int8_t pin, bool activeHigh) {
+    if (pin < 0 || gDetector) return false;
+    det->pin = pin;
+    det->activeHigh = activeHigh;
+
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = det;
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD && HOT_PATH_IRAM
+    args.dispatch_method = ESP_TIMER_ISR;
+#else
+    args.dispatch_method = ESP_TIMER_TASK;
+#endif
+    args.name = "leak";
+    if (esp_timer_create(&args, &gTimer) != ESP_OK) {
+        gTimer = nullptr;
+        det->pin = -1;
+        return false;
+    }
+
+    // Pull towards dry where the pin has pulls (GPIO 34-39 need an external one)
+    pinMode(pin, activeHigh ? INPUT_PULLDOWN : INPUT_PULLUP);
+    gDetector = det;
+    attachInterruptArg(digitalPinToInterrupt(pin), onEdge, det, CHANGE);
+
+    // Already wet at boot: no edge will come
+    if (readActive(det)) onEdge(det);
+    return true;
+}
+
+#else
+
+bool LeakDetector_start(LeakDetector* det, int8_t pin, bool activeHigh) {
+    (void)det;
+    (void)pin;
+    (void)activeHigh;
+    return false;
+}
+
+#endif
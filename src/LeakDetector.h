@@ -0,0 +1,82 @@
+#ifndef LEAK_DETECTOR_H
+#define LEAK_DETECTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * LeakDetector - Interrupt-driven water-ingress latch
+ *
+ * A leak has to stop the dive within milliseconds, not at the next
+ * control tick. The sensor input raises a GPIO interrupt on every edge;
+ * the first edge arms a one-shot timer, and when it fires
+ * LEAK_DEBOUNCE_US later the pin is sampled again:
+ *   - still wet: the detector latches and calls the handler right there
+ *     (timer context), which drives the outputs itself
+ *   - dry again: a bounce or splash on the contacts, counted and dropped
+ * Edges while a check is pending or after the latch are only counted.
+ * The latch holds until reset: a Sub with water inside comes up.
+ *
+ * Reaction time is interrupt latency + LEAK_DEBOUNCE_US + the handler,
+ * independent of the task loop. The timer callback is dispatched from
+ * the timer ISR where esp_timer supports it, else from the esp_timer
+ * task (highest priority, still ahead of every application task).
+ *
+ * The edge / confirm steps are plain functions (tested natively);
+ * LeakDetector_start() wires them to the GPIO and timer.
+ *
+ * @file LeakDetector.h
+ */
+
+#define LEAK_DEBOUNCE_US        2000    // Input must stay wet this long
+
+/**
+ * Called once from timer context on the latch; must be IRAM-safe
+ * (register writes only, no locks that may block, no flash access)
+ */
+typedef void (*LeakHandler)(void* arg);
+
+typedef struct {
+    LeakHandler handler;
+    void* arg;
+    int8_t pin;                     // -1 = not started
+    bool activeHigh;
+
+    volatile bool pending;          // Debounce check armed
+    volatile bool latched;
+    volatile uint32_t edgeUs;       // First edge of the pending check
+    volatile uint32_t latchUs;      // Edge of the confirmed leak
+    volatile uint32_t reactionUs;   // That edge to the handler's return
+    volatile uint32_t edges;        // Interrupts seen (bounces included)
+    volatile uint32_t rejected;     // Checks that found the input dry
+} LeakDetector;
+
+void LeakDetector_init(LeakDetector* det, LeakHandler handler, void* arg);
+
+/**
+ * Input edge (GPIO ISR)
+ * @return true if the debounce timer should be started now
+ */
+bool LeakDetector_edge(LeakDetector* det, uint32_t nowUs);
+
+/**
+ * Debounce timer expired: latch if the input is still active
+ * @param active Input level, already mapped through activeHigh
+ * @param nowUs Time the check ran; reactionUs is taken after the handler
+ * @return true if this call latched
+ */
+bool LeakDetector_confirm(LeakDetector* det, bool active, uint32_t nowUs);
+
+static inline bool LeakDetector_isLatched(const LeakDetector* det) { return det->latched; }
+
+/**
+ * Attach the GPIO interrupt and create the debounce timer
+ * A pin that is already wet at start is checked at once.
+ * @param pin Sensor input (-1 = not fitted: returns false, never latches)
+ * @param activeHigh true if the sensor drives the pin high on a leak
+ * @return false if the pin or timer could not be set up (no hardware
+ *         on native builds)
+ */
+bool LeakDetector_start(LeakDetector* det, int8_t pin, bool activeHigh);
+
+#endif // LEAK_DETECTOR_H
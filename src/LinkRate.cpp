@@ -0,0 +1,249 @@
+#include "LinkRate.h"
+#include <string.h>
+#include "Crc16.h"
+
+/**
+ * LinkRate - Implementation
+ *
+ * A proposal is only started from evaluate(), at most once per
+ * LINK_RATE_EVAL_MS, and gives up after LINK_RATE_MAX_ATTEMPTS sends, so
+ * negotiation costs at most a few frames a second even on a link that
+ * swings every period. A PHY switch is proposed the same way, as the
+ * rung below ROBUST, so tier and PHY never change in the same proposal.
+ *
+ * @file LinkRate.cpp
+ */
+
+#define FRAME_CRC_OFFSET (LINK_RATE_FRAME_SIZE - 2)
+
+static const LinkTierRates TIER_RATES[LINK_TIER_COUNT] = {
+    {10, 5},    // ROBUST
+    {25, 10},   // NORMAL
+    {50, 20},   // FAST
+};
+
+static const char* const TIER_NAMES[LINK_TIER_COUNT] = {"robust", "normal", "fast"};
+static const char* const PHY_NAMES[LINK_PHY_COUNT] = {"fast", "lr"};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static void propose(LinkRate* lr, LinkTier tier, LinkPhy phy) {
+    lr->epoch++;
+    lr->proposed = tier;
+    lr->proposedPhy = phy;
+    lr->pending = true;
+    lr->attempts = 0;
+    lr->proposals++;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void LinkRate_init(LinkRate* lr) {
+    memset(lr, 0, sizeof(*lr));
+    lr->tier = LINK_TIER_FAST;
+    lr->agreed = LINK_TIER_FAST;
+    lr->proposed = LINK_TIER_FAST;
+    lr->grade = LINK_GRADE_FAIR;
+}
+
+void LinkRate_setLongRange(LinkRate* lr, bool capable) {
+    lr->localLr = capable;
+    if (!capable && lr->phy == LINK_PHY_LONG_RANGE) {
+        lr->phy = LINK_PHY_FAST;
+        lr->phySwitches++;
+    }
+    if (capable)
+        propose(lr, lr->tier, lr->phy);
+}
+
+void LinkRate_setCompact(LinkRate* lr, bool capable) {
+    lr->localCompact = capable;
+    if (!capable)
+        lr->peerCompact = false;
+    else if (!lr->pending)
+        propose(lr, lr->tier, lr->phy);
+}
+
+LinkTierRates LinkRate_rates(LinkTier tier) {
+    if ((unsigned)tier >= LINK_TIER_COUNT)
+        tier = LINK_TIER_ROBUST;
+    return TIER_RATES[tier];
+}
+
+LinkGrade LinkRate_grade(const LinkSample* s) {
+    if (s->signalLost || s->lossPercent >= LINK_RATE_BAD_LOSS || s->rssiDbm < LINK_RATE_BAD_RSSI)
+        return LINK_GRADE_BAD;
+
+    bool txCounted = s->txSent >= LINK_RATE_MIN_TX_SAMPLE;
+    if (txCounted && s->txFailed * 100 >= LINK_RATE_BAD_TX_FAIL * s->txSent)
+        return LINK_GRADE_BAD;
+
+    bool txClean = !txCounted || s->txFailed * 100 <= LINK_RATE_GOOD_TX_FAIL * s->txSent;
+    if (s->lossPercent <= LINK_RATE_GOOD_LOSS && s->rssiDbm >= LINK_RATE_GOOD_RSSI && txClean)
+        return LINK_GRADE_GOOD;
+    return LINK_GRADE_FAIR;
+}
+
+bool LinkRate_evaluate(LinkRate* lr, const LinkSample* sample) {
+    lr->last = *sample;
+    lr->grade = LinkRate_grade(sample);
+
+    LinkTier target = lr->tier;
+    LinkPhy targetPhy = lr->phy;
+    if (lr->grade == LINK_GRADE_BAD) {
+        lr->goodStreak = 0;
+        if (lr->tier == LINK_TIER_ROBUST && lr->localLr && lr->peerLr)
+            targetPhy = LINK_PHY_LONG_RANGE;
+        else if (sample->signalLost || sample->lossPercent >= LINK_RATE_LOST_LOSS)
+            target = LINK_TIER_ROBUST;
+        else if (lr->tier > LINK_TIER_ROBUST)
+            target = (LinkTier)(lr->tier - 1);
+    } else if (lr->grade == LINK_GRADE_GOOD) {
+        // Waiting for an ack: an upgrade is already on its way
+        if (!lr->pending && ++lr->goodStreak >= LINK_RATE_UPGRADE_EVALS) {
+            lr->goodStreak = 0;
+            if (lr->phy == LINK_PHY_LONG_RANGE)
+                targetPhy = LINK_PHY_FAST;
+            else if (lr->tier < LINK_TIER_FAST)
+                target = (LinkTier)(lr->tier + 1);
+        }
+    } else {
+        lr->goodStreak = 0;
+    }
+
+    if (target == lr->tier && targetPhy == lr->phy) {
+        // Turned bad during an upgrade: the controller may already run
+        // faster, so ask for the current rates again
+        bool upgrading = lr->proposed > lr->tier ||
+                         (lr->proposedPhy == LINK_PHY_FAST && lr->phy == LINK_PHY_LONG_RANGE);
+        if (lr->grade == LINK_GRADE_BAD && lr->pending && upgrading) {
+            propose(lr, lr->tier, lr->phy);
+            return true;
+        }
+        return false;
+    }
+
+    // Slower telemetry and a more robust PHY never hurt; faster waits for
+    // the controller
+    if (target < lr->tier || !lr->negotiating)
+        lr->tier = target;
+    if ((targetPhy == LINK_PHY_LONG_RANGE || !lr->negotiating) && lr->phy != targetPhy) {
+        lr->phy = targetPhy;
+        lr->phySwitches++;
+    }
+    propose(lr, target, targetPhy);
+    return true;
+}
+
+bool LinkRate_takeProposal(LinkRate* lr, uint32_t nowMs, LinkRateFrame* out) {
+    if (!lr->pending)
+        return false;
+    if (lr->attempts > 0 && nowMs - lr->lastSentMs < LINK_RATE_RETRY_MS)
+        return false;
+    if (lr->attempts >= LINK_RATE_MAX_ATTEMPTS) {
+        lr->pending = false;
+        lr->unanswered++;
+        return false;
+    }
+    lr->attempts++;
+    lr->lastSentMs = nowMs;
+
+    LinkTierRates rates = LinkRate_rates(lr->proposed);
+    out->flags = 0;
+    if (lr->localLr)
+        out->flags |= LINK_RATE_FLAG_LR_CAPABLE;
+    if (lr->proposedPhy == LINK_PHY_LONG_RANGE)
+        out->flags |= LINK_RATE_FLAG_PHY_LR;
+    if (lr->localCompact)
+        out->flags |= LINK_RATE_FLAG_COMPACT;
+    out->epoch = lr->epoch;
+    out->tier = (uint8_t)lr->proposed;
+    out->controlHz = rates.controlHz;
+    out->telemetryHz = rates.telemetryHz;
+    out->lossPercent = lr->last.lossPercent;
+    out->rssiDbm = lr->last.rssiDbm;
+    return true;
+}
+
+bool LinkRate_onAck(LinkRate* lr, const LinkRateFrame* ack) {
+    if (!(ack->flags & LINK_RATE_FLAG_ACK))
+        return false;
+    // Capability stands whether or not the ack settles anything
+    lr->peerLr = (ack->flags & LINK_RATE_FLAG_LR_CAPABLE) != 0;
+    lr->peerCompact = lr->localCompact && (ack->flags & LINK_RATE_FLAG_COMPACT);
+    if (!lr->pending || ack->epoch != lr->epoch)
+        return false;
+    // The controller may settle lower, never higher
+    if (ack->tier > (uint8_t)lr->proposed)
+        return false;
+    lr->pending = false;
+    lr->negotiating = true;
+    lr->acks++;
+    lr->agreed = (LinkTier)ack->tier;
+    lr->tier = lr->agreed;
+    // It may also keep the fast PHY (declined, or not capable)
+    LinkPhy phy = (ack->flags & LINK_RATE_FLAG_PHY_LR) && lr->localLr && lr->peerLr
+                      ? LINK_PHY_LONG_RANGE : LINK_PHY_FAST;
+    lr->agreedPhy = phy;
+    if (phy != lr->phy) {
+        lr->phy = phy;
+        lr->phySwitches++;
+    }
+    return true;
+}
+
+uint8_t LinkRate_telemetryDivider(const LinkRate* lr, uint8_t tickHz) {
+    uint8_t hz = LinkRate_rates(lr->tier).telemetryHz;
+    if (hz == 0 || hz >= tickHz)
+        return 1;
+    return (uint8_t)((tickHz + hz - 1) / hz);
+}
+
+size_t LinkRate_encode(const LinkRateFrame* frame, uint8_t* out, size_t outSize) {
+    if (outSize < LINK_RATE_FRAME_SIZE)
+        return 0;
+    out[0] = LINK_RATE_TYPE;
+    out[1] = frame->flags;
+    out[2] = frame->epoch;
+    out[3] = frame->tier;
+    out[4] = frame->controlHz;
+    out[5] = frame->telemetryHz;
+    out[6] = frame->lossPercent;
+    out[7] = (uint8_t)frame->rssiDbm;
+    uint16_t crc = Crc16_compute(out, FRAME_CRC_OFFSET);
+    out[FRAME_CRC_OFFSET] = (uint8_t)(crc & 0xFF);
+    out[FRAME_CRC_OFFSET + 1] = (uint8_t)(crc >> 8);
+    return LINK_RATE_FRAME_SIZE;
+}
+
+bool LinkRate_decode(const uint8_t* data, size_t len, LinkRateFrame* frame) {
+    if (!data || len != LINK_RATE_FRAME_SIZE || data[0] != LINK_RATE_TYPE)
+        return false;
+    uint16_t crc = (uint16_t)data[FRAME_CRC_OFFSET] | ((uint16_t)data[FRAME_CRC_OFFSET + 1] << 8);
+    if (crc != Crc16_compute(data, FRAME_CRC_OFFSET))
+        return false;
+    frame->flags = data[1];
+    frame->epoch = data[2];
+    frame->tier = data[3];
+    frame->controlHz = data[4];
+    frame->telemetryHz = data[5];
+    frame->lossPercent = data[6];
+    frame->rssiDbm = (int8_t)data[7];
+    return frame->tier < LINK_TIER_COUNT;
+}
+
+const char* LinkRate_tierName(LinkTier tier) {
+    if ((unsigned)tier >= LINK_TIER_COUNT)
+        return "?";
+    return TIER_NAMES[tier];
+}
+
+const char* LinkRate_phyName(LinkPhy phy) {
+    if ((unsigned)phy >= LINK_PHY_COUNT)
+        return "?";
+    return PHY_NAMES[phy];
+}
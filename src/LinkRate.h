@@ -0,0 +1,233 @@
+#ifndef LINK_RATE_H
+#define LINK_RATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * LinkRate - Control / telemetry rate negotiation from link quality
+ *
+ * Once per LINK_RATE_EVAL_MS the telemetry task grades the link from the
+ * control frames it receives (RSSIManager loss window and average RSSI)
+ * and from its own sends (EspNowTx failures and timeouts, i.e. hardware
+ * retries exhausted):
+ *   - BAD: drop one tier at once (straight to ROBUST if the link is
+ *     nearly gone); fewer frames in the air leave more of them inside
+ *     the failsafe timeout
+ *   - GOOD for LINK_RATE_UPGRADE_EVALS evaluations in a row: one tier up
+ *   - anything between holds the tier
+ *
+ * Tier (control Hz asked of the controller / telemetry Hz sent):
+ *   ROBUST 10 / 5, NORMAL 25 / 10, FAST 50 / 20
+ *
+ * Below ROBUST there is one more rung: the ESP-NOW long-range PHY
+ * (WIFI_PROTOCOL_LR, 250 / 500 kbit/s, several dB more link budget than
+ * 802.11b/n). A BAD period already at ROBUST switches to it, the first
+ * GOOD streak there switches back to the fast PHY before any tier goes
+ * up. Both ends receive either PHY once LR is in their protocol bitmap,
+ * so only the capability has to be known: every proposal and ack
+ * carries LINK_RATE_FLAG_LR_CAPABLE, and LR is used only once the
+ * controller has sent it. LinkRate_setLongRange() starts a proposal of
+ * the current rates so the capabilities are exchanged while the link is
+ * still good. Like the tiers, a switch to LR applies at once, a switch
+ * back waits for the ack.
+ *
+ * A new tier is proposed to the controller in a small frame, retried
+ * until it is acked with the same epoch. The ack may name a lower tier
+ * (the controller cannot go that fast); the vehicle then uses that one.
+ * Lowering telemetry is always safe, so a downgrade applies at once; an
+ * upgrade waits for the ack. A controller that has never acked (older
+ * firmware) is not negotiating, and telemetry follows the local grade.
+ *
+ * Both directions use one frame, little endian:
+ *
+ *   | type (0xD3) | flags | epoch | tier | control Hz | telemetry Hz |
+ *   | loss % | rssi dBm | crc16 (2) |
+ *
+ * flags: ACK, LR_CAPABLE (sender receives LR), PHY_LR (PHY proposed /
+ * agreed), COMPACT (vehicle: takes NAPacketCompact control frames;
+ * controller: sends them). Controllers that predate the PHY bits ack
+ * with neither, so they are never sent LR.
+ *
+ * Only acks from the paired controller are taken, and rates never leave
+ * the tier table, so a forged ack can at worst pick another fixed tier.
+ *
+ * Pure: no globals, no RTOS. One task owns a LinkRate.
+ *
+ * @file LinkRate.h
+ */
+
+#define LINK_RATE_TYPE              0xD3
+#define LINK_RATE_FRAME_SIZE        10
+#define LINK_RATE_FLAG_ACK          0x01
+#define LINK_RATE_FLAG_LR_CAPABLE   0x02
+#define LINK_RATE_FLAG_PHY_LR       0x04
+#define LINK_RATE_FLAG_COMPACT      0x08
+
+#define LINK_RATE_EVAL_MS           1000
+#define LINK_RATE_UPGRADE_EVALS     5       // Clean seconds before a step up
+#define LINK_RATE_RETRY_MS          250
+#define LINK_RATE_MAX_ATTEMPTS      6
+
+// Grades
+#define LINK_RATE_BAD_LOSS          15      // %
+#define LINK_RATE_LOST_LOSS         40      // %, straight to ROBUST
+#define LINK_RATE_BAD_RSSI          -85     // dBm
+#define LINK_RATE_GOOD_LOSS         2       // %
+#define LINK_RATE_GOOD_RSSI         -72     // dBm
+#define LINK_RATE_BAD_TX_FAIL       25      // % of sends
+#define LINK_RATE_GOOD_TX_FAIL      5
+#define LINK_RATE_MIN_TX_SAMPLE     4       // Fewer sends: failure ratio ignored
+
+typedef enum {
+    LINK_TIER_ROBUST = 0,
+    LINK_TIER_NORMAL,
+    LINK_TIER_FAST,
+    LINK_TIER_COUNT
+} LinkTier;
+
+typedef enum {
+    LINK_PHY_FAST = 0,          // 802.11b/g/n rate (set_tx_route)
+    LINK_PHY_LONG_RANGE,        // WIFI_PROTOCOL_LR
+    LINK_PHY_COUNT
+} LinkPhy;
+
+typedef enum {
+    LINK_GRADE_BAD = 0,
+    LINK_GRADE_FAIR,
+    LINK_GRADE_GOOD
+} LinkGrade;
+
+/**
+ * Rates of one tier
+ */
+typedef struct {
+    uint8_t controlHz;          // Asked of the controller
+    uint8_t telemetryHz;        // Sent by the vehicle
+} LinkTierRates;
+
+/**
+ * Link measurements over one evaluation period
+ */
+typedef struct {
+    uint8_t lossPercent;        // Control frames (sequence gaps)
+    int8_t rssiDbm;             // Average
+    bool signalLost;            // No control frame recently
+    uint32_t txSent;            // Own sends in the period
+    uint32_t txFailed;          // Of those: failed or timed out
+} LinkSample;
+
+/**
+ * Proposal (vehicle) or ack (controller) on the air
+ */
+typedef struct {
+    uint8_t flags;              // LINK_RATE_FLAG_*
+    uint8_t epoch;
+    uint8_t tier;               // LinkTier
+    uint8_t controlHz;
+    uint8_t telemetryHz;
+    uint8_t lossPercent;
+    int8_t rssiDbm;
+} LinkRateFrame;
+
+typedef struct {
+    LinkTier tier;              // Telemetry rate in use
+    LinkTier agreed;            // Last tier the controller acked
+    LinkTier proposed;
+    LinkPhy phy;                // ESP-NOW PHY in use
+    LinkPhy agreedPhy;
+    LinkPhy proposedPhy;
+    bool localLr;               // This end receives LR
+    bool peerLr;                // Controller said it receives LR
+    bool localCompact;          // This end takes compact control frames
+    bool peerCompact;           // Controller said it sends them
+    LinkGrade grade;            // Last evaluation
+    LinkSample last;
+    uint8_t epoch;
+    bool pending;               // Proposal not acked yet
+    uint8_t attempts;
+    uint32_t lastSentMs;
+    bool negotiating;           // Controller has acked before
+    uint8_t goodStreak;
+    uint32_t proposals;
+    uint32_t acks;
+    uint32_t unanswered;        // Proposals given up after the last attempt
+    uint32_t phySwitches;
+} LinkRate;
+
+/**
+ * Start at FAST (the fixed rates before negotiation), nothing pending
+ */
+void LinkRate_init(LinkRate* lr);
+
+/**
+ * Declare whether this end can use the long-range PHY; if it can, propose
+ * the current rates so the controller learns it (and answers with its own)
+ */
+void LinkRate_setLongRange(LinkRate* lr, bool capable);
+
+/**
+ * Declare whether this end takes NAPacketCompact control frames; if it
+ * does, propose the current rates so the controller learns it
+ */
+void LinkRate_setCompact(LinkRate* lr, bool capable);
+
+/**
+ * Rates of a tier (out-of-range tiers read as ROBUST)
+ */
+LinkTierRates LinkRate_rates(LinkTier tier);
+
+/**
+ * Grade one period's measurements
+ */
+LinkGrade LinkRate_grade(const LinkSample* sample);
+
+/**
+ * Grade a period and move the tier
+ * @return true if a new proposal was started
+ */
+bool LinkRate_evaluate(LinkRate* lr, const LinkSample* sample);
+
+/**
+ * Take the pending proposal if it is due (first send or retry)
+ * @param out Frame to send
+ * @return false if nothing is due; gives up after LINK_RATE_MAX_ATTEMPTS
+ */
+bool LinkRate_takeProposal(LinkRate* lr, uint32_t nowMs, LinkRateFrame* out);
+
+/**
+ * Controller's answer
+ * @return true if it settled the pending proposal
+ */
+bool LinkRate_onAck(LinkRate* lr, const LinkRateFrame* ack);
+
+/**
+ * Telemetry ticks per ESP-NOW telemetry frame
+ * @param tickHz Telemetry task rate
+ */
+uint8_t LinkRate_telemetryDivider(const LinkRate* lr, uint8_t tickHz);
+
+/**
+ * Serialize a frame
+ * @return LINK_RATE_FRAME_SIZE, 0 if out is too small
+ */
+size_t LinkRate_encode(const LinkRateFrame* frame, uint8_t* out, size_t outSize);
+
+/**
+ * Parse a frame
+ * @return false on wrong length, type or CRC
+ */
+bool LinkRate_decode(const uint8_t* data, size_t len, LinkRateFrame* frame);
+
+/**
+ * Tier name for reports ("robust", "normal", "fast")
+ */
+const char* LinkRate_tierName(LinkTier tier);
+
+/**
+ * PHY name for reports ("fast", "lr")
+ */
+const char* LinkRate_phyName(LinkPhy phy);
+
+#endif // LINK_RATE_H
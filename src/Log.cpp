@@ -0,0 +1,168 @@
+#include "Log.h"
+#include "MemPlacement.h"
+#include <atomic>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Log - Implementation
+ *
+ * Bounded MPSC queue with a sequence number per slot (Vyukov, keyed to
+ * the start of each lap so the all-zero static state is already an empty
+ * queue): for reservation number pos on the lap starting at L the slot is
+ * free when seq == L, holds a complete message when seq == L + 1, and the
+ * consumer hands it to the next lap by storing L + LOG_SLOTS. A producer that finds its
+ * slot still unread gives up instead of waiting.
+ *
+ * @file Log.cpp
+ */
+
+#define SLOT_MASK (LOG_SLOTS - 1)
+#define LAP(pos)  ((pos) & ~(uint32_t)SLOT_MASK)   // First position of the lap
+
+static_assert((LOG_SLOTS & SLOT_MASK) == 0, "LOG_SLOTS must be a power of two");
+static_assert(LOG_SLOT_SIZE <= 0xFFFF, "slot length is 16 bit");
+
+struct LogSlot {
+    std::atomic<uint32_t> seq;
+    uint16_t len;
+    uint8_t data[LOG_SLOT_SIZE];
+};
+
+static LogSlot gSlots[LOG_SLOTS];
+static std::atomic<uint32_t> gEnqueuePos(0);
+static uint32_t gDequeuePos = 0;       // Drain task only
+static uint16_t gOffset = 0;           // Bytes of the oldest message written
+
+static std::atomic<uint32_t> gQueued(0);
+static std::atomic<uint32_t> gDropped(0);
+static std::atomic<uint32_t> gTruncated(0);
+static std::atomic<uint32_t> gOversize(0);
+static std::atomic<uint32_t> gHighWater(0);
+static uint32_t gWritten = 0;
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static LogSlot* reserve(uint32_t* posOut) {
+    uint32_t pos = gEnqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        LogSlot* slot = &gSlots[pos & SLOT_MASK];
+        uint32_t seq = slot->seq.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(seq - LAP(pos));
+        if (diff == 0) {
+            if (gEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            gDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;             // Full: the drain has not freed it yet
+        } else {
+            pos = gEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Slots in use, including this one (approximate under contention)
+    uint32_t used = pos + 1 - gDequeuePos;
+    uint32_t high = gHighWater.load(std::memory_order_relaxed);
+    while (used <= LOG_SLOTS && used > high &&
+           !gHighWater.compare_exchange_weak(high, used, std::memory_order_relaxed)) {}
+    *posOut = pos;
+    return &gSlots[pos & SLOT_MASK];
+}
+
+static void commit(LogSlot* slot, uint32_t pos) {
+    gQueued.fetch_add(1, std::memory_order_relaxed);
+    slot->seq.store(LAP(pos) + 1, std::memory_order_release);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void Log_init(void) {
+    for (uint32_t i = 0; i < LOG_SLOTS; i++)
+        gSlots[i].seq.store(0, std::memory_order_relaxed);
+    gEnqueuePos.store(0, std::memory_order_relaxed);
+    gDequeuePos = 0;
+    gOffset = 0;
+    gQueued.store(0);
+    gDropped.store(0);
+    gTruncated.store(0);
+    gOversize.store(0);
+    gHighWater.store(0);
+    gWritten = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    MemPlacement_note("log_queue", gSlots, sizeof(gSlots), MEM_CLASS_INTERNAL);
+}
+
+bool Log_printf(const char* fmt, ...) {
+    uint32_t pos;
+    LogSlot* slot = reserve(&pos);
+    if (!slot)
+        return false;
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf((char*)slot->data, LOG_SLOT_SIZE, fmt, args);
+    va_end(args);
+    if (n < 0) {
+        n = 0;
+    } else if (n >= LOG_SLOT_SIZE) {
+        // Cut, but keep the line ending so the next message starts clean
+        n = LOG_SLOT_SIZE;
+        slot->data[LOG_SLOT_SIZE - 1] = '\n';
+        gTruncated.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot->len = (uint16_t)n;
+    commit(slot, pos);
+    return true;
+}
+
+bool Log_write(const uint8_t* data, size_t len) {
+    if (len > LOG_SLOT_SIZE) {
+        gOversize.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    uint32_t pos;
+    LogSlot* slot = reserve(&pos);
+    if (!slot)
+        return false;
+    memcpy(slot->data, data, len);
+    slot->len = (uint16_t)len;
+    commit(slot, pos);
+    return true;
+}
+
+size_t Log_peek(const uint8_t** data) {
+    LogSlot* slot = &gSlots[gDequeuePos & SLOT_MASK];
+    if (slot->seq.load(std::memory_order_acquire) != LAP(gDequeuePos) + 1)
+        return 0;
+    *data = slot->data + gOffset;
+    return slot->len - gOffset;
+}
+
+void Log_consume(size_t n) {
+    LogSlot* slot = &gSlots[gDequeuePos & SLOT_MASK];
+    if (slot->seq.load(std::memory_order_acquire) != LAP(gDequeuePos) + 1)
+        return;
+    gOffset += (uint16_t)n;
+    if (gOffset < slot->len)
+        return;
+    gOffset = 0;
+    gWritten++;
+    slot->seq.store(LAP(gDequeuePos) + LOG_SLOTS, std::memory_order_release);
+    gDequeuePos++;
+}
+
+LogStats Log_getStats(void) {
+    LogStats s;
+    s.queued = gQueued.load(std::memory_order_relaxed);
+    s.written = gWritten;
+    s.dropped = gDropped.load(std::memory_order_relaxed);
+    s.truncated = gTruncated.load(std::memory_order_relaxed);
+    s.oversize = gOversize.load(std::memory_order_relaxed);
+    s.highWater = gHighWater.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,114 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Log - Non-blocking serial output queue
+ *
+ * Serial.print from the control task, the Wi-Fi receive callback or the
+ * telemetry task blocks the caller as soon as the UART TX buffer is full
+ * (115200 baud drains ~11.5 bytes/ms). Those paths format into a fixed
+ * lock-free MPSC queue instead, and one low-priority task writes it out
+ * only as fast as the UART takes it:
+ *
+ * - Any number of producers (tasks, callbacks) reserve a slot with one
+ *   compare-and-swap and format straight into it; nothing ever waits
+ * - Queue full: the message is dropped and counted, never blocks
+ * - Lines longer than LOG_SLOT_SIZE are cut (LOG_* text) or refused
+ *   (Log_write binary frames), both counted
+ * - Messages leave in reservation order, each in one piece
+ *
+ * Levels are filtered at compile time: LOG_LEVEL (default INFO) removes
+ * the lower macros and their arguments entirely. Command replies on the
+ * comms task keep writing to Serial directly.
+ *
+ * Plain data structure, no hardware access; the drain (Log_peek() /
+ * Log_consume()) is driven by the caller's task.
+ *
+ * @file Log.h
+ */
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_SLOTS           32      // Power of two
+#define LOG_SLOT_SIZE       128     // Bytes per message, newline included
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) Log_printf(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) Log_printf(__VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) Log_printf(__VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) Log_printf(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+typedef struct {
+    uint32_t queued;        // Messages accepted
+    uint32_t written;       // Messages fully handed to the UART
+    uint32_t dropped;       // Queue full
+    uint32_t truncated;     // Text cut to LOG_SLOT_SIZE
+    uint32_t oversize;      // Binary frames refused (> LOG_SLOT_SIZE)
+    uint32_t highWater;     // Most slots in use at once
+} LogStats;
+
+/**
+ * Empty the queue and clear the counters (before any producer runs;
+ * the zero-initialised queue is already usable without it)
+ */
+void Log_init(void);
+
+/**
+ * Queue one formatted message (any task or callback, never blocks)
+ * The format carries its own newline, as with Serial.printf
+ * @return false if dropped
+ */
+bool Log_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * Queue raw bytes as one message (telemetry lines / binary frames)
+ * @return false if dropped or longer than LOG_SLOT_SIZE
+ */
+bool Log_write(const uint8_t* data, size_t len);
+
+/**
+ * Unwritten bytes of the oldest message (drain task only)
+ * @param data Set to the first unwritten byte
+ * @return Byte count, 0 if the queue is empty
+ */
+size_t Log_peek(const uint8_t** data);
+
+/**
+ * Mark bytes of the oldest message written; the slot is released once
+ * the whole message is out (drain task only)
+ */
+void Log_consume(size_t n);
+
+/**
+ * Copy the counters
+ */
+LogStats Log_getStats(void);
+
+#endif // LOG_H
@@ -0,0 +1,167 @@
+#include "LoopTiming.h"
+#include "HAL.h"
+#include <string.h>
+
+/**
+ * LoopTiming - Implementation
+ *
+ * Cycle differences use uint32_t wraparound, so an iteration (or a load
+ * window) must stay under 2^32 cycles: ~17 s at 240 MHz.
+ *
+ * @file LoopTiming.cpp
+ */
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <esp_freertos_hooks.h>
+#include <xtensa/hal.h>
+#endif
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint32_t cycles_to_us(const LoopTimer* timer, uint32_t cycles) {
+    return timer->cyclesPerUs ? cycles / timer->cyclesPerUs : cycles;
+}
+
+static void record(uint32_t* hist, uint32_t* last, uint32_t* max, uint32_t us) {
+    hist[LoopTiming_bucket(us)]++;
+    *last = us;
+    if (us > *max) *max = us;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void LoopTiming_init(LoopTimer* timer, uint32_t nominalPeriodUs, uint32_t cyclesPerUs) {
+    memset(timer, 0, sizeof(*timer));
+    timer->nominalPeriodUs = nominalPeriodUs;
+    timer->cyclesPerUs = cyclesPerUs;
+}
+
+void LoopTiming_begin(LoopTimer* timer, uint32_t cycles) {
+    if (timer->haveStart) {
+        uint32_t periodUs = cycles_to_us(timer, cycles - timer->startCycles);
+        record(timer->periodHist, &timer->lastPeriodUs, &timer->maxPeriodUs, periodUs);
+
+        if (timer->nominalPeriodUs) {
+            uint32_t jitterUs = periodUs > timer->nominalPeriodUs
+                                    ? periodUs - timer->nominalPeriodUs
+                                    : timer->nominalPeriodUs - periodUs;
+            record(timer->jitterHist, &timer->lastJitterUs, &timer->maxJitterUs, jitterUs);
+        }
+    }
+    timer->startCycles = cycles;
+    timer->haveStart = true;
+}
+
+void LoopTiming_end(LoopTimer* timer, uint32_t cycles) {
+    if (!timer->haveStart) return;
+    uint32_t execUs = cycles_to_us(timer, cycles - timer->startCycles);
+    record(timer->execHist, &timer->lastExecUs, &timer->maxExecUs, execUs);
+    timer->count++;
+}
+
+void LoopTiming_resetStats(LoopTimer* timer) {
+    LoopTiming_init(timer, timer->nominalPeriodUs, timer->cyclesPerUs);
+}
+
+uint8_t LoopTiming_bucket(uint32_t us) {
+    if (us == 0) return 0;
+    uint8_t bucket = (uint8_t)(32 - __builtin_clz(us));     // floor(log2) + 1
+    return bucket < LOOP_HIST_BUCKETS ? bucket : LOOP_HIST_BUCKETS - 1;
+}
+
+// ============================================================================
+// Per-Core Idle Monitor
+// ============================================================================
+
+#if defined(__XTENSA__)
+
+typedef struct {
+    uint32_t lastCycles;        // Previous idle hook call
+    volatile uint32_t idleCycles;   // Running total (wraps), idle task only
+} IdleCounter;
+
+static IdleCounter gIdle[LOOP_TIMING_CORES];
+static uint32_t gIdleGapCycles = 0;
+static uint32_t gCyclesPerUs = 0;
+static bool gMonitorRunning = false;
+
+static struct {
+    int64_t lastUs;
+    uint32_t lastIdle[LOOP_TIMING_CORES];
+    float load[LOOP_TIMING_CORES];
+} gLoad;
+
+static inline void idle_tick(IdleCounter* c) {
+    uint32_t now = xthal_get_ccount();
+    uint32_t gap = now - c->lastCycles;
+    if (gap < gIdleGapCycles) c->idleCycles += gap;
+    c->lastCycles = now;
+}
+
+// Returning false keeps the idle task spinning (no WAITI between calls)
+static bool idle_hook_core0(void) {
+    idle_tick(&gIdle[0]);
+    return false;
+}
+
+static bool idle_hook_core1(void) {
+    idle_tick(&gIdle[1]);
+    return false;
+}
+
+bool LoopTiming_startIdleMonitor(void) {
+    if (gMonitorRunning) return true;
+
+    gCyclesPerUs = getCpuFrequencyMhz();
+    gIdleGapCycles = LOOP_IDLE_GAP_US * gCyclesPerUs;
+    memset(gIdle, 0, sizeof(gIdle));
+    gLoad.lastUs = HAL_Now();
+    for (int i = 0; i < LOOP_TIMING_CORES; i++) {
+        gLoad.lastIdle[i] = 0;
+        gLoad.load[i] = -1.0f;
+    }
+
+    bool ok = esp_register_freertos_idle_hook_for_cpu(idle_hook_core0, 0) == ESP_OK;
+#if portNUM_PROCESSORS > 1
+    ok = ok && esp_register_freertos_idle_hook_for_cpu(idle_hook_core1, 1) == ESP_OK;
+#endif
+    gMonitorRunning = ok;
+    return ok;
+}
+
+void LoopTiming_updateCoreLoad(void) {
+    if (!gMonitorRunning) return;
+
+    HAL_Micros now = HAL_Now();
+    int64_t windowUs = now - gLoad.lastUs;
+    if (windowUs < LOOP_LOAD_WINDOW_US) return;
+
+    for (int i = 0; i < portNUM_PROCESSORS && i < LOOP_TIMING_CORES; i++) {
+        uint32_t idle = gIdle[i].idleCycles;
+        float idleUs = (float)(idle - gLoad.lastIdle[i]) / gCyclesPerUs;
+        gLoad.lastIdle[i] = idle;
+
+        float load = 100.0f * (1.0f - idleUs / (float)windowUs);
+        gLoad.load[i] = load < 0.0f ? 0.0f : (load > 100.0f ? 100.0f : load);
+    }
+    gLoad.lastUs = now;
+}
+
+float LoopTiming_getCoreLoad(uint8_t core) {
+    if (!gMonitorRunning || core >= LOOP_TIMING_CORES) return -1.0f;
+    return gLoad.load[core];
+}
+
+#else
+
+// Host builds have no FreeRTOS idle task
+bool LoopTiming_startIdleMonitor(void) { return false; }
+void LoopTiming_updateCoreLoad(void) {}
+float LoopTiming_getCoreLoad(uint8_t core) { (void)core; return -1.0f; }
+
+#endif
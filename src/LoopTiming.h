@@ -0,0 +1,104 @@
+#ifndef LOOP_TIMING_H
+#define LOOP_TIMING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * LoopTiming - Cycle-accurate loop period / execution / jitter histograms
+ *
+ * A LoopTimer is stamped with the CPU cycle counter at the start and end
+ * of every iteration (begin / end on the same core: CCOUNT is per core).
+ * Period, execution time and jitter (|period - nominal|) go into log2
+ * histograms: bucket 0 counts 0 us, bucket b > 0 counts [2^(b-1), 2^b) us,
+ * the last bucket everything above. Updating is a few integer ops.
+ *
+ * Per-core CPU load comes from FreeRTOS idle hooks: the idle task calls
+ * the hook in a tight loop, so back-to-back calls (gap < IDLE_GAP_US) are
+ * idle time and anything longer was spent in tasks or interrupts.
+ *
+ * @file LoopTiming.h
+ */
+
+#define LOOP_HIST_BUCKETS       20      // Up to 2^18 us (~262 ms), then clamped
+#define LOOP_IDLE_GAP_US        50      // Longer gaps between idle hook calls = busy
+#define LOOP_LOAD_WINDOW_US     250000  // Minimum window for a core load sample
+#define LOOP_TIMING_CORES       2
+
+/**
+ * Timing state and histograms of one periodic loop
+ */
+typedef struct {
+    uint32_t nominalPeriodUs;   // Expected period (jitter reference), 0 = none
+    uint32_t cyclesPerUs;       // CPU clock in MHz
+    uint32_t startCycles;       // Cycle count at the current iteration start
+    bool haveStart;
+
+    uint32_t count;             // Completed iterations
+    uint32_t lastPeriodUs;
+    uint32_t lastExecUs;
+    uint32_t lastJitterUs;
+    uint32_t maxPeriodUs;
+    uint32_t maxExecUs;
+    uint32_t maxJitterUs;
+
+    uint32_t periodHist[LOOP_HIST_BUCKETS];
+    uint32_t execHist[LOOP_HIST_BUCKETS];
+    uint32_t jitterHist[LOOP_HIST_BUCKETS];
+} LoopTimer;
+
+/**
+ * Initialize (or reset) a loop timer
+ * @param timer Timer state
+ * @param nominalPeriodUs Expected period, 0 = no jitter tracking
+ * @param cyclesPerUs CPU clock in MHz (cycle counter ticks per microsecond)
+ */
+void LoopTiming_init(LoopTimer* timer, uint32_t nominalPeriodUs, uint32_t cyclesPerUs);
+
+/**
+ * Mark the start of an iteration (records the period since the last one)
+ * @param timer Timer state
+ * @param cycles Current cycle count
+ */
+void LoopTiming_begin(LoopTimer* timer, uint32_t cycles);
+
+/**
+ * Mark the end of an iteration (records execution time)
+ * @param timer Timer state
+ * @param cycles Current cycle count
+ */
+void LoopTiming_end(LoopTimer* timer, uint32_t cycles);
+
+/**
+ * Clear counters and histograms, keeping period and clock
+ * @param timer Timer state
+ */
+void LoopTiming_resetStats(LoopTimer* timer);
+
+/**
+ * Histogram bucket of a duration
+ * @param us Duration in microseconds
+ * @return Bucket index (0 to LOOP_HIST_BUCKETS - 1)
+ */
+uint8_t LoopTiming_bucket(uint32_t us);
+
+/**
+ * Start measuring per-core idle time (registers idle hooks)
+ * @return true if hooks are installed on every core
+ */
+bool LoopTiming_startIdleMonitor(void);
+
+/**
+ * Recompute per-core load (call periodically; windows shorter than
+ * LOOP_LOAD_WINDOW_US are skipped)
+ */
+void LoopTiming_updateCoreLoad(void);
+
+/**
+ * Get the load of a core over the last window
+ * @param core Core index
+ * @return Load 0-100 %, or -1 if not measured
+ */
+float LoopTiming_getCoreLoad(uint8_t core);
+
+#endif // LOOP_TIMING_H
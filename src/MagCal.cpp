@@ -0,0 +1,408 @@
+#include "MagCal.h"
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+FAST_MATH_FLOAT_ONLY
+
+/**
+ * MagCal - Implementation
+ *
+ * Parameters theta = [A B C D E F G H I J] against the regressor
+ * phi(u) = [x^2 y^2 z^2 2xy 2xz 2yz 2x 2y 2z 1] with u = raw / SCALE.
+ * Minimising theta' S theta (S = sum phi phi') under t' theta = 1 with
+ * t = [1 1 1 0 ...] gives theta = S^-1 t / (t' S^-1 t): one solve. With M
+ * the 3x3 of A..F and v = GHI:
+ *
+ *   center c = -M^-1 v,  k = c' M c - J,  Q = M / k:  (u-c)' Q (u-c) = 1
+ *
+ * The ellipsoid's semi-axes are 1 / sqrt(eig(Q)); scaling Q^1/2 by their
+ * geometric mean R = det(Q)^-1/6 maps it onto the sphere of radius R with
+ * the same volume, so the correction does not change the field strength
+ * on average. theta . phi = k * (|corrected|^2 / R^2 - 1), which is how
+ * the least-squares residual becomes a relative radius error.
+ *
+ * Float throughout: u is of order one and the centre-free constraint
+ * keeps the system well conditioned wherever the offset lies.
+ *
+ * @file MagCal.cpp
+ */
+
+static const int N = MAG_CAL_PARAMS;
+
+// ============================================================================
+// Config / Record
+// ============================================================================
+
+void MagCal_defaultConfig(MagConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->enabled = 1;
+    config->learn = 1;
+}
+
+void MagCal_sanitize(MagConfig* config) {
+    config->enabled = config->enabled ? 1 : 0;
+    config->learn = config->learn ? 1 : 0;
+    config->reserved = 0;
+    if (!isfinite(config->declinationDeg))
+        config->declinationDeg = 0.0f;
+    config->declinationDeg = FastMath_wrap180(config->declinationDeg);
+}
+
+void MagCal_defaultRecord(MagCalRecord* rec) {
+    memset(rec, 0, sizeof(*rec));
+    rec->version = MAG_CAL_VERSION;
+    for (int i = 0; i < 3; i++)
+        rec->soft[i][i] = 1.0f;
+}
+
+bool MagCal_sanitizeRecord(MagCalRecord* rec) {
+    bool ok = rec->version == MAG_CAL_VERSION;
+    for (int i = 0; ok && i < 3; i++) {
+        ok = isfinite(rec->offset[i]) && fabsf(rec->offset[i]) < 10.0f * MAG_CAL_FIELD_MAX_UT;
+        for (int j = 0; ok && j < 3; j++)
+            ok = isfinite(rec->soft[i][j]) && fabsf(rec->soft[i][j]) < 2.0f * MAG_CAL_MAX_AXIS_RATIO;
+    }
+    if (ok && rec->valid)
+        ok = rec->radiusUt >= MAG_CAL_FIELD_MIN_UT && rec->radiusUt <= MAG_CAL_FIELD_MAX_UT &&
+             isfinite(rec->residual);
+    if (!ok) {
+        MagCal_defaultRecord(rec);
+        return false;
+    }
+    rec->valid = rec->valid ? 1 : 0;
+    return true;
+}
+
+// ============================================================================
+// 3x3 Helpers
+// ============================================================================
+
+static void quadricToMatrix(const float theta[N], float M[3][3], float v[3]) {
+    M[0][0] = theta[0]; M[1][1] = theta[1]; M[2][2] = theta[2];
+    M[0][1] = M[1][0] = theta[3];
+    M[0][2] = M[2][0] = theta[4];
+    M[1][2] = M[2][1] = theta[5];
+    v[0] = theta[6]; v[1] = theta[7]; v[2] = theta[8];
+}
+
+static float det3(const float m[3][3]) {
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+           m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+           m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+// x = m^-1 b by Cramer's rule; false if m is singular
+static bool solve3(const float m[3][3], const float b[3], float x[3]) {
+    float d = det3(m);
+    if (!isfinite(d) || fabsf(d) < 1e-12f)
+        return false;
+    for (int c = 0; c < 3; c++) {
+        float t[3][3];
+        memcpy(t, m, sizeof(t));
+        for (int r = 0; r < 3; r++)
+            t[r][c] = b[r];
+        x[c] = det3(t) / d;
+    }
+    return true;
+}
+
+// Symmetric eigen decomposition by cyclic Jacobi rotations: a = V diag(w) V'
+static void eigen3(const float a[3][3], float w[3], float V[3][3]) {
+    float m[3][3];
+    memcpy(m, a, sizeof(m));
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            V[i][j] = i == j ? 1.0f : 0.0f;
+
+    for (int sweep = 0; sweep < 12; sweep++) {
+        float off = fabsf(m[0][1]) + fabsf(m[0][2]) + fabsf(m[1][2]);
+        if (off < 1e-9f)
+            break;
+        for (int p = 0; p < 2; p++) {
+            for (int q = p + 1; q < 3; q++) {
+                if (fabsf(m[p][q]) < 1e-12f)
+                    continue;
+                float theta = (m[q][q] - m[p][p]) / (2.0f * m[p][q]);
+                float t = (theta >= 0.0f ? 1.0f : -1.0f) /
+                          (fabsf(theta) + sqrtf(theta * theta + 1.0f));
+                float c = 1.0f / sqrtf(t * t + 1.0f);
+                float s = t * c;
+                for (int k = 0; k < 3; k++) {
+                    float mkp = m[k][p], mkq = m[k][q];
+                    m[k][p] = c * mkp - s * mkq;
+                    m[k][q] = s * mkp + c * mkq;
+                }
+                for (int k = 0; k < 3; k++) {
+                    float mpk = m[p][k], mqk = m[q][k];
+                    m[p][k] = c * mpk - s * mqk;
+                    m[q][k] = s * mpk + c * mqk;
+                }
+                for (int k = 0; k < 3; k++) {
+                    float vkp = V[k][p], vkq = V[k][q];
+                    V[k][p] = c * vkp - s * vkq;
+                    V[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++)
+        w[i] = m[i][i];
+}
+
+// ============================================================================
+// Fit
+// ============================================================================
+
+static const uint8_t FULL_PARAMS[N] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+static const uint8_t PLANAR_PARAMS[6] = {0, 1, 3, 6, 7, 9};    // A B D G H J
+
+// Minimise theta' S theta over the parameters in idx (others 0) under
+// A + B + C = 1: x = S^-1 t by Gaussian elimination with partial pivoting
+static bool solveFit(const MagCal* mc, const uint8_t* idx, int n, float theta[N]) {
+    float a[N][N + 1];
+    float ridge = MAG_CAL_RIDGE * mc->weight;
+    for (int i = 0; i < n; i++) {
+        int p = idx[i];
+        for (int j = 0; j < n; j++) {
+            int q = idx[j];
+            a[i][j] = p <= q ? mc->S[p][q] : mc->S[q][p];
+        }
+        a[i][i] += ridge;
+        a[i][n] = p < 3 ? 1.0f : 0.0f;
+    }
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++)
+            if (fabsf(a[row][col]) > fabsf(a[pivot][col]))
+                pivot = row;
+        if (fabsf(a[pivot][col]) < 1e-12f)
+            return false;
+        if (pivot != col) {
+            for (int j = col; j <= n; j++) {
+                float t = a[col][j];
+                a[col][j] = a[pivot][j];
+                a[pivot][j] = t;
+            }
+        }
+        for (int row = col + 1; row < n; row++) {
+            float f = a[row][col] / a[col][col];
+            for (int j = col; j <= n; j++)
+                a[row][j] -= f * a[col][j];
+        }
+    }
+    float x[N];
+    float trace = 0.0f;
+    for (int i = n - 1; i >= 0; i--) {
+        float s = a[i][n];
+        for (int j = i + 1; j < n; j++)
+            s -= a[i][j] * x[j];
+        x[i] = s / a[i][i];
+        if (idx[i] < 3)
+            trace += x[i];
+    }
+    if (!isfinite(trace) || fabsf(trace) < 1e-20f)
+        return false;
+    memset(theta, 0, N * sizeof(float));
+    for (int i = 0; i < n; i++)
+        theta[idx[i]] = x[i] / trace;
+    return true;
+}
+
+// Check a solution and turn it into a record. Planar: theta has no z terms;
+// z gets the horizontal axes' geometric mean around the samples' mid z.
+static bool quadricToRecord(const MagCal* mc, const float theta[N], bool planar,
+                            MagCalRecord* rec) {
+    float M[3][3], v[3], c[3], nv[3];
+    quadricToMatrix(theta, M, v);
+    if (planar)
+        M[2][2] = 1.0f;                         // Placeholder, keeps M invertible
+    for (int i = 0; i < 3; i++)
+        nv[i] = -v[i];
+    if (!solve3(M, nv, c))
+        return false;
+    float k = -theta[9];
+    for (int i = 0; i < 3; i++)
+        k += c[i] * (M[i][0] * c[0] + M[i][1] * c[1] + M[i][2] * c[2]);
+    if (!(k > 1e-9f))                           // Not an ellipsoid
+        return false;
+
+    float Q[3][3], w[3], V[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            Q[i][j] = M[i][j] / k;
+    if (planar) {
+        float det2 = Q[0][0] * Q[1][1] - Q[0][1] * Q[0][1];
+        if (!(det2 > 0.0f) || !(Q[0][0] > 0.0f))
+            return false;
+        Q[2][2] = sqrtf(det2);
+        c[2] = 0.5f * (mc->boxMin[2] + mc->boxMax[2]) / MAG_CAL_SCALE_UT;
+    }
+    eigen3(Q, w, V);
+    float wMin = w[0], wMax = w[0];
+    for (int i = 1; i < 3; i++) {
+        if (w[i] < wMin) wMin = w[i];
+        if (w[i] > wMax) wMax = w[i];
+    }
+    // Semi-axes 1 / sqrt(w): ratio sqrt(wMax / wMin)
+    if (!(wMin > 0.0f) || wMax > wMin * MAG_CAL_MAX_AXIS_RATIO * MAG_CAL_MAX_AXIS_RATIO)
+        return false;
+
+    float R = powf(w[0] * w[1] * w[2], -1.0f / 6.0f);
+    float radiusUt = R * MAG_CAL_SCALE_UT;
+    float minUt = planar ? MAG_CAL_HORIZONTAL_MIN_UT : MAG_CAL_FIELD_MIN_UT;
+    if (!(radiusUt >= minUt && radiusUt <= MAG_CAL_FIELD_MAX_UT))
+        return false;
+
+    // Sum of squared equation errors: theta' S theta. From float sums it
+    // bottoms out around 0.3 %, well under the gate.
+    float sq = 0.0f;
+    for (int i = 0; i < N; i++) {
+        float si = 0.0f;
+        for (int j = 0; j < N; j++)
+            si += (i <= j ? mc->S[i][j] : mc->S[j][i]) * theta[j];
+        sq += theta[i] * si;
+    }
+    float residual = sqrtf(fmaxf(sq, 0.0f) / mc->weight) / (2.0f * k);
+    if (!(residual <= MAG_CAL_MAX_RESIDUAL))
+        return false;
+
+    MagCal_defaultRecord(rec);
+    rec->valid = 1;
+    rec->planar = planar ? 1 : 0;
+    rec->coverage = MagCal_coverageCount(mc->coverage);
+    for (int i = 0; i < 3; i++) {
+        rec->offset[i] = c[i] * MAG_CAL_SCALE_UT;
+        for (int j = 0; j < 3; j++) {
+            float s = 0.0f;
+            for (int e = 0; e < 3; e++)
+                s += V[i][e] * sqrtf(w[e]) * V[j][e];
+            rec->soft[i][j] = R * s;
+        }
+    }
+    rec->radiusUt = radiusUt;
+    rec->residual = residual;
+    return true;
+}
+
+static void markSector(MagCal* mc, const float raw[3]) {
+    // Around the fitted offset, or the middle of the samples seen so far
+    float d[3];
+    for (int i = 0; i < 3; i++) {
+        float center = mc->cal.valid ? mc->cal.offset[i]
+                                     : 0.5f * (mc->boxMin[i] + mc->boxMax[i]);
+        d[i] = raw[i] - center;
+    }
+    float h2 = d[0] * d[0] + d[1] * d[1];
+    if (h2 < 0.04f * (h2 + d[2] * d[2]))        // Within ~78 deg of the z axis
+        return;
+    float a = FastMath_atan2(d[1], d[0]) + FAST_MATH_PI;
+    int sector = (int)(a * (MAG_CAL_SECTORS / FAST_MATH_TWO_PI));
+    if (sector >= MAG_CAL_SECTORS)
+        sector = MAG_CAL_SECTORS - 1;
+    mc->coverage |= (uint8_t)(1u << sector);
+}
+
+// ============================================================================
+// Public
+// ============================================================================
+
+void MagCal_init(MagCal* mc, const MagCalRecord* rec) {
+    memset(mc, 0, sizeof(*mc));
+    mc->cal = *rec;
+}
+
+void MagCal_reset(MagCal* mc) {
+    MagCalRecord rec;
+    MagCal_defaultRecord(&rec);
+    MagCal_init(mc, &rec);
+}
+
+bool MagCal_feed(MagCal* mc, const float raw[3]) {
+    if (!isfinite(raw[0]) || !isfinite(raw[1]) || !isfinite(raw[2]))
+        return false;
+    if (mc->haveLast) {
+        float dx = raw[0] - mc->last[0], dy = raw[1] - mc->last[1], dz = raw[2] - mc->last[2];
+        if (dx * dx + dy * dy + dz * dz < MAG_CAL_MIN_STEP_UT * MAG_CAL_MIN_STEP_UT)
+            return false;
+    }
+    float u[3];
+    for (int i = 0; i < 3; i++)
+        u[i] = raw[i] / MAG_CAL_SCALE_UT;
+    for (int i = 0; i < 3; i++) {
+        mc->last[i] = raw[i];
+        if (!mc->haveLast || raw[i] < mc->boxMin[i]) mc->boxMin[i] = raw[i];
+        if (!mc->haveLast || raw[i] > mc->boxMax[i]) mc->boxMax[i] = raw[i];
+    }
+    mc->haveLast = true;
+    mc->accepted++;
+    markSector(mc, raw);
+
+    float phi[N] = {u[0] * u[0], u[1] * u[1], u[2] * u[2],
+                    2.0f * u[0] * u[1], 2.0f * u[0] * u[2], 2.0f * u[1] * u[2],
+                    2.0f * u[0], 2.0f * u[1], 2.0f * u[2], 1.0f};
+    for (int i = 0; i < N; i++)
+        for (int j = i; j < N; j++)
+            mc->S[i][j] = MAG_CAL_FORGET * mc->S[i][j] + phi[i] * phi[j];
+    mc->weight = MAG_CAL_FORGET * mc->weight + 1.0f;
+
+    if (++mc->sinceSolve < MAG_CAL_SOLVE_EVERY || mc->weight < MAG_CAL_MIN_WEIGHT ||
+        MagCal_coverageCount(mc->coverage) < MAG_CAL_MIN_SECTORS)
+        return false;
+    mc->sinceSolve = 0;
+
+    // Level turns only: z carries no information on the z terms
+    float xySpan = fmaxf(mc->boxMax[0] - mc->boxMin[0], mc->boxMax[1] - mc->boxMin[1]);
+    bool planar = mc->boxMax[2] - mc->boxMin[2] < MAG_CAL_SPAN_3D * xySpan;
+
+    float theta[N];
+    MagCalRecord rec;
+    bool solved = planar ? solveFit(mc, PLANAR_PARAMS, 6, theta)
+                         : solveFit(mc, FULL_PARAMS, N, theta);
+    if (!solved || !quadricToRecord(mc, theta, planar, &rec)) {
+        mc->rejectedFits++;
+        return false;
+    }
+    mc->cal = rec;
+    // Next fit after another turn
+    mc->coverage = 0;
+    for (int i = 0; i < 3; i++)
+        mc->boxMin[i] = mc->boxMax[i] = raw[i];
+    mc->fits++;
+    return true;
+}
+
+void MagCal_correct(const MagCal* mc, const float raw[3], float out[3]) {
+    if (!mc->cal.valid) {
+        out[0] = raw[0]; out[1] = raw[1]; out[2] = raw[2];
+        return;
+    }
+    float d[3] = {raw[0] - mc->cal.offset[0], raw[1] - mc->cal.offset[1],
+                  raw[2] - mc->cal.offset[2]};
+    for (int i = 0; i < 3; i++)
+        out[i] = mc->cal.soft[i][0] * d[0] + mc->cal.soft[i][1] * d[1] + mc->cal.soft[i][2] * d[2];
+}
+
+bool MagCal_disturbed(const MagCal* mc, const float corrected[3]) {
+    if (!mc->cal.valid)
+        return true;
+    float n = sqrtf(corrected[0] * corrected[0] + corrected[1] * corrected[1] +
+                    corrected[2] * corrected[2]);
+    return fabsf(n / mc->cal.radiusUt - 1.0f) > MAG_CAL_FIELD_GATE;
+}
+
+uint8_t MagCal_coverageCount(uint8_t coverage) {
+    uint8_t n = 0;
+    for (; coverage; coverage &= (uint8_t)(coverage - 1))
+        n++;
+    return n;
+}
+
+float MagCal_heading(const float earth[3], float gyroHeadingDeg, float declinationDeg) {
+    // North lies atan2(e_y, e_x) counter-clockwise of the estimator's x axis,
+    // the body yaw (= -gyroHeading) counter-clockwise of it
+    float h = FastMath_atan2(earth[1], earth[0]) * FAST_MATH_RAD_TO_DEG +
+              gyroHeadingDeg + declinationDeg;
+    h = FastMath_wrap180(h);
+    return h < 0.0f ? h + 360.0f : h;
+}
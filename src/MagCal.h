@@ -0,0 +1,182 @@
+#ifndef MAG_CAL_H
+#define MAG_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * MagCal - Online hard / soft-iron calibration and magnetic heading
+ *
+ * A magnetometer fixed to the vehicle sees the Earth field on a sphere
+ * that iron on the vehicle shifts (hard iron: offset) and stretches (soft
+ * iron: symmetric matrix) into an ellipsoid. The ellipsoid is fitted as
+ * the general quadric
+ *
+ *   A x^2 + B y^2 + C z^2 + 2D xy + 2E xz + 2F yz + 2G x + 2H y + 2I z + J = 0
+ *
+ * under A + B + C = 1, which every ellipsoid satisfies after scaling and
+ * which does not care where the centre is (hard iron often puts the
+ * origin outside the ellipsoid). The least-squares fit needs only the
+ * 10x10 scatter matrix of the samples, kept in constant memory; samples
+ * are never stored. It fades by MAG_CAL_FORGET per accepted sample, so
+ * the fit follows a payload change; a sample closer than
+ * MAG_CAL_MIN_STEP_UT to the last accepted one is skipped (a parked
+ * vehicle would otherwise outvote the rest).
+ *
+ * Every MAG_CAL_SOLVE_EVERY accepted samples the constrained problem is
+ * solved (one linear system). A solution is only taken if it is an
+ * ellipsoid with axes within MAG_CAL_MAX_AXIS_RATIO, a field of
+ * MAG_CAL_FIELD_MIN_UT..MAX and a residual under MAG_CAL_MAX_RESIDUAL,
+ * and once the vehicle has turned around: samples in MAG_CAL_MIN_SECTORS
+ * of the MAG_CAL_SECTORS body-xy directions around the offset. Turning
+ * in the xy plane is what heading needs; tumbling is not required.
+ *
+ * A vehicle that only turns level (rover, boat) leaves every z term of
+ * the quadric unobservable. When the samples span less than
+ * MAG_CAL_SPAN_3D of their xy range in z, only the horizontal ellipse
+ * (A B D G H J under A + B = 1) is fitted and z is passed through around
+ * its mean: the corrected field is then the horizontal one, good for
+ * heading while roughly level but not tilt compensated (planar flag).
+ * One tumble of the vehicle later upgrades it to the full fit.
+ *
+ * The fit is applied as corrected = soft * (raw - offset), which has the
+ * length of the fitted field; tilt compensation and heading are done by
+ * the caller with its attitude (MagCal_heading).
+ *
+ * Pure: no globals, no RTOS. Owned by the sensor task; the record goes
+ * to NVS (MAG_CAL_RECORD_KEY) after each accepted fit.
+ *
+ * @file MagCal.h
+ */
+
+#define MAG_CAL_CONFIG_KEY          "cfg_mag"
+#define MAG_CAL_RECORD_KEY          "cal_mag"
+#define MAG_CAL_VERSION             1
+#define MAG_CAL_PARAMS              10
+#define MAG_CAL_SCALE_UT            50.0f   // Fitted in units of about one Earth field
+#define MAG_CAL_FORGET              0.999f  // Per accepted sample (~1000 effective)
+#define MAG_CAL_MIN_STEP_UT         3.0f
+#define MAG_CAL_SOLVE_EVERY         20      // Accepted samples between fits
+#define MAG_CAL_MIN_WEIGHT          100.0f  // Effective samples before the first fit
+#define MAG_CAL_RIDGE               1e-6f   // Relative to the weight, keeps the solve regular
+#define MAG_CAL_SECTORS             8       // 45 deg body-xy sectors
+#define MAG_CAL_MIN_SECTORS         6
+#define MAG_CAL_FIELD_MIN_UT        20.0f
+#define MAG_CAL_FIELD_MAX_UT        80.0f
+#define MAG_CAL_HORIZONTAL_MIN_UT   8.0f    // Planar fit: horizontal field only
+#define MAG_CAL_SPAN_3D             0.5f    // z span / xy span of the samples for a 3D fit
+#define MAG_CAL_MAX_AXIS_RATIO      1.5f
+#define MAG_CAL_MAX_RESIDUAL        0.05f   // RMS of |corrected| / radius - 1
+#define MAG_CAL_FIELD_GATE          0.15f   // |corrected| off the radius by this: disturbed
+#define MAG_CAL_HEADING_SIGMA_DEG   5.0f    // Fused heading 1-sigma
+#define MAG_CAL_FUSE_MS             100     // Heading fused at 10 Hz
+
+/**
+ * Stored configuration
+ */
+typedef struct {
+    uint8_t enabled;            // Fuse the magnetic heading
+    uint8_t learn;              // Refine the calibration online
+    uint16_t reserved;
+    float declinationDeg;       // East positive: true = magnetic + declination
+} MagConfig;
+
+/**
+ * Stored calibration (NVS blob)
+ */
+typedef struct {
+    uint16_t version;
+    uint8_t valid;
+    uint8_t coverage;           // Sectors seen at the fit
+    uint8_t planar;             // Horizontal-only fit (z passed through)
+    uint8_t reserved[3];
+    float offset[3];            // Hard iron, uT
+    float soft[3][3];           // Soft iron, symmetric
+    float radiusUt;             // Fitted field strength
+    float residual;             // RMS of |corrected| / radius - 1
+} MagCalRecord;
+
+typedef struct {
+    MagCalRecord cal;           // Applied
+
+    // Scatter matrix (upper triangle used), faded per accepted sample
+    float S[MAG_CAL_PARAMS][MAG_CAL_PARAMS];
+    float weight;
+
+    float last[3];              // Last accepted sample, uT
+    bool haveLast;
+    float boxMin[3];            // Range of samples since the last fit, uT
+    float boxMax[3];
+    uint8_t coverage;           // Sector bits seen (relative to the offset)
+    uint16_t sinceSolve;
+
+    uint32_t accepted;
+    uint32_t fits;              // Solutions taken
+    uint32_t rejectedFits;      // Solved but failed a check
+} MagCal;
+
+/**
+ * Heading fused, learning on, no declination
+ */
+void MagCal_defaultConfig(MagConfig* config);
+
+/**
+ * Clamp a loaded / edited config into range
+ */
+void MagCal_sanitize(MagConfig* config);
+
+/**
+ * No calibration (offset 0, identity soft iron, not valid)
+ */
+void MagCal_defaultRecord(MagCalRecord* rec);
+
+/**
+ * Check a loaded record: wrong version or implausible values reset it
+ * @return false if it was reset
+ */
+bool MagCal_sanitizeRecord(MagCalRecord* rec);
+
+/**
+ * Start from a (sanitized) stored record
+ */
+void MagCal_init(MagCal* mc, const MagCalRecord* rec);
+
+/**
+ * Add one raw sample
+ * @param raw Field, uT, body axes
+ * @return true if a new fit was taken (store mc->cal)
+ */
+bool MagCal_feed(MagCal* mc, const float raw[3]);
+
+/**
+ * Apply the calibration (raw copied through while not valid)
+ */
+void MagCal_correct(const MagCal* mc, const float raw[3], float out[3]);
+
+/**
+ * A corrected field whose strength is off the fitted one by more than
+ * MAG_CAL_FIELD_GATE (iron nearby, motor current): not a heading source
+ */
+bool MagCal_disturbed(const MagCal* mc, const float corrected[3]);
+
+/**
+ * Forget the fit and all samples
+ */
+void MagCal_reset(MagCal* mc);
+
+/**
+ * Sectors set in a coverage mask
+ */
+uint8_t MagCal_coverageCount(uint8_t coverage);
+
+/**
+ * Compass heading from a corrected field rotated into the attitude
+ * estimator's earth frame (z up, x its yaw reference)
+ * @param earth Corrected field in that frame
+ * @param gyroHeadingDeg Attitude estimator heading, clockwise (-yaw)
+ * @param declinationDeg East positive
+ * @return True heading of the body x axis, 0-360 deg
+ */
+float MagCal_heading(const float earth[3], float gyroHeadingDeg, float declinationDeg);
+
+#endif // MAG_CAL_H
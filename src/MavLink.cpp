@@ -0,0 +1,138 @@
+#include "MavLink.h"
+#include <string.h>
+
+/**
+ * MavLink - Implementation
+ *
+ * @file MavLink.cpp
+ */
+
+typedef struct {
+    uint32_t msgid;
+    uint8_t crcExtra;
+    uint8_t length;
+} MessageInfo;
+
+static const MessageInfo MESSAGES[] = {
+    {MAVLINK_MSG_HEARTBEAT,            50,  sizeof(MavHeartbeat)},
+    {MAVLINK_MSG_SYS_STATUS,           124, sizeof(MavSysStatus)},
+    {MAVLINK_MSG_PARAM_REQUEST_READ,   214, sizeof(MavParamRequestRead)},
+    {MAVLINK_MSG_PARAM_REQUEST_LIST,   159, sizeof(MavParamRequestList)},
+    {MAVLINK_MSG_PARAM_VALUE,          220, sizeof(MavParamValue)},
+    {MAVLINK_MSG_PARAM_SET,            168, sizeof(MavParamSet)},
+    {MAVLINK_MSG_ATTITUDE,             39,  sizeof(MavAttitude)},
+    {MAVLINK_MSG_GLOBAL_POSITION_INT,  104, sizeof(MavGlobalPositionInt)},
+    {MAVLINK_MSG_MISSION_CURRENT,      28,  sizeof(MavMissionCurrent)},
+    {MAVLINK_MSG_MISSION_REQUEST_LIST, 132, sizeof(MavMissionRequestList)},
+    {MAVLINK_MSG_MISSION_COUNT,        221, sizeof(MavMissionCount)},
+    {MAVLINK_MSG_MISSION_CLEAR_ALL,    232, sizeof(MavMissionClearAll)},
+    {MAVLINK_MSG_MISSION_ACK,          153, sizeof(MavMissionAck)},
+    {MAVLINK_MSG_MISSION_REQUEST_INT,  196, sizeof(MavMissionRequestInt)},
+    {MAVLINK_MSG_MISSION_ITEM_INT,     38,  sizeof(MavMissionItemInt)},
+    {MAVLINK_MSG_COMMAND_LONG,         152, sizeof(MavCommandLong)},
+    {MAVLINK_MSG_COMMAND_ACK,          143, sizeof(MavCommandAck)},
+};
+
+#define MESSAGE_COUNT (sizeof(MESSAGES) / sizeof(MESSAGES[0]))
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+uint16_t MavLink_crc(const uint8_t* data, size_t len, uint16_t crc) {
+    for (size_t i = 0; i < len; i++) {
+        uint8_t tmp = data[i] ^ (uint8_t)(crc & 0xFF);
+        tmp ^= (uint8_t)(tmp << 4);
+        crc = (crc >> 8) ^ ((uint16_t)tmp << 8) ^ ((uint16_t)tmp << 3) ^ (tmp >> 4);
+    }
+    return crc;
+}
+
+bool MavLink_messageInfo(uint32_t msgid, uint8_t* crcExtra, uint8_t* length) {
+    for (size_t i = 0; i < MESSAGE_COUNT; i++) {
+        if (MESSAGES[i].msgid == msgid) {
+            if (crcExtra) *crcExtra = MESSAGES[i].crcExtra;
+            if (length) *length = MESSAGES[i].length;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint16_t frameCrc(const uint8_t* frame, uint8_t payloadLen, uint8_t crcExtra) {
+    // Everything after STX up to the end of the payload, then CRC_EXTRA
+    uint16_t crc = MavLink_crc(frame + 1, MAVLINK_HEADER_LEN - 1 + payloadLen, 0xFFFF);
+    return MavLink_crc(&crcExtra, 1, crc);
+}
+
+size_t MavLink_finish(MavLinkTx* tx, uint8_t* frame, uint32_t msgid, uint8_t len) {
+    uint8_t crcExtra;
+    if (!MavLink_messageInfo(msgid, &crcExtra, NULL)) return 0;
+
+    // v2 drops trailing zero bytes but always keeps the first one
+    const uint8_t* payload = MavLink_payload(frame);
+    while (len > 1 && payload[len - 1] == 0) len--;
+
+    frame[0] = MAVLINK_STX;
+    frame[1] = len;
+    frame[2] = 0;               // incompat_flags
+    frame[3] = 0;               // compat_flags
+    frame[4] = tx->seq++;
+    frame[5] = tx->systemId;
+    frame[6] = tx->componentId;
+    frame[7] = (uint8_t)msgid;
+    frame[8] = (uint8_t)(msgid >> 8);
+    frame[9] = (uint8_t)(msgid >> 16);
+
+    uint16_t crc = frameCrc(frame, len, crcExtra);
+    frame[MAVLINK_HEADER_LEN + len] = (uint8_t)crc;
+    frame[MAVLINK_HEADER_LEN + len + 1] = (uint8_t)(crc >> 8);
+    return MAVLINK_HEADER_LEN + len + MAVLINK_CHECKSUM_LEN;
+}
+
+size_t MavLink_frameLength(const uint8_t* head, size_t available) {
+    if (available < 3 || head[0] != MAVLINK_STX) return 0;
+    size_t total = MAVLINK_HEADER_LEN + head[1] + MAVLINK_CHECKSUM_LEN;
+    if (head[2] & MAVLINK_IFLAG_SIGNED) total += MAVLINK_SIGNATURE_LEN;
+    return total;
+}
+
+MavLinkParseResult MavLink_parse(uint8_t* frame, size_t len, MavLinkView* view) {
+    size_t expected = MavLink_frameLength(frame, len);
+    if (expected == 0 || expected != len) return MAVLINK_PARSE_SHORT;
+    if (frame[2] & MAVLINK_IFLAG_SIGNED) return MAVLINK_PARSE_SIGNED;
+
+    uint32_t msgid = frame[7] | ((uint32_t)frame[8] << 8) | ((uint32_t)frame[9] << 16);
+    uint8_t crcExtra, fullLen;
+    if (!MavLink_messageInfo(msgid, &crcExtra, &fullLen)) return MAVLINK_PARSE_UNKNOWN;
+
+    uint8_t payloadLen = frame[1];
+    uint16_t crc = frameCrc(frame, payloadLen, crcExtra);
+    uint16_t wire = frame[MAVLINK_HEADER_LEN + payloadLen] |
+                    ((uint16_t)frame[MAVLINK_HEADER_LEN + payloadLen + 1] << 8);
+    if (crc != wire) return MAVLINK_PARSE_CRC;
+
+    // Restore the truncated zeros (this overwrites the checked CRC)
+    if (payloadLen < fullLen)
+        memset(frame + MAVLINK_HEADER_LEN + payloadLen, 0, fullLen - payloadLen);
+
+    view->msgid = msgid;
+    view->seq = frame[4];
+    view->systemId = frame[5];
+    view->componentId = frame[6];
+    view->len = payloadLen;
+    view->payload = frame + MAVLINK_HEADER_LEN;
+    return MAVLINK_PARSE_OK;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void MavLink_setParamId(char* id, const char* name) {
+    strncpy(id, name, MAVLINK_PARAM_ID_LEN);
+}
+
+bool MavLink_paramIdEquals(const char* id, const char* name) {
+    return strncmp(id, name, MAVLINK_PARAM_ID_LEN) == 0;
+}
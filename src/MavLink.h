@@ -0,0 +1,317 @@
+#ifndef MAVLINK_H
+#define MAVLINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * MavLink - MAVLink v2 framing and the common.xml messages we speak
+ *
+ * A hand-written subset instead of the generated library: the frame
+ * layer (header, CRC-16/MCRF4XX with the per-message CRC_EXTRA, v2
+ * trailing-zero truncation) and packed structs for each payload in wire
+ * order, so a payload is read and written in place:
+ *
+ *   TX  The caller fills MavLink_payload(frame) as the message struct
+ *       and MavLink_finish() truncates, writes the header and the CRC
+ *       around it in the same buffer.
+ *   RX  MavLink_parse() checks a complete frame and zero-fills the
+ *       truncated tail in place, so the view's payload can be read as
+ *       the full struct.
+ *
+ * Messages we have no CRC_EXTRA for cannot be checked and are refused
+ * (MAVLINK_PARSE_UNKNOWN). Signed frames (incompat flag 0x01) are
+ * refused too. v1 frames (0xFE) are not handled.
+ *
+ * Pure: no globals, no I/O.
+ *
+ * @file MavLink.h
+ */
+
+#define MAVLINK_STX                 0xFD
+#define MAVLINK_HEADER_LEN          10      // STX .. msgid
+#define MAVLINK_CHECKSUM_LEN        2
+#define MAVLINK_SIGNATURE_LEN       13
+#define MAVLINK_MAX_PAYLOAD         255
+#define MAVLINK_MAX_FRAME           (MAVLINK_HEADER_LEN + MAVLINK_MAX_PAYLOAD + \
+                                     MAVLINK_CHECKSUM_LEN + MAVLINK_SIGNATURE_LEN)
+#define MAVLINK_IFLAG_SIGNED        0x01
+
+// Message ids
+#define MAVLINK_MSG_HEARTBEAT               0
+#define MAVLINK_MSG_SYS_STATUS              1
+#define MAVLINK_MSG_PARAM_REQUEST_READ      20
+#define MAVLINK_MSG_PARAM_REQUEST_LIST      21
+#define MAVLINK_MSG_PARAM_VALUE             22
+#define MAVLINK_MSG_PARAM_SET               23
+#define MAVLINK_MSG_ATTITUDE                30
+#define MAVLINK_MSG_GLOBAL_POSITION_INT     33
+#define MAVLINK_MSG_MISSION_CURRENT         42
+#define MAVLINK_MSG_MISSION_REQUEST_LIST    43
+#define MAVLINK_MSG_MISSION_COUNT           44
+#define MAVLINK_MSG_MISSION_CLEAR_ALL       45
+#define MAVLINK_MSG_MISSION_ACK             47
+#define MAVLINK_MSG_MISSION_REQUEST_INT     51
+#define MAVLINK_MSG_MISSION_ITEM_INT        73
+#define MAVLINK_MSG_COMMAND_LONG            76
+#define MAVLINK_MSG_COMMAND_ACK             77
+
+// Enum values used here (common.xml)
+#define MAV_TYPE_FIXED_WING                 1
+#define MAV_TYPE_QUADROTOR                  2
+#define MAV_TYPE_GROUND_ROVER               10
+#define MAV_TYPE_SUBMARINE                  12
+#define MAV_AUTOPILOT_GENERIC               0
+#define MAV_MODE_FLAG_SAFETY_ARMED          0x80
+#define MAV_MODE_FLAG_MANUAL_INPUT_ENABLED  0x40
+#define MAV_MODE_FLAG_AUTO_ENABLED          0x04
+#define MAV_STATE_STANDBY                   3
+#define MAV_STATE_ACTIVE                    4
+#define MAV_STATE_CRITICAL                  5
+#define MAV_PARAM_TYPE_REAL32               9
+#define MAV_RESULT_ACCEPTED                 0
+#define MAV_RESULT_UNSUPPORTED              3
+#define MAV_MISSION_TYPE_MISSION            0
+
+#define MAV_SYS_STATUS_SENSOR_3D_GYRO       0x01
+#define MAV_SYS_STATUS_SENSOR_3D_ACCEL      0x02
+#define MAV_SYS_STATUS_SENSOR_3D_MAG        0x04
+#define MAV_SYS_STATUS_SENSOR_ABS_PRESSURE  0x08
+#define MAV_SYS_STATUS_SENSOR_GPS           0x20
+
+#define MAVLINK_PARAM_ID_LEN                16
+
+typedef enum {
+    MAVLINK_PARSE_OK = 0,
+    MAVLINK_PARSE_SHORT,        // Not a whole frame / length mismatch
+    MAVLINK_PARSE_SIGNED,       // Signed frame: not supported
+    MAVLINK_PARSE_UNKNOWN,      // No CRC_EXTRA for this message id
+    MAVLINK_PARSE_CRC
+} MavLinkParseResult;
+
+/**
+ * Sender state: our ids and the sequence counter
+ */
+typedef struct {
+    uint8_t systemId;
+    uint8_t componentId;
+    uint8_t seq;
+} MavLinkTx;
+
+/**
+ * A parsed frame; payload points into the frame buffer, zero-filled up
+ * to the message's full length
+ */
+typedef struct {
+    uint32_t msgid;
+    uint8_t systemId;
+    uint8_t componentId;
+    uint8_t seq;
+    uint8_t len;                // As received (before zero fill)
+    const uint8_t* payload;
+} MavLinkView;
+
+// ============================================================================
+// Payloads (wire order: fields sorted by size, extensions last)
+// ============================================================================
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t customMode;
+    uint8_t type;
+    uint8_t autopilot;
+    uint8_t baseMode;
+    uint8_t systemStatus;
+    uint8_t mavlinkVersion;
+} MavHeartbeat;
+
+typedef struct {
+    uint32_t sensorsPresent;
+    uint32_t sensorsEnabled;
+    uint32_t sensorsHealth;
+    uint16_t load;              // 0.1 %
+    uint16_t voltageBattery;    // mV, UINT16_MAX = unknown
+    int16_t currentBattery;     // 10 mA, -1 = unknown
+    uint16_t dropRateComm;      // 0.01 %
+    uint16_t errorsComm;
+    uint16_t errorsCount[4];
+    int8_t batteryRemaining;    // %, -1 = unknown
+} MavSysStatus;
+
+typedef struct {
+    int16_t paramIndex;         // -1: use paramId
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    char paramId[MAVLINK_PARAM_ID_LEN];
+} MavParamRequestRead;
+
+typedef struct {
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+} MavParamRequestList;
+
+typedef struct {
+    float paramValue;
+    uint16_t paramCount;
+    uint16_t paramIndex;
+    char paramId[MAVLINK_PARAM_ID_LEN];
+    uint8_t paramType;
+} MavParamValue;
+
+typedef struct {
+    float paramValue;
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    char paramId[MAVLINK_PARAM_ID_LEN];
+    uint8_t paramType;
+} MavParamSet;
+
+typedef struct {
+    uint32_t timeBootMs;
+    float roll;                 // rad
+    float pitch;
+    float yaw;
+    float rollSpeed;            // rad/s
+    float pitchSpeed;
+    float yawSpeed;
+} MavAttitude;
+
+typedef struct {
+    uint32_t timeBootMs;
+    int32_t lat;                // deg * 1e7
+    int32_t lon;
+    int32_t alt;                // mm MSL
+    int32_t relativeAlt;        // mm above home
+    int16_t vx;                 // cm/s north
+    int16_t vy;                 // cm/s east
+    int16_t vz;                 // cm/s down
+    uint16_t hdg;               // cdeg, UINT16_MAX = unknown
+} MavGlobalPositionInt;
+
+typedef struct {
+    uint16_t seq;
+} MavMissionCurrent;
+
+typedef struct {
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t missionType;        // Extension
+} MavMissionRequestList;
+
+typedef struct {
+    uint16_t count;
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t missionType;        // Extension
+} MavMissionCount;
+
+typedef struct {
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t missionType;        // Extension
+} MavMissionClearAll;
+
+typedef struct {
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t type;               // MAV_MISSION_RESULT
+    uint8_t missionType;        // Extension
+} MavMissionAck;
+
+typedef struct {
+    uint16_t seq;
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t missionType;        // Extension
+} MavMissionRequestInt;
+
+typedef struct {
+    float param1;
+    float param2;
+    float param3;
+    float param4;
+    int32_t x;                  // lat deg * 1e7
+    int32_t y;                  // lon deg * 1e7
+    float z;                    // m
+    uint16_t seq;
+    uint16_t command;           // MAV_CMD
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t frame;              // MAV_FRAME
+    uint8_t current;
+    uint8_t autocontinue;
+    uint8_t missionType;        // Extension
+} MavMissionItemInt;
+
+typedef struct {
+    float param[7];
+    uint16_t command;
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t confirmation;
+} MavCommandLong;
+
+typedef struct {
+    uint16_t command;
+    uint8_t result;             // MAV_RESULT
+} MavCommandAck;
+#pragma pack(pop)
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+/**
+ * CRC-16/MCRF4XX (X.25) as MAVLink uses it
+ */
+uint16_t MavLink_crc(const uint8_t* data, size_t len, uint16_t crc);
+
+/**
+ * CRC_EXTRA and full payload length of a known message
+ * @return false if the id is not one of ours
+ */
+bool MavLink_messageInfo(uint32_t msgid, uint8_t* crcExtra, uint8_t* length);
+
+/**
+ * Payload area of a frame buffer (MAVLINK_MAX_FRAME bytes)
+ */
+static inline uint8_t* MavLink_payload(uint8_t* frame) {
+    return frame + MAVLINK_HEADER_LEN;
+}
+
+/**
+ * Seal a frame whose payload is already in place
+ * @param len Full payload length (sizeof the struct); trailing zeros are cut
+ * @return Frame length, 0 for an unknown message id
+ */
+size_t MavLink_finish(MavLinkTx* tx, uint8_t* frame, uint32_t msgid, uint8_t len);
+
+/**
+ * Bytes the whole frame takes, from its first three bytes
+ * @return 0 if the buffer does not start a v2 frame
+ */
+size_t MavLink_frameLength(const uint8_t* head, size_t available);
+
+/**
+ * Check a complete frame and zero-fill its payload in place
+ * @param frame Frame, from STX; at least MAVLINK_MAX_FRAME bytes of room
+ * @param len Bytes in the frame
+ */
+MavLinkParseResult MavLink_parse(uint8_t* frame, size_t len, MavLinkView* view);
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+/**
+ * param_id field from a name (NUL padded, not terminated at 16 chars)
+ */
+void MavLink_setParamId(char* id, const char* name);
+
+/**
+ * @return true if a received param_id names this parameter
+ */
+bool MavLink_paramIdEquals(const char* id, const char* name);
+
+#endif // MAVLINK_H
@@ -0,0 +1,189 @@
+#include "MavMission.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * MavMission - Implementation
+ *
+ * @file MavMission.cpp
+ */
+
+#define LAT_E7_MAX  900000000L
+#define LNG_E7_MAX  1800000000L
+
+static bool relativeFrame(uint8_t frame) {
+    return frame == MAV_FRAME_GLOBAL_RELATIVE_ALT || frame == MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+}
+
+static bool commandFrame(uint8_t frame) {
+    return frame == MAV_FRAME_MISSION || relativeFrame(frame);
+}
+
+// ============================================================================
+// Item Conversion
+// ============================================================================
+
+static uint8_t positionItem(const MavMissionItemInt* item, WaypointRecord* record) {
+    if (!relativeFrame(item->frame)) return MAV_MISSION_UNSUPPORTED_FRAME;
+    if (item->x < -LAT_E7_MAX || item->x > LAT_E7_MAX) return MAV_MISSION_INVALID_PARAM5_X;
+    if (item->y < -LNG_E7_MAX || item->y > LNG_E7_MAX) return MAV_MISSION_INVALID_PARAM6_Y;
+    float dm = roundf(item->z * 10.0f);
+    if (!(dm >= INT16_MIN && dm <= INT16_MAX)) return MAV_MISSION_INVALID_PARAM7;
+    record->lat = item->x;
+    record->lng = item->y;
+    record->alt = (int16_t)dm;
+    return MAV_MISSION_ACCEPTED;
+}
+
+uint8_t MavMission_fromItem(const MavMissionItemInt* item, WaypointRecord* record) {
+    memset(record, 0, sizeof(*record));
+
+    switch (item->command) {
+        case MAV_CMD_NAV_WAYPOINT:
+            record->cmd = MISSION_CMD_WAYPOINT;
+            return positionItem(item, record);
+
+        case MAV_CMD_NAV_LOITER_TIME:
+            if (!(item->param1 >= 0.0f && item->param1 <= 65535.0f))
+                return MAV_MISSION_INVALID_PARAM1;
+            record->cmd = MISSION_CMD_LOITER;
+            record->param = (uint16_t)lroundf(item->param1);
+            return positionItem(item, record);
+
+        case MAV_CMD_NAV_RETURN_TO_LAUNCH:
+            if (!commandFrame(item->frame)) return MAV_MISSION_UNSUPPORTED_FRAME;
+            record->cmd = MISSION_CMD_RTL;
+            return MAV_MISSION_ACCEPTED;
+
+        case MAV_CMD_DO_JUMP:
+            if (!commandFrame(item->frame)) return MAV_MISSION_UNSUPPORTED_FRAME;
+            if (!(item->param1 >= 0.0f && item->param1 < 65535.0f))
+                return MAV_MISSION_INVALID_PARAM1;
+            // Our 0 is "forever"; a jump taken zero times has no item
+            if (item->param2 != -1.0f && !(item->param2 >= 1.0f && item->param2 <= 255.0f))
+                return MAV_MISSION_INVALID_PARAM2;
+            record->cmd = MISSION_CMD_JUMP;
+            record->param = (uint16_t)lroundf(item->param1);
+            record->arg = item->param2 < 0.0f ? 0 : (uint8_t)lroundf(item->param2);
+            return MAV_MISSION_ACCEPTED;
+
+        case MAV_CMD_DO_CHANGE_SPEED:
+            if (!commandFrame(item->frame)) return MAV_MISSION_UNSUPPORTED_FRAME;
+            if (!(item->param3 >= 0.0f && item->param3 <= 100.0f))
+                return MAV_MISSION_INVALID_PARAM3;
+            record->cmd = MISSION_CMD_SET_SPEED;
+            record->param = (uint16_t)(1000 + lroundf(item->param3 * 10.0f));
+            return MAV_MISSION_ACCEPTED;
+
+        case MAV_CMD_DO_CHANGE_ALTITUDE:
+            if (!commandFrame(item->frame)) return MAV_MISSION_UNSUPPORTED_FRAME;
+            if (!(item->param1 <= 0.0f && item->param1 >= INT16_MIN / 10.0f))
+                return MAV_MISSION_INVALID_PARAM1;
+            record->cmd = MISSION_CMD_SET_DEPTH;
+            record->alt = (int16_t)lroundf(-item->param1 * 10.0f);
+            return MAV_MISSION_ACCEPTED;
+
+        default:
+            return MAV_MISSION_UNSUPPORTED;
+    }
+}
+
+static void positionFields(const WaypointRecord* record, MavMissionItemInt* item) {
+    item->frame = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+    item->x = record->lat;
+    item->y = record->lng;
+    item->z = record->alt * 0.1f;
+}
+
+void MavMission_toItem(const WaypointRecord* record, uint16_t seq, MavMissionItemInt* item) {
+    memset(item, 0, sizeof(*item));
+    item->seq = seq;
+    item->autocontinue = 1;
+    item->frame = MAV_FRAME_MISSION;
+
+    switch (record->cmd) {
+        case MISSION_CMD_WAYPOINT:
+            item->command = MAV_CMD_NAV_WAYPOINT;
+            positionFields(record, item);
+            break;
+        case MISSION_CMD_LOITER:
+            item->command = MAV_CMD_NAV_LOITER_TIME;
+            item->param1 = record->param;
+            positionFields(record, item);
+            break;
+        case MISSION_CMD_SET_SPEED:
+            item->command = MAV_CMD_DO_CHANGE_SPEED;
+            item->param2 = -1.0f;
+            item->param3 = (record->param - 1000) * 0.1f;
+            item->param4 = -1.0f;
+            break;
+        case MISSION_CMD_SET_DEPTH:
+            item->command = MAV_CMD_DO_CHANGE_ALTITUDE;
+            item->param1 = -record->alt * 0.1f;
+            break;
+        case MISSION_CMD_JUMP:
+            item->command = MAV_CMD_DO_JUMP;
+            item->param1 = record->param;
+            item->param2 = record->arg == 0 ? -1.0f : record->arg;
+            break;
+        default:
+            item->command = MAV_CMD_NAV_RETURN_TO_LAUNCH;
+            break;
+    }
+}
+
+// ============================================================================
+// Upload
+// ============================================================================
+
+static MavMissionStep request(MavMissionUpload* up, uint32_t nowMs) {
+    up->requestMs = nowMs;
+    return MAV_MISSION_STEP_REQUEST;
+}
+
+static MavMissionStep abortWith(MavMissionUpload* up, uint8_t result) {
+    up->result = result;
+    up->active = false;
+    return MAV_MISSION_STEP_ABORT;
+}
+
+MavMissionStep MavMissionUpload_begin(MavMissionUpload* up, WaypointRecord* buffer,
+                                      uint16_t count, uint8_t peerSystem,
+                                      uint8_t peerComponent, uint32_t nowMs) {
+    memset(up, 0, sizeof(*up));
+    up->records = buffer;
+    up->count = count;
+    up->peerSystem = peerSystem;
+    up->peerComponent = peerComponent;
+    up->active = true;
+    return request(up, nowMs);
+}
+
+MavMissionStep MavMissionUpload_item(MavMissionUpload* up, const MavMissionItemInt* item,
+                                     uint32_t nowMs) {
+    if (!up->active) return MAV_MISSION_STEP_NONE;
+    if (item->seq != up->next) return request(up, nowMs);
+
+    WaypointRecord* record = &up->records[up->next];
+    uint8_t result = MavMission_fromItem(item, record);
+    if (result == MAV_MISSION_ACCEPTED && record->cmd == MISSION_CMD_JUMP &&
+        record->param >= up->count)
+        result = MAV_MISSION_INVALID_PARAM1;
+    if (result != MAV_MISSION_ACCEPTED) return abortWith(up, result);
+
+    up->retries = 0;
+    if (++up->next == up->count) return MAV_MISSION_STEP_COMPLETE;
+    return request(up, nowMs);
+}
+
+MavMissionStep MavMissionUpload_poll(MavMissionUpload* up, uint32_t nowMs) {
+    if (!up->active || nowMs - up->requestMs < MAV_MISSION_RETRY_MS)
+        return MAV_MISSION_STEP_NONE;
+    if (++up->retries > MAV_MISSION_RETRIES)
+        return abortWith(up, MAV_MISSION_OPERATION_CANCELLED);
+    return request(up, nowMs);
+}
+
+void MavMissionUpload_end(MavMissionUpload* up) {
+    up->active = false;
+}
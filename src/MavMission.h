@@ -0,0 +1,137 @@
+#ifndef MAV_MISSION_H
+#define MAV_MISSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MavLink.h"
+#include "MissionItem.h"
+
+/**
+ * MavMission - MAVLink mission protocol on top of the on-board items
+ *
+ * Item mapping (MISSION_ITEM_INT <-> WaypointRecord, MissionItem.h):
+ *
+ *   MAV_CMD                   frame   item        fields
+ *   NAV_WAYPOINT (16)         3 / 6   WAYPOINT    x, y, z m -> alt dm
+ *   NAV_LOITER_TIME (19)      3 / 6   LOITER      + param1 s -> hold
+ *   NAV_RETURN_TO_LAUNCH (20) any     RTL
+ *   DO_JUMP (177)             any     JUMP        param1 seq, param2
+ *                                                 repeats (-1 = forever)
+ *   DO_CHANGE_SPEED (178)     any     SET_SPEED   param3 throttle % ->
+ *                                                 1000 + 10 * % (PWM us)
+ *   DO_CHANGE_ALTITUDE (186)  any     SET_DEPTH   param1 m (<= 0, -depth)
+ *
+ * Altitudes are relative to home, so only the relative-altitude frames
+ * are taken for position items; "any" is those or 2 (MAV_FRAME_MISSION).
+ * A per-waypoint speed has no MAVLink field and is not downloaded.
+ *
+ * Upload: MISSION_COUNT opens a transfer into a caller buffer, the
+ * vehicle requests each item in order (MISSION_REQUEST_INT) and resends
+ * a request after MAV_MISSION_RETRY_MS, giving up after
+ * MAV_MISSION_RETRIES. The complete list goes to the mission store as
+ * one bulk upload, so the flying mission is replaced atomically or not
+ * at all. Download is stateless: every MISSION_REQUEST_INT is answered
+ * from the live mission.
+ *
+ * Pure: no globals, no I/O.
+ *
+ * @file MavMission.h
+ */
+
+#define MAV_MISSION_RETRY_MS        1500
+#define MAV_MISSION_RETRIES         5
+
+// MAV_CMD
+#define MAV_CMD_NAV_WAYPOINT            16
+#define MAV_CMD_NAV_LOITER_TIME         19
+#define MAV_CMD_NAV_RETURN_TO_LAUNCH    20
+#define MAV_CMD_DO_JUMP                 177
+#define MAV_CMD_DO_CHANGE_SPEED         178
+#define MAV_CMD_DO_CHANGE_ALTITUDE      186
+
+// MAV_FRAME
+#define MAV_FRAME_GLOBAL_RELATIVE_ALT       3
+#define MAV_FRAME_MISSION                   2
+#define MAV_FRAME_GLOBAL_RELATIVE_ALT_INT   6
+
+// MAV_MISSION_RESULT
+#define MAV_MISSION_ACCEPTED            0
+#define MAV_MISSION_ERROR               1
+#define MAV_MISSION_UNSUPPORTED_FRAME   2
+#define MAV_MISSION_UNSUPPORTED         3
+#define MAV_MISSION_NO_SPACE            4
+#define MAV_MISSION_INVALID_PARAM1      6
+#define MAV_MISSION_INVALID_PARAM2      7
+#define MAV_MISSION_INVALID_PARAM3      8
+#define MAV_MISSION_INVALID_PARAM5_X    10
+#define MAV_MISSION_INVALID_PARAM6_Y    11
+#define MAV_MISSION_INVALID_PARAM7      12
+#define MAV_MISSION_INVALID_SEQUENCE    13
+#define MAV_MISSION_DENIED              14
+#define MAV_MISSION_OPERATION_CANCELLED 15
+
+typedef enum {
+    MAV_MISSION_STEP_NONE = 0,
+    MAV_MISSION_STEP_REQUEST,   // Send MISSION_REQUEST_INT for up->next
+    MAV_MISSION_STEP_COMPLETE,  // All items in: commit up->records
+    MAV_MISSION_STEP_ABORT      // Send MISSION_ACK up->result, transfer closed
+} MavMissionStep;
+
+typedef struct {
+    WaypointRecord* records;    // Caller buffer, count entries
+    uint16_t count;
+    uint16_t next;              // Next item to request
+    uint8_t peerSystem;         // Ground station that opened the transfer
+    uint8_t peerComponent;
+    uint8_t retries;
+    uint8_t result;             // MAV_MISSION_RESULT for ABORT
+    uint32_t requestMs;         // Last request sent
+    bool active;
+} MavMissionUpload;
+
+// ============================================================================
+// Item Conversion
+// ============================================================================
+
+/**
+ * @return MAV_MISSION_ACCEPTED, or the reason the item cannot be stored
+ */
+uint8_t MavMission_fromItem(const MavMissionItemInt* item, WaypointRecord* record);
+
+/**
+ * Fill a MISSION_ITEM_INT from a stored item (targets left to the caller)
+ */
+void MavMission_toItem(const WaypointRecord* record, uint16_t seq, MavMissionItemInt* item);
+
+// ============================================================================
+// Upload
+// ============================================================================
+
+/**
+ * Open a transfer of count (> 0) items; replaces one in progress
+ * @return MAV_MISSION_STEP_REQUEST for item 0
+ */
+MavMissionStep MavMissionUpload_begin(MavMissionUpload* up, WaypointRecord* buffer,
+                                      uint16_t count, uint8_t peerSystem,
+                                      uint8_t peerComponent, uint32_t nowMs);
+
+/**
+ * Take a received MISSION_ITEM_INT
+ * An item other than the one requested is answered by requesting it
+ * again; an item that does not convert aborts the transfer.
+ */
+MavMissionStep MavMissionUpload_item(MavMissionUpload* up, const MavMissionItemInt* item,
+                                     uint32_t nowMs);
+
+/**
+ * Request timeout
+ * @return REQUEST to resend, ABORT (OPERATION_CANCELLED) once out of retries
+ */
+MavMissionStep MavMissionUpload_poll(MavMissionUpload* up, uint32_t nowMs);
+
+/**
+ * Close the transfer (after COMPLETE or when the ground station cancels)
+ */
+void MavMissionUpload_end(MavMissionUpload* up);
+
+#endif // MAV_MISSION_H
@@ -0,0 +1,205 @@
+#include "MemPlacement.h"
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * MemPlacement - Implementation
+ *
+ * The allocation itself runs outside the ledger lock (the heap has its
+ * own); only the table update is a critical section. A full table does
+ * not fail the allocation, the block is just counted as untracked.
+ *
+ * @file MemPlacement.cpp
+ */
+
+#if defined(__XTENSA__)
+#include <esp_heap_caps.h>
+#if __has_include(<esp_memory_utils.h>)
+#include <esp_memory_utils.h>
+#else
+#include <soc/soc_memory_layout.h>
+#endif
+#endif
+
+static MemPlacementEntry gEntries[MEM_PLACEMENT_MAX_ENTRIES];
+static MemPlacementStats gStats;
+static portMUX_TYPE gMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// Heap
+// ============================================================================
+
+#if defined(__XTENSA__)
+
+static void* heapAlloc(size_t size, MemClass memClass, bool* fellBack) {
+    switch (memClass) {
+        case MEM_CLASS_BULK: {
+            if (MemPlacement_hasPsram()) {
+                void* p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+                if (p) return p;
+                *fellBack = true;
+            }
+            return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        }
+        case MEM_CLASS_DMA:
+            return heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        default:
+            return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+}
+
+static void heapFree(void* ptr) {
+    heap_caps_free(ptr);
+}
+
+bool MemPlacement_hasPsram(void) {
+    return heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+}
+
+MemRegion MemPlacement_regionOf(const void* ptr) {
+    return esp_ptr_external_ram(ptr) ? MEM_REGION_PSRAM : MEM_REGION_INTERNAL;
+}
+
+void MemPlacement_getHeap(MemRegion region, uint32_t* freeBytes, uint32_t* totalBytes) {
+    uint32_t caps = region == MEM_REGION_PSRAM ? MALLOC_CAP_SPIRAM
+                                               : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    *freeBytes = heap_caps_get_free_size(caps);
+    *totalBytes = heap_caps_get_total_size(caps);
+}
+
+#else
+
+static void* heapAlloc(size_t size, MemClass memClass, bool* fellBack) {
+    (void)memClass;
+    (void)fellBack;
+    return malloc(size);
+}
+
+static void heapFree(void* ptr) {
+    free(ptr);
+}
+
+bool MemPlacement_hasPsram(void) {
+    return false;
+}
+
+MemRegion MemPlacement_regionOf(const void* ptr) {
+    (void)ptr;
+    return MEM_REGION_INTERNAL;
+}
+
+void MemPlacement_getHeap(MemRegion region, uint32_t* freeBytes, uint32_t* totalBytes) {
+    (void)region;
+    *freeBytes = 0;
+    *totalBytes = 0;
+}
+
+#endif
+
+// ============================================================================
+// Ledger
+// ============================================================================
+
+static void addEntry(const char* tag, const void* ptr, size_t size,
+                     MemClass memClass, bool heap) {
+    MemRegion region = MemPlacement_regionOf(ptr);
+    portENTER_CRITICAL(&gMux);
+    MemPlacementEntry* slot = NULL;
+    for (uint8_t i = 0; i < MEM_PLACEMENT_MAX_ENTRIES; i++) {
+        if (gEntries[i].ptr == NULL) {
+            slot = &gEntries[i];
+            break;
+        }
+    }
+    if (slot) {
+        slot->tag = tag;
+        slot->ptr = ptr;
+        slot->size = (uint32_t)size;
+        slot->memClass = (uint8_t)memClass;
+        slot->region = (uint8_t)region;
+        slot->heap = heap;
+        if (region == MEM_REGION_PSRAM) gStats.psramBytes += (uint32_t)size;
+        else gStats.internalBytes += (uint32_t)size;
+    } else {
+        gStats.untracked++;
+    }
+    portEXIT_CRITICAL(&gMux);
+}
+
+void* MemPlacement_alloc(const char* tag, size_t size, MemClass memClass) {
+    bool fellBack = false;
+    void* p = heapAlloc(size ? size : 1, memClass, &fellBack);
+    if (!p) {
+        portENTER_CRITICAL(&gMux);
+        gStats.failures++;
+        portEXIT_CRITICAL(&gMux);
+        return NULL;
+    }
+    if (fellBack) {
+        portENTER_CRITICAL(&gMux);
+        gStats.fallbacks++;
+        portEXIT_CRITICAL(&gMux);
+    }
+    addEntry(tag, p, size, memClass, true);
+    return p;
+}
+
+void MemPlacement_free(void* ptr) {
+    if (!ptr) return;
+    portENTER_CRITICAL(&gMux);
+    for (uint8_t i = 0; i < MEM_PLACEMENT_MAX_ENTRIES; i++) {
+        MemPlacementEntry* e = &gEntries[i];
+        if (e->ptr == ptr && e->heap) {
+            if (e->region == MEM_REGION_PSRAM) gStats.psramBytes -= e->size;
+            else gStats.internalBytes -= e->size;
+            memset(e, 0, sizeof(*e));
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&gMux);
+    heapFree(ptr);
+}
+
+void MemPlacement_note(const char* tag, const void* ptr, size_t size, MemClass memClass) {
+    // A module initialised again keeps its one entry
+    bool known = false;
+    portENTER_CRITICAL(&gMux);
+    for (uint8_t i = 0; i < MEM_PLACEMENT_MAX_ENTRIES; i++) {
+        if (gEntries[i].ptr == ptr) known = true;
+    }
+    portEXIT_CRITICAL(&gMux);
+    if (!known) addEntry(tag, ptr, size, memClass, false);
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+const char* MemPlacement_regionName(MemRegion region) {
+    return region == MEM_REGION_PSRAM ? "psram" : "internal";
+}
+
+uint8_t MemPlacement_getEntries(MemPlacementEntry* out, uint8_t max) {
+    uint8_t n = 0;
+    portENTER_CRITICAL(&gMux);
+    for (uint8_t i = 0; i < MEM_PLACEMENT_MAX_ENTRIES && n < max; i++) {
+        if (gEntries[i].ptr != NULL) out[n++] = gEntries[i];
+    }
+    portEXIT_CRITICAL(&gMux);
+    return n;
+}
+
+MemPlacementStats MemPlacement_getStats(void) {
+    portENTER_CRITICAL(&gMux);
+    MemPlacementStats s = gStats;
+    portEXIT_CRITICAL(&gMux);
+    return s;
+}
+
+void MemPlacement_reset(void) {
+    portENTER_CRITICAL(&gMux);
+    memset(gEntries, 0, sizeof(gEntries));
+    memset(&gStats, 0, sizeof(gStats));
+    portEXIT_CRITICAL(&gMux);
+}
@@ -0,0 +1,131 @@
+#ifndef MEM_PLACEMENT_H
+#define MEM_PLACEMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * MemPlacement - Where the large buffers live (internal DRAM / PSRAM)
+ *
+ * On a WROVER (or an S3 with octal PSRAM) internal DRAM is still the
+ * scarce part: WiFi, lwIP, the task stacks and every DMA descriptor must
+ * be there, and the bulk buffers that are only touched now and then -
+ * the OTA download and inflate window, the WebSocket frames, the mission
+ * store and its upload staging, the path planner scratch - would squeeze
+ * them. PSRAM is slower (through the same cache
+ * as flash, and unreachable while the cache is off for a flash write),
+ * so only buffers that no interrupt touches and that the control loop
+ * does not stream through every tick go there:
+ *
+ *   class     heap                                 without PSRAM
+ *   BULK      PSRAM first, internal if it is full  internal
+ *   INTERNAL  internal 8-bit (hot paths)           internal
+ *   DMA       internal DMA-capable                 internal DMA-capable
+ *
+ * Static buffers take BULK_BSS, which moves them to .ext_ram.bss when
+ * the SDK was built with CONFIG_SPIRAM_ALLOW_BSS_EXT_MEM and is empty
+ * otherwise (then they stay in internal .bss, as before). The log queue,
+ * trace rings and blackbox images stay internal on purpose: they are
+ * written at control rate.
+ *
+ * Every allocation made here and every static buffer registered with
+ * MemPlacement_note() goes into a small ledger with the region it really
+ * ended up in, printed at boot and in get_alloc.
+ *
+ * On the host every region is internal and the heap is malloc.
+ *
+ * @file MemPlacement.h
+ */
+
+#define MEM_PLACEMENT_MAX_ENTRIES 24
+
+#ifdef __XTENSA__
+#include <esp_attr.h>
+#endif
+
+#if defined(EXT_RAM_BSS_ATTR)
+#define BULK_BSS EXT_RAM_BSS_ATTR   // IDF 5
+#elif defined(EXT_RAM_ATTR)
+#define BULK_BSS EXT_RAM_ATTR       // IDF 4.4 (Arduino 2.x)
+#else
+#define BULK_BSS
+#endif
+
+typedef enum {
+    MEM_CLASS_BULK = 0,
+    MEM_CLASS_INTERNAL,
+    MEM_CLASS_DMA
+} MemClass;
+
+typedef enum {
+    MEM_REGION_INTERNAL = 0,
+    MEM_REGION_PSRAM
+} MemRegion;
+
+typedef struct {
+    const char* tag;            // Static string, e.g. "ota_dict"
+    const void* ptr;
+    uint32_t size;
+    uint8_t memClass;           // MemClass asked for
+    uint8_t region;             // MemRegion it landed in
+    bool heap;                  // Allocated here (else a noted static)
+} MemPlacementEntry;
+
+typedef struct {
+    uint32_t internalBytes;     // Ledger entries by region
+    uint32_t psramBytes;
+    uint32_t fallbacks;         // BULK allocations that found no PSRAM room
+    uint32_t failures;          // Allocations that returned NULL
+    uint32_t untracked;         // Ledger full: allocated but not listed
+} MemPlacementStats;
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+/**
+ * Allocate size bytes of the given class and record them under tag
+ * @return NULL if no region of the class has the room
+ */
+void* MemPlacement_alloc(const char* tag, size_t size, MemClass memClass);
+
+/**
+ * Free a block from MemPlacement_alloc() (NULL is ignored)
+ */
+void MemPlacement_free(void* ptr);
+
+/**
+ * Record a static buffer at init (again for the same buffer is a no-op)
+ */
+void MemPlacement_note(const char* tag, const void* ptr, size_t size, MemClass memClass);
+
+// ============================================================================
+// Report
+// ============================================================================
+
+bool MemPlacement_hasPsram(void);
+
+MemRegion MemPlacement_regionOf(const void* ptr);
+
+const char* MemPlacement_regionName(MemRegion region);
+
+/**
+ * Copy the ledger (live allocations and noted statics)
+ * @return entries copied
+ */
+uint8_t MemPlacement_getEntries(MemPlacementEntry* out, uint8_t max);
+
+MemPlacementStats MemPlacement_getStats(void);
+
+/**
+ * Free and total bytes of a region (PSRAM: 0 / 0 when there is none)
+ */
+void MemPlacement_getHeap(MemRegion region, uint32_t* freeBytes, uint32_t* totalBytes);
+
+/**
+ * Empty the ledger (tests)
+ */
+void MemPlacement_reset(void);
+
+#endif // MEM_PLACEMENT_H
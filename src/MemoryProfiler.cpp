@@ -1,14 +1,21 @@
 #include "MemoryProfiler.h"
+#include "HAL.h"
+#include "LoopTiming.h"
 #include <Arduino.h>
 #include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <stdio.h>
 #include <string.h>
 
 // Memory Profiler Configuration
 #define MAX_TRACKED_TASKS 20
+#define TASK_HASH_SIZE 32          // Power of two, > MAX_TRACKED_TASKS
 #define STATS_BUFFER_SIZE 256
 #define LOOP_FREQUENCY_TARGET 50   // 50Hz control loop
 #define LOOP_FREQUENCY_TOLERANCE 5 // +/- 5Hz acceptable
+#define ALLOC_SITE_TABLE_SIZE 64   // Power of two, open addressing
+#define STACK_SIZE_TABLE_SIZE 24   // Registered task stack sizes
 
 // Internal state
 static struct {
@@ -28,9 +35,13 @@ static struct {
   uint32_t loopIterations;
   uint32_t lastFrequencyCheckTime;
 
-  // Task tracking
+  // Task tracking: dense in registration order, hashIndex maps a name
+  // hash to slot + 1 (0 = empty). generation invalidates cached slots.
   TaskTimingInfo tasks[MAX_TRACKED_TASKS];
   uint8_t taskCount;
+  uint8_t hashIndex[TASK_HASH_SIZE];
+  uint32_t generation;
+  float usPerCycle;
 
   // Status string buffer
   char statusBuffer[STATS_BUFFER_SIZE];
@@ -44,13 +55,58 @@ static struct {
                    .minLoopTimeUs = UINT32_MAX,
                    .loopIterations = 0,
                    .lastFrequencyCheckTime = 0,
-                   .taskCount = 0};
+                   .taskCount = 0,
+                   .generation = 1};
+
+static portMUX_TYPE registryMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Allocation accounting: written from any task by the malloc wrappers
+typedef struct {
+  const char *tag; // Task name pointer (identity), NULL = empty
+  AllocSite site;
+} AllocEntry;
+
+static struct {
+  AllocEntry sites[ALLOC_SITE_TABLE_SIZE];
+  AllocStats stats;
+  const char *loopTag; // Task running MemoryProfiler_recordLoop()
+  uint32_t pendingLoopAllocs;
+} allocState;
+
+static portMUX_TYPE allocMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Task snapshot: written by MemoryProfiler_scanTasks() only. prevHandles /
+// prevRunTime belong to the previous scan (run time deltas)
+static struct {
+  struct {
+    const char *name;
+    uint32_t bytes;
+  } sizes[STACK_SIZE_TABLE_SIZE];
+  uint8_t sizeCount;
+
+  TaskStatus_t status[PROFILE_MAX_SYSTEM_TASKS];
+  TaskStackInfo tasks[PROFILE_MAX_SYSTEM_TASKS];
+  uint8_t taskCount;
+  TaskHandle_t prevHandles[PROFILE_MAX_SYSTEM_TASKS];
+  uint32_t prevRunTime[PROFILE_MAX_SYSTEM_TASKS];
+  uint8_t prevCount;
+  uint32_t prevTotalRunTime;
+
+  uint32_t stackUsed; // Totals over tasks with a registered size
+  uint32_t stackFree;
+} taskState;
 
 // Forward declarations
 static uint32_t getHeapSize(void);
 static uint32_t getHeapUsed(void);
-static uint32_t getStackUsed(void);
+static uint32_t registeredStackSize(const char *name);
 static uint32_t calculateFragmentation(void);
+static uint32_t hashName(const char *name);
+static int findTask(const char *name, uint32_t hash);
+static uint8_t registerLocked(const char *name);
+static void recordSample(TaskTimingInfo *task, float us);
+static const char *currentAllocTag(void);
+static AllocEntry *findAllocSite(uint32_t caller, const char *tag);
 
 /**
  * Initialize memory profiler
@@ -59,13 +115,16 @@ bool MemoryProfiler_init(void) {
   if (profilerState.initialized)
     return true;
 
-  // Initialize task array
-  memset(profilerState.tasks, 0, sizeof(profilerState.tasks));
-  profilerState.taskCount = 0;
+  // Registry is left alone: PROFILE_SCOPE sites may register before init
+#if defined(__XTENSA__)
+  profilerState.usPerCycle = 1.0f / getCpuFrequencyMhz();
+#else
+  profilerState.usPerCycle = 0.001f; // Host cycle counter is nanoseconds
+#endif
 
   // Initialize timing
-  profilerState.lastLoopStartTime = micros();
-  profilerState.lastFrequencyCheckTime = millis();
+  profilerState.lastLoopStartTime = HAL_GetMicros();
+  profilerState.lastFrequencyCheckTime = HAL_GetMillis();
 
   profilerState.initialized = true;
   Serial.println("[MemoryProfiler] Initialized");
@@ -82,7 +141,6 @@ MemoryStats MemoryProfiler_getMemoryStats(void) {
 
   uint32_t heapSize = getHeapSize();
   uint32_t heapUsed = getHeapUsed();
-  uint32_t stackUsed = getStackUsed();
   uint32_t largestFreeBlock =
       heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT);
   uint32_t fragmentation = calculateFragmentation();
@@ -92,18 +150,18 @@ MemoryStats MemoryProfiler_getMemoryStats(void) {
     profilerState.maxHeapUsed = heapUsed;
   }
 
-  uint32_t totalUsed = heapUsed + stackUsed;
-  uint32_t totalAvailable = heapSize + (8192); // Assume 8KB stack (ESP32)
-  float utilization = (totalUsed * 100.0f) / totalAvailable;
+  // Task stacks are allocated from the heap: already part of heapUsed.
+  // Stack figures come from the last MemoryProfiler_scanTasks()
+  float utilization = heapSize ? (heapUsed * 100.0f) / heapSize : 0.0f;
 
   return (MemoryStats){.heapSize = heapSize,
                        .heapUsed = heapUsed,
                        .largestFreeBlock = largestFreeBlock,
                        .fragmentationRatio = fragmentation,
-                       .stackUsed = stackUsed,
-                       .stackFree = (8192 - stackUsed),
-                       .totalMemoryUsed = totalUsed,
-                       .totalMemoryAvailable = totalAvailable,
+                       .stackUsed = taskState.stackUsed,
+                       .stackFree = taskState.stackFree,
+                       .totalMemoryUsed = heapUsed,
+                       .totalMemoryAvailable = heapSize,
                        .memoryUtilization = utilization};
 }
 
@@ -115,18 +173,28 @@ CPUStats MemoryProfiler_getCPUStats(void) {
     return (CPUStats){0};
   }
 
-  uint32_t now = millis();
+  uint32_t now = HAL_GetMillis();
   uint32_t elapsedMs = now - profilerState.lastFrequencyCheckTime;
 
   // Calculate loop frequency (100ms sample)
   float loopFrequency =
       profilerState.loopIterations * 1000.0f / (elapsedMs ? elapsedMs : 1);
 
-  // Estimate CPU load based on loop execution time
+  // Measured per-core load (idle hooks) when available: busiest core
+  float cpuLoad = -1.0f;
+  for (uint8_t core = 0; core < LOOP_TIMING_CORES; core++) {
+    float load = LoopTiming_getCoreLoad(core);
+    if (load > cpuLoad)
+      cpuLoad = load;
+  }
+
+  // Otherwise estimate from loop execution time
   // At 50Hz, each iteration should take ~20ms
   // If actual time is less, CPU has spare capacity
-  float cpuLoad = (profilerState.loopExecutionTimeUs / 20000.0f) * 100.0f;
-  cpuLoad = cpuLoad > 100.0f ? 100.0f : cpuLoad; // Cap at 100%
+  if (cpuLoad < 0.0f) {
+    cpuLoad = (profilerState.loopExecutionTimeUs / 20000.0f) * 100.0f;
+    cpuLoad = cpuLoad > 100.0f ? 100.0f : cpuLoad; // Cap at 100%
+  }
 
   return (CPUStats){.loopExecutionTimeUs = profilerState.loopExecutionTimeUs,
                     .maxLoopExecutionTimeUs = profilerState.maxLoopTimeUs,
@@ -136,6 +204,34 @@ CPUStats MemoryProfiler_getCPUStats(void) {
                     .loopFrequencyHz = (uint32_t)loopFrequency};
 }
 
+/**
+ * Record one control loop iteration
+ */
+void MemoryProfiler_recordLoop(uint32_t cycles) {
+  if (!profilerState.enabled || !profilerState.initialized)
+    return;
+
+  uint32_t us = (uint32_t)(cycles * profilerState.usPerCycle);
+  profilerState.loopExecutionTimeUs = us;
+  if (us > profilerState.maxLoopTimeUs)
+    profilerState.maxLoopTimeUs = us;
+  if (us < profilerState.minLoopTimeUs)
+    profilerState.minLoopTimeUs = us;
+  profilerState.loopIterations++;
+
+  // Allocations made by this task since the previous iteration
+  portENTER_CRITICAL(&allocMux);
+  allocState.loopTag = currentAllocTag();
+  uint32_t allocs = allocState.pendingLoopAllocs;
+  allocState.pendingLoopAllocs = 0;
+  allocState.stats.lastLoopAllocs = allocs;
+  if (allocs > allocState.stats.maxLoopAllocs)
+    allocState.stats.maxLoopAllocs = allocs;
+  if (allocs > 0)
+    allocState.stats.loopsWithAllocs++;
+  portEXIT_CRITICAL(&allocMux);
+}
+
 /**
  * Record task execution time
  */
@@ -144,36 +240,43 @@ void MemoryProfiler_recordTaskTime(const char *taskName,
   if (!profilerState.enabled || !profilerState.initialized)
     return;
 
-  // Find or create task entry
-  int taskIndex = -1;
-  for (int i = 0; i < profilerState.taskCount; i++) {
-    if (strcmp(profilerState.tasks[i].taskName, taskName) == 0) {
-      taskIndex = i;
-      break;
-    }
-  }
+  uint8_t slot = MemoryProfiler_registerTask(taskName);
+  if (slot != PROFILE_INVALID_SLOT)
+    recordSample(&profilerState.tasks[slot], (float)executionTimeUs);
+}
 
-  // Create new task entry if not found
-  if (taskIndex == -1 && profilerState.taskCount < MAX_TRACKED_TASKS) {
-    taskIndex = profilerState.taskCount++;
-    profilerState.tasks[taskIndex].taskName = taskName;
-    profilerState.tasks[taskIndex].maxExecutionTimeUs = 0;
-    profilerState.tasks[taskIndex].minExecutionTimeUs = UINT32_MAX;
-    profilerState.tasks[taskIndex].callCount = 0;
-  }
+/**
+ * Register a task name
+ */
+uint8_t MemoryProfiler_registerTask(const char *name) {
+  portENTER_CRITICAL(&registryMux);
+  uint8_t slot = registerLocked(name);
+  portEXIT_CRITICAL(&registryMux);
+  return slot;
+}
 
-  if (taskIndex >= 0 && taskIndex < MAX_TRACKED_TASKS) {
-    TaskTimingInfo *task = &profilerState.tasks[taskIndex];
-    task->executionTimeUs = executionTimeUs;
-    task->callCount++;
+/**
+ * Record one execution of a registered task
+ */
+void MemoryProfiler_recordCycles(uint8_t slot, uint32_t cycles) {
+  if (!profilerState.enabled || !profilerState.initialized ||
+      slot >= profilerState.taskCount)
+    return;
+  recordSample(&profilerState.tasks[slot], cycles * profilerState.usPerCycle);
+}
 
-    if (executionTimeUs > task->maxExecutionTimeUs) {
-      task->maxExecutionTimeUs = executionTimeUs;
-    }
-    if (executionTimeUs < task->minExecutionTimeUs) {
-      task->minExecutionTimeUs = executionTimeUs;
-    }
-  }
+/**
+ * Slot of a call site
+ */
+uint8_t MemoryProfiler_resolveSite(ProfileSite *site) {
+  if (site->generation == profilerState.generation)
+    return site->slot;
+
+  portENTER_CRITICAL(&registryMux);
+  site->slot = registerLocked(site->name);
+  site->generation = profilerState.generation;
+  portEXIT_CRITICAL(&registryMux);
+  return site->slot;
 }
 
 /**
@@ -190,6 +293,178 @@ TaskTimingInfo *MemoryProfiler_getTaskTiming(uint8_t index) {
  */
 uint8_t MemoryProfiler_getTaskCount(void) { return profilerState.taskCount; }
 
+/**
+ * Register the stack size of a task
+ */
+void MemoryProfiler_setTaskStackSize(const char *name, uint32_t stackBytes) {
+  portENTER_CRITICAL(&registryMux);
+  uint8_t i = 0;
+  while (i < taskState.sizeCount && strcmp(taskState.sizes[i].name, name) != 0)
+    i++;
+  if (i < STACK_SIZE_TABLE_SIZE) {
+    taskState.sizes[i].name = name;
+    taskState.sizes[i].bytes = stackBytes;
+    if (i == taskState.sizeCount)
+      taskState.sizeCount++;
+  }
+  portEXIT_CRITICAL(&registryMux);
+}
+
+/**
+ * Snapshot all FreeRTOS tasks
+ */
+uint8_t MemoryProfiler_scanTasks(void) {
+  // Copies the task list with the scheduler suspended; the high-water
+  // mark of each stack is found by scanning for the fill pattern
+  uint32_t totalRunTime = 0;
+  UBaseType_t n = uxTaskGetSystemState(taskState.status,
+                                       PROFILE_MAX_SYSTEM_TASKS, &totalRunTime);
+  uint32_t totalDelta = totalRunTime - taskState.prevTotalRunTime;
+  uint32_t stackUsed = 0;
+  uint32_t stackFree = 0;
+
+  for (UBaseType_t i = 0; i < n; i++) {
+    const TaskStatus_t *st = &taskState.status[i];
+    TaskStackInfo *info = &taskState.tasks[i];
+    memset(info, 0, sizeof(*info));
+    strncpy(info->name, st->pcTaskName, ALLOC_TASK_NAME_LEN - 1);
+
+    BaseType_t affinity = xTaskGetAffinity(st->xHandle);
+    info->core = affinity == tskNO_AFFINITY ? PROFILE_CORE_ANY : (uint8_t)affinity;
+    info->priority = (uint8_t)st->uxCurrentPriority;
+    info->state = (uint8_t)st->eCurrentState;
+    info->stackHighWater = st->usStackHighWaterMark;
+    info->runTime = st->ulRunTimeCounter;
+
+    for (uint8_t j = 0; j < taskState.prevCount; j++) {
+      if (taskState.prevHandles[j] == st->xHandle) {
+        uint32_t delta = info->runTime - taskState.prevRunTime[j];
+        info->cpuPercent = totalDelta ? delta * 100.0f / totalDelta : 0.0f;
+        break;
+      }
+    }
+
+    info->stackSize = registeredStackSize(info->name);
+    if (info->stackSize > info->stackHighWater) {
+      stackUsed += info->stackSize - info->stackHighWater;
+      stackFree += info->stackHighWater;
+    }
+  }
+
+  for (UBaseType_t i = 0; i < n; i++) {
+    taskState.prevHandles[i] = taskState.status[i].xHandle;
+    taskState.prevRunTime[i] = taskState.tasks[i].runTime;
+  }
+  taskState.prevCount = (uint8_t)n;
+  taskState.prevTotalRunTime = totalRunTime;
+  taskState.taskCount = (uint8_t)n;
+  taskState.stackUsed = stackUsed;
+  taskState.stackFree = stackFree;
+  return (uint8_t)n;
+}
+
+/**
+ * Get number of tasks in the last snapshot
+ */
+uint8_t MemoryProfiler_getSystemTaskCount(void) { return taskState.taskCount; }
+
+/**
+ * Get a task from the last snapshot
+ */
+const TaskStackInfo *MemoryProfiler_getSystemTask(uint8_t index) {
+  if (index >= taskState.taskCount)
+    return NULL;
+  return &taskState.tasks[index];
+}
+
+/**
+ * Count one allocation
+ */
+void MemoryProfiler_recordAlloc(uint32_t caller, uint32_t size, bool ok) {
+  if (!profilerState.enabled)
+    return;
+
+  const char *tag = currentAllocTag();
+  portENTER_CRITICAL(&allocMux);
+  if (!ok) {
+    allocState.stats.failedCount++;
+  } else {
+    allocState.stats.allocCount++;
+    allocState.stats.allocBytes += size;
+    if (tag == allocState.loopTag)
+      allocState.pendingLoopAllocs++;
+
+    AllocEntry *entry = findAllocSite(caller, tag);
+    if (entry) {
+      entry->site.count++;
+      entry->site.bytes += size;
+    } else {
+      allocState.stats.untrackedCount++;
+    }
+  }
+  portEXIT_CRITICAL(&allocMux);
+}
+
+/**
+ * Count one free
+ */
+void MemoryProfiler_recordFree(void) {
+  if (!profilerState.enabled)
+    return;
+  portENTER_CRITICAL(&allocMux);
+  allocState.stats.freeCount++;
+  portEXIT_CRITICAL(&allocMux);
+}
+
+/**
+ * Get allocation statistics
+ */
+AllocStats MemoryProfiler_getAllocStats(void) {
+  portENTER_CRITICAL(&allocMux);
+  AllocStats stats = allocState.stats;
+  portEXIT_CRITICAL(&allocMux);
+#if defined(MEMORY_PROFILER_ALLOC_TRACKING)
+  stats.tracking = true;
+#endif
+  return stats;
+}
+
+/**
+ * Get the busiest allocation sites
+ */
+uint8_t MemoryProfiler_getTopAllocSites(AllocSite *out, uint8_t maxSites) {
+  // Selection by count, one pass per output slot; entries are copied
+  // under the lock so a concurrent allocation cannot tear them
+  uint8_t n = 0;
+  uint32_t prevCount = UINT32_MAX;
+  int prevIndex = -1;
+  while (n < maxSites) {
+    int best = -1;
+    portENTER_CRITICAL(&allocMux);
+    for (int i = 0; i < ALLOC_SITE_TABLE_SIZE; i++) {
+      const AllocEntry *e = &allocState.sites[i];
+      if (e->tag == NULL)
+        continue;
+      // Strictly after the previous pick in (count desc, index asc) order
+      uint32_t c = e->site.count;
+      if (c > prevCount || (c == prevCount && i <= prevIndex))
+        continue;
+      if (best < 0 || c > allocState.sites[best].site.count)
+        best = i;
+    }
+    if (best >= 0)
+      out[n] = allocState.sites[best].site;
+    portEXIT_CRITICAL(&allocMux);
+
+    if (best < 0)
+      break;
+    prevCount = out[n].count;
+    prevIndex = best;
+    n++;
+  }
+  return n;
+}
+
 /**
  * Calculate recommended buffer optimizations
  */
@@ -254,9 +529,18 @@ void MemoryProfiler_reset(void) {
   profilerState.loopIterations = 0;
   profilerState.maxLoopTimeUs = 0;
   profilerState.minLoopTimeUs = UINT32_MAX;
+  portENTER_CRITICAL(&registryMux);
   profilerState.taskCount = 0;
   memset(profilerState.tasks, 0, sizeof(profilerState.tasks));
-  profilerState.lastFrequencyCheckTime = millis();
+  memset(profilerState.hashIndex, 0, sizeof(profilerState.hashIndex));
+  profilerState.generation++; // PROFILE_SCOPE sites register again
+  portEXIT_CRITICAL(&registryMux);
+  portENTER_CRITICAL(&allocMux);
+  memset(allocState.sites, 0, sizeof(allocState.sites));
+  memset(&allocState.stats, 0, sizeof(allocState.stats));
+  allocState.pendingLoopAllocs = 0;
+  portEXIT_CRITICAL(&allocMux);
+  profilerState.lastFrequencyCheckTime = HAL_GetMillis();
 }
 
 /**
@@ -306,16 +590,19 @@ static uint32_t getHeapUsed(void) {
 }
 
 /**
- * Get stack used (approximate)
+ * Registered stack size of a task, 0 if unknown
  */
-static uint32_t getStackUsed(void) {
-  // Get current stack pointer
-  volatile uint32_t sp;
-  asm("mov %0, sp" : "=r"(sp));
-
-  // ESP32 stack grows downward from high address
-  // This is a rough estimate
-  return (8192 - (sp & 0x1FFF)) / 8192; // Return as rough percentage
+static uint32_t registeredStackSize(const char *name) {
+  uint32_t bytes = 0;
+  portENTER_CRITICAL(&registryMux);
+  for (uint8_t i = 0; i < taskState.sizeCount; i++) {
+    if (strcmp(taskState.sizes[i].name, name) == 0) {
+      bytes = taskState.sizes[i].bytes;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&registryMux);
+  return bytes;
 }
 
 /**
@@ -334,3 +621,194 @@ static uint32_t calculateFragmentation(void) {
   uint32_t fragmented = heapFree - largestFree;
   return (fragmented * 100) / heapFree;
 }
+
+/**
+ * FNV-1a hash of a task name
+ */
+static uint32_t hashName(const char *name) {
+  uint32_t h = 2166136261u;
+  while (*name) {
+    h ^= (uint8_t)*name++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/**
+ * Slot of a registered name (linear probing), -1 if not registered
+ */
+static int findTask(const char *name, uint32_t hash) {
+  for (uint32_t i = 0; i < TASK_HASH_SIZE; i++) {
+    uint8_t entry = profilerState.hashIndex[(hash + i) & (TASK_HASH_SIZE - 1)];
+    if (entry == 0)
+      return -1;
+    const char *known = profilerState.tasks[entry - 1].taskName;
+    if (known == name || strcmp(known, name) == 0)
+      return entry - 1;
+  }
+  return -1;
+}
+
+/**
+ * Find or create a task entry (registryMux held)
+ */
+static uint8_t registerLocked(const char *name) {
+  uint32_t hash = hashName(name);
+  int found = findTask(name, hash);
+  if (found >= 0)
+    return (uint8_t)found;
+  if (profilerState.taskCount >= MAX_TRACKED_TASKS)
+    return PROFILE_INVALID_SLOT;
+
+  uint8_t slot = profilerState.taskCount;
+  TaskTimingInfo *task = &profilerState.tasks[slot];
+  memset(task, 0, sizeof(*task));
+  task->taskName = name;
+  task->minExecutionTimeUs = UINT32_MAX;
+
+  uint32_t i = hash;
+  while (profilerState.hashIndex[i & (TASK_HASH_SIZE - 1)] != 0)
+    i++;
+  profilerState.hashIndex[i & (TASK_HASH_SIZE - 1)] = slot + 1;
+  profilerState.taskCount++; // Publish last: recorders check slot < count
+  return slot;
+}
+
+/**
+ * Fold one sample into a task's min / max / mean / EWMA
+ */
+static void recordSample(TaskTimingInfo *task, float us) {
+  uint32_t whole = (uint32_t)us;
+  task->executionTimeUs = whole;
+  task->callCount++;
+
+  if (whole > task->maxExecutionTimeUs) {
+    task->maxExecutionTimeUs = whole;
+  }
+  if (whole < task->minExecutionTimeUs) {
+    task->minExecutionTimeUs = whole;
+  }
+
+  task->meanExecutionTimeUs += (us - task->meanExecutionTimeUs) / task->callCount;
+  if (task->callCount == 1) {
+    task->ewmaExecutionTimeUs = us;
+  } else {
+    task->ewmaExecutionTimeUs +=
+        PROFILE_EWMA_ALPHA * (us - task->ewmaExecutionTimeUs);
+  }
+}
+
+/**
+ * Allocation tag of the calling task (its name pointer)
+ */
+static const char *currentAllocTag(void) {
+#if defined(__XTENSA__)
+  // Global constructors allocate before the scheduler has a current task
+  if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+    return "boot";
+  return pcTaskGetName(NULL);
+#else
+  return "host";
+#endif
+}
+
+/**
+ * Find or create the entry of a call site (allocMux held)
+ * @return Entry, or NULL if the table is full
+ */
+static AllocEntry *findAllocSite(uint32_t caller, const char *tag) {
+  uint32_t h = (caller ^ (uint32_t)(uintptr_t)tag) * 2654435761u;
+  for (uint32_t i = 0; i < ALLOC_SITE_TABLE_SIZE; i++) {
+    AllocEntry *e = &allocState.sites[(h + i) & (ALLOC_SITE_TABLE_SIZE - 1)];
+    if (e->tag == NULL) {
+      e->tag = tag;
+      e->site.caller = caller;
+      strncpy(e->site.task, tag, ALLOC_TASK_NAME_LEN - 1);
+      allocState.stats.siteCount++;
+      return e;
+    }
+    if (e->site.caller == caller && e->tag == tag)
+      return e;
+  }
+  return NULL;
+}
+
+// ============================================================================
+// Allocation Hooks (-Wl,--wrap, see env:esp32dev_alloc)
+// ============================================================================
+
+#if defined(MEMORY_PROFILER_ALLOC_TRACKING) && defined(__XTENSA__)
+
+// Windowed ABI: the top two bits of a0 hold the caller's window size
+#define ALLOC_CALLER()                                                         \
+  (((uint32_t)(uintptr_t)__builtin_return_address(0) & 0x3FFFFFFFu) | 0x40000000u)
+
+// operator new calls malloc: count the new, not the nested malloc
+static __thread uint8_t allocDepth = 0;
+
+struct AllocDepthGuard {
+  AllocDepthGuard() { allocDepth++; }
+  ~AllocDepthGuard() { allocDepth--; } // Also when new throws
+};
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+void *__real__Znwj(size_t size);
+void *__real__Znaj(size_t size);
+
+void *__wrap_malloc(size_t size) {
+  void *p = __real_malloc(size);
+  if (allocDepth == 0)
+    MemoryProfiler_recordAlloc(ALLOC_CALLER(), size, p != NULL);
+  return p;
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  void *p = __real_calloc(n, size);
+  if (allocDepth == 0)
+    MemoryProfiler_recordAlloc(ALLOC_CALLER(), n * size, p != NULL);
+  return p;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  void *p = __real_realloc(ptr, size);
+  if (allocDepth == 0) {
+    if (size > 0)
+      MemoryProfiler_recordAlloc(ALLOC_CALLER(), size, p != NULL);
+    if (ptr && (p || size == 0))
+      MemoryProfiler_recordFree();
+  }
+  return p;
+}
+
+void __wrap_free(void *ptr) {
+  if (ptr)
+    MemoryProfiler_recordFree();
+  __real_free(ptr);
+}
+
+void *__wrap__Znwj(size_t size) {
+  void *p;
+  {
+    AllocDepthGuard guard;
+    p = __real__Znwj(size);
+  }
+  MemoryProfiler_recordAlloc(ALLOC_CALLER(), size, true);
+  return p;
+}
+
+void *__wrap__Znaj(size_t size) {
+  void *p;
+  {
+    AllocDepthGuard guard;
+    p = __real__Znaj(size);
+  }
+  MemoryProfiler_recordAlloc(ALLOC_CALLER(), size, true);
+  return p;
+}
+}
+
+#endif
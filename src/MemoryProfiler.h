@@ -9,15 +9,51 @@
  * 
  * Features:
  * - Heap fragmentation analysis
- * - Stack usage tracking
+ * - Stack high-water marks, run time and core of every FreeRTOS task
  * - Task timing analysis
  * - Memory statistics collection
  * - Buffer optimization recommendations
  * - CPU load percentage
+ * - Heap allocation accounting (esp32dev_alloc build)
+ *
+ * Task timing: call sites register a name once and record by slot, so a
+ * sample costs a handful of arithmetic ops (no string compare). The
+ * PROFILE_SCOPE("name") macro does both, timing the enclosing scope with
+ * the CPU cycle counter:
+ *
+ *   void navTick() {
+ *       PROFILE_SCOPE("nav_update");
+ *       ...
+ *   }
+ *
+ * MemoryProfiler_recordTaskTime(name, us) still works; it finds the slot
+ * through a hash index instead of scanning every entry.
+ *
+ * Allocation accounting: with MEMORY_PROFILER_ALLOC_TRACKING the link
+ * wraps malloc / calloc / realloc / free and operator new / new[]
+ * (env:esp32dev_alloc in platformio.ini). Each allocation is counted
+ * against its call site (return address, resolve with addr2line) and
+ * the allocating task; allocations made by the control loop's task
+ * between two MemoryProfiler_recordLoop() calls are counted per
+ * iteration, so a steady-state loop should report zero.
+ *
+ * Task stacks: MemoryProfiler_scanTasks() walks uxTaskGetSystemState()
+ * (suspends the scheduler while it copies the task list; call it at
+ * ~1 Hz, not from the control loop). FreeRTOS does not expose stack
+ * sizes, so task creators register them with
+ * MemoryProfiler_setTaskStackSize(); the high-water mark is reported
+ * for every task either way.
  * 
  * @file MemoryProfiler.h
  */
 
+#define PROFILE_INVALID_SLOT 0xFF
+#define PROFILE_EWMA_ALPHA 0.125f   // Weight of the newest sample
+#define ALLOC_TASK_NAME_LEN 16      // configMAX_TASK_NAME_LEN
+#define ALLOC_TOP_SITES 10          // Sites reported by get_alloc
+#define PROFILE_MAX_SYSTEM_TASKS 32 // Tasks listed by MemoryProfiler_scanTasks()
+#define PROFILE_CORE_ANY 0xFF       // Task not pinned to a core
+
 /**
  * Memory Statistics Structure
  */
@@ -26,10 +62,10 @@ typedef struct {
     uint32_t heapUsed;              // Current heap used (bytes)
     uint32_t largestFreeBlock;      // Largest contiguous free block (bytes)
     uint32_t fragmentationRatio;    // Fragmentation % (0-100)
-    uint32_t stackUsed;             // Stack memory used (bytes)
-    uint32_t stackFree;             // Stack memory free (bytes)
-    uint32_t totalMemoryUsed;       // Heap + stack used (bytes)
-    uint32_t totalMemoryAvailable;  // Heap + stack total (bytes)
+    uint32_t stackUsed;             // Peak stack use, tasks with a known size (bytes)
+    uint32_t stackFree;             // Never-touched stack, same tasks (bytes)
+    uint32_t totalMemoryUsed;       // Heap used, task stacks included (bytes)
+    uint32_t totalMemoryAvailable;  // Heap total (bytes)
     float memoryUtilization;        // Memory usage % (0-100.0)
 } MemoryStats;
 
@@ -40,7 +76,7 @@ typedef struct {
     uint32_t loopExecutionTimeUs;   // Time to execute one control loop (microseconds)
     uint32_t maxLoopExecutionTimeUs;// Maximum loop execution time (microseconds)
     uint32_t minLoopExecutionTimeUs;// Minimum loop execution time (microseconds)
-    float cpuLoadPercent;           // Estimated CPU load (0-100.0)
+    float cpuLoadPercent;           // Busiest core (idle hooks), else loop time / 20ms
     uint32_t loopIterations;        // Total number of loop iterations
     uint32_t loopFrequencyHz;       // Measured loop frequency (should be ~50Hz)
 } CPUStats;
@@ -55,8 +91,60 @@ typedef struct {
     uint32_t callCount;             // Number of times called
     uint32_t maxExecutionTimeUs;    // Maximum execution time
     uint32_t minExecutionTimeUs;    // Minimum execution time
+    float meanExecutionTimeUs;      // Running mean over all calls
+    float ewmaExecutionTimeUs;      // Exponentially weighted (PROFILE_EWMA_ALPHA)
 } TaskTimingInfo;
 
+/**
+ * Call site of PROFILE_SCOPE (static, zero-cost after the first call)
+ * The slot is re-resolved when MemoryProfiler_reset() clears the registry.
+ */
+typedef struct {
+    const char* name;
+    uint8_t slot;
+    uint32_t generation;
+} ProfileSite;
+
+/**
+ * FreeRTOS task snapshot (MemoryProfiler_scanTasks)
+ */
+typedef struct {
+    char name[ALLOC_TASK_NAME_LEN];
+    uint8_t core;                   // Pinned core, PROFILE_CORE_ANY if unpinned
+    uint8_t priority;               // Current priority
+    uint8_t state;                  // eTaskState
+    uint32_t stackSize;             // Bytes, 0 if not registered
+    uint32_t stackHighWater;        // Minimum free stack since creation (bytes)
+    uint32_t runTime;               // Run time counter, 0 without run time stats
+    float cpuPercent;               // Share of one core since the previous scan
+} TaskStackInfo;
+
+/**
+ * Allocation call site (one per return address and task)
+ */
+typedef struct {
+    uint32_t caller;                // Return address of malloc / new
+    char task[ALLOC_TASK_NAME_LEN]; // Allocating task
+    uint32_t count;                 // Allocations
+    uint32_t bytes;                 // Bytes requested (total)
+} AllocSite;
+
+/**
+ * Allocation Statistics Structure
+ */
+typedef struct {
+    bool tracking;                  // Built with MEMORY_PROFILER_ALLOC_TRACKING
+    uint32_t allocCount;            // Successful allocations
+    uint32_t freeCount;             // Non-NULL frees
+    uint32_t allocBytes;            // Bytes requested (total)
+    uint32_t failedCount;           // Allocations that returned NULL
+    uint32_t siteCount;             // Distinct call sites
+    uint32_t untrackedCount;        // Allocations from sites beyond the table
+    uint32_t lastLoopAllocs;        // Control loop task, last iteration
+    uint32_t maxLoopAllocs;         // Control loop task, worst iteration
+    uint32_t loopsWithAllocs;       // Iterations that allocated at all
+} AllocStats;
+
 /**
  * Initialize memory profiler
  * @return true if initialization successful
@@ -75,6 +163,12 @@ MemoryStats MemoryProfiler_getMemoryStats(void);
  */
 CPUStats MemoryProfiler_getCPUStats(void);
 
+/**
+ * Record one control loop iteration (feeds CPUStats)
+ * @param cycles Loop execution time in CPU cycles (PROFILE_CYCLES() difference)
+ */
+void MemoryProfiler_recordLoop(uint32_t cycles);
+
 /**
  * Record task execution time
  * @param taskName Name of task (for reporting)
@@ -82,6 +176,27 @@ CPUStats MemoryProfiler_getCPUStats(void);
  */
 void MemoryProfiler_recordTaskTime(const char* taskName, uint32_t executionTimeUs);
 
+/**
+ * Register a task name (once per call site)
+ * @param name Name of task; must outlive the profiler (string literal)
+ * @return Slot for MemoryProfiler_recordCycles(), PROFILE_INVALID_SLOT if full
+ */
+uint8_t MemoryProfiler_registerTask(const char* name);
+
+/**
+ * Record one execution of a registered task (constant time)
+ * @param slot Slot from MemoryProfiler_registerTask()
+ * @param cycles Duration in CPU cycles (PROFILE_CYCLES() difference)
+ */
+void MemoryProfiler_recordCycles(uint8_t slot, uint32_t cycles);
+
+/**
+ * Slot of a call site, registering it on first use or after a reset
+ * @param site Static call site (see PROFILE_SCOPE)
+ * @return Slot, PROFILE_INVALID_SLOT if the registry is full
+ */
+uint8_t MemoryProfiler_resolveSite(ProfileSite* site);
+
 /**
  * Get task timing information by index
  * @param index Task index (0 to N-1)
@@ -95,6 +210,58 @@ TaskTimingInfo* MemoryProfiler_getTaskTiming(uint8_t index);
  */
 uint8_t MemoryProfiler_getTaskCount(void);
 
+/**
+ * Register the stack size of a task (FreeRTOS only knows the high-water mark)
+ * @param name Task name as passed to xTaskCreate (static string)
+ * @param stackBytes Stack size in bytes
+ */
+void MemoryProfiler_setTaskStackSize(const char* name, uint32_t stackBytes);
+
+/**
+ * Snapshot all FreeRTOS tasks (stack high-water mark, run time, core)
+ * @return Number of tasks listed
+ */
+uint8_t MemoryProfiler_scanTasks(void);
+
+/**
+ * Get number of tasks in the last snapshot
+ */
+uint8_t MemoryProfiler_getSystemTaskCount(void);
+
+/**
+ * Get a task from the last snapshot
+ * @param index Task index (0 to N-1)
+ * @return Task info, or NULL if index out of bounds
+ */
+const TaskStackInfo* MemoryProfiler_getSystemTask(uint8_t index);
+
+/**
+ * Count one allocation (called by the malloc / new wrappers)
+ * @param caller Return address of the allocation call
+ * @param size Bytes requested
+ * @param ok false if the allocation failed
+ */
+void MemoryProfiler_recordAlloc(uint32_t caller, uint32_t size, bool ok);
+
+/**
+ * Count one free of a non-NULL pointer
+ */
+void MemoryProfiler_recordFree(void);
+
+/**
+ * Get allocation statistics
+ * @return AllocStats structure with current values
+ */
+AllocStats MemoryProfiler_getAllocStats(void);
+
+/**
+ * Get the busiest allocation sites
+ * @param out Output array, sorted by allocation count (highest first)
+ * @param maxSites Output capacity
+ * @return Number of sites written
+ */
+uint8_t MemoryProfiler_getTopAllocSites(AllocSite* out, uint8_t maxSites);
+
 /**
  * Calculate recommended buffer optimizations
  * @return Recommendation string (e.g., "Reduce serial buffer by 512 bytes")
@@ -142,4 +309,49 @@ void MemoryProfiler_setEnabled(bool enabled);
  */
 bool MemoryProfiler_isEnabled(void);
 
+// ============================================================================
+// Scope Timer
+// ============================================================================
+
+// Cycle counter: CCOUNT on Xtensa, nanoseconds on host builds
+#if defined(__XTENSA__)
+#include <xtensa/hal.h>
+#define PROFILE_CYCLES() xthal_get_ccount()
+#else
+#include <time.h>
+static inline uint32_t profile_host_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#define PROFILE_CYCLES() profile_host_cycles()
+#endif
+
+#ifdef __cplusplus
+/**
+ * Records the lifetime of the enclosing scope (use PROFILE_SCOPE)
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileSite* site)
+        : _slot(MemoryProfiler_resolveSite(site)), _start(PROFILE_CYCLES()) {}
+    ~ProfileScope() { MemoryProfiler_recordCycles(_slot, PROFILE_CYCLES() - _start); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    uint8_t _slot;
+    uint32_t _start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name)                                                    \
+    static ProfileSite PROFILE_CONCAT(_profileSite, __LINE__) = {              \
+        name, PROFILE_INVALID_SLOT, 0};                                        \
+    ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(                      \
+        &PROFILE_CONCAT(_profileSite, __LINE__))
+#endif
+
 #endif // MEMORY_PROFILER_H
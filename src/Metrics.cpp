@@ -0,0 +1,296 @@
+#include "Metrics.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Metrics - Implementation
+ *
+ * A line is a pure function of (snapshot, metric, line index), so the
+ * cursor only records where it stopped; a line cut by a full TCP buffer
+ * is rendered again on the next call and sent from its offset.
+ *
+ * @file Metrics.cpp
+ */
+
+typedef enum {
+    METRIC_U32,
+    METRIC_I32,
+    METRIC_U64,
+    METRIC_F32
+} MetricValueType;
+
+typedef enum {
+    METRIC_LABELS_NONE,
+    METRIC_LABELS_CORE,
+    METRIC_LABELS_TASK,
+    METRIC_LABELS_RX_STAGE
+} MetricLabels;
+
+typedef struct {
+    const char* name;
+    const char* help;
+    const char* type;           // "counter" / "gauge"
+    uint8_t valueType;          // MetricValueType
+    uint8_t labels;             // MetricLabels
+    uint16_t offset;            // First sample in MetricsSnapshot
+} MetricDef;
+
+#define FIELD(f) ((uint16_t)offsetof(MetricsSnapshot, f))
+#define COUNTER "counter"
+#define GAUGE   "gauge"
+
+static const MetricDef METRICS[] = {
+    {"na_uptime_seconds", "Time since boot", COUNTER, METRIC_U32, METRIC_LABELS_NONE, FIELD(uptimeS)},
+
+    {"na_heap_free_bytes", "Free heap", GAUGE, METRIC_U32, METRIC_LABELS_NONE, FIELD(heapFree)},
+    {"na_heap_min_free_bytes", "Lowest free heap since boot", GAUGE, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(heapMinFree)},
+    {"na_heap_largest_block_bytes", "Largest free heap block", GAUGE, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(heapLargestBlock)},
+    {"na_heap_size_bytes", "Total heap", GAUGE, METRIC_U32, METRIC_LABELS_NONE, FIELD(heapSize)},
+
+    {"na_cpu_load_ratio", "Busy fraction of each core", GAUGE, METRIC_F32, METRIC_LABELS_CORE,
+     FIELD(coreLoad)},
+    {"na_loop_max_us", "Worst control loop execution time", GAUGE, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(loopMaxUs)},
+    {"na_task_runs_total", "Completed task releases", COUNTER, METRIC_U32, METRIC_LABELS_TASK,
+     FIELD(taskRuns)},
+    {"na_task_overruns_total", "Releases that exceeded the task period", COUNTER, METRIC_U32,
+     METRIC_LABELS_TASK, FIELD(taskOverruns)},
+    {"na_task_exec_max_us", "Worst task body execution time", GAUGE, METRIC_U32,
+     METRIC_LABELS_TASK, FIELD(taskExecMaxUs)},
+    {"na_task_jitter_max_us", "Worst task release jitter", GAUGE, METRIC_U32, METRIC_LABELS_TASK,
+     FIELD(taskJitterMaxUs)},
+
+    {"na_ratelimit_allowed_total", "Commands admitted by the rate limiter", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(rateAllowed)},
+    {"na_ratelimit_blocked_total", "Commands rejected by the rate limiter", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(rateBlocked)},
+    {"na_ratelimit_peer_blocked_total", "Commands rejected by a peer bucket", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(ratePeerBlocked)},
+    {"na_ratelimit_class_blocked_total", "Commands rejected by a class bucket", COUNTER,
+     METRIC_U32, METRIC_LABELS_NONE, FIELD(rateClassBlocked)},
+
+    {"na_rx_passed_total", "Radio frames accepted by the receive filter", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(rxPassed)},
+    {"na_rx_rejected_total", "Radio frames rejected before decryption", COUNTER, METRIC_U32,
+     METRIC_LABELS_RX_STAGE, FIELD(rxRejected)},
+
+    {"na_failsafe_state", "0 idle, 1 armed, 2 signal loss, 3 emergency", GAUGE, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(failsafeState)},
+    {"na_failsafe_packets_total", "Control packets seen by the failsafe", COUNTER,
+     METRIC_U32, METRIC_LABELS_NONE, FIELD(failsafePackets)},
+    {"na_failsafe_bad_hmac_total", "Packets with an invalid HMAC", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(failsafeBadHmac)},
+    {"na_failsafe_critical_fault", "1 = vehicle fault forcing the failsafe (Sub leak)", GAUGE,
+     METRIC_U32, METRIC_LABELS_NONE, FIELD(failsafeFault)},
+
+    {"na_link_rssi_dbm", "Received signal strength", GAUGE, METRIC_I32, METRIC_LABELS_NONE,
+     FIELD(linkRssiDbm)},
+    {"na_link_quality_percent", "Link quality", GAUGE, METRIC_U32, METRIC_LABELS_NONE,
+     FIELD(linkQuality)},
+    {"na_link_received_total", "Frames with a new sequence number", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(linkReceived)},
+    {"na_link_lost_total", "Sequence numbers never received", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(linkLost)},
+    {"na_link_duplicates_total", "Frames received twice", COUNTER, METRIC_U32, METRIC_LABELS_NONE,
+     FIELD(linkDuplicates)},
+
+    {"na_crypto_aes_calls_total", "AES-CTR invocations", COUNTER, METRIC_U32, METRIC_LABELS_NONE,
+     FIELD(cryptoAesCalls)},
+    {"na_crypto_aes_bytes_total", "Bytes processed by AES-CTR", COUNTER, METRIC_U64,
+     METRIC_LABELS_NONE, FIELD(cryptoAesBytes)},
+    {"na_crypto_sha_calls_total", "HMAC-SHA256 invocations", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(cryptoShaCalls)},
+    {"na_crypto_sha_bytes_total", "Bytes authenticated by HMAC-SHA256", COUNTER, METRIC_U64,
+     METRIC_LABELS_NONE, FIELD(cryptoShaBytes)},
+
+    {"na_ota_status", "0 idle, 1 downloading, 2 verifying, 3 flashing, 4 success, 5 error, "
+     "6 rollback", GAUGE, METRIC_U32, METRIC_LABELS_NONE, FIELD(otaStatus)},
+    {"na_ota_attempts_total", "Firmware updates started", COUNTER, METRIC_U32, METRIC_LABELS_NONE,
+     FIELD(otaAttempts)},
+    {"na_ota_success_total", "Firmware updates completed", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(otaSuccess)},
+    {"na_ota_failed_total", "Firmware updates failed", COUNTER, METRIC_U32, METRIC_LABELS_NONE,
+     FIELD(otaFailed)},
+    {"na_ota_rollbacks_total", "Firmware rollbacks", COUNTER, METRIC_U32, METRIC_LABELS_NONE,
+     FIELD(otaRollbacks)},
+
+    {"na_log_dropped_total", "Serial log messages dropped on a full queue", COUNTER, METRIC_U32,
+     METRIC_LABELS_NONE, FIELD(logDropped)},
+};
+
+#define METRIC_COUNT (sizeof(METRICS) / sizeof(METRICS[0]))
+
+// Receive filter stages, RX_FILTER_LENGTH onwards
+static const char* const RX_STAGE_NAMES[METRICS_RX_STAGES] = {
+    "length", "format", "source", "checksum", "sequence", "rate"
+};
+static const char* const CORE_NAMES[METRICS_CORES] = {"0", "1"};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint16_t sample_count(const MetricsSnapshot* snap, const MetricDef* m) {
+    switch (m->labels) {
+    case METRIC_LABELS_CORE:     return METRICS_CORES;
+    case METRIC_LABELS_TASK:     return snap->taskCount;
+    case METRIC_LABELS_RX_STAGE: return METRICS_RX_STAGES;
+    default:                     return 1;
+    }
+}
+
+static const char* label_key(const MetricDef* m) {
+    switch (m->labels) {
+    case METRIC_LABELS_CORE:     return "core";
+    case METRIC_LABELS_TASK:     return "task";
+    case METRIC_LABELS_RX_STAGE: return "stage";
+    default:                     return NULL;
+    }
+}
+
+static const char* label_value(const MetricsSnapshot* snap, const MetricDef* m, uint16_t i) {
+    switch (m->labels) {
+    case METRIC_LABELS_CORE:     return CORE_NAMES[i];
+    case METRIC_LABELS_TASK:     return snap->taskNames[i];
+    case METRIC_LABELS_RX_STAGE: return RX_STAGE_NAMES[i];
+    default:                     return "";
+    }
+}
+
+static void format_value(const MetricsSnapshot* snap, const MetricDef* m, uint16_t i,
+                         char* out, size_t size) {
+    const uint8_t* base = (const uint8_t*)snap + m->offset;
+    switch (m->valueType) {
+    case METRIC_U64: {
+        uint64_t v;
+        memcpy(&v, base + i * sizeof(v), sizeof(v));
+        snprintf(out, size, "%llu", (unsigned long long)v);
+        break;
+    }
+    case METRIC_I32: {
+        int32_t v;
+        memcpy(&v, base + i * sizeof(v), sizeof(v));
+        snprintf(out, size, "%ld", (long)v);
+        break;
+    }
+    case METRIC_F32: {
+        float v;
+        memcpy(&v, base + i * sizeof(v), sizeof(v));
+        if (isnan(v))
+            snprintf(out, size, "NaN");
+        else
+            snprintf(out, size, "%.4f", (double)v);
+        break;
+    }
+    default: {
+        uint32_t v;
+        memcpy(&v, base + i * sizeof(v), sizeof(v));
+        snprintf(out, size, "%lu", (unsigned long)v);
+        break;
+    }
+    }
+}
+
+/**
+ * Render one line: 0 = HELP, 1 = TYPE, 2.. = samples
+ * @return Length (without NUL)
+ */
+static size_t render_line(const MetricsSnapshot* snap, const MetricDef* m, uint16_t line,
+                          char* out) {
+    int n;
+    if (line == 0) {
+        n = snprintf(out, METRICS_LINE_MAX, "# HELP %s %s\n", m->name, m->help);
+    } else if (line == 1) {
+        n = snprintf(out, METRICS_LINE_MAX, "# TYPE %s %s\n", m->name, m->type);
+    } else {
+        uint16_t i = line - 2;
+        char value[24];
+        format_value(snap, m, i, value, sizeof(value));
+        const char* key = label_key(m);
+        if (key)
+            n = snprintf(out, METRICS_LINE_MAX, "%s{%s=\"%s\"} %s\n", m->name, key,
+                         label_value(snap, m, i), value);
+        else
+            n = snprintf(out, METRICS_LINE_MAX, "%s %s\n", m->name, value);
+    }
+    if (n < 0)
+        return 0;
+    return (size_t)n < METRICS_LINE_MAX ? (size_t)n : METRICS_LINE_MAX - 1;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void Metrics_startRender(MetricsCursor* cursor) {
+    cursor->metric = 0;
+    cursor->line = 0;
+    cursor->offset = 0;
+}
+
+size_t Metrics_render(const MetricsSnapshot* snap, MetricsCursor* cursor, char* out,
+                      size_t maxLen) {
+    char line[METRICS_LINE_MAX];
+    size_t written = 0;
+    while (written < maxLen && cursor->metric < METRIC_COUNT) {
+        const MetricDef* m = &METRICS[cursor->metric];
+        if (cursor->line >= 2 + sample_count(snap, m)) {
+            cursor->metric++;
+            cursor->line = 0;
+            cursor->offset = 0;
+            continue;
+        }
+        size_t len = render_line(snap, m, cursor->line, line);
+        size_t n = len - cursor->offset;
+        if (n > maxLen - written)
+            n = maxLen - written;
+        memcpy(out + written, line + cursor->offset, n);
+        written += n;
+        cursor->offset += (uint16_t)n;
+        if (cursor->offset >= len) {
+            cursor->line++;
+            cursor->offset = 0;
+        }
+    }
+    return written;
+}
+
+// ============================================================================
+// HTTP Route
+// ============================================================================
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+static MetricsCaptureFn captureFn = NULL;
+
+// Per-scrape state, owned by the response filler and freed with it
+struct MetricsScrape {
+  MetricsSnapshot snap;
+  MetricsCursor cursor;
+};
+
+static void handle_metrics(AsyncWebServerRequest *request) {
+  MetricsScrape scrape;
+  memset(&scrape, 0, sizeof(scrape));
+  captureFn(&scrape.snap);
+  Metrics_startRender(&scrape.cursor);
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      METRICS_CONTENT_TYPE,
+      [scrape](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+        return Metrics_render(&scrape.snap, &scrape.cursor, (char *)buffer, maxLen);
+      });
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
+}
+
+void Metrics_begin(AsyncWebServer *server, MetricsCaptureFn capture) {
+  captureFn = capture;
+  server->on("/metrics", HTTP_GET, handle_metrics);
+}
+
+#endif // __XTENSA__
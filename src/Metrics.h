@@ -0,0 +1,144 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Metrics - Prometheus text exposition at GET /metrics (port 80)
+ *
+ * A scrape copies every counter once into a MetricsSnapshot (plain
+ * struct, no strings), then the response callback renders it straight
+ * into the TCP send buffer a line at a time:
+ *
+ * - No String, no response-sized buffer: one 160 byte line on the stack
+ *   of the async_tcp task, re-rendered when a line straddles two buffers
+ * - All values of one scrape come from the same instant
+ * - The control path is not touched: the snapshot only reads counters
+ *   the tasks already keep
+ *
+ * The metric set is a const table (name, help, type, snapshot field);
+ * labelled families (per task, per core, per receive-filter stage) step
+ * through an array field.
+ *
+ *   na_uptime_seconds, na_heap_*, na_cpu_load_ratio{core},
+ *   na_task_*{task}, na_ratelimit_*, na_rx_*{stage}, na_failsafe_*,
+ *   na_link_*, na_crypto_*, na_ota_*, na_log_dropped_total
+ *
+ * @file Metrics.h
+ */
+
+#define METRICS_MAX_TASKS       8       // SCHED_MAX_TASKS
+#define METRICS_CORES           2
+#define METRICS_RX_STAGES       6       // RxFilter reject stages
+#define METRICS_TASK_NAME_MAX   16
+#define METRICS_LINE_MAX        160
+#define METRICS_CONTENT_TYPE    "text/plain; version=0.0.4"
+
+class AsyncWebServer;
+
+/**
+ * Everything one scrape reports
+ */
+typedef struct {
+    uint32_t uptimeS;
+
+    // Heap
+    uint32_t heapFree;
+    uint32_t heapMinFree;
+    uint32_t heapLargestBlock;
+    uint32_t heapSize;
+
+    // Profiler
+    float coreLoad[METRICS_CORES];          // 0-1, NaN if not measured
+    uint32_t loopMaxUs;
+    uint8_t taskCount;
+    char taskNames[METRICS_MAX_TASKS][METRICS_TASK_NAME_MAX];
+    uint32_t taskRuns[METRICS_MAX_TASKS];
+    uint32_t taskOverruns[METRICS_MAX_TASKS];
+    uint32_t taskExecMaxUs[METRICS_MAX_TASKS];
+    uint32_t taskJitterMaxUs[METRICS_MAX_TASKS];
+
+    // Rate limiter
+    uint32_t rateAllowed;
+    uint32_t rateBlocked;
+    uint32_t ratePeerBlocked;
+    uint32_t rateClassBlocked;
+
+    // Receive filter
+    uint32_t rxPassed;
+    uint32_t rxRejected[METRICS_RX_STAGES]; // length, format, source, crc, sequence, rate
+
+    // Failsafe
+    uint32_t failsafeState;                 // FailsafeState
+    uint32_t failsafePackets;
+    uint32_t failsafeBadHmac;
+    uint32_t failsafeFault;                 // Vehicle critical fault (Sub leak), 0 / 1
+
+    // Link
+    int32_t linkRssiDbm;
+    uint32_t linkQuality;                   // 0-100
+    uint32_t linkReceived;
+    uint32_t linkLost;
+    uint32_t linkDuplicates;
+
+    // Crypto
+    uint32_t cryptoAesCalls;
+    uint64_t cryptoAesBytes;
+    uint32_t cryptoShaCalls;
+    uint64_t cryptoShaBytes;
+
+    // OTA
+    uint32_t otaStatus;                     // OTAStatus
+    uint32_t otaAttempts;
+    uint32_t otaSuccess;
+    uint32_t otaFailed;
+    uint32_t otaRollbacks;
+
+    uint32_t logDropped;
+} MetricsSnapshot;
+
+/**
+ * Render position, resumable at any byte
+ */
+typedef struct {
+    uint16_t metric;        // Table row
+    uint16_t line;          // 0 = HELP, 1 = TYPE, 2.. = samples
+    uint16_t offset;        // Bytes of the current line already sent
+} MetricsCursor;
+
+/**
+ * Fills a snapshot (firmware side, reads the managers)
+ */
+typedef void (*MetricsCaptureFn)(MetricsSnapshot* snap);
+
+// ============================================================================
+// Rendering (pure)
+// ============================================================================
+
+/**
+ * Rewind a cursor to the first line
+ */
+void Metrics_startRender(MetricsCursor* cursor);
+
+/**
+ * Render the next bytes of the exposition
+ * @param out    Destination (TCP buffer)
+ * @param maxLen Space in out
+ * @return Bytes written, 0 once everything was sent
+ */
+size_t Metrics_render(const MetricsSnapshot* snap, MetricsCursor* cursor, char* out,
+                      size_t maxLen);
+
+// ============================================================================
+// HTTP Route (target)
+// ============================================================================
+
+/**
+ * Register GET /metrics (before server->begin())
+ * @param capture Called once per scrape, on the async_tcp task
+ */
+void Metrics_begin(AsyncWebServer* server, MetricsCaptureFn capture);
+
+#endif // METRICS_H
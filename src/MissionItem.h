@@ -0,0 +1,65 @@
+#ifndef MISSION_ITEM_H
+#define MISSION_ITEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * MissionItem - On-board mission instruction format
+ *
+ * A mission is a list of 14-byte items. Position items (WAYPOINT,
+ * LOITER) are flown; the others run instantly when the mission reaches
+ * them, so speed changes, dives, loops and the final RTL need no ground
+ * station round trip:
+ *
+ *   cmd        lat / lng   alt          param            arg
+ *   WAYPOINT   target      dm           speed (0 = set)  -
+ *   LOITER     target      dm           hold, s          -
+ *   SET_SPEED  -           -            speed            -
+ *   SET_DEPTH  -           depth, dm    -                -
+ *   JUMP       -           -            item index       repeats (0 = forever)
+ *   RTL        -           -            -                -
+ *
+ * The same packed layout is the bulk upload wire format and the NVS blob.
+ *
+ * @file MissionItem.h
+ */
+
+typedef enum {
+    MISSION_CMD_WAYPOINT = 0,
+    MISSION_CMD_LOITER = 1,
+    MISSION_CMD_SET_SPEED = 2,
+    MISSION_CMD_SET_DEPTH = 3,
+    MISSION_CMD_JUMP = 4,
+    MISSION_CMD_RTL = 5,
+    MISSION_CMD_COUNT
+} MissionCommand;
+
+/**
+ * One item, packed little endian (wire and NVS format)
+ */
+typedef struct __attribute__((packed)) {
+    int32_t lat;                // deg * 1e7
+    int32_t lng;
+    int16_t alt;                // dm
+    uint16_t param;
+    uint8_t cmd;                // MissionCommand
+    uint8_t arg;
+} WaypointRecord;
+
+/**
+ * Read-only view of a mission stored as arrays (WaypointManager)
+ */
+typedef struct {
+    const uint8_t* cmd;
+    const uint16_t* param;
+    const uint8_t* arg;
+    const int16_t* alt;
+    uint16_t count;
+} MissionView;
+
+static inline bool MissionItem_isPosition(uint8_t cmd) {
+    return cmd == MISSION_CMD_WAYPOINT || cmd == MISSION_CMD_LOITER;
+}
+
+#endif // MISSION_ITEM_H
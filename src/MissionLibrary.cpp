@@ -0,0 +1,253 @@
+#include "MissionLibrary.h"
+#include "Crc16.h"
+#include <string.h>
+
+/**
+ * MissionLibrary - Implementation
+ *
+ * Flash access is three calls (read / program / erase a range of the
+ * partition); the target maps them to esp_partition, the host to a RAM
+ * image that starts erased.
+ *
+ * @file MissionLibrary.cpp
+ */
+
+#define VERIFY_CHUNK 256                // Read-back buffer while saving
+
+static const char* const STATUS_NAMES[] = {
+    "ok", "no_partition", "not_found", "full", "bad_name", "too_large", "flash", "bad_crc"};
+
+static MissionLibraryIndex gIndex;
+
+// ============================================================================
+// Index (pure)
+// ============================================================================
+
+static uint16_t headerCrc(const MissionLibraryHeader* header) {
+    return Crc16_compute((const uint8_t*)header, offsetof(MissionLibraryHeader, headerCrc));
+}
+
+bool MissionLibrary_nameValid(const char* name) {
+    if (!name || !name[0]) return false;
+    size_t len = 0;
+    for (; name[len]; len++) {
+        if (len >= MISSION_LIBRARY_NAME_LEN - 1) return false;
+        if (name[len] < 0x20 || name[len] > 0x7E) return false;
+    }
+    return true;
+}
+
+void MissionLibrary_makeHeader(MissionLibraryHeader* header, const char* name, uint16_t count,
+                               uint16_t crc, uint32_t sequence) {
+    memset(header, 0, sizeof(*header));
+    header->magic = MISSION_LIBRARY_MAGIC;
+    header->version = MISSION_LIBRARY_VERSION;
+    header->count = count;
+    header->crc = crc;
+    header->sequence = sequence;
+    strncpy(header->name, name, MISSION_LIBRARY_NAME_LEN - 1);
+    header->headerCrc = headerCrc(header);
+}
+
+bool MissionLibrary_headerValid(const MissionLibraryHeader* header) {
+    return header->magic == MISSION_LIBRARY_MAGIC &&
+           header->version == MISSION_LIBRARY_VERSION &&
+           header->headerCrc == headerCrc(header) &&
+           memchr(header->name, 0, MISSION_LIBRARY_NAME_LEN) != NULL &&
+           MissionLibrary_nameValid(header->name) &&
+           header->count <= MISSION_LIBRARY_MAX_RECORDS;
+}
+
+void MissionLibrary_initIndex(MissionLibraryIndex* index, uint8_t slotCount) {
+    memset(index, 0, sizeof(*index));
+    index->slotCount = slotCount > MISSION_LIBRARY_MAX_SLOTS ? MISSION_LIBRARY_MAX_SLOTS : slotCount;
+}
+
+int MissionLibrary_find(const MissionLibraryIndex* index, const char* name) {
+    for (uint8_t i = 0; name && i < index->slotCount; i++) {
+        if (index->slots[i].used && strcmp(index->slots[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+int MissionLibrary_freeSlot(const MissionLibraryIndex* index) {
+    for (uint8_t i = 0; i < index->slotCount; i++) {
+        if (!index->slots[i].used) return i;
+    }
+    return -1;
+}
+
+int MissionLibrary_scanSlot(MissionLibraryIndex* index, uint8_t slot,
+                            const MissionLibraryHeader* header) {
+    if (slot >= index->slotCount || !header || !MissionLibrary_headerValid(header)) return -1;
+    if ((int32_t)(header->sequence + 1 - index->nextSequence) > 0)
+        index->nextSequence = header->sequence + 1;
+
+    int older = -1;
+    int other = MissionLibrary_find(index, header->name);
+    if (other >= 0) {
+        // Saved again and reset before the old copy was erased
+        if ((int32_t)(header->sequence - index->slots[other].sequence) < 0) return slot;
+        index->slots[other].used = false;
+        older = other;
+    }
+    MissionLibraryEntry* e = &index->slots[slot];
+    e->used = true;
+    memcpy(e->name, header->name, MISSION_LIBRARY_NAME_LEN);
+    e->count = header->count;
+    e->crc = header->crc;
+    e->sequence = header->sequence;
+    return older;
+}
+
+const char* MissionLibrary_statusName(MissionLibraryStatus status) {
+    return (unsigned)status < sizeof(STATUS_NAMES) / sizeof(STATUS_NAMES[0])
+               ? STATUS_NAMES[status] : "?";
+}
+
+const MissionLibraryIndex* MissionLibrary_getIndex(void) {
+    return &gIndex;
+}
+
+// ============================================================================
+// Flash
+// ============================================================================
+
+#if defined(__XTENSA__)
+#include <esp_partition.h>
+
+static const esp_partition_t* gPart = NULL;
+
+static bool flashOpen(uint8_t* slotCount) {
+    gPart = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                     MISSION_LIBRARY_PARTITION_LABEL);
+    if (!gPart) return false;
+    uint32_t sectors = gPart->size / MISSION_LIBRARY_SECTOR_SIZE;
+    *slotCount = (uint8_t)(sectors > MISSION_LIBRARY_MAX_SLOTS ? MISSION_LIBRARY_MAX_SLOTS : sectors);
+    return true;
+}
+
+static bool flashRead(uint32_t offset, void* out, size_t len) {
+    return esp_partition_read(gPart, offset, out, len) == ESP_OK;
+}
+
+static bool flashWrite(uint32_t offset, const void* data, size_t len) {
+    return esp_partition_write(gPart, offset, data, len) == ESP_OK;
+}
+
+static bool flashErase(uint32_t offset) {
+    return esp_partition_erase_range(gPart, offset, MISSION_LIBRARY_SECTOR_SIZE) == ESP_OK;
+}
+
+#else
+
+static uint8_t gImage[MISSION_LIBRARY_MAX_SLOTS * MISSION_LIBRARY_SECTOR_SIZE];
+static bool gImageReady = false;
+
+static bool flashOpen(uint8_t* slotCount) {
+    if (!gImageReady) {
+        memset(gImage, 0xFF, sizeof(gImage));
+        gImageReady = true;
+    }
+    *slotCount = MISSION_LIBRARY_MAX_SLOTS;
+    return true;
+}
+
+static bool flashRead(uint32_t offset, void* out, size_t len) {
+    if (offset + len > sizeof(gImage)) return false;
+    memcpy(out, gImage + offset, len);
+    return true;
+}
+
+static bool flashWrite(uint32_t offset, const void* data, size_t len) {
+    if (offset + len > sizeof(gImage)) return false;
+    // NOR flash: programming only clears bits
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) gImage[offset + i] &= p[i];
+    return true;
+}
+
+static bool flashErase(uint32_t offset) {
+    if (offset + MISSION_LIBRARY_SECTOR_SIZE > sizeof(gImage)) return false;
+    memset(gImage + offset, 0xFF, MISSION_LIBRARY_SECTOR_SIZE);
+    return true;
+}
+
+#endif
+
+static uint32_t slotOffset(uint8_t slot) {
+    return (uint32_t)slot * MISSION_LIBRARY_SECTOR_SIZE;
+}
+
+MissionLibraryStatus MissionLibrary_begin(void) {
+    uint8_t slotCount = 0;
+    if (!flashOpen(&slotCount)) {
+        MissionLibrary_initIndex(&gIndex, 0);
+        return MISSION_LIBRARY_NO_PARTITION;
+    }
+    MissionLibrary_initIndex(&gIndex, slotCount);
+    for (uint8_t i = 0; i < slotCount; i++) {
+        MissionLibraryHeader header;
+        if (!flashRead(slotOffset(i), &header, sizeof(header))) continue;
+        int stale = MissionLibrary_scanSlot(&gIndex, i, &header);
+        if (stale >= 0) flashErase(slotOffset((uint8_t)stale));
+    }
+    return MISSION_LIBRARY_OK;
+}
+
+MissionLibraryStatus MissionLibrary_save(const char* name, const WaypointRecord* records,
+                                         uint16_t count, uint8_t* slot) {
+    if (gIndex.slotCount == 0) return MISSION_LIBRARY_NO_PARTITION;
+    if (!MissionLibrary_nameValid(name)) return MISSION_LIBRARY_BAD_NAME;
+    if (count > MISSION_LIBRARY_MAX_RECORDS) return MISSION_LIBRARY_TOO_LARGE;
+    int target = MissionLibrary_freeSlot(&gIndex);
+    if (target < 0) return MISSION_LIBRARY_FULL;
+
+    // A free sector may hold a half-written save: always start erased
+    uint32_t base = slotOffset((uint8_t)target);
+    size_t bytes = (size_t)count * sizeof(WaypointRecord);
+    if (!flashErase(base) ||
+        (bytes && !flashWrite(base + sizeof(MissionLibraryHeader), records, bytes)))
+        return MISSION_LIBRARY_FLASH_ERROR;
+
+    // Read back before the header makes it visible
+    uint16_t crc = Crc16_compute((const uint8_t*)records, bytes);
+    uint16_t readCrc = CRC16_INIT;
+    uint8_t chunk[VERIFY_CHUNK];
+    for (size_t done = 0; done < bytes;) {
+        size_t n = bytes - done < sizeof(chunk) ? bytes - done : sizeof(chunk);
+        if (!flashRead(base + sizeof(MissionLibraryHeader) + done, chunk, n))
+            return MISSION_LIBRARY_FLASH_ERROR;
+        readCrc = Crc16_update(readCrc, chunk, n);
+        done += n;
+    }
+    if (readCrc != crc) return MISSION_LIBRARY_BAD_CRC;
+
+    MissionLibraryHeader header;
+    MissionLibrary_makeHeader(&header, name, count, crc, gIndex.nextSequence);
+    if (!flashWrite(base, &header, sizeof(header))) return MISSION_LIBRARY_FLASH_ERROR;
+
+    // Only now retire the previous copy of this name
+    int old = MissionLibrary_scanSlot(&gIndex, (uint8_t)target, &header);
+    if (old >= 0) flashErase(slotOffset((uint8_t)old));
+    if (slot) *slot = (uint8_t)target;
+    return MISSION_LIBRARY_OK;
+}
+
+MissionLibraryStatus MissionLibrary_read(uint8_t slot, uint16_t first, WaypointRecord* records,
+                                         uint16_t n) {
+    if (slot >= gIndex.slotCount || !gIndex.slots[slot].used) return MISSION_LIBRARY_NOT_FOUND;
+    if ((uint32_t)first + n > gIndex.slots[slot].count) return MISSION_LIBRARY_TOO_LARGE;
+    uint32_t offset = slotOffset(slot) + sizeof(MissionLibraryHeader) +
+                      (uint32_t)first * sizeof(WaypointRecord);
+    if (n && !flashRead(offset, records, (size_t)n * sizeof(WaypointRecord)))
+        return MISSION_LIBRARY_FLASH_ERROR;
+    return MISSION_LIBRARY_OK;
+}
+
+MissionLibraryStatus MissionLibrary_remove(uint8_t slot) {
+    if (slot >= gIndex.slotCount || !gIndex.slots[slot].used) return MISSION_LIBRARY_NOT_FOUND;
+    if (!flashErase(slotOffset(slot))) return MISSION_LIBRARY_FLASH_ERROR;
+    gIndex.slots[slot].used = false;
+    return MISSION_LIBRARY_OK;
+}
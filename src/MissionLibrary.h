@@ -0,0 +1,163 @@
+#ifndef MISSION_LIBRARY_H
+#define MISSION_LIBRARY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "MissionItem.h"
+
+/**
+ * MissionLibrary - Named missions kept in their own flash partition
+ *
+ * WaypointManager holds the one mission being flown. The library keeps
+ * up to MISSION_LIBRARY_MAX_SLOTS more in the "missions" data partition,
+ * one 4 KB sector each (the largest mission, 256 records of 14 bytes,
+ * fits with its header):
+ *
+ *   | MissionLibraryHeader (32) | WaypointRecord x count | 0xFF ... |
+ *
+ * The records are programmed first and the header last, so a sector cut
+ * off by a reset has no valid header and is free. A save never
+ * overwrites in place: the new copy goes to a free sector and the old
+ * one is erased after, so a reset in between leaves both and boot keeps
+ * the higher sequence. The index (name, slot, count, CRC) is rebuilt
+ * from the 16 headers at boot; the records themselves are only read
+ * when a mission is loaded, straight into the upload staging path
+ * (MissionUpload), which checks the CRC again before the swap.
+ *
+ * The index is the comms task's (serial commands) after begin(). On the
+ * host the partition is a RAM image, so the whole path runs in tests.
+ *
+ * @file MissionLibrary.h
+ */
+
+#define MISSION_LIBRARY_PARTITION_LABEL "missions"
+#define MISSION_LIBRARY_SECTOR_SIZE     4096
+#define MISSION_LIBRARY_MAX_SLOTS       16
+#define MISSION_LIBRARY_MAGIC           0x4C4D414EUL    // "NAML"
+#define MISSION_LIBRARY_VERSION         1
+#define MISSION_LIBRARY_NAME_LEN        16              // NUL included
+#define MISSION_LIBRARY_MAX_RECORDS \
+    ((MISSION_LIBRARY_SECTOR_SIZE - sizeof(MissionLibraryHeader)) / sizeof(WaypointRecord))
+
+typedef enum {
+    MISSION_LIBRARY_OK = 0,
+    MISSION_LIBRARY_NO_PARTITION,   // begin() found no "missions" partition
+    MISSION_LIBRARY_NOT_FOUND,
+    MISSION_LIBRARY_FULL,           // No free sector
+    MISSION_LIBRARY_BAD_NAME,       // Empty or too long
+    MISSION_LIBRARY_TOO_LARGE,
+    MISSION_LIBRARY_FLASH_ERROR,
+    MISSION_LIBRARY_BAD_CRC         // Records do not match the header
+} MissionLibraryStatus;
+
+/**
+ * Sector header (packed little endian, 32 bytes)
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;                 // MISSION_LIBRARY_MAGIC
+    uint8_t version;                // MISSION_LIBRARY_VERSION
+    uint8_t reserved;
+    uint16_t count;                 // Records after the header
+    uint16_t crc;                   // NA_CRC16 of the packed records
+    uint32_t sequence;              // Save order, newer wins on a duplicate name
+    char name[MISSION_LIBRARY_NAME_LEN];
+    uint16_t headerCrc;             // NA_CRC16 of the bytes above
+} MissionLibraryHeader;
+
+/**
+ * One index row
+ */
+typedef struct {
+    bool used;
+    char name[MISSION_LIBRARY_NAME_LEN];
+    uint16_t count;
+    uint16_t crc;
+    uint32_t sequence;
+} MissionLibraryEntry;
+
+/**
+ * Index of the partition, one row per sector (id = sector)
+ */
+typedef struct {
+    MissionLibraryEntry slots[MISSION_LIBRARY_MAX_SLOTS];
+    uint8_t slotCount;              // Sectors in the partition (0 = none)
+    uint32_t nextSequence;
+} MissionLibraryIndex;
+
+// ============================================================================
+// Index (pure)
+// ============================================================================
+
+/**
+ * Fill a header for name / records (name must be valid)
+ */
+void MissionLibrary_makeHeader(MissionLibraryHeader* header, const char* name, uint16_t count,
+                               uint16_t crc, uint32_t sequence);
+
+/**
+ * Magic, version, header CRC, NUL-terminated name and a count that fits
+ */
+bool MissionLibrary_headerValid(const MissionLibraryHeader* header);
+
+/**
+ * 1-15 characters, printable ASCII
+ */
+bool MissionLibrary_nameValid(const char* name);
+
+/**
+ * Empty index of slotCount sectors
+ */
+void MissionLibrary_initIndex(MissionLibraryIndex* index, uint8_t slotCount);
+
+/**
+ * Add a sector's header found at boot (NULL / invalid = free sector)
+ * @return Slot to erase because the same name has a newer copy, -1 if none
+ */
+int MissionLibrary_scanSlot(MissionLibraryIndex* index, uint8_t slot,
+                            const MissionLibraryHeader* header);
+
+/**
+ * @return Slot of name (exact match), -1 if not in the index
+ */
+int MissionLibrary_find(const MissionLibraryIndex* index, const char* name);
+
+/**
+ * @return First free slot, -1 when full
+ */
+int MissionLibrary_freeSlot(const MissionLibraryIndex* index);
+
+// ============================================================================
+// Flash
+// ============================================================================
+
+/**
+ * Find the partition and build the index from its headers; erases the
+ * older copy of a name saved twice (boot)
+ */
+MissionLibraryStatus MissionLibrary_begin(void);
+
+/**
+ * Save records under name: new sector, then the old copy of that name
+ * is erased
+ * @param slot Sector written, may be NULL
+ */
+MissionLibraryStatus MissionLibrary_save(const char* name, const WaypointRecord* records,
+                                         uint16_t count, uint8_t* slot);
+
+/**
+ * Read n records of slot from record first
+ */
+MissionLibraryStatus MissionLibrary_read(uint8_t slot, uint16_t first, WaypointRecord* records,
+                                         uint16_t n);
+
+MissionLibraryStatus MissionLibrary_remove(uint8_t slot);
+
+/**
+ * Current index (slots[id].used marks a stored mission)
+ */
+const MissionLibraryIndex* MissionLibrary_getIndex(void);
+
+const char* MissionLibrary_statusName(MissionLibraryStatus status);
+
+#endif // MISSION_LIBRARY_H
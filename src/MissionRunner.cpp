@@ -0,0 +1,97 @@
+#include "MissionRunner.h"
+#include <string.h>
+
+/**
+ * MissionRunner - Implementation
+ *
+ * @file MissionRunner.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+/**
+ * Take a jump? Counts down the item's repeats on each pass
+ */
+static bool take_jump(MissionRunner* r, uint16_t item, uint8_t repeats) {
+    if (repeats == 0) return true;      // Forever
+
+    for (uint8_t i = 0; i < r->jumpCount; i++) {
+        if (r->jumpItem[i] == item) {
+            if (r->jumpLeft[i] == 0) return false;
+            r->jumpLeft[i]--;
+            return true;
+        }
+    }
+    if (r->jumpCount >= MISSION_MAX_JUMPS) return false;
+    r->jumpItem[r->jumpCount] = item;
+    r->jumpLeft[r->jumpCount] = repeats - 1;
+    r->jumpCount++;
+    return true;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void MissionRunner_init(MissionRunner* runner, uint16_t defaultSpeed) {
+    memset(runner, 0, sizeof(*runner));
+    runner->speed = defaultSpeed;
+}
+
+MissionStep MissionRunner_resolve(MissionRunner* runner, const MissionView* mission) {
+    MissionStep step;
+    memset(&step, 0, sizeof(step));
+    step.type = MISSION_STEP_DONE;
+
+    for (int n = 0; n < MISSION_MAX_STEPS && runner->index < mission->count; n++) {
+        uint16_t i = runner->index;
+        switch (mission->cmd[i]) {
+        case MISSION_CMD_WAYPOINT:
+        case MISSION_CMD_LOITER:
+            step.type = MISSION_STEP_GOTO;
+            step.index = i;
+            if (mission->cmd[i] == MISSION_CMD_LOITER) {
+                step.speed = runner->speed;
+                step.loiterS = mission->param[i];
+            } else {
+                step.speed = mission->param[i] ? mission->param[i] : runner->speed;
+            }
+            return step;
+
+        case MISSION_CMD_SET_SPEED:
+            runner->speed = mission->param[i];
+            runner->index++;
+            break;
+
+        case MISSION_CMD_SET_DEPTH:
+            step.setDepth = true;
+            step.depth = mission->alt[i] * 0.1f;
+            runner->index++;
+            break;
+
+        case MISSION_CMD_JUMP:
+            if (mission->param[i] < mission->count && take_jump(runner, i, mission->arg[i])) {
+                runner->index = mission->param[i];
+            } else {
+                runner->index++;
+            }
+            break;
+
+        case MISSION_CMD_RTL:
+            runner->index++;
+            step.type = MISSION_STEP_RTL;
+            return step;
+
+        default:
+            runner->index++;                // Unknown: skip
+            break;
+        }
+    }
+    return step;
+}
+
+void MissionRunner_complete(MissionRunner* runner, uint16_t index) {
+    runner->index = index + 1;
+}
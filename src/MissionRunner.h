@@ -0,0 +1,66 @@
+#ifndef MISSION_RUNNER_H
+#define MISSION_RUNNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MissionItem.h"
+
+/**
+ * MissionRunner - Interpreter for the instant mission items
+ *
+ * resolve() runs every instant item from the current index onwards
+ * (speed, depth, jumps) until it reaches something the vehicle has to
+ * fly or do: a position item, RTL, or the end of the mission. The
+ * navigation layer flies the position item and calls complete() when
+ * it is reached (and, for LOITER, held).
+ *
+ * Jump repeat counters live in a small table (MISSION_MAX_JUMPS
+ * distinct JUMP items per mission); further jumps are skipped. A loop
+ * with no position item in it is cut off after MISSION_MAX_STEPS.
+ *
+ * @file MissionRunner.h
+ */
+
+#define MISSION_MAX_JUMPS       8
+#define MISSION_MAX_STEPS       64      // Instant items per resolve()
+
+typedef enum {
+    MISSION_STEP_GOTO = 0,      // Fly to item `index`
+    MISSION_STEP_RTL = 1,       // RTL item reached
+    MISSION_STEP_DONE = 2       // Past the last item (or a runaway loop)
+} MissionStepType;
+
+typedef struct {
+    MissionStepType type;
+    uint16_t index;             // GOTO: position item
+    uint16_t speed;             // GOTO: item speed, else the mission speed
+    uint16_t loiterS;           // GOTO: hold time once there (LOITER)
+    bool setDepth;              // A SET_DEPTH ran on the way
+    float depth;                // m, the last one
+} MissionStep;
+
+typedef struct {
+    uint16_t index;             // Next item to run
+    uint16_t speed;             // Mission speed (SET_SPEED)
+    uint8_t jumpCount;
+    uint16_t jumpItem[MISSION_MAX_JUMPS];
+    uint8_t jumpLeft[MISSION_MAX_JUMPS];
+} MissionRunner;
+
+/**
+ * Start at item 0
+ * @param defaultSpeed Speed until the first SET_SPEED
+ */
+void MissionRunner_init(MissionRunner* runner, uint16_t defaultSpeed);
+
+/**
+ * Run instant items until the next thing to fly
+ */
+MissionStep MissionRunner_resolve(MissionRunner* runner, const MissionView* mission);
+
+/**
+ * The position item from the last GOTO is done: move past it
+ */
+void MissionRunner_complete(MissionRunner* runner, uint16_t index);
+
+#endif // MISSION_RUNNER_H
@@ -0,0 +1,58 @@
+#include "MissionUpload.h"
+#include "Crc16.h"
+#include <string.h>
+
+/**
+ * MissionUpload - Implementation
+ *
+ * @file MissionUpload.cpp
+ */
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+MissionUploadStatus MissionUpload_begin(MissionUpload* up, WaypointRecord* buffer,
+                                        uint16_t capacity, uint16_t count, uint16_t crc) {
+    up->active = false;
+    if (count > capacity) return MISSION_UPLOAD_TOO_LARGE;
+    if (!buffer && count > 0) return MISSION_UPLOAD_NO_MEMORY;
+
+    up->records = buffer;
+    up->capacity = capacity;
+    up->expected = count;
+    up->received = 0;
+    up->crc = crc;
+    up->active = true;
+    return MISSION_UPLOAD_OK;
+}
+
+MissionUploadStatus MissionUpload_add(MissionUpload* up, uint16_t first,
+                                      const WaypointRecord* records, uint16_t n) {
+    if (!up->active) return MISSION_UPLOAD_IDLE;
+    if (first != up->received) return MISSION_UPLOAD_OUT_OF_ORDER;
+    if ((uint32_t)first + n > up->expected) return MISSION_UPLOAD_OVERFLOW;
+
+    memcpy(&up->records[first], records, n * sizeof(WaypointRecord));
+    up->received += n;
+    return MISSION_UPLOAD_OK;
+}
+
+MissionUploadStatus MissionUpload_finish(MissionUpload* up) {
+    if (!up->active) return MISSION_UPLOAD_IDLE;
+    if (up->received != up->expected) return MISSION_UPLOAD_INCOMPLETE;
+
+    uint16_t crc = Crc16_compute((const uint8_t*)up->records, up->expected * sizeof(WaypointRecord));
+    if (crc != up->crc) {
+        // Start over: some record is wrong, not just the last one
+        up->received = 0;
+        return MISSION_UPLOAD_BAD_CRC;
+    }
+    up->active = false;
+    return MISSION_UPLOAD_OK;
+}
+
+void MissionUpload_abort(MissionUpload* up) {
+    up->active = false;
+    up->received = 0;
+}
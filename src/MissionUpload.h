@@ -0,0 +1,77 @@
+#ifndef MISSION_UPLOAD_H
+#define MISSION_UPLOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "MissionItem.h"
+
+/**
+ * MissionUpload - Staged bulk mission transfer
+ *
+ * The host announces the waypoint count and the CRC of the whole mission,
+ * then sends the records in chunks, in order. Records land in a shadow
+ * buffer; the live mission is untouched until finish() has checked that
+ * every record arrived and the CRC (NA_CRC16 over the packed records)
+ * matches, so a cut-off or corrupted upload leaves the old mission
+ * flying. A chunk that does not start at the next expected index is
+ * refused and the reply tells the host where to resume.
+ *
+ * WaypointRecord (MissionItem.h) is also the NVS layout, so an accepted
+ * shadow buffer is saved as is.
+ *
+ * @file MissionUpload.h
+ */
+
+typedef enum {
+    MISSION_UPLOAD_OK = 0,
+    MISSION_UPLOAD_IDLE = 1,            // No upload in progress
+    MISSION_UPLOAD_TOO_LARGE = 2,       // Count over the buffer capacity
+    MISSION_UPLOAD_OUT_OF_ORDER = 3,    // Chunk not at the next index
+    MISSION_UPLOAD_OVERFLOW = 4,        // Chunk past the announced count
+    MISSION_UPLOAD_INCOMPLETE = 5,      // finish() before the last record
+    MISSION_UPLOAD_BAD_CRC = 6,
+    MISSION_UPLOAD_NO_MEMORY = 7,       // Caller could not allocate the buffer
+    MISSION_UPLOAD_BUSY = 8,            // Previous mission not applied yet
+    MISSION_UPLOAD_BAD_FRAME = 9        // Transport: malformed request
+} MissionUploadStatus;
+
+typedef struct {
+    WaypointRecord* records;    // Shadow buffer (caller owned)
+    uint16_t capacity;
+    uint16_t expected;          // Announced count
+    uint16_t received;          // Next index expected
+    uint16_t crc;               // Announced CRC
+    bool active;
+} MissionUpload;
+
+/**
+ * Start an upload (replaces one in progress)
+ * @param up Upload state
+ * @param buffer Shadow buffer
+ * @param capacity Records the buffer holds
+ * @param count Announced waypoint count
+ * @param crc Announced NA_CRC16 of the packed records
+ */
+MissionUploadStatus MissionUpload_begin(MissionUpload* up, WaypointRecord* buffer,
+                                        uint16_t capacity, uint16_t count, uint16_t crc);
+
+/**
+ * Stage a chunk of records
+ * @param first Index of records[0] in the mission
+ */
+MissionUploadStatus MissionUpload_add(MissionUpload* up, uint16_t first,
+                                      const WaypointRecord* records, uint16_t n);
+
+/**
+ * Check completeness and CRC; on OK the upload is closed and
+ * up->records[0..expected) is the new mission
+ */
+MissionUploadStatus MissionUpload_finish(MissionUpload* up);
+
+/**
+ * Drop an upload in progress
+ */
+void MissionUpload_abort(MissionUpload* up);
+
+#endif // MISSION_UPLOAD_H
@@ -0,0 +1,132 @@
+#include "MotorCal.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * MotorCal - Implementation
+ *
+ * @file MotorCal.cpp
+ */
+
+// ============================================================================
+// Private Helpers
+// ============================================================================
+
+static void beginStep(MotorCal* cal, uint8_t duty, uint32_t nowMs, int32_t counts) {
+    cal->duty = duty;
+    cal->stepStartMs = nowMs;
+    cal->stepCounts = counts;
+    cal->ampSum = 0.0f;
+    cal->ampSamples = 0;
+}
+
+static void finish(MotorCal* cal, MotorCalState state) {
+    cal->state = state;
+    if (state == MOTOR_CAL_DONE) cal->breakaway = cal->duty;
+    cal->duty = 0;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void MotorTrim_defaults(MotorTrimTable* table) {
+    memset(table, MOTOR_TRIM_INHERIT, sizeof(*table));
+}
+
+void MotorTrim_sanitize(MotorTrimTable* table) {
+    for (int i = 0; i < MOTOR_TRIM_MAX; i++) {
+        MotorTrim* t = &table->motors[i];
+        if (t->deadband != MOTOR_TRIM_INHERIT && t->deadband > MOTOR_TRIM_MAX_DEADBAND)
+            t->deadband = MOTOR_TRIM_MAX_DEADBAND;
+    }
+}
+
+uint8_t MotorTrim_resolve(uint8_t trim, uint8_t base) {
+    return trim == MOTOR_TRIM_INHERIT ? base : trim;
+}
+
+void MotorCal_start(MotorCal* cal, MotorCalFeedback feedback, uint32_t nowMs, int32_t counts) {
+    memset(cal, 0, sizeof(*cal));
+    cal->feedback = feedback;
+    if (feedback == MOTOR_CAL_FEEDBACK_CURRENT) {
+        cal->state = MOTOR_CAL_BASELINE;
+        beginStep(cal, 0, nowMs, counts);
+    } else {
+        cal->state = MOTOR_CAL_RAMP;
+        beginStep(cal, MOTOR_CAL_START_DUTY, nowMs, counts);
+    }
+}
+
+uint8_t MotorCal_update(MotorCal* cal, uint32_t nowMs, int32_t counts, float amps) {
+    if (!MotorCal_isRunning(cal)) return 0;
+
+    uint32_t held = nowMs - cal->stepStartMs;
+    if (!isnan(amps) && held >= MOTOR_CAL_SETTLE_MS) {
+        cal->ampSum += amps;
+        cal->ampSamples++;
+    }
+    if (held < MOTOR_CAL_STEP_MS) return cal->duty;
+
+    // Step over: judge it
+    if (cal->feedback == MOTOR_CAL_FEEDBACK_ENCODER) {
+        int32_t edges = counts - cal->stepCounts;
+        cal->lastCounts = edges < 0 ? -edges : edges;
+        if (cal->lastCounts >= MOTOR_CAL_COUNTS) {
+            finish(cal, MOTOR_CAL_DONE);
+            return 0;
+        }
+    } else {
+        // No sample in the whole step: keep holding until one arrives
+        if (cal->ampSamples == 0) return cal->duty;
+        float mean = cal->ampSum / cal->ampSamples;
+        if (cal->state == MOTOR_CAL_BASELINE) {
+            cal->baselineAmps = mean;
+            cal->state = MOTOR_CAL_RAMP;
+            beginStep(cal, MOTOR_CAL_START_DUTY, nowMs, counts);
+            return cal->duty;
+        }
+        float motorAmps = mean - cal->baselineAmps;
+        cal->lastAmps = motorAmps;
+        if (cal->peakAmps >= MOTOR_CAL_MIN_AMPS &&
+            motorAmps < cal->peakAmps * (1.0f - MOTOR_CAL_AMP_DROP)) {
+            finish(cal, MOTOR_CAL_DONE);
+            return 0;
+        }
+        if (motorAmps > cal->peakAmps) cal->peakAmps = motorAmps;
+    }
+
+    if (cal->duty + MOTOR_CAL_STEP_DUTY > MOTOR_CAL_MAX_DUTY) {
+        finish(cal, MOTOR_CAL_FAILED);
+        return 0;
+    }
+    beginStep(cal, (uint8_t)(cal->duty + MOTOR_CAL_STEP_DUTY), nowMs, counts);
+    return cal->duty;
+}
+
+void MotorCal_abort(MotorCal* cal) {
+    if (MotorCal_isRunning(cal)) {
+        cal->state = MOTOR_CAL_IDLE;
+        cal->duty = 0;
+    }
+}
+
+bool MotorCal_isRunning(const MotorCal* cal) {
+    return cal->state == MOTOR_CAL_BASELINE || cal->state == MOTOR_CAL_RAMP;
+}
+
+uint8_t MotorCal_minPwm(const MotorCal* cal) {
+    int pwm = cal->breakaway + MOTOR_CAL_MARGIN;
+    // 0xFF would read as "inherit"
+    return (uint8_t)(pwm >= MOTOR_TRIM_INHERIT ? MOTOR_TRIM_INHERIT - 1 : pwm);
+}
+
+const char* MotorCal_stateName(MotorCalState state) {
+    switch (state) {
+        case MOTOR_CAL_BASELINE: return "baseline";
+        case MOTOR_CAL_RAMP:     return "ramp";
+        case MOTOR_CAL_DONE:     return "done";
+        case MOTOR_CAL_FAILED:   return "failed";
+        default:                 return "idle";
+    }
+}
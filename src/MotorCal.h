@@ -0,0 +1,125 @@
+#ifndef MOTOR_CAL_H
+#define MOTOR_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * MotorCal - Breakaway duty calibration and per-motor trims
+ *
+ * MotorConfig's minPWM / deadband apply to every brushed motor of the
+ * vehicle, but motors and gearboxes differ: with one minPWM some creep at
+ * the lowest stick and others stall. A calibration drives one motor at a
+ * time up a duty staircase, from standstill, until its feedback says it
+ * turns:
+ *
+ *   encoder  MOTOR_CAL_COUNTS edges within one step
+ *   current  a stalled brushed motor's current rises with duty; once it
+ *            turns, back-EMF pulls it down: the step mean falls
+ *            MOTOR_CAL_AMP_DROP below the highest stalled step (pack
+ *            current less the baseline measured at duty 0 first)
+ *
+ * The breakaway duty (+ MOTOR_CAL_MARGIN) becomes that motor's minPWM in
+ * a MotorTrimTable; deadband can be trimmed per motor by hand. Trim
+ * fields left at MOTOR_TRIM_INHERIT follow MotorConfig.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file MotorCal.h
+ */
+
+#define MOTOR_TRIM_MAX          8       // Motors with a trim (Sub's thruster limit)
+#define MOTOR_TRIM_INHERIT      0xFF    // Field follows MotorConfig
+#define MOTOR_TRIM_CONFIG_KEY   "cfg_mtrim"
+#define MOTOR_TRIM_MAX_DEADBAND 50      // Of 100
+
+#define MOTOR_CAL_START_DUTY    8       // Of 255, first step
+#define MOTOR_CAL_STEP_DUTY     2       // Per step
+#define MOTOR_CAL_MAX_DUTY      160     // Nothing by here: give up (jammed, not wired)
+#define MOTOR_CAL_STEP_MS       300     // Hold per step
+#define MOTOR_CAL_SETTLE_MS     100     // Current samples before this are ignored
+#define MOTOR_CAL_COUNTS        8       // Encoder edges in one step = turning
+#define MOTOR_CAL_AMP_DROP      0.15f   // Fraction below the stalled peak = turning
+#define MOTOR_CAL_MIN_AMPS      0.05f   // Peak needed before a drop means anything
+#define MOTOR_CAL_MARGIN        2       // Duty added to the breakaway
+
+typedef enum {
+    MOTOR_CAL_FEEDBACK_ENCODER = 0,
+    MOTOR_CAL_FEEDBACK_CURRENT = 1
+} MotorCalFeedback;
+
+typedef enum {
+    MOTOR_CAL_IDLE = 0,
+    MOTOR_CAL_BASELINE,         // Duty 0: idle current
+    MOTOR_CAL_RAMP,
+    MOTOR_CAL_DONE,
+    MOTOR_CAL_FAILED            // No breakaway up to MOTOR_CAL_MAX_DUTY
+} MotorCalState;
+
+typedef struct {
+    uint8_t minPWM;             // Of 255, MOTOR_TRIM_INHERIT = MotorConfig
+    uint8_t deadband;           // Of 100, MOTOR_TRIM_INHERIT = MotorConfig
+} MotorTrim;
+
+typedef struct {
+    MotorTrim motors[MOTOR_TRIM_MAX];
+} MotorTrimTable;
+
+typedef struct {
+    MotorCalState state;
+    MotorCalFeedback feedback;
+    uint8_t duty;               // Step being held, of 255
+    uint32_t stepStartMs;
+    int32_t stepCounts;         // Encoder at the step's start
+
+    float ampSum;               // Settled samples of this step
+    uint16_t ampSamples;
+    float baselineAmps;
+    float peakAmps;             // Highest stalled step, less the baseline
+
+    uint8_t breakaway;          // Result, of 255 (DONE)
+    float lastAmps;             // Last step's mean less the baseline
+    int32_t lastCounts;         // Last step's edges
+} MotorCal;
+
+void MotorTrim_defaults(MotorTrimTable* table);
+
+/**
+ * Clamp a table into sane ranges (in place)
+ */
+void MotorTrim_sanitize(MotorTrimTable* table);
+
+/**
+ * Trimmed value, or the vehicle-wide one when the field inherits
+ */
+uint8_t MotorTrim_resolve(uint8_t trim, uint8_t base);
+
+/**
+ * Start a run for one motor (the caller has stopped the others)
+ * @param counts Encoder now (any value for current feedback)
+ */
+void MotorCal_start(MotorCal* cal, MotorCalFeedback feedback, uint32_t nowMs, int32_t counts);
+
+/**
+ * Advance one control tick
+ * @param counts Encoder now (encoder feedback)
+ * @param amps New pack current sample, NAN when none arrived this tick
+ * @return Duty to hold the motor at (forward, of 255); 0 once finished
+ */
+uint8_t MotorCal_update(MotorCal* cal, uint32_t nowMs, int32_t counts, float amps);
+
+/**
+ * Stop a run (the result stays unset)
+ */
+void MotorCal_abort(MotorCal* cal);
+
+bool MotorCal_isRunning(const MotorCal* cal);
+
+/**
+ * minPWM for the breakaway found (DONE only)
+ */
+uint8_t MotorCal_minPwm(const MotorCal* cal);
+
+const char* MotorCal_stateName(MotorCalState state);
+
+#endif // MOTOR_CAL_H
@@ -0,0 +1,18 @@
+#include "MotorMixer.h"
+
+/**
+ * MotorMixer - Frame table storage
+ *
+ * The tables are constexpr in the header; C++11 still needs one
+ * out-of-class definition each because the mixer takes their address.
+ *
+ * @file MotorMixer.cpp
+ */
+
+constexpr MixerRow MixerFrameQuadX::kTable[];
+constexpr MixerRow MixerFrameQuadPlus::kTable[];
+constexpr MixerRow MixerFrameHexX::kTable[];
+constexpr MixerRow MixerFrameOctoX::kTable[];
+constexpr MixerRow MixerFrameRover::kTable[];
+constexpr MixerRow MixerFrameSub3::kTable[];
+constexpr MixerRow MixerFrameSubVectored::kTable[];
@@ -0,0 +1,266 @@
+#ifndef MOTOR_MIXER_H
+#define MOTOR_MIXER_H
+
+#include "FastMath.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * MotorMixer - Table-driven motor / thruster mixer
+ *
+ * Every frame is a constexpr table with one row per output; each row
+ * holds that output's coefficient for every control axis:
+ *
+ *   out[i] = sum over axes of kTable[i].k[axis] * in[axis]
+ *
+ * The row loop is unrolled at compile time (MixerRows<> recursion), so a
+ * quad mix compiles down to straight-line multiply-adds against constants.
+ *
+ * Desaturation is done in one pass and keeps yaw (and roll / pitch)
+ * authority, taking the error out of the frame's give-way axis instead:
+ * 1. Attitude part (all axes but the give-way one): if its spread is wider
+ *    than the output range, scale it down, preserving the axis ratios
+ * 2. Give-way axis (Frame::kGiveWayAxis):
+ *    - collective frames (multirotors, every output carries the same
+ *      thrust) shift it into the headroom left by the attitude part
+ *    - other frames (rover, sub) scale it down until every output fits
+ *
+ * Adding a frame is a new struct with kOutputs, kGiveWayAxis, kCollective
+ * and kTable (plus its one-line definition in MotorMixer.cpp).
+ *
+ * Axis conventions: roll + = right side down, pitch + = nose up,
+ * yaw + = nose right, thrust + = up, forward + = ahead, lateral + = right.
+ *
+ * Out = float gives -1..1; Out = int16_t gives Motor::setSpeed units
+ * (+-MIXER_INT_SCALE). The mix itself runs in float (ESP32 has an FPU).
+ *
+ * @file MotorMixer.h
+ */
+
+// Templates are instantiated in the vehicles: keep them float-only there
+#pragma GCC diagnostic push
+FAST_MATH_FLOAT_ONLY
+
+#define MIXER_INT_SCALE 100     // Motor::setSpeed range
+
+enum MixerAxis : uint8_t {
+  MIXER_ROLL = 0,
+  MIXER_PITCH,
+  MIXER_YAW,
+  MIXER_THRUST,     // Vertical / collective
+  MIXER_FORWARD,
+  MIXER_LATERAL,
+  MIXER_AXIS_COUNT
+};
+
+/**
+ * Coefficients of one output
+ */
+struct MixerRow {
+  float k[MIXER_AXIS_COUNT];    // roll, pitch, yaw, thrust, forward, lateral
+};
+
+// ============================================================================
+// Frames
+// ============================================================================
+
+// FL(1) \ / FR(0)
+//        X
+// BL(2) / \ BR(3)
+struct MixerFrameQuadX {
+  static constexpr uint8_t kOutputs = 4;
+  static constexpr uint8_t kGiveWayAxis = MIXER_THRUST;
+  static constexpr bool kCollective = true;
+  static constexpr MixerRow kTable[kOutputs] = {
+      {{-1.0f,  1.0f, -1.0f, 1.0f, 0.0f, 0.0f}},    // FR
+      {{ 1.0f,  1.0f,  1.0f, 1.0f, 0.0f, 0.0f}},    // FL
+      {{ 1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f}},    // BL
+      {{-1.0f, -1.0f,  1.0f, 1.0f, 0.0f, 0.0f}},    // BR
+  };
+};
+
+// Front, left, back, right
+struct MixerFrameQuadPlus {
+  static constexpr uint8_t kOutputs = 4;
+  static constexpr uint8_t kGiveWayAxis = MIXER_THRUST;
+  static constexpr bool kCollective = true;
+  static constexpr MixerRow kTable[kOutputs] = {
+      {{ 0.0f,  1.0f, -1.0f, 1.0f, 0.0f, 0.0f}},    // F
+      {{ 1.0f,  0.0f,  1.0f, 1.0f, 0.0f, 0.0f}},    // L
+      {{ 0.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f}},    // B
+      {{-1.0f,  0.0f,  1.0f, 1.0f, 0.0f, 0.0f}},    // R
+  };
+};
+
+// Clockwise from the front-right arm (30 deg), alternating spin
+struct MixerFrameHexX {
+  static constexpr uint8_t kOutputs = 6;
+  static constexpr uint8_t kGiveWayAxis = MIXER_THRUST;
+  static constexpr bool kCollective = true;
+  static constexpr MixerRow kTable[kOutputs] = {
+      {{-0.5f,  0.866f, -1.0f, 1.0f, 0.0f, 0.0f}},  // 30
+      {{-1.0f,  0.0f,    1.0f, 1.0f, 0.0f, 0.0f}},  // 90
+      {{-0.5f, -0.866f, -1.0f, 1.0f, 0.0f, 0.0f}},  // 150
+      {{ 0.5f, -0.866f,  1.0f, 1.0f, 0.0f, 0.0f}},  // 210
+      {{ 1.0f,  0.0f,   -1.0f, 1.0f, 0.0f, 0.0f}},  // 270
+      {{ 0.5f,  0.866f,  1.0f, 1.0f, 0.0f, 0.0f}},  // 330
+  };
+};
+
+// Clockwise from 22.5 deg, alternating spin
+struct MixerFrameOctoX {
+  static constexpr uint8_t kOutputs = 8;
+  static constexpr uint8_t kGiveWayAxis = MIXER_THRUST;
+  static constexpr bool kCollective = true;
+  static constexpr MixerRow kTable[kOutputs] = {
+      {{-0.383f,  0.924f, -1.0f, 1.0f, 0.0f, 0.0f}},    // 22.5
+      {{-0.924f,  0.383f,  1.0f, 1.0f, 0.0f, 0.0f}},    // 67.5
+      {{-0.924f, -0.383f, -1.0f, 1.0f, 0.0f, 0.0f}},    // 112.5
+      {{-0.383f, -0.924f,  1.0f, 1.0f, 0.0f, 0.0f}},    // 157.5
+      {{ 0.383f, -0.924f, -1.0f, 1.0f, 0.0f, 0.0f}},    // 202.5
+      {{ 0.924f, -0.383f,  1.0f, 1.0f, 0.0f, 0.0f}},    // 247.5
+      {{ 0.924f,  0.383f, -1.0f, 1.0f, 0.0f, 0.0f}},    // 292.5
+      {{ 0.383f,  0.924f,  1.0f, 1.0f, 0.0f, 0.0f}},    // 337.5
+  };
+};
+
+// Skid steer: left, right
+struct MixerFrameRover {
+  static constexpr uint8_t kOutputs = 2;
+  static constexpr uint8_t kGiveWayAxis = MIXER_FORWARD;
+  static constexpr bool kCollective = false;
+  static constexpr MixerRow kTable[kOutputs] = {
+      {{0.0f, 0.0f,  1.0f, 0.0f, 1.0f, 0.0f}},      // Left
+      {{0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f}},      // Right
+  };
+};
+
+// Current Sub hardware: forward, yaw and vertical thruster
+struct MixerFrameSub3 {
+  static constexpr uint8_t kOutputs = 3;
+  static constexpr uint8_t kGiveWayAxis = MIXER_FORWARD;
+  static constexpr bool kCollective = false;
+  static constexpr MixerRow kTable[kOutputs] = {
+      {{0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f}},       // Forward
+      {{0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f}},       // Yaw
+      {{0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f}},       // Vertical
+  };
+};
+
+// Vectored ROV: 4 horizontal thrusters at 45 deg + 2 vertical
+struct MixerFrameSubVectored {
+  static constexpr uint8_t kOutputs = 6;
+  static constexpr uint8_t kGiveWayAxis = MIXER_FORWARD;
+  static constexpr bool kCollective = false;
+  static constexpr MixerRow kTable[kOutputs] = {
+      {{ 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, -1.0f}},    // Front right
+      {{ 0.0f, 0.0f,  1.0f, 0.0f, 1.0f,  1.0f}},    // Front left
+      {{ 0.0f, 0.0f,  1.0f, 0.0f, 1.0f, -1.0f}},    // Back left
+      {{ 0.0f, 0.0f, -1.0f, 0.0f, 1.0f,  1.0f}},    // Back right
+      {{ 1.0f, 0.0f,  0.0f, 1.0f, 0.0f,  0.0f}},    // Vertical left
+      {{-1.0f, 0.0f,  0.0f, 1.0f, 0.0f,  0.0f}},    // Vertical right
+  };
+};
+
+// ============================================================================
+// Mixer Engine
+// ============================================================================
+
+// Row i: attitude part into m[i], give-way part into g[i], then row i + 1
+template <typename Frame, uint8_t I, uint8_t N> struct MixerRows {
+  static inline void mix(const float *in, float *m, float *g) {
+    const MixerRow &row = Frame::kTable[I];
+    float sum = 0.0f;
+    for (uint8_t axis = 0; axis < MIXER_AXIS_COUNT; axis++) {
+      if (axis != Frame::kGiveWayAxis) sum += row.k[axis] * in[axis];
+    }
+    m[I] = sum;
+    g[I] = row.k[Frame::kGiveWayAxis] * in[Frame::kGiveWayAxis];
+    MixerRows<Frame, I + 1, N>::mix(in, m, g);
+  }
+};
+
+template <typename Frame, uint8_t N> struct MixerRows<Frame, N, N> {
+  static inline void mix(const float *, float *, float *) {}
+};
+
+template <typename Out> struct MixerOutput {
+  static inline Out convert(float v) { return v; }
+};
+
+template <> struct MixerOutput<int16_t> {
+  static inline int16_t convert(float v) { return (int16_t)lroundf(v * MIXER_INT_SCALE); }
+};
+
+template <typename Frame, typename Out = float> class MotorMixer {
+public:
+  static constexpr uint8_t kOutputs = Frame::kOutputs;
+
+  /**
+   * @param outMin Lowest output (-1 for reversible drives, 0 for ESCs)
+   * @param outMax Highest output
+   */
+  explicit MotorMixer(float outMin = -1.0f, float outMax = 1.0f)
+      : _outMin(outMin), _outMax(outMax), _saturated(false) {}
+
+  /**
+   * Mix one set of commands
+   * @param in Axis commands (MIXER_* order), normalized -1..1
+   * @param out Output per row of the frame table
+   */
+  void mix(const float in[MIXER_AXIS_COUNT], Out out[kOutputs]) {
+    float m[kOutputs], g[kOutputs];
+    MixerRows<Frame, 0, kOutputs>::mix(in, m, g);
+
+    float lo = m[0], hi = m[0];
+    for (uint8_t i = 1; i < kOutputs; i++) {
+      lo = m[i] < lo ? m[i] : lo;
+      hi = m[i] > hi ? m[i] : hi;
+    }
+
+    // 1. Fit the attitude spread into the output range
+    float span = _outMax - _outMin;
+    float scale = (hi - lo) > span ? span / (hi - lo) : 1.0f;
+    _saturated = scale < 1.0f;
+
+    if (Frame::kCollective) {
+      // 2a. Shift the shared thrust into the remaining headroom
+      float thrust = g[0];
+      float minThrust = _outMin - lo * scale;
+      float maxThrust = _outMax - hi * scale;
+      if (thrust < minThrust) thrust = minThrust, _saturated = true;
+      if (thrust > maxThrust) thrust = maxThrust, _saturated = true;
+      for (uint8_t i = 0; i < kOutputs; i++) {
+        out[i] = MixerOutput<Out>::convert(m[i] * scale + thrust);
+      }
+    } else {
+      // 2b. Shrink the give-way axis until every output fits
+      float k = 1.0f;
+      for (uint8_t i = 0; i < kOutputs; i++) {
+        float v = m[i] * scale;
+        if (v + g[i] > _outMax && g[i] > 0.0f) k = fminf(k, (_outMax - v) / g[i]);
+        if (v + g[i] < _outMin && g[i] < 0.0f) k = fminf(k, (_outMin - v) / g[i]);
+      }
+      if (k < 0.0f) k = 0.0f;
+      _saturated = _saturated || k < 1.0f;
+      for (uint8_t i = 0; i < kOutputs; i++) {
+        out[i] = MixerOutput<Out>::convert(m[i] * scale + g[i] * k);
+      }
+    }
+  }
+
+  /**
+   * @return true if the last mix had to give up authority
+   */
+  bool isSaturated() const { return _saturated; }
+
+private:
+  float _outMin;
+  float _outMax;
+  bool _saturated;
+};
+
+#pragma GCC diagnostic pop
+
+#endif // MOTOR_MIXER_H
@@ -0,0 +1,101 @@
+#ifndef NA_FLEET_OTA_H
+#define NA_FLEET_OTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "NAPacketAEAD.h"
+#include "NAHandshakeX25519.h"
+#include "NAFormationBeacon.h"
+#include "FleetOta.h"
+
+/**
+ * NAFleetOta - Fleet firmware distribution frames (ESP-NOW broadcast)
+ *
+ * Announce (108 bytes): the image being served, sent every
+ *   FLEET_OTA_ANNOUNCE_MS. Carries the SHA-256 of the whole image and
+ *   the ECDSA P-256 signature over it, so a receiver checks the sender's
+ *   claim against its own signing key before it erases anything.
+ * Chunk (208 bytes): FLEET_OTA_CHUNK_SIZE image bytes at index * size;
+ *   always full length, the last chunk is padded.
+ * NACK (40 bytes): chunks a receiver is missing in one window.
+ *
+ * None of them is authenticated on its own: a forged chunk or NACK can
+ * only waste airtime or fail the final hash check. Told apart from every
+ * other frame by length.
+ *
+ * @file NAFleetOta.h
+ */
+
+#define NA_FLEET_ANNOUNCE_TYPE  0xF0
+#define NA_FLEET_CHUNK_TYPE     0xF1
+#define NA_FLEET_NACK_TYPE      0xF2
+
+#define NA_FLEET_HASH_SIZE      32
+#define NA_FLEET_SIG_SIZE       64
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t protocolVersion;
+    uint8_t type;                   // NA_FLEET_ANNOUNCE_TYPE
+    uint32_t imageId;               // First 4 bytes of the SHA-256
+    uint32_t imageSize;
+    uint8_t sha256[NA_FLEET_HASH_SIZE];
+    uint8_t signature[NA_FLEET_SIG_SIZE];
+    uint16_t checksum;              // CRC16 over every byte above
+} NAFleetAnnounce;
+
+typedef struct {
+    uint8_t protocolVersion;
+    uint8_t type;                   // NA_FLEET_CHUNK_TYPE
+    uint32_t imageId;
+    uint16_t index;
+    uint8_t data[FLEET_OTA_CHUNK_SIZE];
+} NAFleetChunk;
+
+typedef struct {
+    uint8_t protocolVersion;
+    uint8_t type;                   // NA_FLEET_NACK_TYPE
+    uint32_t imageId;
+    uint16_t base;                  // First chunk of the window
+    uint8_t bits[FLEET_OTA_NACK_BITS / 8];  // Bit i set: chunk base + i missing
+} NAFleetNack;
+#pragma pack(pop)
+
+static_assert(sizeof(NAFleetChunk) <= 250, "Chunk must fit one ESP-NOW frame");
+
+#define NA_FLEET_ASSERT_DISTINCT(T)                                                     \
+    static_assert(sizeof(T) != sizeof(NAPacket) && sizeof(T) != sizeof(NAHandshakePacket) && \
+                      sizeof(T) != sizeof(NAPacketAEAD) &&                              \
+                      sizeof(T) != sizeof(NAHandshakeX25519) &&                         \
+                      sizeof(T) != sizeof(NAFormationBeacon),                           \
+                  #T " must be distinguishable by length")
+NA_FLEET_ASSERT_DISTINCT(NAFleetAnnounce);
+NA_FLEET_ASSERT_DISTINCT(NAFleetChunk);
+NA_FLEET_ASSERT_DISTINCT(NAFleetNack);
+
+static inline uint32_t NA_Fleet_imageId(const uint8_t* sha256) {
+    uint32_t id;
+    memcpy(&id, sha256, sizeof(id));
+    return id;
+}
+
+static inline void NA_Fleet_buildAnnounce(NAFleetAnnounce* frame, uint32_t imageSize,
+                                          const uint8_t* sha256, const uint8_t* signature) {
+    frame->protocolVersion = PROTOCOL_VERSION;
+    frame->type = NA_FLEET_ANNOUNCE_TYPE;
+    frame->imageId = NA_Fleet_imageId(sha256);
+    frame->imageSize = imageSize;
+    memcpy(frame->sha256, sha256, NA_FLEET_HASH_SIZE);
+    memcpy(frame->signature, signature, NA_FLEET_SIG_SIZE);
+    frame->checksum = NA_CRC16((const uint8_t*)frame, offsetof(NAFleetAnnounce, checksum));
+}
+
+static inline bool NA_Fleet_announceValid(const NAFleetAnnounce* frame) {
+    return frame->protocolVersion == PROTOCOL_VERSION && frame->type == NA_FLEET_ANNOUNCE_TYPE &&
+           frame->imageId == NA_Fleet_imageId(frame->sha256) &&
+           frame->checksum == NA_CRC16((const uint8_t*)frame, offsetof(NAFleetAnnounce, checksum));
+}
+
+#endif // NA_FLEET_OTA_H
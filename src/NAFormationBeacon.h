@@ -0,0 +1,103 @@
+#ifndef NA_FORMATION_BEACON_H
+#define NA_FORMATION_BEACON_H
+
+#include <stdint.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "NAPacketAEAD.h"
+#include "NAHandshakeX25519.h"
+#include "FormationTable.h"
+
+/**
+ * NAFormationBeacon - Vehicle-to-vehicle state beacon (ESP-NOW broadcast)
+ *
+ * 33 bytes: position as the GPS fix (each receiver projects it into its
+ * own local frame), velocity in cm/s, heading in centidegrees and the
+ * mission item. The tag is HMAC-SHA256 under the formation key (derived
+ * from the shared secret), truncated to 8 bytes: beacons are
+ * broadcast-only, rate bound, and a forgery only moves a follower's aim
+ * point for one beacon interval.
+ *
+ * Vehicles of another group (same key, other convoy) are ignored before
+ * the tag is checked. Told apart from every other frame by length.
+ *
+ * @file NAFormationBeacon.h
+ */
+
+#define NA_BEACON_TYPE          0xB5
+#define NA_BEACON_TAG_SIZE      8
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t protocolVersion;
+    uint8_t type;                   // NA_BEACON_TYPE
+    uint8_t group;                  // Formation group
+    uint8_t vehicleType;
+    uint8_t flags;                  // FORMATION_FLAG_*
+    uint32_t sequence;              // Per sender, increasing
+    int32_t latE7;
+    int32_t lngE7;
+    int16_t velEast;                // cm/s
+    int16_t velNorth;
+    uint16_t heading;               // Centidegrees, 0-35999
+    uint16_t missionIndex;
+    uint8_t tag[NA_BEACON_TAG_SIZE];    // Over every byte above
+} NAFormationBeacon;
+#pragma pack(pop)
+
+#define NA_BEACON_AUTH_SIZE     (sizeof(NAFormationBeacon) - NA_BEACON_TAG_SIZE)
+
+static_assert(sizeof(NAFormationBeacon) != sizeof(NAPacket),
+              "Beacon must be distinguishable by length");
+static_assert(sizeof(NAFormationBeacon) != sizeof(NAHandshakePacket),
+              "Beacon must be distinguishable by length");
+static_assert(sizeof(NAFormationBeacon) != sizeof(NAPacketAEAD),
+              "Beacon must be distinguishable by length");
+static_assert(sizeof(NAFormationBeacon) != sizeof(NAHandshakeX25519),
+              "Beacon must be distinguishable by length");
+
+static inline int16_t NA_Beacon_toCms(float mps) {
+    float cms = mps * 100.0f;
+    if (cms > 32767.0f) return 32767;
+    if (cms < -32767.0f) return -32767;
+    return (int16_t)cms;
+}
+
+/**
+ * Fill a beacon (tag left for the caller)
+ */
+static inline void NA_Beacon_build(NAFormationBeacon* frame, uint8_t group, uint32_t sequence,
+                                   const FormationState* state) {
+    float heading = state->heading;
+    while (heading < 0.0f) heading += 360.0f;
+    while (heading >= 360.0f) heading -= 360.0f;
+
+    frame->protocolVersion = PROTOCOL_VERSION;
+    frame->type = NA_BEACON_TYPE;
+    frame->group = group;
+    frame->vehicleType = state->vehicleType;
+    frame->flags = state->flags;
+    frame->sequence = sequence;
+    frame->latE7 = state->latE7;
+    frame->lngE7 = state->lngE7;
+    frame->velEast = NA_Beacon_toCms(state->velEast);
+    frame->velNorth = NA_Beacon_toCms(state->velNorth);
+    frame->heading = (uint16_t)(heading * 100.0f) % 36000;
+    frame->missionIndex = state->missionIndex;
+}
+
+/**
+ * Decode a beacon's state
+ */
+static inline void NA_Beacon_toState(const NAFormationBeacon* frame, FormationState* state) {
+    state->latE7 = frame->latE7;
+    state->lngE7 = frame->lngE7;
+    state->velEast = frame->velEast * 0.01f;
+    state->velNorth = frame->velNorth * 0.01f;
+    state->heading = frame->heading * 0.01f;
+    state->missionIndex = frame->missionIndex;
+    state->vehicleType = frame->vehicleType;
+    state->flags = frame->flags;
+}
+
+#endif // NA_FORMATION_BEACON_H
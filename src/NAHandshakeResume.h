@@ -0,0 +1,69 @@
+#ifndef NA_HANDSHAKE_RESUME_H
+#define NA_HANDSHAKE_RESUME_H
+
+#include <stdint.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "NAPacketAEAD.h"
+#include "NAHandshakeX25519.h"
+#include "NAFormationBeacon.h"
+#include "SessionResume.h"
+
+/**
+ * NAHandshakeResume - Session resumption frame (no ECDH)
+ *
+ * After an NA_KX_VERSION_X25519_HKDF handshake both ends hold a
+ * resumption secret and a ticket id (derivations in SessionResume.h).
+ * A controller that lost the link sends:
+ *   INIT   ticketId, controller nonce, binder tag (proves the secret)
+ * and the vehicle answers:
+ *   PUBKEY ticketId, vehicle nonce, accept tag (proves it, too)
+ * Both then derive the new session from the secret and the two nonces.
+ * No answer (unknown, expired or already used ticket): full handshake.
+ * 49 bytes, distinct from every other radio frame.
+ *
+ * @file NAHandshakeResume.h
+ */
+
+#define NA_KX_VERSION_RESUME        4
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t protocolVersion;
+    uint8_t type;                                   // PACKET_TYPE_HANDSHAKE_INIT / _PUBKEY
+    uint8_t kxVersion;                              // NA_KX_VERSION_RESUME
+    uint8_t ticketId[SESSION_RESUME_ID_SIZE];
+    uint8_t nonce[SESSION_RESUME_NONCE_SIZE];       // Sender's
+    uint8_t tag[SESSION_RESUME_TAG_SIZE];           // Binder (INIT) / accept (PUBKEY)
+    uint16_t checksum;                              // NA_CRC16 over the bytes above
+} NAHandshakeResume;
+#pragma pack(pop)
+
+static_assert(sizeof(NAHandshakeResume) != sizeof(NAHandshakePacket),
+              "Resume frame must be distinguishable by length");
+static_assert(sizeof(NAHandshakeResume) != sizeof(NAHandshakeX25519),
+              "Resume frame must be distinguishable by length");
+static_assert(sizeof(NAHandshakeResume) != sizeof(NAPacket),
+              "Resume frame must be distinguishable by length");
+static_assert(sizeof(NAHandshakeResume) != sizeof(NAPacketAEAD),
+              "Resume frame must be distinguishable by length");
+static_assert(sizeof(NAHandshakeResume) != sizeof(NAFormationBeacon),
+              "Resume frame must be distinguishable by length");
+
+/**
+ * Fill a frame and its checksum
+ * @param type PACKET_TYPE_HANDSHAKE_INIT or PACKET_TYPE_HANDSHAKE_PUBKEY
+ */
+static inline void NA_Resume_buildFrame(NAHandshakeResume* frame, uint8_t type,
+                                        const uint8_t* ticketId, const uint8_t* nonce,
+                                        const uint8_t* tag) {
+    frame->protocolVersion = PROTOCOL_VERSION;
+    frame->type = type;
+    frame->kxVersion = NA_KX_VERSION_RESUME;
+    memcpy(frame->ticketId, ticketId, SESSION_RESUME_ID_SIZE);
+    memcpy(frame->nonce, nonce, SESSION_RESUME_NONCE_SIZE);
+    memcpy(frame->tag, tag, SESSION_RESUME_TAG_SIZE);
+    frame->checksum = NA_CRC16((uint8_t*)frame, sizeof(NAHandshakeResume) - 2);
+}
+
+#endif // NA_HANDSHAKE_RESUME_H
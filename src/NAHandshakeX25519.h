@@ -0,0 +1,63 @@
+#ifndef NA_HANDSHAKE_X25519_H
+#define NA_HANDSHAKE_X25519_H
+
+#include <stdint.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "NAPacketAEAD.h"
+
+/**
+ * NAHandshakeX25519 - Compact X25519 handshake frame
+ *
+ * Same INIT / PUBKEY exchange as NAHandshakePacket, with a 32-byte X25519
+ * public key instead of the 64-byte P-256 point. The kxVersion field names
+ * the key agreement so later versions can reuse the frame; the responder
+ * always answers with the version the initiator chose:
+ *   NA_KX_VERSION_X25519       raw shared secret as the key (like P-256)
+ *   NA_KX_VERSION_X25519_HKDF  SessionKeys: HKDF directional keys + ratchet
+ *
+ * Controllers that only speak P-256 keep sending NAHandshakePacket; the
+ * receiver tells the two apart by frame length.
+ *
+ * @file NAHandshakeX25519.h
+ */
+
+#define NA_KX_VERSION_P256      1   // Legacy NAHandshakePacket (implicit)
+#define NA_KX_VERSION_X25519    2
+#define NA_KX_VERSION_X25519_HKDF 3
+
+#define NA_X25519_KEY_SIZE      32
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t protocolVersion;
+    uint8_t type;                           // PACKET_TYPE_HANDSHAKE_INIT / _PUBKEY
+    uint8_t kxVersion;                      // NA_KX_VERSION_X25519*
+    uint8_t publicKey[NA_X25519_KEY_SIZE];  // u coordinate, little-endian
+    uint16_t checksum;                      // NA_CRC16 over the bytes above
+} NAHandshakeX25519;
+#pragma pack(pop)
+
+static_assert(sizeof(NAHandshakeX25519) != sizeof(NAHandshakePacket),
+              "X25519 handshake must be distinguishable by length");
+static_assert(sizeof(NAHandshakeX25519) != sizeof(NAPacket),
+              "X25519 handshake must be distinguishable by length");
+static_assert(sizeof(NAHandshakeX25519) != sizeof(NAPacketAEAD),
+              "X25519 handshake must be distinguishable by length");
+
+/**
+ * Fill a frame and its checksum
+ * @param type PACKET_TYPE_HANDSHAKE_INIT or PACKET_TYPE_HANDSHAKE_PUBKEY
+ * @param kxVersion NA_KX_VERSION_X25519 or NA_KX_VERSION_X25519_HKDF
+ * @param publicKey 32-byte X25519 public key
+ */
+static inline void NA_X25519_buildFrame(NAHandshakeX25519* frame, uint8_t type,
+                                        uint8_t kxVersion, const uint8_t* publicKey) {
+    frame->protocolVersion = PROTOCOL_VERSION;
+    frame->type = type;
+    frame->kxVersion = kxVersion;
+    memcpy(frame->publicKey, publicKey, NA_X25519_KEY_SIZE);
+    frame->checksum = NA_CRC16((uint8_t*)frame, sizeof(NAHandshakeX25519) - 2);
+}
+
+#endif // NA_HANDSHAKE_X25519_H
@@ -0,0 +1,107 @@
+#ifndef NA_PACKET_AEAD_H
+#define NA_PACKET_AEAD_H
+
+#include <stdint.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "EncryptionManager.h"
+
+/**
+ * NAPacketAEAD - Compact AES-256-GCM control frame
+ *
+ * Replaces IV (16) + HMAC (32) + CRC (2) of the legacy NAPacket with a
+ * 12-byte nonce and 16-byte GCM tag. The clear header is bound to the tag
+ * as AAD, so the tag also covers version, vehicle type and sequence number.
+ *
+ * Controllers that only speak CTR+HMAC keep sending NAPacket
+ * (encryptionFlag = NA_ENCRYPTION_CTR_HMAC); the receiver tells the two
+ * apart by frame length.
+ *
+ * @file NAPacketAEAD.h
+ */
+
+#define NA_ENCRYPTION_NONE      0
+#define NA_ENCRYPTION_CTR_HMAC  1   // Legacy: AES-CTR + HMAC-SHA256
+#define NA_ENCRYPTION_AEAD      2   // AES-256-GCM
+#define NA_ENCRYPTION_COMPACT   3   // NAPacketCompact, unpacked (never on air)
+#define NA_ENCRYPTION_LINK      4   // NAPacket in clear, ESP-NOW CCMP below it
+
+#define NA_AEAD_PAYLOAD_SIZE    10  // throttle..buttons
+#define NA_AEAD_AAD_SIZE        7   // protocolVersion..sequenceNumber
+
+#pragma pack(push, 1)
+typedef struct {
+    // Clear header (AAD)
+    uint8_t protocolVersion;
+    uint8_t vehicleType;
+    uint8_t encryptionFlag;                 // NA_ENCRYPTION_AEAD
+    uint32_t sequenceNumber;
+
+    uint8_t nonce[AES_GCM_NONCE_SIZE];
+    uint8_t payload[NA_AEAD_PAYLOAD_SIZE];  // Encrypted throttle..buttons
+    uint8_t tag[AES_GCM_TAG_SIZE];
+} NAPacketAEAD;
+#pragma pack(pop)
+
+static_assert(sizeof(NAPacketAEAD) != sizeof(NAPacket),
+              "AEAD frame must be distinguishable by length");
+static_assert(sizeof(NAPacketAEAD) != sizeof(NAHandshakePacket),
+              "AEAD frame must be distinguishable by length");
+
+/**
+ * Unpack an AEAD frame into an NAPacket (no crypto, safe in Wi-Fi callback)
+ *
+ * Nonce and tag are carried in the iv / hmac fields until the control task
+ * verifies the frame with NA_AEAD_decryptPacket().
+ */
+static inline void NA_AEAD_toPacket(const NAPacketAEAD* frame, NAPacket* pkt) {
+    memset(pkt, 0, sizeof(NAPacket));
+    pkt->protocolVersion = frame->protocolVersion;
+    pkt->vehicleType = frame->vehicleType;
+    pkt->encryptionFlag = frame->encryptionFlag;
+    pkt->sequenceNumber = frame->sequenceNumber;
+    memcpy(&pkt->throttle, frame->payload, NA_AEAD_PAYLOAD_SIZE);
+    memcpy(pkt->iv, frame->nonce, AES_GCM_NONCE_SIZE);
+    memcpy(pkt->hmac, frame->tag, AES_GCM_TAG_SIZE);
+}
+
+/**
+ * Rebuild the clear header bound to the tag
+ * @param pkt Unpacked packet
+ * @param aad Output buffer (NA_AEAD_AAD_SIZE bytes)
+ */
+static inline void NA_AEAD_buildAAD(const NAPacket* pkt, uint8_t* aad) {
+    aad[0] = pkt->protocolVersion;
+    aad[1] = pkt->vehicleType;
+    aad[2] = pkt->encryptionFlag;
+    memcpy(&aad[3], &pkt->sequenceNumber, sizeof(uint32_t));
+}
+
+/**
+ * Verify and decrypt an unpacked AEAD packet in place
+ * @param pkt Packet produced by NA_AEAD_toPacket()
+ * @return true if the tag is valid
+ */
+static inline bool NA_AEAD_decryptPacket(NAPacket* pkt) {
+    uint8_t aad[NA_AEAD_AAD_SIZE];
+    NA_AEAD_buildAAD(pkt, aad);
+    return EncryptionManager_aeadDecrypt(
+        (const uint8_t*)&pkt->throttle, NA_AEAD_PAYLOAD_SIZE, pkt->iv,
+        aad, NA_AEAD_AAD_SIZE, pkt->hmac, (uint8_t*)&pkt->throttle);
+}
+
+/**
+ * Verify and decrypt in place under the key of one radio peer
+ * @param set EncryptionManager peer key set (PeerSessionTable slot)
+ * @param pkt Packet produced by NA_AEAD_toPacket()
+ * @return true if the tag is valid
+ */
+static inline bool NA_AEAD_decryptPacketFrom(uint8_t set, NAPacket* pkt) {
+    uint8_t aad[NA_AEAD_AAD_SIZE];
+    NA_AEAD_buildAAD(pkt, aad);
+    return EncryptionManager_aeadDecryptFrom(
+        set, (const uint8_t*)&pkt->throttle, NA_AEAD_PAYLOAD_SIZE, pkt->iv,
+        aad, NA_AEAD_AAD_SIZE, pkt->hmac, (uint8_t*)&pkt->throttle);
+}
+
+#endif // NA_PACKET_AEAD_H
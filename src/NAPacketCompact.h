@@ -0,0 +1,194 @@
+#ifndef NA_PACKET_COMPACT_H
+#define NA_PACKET_COMPACT_H
+
+#include <stdint.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "NAPacketAEAD.h"
+#include "NAHandshakeX25519.h"
+#include "NAHandshakeResume.h"
+#include "NAFormationBeacon.h"
+#include "EncryptionManager.h"
+
+/**
+ * NAPacketCompact - 19-byte high-rate control frame
+ *
+ * A full control frame spends 45 (AEAD) or more bytes on air for 10
+ * bytes of sticks. For 250-500 Hz control the compact frame carries only
+ * what changes from frame to frame:
+ *
+ *   | type (0xC7) | sequence (low 16 bits) | payload (8) | tag (8) |
+ *
+ *   payload  throttle, roll, pitch, yaw as 12-bit two's complement
+ *            (-2048..2047, little-endian bit stream), mode, buttons;
+ *            AES-256-GCM encrypted under the peer's session key
+ *   tag      GCM tag truncated to 64 bits
+ *
+ * Nothing else is sent. The receiver rebuilds the full 32-bit sequence
+ * number from the low 16 bits and the highest one its replay window has
+ * accepted (nearest match), and the nonce and AAD are derived from it:
+ *
+ *   nonce  "NACF" | 0 0 0 0 | sequence (LE)
+ *   AAD    type | protocol version | sequence (LE)
+ *
+ * so a frame rebuilt to the wrong sequence fails its tag rather than
+ * being taken for another. Full frames (NAPacketAEAD) must never use a
+ * nonce with the NACF prefix.
+ *
+ * The sender interleaves a full frame at least every
+ * NA_COMPACT_RESYNC_FRAMES: it carries the whole sequence number and
+ * resynchronizes a receiver whose window has reset (1 s without frames,
+ * new session). Compact frames arriving before that are dropped.
+ *
+ * Only keyed peer sessions take compact frames. The controller learns
+ * that this vehicle does from LINK_RATE_FLAG_COMPACT in the rate
+ * proposals and answers with the same flag when it will send them.
+ *
+ * @file NAPacketCompact.h
+ */
+
+#ifndef NA_COMPACT_CONTROL
+#define NA_COMPACT_CONTROL          1       // 0: not advertised, frames dropped
+#endif
+
+#define NA_COMPACT_TYPE             0xC7
+#define NA_COMPACT_PAYLOAD_SIZE     8       // 4 x 12-bit axes, mode, buttons
+#define NA_COMPACT_TAG_SIZE         8       // Truncated GCM tag
+#define NA_COMPACT_AAD_SIZE         6
+#define NA_COMPACT_AXIS_MIN         -2048
+#define NA_COMPACT_AXIS_MAX         2047
+#define NA_COMPACT_RESYNC_FRAMES    50      // Full frame at least this often
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t type;                               // NA_COMPACT_TYPE
+    uint16_t sequence;                          // Low 16 bits
+    uint8_t payload[NA_COMPACT_PAYLOAD_SIZE];   // Encrypted
+    uint8_t tag[NA_COMPACT_TAG_SIZE];
+} NAPacketCompact;
+#pragma pack(pop)
+
+static_assert(NA_COMPACT_PAYLOAD_SIZE <= sizeof(((NAPacket*)0)->iv) &&
+              NA_COMPACT_TAG_SIZE <= sizeof(((NAPacket*)0)->hmac),
+              "Compact fields are carried in iv / hmac until verified");
+static_assert(sizeof(NAPacketCompact) != sizeof(NAPacket),
+              "Compact frame must be distinguishable by length");
+static_assert(sizeof(NAPacketCompact) != sizeof(NAPacketAEAD),
+              "Compact frame must be distinguishable by length");
+static_assert(sizeof(NAPacketCompact) != sizeof(NAHandshakePacket),
+              "Compact frame must be distinguishable by length");
+static_assert(sizeof(NAPacketCompact) != sizeof(NAHandshakeX25519),
+              "Compact frame must be distinguishable by length");
+static_assert(sizeof(NAPacketCompact) != sizeof(NAHandshakeResume),
+              "Compact frame must be distinguishable by length");
+static_assert(sizeof(NAPacketCompact) != sizeof(NAFormationBeacon),
+              "Compact frame must be distinguishable by length");
+
+/**
+ * Full sequence number nearest to a reference whose low 16 bits are low
+ * @param reference Highest sequence accepted from the sender
+ */
+static inline uint32_t NA_Compact_expandSequence(uint32_t reference, uint16_t low) {
+    uint32_t seq = (reference & 0xFFFF0000u) | low;
+    int32_t diff = (int32_t)(seq - reference);
+    if (diff > 0x8000)
+        seq -= 0x10000;
+    else if (diff < -0x8000)
+        seq += 0x10000;
+    return seq;
+}
+
+static inline uint16_t NA_Compact_axis(int16_t v) {
+    if (v < NA_COMPACT_AXIS_MIN) v = NA_COMPACT_AXIS_MIN;
+    if (v > NA_COMPACT_AXIS_MAX) v = NA_COMPACT_AXIS_MAX;
+    return (uint16_t)v & 0x0FFF;
+}
+
+/**
+ * Pack a packet's sticks, mode and buttons into a clear payload
+ * (axes outside -2048..2047 are clamped)
+ */
+static inline void NA_Compact_packSticks(const NAPacket* pkt, uint8_t* payload) {
+    uint16_t a[4] = {NA_Compact_axis((int16_t)pkt->throttle), NA_Compact_axis(pkt->roll),
+                     NA_Compact_axis(pkt->pitch), NA_Compact_axis(pkt->yaw)};
+    payload[0] = (uint8_t)a[0];
+    payload[1] = (uint8_t)((a[0] >> 8) | (a[1] << 4));
+    payload[2] = (uint8_t)(a[1] >> 4);
+    payload[3] = (uint8_t)a[2];
+    payload[4] = (uint8_t)((a[2] >> 8) | (a[3] << 4));
+    payload[5] = (uint8_t)(a[3] >> 4);
+    payload[6] = pkt->mode;
+    payload[7] = pkt->buttons;
+}
+
+/**
+ * Unpack a clear payload into a packet's sticks, mode and buttons
+ */
+static inline void NA_Compact_unpackSticks(const uint8_t* payload, NAPacket* pkt) {
+    uint16_t a[4] = {
+        (uint16_t)(payload[0] | ((payload[1] & 0x0F) << 8)),
+        (uint16_t)((payload[1] >> 4) | (payload[2] << 4)),
+        (uint16_t)(payload[3] | ((payload[4] & 0x0F) << 8)),
+        (uint16_t)((payload[4] >> 4) | (payload[5] << 4)),
+    };
+    int16_t v[4];
+    for (int i = 0; i < 4; i++)
+        v[i] = (int16_t)((a[i] & 0x800) ? (a[i] | 0xF000) : a[i]);
+    pkt->throttle = (uint16_t)v[0];
+    pkt->roll = v[1];
+    pkt->pitch = v[2];
+    pkt->yaw = v[3];
+    pkt->mode = payload[6];
+    pkt->buttons = payload[7];
+}
+
+static inline void NA_Compact_buildNonce(uint32_t sequence, uint8_t* nonce) {
+    memset(nonce, 0, AES_GCM_NONCE_SIZE);
+    memcpy(nonce, "NACF", 4);
+    memcpy(&nonce[8], &sequence, sizeof(uint32_t));
+}
+
+static inline void NA_Compact_buildAAD(uint32_t sequence, uint8_t* aad) {
+    aad[0] = NA_COMPACT_TYPE;
+    aad[1] = PROTOCOL_VERSION;
+    memcpy(&aad[2], &sequence, sizeof(uint32_t));
+}
+
+/**
+ * Unpack a compact frame into an NAPacket (no crypto, safe in Wi-Fi callback)
+ *
+ * sequenceNumber holds only the low 16 bits until the receiver expands
+ * it; the encrypted payload and the tag are carried in the iv / hmac
+ * fields until NA_Compact_decryptPacketFrom() verifies them.
+ */
+static inline void NA_Compact_toPacket(const NAPacketCompact* frame, NAPacket* pkt) {
+    memset(pkt, 0, sizeof(NAPacket));
+    pkt->protocolVersion = PROTOCOL_VERSION;
+    pkt->encryptionFlag = NA_ENCRYPTION_COMPACT;
+    pkt->sequenceNumber = frame->sequence;
+    memcpy(pkt->iv, frame->payload, NA_COMPACT_PAYLOAD_SIZE);
+    memcpy(pkt->hmac, frame->tag, NA_COMPACT_TAG_SIZE);
+}
+
+/**
+ * Verify and decrypt an unpacked compact packet under one peer's key
+ * @param set EncryptionManager peer key set (PeerSessionTable slot)
+ * @param pkt Packet from NA_Compact_toPacket(), sequence already expanded
+ * @return true if the tag is valid (sticks, mode and buttons filled in)
+ */
+static inline bool NA_Compact_decryptPacketFrom(uint8_t set, NAPacket* pkt) {
+    uint8_t nonce[AES_GCM_NONCE_SIZE];
+    uint8_t aad[NA_COMPACT_AAD_SIZE];
+    uint8_t payload[NA_COMPACT_PAYLOAD_SIZE];
+    NA_Compact_buildNonce(pkt->sequenceNumber, nonce);
+    NA_Compact_buildAAD(pkt->sequenceNumber, aad);
+    if (!EncryptionManager_aeadDecryptFromTruncated(
+            set, pkt->iv, NA_COMPACT_PAYLOAD_SIZE, nonce, aad, NA_COMPACT_AAD_SIZE,
+            pkt->hmac, NA_COMPACT_TAG_SIZE, payload))
+        return false;
+    NA_Compact_unpackSticks(payload, pkt);
+    memset(payload, 0, sizeof(payload));
+    return true;
+}
+
+#endif // NA_PACKET_COMPACT_H
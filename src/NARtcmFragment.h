@@ -0,0 +1,76 @@
+#ifndef NA_RTCM_FRAGMENT_H
+#define NA_RTCM_FRAGMENT_H
+
+#include <stdint.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "NAHandshakeResume.h"
+#include "NAFleetOta.h"
+#include "RtcmRelay.h"
+
+/**
+ * NARtcmFragment - RTK correction fragment (ESP-NOW broadcast, or /ws)
+ *
+ * 213 bytes: one piece of an RTCM3 frame from the base vehicle's
+ * receiver (see RtcmRelay.h). Every fragment is always sent full length;
+ * len says how much of data is used. The tag is HMAC-SHA256 under the
+ * RTK key (derived from the shared secret), truncated to 8 bytes: a
+ * forged correction would move every rover's position, so only the
+ * fleet's own base is believed.
+ *
+ * Told apart from every other frame by length.
+ *
+ * @file NARtcmFragment.h
+ */
+
+#define NA_RTCM_TYPE            0xD5
+#define NA_RTCM_TAG_SIZE        8
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t protocolVersion;
+    uint8_t type;                   // NA_RTCM_TYPE
+    uint8_t seq;                    // RTCM frame, per base, wraps
+    uint8_t part;                   // Index << 4 | count
+    uint8_t len;                    // Bytes of data used
+    uint8_t data[RTCM_FRAGMENT_DATA];
+    uint8_t tag[NA_RTCM_TAG_SIZE];  // Over every byte above
+} NARtcmFragment;
+#pragma pack(pop)
+
+#define NA_RTCM_AUTH_SIZE       (sizeof(NARtcmFragment) - NA_RTCM_TAG_SIZE)
+
+static_assert(RTCM_MAX_FRAGMENTS <= 15, "Fragment index and count share a byte");
+static_assert(sizeof(NARtcmFragment) <= 250, "Fragment must fit one ESP-NOW frame");
+NA_FLEET_ASSERT_DISTINCT(NARtcmFragment);
+static_assert(sizeof(NARtcmFragment) != sizeof(NAHandshakeResume) &&
+                  sizeof(NARtcmFragment) != sizeof(NAFleetAnnounce) &&
+                  sizeof(NARtcmFragment) != sizeof(NAFleetChunk) &&
+                  sizeof(NARtcmFragment) != sizeof(NAFleetNack),
+              "NARtcmFragment must be distinguishable by length");
+
+/**
+ * Fill fragment index of a frame (tag left for the caller)
+ */
+static inline void NA_Rtcm_build(NARtcmFragment* frag, uint8_t seq, uint8_t index,
+                                 const uint8_t* frame, size_t frameLen) {
+    size_t offset = (size_t)index * RTCM_FRAGMENT_DATA;
+    size_t n = frameLen - offset < RTCM_FRAGMENT_DATA ? frameLen - offset : RTCM_FRAGMENT_DATA;
+    memset(frag, 0, sizeof(*frag));
+    frag->protocolVersion = PROTOCOL_VERSION;
+    frag->type = NA_RTCM_TYPE;
+    frag->seq = seq;
+    frag->part = (uint8_t)(index << 4 | RtcmRelay_fragmentCount(frameLen));
+    frag->len = (uint8_t)n;
+    memcpy(frag->data, frame + offset, n);
+}
+
+static inline uint8_t NA_Rtcm_index(const NARtcmFragment* frag) {
+    return frag->part >> 4;
+}
+
+static inline uint8_t NA_Rtcm_count(const NARtcmFragment* frag) {
+    return frag->part & 0x0F;
+}
+
+#endif // NA_RTCM_FRAGMENT_H
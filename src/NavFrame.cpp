@@ -0,0 +1,112 @@
+#include "NavFrame.h"
+#include "FastMath.h"
+#include <math.h>
+
+FAST_MATH_FLOAT_ONLY
+
+/**
+ * NavFrame - Implementation
+ *
+ * @file NavFrame.cpp
+ */
+
+// Double on purpose: cos(originLat) once per origin, not per fix
+#define NAV_FRAME_RAD_PER_E7    (M_PI / 180.0 / NAV_FRAME_E7)
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+int32_t NavFrame_toE7(double degrees) {
+    return (int32_t)lround(degrees * NAV_FRAME_E7);
+}
+
+void NavFrame_init(NavFrame* frame, int32_t latE7, int32_t lngE7) {
+    frame->originLat = latE7;
+    frame->originLng = lngE7;
+    frame->eastScale = NAV_FRAME_M_PER_E7 * (float)cos(latE7 * NAV_FRAME_RAD_PER_E7);
+    frame->valid = true;
+}
+
+NavVector NavFrame_toLocal(const NavFrame* frame, int32_t latE7, int32_t lngE7) {
+    int32_t dLat = latE7 - frame->originLat;
+
+    // Shortest way round across the antimeridian (+/-180 deg is 3.6e9 apart)
+    int64_t dLng = (int64_t)lngE7 - frame->originLng;
+    if (dLng > 180 * NAV_FRAME_E7) dLng -= 360 * NAV_FRAME_E7;
+    if (dLng < -180 * NAV_FRAME_E7) dLng += 360 * NAV_FRAME_E7;
+
+    NavVector v;
+    v.north = (float)dLat * NAV_FRAME_M_PER_E7;
+    v.east = (float)(int32_t)dLng * frame->eastScale;
+    return v;
+}
+
+void NavFrame_toGlobal(const NavFrame* frame, NavVector point, int32_t* latE7, int32_t* lngE7) {
+    *latE7 = frame->originLat + (int32_t)lroundf(point.north / NAV_FRAME_M_PER_E7);
+
+    int64_t lng = (int64_t)frame->originLng + lroundf(point.east / frame->eastScale);
+    if (lng > 180 * NAV_FRAME_E7) lng -= 360 * NAV_FRAME_E7;
+    if (lng < -180 * NAV_FRAME_E7) lng += 360 * NAV_FRAME_E7;
+    *lngE7 = (int32_t)lng;
+}
+
+float NavFrame_distance(NavVector from, NavVector to) {
+    float de = to.east - from.east;
+    float dn = to.north - from.north;
+    return FastMath_sqrt(de * de + dn * dn);
+}
+
+float NavFrame_bearing(NavVector from, NavVector to) {
+    return FastMath_atan2(to.east - from.east, to.north - from.north) * FAST_MATH_RAD_TO_DEG;
+}
+
+NavPursuit NavFrame_pursuit(NavVector start, NavVector end, NavVector position, float lookahead) {
+    NavLeg leg = NavFrame_leg(start, end);
+    return NavFrame_pursuitLeg(&leg, position, lookahead);
+}
+
+NavLeg NavFrame_leg(NavVector start, NavVector end) {
+    NavLeg leg;
+    leg.start = start;
+    leg.end = end;
+    float le = end.east - start.east;
+    float ln = end.north - start.north;
+    leg.length = FastMath_sqrt(le * le + ln * ln);
+    leg.bearing = NavFrame_bearing(start, end);
+    if (leg.length < 0.01f) {
+        leg.dirEast = 0.0f;
+        leg.dirNorth = 0.0f;
+    } else {
+        leg.dirEast = le / leg.length;
+        leg.dirNorth = ln / leg.length;
+    }
+    return leg;
+}
+
+NavPursuit NavFrame_pursuitLeg(const NavLeg* leg, NavVector position, float lookahead) {
+    NavPursuit p;
+    p.legLength = leg->length;
+    p.aim = leg->end;
+    if (leg->length < 0.01f) {
+        p.alongTrack = 0.0f;
+        p.crossTrack = 0.0f;
+        return p;
+    }
+
+    float ue = leg->dirEast;
+    float un = leg->dirNorth;
+    float pe = position.east - leg->start.east;
+    float pn = position.north - leg->start.north;
+    p.alongTrack = pe * ue + pn * un;
+    p.crossTrack = pe * un - pn * ue;
+
+    float reach = lookahead * lookahead - p.crossTrack * p.crossTrack;
+    float aimAlong = p.alongTrack + FastMath_sqrt(reach);
+    if (aimAlong < p.legLength) {
+        if (aimAlong < 0.0f) aimAlong = 0.0f;
+        p.aim.east = leg->start.east + ue * aimAlong;
+        p.aim.north = leg->start.north + un * aimAlong;
+    }
+    return p;
+}
@@ -1,6 +1,12 @@
 #include "NavigationManager.h"
+#include "DepthManager.h"
+#include "FastMath.h"
+#include "HAL.h"
+#include "Log.h"
 #include <math.h>
 
+FAST_MATH_FLOAT_ONLY
+
 NavigationManager& NavigationManager::getInstance() {
     static NavigationManager instance;
     return instance;
@@ -13,8 +19,54 @@ NavigationManager::NavigationManager() {
     _state.isRTLActive = false;
     _state.homeLat = 0;
     _state.homeLng = 0;
-    _prevError = 0;
-    _integral = 0;
+    _yawGains.kp = NAV_YAW_KP;
+    _yawGains.ki = NAV_YAW_KI;
+    _yawGains.kd = NAV_YAW_KD;
+    _yawGains.kff = 0.0f;
+    _yawGains.dCutoffHz = NAV_YAW_D_CUTOFF_HZ;
+    _yawGains.iLimit = NAV_YAW_I_LIMIT;
+    _yawGains.outLimit = MAX_NAV_OUTPUT;
+    PID_reset(&_yawPid);
+    _lastOutputMs = 0;
+    _guidance.mode = NAV_GUIDANCE_L1;
+    _guidance.lookahead = NAV_L1_LOOKAHEAD_M;
+    _guidance.cornerCut = NAV_CORNER_CUT;
+    _state.crossTrackError = 0;
+    memset(&_fix, 0, sizeof(_fix));
+    _frame.valid = false;
+    _state.isLoitering = false;
+    _state.isSurveyActive = false;
+    _legSpeed = 0;
+    _legAlt = 0.0f;
+    _legAltValid = false;
+    _legValid = false;
+    _loiterS = 0;
+    _loiterUntilMs = 0;
+    SpeedProfile_defaults(&_speedConfig);
+    memset(&_legPlan, 0, sizeof(_legPlan));
+    SpeedProfile_reset(&_speed, 0.0f);
+    _turnStartM = WP_RADIUS_METERS;
+    RangeEnvelope_defaults(&_obstacleEnvelope);
+    _obstacleScale = 1.0f;
+    _lastItemValid = false;
+    MissionRunner_init(&_runner, WAYPOINT_DEFAULT_SPEED);
+    _missionCount = 0;
+    _missionRevision = 0;
+    _missionSynced = false;
+    memset(&_survey, 0, sizeof(_survey));
+    _surveyFrame.valid = false;
+    _surveySpeed = WAYPOINT_DEFAULT_SPEED;
+    _surveyHasPoint = false;
+    _surveyPrevValid = false;
+    _state.isFollowing = false;
+    _follow.right = 0.0f;
+    _follow.back = 0.0f;
+    _follow.leadS = NAV_FOLLOW_LEAD_S;
+    _follow.speed = WAYPOINT_DEFAULT_SPEED;
+    memset(&_leader, 0, sizeof(_leader));
+    _leaderSeenMs = 0;
+    _leaderValid = false;
+    _followHold = true;
 }
 
 void NavigationManager::init() {
@@ -23,24 +75,38 @@ void NavigationManager::init() {
     _state.isMissionActive = false;
 }
 
-void NavigationManager::feedGPS(char c) {
-    _gps.encode(c);
+void NavigationManager::setGPSFix(const GPSFix& fix) {
+    _fix = fix;
 }
 
 bool NavigationManager::isGPSLocked() {
-    return _gps.location.isValid() && _gps.location.age() < 1500;
+    return _fix.valid && HAL_GetMillis() - _fix.timeMs < GPS_FIX_TIMEOUT_MS;
 }
 
 void NavigationManager::getGPSLocation(float& lat, float& lng) {
     if (isGPSLocked()) {
-        lat = _gps.location.lat();
-        lng = _gps.location.lng();
+        lat = (float)(_fix.lat / (double)NAV_FRAME_E7);
+        lng = (float)(_fix.lng / (double)NAV_FRAME_E7);
+    }
+}
+
+void NavigationManager::getGPSLocationE7(int32_t& lat, int32_t& lng) {
+    if (isGPSLocked()) {
+        lat = _fix.lat;
+        lng = _fix.lng;
     }
 }
 
 float NavigationManager::getGPSCourse() {
-    if (_gps.course.isValid()) {
-        return (float)_gps.course.deg();
+    if (_fix.valid) {
+        return _fix.course * 1e-5f;
+    }
+    return 0.0f;
+}
+
+float NavigationManager::getGPSSpeed() {
+    if (isGPSLocked()) {
+        return _fix.groundSpeed * 0.001f;
     }
     return 0.0f;
 }
@@ -50,115 +116,504 @@ void NavigationManager::startMission() {
         _state.isMissionActive = true;
         _state.isRTLActive = false;
         _state.currentWaypointIndex = 0;
-        Serial.println("[Nav] Mission Started");
+        _state.isLoitering = false;
+        _state.isSurveyActive = false;
+        _state.isFollowing = false;
+        _legValid = false;          // First leg starts where we are
+        _lastItemValid = false;
+        MissionRunner_init(&_runner, WAYPOINT_DEFAULT_SPEED);
+        resetPID();
+        LOG_INFO("[Nav] Mission Started\n");
     }
 }
 
 void NavigationManager::stopMission() {
     _state.isMissionActive = false;
     _state.isRTLActive = false;
-    Serial.println("[Nav] Mission Stopped");
+    _state.isLoitering = false;
+    _state.isSurveyActive = false;
+    _state.isFollowing = false;
+    resetPID();
+    SpeedProfile_reset(&_speed, 0.0f);
+    LOG_INFO("[Nav] Mission Stopped\n");
 }
 
 void NavigationManager::setHome(float lat, float lng) {
     _state.homeLat = lat;
     _state.homeLng = lng;
-    Serial.printf("[Nav] Home Set: %.6f, %.6f\n", lat, lng);
+    NavFrame_init(&_frame, NavFrame_toE7((double)lat), NavFrame_toE7((double)lng));
+    _legValid = false;
+    LOG_INFO("[Nav] Home Set: %.6f, %.6f\n", (double)lat, (double)lng);
 }
 
 void NavigationManager::executeRTL() {
     if (_state.homeLat == 0 && _state.homeLng == 0) {
-        Serial.println("[Nav] RTL Failed: Home not set");
+        LOG_WARN("[Nav] RTL Failed: Home not set\n");
         return;
     }
     _state.isRTLActive = true;
     _state.isMissionActive = true;
-    _state.currentWaypointIndex = 0; // RTL uses a virtual path/direct to home
-    Serial.println("[Nav] RTL Active: Returning Home...");
+    _state.isLoitering = false;
+    _state.isFollowing = false;
+    _legValid = false;              // Straight home from here
+    resetPID();
+    LOG_INFO("[Nav] RTL Active: Returning Home...\n");
+}
+
+void NavigationManager::captureResume(WarmRestartNav& nav) {
+    WaypointManager& wpm = WaypointManager::getInstance();
+    nav.homeLat = _state.homeLat;
+    nav.homeLng = _state.homeLng;
+    nav.homeSet = hasHome();
+    nav.rtlActive = _state.isRTLActive && _state.isMissionActive;
+    nav.missionActive = _state.isMissionActive && !_state.isSurveyActive && !_state.isFollowing;
+    nav.waypointIndex = _state.currentWaypointIndex;
+    nav.lastItem = _lastItem;
+    nav.lastItemValid = _lastItemValid;
+    nav.runner = _runner;
+    nav.missionCount = wpm.getWaypointCount();
+    nav.missionPersisted = wpm.isPersisted();
+    nav.missionCrc = wpm.getPersistedCrc();
+}
+
+bool NavigationManager::resume(const WarmRestartNav& nav) {
+    if (nav.homeSet) {
+        _state.homeLat = nav.homeLat;
+        _state.homeLng = nav.homeLng;
+        NavFrame_init(&_frame, NavFrame_toE7((double)nav.homeLat),
+                      NavFrame_toE7((double)nav.homeLng));
+        _legValid = false;
+        LOG_INFO("[Nav] Home Restored: %.6f, %.6f\n", (double)nav.homeLat, (double)nav.homeLng);
+    }
+
+    if (nav.rtlActive && nav.homeSet) {
+        executeRTL();
+        return true;
+    }
+    if (!nav.missionActive) return false;
+
+    // The cursor only means something for the mission it was taken on
+    WaypointManager& wpm = WaypointManager::getInstance();
+    if (!nav.missionPersisted || !wpm.isPersisted() || wpm.getWaypointCount() != nav.missionCount ||
+        wpm.getPersistedCrc() != nav.missionCrc) {
+        LOG_WARN("[Nav] Mission changed, not resumed\n");
+        return false;
+    }
+    _state.isMissionActive = true;
+    _state.isRTLActive = false;
+    _state.isLoitering = false;
+    _state.isSurveyActive = false;
+    _state.isFollowing = false;
+    _state.currentWaypointIndex = nav.waypointIndex;
+    _runner = nav.runner;
+    _lastItem = nav.lastItem;
+    _lastItemValid = nav.lastItemValid;
+    _legValid = false;
+    resetPID();
+    LOG_INFO("[Nav] Mission Resumed at item %u\n", nav.waypointIndex);
+    return true;
+}
+
+void NavigationManager::startSurvey(const SurveyPattern& pattern, int32_t latE7, int32_t lngE7,
+                                    uint16_t speed) {
+    _survey = pattern;
+    SurveyPattern_restart(&_survey);
+    NavFrame_init(&_surveyFrame, latE7, lngE7);
+    if (!_frame.valid) {
+        NavFrame_init(&_frame, latE7, lngE7);
+    }
+    _surveySpeed = speed;
+    _surveyHasPoint = false;
+    _surveyPrevValid = false;
+
+    _state.isMissionActive = true;
+    _state.isRTLActive = false;
+    _state.isLoitering = false;
+    _state.isSurveyActive = true;
+    _state.isFollowing = false;
+    _state.currentWaypointIndex = 0;
+    _legValid = false;
+    resetPID();
+    LOG_INFO("[Nav] Survey Started\n");
+}
+
+void NavigationManager::startFollow(const NavFollowConfig& config) {
+    _follow = config;
+    _leaderValid = false;           // Wait for a beacon of the new leader
+    _followHold = true;
+    _state.isMissionActive = true;
+    _state.isRTLActive = false;
+    _state.isLoitering = false;
+    _state.isSurveyActive = false;
+    _state.isFollowing = true;
+    resetPID();
+    LOG_INFO("[Nav] Follow Started: %.1f m right, %.1f m back\n", (double)config.right,
+             (double)config.back);
+}
+
+void NavigationManager::setLeader(const FormationState& leader, uint32_t seenMs) {
+    _leader = leader;
+    _leaderSeenMs = seenMs;
+    _leaderValid = (leader.flags & FORMATION_FLAG_POSITION) != 0;
+    if (_leaderValid && !_frame.valid) {
+        // No home / mission yet: anchor at the leader, as a survey does
+        NavFrame_init(&_frame, leader.latE7, leader.lngE7);
+    }
 }
 
 void NavigationManager::update(float currentLat, float currentLng, float currentHeading) {
+    update(NavFrame_toE7(currentLat), NavFrame_toE7(currentLng), currentHeading);
+}
+
+void NavigationManager::update(int32_t latE7, int32_t lngE7, float currentHeading) {
     if (!_state.isMissionActive) return;
 
-    NAWaypoint targetWP;
-    if (!WaypointManager::getInstance().getWaypoint(_state.currentWaypointIndex, targetWP)) {
-        stopMission();
+    // A mission edit can re-anchor the frame: sync before projecting
+    syncMission();
+    update(NavFrame_toLocal(&_frame, latE7, lngE7), currentHeading);
+}
+
+void NavigationManager::update(const NavVector& position, float currentHeading) {
+    if (!_state.isMissionActive) return;
+    if (_state.isFollowing) {
+        updateFollow(position, currentHeading);
         return;
     }
 
-    _state.distanceToTarget = calculateDistance(currentLat, currentLng, targetWP.lat, targetWP.lng);
-    _state.bearingToTarget = calculateBearing(currentLat, currentLng, targetWP.lat, targetWP.lng);
-    
-    float error = _state.bearingToTarget - currentHeading;
+    syncMission();
+    if (!_legValid && !loadLeg(position)) return;
+
+    const NavLeg& leg = _leg;
+    _state.distanceToTarget = NavFrame_distance(position, leg.end);
+    _state.bearingToTarget = NavFrame_bearing(position, leg.end);
+
+    float aimBearing = _state.bearingToTarget;
+    bool reached = _state.distanceToTarget < WP_RADIUS_METERS;
+    _state.crossTrackError = 0;
+
+    if (_guidance.mode == NAV_GUIDANCE_L1) {
+        NavPursuit pursuit = NavFrame_pursuitLeg(&leg, position, _guidance.lookahead);
+        _state.crossTrackError = pursuit.crossTrack;
+        if (pursuit.alongTrack < pursuit.legLength) {
+            aimBearing = NavFrame_bearing(position, pursuit.aim);
+        }
+
+        // Corner cutting: turn onto the next leg before the WP, and
+        // accept a WP passed abeam (close to the track) instead of
+        // circling back for it
+        // (not into a loiter point, which must be reached)
+        // (a survey always turns onto another track or ends)
+        uint16_t next = _state.currentWaypointIndex + 1;
+        bool hasNext = !_state.isRTLActive && _loiterS == 0 &&
+                       (_state.isSurveyActive ||
+                        (next < _missionCount &&
+                         WaypointManager::getInstance().getCommand(next) == MISSION_CMD_WAYPOINT));
+        if (hasNext && _state.distanceToTarget < _guidance.cornerCut * _guidance.lookahead) {
+            reached = true;
+        }
+        if (_loiterS == 0 && pursuit.alongTrack >= pursuit.legLength &&
+            fabsf(pursuit.crossTrack) < _guidance.lookahead) {
+            reached = true;
+        }
+    }
+
+    float error = aimBearing - currentHeading;
     _state.headingError = normalizeAngle(error);
 
-    // Check if reached
-    if (_state.distanceToTarget < WP_RADIUS_METERS) {
-        Serial.printf("[Nav] Waypoint %d Reached!\n", _state.currentWaypointIndex);
+    // Check if reached; a loiter point starts its clock on arrival and
+    // holds (steering back if it drifts off) until the time is up
+    if (reached && _loiterS > 0 && !_state.isLoitering) {
+        _state.isLoitering = true;
+        _loiterUntilMs = HAL_GetMillis() + _loiterS * 1000UL;
+        LOG_INFO("[Nav] Loiter %us at item %d\n", _loiterS, _state.currentWaypointIndex);
+    }
+    if (_state.isLoitering) {
+        if ((int32_t)(HAL_GetMillis() - _loiterUntilMs) < 0) return;
+        _state.isLoitering = false;
+        reached = true;
+    }
+    if (reached) {
+        advanceWaypoint();
+    }
+}
+
+void NavigationManager::updateFollow(const NavVector& position, float currentHeading) {
+    // The leader's fix is projected into our frame (origins differ per vehicle)
+    uint32_t ageMs = HAL_GetMillis() - _leaderSeenMs;
+    _followHold = !_leaderValid || !_frame.valid || ageMs > NAV_FOLLOW_TIMEOUT_MS;
+    if (_followHold) {
+        _state.distanceToTarget = 0;
+        _state.headingError = 0;
+        return;
+    }
+
+    NavVector leader = NavFrame_toLocal(&_frame, _leader.latE7, _leader.lngE7);
+    NavVector slot = Formation_followTarget(leader, &_leader, _follow.right, _follow.back,
+                                            _follow.leadS + ageMs * 0.001f);
+    _state.distanceToTarget = NavFrame_distance(position, slot);
+    _state.bearingToTarget = NavFrame_bearing(position, slot);
+    _state.headingError = normalizeAngle(_state.bearingToTarget - currentHeading);
+    _state.crossTrackError = 0;
+}
+
+void NavigationManager::setGuidance(const NavGuidanceConfig& config) {
+    _guidance = config;
+    if (_guidance.lookahead < WP_RADIUS_METERS) _guidance.lookahead = WP_RADIUS_METERS;
+    if (_guidance.cornerCut < 0.0f) _guidance.cornerCut = 0.0f;
+    if (_guidance.cornerCut > 1.0f) _guidance.cornerCut = 1.0f;
+}
+
+void NavigationManager::setSpeedProfile(const SpeedProfileConfig& config) {
+    _speedConfig = config;
+    SpeedProfile_sanitize(&_speedConfig);   // Corner speeds: from the next leg on
+}
+
+void NavigationManager::advanceWaypoint() {
+    resetPID();
+    if (_state.isRTLActive) {
+        // Home: the control task sees RTL still flagged and finishes it
+        _state.isMissionActive = false;
+        return;
+    }
+    if (_state.isSurveyActive) {
+        _surveyPrev = _surveyPoint;
+        _surveyPrevValid = true;
+        _surveyHasPoint = false;
         _state.currentWaypointIndex++;
-        if (_state.currentWaypointIndex >= WaypointManager::getInstance().getWaypointCount()) {
-            Serial.println("[Nav] Mission Complete");
-            stopMission();
-        }
+        _legValid = false;
+        return;
     }
+    LOG_INFO("[Nav] Waypoint %d Reached!\n", _state.currentWaypointIndex);
+    // The next leg runs from this waypoint, wherever the turn started
+    _lastItem = _state.currentWaypointIndex;
+    _lastItemValid = true;
+    MissionRunner_complete(&_runner, _state.currentWaypointIndex);
+    _legValid = false;
+}
+
+void NavigationManager::setObstacleEnvelope(const RangeEnvelope& envelope) {
+    _obstacleEnvelope = envelope;
+    RangeEnvelope_sanitize(&_obstacleEnvelope);
+}
+
+void NavigationManager::setObstacleRange(float rangeM) {
+    _obstacleScale = rangeM < 0.0f ? 1.0f : Rangefinder_speedScale(&_obstacleEnvelope, rangeM);
 }
 
 bool NavigationManager::getNavigationOutput(int16_t& throttleOut, int16_t& yawOut) {
     if (!_state.isMissionActive) return false;
 
-    // Simple PID for Yaw
-    float error = _state.headingError;
-    
-    // P-Term
-    float output = error * NAV_YAW_KP;
-    
-    // Limits
-    if (output > MAX_NAV_OUTPUT) output = MAX_NAV_OUTPUT;
-    if (output < -MAX_NAV_OUTPUT) output = -MAX_NAV_OUTPUT;
+    // Fixed control period as dt; a longer gap (first call, stall)
+    // restarts the PID instead
+    uint32_t now = HAL_GetMillis();
+    if (_lastOutputMs && now - _lastOutputMs > NAV_PID_MAX_DT_S * 1000.0f) {
+        resetPID();
+    }
+    _lastOutputMs = now ? now : 1;
+
+    // Steer the heading error to zero: measured = -error, so D acts on the
+    // error's rate. Unwrap it so a crossing of +/-180 is not a step
+    float measured = -_state.headingError;
+    if (_yawPid.primed) {
+        _yawPid.prevMeasured = measured - normalizeAngle(measured - _yawPid.prevMeasured);
+    }
+    float output = PID_update(&_yawGains, &_yawPid, 0.0f, measured, NAV_CONTROL_DT_S, true);
 
     yawOut = (int16_t)output;
-    
-    NAWaypoint targetWP;
-    WaypointManager::getInstance().getWaypoint(_state.currentWaypointIndex, targetWP);
-    throttleOut = targetWP.speed; // Use WP speed as target throttle
 
+    // Following: hold at the slot (or without a leader), ramp up with distance
+    if (_state.isFollowing) {
+        if (_followHold || _state.distanceToTarget < NAV_FOLLOW_HOLD_M ||
+            _obstacleScale <= 0.0f) {
+            throttleOut = 0;
+            yawOut = 0;
+            SpeedProfile_reset(&_speed, 0.0f);
+            return true;
+        }
+        float scale = _state.distanceToTarget / NAV_FOLLOW_SLOW_M;
+        if (scale > _obstacleScale) scale = _obstacleScale;
+        throttleOut = (int16_t)(_follow.speed * (scale < 1.0f ? scale : 1.0f));
+        SpeedProfile_reset(&_speed, throttleOut);   // A mission picks up from here
+        return true;
+    }
+
+    // Holding a loiter point: stop while inside the radius
+    if (_state.isLoitering && _state.distanceToTarget < WP_RADIUS_METERS) {
+        throttleOut = 0;
+        yawOut = 0;
+        SpeedProfile_reset(&_speed, 0.0f);
+        return true;
+    }
+
+    // Obstacle inside the stop distance: hold until it clears
+    if (_obstacleScale <= 0.0f) {
+        throttleOut = 0;
+        yawOut = 0;
+        SpeedProfile_reset(&_speed, 0.0f);
+        return true;
+    }
+
+    if (!_speedConfig.enabled) {
+        throttleOut = (int16_t)(_legSpeed * _obstacleScale); // WP speed as target throttle
+        return true;
+    }
+    float target = SpeedProfile_target(&_legPlan, _state.distanceToTarget - _turnStartM);
+    float cap = _obstacleScale < 1.0f ? _legPlan.speed * _obstacleScale : SPEED_PROFILE_MAX;
+    if (target > cap) target = cap;
+    float speed = SpeedProfile_step(&_speedConfig, &_speed, target, NAV_CONTROL_DT_S);
+    // The envelope cuts the speed at once (no ramp down towards a wall);
+    // the profile ramps back up once the way clears
+    if (speed > cap) {
+        SpeedProfile_reset(&_speed, cap);
+        speed = cap;
+    }
+    throttleOut = (int16_t)lroundf(speed);
     return true;
 }
 
+bool NavigationManager::getLegAltitude(float& altM) {
+    if (!_legAltValid) return false;
+    altM = _legAlt;
+    return true;
+}
+
+void NavigationManager::resetPID() {
+    PID_reset(&_yawPid);
+    _lastOutputMs = 0;
+}
+
 // ============================================================================
-// Internal Math Helpers (Haversine & Bearing)
+// Internal Math Helpers (Local Tangent Plane)
 // ============================================================================
 
-#define DEGREES_TO_RADIANS (M_PI / 180.0)
-#define RADIANS_TO_DEGREES (180.0 / M_PI)
-#define EARTH_RADIUS_M 6371000
-
-float NavigationManager::calculateDistance(float lat1, float lng1, float lat2, float lng2) {
-    float dLat = (lat2 - lat1) * DEGREES_TO_RADIANS;
-    float dLon = (lng2 - lng1) * DEGREES_TO_RADIANS;
-    
-    float a = sin(dLat/2) * sin(dLat/2) +
-              cos(lat1 * DEGREES_TO_RADIANS) * cos(lat2 * DEGREES_TO_RADIANS) * 
-              sin(dLon/2) * sin(dLon/2);
-    
-    float c = 2 * atan2(sqrt(a), sqrt(1-a));
-    return EARTH_RADIUS_M * c;
-}
-
-float NavigationManager::calculateBearing(float lat1, float lng1, float lat2, float lng2) {
-    float dLon = (lng2 - lng1) * DEGREES_TO_RADIANS;
-    float lat1Rad = lat1 * DEGREES_TO_RADIANS;
-    float lat2Rad = lat2 * DEGREES_TO_RADIANS;
-    
-    float y = sin(dLon) * cos(lat2Rad);
-    float x = cos(lat1Rad) * sin(lat2Rad) - sin(lat1Rad) * cos(lat2Rad) * cos(dLon);
-    
-    float brng = atan2(y, x) * RADIANS_TO_DEGREES;
-    return normalizeAngle(brng);
+void NavigationManager::syncMission() {
+    WaypointManager& wpm = WaypointManager::getInstance();
+    if (_missionSynced && wpm.getRevision() == _missionRevision) return;
+    _missionRevision = wpm.getRevision();
+    _missionCount = wpm.getWaypointCount();
+    _missionSynced = true;
+    _legValid = false;
+
+    for (uint16_t i = 0; !_frame.valid && i < _missionCount; i++) {
+        // No home yet: anchor the frame on the mission's first position
+        if (MissionItem_isPosition(wpm.getCommand(i))) {
+            NavFrame_init(&_frame, wpm.getLatE7(i), wpm.getLngE7(i));
+        }
+    }
+}
+
+bool NavigationManager::loadLeg(const NavVector& position) {
+    WaypointManager& wpm = WaypointManager::getInstance();
+    _loiterS = 0;
+    _state.isLoitering = false;
+
+    if (_state.isRTLActive) {
+        // Home is the frame origin (setHome re-anchors the frame)
+        NavVector home = {0.0f, 0.0f};
+        _leg = NavFrame_leg(position, home);
+        _legSpeed = _runner.speed;
+        planSpeed(NULL, 0);
+        _legValid = true;
+        return true;
+    }
+
+    if (_state.isSurveyActive) return loadSurveyLeg(position);
+
+    // Run instant items (speed, depth, jumps) up to the next position
+    MissionView view = wpm.getView();
+    MissionStep step = MissionRunner_resolve(&_runner, &view);
+    if (step.setDepth) {
+        DepthManager::getInstance().setTargetDepth(step.depth);
+        DepthManager::getInstance().setDiving(true);
+    }
+    if (step.type == MISSION_STEP_RTL) {
+        executeRTL();
+        if (!_state.isRTLActive) {
+            stopMission();
+            return false;
+        }
+        return loadLeg(position);
+    }
+    if (step.type == MISSION_STEP_DONE) {
+        LOG_INFO("[Nav] Mission Complete\n");
+        stopMission();
+        return false;
+    }
+
+    uint16_t i = step.index;
+    NavVector end = NavFrame_toLocal(&_frame, wpm.getLatE7(i), wpm.getLngE7(i));
+    NavVector start = position;
+    if (_lastItemValid && _lastItem < _missionCount) {
+        start = NavFrame_toLocal(&_frame, wpm.getLatE7(_lastItem), wpm.getLngE7(_lastItem));
+    }
+    _leg = NavFrame_leg(start, end);
+    _legSpeed = step.speed;
+    _legAlt = wpm.getAlt(i);
+    _legAltValid = true;
+    _loiterS = step.loiterS;
+    _state.currentWaypointIndex = i;
+    // Turn onto the next leg only if it is a plain waypoint (as for
+    // corner cutting): anything else stops or changes course there
+    uint16_t next = i + 1;
+    if (_loiterS == 0 && next < _missionCount &&
+        wpm.getCommand(next) == MISSION_CMD_WAYPOINT) {
+        NavVector nextEnd = NavFrame_toLocal(&_frame, wpm.getLatE7(next), wpm.getLngE7(next));
+        planSpeed(&nextEnd, step.speed);
+    } else {
+        planSpeed(NULL, 0);
+    }
+    _legValid = true;
+    return true;
+}
+
+bool NavigationManager::loadSurveyLeg(const NavVector& position) {
+    // Only a reached point draws the next one: a re-anchor or mission
+    // edit rebuilds the same leg
+    if (!_surveyHasPoint) {
+        if (!SurveyPattern_next(&_survey, &_surveyPoint)) {
+            LOG_INFO("[Nav] Survey Complete\n");
+            stopMission();
+            return false;
+        }
+        _surveyHasPoint = true;
+    }
+    NavVector start = _surveyPrevValid ? surveyToLocal(_surveyPrev) : position;
+    _leg = NavFrame_leg(start, surveyToLocal(_surveyPoint));
+    _legSpeed = _surveySpeed;
+    // Peek the following turn point on a copy (the generator is O(1) state)
+    SurveyPattern ahead = _survey;
+    NavVector nextPoint;
+    if (SurveyPattern_next(&ahead, &nextPoint)) {
+        NavVector nextEnd = surveyToLocal(nextPoint);
+        planSpeed(&nextEnd, _surveySpeed);
+    } else {
+        planSpeed(NULL, 0);
+    }
+    _legValid = true;
+    return true;
+}
+
+void NavigationManager::planSpeed(const NavVector* next, uint16_t nextSpeed) {
+    // The turn begins where the next leg takes over: the corner cut
+    // distance under L1, else the waypoint radius
+    bool cuts = next && _guidance.mode == NAV_GUIDANCE_L1;
+    _turnStartM = cuts && _guidance.cornerCut * _guidance.lookahead > WP_RADIUS_METERS
+                      ? _guidance.cornerCut * _guidance.lookahead
+                      : WP_RADIUS_METERS;
+    if (!next) {
+        SpeedProfile_planLeg(&_speedConfig, _legSpeed, -1.0f, 0.0f, &_legPlan);
+        return;
+    }
+    float turn = normalizeAngle(NavFrame_bearing(_leg.end, *next) - _leg.bearing);
+    SpeedProfile_planLeg(&_speedConfig, _legSpeed, nextSpeed, turn, &_legPlan);
+}
+
+NavVector NavigationManager::surveyToLocal(NavVector point) {
+    int32_t lat, lng;
+    NavFrame_toGlobal(&_surveyFrame, point, &lat, &lng);
+    return NavFrame_toLocal(&_frame, lat, lng);
 }
 
 float NavigationManager::normalizeAngle(float angle) {
-    while (angle > 180) angle -= 360;
-    while (angle < -180) angle += 360;
-    return angle;
+    return FastMath_wrap180(angle);
 }
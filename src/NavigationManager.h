@@ -3,24 +3,81 @@
 
 #include <Arduino.h>
 #include "WaypointManager.h"
-#include <TinyGPS++.h>
+#include "NavFrame.h"
+#include "UBXParser.h"
+#include "MissionRunner.h"
+#include "SurveyPattern.h"
+#include "SpeedProfile.h"
+#include "Rangefinder.h"
+#include "PIDController.h"
+#include "FormationTable.h"
+#include "WarmRestart.h"
 
-// PID Constants (Tunable)
+// PID Constants (Tunable; -D overrides, e.g. from a SITL sweep)
+#ifndef NAV_YAW_KP
 #define NAV_YAW_KP 2.0f
+#endif
+#ifndef NAV_YAW_KI
 #define NAV_YAW_KI 0.0f
+#endif
+#ifndef NAV_YAW_KD
 #define NAV_YAW_KD 0.1f
+#endif
 
+#define NAV_YAW_I_LIMIT 200.0f  // Max integral contribution to the output
+#define NAV_YAW_D_CUTOFF_HZ 5.0f // D-term low-pass (GPS / EKF heading steps)
+#define NAV_CONTROL_DT_S 0.02f  // Control task period: getNavigationOutput() runs once per tick
+#define NAV_PID_MAX_DT_S 0.5f   // Longer gaps restart the PID
+
+#define GPS_FIX_TIMEOUT_MS 1500 // Older fixes count as lost lock
+
+#ifndef WP_RADIUS_METERS
 #define WP_RADIUS_METERS 5.0f   // Distance to consider WP reached
+#endif
 #define MAX_NAV_OUTPUT 500      // Max steering override
 
+// Path following (Tunable)
+#ifndef NAV_L1_LOOKAHEAD_M
+#define NAV_L1_LOOKAHEAD_M 10.0f // Pure-pursuit lookahead distance
+#endif
+#define NAV_CORNER_CUT 0.5f      // Next leg starts this fraction of the lookahead before a WP
+
+// Follow-leader (formation beacons)
+#define NAV_FOLLOW_HOLD_M 1.5f       // Inside this distance of the slot: hold
+#define NAV_FOLLOW_SLOW_M 10.0f      // Throttle ramps up to the follow speed over this
+#define NAV_FOLLOW_LEAD_S 0.5f       // Default velocity lead
+#define NAV_FOLLOW_TIMEOUT_MS 2000   // Older leader state: hold in place
+
+enum NavGuidanceMode : uint8_t {
+    NAV_GUIDANCE_DIRECT = 0,    // Steer straight at the waypoint
+    NAV_GUIDANCE_L1 = 1         // Track the leg from the previous waypoint
+};
+
+struct NavGuidanceConfig {
+    NavGuidanceMode mode;
+    float lookahead;        // Meters
+    float cornerCut;        // 0-1, fraction of lookahead (0 = WP radius only)
+};
+
+struct NavFollowConfig {
+    float right;            // Meters to the leader's right (negative = left)
+    float back;             // Meters behind the leader (negative = ahead)
+    float leadS;            // Aim this far ahead on the leader's velocity
+    uint16_t speed;         // Throttle when far from the slot
+};
+
 struct NavigationState {
     float distanceToTarget; // Meters
     float bearingToTarget;  // Degrees
-    float headingError;     // Degrees (-180 to 180)
-    uint8_t currentWaypointIndex;
+    float headingError;     // Degrees (-180 to 180), to the guidance aim point
+    float crossTrackError;  // Meters off the current leg, + = right (L1 only)
+    uint16_t currentWaypointIndex; // Mission item being flown
     bool isMissionActive;
     bool isWaypointReached;
     bool isRTLActive;       // Phase 14: RTL status
+    bool isLoitering;       // Holding a LOITER item
+    bool isSurveyActive;    // Flying a generated survey instead of the mission
+    bool isFollowing;       // Keeping a slot on a leader instead of the mission
     float homeLat;          // Phase 14: Home coordinates
     float homeLng;
 };
@@ -31,37 +88,134 @@ public:
 
     void init();
     void update(float currentLat, float currentLng, float currentHeading);
+    void update(int32_t latE7, int32_t lngE7, float currentHeading); // deg * 1e7
+    void update(const NavVector& position, float currentHeading);   // In getFrame()
     
-    // GPS Feed
-    void feedGPS(char c); // Feed NMEA chars
+    // GPS Feed (latest fix from GPSManager, once per control tick)
+    void setGPSFix(const GPSFix& fix);
+    const GPSFix& getGPSFix() { return _fix; }
     bool isGPSLocked();
     void getGPSLocation(float& lat, float& lng);
+    void getGPSLocationE7(int32_t& lat, int32_t& lng); // Full receiver precision
     float getGPSCourse(); // Returns course in degrees (0-360)
+    float getGPSSpeed();  // Ground speed in m/s, 0 without a valid fix
 
     // Control Output
     bool getNavigationOutput(int16_t& throttleOut, int16_t& yawOut);
+    // Leg targets for the Plane energy controller: waypoint altitude (m
+    // above the launch point; RTL and survey keep the last one) and speed
+    bool getLegAltitude(float& altM);  // false: no waypoint altitude yet
+    uint16_t getLegSpeed() { return _legSpeed; }
     
     // Mission Control
     void startMission();
     void stopMission();
     void setHome(float lat, float lng); // Phase 14: Set home location
     void executeRTL();                  // Phase 14: Return to home
+    bool hasHome() { return _state.homeLat != 0 || _state.homeLng != 0; }
+
+    // Warm restart: home and the mission cursor across a reset
+    // (survey and follow are not resumed)
+    void captureResume(WarmRestartNav& nav);
+    bool resume(const WarmRestartNav& nav); // true if a mission / RTL resumed
+
+    // Survey: legs generated on the fly, in the pattern's own frame
+    // (anchored at latE7 / lngE7), instead of the stored mission
+    void startSurvey(const SurveyPattern& pattern, int32_t latE7, int32_t lngE7, uint16_t speed);
+
+    // Follow-leader: hold a slot relative to a neighbour, fed with its
+    // latest beacon once per control tick (setLeader)
+    void startFollow(const NavFollowConfig& config);
+    void setLeader(const FormationState& leader, uint32_t seenMs);
+    NavFollowConfig getFollow() { return _follow; }
+
+    // Path following
+    void setGuidance(const NavGuidanceConfig& config);
+    NavGuidanceConfig getGuidance() { return _guidance; }
+
+    // Throttle along the path: jerk-limited, slowing for the turn ahead
+    void setSpeedProfile(const SpeedProfileConfig& config);
+    SpeedProfileConfig getSpeedProfile() { return _speedConfig; }
+
+    // Obstacle slow-down: the forward range, once per control tick
+    // (< 0 = no rangefinder), scales the path and follow speed down
+    // through the envelope and stops inside stopM
+    void setObstacleEnvelope(const RangeEnvelope& envelope);
+    RangeEnvelope getObstacleEnvelope() { return _obstacleEnvelope; }
+    void setObstacleRange(float rangeM);
+    float getObstacleScale() { return _obstacleScale; }    // 0 = stopped
     
     NavigationState getState() { return _state; }
+    const NavFrame& getFrame() { return _frame; }
 
 private:
     NavigationManager();
     
-    TinyGPSPlus _gps;
+    GPSFix _fix;
     NavigationState _state;
     
-    // PID State
-    float _prevError;
-    float _integral;
-    
+    // Steering PID (heading error -> yaw)
+    PIDGains _yawGains;
+    PIDState _yawPid;
+    uint32_t _lastOutputMs;     // 0 = first output since a reset
+
+    // Guidance
+    NavGuidanceConfig _guidance;
+
+    // Local frame (origin at home, else the first waypoint) and the
+    // active leg in it, built once per leg (or mission edit / re-anchor)
+    NavFrame _frame;
+    NavLeg _leg;                // Previous WP (or where the leg began) -> target
+    uint16_t _legSpeed;         // Target WP speed
+    float _legAlt;              // Target WP altitude, m
+    bool _legAltValid;
+    uint16_t _loiterS;          // Hold time at the target (LOITER), 0 = none
+    uint32_t _loiterUntilMs;
+    bool _legValid;
+
+    // Speed profile: per-leg plan from loadLeg(), stepped each output
+    SpeedProfileConfig _speedConfig;
+    SpeedLegPlan _legPlan;
+    SpeedProfileState _speed;
+    float _turnStartM;          // Leg ends this far before the target
+
+    // Obstacle slow-down
+    RangeEnvelope _obstacleEnvelope;
+    float _obstacleScale;       // Of the path speed, from the last range
+
+    // Mission interpreter: instant items run when the mission reaches them
+    MissionRunner _runner;
+    uint16_t _lastItem;         // Last position item reached (next leg start)
+    bool _lastItemValid;
+    uint16_t _missionCount;
+    uint32_t _missionRevision;
+    bool _missionSynced;
+
+    // Survey generator: one turn point at a time, O(1) memory
+    SurveyPattern _survey;
+    NavFrame _surveyFrame;
+    uint16_t _surveySpeed;
+    NavVector _surveyPoint;     // Current target, survey frame
+    bool _surveyHasPoint;       // Else the next one is generated
+    NavVector _surveyPrev;      // Last point reached (next leg start)
+    bool _surveyPrevValid;
+
+    // Follow-leader
+    NavFollowConfig _follow;
+    FormationState _leader;
+    uint32_t _leaderSeenMs;
+    bool _leaderValid;
+    bool _followHold;           // No fresh leader / frame: stop
+
     // Helper Math
-    float calculateBearing(float lat1, float lng1, float lat2, float lng2);
-    float calculateDistance(float lat1, float lng1, float lat2, float lng2);
+    void syncMission();
+    bool loadLeg(const NavVector& position); // false: mission ended
+    bool loadSurveyLeg(const NavVector& position);
+    void planSpeed(const NavVector* next, uint16_t nextSpeed);
+    void updateFollow(const NavVector& position, float currentHeading);
+    NavVector surveyToLocal(NavVector point);
+    void advanceWaypoint();
+    void resetPID();
     float normalizeAngle(float angle);
 };
 
@@ -0,0 +1,169 @@
+#include "OTADelta.h"
+#include <string.h>
+
+/**
+ * OTADelta - Implementation
+ *
+ * @file OTADelta.cpp
+ */
+
+enum {
+    DELTA_HEADER = 0,
+    DELTA_DIFF_LEN,
+    DELTA_EXTRA_LEN,
+    DELTA_SEEK,
+    DELTA_DIFF,
+    DELTA_EXTRA,
+    DELTA_ERROR
+};
+
+static uint32_t readLE32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static OTADeltaResult fail(OTADelta* d, OTADeltaResult result) {
+    d->state = DELTA_ERROR;
+    d->result = result;
+    return result;
+}
+
+void OTADelta_init(OTADelta* d, OTADeltaReadFn read, OTADeltaWriteFn write, void* ctx) {
+    memset(d, 0, sizeof(*d));
+    d->state = DELTA_HEADER;
+    d->result = OTA_DELTA_OK;
+    d->read = read;
+    d->write = write;
+    d->ctx = ctx;
+}
+
+bool OTADelta_isPatch(const uint8_t* data, uint32_t len) {
+    return len >= 4 && memcmp(data, OTA_DELTA_MAGIC, 4) == 0;
+}
+
+bool OTADelta_headerReady(const OTADelta* d) {
+    return d->headerLen == OTA_DELTA_HEADER_SIZE && d->result == OTA_DELTA_OK;
+}
+
+bool OTADelta_isComplete(const OTADelta* d) {
+    return d->state == DELTA_DIFF_LEN && d->varintShift == 0 && d->written == d->targetSize &&
+           OTADelta_headerReady(d);
+}
+
+// ============================================================================
+// Records
+// ============================================================================
+
+// One varint byte; true once the value is complete in d->varint
+static bool takeVarint(OTADelta* d, uint8_t b, OTADeltaResult* err) {
+    if (d->varintShift > 28 || (d->varintShift == 28 && (b & 0x70))) {
+        *err = fail(d, OTA_DELTA_ERR_FORMAT);
+        return false;
+    }
+    d->varint |= (uint32_t)(b & 0x7F) << d->varintShift;
+    if (b & 0x80) {
+        d->varintShift += 7;
+        return false;
+    }
+    d->varintShift = 0;
+    return true;
+}
+
+static void startRecordField(OTADelta* d, uint8_t state) {
+    d->state = state;
+    d->varint = 0;
+}
+
+// Record header fully read: the diff run and the seek after it must
+// both stay inside the source, and the record inside the target
+static OTADeltaResult endRecordHeader(OTADelta* d) {
+    d->seek = (int32_t)(d->varint >> 1) ^ -(int32_t)(d->varint & 1);
+    int64_t next = (int64_t)d->oldPos + d->diffLeft + d->seek;
+    if ((uint64_t)d->oldPos + d->diffLeft > d->sourceSize) return fail(d, OTA_DELTA_ERR_FORMAT);
+    if (next < 0 || next > (int64_t)d->sourceSize) return fail(d, OTA_DELTA_ERR_FORMAT);
+    if ((uint64_t)d->diffLeft + d->extraLeft > d->targetSize - d->written) return fail(d, OTA_DELTA_ERR_FORMAT);
+
+    if (d->diffLeft) {
+        d->state = DELTA_DIFF;
+        return OTA_DELTA_OK;
+    }
+    d->oldPos = (uint32_t)next;
+    if (d->extraLeft) d->state = DELTA_EXTRA;
+    else startRecordField(d, DELTA_DIFF_LEN);
+    return OTA_DELTA_OK;
+}
+
+OTADeltaResult OTADelta_feed(OTADelta* d, const uint8_t* data, uint32_t len) {
+    if (d->state == DELTA_ERROR) return d->result;
+
+    uint32_t pos = 0;
+    OTADeltaResult err = OTA_DELTA_OK;
+    while (pos < len) {
+        switch (d->state) {
+        case DELTA_HEADER: {
+            uint32_t n = OTA_DELTA_HEADER_SIZE - d->headerLen;
+            if (n > len - pos) n = len - pos;
+            memcpy(d->header + d->headerLen, data + pos, n);
+            d->headerLen += n;
+            pos += n;
+            if (d->headerLen >= 4 && !OTADelta_isPatch(d->header, 4)) return fail(d, OTA_DELTA_ERR_MAGIC);
+            if (d->headerLen == OTA_DELTA_HEADER_SIZE) {
+                d->targetSize = readLE32(d->header + 4);
+                d->sourceSize = readLE32(d->header + 8);
+                d->sourceSHA256 = d->header + 12;
+                startRecordField(d, DELTA_DIFF_LEN);
+            }
+            break;
+        }
+
+        case DELTA_DIFF_LEN:
+            if (takeVarint(d, data[pos++], &err)) {
+                d->diffLeft = d->varint;
+                startRecordField(d, DELTA_EXTRA_LEN);
+            }
+            break;
+
+        case DELTA_EXTRA_LEN:
+            if (takeVarint(d, data[pos++], &err)) {
+                d->extraLeft = d->varint;
+                startRecordField(d, DELTA_SEEK);
+            }
+            break;
+
+        case DELTA_SEEK:
+            if (takeVarint(d, data[pos++], &err)) err = endRecordHeader(d);
+            break;
+
+        case DELTA_DIFF: {
+            uint32_t n = d->diffLeft;
+            if (n > len - pos) n = len - pos;
+            if (n > OTA_DELTA_CHUNK) n = OTA_DELTA_CHUNK;
+            if (!d->read(d->ctx, d->oldPos, d->buf, n)) return fail(d, OTA_DELTA_ERR_SOURCE);
+            for (uint32_t i = 0; i < n; i++) d->buf[i] = (uint8_t)(d->buf[i] + data[pos + i]);
+            if (!d->write(d->ctx, d->buf, n)) return fail(d, OTA_DELTA_ERR_WRITE);
+            pos += n;
+            d->oldPos += n;
+            d->written += n;
+            d->diffLeft -= n;
+            if (d->diffLeft == 0) {
+                d->oldPos += d->seek;
+                if (d->extraLeft) d->state = DELTA_EXTRA;
+                else startRecordField(d, DELTA_DIFF_LEN);
+            }
+            break;
+        }
+
+        case DELTA_EXTRA: {
+            uint32_t n = d->extraLeft;
+            if (n > len - pos) n = len - pos;
+            if (!d->write(d->ctx, data + pos, n)) return fail(d, OTA_DELTA_ERR_WRITE);
+            pos += n;
+            d->written += n;
+            d->extraLeft -= n;
+            if (d->extraLeft == 0) startRecordField(d, DELTA_DIFF_LEN);
+            break;
+        }
+        }
+        if (err != OTA_DELTA_OK) return err;
+    }
+    return OTA_DELTA_OK;
+}
@@ -0,0 +1,104 @@
+#ifndef OTA_DELTA_H
+#define OTA_DELTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * OTADelta - Streaming binary delta patch (bsdiff-style)
+ *
+ * Rebuilds a new firmware image from the running one plus a patch, one
+ * network chunk at a time, without holding either image in RAM.
+ *
+ * Patch layout (integers little endian):
+ *
+ *   "NAD1" | u32 targetSize | u32 sourceSize | sourceSHA256[32]
+ *   record*: varint diffLen | varint extraLen | zigzag varint seek
+ *            diffLen bytes  -> out = source[oldPos + i] + byte (mod 256)
+ *            extraLen bytes -> copied to out as-is
+ *            oldPos += diffLen + seek
+ *
+ * Varints are LEB128 (7 bits per byte, low group first). The patch is
+ * finished once targetSize bytes have been written and no record is
+ * half-read.
+ *
+ * Source reads and output writes go through callbacks, so the module
+ * has no flash or Update dependency (OTAUpdater reads the running
+ * partition and feeds Update.write; the unit tests use RAM buffers).
+ *
+ * @file OTADelta.h
+ */
+
+#define OTA_DELTA_MAGIC         "NAD1"
+#define OTA_DELTA_HEADER_SIZE   44      // Magic + sizes + source SHA-256
+#define OTA_DELTA_CHUNK         256     // Source bytes read per diff step
+
+typedef enum {
+    OTA_DELTA_OK = 0,
+    OTA_DELTA_ERR_MAGIC,        // Not a delta patch
+    OTA_DELTA_ERR_FORMAT,       // Bad varint, seek out of the source, output overrun
+    OTA_DELTA_ERR_SOURCE,       // Source read failed
+    OTA_DELTA_ERR_WRITE         // Output write failed
+} OTADeltaResult;
+
+/**
+ * @return true on success
+ */
+typedef bool (*OTADeltaReadFn)(void* ctx, uint32_t offset, uint8_t* buf, uint32_t len);
+typedef bool (*OTADeltaWriteFn)(void* ctx, const uint8_t* data, uint32_t len);
+
+typedef struct {
+    uint8_t state;
+    OTADeltaResult result;
+
+    // Header
+    uint8_t header[OTA_DELTA_HEADER_SIZE];
+    uint8_t headerLen;
+    uint32_t targetSize;
+    uint32_t sourceSize;
+    const uint8_t* sourceSHA256;    // Into header, valid once headerReady
+
+    // Current record
+    uint32_t varint;
+    uint8_t varintShift;
+    uint32_t diffLeft;
+    uint32_t extraLeft;
+    int32_t seek;
+
+    uint32_t oldPos;
+    uint32_t written;
+
+    OTADeltaReadFn read;
+    OTADeltaWriteFn write;
+    void* ctx;
+    uint8_t buf[OTA_DELTA_CHUNK];
+} OTADelta;
+
+/**
+ * Reset for a new patch
+ */
+void OTADelta_init(OTADelta* d, OTADeltaReadFn read, OTADeltaWriteFn write, void* ctx);
+
+/**
+ * Check whether a stream starts with the patch magic
+ * @param len Bytes available (at least 4 to match)
+ */
+bool OTADelta_isPatch(const uint8_t* data, uint32_t len);
+
+/**
+ * Consume the next patch bytes
+ * @return OTA_DELTA_OK, or the (sticky) error
+ */
+OTADeltaResult OTADelta_feed(OTADelta* d, const uint8_t* data, uint32_t len);
+
+/**
+ * @return true once targetSize / sourceSize / sourceSHA256 are valid
+ */
+bool OTADelta_headerReady(const OTADelta* d);
+
+/**
+ * @return true once the whole target has been written
+ */
+bool OTADelta_isComplete(const OTADelta* d);
+
+#endif // OTA_DELTA_H
@@ -0,0 +1,166 @@
+#include "OTAManifest.h"
+#include "Crc16.h"
+#include <ArduinoJson.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * OTAManifest - Implementation
+ *
+ * The JSON is read through a filter that keeps only "version" and "ota",
+ * so the web flasher's "builds" and the changelog cost no memory.
+ *
+ * @file OTAManifest.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static int hexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parseHex(const char* hex, uint8_t* out, size_t len) {
+    if (!hex || strlen(hex) != len * 2) return false;
+    for (size_t i = 0; i < len; i++) {
+        int hi = hexNibble(hex[2 * i]);
+        int lo = hexNibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
+static bool copyString(char* out, size_t outSize, const char* s) {
+    size_t len = s ? strlen(s) : 0;
+    if (len >= outSize) return false;
+    memcpy(out, s ? s : "", len + 1);
+    return true;
+}
+
+static uint16_t urlCrc(const char* url) {
+    return Crc16_compute((const uint8_t*)url, strlen(url));
+}
+
+// ============================================================================
+// Versions and URLs
+// ============================================================================
+
+int OTAManifest_compareVersions(const char* a, const char* b) {
+    while ((a && *a >= '0' && *a <= '9') || (b && *b >= '0' && *b <= '9')) {
+        char* endA;
+        char* endB;
+        unsigned long va = (a && *a >= '0' && *a <= '9') ? strtoul(a, &endA, 10) : 0;
+        unsigned long vb = (b && *b >= '0' && *b <= '9') ? strtoul(b, &endB, 10) : 0;
+        if (va != vb) return va < vb ? -1 : 1;
+        // Step past the number and one '.', stop at a suffix
+        if (a && *a >= '0' && *a <= '9') a = *endA == '.' ? endA + 1 : NULL;
+        if (b && *b >= '0' && *b <= '9') b = *endB == '.' ? endB + 1 : NULL;
+    }
+    return 0;
+}
+
+bool OTAManifest_resolveUrl(const char* base, const char* ref, char* out, size_t outSize) {
+    if (!ref || !ref[0]) return false;
+    if (strstr(ref, "://") || !base) return copyString(out, outSize, ref);
+
+    size_t keep;
+    const char* scheme = strstr(base, "://");
+    const char* host = scheme ? scheme + 3 : base;
+    if (ref[0] == '/') {
+        const char* path = strchr(host, '/');
+        keep = path ? (size_t)(path - base) : strlen(base);
+    } else {
+        const char* slash = strrchr(host, '/');
+        keep = slash ? (size_t)(slash - base) + 1 : strlen(base);
+    }
+    bool needSlash = ref[0] != '/' && (keep == 0 || base[keep - 1] != '/');
+    size_t refLen = strlen(ref);
+    if (keep + needSlash + refLen >= outSize) return false;
+    memcpy(out, base, keep);
+    if (needSlash) out[keep++] = '/';
+    memcpy(out + keep, ref, refLen + 1);
+    return true;
+}
+
+// ============================================================================
+// Selection
+// ============================================================================
+
+OTAManifestResult OTAManifest_select(const char* json, size_t len, const char* manifestUrl,
+                                     const char* currentVersion, OTAManifestChoice* out) {
+    memset(out, 0, sizeof(*out));
+    JsonDocument filter;
+    filter["version"] = true;
+    filter["ota"] = true;
+    JsonDocument doc;
+    if (!json || deserializeJson(doc, json, len, DeserializationOption::Filter(filter)))
+        return OTA_MANIFEST_BAD;
+
+    const char* version = doc["version"];
+    if (!version || !copyString(out->version, sizeof(out->version), version))
+        return OTA_MANIFEST_BAD;
+    if (OTAManifest_compareVersions(version, currentVersion) <= 0)
+        return OTA_MANIFEST_UP_TO_DATE;
+
+    JsonObject ota = doc["ota"];
+    const char* sha = ota["sha256"];
+    const char* sig = ota["sig"];
+    if ((sha && !parseHex(sha, out->sha256, sizeof(out->sha256))) ||
+        (sig && !parseHex(sig, out->signature, sizeof(out->signature))))
+        return OTA_MANIFEST_BAD;
+    out->hasSha256 = sha != NULL;
+    out->hasSignature = sig != NULL;
+
+    // Smallest usable entry; one without a size only if nothing else is
+    JsonObject best;
+    uint64_t bestCost = UINT64_MAX;
+    for (JsonObject image : ota["images"].as<JsonArray>()) {
+        const char* from = image["from"];
+        if (!image["url"].is<const char*>() || (from && strcmp(from, currentVersion) != 0))
+            continue;
+        uint32_t size = image["size"] | 0;
+        uint64_t cost = size ? size : (uint64_t)UINT32_MAX + 1;
+        if (cost < bestCost) {
+            best = image;
+            bestCost = cost;
+        }
+    }
+    if (best.isNull() ||
+        !OTAManifest_resolveUrl(manifestUrl, best["url"], out->url, sizeof(out->url)))
+        return OTA_MANIFEST_NO_IMAGE;
+    out->size = best["size"] | 0;
+    out->delta = !best["from"].isNull();
+    return OTA_MANIFEST_UPDATE;
+}
+
+// ============================================================================
+// Conditional Requests
+// ============================================================================
+
+bool OTAManifest_cacheMatches(const OTAManifestCache* cache, const char* manifestUrl,
+                              const char* currentVersion) {
+    return cache->magic == OTA_MANIFEST_CACHE_MAGIC && manifestUrl &&
+           cache->urlCrc == urlCrc(manifestUrl) &&
+           strncmp(cache->runningVersion, currentVersion, sizeof(cache->runningVersion)) == 0 &&
+           (cache->etag[0] || cache->lastModified[0]);
+}
+
+void OTAManifest_cacheStore(OTAManifestCache* cache, const char* manifestUrl,
+                            const char* currentVersion, const char* etag,
+                            const char* lastModified, OTAManifestResult result,
+                            const OTAManifestChoice* choice) {
+    memset(cache, 0, sizeof(*cache));
+    cache->magic = OTA_MANIFEST_CACHE_MAGIC;
+    cache->urlCrc = urlCrc(manifestUrl);
+    cache->result = (uint8_t)result;
+    copyString(cache->runningVersion, sizeof(cache->runningVersion), currentVersion);
+    if (!copyString(cache->etag, sizeof(cache->etag), etag)) cache->etag[0] = '\0';
+    if (!copyString(cache->lastModified, sizeof(cache->lastModified), lastModified))
+        cache->lastModified[0] = '\0';
+    if (choice) cache->choice = *choice;
+}
@@ -0,0 +1,112 @@
+#ifndef OTA_MANIFEST_H
+#define OTA_MANIFEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * OTAManifest - Pick the update payload from a firmware manifest
+ *
+ * The manifest is the web flasher's manifest.json with an "ota" block
+ * (the flasher ignores it):
+ *
+ *   {"version":"1.2.0", "builds":[...],
+ *    "ota":{"sha256":"<hex>", "sig":"<hex r||s>",
+ *           "images":[{"url":"NA_Core_v1.2.0.bin.z","size":803210},
+ *                     {"from":"1.1.0-security","url":"d/1.1.0.nad","size":41872}]}}
+ *
+ * sha256 / sig are those of the final image, so they hold for every
+ * entry; an entry with "from" is a delta patch (OTADelta.h) usable only
+ * by a vehicle running exactly that version. Of the usable entries the
+ * smallest is taken; relative URLs resolve against the manifest's.
+ *
+ * Polling is made cheap with HTTP validators: OTAManifestCache keeps the
+ * ETag / Last-Modified of the last manifest with the choice made from
+ * it, so the next check is a conditional GET and a 304 reuses the choice
+ * without a body. The cache only counts for the same manifest URL and
+ * the same running version (an update invalidates it).
+ *
+ * Pure: no globals, no RTOS (OTAUpdater does the HTTP and the NVS).
+ *
+ * @file OTAManifest.h
+ */
+
+#define OTA_MANIFEST_URL_MAX        256     // Same as the download URL limit
+#define OTA_MANIFEST_VERSION_MAX    24
+#define OTA_MANIFEST_ETAG_MAX       64      // Longer ETags are not kept
+#define OTA_MANIFEST_DATE_MAX       32      // IMF-fixdate is 29 characters
+#define OTA_MANIFEST_BODY_MAX       4096
+#define OTA_MANIFEST_CACHE_MAGIC    0x4F544D46UL    // "OTMF"
+
+typedef enum {
+    OTA_MANIFEST_UP_TO_DATE = 0,    // Manifest version not newer
+    OTA_MANIFEST_UPDATE = 1,        // choice is valid
+    OTA_MANIFEST_NO_IMAGE = 2,      // Newer, but nothing this vehicle can apply
+    OTA_MANIFEST_BAD = 3            // Not JSON, no version, bad hex
+} OTAManifestResult;
+
+/**
+ * Payload chosen for this vehicle
+ */
+typedef struct {
+    char version[OTA_MANIFEST_VERSION_MAX];
+    char url[OTA_MANIFEST_URL_MAX];     // Absolute
+    uint32_t size;                      // 0 = not given
+    uint8_t sha256[32];
+    uint8_t signature[64];
+    bool hasSha256;
+    bool hasSignature;
+    bool delta;
+} OTAManifestChoice;
+
+/**
+ * Validators and outcome of the last manifest fetched (stored in NVS)
+ */
+typedef struct {
+    uint32_t magic;                     // OTA_MANIFEST_CACHE_MAGIC
+    uint16_t urlCrc;                    // Manifest URL the validators belong to
+    uint8_t result;                     // OTAManifestResult
+    char runningVersion[OTA_MANIFEST_VERSION_MAX];  // Version it was chosen for
+    char etag[OTA_MANIFEST_ETAG_MAX];
+    char lastModified[OTA_MANIFEST_DATE_MAX];
+    OTAManifestChoice choice;
+} OTAManifestCache;
+
+/**
+ * Compare dotted numeric versions ("1.10.0" > "1.9.2"); a suffix after
+ * the numbers ("-security") is ignored, missing parts count as 0
+ * @return <0, 0, >0 as a is older, equal, newer than b
+ */
+int OTAManifest_compareVersions(const char* a, const char* b);
+
+/**
+ * Resolve ref against base: absolute ("scheme://") as is, "/path" on
+ * base's host, anything else next to base's last '/'
+ * @return false if out is too small
+ */
+bool OTAManifest_resolveUrl(const char* base, const char* ref, char* out, size_t outSize);
+
+/**
+ * Choose the payload for a vehicle running currentVersion
+ * @param manifestUrl Where json came from (resolves relative URLs)
+ */
+OTAManifestResult OTAManifest_select(const char* json, size_t len, const char* manifestUrl,
+                                     const char* currentVersion, OTAManifestChoice* out);
+
+/**
+ * Cache holds validators that may be sent for this URL and version
+ */
+bool OTAManifest_cacheMatches(const OTAManifestCache* cache, const char* manifestUrl,
+                              const char* currentVersion);
+
+/**
+ * Record a fetched manifest; an ETag / date that does not fit is dropped
+ * (a truncated validator would never match)
+ */
+void OTAManifest_cacheStore(OTAManifestCache* cache, const char* manifestUrl,
+                            const char* currentVersion, const char* etag,
+                            const char* lastModified, OTAManifestResult result,
+                            const OTAManifestChoice* choice);
+
+#endif // OTA_MANIFEST_H
@@ -0,0 +1,54 @@
+#include "OTASignature.h"
+#include "mbedtls/ecdsa.h"
+#include <string.h>
+
+/**
+ * OTASignature - Implementation
+ *
+ * @file OTASignature.cpp
+ */
+
+void OTASignature_initKey(OTASignatureKey* key) {
+    mbedtls_ecp_group_init(&key->grp);
+    mbedtls_ecp_point_init(&key->Q);
+    key->loaded = false;
+}
+
+bool OTASignature_loadKey(OTASignatureKey* key, const uint8_t raw[OTA_SIGNATURE_KEY_SIZE]) {
+    OTASignature_freeKey(key);
+
+    // Uncompressed point: 0x04 || X || Y
+    uint8_t point[1 + OTA_SIGNATURE_KEY_SIZE];
+    point[0] = 0x04;
+    memcpy(point + 1, raw, OTA_SIGNATURE_KEY_SIZE);
+
+    if (mbedtls_ecp_group_load(&key->grp, MBEDTLS_ECP_DP_SECP256R1) != 0 ||
+        mbedtls_ecp_point_read_binary(&key->grp, &key->Q, point, sizeof(point)) != 0 ||
+        mbedtls_ecp_check_pubkey(&key->grp, &key->Q) != 0) {
+        OTASignature_freeKey(key);
+        return false;
+    }
+    key->loaded = true;
+    return true;
+}
+
+void OTASignature_freeKey(OTASignatureKey* key) {
+    mbedtls_ecp_point_free(&key->Q);
+    mbedtls_ecp_group_free(&key->grp);
+    OTASignature_initKey(key);
+}
+
+bool OTASignature_verify(OTASignatureKey* key, const uint8_t hash[32],
+                         const uint8_t signature[OTA_SIGNATURE_SIZE]) {
+    if (!key->loaded) return false;
+
+    mbedtls_mpi r, s;
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+    bool ok = mbedtls_mpi_read_binary(&r, signature, 32) == 0 &&
+              mbedtls_mpi_read_binary(&s, signature + 32, 32) == 0 &&
+              mbedtls_ecdsa_verify(&key->grp, hash, 32, &key->Q, &r, &s) == 0;
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&s);
+    return ok;
+}
@@ -0,0 +1,63 @@
+#ifndef OTA_SIGNATURE_H
+#define OTA_SIGNATURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mbedtls/ecp.h"
+
+/**
+ * OTASignature - ECDSA P-256 check of a firmware image hash
+ *
+ * The signature is over the SHA-256 of the final image, which the OTA
+ * pipeline already computes while streaming, so checking it costs one
+ * ECDSA verify at the end of the download and no second pass over the
+ * new partition.
+ *
+ * Keys and signatures are raw big-endian fields, not PEM / DER:
+ *   public key = X || Y (64 bytes), signature = r || s (64 bytes)
+ * The key is imported once (curve parameters loaded, point validated)
+ * and kept in an OTASignatureKey, so boot and each update skip any
+ * parsing.
+ *
+ * Same curve as KeyExchangeManager (secp256r1), so it adds no mbedtls
+ * code to the image.
+ *
+ * @file OTASignature.h
+ */
+
+#define OTA_SIGNATURE_SIZE      64      // r || s
+#define OTA_SIGNATURE_KEY_SIZE  64      // X || Y
+
+typedef struct {
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point Q;
+    bool loaded;
+} OTASignatureKey;
+
+/**
+ * Prepare an empty key
+ */
+void OTASignature_initKey(OTASignatureKey* key);
+
+/**
+ * Import a public key
+ * @param raw X || Y, 64 bytes
+ * @return true if the point is on the curve; key stays empty otherwise
+ */
+bool OTASignature_loadKey(OTASignatureKey* key, const uint8_t raw[OTA_SIGNATURE_KEY_SIZE]);
+
+/**
+ * Release a key (it can be loaded again afterwards)
+ */
+void OTASignature_freeKey(OTASignatureKey* key);
+
+/**
+ * Check a signature over an image hash
+ * @param hash SHA-256 of the image
+ * @param signature r || s, 64 bytes
+ * @return true if valid under the loaded key
+ */
+bool OTASignature_verify(OTASignatureKey* key, const uint8_t hash[32],
+                         const uint8_t signature[OTA_SIGNATURE_SIZE]);
+
+#endif // OTA_SIGNATURE_H
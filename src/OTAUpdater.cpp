@@ -1,17 +1,59 @@
 #include "OTAUpdater.h"
+#include "EspNowTx.h"
+#include "HAL.h"
+#include "MemPlacement.h"
+#include "MemoryProfiler.h"
+#include "NAFleetOta.h"
+#include "OTADelta.h"
+#include "OTAManifest.h"
+#include "OTASignature.h"
+#include "TaskScheduler.h"
 #include <Arduino.h>
 #include <HTTPClient.h>
+#include <Preferences.h>
 #include <SPIFFS.h>
 #include <Update.h>
+#include <esp32/rom/miniz.h>
+#include <esp_now.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
 #include <mbedtls/sha256.h>
 #include <string.h>
 
 // OTA Configuration
 #define OTA_TIMEOUT_MS 300000 // 5 minutes download timeout
-#define OTA_BUFFER_SIZE 4096  // 4KB download buffer
+#define OTA_BUFFER_SIZE 4096  // 4KB download buffer (static BULK_BSS, not on a stack)
+#define OTA_BUFFER_COUNT 2    // Network fills one while the writer drains the other
+#define OTA_BUFFER_END 0xFF   // Queue marker: download over, writer exits
 #define OTA_MAX_RETRIES 3
+#define OTA_URL_MAX 256
+#define OTA_TASK_STACK 8192   // HTTPClient / TLS
+#define OTA_WRITER_STACK 4096
+#define OTA_IMAGE_MAGIC 0xE9  // ESP32 app image header
+#define OTA_SECTOR_SIZE 4096  // Flash erase unit
+#define OTA_RETRY_DELAY_MS 2000
+#define OTA_CHECKPOINT_BYTES 65536 // Resume point saved every 64KB (NVS wear)
+#define OTA_CHECKPOINT_MAGIC 0x4F544152 // "OTAR"
+#define OTA_CHECKPOINT_NS "ota"
+#define OTA_CHECKPOINT_KEY "resume"
+#define OTA_SIGNING_KEY "sign_key" // Raw P-256 public key, same namespace
+#define OTA_IMAGE_KEY "image"      // Last installed image (OTAImageRecord)
+#define OTA_FLEET_KEY "fleet"      // Listen for fleet images
+#define OTA_MANIFEST_KEY "manifest" // Validators of the last manifest (OTAManifestCache)
+#define OTA_CHECK_TIMEOUT_MS 10000 // Whole manifest request
+#define OTA_CHECK_STACK 8192       // HTTPClient / TLS + the manifest's JSON
+#define OTA_FLEET_QUEUE 32         // Frames from the Wi-Fi task (~45 ms of chunks)
+#define OTA_FLEET_STACK 6144       // ECDSA verify of the announce
+#define OTA_FLEET_ANNOUNCE_MS 500
+#define OTA_FLEET_BURST 4          // Chunks per send step (then a tick's yield)
+#define OTA_FLEET_LINGER_MS 10000  // Sender: nothing pending and no NACK for this long
+#define OTA_FLEET_LOST_MS 30000    // Receiver: nothing heard from the sender for this long
+#define OTA_FLEET_SECTORS \
+  ((FLEET_OTA_MAX_CHUNKS * FLEET_OTA_CHUNK_SIZE + OTA_SECTOR_SIZE - 1) / OTA_SECTOR_SIZE)
 
 // Internal state
+// Written by the OTA task (and start / cancel), read by any task;
+// multi-field updates and snapshots go through otaMux.
 static struct {
   OTAStatus status;
   OTAErrorCode lastError;
@@ -19,8 +61,15 @@ static struct {
   uint32_t totalSize;
   uint8_t progress;
   uint32_t downloadStartTime;
+  uint32_t resumedFrom;
+  uint32_t stallMs; // Network task waiting on the writer, this update
   uint8_t expectedSHA256[32];
+  uint8_t signature[OTA_SIGNATURE_SIZE];
+  bool hasSignature;
   bool initialized;
+  bool taskRunning;
+  volatile bool cancelRequested;
+  char url[OTA_URL_MAX];
 
   // Statistics
   uint32_t totalAttempts;
@@ -28,24 +77,958 @@ static struct {
   uint32_t failedUpdates;
   uint32_t rollbacks;
   uint32_t lastUpdateTime;
+  uint32_t lastThroughputBps;
+  uint32_t lastStallMs;
 } otaState = {.status = OTA_STATUS_IDLE,
               .lastError = OTA_ERR_NONE,
               .bytesDownloaded = 0,
               .totalSize = 0,
               .progress = 0,
               .downloadStartTime = 0,
+              .resumedFrom = 0,
+              .stallMs = 0,
+              .hasSignature = false,
               .initialized = false,
+              .taskRunning = false,
+              .cancelRequested = false,
               .totalAttempts = 0,
               .successfulUpdates = 0,
               .failedUpdates = 0,
               .rollbacks = 0,
-              .lastUpdateTime = 0};
+              .lastUpdateTime = 0,
+              .lastThroughputBps = 0,
+              .lastStallMs = 0};
+
+static portMUX_TYPE otaMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Download buffers, handed between the two OTA tasks by index:
+//   ota (network):  free queue -> fill from WiFiClient -> full queue
+//   ota_flash:      full queue -> pipeline / flash / hash -> free queue
+// so the socket keeps being drained while a sector is erased and written.
+BULK_BSS static uint8_t otaBuffers[OTA_BUFFER_COUNT][OTA_BUFFER_SIZE];
+static uint16_t otaBufferLen[OTA_BUFFER_COUNT];
+static QueueHandle_t otaFreeQueue;
+static QueueHandle_t otaFullQueue;
+static TaskHandle_t otaNetworkTask;
+static volatile bool otaWriterFailed;
+
+typedef enum {
+  IMAGE_UNKNOWN = 0, // Waiting for the first 4 bytes
+  IMAGE_RAW,
+  IMAGE_DELTA
+} OTAImageKind;
+
+// Per-update pipeline (OTA task only):
+//   network -> [zlib inflate] -> [delta patch] -> Update.write + SHA-256
+// Compression is detected from the zlib header of the download, a delta
+// patch from its magic once inflated; anything else is a plain image.
+// The 32KB inflate window is only allocated for compressed downloads.
+static struct {
+  bool started;
+  bool compressed;
+  bool inflateDone;
+  tinfl_decompressor *inflater;
+  uint8_t *dict;
+  size_t dictOfs;
+
+  OTAImageKind kind;
+  uint8_t prefix[4];
+  uint8_t prefixLen;
+  OTADelta delta;
+  const esp_partition_t *source;
+
+  bool begun;
+  uint32_t imageBytes; // Final image written so far
+  mbedtls_sha256_context sha;
+  OTAErrorCode error;
+  const char *errorMsg;
+} otaPipe;
+
+// Sequential writer into the next OTA partition. Data is collected into
+// whole sectors, each erased and programmed in one go, so a resumed
+// update continues in place at a sector boundary; the boot partition
+// only switches once the whole image is verified. otaSector may be in
+// PSRAM: the flash driver copies such a source through an internal
+// bounce buffer, since the cache (and with it PSRAM) is off while it writes.
+static struct {
+  const esp_partition_t *part;
+  uint32_t offset; // Flashed so far, sector aligned
+  uint16_t fill;   // Bytes waiting in otaSector
+} otaFlash;
+BULK_BSS static uint8_t otaSector[OTA_SECTOR_SIZE];
+
+// Resume point of a plain-image download (NVS). Compressed and delta
+// downloads restart instead: their decoder state lives in RAM.
+typedef struct {
+  uint32_t magic;
+  uint32_t partition; // Target partition address
+  uint32_t offset;    // Sector aligned, flashed up to here
+  uint32_t totalSize;
+  uint8_t expectedSHA256[32];
+  char url[OTA_URL_MAX];
+} OTACheckpoint;
+
+static uint32_t otaCheckpointOffset;
+
+// Imported once at init / set time; read by the OTA task at the end of
+// each update. Updates are refused while it is being replaced.
+static OTASignatureKey otaSigningKey;
+
+// Manifest checks (ota_check task; getters copy under otaMux). The
+// cache is written by the check only, after boot.
+static OTAManifestCache otaManifest;
+static OTACheckInfo otaCheck;
+static char otaCheckUrl[OTA_URL_MAX];
+static bool otaCheckInstall;
 
 // Internal error logging
 static void logOTAEvent(const char *event, const char *details) {
   Serial.printf("[OTA] %s: %s\n", event, details ? details : "");
 }
 
+static void setStatus(OTAStatus status) {
+  portENTER_CRITICAL(&otaMux);
+  // A cancel already reported IDLE; don't overwrite it
+  if (!otaState.cancelRequested)
+    otaState.status = status;
+  portEXIT_CRITICAL(&otaMux);
+}
+
+static void failUpdate(OTAErrorCode error, const char *details) {
+  logOTAEvent("ERROR", details);
+  portENTER_CRITICAL(&otaMux);
+  if (!otaState.cancelRequested) {
+    otaState.status = OTA_STATUS_ERROR;
+    otaState.lastError = error;
+  }
+  otaState.failedUpdates++;
+  portEXIT_CRITICAL(&otaMux);
+}
+
+static bool pipeFail(OTAErrorCode error, const char *msg) {
+  if (otaPipe.error == OTA_ERR_NONE) {
+    otaPipe.error = error;
+    otaPipe.errorMsg = msg;
+  }
+  return false;
+}
+
+// ============================================================================
+// Flash Writer
+// ============================================================================
+
+static bool flashBegin(uint32_t size, uint32_t offset) {
+  otaFlash.part = esp_ota_get_next_update_partition(NULL);
+  if (!otaFlash.part)
+    return pipeFail(OTA_ERR_FLASH_ERROR, "No OTA partition");
+  if (size != OTA_SIZE_UNKNOWN && size > otaFlash.part->size)
+    return pipeFail(OTA_ERR_STORAGE_FULL, "Image larger than partition");
+  otaFlash.offset = offset;
+  otaFlash.fill = 0;
+  return true;
+}
+
+static bool flashSector(void) {
+  if (esp_partition_erase_range(otaFlash.part, otaFlash.offset,
+                                OTA_SECTOR_SIZE) != ESP_OK)
+    return pipeFail(OTA_ERR_FLASH_ERROR, "Flash erase failed");
+  if (esp_partition_write(otaFlash.part, otaFlash.offset, otaSector,
+                          otaFlash.fill) != ESP_OK)
+    return pipeFail(OTA_ERR_FLASH_ERROR, "Flash write failed");
+  otaFlash.offset += OTA_SECTOR_SIZE;
+  otaFlash.fill = 0;
+  return true;
+}
+
+static bool flashWrite(const uint8_t *data, size_t len) {
+  if (otaFlash.offset + otaFlash.fill + len > otaFlash.part->size)
+    return pipeFail(OTA_ERR_STORAGE_FULL, "Image larger than partition");
+  while (len > 0) {
+    size_t n = min(len, (size_t)(OTA_SECTOR_SIZE - otaFlash.fill));
+    memcpy(otaSector + otaFlash.fill, data, n);
+    otaFlash.fill += n;
+    data += n;
+    len -= n;
+    if (otaFlash.fill == OTA_SECTOR_SIZE && !flashSector())
+      return false;
+  }
+  return true;
+}
+
+// Last, partial sector
+static bool flashFlush(void) {
+  return otaFlash.fill == 0 || flashSector();
+}
+
+// Validates the image (esp_image_verify) and makes it the boot partition
+static bool flashEnd(void) {
+  esp_err_t err = esp_ota_set_boot_partition(otaFlash.part);
+  if (err == ESP_ERR_OTA_VALIDATE_FAILED)
+    return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Image validation failed");
+  if (err != ESP_OK)
+    return pipeFail(OTA_ERR_FLASH_ERROR, "Set boot partition failed");
+  return true;
+}
+
+// ============================================================================
+// Resume Checkpoint
+// ============================================================================
+
+static void clearCheckpoint(void) {
+  Preferences prefs;
+  if (prefs.begin(OTA_CHECKPOINT_NS, false)) {
+    if (prefs.isKey(OTA_CHECKPOINT_KEY))
+      prefs.remove(OTA_CHECKPOINT_KEY);
+    prefs.end();
+  }
+  otaCheckpointOffset = 0;
+}
+
+// Plain images only, once another OTA_CHECKPOINT_BYTES are on flash
+// (ota_flash task)
+static void saveCheckpoint(void) {
+  if (otaPipe.compressed || otaPipe.kind != IMAGE_RAW)
+    return;
+  uint32_t offset = otaFlash.offset;
+  if (offset < otaCheckpointOffset + OTA_CHECKPOINT_BYTES)
+    return;
+
+  OTACheckpoint cp;
+  memset(&cp, 0, sizeof(cp));
+  cp.magic = OTA_CHECKPOINT_MAGIC;
+  cp.partition = otaFlash.part->address;
+  cp.offset = offset;
+  cp.totalSize = otaState.totalSize;
+  memcpy(cp.expectedSHA256, otaState.expectedSHA256, 32);
+  strncpy(cp.url, otaState.url, OTA_URL_MAX - 1);
+
+  Preferences prefs;
+  if (prefs.begin(OTA_CHECKPOINT_NS, false)) {
+    if (prefs.putBytes(OTA_CHECKPOINT_KEY, &cp, sizeof(cp)) == sizeof(cp))
+      otaCheckpointOffset = offset;
+    prefs.end();
+  }
+}
+
+/**
+ * Pick up a download interrupted by a reboot (or an earlier link loss)
+ * Same URL, same expected hash and same target partition only. The
+ * hash of the part already on flash is rebuilt by reading it back,
+ * which also covers whatever the flash actually holds.
+ * @return Offset to resume from, 0 to start over
+ */
+static uint32_t loadCheckpoint(const char *url) {
+  OTACheckpoint cp;
+  Preferences prefs;
+  if (!prefs.begin(OTA_CHECKPOINT_NS, true))
+    return 0;
+  bool found = prefs.getBytesLength(OTA_CHECKPOINT_KEY) == sizeof(cp) &&
+               prefs.getBytes(OTA_CHECKPOINT_KEY, &cp, sizeof(cp)) == sizeof(cp);
+  prefs.end();
+  if (!found)
+    return 0;
+
+  const esp_partition_t *part = esp_ota_get_next_update_partition(NULL);
+  cp.url[OTA_URL_MAX - 1] = '\0';
+  if (cp.magic != OTA_CHECKPOINT_MAGIC || !part ||
+      cp.partition != part->address || strcmp(cp.url, url) != 0 ||
+      memcmp(cp.expectedSHA256, otaState.expectedSHA256, 32) != 0 ||
+      cp.offset == 0 || cp.offset % OTA_SECTOR_SIZE != 0 ||
+      cp.offset >= cp.totalSize || cp.totalSize > part->size)
+    return 0;
+
+  uint8_t *buf = otaBuffers[0]; // Tasks not streaming yet
+  for (uint32_t ofs = 0; ofs < cp.offset; ofs += OTA_BUFFER_SIZE) {
+    uint32_t n = min((uint32_t)OTA_BUFFER_SIZE, cp.offset - ofs);
+    if (esp_partition_read(part, ofs, buf, n) != ESP_OK)
+      return 0;
+    if (ofs == 0 && buf[0] != OTA_IMAGE_MAGIC)
+      return 0;
+    mbedtls_sha256_update(&otaPipe.sha, buf, n);
+  }
+
+  if (!flashBegin(cp.totalSize, cp.offset))
+    return 0;
+  otaPipe.started = true;
+  otaPipe.kind = IMAGE_RAW;
+  otaPipe.begun = true;
+  otaPipe.imageBytes = cp.offset;
+  otaCheckpointOffset = cp.offset;
+
+  portENTER_CRITICAL(&otaMux);
+  otaState.totalSize = cp.totalSize;
+  otaState.bytesDownloaded = cp.offset;
+  otaState.resumedFrom = cp.offset;
+  portEXIT_CRITICAL(&otaMux);
+  return cp.offset;
+}
+
+// ============================================================================
+// Installed Image
+// ============================================================================
+
+// What the last successful update put on flash: a fleet sender serves it
+// once it is running, a fleet receiver skips announcements of it
+typedef struct {
+  uint32_t partition; // Address it was written to
+  uint32_t size;
+  uint8_t sha256[32];
+  uint8_t signature[OTA_SIGNATURE_SIZE];
+  bool hasSignature;
+} OTAImageRecord;
+
+static OTAImageRecord otaInstalled; // Loaded at init, kept in step with NVS
+static bool otaInstalledValid;
+
+static void loadImageRecord(void) {
+  Preferences prefs;
+  otaInstalledValid = false;
+  if (prefs.begin(OTA_CHECKPOINT_NS, true)) {
+    otaInstalledValid =
+        prefs.getBytesLength(OTA_IMAGE_KEY) == sizeof(otaInstalled) &&
+        prefs.getBytes(OTA_IMAGE_KEY, &otaInstalled, sizeof(otaInstalled)) ==
+            sizeof(otaInstalled);
+    prefs.end();
+  }
+}
+
+static void saveImageRecord(const esp_partition_t *part, uint32_t size,
+                            const uint8_t sha256[32], const uint8_t *signature) {
+  OTAImageRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.partition = part->address;
+  rec.size = size;
+  memcpy(rec.sha256, sha256, 32);
+  rec.hasSignature = signature != NULL;
+  if (signature)
+    memcpy(rec.signature, signature, OTA_SIGNATURE_SIZE);
+
+  Preferences prefs;
+  if (prefs.begin(OTA_CHECKPOINT_NS, false)) {
+    if (prefs.putBytes(OTA_IMAGE_KEY, &rec, sizeof(rec)) == sizeof(rec)) {
+      otaInstalled = rec;
+      otaInstalledValid = true;
+    }
+    prefs.end();
+  }
+}
+
+// ============================================================================
+// Image Pipeline
+// ============================================================================
+
+static void pipeInit(void) {
+  memset(&otaPipe, 0, sizeof(otaPipe));
+  mbedtls_sha256_init(&otaPipe.sha);
+  mbedtls_sha256_starts(&otaPipe.sha, 0); // 0 = SHA256
+}
+
+static void pipeFree(uint8_t calculatedHash[32]) {
+  mbedtls_sha256_finish(&otaPipe.sha, calculatedHash);
+  mbedtls_sha256_free(&otaPipe.sha);
+  MemPlacement_free(otaPipe.inflater);
+  MemPlacement_free(otaPipe.dict);
+  otaPipe.inflater = NULL;
+  otaPipe.dict = NULL;
+}
+
+// The patch is only valid against the image it was made from
+static bool verifyDeltaSource(void) {
+  const OTADelta *d = &otaPipe.delta;
+  if (!otaPipe.source || d->sourceSize > otaPipe.source->size)
+    return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Delta source too large");
+
+  mbedtls_sha256_context ctx;
+  mbedtls_sha256_init(&ctx);
+  mbedtls_sha256_starts(&ctx, 0);
+  uint8_t buf[512];
+  bool ok = true;
+  for (uint32_t ofs = 0; ok && ofs < d->sourceSize; ofs += sizeof(buf)) {
+    uint32_t n = min((uint32_t)sizeof(buf), d->sourceSize - ofs);
+    ok = esp_partition_read(otaPipe.source, ofs, buf, n) == ESP_OK;
+    if (ok)
+      mbedtls_sha256_update(&ctx, buf, n);
+  }
+  uint8_t hash[32];
+  mbedtls_sha256_finish(&ctx, hash);
+  mbedtls_sha256_free(&ctx);
+  if (!ok)
+    return pipeFail(OTA_ERR_FLASH_ERROR, "Delta source read failed");
+  if (memcmp(hash, d->sourceSHA256, 32) != 0)
+    return pipeFail(OTA_ERR_CHECKSUM_FAILED, "Delta source mismatch");
+  return true;
+}
+
+// Final image bytes; the writer starts on the first of them so the size
+// can be checked (delta target, content length, or unknown if inflated)
+static bool imageWrite(const uint8_t *data, size_t len) {
+  if (!otaPipe.begun) {
+    uint32_t size = OTA_SIZE_UNKNOWN;
+    if (otaPipe.kind == IMAGE_DELTA) {
+      if (!verifyDeltaSource())
+        return false;
+      size = otaPipe.delta.targetSize;
+    } else if (!otaPipe.compressed) {
+      size = otaState.totalSize;
+    }
+    if (data[0] != OTA_IMAGE_MAGIC)
+      return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Not an app image");
+    if (!flashBegin(size, 0))
+      return false;
+    otaPipe.begun = true;
+  }
+  if (!flashWrite(data, len))
+    return false;
+  mbedtls_sha256_update(&otaPipe.sha, data, len);
+  otaPipe.imageBytes += len;
+  return true;
+}
+
+static bool deltaRead(void *ctx, uint32_t offset, uint8_t *buf, uint32_t len) {
+  return esp_partition_read(otaPipe.source, offset, buf, len) == ESP_OK;
+}
+
+static bool deltaWrite(void *ctx, const uint8_t *data, uint32_t len) {
+  return imageWrite(data, len);
+}
+
+static bool deltaFeed(const uint8_t *data, size_t len) {
+  switch (OTADelta_feed(&otaPipe.delta, data, len)) {
+  case OTA_DELTA_OK:
+    return true;
+  case OTA_DELTA_ERR_SOURCE:
+    return pipeFail(OTA_ERR_FLASH_ERROR, "Delta source read failed");
+  case OTA_DELTA_ERR_WRITE:
+    return false; // imageWrite already set the error
+  default:
+    return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Bad delta patch");
+  }
+}
+
+// Decompressed (or plain) download bytes
+static bool imageFeed(const uint8_t *data, size_t len) {
+  if (otaPipe.kind == IMAGE_UNKNOWN) {
+    size_t n = min(len, sizeof(otaPipe.prefix) - otaPipe.prefixLen);
+    memcpy(otaPipe.prefix + otaPipe.prefixLen, data, n);
+    otaPipe.prefixLen += n;
+    data += n;
+    len -= n;
+    if (otaPipe.prefixLen < sizeof(otaPipe.prefix))
+      return true;
+
+    if (OTADelta_isPatch(otaPipe.prefix, otaPipe.prefixLen)) {
+      otaPipe.kind = IMAGE_DELTA;
+      otaPipe.source = esp_ota_get_running_partition();
+      OTADelta_init(&otaPipe.delta, deltaRead, deltaWrite, NULL);
+      logOTAEvent("FORMAT", "Delta patch");
+      if (!deltaFeed(otaPipe.prefix, otaPipe.prefixLen))
+        return false;
+    } else {
+      otaPipe.kind = IMAGE_RAW;
+      if (!imageWrite(otaPipe.prefix, otaPipe.prefixLen))
+        return false;
+    }
+  }
+  if (len == 0)
+    return true;
+  return otaPipe.kind == IMAGE_DELTA ? deltaFeed(data, len)
+                                     : imageWrite(data, len);
+}
+
+// Streaming inflate into the circular window; each run of new output is
+// passed on before the window wraps over it
+static bool inflateFeed(const uint8_t *data, size_t len) {
+  while (len > 0 || !otaPipe.inflateDone) {
+    if (otaPipe.inflateDone)
+      return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Data after compressed image");
+
+    size_t inBytes = len;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - otaPipe.dictOfs;
+    tinfl_status status = tinfl_decompress(
+        otaPipe.inflater, data, &inBytes, otaPipe.dict,
+        otaPipe.dict + otaPipe.dictOfs, &outBytes,
+        TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+    data += inBytes;
+    len -= inBytes;
+
+    if (outBytes && !imageFeed(otaPipe.dict + otaPipe.dictOfs, outBytes))
+      return false;
+    otaPipe.dictOfs = (otaPipe.dictOfs + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+
+    if (status < TINFL_STATUS_DONE)
+      return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Bad compressed data");
+    if (status == TINFL_STATUS_DONE)
+      otaPipe.inflateDone = true;
+    else if (status == TINFL_STATUS_NEEDS_MORE_INPUT)
+      return true;
+  }
+  return true;
+}
+
+static bool isZlibHeader(const uint8_t *data) {
+  return (data[0] & 0x0F) == 8 && ((data[0] << 8) | data[1]) % 31 == 0;
+}
+
+/**
+ * Push one network chunk (at least 2 bytes for the first one)
+ */
+static bool pipeFeed(const uint8_t *data, size_t len) {
+  if (!otaPipe.started) {
+    otaPipe.started = true;
+    otaPipe.compressed = isZlibHeader(data);
+    if (otaPipe.compressed) {
+      logOTAEvent("FORMAT", "zlib compressed");
+      otaPipe.inflater = (tinfl_decompressor *)MemPlacement_alloc(
+          "ota_inflate", sizeof(tinfl_decompressor), MEM_CLASS_BULK);
+      otaPipe.dict = (uint8_t *)MemPlacement_alloc("ota_dict", TINFL_LZ_DICT_SIZE, MEM_CLASS_BULK);
+      if (!otaPipe.inflater || !otaPipe.dict)
+        return pipeFail(OTA_ERR_MEMORY_INSUFFICIENT, "No memory for inflate");
+      tinfl_init(otaPipe.inflater);
+    }
+  }
+  return otaPipe.compressed ? inflateFeed(data, len) : imageFeed(data, len);
+}
+
+/**
+ * Whole download received: check nothing is left half-decoded
+ */
+static bool pipeFinish(void) {
+  if (otaPipe.compressed && !otaPipe.inflateDone)
+    return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Truncated compressed image");
+  if (otaPipe.kind == IMAGE_DELTA && !OTADelta_isComplete(&otaPipe.delta))
+    return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Truncated delta patch");
+  if (!otaPipe.begun)
+    return pipeFail(OTA_ERR_INVALID_FIRMWARE, "Image too short");
+  return flashFlush();
+}
+
+// ============================================================================
+// Writer Task
+// ============================================================================
+
+static void otaWriterEntry(void *arg) {
+  uint8_t idx;
+  for (;;) {
+    xQueueReceive(otaFullQueue, &idx, portMAX_DELAY);
+    if (idx == OTA_BUFFER_END)
+      break;
+    // After an error keep recycling buffers until the network side stops
+    if (!otaWriterFailed) {
+      if (pipeFeed(otaBuffers[idx], otaBufferLen[idx])) {
+        saveCheckpoint();
+      } else {
+        failUpdate(otaPipe.error, otaPipe.errorMsg);
+        otaWriterFailed = true;
+      }
+    }
+    xQueueSend(otaFreeQueue, &idx, portMAX_DELAY);
+  }
+  xTaskNotifyGive(otaNetworkTask);
+  vTaskDelete(NULL);
+}
+
+static bool startWriter(void) {
+  otaWriterFailed = false;
+  otaNetworkTask = xTaskGetCurrentTaskHandle();
+  otaFreeQueue = xQueueCreate(OTA_BUFFER_COUNT, sizeof(uint8_t));
+  otaFullQueue = xQueueCreate(OTA_BUFFER_COUNT + 1, sizeof(uint8_t));
+  if (!otaFreeQueue || !otaFullQueue)
+    return false;
+  for (uint8_t i = 0; i < OTA_BUFFER_COUNT; i++)
+    xQueueSend(otaFreeQueue, &i, 0);
+  // Below the network task, so a ready socket always preempts flash work
+  MemoryProfiler_setTaskStackSize("ota_flash", OTA_WRITER_STACK);
+  return xTaskCreatePinnedToCore(otaWriterEntry, "ota_flash", OTA_WRITER_STACK,
+                                 NULL, SCHED_PRIORITY_OTA_FLASH, NULL,
+                                 SCHED_BACKGROUND_CORE) == pdPASS;
+}
+
+// Every buffer handed over has been written once this returns
+static void stopWriter(bool started) {
+  if (started) {
+    uint8_t end = OTA_BUFFER_END;
+    xQueueSend(otaFullQueue, &end, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  }
+  if (otaFreeQueue)
+    vQueueDelete(otaFreeQueue);
+  if (otaFullQueue)
+    vQueueDelete(otaFullQueue);
+  otaFreeQueue = NULL;
+  otaFullQueue = NULL;
+}
+
+// Next empty buffer; waiting here is the writer falling behind
+static bool acquireBuffer(uint8_t *idx) {
+  if (xQueueReceive(otaFreeQueue, idx, 0) == pdTRUE)
+    return true;
+  uint32_t start = HAL_GetMillis();
+  bool ok = true;
+  while (xQueueReceive(otaFreeQueue, idx, pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (otaState.cancelRequested) {
+      ok = false;
+      break;
+    }
+  }
+  otaState.stallMs += HAL_GetMillis() - start;
+  return ok;
+}
+
+static void handOff(uint8_t idx, uint16_t len) {
+  otaBufferLen[idx] = len;
+  xQueueSend(otaFullQueue, &idx, portMAX_DELAY); // Room for every buffer
+}
+
+// ============================================================================
+// Fleet Distribution
+// ============================================================================
+
+typedef struct {
+  uint8_t len;
+  uint8_t data[sizeof(NAFleetChunk)]; // Largest fleet frame
+} OTAFleetFrame;
+
+// Everything below the queue belongs to the ota_fleet task; role is read
+// by other tasks, the counters only as statistics
+static struct {
+  QueueHandle_t queue;
+  TaskHandle_t task;
+  volatile bool listening;
+  volatile bool hold;
+  volatile bool sendRequested;
+  volatile bool stopRequested;
+  volatile OTAFleetRole role;
+  OTAImageRecord image; // Served, or announced and being received
+  union {
+    FleetOtaTx tx;
+    FleetOtaRx rx;
+  };
+  uint8_t erased[(OTA_FLEET_SECTORS + 7) / 8]; // Receiver: sectors erased this update
+  uint32_t lastHeardMs;                        // Receiver: the sender's last frame
+  uint32_t lastActivityMs;                     // Sender: last chunk sent or NACK heard
+  uint32_t lastAnnounceMs;
+  uint32_t rejectedId; // Announced with a bad signature, ignored until reboot
+} otaFleet;
+
+static const uint8_t fleetBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+// The driver queue fills up at full rate; waiting a tick is the pacing
+static void fleetBroadcast(const void *frame, size_t len) {
+  for (uint8_t tries = 0; tries < 10; tries++) {
+    if (esp_now_send(fleetBroadcastMac, (const uint8_t *)frame, len) !=
+        ESP_ERR_ESPNOW_NO_MEM)
+      return;
+    vTaskDelay(1);
+  }
+}
+
+// SHA-256 of the first size bytes of a partition
+static bool hashPartition(const esp_partition_t *part, uint32_t size,
+                          uint8_t hash[32]) {
+  mbedtls_sha256_context ctx;
+  mbedtls_sha256_init(&ctx);
+  mbedtls_sha256_starts(&ctx, 0);
+  uint8_t buf[512];
+  bool ok = true;
+  for (uint32_t ofs = 0; ok && ofs < size; ofs += sizeof(buf)) {
+    uint32_t n = min((uint32_t)sizeof(buf), size - ofs);
+    ok = esp_partition_read(part, ofs, buf, n) == ESP_OK;
+    if (ok)
+      mbedtls_sha256_update(&ctx, buf, n);
+  }
+  mbedtls_sha256_finish(&ctx, hash);
+  mbedtls_sha256_free(&ctx);
+  return ok;
+}
+
+// ---- Sender ----
+
+static void fleetSendBegin(uint32_t now) {
+  // The record says what was installed; check it is what runs
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  uint8_t hash[32];
+  if (!otaInstalledValid || !running || otaInstalled.partition != running->address ||
+      !hashPartition(running, otaInstalled.size, hash) ||
+      memcmp(hash, otaInstalled.sha256, 32) != 0) {
+    logOTAEvent("FLEET", "Running image does not match its record");
+    return;
+  }
+  otaFleet.image = otaInstalled;
+  FleetOtaTx_begin(&otaFleet.tx, otaInstalled.size);
+  otaFleet.lastActivityMs = now;
+  otaFleet.lastAnnounceMs = now - OTA_FLEET_ANNOUNCE_MS;
+  otaFleet.stopRequested = false;
+  otaFleet.role = OTA_FLEET_SENDING;
+  logOTAEvent("FLEET", "Serving running image");
+}
+
+static void fleetSendStep(uint32_t now) {
+  FleetOtaTx *tx = &otaFleet.tx;
+  if (otaFleet.stopRequested ||
+      (tx->pendingCount == 0 && now - otaFleet.lastActivityMs > OTA_FLEET_LINGER_MS)) {
+    otaFleet.role = OTA_FLEET_IDLE;
+    logOTAEvent("FLEET", otaFleet.stopRequested ? "Stopped" : "No more NACKs, done");
+    return;
+  }
+
+  if (now - otaFleet.lastAnnounceMs >= OTA_FLEET_ANNOUNCE_MS) {
+    NAFleetAnnounce announce;
+    NA_Fleet_buildAnnounce(&announce, otaFleet.image.size, otaFleet.image.sha256,
+                           otaFleet.image.signature);
+    fleetBroadcast(&announce, sizeof(announce));
+    otaFleet.lastAnnounceMs = now;
+  }
+
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  NAFleetChunk chunk;
+  chunk.protocolVersion = PROTOCOL_VERSION;
+  chunk.type = NA_FLEET_CHUNK_TYPE;
+  chunk.imageId = NA_Fleet_imageId(otaFleet.image.sha256);
+  uint16_t index;
+  for (uint8_t n = 0; n < OTA_FLEET_BURST && FleetOtaTx_next(tx, &index); n++) {
+    uint16_t len = FleetOta_chunkLength(tx->imageSize, index);
+    memset(chunk.data + len, 0xFF, sizeof(chunk.data) - len);
+    if (esp_partition_read(running, (uint32_t)index * FLEET_OTA_CHUNK_SIZE, chunk.data,
+                           len) != ESP_OK)
+      continue; // Asked for again by whoever misses it
+    chunk.index = index;
+    fleetBroadcast(&chunk, sizeof(chunk));
+    otaFleet.lastActivityMs = now;
+  }
+}
+
+// ---- Receiver ----
+
+static void fleetJoin(const NAFleetAnnounce *announce, uint32_t now) {
+  if (!otaFleet.listening || otaFleet.hold || !NA_Fleet_announceValid(announce) ||
+      announce->imageId == otaFleet.rejectedId)
+    return;
+  // Only signed images are taken over the air from another vehicle
+  if (!otaSigningKey.loaded)
+    return;
+  if (otaInstalledValid && memcmp(otaInstalled.sha256, announce->sha256, 32) == 0)
+    return; // Already running it, or installed and waiting for a reboot
+  if (FleetOta_chunkCount(announce->imageSize) == 0)
+    return;
+  if (!OTASignature_verify(&otaSigningKey, announce->sha256, announce->signature)) {
+    otaFleet.rejectedId = announce->imageId;
+    logOTAEvent("FLEET", "Announced signature invalid, ignored");
+    return;
+  }
+
+  portENTER_CRITICAL(&otaMux);
+  bool busy = otaState.taskRunning;
+  if (!busy) {
+    otaState.taskRunning = true;
+    otaState.cancelRequested = false;
+    otaState.status = OTA_STATUS_DOWNLOADING;
+    otaState.bytesDownloaded = 0;
+    otaState.totalSize = announce->imageSize;
+    otaState.resumedFrom = 0;
+    otaState.stallMs = 0;
+    otaState.progress = 0;
+    otaState.lastError = OTA_ERR_NONE;
+    otaState.totalAttempts++;
+  }
+  portEXIT_CRITICAL(&otaMux);
+  if (busy)
+    return;
+
+  otaState.downloadStartTime = now;
+  pipeInit();
+  if (!flashBegin(announce->imageSize, 0)) {
+    failUpdate(otaPipe.error, otaPipe.errorMsg);
+    uint8_t unused[32];
+    pipeFree(unused);
+    portENTER_CRITICAL(&otaMux);
+    otaState.taskRunning = false;
+    portEXIT_CRITICAL(&otaMux);
+    return;
+  }
+  memset(&otaFleet.image, 0, sizeof(otaFleet.image));
+  otaFleet.image.size = announce->imageSize;
+  memcpy(otaFleet.image.sha256, announce->sha256, 32);
+  memcpy(otaFleet.image.signature, announce->signature, OTA_SIGNATURE_SIZE);
+  otaFleet.image.hasSignature = true;
+  FleetOtaRx_begin(&otaFleet.rx, announce->imageId, announce->imageSize, now);
+  memset(otaFleet.erased, 0, sizeof(otaFleet.erased));
+  otaFleet.lastHeardMs = now;
+  otaFleet.role = OTA_FLEET_RECEIVING;
+  logOTAEvent("FLEET", "Receiving announced image");
+}
+
+// Chunks land anywhere: each sector is erased the first time it's touched
+static bool fleetWrite(uint32_t offset, const uint8_t *data, uint16_t len) {
+  for (uint32_t s = offset / OTA_SECTOR_SIZE; s <= (offset + len - 1) / OTA_SECTOR_SIZE; s++) {
+    if (otaFleet.erased[s >> 3] & (1u << (s & 7)))
+      continue;
+    if (esp_partition_erase_range(otaFlash.part, s * OTA_SECTOR_SIZE, OTA_SECTOR_SIZE) !=
+        ESP_OK)
+      return pipeFail(OTA_ERR_FLASH_ERROR, "Flash erase failed");
+    otaFleet.erased[s >> 3] |= 1u << (s & 7);
+  }
+  if (esp_partition_write(otaFlash.part, offset, data, len) != ESP_OK)
+    return pipeFail(OTA_ERR_FLASH_ERROR, "Flash write failed");
+  return true;
+}
+
+// Whole image in place: hash what the flash holds, then switch
+static bool fleetVerify(void) {
+  setStatus(OTA_STATUS_VERIFYING);
+  uint8_t hash[32];
+  bool read = hashPartition(otaFlash.part, otaFleet.image.size, hash);
+  if (!read)
+    return pipeFail(OTA_ERR_FLASH_ERROR, "Flash read failed");
+  // The announce signature was checked over this same hash
+  if (memcmp(hash, otaFleet.image.sha256, 32) != 0)
+    return pipeFail(OTA_ERR_SIGNATURE_MISMATCH, "SHA256 mismatch");
+  setStatus(OTA_STATUS_FLASHING);
+  if (!flashEnd())
+    return false;
+  saveImageRecord(otaFlash.part, otaFleet.image.size, hash, otaFleet.image.signature);
+  return true;
+}
+
+static void fleetEndReceive(bool ok) {
+  uint8_t unused[32];
+  pipeFree(unused);
+  uint32_t elapsed = HAL_GetMillis() - otaState.downloadStartTime;
+  otaState.lastStallMs = 0;
+  otaState.lastThroughputBps =
+      elapsed ? (uint32_t)((uint64_t)otaState.bytesDownloaded * 1000 / elapsed) : 0;
+  otaFleet.role = OTA_FLEET_IDLE;
+
+  portENTER_CRITICAL(&otaMux);
+  if (ok) {
+    otaState.status = OTA_STATUS_SUCCESS;
+    otaState.successfulUpdates++;
+    otaState.lastUpdateTime = HAL_GetMillis();
+  }
+  otaState.taskRunning = false;
+  portEXIT_CRITICAL(&otaMux);
+  logOTAEvent("FLEET", ok ? "Image verified, boots next" : "Receive ended");
+}
+
+static void fleetChunk(const NAFleetChunk *chunk, uint32_t now) {
+  FleetOtaRx *rx = &otaFleet.rx;
+  if (chunk->imageId == rx->imageId)
+    otaFleet.lastHeardMs = now;
+  if (FleetOtaRx_accept(rx, chunk->imageId, chunk->index, now) != FLEET_CHUNK_NEW)
+    return;
+  if (chunk->index == 0 && chunk->data[0] != OTA_IMAGE_MAGIC) {
+    pipeFail(OTA_ERR_INVALID_FIRMWARE, "Not an app image");
+    failUpdate(otaPipe.error, otaPipe.errorMsg);
+    fleetEndReceive(false);
+    return;
+  }
+  if (!fleetWrite((uint32_t)chunk->index * FLEET_OTA_CHUNK_SIZE, chunk->data,
+                  FleetOta_chunkLength(rx->imageSize, chunk->index))) {
+    failUpdate(otaPipe.error, otaPipe.errorMsg);
+    fleetEndReceive(false);
+    return;
+  }
+
+  uint32_t bytes = min((uint32_t)rx->received * FLEET_OTA_CHUNK_SIZE, rx->imageSize);
+  portENTER_CRITICAL(&otaMux);
+  otaState.bytesDownloaded = bytes;
+  otaState.progress = (uint8_t)(((uint64_t)bytes * 100) / rx->imageSize);
+  portEXIT_CRITICAL(&otaMux);
+
+  if (FleetOtaRx_complete(rx)) {
+    bool ok = fleetVerify();
+    if (!ok)
+      failUpdate(otaPipe.error, otaPipe.errorMsg);
+    fleetEndReceive(ok);
+  }
+}
+
+static void fleetReceiveStep(uint32_t now) {
+  if (otaState.cancelRequested) {
+    logOTAEvent("CANCEL", "Fleet update cancelled");
+    fleetEndReceive(false);
+    return;
+  }
+  if (now - otaFleet.lastHeardMs > OTA_FLEET_LOST_MS) {
+    failUpdate(OTA_ERR_NETWORK_ERROR, "Fleet sender lost");
+    fleetEndReceive(false);
+    return;
+  }
+  NAFleetNack nack;
+  if (FleetOtaRx_poll(&otaFleet.rx, now, esp_random(), &nack.base, nack.bits)) {
+    nack.protocolVersion = PROTOCOL_VERSION;
+    nack.type = NA_FLEET_NACK_TYPE;
+    nack.imageId = otaFleet.rx.imageId;
+    fleetBroadcast(&nack, sizeof(nack));
+  }
+}
+
+// ---- Task ----
+
+static void fleetHandle(const OTAFleetFrame *frame, uint32_t now) {
+  OTAFleetRole role = otaFleet.role;
+  if (frame->len == sizeof(NAFleetAnnounce)) {
+    const NAFleetAnnounce *announce = (const NAFleetAnnounce *)frame->data;
+    if (role == OTA_FLEET_RECEIVING && announce->imageId == otaFleet.rx.imageId)
+      otaFleet.lastHeardMs = now;
+    else if (role == OTA_FLEET_IDLE)
+      fleetJoin(announce, now);
+  } else if (frame->len == sizeof(NAFleetChunk)) {
+    if (role == OTA_FLEET_RECEIVING)
+      fleetChunk((const NAFleetChunk *)frame->data, now);
+  } else if (frame->len == sizeof(NAFleetNack)) {
+    const NAFleetNack *nack = (const NAFleetNack *)frame->data;
+    if (role == OTA_FLEET_SENDING &&
+        nack->imageId == NA_Fleet_imageId(otaFleet.image.sha256)) {
+      FleetOtaTx_nack(&otaFleet.tx, nack->base, nack->bits);
+      otaFleet.lastActivityMs = now;
+    } else if (role == OTA_FLEET_RECEIVING) {
+      FleetOtaRx_overhear(&otaFleet.rx, nack->imageId, nack->base, nack->bits, now);
+    }
+  }
+}
+
+static void fleetTaskEntry(void *arg) {
+  EspNowTx_addPeer(fleetBroadcastMac);
+  OTAFleetFrame frame;
+  for (;;) {
+    // Sending never waits on the queue; idle and receiving poll it
+    TickType_t wait = otaFleet.role == OTA_FLEET_SENDING ? 0 : pdMS_TO_TICKS(20);
+    while (xQueueReceive(otaFleet.queue, &frame, wait) == pdTRUE) {
+      fleetHandle(&frame, HAL_GetMillis());
+      wait = 0;
+    }
+    uint32_t now = HAL_GetMillis();
+    if (otaFleet.sendRequested) {
+      otaFleet.sendRequested = false;
+      if (otaFleet.role == OTA_FLEET_IDLE)
+        fleetSendBegin(now);
+    }
+    if (otaFleet.role == OTA_FLEET_SENDING) {
+      fleetSendStep(now);
+      vTaskDelay(1);
+    } else if (otaFleet.role == OTA_FLEET_RECEIVING) {
+      fleetReceiveStep(now);
+    }
+  }
+}
+
+static bool startFleetTask(void) {
+  if (otaFleet.task)
+    return true;
+  if (!otaFleet.queue)
+    otaFleet.queue = xQueueCreate(OTA_FLEET_QUEUE, sizeof(OTAFleetFrame));
+  if (!otaFleet.queue)
+    return false;
+  MemoryProfiler_setTaskStackSize("ota_fleet", OTA_FLEET_STACK);
+  return xTaskCreatePinnedToCore(fleetTaskEntry, "ota_fleet", OTA_FLEET_STACK, NULL,
+                                 SCHED_PRIORITY_OTA, &otaFleet.task,
+                                 SCHED_BACKGROUND_CORE) == pdPASS;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
 /**
  * Initialize OTA manager
  */
@@ -55,173 +1038,401 @@ bool OTAUpdater_init(void) {
 
   // Note: SPIFFS is used for general storage, OTA uses a dedicated partition
   // via Update library
+  OTASignature_initKey(&otaSigningKey);
+  Preferences prefs;
+  uint8_t raw[OTA_SIGNATURE_KEY_SIZE];
+  if (prefs.begin(OTA_CHECKPOINT_NS, true)) {
+    if (prefs.isKey(OTA_SIGNING_KEY) &&
+        prefs.getBytes(OTA_SIGNING_KEY, raw, sizeof(raw)) == sizeof(raw) &&
+        !OTASignature_loadKey(&otaSigningKey, raw))
+      logOTAEvent("ERROR", "Stored signing key invalid");
+    otaFleet.listening = prefs.getBool(OTA_FLEET_KEY, false);
+    if (prefs.getBytesLength(OTA_MANIFEST_KEY) != sizeof(otaManifest) ||
+        prefs.getBytes(OTA_MANIFEST_KEY, &otaManifest, sizeof(otaManifest)) !=
+            sizeof(otaManifest))
+      memset(&otaManifest, 0, sizeof(otaManifest));
+    prefs.end();
+  }
+  loadImageRecord();
+  MemPlacement_note("ota_buf", otaBuffers, sizeof(otaBuffers), MEM_CLASS_BULK);
+  MemPlacement_note("ota_sector", otaSector, sizeof(otaSector), MEM_CLASS_BULK);
+  // Stays set until the next update overwrites the rejected image
+  if (esp_ota_get_last_invalid_partition())
+    logOTAEvent("ROLLBACK", "Last update was rejected, running the previous image");
+  if (otaFleet.listening && !startFleetTask())
+    logOTAEvent("ERROR", "Fleet task create failed");
+
   otaState.initialized = true;
-  logOTAEvent("INIT", "OTA manager ready");
+  logOTAEvent("INIT", otaSigningKey.loaded ? "OTA manager ready (signed images)"
+                                           : "OTA manager ready");
   return true;
 }
 
-/**
- * Start firmware download and update process
- */
-bool OTAUpdater_startDownload(const char *url, const uint8_t *expectedSHA256) {
-  if (!otaState.initialized)
+bool OTAUpdater_setSigningKey(const uint8_t *publicKey) {
+  if (!otaState.initialized || otaState.taskRunning)
     return false;
-  if (!url) {
-    otaState.lastError = OTA_ERR_INVALID_URL;
+
+  OTASignatureKey key;
+  OTASignature_initKey(&key);
+  if (publicKey && !OTASignature_loadKey(&key, publicKey)) {
+    OTASignature_freeKey(&key);
     return false;
   }
 
-  otaState.status = OTA_STATUS_DOWNLOADING;
-  otaState.bytesDownloaded = 0;
-  otaState.progress = 0;
-  otaState.downloadStartTime = millis();
-  otaState.lastError = OTA_ERR_NONE;
-  otaState.totalAttempts++;
-
-  if (expectedSHA256) {
-    memcpy(otaState.expectedSHA256, expectedSHA256, 32);
-  } else {
-    memset(otaState.expectedSHA256, 0, 32); // No verification if NULL
+  Preferences prefs;
+  bool ok = prefs.begin(OTA_CHECKPOINT_NS, false);
+  if (ok) {
+    if (publicKey)
+      ok = prefs.putBytes(OTA_SIGNING_KEY, publicKey, OTA_SIGNATURE_KEY_SIZE) ==
+           OTA_SIGNATURE_KEY_SIZE;
+    else if (prefs.isKey(OTA_SIGNING_KEY))
+      ok = prefs.remove(OTA_SIGNING_KEY);
+    prefs.end();
+  }
+  if (!ok) {
+    OTASignature_freeKey(&key);
+    return false;
   }
 
-  logOTAEvent("START", url);
+  OTASignature_freeKey(&otaSigningKey);
+  otaSigningKey = key; // Moves the mbedtls buffers, key is not freed
+  logOTAEvent("KEY", publicKey ? "Signing key set" : "Signing key cleared");
+  return true;
+}
 
+bool OTAUpdater_hasSigningKey(void) { return otaSigningKey.loaded; }
+
+typedef enum {
+  FETCH_DONE = 0,
+  FETCH_RETRY, // Link dropped, resume from the current offset
+  FETCH_FAILED
+} OTAFetchResult;
+
+/**
+ * One HTTP request, from otaState.bytesDownloaded to the end of the image
+ */
+static OTAFetchResult fetchImage(const char *url) {
+  uint32_t offset = otaState.bytesDownloaded;
   HTTPClient http;
   // For Phase 9, we disable certificate validation for easier development
   // In production, we should provide the root CA
   http.begin(url);
+  if (offset > 0) {
+    char range[24];
+    snprintf(range, sizeof(range), "bytes=%lu-", (unsigned long)offset);
+    http.addHeader("Range", range);
+  }
 
   int httpCode = http.GET();
-  if (httpCode != HTTP_CODE_OK) {
-    logOTAEvent("ERROR", "HTTP GET failed");
-    otaState.status = OTA_STATUS_ERROR;
-    otaState.lastError = OTA_ERR_DOWNLOAD_FAILED;
-    otaState.failedUpdates++;
+  if (httpCode < 0) { // No connection / no response
+    logOTAEvent("RETRY", "HTTP connect failed");
     http.end();
-    return false;
+    return FETCH_RETRY;
   }
-
-  otaState.totalSize = http.getSize();
-  if (otaState.totalSize == 0) {
-    logOTAEvent("ERROR", "Invalid content length");
-    otaState.status = OTA_STATUS_ERROR;
-    otaState.lastError = OTA_ERR_INVALID_FIRMWARE;
+  if (httpCode != (offset > 0 ? HTTP_CODE_PARTIAL_CONTENT : HTTP_CODE_OK)) {
+    failUpdate(OTA_ERR_DOWNLOAD_FAILED,
+               offset > 0 ? "Range request refused" : "HTTP GET failed");
     http.end();
-    return false;
+    return FETCH_FAILED;
   }
 
-  if (!Update.begin(otaState.totalSize)) {
-    logOTAEvent("ERROR", "Update.begin failed");
-    otaState.status = OTA_STATUS_ERROR;
-    otaState.lastError = OTA_ERR_FLASH_ERROR;
+  // A resumed request must be the rest of the same file
+  int size = http.getSize();
+  if (size <= 0 ||
+      (offset > 0 && (uint32_t)size != otaState.totalSize - offset)) {
+    failUpdate(OTA_ERR_INVALID_FIRMWARE, "Invalid content length");
     http.end();
-    return false;
+    return FETCH_FAILED;
+  }
+  if (offset == 0) {
+    portENTER_CRITICAL(&otaMux);
+    otaState.totalSize = (uint32_t)size;
+    portEXIT_CRITICAL(&otaMux);
   }
 
   WiFiClient *stream = http.getStreamPtr();
-  uint8_t buffer[OTA_BUFFER_SIZE];
-
-  mbedtls_sha256_context sha_ctx;
-  mbedtls_sha256_init(&sha_ctx);
-  mbedtls_sha256_starts(&sha_ctx, 0); // 0 = SHA256
+  uint32_t received = offset;
+  OTAFetchResult result = FETCH_DONE;
 
-  uint32_t writtenTotal = 0;
+  uint8_t idx;
+  if (!acquireBuffer(&idx)) {
+    http.end();
+    return FETCH_FAILED;
+  }
+  bool haveBuffer = true;
+  uint16_t fill = 0;
 
-  while (http.connected() && (writtenTotal < otaState.totalSize)) {
-    size_t size = stream->available();
-    if (size > 0) {
-      int c =
-          stream->readBytes(buffer, min((size_t)size, (size_t)OTA_BUFFER_SIZE));
+  while (http.connected() && (received < otaState.totalSize)) {
+    if (otaState.cancelRequested) {
+      logOTAEvent("CANCEL", "Download cancelled");
+      result = FETCH_FAILED;
+      break;
+    }
+    if (otaWriterFailed) { // Error already reported by the writer
+      result = FETCH_FAILED;
+      break;
+    }
 
-      if (Update.write(buffer, c) != (size_t)c) {
-        logOTAEvent("ERROR", "Flash write mismatch");
-        otaState.status = OTA_STATUS_ERROR;
-        otaState.lastError = OTA_ERR_FLASH_ERROR;
-        break;
+    size_t available = stream->available();
+    // Format detection needs the first two bytes together
+    bool canHandOff = fill >= 2 || (fill > 0 && received > fill);
+    if (available == 0 || fill == OTA_BUFFER_SIZE) {
+      // Link idle (or buffer full): pass on what we have
+      if (canHandOff) {
+        handOff(idx, fill);
+        fill = 0;
+        haveBuffer = acquireBuffer(&idx);
+        if (!haveBuffer) {
+          result = FETCH_FAILED;
+          break;
+        }
       }
+      if (available == 0)
+        vTaskDelay(pdMS_TO_TICKS(5)); // Let lower-priority work run
+    } else {
+      int c = stream->readBytes(otaBuffers[idx] + fill,
+                                min(available, (size_t)(OTA_BUFFER_SIZE - fill)));
+      fill += c;
+      received += c;
 
-      mbedtls_sha256_update(&sha_ctx, buffer, c);
-      writtenTotal += c;
-      otaState.bytesDownloaded = writtenTotal;
-      otaState.progress = (uint8_t)((writtenTotal * 100) / otaState.totalSize);
+      portENTER_CRITICAL(&otaMux);
+      otaState.bytesDownloaded = received;
+      otaState.progress = (uint8_t)(((uint64_t)received * 100) / otaState.totalSize);
+      portEXIT_CRITICAL(&otaMux);
+    }
 
-      // Periodically log progress (or handle in loop)
-      if (otaState.progress % 10 == 0) {
-        yield(); // Feed watchdog
-      }
+    if (HAL_GetMillis() - otaState.downloadStartTime > OTA_TIMEOUT_MS) {
+      failUpdate(OTA_ERR_TIMEOUT, "Download timeout");
+      result = FETCH_FAILED;
+      break;
     }
+  }
 
-    if (millis() - otaState.downloadStartTime > OTA_TIMEOUT_MS) {
-      logOTAEvent("ERROR", "Download timeout");
-      otaState.status = OTA_STATUS_ERROR;
-      otaState.lastError = OTA_ERR_TIMEOUT;
+  if (haveBuffer) {
+    if (fill > 0 && result != FETCH_FAILED)
+      handOff(idx, fill);
+    else
+      xQueueSend(otaFreeQueue, &idx, 0);
+  }
+
+  if (result == FETCH_DONE && received < otaState.totalSize) {
+    logOTAEvent("RETRY", "Connection closed");
+    result = FETCH_RETRY;
+  }
+  http.end();
+  return result;
+}
+
+/**
+ * Download, verify and flash (OTA task)
+ * A dropped link resumes with a Range request from the last byte fed
+ * to the pipeline, OTA_MAX_RETRIES times in a row without progress.
+ * @return true if the new image is ready to boot
+ */
+static bool runUpdate(const char *url) {
+  pipeInit();
+  otaCheckpointOffset = 0;
+  uint32_t resumeOffset = loadCheckpoint(url);
+  if (resumeOffset > 0) {
+    char msg[32];
+    snprintf(msg, sizeof(msg), "From byte %lu", (unsigned long)resumeOffset);
+    logOTAEvent("RESUME", msg);
+  } else {
+    // The hash may hold a partial read-back of a rejected checkpoint
+    uint8_t unused[32];
+    pipeFree(unused);
+    pipeInit();
+    clearCheckpoint();
+  }
+
+  bool writerStarted = startWriter();
+  if (!writerStarted) {
+    failUpdate(OTA_ERR_MEMORY_INSUFFICIENT, "Writer task create failed");
+    stopWriter(false);
+    uint8_t unused[32];
+    pipeFree(unused);
+    return false;
+  }
+
+  uint8_t retries = 0;
+  OTAFetchResult result;
+  for (;;) {
+    uint32_t before = otaState.bytesDownloaded;
+    result = fetchImage(url);
+    if (result != FETCH_RETRY)
+      break;
+    if (otaState.bytesDownloaded != before)
+      retries = 0;
+    if (otaState.cancelRequested || ++retries > OTA_MAX_RETRIES) {
+      failUpdate(OTA_ERR_NETWORK_ERROR, "Connection lost");
+      result = FETCH_FAILED;
       break;
     }
+    vTaskDelay(pdMS_TO_TICKS(OTA_RETRY_DELAY_MS));
+  }
+  stopWriter(true);
+
+  uint32_t elapsed = HAL_GetMillis() - otaState.downloadStartTime;
+  otaState.lastStallMs = otaState.stallMs;
+  otaState.lastThroughputBps =
+      elapsed ? (uint32_t)((uint64_t)(otaState.bytesDownloaded - otaState.resumedFrom) *
+                           1000 / elapsed)
+              : 0;
+
+  bool ok = result == FETCH_DONE && !otaWriterFailed;
+  if (ok && !pipeFinish()) {
+    failUpdate(otaPipe.error, otaPipe.errorMsg);
+    ok = false;
   }
 
+  // Hash of the reconstructed image, whatever the download format
   uint8_t calculatedHash[32];
-  mbedtls_sha256_finish(&sha_ctx, calculatedHash);
-  mbedtls_sha256_free(&sha_ctx);
+  pipeFree(calculatedHash);
 
-  if (otaState.status == OTA_STATUS_ERROR) {
-    Update.abort();
-    http.end();
-    otaState.failedUpdates++;
+  if (!ok) {
+    // Keep the resume point only when the link was the problem
+    OTAErrorCode error = otaState.lastError;
+    if (otaState.cancelRequested ||
+        (error != OTA_ERR_NETWORK_ERROR && error != OTA_ERR_TIMEOUT))
+      clearCheckpoint();
     return false;
   }
 
-  otaState.status = OTA_STATUS_VERIFYING;
+  setStatus(OTA_STATUS_VERIFYING);
 
   // Verify SHA256 if expected hash was provided
-  bool hashValid = true;
   bool hasExpectedHash = false;
   for (int i = 0; i < 32; i++)
     if (otaState.expectedSHA256[i] != 0)
       hasExpectedHash = true;
 
   if (hasExpectedHash) {
-    if (!OTAUpdater_verifySHA256(
-            NULL, 0,
-            otaState.expectedSHA256)) { // This is just a placeholder call
-      // Comparison
-      int mismatch = 0;
-      for (int i = 0; i < 32; i++)
-        mismatch |= (calculatedHash[i] ^ otaState.expectedSHA256[i]);
-      if (mismatch != 0)
-        hashValid = false;
+    int mismatch = 0;
+    for (int i = 0; i < 32; i++)
+      mismatch |= (calculatedHash[i] ^ otaState.expectedSHA256[i]);
+    if (mismatch != 0) {
+      failUpdate(OTA_ERR_SIGNATURE_MISMATCH, "SHA256 mismatch");
+      clearCheckpoint();
+      return false;
     }
   }
 
-  if (!hashValid) {
-    logOTAEvent("ERROR", "SHA256 mismatch");
-    otaState.status = OTA_STATUS_ERROR;
-    otaState.lastError = OTA_ERR_SIGNATURE_MISMATCH;
-    Update.abort();
-    http.end();
-    otaState.failedUpdates++;
+  // With a signing key provisioned only signed images are accepted; the
+  // streamed hash is all the check needs
+  if (otaSigningKey.loaded &&
+      (!otaState.hasSignature ||
+       !OTASignature_verify(&otaSigningKey, calculatedHash, otaState.signature))) {
+    failUpdate(OTA_ERR_SIGNATURE_INVALID,
+               otaState.hasSignature ? "Signature invalid" : "Signature required");
+    clearCheckpoint();
     return false;
   }
 
-  otaState.status = OTA_STATUS_FLASHING;
-  if (Update.end(true)) {
-    if (Update.isFinished()) {
-      logOTAEvent("SUCCESS", "OTA update finished");
-      otaState.status = OTA_STATUS_SUCCESS;
-      otaState.successfulUpdates++;
-      otaState.lastUpdateTime = millis();
-      http.end();
-      return true;
-    }
+  setStatus(OTA_STATUS_FLASHING);
+  clearCheckpoint();
+  if (flashEnd()) {
+    logOTAEvent("SUCCESS", "OTA update finished");
+    saveImageRecord(otaFlash.part, otaPipe.imageBytes, calculatedHash,
+                    otaState.hasSignature ? otaState.signature : NULL);
+    portENTER_CRITICAL(&otaMux);
+    otaState.status = OTA_STATUS_SUCCESS;
+    otaState.successfulUpdates++;
+    otaState.lastUpdateTime = HAL_GetMillis();
+    portEXIT_CRITICAL(&otaMux);
+    return true;
   }
 
-  logOTAEvent("ERROR", "Update.end failed");
-  otaState.status = OTA_STATUS_ERROR;
-  otaState.lastError = OTA_ERR_FLASH_ERROR;
-  otaState.failedUpdates++;
-  http.end();
+  failUpdate(otaPipe.error, otaPipe.errorMsg);
   return false;
 }
 
+static void otaTask(void *arg) {
+  runUpdate(otaState.url);
+
+  portENTER_CRITICAL(&otaMux);
+  otaState.taskRunning = false;
+  portEXIT_CRITICAL(&otaMux);
+  vTaskDelete(NULL);
+}
+
+/**
+ * Start firmware download and update process
+ */
+bool OTAUpdater_startDownload(const char *url, const uint8_t *expectedSHA256) {
+  return OTAUpdater_startSignedDownload(url, expectedSHA256, NULL);
+}
+
+bool OTAUpdater_startSignedDownload(const char *url,
+                                    const uint8_t *expectedSHA256,
+                                    const uint8_t *signature) {
+  if (!otaState.initialized)
+    return false;
+  if (!url || url[0] == '\0' || strlen(url) >= OTA_URL_MAX) {
+    otaState.lastError = OTA_ERR_INVALID_URL;
+    return false;
+  }
+
+  portENTER_CRITICAL(&otaMux);
+  bool busy = otaState.taskRunning || otaFleet.role == OTA_FLEET_SENDING;
+  if (!busy) {
+    otaState.taskRunning = true;
+    otaState.cancelRequested = false;
+    otaState.status = OTA_STATUS_DOWNLOADING;
+    otaState.bytesDownloaded = 0;
+    otaState.totalSize = 0;
+    otaState.resumedFrom = 0;
+    otaState.stallMs = 0;
+    otaState.progress = 0;
+    otaState.lastError = OTA_ERR_NONE;
+    otaState.totalAttempts++;
+  }
+  portEXIT_CRITICAL(&otaMux);
+  if (busy) {
+    logOTAEvent("BUSY", "Update already running");
+    return false;
+  }
+
+  otaState.downloadStartTime = HAL_GetMillis();
+  strncpy(otaState.url, url, OTA_URL_MAX);
+  if (expectedSHA256) {
+    memcpy(otaState.expectedSHA256, expectedSHA256, 32);
+  } else {
+    memset(otaState.expectedSHA256, 0, 32); // No verification if NULL
+  }
+  otaState.hasSignature = signature != NULL;
+  if (signature)
+    memcpy(otaState.signature, signature, OTA_SIGNATURE_SIZE);
+
+  logOTAEvent("START", url);
+
+  MemoryProfiler_setTaskStackSize("ota", OTA_TASK_STACK);
+  if (xTaskCreatePinnedToCore(otaTask, "ota", OTA_TASK_STACK, NULL,
+                              SCHED_PRIORITY_OTA, NULL,
+                              SCHED_BACKGROUND_CORE) != pdPASS) {
+    portENTER_CRITICAL(&otaMux);
+    otaState.taskRunning = false;
+    otaState.status = OTA_STATUS_ERROR;
+    otaState.lastError = OTA_ERR_MEMORY_INSUFFICIENT;
+    portEXIT_CRITICAL(&otaMux);
+    logOTAEvent("ERROR", "Task create failed");
+    return false;
+  }
+  return true;
+}
+
+OTAProgress OTAUpdater_getProgressInfo(void) {
+  OTAProgress info;
+  portENTER_CRITICAL(&otaMux);
+  info.status = otaState.status;
+  info.lastError = otaState.lastError;
+  info.progress = otaState.progress;
+  info.bytesDownloaded = otaState.bytesDownloaded;
+  info.totalSize = otaState.totalSize;
+  info.resumedFrom = otaState.resumedFrom;
+  portEXIT_CRITICAL(&otaMux);
+  return info;
+}
+
 uint8_t OTAUpdater_getProgress(void) { return otaState.progress; }
 OTAStatus OTAUpdater_getStatus(void) { return otaState.status; }
 OTAErrorCode OTAUpdater_getLastError(void) { return otaState.lastError; }
@@ -231,12 +1442,16 @@ uint32_t OTAUpdater_getBytesDownloaded(void) {
 uint32_t OTAUpdater_getTotalSize(void) { return otaState.totalSize; }
 
 bool OTAUpdater_cancel(void) {
-  if (otaState.status == OTA_STATUS_DOWNLOADING) {
+  // Flashing can't be interrupted; the task aborts the image otherwise
+  bool cancelled = false;
+  portENTER_CRITICAL(&otaMux);
+  if (otaState.taskRunning && otaState.status == OTA_STATUS_DOWNLOADING) {
+    otaState.cancelRequested = true;
     otaState.status = OTA_STATUS_IDLE;
-    Update.abort();
-    return true;
+    cancelled = true;
   }
-  return false;
+  portEXIT_CRITICAL(&otaMux);
+  return cancelled;
 }
 
 bool OTAUpdater_rollback(void) {
@@ -250,12 +1465,172 @@ bool OTAUpdater_rollback(void) {
   return false;
 }
 
+bool OTAUpdater_isPendingVerify(void) {
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  esp_ota_img_states_t state;
+  return running && esp_ota_get_state_partition(running, &state) == ESP_OK &&
+         state == ESP_OTA_IMG_PENDING_VERIFY;
+}
+
+bool OTAUpdater_confirmImage(void) {
+  if (esp_ota_mark_app_valid_cancel_rollback() != ESP_OK)
+    return false;
+  logOTAEvent("VERIFY", "Image confirmed");
+  return true;
+}
+
+void OTAUpdater_rejectImage(void) {
+  if (!esp_ota_check_rollback_is_possible()) {
+    logOTAEvent("ERROR", "Image failed its check, no previous image to go back to");
+    return;
+  }
+  logOTAEvent("ROLLBACK", "Image failed its check, rebooting into the previous one");
+  Serial.flush();
+  esp_ota_mark_app_invalid_rollback_and_reboot();
+}
+
 const char *OTAUpdater_getCurrentVersion(void) { return "1.1.0-security"; }
-const char *OTAUpdater_getLatestVersion(void) { return "1.1.0-security"; }
+const char *OTAUpdater_getLatestVersion(void) {
+  // Last check that found a newer manifest, else what is running
+  return otaCheck.latest[0] ? otaCheck.latest : OTAUpdater_getCurrentVersion();
+}
+
+/**
+ * Manifest body of a 200 response (Content-Length required, capped)
+ * @return Bytes read, 0 on a bad length or a short read
+ */
+static size_t readManifest(HTTPClient &http, char *body) {
+  int size = http.getSize();
+  if (size <= 0 || size >= OTA_MANIFEST_BODY_MAX)
+    return 0;
+  WiFiClient *stream = http.getStreamPtr();
+  size_t len = 0;
+  uint32_t start = HAL_GetMillis();
+  while (len < (size_t)size && HAL_GetMillis() - start < OTA_CHECK_TIMEOUT_MS) {
+    int avail = stream->available();
+    if (avail <= 0) {
+      if (!http.connected())
+        break;
+      vTaskDelay(pdMS_TO_TICKS(10));
+      continue;
+    }
+    len += stream->readBytes(body + len, min((size_t)avail, (size_t)size - len));
+  }
+  return len == (size_t)size ? len : 0;
+}
+
+static void saveManifestCache(void) {
+  Preferences prefs;
+  if (prefs.begin(OTA_CHECKPOINT_NS, false)) {
+    prefs.putBytes(OTA_MANIFEST_KEY, &otaManifest, sizeof(otaManifest));
+    prefs.end();
+  }
+}
 
 bool OTAUpdater_checkForUpdates(const char *serverUrl) {
-  // Phase 9: Return false (Manual update via URL preferred)
-  return false;
+  if (!serverUrl || serverUrl[0] == '\0' || strlen(serverUrl) >= OTA_URL_MAX)
+    return false;
+  const char *current = OTAUpdater_getCurrentVersion();
+  bool conditional = OTAManifest_cacheMatches(&otaManifest, serverUrl, current);
+
+  HTTPClient http;
+  http.setTimeout(OTA_CHECK_TIMEOUT_MS);
+  http.begin(serverUrl);
+  const char *validators[] = {"ETag", "Last-Modified"};
+  http.collectHeaders(validators, 2);
+  if (conditional && otaManifest.etag[0])
+    http.addHeader("If-None-Match", otaManifest.etag);
+  if (conditional && otaManifest.lastModified[0])
+    http.addHeader("If-Modified-Since", otaManifest.lastModified);
+
+  int httpCode = http.GET();
+  OTAManifestResult result = OTA_MANIFEST_BAD;
+  size_t bodyLen = 0;
+  if (httpCode == HTTP_CODE_NOT_MODIFIED && conditional) {
+    result = (OTAManifestResult)otaManifest.result;
+  } else if (httpCode == HTTP_CODE_OK) {
+    char *body = (char *)MemPlacement_alloc("ota_manifest", OTA_MANIFEST_BODY_MAX,
+                                            MEM_CLASS_BULK);
+    bodyLen = body ? readManifest(http, body) : 0;
+    OTAManifestChoice choice;
+    if (bodyLen > 0) {
+      result = OTAManifest_select(body, bodyLen, serverUrl, current, &choice);
+      // A manifest we could not read is asked for in full next time
+      if (result != OTA_MANIFEST_BAD) {
+        OTAManifest_cacheStore(&otaManifest, serverUrl, current, http.header("ETag").c_str(),
+                               http.header("Last-Modified").c_str(), result, &choice);
+        saveManifestCache();
+      }
+    }
+    MemPlacement_free(body);
+  }
+  http.end();
+
+  bool update = result == OTA_MANIFEST_UPDATE;
+  portENTER_CRITICAL(&otaMux);
+  otaCheck.checks++;
+  otaCheck.httpCode = (int16_t)httpCode;
+  otaCheck.result = (uint8_t)result;
+  otaCheck.manifestBytes += bodyLen;
+  if (httpCode == HTTP_CODE_NOT_MODIFIED)
+    otaCheck.notModified++;
+  otaCheck.latest[0] = '\0';
+  otaCheck.size = update ? otaManifest.choice.size : 0;
+  otaCheck.delta = update && otaManifest.choice.delta;
+  if (update || result == OTA_MANIFEST_NO_IMAGE)
+    memcpy(otaCheck.latest, otaManifest.choice.version, sizeof(otaCheck.latest));
+  portEXIT_CRITICAL(&otaMux);
+  return update;
+}
+
+static void otaCheckTask(void *param) {
+  bool update = OTAUpdater_checkForUpdates(otaCheckUrl);
+  char detail[OTA_MANIFEST_VERSION_MAX + 32];
+  snprintf(detail, sizeof(detail), "%s (HTTP %d)", update ? otaManifest.choice.version : "none",
+           otaCheck.httpCode);
+  logOTAEvent("CHECK", detail);
+  if (update && otaCheckInstall) {
+    const OTAManifestChoice &c = otaManifest.choice;
+    OTAUpdater_startSignedDownload(c.url, c.hasSha256 ? c.sha256 : NULL,
+                                   c.hasSignature ? c.signature : NULL);
+  }
+  portENTER_CRITICAL(&otaMux);
+  otaCheck.running = false;
+  portEXIT_CRITICAL(&otaMux);
+  vTaskDelete(NULL);
+}
+
+bool OTAUpdater_startCheck(const char *manifestUrl, bool install) {
+  if (!otaState.initialized || !manifestUrl || manifestUrl[0] == '\0' ||
+      strlen(manifestUrl) >= OTA_URL_MAX)
+    return false;
+  portENTER_CRITICAL(&otaMux);
+  bool busy = otaCheck.running || otaState.taskRunning;
+  if (!busy)
+    otaCheck.running = true;
+  portEXIT_CRITICAL(&otaMux);
+  if (busy)
+    return false;
+
+  strncpy(otaCheckUrl, manifestUrl, sizeof(otaCheckUrl) - 1);
+  otaCheckUrl[sizeof(otaCheckUrl) - 1] = '\0';
+  otaCheckInstall = install;
+  MemoryProfiler_setTaskStackSize("ota_check", OTA_CHECK_STACK);
+  if (xTaskCreatePinnedToCore(otaCheckTask, "ota_check", OTA_CHECK_STACK, NULL,
+                              SCHED_PRIORITY_OTA, NULL, SCHED_BACKGROUND_CORE) != pdPASS) {
+    portENTER_CRITICAL(&otaMux);
+    otaCheck.running = false;
+    portEXIT_CRITICAL(&otaMux);
+    return false;
+  }
+  return true;
+}
+
+OTACheckInfo OTAUpdater_getCheckInfo(void) {
+  portENTER_CRITICAL(&otaMux);
+  OTACheckInfo info = otaCheck;
+  portEXIT_CRITICAL(&otaMux);
+  return info;
 }
 
 bool OTAUpdater_verifySHA256(const uint8_t *firmwareData, uint32_t dataLen,
@@ -276,7 +1651,9 @@ OTAStats OTAUpdater_getStats(void) {
                     .successfulUpdates = otaState.successfulUpdates,
                     .failedUpdates = otaState.failedUpdates,
                     .rollbacks = otaState.rollbacks,
-                    .lastUpdateTime = otaState.lastUpdateTime};
+                    .lastUpdateTime = otaState.lastUpdateTime,
+                    .throughputBps = otaState.lastThroughputBps,
+                    .stallMs = otaState.lastStallMs};
 }
 
 const char *OTAUpdater_getErrorMessage(void) {
@@ -293,7 +1670,109 @@ const char *OTAUpdater_getErrorMessage(void) {
     return "Flash error";
   case OTA_ERR_TIMEOUT:
     return "Timeout";
+  case OTA_ERR_NETWORK_ERROR:
+    return "Network error";
+  case OTA_ERR_INVALID_FIRMWARE:
+    return "Invalid firmware";
+  case OTA_ERR_CHECKSUM_FAILED:
+    return "Delta source mismatch";
+  case OTA_ERR_MEMORY_INSUFFICIENT:
+    return "Out of memory";
+  case OTA_ERR_SIGNATURE_INVALID:
+    return "Signature invalid";
+  case OTA_ERR_NO_IMAGE:
+    return "No signed image to serve";
   default:
     return "Unknown";
   }
 }
+
+bool OTAUpdater_isBusy(void) {
+  return otaState.taskRunning || otaFleet.role != OTA_FLEET_IDLE;
+}
+
+// ============================================================================
+// Fleet Distribution API
+// ============================================================================
+
+bool OTAUpdater_startFleetSend(void) {
+  if (!otaState.initialized || otaState.taskRunning || otaFleet.role != OTA_FLEET_IDLE)
+    return false;
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  if (!otaInstalledValid || !otaInstalled.hasSignature || !running ||
+      otaInstalled.partition != running->address ||
+      FleetOta_chunkCount(otaInstalled.size) == 0) {
+    otaState.lastError = OTA_ERR_NO_IMAGE;
+    return false;
+  }
+  if (!startFleetTask()) {
+    otaState.lastError = OTA_ERR_MEMORY_INSUFFICIENT;
+    return false;
+  }
+  otaFleet.sendRequested = true; // The task checks the image and starts
+  return true;
+}
+
+void OTAUpdater_stopFleetSend(void) {
+  otaFleet.sendRequested = false;
+  otaFleet.stopRequested = true;
+}
+
+bool OTAUpdater_setFleetListen(bool listen) {
+  if (!otaState.initialized)
+    return false;
+  Preferences prefs;
+  if (!prefs.begin(OTA_CHECKPOINT_NS, false))
+    return false;
+  bool ok = prefs.putBool(OTA_FLEET_KEY, listen) > 0;
+  prefs.end();
+  if (!ok || (listen && !startFleetTask()))
+    return false;
+  otaFleet.listening = listen;
+  return true;
+}
+
+void OTAUpdater_setFleetHold(bool hold) { otaFleet.hold = hold; }
+
+void OTAUpdater_fleetFrame(const uint8_t *data, size_t len) {
+  QueueHandle_t queue = otaFleet.queue;
+  if (!queue || len > sizeof(((OTAFleetFrame *)0)->data) || len < 2 ||
+      data[0] != PROTOCOL_VERSION)
+    return;
+  // Chunks only matter while receiving; announces only to a listener
+  OTAFleetRole role = otaFleet.role;
+  if (len == sizeof(NAFleetChunk) && role != OTA_FLEET_RECEIVING)
+    return;
+  if (len == sizeof(NAFleetAnnounce) && role == OTA_FLEET_IDLE &&
+      (!otaFleet.listening || otaFleet.hold))
+    return;
+  OTAFleetFrame frame;
+  frame.len = (uint8_t)len;
+  memcpy(frame.data, data, len);
+  xQueueSend(queue, &frame, 0); // Full: dropped, repaired by NACK
+}
+
+OTAFleetInfo OTAUpdater_getFleetInfo(void) {
+  OTAFleetInfo info;
+  memset(&info, 0, sizeof(info));
+  info.role = otaFleet.role;
+  info.listening = otaFleet.listening;
+  if (info.role == OTA_FLEET_SENDING) {
+    const FleetOtaTx *tx = &otaFleet.tx;
+    info.imageId = NA_Fleet_imageId(otaFleet.image.sha256);
+    info.chunks = tx->chunkCount;
+    info.pending = tx->pendingCount;
+    info.round = tx->round;
+    info.frames = tx->sent;
+    info.nacks = tx->nacks;
+  } else if (info.role == OTA_FLEET_RECEIVING) {
+    const FleetOtaRx *rx = &otaFleet.rx;
+    info.imageId = rx->imageId;
+    info.chunks = rx->chunkCount;
+    info.pending = rx->chunkCount - rx->received;
+    info.frames = rx->duplicates;
+    info.nacks = rx->nacksSent;
+    info.suppressed = rx->nacksSuppressed;
+  }
+  return info;
+}
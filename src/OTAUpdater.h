@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "OTAManifest.h"
 
 /**
  * OTAUpdater - Over-The-Air Firmware Update Manager
@@ -14,7 +16,53 @@
  * - Progress tracking (0-100%)
  * - Storage in SPIFFS partition
  * - Automatic boot validation (60s timeout)
- * 
+ *
+ * The download runs in its own low-priority task (SCHED_PRIORITY_OTA,
+ * background core), so failsafe, control and telemetry keep running.
+ * A second task (ota_flash, one priority lower) decodes, hashes and
+ * flashes: the two swap a pair of static 4KB buffers, so the socket is
+ * drained into one while the other is being written. Every getter is safe from other tasks and never blocks on
+ * the download.
+ *
+ * Accepted downloads (detected from the first bytes, no flag needed):
+ * - Plain app image
+ * - zlib stream of either of the below, inflated on the fly (the ROM
+ *   miniz inflater, 32KB window allocated only for the update)
+ * - Delta patch against the running partition (OTADelta.h); the patch
+ *   carries the SHA-256 of the image it was made from and is refused
+ *   unless the running partition matches
+ * The expected SHA-256 is always that of the final, rebuilt image.
+ *
+ * Signed images: once a P-256 public key is set (OTAUpdater_setSigningKey,
+ * kept raw in NVS and imported once at init), every update must come
+ * with an ECDSA signature over that same streamed SHA-256 and is
+ * refused before the boot partition switches otherwise (OTASignature.h).
+ *
+ * The image is written straight into the next OTA partition, erasing
+ * each sector just before it is filled. A dropped link resumes with an
+ * HTTP Range request (OTA_MAX_RETRIES in a row without progress). For
+ * plain images a resume point is also kept in NVS every 64KB, so a
+ * start_ota_update with the same URL after a reboot continues from
+ * there; the SHA-256 of the part already written is rebuilt by reading
+ * it back from flash.
+ *
+ * Update checks read a manifest (OTAManifest.h) with conditional GETs,
+ * so a fleet polling an unchanged manifest costs a 304 per vehicle, and
+ * pick the smallest payload: a delta from the running version when the
+ * manifest has one, the full image otherwise.
+ *
+ * Fleet distribution (FleetOta.h, NAFleetOta.h): a vehicle whose running
+ * image came from a signed update can serve it to every vehicle in
+ * range at once over ESP-NOW broadcast (OTAUpdater_startFleetSend).
+ * Vehicles set to listen take an announced image only while parked,
+ * only with a signing key, and only if the announced signature verifies
+ * and the image differs from the one they last installed. Chunks are
+ * written in place as they arrive, in any order (each sector erased on
+ * first touch); gaps are repaired by NACK. The boot partition switches
+ * once the whole image read back from flash matches the signed hash.
+ * Frames pass from the Wi-Fi task to one "ota_fleet" task, created the
+ * first time fleet mode is used.
+ *
  * @file OTAUpdater.h
  */
 
@@ -41,7 +89,9 @@ typedef enum {
     OTA_ERR_INVALID_FIRMWARE = 7,
     OTA_ERR_TIMEOUT = 8,
     OTA_ERR_CHECKSUM_FAILED = 9,
-    OTA_ERR_MEMORY_INSUFFICIENT = 10
+    OTA_ERR_MEMORY_INSUFFICIENT = 10,
+    OTA_ERR_SIGNATURE_INVALID = 11,     // Missing or bad ECDSA signature
+    OTA_ERR_NO_IMAGE = 12               // Fleet send: running image not from a signed update
 } OTAErrorCode;
 
 /**
@@ -51,16 +101,63 @@ typedef enum {
 bool OTAUpdater_init(void);
 
 /**
- * Start firmware download from HTTPS URL
+ * Start firmware download from HTTPS URL (returns immediately)
  * @param url HTTPS firmware download URL
- * @param expectedSHA256 Expected SHA256 hash of firmware (32 bytes)
- * @return true if download started successfully
+ * @param expectedSHA256 Expected SHA256 hash of the final image (32 bytes),
+ *        NULL to skip the check
+ * @return true if the download task was started, false on a bad URL or
+ *         while another update is still running
  */
 bool OTAUpdater_startDownload(
     const char* url,
     const uint8_t* expectedSHA256
 );
 
+/**
+ * Start a download that carries an image signature (returns immediately)
+ * @param url HTTPS firmware download URL
+ * @param expectedSHA256 As for OTAUpdater_startDownload, may be NULL
+ * @param signature ECDSA P-256 r || s (64 bytes) over the final image's
+ *        SHA-256; NULL for unsigned (refused if a signing key is set)
+ * @return true if the download task was started
+ */
+bool OTAUpdater_startSignedDownload(
+    const char* url,
+    const uint8_t* expectedSHA256,
+    const uint8_t* signature
+);
+
+/**
+ * Set the image signing key (stored in NVS)
+ * @param publicKey Raw P-256 point X || Y (64 bytes), NULL to clear and
+ *        accept unsigned images again
+ * @return false on an invalid key, a storage error or while an update runs
+ */
+bool OTAUpdater_setSigningKey(const uint8_t* publicKey);
+
+/**
+ * @return true if only signed images are accepted
+ */
+bool OTAUpdater_hasSigningKey(void);
+
+/**
+ * Consistent snapshot of a running update
+ */
+typedef struct {
+    OTAStatus status;
+    OTAErrorCode lastError;
+    uint8_t progress;
+    uint32_t bytesDownloaded;
+    uint32_t totalSize;
+    uint32_t resumedFrom;   // Offset picked up from a saved resume point, 0 if none
+} OTAProgress;
+
+/**
+ * Read status, error and progress together (short spinlock, no waiting
+ * on the download)
+ */
+OTAProgress OTAUpdater_getProgressInfo(void);
+
 /**
  * Get current OTA progress (0-100%)
  * @return Progress percentage
@@ -99,7 +196,9 @@ uint32_t OTAUpdater_getTotalSize(void);
 
 /**
  * Cancel current OTA operation
- * @return true if cancelled successfully
+ * The task aborts the partial image at its next chunk; status is IDLE
+ * right away.
+ * @return true if a download was cancelled
  */
 bool OTAUpdater_cancel(void);
 
@@ -109,6 +208,25 @@ bool OTAUpdater_cancel(void);
  */
 bool OTAUpdater_rollback(void);
 
+/**
+ * Running image is on trial: first boot after an update, neither marked
+ * valid nor rolled back yet (needs bootloader rollback support)
+ * Works before OTAUpdater_init.
+ */
+bool OTAUpdater_isPendingVerify(void);
+
+/**
+ * Keep the running image (cancels the bootloader's rollback)
+ * @return false if the image could not be marked valid
+ */
+bool OTAUpdater_confirmImage(void);
+
+/**
+ * Mark the running image invalid and reboot into the previous one
+ * Returns only if there is nothing to go back to.
+ */
+void OTAUpdater_rejectImage(void);
+
 /**
  * Get current firmware version string
  * @return Version string (e.g., "1.0.0")
@@ -122,12 +240,40 @@ const char* OTAUpdater_getCurrentVersion(void);
 const char* OTAUpdater_getLatestVersion(void);
 
 /**
- * Check if new firmware is available
- * @param serverUrl URL to check for updates
- * @return true if new firmware available
+ * Check a firmware manifest for a newer image (OTAManifest.h)
+ * Blocks on HTTP: call from a background task (OTAUpdater_startCheck).
+ * The request carries the ETag / Last-Modified of the last manifest from
+ * this URL, so an unchanged manifest is a 304 with no body and the
+ * previous choice stands.
+ * @param serverUrl Manifest URL
+ * @return true if a newer image this vehicle can apply was found
  */
 bool OTAUpdater_checkForUpdates(const char* serverUrl);
 
+/**
+ * Run OTAUpdater_checkForUpdates in the background (returns immediately)
+ * @param install Start the chosen download when an update is found
+ * @return false on a bad URL or while a check or an update runs
+ */
+bool OTAUpdater_startCheck(const char* manifestUrl, bool install);
+
+/**
+ * Manifest checks since boot and the last outcome
+ */
+typedef struct {
+    bool running;
+    uint8_t result;             // OTAManifestResult of the last check
+    int16_t httpCode;           // Last response, < 0 = no connection
+    uint32_t checks;
+    uint32_t notModified;       // Answered 304
+    uint32_t manifestBytes;     // Manifest bodies downloaded
+    char latest[OTA_MANIFEST_VERSION_MAX];  // Version on offer ("" if none)
+    uint32_t size;              // Chosen payload, 0 if not given
+    bool delta;
+} OTACheckInfo;
+
+OTACheckInfo OTAUpdater_getCheckInfo(void);
+
 /**
  * Verify firmware signature
  * @param firmwareData Firmware binary data
@@ -151,8 +297,73 @@ typedef struct {
     uint32_t failedUpdates;
     uint32_t rollbacks;
     uint32_t lastUpdateTime;
+    uint32_t throughputBps;     // Last update: bytes received per second
+    uint32_t stallMs;           // Last update: network reads held up by flash writes
 } OTAStats;
 
 OTAStats OTAUpdater_getStats(void);
 
+/**
+ * @return true while an update is received (any kind) or an image served
+ */
+bool OTAUpdater_isBusy(void);
+
+// ============================================================================
+// Fleet Distribution
+// ============================================================================
+
+typedef enum {
+    OTA_FLEET_IDLE = 0,
+    OTA_FLEET_SENDING = 1,
+    OTA_FLEET_RECEIVING = 2
+} OTAFleetRole;
+
+/**
+ * Fleet state; counters are statistics, read without locking
+ */
+typedef struct {
+    OTAFleetRole role;
+    bool listening;
+    uint32_t imageId;       // First 4 bytes of the image SHA-256
+    uint16_t chunks;        // Image size in chunks
+    uint16_t pending;       // Sender: still to send; receiver: still missing
+    uint16_t round;         // Sender: repair bursts so far
+    uint32_t frames;        // Sender: chunks sent; receiver: duplicates
+    uint32_t nacks;         // Sender: heard; receiver: sent
+    uint32_t suppressed;    // Receiver: NACKs held back for an overheard one
+} OTAFleetInfo;
+
+/**
+ * Serve the running image to the fleet (returns immediately)
+ * Runs until no NACK has been heard for a while or until stopped.
+ * @return false if the running image was not installed by a signed
+ *         update (OTA_ERR_NO_IMAGE) or an update is in progress
+ */
+bool OTAUpdater_startFleetSend(void);
+
+/**
+ * Stop serving (the sender finishes the frame it is on)
+ */
+void OTAUpdater_stopFleetSend(void);
+
+/**
+ * Take fleet images when announced (stored in NVS)
+ * @return false on a storage error or if the fleet task can't start
+ */
+bool OTAUpdater_setFleetListen(bool listen);
+
+/**
+ * Refuse to join a fleet update, e.g. while armed (one that is already
+ * being received carries on)
+ */
+void OTAUpdater_setFleetHold(bool hold);
+
+/**
+ * Hand over a fleet frame (ESP-NOW receive callback; copies and queues,
+ * never blocks)
+ */
+void OTAUpdater_fleetFrame(const uint8_t* data, size_t len);
+
+OTAFleetInfo OTAUpdater_getFleetInfo(void);
+
 #endif // OTA_UPDATER_H
@@ -0,0 +1,185 @@
+#include "OccupancyGrid.h"
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * OccupancyGrid - Implementation
+ *
+ * @file OccupancyGrid.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+#define OCC_GRID_MIN_CELL_M     0.25f
+#define OCC_GRID_MAX_CELL_M     20.0f
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static uint16_t countBits(const uint8_t* bits) {
+    uint16_t n = 0;
+    for (int i = 0; i < OCC_GRID_CELLS / 8; i++) n += __builtin_popcount(bits[i]);
+    return n;
+}
+
+// ============================================================================
+// Map
+// ============================================================================
+
+void OccupancyGrid_init(OccupancyGrid* grid) {
+    memset(grid, 0, sizeof(*grid));
+    grid->map.cellM = OCC_GRID_DEFAULT_CELL_M;
+}
+
+void OccupancyGrid_anchor(OccupancyGrid* grid, int32_t latE7, int32_t lngE7, float cellM) {
+    OccupancyGrid_init(grid);
+    grid->map.originLat = latE7;
+    grid->map.originLng = lngE7;
+    grid->map.cellM = clampf(cellM, OCC_GRID_MIN_CELL_M, OCC_GRID_MAX_CELL_M);
+    NavFrame_init(&grid->frame, latE7, lngE7);
+    grid->anchored = true;
+}
+
+bool OccupancyGrid_load(OccupancyGrid* grid, const OccupancyGridRecord* record) {
+    OccupancyGrid_init(grid);
+    if (!(record->cellM >= OCC_GRID_MIN_CELL_M && record->cellM <= OCC_GRID_MAX_CELL_M) ||
+        record->originLat < -900000000L || record->originLat > 900000000L)
+        return false;
+    grid->map = *record;
+    NavFrame_init(&grid->frame, record->originLat, record->originLng);
+    grid->anchored = true;
+    grid->blocked = countBits(grid->map.bits);
+    return true;
+}
+
+void OccupancyGrid_clear(OccupancyGrid* grid) {
+    memset(grid->map.bits, 0, sizeof(grid->map.bits));
+    grid->blocked = 0;
+}
+
+bool OccupancyGrid_cellOf(const OccupancyGrid* grid, NavVector point, int* row, int* col) {
+    float y = point.north / grid->map.cellM + OCC_GRID_DIM / 2;
+    float x = point.east / grid->map.cellM + OCC_GRID_DIM / 2;
+    if (!(y >= 0.0f && y < OCC_GRID_DIM && x >= 0.0f && x < OCC_GRID_DIM)) return false;
+    *row = (int)y;
+    *col = (int)x;
+    return true;
+}
+
+NavVector OccupancyGrid_cellCenter(const OccupancyGrid* grid, int row, int col) {
+    NavVector p;
+    p.north = (row - OCC_GRID_DIM / 2 + 0.5f) * grid->map.cellM;
+    p.east = (col - OCC_GRID_DIM / 2 + 0.5f) * grid->map.cellM;
+    return p;
+}
+
+void OccupancyGrid_set(OccupancyGrid* grid, int row, int col, bool blocked) {
+    if ((unsigned)row >= OCC_GRID_DIM || (unsigned)col >= OCC_GRID_DIM) return;
+    int i = row * OCC_GRID_DIM + col;
+    uint8_t mask = 1u << (i & 7);
+    bool was = grid->map.bits[i >> 3] & mask;
+    if (was == blocked) return;
+    grid->map.bits[i >> 3] ^= mask;
+    grid->blocked += blocked ? 1 : -1;
+}
+
+int OccupancyGrid_fillPolygon(OccupancyGrid* grid, const NavVector* vertices, uint8_t count,
+                              bool blocked) {
+    if (!grid->anchored || count < 3 || count > OCC_GRID_MAX_POLYGON) return -1;
+    uint16_t before = grid->blocked;
+    for (int row = 0; row < OCC_GRID_DIM; row++) {
+        for (int col = 0; col < OCC_GRID_DIM; col++) {
+            // Even-odd test on the cell centre
+            NavVector c = OccupancyGrid_cellCenter(grid, row, col);
+            bool inside = false;
+            for (uint8_t i = 0, j = count - 1; i < count; j = i++) {
+                const NavVector& a = vertices[i];
+                const NavVector& b = vertices[j];
+                if ((a.north > c.north) != (b.north > c.north) &&
+                    c.east < a.east + (c.north - a.north) * (b.east - a.east) / (b.north - a.north))
+                    inside = !inside;
+            }
+            if (inside) OccupancyGrid_set(grid, row, col, blocked);
+        }
+    }
+    return blocked ? grid->blocked - before : before - grid->blocked;
+}
+
+void OccupancyGrid_getRow(const OccupancyGrid* grid, int row, uint8_t* bytes) {
+    memcpy(bytes, &grid->map.bits[row * OCC_GRID_ROW_BYTES], OCC_GRID_ROW_BYTES);
+}
+
+bool OccupancyGrid_setRow(OccupancyGrid* grid, int row, const uint8_t* bytes) {
+    if (!grid->anchored || (unsigned)row >= OCC_GRID_DIM) return false;
+    memcpy(&grid->map.bits[row * OCC_GRID_ROW_BYTES], bytes, OCC_GRID_ROW_BYTES);
+    grid->blocked = countBits(grid->map.bits);
+    return true;
+}
+
+// ============================================================================
+// Line of sight
+// ============================================================================
+
+// Clip the segment p0 + t (p1 - p0), t in [t0, t1], to lo <= p <= hi on
+// one axis (Liang-Barsky)
+static bool clipAxis(float p0, float d, float lo, float hi, float* t0, float* t1) {
+    if (fabsf(d) < 1e-9f) return p0 >= lo && p0 <= hi;
+    float a = (lo - p0) / d, b = (hi - p0) / d;
+    if (a > b) { float t = a; a = b; b = t; }
+    if (a > *t0) *t0 = a;
+    if (b < *t1) *t1 = b;
+    return *t0 <= *t1;
+}
+
+bool OccupancyGrid_segmentClear(const OccupancyGrid* grid, NavVector from, NavVector to) {
+    if (grid->blocked == 0) return true;
+
+    // Grid units: x = column, y = row, clipped to the square (outside is free)
+    float x0 = from.east / grid->map.cellM + OCC_GRID_DIM / 2;
+    float y0 = from.north / grid->map.cellM + OCC_GRID_DIM / 2;
+    float dx = to.east / grid->map.cellM + OCC_GRID_DIM / 2 - x0;
+    float dy = to.north / grid->map.cellM + OCC_GRID_DIM / 2 - y0;
+    float t0 = 0.0f, t1 = 1.0f;
+    if (!clipAxis(x0, dx, 0.0f, OCC_GRID_DIM, &t0, &t1) ||
+        !clipAxis(y0, dy, 0.0f, OCC_GRID_DIM, &t0, &t1))
+        return true;
+    float xa = x0 + t0 * dx, ya = y0 + t0 * dy;
+    float xb = x0 + t1 * dx, yb = y0 + t1 * dy;
+
+    // Cell walk (Amanatides & Woo); a corner hit checks both side cells
+    int col = (int)xa, row = (int)ya;
+    int colEnd = (int)xb, rowEnd = (int)yb;
+    if (col >= OCC_GRID_DIM) col = OCC_GRID_DIM - 1;
+    if (row >= OCC_GRID_DIM) row = OCC_GRID_DIM - 1;
+    if (colEnd >= OCC_GRID_DIM) colEnd = OCC_GRID_DIM - 1;
+    if (rowEnd >= OCC_GRID_DIM) rowEnd = OCC_GRID_DIM - 1;
+    int stepX = dx > 0.0f ? 1 : -1, stepY = dy > 0.0f ? 1 : -1;
+    float ex = xb - xa, ey = yb - ya;
+    float tDeltaX = fabsf(ex) > 1e-9f ? fabsf(1.0f / ex) : 1e30f;
+    float tDeltaY = fabsf(ey) > 1e-9f ? fabsf(1.0f / ey) : 1e30f;
+    float tMaxX = fabsf(ex) > 1e-9f ? (stepX > 0 ? col + 1 - xa : xa - col) * tDeltaX : 1e30f;
+    float tMaxY = fabsf(ey) > 1e-9f ? (stepY > 0 ? row + 1 - ya : ya - row) * tDeltaY : 1e30f;
+
+    for (int n = 2 * OCC_GRID_DIM + 2; n > 0; n--) {
+        if (OccupancyGrid_isBlocked(grid, row, col)) return false;
+        if ((row == rowEnd && col == colEnd) || (tMaxX > 1.0f && tMaxY > 1.0f)) return true;
+        if (fabsf(tMaxX - tMaxY) < 1e-6f) {
+            if (OccupancyGrid_isBlocked(grid, row, col + stepX) ||
+                OccupancyGrid_isBlocked(grid, row + stepY, col))
+                return false;
+            col += stepX;
+            row += stepY;
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+        } else if (tMaxX < tMaxY) {
+            col += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            row += stepY;
+            tMaxY += tDeltaY;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,123 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NavFrame.h"
+
+/**
+ * OccupancyGrid - Bit-packed no-go map anchored at home
+ *
+ * A square of OCC_GRID_DIM x OCC_GRID_DIM cells centred on its own
+ * origin (home when the map was started), one bit per cell (1 =
+ * blocked), row-major with row 0 to the south and column 0 to the west:
+ *
+ *   cell (row, col) covers north [(row - DIM/2) cell, (row - DIM/2 + 1) cell)
+ *                          east  [(col - DIM/2) cell, (col - DIM/2 + 1) cell)
+ *
+ * The map keeps its own NavFrame, so it stays put when home moves. At
+ * the default 64 x 64 cells of 2 m it spans 128 m and holds 512 bytes,
+ * small enough to keep in one NVS blob and to send a row per message.
+ * Anything outside the square counts as free.
+ *
+ * Plain struct, no hardware.
+ *
+ * @file OccupancyGrid.h
+ */
+
+#ifndef OCC_GRID_DIM
+#define OCC_GRID_DIM            64      // Cells per side, multiple of 8
+#endif
+#define OCC_GRID_CELLS          (OCC_GRID_DIM * OCC_GRID_DIM)
+#define OCC_GRID_ROW_BYTES      (OCC_GRID_DIM / 8)
+#define OCC_GRID_NVS_KEY        "occ_grid"
+#define OCC_GRID_DEFAULT_CELL_M 2.0f
+#define OCC_GRID_MAX_POLYGON    32
+
+typedef struct {
+    int32_t originLat;          // deg * 1e7, centre of the square
+    int32_t originLng;
+    float cellM;                // Cell side, meters
+    uint8_t bits[OCC_GRID_CELLS / 8];
+} OccupancyGridRecord;          // NVS format
+
+typedef struct {
+    OccupancyGridRecord map;
+    NavFrame frame;             // Around map.originLat / originLng
+    bool anchored;              // Has an origin (false = empty, all free)
+    uint16_t blocked;           // Cells set
+} OccupancyGrid;
+
+/**
+ * Empty, unanchored map (everything free)
+ */
+void OccupancyGrid_init(OccupancyGrid* grid);
+
+/**
+ * Start a clear map around a point
+ * @param cellM Cell side, clamped to 0.25 .. 20 m
+ */
+void OccupancyGrid_anchor(OccupancyGrid* grid, int32_t latE7, int32_t lngE7, float cellM);
+
+/**
+ * Take a stored map; false (and left empty) if it does not validate
+ */
+bool OccupancyGrid_load(OccupancyGrid* grid, const OccupancyGridRecord* record);
+
+/**
+ * Free every cell (origin kept)
+ */
+void OccupancyGrid_clear(OccupancyGrid* grid);
+
+/**
+ * Cell holding a point in the map's frame
+ * @return false outside the square
+ */
+bool OccupancyGrid_cellOf(const OccupancyGrid* grid, NavVector point, int* row, int* col);
+
+/**
+ * Centre of a cell in the map's frame
+ */
+NavVector OccupancyGrid_cellCenter(const OccupancyGrid* grid, int row, int col);
+
+/**
+ * Point in deg * 1e7 into the map's frame
+ */
+static inline NavVector OccupancyGrid_toLocal(const OccupancyGrid* grid, int32_t latE7, int32_t lngE7) {
+    return NavFrame_toLocal(&grid->frame, latE7, lngE7);
+}
+
+/**
+ * Blocked? Cells outside the square are free
+ */
+static inline bool OccupancyGrid_isBlocked(const OccupancyGrid* grid, int row, int col) {
+    if ((unsigned)row >= OCC_GRID_DIM || (unsigned)col >= OCC_GRID_DIM) return false;
+    int i = row * OCC_GRID_DIM + col;
+    return (grid->map.bits[i >> 3] >> (i & 7)) & 1;
+}
+
+void OccupancyGrid_set(OccupancyGrid* grid, int row, int col, bool blocked);
+
+/**
+ * Mark every cell whose centre is inside a polygon
+ * @param vertices In the map's frame, either winding
+ * @param count 3 to OCC_GRID_MAX_POLYGON
+ * @return Cells changed, -1 on a bad polygon or an unanchored map
+ */
+int OccupancyGrid_fillPolygon(OccupancyGrid* grid, const NavVector* vertices, uint8_t count,
+                              bool blocked);
+
+/**
+ * One row as OCC_GRID_ROW_BYTES bytes (bit 0 of byte 0 = column 0)
+ */
+void OccupancyGrid_getRow(const OccupancyGrid* grid, int row, uint8_t* bytes);
+bool OccupancyGrid_setRow(OccupancyGrid* grid, int row, const uint8_t* bytes);
+
+/**
+ * Does the straight segment between two points stay off blocked cells?
+ * Visits every cell the segment touches (supercover), including both
+ * ends.
+ */
+bool OccupancyGrid_segmentClear(const OccupancyGrid* grid, NavVector from, NavVector to);
+
+#endif // OCCUPANCY_GRID_H
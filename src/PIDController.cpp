@@ -0,0 +1,92 @@
+#include "PIDController.h"
+#include <string.h>
+
+/**
+ * PIDController - Implementation
+ *
+ * @file PIDController.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static float clampf(float v, float limit) {
+    return v > limit ? limit : (v < -limit ? -limit : v);
+}
+
+/**
+ * Shared step once the unfiltered D contribution is known
+ */
+static float step(const PIDGains* gains, PIDState* state, float setpoint, float measured,
+                  float dRaw, float dt, bool integrate) {
+    float error = setpoint - measured;
+    state->prevMeasured = measured;
+    state->prevSetpoint = setpoint;
+    state->prevError = error;
+    state->primed = true;
+
+    // D low-pass: alpha = dt / (RC + dt)
+    if (gains->dCutoffHz > 0.0f && dt > 0.0f) {
+        float rc = 1.0f / (6.2831853f * gains->dCutoffHz);
+        state->dTerm += (dRaw - state->dTerm) * (dt / (rc + dt));
+    } else {
+        state->dTerm = dRaw;
+    }
+
+    float pff = gains->kp * error + gains->kff * setpoint;
+    float out = pff + state->integral + state->dTerm;
+
+    // Conditional integration: hold while saturated in the error's direction
+    bool saturated = (out >= gains->outLimit && error > 0.0f) ||
+                     (out <= -gains->outLimit && error < 0.0f);
+    if (integrate && !saturated) {
+        state->integral = clampf(state->integral + gains->ki * error * dt, gains->iLimit);
+        out = pff + state->integral + state->dTerm;
+    }
+
+    return clampf(out, gains->outLimit);
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+float PID_update(const PIDGains* gains, PIDState* state, float setpoint, float measured,
+                 float dt, bool integrate) {
+    // D on measurement
+    float dRaw = 0.0f;
+    if (state->primed && dt > 0.0f) {
+        dRaw = -gains->kd * (measured - state->prevMeasured) / dt;
+    }
+    return step(gains, state, setpoint, measured, dRaw, dt, integrate);
+}
+
+float PID_updateRate(const PIDGains* gains, PIDState* state, float setpoint, float measured,
+                     float measuredRate, float dt, bool integrate) {
+    return step(gains, state, setpoint, measured, -gains->kd * measuredRate, dt, integrate);
+}
+
+void PID_reset(PIDState* state) {
+    memset(state, 0, sizeof(*state));
+}
+
+void PID_setGains(PIDGains* gains, PIDState* state, const PIDGains* next) {
+    if (state->primed) {
+        float before = gains->kp * state->prevError + gains->kff * state->prevSetpoint;
+        float after = next->kp * state->prevError + next->kff * state->prevSetpoint;
+        state->integral = clampf(state->integral + before - after, next->iLimit);
+    }
+    *gains = *next;
+}
+
+void PID_transfer(const PIDGains* gains, PIDState* state, float setpoint, float measured,
+                  float output) {
+    float error = setpoint - measured;
+    state->prevMeasured = measured;
+    state->prevSetpoint = setpoint;
+    state->prevError = error;
+    state->primed = true;
+    state->dTerm = 0.0f;
+    state->integral = clampf(output - gains->kp * error - gains->kff * setpoint, gains->iLimit);
+}
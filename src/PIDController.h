@@ -0,0 +1,96 @@
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * PIDController - Shared PID step (depth hold, navigation, rate loops)
+ *
+ *   out = kff * sp + kp * e + integral + D
+ *
+ * - D acts on the measurement (no kick on setpoint steps), through a
+ *   first-order low-pass at dCutoffHz
+ * - Anti-windup: the integral is clamped to +-iLimit and stops growing
+ *   while the output is saturated in the direction of the error
+ * - The integral is kept in output units, so changing ki never steps the
+ *   output; PID_setGains() also carries the P / FF change over into the
+ *   integral (bumpless retune)
+ * - dt is the caller's fixed loop period (the scheduler's, not a
+ *   measured millis() difference)
+ *
+ * State is a plain struct, no allocation.
+ *
+ * @file PIDController.h
+ */
+
+/**
+ * Gains and limits
+ */
+typedef struct {
+    float kp;
+    float ki;               // 1/s
+    float kd;               // s
+    float kff;              // Setpoint feed-forward
+    float dCutoffHz;        // D-term low-pass, 0 = unfiltered
+    float iLimit;           // |integral| limit, output units
+    float outLimit;         // |output| limit
+} PIDGains;
+
+/**
+ * Runtime state
+ */
+typedef struct {
+    float integral;
+    float dTerm;            // Filtered D contribution
+    float prevMeasured;
+    float prevSetpoint;
+    float prevError;
+    bool primed;            // prevMeasured is valid
+} PIDState;
+
+/**
+ * One controller step
+ * @param setpoint Target
+ * @param measured Process value
+ * @param dt Loop period, s
+ * @param integrate false to hold the integrator
+ * @return Output, clamped to +-outLimit
+ */
+float PID_update(const PIDGains* gains, PIDState* state, float setpoint, float measured,
+                 float dt, bool integrate);
+
+/**
+ * One controller step with the process rate supplied by the caller
+ *
+ * For a measurement whose derivative is estimated elsewhere (a state
+ * estimator): D = -kd * measuredRate, through the same low-pass,
+ * instead of differencing successive measurements.
+ * @param measuredRate d(measured)/dt
+ */
+float PID_updateRate(const PIDGains* gains, PIDState* state, float setpoint, float measured,
+                     float measuredRate, float dt, bool integrate);
+
+/**
+ * Zero integrator and D history
+ */
+void PID_reset(PIDState* state);
+
+/**
+ * Replace gains without a step in the output
+ *
+ * The integral absorbs the change in the proportional and feed-forward
+ * terms at the last error / setpoint (clamped to the new iLimit).
+ */
+void PID_setGains(PIDGains* gains, PIDState* state, const PIDGains* next);
+
+/**
+ * Take over from another controller (or manual) at its output
+ *
+ * Presets the integral so the next step continues from `output`
+ * instead of jumping to the PID's own value.
+ */
+void PID_transfer(const PIDGains* gains, PIDState* state, float setpoint, float measured,
+                  float output);
+
+#endif // PID_CONTROLLER_H
@@ -0,0 +1,172 @@
+#include "PathPlanner.h"
+#include <string.h>
+
+/**
+ * PathPlanner - Implementation
+ *
+ * @file PathPlanner.cpp
+ */
+
+#define COST_STRAIGHT   10
+#define COST_DIAGONAL   14
+#define G_UNSEEN        0xFFFF
+#define NO_PARENT       0xFF
+
+// Moves: E, N, W, S, then NE, NW, SW, SE (diagonals from 4)
+static const int8_t MOVE_ROW[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+static const int8_t MOVE_COL[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+
+static uint16_t octile(int row, int col, int goalRow, int goalCol) {
+    int dr = row > goalRow ? row - goalRow : goalRow - row;
+    int dc = col > goalCol ? col - goalCol : goalCol - col;
+    int lo = dr < dc ? dr : dc;
+    int hi = dr < dc ? dc : dr;
+    return (uint16_t)(COST_DIAGONAL * lo + COST_STRAIGHT * (hi - lo));
+}
+
+// ============================================================================
+// Open list (binary min-heap on key)
+// ============================================================================
+
+static bool push(PathPlanner* p, uint32_t key, uint16_t cell) {
+    if (p->openCount >= PLANNER_OPEN_MAX) return false;
+    uint16_t i = p->openCount++;
+    while (i > 0) {
+        uint16_t up = (i - 1) / 2;
+        if (p->open[up].key <= key) break;
+        p->open[i] = p->open[up];
+        i = up;
+    }
+    p->open[i].key = key;
+    p->open[i].cell = cell;
+    if (p->openCount > p->openPeak) p->openPeak = p->openCount;
+    return true;
+}
+
+static PlannerNode pop(PathPlanner* p) {
+    PlannerNode top = p->open[0];
+    PlannerNode last = p->open[--p->openCount];
+    uint16_t i = 0;
+    for (;;) {
+        uint16_t child = 2 * i + 1;
+        if (child >= p->openCount) break;
+        if (child + 1 < p->openCount && p->open[child + 1].key < p->open[child].key) child++;
+        if (last.key <= p->open[child].key) break;
+        p->open[i] = p->open[child];
+        i = child;
+    }
+    if (p->openCount > 0) p->open[i] = last;
+    return top;
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+static PlanResult search(PathPlanner* p, const OccupancyGrid* grid, int startRow, int startCol,
+                         int goalRow, int goalCol) {
+    memset(p->g, 0xFF, sizeof(p->g));
+    memset(p->closed, 0, sizeof(p->closed));
+    p->openCount = 0;
+    p->openPeak = 0;
+    p->expanded = 0;
+
+    uint16_t start = startRow * OCC_GRID_DIM + startCol;
+    uint16_t goal = goalRow * OCC_GRID_DIM + goalCol;
+    uint16_t h = octile(startRow, startCol, goalRow, goalCol);
+    p->g[start] = 0;
+    p->parent[start] = NO_PARENT;
+    push(p, (uint32_t)h << 12 | (h < 4095 ? h : 4095), start);
+
+    while (p->openCount > 0) {
+        PlannerNode node = pop(p);
+        uint16_t cell = node.cell;
+        if (p->closed[cell >> 3] & (1u << (cell & 7))) continue;      // Stale entry
+        p->closed[cell >> 3] |= 1u << (cell & 7);
+        if (cell == goal) return PLAN_OK;
+        p->expanded++;
+
+        int row = cell / OCC_GRID_DIM, col = cell % OCC_GRID_DIM;
+        for (uint8_t m = 0; m < 8; m++) {
+            int r = row + MOVE_ROW[m], c = col + MOVE_COL[m];
+            if ((unsigned)r >= OCC_GRID_DIM || (unsigned)c >= OCC_GRID_DIM) continue;
+            if (OccupancyGrid_isBlocked(grid, r, c)) continue;
+            if (m >= 4 && (OccupancyGrid_isBlocked(grid, row, c) ||
+                           OccupancyGrid_isBlocked(grid, r, col)))
+                continue;                                   // Would clip a corner
+            uint16_t next = r * OCC_GRID_DIM + c;
+            if (p->closed[next >> 3] & (1u << (next & 7))) continue;
+            uint32_t g = p->g[cell] + (m >= 4 ? COST_DIAGONAL : COST_STRAIGHT);
+            if (g >= p->g[next]) continue;
+            p->g[next] = (uint16_t)g;
+            p->parent[next] = m;
+            uint16_t hn = octile(r, c, goalRow, goalCol);
+            if (!push(p, (g + hn) << 12 | (hn < 4095 ? hn : 4095), next)) return PLAN_OPEN_FULL;
+        }
+    }
+    return PLAN_NO_PATH;
+}
+
+// ============================================================================
+// Plan
+// ============================================================================
+
+PlanResult PathPlanner_plan(PathPlanner* planner, const OccupancyGrid* grid, NavVector start,
+                            NavVector goal, NavVector points[PLANNER_MAX_POINTS], uint8_t* count) {
+    *count = 0;
+    if (!grid->anchored || OccupancyGrid_segmentClear(grid, start, goal)) return PLAN_DIRECT;
+
+    int startRow, startCol, goalRow, goalCol;
+    if (!OccupancyGrid_cellOf(grid, start, &startRow, &startCol) ||
+        !OccupancyGrid_cellOf(grid, goal, &goalRow, &goalCol))
+        return PLAN_OUTSIDE;
+    if (OccupancyGrid_isBlocked(grid, startRow, startCol)) return PLAN_START_BLOCKED;
+    if (OccupancyGrid_isBlocked(grid, goalRow, goalCol)) return PLAN_GOAL_BLOCKED;
+
+    PlanResult result = search(planner, grid, startRow, startCol, goalRow, goalCol);
+    if (result != PLAN_OK) return result;
+
+    // Pull the path tight, from the goal back: keep the last cell the
+    // current anchor can see each time the next one is hidden
+    NavVector anchor = goal;
+    NavVector visible = goal;
+    uint8_t n = 0;
+    uint16_t cell = goalRow * OCC_GRID_DIM + goalCol;
+    while (planner->parent[cell] != NO_PARENT) {
+        uint8_t m = planner->parent[cell];
+        int row = cell / OCC_GRID_DIM - MOVE_ROW[m];
+        int col = cell % OCC_GRID_DIM - MOVE_COL[m];
+        cell = row * OCC_GRID_DIM + col;
+        NavVector p = planner->parent[cell] == NO_PARENT ? start
+                                                         : OccupancyGrid_cellCenter(grid, row, col);
+        if (!OccupancyGrid_segmentClear(grid, anchor, p)) {
+            if (n >= PLANNER_MAX_POINTS) return PLAN_TOO_MANY_POINTS;
+            points[n++] = visible;
+            anchor = visible;
+        }
+        visible = p;
+    }
+
+    // Collected goal to start: flip into flying order
+    for (uint8_t i = 0; i < n / 2; i++) {
+        NavVector t = points[i];
+        points[i] = points[n - 1 - i];
+        points[n - 1 - i] = t;
+    }
+    *count = n;
+    return PLAN_OK;
+}
+
+const char* PathPlanner_resultName(PlanResult result) {
+    switch (result) {
+    case PLAN_DIRECT: return "direct";
+    case PLAN_OK: return "ok";
+    case PLAN_OUTSIDE: return "outside";
+    case PLAN_START_BLOCKED: return "start_blocked";
+    case PLAN_GOAL_BLOCKED: return "goal_blocked";
+    case PLAN_NO_PATH: return "no_path";
+    case PLAN_OPEN_FULL: return "open_full";
+    case PLAN_TOO_MANY_POINTS: return "too_many_points";
+    }
+    return "?";
+}
@@ -0,0 +1,77 @@
+#ifndef PATH_PLANNER_H
+#define PATH_PLANNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "OccupancyGrid.h"
+
+/**
+ * PathPlanner - A* around the no-go cells of an OccupancyGrid
+ *
+ * 8-connected A* with octile costs (10 straight, 14 diagonal) and the
+ * octile distance as heuristic, so the path is the shortest the grid
+ * allows. Diagonal moves may not cut the corner of a blocked cell.
+ * Everything lives in the planner struct, no heap:
+ *
+ *   g cost    uint16 per cell     8 KB at 64 x 64
+ *   parent    move per cell       4 KB
+ *   closed    one bit per cell    0.5 KB
+ *   open      binary heap of PLANNER_OPEN_MAX entries (lazy: a cheaper
+ *             route to a cell pushes it again, the stale entry is
+ *             skipped when popped), 4 KB
+ *
+ * The cell path is then pulled tight: walking it back from the goal,
+ * a turn point is kept only where the straight line from the last one
+ * would cross a blocked cell (OccupancyGrid_segmentClear), so a detour
+ * around one obstacle is usually one or two points. A whole 64 x 64
+ * search is a few milliseconds on the ESP32.
+ *
+ * @file PathPlanner.h
+ */
+
+#ifndef PLANNER_OPEN_MAX
+#define PLANNER_OPEN_MAX        512
+#endif
+#define PLANNER_MAX_POINTS      16      // Turn points per planned leg
+
+typedef enum {
+    PLAN_DIRECT = 0,            // Straight line is clear, no points
+    PLAN_OK = 1,                // Detour found
+    PLAN_OUTSIDE = 2,           // Start or goal off the map with the line blocked
+    PLAN_START_BLOCKED = 3,
+    PLAN_GOAL_BLOCKED = 4,
+    PLAN_NO_PATH = 5,
+    PLAN_OPEN_FULL = 6,         // Search outgrew PLANNER_OPEN_MAX
+    PLAN_TOO_MANY_POINTS = 7    // Path needs more than PLANNER_MAX_POINTS
+} PlanResult;
+
+typedef struct {
+    uint32_t key;               // f << 12 | h (ties go to the cell nearer the goal)
+    uint16_t cell;
+} PlannerNode;
+
+typedef struct {
+    uint16_t g[OCC_GRID_CELLS];
+    uint8_t parent[OCC_GRID_CELLS];         // Move that reached the cell
+    uint8_t closed[OCC_GRID_CELLS / 8];
+    PlannerNode open[PLANNER_OPEN_MAX];
+    uint16_t openCount;
+    uint16_t openPeak;          // Last search
+    uint16_t expanded;
+} PathPlanner;
+
+/**
+ * Route between two points of the grid's frame
+ * @param points Turn points between start and goal (neither included)
+ * @param count Points written
+ * @return PLAN_DIRECT / PLAN_OK on success
+ */
+PlanResult PathPlanner_plan(PathPlanner* planner, const OccupancyGrid* grid, NavVector start,
+                            NavVector goal, NavVector points[PLANNER_MAX_POINTS], uint8_t* count);
+
+/**
+ * Short name for a result ("ok", "no_path", ...)
+ */
+const char* PathPlanner_resultName(PlanResult result);
+
+#endif // PATH_PLANNER_H
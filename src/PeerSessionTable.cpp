@@ -0,0 +1,161 @@
+#include "PeerSessionTable.h"
+#include <string.h>
+
+/**
+ * PeerSessionTable - Implementation
+ *
+ * Slots never move, so a slot index stays valid as a key set index for as
+ * long as the MAC holds it. The hash index is rebuilt on removal (a
+ * handful of entries, rare) instead of using tombstones.
+ *
+ * @file PeerSessionTable.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint32_t hash_mac(const uint8_t* mac) {
+    uint32_t h = 2166136261u;           // FNV-1a
+    for (int i = 0; i < PEER_SESSION_MAC_SIZE; i++) {
+        h ^= mac[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void index_insert(PeerSessionTable* table, int slot) {
+    uint32_t start = hash_mac(table->peers[slot].mac);
+    for (uint32_t i = 0; i < PEER_SESSION_INDEX_SIZE; i++) {
+        int8_t* e = &table->index[(start + i) & (PEER_SESSION_INDEX_SIZE - 1)];
+        if (*e == PEER_SESSION_NONE) {
+            *e = (int8_t)slot;
+            return;
+        }
+    }
+}
+
+static void index_rebuild(PeerSessionTable* table) {
+    memset(table->index, PEER_SESSION_NONE, sizeof(table->index));
+    for (int i = 0; i < PEER_SESSION_MAX; i++) {
+        if (table->peers[i].used)
+            index_insert(table, i);
+    }
+}
+
+static void clear_slot(PeerSession* peer) {
+    SessionKeys_wipe(&peer->keys);
+    memset(peer, 0, sizeof(*peer));
+    ReplayWindow_init(&peer->replay);
+}
+
+// LRU slot a newcomer may take over, or NONE
+static int pick_victim(const PeerSessionTable* table, bool forKeys) {
+    int victim = PEER_SESSION_NONE;
+    for (int i = 0; i < PEER_SESSION_MAX; i++) {
+        const PeerSession* p = &table->peers[i];
+        if (p->pinned || (p->keyed && !forKeys))
+            continue;
+        // Keyless slots go first, then the oldest
+        if (victim == PEER_SESSION_NONE ||
+            (table->peers[victim].keyed && !p->keyed) ||
+            (table->peers[victim].keyed == p->keyed &&
+             (int32_t)(p->lastUsed - table->peers[victim].lastUsed) < 0))
+            victim = i;
+    }
+    return victim;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+void PeerSessionTable_init(PeerSessionTable* table) {
+    memset(table, 0, sizeof(*table));
+    for (int i = 0; i < PEER_SESSION_MAX; i++)
+        clear_slot(&table->peers[i]);
+    memset(table->index, PEER_SESSION_NONE, sizeof(table->index));
+}
+
+int PeerSessionTable_find(const PeerSessionTable* table, const uint8_t* mac) {
+    uint32_t start = hash_mac(mac);
+    for (uint32_t i = 0; i < PEER_SESSION_INDEX_SIZE; i++) {
+        int8_t slot = table->index[(start + i) & (PEER_SESSION_INDEX_SIZE - 1)];
+        if (slot == PEER_SESSION_NONE)
+            return PEER_SESSION_NONE;
+        if (memcmp(table->peers[slot].mac, mac, PEER_SESSION_MAC_SIZE) == 0)
+            return slot;
+    }
+    return PEER_SESSION_NONE;
+}
+
+int PeerSessionTable_acquire(PeerSessionTable* table, const uint8_t* mac, bool forKeys,
+                             uint8_t* evicted, bool* didEvict) {
+    if (didEvict)
+        *didEvict = false;
+    int slot = PeerSessionTable_find(table, mac);
+    if (slot != PEER_SESSION_NONE) {
+        PeerSessionTable_touch(table, slot);
+        return slot;
+    }
+
+    for (int i = 0; i < PEER_SESSION_MAX && slot == PEER_SESSION_NONE; i++) {
+        if (!table->peers[i].used)
+            slot = i;
+    }
+    if (slot == PEER_SESSION_NONE) {
+        slot = pick_victim(table, forKeys);
+        if (slot == PEER_SESSION_NONE) {
+            table->rejected++;
+            return PEER_SESSION_NONE;
+        }
+        if (evicted)
+            memcpy(evicted, table->peers[slot].mac, PEER_SESSION_MAC_SIZE);
+        if (didEvict)
+            *didEvict = true;
+        table->evictions++;
+        clear_slot(&table->peers[slot]);
+        index_rebuild(table);
+    }
+
+    PeerSession* peer = &table->peers[slot];
+    memcpy(peer->mac, mac, PEER_SESSION_MAC_SIZE);
+    peer->used = true;
+    index_insert(table, slot);
+    PeerSessionTable_touch(table, slot);
+    return slot;
+}
+
+void PeerSessionTable_touch(PeerSessionTable* table, int slot) {
+    if (slot >= 0 && slot < PEER_SESSION_MAX)
+        table->peers[slot].lastUsed = ++table->clock;
+}
+
+void PeerSessionTable_setPinned(PeerSessionTable* table, int slot, bool pinned) {
+    if (slot >= 0 && slot < PEER_SESSION_MAX && table->peers[slot].used)
+        table->peers[slot].pinned = pinned;
+}
+
+void PeerSessionTable_remove(PeerSessionTable* table, int slot) {
+    if (slot < 0 || slot >= PEER_SESSION_MAX || !table->peers[slot].used)
+        return;
+    clear_slot(&table->peers[slot]);
+    index_rebuild(table);
+}
+
+void PeerSessionTable_clearKeys(PeerSessionTable* table) {
+    for (int i = 0; i < PEER_SESSION_MAX; i++) {
+        PeerSession* p = &table->peers[i];
+        SessionKeys_wipe(&p->keys);
+        p->keyed = false;
+        p->linkCipher = false;
+        ReplayWindow_init(&p->replay);
+    }
+}
+
+uint8_t PeerSessionTable_count(const PeerSessionTable* table) {
+    uint8_t n = 0;
+    for (int i = 0; i < PEER_SESSION_MAX; i++)
+        n += table->peers[i].used;
+    return n;
+}
@@ -0,0 +1,105 @@
+#ifndef PEER_SESSION_TABLE_H
+#define PEER_SESSION_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ReplayWindow.h"
+#include "SessionKeys.h"
+
+/**
+ * PeerSessionTable - Per-sender radio session state, keyed by MAC
+ *
+ * One ground station plus a relay or a follower vehicle each get their
+ * own session: a handshake from one peer installs keys for that peer only
+ * instead of replacing the link keys of everyone (and making the others
+ * re-handshake in turn). Each slot holds:
+ *   - the sequence window (ReplayWindow)
+ *   - the session keys, ratcheted per peer (SessionKeys)
+ * and its index is the key set of that peer in EncryptionManager /
+ * HMACValidator, where the expanded AES / GCM / HMAC key schedules live.
+ * Rate buckets are already per peer (RateLimitManager).
+ *
+ * Lookup hashes the MAC into an open-addressed index (O(1) in the receive
+ * callback). Capacity is fixed; when full, the least recently used
+ * unpinned slot is taken over. A sender without keys may only displace
+ * another keyless slot, so unknown or spoofed MACs can never evict an
+ * established session. The paired controller is pinned.
+ *
+ * Pure: no globals, no RTOS. Callers serialize access to one table.
+ *
+ * @file PeerSessionTable.h
+ */
+
+#define PEER_SESSION_MAX        4       // Controller + relay / follower + spares
+#define PEER_SESSION_INDEX_SIZE 16      // Hash index slots (power of two, >= 2x MAX)
+#define PEER_SESSION_MAC_SIZE   6
+#define PEER_SESSION_NONE       -1
+
+typedef struct {
+    uint8_t mac[PEER_SESSION_MAC_SIZE];
+    bool used;
+    bool pinned;            // Never evicted (paired controller)
+    bool keyed;             // Own keys installed (handshake), else the link keys
+    bool linkCipher;        // ESP-NOW CCMP key installed in the driver for this MAC
+    uint32_t lastUsed;      // LRU stamp (table clock)
+    uint32_t installs;      // Key installs for this MAC since it got the slot
+    ReplayWindow replay;
+    SessionKeys keys;       // keys.valid: HKDF session that ratchets
+} PeerSession;
+
+typedef struct {
+    PeerSession peers[PEER_SESSION_MAX];
+    int8_t index[PEER_SESSION_INDEX_SIZE];  // Slot per hash bucket, NONE = empty
+    uint32_t clock;
+    uint32_t evictions;
+    uint32_t rejected;      // acquire() found nothing it may take over
+} PeerSessionTable;
+
+/**
+ * Empty the table
+ */
+void PeerSessionTable_init(PeerSessionTable* table);
+
+/**
+ * Slot of a MAC
+ * @return Slot index or PEER_SESSION_NONE
+ */
+int PeerSessionTable_find(const PeerSessionTable* table, const uint8_t* mac);
+
+/**
+ * Find or create the slot of a MAC and mark it used
+ * @param forKeys The slot will receive keys (may evict a keyed slot)
+ * @param evicted Output: MAC of the session taken over (set if returned
+ *        true there), may be NULL
+ * @param didEvict Output: whether a session was taken over, may be NULL
+ * @return Slot index or PEER_SESSION_NONE (full of pinned / keyed slots)
+ */
+int PeerSessionTable_acquire(PeerSessionTable* table, const uint8_t* mac, bool forKeys,
+                             uint8_t* evicted, bool* didEvict);
+
+/**
+ * Mark a slot as just used (LRU)
+ */
+void PeerSessionTable_touch(PeerSessionTable* table, int slot);
+
+/**
+ * Pin or unpin a slot
+ */
+void PeerSessionTable_setPinned(PeerSessionTable* table, int slot, bool pinned);
+
+/**
+ * Drop a slot (keys wiped)
+ */
+void PeerSessionTable_remove(PeerSessionTable* table, int slot);
+
+/**
+ * Wipe the keys of every slot and restart their windows (link keys changed)
+ */
+void PeerSessionTable_clearKeys(PeerSessionTable* table);
+
+/**
+ * Number of slots in use
+ */
+uint8_t PeerSessionTable_count(const PeerSessionTable* table);
+
+#endif // PEER_SESSION_TABLE_H
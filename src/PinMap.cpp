@@ -0,0 +1,138 @@
+#include "PinMap.h"
+#include "RcInput.h"
+#include "Rangefinder.h"
+#include <stddef.h>
+
+/**
+ * PinMap - Implementation
+ *
+ * @file PinMap.cpp
+ */
+
+// ============================================================================
+// Board Tables (ESP32 DevKit V1 / ESP32-S3 DevKitC-1, see docs/hardware.md)
+// ============================================================================
+
+#if PINMAP_TARGET_S3
+// GPIO 22-25 do not exist; 26-32 drive the SPI flash / PSRAM, 19-20 USB
+static bool gpio_exists(int pin) {
+    return pin >= 0 && pin < PINMAP_GPIO_COUNT && !(pin >= 22 && pin <= 25);
+}
+
+static bool gpio_drivable(int pin) {
+    return !(pin >= 26 && pin <= 32) && pin != 19 && pin != 20;
+}
+#else
+// GPIO 20, 24 and 28-31 are not bonded out; 6-11 drive the SPI flash,
+// 34-39 are input only
+static bool gpio_exists(int pin) {
+    return pin >= 0 && pin < PINMAP_GPIO_COUNT && pin != 20 && pin != 24 &&
+           !(pin >= 28 && pin <= 31);
+}
+
+static bool gpio_drivable(int pin) {
+    return pin < 34 && !(pin >= 6 && pin <= 11);
+}
+#endif
+
+static const struct {
+    int8_t pin;
+    const char* owner;
+} RESERVED[] = {
+#if PINMAP_TARGET_S3
+    {43, "uart0"}, {44, "uart0"},       // USB serial (commands, telemetry)
+#else
+    {1, "uart0"}, {3, "uart0"},         // USB serial (commands, telemetry)
+#endif
+    {2, "led"},   {4, "button"},
+    {5, "imu"},                         // MPU-6050 data ready
+    {16, "gps"},  {17, "gps"},          // GPS_RX_PIN / GPS_TX_PIN
+    {21, "i2c"},  {22, "i2c"},
+#if RC_INPUT_PIN >= 0
+    {RC_INPUT_PIN, "rc"},               // Receiver on UART1
+#endif
+#if RC_TELEMETRY_PIN >= 0
+    {RC_TELEMETRY_PIN, "rc"},           // CRSF telemetry to the receiver
+#endif
+#if RANGE_TRIG_PIN >= 0
+    {RANGE_TRIG_PIN, "range"},          // Rangefinder trigger / echo
+#endif
+#if RANGE_ECHO_PIN >= 0
+    {RANGE_ECHO_PIN, "range"},
+#endif
+};
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+bool PinMap_isOutput(int pin) {
+    return gpio_exists(pin) && gpio_drivable(pin);
+}
+
+const char* PinMap_reservedBy(int pin) {
+    for (size_t i = 0; i < sizeof(RESERVED) / sizeof(RESERVED[0]); i++) {
+        if (RESERVED[i].pin == pin) return RESERVED[i].owner;
+    }
+    return NULL;
+}
+
+bool PinMap_pwmFits(uint32_t frequency, uint8_t resolution) {
+    if (resolution > PINMAP_MAX_RESOLUTION) return false;
+    if (frequency == 0 || resolution == 0) return true;
+    return (uint64_t)frequency << resolution <= PINMAP_LEDC_CLOCK_HZ;
+}
+
+uint8_t PinMap_pwmMaxResolution(uint32_t frequency) {
+    if (frequency == 0) return 0;
+    uint32_t steps = PINMAP_LEDC_CLOCK_HZ / frequency;
+    uint8_t bits = 0;
+    while (bits < PINMAP_MAX_RESOLUTION && (steps >> (bits + 1))) bits++;
+    return bits;
+}
+
+uint32_t PinMap_dutyFromQ15(uint16_t q15, uint8_t resolution) {
+    if (q15 > PINMAP_Q15_ONE) q15 = PINMAP_Q15_ONE;
+    if (resolution > PINMAP_MAX_RESOLUTION) resolution = PINMAP_MAX_RESOLUTION;
+    return (uint32_t)(((uint64_t)q15 << resolution) + PINMAP_Q15_ONE / 2) >> 15;
+}
+
+PinMapError PinMap_validate(const PinMapProfile* profile, uint8_t* badOutput, int8_t* badPin) {
+    *badOutput = 0;
+    *badPin = -1;
+    if (profile->count > PINMAP_MAX_OUTPUTS) return PINMAP_BAD_COUNT;
+
+    bool used[PINMAP_GPIO_COUNT] = {false};
+    for (uint8_t i = 0; i < profile->count; i++) {
+        const PinMapOutput* out = &profile->outputs[i];
+        *badOutput = i;
+        if (out->pin < 0) continue;     // Not fitted
+
+        const int8_t pins[3] = {out->pin, out->dir1, out->dir2};
+        for (int p = 0; p < 3; p++) {
+            int8_t pin = pins[p];
+            if (pin < 0 && p > 0) continue;
+            *badPin = pin;
+            if (!PinMap_isOutput(pin)) return PINMAP_NOT_OUTPUT;
+            if (PinMap_reservedBy(pin)) return PINMAP_RESERVED;
+            if (used[pin]) return PINMAP_DUPLICATE;
+            used[pin] = true;
+        }
+        *badPin = -1;
+        if (!PinMap_pwmFits(out->frequency, out->resolution)) return PINMAP_BAD_PWM;
+    }
+    *badOutput = 0;
+    return PINMAP_OK;
+}
+
+const char* PinMap_errorName(PinMapError err) {
+    switch (err) {
+    case PINMAP_OK: return "ok";
+    case PINMAP_NOT_OUTPUT: return "not_output";
+    case PINMAP_RESERVED: return "reserved";
+    case PINMAP_DUPLICATE: return "duplicate";
+    case PINMAP_BAD_PWM: return "bad_pwm";
+    case PINMAP_BAD_COUNT: return "bad_count";
+    }
+    return "?";
+}
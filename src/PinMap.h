@@ -0,0 +1,121 @@
+#ifndef PIN_MAP_H
+#define PIN_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * PinMap - Vehicle output pins and PWM settings, checked against the board
+ *
+ * A profile lists the vehicle's outputs in its own order (e.g. Copter
+ * FR, FL, BL, BR). Each output has a PWM / signal pin, optional H-bridge
+ * direction pins, and a PWM frequency / resolution (0 = driver default).
+ * LEDC channels are not part of the profile: the HAL registry assigns
+ * them from frequency and resolution.
+ *
+ * PinMap_validate() rejects, for any pin of any output:
+ * - GPIO that cannot drive an output (34-39 input only, 6-11 SPI flash,
+ *   numbers the ESP32 does not have; on the S3 26-32 flash / PSRAM and
+ *   19-20 USB)
+ * - pins owned by the board (UART0, status LED, button, IMU INT, GPS
+ *   UART, I2C, RC receiver when RC_INPUT_PIN is set)
+ * - a pin used twice in the profile
+ * and PWM settings the LEDC cannot produce (freq * 2^bits > 80 MHz).
+ *
+ * Duty is in timer ticks, 0 .. 2^bits; 2^bits holds the output high for
+ * the whole period. Callers that do not care about the resolution use
+ * Q15 (PINMAP_Q15_ONE = 100 %) and let PinMap_dutyFromQ15 scale it.
+ *
+ * @file PinMap.h
+ */
+
+#if defined(ESP_PLATFORM)
+#include <sdkconfig.h>
+#endif
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define PINMAP_TARGET_S3        1
+#else
+#define PINMAP_TARGET_S3        0
+#endif
+
+#define PINMAP_MAX_OUTPUTS      9              // Sub: 8 thrusters + trim servo
+#define PINMAP_LEGACY_OUTPUTS   4              // Profiles saved before the Sub went to 8
+#if PINMAP_TARGET_S3
+#define PINMAP_GPIO_COUNT       49
+#else
+#define PINMAP_GPIO_COUNT       40
+#endif
+#define PINMAP_LEDC_CLOCK_HZ    80000000UL     // APB clock
+#define PINMAP_MAX_RESOLUTION   16             // HAL_PWMAllocate limit
+#define PINMAP_Q15_ONE          32768          // 100 % duty in Q15
+
+typedef enum {
+    PINMAP_OK = 0,
+    PINMAP_NOT_OUTPUT,      // Input-only, flash or missing GPIO
+    PINMAP_RESERVED,        // Owned by the board (see PinMap_reservedBy)
+    PINMAP_DUPLICATE,       // Same pin twice in the profile
+    PINMAP_BAD_PWM,         // Frequency / resolution out of LEDC range
+    PINMAP_BAD_COUNT        // Wrong number of outputs for the vehicle
+} PinMapError;
+
+/**
+ * One vehicle output
+ */
+typedef struct {
+    int8_t pin;             // PWM / signal pin, -1 = output not fitted
+    int8_t dir1;            // Direction pins, -1 = none (ESC / servo)
+    int8_t dir2;
+    uint8_t resolution;     // Duty bits, 0 = driver default
+    uint32_t frequency;     // Hz, 0 = driver default
+} PinMapOutput;
+
+/**
+ * All outputs of a vehicle (NVS format, see ConfigManager)
+ */
+typedef struct {
+    uint8_t count;
+    PinMapOutput outputs[PINMAP_MAX_OUTPUTS];
+} PinMapProfile;
+
+/**
+ * @return true if the GPIO exists and can drive an output
+ */
+bool PinMap_isOutput(int pin);
+
+/**
+ * @return Board function owning the pin ("gps", "i2c", ...), NULL if free
+ */
+const char* PinMap_reservedBy(int pin);
+
+/**
+ * @return true if the LEDC can run this frequency at this resolution
+ *         (0 = driver default, always accepted)
+ */
+bool PinMap_pwmFits(uint32_t frequency, uint8_t resolution);
+
+/**
+ * Finest resolution the LEDC can run at a frequency
+ * @return floor(log2(80 MHz / frequency)) capped at PINMAP_MAX_RESOLUTION,
+ *         0 if not even 1 bit fits (or frequency is 0)
+ */
+uint8_t PinMap_pwmMaxResolution(uint32_t frequency);
+
+/**
+ * Q15 duty (0 .. PINMAP_Q15_ONE, larger clamps) in ticks of a resolution,
+ * rounded to nearest
+ */
+uint32_t PinMap_dutyFromQ15(uint16_t q15, uint8_t resolution);
+
+/**
+ * Check a whole profile
+ * @param badOutput Set to the first offending output index
+ * @param badPin Set to the offending pin (-1 for PWM / count errors)
+ */
+PinMapError PinMap_validate(const PinMapProfile* profile, uint8_t* badOutput, int8_t* badPin);
+
+/**
+ * Short name of an error ("reserved", ...)
+ */
+const char* PinMap_errorName(PinMapError err);
+
+#endif // PIN_MAP_H
@@ -0,0 +1,274 @@
+#include "PositionEstimator.h"
+#include "DspKernels.h"
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+FAST_MATH_FLOAT_ONLY
+
+/**
+ * PositionEstimator - Implementation
+ *
+ * Every measurement observes exactly one state (H is a unit row), so a
+ * scalar update is S = P[i][i] + R, K = P[:, i] / S and a rank-one
+ * covariance downdate.
+ *
+ * @file PositionEstimator.cpp
+ */
+
+#define POS_EST_PI              3.14159265f
+#define POS_EST_DEG_TO_RAD      (POS_EST_PI / 180.0f)
+#define POS_EST_UNKNOWN_VAR     1.0e4f  // Variance of a state nothing has observed yet
+#define POS_EST_RESET_REJECTS   10      // Rejected GPS fixes in a row before a reset
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static float wrap_pi(float a) {
+    while (a > POS_EST_PI) a -= 2.0f * POS_EST_PI;
+    while (a < -POS_EST_PI) a += 2.0f * POS_EST_PI;
+    return a;
+}
+
+static float sigma_or(float sigma, float fallback, float floor) {
+    if (sigma <= 0.0f) sigma = fallback;
+    return sigma < floor ? floor : sigma;
+}
+
+static float pos_floor(const PositionGPSInput* gps) {
+    return gps->rtkFixed ? POS_EST_RTK_MIN_POS_SIGMA : POS_EST_MIN_POS_SIGMA;
+}
+
+/**
+ * Fuse a direct measurement of one state
+ * @return false if gated out
+ */
+static bool fuse(PositionEstimator* est, int i, float innovation, float variance) {
+    float s = est->P[i][i] + variance;
+    if (innovation * innovation > POS_EST_GATE * POS_EST_GATE * s) {
+        est->rejected++;
+        return false;
+    }
+
+    float k[POS_EST_STATES];
+    float row[POS_EST_STATES];
+    for (int j = 0; j < POS_EST_STATES; j++) {
+        k[j] = est->P[j][i] / s;
+        row[j] = est->P[i][j];
+    }
+    for (int j = 0; j < POS_EST_STATES; j++) {
+        est->x[j] += k[j] * innovation;
+        for (int m = 0; m < POS_EST_STATES; m++) {
+            est->P[j][m] -= k[j] * row[m];
+        }
+    }
+    est->x[POS_EST_PSI] = wrap_pi(est->x[POS_EST_PSI]);
+    est->updates++;
+    return true;
+}
+
+/**
+ * Start over from one GPS solution
+ */
+static void reset_to(PositionEstimator* est, const PositionGPSInput* gps, float hSigma, float sSigma) {
+    float psi = est->x[POS_EST_PSI];
+    float psiVar = est->P[POS_EST_PSI][POS_EST_PSI];
+
+    memset(est->x, 0, sizeof(est->x));
+    memset(est->P, 0, sizeof(est->P));
+    est->x[POS_EST_PE] = gps->position.east;
+    est->x[POS_EST_PN] = gps->position.north;
+    est->x[POS_EST_VE] = gps->velE;
+    est->x[POS_EST_VN] = gps->velN;
+    est->P[POS_EST_PE][POS_EST_PE] = hSigma * hSigma;
+    est->P[POS_EST_PN][POS_EST_PN] = hSigma * hSigma;
+    est->P[POS_EST_VE][POS_EST_VE] = sSigma * sSigma;
+    est->P[POS_EST_VN][POS_EST_VN] = sSigma * sSigma;
+    if (gps->vAcc > 0.0f) {
+        float vSigma = sigma_or(gps->vAcc, POS_EST_DEFAULT_POS_SIGMA, pos_floor(gps));
+        est->x[POS_EST_PU] = gps->up;
+        est->x[POS_EST_VU] = gps->velU;
+        est->P[POS_EST_PU][POS_EST_PU] = vSigma * vSigma;
+        est->P[POS_EST_VU][POS_EST_VU] = sSigma * sSigma;
+    } else {
+        est->P[POS_EST_PU][POS_EST_PU] = POS_EST_UNKNOWN_VAR;
+        est->P[POS_EST_VU][POS_EST_VU] = POS_EST_UNKNOWN_VAR;
+    }
+
+    // The heading offset does not depend on the position
+    est->x[POS_EST_PSI] = psi;
+    est->P[POS_EST_PSI][POS_EST_PSI] = est->headingAligned ? psiVar : POS_EST_PI * POS_EST_PI;
+    est->initialized = true;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void PositionEstimator_init(PositionEstimator* est) {
+    memset(est, 0, sizeof(*est));
+    est->P[POS_EST_PSI][POS_EST_PSI] = POS_EST_PI * POS_EST_PI;
+}
+
+void PositionEstimator_resetPosition(PositionEstimator* est) {
+    est->initialized = false;
+    est->gpsRejectStreak = 0;
+}
+
+void PositionEstimator_predict(PositionEstimator* est, const float accel[3], float dt) {
+    if (!est->initialized || dt <= 0.0f) return;
+    if (dt > POS_EST_MAX_DT) dt = POS_EST_MAX_DT;
+
+    // Acceleration in ENU (unused until the heading offset is known)
+    float aE = 0.0f, aN = 0.0f, aU = 0.0f;
+    if (est->headingAligned) {
+        float s, c;
+        FastMath_sinCos(est->x[POS_EST_PSI], &s, &c);
+        aE = accel[0] * s - accel[1] * c;
+        aN = accel[0] * c + accel[1] * s;
+        aU = accel[2];
+    }
+
+    float* x = est->x;
+    float half = 0.5f * dt * dt;
+    x[POS_EST_PE] += x[POS_EST_VE] * dt + aE * half;
+    x[POS_EST_PN] += x[POS_EST_VN] * dt + aN * half;
+    x[POS_EST_PU] += x[POS_EST_VU] * dt + aU * half;
+    x[POS_EST_VE] += aE * dt;
+    x[POS_EST_VN] += aN * dt;
+    x[POS_EST_VU] += aU * dt;
+
+    // Jacobian: identity plus velocity -> position and heading -> accel
+    alignas(DSP_ALIGN) float F[POS_EST_STATES][POS_EST_STATES];
+    memset(F, 0, sizeof(F));
+    for (int i = 0; i < POS_EST_STATES; i++) F[i][i] = 1.0f;
+    F[POS_EST_PE][POS_EST_VE] = dt;
+    F[POS_EST_PN][POS_EST_VN] = dt;
+    F[POS_EST_PU][POS_EST_VU] = dt;
+    F[POS_EST_PE][POS_EST_PSI] = aN * half;     // d(aE)/d(psi) = aN
+    F[POS_EST_PN][POS_EST_PSI] = -aE * half;    // d(aN)/d(psi) = -aE
+    F[POS_EST_VE][POS_EST_PSI] = aN * dt;
+    F[POS_EST_VN][POS_EST_PSI] = -aE * dt;
+
+    // P = F P F^T
+    alignas(DSP_ALIGN) float Ft[POS_EST_STATES][POS_EST_STATES];
+    alignas(DSP_ALIGN) float FP[POS_EST_STATES][POS_EST_STATES];
+    for (int i = 0; i < POS_EST_STATES; i++) {
+        for (int j = 0; j < POS_EST_STATES; j++) Ft[j][i] = F[i][j];
+    }
+    Dsp_matMul(&F[0][0], &est->P[0][0], &FP[0][0], POS_EST_STATES, POS_EST_STATES, POS_EST_STATES);
+    Dsp_matMul(&FP[0][0], &Ft[0][0], &est->P[0][0], POS_EST_STATES, POS_EST_STATES, POS_EST_STATES);
+
+    // Q: white acceleration noise per axis, random-walk heading offset
+    float qa = POS_EST_ACCEL_NOISE * POS_EST_ACCEL_NOISE;
+    for (int axis = 0; axis < 3; axis++) {
+        int p = POS_EST_PE + axis;
+        int v = POS_EST_VE + axis;
+        est->P[p][p] += qa * half * half;
+        est->P[p][v] += qa * half * dt;
+        est->P[v][p] += qa * half * dt;
+        est->P[v][v] += qa * dt * dt;
+    }
+    if (est->headingAligned) {
+        float drift = POS_EST_HEADING_DRIFT * POS_EST_DEG_TO_RAD;
+        est->P[POS_EST_PSI][POS_EST_PSI] += drift * drift * dt;
+    }
+    est->predictions++;
+}
+
+uint8_t PositionEstimator_updateGPS(PositionEstimator* est, const PositionGPSInput* gps) {
+    float hSigma = sigma_or(gps->hAcc, POS_EST_DEFAULT_POS_SIGMA, pos_floor(gps));
+    float sSigma = sigma_or(gps->sAcc, POS_EST_DEFAULT_VEL_SIGMA, POS_EST_MIN_VEL_SIGMA);
+
+    if (!est->initialized) {
+        reset_to(est, gps, hSigma, sSigma);
+        return gps->vAcc > 0.0f ? 6 : 4;
+    }
+
+    uint8_t accepted = 0;
+    float hVar = hSigma * hSigma;
+    float sVar = sSigma * sSigma;
+    bool east = fuse(est, POS_EST_PE, gps->position.east - est->x[POS_EST_PE], hVar);
+    bool north = fuse(est, POS_EST_PN, gps->position.north - est->x[POS_EST_PN], hVar);
+    accepted += east + north;
+    accepted += fuse(est, POS_EST_VE, gps->velE - est->x[POS_EST_VE], sVar);
+    accepted += fuse(est, POS_EST_VN, gps->velN - est->x[POS_EST_VN], sVar);
+    if (gps->vAcc > 0.0f) {
+        float vSigma = sigma_or(gps->vAcc, POS_EST_DEFAULT_POS_SIGMA, pos_floor(gps));
+        accepted += fuse(est, POS_EST_PU, gps->up - est->x[POS_EST_PU], vSigma * vSigma);
+        accepted += fuse(est, POS_EST_VU, gps->velU - est->x[POS_EST_VU], sVar);
+    }
+
+    // A diverged filter gates out every fix: start over from GPS
+    if (east && north) {
+        est->gpsRejectStreak = 0;
+    } else if (++est->gpsRejectStreak >= POS_EST_RESET_REJECTS) {
+        est->gpsRejectStreak = 0;
+        reset_to(est, gps, hSigma, sSigma);
+    }
+    return accepted;
+}
+
+bool PositionEstimator_updateHeading(PositionEstimator* est, float gyroHeadingDeg,
+                                     float courseDeg, float sigmaDeg) {
+    float offset = wrap_pi((courseDeg - gyroHeadingDeg) * POS_EST_DEG_TO_RAD);
+    float sigma = sigmaDeg * POS_EST_DEG_TO_RAD;
+
+    if (!est->headingAligned) {
+        // First course: take it as is, no cross-correlation yet
+        for (int i = 0; i < POS_EST_STATES; i++) {
+            est->P[i][POS_EST_PSI] = 0.0f;
+            est->P[POS_EST_PSI][i] = 0.0f;
+        }
+        est->x[POS_EST_PSI] = offset;
+        est->P[POS_EST_PSI][POS_EST_PSI] = sigma * sigma;
+        est->headingAligned = true;
+        return true;
+    }
+    return fuse(est, POS_EST_PSI, wrap_pi(offset - est->x[POS_EST_PSI]), sigma * sigma);
+}
+
+uint8_t PositionEstimator_updateVelocity(PositionEstimator* est, float velE, float velN,
+                                         float sigma) {
+    if (!est->initialized) return 0;
+    float var = sigma_or(sigma, POS_EST_DEFAULT_VEL_SIGMA, POS_EST_MIN_VEL_SIGMA);
+    var *= var;
+    uint8_t accepted = 0;
+    if (fuse(est, POS_EST_VE, velE - est->x[POS_EST_VE], var)) accepted++;
+    if (fuse(est, POS_EST_VN, velN - est->x[POS_EST_VN], var)) accepted++;
+    return accepted;
+}
+
+bool PositionEstimator_updateHeight(PositionEstimator* est, float up, float sigma) {
+    if (!est->initialized) return false;
+    if (est->P[POS_EST_PU][POS_EST_PU] >= POS_EST_UNKNOWN_VAR) {
+        // First height: no GPS height to check it against
+        est->x[POS_EST_PU] = up;
+        est->P[POS_EST_PU][POS_EST_PU] = sigma * sigma;
+        return true;
+    }
+    return fuse(est, POS_EST_PU, up - est->x[POS_EST_PU], sigma * sigma);
+}
+
+NavVector PositionEstimator_getPosition(const PositionEstimator* est) {
+    NavVector v;
+    v.east = est->x[POS_EST_PE];
+    v.north = est->x[POS_EST_PN];
+    return v;
+}
+
+float PositionEstimator_getHeading(const PositionEstimator* est, float gyroHeadingDeg) {
+    float heading = fmodf(gyroHeadingDeg + est->x[POS_EST_PSI] / POS_EST_DEG_TO_RAD, 360.0f);
+    return heading < 0.0f ? heading + 360.0f : heading;
+}
+
+float PositionEstimator_getPositionSigma(const PositionEstimator* est) {
+    float var = est->P[POS_EST_PE][POS_EST_PE];
+    if (est->P[POS_EST_PN][POS_EST_PN] > var) var = est->P[POS_EST_PN][POS_EST_PN];
+    return sqrtf(var);
+}
+
+bool PositionEstimator_isHealthy(const PositionEstimator* est) {
+    return est->initialized && PositionEstimator_getPositionSigma(est) < POS_EST_HEALTHY_SIGMA;
+}
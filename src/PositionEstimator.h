@@ -0,0 +1,162 @@
+#ifndef POSITION_ESTIMATOR_H
+#define POSITION_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NavFrame.h"
+
+/**
+ * PositionEstimator - GPS / IMU position and heading EKF
+ *
+ * State (7), in the NavFrame ENU plane around home:
+ *
+ *   pE pN pU   position, m
+ *   vE vN vU   velocity, m/s
+ *   psi        heading offset, rad: compass heading of the attitude
+ *              estimator's x axis (its gyro-only yaw has no north)
+ *
+ * - predict() runs every control tick with the tick's mean acceleration
+ *   in the attitude estimator's earth frame (gravity removed), rotated
+ *   to ENU by psi; the offset is a slow random walk (gyro drift)
+ * - GPS position / velocity, GPS course (heading offset, only while
+ *   moving) or a compass heading (any time), horizontal velocity from elsewhere (wheel odometry) and
+ *   height (baro / depth) are fused as sequential scalar
+ *   updates, so there is no matrix inverse; each innovation is gated
+ *   at POS_EST_GATE sigma
+ * - Until the first heading update the heading offset is unknown and
+ *   acceleration is not used, so position coasts on velocity
+ *
+ * Fixed-size float arrays, no allocation. About 2k FLOPs per predict.
+ *
+ * @file PositionEstimator.h
+ */
+
+#define POS_EST_STATES          7
+
+#define POS_EST_ACCEL_NOISE     0.5f    // m/s^2, IMU accel + attitude error
+#define POS_EST_HEADING_DRIFT   0.2f    // deg/s random walk of the offset
+#define POS_EST_MIN_POS_SIGMA   0.5f    // m, floor for receiver hAcc / vAcc
+#define POS_EST_RTK_MIN_POS_SIGMA 0.02f // m, the floor with an RTK fixed solution
+#define POS_EST_MIN_VEL_SIGMA   0.1f    // m/s
+#define POS_EST_DEFAULT_POS_SIGMA 5.0f  // Receiver gives no estimate (NMEA)
+#define POS_EST_DEFAULT_VEL_SIGMA 0.5f
+#define POS_EST_GATE            5.0f    // Innovation gate, sigma
+#define POS_EST_HEALTHY_SIGMA   10.0f   // m, horizontal 1-sigma for isHealthy()
+#define POS_EST_MAX_DT          0.1f    // s, longer steps are clamped
+
+enum {
+    POS_EST_PE = 0,
+    POS_EST_PN,
+    POS_EST_PU,
+    POS_EST_VE,
+    POS_EST_VN,
+    POS_EST_VU,
+    POS_EST_PSI
+};
+
+typedef struct {
+    float x[POS_EST_STATES];
+    float P[POS_EST_STATES][POS_EST_STATES];
+    bool initialized;           // First GPS fix applied
+    bool headingAligned;        // psi set from GPS course or compass
+    uint8_t gpsRejectStreak;    // Fixes in a row with position gated out
+
+    uint32_t predictions;
+    uint32_t updates;           // Scalar measurements fused
+    uint32_t rejected;          // ... and gated out
+} PositionEstimator;
+
+/**
+ * One GPS solution in the local frame
+ */
+typedef struct {
+    NavVector position;         // m, from NavFrame_toLocal()
+    float up;                   // m above home
+    float velE;                 // m/s
+    float velN;
+    float velU;
+    float hAcc;                 // m, 0 = unknown
+    float vAcc;                 // m, 0 = no usable height / vertical speed
+    float sAcc;                 // m/s, 0 = unknown
+    bool rtkFixed;              // Carrier phase fixed: hAcc / vAcc trusted to centimetres
+} PositionGPSInput;
+
+/**
+ * Reset (uninitialized until the first GPS update)
+ */
+void PositionEstimator_init(PositionEstimator* est);
+
+/**
+ * Forget position and velocity (the next GPS update re-initializes them)
+ * but keep the heading offset, e.g. when the local frame is re-anchored
+ */
+void PositionEstimator_resetPosition(PositionEstimator* est);
+
+/**
+ * Propagate by one step
+ * @param est Estimator state
+ * @param accel Mean acceleration over the step in the attitude
+ *        estimator's earth frame, gravity removed, m/s^2
+ * @param dt Step, s
+ */
+void PositionEstimator_predict(PositionEstimator* est, const float accel[3], float dt);
+
+/**
+ * Fuse a GPS solution (the first one initializes the state)
+ * @return Number of scalar measurements accepted
+ */
+uint8_t PositionEstimator_updateGPS(PositionEstimator* est, const PositionGPSInput* gps);
+
+/**
+ * Fuse a heading measurement: GPS course (only valid while the vehicle
+ * moves forward: rover, boat, plane) or a tilt-compensated compass
+ * @param gyroHeadingDeg Attitude estimator heading, clockwise (-yaw)
+ * @param courseDeg GPS course over ground / compass heading (true north)
+ * @param sigmaDeg Course 1-sigma
+ * @return false if gated out
+ */
+bool PositionEstimator_updateHeading(PositionEstimator* est, float gyroHeadingDeg,
+                                     float courseDeg, float sigmaDeg);
+
+/**
+ * Fuse a horizontal velocity measured without GPS (e.g. wheel speed
+ * along the fused heading): keeps position from drifting between fixes
+ * and through outages
+ * @param velE East, m/s
+ * @param velN North, m/s
+ * @param sigma 1-sigma per component, m/s
+ * @return Number of components accepted (0 if not initialized)
+ */
+uint8_t PositionEstimator_updateVelocity(PositionEstimator* est, float velE, float velN,
+                                         float sigma);
+
+/**
+ * Fuse a height above home (e.g. -depth for the Sub)
+ * @param up Meters above home
+ * @param sigma 1-sigma, m
+ * @return false if gated out or not initialized
+ */
+bool PositionEstimator_updateHeight(PositionEstimator* est, float up, float sigma);
+
+/**
+ * Fused position in the local frame
+ */
+NavVector PositionEstimator_getPosition(const PositionEstimator* est);
+
+/**
+ * Fused compass heading, 0-360 deg
+ * @param gyroHeadingDeg Attitude estimator heading, clockwise (-yaw)
+ */
+float PositionEstimator_getHeading(const PositionEstimator* est, float gyroHeadingDeg);
+
+/**
+ * Horizontal position 1-sigma (larger of east / north), m
+ */
+float PositionEstimator_getPositionSigma(const PositionEstimator* est);
+
+/**
+ * Initialized and horizontal 1-sigma below POS_EST_HEALTHY_SIGMA
+ */
+bool PositionEstimator_isHealthy(const PositionEstimator* est);
+
+#endif // POSITION_ESTIMATOR_H
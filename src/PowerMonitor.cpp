@@ -0,0 +1,142 @@
+#include "PowerMonitor.h"
+#include <string.h>
+
+/**
+ * PowerMonitor - Implementation
+ *
+ * @file PowerMonitor.cpp
+ */
+
+#define MAX_RESERVE_PERCENT     50
+#define MIN_MARGIN              1.0f
+#define MAX_MARGIN              3.0f
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void PowerMonitor_defaultConfig(PowerConfig* config) {
+    config->offsetMv = 0.0f;
+    config->ampsPerVolt = 0.0f;
+    config->capacityMah = 0;
+    config->reservePercent = 20;
+    config->returnMargin = 1.3f;
+}
+
+void PowerMonitor_sanitize(PowerConfig* config) {
+    if (!(config->offsetMv > 0.0f)) config->offsetMv = 0.0f;       // Also NaN
+    if (!(config->ampsPerVolt > 0.0f)) config->ampsPerVolt = 0.0f;
+    if (config->reservePercent > MAX_RESERVE_PERCENT) config->reservePercent = MAX_RESERVE_PERCENT;
+    if (!(config->returnMargin >= MIN_MARGIN))
+        config->returnMargin = MIN_MARGIN;
+    else if (config->returnMargin > MAX_MARGIN)
+        config->returnMargin = MAX_MARGIN;
+}
+
+float PowerMonitor_ampsFromMv(const PowerConfig* config, float pinMv) {
+    float amps = (pinMv - config->offsetMv) * config->ampsPerVolt * 0.001f;
+    return amps > 0.0f ? amps : 0.0f;
+}
+
+// ============================================================================
+// Accounting
+// ============================================================================
+
+void PowerMonitor_init(PowerMonitor* pm, const PowerConfig* config) {
+    memset(pm, 0, sizeof(*pm));
+    PowerMonitor_setConfig(pm, config);
+    pm->returnMah = -1.0f;
+}
+
+void PowerMonitor_setConfig(PowerMonitor* pm, const PowerConfig* config) {
+    pm->config = *config;
+    PowerMonitor_sanitize(&pm->config);
+}
+
+void PowerMonitor_update(PowerMonitor* pm, float packMv, float amps, float speedMps,
+                         uint32_t nowMs) {
+    if (!(amps > 0.0f)) amps = 0.0f;
+    pm->amps = amps;
+    pm->watts = amps * packMv * 0.001f;
+    if (amps > pm->peakAmps) pm->peakAmps = amps;
+
+    // Integrate over the gap from the previous reading (rectangle rule:
+    // readings are block averages ending at nowMs)
+    uint32_t dtMs = nowMs - pm->lastMs;
+    bool integrate = pm->primed && dtMs <= POWER_MAX_DT_MS;
+    pm->primed = true;
+    pm->lastMs = nowMs;
+    if (!integrate) return;
+
+    float hours = dtMs / 3600000.0f;
+    float mAh = amps * 1000.0f * hours;
+    float wh = pm->watts * hours;
+    pm->mAh += mAh;
+    pm->wh += wh;
+
+    float meters = 0.0f;
+    if (speedMps >= POWER_MOVING_MPS) {
+        meters = speedMps * dtMs * 0.001f;
+        pm->meters += meters;
+        pm->movingMah += mAh;
+    }
+
+    if (pm->legOpen) {
+        PowerLeg* leg = &pm->legs[(pm->legCount - 1) % POWER_MAX_LEGS];
+        leg->mAh += mAh;
+        leg->wh += wh;
+        leg->meters += meters;
+        leg->ms += dtMs;
+    }
+}
+
+void PowerMonitor_startLeg(PowerMonitor* pm, uint16_t item) {
+    PowerLeg* leg = &pm->legs[pm->legCount % POWER_MAX_LEGS];
+    memset(leg, 0, sizeof(*leg));
+    leg->item = item;
+    pm->legCount++;
+    pm->legOpen = true;
+}
+
+void PowerMonitor_endLeg(PowerMonitor* pm) {
+    pm->legOpen = false;
+}
+
+const PowerLeg* PowerMonitor_getLeg(const PowerMonitor* pm, uint16_t back) {
+    if (back >= pm->legCount || back >= POWER_MAX_LEGS) return nullptr;
+    return &pm->legs[(pm->legCount - 1 - back) % POWER_MAX_LEGS];
+}
+
+// ============================================================================
+// Return Budget
+// ============================================================================
+
+float PowerMonitor_mahPerMeter(const PowerMonitor* pm) {
+    if (pm->meters < POWER_MIN_TRAVEL_M) return -1.0f;
+    return pm->movingMah / pm->meters;
+}
+
+float PowerMonitor_availableMah(const PowerMonitor* pm) {
+    if (!pm->config.capacityMah) return -1.0f;
+    float usable = pm->config.capacityMah * (100 - pm->config.reservePercent) / 100.0f;
+    return usable - pm->mAh;
+}
+
+bool PowerMonitor_checkReturn(PowerMonitor* pm, float homeDistanceM, uint32_t nowMs) {
+    float perMeter = PowerMonitor_mahPerMeter(pm);
+    float available = PowerMonitor_availableMah(pm);
+    if (perMeter < 0.0f || !pm->config.capacityMah || !(homeDistanceM >= 0.0f)) {
+        pm->returnMah = -1.0f;
+        pm->shortSinceMs = 0;
+        return pm->rtl;
+    }
+
+    pm->returnMah = homeDistanceM * perMeter * pm->config.returnMargin;
+    if (available < pm->returnMah) {
+        if (!pm->shortSinceMs) pm->shortSinceMs = nowMs ? nowMs : 1;
+        if (nowMs - pm->shortSinceMs >= POWER_RTL_HOLD_MS) pm->rtl = true;
+    } else {
+        pm->shortSinceMs = 0;
+    }
+    return pm->rtl;
+}
@@ -0,0 +1,149 @@
+#ifndef POWER_MONITOR_H
+#define POWER_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * PowerMonitor - Current, energy and range accounting
+ *
+ * Integrates pack current and voltage at the battery block rate into
+ * mAh and Wh used, and the ground speed into distance travelled:
+ *
+ * - Current comes from a Hall / shunt-amplifier sensor on an ADC pin
+ *   (amps = (pinMv - offsetMv) * ampsPerVolt / 1000) or, without one,
+ *   from the ESCs' own current telemetry
+ * - Energy is booked per mission leg (the item being flown), with
+ *   distance and time, so legs flown at different WP speeds can be
+ *   compared in mAh per km
+ * - Return budget: charge left above the reserve against the charge
+ *   the trip home costs at the mAh per meter measured so far, times a
+ *   margin. RTL is requested once the budget stays short for
+ *   POWER_RTL_HOLD_MS; nothing is judged before POWER_MIN_TRAVEL_M of
+ *   travel has given a consumption figure
+ *
+ * Plain struct, no hardware access; update at a fixed rate with each
+ * new battery reading.
+ *
+ * @file PowerMonitor.h
+ */
+
+#define POWER_MAX_LEGS          16      // Most recent legs kept
+#define POWER_MIN_TRAVEL_M      100.0f  // Travel before mAh/m is trusted
+#define POWER_MOVING_MPS        0.5f    // Slower counts as standing still
+#define POWER_MAX_DT_MS         1000    // Longer gaps are not integrated
+#define POWER_RTL_HOLD_MS       3000
+#define POWER_LEG_RTL           0xFFFF  // Leg item for the flight home
+#define POWER_CONFIG_KEY        "cfg_power"
+
+// Where the current reading comes from
+#define POWER_SOURCE_NONE       0
+#define POWER_SOURCE_ADC        1       // Sensor on the battery ADC
+#define POWER_SOURCE_ESC        2       // Sum of the ESCs' current telemetry
+
+typedef struct {
+    float offsetMv;             // Sensor pin output at 0 A
+    float ampsPerVolt;          // Sensor gain (A per pin V)
+    uint16_t capacityMah;       // Pack capacity, 0 = no return budget
+    uint8_t reservePercent;     // Capacity kept back for landing
+    float returnMargin;         // Return cost multiplier (wind, detours)
+} PowerConfig;
+
+typedef struct {
+    uint16_t item;              // Mission item flown, POWER_LEG_RTL home
+    float mAh;
+    float wh;
+    float meters;
+    uint32_t ms;
+} PowerLeg;
+
+typedef struct {
+    PowerConfig config;
+
+    float amps;                 // Last reading
+    float watts;
+    float peakAmps;
+
+    float mAh;                  // Used since init
+    float wh;
+    float meters;               // Travelled while moving
+    float movingMah;            // ...and the charge it took
+
+    PowerLeg legs[POWER_MAX_LEGS];      // Ring, legCount % POWER_MAX_LEGS is next
+    uint16_t legCount;          // Legs started since init
+    bool legOpen;
+
+    float returnMah;            // Last budget check, -1 = unknown
+    bool rtl;
+    uint32_t shortSinceMs;      // Start of the current short-budget streak, 0 = none
+
+    bool primed;
+    uint32_t lastMs;
+} PowerMonitor;
+
+/**
+ * Default: 0 offset, 0 gain (no ADC sensor), no capacity, 20 % reserve,
+ * margin 1.3
+ */
+void PowerMonitor_defaultConfig(PowerConfig* config);
+
+void PowerMonitor_sanitize(PowerConfig* config);
+
+/**
+ * Sensor pin millivolts to amps (never negative)
+ */
+float PowerMonitor_ampsFromMv(const PowerConfig* config, float pinMv);
+
+void PowerMonitor_init(PowerMonitor* pm, const PowerConfig* config);
+
+/**
+ * Replace the configuration, keeping the totals
+ */
+void PowerMonitor_setConfig(PowerMonitor* pm, const PowerConfig* config);
+
+/**
+ * Integrate one reading into the totals and the open leg
+ * @param packMv Pack voltage
+ * @param amps Pack current
+ * @param speedMps Ground speed, 0 without a fix
+ * @param nowMs Reading time (millis)
+ */
+void PowerMonitor_update(PowerMonitor* pm, float packMv, float amps, float speedMps,
+                         uint32_t nowMs);
+
+/**
+ * Close the open leg (if any) and start booking to mission item `item`
+ */
+void PowerMonitor_startLeg(PowerMonitor* pm, uint16_t item);
+
+/**
+ * Close the open leg; later energy is booked to no leg
+ */
+void PowerMonitor_endLeg(PowerMonitor* pm);
+
+/**
+ * @param back 0 = most recent leg
+ * @return nullptr past the kept legs
+ */
+const PowerLeg* PowerMonitor_getLeg(const PowerMonitor* pm, uint16_t back);
+
+/**
+ * @return Measured consumption while moving in mAh per meter, -1 until
+ *         POWER_MIN_TRAVEL_M travelled
+ */
+float PowerMonitor_mahPerMeter(const PowerMonitor* pm);
+
+/**
+ * @return Charge left above the reserve in mAh (may be negative),
+ *         -1 without a capacity
+ */
+float PowerMonitor_availableMah(const PowerMonitor* pm);
+
+/**
+ * Check the return budget against the distance home
+ * @return true while RTL is called for (held POWER_RTL_HOLD_MS, then
+ *         latched until re-initialized)
+ */
+bool PowerMonitor_checkReturn(PowerMonitor* pm, float homeDistanceM, uint32_t nowMs);
+
+#endif // POWER_MONITOR_H
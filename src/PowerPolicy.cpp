@@ -0,0 +1,105 @@
+#include "PowerPolicy.h"
+#include <string.h>
+
+/**
+ * PowerPolicy - Implementation
+ *
+ * The idle timer restarts on every busy tick and on every frame, so a
+ * controller that keeps sending neutral sticks while disarmed keeps the
+ * vehicle at full clock as well.
+ *
+ * @file PowerPolicy.cpp
+ */
+
+static const char* const MODE_NAMES[POWER_MODE_COUNT] = {"full", "eco"};
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void PowerPolicy_defaultConfig(PowerPolicyConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->enabled = 1;
+    config->lightSleep = 1;
+    config->minMhz = POWER_POLICY_MIN_MHZ;
+    config->idleDelayMs = POWER_POLICY_IDLE_DELAY_MS;
+}
+
+void PowerPolicy_sanitize(PowerPolicyConfig* config) {
+    config->enabled = config->enabled ? 1 : 0;
+    config->lightSleep = config->lightSleep ? 1 : 0;
+    if (config->minMhz != 80 && config->minMhz != 160)
+        config->minMhz = POWER_POLICY_MIN_MHZ;
+    if (config->idleDelayMs < POWER_POLICY_IDLE_DELAY_MIN_MS)
+        config->idleDelayMs = POWER_POLICY_IDLE_DELAY_MIN_MS;
+    if (config->idleDelayMs > POWER_POLICY_IDLE_DELAY_MAX_MS)
+        config->idleDelayMs = POWER_POLICY_IDLE_DELAY_MAX_MS;
+}
+
+// ============================================================================
+// Policy
+// ============================================================================
+
+void PowerPolicy_init(PowerPolicy* pp, uint32_t nowMs) {
+    memset(pp, 0, sizeof(*pp));
+    pp->mode = POWER_MODE_FULL;
+    pp->applied = POWER_MODE_FULL;
+    pp->idleSinceMs = nowMs;
+}
+
+void PowerPolicy_frame(PowerPolicy* pp, int64_t arrivedUs) {
+    if (pp->applied == POWER_MODE_ECO && pp->wakeFrameUs == 0)
+        pp->wakeFrameUs = arrivedUs;
+    pp->busySeen = true;
+}
+
+PowerMode PowerPolicy_update(PowerPolicy* pp, const PowerPolicyConfig* config, bool busy,
+                             uint32_t nowMs) {
+    if (busy || pp->busySeen || !config->enabled) {
+        pp->idleSinceMs = nowMs;
+        pp->busySeen = false;
+        pp->mode = POWER_MODE_FULL;
+    } else if (nowMs - pp->idleSinceMs >= config->idleDelayMs) {
+        pp->mode = POWER_MODE_ECO;
+    }
+    return pp->mode;
+}
+
+void PowerPolicy_applied(PowerPolicy* pp, PowerMode mode, uint32_t nowMs, int64_t nowUs) {
+    if (mode == pp->applied)
+        return;
+    if (mode == POWER_MODE_ECO) {
+        pp->ecoEntries++;
+        pp->ecoStartMs = nowMs;
+    } else {
+        pp->ecoTotalMs += nowMs - pp->ecoStartMs;
+        if (pp->wakeFrameUs != 0) {
+            int64_t latency = nowUs - pp->wakeFrameUs;
+            pp->lastWakeUs = latency > 0 ? (uint32_t)latency : 0;
+            if (pp->lastWakeUs > pp->maxWakeUs)
+                pp->maxWakeUs = pp->lastWakeUs;
+            if (pp->lastWakeUs > POWER_POLICY_WAKE_BOUND_US)
+                pp->slowWakes++;
+            pp->wakes++;
+        }
+    }
+    pp->wakeFrameUs = 0;
+    pp->applied = mode;
+}
+
+uint64_t PowerPolicy_ecoMs(const PowerPolicy* pp, uint32_t nowMs) {
+    uint64_t total = pp->ecoTotalMs;
+    if (pp->applied == POWER_MODE_ECO)
+        total += nowMs - pp->ecoStartMs;
+    return total;
+}
+
+// ============================================================================
+// Names
+// ============================================================================
+
+const char* PowerPolicy_modeName(PowerMode mode) {
+    if ((unsigned)mode >= POWER_MODE_COUNT)
+        return "?";
+    return MODE_NAMES[mode];
+}
@@ -0,0 +1,116 @@
+#ifndef POWER_POLICY_H
+#define POWER_POLICY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * PowerPolicy - Full clock while flying, scaled down while parked
+ *
+ * Two modes:
+ *
+ *   FULL  CPU held at its maximum clock, no light sleep, radio never
+ *         sleeps (WifiLink's own power-save setting)
+ *   ECO   CPU scaled down to minMhz between ticks, automatic light sleep
+ *         if enabled, radio in modem sleep with an ESP-NOW wake window
+ *
+ * The vehicle is busy while armed, in signal loss, on a mission or with a
+ * host on the serial port; ECO starts once it has not been busy for
+ * idleDelayMs. Any control frame applied while in ECO wakes it at once:
+ * the mode is FULL again in the tick that applied the frame, before that
+ * frame moves anything, so the failsafe arms at full clock.
+ *
+ * Wake latency is measured from the frame's arrival to the moment FULL
+ * is in place (the caller reports it applied); wakes slower than
+ * POWER_POLICY_WAKE_BOUND_US are counted.
+ *
+ * Stored as a config blob (POWER_POLICY_CONFIG_KEY).
+ *
+ * Pure: no globals, no RTOS. Owned by the control task.
+ *
+ * @file PowerPolicy.h
+ */
+
+#define POWER_POLICY_CONFIG_KEY         "cfg_pm"
+#define POWER_POLICY_IDLE_DELAY_MS      10000
+#define POWER_POLICY_IDLE_DELAY_MIN_MS  1000
+#define POWER_POLICY_IDLE_DELAY_MAX_MS  600000
+#define POWER_POLICY_MIN_MHZ            80      // APB stays at 80 MHz (UART, LEDC)
+#define POWER_POLICY_WAKE_BOUND_US      40000   // Two control periods
+
+typedef enum {
+    POWER_MODE_FULL = 0,
+    POWER_MODE_ECO,
+    POWER_MODE_COUNT
+} PowerMode;
+
+/**
+ * Stored configuration
+ */
+typedef struct {
+    uint8_t enabled;            // 0: always FULL
+    uint8_t lightSleep;         // Automatic light sleep in ECO
+    uint16_t minMhz;            // ECO clock floor: 80 or 160
+    uint32_t idleDelayMs;       // Not busy this long -> ECO
+} PowerPolicyConfig;
+
+typedef struct {
+    PowerMode mode;             // Wanted by the policy
+    PowerMode applied;          // Reported in place by the caller
+    bool busySeen;              // Frame applied since the last update
+    uint32_t idleSinceMs;       // Last busy tick
+    int64_t wakeFrameUs;        // Arrival of the frame that woke ECO (0 = none)
+    uint32_t ecoEntries;
+    uint32_t ecoStartMs;
+    uint64_t ecoTotalMs;        // Time in ECO before the current stretch
+    uint32_t wakes;             // ECO -> FULL by a control frame
+    uint32_t lastWakeUs;
+    uint32_t maxWakeUs;
+    uint32_t slowWakes;         // Over POWER_POLICY_WAKE_BOUND_US
+} PowerPolicy;
+
+/**
+ * Enabled, light sleep, 80 MHz floor, 10 s idle delay
+ */
+void PowerPolicy_defaultConfig(PowerPolicyConfig* config);
+
+/**
+ * Clamp a loaded / edited config into range
+ */
+void PowerPolicy_sanitize(PowerPolicyConfig* config);
+
+/**
+ * FULL, idle timer starting now
+ */
+void PowerPolicy_init(PowerPolicy* pp, uint32_t nowMs);
+
+/**
+ * A control frame was applied this tick
+ * @param arrivedUs Its arrival time (same clock as PowerPolicy_applied)
+ */
+void PowerPolicy_frame(PowerPolicy* pp, int64_t arrivedUs);
+
+/**
+ * Decide the mode for this tick
+ * @param busy Armed, signal loss, mission or host active
+ * @return Mode to be in; the caller applies it and reports back
+ */
+PowerMode PowerPolicy_update(PowerPolicy* pp, const PowerPolicyConfig* config, bool busy,
+                             uint32_t nowMs);
+
+/**
+ * The caller has put a mode in place (records ECO time and wake latency)
+ */
+void PowerPolicy_applied(PowerPolicy* pp, PowerMode mode, uint32_t nowMs, int64_t nowUs);
+
+/**
+ * Time spent in ECO, including the current stretch
+ */
+uint64_t PowerPolicy_ecoMs(const PowerPolicy* pp, uint32_t nowMs);
+
+/**
+ * Mode name ("full", "eco")
+ */
+const char* PowerPolicy_modeName(PowerMode mode);
+
+#endif // POWER_POLICY_H
@@ -1,4 +1,7 @@
 #include "RSSIManager.h"
+#include "HAL.h"
+#include <esp_idf_version.h>
+#include <esp_wifi.h>
 
 const int8_t RSSIManager::RSSI_MIN = -120;
 const int8_t RSSIManager::RSSI_MAX = 0;
@@ -7,12 +10,18 @@ const int8_t RSSIManager::RSSI_GOOD = -60;
 const int8_t RSSIManager::RSSI_FAIR = -75;
 const uint32_t RSSIManager::SIGNAL_TIMEOUT = 1000;  // milliseconds
 
-RSSIManager::RSSIManager() : currentRSSI_dBm(RSSI_MIN), lastUpdateTime(0) {}
+// Latest ESP-NOW frame RSSI from the promiscuous sniffer (Wi-Fi task)
+static volatile int8_t lastFrameRSSI = -120;
+
+RSSIManager::RSSIManager()
+    : currentRSSI_dBm(RSSI_MIN), lastUpdateTime(0), _rssiCount(0), _rssiHead(0),
+      _rssiSum(0), _haveSeq(false), _lastSeq(0), _windowExpected(0),
+      _windowLost(0), _lossPercent(0), _stats() {}
 
 void RSSIManager::updateRSSI(int8_t rssi) {
     // Clamp to valid range
     currentRSSI_dBm = constrain(rssi, RSSI_MIN, RSSI_MAX);
-    lastUpdateTime = millis();
+    lastUpdateTime = HAL_GetMillis();
 }
 
 uint8_t RSSIManager::dbmToPercentage(int8_t rssi_dbm) {
@@ -56,6 +65,141 @@ const char* RSSIManager::getSignalQuality() {
 }
 
 bool RSSIManager::isSignalLost() {
-    uint32_t timeSinceUpdate = millis() - lastUpdateTime;
+    uint32_t timeSinceUpdate = HAL_GetMillis() - lastUpdateTime;
     return timeSinceUpdate > SIGNAL_TIMEOUT;
 }
+
+// ============================================================================
+// Link Quality
+// ============================================================================
+
+void RSSIManager::recordFrame(int8_t rssi, uint32_t sequenceNumber) {
+    int8_t clamped = constrain(rssi, RSSI_MIN, RSSI_MAX);
+    uint32_t now = HAL_GetMillis();
+
+    portENTER_CRITICAL(&_linkMux);
+    currentRSSI_dBm = clamped;
+    lastUpdateTime = now;
+
+    // Running sum over the ring of recent samples
+    if (_rssiCount == RSSI_WINDOW_SIZE) {
+        _rssiSum -= _rssiWindow[_rssiHead];
+    } else {
+        _rssiCount++;
+    }
+    _rssiWindow[_rssiHead] = clamped;
+    _rssiSum += clamped;
+    _rssiHead = (_rssiHead + 1) % RSSI_WINDOW_SIZE;
+
+    uint32_t delta = sequenceNumber - _lastSeq;
+    if (!_haveSeq) {
+        _haveSeq = true;
+        _lastSeq = sequenceNumber;
+        _windowExpected++;
+        _stats.received++;
+    } else if (delta == 0) {
+        _stats.duplicates++;
+    } else if (delta <= LINK_MAX_SEQ_GAP) {
+        // Every number skipped since the last frame was lost
+        _windowExpected += delta;
+        _windowLost += delta - 1;
+        _stats.lost += delta - 1;
+        _stats.received++;
+        _lastSeq = sequenceNumber;
+    } else if (_lastSeq - sequenceNumber <= LINK_MAX_SEQ_GAP) {
+        // Reordered: it was counted lost when the newer frame arrived
+        _stats.late++;
+        _stats.received++;
+        if (_windowLost)
+            _windowLost--;
+        if (_stats.lost)
+            _stats.lost--;
+    } else {
+        // Sender restarted or jumped: resync without counting loss
+        _stats.resyncs++;
+        _stats.received++;
+        _lastSeq = sequenceNumber;
+        _windowExpected++;
+    }
+
+    if (_windowExpected >= LINK_LOSS_WINDOW) {
+        _lossPercent = (uint8_t)((_windowLost * 100UL) / _windowExpected);
+        _windowExpected = 0;
+        _windowLost = 0;
+    }
+    portEXIT_CRITICAL(&_linkMux);
+}
+
+int8_t RSSIManager::getAverageRSSI_dBm() {
+    if (isSignalLost()) {
+        return RSSI_MIN;
+    }
+    portENTER_CRITICAL(&_linkMux);
+    int8_t avg = _rssiCount ? (int8_t)(_rssiSum / _rssiCount) : RSSI_MIN;
+    portEXIT_CRITICAL(&_linkMux);
+    return avg;
+}
+
+uint8_t RSSIManager::getPacketLossPercent() {
+    if (isSignalLost()) {
+        return 100;
+    }
+    portENTER_CRITICAL(&_linkMux);
+    uint8_t loss = _lossPercent;
+    // Before the first full window, use what we have so far
+    bool firstWindow = _stats.received + _stats.lost < LINK_LOSS_WINDOW;
+    if (firstWindow && _windowExpected) {
+        loss = (uint8_t)((_windowLost * 100UL) / _windowExpected);
+    }
+    portEXIT_CRITICAL(&_linkMux);
+    return loss;
+}
+
+uint8_t RSSIManager::getLinkQuality() {
+    uint8_t loss = getPacketLossPercent();
+    return (uint8_t)((dbmToPercentage(getAverageRSSI_dBm()) * (100 - loss)) / 100);
+}
+
+LinkStats RSSIManager::getLinkStats() {
+    portENTER_CRITICAL(&_linkMux);
+    LinkStats copy = _stats;
+    portEXIT_CRITICAL(&_linkMux);
+    return copy;
+}
+
+// ============================================================================
+// Per-frame RSSI Capture
+// ============================================================================
+
+#if ESP_IDF_VERSION_MAJOR < 5
+// ESP-NOW frames are vendor-specific action frames:
+// 24-byte MAC header, category 127, Espressif OUI 18:FE:34
+static void IRAM_ATTR espnow_sniffer(void* buf, wifi_promiscuous_pkt_type_t type) {
+    if (type != WIFI_PKT_MGMT) return;
+
+    const wifi_promiscuous_pkt_t* pkt = (const wifi_promiscuous_pkt_t*)buf;
+    const uint8_t* frame = pkt->payload;
+    if (pkt->rx_ctrl.sig_len < 28) return;
+    if (frame[0] != 0xD0) return;   // Action frame
+    if (frame[24] != 127 || frame[25] != 0x18 || frame[26] != 0xFE || frame[27] != 0x34) return;
+
+    lastFrameRSSI = pkt->rx_ctrl.rssi;
+}
+#endif
+
+bool RSSIManager::beginFrameCapture() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    // esp_now_recv_info_t carries rx_ctrl, nothing to set up
+    return true;
+#else
+    wifi_promiscuous_filter_t filter = {};
+    filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+    esp_wifi_set_promiscuous_filter(&filter);
+    esp_wifi_set_promiscuous_rx_cb(espnow_sniffer);
+    return esp_wifi_set_promiscuous(true) == ESP_OK;
+#endif
+}
+
+int8_t RSSIManager::getLastFrameRSSI() {
+    return lastFrameRSSI;
+}
@@ -3,15 +3,37 @@
 
 #include <Arduino.h>
 #include <esp_now.h>
+#include <freertos/FreeRTOS.h>
 
 /**
  * RSSIManager - Signal strength monitoring from ESP-NOW
  * 
  * RSSI (Received Signal Strength Indicator):
  * - Range: -120 to 0 dBm (typical: -50 to -80 dBm good signal)
- * - ESP-NOW callback provides RSSI in packet info
+ * - ESP-NOW callback provides RSSI in packet info (IDF 5+); on older
+ *   cores a promiscuous-mode sniffer reads it from the ESP-NOW action frame
  * - Converted to percentage: 0% = -120dBm (very bad), 100% = 0dBm (ideal)
+ *
+ * Link quality:
+ * - RSSI averaged over the last RSSI_WINDOW_SIZE frames
+ * - Packet loss from sequenceNumber gaps, per LINK_LOSS_WINDOW expected frames
+ * - recordFrame() runs in the Wi-Fi task, getters in any task (guarded by _linkMux)
  */
+
+#define RSSI_WINDOW_SIZE 16     // Frames in the RSSI average
+#define LINK_LOSS_WINDOW 64     // Expected frames per loss measurement
+#define LINK_MAX_SEQ_GAP 256    // Larger jumps are a sender restart, not loss
+
+/**
+ * Link counters since boot
+ */
+struct LinkStats {
+    uint32_t received;      // Frames with a new sequence number
+    uint32_t lost;          // Sequence numbers never seen
+    uint32_t duplicates;    // Same sequence number again
+    uint32_t late;          // Older than the newest seen (reordered)
+    uint32_t resyncs;       // Sequence jumps treated as a sender restart
+};
 class RSSIManager {
 public:
     RSSIManager();
@@ -45,10 +67,65 @@ public:
      * @return true if last update > 1000ms ago
      */
     bool isSignalLost();
+
+    /**
+     * Record one received control frame (Wi-Fi task)
+     * @param rssi Frame RSSI in dBm
+     * @param sequenceNumber Sender's sequence number
+     */
+    void recordFrame(int8_t rssi, uint32_t sequenceNumber);
+
+    /**
+     * Get windowed average RSSI in dBm
+     * @return average of the last RSSI_WINDOW_SIZE frames, RSSI_MIN if lost
+     */
+    int8_t getAverageRSSI_dBm();
+
+    /**
+     * Get packet loss over the last completed window (0-100%)
+     * @return loss percentage, 100 if signal lost
+     */
+    uint8_t getPacketLossPercent();
+
+    /**
+     * Get combined link quality (0-100%): average RSSI scaled by delivery rate
+     * @return quality percentage
+     */
+    uint8_t getLinkQuality();
+
+    /**
+     * Copy link counters
+     */
+    LinkStats getLinkStats();
+
+    /**
+     * Start per-frame RSSI capture (call after esp_now_init)
+     * @return true if a capture path is available
+     */
+    static bool beginFrameCapture();
+
+    /**
+     * Get RSSI of the most recent ESP-NOW frame seen by the sniffer
+     * @return RSSI in dBm, RSSI_MIN before the first frame
+     */
+    static int8_t getLastFrameRSSI();
     
 private:
     int8_t currentRSSI_dBm;
     uint32_t lastUpdateTime;
+
+    // Link window state (guarded by _linkMux)
+    int8_t _rssiWindow[RSSI_WINDOW_SIZE];
+    uint8_t _rssiCount;
+    uint8_t _rssiHead;
+    int16_t _rssiSum;
+    bool _haveSeq;
+    uint32_t _lastSeq;
+    uint16_t _windowExpected;
+    uint16_t _windowLost;
+    uint8_t _lossPercent;
+    LinkStats _stats;
+    portMUX_TYPE _linkMux = portMUX_INITIALIZER_UNLOCKED;
     
     static const int8_t RSSI_MIN;       // -120 dBm (very bad)
     static const int8_t RSSI_MAX;       // 0 dBm (ideal)
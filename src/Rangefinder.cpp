@@ -0,0 +1,80 @@
+#include "Rangefinder.h"
+#include <string.h>
+
+/**
+ * Rangefinder - Implementation
+ *
+ * @file Rangefinder.cpp
+ */
+
+#define RANGE_MIN_GAP_M     0.1f    // Between stopM and slowM
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static float median(const float* v, uint8_t n) {
+    float s[RANGE_MEDIAN];
+    memcpy(s, v, n * sizeof(float));
+    // Insertion sort: the window is a handful of values
+    for (uint8_t i = 1; i < n; i++) {
+        float x = s[i];
+        uint8_t j = i;
+        while (j > 0 && s[j - 1] > x) {
+            s[j] = s[j - 1];
+            j--;
+        }
+        s[j] = x;
+    }
+    // Even count (window still filling): the nearer of the middle two
+    return s[(n - 1) / 2];
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+float Rangefinder_echoToMeters(uint32_t echoUs) {
+    if (echoUs == 0 || echoUs >= RANGE_ECHO_TIMEOUT_US) return RANGE_MAX_M;
+    float m = echoUs * 1e-6f * RANGE_SOUND_MPS * 0.5f;
+    return m > RANGE_MAX_M ? RANGE_MAX_M : m;
+}
+
+void RangeFilter_init(RangeFilter* f) {
+    memset(f, 0, sizeof(*f));
+    f->range = RANGE_MAX_M;
+}
+
+float RangeFilter_add(RangeFilter* f, float meters) {
+    if (meters < RANGE_MIN_M) meters = RANGE_MIN_M;
+    if (meters >= RANGE_MAX_M) {
+        meters = RANGE_MAX_M;
+        f->noEcho++;
+    }
+    f->window[f->head] = meters;
+    f->head = (uint8_t)((f->head + 1) % RANGE_MEDIAN);
+    if (f->count < RANGE_MEDIAN) f->count++;
+    f->samples++;
+    f->range = median(f->window, f->count);
+    return f->range;
+}
+
+void RangeEnvelope_defaults(RangeEnvelope* env) {
+    env->enabled = true;
+    env->slowM = RANGE_SLOW_M;
+    env->stopM = RANGE_STOP_M;
+}
+
+void RangeEnvelope_sanitize(RangeEnvelope* env) {
+    if (!(env->stopM >= RANGE_MIN_M)) env->stopM = RANGE_MIN_M;
+    if (env->stopM > RANGE_MAX_M - RANGE_MIN_GAP_M) env->stopM = RANGE_MAX_M - RANGE_MIN_GAP_M;
+    if (!(env->slowM >= env->stopM + RANGE_MIN_GAP_M)) env->slowM = env->stopM + RANGE_MIN_GAP_M;
+    if (env->slowM > RANGE_MAX_M) env->slowM = RANGE_MAX_M;
+}
+
+float Rangefinder_speedScale(const RangeEnvelope* env, float rangeM) {
+    if (!env->enabled) return 1.0f;
+    if (rangeM <= env->stopM) return 0.0f;
+    if (rangeM >= env->slowM) return 1.0f;
+    return (rangeM - env->stopM) / (env->slowM - env->stopM);
+}
@@ -0,0 +1,107 @@
+#ifndef RANGEFINDER_H
+#define RANGEFINDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Rangefinder - Forward obstacle range: echo timing, filter, slow-down
+ *
+ * A forward ultrasonic ranger (HC-SR04 / JSN-SR04T class) answers each
+ * trigger with one echo pulse as long as the sound's round trip, or a
+ * pulse past RANGE_ECHO_TIMEOUT_US when nothing came back. The driver
+ * (UltrasonicRMT) times the pulse in the RMT peripheral; this module
+ * turns it into a filtered range and a speed scale:
+ *
+ * - Rangefinder_echoToMeters(): half the round trip at the speed of sound
+ * - RangeFilter: median of the last RANGE_MEDIAN readings, so a single
+ *   crosstalk / multipath echo neither stops the vehicle nor hides a
+ *   wall; no echo reads as RANGE_MAX_M (clear)
+ * - Rangefinder_speedScale(): the distance envelope, full speed beyond
+ *   slowM, linear down to 0 at stopM, 0 inside it:
+ *
+ *     scale
+ *       1 |            ________
+ *         |          /
+ *         |        /
+ *       0 |______/
+ *         +-----+-----+-------- range
+ *             stopM  slowM
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file Rangefinder.h
+ */
+
+// Sensor pins (-1 = not fitted): trigger out, echo in (5 V sensors need
+// a divider on the echo line)
+#ifndef RANGE_TRIG_PIN
+#define RANGE_TRIG_PIN          -1
+#endif
+#ifndef RANGE_ECHO_PIN
+#define RANGE_ECHO_PIN          -1
+#endif
+
+#define RANGE_PERIOD_MS         60      // Trigger interval: lets the last echo die out
+#define RANGE_ECHO_TIMEOUT_US   25000   // Longer pulse: nothing in range
+#define RANGE_SOUND_MPS         343.0f  // Air at 20 deg C
+#define RANGE_MIN_M             0.02f   // Shorter: ring-down, not a target
+#define RANGE_MAX_M             4.0f    // Rated range; no echo reads as this
+#define RANGE_MEDIAN            3       // Readings in the median window
+#define RANGE_STALE_MS          (4 * RANGE_PERIOD_MS)  // Older: sensor lost
+#define RANGE_CONFIG_KEY        "cfg_range"
+
+// Envelope defaults (Tunable; -D overrides)
+#ifndef RANGE_SLOW_M
+#define RANGE_SLOW_M            2.0f    // Start slowing down
+#endif
+#ifndef RANGE_STOP_M
+#define RANGE_STOP_M            0.5f    // Stop
+#endif
+
+typedef struct {
+    bool enabled;           // Off: ranges are published, speed untouched
+    float slowM;
+    float stopM;            // < slowM
+} RangeEnvelope;
+
+typedef struct {
+    float window[RANGE_MEDIAN];
+    uint8_t count;          // Readings in the window (fills at start)
+    uint8_t head;           // Next slot
+    float range;            // Median, m
+
+    // Statistics
+    uint32_t samples;
+    uint32_t noEcho;        // Clear readings
+} RangeFilter;
+
+/**
+ * Range of an echo pulse
+ * @param echoUs Pulse width, 0 = no echo
+ * @return Metres, RANGE_MAX_M for no echo or anything beyond it
+ */
+float Rangefinder_echoToMeters(uint32_t echoUs);
+
+void RangeFilter_init(RangeFilter* f);
+
+/**
+ * Add one reading and update the median
+ * @return The filtered range, m
+ */
+float RangeFilter_add(RangeFilter* f, float meters);
+
+void RangeEnvelope_defaults(RangeEnvelope* env);
+
+/**
+ * Clamp an envelope into sane ranges (in place)
+ */
+void RangeEnvelope_sanitize(RangeEnvelope* env);
+
+/**
+ * Speed factor for an obstacle at rangeM
+ * @return 0 (stop) .. 1 (full speed); 1 when the envelope is off
+ */
+float Rangefinder_speedScale(const RangeEnvelope* env, float rangeM);
+
+#endif // RANGEFINDER_H
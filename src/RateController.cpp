@@ -0,0 +1,68 @@
+#include "RateController.h"
+#include <string.h>
+
+/**
+ * RateController - Implementation
+ *
+ * @file RateController.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static float clampf(float v, float limit) {
+    return v > limit ? limit : (v < -limit ? -limit : v);
+}
+
+// ============================================================================
+// Single Axis
+// ============================================================================
+
+void RatePID_defaultGains(RatePIDGains* gains, float kp, float ki, float kd) {
+    gains->kp = kp;
+    gains->ki = ki;
+    gains->kd = kd;
+    gains->kff = RATE_DEFAULT_FF;
+    gains->dCutoffHz = RATE_DEFAULT_D_CUTOFF;
+    gains->iLimit = RATE_DEFAULT_I_LIMIT;
+    gains->outLimit = RATE_DEFAULT_OUT_LIMIT;
+}
+
+float RatePID_update(const RatePIDGains* gains, RatePIDState* state, float setpoint,
+                     float measured, float dt, bool integrate) {
+    return PID_update(gains, state, setpoint, measured, dt, integrate);
+}
+
+// ============================================================================
+// Controller Bank
+// ============================================================================
+
+void RateController_init(RateController* rc, float maxRollPitch, float maxYaw) {
+    memset(rc, 0, sizeof(*rc));
+    rc->maxRate[RATE_AXIS_ROLL] = maxRollPitch;
+    rc->maxRate[RATE_AXIS_PITCH] = maxRollPitch;
+    rc->maxRate[RATE_AXIS_YAW] = maxYaw;
+    for (uint8_t axis = 0; axis < RATE_AXIS_COUNT; axis++) {
+        RatePID_defaultGains(&rc->gains[axis], 0.0f, 0.0f, 0.0f);
+    }
+}
+
+void RateController_setGains(RateController* rc, uint8_t axis, const RatePIDGains* gains) {
+    if (axis >= RATE_AXIS_COUNT) return;
+    rc->gains[axis] = *gains;
+}
+
+void RateController_reset(RateController* rc) {
+    memset(rc->state, 0, sizeof(rc->state));
+    memset(rc->output, 0, sizeof(rc->output));
+}
+
+void RateController_update(RateController* rc, const float command[RATE_AXIS_COUNT],
+                           const float rates[RATE_AXIS_COUNT], float dt, bool integrate) {
+    for (uint8_t axis = 0; axis < RATE_AXIS_COUNT; axis++) {
+        float measured = rc->maxRate[axis] > 0.0f ? rates[axis] / rc->maxRate[axis] : 0.0f;
+        rc->output[axis] = RatePID_update(&rc->gains[axis], &rc->state[axis],
+                                          clampf(command[axis], 1.0f), measured, dt, integrate);
+    }
+}
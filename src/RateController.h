@@ -0,0 +1,105 @@
+#ifndef RATE_CONTROLLER_H
+#define RATE_CONTROLLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "PIDController.h"
+
+/**
+ * RateController - Body-rate PID bank (roll, pitch, yaw)
+ *
+ * Inner loop of the multirotor: the pilot's sticks command angular rate,
+ * each axis drives its gyro rate to the setpoint.
+ *
+ *   out = kff * sp + kp * e + integral + D
+ *
+ * - Error and setpoint are normalized by the axis' full-stick rate, so
+ *   gains are dimensionless and outputs are mixer units (-1..1)
+ * - D acts on the measurement (no kick on stick steps), through a
+ *   first-order low-pass at dCutoffHz; gyro noise is mostly above it
+ * - Anti-windup: the integral is clamped to +-iLimit and stops growing
+ *   while the output is saturated in the direction of the error
+ * - Callers pass integrate = false on the ground (low throttle) so the
+ *   integrators don't wind up against the floor
+ *
+ * Each axis is a PIDController step; state is plain structs (no
+ * allocation) and gains can be replaced between updates without
+ * resetting the integrators.
+ *
+ * @file RateController.h
+ */
+
+#define RATE_AXIS_ROLL      0
+#define RATE_AXIS_PITCH     1
+#define RATE_AXIS_YAW       2
+#define RATE_AXIS_COUNT     3
+
+#define RATE_DEFAULT_FF         0.2f
+#define RATE_DEFAULT_D_CUTOFF   30.0f   // Hz
+#define RATE_DEFAULT_I_LIMIT    0.3f    // Output units
+#define RATE_DEFAULT_OUT_LIMIT  1.0f
+
+/**
+ * Gains / state for one axis: the shared PID (PIDController.h)
+ */
+typedef PIDGains RatePIDGains;
+typedef PIDState RatePIDState;
+
+/**
+ * Three-axis controller bank
+ */
+typedef struct {
+    RatePIDGains gains[RATE_AXIS_COUNT];
+    RatePIDState state[RATE_AXIS_COUNT];
+    float maxRate[RATE_AXIS_COUNT];     // Full-stick rate, rad/s
+    float output[RATE_AXIS_COUNT];      // Last outputs, mixer units
+} RateController;
+
+/**
+ * Fill gains with defaults for the given PID terms
+ */
+void RatePID_defaultGains(RatePIDGains* gains, float kp, float ki, float kd);
+
+/**
+ * Run one axis
+ * @param gains Axis gains
+ * @param state Axis state
+ * @param setpoint Normalized rate command
+ * @param measured Normalized measured rate
+ * @param dt Time since the previous update, s
+ * @param integrate false to hold the integrator
+ * @return Output, clamped to +-outLimit
+ */
+float RatePID_update(const RatePIDGains* gains, RatePIDState* state, float setpoint,
+                     float measured, float dt, bool integrate);
+
+/**
+ * Reset state and set default gains
+ * @param rc Controller bank
+ * @param maxRollPitch Full-stick roll / pitch rate, rad/s
+ * @param maxYaw Full-stick yaw rate, rad/s
+ */
+void RateController_init(RateController* rc, float maxRollPitch, float maxYaw);
+
+/**
+ * Replace one axis' gains (keeps integrator and filter state)
+ */
+void RateController_setGains(RateController* rc, uint8_t axis, const RatePIDGains* gains);
+
+/**
+ * Zero integrators and D history (e.g. on disarm)
+ */
+void RateController_reset(RateController* rc);
+
+/**
+ * Run all three axes
+ * @param rc Controller bank
+ * @param command Stick commands, -1..1 per axis
+ * @param rates Measured body rates, rad/s
+ * @param dt Time since the previous update, s
+ * @param integrate false to hold the integrators
+ */
+void RateController_update(RateController* rc, const float command[RATE_AXIS_COUNT],
+                           const float rates[RATE_AXIS_COUNT], float dt, bool integrate);
+
+#endif // RATE_CONTROLLER_H
@@ -1,43 +1,210 @@
 #include "RateLimitManager.h"
+#include "HAL.h"
 #include <Arduino.h>
 #include <string.h>
 #include <stdio.h>
 
 /**
  * RateLimitManager - Token Bucket Implementation
- * 
+ *
  * Token bucket algorithm:
  * - Capacity: 100 tokens (max 100 commands/sec if refilled at right rate)
- * - Refill: +1 token every 10ms (100 tokens per 1 second)
+ * - Refill: continuous, 100 tokens per 1 second (configurable)
  * - Cost: 1 token per command
  * - Rejection: Return error code, don't process command
- * 
+ *
+ * Tokens are Q16 fixed point and refilled from HAL_Now(), so
+ * any rate from 1/s to 65535/s accrues exactly: the sub-Q16 remainder of
+ * each refill is carried to the next one instead of being dropped.
+ *
  * @file RateLimitManager.cpp
  */
 
+#define TOKEN_ONE       (1UL << 16)     // One token in Q16
+#define US_PER_SEC      1000000ULL
+
 typedef struct {
-    uint8_t tokens;
-    uint8_t capacity;
-    uint32_t lastRefillTime;
     uint32_t totalAllowed;
     uint32_t totalBlocked;
+    uint32_t peerBlocked;
+    uint32_t classBlocked;
     bool initialized;
 } RateLimitState;
 
 static RateLimitState gRateLimitState = {
-    .tokens = 0,
-    .capacity = RATE_LIMIT_CAPACITY,
-    .lastRefillTime = 0,
     .totalAllowed = 0,
     .totalBlocked = 0,
+    .peerBlocked = 0,
+    .classBlocked = 0,
     .initialized = false
 };
 
-// Per-command limits (optional, initialized to 0 = no limit)
-static struct {
-    uint16_t maxPerSecond[256];
-    uint32_t lastUsed[256];
-} gCommandLimits = {{0}};
+// ============================================================================
+// Buckets
+// ============================================================================
+
+// Bucket with its own rate, tokens in Q16
+typedef struct {
+    uint32_t tokens;
+    uint32_t capacity;
+    uint32_t perSecond;         // Whole tokens per second
+    uint32_t carry;             // Refill remainder (token/2^16 * us/s units)
+    int64_t lastRefillUs;
+} RateBucket;
+
+enum {
+    ENTRY_EMPTY = 0,
+    ENTRY_PEER,
+    ENTRY_COMMAND
+};
+
+// Open-addressed table entry, key = kind + id
+typedef struct {
+    uint8_t kind;
+    uint8_t id[RATE_LIMIT_MAC_SIZE];    // Peer MAC, or command type in id[0]
+    RateBucket bucket;
+} RateLimitEntry;
+
+static RateLimitEntry gTable[RATE_LIMIT_TABLE_SIZE];
+static uint8_t gTableUsed = 0;
+
+// Per-class rate and burst
+static const struct {
+    uint16_t perSecond;
+    uint16_t burst;
+} CLASS_LIMITS[RATE_CLASS_COUNT] = {
+    {100, 100},     // RATE_CLASS_CONTROL
+    {20, 20},       // RATE_CLASS_COMMAND
+    {2, 4}          // RATE_CLASS_HANDSHAKE
+};
+static RateBucket gClassBuckets[RATE_CLASS_COUNT];
+
+// Global bucket; control class and peers scale with its rate
+static RateBucket gGlobal;
+static uint16_t gGlobalPerSecond = RATE_LIMIT_CAPACITY;
+static uint16_t gPeerPerSecond = RATE_LIMIT_PEER_PER_SEC;
+
+static const uint8_t LOCAL_PEER[RATE_LIMIT_MAC_SIZE] = {0};
+
+static portMUX_TYPE gRateLimitMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void bucket_init(RateBucket* b, uint16_t perSecond, uint16_t burst, int64_t now) {
+    b->tokens = (uint32_t)burst * TOKEN_ONE;
+    b->capacity = (uint32_t)burst * TOKEN_ONE;
+    b->perSecond = perSecond;
+    b->carry = 0;
+    b->lastRefillUs = now;
+}
+
+static void bucket_refill(RateBucket* b, int64_t now) {
+    int64_t elapsed = now - b->lastRefillUs;
+    b->lastRefillUs = now;
+    if (elapsed <= 0 || b->perSecond == 0) return;
+    if (b->tokens >= b->capacity) {
+        b->carry = 0;
+        return;
+    }
+
+    // Past the time to refill the deficit the bucket is simply full; below
+    // it elapsed * perSecond stays under deficit * 1e6, so no overflow
+    uint32_t deficit = b->capacity - b->tokens;
+    uint64_t fillUs = (uint64_t)deficit * US_PER_SEC / ((uint64_t)b->perSecond * TOKEN_ONE) + 1;
+    if ((uint64_t)elapsed >= fillUs) {
+        b->tokens = b->capacity;
+        b->carry = 0;
+        return;
+    }
+
+    uint64_t scaled = (uint64_t)elapsed * b->perSecond * TOKEN_ONE + b->carry;
+    uint64_t add = scaled / US_PER_SEC;
+    b->carry = (uint32_t)(scaled % US_PER_SEC);
+    b->tokens = add >= deficit ? b->capacity : b->tokens + (uint32_t)add;
+}
+
+static inline bool bucket_has_token(const RateBucket* b) {
+    return b->tokens >= TOKEN_ONE;
+}
+
+static inline uint16_t bucket_whole(const RateBucket* b) {
+    return (uint16_t)(b->tokens / TOKEN_ONE);
+}
+
+static uint32_t hash_key(uint8_t kind, const uint8_t* id) {
+    uint32_t h = 2166136261u ^ kind;    // FNV-1a
+    for (int i = 0; i < RATE_LIMIT_MAC_SIZE; i++) {
+        h ^= id[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * Find (or create) the bucket for a key
+ *
+ * Entries are never removed individually, so a probe can stop at the
+ * first empty slot. When the table is full, a bucket that has refilled
+ * to full is taken over in place: it holds no state the old key needs.
+ */
+static RateBucket* table_lookup(uint8_t kind, const uint8_t* id, bool create,
+                                uint16_t perSecond, uint16_t burst, int64_t now) {
+    uint32_t start = hash_key(kind, id) & (RATE_LIMIT_TABLE_SIZE - 1);
+    for (uint32_t i = 0; i < RATE_LIMIT_TABLE_SIZE; i++) {
+        RateLimitEntry* e = &gTable[(start + i) & (RATE_LIMIT_TABLE_SIZE - 1)];
+        if (e->kind == kind && memcmp(e->id, id, RATE_LIMIT_MAC_SIZE) == 0) return &e->bucket;
+        if (e->kind == ENTRY_EMPTY) {
+            if (!create) return NULL;
+            e->kind = kind;
+            memcpy(e->id, id, RATE_LIMIT_MAC_SIZE);
+            bucket_init(&e->bucket, perSecond, burst, now);
+            gTableUsed++;
+            return &e->bucket;
+        }
+    }
+    if (!create) return NULL;
+
+    // Full: reuse an idle peer bucket (configured command limits stay)
+    for (uint32_t i = 0; i < RATE_LIMIT_TABLE_SIZE; i++) {
+        RateLimitEntry* e = &gTable[(start + i) & (RATE_LIMIT_TABLE_SIZE - 1)];
+        if (e->kind != ENTRY_PEER) continue;
+        bucket_refill(&e->bucket, now);
+        if (e->bucket.tokens < e->bucket.capacity) continue;
+        e->kind = kind;
+        memcpy(e->id, id, RATE_LIMIT_MAC_SIZE);
+        bucket_init(&e->bucket, perSecond, burst, now);
+        return &e->bucket;
+    }
+    return NULL;
+}
+
+static void init_class_buckets(int64_t now) {
+    for (int i = 0; i < RATE_CLASS_COUNT; i++) {
+        bucket_init(&gClassBuckets[i], CLASS_LIMITS[i].perSecond, CLASS_LIMITS[i].burst, now);
+    }
+    // Control traffic may use the whole configured rate
+    bucket_init(&gClassBuckets[RATE_CLASS_CONTROL], gGlobalPerSecond, gGlobalPerSecond, now);
+}
+
+static void refill_buckets(int64_t now) {
+    for (int i = 0; i < RATE_LIMIT_TABLE_SIZE; i++) {
+        RateBucket* b = &gTable[i].bucket;
+        bucket_init(b, b->perSecond, b->capacity / TOKEN_ONE, now);
+    }
+    init_class_buckets(now);
+}
+
+static void reset_buckets(int64_t now) {
+    memset(gTable, 0, sizeof(gTable));
+    gTableUsed = 0;
+    init_class_buckets(now);
+}
+
+// Re-rate a bucket, keeping (at most the new capacity of) its tokens
+static void bucket_set_rate(RateBucket* b, uint16_t perSecond, int64_t now) {
+    bucket_refill(b, now);
+    b->perSecond = perSecond;
+    b->capacity = (uint32_t)perSecond * TOKEN_ONE;
+    if (b->tokens > b->capacity) b->tokens = b->capacity;
+}
 
 // ============================================================================
 // Public API Implementation
@@ -47,18 +214,45 @@ bool RateLimitManager_init(uint8_t initialTokens) {
     if (initialTokens > RATE_LIMIT_CAPACITY) {
         return false;
     }
-    
-    gRateLimitState.tokens = initialTokens;
-    gRateLimitState.capacity = RATE_LIMIT_CAPACITY;
-    gRateLimitState.lastRefillTime = millis(); 
+
+    HAL_Micros now = HAL_Now();
+    portENTER_CRITICAL(&gRateLimitMux);
+    gGlobalPerSecond = RATE_LIMIT_CAPACITY;
+    gPeerPerSecond = RATE_LIMIT_PEER_PER_SEC;
+    bucket_init(&gGlobal, RATE_LIMIT_CAPACITY, RATE_LIMIT_CAPACITY, now);
+    gGlobal.tokens = (uint32_t)initialTokens * TOKEN_ONE;
     gRateLimitState.totalAllowed = 0;
     gRateLimitState.totalBlocked = 0;
+    gRateLimitState.peerBlocked = 0;
+    gRateLimitState.classBlocked = 0;
     gRateLimitState.initialized = true;
-    
-    // Initialize per-command limits
-    memset(gCommandLimits.maxPerSecond, 0, sizeof(gCommandLimits.maxPerSecond));
-    memset(gCommandLimits.lastUsed, 0, sizeof(gCommandLimits.lastUsed));
-    
+
+    // Peer buckets and per-command limits start empty
+    reset_buckets(now);
+    portEXIT_CRITICAL(&gRateLimitMux);
+
+    return true;
+}
+
+bool RateLimitManager_setRate(uint16_t perSecond) {
+    if (perSecond == 0 || !gRateLimitState.initialized) {
+        return false;
+    }
+
+    HAL_Micros now = HAL_Now();
+    uint16_t peer = (uint16_t)((uint32_t)perSecond * RATE_LIMIT_PEER_PER_SEC / RATE_LIMIT_CAPACITY);
+    if (peer == 0) peer = 1;
+
+    portENTER_CRITICAL(&gRateLimitMux);
+    gGlobalPerSecond = perSecond;
+    gPeerPerSecond = peer;
+    bucket_set_rate(&gGlobal, perSecond, now);
+    bucket_set_rate(&gClassBuckets[RATE_CLASS_CONTROL], perSecond, now);
+    for (int i = 0; i < RATE_LIMIT_TABLE_SIZE; i++) {
+        if (gTable[i].kind == ENTRY_PEER) bucket_set_rate(&gTable[i].bucket, peer, now);
+    }
+    portEXIT_CRITICAL(&gRateLimitMux);
+
     return true;
 }
 
@@ -66,71 +260,128 @@ RateLimitStatus RateLimitManager_checkCommand(uint8_t commandType) {
     if (!gRateLimitState.initialized) {
         return RATE_LIMIT_BLOCKED;
     }
-    
+
     // Auto-refill based on time elapsed instead of manual loop call
-    uint32_t now = millis();
-    uint32_t elapsed = now - gRateLimitState.lastRefillTime;
-    
-    // 1 token every 10ms (100 tokens per sec)
-    if (elapsed >= 10) {
-        uint8_t refillCount = elapsed / 10;
-        gRateLimitState.tokens += refillCount;
-        if (gRateLimitState.tokens > gRateLimitState.capacity) {
-            gRateLimitState.tokens = gRateLimitState.capacity;
-        }
-        gRateLimitState.lastRefillTime += refillCount * 10;
-    }
+    HAL_Micros now = HAL_Now();
+    uint8_t id[RATE_LIMIT_MAC_SIZE] = {commandType};
+    RateLimitStatus status = RATE_LIMIT_ALLOWED;
+
+    portENTER_CRITICAL(&gRateLimitMux);
+    bucket_refill(&gGlobal, now);
+
+    // Per-command rate limit (if set)
+    RateBucket* cmd = table_lookup(ENTRY_COMMAND, id, false, 0, 0, now);
+    if (cmd && cmd->perSecond == 0) cmd = NULL;
+    if (cmd) bucket_refill(cmd, now);
 
     // Check global token bucket
-    if (gRateLimitState.tokens == 0) {
+    if (!bucket_has_token(&gGlobal)) {
+        gRateLimitState.totalBlocked++;
+        status = RATE_LIMIT_EXCEEDED;
+    } else if (cmd && !bucket_has_token(cmd)) {
         gRateLimitState.totalBlocked++;
-        return RATE_LIMIT_EXCEEDED;
+        gRateLimitState.classBlocked++;
+        status = RATE_LIMIT_EXCEEDED;
+    } else {
+        // Command allowed: consume one token
+        if (cmd) cmd->tokens -= TOKEN_ONE;
+        gGlobal.tokens -= TOKEN_ONE;
+        gRateLimitState.totalAllowed++;
+    }
+    portEXIT_CRITICAL(&gRateLimitMux);
+
+    return status;
+}
+
+RateLimitStatus RateLimitManager_check(const uint8_t* peer, RateLimitClass cls) {
+    if (!gRateLimitState.initialized || cls >= RATE_CLASS_COUNT) {
+        return RATE_LIMIT_BLOCKED;
     }
-    
-    // Check per-command rate limit (if set)
-    if (gCommandLimits.maxPerSecond[commandType] > 0) {
-        // Phase 9: Implement per-command tracking
+
+    HAL_Micros now = HAL_Now();
+    RateLimitStatus status = RATE_LIMIT_ALLOWED;
+
+    portENTER_CRITICAL(&gRateLimitMux);
+    bucket_refill(&gGlobal, now);
+    RateBucket* klass = &gClassBuckets[cls];
+    bucket_refill(klass, now);
+    RateBucket* own = table_lookup(ENTRY_PEER, peer ? peer : LOCAL_PEER, true,
+                                   gPeerPerSecond, gPeerPerSecond, now);
+    if (own) bucket_refill(own, now);
+
+    // Narrowest level first: the one at fault is the one that rejects
+    if (!own || !bucket_has_token(own)) {
+        gRateLimitState.peerBlocked++;
+        status = RATE_LIMIT_EXCEEDED;
+    } else if (!bucket_has_token(klass)) {
+        gRateLimitState.classBlocked++;
+        status = RATE_LIMIT_EXCEEDED;
+    } else if (!bucket_has_token(&gGlobal)) {
+        status = RATE_LIMIT_EXCEEDED;
+    }
+
+    if (status == RATE_LIMIT_ALLOWED) {
+        own->tokens -= TOKEN_ONE;
+        klass->tokens -= TOKEN_ONE;
+        gGlobal.tokens -= TOKEN_ONE;
+        gRateLimitState.totalAllowed++;
+    } else {
+        gRateLimitState.totalBlocked++;
     }
-    
-    // Command allowed: consume one token
-    gRateLimitState.tokens--;
-    gRateLimitState.totalAllowed++;
-    
-    return RATE_LIMIT_ALLOWED;
+    portEXIT_CRITICAL(&gRateLimitMux);
+
+    return status;
 }
 
-uint8_t RateLimitManager_refill(void) {
+uint16_t RateLimitManager_refill(void) {
     // Deprecated: Now handled automatically in checkCommand
-    return gRateLimitState.tokens;
+    return bucket_whole(&gGlobal);
 }
 
-uint8_t RateLimitManager_getTokens(void) {
-    return gRateLimitState.tokens;
+uint16_t RateLimitManager_getTokens(void) {
+    return bucket_whole(&gGlobal);
 }
 
 bool RateLimitManager_setCommandLimit(uint8_t commandType, uint16_t maxPerSecond) {
     if (maxPerSecond > 1000) {
         return false;  // Max 1000 per second per command
     }
-    
-    gCommandLimits.maxPerSecond[commandType] = maxPerSecond;
-    return true;
+
+    HAL_Micros now = HAL_Now();
+    uint8_t id[RATE_LIMIT_MAC_SIZE] = {commandType};
+    portENTER_CRITICAL(&gRateLimitMux);
+    RateBucket* cmd = table_lookup(ENTRY_COMMAND, id, maxPerSecond > 0,
+                                   maxPerSecond, maxPerSecond, now);
+    if (cmd) {
+        // 0 = no limit: the entry stays (no deletions) but is skipped
+        bucket_init(cmd, maxPerSecond, maxPerSecond, now);
+    }
+    portEXIT_CRITICAL(&gRateLimitMux);
+    return cmd != NULL || maxPerSecond == 0;
 }
 
 void RateLimitManager_reset(void) {
-    gRateLimitState.tokens = gRateLimitState.capacity;
-    gRateLimitState.lastRefillTime = 0;
+    HAL_Micros now = HAL_Now();
+    portENTER_CRITICAL(&gRateLimitMux);
+    bucket_init(&gGlobal, gGlobalPerSecond, gGlobalPerSecond, now);
     gRateLimitState.totalAllowed = 0;
     gRateLimitState.totalBlocked = 0;
+    gRateLimitState.peerBlocked = 0;
+    gRateLimitState.classBlocked = 0;
+    refill_buckets(now);
+    portEXIT_CRITICAL(&gRateLimitMux);
 }
 
 RateLimitStats RateLimitManager_getStats(void) {
     RateLimitStats stats = {
-        .currentTokens = gRateLimitState.tokens,
-        .capacity = gRateLimitState.capacity,
+        .currentTokens = bucket_whole(&gGlobal),
+        .capacity = (uint16_t)(gGlobal.capacity / TOKEN_ONE),
         .totalCommandsAllowed = gRateLimitState.totalAllowed,
         .totalCommandsBlocked = gRateLimitState.totalBlocked,
-        .lastRefillTime = gRateLimitState.lastRefillTime
+        .lastRefillTime = (uint32_t)(gGlobal.lastRefillUs / 1000),
+        .peerBlocked = gRateLimitState.peerBlocked,
+        .classBlocked = gRateLimitState.classBlocked,
+        .bucketsUsed = gTableUsed
     };
     return stats;
 }
@@ -8,10 +8,22 @@
  * RateLimitManager - Token Bucket Rate Limiting
  * 
  * Prevents DoS attacks by limiting command rate:
- * - Max 100 commands per second
- * - Refill: +1 token every 10ms
+ * - Max 100 commands per second (RateLimitManager_setRate: 1..65535)
+ * - Refill: continuous, Q16 fractional tokens on a microsecond clock
  * - Per-command-type limits (optional)
- * 
+ *
+ * Hierarchical check (RateLimitManager_check): a request needs a token in
+ * its peer bucket, its class bucket and the global bucket, and is only
+ * charged once all three have one. A flooding peer (or command class)
+ * empties its own bucket and is rejected there, without draining the
+ * global budget the control link depends on.
+ *
+ * Peer and per-command buckets live in a small open-addressed table and
+ * are only created when first used. Buckets that have refilled to full
+ * carry no state, so they are reused when the table is full.
+ *
+ * Safe to call from the Wi-Fi task and application tasks concurrently.
+ *
  * @file RateLimitManager.h
  */
 
@@ -19,6 +31,22 @@
 #define RATE_LIMIT_REFILL_PER_MS  1    // Tokens per 10ms = 100/sec
 #define RATE_LIMIT_REFILL_INTERVAL  10 // Milliseconds
 
+#define RATE_LIMIT_TABLE_SIZE   32      // Peer / command buckets (power of two)
+#define RATE_LIMIT_PEER_PER_SEC 60      // Per-peer rate (and burst) at the default
+                                        // rate; scales with RateLimitManager_setRate
+                                        // so one peer never takes the whole budget
+#define RATE_LIMIT_MAC_SIZE     6
+
+/**
+ * Command classes, each with its own bucket
+ */
+typedef enum {
+    RATE_CLASS_CONTROL = 0,     // Control frames and stick moves (100/s)
+    RATE_CLASS_COMMAND = 1,     // Serial JSON commands (20/s)
+    RATE_CLASS_HANDSHAKE = 2,   // Key exchange frames (2/s, burst 4)
+    RATE_CLASS_COUNT
+} RateLimitClass;
+
 /**
  * Status codes for rate limit checks
  */
@@ -36,6 +64,17 @@ typedef enum {
  */
 bool RateLimitManager_init(uint8_t initialTokens);
 
+/**
+ * Set the global rate (also the burst: one second of traffic)
+ *
+ * The control class and peer buckets follow it, so a 200 Hz link only
+ * needs a rate of 200 here. Current tokens are kept (up to the new
+ * capacity), so changing the rate never grants a fresh burst.
+ * @param perSecond Requests per second (SecurityConfig::rateLimitCPS)
+ * @return false for 0 or before RateLimitManager_init
+ */
+bool RateLimitManager_setRate(uint16_t perSecond);
+
 /**
  * Check if command is allowed under rate limit
  * @param commandType Command ID (0-255)
@@ -43,23 +82,31 @@ bool RateLimitManager_init(uint8_t initialTokens);
  */
 RateLimitStatus RateLimitManager_checkCommand(uint8_t commandType);
 
+/**
+ * Check a request against its peer, class and the global bucket
+ * @param peer Sender MAC (6 bytes), NULL for the local host link
+ * @param cls Command class
+ * @return RATE_LIMIT_ALLOWED if allowed (one token taken from each level)
+ */
+RateLimitStatus RateLimitManager_check(const uint8_t* peer, RateLimitClass cls);
+
 /**
  * Refill tokens (call every 10ms in main loop)
  * @return Current token count after refill
  */
-uint8_t RateLimitManager_refill(void);
+uint16_t RateLimitManager_refill(void);
 
 /**
  * Get current token count
- * @return Number of tokens available
+ * @return Number of whole tokens available
  */
-uint8_t RateLimitManager_getTokens(void);
+uint16_t RateLimitManager_getTokens(void);
 
 /**
- * Set per-command rate limit
+ * Set per-command rate limit (checked by RateLimitManager_checkCommand)
  * @param commandType Command ID
- * @param maxPerSecond Max calls per second
- * @return true if set successfully
+ * @param maxPerSecond Max calls per second (also the burst), 0 = no limit
+ * @return true if set successfully (false if over 1000 or the table is full)
  */
 bool RateLimitManager_setCommandLimit(uint8_t commandType, uint16_t maxPerSecond);
 
@@ -72,11 +119,14 @@ void RateLimitManager_reset(void);
  * Get rate limit statistics
  */
 typedef struct {
-    uint8_t currentTokens;
-    uint8_t capacity;
+    uint16_t currentTokens;     // Whole tokens
+    uint16_t capacity;
     uint32_t totalCommandsAllowed;
     uint32_t totalCommandsBlocked;
     uint32_t lastRefillTime;
+    uint32_t peerBlocked;       // Rejected by a peer bucket
+    uint32_t classBlocked;      // Rejected by a class / per-command bucket
+    uint8_t bucketsUsed;        // Table entries in use
 } RateLimitStats;
 
 RateLimitStats RateLimitManager_getStats(void);
@@ -0,0 +1,91 @@
+#include "RateProfile.h"
+#include <string.h>
+
+/**
+ * RateProfile - Implementation
+ *
+ * @file RateProfile.cpp
+ */
+
+// ============================================================================
+// Profiles
+// ============================================================================
+
+// Rover, Plane, Sub, Copter: outer loop at 50 Hz everywhere, so the
+// navigation, failsafe and logging timing is the same on every vehicle
+const RateProfile RATE_PROFILES[RATE_PROFILE_COUNT] = {
+    {20, 1},
+    {20, 1},
+    {20, 1},
+    {2, 10},    // 500 Hz rate loop
+};
+
+const RateProfile RATE_PROFILE_FLAT = {20, 1};
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+const RateProfile* RateProfile_forVehicle(uint8_t type) {
+    return type < RATE_PROFILE_COUNT ? &RATE_PROFILES[type] : &RATE_PROFILE_FLAT;
+}
+
+void RateSchedule_init(RateSchedule* s, const RateProfile* profile) {
+    memset(s, 0, sizeof(*s));
+    s->profile = *profile;
+    if (s->profile.innerPeriodMs == 0) s->profile.innerPeriodMs = 1;
+    if (s->profile.outerDiv == 0) s->profile.outerDiv = 1;
+    s->innerPeriodUs = s->profile.innerPeriodMs * 1000UL;
+    s->phase = s->profile.outerDiv - 1;
+}
+
+bool RateSchedule_begin(RateSchedule* s) {
+    if (s->phase < 255) s->phase++;
+    int div = s->profile.outerDiv;
+    if (s->phase < div) return false;
+
+    // Late by a whole outer period: run, missed deadline or not
+    if (s->phase >= 2 * div) {
+        s->outerForced++;
+        return true;
+    }
+    if (s->lastMissed) {
+        s->outerDeferred++;
+        return false;
+    }
+    return true;
+}
+
+float RateSchedule_outerDt(const RateSchedule* s) {
+    return s->phase * s->innerPeriodUs * 1e-6f;
+}
+
+float RateSchedule_innerDt(const RateSchedule* s) {
+    return s->innerPeriodUs * 1e-6f;
+}
+
+void RateSchedule_end(RateSchedule* s, bool outerRan, uint32_t execUs) {
+    bool missed = execUs > s->innerPeriodUs;
+    s->ticks++;
+    if (outerRan) {
+        s->phase = 0;
+        s->outerRuns++;
+        if (missed) s->outerMisses++;
+        if (execUs > s->maxOuterUs) s->maxOuterUs = execUs;
+    } else {
+        if (missed) s->innerMisses++;
+        if (execUs > s->maxInnerUs) s->maxInnerUs = execUs;
+    }
+    s->lastMissed = missed;
+}
+
+void RateSchedule_resetStats(RateSchedule* s) {
+    s->ticks = 0;
+    s->outerRuns = 0;
+    s->outerDeferred = 0;
+    s->outerForced = 0;
+    s->innerMisses = 0;
+    s->outerMisses = 0;
+    s->maxInnerUs = 0;
+    s->maxOuterUs = 0;
+}
@@ -0,0 +1,98 @@
+#ifndef RATE_PROFILE_H
+#define RATE_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * RateProfile - Per-vehicle control loop rates and deadline accounting
+ *
+ * The control task runs two loops at integer-divided rates:
+ *
+ *   inner  every tick: drain the IMU, vehicle->loop() (a Copter's body
+ *          rate PIDs and mixer, actuator commit)
+ *   outer  every outerDiv ticks: links and sticks, failsafe, navigation,
+ *          battery, config hot-swap, setInputs(), topics and logging
+ *
+ * A Copter's rate loop wants far more than 50 Hz, while a Rover, Plane
+ * (its rate loop already runs per gyro sample in setAttitude()) or Sub
+ * gains nothing from a faster tick; each vehicle type gets its row in
+ * RATE_PROFILES. Telemetry and background work keep their own core 0
+ * tasks and periods.
+ *
+ * A tick that runs longer than the inner period is a deadline miss: the
+ * next release is late. After a miss the next outer run is held back a
+ * tick so inner ticks catch up first; never more than one outer period,
+ * then it runs regardless (failsafe and stick updates are late, never
+ * starved). Inner work is never skipped.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file RateProfile.h
+ */
+
+#define RATE_PROFILE_COUNT      4       // VehicleType order (VehicleRegistry.h)
+
+typedef struct {
+    uint8_t innerPeriodMs;      // Control task period
+    uint8_t outerDiv;           // Outer loop every N inner ticks
+} RateProfile;
+
+typedef struct {
+    RateProfile profile;
+    uint32_t innerPeriodUs;
+    uint8_t phase;              // Inner ticks since the last outer run
+    bool lastMissed;            // Previous tick overran the inner period
+
+    uint32_t ticks;
+    uint32_t outerRuns;
+    uint32_t outerDeferred;     // Ticks an outer run was due but held back
+    uint32_t outerForced;       // Outer runs a whole outer period late
+    uint32_t innerMisses;       // Inner-only ticks past the inner period
+    uint32_t outerMisses;       // Ticks with the outer loop past it
+    uint32_t maxInnerUs;        // Worst inner-only tick
+    uint32_t maxOuterUs;        // Worst tick with the outer loop
+} RateSchedule;
+
+extern const RateProfile RATE_PROFILES[RATE_PROFILE_COUNT];
+extern const RateProfile RATE_PROFILE_FLAT;    // 50 Hz, outer every tick
+
+/**
+ * Profile for a vehicle type, RATE_PROFILE_FLAT when out of range
+ */
+const RateProfile* RateProfile_forVehicle(uint8_t type);
+
+/**
+ * Start a schedule; the first tick runs the outer loop
+ */
+void RateSchedule_init(RateSchedule* s, const RateProfile* profile);
+
+/**
+ * Begin a tick
+ * @return true if this tick runs the outer loop (then RateSchedule_outerDt)
+ */
+bool RateSchedule_begin(RateSchedule* s);
+
+/**
+ * Time the outer loop covers this tick: since its previous run, s
+ */
+float RateSchedule_outerDt(const RateSchedule* s);
+
+/**
+ * Inner loop step, s
+ */
+float RateSchedule_innerDt(const RateSchedule* s);
+
+/**
+ * End a tick
+ * @param outerRan What RateSchedule_begin returned
+ * @param execUs Tick execution time
+ */
+void RateSchedule_end(RateSchedule* s, bool outerRan, uint32_t execUs);
+
+/**
+ * Clear the counters (the phase is kept)
+ */
+void RateSchedule_resetStats(RateSchedule* s);
+
+#endif // RATE_PROFILE_H
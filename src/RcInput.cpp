@@ -0,0 +1,295 @@
+#include "RcInput.h"
+#include <string.h>
+
+/**
+ * RcInput - Implementation
+ *
+ * Idle, the next header byte is searched and, if the whole frame is
+ * already in the buffer, checked where it lies. A frame cut off by the
+ * end of the read is copied into the parser's buffer and checked once the
+ * rest arrives. A bad frame gives up only its first byte, so a header
+ * value inside a payload does not cost the frame behind it.
+ *
+ * @file RcInput.cpp
+ */
+
+#define CRSF_MIN_LENGTH         2       // Type + CRC
+#define CRSF_MAX_LENGTH         (RC_CRSF_MAX_FRAME - 2)
+#define SBUS_FLAGS_OFFSET       23
+#define SWITCH_HIGH_TICKS       ((RC_TICKS_CENTER + RC_TICKS_MAX) / 2)
+
+static const char* const PROTOCOL_NAMES[RC_PROTOCOL_COUNT] = {"sbus", "crsf"};
+static const uint8_t DEFAULT_AXES[RC_AXES] = {2, 0, 1, 3};     // AETR
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static bool is_header(uint8_t protocol, uint8_t b) {
+    if (protocol == RC_PROTOCOL_SBUS) return b == RC_SBUS_HEADER;
+    return b == RC_CRSF_ADDR_FC || b == RC_CRSF_ADDR_TX;
+}
+
+// SBUS2 interleaves telemetry slots: footer 0x04, 0x14, 0x24, 0x34
+static bool sbus_footer(uint8_t b) {
+    return b == 0x00 || (b & 0xCF) == 0x04;
+}
+
+static void unpack(const uint8_t* p, uint16_t* channels) {
+    uint32_t acc = 0;
+    uint8_t bits = 0, c = 0;
+    for (uint8_t i = 0; i < RC_CHANNELS_LEN; i++) {
+        acc |= (uint32_t)p[i] << bits;
+        bits += 8;
+        while (bits >= 11) {
+            channels[c++] = (uint16_t)(acc & 0x7FF);
+            acc >>= 11;
+            bits -= 11;
+        }
+    }
+}
+
+static void pack(const uint16_t* channels, uint8_t* p) {
+    uint32_t acc = 0;
+    uint8_t bits = 0, n = 0;
+    for (uint8_t c = 0; c < RC_MAX_CHANNELS; c++) {
+        acc |= (uint32_t)(channels[c] & 0x7FF) << bits;
+        bits += 11;
+        while (bits >= 8) {
+            p[n++] = (uint8_t)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+}
+
+/**
+ * Check a whole frame starting at its header and emit it
+ * @return false (and counted) if it does not check out
+ */
+static bool check(RcParser* parser, const uint8_t* f, RcFrame* frame) {
+    if (parser->protocol == RC_PROTOCOL_SBUS) {
+        if (!sbus_footer(f[RC_SBUS_FRAME_LEN - 1])) {
+            parser->crcErrors++;
+            return false;
+        }
+        frame->type = RC_CRSF_TYPE_CHANNELS;
+        frame->length = RC_CHANNELS_LEN + 1;
+        frame->payload = &f[1];
+    } else {
+        uint8_t length = f[1];
+        if (RcInput_crc8(&f[2], length - 1) != f[length + 1]) {
+            parser->crcErrors++;
+            return false;
+        }
+        frame->type = f[2];
+        frame->length = (uint8_t)(length - CRSF_MIN_LENGTH);
+        frame->payload = &f[3];
+    }
+    parser->frames++;
+    return true;
+}
+
+/**
+ * Frame length from its first bytes
+ * @return Bytes of the whole frame, 0 if not known yet, -1 if impossible
+ */
+static int frame_length(RcParser* parser, const uint8_t* f, size_t len) {
+    if (parser->protocol == RC_PROTOCOL_SBUS) return RC_SBUS_FRAME_LEN;
+    if (len < 2) return 0;
+    if (f[1] < CRSF_MIN_LENGTH || f[1] > CRSF_MAX_LENGTH) {
+        parser->badLength++;
+        return -1;
+    }
+    return f[1] + 2;
+}
+
+/**
+ * Try to take a whole frame straight from the buffer
+ * @return Bytes consumed (frame or bad header byte), 0 if incomplete
+ */
+static size_t feed_in_place(RcParser* parser, const uint8_t* data, size_t len, RcFrame* frame) {
+    int length = frame_length(parser, data, len);
+    if (length < 0) return 1;
+    if (length == 0 || len < (size_t)length) return 0;
+    return check(parser, data, frame) ? (size_t)length : 1;
+}
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+void RcInput_init(RcParser* parser, RcProtocol protocol) {
+    memset(parser, 0, sizeof(*parser));
+    parser->protocol = (uint8_t)protocol;
+}
+
+size_t RcInput_feed(RcParser* parser, const uint8_t* data, size_t len, RcFrame* frame) {
+    frame->payload = NULL;
+    size_t i = 0;
+
+    while (i < len) {
+        if (parser->index == 0) {
+            while (i < len && !is_header(parser->protocol, data[i])) i++;
+            if (i == len) return len;
+            size_t used = feed_in_place(parser, &data[i], len - i, frame);
+            if (frame->payload) return i + used;
+            if (used) {
+                i += used;
+                continue;
+            }
+            // Frame continues in the next read
+            parser->buffer[0] = data[i++];
+            parser->index = 1;
+            parser->length = 0;
+            continue;
+        }
+
+        if (parser->length == 0) {
+            int length = frame_length(parser, parser->buffer, parser->index);
+            if (length == 0) {
+                parser->buffer[parser->index++] = data[i++];
+                continue;
+            }
+            if (length < 0) {
+                parser->index = 0;      // Resync on the bytes that follow
+                continue;
+            }
+            parser->length = (uint8_t)length;
+        }
+
+        size_t n = parser->length - parser->index;
+        if (n > len - i) n = len - i;
+        memcpy(&parser->buffer[parser->index], &data[i], n);
+        parser->index += n;
+        i += n;
+        if (parser->index < parser->length) continue;
+        parser->index = 0;
+        if (check(parser, parser->buffer, frame)) return i;
+    }
+    return len;
+}
+
+bool RcInput_decodeChannels(const RcFrame* frame, RcChannels* out) {
+    if (!frame->payload || frame->type != RC_CRSF_TYPE_CHANNELS) return false;
+    if (frame->length != RC_CHANNELS_LEN && frame->length != RC_CHANNELS_LEN + 1) return false;
+    unpack(frame->payload, out->channels);
+    out->flags = 0;
+    if (frame->length > RC_CHANNELS_LEN) {
+        uint8_t sbus = frame->payload[RC_CHANNELS_LEN];
+        if (sbus & RC_SBUS_FLAG_FRAME_LOST) out->flags |= RC_FLAG_FRAME_LOST;
+        if (sbus & RC_SBUS_FLAG_FAILSAFE) out->flags |= RC_FLAG_FAILSAFE;
+    }
+    return true;
+}
+
+bool RcInput_decodeLink(const RcFrame* frame, RcLink* out) {
+    if (!frame->payload || frame->type != RC_CRSF_TYPE_LINK ||
+        frame->length < RC_CRSF_LINK_LEN) return false;
+    // RSSI of both antennas as positive dBm, the smaller is the better
+    uint8_t rssi = frame->payload[0] < frame->payload[1] ? frame->payload[0] : frame->payload[1];
+    out->rssiDbm = -(int16_t)rssi;
+    out->lq = frame->payload[2];
+    out->snr = (int8_t)frame->payload[3];
+    return true;
+}
+
+uint8_t RcInput_crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0xD5) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t RcInput_buildChannels(RcProtocol protocol, const uint16_t* channels, uint8_t flags,
+                             uint8_t* out, size_t outSize) {
+    if (protocol == RC_PROTOCOL_SBUS) {
+        if (outSize < RC_SBUS_FRAME_LEN) return 0;
+        out[0] = RC_SBUS_HEADER;
+        pack(channels, &out[1]);
+        out[SBUS_FLAGS_OFFSET] = flags;
+        out[RC_SBUS_FRAME_LEN - 1] = 0x00;
+        return RC_SBUS_FRAME_LEN;
+    }
+    size_t total = RC_CHANNELS_LEN + 4;
+    if (outSize < total) return 0;
+    out[0] = RC_CRSF_ADDR_FC;
+    out[1] = RC_CHANNELS_LEN + CRSF_MIN_LENGTH;
+    out[2] = RC_CRSF_TYPE_CHANNELS;
+    pack(channels, &out[3]);
+    out[total - 1] = RcInput_crc8(&out[2], RC_CHANNELS_LEN + 1);
+    return total;
+}
+
+// ============================================================================
+// Mapping
+// ============================================================================
+
+void RcInput_defaultConfig(RcConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->enabled = 1;
+    config->protocol = RC_PROTOCOL_CRSF;
+    memcpy(config->axes, DEFAULT_AXES, sizeof(config->axes));
+    config->autoChannel = 4;
+    config->telemetry = 1;
+}
+
+void RcInput_sanitize(RcConfig* config) {
+    config->enabled = config->enabled ? 1 : 0;
+    if (config->protocol >= RC_PROTOCOL_COUNT) config->protocol = RC_PROTOCOL_CRSF;
+    for (uint8_t a = 0; a < RC_AXES; a++) {
+        if (config->axes[a] >= RC_MAX_CHANNELS && config->axes[a] != RC_CHANNEL_NONE)
+            config->axes[a] = DEFAULT_AXES[a];
+    }
+    config->reverse &= (1 << RC_AXES) - 1;
+    if (config->autoChannel >= RC_MAX_CHANNELS) config->autoChannel = RC_CHANNEL_NONE;
+    config->throttleCentered = config->throttleCentered ? 1 : 0;
+    config->telemetry = config->telemetry ? 1 : 0;
+}
+
+bool RcInput_toSticks(const RcConfig* config, const RcChannels* channels,
+                      int16_t sticks[RC_AXES]) {
+    for (uint8_t a = 0; a < RC_AXES; a++) {
+        uint8_t ch = config->axes[a];
+        if (ch >= RC_MAX_CHANNELS) {
+            sticks[a] = 0;
+            continue;
+        }
+        int32_t t = channels->channels[ch];
+        if (t < RC_TICKS_MIN) t = RC_TICKS_MIN;
+        if (t > RC_TICKS_MAX) t = RC_TICKS_MAX;
+        if (config->reverse & (1 << a)) t = RC_TICKS_MIN + RC_TICKS_MAX - t;
+
+        int32_t v;
+        if (a == 0 && !config->throttleCentered) {
+            v = (t - RC_TICKS_MIN) * RC_STICK_MAX / (RC_TICKS_MAX - RC_TICKS_MIN);
+        } else if (t >= RC_TICKS_CENTER) {
+            v = (t - RC_TICKS_CENTER) * RC_STICK_MAX / (RC_TICKS_MAX - RC_TICKS_CENTER);
+        } else {
+            v = (t - RC_TICKS_CENTER) * RC_STICK_MAX / (RC_TICKS_CENTER - RC_TICKS_MIN);
+        }
+        sticks[a] = (int16_t)v;
+    }
+    return config->autoChannel < RC_MAX_CHANNELS &&
+           channels->channels[config->autoChannel] >= SWITCH_HIGH_TICKS;
+}
+
+const char* RcInput_protocolName(RcProtocol protocol) {
+    if ((unsigned)protocol >= RC_PROTOCOL_COUNT) return "?";
+    return PROTOCOL_NAMES[protocol];
+}
+
+bool RcInput_parseProtocol(const char* name, RcProtocol* protocol) {
+    if (!name) return false;
+    for (uint8_t i = 0; i < RC_PROTOCOL_COUNT; i++) {
+        if (strcmp(name, PROTOCOL_NAMES[i]) == 0) {
+            *protocol = (RcProtocol)i;
+            return true;
+        }
+    }
+    return false;
+}
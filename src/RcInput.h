@@ -0,0 +1,215 @@
+#ifndef RC_INPUT_H
+#define RC_INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * RcInput - SBUS / CRSF receiver framing and channel mapping
+ *
+ * SBUS (100000 baud 8E2, inverted line), 25 bytes every 7-14 ms:
+ *   0x0F | 16 x 11-bit channels (22) | flags | footer (0x00, SBUS2 x4)
+ * flags: bit 0/1 digital channels 17/18, bit 2 frame lost, bit 3 failsafe.
+ * There is no checksum; header and footer frame it.
+ *
+ * CRSF (420000 baud 8N1), every 4-20 ms depending on the link rate:
+ *   address (0xC8 / 0xEE) | length | type | payload | CRC-8 (poly 0xD5)
+ * length counts type .. CRC; the CRC covers type .. payload. Type 0x16
+ * carries the same 16 x 11-bit channels, 0x14 the link statistics.
+ *
+ * Both pack channels LSB first, 172 .. 1811 for 988 .. 2012 us (992 =
+ * center), so one decoder serves both. RcInput_feed() takes whole UART
+ * reads like UBXParser_feed(): a frame that lies entirely in the buffer is
+ * checked and returned in place, only a frame split across reads is
+ * assembled in the parser's buffer. SBUS frames come out as a channels
+ * frame of 23 bytes (channels + flags).
+ *
+ * RcConfig maps channels onto the NAPacket sticks (throttle, roll, pitch,
+ * yaw: -1000 .. 1000, throttle 0 .. 1000 unless centered) and a switch
+ * onto MODE_AUTO, and switches the CRSF telemetry downlink (CrsfTelemetry).
+ * Stored as a config blob (RC_CONFIG_KEY).
+ *
+ * Plain struct, no hardware access.
+ *
+ * @file RcInput.h
+ */
+
+// Receiver RX GPIO on UART1 (-1 = no receiver). UART1 is also the Copter
+// ESC telemetry port: only one of them can be wired.
+#ifndef RC_INPUT_PIN
+#define RC_INPUT_PIN            -1
+#endif
+
+// UART1 TX to the receiver's RX for the CRSF telemetry downlink (-1 = none)
+#ifndef RC_TELEMETRY_PIN
+#define RC_TELEMETRY_PIN        -1
+#endif
+
+#define RC_CONFIG_KEY           "cfg_rc"
+#define RC_MAX_CHANNELS         16
+#define RC_CHANNEL_NONE         0xFF
+#define RC_AXES                 4       // Throttle, roll, pitch, yaw
+
+#define RC_SBUS_BAUD            100000
+#define RC_SBUS_FRAME_LEN       25
+#define RC_SBUS_HEADER          0x0F
+#define RC_SBUS_FLAG_FRAME_LOST 0x04
+#define RC_SBUS_FLAG_FAILSAFE   0x08
+
+#define RC_CRSF_BAUD            420000
+#define RC_CRSF_ADDR_FC         0xC8    // Flight controller
+#define RC_CRSF_ADDR_TX         0xEE    // Sent by some receivers instead
+#define RC_CRSF_MAX_FRAME       64      // Address + length + at most 62
+#define RC_CRSF_TYPE_LINK       0x14
+#define RC_CRSF_TYPE_CHANNELS   0x16
+#define RC_CRSF_LINK_LEN        10
+
+#define RC_CHANNELS_LEN         22      // 16 x 11 bits
+#define RC_TICKS_MIN            172     // 988 us
+#define RC_TICKS_CENTER         992     // 1500 us
+#define RC_TICKS_MAX            1811    // 2012 us
+#define RC_STICK_MAX            1000
+
+typedef enum {
+    RC_PROTOCOL_SBUS = 0,
+    RC_PROTOCOL_CRSF,
+    RC_PROTOCOL_COUNT
+} RcProtocol;
+
+// RcChannels.flags
+#define RC_FLAG_FRAME_LOST      0x01    // SBUS: a frame was missed on the air
+#define RC_FLAG_FAILSAFE        0x02    // Receiver lost the transmitter
+
+/**
+ * One complete, checked frame
+ */
+typedef struct {
+    uint8_t type;               // RC_CRSF_TYPE_* (SBUS: RC_CRSF_TYPE_CHANNELS)
+    uint8_t length;             // Payload bytes
+    const uint8_t* payload;     // NULL = no frame; valid until the next feed
+} RcFrame;
+
+/**
+ * Channel values of one frame
+ */
+typedef struct {
+    uint16_t channels[RC_MAX_CHANNELS];     // Raw 11-bit ticks
+    uint8_t flags;              // RC_FLAG_*
+} RcChannels;
+
+/**
+ * CRSF link statistics (uplink: transmitter -> receiver)
+ */
+typedef struct {
+    int16_t rssiDbm;            // Better antenna
+    uint8_t lq;                 // Link quality, % of packets received
+    int8_t snr;                 // dB
+} RcLink;
+
+typedef struct {
+    uint8_t protocol;           // RcProtocol
+    uint8_t index;              // Bytes of a split frame in buffer (0 = idle)
+    uint8_t length;             // Whole frame length (0 = not known yet)
+    uint8_t buffer[RC_CRSF_MAX_FRAME];
+
+    // Statistics
+    uint32_t frames;
+    uint32_t crcErrors;         // CRSF CRC / SBUS footer mismatch
+    uint32_t badLength;         // CRSF length out of range
+} RcParser;
+
+/**
+ * Channel mapping (stored as RC_CONFIG_KEY)
+ */
+typedef struct {
+    uint8_t enabled;            // Take control from the receiver
+    uint8_t protocol;           // RcProtocol (applied at boot)
+    uint8_t axes[RC_AXES];      // Channel of throttle, roll, pitch, yaw
+    uint8_t reverse;            // Bit per axis
+    uint8_t autoChannel;        // Switch high = MODE_AUTO (RC_CHANNEL_NONE = off)
+    uint8_t throttleCentered;   // Throttle -1000 .. 1000 (Rover / Sub reverse)
+    uint8_t telemetry;          // CRSF: answer telemetry slots (RC_TELEMETRY_PIN)
+} RcConfig;
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+/**
+ * Reset the parser (statistics included)
+ */
+void RcInput_init(RcParser* parser, RcProtocol protocol);
+
+/**
+ * Consume bytes up to and including the next complete frame
+ * @param parser Parser state
+ * @param data Received bytes
+ * @param len Number of bytes
+ * @param frame Output; payload is NULL if no frame completed
+ * @return Bytes consumed (call again with the rest while it is < len)
+ */
+size_t RcInput_feed(RcParser* parser, const uint8_t* data, size_t len, RcFrame* frame);
+
+/**
+ * Decode a channels frame (CRSF 0x16, or SBUS with its flags byte)
+ * @return false for other frames
+ */
+bool RcInput_decodeChannels(const RcFrame* frame, RcChannels* out);
+
+/**
+ * Decode a CRSF link statistics frame
+ * @return false for other frames
+ */
+bool RcInput_decodeLink(const RcFrame* frame, RcLink* out);
+
+/**
+ * CRC-8 of CRSF (DVB-S2, poly 0xD5, init 0)
+ */
+uint8_t RcInput_crc8(const uint8_t* data, size_t len);
+
+/**
+ * Build a frame (tests, simulators)
+ * @param channels 16 raw channel values (11 bits)
+ * @param flags SBUS flags byte (ignored for CRSF)
+ * @param out Output buffer, RC_SBUS_FRAME_LEN / 26 bytes
+ * @return Bytes written, 0 if outSize is too small
+ */
+size_t RcInput_buildChannels(RcProtocol protocol, const uint16_t* channels, uint8_t flags,
+                             uint8_t* out, size_t outSize);
+
+// ============================================================================
+// Mapping
+// ============================================================================
+
+/**
+ * AETR order on channels 1-4 (throttle on 3), auto on channel 5,
+ * telemetry on
+ */
+void RcInput_defaultConfig(RcConfig* config);
+
+/**
+ * Clamp a loaded / edited config into range
+ */
+void RcInput_sanitize(RcConfig* config);
+
+/**
+ * Sticks of a frame
+ * @param sticks Output: throttle, roll, pitch, yaw (NAPacket scale)
+ * @return true if the auto switch is high
+ */
+bool RcInput_toSticks(const RcConfig* config, const RcChannels* channels,
+                      int16_t sticks[RC_AXES]);
+
+/**
+ * Protocol name ("sbus", "crsf")
+ */
+const char* RcInput_protocolName(RcProtocol protocol);
+
+/**
+ * Parse a protocol name
+ * @return false if unknown
+ */
+bool RcInput_parseProtocol(const char* name, RcProtocol* protocol);
+
+#endif // RC_INPUT_H
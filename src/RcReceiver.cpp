@@ -0,0 +1,184 @@
+#include "RcReceiver.h"
+#include "MemoryProfiler.h"
+
+RcReceiver::RcReceiver()
+    : _events(nullptr), _task(nullptr), _telemetryOn(false), _haveSnap(false), _slotUs(0) {
+    _mux = portMUX_INITIALIZER_UNLOCKED;
+    memset(&_stats, 0, sizeof(_stats));
+    memset(&_channels, 0, sizeof(_channels));
+    memset(&_watch, 0, sizeof(_watch));
+    RcInput_init(&_parser, RC_PROTOCOL_CRSF);
+    TelemetryStreams_defaultConfig(&_streamsConfig);
+    TelemetryStreams_init(&_downlink);
+}
+
+bool RcReceiver::setup(RcProtocol protocol, uint8_t priority, uint8_t core) {
+    RcInput_init(&_parser, protocol);
+
+    uart_config_t config = {};
+    if (protocol == RC_PROTOCOL_SBUS) {
+        config.baud_rate = RC_SBUS_BAUD;
+        config.parity = UART_PARITY_EVEN;
+        config.stop_bits = UART_STOP_BITS_2;
+    } else {
+        config.baud_rate = RC_CRSF_BAUD;
+        config.parity = UART_PARITY_DISABLE;
+        config.stop_bits = UART_STOP_BITS_1;
+    }
+    config.data_bits = UART_DATA_8_BITS;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_APB;
+
+    if (uart_driver_install(RC_UART, RC_RX_BUFFER, 0, RC_EVENT_QUEUE, &_events, 0) != ESP_OK ||
+        uart_param_config(RC_UART, &config) != ESP_OK ||
+        uart_set_pin(RC_UART, RC_TELEMETRY_PIN >= 0 ? RC_TELEMETRY_PIN : UART_PIN_NO_CHANGE,
+                     RC_INPUT_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) {
+        Serial.println("[RC] UART setup failed");
+        return false;
+    }
+    uart_set_line_inverse(RC_UART, protocol == RC_PROTOCOL_SBUS ? UART_SIGNAL_RXD_INV
+                                                                : UART_SIGNAL_INV_DISABLE);
+    uart_set_rx_timeout(RC_UART, RC_RX_TIMEOUT_SYMBOLS);
+
+    MemoryProfiler_setTaskStackSize("rc", RC_TASK_STACK);
+    if (xTaskCreatePinnedToCore(taskEntry, "rc", RC_TASK_STACK, this, priority, &_task, core) != pdPASS) {
+        Serial.println("[RC] Task create failed");
+        return false;
+    }
+    return true;
+}
+
+void RcReceiver::setTelemetryConfig(const TelemetryStreamsConfig& config, bool enabled) {
+    portENTER_CRITICAL(&_mux);
+    _streamsConfig = config;
+    _telemetryOn = enabled;
+    portEXIT_CRITICAL(&_mux);
+}
+
+RcReceiverStats RcReceiver::getStats(RcChannels* channels) {
+    portENTER_CRITICAL(&_mux);
+    RcReceiverStats copy = _stats;
+    if (channels) *channels = _channels;
+    portEXIT_CRITICAL(&_mux);
+    return copy;
+}
+
+// ============================================================================
+// Reader Task
+// ============================================================================
+
+void RcReceiver::handle(const uint8_t* data, size_t len, HAL_Micros rxUs) {
+    size_t off = 0;
+    while (off < len) {
+        RcFrame frame;
+        off += RcInput_feed(&_parser, &data[off], len - off, &frame);
+        if (!frame.payload) continue;
+
+        RcSample sample;
+        RcLink link;
+        if (RcInput_decodeChannels(&frame, &sample.channels)) {
+            portENTER_CRITICAL(&_mux);
+            sample.sequence = _stats.frames++;
+            if (sample.channels.flags & RC_FLAG_FAILSAFE) _stats.failsafeFrames++;
+            if (sample.channels.flags & RC_FLAG_FRAME_LOST) _stats.lostFrames++;
+            _stats.lastFrameUs = rxUs;
+            _channels = sample.channels;
+            portEXIT_CRITICAL(&_mux);
+            sample.rxUs = rxUs;
+            _ring.push(sample);
+            if (RC_TELEMETRY_PIN >= 0 && _parser.protocol == RC_PROTOCOL_CRSF)
+                sendTelemetry(rxUs);
+        } else if (RcInput_decodeLink(&frame, &link)) {
+            portENTER_CRITICAL(&_mux);
+            _stats.link = link;
+            _stats.haveLink = true;
+            portEXIT_CRITICAL(&_mux);
+        }
+    }
+    portENTER_CRITICAL(&_mux);
+    _stats.crcErrors = _parser.crcErrors;
+    _stats.badLength = _parser.badLength;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void RcReceiver::sendTelemetry(HAL_Micros rxUs) {
+    TelemetrySnapshot snap;
+    while (_snapshots.readNext(snap)) {
+        TelemetryStreams_watch(&_downlink, &_watch, &snap);
+        _snap = snap;
+        _haveSnap = true;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    TelemetryStreamsConfig config = _streamsConfig;
+    bool on = _telemetryOn;
+    portEXIT_CRITICAL(&_mux);
+    if (!on || !_haveSnap) {
+        _slotUs = rxUs;
+        return;
+    }
+
+    // Whole ms only; the rest carries over to the next slot
+    if (_slotUs == 0) _slotUs = rxUs;
+    HAL_Micros dtMs = (rxUs - _slotUs) / 1000;
+    if (dtMs > UINT16_MAX) {
+        dtMs = UINT16_MAX;
+        _slotUs = rxUs;
+    } else {
+        _slotUs += dtMs * 1000;
+    }
+    TelemetryStreams_tick(&_downlink, &config, (uint16_t)dtMs);
+
+    TelemetryStreamId id = TelemetryStreams_next(&_downlink, &config, CRSF_TELEMETRY_STREAMS);
+    if (id == TELEMETRY_STREAM_COUNT) return;
+    uint8_t frame[CRSF_TELEMETRY_MAX_FRAME];
+    size_t len = CrsfTelemetry_encode(id, &_snap, frame, sizeof(frame));
+    // No TX ring: a frame this short goes straight into the empty FIFO
+    bool sent = len && uart_write_bytes(RC_UART, frame, len) == (int)len;
+    portENTER_CRITICAL(&_mux);
+    if (sent) _stats.telemetryFrames++;
+    else _stats.telemetryDropped++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void RcReceiver::run() {
+    uint8_t buf[RC_READ_CHUNK];
+    uart_event_t event;
+    for (;;) {
+        if (xQueueReceive(_events, &event, portMAX_DELAY) != pdTRUE) continue;
+        // Stamped before the read: the frame ended RC_RX_TIMEOUT_SYMBOLS ago
+        HAL_Micros rxUs = HAL_Now();
+        switch (event.type) {
+            case UART_DATA: {
+                size_t left = event.size;
+                while (left > 0) {
+                    int n = uart_read_bytes(RC_UART, buf, left > sizeof(buf) ? sizeof(buf) : left, 0);
+                    if (n <= 0) break;
+                    handle(buf, (size_t)n, rxUs);
+                    left -= (size_t)n;
+                }
+                break;
+            }
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                uart_flush_input(RC_UART);
+                xQueueReset(_events);
+                portENTER_CRITICAL(&_mux);
+                _stats.overflows++;
+                portEXIT_CRITICAL(&_mux);
+                break;
+            case UART_FRAME_ERR:
+            case UART_PARITY_ERR:
+                portENTER_CRITICAL(&_mux);
+                _stats.lineErrors++;
+                portEXIT_CRITICAL(&_mux);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void RcReceiver::taskEntry(void* arg) {
+    static_cast<RcReceiver*>(arg)->run();
+}
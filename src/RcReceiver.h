@@ -0,0 +1,144 @@
+#ifndef RC_RECEIVER_H
+#define RC_RECEIVER_H
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "HAL.h"
+#include "CrsfTelemetry.h"
+#include "RcInput.h"
+#include "SPSCRing.h"
+#include "TelemetryStreams.h"
+
+/**
+ * RcReceiver - SBUS / CRSF receiver driver on UART1
+ *
+ * Hardware:
+ * - UART1 RX on RC_INPUT_PIN (build flag, -1 = no receiver)
+ * - SBUS: 100000 baud 8E2, line inverted in the UART (no inverter needed)
+ * - CRSF (ExpressLRS, TBS Crossfire): 420000 baud 8N1; UART1 TX on
+ *   RC_TELEMETRY_PIN (-1 = RX only) to the receiver's RX for telemetry
+ *
+ * Operation:
+ * - The ESP-IDF UART driver fills its ring from the FIFO in the UART
+ *   interrupt and posts an event when RC_RX_TIMEOUT_SYMBOLS of idle line
+ *   follow a burst, i.e. at the end of every frame (the ESP32 UART has no
+ *   receive DMA in the driver; the FIFO interrupt is the same thing for
+ *   frames this short)
+ * - The reader task blocks on that event queue, so it wakes once per
+ *   frame, stamps HAL_Now(), reads the burst and decodes it in place
+ *   with RcInput_feed()
+ * - Decoded channels go to the control task through an SPSC ring, as the
+ *   radio frames do; nothing on this path touches Wi-Fi
+ * - FIFO / ring overflows flush the UART and are counted
+ * - CRSF telemetry: the receiver listens for one frame after each
+ *   channels frame. The reader task answers right after decoding it,
+ *   with the one stream TelemetryStreams_next() picks (its own credit,
+ *   ticked by the time between slots, rates from the telemetry streams
+ *   config), encoded from the newest snapshot into a stack buffer
+ */
+
+#define RC_UART                 UART_NUM_1
+#define RC_RX_BUFFER            256     // Driver ring (at least the FIFO, 128)
+#define RC_EVENT_QUEUE          8
+#define RC_RX_TIMEOUT_SYMBOLS   3       // SBUS 360 us, CRSF 71 us after the last byte
+#define RC_READ_CHUNK           128
+#define RC_TASK_STACK           3072    // bytes
+
+/**
+ * Channels of one frame as handed to the control task
+ */
+struct RcSample {
+    RcChannels channels;
+    HAL_Micros rxUs;            // End of the frame (UART event)
+    uint32_t sequence;          // Frames decoded before this one
+};
+
+/**
+ * Driver statistics
+ */
+struct RcReceiverStats {
+    uint32_t frames;            // Channel frames
+    uint32_t crcErrors;
+    uint32_t badLength;
+    uint32_t failsafeFrames;    // Receiver reported failsafe
+    uint32_t lostFrames;        // SBUS frame-lost flag
+    uint32_t overflows;         // UART FIFO / driver ring overflows
+    uint32_t lineErrors;        // Framing / parity errors
+    HAL_Micros lastFrameUs;     // 0 = none yet
+    uint32_t telemetryFrames;   // CRSF telemetry frames written
+    uint32_t telemetryDropped;  // Not fully written into the TX FIFO
+    RcLink link;                // CRSF link statistics (haveLink)
+    bool haveLink;
+};
+
+class RcReceiver {
+public:
+    RcReceiver();
+
+    /**
+     * Install the UART driver and start the reader task
+     * @param protocol SBUS or CRSF
+     * @param priority FreeRTOS priority of the reader task
+     * @param core Core to pin the reader task to
+     * @return false if the UART or the task could not be set up
+     */
+    bool setup(RcProtocol protocol, uint8_t priority, uint8_t core);
+
+    /**
+     * Newest frame since the last call (control task)
+     * @return false if none arrived
+     */
+    bool readLatest(RcSample& sample) { return _ring.readLatest(sample); }
+
+    /**
+     * Newest channels and statistics
+     */
+    RcReceiverStats getStats(RcChannels* channels = nullptr);
+
+    RcProtocol getProtocol() const { return (RcProtocol)_parser.protocol; }
+
+    /**
+     * Newest telemetry for the downlink (telemetry task)
+     */
+    void setTelemetry(const TelemetrySnapshot& snap) { _snapshots.push(snap); }
+
+    /**
+     * Stream rates and priorities, and whether to answer telemetry slots
+     */
+    void setTelemetryConfig(const TelemetryStreamsConfig& config, bool enabled);
+
+    /**
+     * Downlink stream counters (reader task state, read without locking)
+     */
+    const TelemetryStreams& getDownlink() const { return _downlink; }
+
+private:
+    RcParser _parser;           // Reader task only
+    SPSCRing<RcSample, 4> _ring;
+    QueueHandle_t _events;
+    TaskHandle_t _task;
+
+    portMUX_TYPE _mux;
+    RcReceiverStats _stats;     // Guarded by _mux
+    RcChannels _channels;       // Guarded by _mux
+    TelemetryStreamsConfig _streamsConfig;  // Guarded by _mux
+    bool _telemetryOn;          // Guarded by _mux
+
+    // Downlink, reader task only
+    SPSCRing<TelemetrySnapshot, 2> _snapshots;
+    TelemetryStreams _downlink;
+    TelemetryEventWatch _watch;
+    TelemetrySnapshot _snap;
+    bool _haveSnap;
+    HAL_Micros _slotUs;         // Time the downlink credit was ticked to
+
+    void handle(const uint8_t* data, size_t len, HAL_Micros rxUs);
+    void sendTelemetry(HAL_Micros rxUs);
+    void run();
+    static void taskEntry(void* arg);
+};
+
+#endif // RC_RECEIVER_H
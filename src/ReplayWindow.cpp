@@ -0,0 +1,81 @@
+#include "ReplayWindow.h"
+#include <string.h>
+
+/**
+ * ReplayWindow - Implementation
+ *
+ * Distances use uint32_t wraparound: seq - highest below 2^31 is ahead.
+ *
+ * @file ReplayWindow.cpp
+ */
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static bool is_ahead(const ReplayWindow* win, uint32_t seq) {
+    uint32_t diff = seq - win->highest;
+    return diff != 0 && diff < 0x80000000UL;
+}
+
+static bool resync_due(const ReplayWindow* win, uint32_t nowMs) {
+    return nowMs - win->lastAcceptMs >= REPLAY_RESYNC_MS;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void ReplayWindow_init(ReplayWindow* win) {
+    memset(win, 0, sizeof(*win));
+}
+
+ReplayStatus ReplayWindow_check(ReplayWindow* win, uint32_t seq, uint32_t nowMs) {
+    if (!win->haveSeq || is_ahead(win, seq) || resync_due(win, nowMs)) {
+        return REPLAY_OK;
+    }
+
+    uint32_t back = win->highest - seq;
+    if (back >= REPLAY_WINDOW_SIZE) {
+        win->stats.tooOld++;
+        return REPLAY_TOO_OLD;
+    }
+    if (win->bitmap & (1ULL << back)) {
+        win->stats.duplicates++;
+        return REPLAY_DUPLICATE;
+    }
+    return REPLAY_OK;
+}
+
+void ReplayWindow_accept(ReplayWindow* win, uint32_t seq, uint32_t nowMs) {
+    if (!win->haveSeq) {
+        win->haveSeq = true;
+        win->highest = seq;
+        win->bitmap = 1;
+    } else if (is_ahead(win, seq)) {
+        uint32_t diff = seq - win->highest;
+        win->bitmap = diff >= REPLAY_WINDOW_SIZE ? 1 : (win->bitmap << diff) | 1;
+        win->stats.lost += diff - 1;
+        win->highest = seq;
+    } else {
+        uint32_t back = win->highest - seq;
+        uint64_t bit = back < REPLAY_WINDOW_SIZE ? 1ULL << back : 0;
+        if (bit && !resync_due(win, nowMs)) {
+            // Late arrival: it was counted lost when the window moved past it
+            if (!(win->bitmap & bit)) {
+                win->bitmap |= bit;
+                win->stats.reordered++;
+                if (win->stats.lost)
+                    win->stats.lost--;
+            }
+        } else {
+            // Sender restarted its counter: re-anchor on this frame
+            win->highest = seq;
+            win->bitmap = 1;
+            win->stats.resyncs++;
+        }
+    }
+
+    win->stats.accepted++;
+    win->lastAcceptMs = nowMs;
+}
@@ -0,0 +1,88 @@
+#ifndef REPLAY_WINDOW_H
+#define REPLAY_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * ReplayWindow - Sliding-window sequence number filter (IPsec style)
+ *
+ * Tracks the highest accepted sequenceNumber and a 64-bit bitmap of the
+ * frames just below it:
+ * - check() runs BEFORE decryption / HMAC: duplicates and frames older
+ *   than the window are rejected without spending crypto cycles
+ * - accept() runs only AFTER the frame authenticated, so a forged
+ *   sequence number can never move the window
+ * - Gaps count as lost; a late frame inside the window is accepted once
+ *   and moves its number from lost to reordered
+ *
+ * A controller reboot restarts its counter; when nothing has been
+ * accepted for REPLAY_RESYNC_MS the next authenticated frame re-anchors
+ * the window. A new session (key exchange) should call init().
+ *
+ * Note: CTR+HMAC frames do not authenticate sequenceNumber (the HMAC
+ * covers the control payload only), so there the window stops
+ * duplicates and stale radio frames, not a deliberate replay. AEAD
+ * frames carry it in the AAD.
+ *
+ * @file ReplayWindow.h
+ */
+
+#define REPLAY_WINDOW_SIZE  64      // Bits in the bitmap
+#define REPLAY_RESYNC_MS    1000    // Silence after which the window re-anchors
+
+/**
+ * Status codes for replay checks
+ */
+typedef enum {
+    REPLAY_OK = 0,          // New frame (or resync allowed)
+    REPLAY_DUPLICATE = 1,   // Already accepted
+    REPLAY_TOO_OLD = 2      // Below the window
+} ReplayStatus;
+
+/**
+ * Replay / loss counters
+ */
+typedef struct {
+    uint32_t accepted;
+    uint32_t lost;          // Numbers skipped and never seen
+    uint32_t reordered;     // Accepted late, inside the window
+    uint32_t duplicates;
+    uint32_t tooOld;
+    uint32_t resyncs;
+} ReplayStats;
+
+/**
+ * Window state (one per sender / session)
+ */
+typedef struct {
+    bool haveSeq;
+    uint32_t highest;       // Highest accepted sequence number
+    uint64_t bitmap;        // Bit i set: (highest - i) accepted
+    uint32_t lastAcceptMs;
+    ReplayStats stats;
+} ReplayWindow;
+
+/**
+ * Reset window and counters (new session)
+ */
+void ReplayWindow_init(ReplayWindow* win);
+
+/**
+ * Check a sequence number before authentication (counts rejects only)
+ * @param win Window state
+ * @param seq Received sequence number
+ * @param nowMs Current time (millis)
+ * @return REPLAY_OK if the frame is worth authenticating
+ */
+ReplayStatus ReplayWindow_check(ReplayWindow* win, uint32_t seq, uint32_t nowMs);
+
+/**
+ * Record an authenticated frame (call only after check() returned OK)
+ * @param win Window state
+ * @param seq Sequence number of the authenticated frame
+ * @param nowMs Current time (millis)
+ */
+void ReplayWindow_accept(ReplayWindow* win, uint32_t seq, uint32_t nowMs);
+
+#endif // REPLAY_WINDOW_H
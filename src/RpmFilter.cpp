@@ -0,0 +1,79 @@
+#include "RpmFilter.h"
+#include <string.h>
+
+/**
+ * RpmFilter - Implementation
+ *
+ * @file RpmFilter.cpp
+ */
+
+#define LIMIT_FRACTION  0.45f       // Highest notch, as a fraction of the sample rate
+
+void RpmFilter_defaultConfig(RpmFilterConfig* config) {
+    config->enabled = false;
+    config->harmonics = 3;
+    config->minHz = 80.0f;
+    config->q = 5.0f;
+    config->motorPoles = 14;
+}
+
+void RpmFilter_sanitize(RpmFilterConfig* config, float sampleHz) {
+    if (config->harmonics < 1)
+        config->harmonics = 1;
+    else if (config->harmonics > RPM_FILTER_MAX_HARMONICS)
+        config->harmonics = RPM_FILTER_MAX_HARMONICS;
+    float limit = LIMIT_FRACTION * sampleHz;
+    if (!(config->minHz > 0.0f))
+        config->minHz = 0.0f;       // Also NaN
+    else if (config->minHz > limit)
+        config->minHz = limit;
+    if (!(config->q >= RPM_FILTER_MIN_Q))
+        config->q = RPM_FILTER_MIN_Q;
+    else if (config->q > RPM_FILTER_MAX_Q)
+        config->q = RPM_FILTER_MAX_Q;
+    // Even and at least one pole pair
+    if (config->motorPoles < 2) config->motorPoles = 2;
+    config->motorPoles &= (uint8_t)~1u;
+}
+
+float RpmFilter_erpmToHz(uint32_t erpm, uint8_t motorPoles) {
+    if (motorPoles < 2) return 0.0f;
+    return (float)erpm / (float)(motorPoles / 2) / 60.0f;
+}
+
+void RpmFilter_init(RpmFilter* f, const RpmFilterConfig* config, uint8_t motorCount,
+                    float sampleHz) {
+    memset(f, 0, sizeof(*f));
+    f->config = *config;
+    RpmFilter_sanitize(&f->config, sampleHz);
+    f->sampleHz = sampleHz;
+    f->motorCount = motorCount > RPM_FILTER_MAX_MOTORS ? RPM_FILTER_MAX_MOTORS : motorCount;
+
+    BiquadCoefs pass;
+    Biquad_passthrough(&pass);
+    for (uint8_t m = 0; m < f->motorCount; m++) {
+        BiquadCascade_init(&f->notches[m], 3);
+        for (uint8_t h = 0; h < f->config.harmonics; h++)
+            BiquadCascade_addStage(&f->notches[m], &pass);
+    }
+}
+
+void RpmFilter_update(RpmFilter* f, const float* motorHz) {
+    float limit = LIMIT_FRACTION * f->sampleHz;
+    for (uint8_t m = 0; m < f->motorCount; m++) {
+        f->motorHz[m] = motorHz[m];
+        for (uint8_t h = 0; h < f->config.harmonics; h++) {
+            float hz = motorHz[m] * (float)(h + 1);
+            BiquadCoefs c;
+            if (hz < f->config.minHz || hz > limit ||
+                !Biquad_notch(&c, hz, f->sampleHz, f->config.q))
+                Biquad_passthrough(&c);
+            BiquadCascade_setStage(&f->notches[m], h, &c);
+        }
+    }
+}
+
+void RpmFilter_applyBlock(RpmFilter* f, float* frames, size_t count) {
+    for (uint8_t m = 0; m < f->motorCount; m++)
+        BiquadCascade_applyBlock(&f->notches[m], frames, count);
+}
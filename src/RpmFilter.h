@@ -0,0 +1,80 @@
+#ifndef RPM_FILTER_H
+#define RPM_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "BiquadFilter.h"
+
+/**
+ * RpmFilter - Gyro notches on each motor's rotation harmonics
+ *
+ * With ESC RPM feedback the noise frequencies are measured, not
+ * searched for: motor m puts its energy at h * rpm_m / 60 Hz for the
+ * first few harmonics h. One narrow notch per motor and harmonic sits
+ * exactly there, moved every control tick, so the rate loop gets the
+ * noise removed with the least delay of any gyro filter (narrow notches
+ * add almost no phase lag below them).
+ *
+ * Each motor is a BiquadCascade of up to RPM_FILTER_MAX_HARMONICS
+ * notches over the three gyro axes; updates replace coefficients and
+ * keep the state (BiquadCascade_setStage). A harmonic below minHz or
+ * above 0.45 * sampleHz passes through.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file RpmFilter.h
+ */
+
+#define RPM_FILTER_MAX_MOTORS       4
+#define RPM_FILTER_MAX_HARMONICS    3
+#define RPM_FILTER_MIN_Q            2.0f
+#define RPM_FILTER_MAX_Q            20.0f
+#define RPM_FILTER_CONFIG_KEY       "cfg_rpm_filt"
+
+typedef struct {
+    bool enabled;
+    uint8_t harmonics;          // 1..RPM_FILTER_MAX_HARMONICS
+    float minHz;                // Lowest notch (idle)
+    float q;
+    uint8_t motorPoles;         // Magnets, for eRPM -> RPM
+} RpmFilterConfig;
+
+typedef struct {
+    RpmFilterConfig config;
+    float sampleHz;
+    uint8_t motorCount;
+    float motorHz[RPM_FILTER_MAX_MOTORS];      // Last update
+    BiquadCascade notches[RPM_FILTER_MAX_MOTORS];
+} RpmFilter;
+
+/**
+ * Default: off, 3 harmonics, 80 Hz floor, Q 5, 14 poles
+ */
+void RpmFilter_defaultConfig(RpmFilterConfig* config);
+
+void RpmFilter_sanitize(RpmFilterConfig* config, float sampleHz);
+
+/**
+ * Mechanical rotation frequency from electrical RPM
+ */
+float RpmFilter_erpmToHz(uint32_t erpm, uint8_t motorPoles);
+
+/**
+ * Set up passthrough notches for motorCount motors over 3 axes
+ */
+void RpmFilter_init(RpmFilter* f, const RpmFilterConfig* config, uint8_t motorCount,
+                    float sampleHz);
+
+/**
+ * Move the notches to the motors' rotation frequencies
+ * @param motorHz Per motor, from RpmFilter_erpmToHz
+ */
+void RpmFilter_update(RpmFilter* f, const float* motorHz);
+
+/**
+ * Filter frames of x y z in place
+ */
+void RpmFilter_applyBlock(RpmFilter* f, float* frames, size_t count);
+
+#endif // RPM_FILTER_H
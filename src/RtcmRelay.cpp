@@ -0,0 +1,172 @@
+#include "RtcmRelay.h"
+#include <string.h>
+
+/**
+ * RtcmRelay - Implementation
+ *
+ * The framer buffers from a preamble on. A candidate that fails (reserved
+ * bits set, bad CRC) is dropped up to the next preamble inside the
+ * buffer, not up to its own claimed end: a 0xD3 inside a UBX frame must
+ * not swallow the real RTCM frames behind it.
+ *
+ * @file RtcmRelay.cpp
+ */
+
+#define CRC24Q_POLY 0x1864CFB
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static uint16_t payloadLength(const uint8_t* frame) {
+    return (uint16_t)(((frame[1] & 0x03) << 8) | frame[2]);
+}
+
+/**
+ * Drop the buffered candidate up to the next preamble after its first byte
+ */
+static void resync(RtcmFramer* f) {
+    uint16_t k = 1;
+    while (k < f->len && f->buf[k] != RTCM_PREAMBLE) k++;
+    memmove(f->buf, f->buf + k, f->len - k);
+    f->len -= k;
+}
+
+/**
+ * Resolve what is buffered as far as it goes
+ * @return Length of a valid frame at buf[0], 0 if more bytes are needed
+ */
+static uint16_t settle(RtcmFramer* f) {
+    while (f->len >= RTCM_HEADER) {
+        if (f->buf[1] & 0xFC) {
+            resync(f);
+            continue;
+        }
+        uint16_t need = RTCM_HEADER + payloadLength(f->buf) + RTCM_CRC_SIZE;
+        if (f->len < need) return 0;
+        if (Rtcm_frameValid(f->buf, need)) return need;
+        f->crcErrors++;
+        resync(f);
+    }
+    return 0;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+uint32_t Rtcm_crc24q(const uint8_t* data, size_t len) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint32_t)data[i] << 16;
+        for (int bit = 0; bit < 8; bit++) {
+            crc <<= 1;
+            if (crc & 0x1000000) crc ^= CRC24Q_POLY;
+        }
+    }
+    return crc & 0xFFFFFF;
+}
+
+bool Rtcm_frameValid(const uint8_t* frame, size_t len) {
+    if (!frame || len < RTCM_HEADER + RTCM_CRC_SIZE) return false;
+    if (frame[0] != RTCM_PREAMBLE || (frame[1] & 0xFC)) return false;
+    if (RTCM_HEADER + payloadLength(frame) + RTCM_CRC_SIZE != len) return false;
+    const uint8_t* c = frame + len - RTCM_CRC_SIZE;
+    uint32_t crc = ((uint32_t)c[0] << 16) | ((uint32_t)c[1] << 8) | c[2];
+    return Rtcm_crc24q(frame, len - RTCM_CRC_SIZE) == crc;
+}
+
+uint16_t Rtcm_messageType(const uint8_t* frame) {
+    if (payloadLength(frame) < 2) return 0;
+    return (uint16_t)((frame[3] << 4) | (frame[4] >> 4));
+}
+
+void RtcmFramer_init(RtcmFramer* f) {
+    memset(f, 0, sizeof(*f));
+}
+
+size_t RtcmFramer_feed(RtcmFramer* f, const uint8_t* data, size_t len,
+                       const uint8_t** frame, uint16_t* frameLen) {
+    *frame = NULL;
+    if (f->taken) {
+        // Bytes behind the last frame may already hold the next one
+        memmove(f->buf, f->buf + f->taken, f->len - f->taken);
+        f->len -= f->taken;
+        f->taken = 0;
+        if (f->len && f->buf[0] != RTCM_PREAMBLE) resync(f);
+        uint16_t n = settle(f);
+        if (n) {
+            f->frames++;
+            f->taken = n;
+            *frame = f->buf;
+            *frameLen = n;
+            return 0;
+        }
+    }
+
+    size_t i = 0;
+    while (i < len) {
+        uint8_t b = data[i++];
+        if (f->len == 0 && b != RTCM_PREAMBLE) continue;
+        f->buf[f->len++] = b;
+        uint16_t n = settle(f);
+        if (n) {
+            f->frames++;
+            f->taken = n;
+            *frame = f->buf;
+            *frameLen = n;
+            return i;
+        }
+    }
+    return i;
+}
+
+uint8_t RtcmRelay_fragmentCount(size_t len) {
+    return (uint8_t)((len + RTCM_FRAGMENT_DATA - 1) / RTCM_FRAGMENT_DATA);
+}
+
+void RtcmReassembler_init(RtcmReassembler* r) {
+    memset(r, 0, sizeof(*r));
+}
+
+bool RtcmReassembler_add(RtcmReassembler* r, uint8_t seq, uint8_t index, uint8_t count,
+                         const uint8_t* data, size_t len,
+                         const uint8_t** frame, uint16_t* frameLen) {
+    *frame = NULL;
+    if (count == 0 || count > RTCM_MAX_FRAGMENTS || index >= count || len == 0 ||
+        len > RTCM_FRAGMENT_DATA) {
+        r->malformed++;
+        return false;
+    }
+
+    if (index == 0) {
+        if (r->next) r->lost++;
+        r->seq = seq;
+        r->count = count;
+        r->len = 0;
+    } else if (r->next == 0 || seq != r->seq || count != r->count || index != r->next) {
+        // The rest of an already dropped frame, or a gap in this one
+        if (r->next) r->lost++;
+        r->next = 0;
+        return false;
+    }
+    if (r->len + len > RTCM_MAX_FRAME) {
+        r->malformed++;
+        r->next = 0;
+        return false;
+    }
+    memcpy(r->buf + r->len, data, len);
+    r->len += (uint16_t)len;
+    r->next = index + 1;
+    if (r->next < r->count) return false;
+
+    r->next = 0;
+    if (!Rtcm_frameValid(r->buf, r->len)) {
+        r->crcErrors++;
+        return false;
+    }
+    r->frames++;
+    *frame = r->buf;
+    *frameLen = r->len;
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef RTCM_RELAY_H
+#define RTCM_RELAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * RtcmRelay - RTCM3 correction framing, fragmentation and reassembly
+ *
+ * RTK needs the base receiver's corrections at the rover receiver within
+ * a second or so. They travel as RTCM3 frames:
+ *
+ *   0xD3 | 6 reserved bits + 10-bit length | payload | CRC-24Q (3)
+ *
+ * at most RTCM_MAX_FRAME bytes. A frame is cut into RTCM_FRAGMENT_DATA
+ * byte fragments (one radio frame each, see NARtcmFragment.h) and put
+ * back together on the rover:
+ *
+ * - RtcmFramer finds the frames in a byte stream (the base receiver's
+ *   UART output, interleaved with UBX) and checks their CRC
+ * - RtcmReassembler takes fragments in order into one frame-sized
+ *   buffer; a gap drops the frame being built (corrections are only
+ *   useful fresh, so nothing is ever retransmitted) and only CRC-checked
+ *   frames come out
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file RtcmRelay.h
+ */
+
+#define RTCM_PREAMBLE           0xD3
+#define RTCM_HEADER             3
+#define RTCM_CRC_SIZE           3
+#define RTCM_MAX_PAYLOAD        1023
+#define RTCM_MAX_FRAME          (RTCM_HEADER + RTCM_MAX_PAYLOAD + RTCM_CRC_SIZE)
+#define RTCM_FRAGMENT_DATA      200
+#define RTCM_MAX_FRAGMENTS \
+    ((RTCM_MAX_FRAME + RTCM_FRAGMENT_DATA - 1) / RTCM_FRAGMENT_DATA)
+
+/**
+ * Stream framer (one byte source)
+ */
+typedef struct {
+    uint8_t buf[RTCM_MAX_FRAME];
+    uint16_t len;               // Bytes buffered, from a preamble on
+    uint16_t taken;             // Frame returned by the last feed
+
+    // Statistics
+    uint32_t frames;
+    uint32_t crcErrors;
+} RtcmFramer;
+
+/**
+ * Fragment reassembler (one fragment source at a time)
+ */
+typedef struct {
+    uint8_t buf[RTCM_MAX_FRAME];
+    uint16_t len;
+    uint8_t seq;                // Frame being built
+    uint8_t count;              // Its fragments
+    uint8_t next;               // Next expected index, 0 = idle
+
+    // Statistics
+    uint32_t frames;
+    uint32_t lost;              // Frames dropped for a missing fragment
+    uint32_t crcErrors;
+    uint32_t malformed;         // Fragment header out of range
+} RtcmReassembler;
+
+/**
+ * CRC-24Q (Qualcomm, as used by RTCM3 and SBAS)
+ */
+uint32_t Rtcm_crc24q(const uint8_t* data, size_t len);
+
+/**
+ * Check a whole frame: preamble, reserved bits, length and CRC
+ */
+bool Rtcm_frameValid(const uint8_t* frame, size_t len);
+
+/**
+ * Message number (first 12 payload bits) of a valid frame, e.g. 1005
+ */
+uint16_t Rtcm_messageType(const uint8_t* frame);
+
+void RtcmFramer_init(RtcmFramer* f);
+
+/**
+ * Consume bytes up to and including the next complete frame
+ * @param frame Output; NULL if no frame completed, else points into the
+ *              framer and stays valid until the next feed
+ * @return Bytes consumed (call again with the rest while it is < len)
+ */
+size_t RtcmFramer_feed(RtcmFramer* f, const uint8_t* data, size_t len,
+                       const uint8_t** frame, uint16_t* frameLen);
+
+/**
+ * Fragments a frame of len bytes is sent as
+ */
+uint8_t RtcmRelay_fragmentCount(size_t len);
+
+void RtcmReassembler_init(RtcmReassembler* r);
+
+/**
+ * Add one fragment
+ * @param seq Frame sequence (wraps)
+ * @param index Fragment index, 0 .. count - 1
+ * @param frame Output when this fragment completed a valid frame; points
+ *              into the reassembler until the next add
+ * @return true if a frame completed
+ */
+bool RtcmReassembler_add(RtcmReassembler* r, uint8_t seq, uint8_t index, uint8_t count,
+                         const uint8_t* data, size_t len,
+                         const uint8_t** frame, uint16_t* frameLen);
+
+#endif // RTCM_RELAY_H
@@ -0,0 +1,126 @@
+#include "RxFilter.h"
+#include "NAPacketAEAD.h"
+#include <Arduino.h>
+#include <string.h>
+
+/**
+ * RxFilter - Implementation
+ *
+ * The allowlist is a few MACs (paired controller plus peers with their
+ * own session), scanned linearly under a spinlock because the control
+ * task and key exchange worker change it while the Wi-Fi task reads it.
+ * "Open" (accept any) is a separate flag so removing the last peer does
+ * not silently open the filter.
+ *
+ * @file RxFilter.cpp
+ */
+
+static uint8_t gPeers[RX_FILTER_MAX_PEERS][RX_FILTER_MAC_SIZE];
+static uint8_t gPeerCount = 0;
+static bool gOpen = true;
+static RxFilterStats gStats;
+static portMUX_TYPE gPeerMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static bool known_encryption(uint8_t flag) {
+    return flag == NA_ENCRYPTION_NONE || flag == NA_ENCRYPTION_CTR_HMAC ||
+           flag == NA_ENCRYPTION_AEAD || flag == NA_ENCRYPTION_COMPACT ||
+           flag == NA_ENCRYPTION_LINK;
+}
+
+// Caller holds gPeerMux
+static int peer_index(const uint8_t* mac) {
+    for (uint8_t i = 0; i < gPeerCount; i++) {
+        if (memcmp(gPeers[i], mac, RX_FILTER_MAC_SIZE) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static bool from_peer(const uint8_t* mac) {
+    portENTER_CRITICAL(&gPeerMux);
+    bool ok = gOpen || peer_index(mac) >= 0;
+    portEXIT_CRITICAL(&gPeerMux);
+    return ok;
+}
+
+static RxFilterStage reject(RxFilterStage stage) {
+    gStats.rejected[stage]++;
+    return stage;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void RxFilter_init(void) {
+    portENTER_CRITICAL(&gPeerMux);
+    memset(gPeers, 0, sizeof(gPeers));
+    gPeerCount = 0;
+    gOpen = true;
+    portEXIT_CRITICAL(&gPeerMux);
+    memset(&gStats, 0, sizeof(gStats));
+}
+
+void RxFilter_setPeer(const uint8_t* mac) {
+    portENTER_CRITICAL(&gPeerMux);
+    gPeerCount = 0;
+    if (mac) memcpy(gPeers[gPeerCount++], mac, RX_FILTER_MAC_SIZE);
+    gOpen = mac == NULL;
+    portEXIT_CRITICAL(&gPeerMux);
+}
+
+bool RxFilter_addPeer(const uint8_t* mac) {
+    bool ok = true;
+    portENTER_CRITICAL(&gPeerMux);
+    if (peer_index(mac) < 0) {
+        if (gPeerCount < RX_FILTER_MAX_PEERS)
+            memcpy(gPeers[gPeerCount++], mac, RX_FILTER_MAC_SIZE);
+        else
+            ok = false;
+    }
+    portEXIT_CRITICAL(&gPeerMux);
+    return ok;
+}
+
+void RxFilter_removePeer(const uint8_t* mac) {
+    portENTER_CRITICAL(&gPeerMux);
+    int i = peer_index(mac);
+    if (i >= 0) {
+        // Keep the list dense: move the last entry into the hole
+        gPeerCount--;
+        if (i != gPeerCount)
+            memcpy(gPeers[i], gPeers[gPeerCount], RX_FILTER_MAC_SIZE);
+    }
+    portEXIT_CRITICAL(&gPeerMux);
+}
+
+RxFilterStage RxFilter_checkControl(const uint8_t* mac, const NAPacket* pkt) {
+    if (pkt->protocolVersion != PROTOCOL_VERSION || !known_encryption(pkt->encryptionFlag)) {
+        return reject(RX_FILTER_FORMAT);
+    }
+    if (!from_peer(mac)) {
+        return reject(RX_FILTER_SOURCE);
+    }
+    bool clear = pkt->encryptionFlag == NA_ENCRYPTION_NONE ||
+                 pkt->encryptionFlag == NA_ENCRYPTION_LINK;
+    if (clear && !NA_VERIFY_PACKET(pkt)) {
+        return reject(RX_FILTER_CHECKSUM);
+    }
+    return RX_FILTER_PASS;
+}
+
+void RxFilter_record(RxFilterStage stage) {
+    if (stage == RX_FILTER_PASS) {
+        gStats.passed++;
+    } else if (stage < RX_FILTER_STAGE_COUNT) {
+        gStats.rejected[stage]++;
+    }
+}
+
+RxFilterStats RxFilter_getStats(void) {
+    return gStats;
+}
@@ -0,0 +1,100 @@
+#ifndef RX_FILTER_H
+#define RX_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NAPacket.h"
+
+/**
+ * RxFilter - Cheap pre-crypto rejection of radio control frames
+ *
+ * Runs in the ESP-NOW receive callback, cheapest stage first, so junk is
+ * dropped before it costs a rate-limit token, a ring slot or an AES/HMAC
+ * pass in the control task:
+ *   1. LENGTH    frame size matches no known frame (counted by the caller)
+ *   2. FORMAT    wrong protocolVersion or unknown encryptionFlag
+ *   3. SOURCE    sender is not an allowed peer: the paired controller plus
+ *                peers with their own session (any while unpaired)
+ *   4. CHECKSUM  NA_CRC16 mismatch; clear frames only (including those
+ *                under ESP-NOW CCMP) - the CRC of a CTR+HMAC frame covers
+ *                the plaintext, AEAD has none
+ *   5. SEQUENCE  duplicate / outside the replay window (caller, ReplayWindow)
+ *   6. RATE      rate limited (caller, RateLimitManager)
+ *
+ * Handshake frames are not source-filtered: pairing a new controller
+ * needs one. Counters are written by the Wi-Fi task and read anywhere.
+ *
+ * @file RxFilter.h
+ */
+
+#define RX_FILTER_MAC_SIZE  6
+#define RX_FILTER_MAX_PEERS 4   // Matches PEER_SESSION_MAX
+
+/**
+ * Pipeline stages (RX_FILTER_PASS = accepted)
+ */
+typedef enum {
+    RX_FILTER_PASS = 0,
+    RX_FILTER_LENGTH,
+    RX_FILTER_FORMAT,
+    RX_FILTER_SOURCE,
+    RX_FILTER_CHECKSUM,
+    RX_FILTER_SEQUENCE,
+    RX_FILTER_RATE,
+    RX_FILTER_STAGE_COUNT
+} RxFilterStage;
+
+/**
+ * Per-stage counters
+ */
+typedef struct {
+    uint32_t passed;
+    uint32_t rejected[RX_FILTER_STAGE_COUNT];   // Indexed by RxFilterStage
+} RxFilterStats;
+
+/**
+ * Clear counters and the allowlist
+ */
+void RxFilter_init(void);
+
+/**
+ * Set the paired controller (replaces the whole allowlist)
+ * @param mac Controller MAC (6 bytes), NULL to accept any sender
+ */
+void RxFilter_setPeer(const uint8_t* mac);
+
+/**
+ * Allow one more sender (relay / follower with its own session)
+ * @param mac Peer MAC (6 bytes)
+ * @return false if the allowlist is full
+ */
+bool RxFilter_addPeer(const uint8_t* mac);
+
+/**
+ * Stop allowing a sender; an emptied list accepts nobody until setPeer()
+ * @param mac Peer MAC (6 bytes)
+ */
+void RxFilter_removePeer(const uint8_t* mac);
+
+/**
+ * Run the frame-local stages (FORMAT, SOURCE, CHECKSUM)
+ * Counts its own rejects; a PASS is counted by RxFilter_record() once
+ * the caller's stages passed too.
+ * @param mac Sender MAC
+ * @param pkt Received frame (AEAD frames unpacked with NA_AEAD_toPacket)
+ * @return RX_FILTER_PASS or the rejecting stage
+ */
+RxFilterStage RxFilter_checkControl(const uint8_t* mac, const NAPacket* pkt);
+
+/**
+ * Count the outcome of a stage run by the caller
+ * @param stage RX_FILTER_PASS or the rejecting stage
+ */
+void RxFilter_record(RxFilterStage stage);
+
+/**
+ * Get counters
+ */
+RxFilterStats RxFilter_getStats(void);
+
+#endif // RX_FILTER_H
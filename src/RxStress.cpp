@@ -0,0 +1,101 @@
+#include "RxStress.h"
+#include <string.h>
+
+/**
+ * RxStress - Implementation
+ *
+ * @file RxStress.cpp
+ */
+
+static const char* const KIND_NAMES[RX_STRESS_KINDS] = {
+    "valid", "crc", "hmac", "replay", "big"
+};
+
+static uint32_t nextRandom(RxStressGen* gen) {
+    // xorshift32: cheap enough not to show up in the measurement
+    uint32_t x = gen->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    gen->rng = x;
+    return x;
+}
+
+void RxStress_defaultMix(RxStressMix* mix) {
+    mix->weights[RX_STRESS_VALID] = 70;
+    mix->weights[RX_STRESS_BAD_CRC] = 10;
+    mix->weights[RX_STRESS_BAD_HMAC] = 10;
+    mix->weights[RX_STRESS_REPLAY] = 5;
+    mix->weights[RX_STRESS_OVERSIZED] = 5;
+    mix->encryptedPercent = 50;
+}
+
+bool RxStress_init(RxStressGen* gen, const RxStressMix* mix, const NAPacket* templ,
+                   uint32_t seed, RxStressSealFn seal, void* sealCtx) {
+    memset(gen, 0, sizeof(*gen));
+    gen->mix = *mix;
+    if (gen->mix.encryptedPercent > 100) gen->mix.encryptedPercent = 100;
+    for (int k = 0; k < RX_STRESS_KINDS; k++) gen->weightTotal += mix->weights[k];
+    gen->rng = seed ? seed : 0x9E3779B9u;
+    gen->templ = *templ;
+    gen->seal = seal ? seal : RxStress_sealClear;
+    gen->sealCtx = sealCtx;
+    return gen->weightTotal > 0;
+}
+
+void RxStress_sealClear(NAPacket* pkt, bool encrypted, void* ctx) {
+    (void)encrypted;
+    (void)ctx;
+    pkt->encryptionFlag = NA_ENCRYPTION_NONE;
+    NA_UPDATE_PACKET_CHECKSUM(pkt);
+}
+
+const char* RxStress_kindName(RxStressKind kind) {
+    return kind < RX_STRESS_KINDS ? KIND_NAMES[kind] : "?";
+}
+
+static RxStressKind pickKind(RxStressGen* gen) {
+    uint32_t r = nextRandom(gen) % gen->weightTotal;
+    for (int k = 0; k < RX_STRESS_KINDS; k++) {
+        if (r < gen->mix.weights[k]) return (RxStressKind)k;
+        r -= gen->mix.weights[k];
+    }
+    return RX_STRESS_VALID;
+}
+
+RxStressKind RxStress_next(RxStressGen* gen, uint8_t* frame, uint16_t* len, bool* encrypted) {
+    RxStressKind kind = gen->weightTotal ? pickKind(gen) : RX_STRESS_VALID;
+    bool enc = nextRandom(gen) % 100 < gen->mix.encryptedPercent;
+    if (kind == RX_STRESS_BAD_HMAC) enc = true;    // A clear frame has no tag to break
+
+    NAPacket pkt;
+    if (kind == RX_STRESS_REPLAY && gen->haveLast) {
+        pkt = gen->last;
+        enc = pkt.encryptionFlag != NA_ENCRYPTION_NONE;
+    } else {
+        // Every frame but a replay spends a fresh number, so the junk
+        // kinds are rejected for what they are, not as duplicates
+        pkt = gen->templ;
+        pkt.sequenceNumber = ++gen->sequence;
+        gen->seal(&pkt, enc, gen->sealCtx);
+        if (kind == RX_STRESS_BAD_CRC) {
+            pkt.checksum ^= 0x5A5A;
+        } else if (kind == RX_STRESS_BAD_HMAC) {
+            pkt.hmac[0] ^= 0xFF;
+        } else if (kind == RX_STRESS_VALID || kind == RX_STRESS_REPLAY) {
+            // A replay before any valid frame goes out as the original
+            gen->last = pkt;
+            gen->haveLast = true;
+        }
+    }
+
+    memcpy(frame, &pkt, sizeof(pkt));
+    *len = sizeof(pkt);
+    if (kind == RX_STRESS_OVERSIZED) {
+        memset(frame + sizeof(pkt), 0, RX_STRESS_FRAME_MAX - sizeof(pkt));
+        *len = RX_STRESS_FRAME_MAX;
+    }
+    if (encrypted) *encrypted = enc;
+    gen->generated[kind]++;
+    return kind;
+}
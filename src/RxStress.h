@@ -0,0 +1,107 @@
+#ifndef RX_STRESS_H
+#define RX_STRESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NAPacket.h"
+
+/**
+ * RxStress - Control frame flood generator for the receive pipeline
+ *
+ * Produces an endless, seeded mix of control frames for measuring how
+ * the receive path (RxFilter -> ReplayWindow -> RateLimitManager ->
+ * decrypt / HMAC) holds up under load:
+ *
+ *   VALID       fresh sequence number, sealed
+ *   BAD_CRC     sealed, then the checksum flipped
+ *   BAD_HMAC    sealed encrypted, then the HMAC flipped
+ *   REPLAY      byte copy of the last VALID frame
+ *   OVERSIZED   a valid frame padded to the ESP-NOW maximum
+ *
+ * The other kinds are sealed clear or CTR+HMAC by encryptedPercent. Sealing is
+ * the caller's (RxStressSealFn): the host harness seals clear with a CRC
+ * only, the on-target injector (rx_injector_main.cpp) with the link key,
+ * so this module needs no crypto.
+ *
+ * VALID frames copy the caller's template (neutral sticks), so a flood
+ * that gets through never moves the vehicle.
+ *
+ * Plain struct, no hardware.
+ *
+ * @file RxStress.h
+ */
+
+#define RX_STRESS_FRAME_MAX     250     // ESP-NOW payload limit
+
+typedef enum {
+    RX_STRESS_VALID = 0,
+    RX_STRESS_BAD_CRC,
+    RX_STRESS_BAD_HMAC,
+    RX_STRESS_REPLAY,
+    RX_STRESS_OVERSIZED,
+    RX_STRESS_KINDS
+} RxStressKind;
+
+/**
+ * Traffic mix: relative weights per kind, share of encrypted frames
+ */
+typedef struct {
+    uint8_t weights[RX_STRESS_KINDS];
+    uint8_t encryptedPercent;   // 0-100
+} RxStressMix;
+
+/**
+ * Seal a frame in place: encryptionFlag, IV, HMAC, checksum, payload
+ * encryption
+ * @param encrypted CTR+HMAC if true, clear otherwise
+ */
+typedef void (*RxStressSealFn)(NAPacket* pkt, bool encrypted, void* ctx);
+
+typedef struct {
+    RxStressMix mix;
+    uint16_t weightTotal;
+    uint32_t rng;
+    uint32_t sequence;
+    NAPacket templ;
+    NAPacket last;              // Last VALID frame as sent
+    bool haveLast;
+    RxStressSealFn seal;
+    void* sealCtx;
+    uint32_t generated[RX_STRESS_KINDS];
+} RxStressGen;
+
+/**
+ * Default mix: 70 % valid, 10 % bad CRC, 10 % bad HMAC, 5 % replayed,
+ * 5 % oversized; half of the frames encrypted
+ */
+void RxStress_defaultMix(RxStressMix* mix);
+
+/**
+ * @param templ Frame content for VALID frames (sequence is overwritten)
+ * @param seed Any value; the same seed gives the same traffic
+ * @param seal Sealing function, NULL = RxStress_sealClear
+ * @return false if every weight is 0
+ */
+bool RxStress_init(RxStressGen* gen, const RxStressMix* mix, const NAPacket* templ,
+                   uint32_t seed, RxStressSealFn seal, void* sealCtx);
+
+/**
+ * Next frame of the mix
+ * @param frame RX_STRESS_FRAME_MAX bytes
+ * @param len Output: bytes to send
+ * @param encrypted Output: sealed as CTR+HMAC (may be NULL)
+ * @return Kind of the frame
+ */
+RxStressKind RxStress_next(RxStressGen* gen, uint8_t* frame, uint16_t* len, bool* encrypted);
+
+/**
+ * Clear sealing (no encryption, CRC only) for builds without keys
+ */
+void RxStress_sealClear(NAPacket* pkt, bool encrypted, void* ctx);
+
+/**
+ * Short name of a kind ("valid", "crc", "hmac", "replay", "big")
+ */
+const char* RxStress_kindName(RxStressKind kind);
+
+#endif // RX_STRESS_H
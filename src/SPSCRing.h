@@ -0,0 +1,156 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * SPSCRing - Lock-Free Single-Producer / Single-Consumer Latest-Value Ring
+ *
+ * Features:
+ * - Wait-free push (safe from the Wi-Fi / ESP-NOW callback context)
+ * - Consumer always takes the newest complete frame, older ones are dropped
+ * - Per-slot sequence numbers (seqlock) so a frame overwritten while it is
+ *   being copied out is detected and re-read, never returned torn
+ *
+ * Exactly one task may call push() and exactly one task may call
+ * readLatest() / readNext(). T must be trivially copyable (e.g. NAPacket).
+ *
+ * readNext() drains frames in order instead (sample streams such as IMU
+ * data); if the producer laps the consumer, the oldest unread frames are
+ * skipped and counted as dropped.
+ *
+ * @file SPSCRing.h
+ */
+
+template <typename T, size_t N> class SPSCRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+  SPSCRing() : _head(0), _lastRead(0), _dropped(0) {
+    for (size_t i = 0; i < N; i++)
+      _slots[i].seq.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Publish a frame (producer only). Never blocks, overwrites oldest slot.
+   * @param item Frame to copy into the ring
+   */
+  void push(const T &item) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    Slot &slot = _slots[head & (N - 1)];
+
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed); // odd = writing
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.data, &item, sizeof(T));
+    slot.seq.store(seq + 2, std::memory_order_release); // even = complete
+
+    _head.store(head + 1, std::memory_order_release);
+  }
+
+  /**
+   * Copy out the newest complete frame (consumer only)
+   * @param out Destination frame
+   * @return true if a frame newer than the last read one was available
+   */
+  bool readLatest(T &out) {
+    // Each retry means the producer lapped us; bound it so a flood
+    // cannot stall the consumer
+    for (size_t attempt = 0; attempt < N; attempt++) {
+      uint32_t head = _head.load(std::memory_order_acquire);
+      if (head == _lastRead)
+        return false;
+
+      Slot &slot = _slots[(head - 1) & (N - 1)];
+      uint32_t seqBefore = slot.seq.load(std::memory_order_acquire);
+      if (seqBefore & 1)
+        continue;
+
+      memcpy(&out, &slot.data, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint32_t seqAfter = slot.seq.load(std::memory_order_relaxed);
+      if (seqBefore != seqAfter)
+        continue;
+
+      _dropped += head - _lastRead - 1;
+      _lastRead = head;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Copy out the oldest unread frame (consumer only)
+   * @param out Destination frame
+   * @return true if a frame was available
+   */
+  bool readNext(T &out) {
+    for (size_t attempt = 0; attempt < N; attempt++) {
+      uint32_t head = _head.load(std::memory_order_acquire);
+      if (head == _lastRead)
+        return false;
+      if (head - _lastRead > N) {
+        // Lapped: everything older than the ring size is gone
+        _dropped += head - _lastRead - N;
+        _lastRead = head - N;
+      }
+
+      // Slot seq counts completed writes: 2 * (lap + 1) for this frame
+      Slot &slot = _slots[_lastRead & (N - 1)];
+      uint32_t expected = 2 * (_lastRead / N + 1);
+      uint32_t seqBefore = slot.seq.load(std::memory_order_acquire);
+      if (seqBefore != expected) {
+        if ((int32_t)(seqBefore - expected) > 0) {
+          _dropped++; // Overwritten by a newer lap
+          _lastRead++;
+        }
+        continue;
+      }
+
+      memcpy(&out, &slot.data, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint32_t seqAfter = slot.seq.load(std::memory_order_relaxed);
+      if (seqBefore != seqAfter)
+        continue;
+
+      _lastRead++;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Frames pushed but not yet read (consumer only, may be > N if lapped)
+   */
+  uint32_t available() const {
+    return _head.load(std::memory_order_acquire) - _lastRead;
+  }
+
+  /**
+   * Total frames pushed since construction
+   */
+  uint32_t getPushCount() const {
+    return _head.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Frames that were superseded before the consumer read them
+   */
+  uint32_t getDroppedCount() const { return _dropped; }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    T data;
+  };
+
+  Slot _slots[N];
+  std::atomic<uint32_t> _head; // Written by producer only
+  uint32_t _lastRead;          // Consumer-owned
+  uint32_t _dropped;           // Consumer-owned
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,105 @@
+#include "SecureRandom.h"
+#include <string.h>
+
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+
+/**
+ * SecureRandom - Implementation
+ *
+ * Reseeding is counted here instead of left to mbedtls so the interval is
+ * the same whatever the library default, and so it shows in the stats.
+ *
+ * @file SecureRandom.cpp
+ */
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+static SemaphoreHandle_t rngLock = NULL;
+#define RNG_LOCK() xSemaphoreTake(rngLock, portMAX_DELAY)
+#define RNG_UNLOCK() xSemaphoreGive(rngLock)
+#else
+#define RNG_LOCK() ((void)0)
+#define RNG_UNLOCK() ((void)0)
+#endif
+
+static const char PERSONALIZATION[] = "NA_Framework_v1";
+
+static mbedtls_entropy_context entropy;
+static mbedtls_ctr_drbg_context drbg;
+static volatile bool seeded = false;
+static uint32_t sinceReseed = 0;
+static SecureRandomStats stats = {0, 0};
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool SecureRandom_init(void) {
+  if (seeded)
+    return true;
+#if defined(ESP_PLATFORM)
+  // First call comes from boot, before any task draws
+  if (!rngLock)
+    rngLock = xSemaphoreCreateMutex();
+  if (!rngLock)
+    return false;
+#endif
+
+  RNG_LOCK();
+  if (!seeded) {
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&drbg);
+    int ret = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy,
+                                    (const unsigned char *)PERSONALIZATION,
+                                    strlen(PERSONALIZATION));
+    if (ret == 0) {
+      // Reseeds are scheduled below; never inside mbedtls
+      mbedtls_ctr_drbg_set_reseed_interval(&drbg, 0x7FFFFFFF);
+      seeded = true;
+    } else {
+      mbedtls_ctr_drbg_free(&drbg);
+      mbedtls_entropy_free(&entropy);
+    }
+  }
+  RNG_UNLOCK();
+  return seeded;
+}
+
+int SecureRandom_fill(uint8_t *out, size_t len) {
+  if (!SecureRandom_init())
+    return MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED;
+
+  RNG_LOCK();
+  int ret = 0;
+  if (sinceReseed >= SECURE_RANDOM_RESEED_INTERVAL) {
+    ret = mbedtls_ctr_drbg_reseed(&drbg, NULL, 0);
+    if (ret == 0) {
+      sinceReseed = 0;
+      stats.reseeds++;
+    }
+  }
+  if (ret == 0)
+    ret = mbedtls_ctr_drbg_random(&drbg, out, len);
+  if (ret == 0) {
+    sinceReseed++;
+    stats.requests++;
+  }
+  RNG_UNLOCK();
+  return ret;
+}
+
+int SecureRandom_mbedtls(void *p_rng, unsigned char *out, size_t len) {
+  (void)p_rng;
+  return SecureRandom_fill(out, len);
+}
+
+SecureRandomStats SecureRandom_getStats(void) {
+  if (!seeded)
+    return stats;
+  RNG_LOCK();
+  SecureRandomStats s = stats;
+  RNG_UNLOCK();
+  return s;
+}
@@ -0,0 +1,55 @@
+#ifndef SECURE_RANDOM_H
+#define SECURE_RANDOM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * SecureRandom - One seeded CTR-DRBG for the whole firmware
+ *
+ * EncryptionManager (IVs, nonce prefixes) and KeyExchangeManager
+ * (ephemeral keys, ECP blinding) used to seed a DRBG and an entropy pool
+ * each. Both now draw from this one: entropy is gathered once per boot,
+ * reseeding happens here every SECURE_RANDOM_RESEED_INTERVAL requests,
+ * and one entropy + DRBG context pair (about 1.4 KB) is gone.
+ *
+ * Calls are serialized by a mutex on the target, so any task (control,
+ * comms, the Wi-Fi task, the key exchange worker) may draw. Not for
+ * ISRs: a reseed gathers entropy.
+ *
+ * @file SecureRandom.h
+ */
+
+#ifndef SECURE_RANDOM_RESEED_INTERVAL
+#define SECURE_RANDOM_RESEED_INTERVAL 10000     // DRBG requests between reseeds
+#endif
+
+/**
+ * Seed the DRBG (idempotent; the first draw does it too)
+ * @return false if the entropy source failed (retried on the next call)
+ */
+bool SecureRandom_init(void);
+
+/**
+ * Fill a buffer with DRBG output
+ * @return 0 or an mbedtls error code
+ */
+int SecureRandom_fill(uint8_t* out, size_t len);
+
+/**
+ * mbedtls f_rng callback over the shared DRBG (p_rng is ignored)
+ */
+int SecureRandom_mbedtls(void* p_rng, unsigned char* out, size_t len);
+
+/**
+ * Requests served and reseeds done since boot
+ */
+typedef struct {
+    uint32_t requests;
+    uint32_t reseeds;
+} SecureRandomStats;
+
+SecureRandomStats SecureRandom_getStats(void);
+
+#endif // SECURE_RANDOM_H
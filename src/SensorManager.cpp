@@ -3,7 +3,8 @@
 SensorManager::SensorManager() {}
 
 bool SensorManager::initI2C() {
-    Wire.begin(I2C_SDA, I2C_SCL);
+    // Shared bus: HAL_I2CInit is a no-op if another manager already started it
+    if (!HAL_I2CInit(I2C_SDA, I2C_SCL, I2C_FREQUENCY)) return false;
     delay(100);
     Serial.println("[I2C] Bus initialized");
     scanI2CBus();
@@ -12,42 +13,36 @@ bool SensorManager::initI2C() {
 
 bool SensorManager::detectMPU6050() {
     // Timeout-protected detection (100ms max)
-    const uint32_t timeout = millis() + 100;
-    Wire.beginTransmission(MPU6050_ADDR);
-    byte error = Wire.endTransmission();
+    HAL_I2CError error = HAL_I2CProbe(MPU6050_ADDR, 100);
     
-    if (millis() > timeout) {
+    if (error == HAL_I2C_TIMEOUT) {
         Serial.println("[I2C] MPU6050 detection timeout");
         return false;
     }
-    return error == 0;
+    return error == HAL_I2C_OK;
 }
 
 bool SensorManager::detectPCA9685() {
     // Timeout-protected detection (100ms max)
-    const uint32_t timeout = millis() + 100;
-    Wire.beginTransmission(PCA9685_ADDR);
-    byte error = Wire.endTransmission();
+    HAL_I2CError error = HAL_I2CProbe(PCA9685_ADDR, 100);
     
-    if (millis() > timeout) {
+    if (error == HAL_I2C_TIMEOUT) {
         Serial.println("[I2C] PCA9685 detection timeout");
         return false;
     }
-    return error == 0;
+    return error == HAL_I2C_OK;
 }
 
 bool SensorManager::detectOLED() {
     // Timeout-protected detection (500ms max) - OLED init can be slow
-    const uint32_t timeout = millis() + 500;
-    Wire.beginTransmission(OLED_ADDR);
-    byte error = Wire.endTransmission();
+    HAL_I2CError error = HAL_I2CProbe(OLED_ADDR, 500);
     
-    if (millis() > timeout) {
+    if (error == HAL_I2C_TIMEOUT) {
         Serial.println("[OLED] Detection timeout - falling back to telemetry-only mode");
         return false;
     }
     
-    if (error == 0) {
+    if (error == HAL_I2C_OK) {
         return true;
     } else {
         Serial.println("[OLED] Not detected (0x3C) - telemetry will use serial only");
@@ -59,9 +54,7 @@ void SensorManager::scanI2CBus() {
     Serial.println("[I2C] Scanning bus...");
     int deviceCount = 0;
     for (byte i = 1; i < 127; i++) {
-        Wire.beginTransmission(i);
-        byte error = Wire.endTransmission();
-        if (error == 0) {
+        if (HAL_I2CProbe(i, 10) == HAL_I2C_OK) {
             Serial.printf("[I2C] Device found at 0x%02X\n", i);
             deviceCount++;
         }
@@ -2,7 +2,7 @@
 #define SENSOR_MANAGER_H
 
 #include <Arduino.h>
-#include <Wire.h>
+#include "HAL.h"
 
 class SensorManager {
 public:
@@ -16,6 +16,7 @@ public:
 private:
     static const uint8_t I2C_SDA = 21;
     static const uint8_t I2C_SCL = 22;
+    static const uint32_t I2C_FREQUENCY = 400000;
     static const uint8_t MPU6050_ADDR = 0x68;
     static const uint8_t PCA9685_ADDR = 0x40;
     static const uint8_t OLED_ADDR = 0x3C;
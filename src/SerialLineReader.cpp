@@ -0,0 +1,241 @@
+#include "SerialLineReader.h"
+#include "MavLink.h"
+#include <Arduino.h>
+#include <atomic>
+#include <ctype.h>
+#include <string.h>
+
+/**
+ * SerialLineReader - Implementation
+ *
+ * The byte ring is a classic SPSC queue: the producer owns head, the
+ * consumer owns tail, and full/empty is decided from their difference.
+ * Line assembly state lives entirely on the consumer side.
+ *
+ * Stream demux: text bytes accumulate until '\n'. A 0x00 discards any
+ * partial text and opens a binary frame; the next 0x00 after at least
+ * one byte closes it. Repeated 0x00 are treated as resync padding.
+ * 0xFD (never part of UTF-8 text) outside a binary frame also discards
+ * partial text and opens a MAVLink v2 frame, which ends after the length
+ * its header announces.
+ *
+ * @file SerialLineReader.cpp
+ */
+
+// STX, len and incompat_flags give a MAVLink frame's length
+#define MAVLINK_LENGTH_BYTES 3
+
+static_assert((SERIAL_RX_RING_SIZE & (SERIAL_RX_RING_SIZE - 1)) == 0,
+              "SERIAL_RX_RING_SIZE must be a power of two");
+
+// Internal state
+static struct {
+  uint8_t ring[SERIAL_RX_RING_SIZE];
+  std::atomic<uint32_t> head; // Producer-owned
+  std::atomic<uint32_t> tail; // Consumer-owned
+
+  char line[SERIAL_LINE_MAX];
+  size_t lineLen;
+  bool discarding;   // Current frame overflowed, skip to its terminator
+  bool binary;       // Inside a 0x00-delimited binary frame
+  bool mavlink;      // Inside a MAVLink frame
+  size_t mavlinkLen; // Its total length, once the header is in
+
+  SerialLineReaderStats stats;
+} gReader;
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+/**
+ * UART event callback: drain the driver buffer into the ring
+ */
+static void on_uart_rx(void) {
+  uint8_t chunk[64];
+  int avail;
+  while ((avail = Serial.available()) > 0) {
+    size_t want = (size_t)avail < sizeof(chunk) ? (size_t)avail : sizeof(chunk);
+    size_t got = Serial.readBytes(chunk, want);
+    if (got == 0)
+      break;
+    SerialLineReader_feed(chunk, got);
+  }
+}
+
+/**
+ * Strip surrounding whitespace from the assembled line in place
+ * @return Trimmed length, line starts at *start
+ */
+static size_t trim_line(char *buf, size_t len, char **start) {
+  size_t begin = 0;
+  while (begin < len && isspace((unsigned char)buf[begin]))
+    begin++;
+  while (len > begin && isspace((unsigned char)buf[len - 1]))
+    len--;
+  *start = buf + begin;
+  return len - begin;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+bool SerialLineReader_init(void) {
+  SerialLineReader_reset();
+  Serial.onReceive(on_uart_rx);
+  return true;
+}
+
+void SerialLineReader_feed(const uint8_t *data, size_t len) {
+  if (!data)
+    return;
+
+  uint32_t head = gReader.head.load(std::memory_order_relaxed);
+  uint32_t tail = gReader.tail.load(std::memory_order_acquire);
+  uint32_t space = SERIAL_RX_RING_SIZE - (head - tail);
+
+  size_t n = len < space ? len : space;
+  for (size_t i = 0; i < n; i++) {
+    gReader.ring[(head + i) & (SERIAL_RX_RING_SIZE - 1)] = data[i];
+  }
+  gReader.head.store(head + n, std::memory_order_release);
+
+  gReader.stats.bytesReceived += n;
+  gReader.stats.bytesDropped += len - n;
+}
+
+size_t SerialLineReader_readFrame(uint8_t *out, size_t outSize,
+                                  SerialFrameType *type) {
+  if (!out || outSize == 0 || !type)
+    return 0;
+
+  uint32_t tail = gReader.tail.load(std::memory_order_relaxed);
+  uint32_t head = gReader.head.load(std::memory_order_acquire);
+
+  while (tail != head) {
+    char c = (char)gReader.ring[tail & (SERIAL_RX_RING_SIZE - 1)];
+    tail++;
+
+    if (gReader.mavlink) {
+      gReader.line[gReader.lineLen++] = c;
+      if (gReader.lineLen == MAVLINK_LENGTH_BYTES)
+        gReader.mavlinkLen = MavLink_frameLength((const uint8_t *)gReader.line,
+                                                 gReader.lineLen);
+      if (gReader.lineLen < MAVLINK_LENGTH_BYTES ||
+          gReader.lineLen < gReader.mavlinkLen)
+        continue;
+
+      size_t len = gReader.lineLen;
+      gReader.mavlink = false;
+      gReader.lineLen = 0;
+      if (len > outSize) {
+        gReader.stats.linesOverflowed++;
+        continue;
+      }
+
+      memcpy(out, gReader.line, len);
+      *type = SERIAL_FRAME_MAVLINK;
+      gReader.stats.mavlinkFrames++;
+      gReader.tail.store(tail, std::memory_order_release);
+      return len;
+    }
+
+    if ((uint8_t)c == MAVLINK_STX && !gReader.binary) {
+      gReader.mavlink = true;
+      gReader.discarding = false;
+      gReader.line[0] = c;
+      gReader.lineLen = 1;
+      continue;
+    }
+
+    if (c == '\0') {
+      // Delimiter: opens a binary frame, or closes one that has data
+      bool closing =
+          gReader.binary && (gReader.lineLen > 0 || gReader.discarding);
+      bool wasDiscarding = gReader.discarding;
+      size_t len = gReader.lineLen;
+
+      gReader.binary = !closing;
+      gReader.lineLen = 0;
+      gReader.discarding = false;
+
+      if (!closing || wasDiscarding)
+        continue;
+
+      if (len > outSize) {
+        gReader.stats.linesOverflowed++;
+        continue;
+      }
+
+      memcpy(out, gReader.line, len);
+      *type = SERIAL_FRAME_BINARY;
+      gReader.stats.binaryFrames++;
+      gReader.tail.store(tail, std::memory_order_release);
+      return len;
+    }
+
+    if (c != '\n' || gReader.binary) {
+      if (gReader.discarding)
+        continue;
+      if (gReader.lineLen >= SERIAL_LINE_MAX - 1) {
+        gReader.discarding = true;
+        gReader.lineLen = 0;
+        gReader.stats.linesOverflowed++;
+        continue;
+      }
+      gReader.line[gReader.lineLen++] = c;
+      continue;
+    }
+
+    // End of text line
+    if (gReader.discarding) {
+      gReader.discarding = false;
+      continue;
+    }
+
+    char *start;
+    size_t len = trim_line(gReader.line, gReader.lineLen, &start);
+    gReader.lineLen = 0;
+    if (len == 0)
+      continue;
+
+    if (len >= outSize) {
+      gReader.stats.linesOverflowed++;
+      continue;
+    }
+
+    memcpy(out, start, len);
+    out[len] = '\0';
+    *type = SERIAL_FRAME_TEXT;
+    gReader.stats.linesCompleted++;
+    gReader.tail.store(tail, std::memory_order_release);
+    return len;
+  }
+
+  gReader.tail.store(tail, std::memory_order_release);
+  return 0;
+}
+
+size_t SerialLineReader_readLine(char *out, size_t outSize) {
+  SerialFrameType type;
+  size_t len;
+  while ((len = SerialLineReader_readFrame((uint8_t *)out, outSize, &type)) >
+         0) {
+    if (type == SERIAL_FRAME_TEXT)
+      return len;
+  }
+  return 0;
+}
+
+SerialLineReaderStats SerialLineReader_getStats(void) { return gReader.stats; }
+
+void SerialLineReader_reset(void) {
+  gReader.tail.store(gReader.head.load(std::memory_order_acquire),
+                     std::memory_order_release);
+  gReader.lineLen = 0;
+  gReader.discarding = false;
+  gReader.binary = false;
+  gReader.mavlink = false;
+  memset(&gReader.stats, 0, sizeof(gReader.stats));
+}
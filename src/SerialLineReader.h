@@ -0,0 +1,99 @@
+#ifndef SERIAL_LINE_READER_H
+#define SERIAL_LINE_READER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * SerialLineReader - Non-blocking line assembler for host commands
+ *
+ * Features:
+ * - UART RX event callback copies bytes into a fixed lock-free ring
+ * - Comms task assembles '\n'-terminated lines without ever waiting
+ * - No heap allocation (replaces Serial.readStringUntil)
+ * - Oversized lines are discarded up to the next newline, not truncated
+ * - Binary frames delimited by 0x00 (COBS, see HostProtocol) share the
+ *   stream with JSON lines: 0x00 opens a binary frame, the next 0x00 after
+ *   data closes it, and '\n' inside a binary frame is plain data
+ * - MAVLink v2 frames (see MavLink) share it too: 0xFD outside a binary
+ *   frame starts one, and its header gives the length, so 0x00 and '\n'
+ *   inside it are plain data
+ *
+ * Producer: UART event task (Serial.onReceive). Consumer: comms task.
+ *
+ * @file SerialLineReader.h
+ */
+
+#define SERIAL_RX_RING_SIZE     2048    // Bytes, power of two
+#define SERIAL_LINE_MAX         1024    // Longest accepted line incl. NUL
+
+/**
+ * Kind of frame returned by SerialLineReader_readFrame()
+ */
+typedef enum {
+    SERIAL_FRAME_TEXT = 0,          // '\n'-terminated line (JSON)
+    SERIAL_FRAME_BINARY = 1,        // 0x00-delimited COBS frame (encoded)
+    SERIAL_FRAME_MAVLINK = 2        // Whole MAVLink v2 frame, from STX
+} SerialFrameType;
+
+/**
+ * Reader Statistics
+ */
+typedef struct {
+    uint32_t bytesReceived;         // Bytes accepted into the ring
+    uint32_t bytesDropped;          // Bytes lost because the ring was full
+    uint32_t linesCompleted;        // Lines handed to the caller
+    uint32_t binaryFrames;          // Binary frames handed to the caller
+    uint32_t mavlinkFrames;         // MAVLink frames handed to the caller
+    uint32_t linesOverflowed;       // Lines discarded for exceeding SERIAL_LINE_MAX
+} SerialLineReaderStats;
+
+/**
+ * Register the UART RX callback (call after Serial.begin)
+ * @return true if initialization successful
+ */
+bool SerialLineReader_init(void);
+
+/**
+ * Push received bytes into the ring (producer side, never blocks)
+ * @param data Received bytes
+ * @param len Number of bytes
+ */
+void SerialLineReader_feed(const uint8_t* data, size_t len);
+
+/**
+ * Take the next complete line (consumer side, never blocks)
+ *
+ * Trailing '\r' and surrounding whitespace are stripped; empty lines
+ * are skipped. Binary and MAVLink frames are consumed and discarded.
+ *
+ * @param out Output buffer, NUL-terminated
+ * @param outSize Size of out (at most SERIAL_LINE_MAX is used)
+ * @return Line length, or 0 if no complete line is pending
+ */
+size_t SerialLineReader_readLine(char* out, size_t outSize);
+
+/**
+ * Take the next complete text line or binary frame (never blocks)
+ * @param out Output buffer; text frames are NUL-terminated, binary frames
+ *            are the COBS-encoded bytes between the delimiters, MAVLink
+ *            frames are the raw frame (not checked here)
+ * @param outSize Size of out
+ * @param type Output frame kind
+ * @return Frame length, or 0 if nothing complete is pending
+ */
+size_t SerialLineReader_readFrame(uint8_t* out, size_t outSize,
+                                  SerialFrameType* type);
+
+/**
+ * Get reader statistics
+ */
+SerialLineReaderStats SerialLineReader_getStats(void);
+
+/**
+ * Drop buffered bytes and partial line, clear statistics
+ */
+void SerialLineReader_reset(void);
+
+#endif // SERIAL_LINE_READER_H
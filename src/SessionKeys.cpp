@@ -0,0 +1,149 @@
+#include "SessionKeys.h"
+#include "mbedtls/md.h"
+#include <string.h>
+
+/**
+ * SessionKeys - Implementation
+ *
+ * HKDF is built on mbedtls' HMAC (always present) rather than
+ * mbedtls/hkdf.h, which is not enabled in every ESP32 mbedtls build.
+ *
+ * @file SessionKeys.cpp
+ */
+
+#define HKDF_HASH_SIZE 32
+
+static const char SESSION_SALT[] = "NA session v1";
+
+// HMAC-SHA256 over up to three parts
+static bool hmac3(const uint8_t* key, size_t keyLen,
+                  const uint8_t* a, size_t aLen,
+                  const uint8_t* b, size_t bLen,
+                  const uint8_t* c, size_t cLen, uint8_t out[HKDF_HASH_SIZE]) {
+    const mbedtls_md_info_t* md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (!md) return false;
+
+    mbedtls_md_context_t ctx;
+    mbedtls_md_init(&ctx);
+    bool ok = mbedtls_md_setup(&ctx, md, 1) == 0 &&
+              mbedtls_md_hmac_starts(&ctx, key, keyLen) == 0 &&
+              (!aLen || mbedtls_md_hmac_update(&ctx, a, aLen) == 0) &&
+              (!bLen || mbedtls_md_hmac_update(&ctx, b, bLen) == 0) &&
+              (!cLen || mbedtls_md_hmac_update(&ctx, c, cLen) == 0) &&
+              mbedtls_md_hmac_finish(&ctx, out) == 0;
+    mbedtls_md_free(&ctx);
+    return ok;
+}
+
+// HKDF-Expand: T(i) = HMAC(PRK, T(i-1) || info || i)
+static bool hkdfExpand(const uint8_t* prk, size_t prkLen, const uint8_t* info, size_t infoLen,
+                       uint8_t* okm, size_t okmLen) {
+    if (okmLen > 255 * HKDF_HASH_SIZE) return false;
+
+    uint8_t t[HKDF_HASH_SIZE];
+    size_t tLen = 0;
+    uint8_t counter = 1;
+    bool ok = true;
+    for (size_t done = 0; ok && done < okmLen; counter++) {
+        ok = hmac3(prk, prkLen, t, tLen, info, infoLen, &counter, 1, t);
+        tLen = HKDF_HASH_SIZE;
+        size_t n = okmLen - done < HKDF_HASH_SIZE ? okmLen - done : HKDF_HASH_SIZE;
+        memcpy(okm + done, t, n);
+        done += n;
+    }
+    memset(t, 0, sizeof(t));
+    return ok;
+}
+
+static bool expandLabel(const uint8_t* prk, const char* label, uint8_t out[SESSION_KEY_SIZE]) {
+    return hkdfExpand(prk, SESSION_KEY_SIZE, (const uint8_t*)label, strlen(label),
+                      out, SESSION_KEY_SIZE);
+}
+
+// Traffic keys for the current chain key
+static bool deriveTrafficKeys(SessionKeys* keys) {
+    return expandLabel(keys->chain, "NA c2v enc", keys->c2vEnc) &&
+           expandLabel(keys->chain, "NA c2v mac", keys->c2vMac) &&
+           expandLabel(keys->chain, "NA v2c enc", keys->v2cEnc) &&
+           expandLabel(keys->chain, "NA v2c mac", keys->v2cMac);
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool SessionKeys_hkdf(const uint8_t* salt, size_t saltLen,
+                      const uint8_t* ikm, size_t ikmLen,
+                      const uint8_t* info, size_t infoLen,
+                      uint8_t* okm, size_t okmLen) {
+    // RFC 5869: absent salt = HashLen zero bytes
+    uint8_t zeros[HKDF_HASH_SIZE] = {0};
+    if (!salt || !saltLen) {
+        salt = zeros;
+        saltLen = sizeof(zeros);
+    }
+
+    uint8_t prk[HKDF_HASH_SIZE];
+    bool ok = hmac3(salt, saltLen, ikm, ikmLen, NULL, 0, NULL, 0, prk) &&
+              hkdfExpand(prk, sizeof(prk), info, infoLen, okm, okmLen);
+    memset(prk, 0, sizeof(prk));
+    return ok;
+}
+
+bool SessionKeys_derive(SessionKeys* keys, const uint8_t* secret, size_t secretLen) {
+    SessionKeys_wipe(keys);
+
+    uint8_t prk[HKDF_HASH_SIZE];
+    bool ok = hmac3((const uint8_t*)SESSION_SALT, strlen(SESSION_SALT), secret, secretLen,
+                    NULL, 0, NULL, 0, prk) &&
+              expandLabel(prk, "NA chain", keys->chain) &&
+              deriveTrafficKeys(keys);
+    memset(prk, 0, sizeof(prk));
+
+    if (!ok) {
+        SessionKeys_wipe(keys);
+        return false;
+    }
+    keys->valid = true;
+    return true;
+}
+
+bool SessionKeys_ratchet(SessionKeys* keys) {
+    if (!keys->valid) return false;
+
+    uint8_t next[SESSION_KEY_SIZE];
+    if (!expandLabel(keys->chain, "NA ratchet", next)) return false;
+    memcpy(keys->chain, next, SESSION_KEY_SIZE);
+    memset(next, 0, sizeof(next));
+
+    if (!deriveTrafficKeys(keys)) {
+        SessionKeys_wipe(keys);
+        return false;
+    }
+    keys->epoch++;
+    return true;
+}
+
+int32_t SessionKeys_stepsFor(const SessionKeys* keys, uint32_t sequenceNumber) {
+    if (!keys->valid) return -1;
+    if (!keys->anchored) return 0;
+    uint32_t epoch = (sequenceNumber >> SESSION_RATCHET_SHIFT) - keys->anchor;
+    return (int32_t)(epoch - keys->epoch);
+}
+
+void SessionKeys_accept(SessionKeys* keys, uint32_t sequenceNumber) {
+    if (!keys->valid || keys->anchored) return;
+    keys->anchor = (sequenceNumber >> SESSION_RATCHET_SHIFT) - keys->epoch;
+    keys->anchored = true;
+}
+
+bool SessionKeys_linkKey(const SessionKeys* keys, uint8_t out[SESSION_LINK_KEY_SIZE]) {
+    if (!keys->valid) return false;
+    static const char label[] = "NA espnow lmk";
+    return hkdfExpand(keys->chain, SESSION_KEY_SIZE, (const uint8_t*)label, strlen(label),
+                      out, SESSION_LINK_KEY_SIZE);
+}
+
+void SessionKeys_wipe(SessionKeys* keys) {
+    memset(keys, 0, sizeof(*keys));
+}
@@ -0,0 +1,97 @@
+#ifndef SESSION_KEYS_H
+#define SESSION_KEYS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * SessionKeys - HKDF-SHA256 session keys with a symmetric ratchet
+ *
+ * Turns an ECDH shared secret into four independent 32-byte keys instead
+ * of using the raw X coordinate for everything:
+ *   c2v enc / c2v mac - controller -> vehicle (vehicle decrypts / verifies)
+ *   v2c enc / v2c mac - vehicle -> controller (vehicle encrypts / tags)
+ *
+ *   PRK   = HKDF-Extract("NA session v1", secret)
+ *   chain = HKDF-Expand(PRK, "NA chain")
+ *   key   = HKDF-Expand(chain, "NA c2v enc" | "NA c2v mac" | ...)
+ *
+ * Rekeying is a ratchet: chain = HKDF-Expand(chain, "NA ratchet") and the
+ * four keys are re-derived. It is one-way (old keys cannot be recovered
+ * from new ones) and costs five HMACs - no ECDH, no DRBG.
+ *
+ * Both ends ratchet when the controller's sequenceNumber crosses a
+ * multiple of 2^SESSION_RATCHET_SHIFT. The vehicle anchors on the first
+ * frame that authenticates after the handshake and from then on expects
+ * the epoch to advance by at most one step per frame (stepsFor()).
+ *
+ * Pure: no globals, no RTOS. Callers serialize access to one instance.
+ *
+ * @file SessionKeys.h
+ */
+
+#define SESSION_KEY_SIZE        32
+#define SESSION_RATCHET_SHIFT   16      // Ratchet every 65536 frames (~22 min at 50 Hz)
+#define SESSION_LINK_KEY_SIZE   16      // ESP-NOW local master key (CCMP)
+
+typedef struct {
+    uint8_t chain[SESSION_KEY_SIZE];
+    uint8_t c2vEnc[SESSION_KEY_SIZE];
+    uint8_t c2vMac[SESSION_KEY_SIZE];
+    uint8_t v2cEnc[SESSION_KEY_SIZE];
+    uint8_t v2cMac[SESSION_KEY_SIZE];
+    uint32_t epoch;                     // Ratchet steps since the handshake
+    uint32_t anchor;                    // sequenceNumber >> SHIFT at epoch 0
+    bool anchored;
+    bool valid;
+} SessionKeys;
+
+/**
+ * HKDF-SHA256 (RFC 5869), extract + expand
+ * @param salt Optional salt (NULL = zero-length)
+ * @param okmLen Output length, at most 255 * 32
+ * @return true on success
+ */
+bool SessionKeys_hkdf(const uint8_t* salt, size_t saltLen,
+                      const uint8_t* ikm, size_t ikmLen,
+                      const uint8_t* info, size_t infoLen,
+                      uint8_t* okm, size_t okmLen);
+
+/**
+ * Derive epoch-0 keys from a fresh shared secret
+ * @return true on success (keys are wiped on failure)
+ */
+bool SessionKeys_derive(SessionKeys* keys, const uint8_t* secret, size_t secretLen);
+
+/**
+ * Advance one epoch: new chain key, new traffic keys
+ */
+bool SessionKeys_ratchet(SessionKeys* keys);
+
+/**
+ * Ratchet steps a frame needs before it can be verified
+ * @return 0 (current keys) or 1 (next epoch); anything else is not a
+ *         frame of this session
+ */
+int32_t SessionKeys_stepsFor(const SessionKeys* keys, uint32_t sequenceNumber);
+
+/**
+ * Record an authenticated frame (anchors the epoch on the first one)
+ */
+void SessionKeys_accept(SessionKeys* keys, uint32_t sequenceNumber);
+
+/**
+ * ESP-NOW local master key for link-layer CCMP with this peer:
+ * HKDF-Expand(chain, "NA espnow lmk"). Taken when the session is
+ * installed; the driver key does not follow the ratchet.
+ * @return false if the session is not valid
+ */
+bool SessionKeys_linkKey(const SessionKeys* keys, uint8_t out[SESSION_LINK_KEY_SIZE]);
+
+/**
+ * Zero all key material
+ */
+void SessionKeys_wipe(SessionKeys* keys);
+
+#endif // SESSION_KEYS_H
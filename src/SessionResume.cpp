@@ -0,0 +1,167 @@
+#include "SessionResume.h"
+#include <string.h>
+
+/**
+ * SessionResume - Implementation
+ *
+ * Every derivation is one SessionKeys_hkdf() call; labels keep them
+ * independent of each other and of the SessionKeys labels.
+ *
+ * @file SessionResume.cpp
+ */
+
+static const char RESUME_SALT[] = "NA resume v1";
+
+static bool hkdf_label(const uint8_t* salt, size_t saltLen, const uint8_t* ikm, size_t ikmLen,
+                       const char* label, uint8_t* out, size_t outLen) {
+    return SessionKeys_hkdf(salt, saltLen, ikm, ikmLen, (const uint8_t*)label, strlen(label),
+                            out, outLen);
+}
+
+static bool tags_equal(const uint8_t* a, const uint8_t* b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+static void wipe_ticket(SessionTicket* ticket) {
+    volatile uint8_t* p = (volatile uint8_t*)ticket;
+    for (size_t i = 0; i < sizeof(*ticket); i++) p[i] = 0;
+}
+
+// ============================================================================
+// Derivations
+// ============================================================================
+
+bool SessionResume_deriveTicket(const SessionKeys* keys, uint8_t secret[SESSION_KEY_SIZE],
+                                uint8_t id[SESSION_RESUME_ID_SIZE]) {
+    // Only the handshake's own chain: both ends still have it at epoch 0
+    if (!keys->valid || keys->epoch != 0) return false;
+    const uint8_t* salt = (const uint8_t*)RESUME_SALT;
+    bool ok = hkdf_label(salt, strlen(RESUME_SALT), keys->chain, SESSION_KEY_SIZE,
+                         "NA resumption secret", secret, SESSION_KEY_SIZE) &&
+              hkdf_label(salt, strlen(RESUME_SALT), secret, SESSION_KEY_SIZE, "NA ticket id",
+                         id, SESSION_RESUME_ID_SIZE);
+    if (!ok) memset(secret, 0, SESSION_KEY_SIZE);
+    return ok;
+}
+
+bool SessionResume_binder(const uint8_t* secret, const uint8_t* id, const uint8_t* clientNonce,
+                          uint8_t tag[SESSION_RESUME_TAG_SIZE]) {
+    uint8_t msg[SESSION_RESUME_ID_SIZE + SESSION_RESUME_NONCE_SIZE];
+    memcpy(msg, id, SESSION_RESUME_ID_SIZE);
+    memcpy(msg + SESSION_RESUME_ID_SIZE, clientNonce, SESSION_RESUME_NONCE_SIZE);
+    return hkdf_label(secret, SESSION_KEY_SIZE, msg, sizeof(msg), "NA resume binder", tag,
+                      SESSION_RESUME_TAG_SIZE);
+}
+
+bool SessionResume_acceptTag(const uint8_t* secret, const uint8_t* id,
+                             const uint8_t* clientNonce, const uint8_t* vehicleNonce,
+                             uint8_t tag[SESSION_RESUME_TAG_SIZE]) {
+    uint8_t msg[SESSION_RESUME_ID_SIZE + 2 * SESSION_RESUME_NONCE_SIZE];
+    memcpy(msg, id, SESSION_RESUME_ID_SIZE);
+    memcpy(msg + SESSION_RESUME_ID_SIZE, clientNonce, SESSION_RESUME_NONCE_SIZE);
+    memcpy(msg + SESSION_RESUME_ID_SIZE + SESSION_RESUME_NONCE_SIZE, vehicleNonce,
+           SESSION_RESUME_NONCE_SIZE);
+    return hkdf_label(secret, SESSION_KEY_SIZE, msg, sizeof(msg), "NA resume accept", tag,
+                      SESSION_RESUME_TAG_SIZE);
+}
+
+bool SessionResume_deriveSession(const uint8_t* secret, const uint8_t* clientNonce,
+                                 const uint8_t* vehicleNonce, SessionKeys* keys) {
+    uint8_t salt[2 * SESSION_RESUME_NONCE_SIZE];
+    memcpy(salt, clientNonce, SESSION_RESUME_NONCE_SIZE);
+    memcpy(salt + SESSION_RESUME_NONCE_SIZE, vehicleNonce, SESSION_RESUME_NONCE_SIZE);
+    uint8_t next[SESSION_KEY_SIZE];
+    bool ok = hkdf_label(salt, sizeof(salt), secret, SESSION_KEY_SIZE, "NA resumed session",
+                         next, sizeof(next)) &&
+              SessionKeys_derive(keys, next, sizeof(next));
+    memset(next, 0, sizeof(next));
+    if (!ok) SessionKeys_wipe(keys);
+    return ok;
+}
+
+// ============================================================================
+// Ticket Table
+// ============================================================================
+
+void SessionResume_init(SessionResumeTable* table) {
+    for (int i = 0; i < SESSION_RESUME_MAX; i++) wipe_ticket(&table->tickets[i]);
+    table->issued = 0;
+    table->resumed = 0;
+    table->rejected = 0;
+}
+
+bool SessionResume_issue(SessionResumeTable* table, const uint8_t* mac, const SessionKeys* keys,
+                         uint32_t nowMs) {
+    SessionTicket next;
+    memset(&next, 0, sizeof(next));
+    if (!SessionResume_deriveTicket(keys, next.secret, next.id)) return false;
+    memcpy(next.mac, mac, 6);
+    next.issuedMs = nowMs;
+    next.used = true;
+
+    // Same MAC first, then a free slot, then the oldest
+    SessionTicket* slot = NULL;
+    for (int i = 0; i < SESSION_RESUME_MAX && !slot; i++) {
+        SessionTicket* t = &table->tickets[i];
+        if (t->used && memcmp(t->mac, mac, 6) == 0) slot = t;
+    }
+    for (int i = 0; i < SESSION_RESUME_MAX && !slot; i++) {
+        if (!table->tickets[i].used) slot = &table->tickets[i];
+    }
+    if (!slot) {
+        slot = &table->tickets[0];
+        for (int i = 1; i < SESSION_RESUME_MAX; i++) {
+            if ((int32_t)(table->tickets[i].issuedMs - slot->issuedMs) < 0)
+                slot = &table->tickets[i];
+        }
+    }
+    *slot = next;
+    wipe_ticket(&next);
+    table->issued++;
+    return true;
+}
+
+SessionResumeResult SessionResume_redeem(SessionResumeTable* table, const uint8_t* mac,
+                                         const uint8_t* id, const uint8_t* clientNonce,
+                                         const uint8_t* binder, const uint8_t* vehicleNonce,
+                                         uint32_t nowMs, SessionKeys* keys,
+                                         uint8_t acceptTag[SESSION_RESUME_TAG_SIZE]) {
+    SessionTicket* ticket = NULL;
+    for (int i = 0; i < SESSION_RESUME_MAX && !ticket; i++) {
+        SessionTicket* t = &table->tickets[i];
+        if (t->used && memcmp(t->mac, mac, 6) == 0 &&
+            memcmp(t->id, id, SESSION_RESUME_ID_SIZE) == 0)
+            ticket = t;
+    }
+    if (!ticket) {
+        table->rejected++;
+        return SESSION_RESUME_UNKNOWN;
+    }
+    if ((uint32_t)(nowMs - ticket->issuedMs) > SESSION_RESUME_LIFETIME_MS) {
+        wipe_ticket(ticket);
+        table->rejected++;
+        return SESSION_RESUME_EXPIRED;
+    }
+
+    uint8_t expected[SESSION_RESUME_TAG_SIZE];
+    if (!SessionResume_binder(ticket->secret, ticket->id, clientNonce, expected))
+        return SESSION_RESUME_FAILED;
+    if (!tags_equal(expected, binder, SESSION_RESUME_TAG_SIZE)) {
+        // Ids travel in the clear: a forged request must not burn the ticket
+        table->rejected++;
+        return SESSION_RESUME_BAD_TAG;
+    }
+
+    bool ok = SessionResume_acceptTag(ticket->secret, ticket->id, clientNonce, vehicleNonce,
+                                      acceptTag) &&
+              SessionResume_deriveSession(ticket->secret, clientNonce, vehicleNonce, keys);
+    // Single use, whatever happens next
+    wipe_ticket(ticket);
+    if (!ok) return SESSION_RESUME_FAILED;
+
+    SessionResume_issue(table, mac, keys, nowMs);
+    table->resumed++;
+    return SESSION_RESUME_OK;
+}
@@ -0,0 +1,124 @@
+#ifndef SESSION_RESUME_H
+#define SESSION_RESUME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SessionKeys.h"
+
+/**
+ * SessionResume - PSK-style resumption of an HKDF session without ECDH
+ *
+ * When a handshake session is installed, both ends derive from its
+ * epoch-0 chain key a resumption secret and a public ticket id:
+ *
+ *   secret = HKDF(salt "NA resume v1", chain, "NA resumption secret")
+ *   id     = HKDF(salt "NA resume v1", secret, "NA ticket id")[0..12]
+ *
+ * A reconnecting controller sends the id, a fresh nonce and a binder
+ * (proof it holds the secret); the vehicle answers with its own nonce
+ * and an accept tag, and both derive the next session:
+ *
+ *   binder = HKDF(salt secret, id | cNonce, "NA resume binder")[0..16]
+ *   accept = HKDF(salt secret, id | cNonce | vNonce, "NA resume accept")[0..16]
+ *   keys   = SessionKeys_derive(HKDF(salt cNonce | vNonce, secret,
+ *                                    "NA resumed session"))
+ *
+ * A ticket is bound to the sender's MAC, lives SESSION_RESUME_LIFETIME_MS
+ * and is single use: redeeming it replaces it with a ticket of the new
+ * session, so a replayed request finds nothing. Costs a handful of HMACs
+ * instead of two scalar multiplications.
+ *
+ * Pure: no globals, no RTOS. Callers serialize access to one table.
+ *
+ * @file SessionResume.h
+ */
+
+#define SESSION_RESUME_MAX          4           // PEER_SESSION_MAX
+#define SESSION_RESUME_ID_SIZE      12
+#define SESSION_RESUME_NONCE_SIZE   16
+#define SESSION_RESUME_TAG_SIZE     16
+#define SESSION_RESUME_LIFETIME_MS  3600000UL   // 1 h from the handshake
+
+typedef enum {
+    SESSION_RESUME_OK = 0,
+    SESSION_RESUME_UNKNOWN = 1,     // No ticket with this id for this MAC
+    SESSION_RESUME_EXPIRED = 2,
+    SESSION_RESUME_BAD_TAG = 3,     // Binder does not match (ticket kept)
+    SESSION_RESUME_FAILED = 4       // Key derivation failed
+} SessionResumeResult;
+
+typedef struct {
+    uint8_t mac[6];
+    uint8_t id[SESSION_RESUME_ID_SIZE];
+    uint8_t secret[SESSION_KEY_SIZE];
+    uint32_t issuedMs;
+    bool used;
+} SessionTicket;
+
+typedef struct {
+    SessionTicket tickets[SESSION_RESUME_MAX];
+    uint32_t issued;
+    uint32_t resumed;
+    uint32_t rejected;
+} SessionResumeTable;
+
+// ============================================================================
+// Derivations (both ends)
+// ============================================================================
+
+/**
+ * Resumption secret and ticket id of an epoch-0 HKDF session
+ */
+bool SessionResume_deriveTicket(const SessionKeys* keys, uint8_t secret[SESSION_KEY_SIZE],
+                                uint8_t id[SESSION_RESUME_ID_SIZE]);
+
+/**
+ * Controller's proof of the secret
+ */
+bool SessionResume_binder(const uint8_t* secret, const uint8_t* id, const uint8_t* clientNonce,
+                          uint8_t tag[SESSION_RESUME_TAG_SIZE]);
+
+/**
+ * Vehicle's proof of the secret (binds both nonces)
+ */
+bool SessionResume_acceptTag(const uint8_t* secret, const uint8_t* id,
+                             const uint8_t* clientNonce, const uint8_t* vehicleNonce,
+                             uint8_t tag[SESSION_RESUME_TAG_SIZE]);
+
+/**
+ * Keys of the resumed session
+ */
+bool SessionResume_deriveSession(const uint8_t* secret, const uint8_t* clientNonce,
+                                 const uint8_t* vehicleNonce, SessionKeys* keys);
+
+// ============================================================================
+// Ticket Table (vehicle)
+// ============================================================================
+
+/**
+ * Empty the table (wipes every secret)
+ */
+void SessionResume_init(SessionResumeTable* table);
+
+/**
+ * Issue (or replace) the ticket of a MAC from its new session
+ * When full, the oldest ticket is dropped.
+ * @return false: not an epoch-0 HKDF session, no ticket
+ */
+bool SessionResume_issue(SessionResumeTable* table, const uint8_t* mac, const SessionKeys* keys,
+                         uint32_t nowMs);
+
+/**
+ * Redeem a ticket: check the binder, derive the new session, answer
+ * On OK the ticket is replaced by one of the new session.
+ * @param vehicleNonce Fresh random nonce for the answer
+ * @param keys         New session (OK only)
+ * @param acceptTag    Tag for the answer (OK only)
+ */
+SessionResumeResult SessionResume_redeem(SessionResumeTable* table, const uint8_t* mac,
+                                         const uint8_t* id, const uint8_t* clientNonce,
+                                         const uint8_t* binder, const uint8_t* vehicleNonce,
+                                         uint32_t nowMs, SessionKeys* keys,
+                                         uint8_t acceptTag[SESSION_RESUME_TAG_SIZE]);
+
+#endif // SESSION_RESUME_H
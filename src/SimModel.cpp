@@ -0,0 +1,299 @@
+#include "SimModel.h"
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * SimModel - Implementation
+ *
+ * @file SimModel.cpp
+ */
+
+#define TWO_PI_F 6.28318531f
+
+static const char* const KIND_NAMES[SIM_KIND_COUNT] = {"rover", "boat", "sub", "copter"};
+
+// ============================================================================
+// Noise
+// ============================================================================
+
+static uint32_t nextRandom(SimModel* model) {
+    uint32_t x = model->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    model->rng = x;
+    return x;
+}
+
+// Sum of four uniforms: close enough to a gaussian for sensor noise
+static float gaussian(SimModel* model, float sigma) {
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) sum += (nextRandom(model) >> 8) * (1.0f / 16777216.0f);
+    return (sum - 2.0f) * 1.7320508f * sigma;
+}
+
+static float wrapAngle(float a) {
+    while (a >= TWO_PI_F) a -= TWO_PI_F;
+    while (a < 0.0f) a += TWO_PI_F;
+    return a;
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void SimModel_defaultParams(SimKind kind, SimParams* p) {
+    memset(p, 0, sizeof(*p));
+    p->kind = kind;
+    switch (kind) {
+    case SIM_ROVER:
+        p->mass = 2.0f;
+        p->maxSpeed = 1.5f;
+        p->motorTau = 0.15f;
+        p->track = 0.25f;
+        break;
+    case SIM_BOAT:
+        p->mass = 3.0f;
+        p->maxThrust = 5.0f;            // Top speed 10 N / 6 = 1.7 m/s
+        p->motorTau = 0.2f;
+        p->track = 0.2f;
+        p->surgeDrag = 6.0f;
+        p->swayDrag = 30.0f;
+        p->yawInertia = 0.15f;
+        p->yawDrag = 0.4f;
+        break;
+    case SIM_SUB:
+        p->mass = 12.0f;
+        p->maxThrust = 20.0f;
+        p->motorTau = 0.2f;
+        p->surgeDrag = 25.0f;
+        p->swayDrag = 40.0f;
+        p->heaveDrag = 40.0f;
+        p->yawInertia = 0.5f;
+        p->yawDrag = 2.0f;
+        p->buoyancy = 2.0f;             // Trimmed slightly positive
+        ThrustAllocator_defaultConfig(&p->thrusters);
+        break;
+    case SIM_COPTER:
+    default:
+        p->mass = 1.0f;
+        p->maxThrust = 5.0f;            // Thrust / weight 2
+        p->motorTau = 0.05f;
+        p->surgeDrag = 0.3f;
+        p->heaveDrag = 0.5f;
+        p->yawInertia = 0.02f;
+        p->yawDrag = 0.02f;
+        p->tiltInertia = 0.01f;
+        p->tiltDrag = 0.02f;
+        p->armLength = 0.12f;
+        p->yawTorque = 0.02f;
+        break;
+    }
+}
+
+void SimModel_init(SimModel* model, const SimParams* params, int32_t originLat,
+                   int32_t originLng, uint32_t seed) {
+    memset(model, 0, sizeof(*model));
+    model->params = *params;
+    NavFrame_init(&model->frame, originLat, originLng);
+    model->rng = seed ? seed : 0x2545F491u;
+    model->gpsNoiseM = 0.3f;
+    model->gyroNoise = 0.002f;
+    model->depthNoiseM = 0.005f;
+}
+
+SimKind SimModel_kindFromName(const char* name) {
+    for (int k = 0; name && k < SIM_KIND_COUNT; k++) {
+        if (strcasecmp(name, KIND_NAMES[k]) == 0) return (SimKind)k;
+    }
+    return SIM_KIND_COUNT;
+}
+
+// ============================================================================
+// Dynamics
+// ============================================================================
+
+static void stepRover(SimModel* model, float dt) {
+    const SimParams* p = &model->params;
+    SimState* s = &model->state;
+    float left = s->outputs[0] * p->maxSpeed;
+    float right = s->outputs[1] * p->maxSpeed;
+    float speed = 0.5f * (left + right);
+    s->rates[2] = p->track > 0.0f ? (left - right) / p->track : 0.0f;
+    s->yaw = wrapAngle(s->yaw + s->rates[2] * dt);
+    s->velN = speed * cosf(s->yaw);
+    s->velE = speed * sinf(s->yaw);
+}
+
+// Surge / sway / yaw on water (BOAT and SUB): body velocities through the
+// water, Coriolis coupling of a rigid hull, current added on top
+static void stepHull(SimModel* model, float surgeForce, float swayForce, float yawTorque,
+                     float dt) {
+    const SimParams* p = &model->params;
+    SimState* s = &model->state;
+    float c = cosf(s->yaw);
+    float sn = sinf(s->yaw);
+    float waterN = s->velN - p->currentN;
+    float waterE = s->velE - p->currentE;
+    float u = waterN * c + waterE * sn;
+    float v = -waterN * sn + waterE * c;
+    float r = s->rates[2];
+
+    u += ((surgeForce - p->surgeDrag * u) / p->mass + v * r) * dt;
+    v += ((swayForce - p->swayDrag * v) / p->mass - u * r) * dt;
+    r += (yawTorque - p->yawDrag * r) / p->yawInertia * dt;
+
+    s->rates[2] = r;
+    s->yaw = wrapAngle(s->yaw + r * dt);
+    c = cosf(s->yaw);
+    sn = sinf(s->yaw);
+    s->velN = u * c - v * sn + p->currentN;
+    s->velE = u * sn + v * c + p->currentE;
+}
+
+static void stepBoat(SimModel* model, float dt) {
+    const SimParams* p = &model->params;
+    float left = model->state.outputs[0] * p->maxThrust;
+    float right = model->state.outputs[1] * p->maxThrust;
+    stepHull(model, left + right, 0.0f, (left - right) * 0.5f * p->track, dt);
+}
+
+static void stepSub(SimModel* model, float dt) {
+    const SimParams* p = &model->params;
+    SimState* s = &model->state;
+    float wrench[MIXER_AXIS_COUNT] = {0};
+    uint8_t n = p->thrusters.count < SIM_MAX_OUTPUTS ? p->thrusters.count : SIM_MAX_OUTPUTS;
+    for (uint8_t i = 0; i < n; i++) {
+        float column[MIXER_AXIS_COUNT];
+        ThrustAllocator_effectiveness(&p->thrusters.thrusters[i], column);
+        for (int axis = 0; axis < MIXER_AXIS_COUNT; axis++)
+            wrench[axis] += column[axis] * s->outputs[i] * p->maxThrust;
+    }
+    stepHull(model, wrench[MIXER_FORWARD], wrench[MIXER_LATERAL], wrench[MIXER_YAW], dt);
+
+    float up = wrench[MIXER_THRUST] + p->buoyancy;
+    s->velD += (-up - p->heaveDrag * s->velD) / p->mass * dt;
+    if (s->down + s->velD * dt < 0.0f && s->velD < 0.0f) {
+        s->velD = 0.0f;         // Broke the surface: floats there
+        s->down = 0.0f;
+    }
+}
+
+static void stepCopter(SimModel* model, float dt) {
+    const SimParams* p = &model->params;
+    SimState* s = &model->state;
+    float fr = s->outputs[0] * p->maxThrust;
+    float fl = s->outputs[1] * p->maxThrust;
+    float bl = s->outputs[2] * p->maxThrust;
+    float br = s->outputs[3] * p->maxThrust;
+    float thrust = fr + fl + bl + br;
+
+    // Torques: roll right, nose up and nose right are positive (MotorMixer)
+    float torque[3] = {p->armLength * (fl + bl - fr - br),
+                       p->armLength * (fr + fl - bl - br),
+                       p->yawTorque * (fl + br - fr - bl)};
+    float inertia[3] = {p->tiltInertia, p->tiltInertia, p->yawInertia};
+    float drag[3] = {p->tiltDrag, p->tiltDrag, p->yawDrag};
+    for (int axis = 0; axis < 3; axis++)
+        s->rates[axis] += (torque[axis] - drag[axis] * s->rates[axis]) / inertia[axis] * dt;
+
+    // Euler angle rates (ZYX)
+    float sr = sinf(s->roll), cr = cosf(s->roll);
+    float cp = cosf(s->pitch), tp = tanf(s->pitch);
+    float pr = s->rates[0], q = s->rates[1], r = s->rates[2];
+    s->roll += (pr + (q * sr + r * cr) * tp) * dt;
+    s->pitch += (q * cr - r * sr) * dt;
+    s->yaw = wrapAngle(s->yaw + (q * sr + r * cr) / cp * dt);
+
+    // Thrust along body -z in NED
+    sr = sinf(s->roll);
+    cr = cosf(s->roll);
+    float sp = sinf(s->pitch);
+    cp = cosf(s->pitch);
+    float sy = sinf(s->yaw), cy = cosf(s->yaw);
+    float zN = cy * sp * cr + sy * sr;
+    float zE = sy * sp * cr - cy * sr;
+    float zD = cp * cr;
+    s->velN += (-thrust * zN - p->surgeDrag * s->velN) / p->mass * dt;
+    s->velE += (-thrust * zE - p->surgeDrag * s->velE) / p->mass * dt;
+    s->velD += (SIM_GRAVITY - (thrust * zD + p->heaveDrag * s->velD) / p->mass) * dt;
+
+    // On the ground: no sinking, no sliding, no tipping over
+    if (s->down + s->velD * dt >= 0.0f && s->velD >= 0.0f) {
+        s->down = 0.0f;
+        s->velN = s->velE = s->velD = 0.0f;
+        s->roll = s->pitch = 0.0f;
+        s->rates[0] = s->rates[1] = 0.0f;
+    }
+}
+
+void SimModel_step(SimModel* model, const float* outputs, uint8_t count, float dt) {
+    if (dt <= 0.0f) return;
+    SimState* s = &model->state;
+    float k = model->params.motorTau > dt ? dt / model->params.motorTau : 1.0f;
+    for (uint8_t i = 0; i < SIM_MAX_OUTPUTS; i++) {
+        float cmd = i < count && outputs ? outputs[i] : 0.0f;
+        if (cmd > 1.0f) cmd = 1.0f;
+        if (cmd < -1.0f) cmd = -1.0f;
+        s->outputs[i] += (cmd - s->outputs[i]) * k;
+    }
+
+    switch (model->params.kind) {
+    case SIM_ROVER: stepRover(model, dt); break;
+    case SIM_BOAT: stepBoat(model, dt); break;
+    case SIM_SUB: stepSub(model, dt); break;
+    case SIM_COPTER: stepCopter(model, dt); break;
+    default: break;
+    }
+
+    s->north += s->velN * dt;
+    s->east += s->velE * dt;
+    s->down += s->velD * dt;
+    s->timeS += dt;
+}
+
+// ============================================================================
+// Sensors
+// ============================================================================
+
+void SimModel_gps(SimModel* model, uint32_t nowMs, GPSFix* fix) {
+    const SimState* s = &model->state;
+    memset(fix, 0, sizeof(*fix));
+    NavVector point = {s->east + gaussian(model, model->gpsNoiseM),
+                       s->north + gaussian(model, model->gpsNoiseM)};
+    NavFrame_toGlobal(&model->frame, point, &fix->lat, &fix->lng);
+    fix->altMsl = (int32_t)(-s->down * 1000.0f);
+    fix->velN = (int32_t)(s->velN * 1000.0f);
+    fix->velE = (int32_t)(s->velE * 1000.0f);
+    fix->velD = (int32_t)(s->velD * 1000.0f);
+    float speed = sqrtf(s->velN * s->velN + s->velE * s->velE);
+    fix->groundSpeed = (int32_t)(speed * 1000.0f);
+
+    // Heading of motion: meaningless at rest, the receiver holds the last one
+    if (speed > 0.2f) model->course = wrapAngle(atan2f(s->velE, s->velN));
+    else if (s->timeS == 0.0f) model->course = s->yaw;
+    fix->course = (int32_t)(model->course * (180.0f / (float)M_PI) * 1e5f);
+
+    fix->hAcc = (uint32_t)(model->gpsNoiseM * 2000.0f);
+    fix->vAcc = fix->hAcc * 2;
+    fix->sAcc = 100;
+    fix->iTOW = nowMs;
+    fix->timeMs = nowMs;
+    fix->fixType = 3;
+    fix->numSV = 12;
+    fix->valid = true;
+}
+
+void SimModel_attitude(SimModel* model, SimAttitude* attitude) {
+    const SimState* s = &model->state;
+    attitude->roll = s->roll;
+    attitude->pitch = s->pitch;
+    attitude->heading = s->yaw;
+    for (int axis = 0; axis < 3; axis++)
+        attitude->rates[axis] = s->rates[axis] + gaussian(model, model->gyroNoise);
+}
+
+float SimModel_depth(SimModel* model) {
+    return model->state.down + gaussian(model, model->depthNoiseM);
+}
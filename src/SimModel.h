@@ -0,0 +1,138 @@
+#ifndef SIM_MODEL_H
+#define SIM_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NavFrame.h"
+#include "ThrustAllocator.h"
+#include "UBXParser.h"
+
+/**
+ * SimModel - Vehicle dynamics and synthetic sensors for the SITL build
+ *
+ * Just enough physics to close the real control loops on the host: the
+ * vehicle classes drive their outputs as on target, the SITL reads them
+ * back as signed commands (-1..1 per output slot, the vehicle's hardware
+ * profile order) and SimModel_step() turns them into motion:
+ *
+ *   ROVER   left / right wheels at up to maxSpeed, no slip, first-order
+ *           motor lag
+ *   BOAT    left / right thrusters (same outputs as the Rover): surge and
+ *           sway drag, yaw damping, a water current carrying the hull
+ *   SUB     any ThrustAllocator layout (its geometry gives each
+ *           thruster's wrench), heave, net buoyancy, the surface as a
+ *           limit; stays level
+ *   COPTER  QuadX (MotorMixer order FR, FL, BL, BR), thrust along the
+ *           body, roll / pitch / yaw torques, ground contact
+ *
+ * World frame is NED about the origin; yaw is the compass heading
+ * (radians, clockwise from north), body rates are x forward, y right,
+ * z down. Integration is semi-implicit Euler at the caller's step (the
+ * SITL uses the control period). The sensors add seeded noise, so a run
+ * is repeatable bit for bit.
+ *
+ * @file SimModel.h
+ */
+
+#define SIM_GRAVITY             9.80665f
+#define SIM_MAX_OUTPUTS         8
+
+typedef enum {
+    SIM_ROVER = 0,
+    SIM_BOAT,
+    SIM_SUB,
+    SIM_COPTER,
+    SIM_KIND_COUNT
+} SimKind;
+
+typedef struct {
+    SimKind kind;
+    float mass;                 // kg
+    float maxThrust;            // N per output at full command (not ROVER)
+    float maxSpeed;             // m/s wheel speed at full command (ROVER)
+    float motorTau;             // s, output lag
+    float track;                // m, wheel / thruster spacing (ROVER, BOAT)
+    float surgeDrag;            // N per m/s
+    float swayDrag;             // N per m/s (BOAT, SUB)
+    float heaveDrag;            // N per m/s (SUB, COPTER)
+    float yawInertia;           // kg m^2
+    float yawDrag;              // N m per rad/s
+    float tiltInertia;          // kg m^2, roll / pitch (COPTER)
+    float tiltDrag;             // N m per rad/s (COPTER)
+    float armLength;            // m, motor to centre along each axis (COPTER)
+    float yawTorque;            // N m per N of thrust, prop drag (COPTER)
+    float buoyancy;             // N, net upward force (SUB, + floats)
+    float currentN, currentE;   // m/s, water current (BOAT, SUB)
+    ThrustConfig thrusters;     // SUB layout
+} SimParams;
+
+typedef struct {
+    float north, east, down;    // m from the origin
+    float velN, velE, velD;     // m/s
+    float roll, pitch, yaw;     // rad, yaw = heading
+    float rates[3];             // rad/s body p q r
+    float outputs[SIM_MAX_OUTPUTS];     // Lagged commands actually applied
+    float timeS;
+} SimState;
+
+typedef struct {
+    SimParams params;
+    SimState state;
+    NavFrame frame;             // Origin of north / east
+    uint32_t rng;
+    float course;               // rad, last GPS heading of motion
+    float gpsNoiseM;            // 1-sigma horizontal position noise
+    float gyroNoise;            // rad/s, 1-sigma
+    float depthNoiseM;
+} SimModel;
+
+/**
+ * Synthetic IMU / attitude solution
+ */
+typedef struct {
+    float roll, pitch, heading; // rad
+    float rates[3];             // rad/s body p q r
+} SimAttitude;
+
+/**
+ * Defaults for a kind: a ~2 kg rover / RC boat / small ROV / 1 kg quad
+ */
+void SimModel_defaultParams(SimKind kind, SimParams* params);
+
+/**
+ * Reset to rest at the origin, heading north
+ * @param seed Noise seed (0 is replaced, xorshift needs a non-zero state)
+ */
+void SimModel_init(SimModel* model, const SimParams* params, int32_t originLat,
+                   int32_t originLng, uint32_t seed);
+
+/**
+ * Advance by dt with the given output commands
+ * @param outputs Signed commands -1..1, hardware profile order
+ * @param count Outputs given (missing ones are 0)
+ */
+void SimModel_step(SimModel* model, const float* outputs, uint8_t count, float dt);
+
+/**
+ * Position / velocity fix as the GPS driver would publish it
+ * @param nowMs millis() stamp for fix.timeMs
+ */
+void SimModel_gps(SimModel* model, uint32_t nowMs, GPSFix* fix);
+
+/**
+ * Attitude with gyro noise
+ */
+void SimModel_attitude(SimModel* model, SimAttitude* attitude);
+
+/**
+ * Depth below the surface with sensor noise, m (SUB)
+ */
+float SimModel_depth(SimModel* model);
+
+/**
+ * Kind from its name ("rover", "boat", "sub", "copter")
+ * @return SIM_KIND_COUNT if unknown
+ */
+SimKind SimModel_kindFromName(const char* name);
+
+#endif // SIM_MODEL_H
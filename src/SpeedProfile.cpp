@@ -0,0 +1,91 @@
+#include "SpeedProfile.h"
+#include <math.h>
+
+/**
+ * SpeedProfile - Implementation
+ *
+ * The jerk-limited follower aims for the acceleration from which a ramp
+ * at the jerk limit brings it to zero exactly as the speed reaches the
+ * target (a = sqrt(2 * jerk * |error|)), capped at the acceleration
+ * limit; the acceleration itself then moves towards that aim by at most
+ * jerk * dt per tick.
+ *
+ * @file SpeedProfile.cpp
+ */
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void SpeedProfile_defaults(SpeedProfileConfig* config) {
+    config->enabled = true;
+    config->accel = SPEED_PROFILE_ACCEL;
+    config->jerk = SPEED_PROFILE_JERK;
+    config->brakeM = SPEED_PROFILE_BRAKE_M;
+    config->minFraction = SPEED_PROFILE_MIN_FRACTION;
+}
+
+void SpeedProfile_sanitize(SpeedProfileConfig* config) {
+    config->accel = clampf(config->accel, 50.0f, 10000.0f);
+    config->jerk = clampf(config->jerk, 50.0f, 100000.0f);
+    config->brakeM = clampf(config->brakeM, 0.0f, 100.0f);
+    config->minFraction = clampf(config->minFraction, 0.05f, 1.0f);
+}
+
+float SpeedProfile_cornerFraction(const SpeedProfileConfig* config, float turnDeg) {
+    float half = fabsf(turnDeg) * (float)M_PI / 360.0f;
+    float c = cosf(half > (float)M_PI_2 ? (float)M_PI_2 : half);
+    return config->minFraction + (1.0f - config->minFraction) * c * c;
+}
+
+void SpeedProfile_planLeg(const SpeedProfileConfig* config, float legSpeed, float nextSpeed,
+                          float turnDeg, SpeedLegPlan* plan) {
+    float speed = clampf(legSpeed, 0.0f, SPEED_PROFILE_MAX);
+    float corner;
+    if (nextSpeed < 0.0f) {
+        corner = speed * config->minFraction;
+    } else {
+        float next = clampf(nextSpeed, 0.0f, SPEED_PROFILE_MAX);
+        corner = (next < speed ? next : speed) * SpeedProfile_cornerFraction(config, turnDeg);
+    }
+    plan->speed = speed;
+    plan->cornerSpeed = corner;
+    // Constant deceleration: distance goes with the drop in v^2
+    plan->brakeM = config->brakeM * (speed * speed - corner * corner) /
+                   (SPEED_PROFILE_MAX * SPEED_PROFILE_MAX);
+}
+
+float SpeedProfile_target(const SpeedLegPlan* plan, float distToTurnM) {
+    if (distToTurnM >= plan->brakeM || plan->brakeM <= 0.0f)
+        return plan->speed;
+    if (distToTurnM <= 0.0f)
+        return plan->cornerSpeed;
+    float c2 = plan->cornerSpeed * plan->cornerSpeed;
+    float v2 = c2 + (plan->speed * plan->speed - c2) * (distToTurnM / plan->brakeM);
+    return sqrtf(v2);
+}
+
+float SpeedProfile_step(const SpeedProfileConfig* config, SpeedProfileState* state,
+                        float target, float dt) {
+    float error = target - state->speed;
+    float aim = sqrtf(2.0f * config->jerk * fabsf(error));
+    if (aim > config->accel) aim = config->accel;
+    if (error < 0.0f) aim = -aim;
+
+    float maxDa = config->jerk * dt;
+    state->accel += clampf(aim - state->accel, -maxDa, maxDa);
+    float next = state->speed + state->accel * dt;
+
+    // Arrived (or crossed over): settle without ringing around the target
+    if ((error >= 0.0f && next >= target) || (error <= 0.0f && next <= target)) {
+        next = target;
+        state->accel = 0.0f;
+    }
+    state->speed = next;
+    return next;
+}
+
+void SpeedProfile_reset(SpeedProfileState* state, float speed) {
+    state->speed = speed;
+    state->accel = 0.0f;
+}
@@ -0,0 +1,104 @@
+#ifndef SPEED_PROFILE_H
+#define SPEED_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * SpeedProfile - Jerk-limited waypoint speed with corner slow-down
+ *
+ * Speeds are in throttle units (the waypoint "speed"). When a leg is
+ * loaded, SpeedProfile_planLeg() works out once how fast the vehicle may
+ * take the turn at its end, from the angle between this leg and the
+ * next and the slower of their speeds, and how far before the turn it
+ * has to start braking. A sharp turn, a loiter point or the end of the
+ * path are entered at minFraction of the leg speed, a straight-on
+ * waypoint at full speed:
+ *
+ *   corner = min(leg, next) * (minFraction + (1 - minFraction) * cos^2(turn / 2))
+ *
+ * Every control tick SpeedProfile_target() gives the allowed speed at
+ * the distance left to the turn (constant deceleration: v^2 falls
+ * linearly over the braking distance) and SpeedProfile_step() moves the
+ * commanded speed towards it with bounded acceleration and jerk, so a
+ * leg change, a mission start from rest or a braking point is a smooth
+ * ramp instead of a throttle step.
+ *
+ * Pure: no globals, no RTOS.
+ *
+ * @file SpeedProfile.h
+ */
+
+// Defaults (Tunable; -D overrides, e.g. from a SITL sweep)
+#ifndef SPEED_PROFILE_ACCEL
+#define SPEED_PROFILE_ACCEL         800.0f  // Throttle units / s
+#endif
+#ifndef SPEED_PROFILE_JERK
+#define SPEED_PROFILE_JERK          2000.0f // Throttle units / s^2
+#endif
+#ifndef SPEED_PROFILE_BRAKE_M
+#define SPEED_PROFILE_BRAKE_M       6.0f    // Full stop distance from SPEED_PROFILE_MAX
+#endif
+#ifndef SPEED_PROFILE_MIN_FRACTION
+#define SPEED_PROFILE_MIN_FRACTION  0.5f    // Of the leg speed, for a hairpin
+#endif
+#define SPEED_PROFILE_MAX           1000.0f // Mixer full scale: faster legs saturate
+
+typedef struct {
+    bool enabled;           // Off: the leg speed is output as is
+    float accel;            // Max |dv/dt|, throttle units / s
+    float jerk;             // Max |d2v/dt2|, throttle units / s^2
+    float brakeM;           // Braking distance from SPEED_PROFILE_MAX to 0, m
+    float minFraction;      // Corner speed of a hairpin / path end, 0-1
+} SpeedProfileConfig;
+
+/**
+ * Per-leg data, computed when the leg is loaded
+ */
+typedef struct {
+    float speed;            // Cruise, clamped to SPEED_PROFILE_MAX
+    float cornerSpeed;      // Entry speed of the turn at the leg's end
+    float brakeM;           // Distance before the turn where braking starts
+} SpeedLegPlan;
+
+typedef struct {
+    float speed;            // Commanded, throttle units
+    float accel;            // Current dv/dt
+} SpeedProfileState;
+
+void SpeedProfile_defaults(SpeedProfileConfig* config);
+
+/**
+ * Clamp a config into sane ranges (in place)
+ */
+void SpeedProfile_sanitize(SpeedProfileConfig* config);
+
+/**
+ * Corner speed factor for a turn of turnDeg (0 = straight on, 180 = back)
+ */
+float SpeedProfile_cornerFraction(const SpeedProfileConfig* config, float turnDeg);
+
+/**
+ * Plan a leg
+ * @param nextSpeed Speed of the following leg, negative if the path ends
+ *                  (or stops) at this leg's target
+ * @param turnDeg Heading change onto the following leg
+ */
+void SpeedProfile_planLeg(const SpeedProfileConfig* config, float legSpeed, float nextSpeed,
+                          float turnDeg, SpeedLegPlan* plan);
+
+/**
+ * Allowed speed with distToTurnM left before the turn
+ */
+float SpeedProfile_target(const SpeedLegPlan* plan, float distToTurnM);
+
+/**
+ * Advance the commanded speed one tick towards target
+ * @return New commanded speed
+ */
+float SpeedProfile_step(const SpeedProfileConfig* config, SpeedProfileState* state,
+                        float target, float dt);
+
+void SpeedProfile_reset(SpeedProfileState* state, float speed);
+
+#endif // SPEED_PROFILE_H
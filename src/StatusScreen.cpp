@@ -0,0 +1,90 @@
+#include "StatusScreen.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * StatusScreen - Implementation
+ *
+ * @file StatusScreen.cpp
+ */
+
+#define LINE_SIZE   (STATUS_SCREEN_COLUMNS + 1)
+
+const char* StatusScreen_mode(const StatusScreenData* data) {
+    if (data->rtlActive) return "RTL";
+    if (data->following) return "FOLLOW";
+    if (data->surveyActive) return "SURVEY";
+    if (data->loitering) return "LOITER";
+    if (data->missionActive) return "AUTO";
+    return "MANUAL";
+}
+
+static const char* linkLabel(StatusLink link) {
+    switch (link) {
+        case STATUS_LINK_OK: return "OK";
+        case STATUS_LINK_LOST: return "LOST";
+        case STATUS_LINK_FAILSAFE: return "FAILSAFE";
+        default: return "--";
+    }
+}
+
+void StatusScreen_format(const StatusScreenData* data,
+                         char lines[STATUS_SCREEN_ROWS][STATUS_SCREEN_COLUMNS + 1]) {
+    for (int i = 0; i < STATUS_SCREEN_ROWS; i++) lines[i][0] = '\0';
+
+    const char* mode = StatusScreen_mode(data);
+    int nameWidth = STATUS_SCREEN_COLUMNS - (int)strlen(mode);
+    snprintf(lines[0], LINE_SIZE, "%-*.*s%s", nameWidth, nameWidth - 1,
+             data->vehicle ? data->vehicle : "", mode);
+
+    if (data->batteryValid) {
+        // Centivolts, so the reading only moves in 10 mV steps
+        unsigned cv = (data->millivolts + 5) / 10;
+        snprintf(lines[1], LINE_SIZE, "BAT %u.%02uV %3u%%", cv / 100, cv % 100,
+                 (unsigned)data->percent);
+    } else {
+        snprintf(lines[1], LINE_SIZE, "BAT --");
+    }
+
+    snprintf(lines[2], LINE_SIZE, "LINK %s", linkLabel(data->link));
+
+    if (!data->gpsValid) {
+        snprintf(lines[3], LINE_SIZE, "GPS --");
+    } else if (data->fixType < 2) {
+        snprintf(lines[3], LINE_SIZE, "GPS NO FIX %usv", (unsigned)data->numSV);
+    } else if (data->carrSoln == 2) {
+        unsigned cm = (unsigned)((data->hAccMm + 5) / 10);
+        if (cm > 999) cm = 999;
+        snprintf(lines[3], LINE_SIZE, "GPS RTK %usv %ucm", (unsigned)data->numSV, cm);
+    } else {
+        unsigned dm = (unsigned)((data->hAccMm + 50) / 100);
+        if (dm > 999) dm = 999;
+        if (data->carrSoln == 1) {
+            snprintf(lines[3], LINE_SIZE, "GPS FLT %usv %u.%um", (unsigned)data->numSV,
+                     dm / 10, dm % 10);
+        } else {
+            snprintf(lines[3], LINE_SIZE, "GPS %uD %usv %u.%um", (unsigned)data->fixType,
+                     (unsigned)data->numSV, dm / 10, dm % 10);
+        }
+    }
+
+    if (data->rtlActive || data->missionActive) {
+        unsigned m = data->distanceM < 0.0f ? 0u
+                   : data->distanceM > 99999.0f ? 99999u
+                   : (unsigned)(data->distanceM + 0.5f);
+        if (data->rtlActive) {
+            snprintf(lines[4], LINE_SIZE, "HOME %um", m);
+        } else {
+            snprintf(lines[4], LINE_SIZE, "WP %u/%u %um", (unsigned)data->waypointIndex + 1,
+                     (unsigned)data->waypointCount, m);
+        }
+    } else if (data->waypointCount) {
+        snprintf(lines[4], LINE_SIZE, "WP %u loaded", (unsigned)data->waypointCount);
+    } else {
+        snprintf(lines[4], LINE_SIZE, "WP --");
+    }
+
+    uint32_t s = data->uptimeS;
+    snprintf(lines[7], LINE_SIZE, "UP %02lu:%02lu:%02lu", (unsigned long)(s / 3600 % 100),
+             (unsigned long)(s / 60 % 60), (unsigned long)(s % 60));
+}
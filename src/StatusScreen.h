@@ -0,0 +1,72 @@
+#ifndef STATUS_SCREEN_H
+#define STATUS_SCREEN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * StatusScreen - Text layout of the hull status display
+ *
+ * Turns a snapshot of the vehicle state into 8 rows of at most 21
+ * characters (the SSD1306 text grid):
+ *
+ *   0  ROVER           AUTO     vehicle, mode
+ *   1  BAT 11.84V  78%          sag compensated percent
+ *   2  LINK OK                  OK / LOST / FAILSAFE / -- (none yet)
+ *   3  GPS 3D 12sv 1.4m         fix, satellites, horizontal accuracy
+ *   4  WP 3/12 45m              item, count, distance to target
+ *   7  UP 01:02:03
+ *
+ * Fields that are not known yet print as "--". Values are rounded to
+ * what a glance needs, so the text (and with it the I2C traffic) only
+ * changes when something worth reading does.
+ *
+ * Plain struct, no hardware.
+ *
+ * @file StatusScreen.h
+ */
+
+#define STATUS_SCREEN_ROWS      8
+#define STATUS_SCREEN_COLUMNS   21
+
+typedef enum {
+    STATUS_LINK_NONE = 0,       // No packet since boot
+    STATUS_LINK_OK,
+    STATUS_LINK_LOST,           // Signal loss, short
+    STATUS_LINK_FAILSAFE        // Emergency failsafe
+} StatusLink;
+
+typedef struct {
+    const char* vehicle;        // e.g. "ROVER"
+    StatusLink link;
+    bool batteryValid;
+    uint16_t millivolts;
+    uint8_t percent;
+    bool gpsValid;              // A fix message has arrived
+    uint8_t fixType;            // 0 none, 2 2D, 3 3D
+    uint8_t numSV;
+    uint8_t carrSoln;           // RTK: 0 none, 1 float, 2 fixed (GPS_CARR_*)
+    uint32_t hAccMm;
+    bool missionActive;
+    bool rtlActive;
+    bool loitering;
+    bool surveyActive;
+    bool following;
+    uint16_t waypointIndex;     // 0-based
+    uint16_t waypointCount;
+    float distanceM;            // To the current target
+    uint32_t uptimeS;
+} StatusScreenData;
+
+/**
+ * Mode label: RTL, FOLLOW, SURVEY, LOITER, AUTO or MANUAL
+ */
+const char* StatusScreen_mode(const StatusScreenData* data);
+
+/**
+ * Lay out all rows (unused rows are empty strings)
+ */
+void StatusScreen_format(const StatusScreenData* data,
+                         char lines[STATUS_SCREEN_ROWS][STATUS_SCREEN_COLUMNS + 1]);
+
+#endif // STATUS_SCREEN_H
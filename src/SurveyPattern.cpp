@@ -0,0 +1,183 @@
+#include "SurveyPattern.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * SurveyPattern - Implementation
+ *
+ * @file SurveyPattern.cpp
+ */
+
+#define SURVEY_RAD_PER_DEG      0.01745329252f
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+/**
+ * Track coordinates back to the local frame
+ */
+static NavVector to_local(const SurveyPattern* s, float along, float cross) {
+    NavVector v;
+    v.east = along * s->sinH + cross * s->cosH;
+    v.north = along * s->cosH - cross * s->sinH;
+    return v;
+}
+
+/**
+ * Cross offset of a lawnmower track
+ */
+static float track_cross(const SurveyPattern* s, uint16_t track) {
+    float width = s->maxCross - s->minCross;
+    float inset = (width < s->spacing ? width : s->spacing) * 0.5f;
+    return s->minCross + inset + track * s->trackStep;
+}
+
+/**
+ * Outermost crossings of the polygon edges with a track
+ * @return false if the track misses the polygon
+ */
+static bool track_span(const SurveyPattern* s, float cross, float* lo, float* hi) {
+    bool hit = false;
+    for (uint8_t i = 0, j = s->vertexCount - 1; i < s->vertexCount; j = i++) {
+        float ci = s->cross[i];
+        float cj = s->cross[j];
+        if ((ci <= cross) == (cj <= cross)) continue;
+
+        float a = s->along[i] + (cross - ci) * (s->along[j] - s->along[i]) / (cj - ci);
+        if (!hit || a < *lo) *lo = a;
+        if (!hit || a > *hi) *hi = a;
+        hit = true;
+    }
+    return hit;
+}
+
+static bool next_lawnmower(SurveyPattern* s, NavVector* point) {
+    while (s->track < s->trackCount) {
+        float cross = track_cross(s, s->track);
+        if (s->corner == 0) {
+            float lo, hi;
+            if (!track_span(s, cross, &lo, &hi)) {
+                s->track++;             // Misses the area (notch of a concave polygon)
+                continue;
+            }
+            bool outbound = (s->flown & 1) == 0;
+            s->entry = outbound ? lo : hi;
+            s->exit = outbound ? hi : lo;
+            s->corner = 1;
+            *point = to_local(s, s->entry, cross);
+            return true;
+        }
+        s->corner = 0;
+        s->track++;
+        s->flown++;
+        *point = to_local(s, s->exit, cross);
+        return true;
+    }
+    return false;
+}
+
+static bool next_spiral(SurveyPattern* s, NavVector* point) {
+    float halfAlong = (s->maxAlong - s->minAlong) * 0.5f;
+    float halfCross = (s->maxCross - s->minCross) * 0.5f;
+    float inset = s->spacing * (0.5f + s->track);
+    float insetAlong = inset;
+    float insetCross = inset;
+
+    if (s->track == 0) {
+        // An area narrower than a spacing is still flown (as a line)
+        if (insetAlong > halfAlong) insetAlong = halfAlong;
+        if (insetCross > halfCross) insetCross = halfCross;
+    } else if (inset >= halfAlong || inset >= halfCross) {
+        return false;
+    }
+
+    float a0 = s->minAlong + insetAlong;
+    float a1 = s->maxAlong - insetAlong;
+    float c0 = s->minCross + insetCross;
+    float c1 = s->maxCross - insetCross;
+
+    switch (s->corner) {
+    case 0:
+        // Lap start: the end of the previous lap's last side
+        *point = to_local(s, s->track == 0 ? a0 : a0 - s->spacing, c0);
+        break;
+    case 1: *point = to_local(s, a1, c0); break;
+    case 2: *point = to_local(s, a1, c1); break;
+    default: *point = to_local(s, a0, c1); break;
+    }
+
+    if (++s->corner > 3) {
+        s->corner = 0;
+        s->track++;
+    }
+    return true;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+bool SurveyPattern_initPolygon(SurveyPattern* survey, SurveyType type, const NavVector* vertices,
+                               uint8_t count, float spacing, float headingDeg) {
+    if (count < 3 || count > SURVEY_MAX_VERTICES) return false;
+    if (!(spacing >= SURVEY_MIN_SPACING_M)) return false;
+
+    memset(survey, 0, sizeof(*survey));
+    survey->type = type;
+    survey->spacing = spacing;
+    survey->sinH = sinf(headingDeg * SURVEY_RAD_PER_DEG);
+    survey->cosH = cosf(headingDeg * SURVEY_RAD_PER_DEG);
+    survey->vertexCount = count;
+
+    for (uint8_t i = 0; i < count; i++) {
+        float a = vertices[i].east * survey->sinH + vertices[i].north * survey->cosH;
+        float c = vertices[i].east * survey->cosH - vertices[i].north * survey->sinH;
+        survey->along[i] = a;
+        survey->cross[i] = c;
+        if (i == 0 || a < survey->minAlong) survey->minAlong = a;
+        if (i == 0 || a > survey->maxAlong) survey->maxAlong = a;
+        if (i == 0 || c < survey->minCross) survey->minCross = c;
+        if (i == 0 || c > survey->maxCross) survey->maxCross = c;
+    }
+
+    // Evenly spaced tracks, never further apart than the spacing
+    float width = survey->maxCross - survey->minCross;
+    if (width <= spacing) {
+        survey->trackCount = 1;
+        survey->trackStep = 0.0f;
+    } else {
+        float span = width - spacing;
+        survey->trackCount = (uint16_t)ceilf(span / spacing) + 1;
+        survey->trackStep = span / (survey->trackCount - 1);
+    }
+    return true;
+}
+
+bool SurveyPattern_initRect(SurveyPattern* survey, SurveyType type, NavVector center,
+                            float width, float length, float spacing, float headingDeg) {
+    float s = sinf(headingDeg * SURVEY_RAD_PER_DEG);
+    float c = cosf(headingDeg * SURVEY_RAD_PER_DEG);
+    float ha = length * 0.5f;
+    float hc = width * 0.5f;
+    const float corners[4][2] = {{-ha, -hc}, {ha, -hc}, {ha, hc}, {-ha, hc}};
+
+    NavVector vertices[4];
+    for (int i = 0; i < 4; i++) {
+        vertices[i].east = center.east + corners[i][0] * s + corners[i][1] * c;
+        vertices[i].north = center.north + corners[i][0] * c - corners[i][1] * s;
+    }
+    return SurveyPattern_initPolygon(survey, type, vertices, 4, spacing, headingDeg);
+}
+
+bool SurveyPattern_next(SurveyPattern* survey, NavVector* point) {
+    if (survey->vertexCount == 0) return false;
+    return survey->type == SURVEY_SPIRAL ? next_spiral(survey, point)
+                                         : next_lawnmower(survey, point);
+}
+
+void SurveyPattern_restart(SurveyPattern* survey) {
+    survey->track = 0;
+    survey->corner = 0;
+    survey->flown = 0;
+}
@@ -0,0 +1,89 @@
+#ifndef SURVEY_PATTERN_H
+#define SURVEY_PATTERN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NavFrame.h"
+
+/**
+ * SurveyPattern - On-board lawnmower / spiral survey generator
+ *
+ * The area is a polygon (or a rectangle, stored as one) in a local
+ * frame. Vertices are rotated once, at init, into track coordinates:
+ * "along" runs in the survey heading, "cross" to its right. The pattern
+ * is never materialised - next() works out one turn point at a time
+ * from a few counters, so a survey of any size costs the size of this
+ * struct:
+ *
+ *   LAWNMOWER  Tracks along the heading, at most `spacing` apart and
+ *              inset half a spacing from the edges, flown alternately
+ *              out and back. Each track spans the outermost crossings
+ *              of the polygon edges (a concave polygon is flown across
+ *              its notches).
+ *   SPIRAL     Inward rectangular spiral over the heading-aligned
+ *              bounding box, laps `spacing` apart.
+ *
+ * @file SurveyPattern.h
+ */
+
+#define SURVEY_MAX_VERTICES     16
+#define SURVEY_MIN_SPACING_M    1.0f
+
+typedef enum {
+    SURVEY_LAWNMOWER = 0,
+    SURVEY_SPIRAL = 1
+} SurveyType;
+
+typedef struct {
+    SurveyType type;
+    float spacing;              // Meters between tracks / laps
+    float sinH;                 // Survey heading
+    float cosH;
+
+    // Area in track coordinates
+    uint8_t vertexCount;
+    float along[SURVEY_MAX_VERTICES];
+    float cross[SURVEY_MAX_VERTICES];
+    float minAlong, maxAlong;
+    float minCross, maxCross;
+
+    // LAWNMOWER: track `step` apart from minCross + inset
+    uint16_t trackCount;
+    float trackStep;
+
+    // Progress
+    uint16_t track;             // LAWNMOWER track / SPIRAL lap
+    uint8_t corner;             // Point within the track (0-1) / lap (0-3)
+    uint16_t flown;             // Tracks emitted (sets the direction)
+    float entry, exit;          // Current track's span, along
+} SurveyPattern;
+
+/**
+ * Survey a polygon
+ * @param vertices Corners in the local frame, in order (either winding)
+ * @param count 3 to SURVEY_MAX_VERTICES
+ * @param spacing Track / lap spacing in meters (>= SURVEY_MIN_SPACING_M)
+ * @param headingDeg Track direction, degrees from north, clockwise
+ * @return false on a bad count or spacing
+ */
+bool SurveyPattern_initPolygon(SurveyPattern* survey, SurveyType type, const NavVector* vertices,
+                               uint8_t count, float spacing, float headingDeg);
+
+/**
+ * Survey a rectangle: `length` along the heading, `width` across it
+ */
+bool SurveyPattern_initRect(SurveyPattern* survey, SurveyType type, NavVector center,
+                            float width, float length, float spacing, float headingDeg);
+
+/**
+ * Next turn point to fly to
+ * @return false when the pattern is finished
+ */
+bool SurveyPattern_next(SurveyPattern* survey, NavVector* point);
+
+/**
+ * Start the same pattern again from its first point
+ */
+void SurveyPattern_restart(SurveyPattern* survey);
+
+#endif // SURVEY_PATTERN_H
@@ -0,0 +1,220 @@
+#include "TaskScheduler.h"
+#include "HAL.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SCHED_ERROR_BUFFER_SIZE 96
+
+// Cycle counter: CCOUNT on Xtensa, nanoseconds on host builds
+#if defined(__XTENSA__)
+#include <xtensa/hal.h>
+#define SCHED_CYCLES() xthal_get_ccount()
+#define SCHED_CYCLES_PER_US() getCpuFrequencyMhz()
+#else
+#include <time.h>
+static inline uint32_t sched_host_cycles(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#define SCHED_CYCLES() sched_host_cycles()
+#define SCHED_CYCLES_PER_US() 1000
+#endif
+
+// ============================================================================
+// Internal State
+// ============================================================================
+
+typedef struct {
+  SchedulerTaskFn fn;
+  TaskHandle_t handle;
+  SchedulerTaskStats stats;
+  LoopTimer timing; // Cycle-stamped histograms (task's own core)
+} SchedulerTask;
+
+static struct {
+  bool initialized;
+  bool running;
+  uint8_t taskCount;
+  SchedulerTask tasks[SCHED_MAX_TASKS];
+  char lastError[SCHED_ERROR_BUFFER_SIZE];
+} schedulerState = {.initialized = false, .running = false, .taskCount = 0};
+
+static void set_last_error(const char *msg) {
+  snprintf(schedulerState.lastError, sizeof(schedulerState.lastError), "%s",
+           msg);
+  Serial.printf("[Scheduler] %s\n", msg);
+}
+
+/**
+ * Common task entry: releases the body every periodMs using vTaskDelayUntil
+ * so that execution time of the body does not shift the next release.
+ */
+static void schedulerTaskEntry(void *arg) {
+  SchedulerTask *task = (SchedulerTask *)arg;
+  SchedulerTaskStats *stats = &task->stats;
+
+  const TickType_t periodTicks = pdMS_TO_TICKS(stats->periodMs);
+  const int64_t periodUs = (int64_t)stats->periodMs * 1000;
+
+  TickType_t lastWake = xTaskGetTickCount();
+  HAL_Micros idealReleaseUs = HAL_Now();
+
+  for (;;) {
+    vTaskDelayUntil(&lastWake, periodTicks);
+
+    HAL_Micros startUs = HAL_Now();
+    idealReleaseUs += periodUs;
+
+    int64_t jitter = startUs - idealReleaseUs;
+    if (jitter < 0)
+      jitter = -jitter;
+    if (jitter > periodUs) {
+      // Fell more than a full period behind (e.g. task was starved):
+      // re-anchor instead of reporting ever-growing jitter
+      idealReleaseUs = startUs;
+      jitter = 0;
+    }
+
+    LoopTiming_begin(&task->timing, SCHED_CYCLES());
+    task->fn((uint32_t)(startUs / 1000));
+    LoopTiming_end(&task->timing, SCHED_CYCLES());
+
+    uint32_t execUs = (uint32_t)(HAL_Now() - startUs);
+    stats->lastExecTimeUs = execUs;
+    if (execUs > stats->maxExecTimeUs)
+      stats->maxExecTimeUs = execUs;
+    stats->lastJitterUs = (uint32_t)jitter;
+    if ((uint32_t)jitter > stats->maxJitterUs)
+      stats->maxJitterUs = (uint32_t)jitter;
+    if (execUs > (uint32_t)periodUs)
+      stats->overrunCount++;
+    stats->runCount++;
+  }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool TaskScheduler_init(void) {
+  if (schedulerState.running) {
+    set_last_error("Cannot re-init while running");
+    return false;
+  }
+
+  memset(schedulerState.tasks, 0, sizeof(schedulerState.tasks));
+  schedulerState.taskCount = 0;
+  schedulerState.lastError[0] = '\0';
+  schedulerState.initialized = true;
+  return true;
+}
+
+int TaskScheduler_addTask(const char *name, SchedulerTaskFn fn,
+                          uint32_t periodMs, uint8_t priority, uint8_t core,
+                          uint32_t stackBytes) {
+  if (!schedulerState.initialized) {
+    set_last_error("Not initialized");
+    return -1;
+  }
+  if (schedulerState.running) {
+    set_last_error("Tasks must be added before start");
+    return -1;
+  }
+  if (!name || !fn || periodMs == 0 || core >= portNUM_PROCESSORS ||
+      priority >= configMAX_PRIORITIES) {
+    set_last_error("Invalid task parameters");
+    return -1;
+  }
+  if (schedulerState.taskCount >= SCHED_MAX_TASKS) {
+    set_last_error("Task table full");
+    return -1;
+  }
+
+  int index = schedulerState.taskCount++;
+  SchedulerTask *task = &schedulerState.tasks[index];
+  task->fn = fn;
+  task->handle = NULL;
+  task->stats.stackBytes = stackBytes ? stackBytes : SCHED_DEFAULT_STACK_SIZE;
+  task->stats.name = name;
+  task->stats.periodMs = periodMs;
+  task->stats.core = core;
+  task->stats.priority = priority;
+  LoopTiming_init(&task->timing, periodMs * 1000, SCHED_CYCLES_PER_US());
+  return index;
+}
+
+bool TaskScheduler_start(void) {
+  if (!schedulerState.initialized || schedulerState.taskCount == 0) {
+    set_last_error("No tasks registered");
+    return false;
+  }
+  if (schedulerState.running)
+    return true;
+
+  for (uint8_t i = 0; i < schedulerState.taskCount; i++) {
+    SchedulerTask *task = &schedulerState.tasks[i];
+    BaseType_t ok = xTaskCreatePinnedToCore(
+        schedulerTaskEntry, task->stats.name, task->stats.stackBytes, task,
+        task->stats.priority, &task->handle, task->stats.core);
+    if (ok != pdPASS) {
+      char msg[SCHED_ERROR_BUFFER_SIZE];
+      snprintf(msg, sizeof(msg), "Failed to create task '%s'",
+               task->stats.name);
+      set_last_error(msg);
+
+      // Tear down anything already started so the caller can fall back
+      for (uint8_t j = 0; j < i; j++) {
+        if (schedulerState.tasks[j].handle) {
+          vTaskDelete(schedulerState.tasks[j].handle);
+          schedulerState.tasks[j].handle = NULL;
+        }
+      }
+      return false;
+    }
+    Serial.printf("[Scheduler] Task '%s' started: %lums, prio %u, core %u\n",
+                  task->stats.name, (unsigned long)task->stats.periodMs,
+                  task->stats.priority, task->stats.core);
+  }
+
+  schedulerState.running = true;
+  return true;
+}
+
+bool TaskScheduler_isRunning(void) { return schedulerState.running; }
+
+uint8_t TaskScheduler_getTaskCount(void) { return schedulerState.taskCount; }
+
+bool TaskScheduler_getStats(uint8_t index, SchedulerTaskStats *stats) {
+  if (!stats || index >= schedulerState.taskCount)
+    return false;
+  *stats = schedulerState.tasks[index].stats;
+  return true;
+}
+
+bool TaskScheduler_getTiming(uint8_t index, LoopTimer *timing) {
+  if (!timing || index >= schedulerState.taskCount)
+    return false;
+  *timing = schedulerState.tasks[index].timing;
+  return true;
+}
+
+void TaskScheduler_resetStats(void) {
+  for (uint8_t i = 0; i < schedulerState.taskCount; i++) {
+    SchedulerTaskStats *stats = &schedulerState.tasks[i].stats;
+    stats->runCount = 0;
+    stats->overrunCount = 0;
+    stats->lastExecTimeUs = 0;
+    stats->maxExecTimeUs = 0;
+    stats->lastJitterUs = 0;
+    stats->maxJitterUs = 0;
+    LoopTiming_resetStats(&schedulerState.tasks[i].timing);
+  }
+}
+
+const char *TaskScheduler_getLastError(void) {
+  return schedulerState.lastError;
+}
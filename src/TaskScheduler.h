@@ -0,0 +1,140 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "LoopTiming.h"
+
+/**
+ * TaskScheduler - Fixed-Rate FreeRTOS Task Scheduler
+ *
+ * Features:
+ * - Periodic tasks released by vTaskDelayUntil (no drift accumulation)
+ * - Per-task core pinning and priority
+ * - Release jitter, execution time and overrun statistics
+ * - Cycle-accurate period / execution / jitter histograms (LoopTiming)
+ *
+ * Core layout (Phase 15):
+ * - Core 1: control task (failsafe, navigation, vehicle mixing): outer
+ *           loop at 50Hz, inner loop at the vehicle's rate (RateProfile)
+ * - Core 0: control frame verification, telemetry, serial command and
+ *           sensor tasks at lower priority, sharing the core with the
+ *           Wi-Fi / ESP-NOW stack
+ *
+ * @file TaskScheduler.h
+ */
+
+#define SCHED_MAX_TASKS          8
+#define SCHED_CONTROL_CORE       1
+#define SCHED_BACKGROUND_CORE    0
+
+// FreeRTOS priorities (Arduino loopTask runs at 1, Wi-Fi task at 23)
+#define SCHED_PRIORITY_IMU       21     // 1 kHz IMU FIFO drain, blocked on data-ready
+#define SCHED_PRIORITY_CONTROL   20
+#define SCHED_PRIORITY_RX_VERIFY 8      // Control frame crypto (core 0), woken per frame
+#define SCHED_PRIORITY_RC        7      // RC receiver UART, woken once per frame
+#define SCHED_PRIORITY_I2C       6      // HAL I2C bus owner (mostly blocked)
+#define SCHED_PRIORITY_GPS       6      // GPS UART reader (sleeps between bulk reads)
+#define SCHED_PRIORITY_SENSOR    5
+#define SCHED_PRIORITY_TELEMETRY 4
+#define SCHED_PRIORITY_COMMS     3
+#define SCHED_PRIORITY_KX        3      // ECDH handshake worker, same level as comms
+#define SCHED_PRIORITY_BOOT      2      // Background boot lane (exits when done)
+#define SCHED_PRIORITY_OTA       2      // Firmware download, yields to everything above
+#define SCHED_PRIORITY_LOG       2      // Serial log / telemetry drain
+#define SCHED_PRIORITY_NOISE     2      // Gyro spectrum for the dynamic notch
+#define SCHED_PRIORITY_OTA_FLASH 1      // OTA decode / flash writer, below the download
+#define SCHED_PRIORITY_BLACKBOX  1      // Flight log flash writer
+#define SCHED_PRIORITY_DISPLAY   1      // Hull status OLED, below everything else
+
+#define SCHED_DEFAULT_STACK_SIZE 4096   // bytes
+
+/**
+ * Periodic task body
+ * @param nowMs millis() at release time
+ */
+typedef void (*SchedulerTaskFn)(uint32_t nowMs);
+
+/**
+ * Per-task runtime statistics
+ */
+typedef struct {
+    const char* name;           // Task name
+    uint32_t periodMs;          // Release period (milliseconds)
+    uint8_t core;               // Pinned core
+    uint8_t priority;           // FreeRTOS priority
+    uint32_t stackBytes;        // Stack size (bytes)
+    uint32_t runCount;          // Number of completed releases
+    uint32_t overrunCount;      // Releases where body exceeded its period
+    uint32_t lastExecTimeUs;    // Last body execution time (microseconds)
+    uint32_t maxExecTimeUs;     // Worst body execution time (microseconds)
+    uint32_t lastJitterUs;      // Last |actual - ideal| release time
+    uint32_t maxJitterUs;       // Worst release jitter (microseconds)
+} SchedulerTaskStats;
+
+/**
+ * Initialize scheduler (clears task table)
+ * @return true if initialization successful
+ */
+bool TaskScheduler_init(void);
+
+/**
+ * Register a periodic task (must be called before TaskScheduler_start)
+ * @param name Task name (static string, used for FreeRTOS and reporting)
+ * @param fn Task body, called once per period
+ * @param periodMs Release period in milliseconds (>= 1)
+ * @param priority FreeRTOS priority
+ * @param core Core to pin the task to (0 or 1)
+ * @param stackBytes Stack size in bytes
+ * @return Task index (>= 0), or -1 on error
+ */
+int TaskScheduler_addTask(const char* name, SchedulerTaskFn fn,
+                          uint32_t periodMs, uint8_t priority, uint8_t core,
+                          uint32_t stackBytes);
+
+/**
+ * Create and start all registered tasks
+ * @return true if every task was created
+ */
+bool TaskScheduler_start(void);
+
+/**
+ * Check if scheduler tasks are running
+ * @return true after a successful TaskScheduler_start
+ */
+bool TaskScheduler_isRunning(void);
+
+/**
+ * Get number of registered tasks
+ * @return Task count
+ */
+uint8_t TaskScheduler_getTaskCount(void);
+
+/**
+ * Get statistics for a task
+ * @param index Task index (0 to N-1)
+ * @param stats Output statistics
+ * @return true if index is valid
+ */
+bool TaskScheduler_getStats(uint8_t index, SchedulerTaskStats* stats);
+
+/**
+ * Get the timing histograms of a task
+ * @param index Task index (0 to N-1)
+ * @param timing Output copy of the task's LoopTimer
+ * @return true if index is valid
+ */
+bool TaskScheduler_getTiming(uint8_t index, LoopTimer* timing);
+
+/**
+ * Reset run/overrun/jitter statistics and histograms of all tasks
+ */
+void TaskScheduler_resetStats(void);
+
+/**
+ * Get last error message
+ * @return Error string (static buffer)
+ */
+const char* TaskScheduler_getLastError(void);
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,235 @@
+#include "TelemetryDelta.h"
+#include "Crc16.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * TelemetryDelta - Implementation
+ *
+ * @file TelemetryDelta.cpp
+ */
+
+// type + keyRef + fields
+#define DELTA_HEADER_SIZE 4
+#define DELTA_CRC_SIZE 2
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static int32_t quant_mv(float volts) { return (int32_t)lroundf(volts * 1000.0f); }
+static int32_t quant_deg(float deg) { return (int32_t)lroundf(deg * 1000000.0f); }
+
+static size_t put_varint(uint8_t *out, uint32_t v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+static size_t put_zigzag(uint8_t *out, int32_t v) {
+  return put_varint(out, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+// Returns bytes consumed, 0 if truncated / longer than 5 bytes
+static size_t get_varint(const uint8_t *in, size_t len, uint32_t *v) {
+  uint32_t result = 0;
+  for (size_t i = 0; i < len && i < 5; i++) {
+    result |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+    if (!(in[i] & 0x80)) {
+      *v = result;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+static size_t get_zigzag(const uint8_t *in, size_t len, int32_t *v) {
+  uint32_t raw;
+  size_t n = get_varint(in, len, &raw);
+  if (n)
+    *v = (int32_t)((raw >> 1) ^ (0U - (raw & 1)));
+  return n;
+}
+
+static size_t write_keyframe(TelemetryDeltaEncoder *enc, const NATelemetry *tel,
+                             uint8_t *out, bool *isKeyframe) {
+  memcpy(out, tel, sizeof(NATelemetry));
+  enc->key = *tel;
+  enc->haveKey = true;
+  enc->sinceKey = 0;
+  if (isKeyframe)
+    *isKeyframe = true;
+  return sizeof(NATelemetry);
+}
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+void TelemetryDelta_initEncoder(TelemetryDeltaEncoder *enc) {
+  memset(enc, 0, sizeof(*enc));
+}
+
+void TelemetryDelta_requestKeyframe(TelemetryDeltaEncoder *enc) {
+  enc->haveKey = false;
+}
+
+size_t TelemetryDelta_encode(TelemetryDeltaEncoder *enc, const NATelemetry *tel,
+                             uint8_t *out, size_t outSize, bool *isKeyframe) {
+  if (isKeyframe)
+    *isKeyframe = false;
+  if (!enc || !tel || !out || outSize < sizeof(NATelemetry))
+    return 0;
+
+  const NATelemetry *key = &enc->key;
+  bool needKey = !enc->haveKey ||
+                 enc->sinceKey >= TELEMETRY_DELTA_KEYFRAME_INTERVAL - 1 ||
+                 tel->encryptionFlag || key->encryptionFlag ||
+                 tel->protocolVersion != key->protocolVersion;
+  if (needKey)
+    return write_keyframe(enc, tel, out, isKeyframe);
+
+  uint8_t fields = 0;
+  size_t n = DELTA_HEADER_SIZE;
+
+  int32_t dMv = quant_mv(tel->batteryVoltage) - quant_mv(key->batteryVoltage);
+  if (dMv) {
+    fields |= TELEMETRY_DELTA_F_BATTERY;
+    n += put_zigzag(out + n, dMv);
+  }
+  int32_t dRssi = (int32_t)tel->rssi - (int32_t)key->rssi;
+  if (dRssi) {
+    fields |= TELEMETRY_DELTA_F_RSSI;
+    n += put_zigzag(out + n, dRssi);
+  }
+  uint32_t dUptime = tel->uptime - key->uptime;
+  if (dUptime) {
+    fields |= TELEMETRY_DELTA_F_UPTIME;
+    n += put_varint(out + n, dUptime);
+  }
+  int32_t dLat = quant_deg(tel->latitude) - quant_deg(key->latitude);
+  if (dLat) {
+    fields |= TELEMETRY_DELTA_F_LAT;
+    n += put_zigzag(out + n, dLat);
+  }
+  int32_t dLng = quant_deg(tel->longitude) - quant_deg(key->longitude);
+  if (dLng) {
+    fields |= TELEMETRY_DELTA_F_LNG;
+    n += put_zigzag(out + n, dLng);
+  }
+  if (tel->status != key->status) {
+    fields |= TELEMETRY_DELTA_F_STATUS;
+    out[n++] = tel->status;
+  }
+
+  out[0] = TELEMETRY_DELTA_TYPE;
+  out[1] = (uint8_t)(key->uptime & 0xFF);
+  out[2] = (uint8_t)((key->uptime >> 8) & 0xFF);
+  out[3] = fields;
+
+  uint16_t crc = Crc16_compute(out, n);
+  out[n++] = (uint8_t)(crc & 0xFF);
+  out[n++] = (uint8_t)(crc >> 8);
+
+  enc->sinceKey++;
+  return n;
+}
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+void TelemetryDelta_initDecoder(TelemetryDeltaDecoder *dec) {
+  memset(dec, 0, sizeof(*dec));
+}
+
+bool TelemetryDelta_decode(TelemetryDeltaDecoder *dec, const uint8_t *frame,
+                           size_t len, NATelemetry *out) {
+  if (!dec || !frame || !out)
+    return false;
+
+  // Keyframe: the plain struct
+  if (len == sizeof(NATelemetry)) {
+    NATelemetry tel;
+    memcpy(&tel, frame, sizeof(tel));
+    if (!NA_VERIFY_TELEMETRY(&tel))
+      return false;
+    dec->key = tel;
+    dec->haveKey = true;
+    *out = tel;
+    return true;
+  }
+
+  if (len < DELTA_HEADER_SIZE + DELTA_CRC_SIZE ||
+      len > TELEMETRY_DELTA_MAX_FRAME || frame[0] != TELEMETRY_DELTA_TYPE)
+    return false;
+
+  size_t body = len - DELTA_CRC_SIZE;
+  uint16_t crc = (uint16_t)frame[body] | ((uint16_t)frame[body + 1] << 8);
+  if (crc != Crc16_compute(frame, body))
+    return false;
+
+  // Delta of a keyframe we never saw (or have since replaced)
+  uint16_t keyRef = (uint16_t)frame[1] | ((uint16_t)frame[2] << 8);
+  if (!dec->haveKey || keyRef != (uint16_t)(dec->key.uptime & 0xFFFF))
+    return false;
+
+  const NATelemetry *key = &dec->key;
+  NATelemetry tel = *key;
+  uint8_t fields = frame[3];
+  size_t pos = DELTA_HEADER_SIZE;
+  size_t used;
+
+  if (fields & TELEMETRY_DELTA_F_BATTERY) {
+    int32_t d;
+    if (!(used = get_zigzag(frame + pos, body - pos, &d)))
+      return false;
+    pos += used;
+    tel.batteryVoltage = (quant_mv(key->batteryVoltage) + d) / 1000.0f;
+  }
+  if (fields & TELEMETRY_DELTA_F_RSSI) {
+    int32_t d;
+    if (!(used = get_zigzag(frame + pos, body - pos, &d)))
+      return false;
+    pos += used;
+    tel.rssi = key->rssi + d;
+  }
+  if (fields & TELEMETRY_DELTA_F_UPTIME) {
+    uint32_t d;
+    if (!(used = get_varint(frame + pos, body - pos, &d)))
+      return false;
+    pos += used;
+    tel.uptime = key->uptime + d;
+  }
+  if (fields & TELEMETRY_DELTA_F_LAT) {
+    int32_t d;
+    if (!(used = get_zigzag(frame + pos, body - pos, &d)))
+      return false;
+    pos += used;
+    tel.latitude = (quant_deg(key->latitude) + d) / 1000000.0f;
+  }
+  if (fields & TELEMETRY_DELTA_F_LNG) {
+    int32_t d;
+    if (!(used = get_zigzag(frame + pos, body - pos, &d)))
+      return false;
+    pos += used;
+    tel.longitude = (quant_deg(key->longitude) + d) / 1000000.0f;
+  }
+  if (fields & TELEMETRY_DELTA_F_STATUS) {
+    if (pos >= body)
+      return false;
+    tel.status = frame[pos++];
+  }
+
+  // Trailing bytes or unknown field bits: not a frame we produced
+  if (pos != body || (fields & ~0x3F))
+    return false;
+
+  NA_UPDATE_TELEMETRY_CHECKSUM(&tel);
+  *out = tel;
+  return true;
+}
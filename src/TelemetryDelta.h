@@ -0,0 +1,98 @@
+#ifndef TELEMETRY_DELTA_H
+#define TELEMETRY_DELTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "NAPacket.h"
+
+/**
+ * TelemetryDelta - Keyframe + delta compression for NATelemetry over ESP-NOW
+ *
+ * Keyframes are the plain NATelemetry struct, so receivers that only
+ * understand full frames keep working. In between, short delta frames
+ * carry the fields that changed since the last keyframe:
+ *
+ *   | type (0xD1) | keyRef (2) | fields (1) | varints... | crc16 (2) |
+ *
+ * - keyRef: low 16 bits of the keyframe's uptime; a delta is applied only
+ *   to that keyframe, so one lost delta never corrupts later frames
+ * - fields: TELEMETRY_DELTA_F_* bitmap, values follow in bit order
+ * - Signed values are zigzag varints of (quantized now - quantized key),
+ *   uptime is an unsigned varint of ms since the key, status is raw
+ * - crc16: NA_CRC16 over everything before it, little endian
+ *
+ * Encrypted telemetry (encryptionFlag set) is always sent as keyframes:
+ * ciphertext does not delta-compress.
+ *
+ * @file TelemetryDelta.h
+ */
+
+#define TELEMETRY_DELTA_TYPE            0xD1
+#define TELEMETRY_DELTA_KEYFRAME_INTERVAL 20    // 1 s at 20 Hz
+#define TELEMETRY_DELTA_MAX_FRAME       32
+
+// Field presence bits
+#define TELEMETRY_DELTA_F_BATTERY   0x01    // mV
+#define TELEMETRY_DELTA_F_RSSI      0x02    // dBm
+#define TELEMETRY_DELTA_F_UPTIME    0x04    // ms
+#define TELEMETRY_DELTA_F_LAT       0x08    // 1e-6 deg
+#define TELEMETRY_DELTA_F_LNG       0x10    // 1e-6 deg
+#define TELEMETRY_DELTA_F_STATUS    0x20    // raw byte
+
+/**
+ * Encoder state (one per telemetry stream)
+ */
+typedef struct {
+    NATelemetry key;        // Last keyframe sent
+    bool haveKey;
+    uint8_t sinceKey;       // Deltas sent since the keyframe
+} TelemetryDeltaEncoder;
+
+/**
+ * Decoder state (one per sender)
+ */
+typedef struct {
+    NATelemetry key;        // Last keyframe received
+    bool haveKey;
+} TelemetryDeltaDecoder;
+
+/**
+ * Reset an encoder; the next frame is a keyframe
+ */
+void TelemetryDelta_initEncoder(TelemetryDeltaEncoder* enc);
+
+/**
+ * Force a keyframe on the next encode (e.g. after a new peer appears)
+ */
+void TelemetryDelta_requestKeyframe(TelemetryDeltaEncoder* enc);
+
+/**
+ * Encode one telemetry sample
+ * @param enc Encoder state
+ * @param tel Sample to send (checksum already updated)
+ * @param out Output buffer (at least sizeof(NATelemetry))
+ * @param outSize Output buffer size
+ * @param isKeyframe Output: true if out holds a full NATelemetry (may be NULL)
+ * @return Frame length, or 0 if out is too small
+ */
+size_t TelemetryDelta_encode(TelemetryDeltaEncoder* enc, const NATelemetry* tel,
+                             uint8_t* out, size_t outSize, bool* isKeyframe);
+
+/**
+ * Reset a decoder; deltas are ignored until the next keyframe
+ */
+void TelemetryDelta_initDecoder(TelemetryDeltaDecoder* dec);
+
+/**
+ * Decode a received frame (keyframe or delta)
+ * @param dec Decoder state
+ * @param frame Received bytes
+ * @param len Received length
+ * @param out Output: reconstructed telemetry, checksum recomputed
+ * @return true if out is valid; false on bad CRC, unknown keyframe or malformed frame
+ */
+bool TelemetryDelta_decode(TelemetryDeltaDecoder* dec, const uint8_t* frame,
+                           size_t len, NATelemetry* out);
+
+#endif // TELEMETRY_DELTA_H
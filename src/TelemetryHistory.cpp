@@ -0,0 +1,78 @@
+#include "TelemetryHistory.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * TelemetryHistory - Implementation
+ *
+ * Decimation is by snapshot uptime, so a slower or stalled telemetry
+ * task leaves gaps in the ring rather than squeezing time.
+ *
+ * @file TelemetryHistory.cpp
+ */
+
+static int16_t clampI16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lroundf(v);
+}
+
+static uint16_t clampU16(float v) {
+    if (v > 65535.0f) return 65535;
+    if (v < 0.0f) return 0;
+    return (uint16_t)lroundf(v);
+}
+
+void TelemetryHistory_init(TelemetryHistory* h, TelemetryHistoryRecord* buffer, uint16_t capacity) {
+    h->records = buffer;
+    h->capacity = buffer ? capacity : 0;
+    TelemetryHistory_clear(h);
+}
+
+void TelemetryHistory_clear(TelemetryHistory* h) {
+    h->head = 0;
+    h->count = 0;
+    h->lastUptime = 0;
+}
+
+bool TelemetryHistory_push(TelemetryHistory* h, const TelemetrySnapshot* snap) {
+    if (h->capacity == 0) return false;
+    if (h->count > 0 && snap->uptime - h->lastUptime < TELEMETRY_HISTORY_INTERVAL_MS) return false;
+
+    float heading = fmodf(snap->heading, 360.0f);
+    if (heading < 0.0f) heading += 360.0f;
+
+    TelemetryHistoryRecord* r = &h->records[h->head];
+    r->uptime = snap->uptime;
+    r->batteryMv = snap->batteryMv;
+    r->rssi = snap->rssi;
+    r->status = snap->status;
+    r->latE7 = snap->latE7;
+    r->lngE7 = snap->lngE7;
+    r->depthCm = clampI16(snap->depth * 100.0f);
+    r->headingDeci = (uint16_t)(clampU16(heading * 10.0f) % 3600);
+    r->speedCms = clampU16(snap->groundSpeed * 100.0f);
+    r->wpIndex = snap->wpIndex;
+    r->navFlags = snap->navFlags;
+    r->cpuPct = (uint8_t)clampU16(snap->cpuPct > 100.0f ? 100.0f : snap->cpuPct);
+
+    h->head = (uint16_t)((h->head + 1) % h->capacity);
+    if (h->count < h->capacity) h->count++;
+    h->lastUptime = snap->uptime;
+    return true;
+}
+
+uint16_t TelemetryHistory_copy(const TelemetryHistory* h, void* out, uint16_t max) {
+    uint16_t n = h->count < max ? h->count : max;
+    if (n == 0) return 0;
+
+    // Newest n records, split where the ring wraps
+    uint16_t start = (uint16_t)((h->head + h->capacity - n) % h->capacity);
+    uint16_t first = (uint16_t)(h->capacity - start);
+    if (first > n) first = n;
+    uint8_t* dst = (uint8_t*)out;
+    memcpy(dst, &h->records[start], first * sizeof(TelemetryHistoryRecord));
+    memcpy(dst + first * sizeof(TelemetryHistoryRecord), h->records,
+           (n - first) * sizeof(TelemetryHistoryRecord));
+    return n;
+}
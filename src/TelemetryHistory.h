@@ -0,0 +1,74 @@
+#ifndef TELEMETRY_HISTORY_H
+#define TELEMETRY_HISTORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "TelemetrySnapshot.h"
+
+/**
+ * TelemetryHistory - Last N seconds of telemetry for charts on connect
+ *
+ * A dashboard that opens /ws late starts with empty charts. The telemetry
+ * task pushes every snapshot here; one in TELEMETRY_HISTORY_INTERVAL_MS
+ * is kept as a compact fixed-point record in a ring the caller owns, so
+ * a new client can get the whole window in one frame before live data.
+ *
+ * Single writer and single reader (both the telemetry task): no locking.
+ * Nothing is allocated here.
+ *
+ * @file TelemetryHistory.h
+ */
+
+// One record per 250 ms (every 5th 50 ms tick)
+#define TELEMETRY_HISTORY_INTERVAL_MS 250
+
+/**
+ * Stored record (packed little endian, 26 bytes). Fixed point keeps it
+ * at a third of the snapshot; the chart resolution does not need more
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t uptime;        // ms
+    uint16_t batteryMv;
+    int8_t rssi;
+    uint8_t status;         // TELEMETRY_STATUS_*
+    int32_t latE7;
+    int32_t lngE7;
+    int16_t depthCm;
+    uint16_t headingDeci;   // 0.1 degree, 0-3599
+    uint16_t speedCms;      // cm/s
+    uint16_t wpIndex;
+    uint8_t navFlags;       // TELEMETRY_NAV_*
+    uint8_t cpuPct;
+} TelemetryHistoryRecord;
+
+typedef struct {
+    TelemetryHistoryRecord* records;
+    uint16_t capacity;
+    uint16_t head;          // Next slot written
+    uint16_t count;
+    uint32_t lastUptime;    // Uptime of the newest record
+} TelemetryHistory;
+
+/**
+ * Use buffer (capacity records) as an empty ring
+ */
+void TelemetryHistory_init(TelemetryHistory* h, TelemetryHistoryRecord* buffer, uint16_t capacity);
+
+/**
+ * Offer a snapshot; kept if TELEMETRY_HISTORY_INTERVAL_MS passed since
+ * the newest record (the oldest is overwritten when full)
+ * @return true if a record was stored
+ */
+bool TelemetryHistory_push(TelemetryHistory* h, const TelemetrySnapshot* snap);
+
+/**
+ * Copy the newest max records (all if fewer), oldest first; out need
+ * not be aligned
+ * @return records copied
+ */
+uint16_t TelemetryHistory_copy(const TelemetryHistory* h, void* out, uint16_t max);
+
+void TelemetryHistory_clear(TelemetryHistory* h);
+
+#endif // TELEMETRY_HISTORY_H
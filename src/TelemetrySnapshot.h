@@ -0,0 +1,74 @@
+#ifndef TELEMETRY_SNAPSHOT_H
+#define TELEMETRY_SNAPSHOT_H
+
+#include <stdint.h>
+#include <string.h>
+#include "NAPacket.h"
+
+/**
+ * TelemetrySnapshot - One telemetry tick's state, sampled once
+ *
+ * The telemetry task fills a snapshot at the start of the tick and every
+ * sink encodes from it:
+ *   - NATelemetry wire frame (ESP-NOW and host binary): plaintext built
+ *     here, ciphertext written to a separate frame, so the snapshot and
+ *     the plaintext are never overwritten by encryption
+ *   - serial JSON line and WebSocket frames: plaintext values only
+ *   - TelemetryStreams frames (ESP-NOW and host binary, when enabled)
+ *   - CRSF telemetry frames to a wired RC receiver (CrsfTelemetry)
+ *
+ * Values are plaintext; `encrypted` only says the radio frame is.
+ *
+ * @file TelemetrySnapshot.h
+ */
+
+// navFlags
+#define TELEMETRY_NAV_MISSION_ACTIVE    0x01
+#define TELEMETRY_NAV_WP_REACHED        0x02
+#define TELEMETRY_NAV_RTL_ACTIVE        0x04
+
+// NATelemetry.status
+#define TELEMETRY_STATUS_GPS_LOCK       0x02
+
+typedef struct {
+    uint32_t uptime;            // ms
+    int64_t utcMs;              // UTC, ms since 1970 (0 = no time yet)
+    uint8_t timeSync;           // TimeSyncState of utcMs
+    uint16_t batteryMv;         // 0 without a battery monitor
+    int8_t rssi;                // Average dBm
+    uint8_t linkQuality;        // 0-100
+    uint8_t status;             // TELEMETRY_STATUS_*
+    bool encrypted;             // Radio frame encrypted
+    float lat, lng;             // 0 without a GPS lock
+    int32_t latE7, lngE7;       // Same, full receiver precision
+    float groundSpeed;          // m/s
+    float roll, pitch;          // Degrees (0 without the IMU)
+    float heading;              // Degrees clockwise
+    float depth;                // m
+    float targetDepth;          // m
+    bool diving;
+    uint8_t failsafe;           // FailsafeState
+    uint16_t wpIndex;
+    uint8_t navFlags;           // TELEMETRY_NAV_*
+    float dist;                 // m to the target
+    float headingError;         // Degrees
+    float heapPct;
+    float cpuPct;
+    uint32_t maxLoopUs;
+} TelemetrySnapshot;
+
+/**
+ * Plaintext NATelemetry of a snapshot (no IV / HMAC, checksum not set)
+ */
+static inline void TelemetrySnapshot_toPacket(const TelemetrySnapshot* snap, NATelemetry* tel) {
+    memset(tel, 0, sizeof(*tel));
+    tel->protocolVersion = PROTOCOL_VERSION;
+    tel->uptime = snap->uptime;
+    tel->batteryVoltage = snap->batteryMv / 1000.0f;
+    tel->rssi = snap->rssi;
+    tel->latitude = snap->lat;
+    tel->longitude = snap->lng;
+    tel->status = snap->status;
+}
+
+#endif // TELEMETRY_SNAPSHOT_H
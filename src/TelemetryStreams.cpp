@@ -0,0 +1,425 @@
+#include "TelemetryStreams.h"
+#include "Crc16.h"
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+/**
+ * TelemetryStreams - Implementation
+ *
+ * @file TelemetryStreams.cpp
+ */
+
+#define CREDIT_ONE 1000                 // Credit of one send
+#define RECORD_HEADER_SIZE 2            // id + length
+
+static const char* const NAMES[TELEMETRY_STREAM_COUNT] = {
+    "attitude", "position", "nav", "battery", "depth", "perf", "events"};
+
+static const uint8_t PAYLOAD_SIZE[TELEMETRY_STREAM_COUNT] = {6, 11, 7, 4, 5, 4, 0};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static void put_u16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)(v & 0xFF);
+    out[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* out, uint32_t v) {
+    put_u16(out, (uint16_t)(v & 0xFFFF));
+    put_u16(out + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    return (uint32_t)get_u16(in) | ((uint32_t)get_u16(in + 2) << 16);
+}
+
+static int16_t sat_i16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lroundf(v);
+}
+
+static uint16_t sat_u16(float v) {
+    if (v > 65535.0f) return 65535;
+    if (v < 0.0f) return 0;
+    return (uint16_t)lroundf(v);
+}
+
+static uint8_t sat_u8(float v) {
+    if (v > 255.0f) return 255;
+    if (v < 0.0f) return 0;
+    return (uint8_t)lroundf(v);
+}
+
+static uint16_t heading_cdeg(float deg) {
+    float cdeg = fmodf(deg, 360.0f) * 100.0f;
+    if (cdeg < 0.0f) cdeg += 36000.0f;
+    return cdeg >= 35999.5f ? 0 : (uint16_t)lroundf(cdeg);
+}
+
+// Payload of a stream (not EVENTS); returns its size
+static uint8_t write_payload(TelemetryStreamId id, const TelemetrySnapshot* s, uint8_t* p) {
+    switch (id) {
+    case TELEMETRY_STREAM_ATTITUDE:
+        put_u16(p, (uint16_t)sat_i16(s->roll * 100.0f));
+        put_u16(p + 2, (uint16_t)sat_i16(s->pitch * 100.0f));
+        put_u16(p + 4, heading_cdeg(s->heading));
+        break;
+    case TELEMETRY_STREAM_POSITION:
+        put_u32(p, (uint32_t)s->latE7);
+        put_u32(p + 4, (uint32_t)s->lngE7);
+        put_u16(p + 8, sat_u16(s->groundSpeed * 100.0f));
+        p[10] = s->status;
+        break;
+    case TELEMETRY_STREAM_NAV:
+        put_u16(p, s->wpIndex);
+        p[2] = s->navFlags;
+        put_u16(p + 3, sat_u16(s->dist * 10.0f));
+        put_u16(p + 5, (uint16_t)sat_i16(s->headingError * 100.0f));
+        break;
+    case TELEMETRY_STREAM_BATTERY:
+        put_u16(p, s->batteryMv);
+        p[2] = (uint8_t)s->rssi;
+        p[3] = s->linkQuality;
+        break;
+    case TELEMETRY_STREAM_DEPTH:
+        put_u16(p, (uint16_t)sat_i16(s->depth * 100.0f));
+        put_u16(p + 2, (uint16_t)sat_i16(s->targetDepth * 100.0f));
+        p[4] = s->diving ? 1 : 0;
+        break;
+    case TELEMETRY_STREAM_PERF:
+        p[0] = sat_u8(s->heapPct);
+        p[1] = sat_u8(s->cpuPct);
+        put_u16(p + 2, s->maxLoopUs > 0xFFFF ? 0xFFFF : (uint16_t)s->maxLoopUs);
+        break;
+    default:
+        return 0;
+    }
+    return PAYLOAD_SIZE[id];
+}
+
+static void read_payload(TelemetryStreamId id, const uint8_t* p, TelemetryStreamFrame* f) {
+    switch (id) {
+    case TELEMETRY_STREAM_ATTITUDE:
+        f->roll = (int16_t)get_u16(p) / 100.0f;
+        f->pitch = (int16_t)get_u16(p + 2) / 100.0f;
+        f->heading = get_u16(p + 4) / 100.0f;
+        break;
+    case TELEMETRY_STREAM_POSITION:
+        f->latE7 = (int32_t)get_u32(p);
+        f->lngE7 = (int32_t)get_u32(p + 4);
+        f->groundSpeed = get_u16(p + 8) / 100.0f;
+        f->status = p[10];
+        break;
+    case TELEMETRY_STREAM_NAV:
+        f->wpIndex = get_u16(p);
+        f->navFlags = p[2];
+        f->dist = get_u16(p + 3) / 10.0f;
+        f->headingError = (int16_t)get_u16(p + 5) / 100.0f;
+        break;
+    case TELEMETRY_STREAM_BATTERY:
+        f->batteryMv = get_u16(p);
+        f->rssi = (int8_t)p[2];
+        f->linkQuality = p[3];
+        break;
+    case TELEMETRY_STREAM_DEPTH:
+        f->depth = (int16_t)get_u16(p) / 100.0f;
+        f->targetDepth = (int16_t)get_u16(p + 2) / 100.0f;
+        f->diving = p[4] != 0;
+        break;
+    case TELEMETRY_STREAM_PERF:
+        f->heapPct = p[0];
+        f->cpuPct = p[1];
+        f->maxLoopUs = get_u16(p + 2);
+        break;
+    default:
+        break;
+    }
+}
+
+// Priority after waiting: one level up per frame the stream was left out of
+static int effective_priority(const TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                              int id) {
+    return (int)config->priority[id] - ts->waiting[id];
+}
+
+/**
+ * Best due stream not yet done: effective priority, then wait, then backlog
+ * @return Stream id, -1 if none is due
+ */
+static int best_due(const TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                    const bool* done) {
+    int best = -1;
+    for (int i = 0; i < TELEMETRY_STREAM_EVENTS; i++) {
+        if (done[i] || ts->credit[i] < CREDIT_ONE)
+            continue;
+        if (best < 0) {
+            best = i;
+            continue;
+        }
+        int pi = effective_priority(ts, config, i);
+        int pb = effective_priority(ts, config, best);
+        if (pi != pb) {
+            if (pi < pb) best = i;
+        } else if (ts->waiting[i] != ts->waiting[best]) {
+            if (ts->waiting[i] > ts->waiting[best]) best = i;
+        } else if (ts->credit[i] > ts->credit[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void TelemetryStreams_defaultConfig(TelemetryStreamsConfig* config) {
+    static const uint8_t hz[TELEMETRY_STREAM_COUNT] = {10, 5, 2, 1, 2, 1, 0};
+    static const uint8_t priority[TELEMETRY_STREAM_COUNT] = {1, 2, 3, 4, 3, 6, 0};
+    memset(config, 0, sizeof(*config));
+    config->enabled = false;
+    config->radioBudget = 64;
+    config->serialBudget = TELEMETRY_STREAM_MAX_FRAME;
+    memcpy(config->hz, hz, sizeof(hz));
+    memcpy(config->priority, priority, sizeof(priority));
+}
+
+void TelemetryStreams_sanitize(TelemetryStreamsConfig* config) {
+    if (config->radioBudget < TELEMETRY_STREAM_MIN_BUDGET)
+        config->radioBudget = TELEMETRY_STREAM_MIN_BUDGET;
+    if (config->radioBudget > TELEMETRY_STREAM_MAX_FRAME)
+        config->radioBudget = TELEMETRY_STREAM_MAX_FRAME;
+    if (config->serialBudget < TELEMETRY_STREAM_MIN_BUDGET)
+        config->serialBudget = TELEMETRY_STREAM_MIN_BUDGET;
+    if (config->serialBudget > TELEMETRY_STREAM_MAX_FRAME)
+        config->serialBudget = TELEMETRY_STREAM_MAX_FRAME;
+    for (int i = 0; i < TELEMETRY_STREAM_COUNT; i++) {
+        if (config->hz[i] > TELEMETRY_STREAM_MAX_HZ)
+            config->hz[i] = TELEMETRY_STREAM_MAX_HZ;
+        if (config->priority[i] > 15)
+            config->priority[i] = 15;
+    }
+    // Events always pre-empt
+    config->hz[TELEMETRY_STREAM_EVENTS] = 0;
+    config->priority[TELEMETRY_STREAM_EVENTS] = 0;
+}
+
+const char* TelemetryStreams_name(TelemetryStreamId id) {
+    return (unsigned)id < TELEMETRY_STREAM_COUNT ? NAMES[id] : NULL;
+}
+
+TelemetryStreamId TelemetryStreams_parse(const char* name) {
+    for (int i = 0; name && i < TELEMETRY_STREAM_COUNT; i++) {
+        if (strcasecmp(name, NAMES[i]) == 0)
+            return (TelemetryStreamId)i;
+    }
+    return TELEMETRY_STREAM_COUNT;
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+void TelemetryStreams_init(TelemetryStreams* ts) {
+    memset(ts, 0, sizeof(*ts));
+}
+
+void TelemetryStreams_tick(TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                           uint16_t dtMs) {
+    const uint32_t cap = (uint32_t)TELEMETRY_STREAM_MAX_BACKLOG * CREDIT_ONE;
+    for (int i = 0; i < TELEMETRY_STREAM_COUNT; i++) {
+        if (config->hz[i] == 0 || i == TELEMETRY_STREAM_EVENTS) {
+            ts->credit[i] = 0;
+            continue;
+        }
+        // hz * ms is per mille of a send per tick
+        uint32_t credit = ts->credit[i] + (uint32_t)config->hz[i] * dtMs;
+        ts->credit[i] = (uint16_t)(credit > cap ? cap : credit);
+    }
+}
+
+void TelemetryStreams_postEvent(TelemetryStreams* ts, uint8_t code, uint16_t arg) {
+    if (ts->eventCount == TELEMETRY_STREAM_EVENT_QUEUE) {
+        ts->eventHead = (uint8_t)((ts->eventHead + 1) % TELEMETRY_STREAM_EVENT_QUEUE);
+        ts->eventCount--;
+        ts->eventsDropped++;
+    }
+    uint8_t slot = (uint8_t)((ts->eventHead + ts->eventCount) % TELEMETRY_STREAM_EVENT_QUEUE);
+    ts->events[slot].code = code;
+    ts->events[slot].arg = arg;
+    ts->eventCount++;
+}
+
+void TelemetryStreams_watch(TelemetryStreams* ts, TelemetryEventWatch* watch,
+                            const TelemetrySnapshot* snap) {
+    if (watch->valid) {
+        if (snap->failsafe != watch->failsafe)
+            TelemetryStreams_postEvent(ts, TELEMETRY_EVENT_FAILSAFE, snap->failsafe);
+        uint8_t changed = snap->navFlags ^ watch->navFlags;
+        if (changed & TELEMETRY_NAV_MISSION_ACTIVE)
+            TelemetryStreams_postEvent(ts, TELEMETRY_EVENT_MISSION,
+                                       (snap->navFlags & TELEMETRY_NAV_MISSION_ACTIVE) ? 1 : 0);
+        if (changed & TELEMETRY_NAV_RTL_ACTIVE)
+            TelemetryStreams_postEvent(ts, TELEMETRY_EVENT_RTL,
+                                       (snap->navFlags & TELEMETRY_NAV_RTL_ACTIVE) ? 1 : 0);
+        // The index moves on as a waypoint is reached: report the one left
+        if (snap->wpIndex != watch->wpIndex && (watch->navFlags & TELEMETRY_NAV_MISSION_ACTIVE))
+            TelemetryStreams_postEvent(ts, TELEMETRY_EVENT_WAYPOINT, watch->wpIndex);
+        if ((snap->status ^ watch->status) & TELEMETRY_STATUS_GPS_LOCK)
+            TelemetryStreams_postEvent(ts, TELEMETRY_EVENT_GPS,
+                                       (snap->status & TELEMETRY_STATUS_GPS_LOCK) ? 1 : 0);
+        if (snap->diving != watch->diving)
+            TelemetryStreams_postEvent(ts, TELEMETRY_EVENT_DIVING, snap->diving ? 1 : 0);
+    }
+    watch->valid = true;
+    watch->navFlags = snap->navFlags;
+    watch->wpIndex = snap->wpIndex;
+    watch->status = snap->status;
+    watch->failsafe = snap->failsafe;
+    watch->diving = snap->diving;
+}
+
+size_t TelemetryStreams_pack(TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                             const TelemetrySnapshot* snap, uint8_t budget,
+                             uint8_t* out, size_t outSize) {
+    size_t limit = budget;
+    if (limit > outSize) limit = outSize;
+    if (limit > TELEMETRY_STREAM_MAX_FRAME) limit = TELEMETRY_STREAM_MAX_FRAME;
+    if (limit < TELEMETRY_STREAM_HEADER_SIZE + TELEMETRY_STREAM_CRC_SIZE)
+        return 0;
+    size_t room = limit - TELEMETRY_STREAM_CRC_SIZE;
+    size_t len = TELEMETRY_STREAM_HEADER_SIZE;
+
+    // Events first, as many as fit; the rest wait for the next frame
+    if (ts->eventCount && len + RECORD_HEADER_SIZE + TELEMETRY_STREAM_EVENT_SIZE <= room) {
+        uint8_t fit = (uint8_t)((room - len - RECORD_HEADER_SIZE) / TELEMETRY_STREAM_EVENT_SIZE);
+        uint8_t n = ts->eventCount < fit ? ts->eventCount : fit;
+        out[len] = TELEMETRY_STREAM_EVENTS;
+        out[len + 1] = (uint8_t)(n * TELEMETRY_STREAM_EVENT_SIZE);
+        len += RECORD_HEADER_SIZE;
+        for (uint8_t i = 0; i < n; i++) {
+            const TelemetryEvent* e = &ts->events[ts->eventHead];
+            out[len] = e->code;
+            put_u16(out + len + 1, e->arg);
+            len += TELEMETRY_STREAM_EVENT_SIZE;
+            ts->eventHead = (uint8_t)((ts->eventHead + 1) % TELEMETRY_STREAM_EVENT_QUEUE);
+            ts->eventCount--;
+        }
+        ts->sent[TELEMETRY_STREAM_EVENTS] += n;
+    }
+
+    // Due streams by effective priority, then by wait, backlog and id
+    bool done[TELEMETRY_STREAM_COUNT] = {false};
+    for (;;) {
+        int best = best_due(ts, config, done);
+        if (best < 0)
+            break;
+        done[best] = true;
+        if (len + RECORD_HEADER_SIZE + PAYLOAD_SIZE[best] > room) {
+            ts->deferred[best]++;
+            if (ts->waiting[best] < UINT8_MAX)
+                ts->waiting[best]++;
+            continue;   // A smaller one may still fit
+        }
+        out[len] = (uint8_t)best;
+        out[len + 1] = write_payload((TelemetryStreamId)best, snap, out + len + RECORD_HEADER_SIZE);
+        len += RECORD_HEADER_SIZE + out[len + 1];
+        ts->credit[best] -= CREDIT_ONE;
+        ts->waiting[best] = 0;
+        ts->sent[best]++;
+    }
+
+    if (len == TELEMETRY_STREAM_HEADER_SIZE)
+        return 0;
+    out[0] = TELEMETRY_STREAM_TYPE;
+    out[1] = ts->sequence++;
+    put_u32(out + 2, snap->uptime);
+    put_u16(out + len, Crc16_compute(out, len));
+    len += TELEMETRY_STREAM_CRC_SIZE;
+    ts->frames++;
+    ts->bytes += (uint32_t)len;
+    return len;
+}
+
+TelemetryStreamId TelemetryStreams_next(TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                                        uint8_t mask) {
+    if (ts->eventCount && (mask & (1 << TELEMETRY_STREAM_EVENTS))) {
+        ts->sent[TELEMETRY_STREAM_EVENTS] += ts->eventCount;
+        ts->eventHead = 0;
+        ts->eventCount = 0;
+        return TELEMETRY_STREAM_EVENTS;
+    }
+
+    // Streams the link cannot carry never come due
+    bool done[TELEMETRY_STREAM_COUNT];
+    for (int i = 0; i < TELEMETRY_STREAM_COUNT; i++)
+        done[i] = (mask & (1 << i)) == 0;
+    int best = best_due(ts, config, done);
+    if (best < 0)
+        return TELEMETRY_STREAM_COUNT;
+
+    done[best] = true;
+    ts->credit[best] -= CREDIT_ONE;
+    ts->waiting[best] = 0;
+    ts->sent[best]++;
+    // Everything else that was due waits for the next slot
+    for (int i = 0; i < TELEMETRY_STREAM_EVENTS; i++) {
+        if (done[i] || ts->credit[i] < CREDIT_ONE)
+            continue;
+        ts->deferred[i]++;
+        if (ts->waiting[i] < UINT8_MAX)
+            ts->waiting[i]++;
+    }
+    return (TelemetryStreamId)best;
+}
+
+// ============================================================================
+// Receiving
+// ============================================================================
+
+bool TelemetryStreams_decode(const uint8_t* data, size_t len, TelemetryStreamFrame* frame) {
+    if (!data || len < TELEMETRY_STREAM_HEADER_SIZE + TELEMETRY_STREAM_CRC_SIZE ||
+        data[0] != TELEMETRY_STREAM_TYPE)
+        return false;
+    size_t end = len - TELEMETRY_STREAM_CRC_SIZE;
+    if (get_u16(data + end) != Crc16_compute(data, end))
+        return false;
+
+    memset(frame, 0, sizeof(*frame));
+    frame->sequence = data[1];
+    frame->uptime = get_u32(data + 2);
+    size_t pos = TELEMETRY_STREAM_HEADER_SIZE;
+    while (pos < end) {
+        if (pos + RECORD_HEADER_SIZE > end)
+            return false;
+        uint8_t id = data[pos];
+        uint8_t size = data[pos + 1];
+        const uint8_t* p = data + pos + RECORD_HEADER_SIZE;
+        pos += RECORD_HEADER_SIZE + size;
+        if (pos > end)
+            return false;
+        if (id == TELEMETRY_STREAM_EVENTS) {
+            for (uint8_t i = 0; i + TELEMETRY_STREAM_EVENT_SIZE <= size &&
+                                frame->eventCount < TELEMETRY_STREAM_EVENT_QUEUE;
+                 i += TELEMETRY_STREAM_EVENT_SIZE) {
+                TelemetryEvent* e = &frame->events[frame->eventCount++];
+                e->code = p[i];
+                e->arg = get_u16(p + i + 1);
+            }
+        } else if (id < TELEMETRY_STREAM_COUNT && size >= PAYLOAD_SIZE[id]) {
+            read_payload((TelemetryStreamId)id, p, frame);
+        } else {
+            continue;   // Unknown or shorter than this firmware's: skipped
+        }
+        frame->present |= (uint8_t)(1 << id);
+    }
+    return true;
+}
@@ -0,0 +1,232 @@
+#ifndef TELEMETRY_STREAMS_H
+#define TELEMETRY_STREAMS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "TelemetrySnapshot.h"
+
+/**
+ * TelemetryStreams - Multi-rate telemetry packed under a byte budget
+ *
+ * Telemetry as named streams, each with its own rate and priority, in
+ * place of one fixed struct at the task rate. Every telemetry tick each
+ * stream earns credit at its rate; when a frame goes out, the streams
+ * that are due are packed in priority order until the link's byte budget
+ * is spent. A stream left out keeps its credit (capped at
+ * TELEMETRY_STREAM_MAX_BACKLOG periods) and gains one priority level per
+ * frame it has been left out of, so a tight budget slows low-priority
+ * streams down instead of starving them. Queued events go first, ahead of every
+ * stream and regardless of rate.
+ *
+ * Frame, little endian:
+ *
+ *   | type (0xD5) | seq | uptime ms (4) | records... | crc16 (2) |
+ *   record: | stream id | length | payload |
+ *
+ * Payloads (fixed per stream, sampled from one TelemetrySnapshot):
+ *   ATTITUDE  roll, pitch i16 cdeg, heading u16 cdeg                 6
+ *   POSITION  lat, lng i32 deg*1e7, ground speed u16 cm/s, status    11
+ *   NAV       waypoint u16, flags u8, distance u16 dm, hdg err i16 cdeg  7
+ *   BATTERY   mV u16, rssi i8, link quality u8                       4
+ *   DEPTH     depth, target i16 cm, diving u8                        5
+ *   PERF      heap %, cpu % u8, max loop u16 us                      4
+ *   EVENTS    (code u8, arg u16) per event                           3n
+ *
+ * Receivers skip records with an id they do not know, so streams can be
+ * added without breaking older ground stations. One TelemetryStreams
+ * per link (ESP-NOW, host serial, CRSF): each has its own budget and credit.
+ *
+ * Stored as a config blob (TELEMETRY_STREAMS_CONFIG_KEY).
+ *
+ * Pure: no globals, no RTOS. Owned by the telemetry task.
+ *
+ * @file TelemetryStreams.h
+ */
+
+#define TELEMETRY_STREAMS_CONFIG_KEY    "cfg_streams"
+#define TELEMETRY_STREAM_TYPE           0xD5
+#define TELEMETRY_STREAM_HEADER_SIZE    6       // type + seq + uptime
+#define TELEMETRY_STREAM_CRC_SIZE       2
+#define TELEMETRY_STREAM_MAX_FRAME      96      // Fits a host protocol frame
+#define TELEMETRY_STREAM_MIN_BUDGET     24      // Header, CRC and the largest record
+#define TELEMETRY_STREAM_MAX_BACKLOG    4       // Periods of credit kept while skipped
+#define TELEMETRY_STREAM_MAX_HZ         50
+#define TELEMETRY_STREAM_EVENT_QUEUE    8
+#define TELEMETRY_STREAM_EVENT_SIZE     3
+
+typedef enum {
+    TELEMETRY_STREAM_ATTITUDE = 0,
+    TELEMETRY_STREAM_POSITION,
+    TELEMETRY_STREAM_NAV,
+    TELEMETRY_STREAM_BATTERY,
+    TELEMETRY_STREAM_DEPTH,
+    TELEMETRY_STREAM_PERF,
+    TELEMETRY_STREAM_EVENTS,
+    TELEMETRY_STREAM_COUNT
+} TelemetryStreamId;
+
+// Event codes (EVENTS stream); arg in brackets
+typedef enum {
+    TELEMETRY_EVENT_FAILSAFE = 1,   // [FailsafeState]
+    TELEMETRY_EVENT_MISSION,        // [1 started, 0 ended]
+    TELEMETRY_EVENT_WAYPOINT,       // [index reached]
+    TELEMETRY_EVENT_RTL,            // [1 started, 0 ended]
+    TELEMETRY_EVENT_GPS,            // [1 locked, 0 lost]
+    TELEMETRY_EVENT_DIVING,         // [1 diving, 0 surfacing]
+    TELEMETRY_EVENT_LEAK,           // [LeakDetector state]
+    TELEMETRY_EVENT_BOOT            // [reset reason]
+} TelemetryEventCode;
+
+/**
+ * Rate and priority of every stream (priority 0 is the highest)
+ */
+typedef struct {
+    bool enabled;                   // Streams replace NATelemetry on the radio
+    uint8_t radioBudget;            // Bytes per ESP-NOW frame
+    uint8_t serialBudget;           // Bytes per host serial frame
+    uint8_t hz[TELEMETRY_STREAM_COUNT];     // 0 = off (EVENTS: ignored)
+    uint8_t priority[TELEMETRY_STREAM_COUNT];
+} TelemetryStreamsConfig;
+
+typedef struct {
+    uint8_t code;                   // TelemetryEventCode
+    uint16_t arg;
+} TelemetryEvent;
+
+/**
+ * Per-link scheduler state
+ */
+typedef struct {
+    uint16_t credit[TELEMETRY_STREAM_COUNT];    // Per mille of a send
+    uint8_t waiting[TELEMETRY_STREAM_COUNT];    // Frames left out of since the last send
+    TelemetryEvent events[TELEMETRY_STREAM_EVENT_QUEUE];
+    uint8_t eventHead;
+    uint8_t eventCount;
+    uint8_t sequence;
+    uint32_t sent[TELEMETRY_STREAM_COUNT];      // Records packed
+    uint32_t deferred[TELEMETRY_STREAM_COUNT];  // Due but over budget
+    uint32_t eventsDropped;                     // Queue full: oldest lost
+    uint32_t frames;
+    uint32_t bytes;
+} TelemetryStreams;
+
+/**
+ * Changes between snapshots that become events
+ */
+typedef struct {
+    bool valid;
+    uint8_t navFlags;
+    uint16_t wpIndex;
+    uint8_t status;
+    uint8_t failsafe;
+    bool diving;
+} TelemetryEventWatch;
+
+/**
+ * One decoded frame (receiver side)
+ */
+typedef struct {
+    uint8_t sequence;
+    uint32_t uptime;
+    uint8_t present;                // Bit per TelemetryStreamId
+    float roll, pitch, heading;     // Degrees
+    int32_t latE7, lngE7;
+    float groundSpeed;              // m/s
+    uint8_t status;
+    uint16_t wpIndex;
+    uint8_t navFlags;
+    float dist, headingError;       // m, degrees
+    uint16_t batteryMv;
+    int8_t rssi;
+    uint8_t linkQuality;
+    float depth, targetDepth;       // m
+    bool diving;
+    uint8_t heapPct, cpuPct;
+    uint16_t maxLoopUs;
+    uint8_t eventCount;
+    TelemetryEvent events[TELEMETRY_STREAM_EVENT_QUEUE];
+} TelemetryStreamFrame;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+/**
+ * Defaults: off, 64-byte radio / 96-byte serial budget, attitude 10 Hz,
+ * position 5, nav 2, depth 2, battery 1, perf 1
+ */
+void TelemetryStreams_defaultConfig(TelemetryStreamsConfig* config);
+
+/**
+ * Clamp rates, budgets and priorities into range
+ */
+void TelemetryStreams_sanitize(TelemetryStreamsConfig* config);
+
+/**
+ * Stream name ("attitude", "position", ...), NULL out of range
+ */
+const char* TelemetryStreams_name(TelemetryStreamId id);
+
+/**
+ * Stream of a name (case-insensitive), TELEMETRY_STREAM_COUNT if unknown
+ */
+TelemetryStreamId TelemetryStreams_parse(const char* name);
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+/**
+ * Reset a link: no credit, no queued events
+ */
+void TelemetryStreams_init(TelemetryStreams* ts);
+
+/**
+ * Earn credit for one telemetry tick of dtMs
+ */
+void TelemetryStreams_tick(TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                           uint16_t dtMs);
+
+/**
+ * Queue an event for the next frame (oldest dropped when full)
+ */
+void TelemetryStreams_postEvent(TelemetryStreams* ts, uint8_t code, uint16_t arg);
+
+/**
+ * Queue events for what changed since the last snapshot (nothing on the
+ * first: it only sets the baseline)
+ */
+void TelemetryStreams_watch(TelemetryStreams* ts, TelemetryEventWatch* watch,
+                            const TelemetrySnapshot* snap);
+
+/**
+ * Pack the events and the due streams into one frame
+ * @param budget Bytes the frame may take (clamped to out and the max frame)
+ * @return Frame length, 0 if nothing was due
+ */
+size_t TelemetryStreams_pack(TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                             const TelemetrySnapshot* snap, uint8_t budget,
+                             uint8_t* out, size_t outSize);
+
+/**
+ * Pick the one stream for a link that sends a record per slot (CRSF
+ * telemetry): queued events first, then the best due stream, with the
+ * same credit and aging as pack(). Picking EVENTS empties the queue.
+ * @param mask Bit per TelemetryStreamId the link can carry
+ * @return Stream to send, TELEMETRY_STREAM_COUNT if none is due
+ */
+TelemetryStreamId TelemetryStreams_next(TelemetryStreams* ts, const TelemetryStreamsConfig* config,
+                                        uint8_t mask);
+
+// ============================================================================
+// Receiving
+// ============================================================================
+
+/**
+ * Decode a stream frame
+ * @return false on a bad type, CRC or record bounds
+ */
+bool TelemetryStreams_decode(const uint8_t* data, size_t len, TelemetryStreamFrame* frame);
+
+#endif // TELEMETRY_STREAMS_H
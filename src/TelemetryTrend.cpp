@@ -0,0 +1,246 @@
+#include "TelemetryTrend.h"
+#include "Crc16.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * TelemetryTrend - Implementation
+ *
+ * Windows follow snapshot uptime: the first sample opens one and the
+ * first sample at or past its length closes it (and opens the next), so
+ * a stalled telemetry task gives a longer window, never a fabricated one.
+ *
+ * @file TelemetryTrend.cpp
+ */
+
+#define RECORD_HEADER_SIZE 2            // id + length
+#define TREND_FIXED_SIZE 5              // window + samples + present
+#define TREND_STAT_SIZE 6               // min, max, mean
+
+static const char* const NAMES[TELEMETRY_TREND_COUNT] = {"depth", "volt", "amps", "herr", "loop"};
+
+// Wire units per metric unit
+static const float SCALE[TELEMETRY_TREND_COUNT] = {100.0f, 100.0f, 100.0f, 100.0f, 1.0f};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static void put_u16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)(v & 0xFF);
+    out[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* out, uint32_t v) {
+    put_u16(out, (uint16_t)(v & 0xFFFF));
+    put_u16(out + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    return (uint32_t)get_u16(in) | ((uint32_t)get_u16(in + 2) << 16);
+}
+
+static int16_t sat_i16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lroundf(v);
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void TelemetryTrend_defaultConfig(TelemetryTrendConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->enabled = false;
+    config->windowMs = 10000;
+}
+
+void TelemetryTrend_sanitize(TelemetryTrendConfig* config) {
+    if (config->windowMs < TELEMETRY_TREND_MIN_WINDOW_MS)
+        config->windowMs = TELEMETRY_TREND_MIN_WINDOW_MS;
+    if (config->windowMs > TELEMETRY_TREND_MAX_WINDOW_MS)
+        config->windowMs = TELEMETRY_TREND_MAX_WINDOW_MS;
+}
+
+const char* TelemetryTrend_name(TelemetryTrendMetric metric) {
+    return (unsigned)metric < TELEMETRY_TREND_COUNT ? NAMES[metric] : NULL;
+}
+
+// ============================================================================
+// Aggregation
+// ============================================================================
+
+void TelemetryTrend_init(TelemetryTrend* tt) {
+    memset(tt, 0, sizeof(*tt));
+}
+
+static void openWindow(TelemetryTrend* tt, uint32_t nowMs) {
+    uint32_t windows = tt->windows;
+    memset(tt, 0, sizeof(*tt));
+    tt->windows = windows;
+    tt->open = true;
+    tt->start = nowMs;
+}
+
+void TelemetryTrend_add(TelemetryTrend* tt, TelemetryTrendMetric metric, float value,
+                        uint32_t nowMs) {
+    if ((unsigned)metric >= TELEMETRY_TREND_COUNT || isnan(value))
+        return;
+    if (!tt->open)
+        openWindow(tt, nowMs);
+    if (tt->count[metric] == 0) {
+        tt->min[metric] = value;
+        tt->max[metric] = value;
+    } else {
+        if (value < tt->min[metric]) tt->min[metric] = value;
+        if (value > tt->max[metric]) tt->max[metric] = value;
+    }
+    tt->sum[metric] += value;
+    if (tt->count[metric] < UINT16_MAX)
+        tt->count[metric]++;
+}
+
+bool TelemetryTrend_update(TelemetryTrend* tt, const TelemetryTrendConfig* config,
+                           const TelemetrySnapshot* snap, float amps,
+                           TelemetryTrendWindow* out) {
+    if (!config->enabled) {
+        tt->open = false;
+        return false;
+    }
+
+    bool closed = false;
+    if (tt->open && snap->uptime - tt->start >= config->windowMs) {
+        if (tt->samples > 0) {
+            memset(out, 0, sizeof(*out));
+            out->start = tt->start;
+            out->durationMs = config->windowMs;
+            out->samples = tt->samples;
+            for (int i = 0; i < TELEMETRY_TREND_COUNT; i++) {
+                if (tt->count[i] == 0)
+                    continue;
+                out->present |= (uint8_t)(1 << i);
+                out->stat[i].min = tt->min[i];
+                out->stat[i].max = tt->max[i];
+                out->stat[i].mean = tt->sum[i] / tt->count[i];
+            }
+            tt->windows++;
+            closed = true;
+        }
+        tt->open = false;
+    }
+
+    if (!tt->open)
+        openWindow(tt, snap->uptime);
+    if (tt->samples < UINT16_MAX)
+        tt->samples++;
+    TelemetryTrend_add(tt, TELEMETRY_TREND_DEPTH, snap->depth, snap->uptime);
+    if (snap->batteryMv > 0)
+        TelemetryTrend_add(tt, TELEMETRY_TREND_VOLTAGE, snap->batteryMv / 1000.0f, snap->uptime);
+    TelemetryTrend_add(tt, TELEMETRY_TREND_CURRENT, amps, snap->uptime);
+    if (snap->navFlags & (TELEMETRY_NAV_MISSION_ACTIVE | TELEMETRY_NAV_RTL_ACTIVE))
+        TelemetryTrend_add(tt, TELEMETRY_TREND_HEADING_ERROR, snap->headingError, snap->uptime);
+    TelemetryTrend_add(tt, TELEMETRY_TREND_LOOP, (float)snap->maxLoopUs, snap->uptime);
+    return closed;
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+size_t TelemetryTrend_pack(const TelemetryTrendWindow* window, uint8_t sequence,
+                           uint8_t* out, size_t outSize) {
+    size_t payload = TREND_FIXED_SIZE;
+    for (int i = 0; i < TELEMETRY_TREND_COUNT; i++) {
+        if (window->present & (1 << i))
+            payload += TREND_STAT_SIZE;
+    }
+    size_t len = TELEMETRY_STREAM_HEADER_SIZE + RECORD_HEADER_SIZE + payload;
+    if (len + TELEMETRY_STREAM_CRC_SIZE > outSize)
+        return 0;
+
+    out[0] = TELEMETRY_STREAM_TYPE;
+    out[1] = sequence;
+    put_u32(out + 2, window->start);
+    uint8_t* p = out + TELEMETRY_STREAM_HEADER_SIZE;
+    p[0] = TELEMETRY_TREND_RECORD_ID;
+    p[1] = (uint8_t)payload;
+    p += RECORD_HEADER_SIZE;
+    put_u16(p, window->durationMs);
+    put_u16(p + 2, window->samples);
+    p[4] = window->present;
+    p += TREND_FIXED_SIZE;
+    for (int i = 0; i < TELEMETRY_TREND_COUNT; i++) {
+        if (!(window->present & (1 << i)))
+            continue;
+        put_u16(p, (uint16_t)sat_i16(window->stat[i].min * SCALE[i]));
+        put_u16(p + 2, (uint16_t)sat_i16(window->stat[i].max * SCALE[i]));
+        put_u16(p + 4, (uint16_t)sat_i16(window->stat[i].mean * SCALE[i]));
+        p += TREND_STAT_SIZE;
+    }
+    put_u16(out + len, Crc16_compute(out, len));
+    return len + TELEMETRY_STREAM_CRC_SIZE;
+}
+
+bool TelemetryTrend_decode(const uint8_t* data, size_t len, TelemetryTrendWindow* window) {
+    if (!data || len < TELEMETRY_STREAM_HEADER_SIZE + TELEMETRY_STREAM_CRC_SIZE ||
+        data[0] != TELEMETRY_STREAM_TYPE)
+        return false;
+    size_t end = len - TELEMETRY_STREAM_CRC_SIZE;
+    if (get_u16(data + end) != Crc16_compute(data, end))
+        return false;
+
+    size_t pos = TELEMETRY_STREAM_HEADER_SIZE;
+    while (pos + RECORD_HEADER_SIZE <= end) {
+        uint8_t id = data[pos];
+        uint8_t size = data[pos + 1];
+        const uint8_t* p = data + pos + RECORD_HEADER_SIZE;
+        pos += RECORD_HEADER_SIZE + size;
+        if (pos > end)
+            return false;
+        if (id != TELEMETRY_TREND_RECORD_ID || size < TREND_FIXED_SIZE)
+            continue;
+
+        memset(window, 0, sizeof(*window));
+        window->start = get_u32(data + 2);
+        window->durationMs = get_u16(p);
+        window->samples = get_u16(p + 2);
+        uint8_t present = p[4];
+        const uint8_t* s = p + TREND_FIXED_SIZE;
+        const uint8_t* stop = p + size;
+        for (int i = 0; i < TELEMETRY_TREND_COUNT; i++) {
+            if (!(present & (1 << i)))
+                continue;
+            if (s + TREND_STAT_SIZE > stop)
+                return false;
+            window->present |= (uint8_t)(1 << i);
+            window->stat[i].min = (int16_t)get_u16(s) / SCALE[i];
+            window->stat[i].max = (int16_t)get_u16(s + 2) / SCALE[i];
+            window->stat[i].mean = (int16_t)get_u16(s + 4) / SCALE[i];
+            s += TREND_STAT_SIZE;
+        }
+        return true;
+    }
+    return false;
+}
+
+size_t TelemetryTrend_jsonLine(const TelemetryTrendWindow* window, TelemetryTrendMetric metric,
+                               char* out, size_t outSize) {
+    if ((unsigned)metric >= TELEMETRY_TREND_COUNT || !(window->present & (1 << metric)))
+        return 0;
+    const TelemetryTrendStat* s = &window->stat[metric];
+    int n = snprintf(out, outSize,
+                     "{\"t\":3,\"m\":\"%s\",\"u\":%lu,\"w\":%u,\"n\":%u,"
+                     "\"min\":%.2f,\"max\":%.2f,\"avg\":%.2f}\r\n",
+                     NAMES[metric], (unsigned long)window->start,
+                     (unsigned)window->durationMs, (unsigned)window->samples,
+                     (double)s->min, (double)s->max, (double)s->mean);
+    if (n < 0 || (size_t)n >= outSize)
+        return 0;
+    return (size_t)n;
+}
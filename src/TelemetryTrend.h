@@ -0,0 +1,157 @@
+#ifndef TELEMETRY_TREND_H
+#define TELEMETRY_TREND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "TelemetrySnapshot.h"
+#include "TelemetryStreams.h"
+
+/**
+ * TelemetryTrend - Windowed min / max / mean of the slow-moving metrics
+ *
+ * On a long dive the 20 Hz values are noise to a ground station on a
+ * thin link; what it needs is how depth, pack voltage and current,
+ * heading error and loop time moved over the last 1 or 10 seconds.
+ * Every telemetry snapshot is folded into running min / max / sum per
+ * metric (constant memory, no sample buffer), and when the window ends
+ * its summary is handed out once:
+ *
+ *   - as a TelemetryStreams frame (same header and CRC) carrying one
+ *     record of id TELEMETRY_TREND_RECORD_ID, which older receivers skip:
+ *
+ *     | window ms u16 | samples u16 | present u8 | (min, max, mean i16) per metric |
+ *
+ *     scaled: depth cm, voltage 10 mV, current 10 mA, heading error
+ *     0.01 degree, loop time us; the frame uptime is the window start
+ *   - as JSON log lines, one per metric ({"t":3,...})
+ *
+ * A metric without a source (no current sensor, heading error while not
+ * navigating) is left out of the window rather than counted as 0.
+ *
+ * Stored as a config blob (TELEMETRY_TREND_CONFIG_KEY).
+ *
+ * Pure: no globals, no RTOS. Owned by the telemetry task.
+ *
+ * @file TelemetryTrend.h
+ */
+
+#define TELEMETRY_TREND_CONFIG_KEY      "cfg_trend"
+#define TELEMETRY_TREND_RECORD_ID       0x10    // Above every TelemetryStreamId
+#define TELEMETRY_TREND_MIN_WINDOW_MS   1000
+#define TELEMETRY_TREND_MAX_WINDOW_MS   60000
+#define TELEMETRY_TREND_JSON_MAX        112     // One metric line, fits a log slot
+
+typedef enum {
+    TELEMETRY_TREND_DEPTH = 0,
+    TELEMETRY_TREND_VOLTAGE,
+    TELEMETRY_TREND_CURRENT,
+    TELEMETRY_TREND_HEADING_ERROR,
+    TELEMETRY_TREND_LOOP,
+    TELEMETRY_TREND_COUNT
+} TelemetryTrendMetric;
+
+typedef struct {
+    bool enabled;
+    uint16_t windowMs;
+} TelemetryTrendConfig;
+
+typedef struct {
+    float min;
+    float max;
+    float mean;
+} TelemetryTrendStat;
+
+/**
+ * One closed window (values in m, V, A, degrees, us)
+ */
+typedef struct {
+    uint32_t start;                 // Uptime ms of the first sample
+    uint16_t durationMs;            // Configured window length
+    uint16_t samples;               // Snapshots folded in
+    uint8_t present;                // Bit per TelemetryTrendMetric
+    TelemetryTrendStat stat[TELEMETRY_TREND_COUNT];
+} TelemetryTrendWindow;
+
+/**
+ * Running state of the open window
+ */
+typedef struct {
+    bool open;
+    uint32_t start;
+    uint16_t samples;
+    uint16_t count[TELEMETRY_TREND_COUNT];
+    float min[TELEMETRY_TREND_COUNT];
+    float max[TELEMETRY_TREND_COUNT];
+    float sum[TELEMETRY_TREND_COUNT];
+    uint32_t windows;               // Closed since init
+} TelemetryTrend;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+/**
+ * Defaults: off, 10 s windows
+ */
+void TelemetryTrend_defaultConfig(TelemetryTrendConfig* config);
+
+/**
+ * Clamp the window into TELEMETRY_TREND_MIN/MAX_WINDOW_MS
+ */
+void TelemetryTrend_sanitize(TelemetryTrendConfig* config);
+
+/**
+ * Metric name ("depth", "volt", "amps", "herr", "loop"), NULL out of range
+ */
+const char* TelemetryTrend_name(TelemetryTrendMetric metric);
+
+// ============================================================================
+// Aggregation
+// ============================================================================
+
+void TelemetryTrend_init(TelemetryTrend* tt);
+
+/**
+ * Fold one value into the open window (opened at nowMs if none is)
+ */
+void TelemetryTrend_add(TelemetryTrend* tt, TelemetryTrendMetric metric, float value,
+                        uint32_t nowMs);
+
+/**
+ * Close the window if it has run its length by snap's uptime, then fold
+ * the snapshot into the open one. Disabled: nothing kept
+ * @param amps Pack current, NAN without a current source
+ * @param out Summary of the window just closed
+ * @return true if a window with samples closed
+ */
+bool TelemetryTrend_update(TelemetryTrend* tt, const TelemetryTrendConfig* config,
+                           const TelemetrySnapshot* snap, float amps,
+                           TelemetryTrendWindow* out);
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+/**
+ * TelemetryStreams frame with the window's trend record
+ * @return Frame length, 0 if out is too small
+ */
+size_t TelemetryTrend_pack(const TelemetryTrendWindow* window, uint8_t sequence,
+                           uint8_t* out, size_t outSize);
+
+/**
+ * Trend record of a TelemetryStreams frame
+ * @return false on a bad frame or one without a trend record
+ */
+bool TelemetryTrend_decode(const uint8_t* data, size_t len, TelemetryTrendWindow* window);
+
+/**
+ * JSON log line of one metric, CRLF terminated:
+ * {"t":3,"m":"depth","u":120000,"w":10000,"n":200,"min":..,"max":..,"avg":..}
+ * @return Line length, 0 if the metric is not in the window
+ */
+size_t TelemetryTrend_jsonLine(const TelemetryTrendWindow* window, TelemetryTrendMetric metric,
+                               char* out, size_t outSize);
+
+#endif // TELEMETRY_TREND_H
@@ -1,64 +1,432 @@
 #include "TelemetryWebSocket.h"
-#include "NavigationManager.h"
-#include "DepthManager.h"
+#include "HAL.h"
+#include "Log.h"
+#include "MemPlacement.h"
 #include <ArduinoJson.h>
 
+// Subscription names, in WS_FIELD_* bit order
+static const char* const FIELD_NAMES[] = {"bat", "gps", "depth", "nav", "prof", "time"};
+
 TelemetryWebSocket& TelemetryWebSocket::getInstance() {
-    static TelemetryWebSocket instance;
+    // Frame payloads, arena and client queues (~5 KB), telemetry task only
+    BULK_BSS static TelemetryWebSocket instance;
     return instance;
 }
 
-TelemetryWebSocket::TelemetryWebSocket() : _ws("/ws"), _lastBroadcast(0) {}
+TelemetryWebSocket::TelemetryWebSocket()
+    : _ws("/ws"), _lastBroadcast(0), _controlHandler(nullptr), _jsonArena(_jsonArenaBuffer, sizeof(_jsonArenaBuffer)) {
+    memset(_clients, 0, sizeof(_clients));
+    memset(_binaryBuffers, 0, sizeof(_binaryBuffers));
+    TelemetryHistory_init(&_history, nullptr, 0);
+    MemPlacement_note("websocket", this, sizeof(*this), MEM_CLASS_BULK);
+}
 
 void TelemetryWebSocket::begin(AsyncWebServer* server) {
     if (!server) return;
-    
-    _ws.onEvent([](AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len) {
-        if (type == WS_EVT_CONNECT) {
-            Serial.printf("[WS] Client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
-        } else if (type == WS_EVT_DISCONNECT) {
-            Serial.printf("[WS] Client #%u disconnected\n", client->id());
-        }
+
+    // Without room the dashboard just starts with empty charts
+    uint16_t seconds = MemPlacement_hasPsram() ? WS_HISTORY_SECONDS_PSRAM : WS_HISTORY_SECONDS_INTERNAL;
+    uint16_t capacity = seconds * 1000 / TELEMETRY_HISTORY_INTERVAL_MS;
+    TelemetryHistoryRecord* records = (TelemetryHistoryRecord*)MemPlacement_alloc(
+        "ws_history", capacity * sizeof(TelemetryHistoryRecord), MEM_CLASS_BULK);
+    TelemetryHistory_init(&_history, records, records ? capacity : 0);
+
+    _ws.onEvent([this](AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len) {
+        onEvent(client, type, arg, data, len);
     });
-    
+
     server->addHandler(&_ws);
     Serial.println("[WS] WebSocket Server Configured at /ws");
 }
 
-void TelemetryWebSocket::broadcast(const NATelemetry& data) {
-    // Throttling
-    if (millis() - _lastBroadcast < WS_BROADCAST_INTERVAL_MS) return;
-    _lastBroadcast = millis();
-    
-    if (_ws.count() == 0) return; // No clients, save CPU
+void TelemetryWebSocket::setControlHandler(WSControlHandler handler) {
+    _controlHandler = handler;
+}
+
+void TelemetryWebSocket::onEvent(AsyncWebSocketClient* client, AwsEventType type,
+                                 void* arg, uint8_t* data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+        IPAddress ip = client->remoteIP();     // Printed by octet: toString() allocates
+        LOG_INFO("[WS] Client #%u connected from %u.%u.%u.%u\n", client->id(),
+                 ip[0], ip[1], ip[2], ip[3]);
+        portENTER_CRITICAL(&_clientMux);
+        ClientSlot* slot = findSlot(0);
+        if (slot) {
+            slot->id = client->id();
+            slot->format = WS_FORMAT_JSON;
+            slot->fields = WS_FIELD_DEFAULT;
+            slot->divisor = 1;
+            slot->phase = 0;
+            slot->sent = 0;
+            slot->dropped = 0;
+            slot->historyPending = true;
+        }
+        portEXIT_CRITICAL(&_clientMux);
+    } else if (type == WS_EVT_DISCONNECT) {
+        LOG_INFO("[WS] Client #%u disconnected\n", client->id());
+        releaseClient(client->id());
+    } else if (type == WS_EVT_DATA) {
+        // Only single-frame messages: text = settings, binary = control
+        AwsFrameInfo* info = (AwsFrameInfo*)arg;
+        if (!info->final || info->index != 0 || info->len != len) return;
+        if (info->opcode == WS_TEXT) {
+            handleMessage(client->id(), (const char*)data, len);
+        } else if (info->opcode == WS_BINARY && _controlHandler) {
+            _controlHandler(data, len);
+        }
+    }
+}
+
+void TelemetryWebSocket::handleMessage(uint32_t id, const char* data, size_t len) {
+    // {"fmt":"bin"|"json", "sub":["bat","gps","depth","nav","prof","time"], "div":N}
+    JsonDocument doc;
+    if (deserializeJson(doc, data, len)) return;
+
+    portENTER_CRITICAL(&_clientMux);
+    ClientSlot* slot = findSlot(id);
+    if (!slot) {
+        portEXIT_CRITICAL(&_clientMux);
+        return;
+    }
+    ClientSlot updated = *slot;
+    portEXIT_CRITICAL(&_clientMux);
+
+    const char* fmt = doc["fmt"];
+    if (fmt) {
+        updated.format = strcmp(fmt, "bin") == 0 ? WS_FORMAT_BINARY : WS_FORMAT_JSON;
+    }
+
+    JsonArrayConst sub = doc["sub"];
+    if (sub) {
+        uint8_t fields = 0;
+        for (JsonVariantConst v : sub) {
+            const char* name = v.as<const char*>();
+            if (!name) continue;
+            if (strcmp(name, "all") == 0) fields = WS_FIELD_ALL;
+            for (uint8_t i = 0; i < sizeof(FIELD_NAMES) / sizeof(FIELD_NAMES[0]); i++) {
+                if (strcmp(name, FIELD_NAMES[i]) == 0) fields |= (1 << i);
+            }
+        }
+        updated.fields = fields;
+    }
+
+    if (!doc["div"].isNull()) {
+        int div = doc["div"] | 1;
+        updated.divisor = (uint8_t)constrain(div, 1, WS_MAX_RATE_DIVISOR);
+        updated.phase = 0;
+    }
 
+    portENTER_CRITICAL(&_clientMux);
+    slot = findSlot(id);
+    if (slot) {
+        // Counters may have moved while the message was parsed
+        updated.sent = slot->sent;
+        updated.dropped = slot->dropped;
+        *slot = updated;
+    }
+    portEXIT_CRITICAL(&_clientMux);
+
+    LOG_INFO("[WS] Client #%u fmt=%s fields=0x%02X div=%u\n", id,
+             updated.format == WS_FORMAT_BINARY ? "bin" : "json",
+             updated.fields, updated.divisor);
+}
+
+TelemetryWebSocket::ClientSlot* TelemetryWebSocket::findSlot(uint32_t id) {
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        if (_clients[i].id == id) return &_clients[i];
+    }
+    return nullptr;
+}
+
+void TelemetryWebSocket::releaseClient(uint32_t id) {
+    portENTER_CRITICAL(&_clientMux);
+    ClientSlot* slot = findSlot(id);
+    if (slot) slot->id = 0;
+    portEXIT_CRITICAL(&_clientMux);
+}
+
+uint8_t TelemetryWebSocket::getClientStats(WSClientStats* out, uint8_t maxClients) {
+    uint8_t n = 0;
+    portENTER_CRITICAL(&_clientMux);
+    for (int i = 0; i < WS_MAX_CLIENTS && n < maxClients; i++) {
+        const ClientSlot& c = _clients[i];
+        if (c.id == 0) continue;
+        out[n].id = c.id;
+        out[n].format = c.format;
+        out[n].fields = c.fields;
+        out[n].divisor = c.divisor;
+        out[n].sent = c.sent;
+        out[n].dropped = c.dropped;
+        n++;
+    }
+    portEXIT_CRITICAL(&_clientMux);
+    return n;
+}
+
+bool TelemetryWebSocket::isLagging(AsyncWebSocketClient* client) {
+    // Send queue backed up (slow Wi-Fi / tab in background): skip, the next
+    // frame supersedes this one anyway
+    return !client->canSend() || client->queueIsFull() ||
+           client->queueLen() >= WS_CLIENT_QUEUE_LIMIT;
+}
+
+bool TelemetryWebSocket::sendHistory(AsyncWebSocketClient* client) {
+    if (_history.count == 0) return true;
+    if (isLagging(client)) return false;
+
+    // Records are copied straight into the message buffer: one copy, one frame
+    size_t len = sizeof(WSHistoryHeader) + _history.count * sizeof(TelemetryHistoryRecord);
+    AsyncWebSocketMessageBuffer* buffer = _ws.makeBuffer(len);
+    if (!buffer) return true; // No heap for it now: go live without history
+
+    WSHistoryHeader hdr;
+    hdr.type = WS_FRAME_HISTORY;
+    hdr.version = WS_HISTORY_VERSION;
+    hdr.count = TelemetryHistory_copy(&_history, buffer->get() + sizeof(hdr), _history.count);
+    hdr.intervalMs = TELEMETRY_HISTORY_INTERVAL_MS;
+    hdr.recordSize = sizeof(TelemetryHistoryRecord);
+    memcpy(buffer->get(), &hdr, sizeof(hdr));
+    client->binary(buffer);
+    return true;
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+size_t TelemetryWebSocket::encodeBinary(const TelemetrySnapshot& s, uint8_t fields, uint8_t* out) {
+    WSTelemetryHeader hdr;
+    hdr.type = WS_FRAME_TELEMETRY;
+    hdr.version = WS_BINARY_VERSION;
+    hdr.fields = fields;
+    hdr.flags = s.encrypted ? WS_FLAG_ENCRYPTED : 0;
+    hdr.status = s.status;
+    hdr.rssi = s.rssi;
+    hdr.uptime = s.uptime;
+
+    size_t n = 0;
+    memcpy(out, &hdr, sizeof(hdr));
+    n += sizeof(hdr);
+
+#define PUT(v) do { memcpy(out + n, &(v), sizeof(v)); n += sizeof(v); } while (0)
+    if (fields & WS_FIELD_BATTERY) {
+        float v = s.batteryMv / 1000.0f;
+        PUT(v);
+    }
+    if (fields & WS_FIELD_GPS) {
+        PUT(s.lat);
+        PUT(s.lng);
+    }
+    if (fields & WS_FIELD_DEPTH) {
+        PUT(s.depth);
+    }
+    if (fields & WS_FIELD_NAV) {
+        PUT(s.wpIndex);
+        PUT(s.navFlags);
+        PUT(s.dist);
+        PUT(s.headingError);
+    }
+    if (fields & WS_FIELD_PROFILER) {
+        PUT(s.heapPct);
+        PUT(s.cpuPct);
+        PUT(s.maxLoopUs);
+    }
+    if (fields & WS_FIELD_TIME) {
+        PUT(s.utcMs);
+        PUT(s.timeSync);
+    }
+#undef PUT
+    return n;
+}
+
+size_t TelemetryWebSocket::encodeJson(const TelemetrySnapshot& s, uint8_t fields, char* out, size_t outSize) {
     // Serialize to JSON (Phase 11: Optimized JSON)
     // Format: {t:2, v:12.6, r:-60, s:1, u:1000}
-    JsonDocument doc;
+    JsonArenaScope arenaScope(_jsonArena);
+    JsonDocument doc(&_jsonArena);
     doc["t"] = 2; // Type Telemetry
-    doc["v"] = data.batteryVoltage;
-    doc["r"] = data.rssi;
-    doc["s"] = data.status;
-    doc["u"] = data.uptime;
-    
-    // Phase 12/13: Position and Depth
-    float lat, lng;
-    NavigationManager::getInstance().getGPSLocation(lat, lng);
-    doc["lat"] = lat;
-    doc["lng"] = lng;
-    doc["alt"] = DepthManager::getInstance().getActualDepth();
-    
-    // Check Encryption Status
-    if (data.encryptionFlag) {
+    doc["r"] = s.rssi;
+    doc["s"] = s.status;
+    doc["u"] = s.uptime;
+
+    if (fields & WS_FIELD_BATTERY) {
+        doc["v"] = s.batteryMv / 1000.0f;
+    }
+    if (fields & WS_FIELD_GPS) {
+        doc["lat"] = s.lat;
+        doc["lng"] = s.lng;
+    }
+    if (fields & WS_FIELD_DEPTH) {
+        doc["alt"] = s.depth;
+    }
+    if (fields & WS_FIELD_NAV) {
+        doc["wp"] = s.wpIndex;
+        doc["dist"] = s.dist;
+        doc["herr"] = s.headingError;
+        doc["mis"] = (s.navFlags & WS_NAV_MISSION_ACTIVE) ? 1 : 0;
+        doc["rtl"] = (s.navFlags & WS_NAV_RTL_ACTIVE) ? 1 : 0;
+    }
+    if (fields & WS_FIELD_PROFILER) {
+        doc["heap"] = s.heapPct;
+        doc["cpu"] = s.cpuPct;
+        doc["loop"] = s.maxLoopUs;
+    }
+    if ((fields & WS_FIELD_TIME) && s.timeSync) {
+        doc["utc"] = s.utcMs;
+        doc["ts"] = s.timeSync;
+    }
+
+    // Radio link encrypted (values here are plaintext either way)
+    if (s.encrypted) {
         doc["enc"] = 1;
     }
-    
-    // We could optimize by sending binary, but JSON is easier for web clients for now.
-    // Length is roughly 60-80 bytes.
-    String output;
-    serializeJson(doc, output);
-    
-    _ws.textAll(output);
+
+    return serializeJson(doc, out, outSize);
+}
+
+AsyncWebSocketMessageBuffer* TelemetryWebSocket::acquireBinaryBuffer(uint8_t fields, size_t len) {
+    BinaryBuffer* freeEntry = nullptr;
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        BinaryBuffer& b = _binaryBuffers[i];
+        if (b.buffer && b.fields == fields) {
+            // Still referenced by a queued message: rewriting it would tear that frame
+            return b.buffer->count() == 0 ? b.buffer : nullptr;
+        }
+        if (!b.buffer && !freeEntry) freeEntry = &b;
+    }
+    if (!freeEntry) return nullptr;
+
+    // Frame length is fixed per field set, so the buffer is sized once
+    freeEntry->buffer = _ws.makeBuffer(len);
+    if (!freeEntry->buffer) return nullptr;
+    freeEntry->buffer->lock(); // Keep it out of AsyncWebSocket's buffer cleanup
+    freeEntry->fields = fields;
+    return freeEntry->buffer;
+}
+
+// ============================================================================
+// Broadcast
+// ============================================================================
+
+void TelemetryWebSocket::broadcast(const TelemetrySnapshot& snap) {
+    // Throttling
+    if (HAL_GetMillis() - _lastBroadcast < WS_BROADCAST_INTERVAL_MS) return;
+    _lastBroadcast = HAL_GetMillis();
+
+    // Recorded with or without clients, for the next one to connect
+    TelemetryHistory_push(&_history, &snap);
+
+    if (_ws.count() == 0) return; // No clients, save CPU
+
+    // Advance per-client schedules and pick the clients due this tick;
+    // a new client gets its history first and live frames from the next tick
+    ClientSlot due[WS_MAX_CLIENTS];
+    uint32_t historyIds[WS_MAX_CLIENTS];
+    uint8_t dueCount = 0, connected = 0, historyCount = 0;
+    portENTER_CRITICAL(&_clientMux);
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        ClientSlot& c = _clients[i];
+        if (c.id == 0) continue;
+        connected++;
+        if (c.historyPending) {
+            historyIds[historyCount++] = c.id;
+            continue;
+        }
+        if (++c.phase < c.divisor) continue;
+        c.phase = 0;
+        due[dueCount++] = c;
+    }
+    portEXIT_CRITICAL(&_clientMux);
+
+    for (uint8_t i = 0; i < historyCount; i++) {
+        AsyncWebSocketClient* client = _ws.client(historyIds[i]);
+        // A busy client keeps it pending for the next tick
+        if (client && !sendHistory(client)) continue;
+        portENTER_CRITICAL(&_clientMux);
+        ClientSlot* slot = findSlot(historyIds[i]);
+        if (slot) slot->historyPending = false;
+        portEXIT_CRITICAL(&_clientMux);
+    }
+    if (dueCount == 0) return;
+
+    // Drop this frame for lagging clients before anything is encoded or queued
+    AsyncWebSocketClient* targets[WS_MAX_CLIENTS];
+    bool dropped[WS_MAX_CLIENTS];
+    uint8_t sendCount = 0;
+    for (uint8_t i = 0; i < dueCount; i++) {
+        targets[i] = _ws.client(due[i].id);
+        dropped[i] = targets[i] && isLagging(targets[i]);
+        if (targets[i] && !dropped[i]) sendCount++;
+    }
+
+    if (sendCount > 0) {
+        send(snap, due, targets, dropped, dueCount, sendCount == connected);
+    }
+
+    // Account per client (slot may have been released meanwhile)
+    portENTER_CRITICAL(&_clientMux);
+    for (uint8_t i = 0; i < dueCount; i++) {
+        if (!targets[i]) continue;
+        ClientSlot* slot = findSlot(due[i].id);
+        if (!slot) continue;
+        if (dropped[i]) slot->dropped++;
+        else slot->sent++;
+    }
+    portEXIT_CRITICAL(&_clientMux);
+}
+
+void TelemetryWebSocket::send(const TelemetrySnapshot& s, const ClientSlot* due,
+                              AsyncWebSocketClient* const* targets,
+                              const bool* dropped, uint8_t dueCount,
+                              bool allClients) {
+    // Each distinct (format, fields) is encoded once per tick
+    uint8_t encodingCount = 0;
+    uint8_t encodingOf[WS_MAX_CLIENTS];
+    for (uint8_t i = 0; i < dueCount; i++) {
+        if (!targets[i] || dropped[i]) continue;
+        uint8_t e = 0;
+        while (e < encodingCount &&
+               (_encodings[e].format != due[i].format || _encodings[e].fields != due[i].fields)) e++;
+        encodingOf[i] = e;
+        if (e < encodingCount) continue;
+
+        Encoding& enc = _encodings[encodingCount++];
+        enc.format = due[i].format;
+        enc.fields = due[i].fields;
+        enc.shared = nullptr;
+        if (enc.format == WS_FORMAT_BINARY) {
+            enc.len = encodeBinary(s, enc.fields, _payloads[e]);
+            enc.shared = acquireBinaryBuffer(enc.fields, enc.len);
+            if (enc.shared) memcpy(enc.shared->get(), _payloads[e], enc.len);
+        } else {
+            enc.len = encodeJson(s, enc.fields, (char*)_payloads[e], WS_JSON_MAX);
+        }
+    }
+
+    // Every connected client gets the same JSON frame: one shared buffer,
+    // released by textAll
+    if (allClients && encodingCount == 1 && _encodings[0].format == WS_FORMAT_JSON) {
+        AsyncWebSocketMessageBuffer* jsonBuf = _ws.makeBuffer(_encodings[0].len);
+        if (jsonBuf) {
+            memcpy(jsonBuf->get(), _payloads[0], _encodings[0].len);
+            _ws.textAll(jsonBuf);
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < dueCount; i++) {
+        if (!targets[i] || dropped[i]) continue;
+
+        uint8_t e = encodingOf[i];
+        const Encoding& enc = _encodings[e];
+        if (enc.format == WS_FORMAT_BINARY) {
+            // Shared buffer; copy only if the previous frame is still queued
+            if (enc.shared) targets[i]->binary(enc.shared);
+            else targets[i]->binary(_payloads[e], enc.len);
+        } else {
+            targets[i]->text((const char*)_payloads[e], enc.len);
+        }
+    }
 }
 
 void TelemetryWebSocket::cleanUp() {
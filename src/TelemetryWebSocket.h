@@ -3,24 +3,200 @@
 
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
-#include "NAPacket.h"
+#include <freertos/FreeRTOS.h>
+#include "JsonArena.h"
+#include "TelemetryHistory.h"
+#include "TelemetrySnapshot.h"
 
 // Rate limit broadcasts to save bandwidth/CPU
 // 20Hz target = 50ms interval
 #define WS_BROADCAST_INTERVAL_MS 50
 
+// Matches DEFAULT_MAX_WS_CLIENTS of AsyncWebSocket on ESP32
+#define WS_MAX_CLIENTS 8
+
+// Largest JSON frame (all field groups)
+#define WS_JSON_MAX 256
+
+// Arena for the JSON frame document (one variant pool + slack)
+#define WS_JSON_ARENA_SIZE 1536
+
+// Binary telemetry frame (client opts in with {"fmt":"bin"})
+#define WS_FRAME_TELEMETRY 2
+#define WS_BINARY_VERSION 3
+#define WS_FLAG_ENCRYPTED 0x01
+
+// History frame sent to a new client before live data
+#define WS_FRAME_HISTORY 3
+#define WS_HISTORY_VERSION 1
+
+// History window: 120 s in PSRAM, 30 s when it has to be internal DRAM
+// (records of TELEMETRY_HISTORY_INTERVAL_MS, 26 bytes each)
+#define WS_HISTORY_SECONDS_PSRAM 120
+#define WS_HISTORY_SECONDS_INTERNAL 30
+
+// Optional field groups, selected per client with {"sub":[...]}
+#define WS_FIELD_BATTERY  0x01  // "bat":   v
+#define WS_FIELD_GPS      0x02  // "gps":   lat, lng
+#define WS_FIELD_DEPTH    0x04  // "depth": alt
+#define WS_FIELD_NAV      0x08  // "nav":   wp, dist, herr, mis, rtl
+#define WS_FIELD_PROFILER 0x10  // "prof":  heap, cpu, loop
+#define WS_FIELD_TIME     0x20  // "time":  utc, ts (GPS time sync)
+#define WS_FIELD_ALL      0x3F
+#define WS_FIELD_DEFAULT  (WS_FIELD_BATTERY | WS_FIELD_GPS | WS_FIELD_DEPTH)
+
+// Rate divisor limit: 1 = every broadcast (20Hz), 20 = 1Hz
+#define WS_MAX_RATE_DIVISOR 20
+
+// Frames a client may have queued before new ones are dropped for it
+// (telemetry is latest-value-wins, older frames are never worth queuing)
+#define WS_CLIENT_QUEUE_LIMIT 2
+
+/**
+ * Binary frame: header, then each selected group in bit order
+ * (packed little endian, read with DataView on the dashboard side).
+ * Values are always plaintext; WS_FLAG_ENCRYPTED only reports that the
+ * radio link is encrypted
+ *
+ *   battery  : float voltage
+ *   gps      : float lat, float lng
+ *   depth    : float alt
+ *   nav      : uint16 wpIndex, uint8 navFlags, float dist, float headingError
+ *   profiler : float heapPct, float cpuPct, uint32 maxLoopUs
+ *   time     : int64 utcMs (0 = no time yet), uint8 TimeSyncState
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t type;       // WS_FRAME_TELEMETRY
+    uint8_t version;    // WS_BINARY_VERSION
+    uint8_t fields;     // WS_FIELD_* present
+    uint8_t flags;      // WS_FLAG_*
+    uint8_t status;
+    int8_t rssi;
+    uint32_t uptime;
+} WSTelemetryHeader;
+
+/**
+ * History frame: header, then count TelemetryHistoryRecord oldest first
+ * (one binary message, to JSON and binary clients alike)
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t type;       // WS_FRAME_HISTORY
+    uint8_t version;    // WS_HISTORY_VERSION
+    uint16_t count;
+    uint16_t intervalMs;    // TELEMETRY_HISTORY_INTERVAL_MS
+    uint16_t recordSize;    // sizeof(TelemetryHistoryRecord)
+} WSHistoryHeader;
+
+// navFlags bits
+#define WS_NAV_MISSION_ACTIVE TELEMETRY_NAV_MISSION_ACTIVE
+#define WS_NAV_WP_REACHED     TELEMETRY_NAV_WP_REACHED
+#define WS_NAV_RTL_ACTIVE     TELEMETRY_NAV_RTL_ACTIVE
+
+/**
+ * Binary message from a client: a control frame in the radio layout
+ * (NAPacket or NAPacketAEAD). Called on the AsyncTCP task; the handler
+ * validates it like an ESP-NOW frame
+ */
+typedef void (*WSControlHandler)(const uint8_t* data, size_t len);
+
+// Per-client wire format
+enum WSClientFormat : uint8_t {
+    WS_FORMAT_JSON = 0,     // Default, {t:2, v:12.6, ...}
+    WS_FORMAT_BINARY = 1,   // WSTelemetryHeader + groups
+};
+
+// Per-client delivery counters (see getClientStats)
+struct WSClientStats {
+    uint32_t id;
+    WSClientFormat format;
+    uint8_t fields;
+    uint8_t divisor;
+    uint32_t sent;
+    uint32_t dropped;   // Frames skipped because the client was lagging
+};
+
 class TelemetryWebSocket {
 public:
     static TelemetryWebSocket& getInstance();
 
     void begin(AsyncWebServer* server);
-    void broadcast(const NATelemetry& data);
+
+    /**
+     * Accept control frames on /ws (set before begin(), NULL = ignore)
+     */
+    void setControlHandler(WSControlHandler handler);
+    void broadcast(const TelemetrySnapshot& snap);
     void cleanUp(); // Call periodically to clean up clients
 
+    /**
+     * Copy per-client counters
+     * @param out Destination array
+     * @param maxClients Capacity of out
+     * @return Number of clients written
+     */
+    uint8_t getClientStats(WSClientStats* out, uint8_t maxClients);
+
 private:
     TelemetryWebSocket();
+
+    struct ClientSlot {
+        uint32_t id;        // 0 = free
+        WSClientFormat format;
+        uint8_t fields;     // WS_FIELD_*
+        uint8_t divisor;    // Send every Nth broadcast
+        uint8_t phase;      // Broadcasts since last send
+        uint32_t sent;
+        uint32_t dropped;
+        bool historyPending;    // History frame not sent yet
+    };
+
+    // One encoding per distinct (format, fields) per broadcast
+    struct Encoding {
+        WSClientFormat format;
+        uint8_t fields;
+        size_t len;
+        AsyncWebSocketMessageBuffer* shared; // Binary only, may be NULL
+    };
+
+    // Locked binary buffer reused for one field set
+    struct BinaryBuffer {
+        uint8_t fields;
+        AsyncWebSocketMessageBuffer* buffer;
+    };
+
+    void onEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg,
+                 uint8_t* data, size_t len);
+    void handleMessage(uint32_t id, const char* data, size_t len);
+    ClientSlot* findSlot(uint32_t id); // Caller holds _clientMux
+    void releaseClient(uint32_t id);
+    bool isLagging(AsyncWebSocketClient* client);
+    bool sendHistory(AsyncWebSocketClient* client);
+
+    size_t encodeBinary(const TelemetrySnapshot& s, uint8_t fields, uint8_t* out);
+    size_t encodeJson(const TelemetrySnapshot& s, uint8_t fields, char* out, size_t outSize);
+    AsyncWebSocketMessageBuffer* acquireBinaryBuffer(uint8_t fields, size_t len);
+    void send(const TelemetrySnapshot& s, const ClientSlot* due,
+              AsyncWebSocketClient* const* targets, const bool* dropped,
+              uint8_t dueCount, bool allClients);
+
     AsyncWebSocket _ws;
     uint32_t _lastBroadcast;
+    WSControlHandler _controlHandler;
+
+    // Slot table is written from the AsyncTCP task, read by telemetry
+    ClientSlot _clients[WS_MAX_CLIENTS];
+    portMUX_TYPE _clientMux = portMUX_INITIALIZER_UNLOCKED;
+
+    BinaryBuffer _binaryBuffers[WS_MAX_CLIENTS];
+
+    // Encoded frames for the current broadcast (telemetry task only)
+    Encoding _encodings[WS_MAX_CLIENTS];
+    uint8_t _payloads[WS_MAX_CLIENTS][WS_JSON_MAX];
+    alignas(JSON_ARENA_ALIGN) uint8_t _jsonArenaBuffer[WS_JSON_ARENA_SIZE];
+    JsonArena _jsonArena;
+
+    // Decimated telemetry (telemetry task only), BULK heap from begin()
+    TelemetryHistory _history;
 };
 
 #endif // TELEMETRY_WEBSOCKET_H
@@ -0,0 +1,199 @@
+#include "ThrustAllocator.h"
+#include "FastMath.h"
+#include <string.h>
+
+/**
+ * ThrustAllocator - Implementation
+ *
+ * @file ThrustAllocator.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+#define AXES            MIXER_AXIS_COUNT
+#define JACOBI_SWEEPS   30
+#define MIN_DIRECTION   1e-3f       // Shorter direction vectors are rejected
+#define MIN_COEFF       1e-5f       // Smaller allocation terms are zero
+
+// ============================================================================
+// Config
+// ============================================================================
+
+void ThrustAllocator_defaultConfig(ThrustConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->count = 3;
+    config->thrusters[0] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};     // Forward
+    config->thrusters[1] = {0.3f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};     // Bow, pushes right
+    config->thrusters[2] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f};    // Vertical, pushes up
+}
+
+bool ThrustAllocator_sanitize(ThrustConfig* config) {
+    if (config->count > THRUST_MAX_THRUSTERS) config->count = THRUST_MAX_THRUSTERS;
+    if (config->count == 0) return false;
+
+    for (uint8_t i = 0; i < config->count; i++) {
+        ThrusterGeometry* t = &config->thrusters[i];
+        if (!isfinite(t->x) || !isfinite(t->y) || !isfinite(t->z)) return false;
+        if (!isfinite(t->dx) || !isfinite(t->dy) || !isfinite(t->dz)) return false;
+        float len = sqrtf(t->dx * t->dx + t->dy * t->dy + t->dz * t->dz);
+        if (len < MIN_DIRECTION) return false;
+        t->dx /= len;
+        t->dy /= len;
+        t->dz /= len;
+    }
+    return true;
+}
+
+void ThrustAllocator_effectiveness(const ThrusterGeometry* t, float* column) {
+    column[MIXER_ROLL] = t->y * t->dz - t->z * t->dy;
+    column[MIXER_PITCH] = t->z * t->dx - t->x * t->dz;
+    column[MIXER_YAW] = t->x * t->dy - t->y * t->dx;
+    column[MIXER_THRUST] = -t->dz;
+    column[MIXER_FORWARD] = t->dx;
+    column[MIXER_LATERAL] = t->dy;
+}
+
+// ============================================================================
+// Pseudo-inverse
+// ============================================================================
+
+// Cyclic Jacobi: a becomes diagonal (eigenvalues), v collects the eigenvectors
+static void jacobi(float a[AXES][AXES], float v[AXES][AXES]) {
+    memset(v, 0, sizeof(float) * AXES * AXES);
+    for (int i = 0; i < AXES; i++) v[i][i] = 1.0f;
+
+    for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++) {
+        float off = 0.0f, diag = 0.0f;
+        for (int p = 0; p < AXES; p++) {
+            diag += a[p][p] * a[p][p];
+            for (int q = p + 1; q < AXES; q++) off += a[p][q] * a[p][q];
+        }
+        if (off <= 1e-14f * diag) return;
+
+        for (int p = 0; p < AXES - 1; p++) {
+            for (int q = p + 1; q < AXES; q++) {
+                if (a[p][q] == 0.0f) continue;
+                float theta = (a[q][q] - a[p][p]) / (2.0f * a[p][q]);
+                float t = 1.0f / (fabsf(theta) + sqrtf(theta * theta + 1.0f));
+                if (theta < 0.0f) t = -t;
+                float c = 1.0f / sqrtf(t * t + 1.0f);
+                float s = t * c;
+
+                for (int k = 0; k < AXES; k++) {
+                    float kp = a[k][p], kq = a[k][q];
+                    a[k][p] = c * kp - s * kq;
+                    a[k][q] = s * kp + c * kq;
+                }
+                for (int k = 0; k < AXES; k++) {
+                    float pk = a[p][k], qk = a[q][k];
+                    a[p][k] = c * pk - s * qk;
+                    a[q][k] = s * pk + c * qk;
+                }
+                for (int k = 0; k < AXES; k++) {
+                    float kp = v[k][p], kq = v[k][q];
+                    v[k][p] = c * kp - s * kq;
+                    v[k][q] = s * kp + c * kq;
+                }
+            }
+        }
+    }
+}
+
+bool ThrustAllocator_init(ThrustAllocator* alloc, const ThrustConfig* config) {
+    memset(alloc, 0, sizeof(*alloc));
+    uint8_t n = config->count > THRUST_MAX_THRUSTERS ? THRUST_MAX_THRUSTERS : config->count;
+    alloc->count = n;
+
+    float b[THRUST_MAX_THRUSTERS][AXES];        // Columns of B, one per thruster
+    for (uint8_t i = 0; i < n; i++) ThrustAllocator_effectiveness(&config->thrusters[i], b[i]);
+
+    // M = B B^T
+    float m[AXES][AXES], v[AXES][AXES];
+    for (int r = 0; r < AXES; r++) {
+        for (int c = 0; c < AXES; c++) {
+            float sum = 0.0f;
+            for (uint8_t i = 0; i < n; i++) sum += b[i][r] * b[i][c];
+            m[r][c] = sum;
+        }
+    }
+    jacobi(m, v);
+
+    // M^+ = sum of v v^T / lambda over the eigenvalues that are not zero
+    float largest = 0.0f;
+    for (int k = 0; k < AXES; k++) largest = fmaxf(largest, m[k][k]);
+    if (largest <= 0.0f) return false;
+    float inv[AXES][AXES] = {};
+    for (int k = 0; k < AXES; k++) {
+        if (m[k][k] <= THRUST_RANK_EPS * largest) continue;
+        alloc->rank++;
+        float w = 1.0f / m[k][k];
+        for (int r = 0; r < AXES; r++)
+            for (int c = 0; c < AXES; c++) inv[r][c] += v[r][k] * v[c][k] * w;
+    }
+
+    // A = B^T M^+, then each axis column scaled to a largest term of 1
+    for (uint8_t i = 0; i < n; i++) {
+        for (int c = 0; c < AXES; c++) {
+            float sum = 0.0f;
+            for (int r = 0; r < AXES; r++) sum += b[i][r] * inv[r][c];
+            alloc->alloc[i][c] = sum;
+        }
+    }
+    for (int c = 0; c < AXES; c++) {
+        float peak = 0.0f;
+        for (uint8_t i = 0; i < n; i++) peak = fmaxf(peak, fabsf(alloc->alloc[i][c]));
+        if (peak < MIN_COEFF) {
+            // Axis out of reach of this layout
+            for (uint8_t i = 0; i < n; i++) alloc->alloc[i][c] = 0.0f;
+            continue;
+        }
+        for (uint8_t i = 0; i < n; i++) {
+            float k = alloc->alloc[i][c] / peak;
+            alloc->alloc[i][c] = fabsf(k) < MIN_COEFF ? 0.0f : k;
+        }
+        alloc->axisMask |= 1 << c;
+    }
+    return alloc->rank > 0;
+}
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+static inline bool givesWay(int axis) {
+    return axis == MIXER_FORWARD || axis == MIXER_LATERAL;
+}
+
+void ThrustAllocator_allocate(ThrustAllocator* alloc, const float* in, float* out) {
+    float g[THRUST_MAX_THRUSTERS];
+    float peak = 0.0f;
+    for (uint8_t i = 0; i < alloc->count; i++) {
+        const float* row = alloc->alloc[i];
+        float v = 0.0f, w = 0.0f;
+        for (int c = 0; c < AXES; c++) {
+            if (givesWay(c)) w += row[c] * in[c];
+            else v += row[c] * in[c];
+        }
+        out[i] = v;
+        g[i] = w;
+        peak = fmaxf(peak, fabsf(v));
+    }
+
+    // 1. Attitude + thrust part: keep the axis ratios
+    alloc->saturated = peak > 1.0f;
+    if (alloc->saturated) {
+        float scale = 1.0f / peak;
+        for (uint8_t i = 0; i < alloc->count; i++) out[i] *= scale;
+    }
+
+    // 2. Forward / lateral shrink into what is left
+    float k = 1.0f;
+    for (uint8_t i = 0; i < alloc->count; i++) {
+        float v = out[i];
+        if (v + g[i] > 1.0f && g[i] > 0.0f) k = fminf(k, (1.0f - v) / g[i]);
+        if (v + g[i] < -1.0f && g[i] < 0.0f) k = fminf(k, (-1.0f - v) / g[i]);
+    }
+    if (k < 0.0f) k = 0.0f;
+    alloc->saturated = alloc->saturated || k < 1.0f;
+    for (uint8_t i = 0; i < alloc->count; i++) out[i] += k * g[i];
+}
@@ -0,0 +1,89 @@
+#ifndef THRUST_ALLOCATOR_H
+#define THRUST_ALLOCATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MotorMixer.h"
+
+/**
+ * ThrustAllocator - Thruster geometry to allocation matrix
+ *
+ * Each thruster is described by where it sits and which way a positive
+ * command pushes (body frame: x ahead, y right, z down; meters and a
+ * direction of any length). The 6 x n effectiveness matrix B maps
+ * thruster commands to the wrench in MixerAxis order:
+ *
+ *   roll / pitch / yaw = (r x d).x / .y / .z
+ *   thrust (up) = -d.z, forward = d.x, lateral = d.y
+ *
+ * ThrustAllocator_init() computes the pseudo-inverse A = B^T (B B^T)^+
+ * once (Jacobi eigen-decomposition of the 6 x 6 B B^T; eigenvalues under
+ * THRUST_RANK_EPS of the largest count as zero, so a layout that cannot
+ * roll or strafe gets those axes dropped instead of a blown-up inverse).
+ * Each axis column of A is then scaled so its largest coefficient is 1,
+ * which makes a full-scale command on one axis drive the most loaded
+ * thruster to full output, as with the MotorMixer tables.
+ *
+ * Per tick ThrustAllocator_allocate() is a fixed n x 6 multiply-add
+ * with the MotorMixer non-collective desaturation: the attitude axes
+ * plus thrust are scaled to fit, then forward / lateral give way. Adding
+ * a thruster is a config change; the tick cost does not depend on the
+ * layout.
+ *
+ * @file ThrustAllocator.h
+ */
+
+#define THRUST_MAX_THRUSTERS    8
+#define THRUST_RANK_EPS         1e-4f       // Relative eigenvalue cut-off
+#define THRUST_CONFIG_KEY       "cfg_thrusters"
+
+/**
+ * One thruster (NVS format)
+ */
+typedef struct {
+    float x, y, z;              // Position from the centre of mass (m)
+    float dx, dy, dz;           // Push direction for a positive command
+} ThrusterGeometry;
+
+typedef struct {
+    uint8_t count;
+    ThrusterGeometry thrusters[THRUST_MAX_THRUSTERS];
+} ThrustConfig;
+
+typedef struct {
+    uint8_t count;
+    uint8_t rank;               // Independent axes the layout can produce
+    uint8_t axisMask;           // Bit per MixerAxis with any authority
+    float alloc[THRUST_MAX_THRUSTERS][MIXER_AXIS_COUNT];
+    bool saturated;             // Last allocate() had to scale or give way
+} ThrustAllocator;
+
+/**
+ * Default: the Sub3 hull (forward, bow yaw, vertical thruster), which
+ * allocates exactly like MixerFrameSub3
+ */
+void ThrustAllocator_defaultConfig(ThrustConfig* config);
+
+/**
+ * Clamp the count and normalize the directions
+ * @return false if a thruster has no direction (config unusable)
+ */
+bool ThrustAllocator_sanitize(ThrustConfig* config);
+
+/**
+ * Effectiveness of one thruster, MixerAxis order
+ */
+void ThrustAllocator_effectiveness(const ThrusterGeometry* t, float* column);
+
+/**
+ * Build the allocation matrix (boot time: ~20 Jacobi sweeps of a 6 x 6)
+ * @return false if the layout produces no wrench at all (rank 0)
+ */
+bool ThrustAllocator_init(ThrustAllocator* alloc, const ThrustConfig* config);
+
+/**
+ * Axis commands (-1..1, MixerAxis order) to thruster commands (-1..1)
+ */
+void ThrustAllocator_allocate(ThrustAllocator* alloc, const float* in, float* out);
+
+#endif // THRUST_ALLOCATOR_H
@@ -0,0 +1,90 @@
+#include "ThrustCurve.h"
+#include "FastMath.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * ThrustCurve - Implementation
+ *
+ * @file ThrustCurve.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Command giving `thrust` on (1 - e) c + e c^2 (the positive root)
+static float inverseExpo(float thrust, float e) {
+    if (e < 1e-4f) return thrust;
+    float b = 1.0f - e;
+    return (-b + sqrtf(b * b + 4.0f * e * thrust)) / (2.0f * e);
+}
+
+static void buildTable(ThrustCurve* tc) {
+    float e = tc->config.linearize ? tc->config.expo : 0.0f;
+    for (int i = 0; i < THRUST_CURVE_LUT_SIZE; i++)
+        tc->lut[i] = inverseExpo((float)i / (THRUST_CURVE_LUT_SIZE - 1), e);
+}
+
+static void updateScale(ThrustCurve* tc) {
+    const ThrustCurveConfig* c = &tc->config;
+    if (!c->voltageComp || tc->cellMv < THRUST_CURVE_MIN_CELL_MV) {
+        tc->scale = 1.0f;
+        return;
+    }
+    tc->scale = clampf(c->refCellMv / tc->cellMv, 1.0f / c->maxBoost, c->maxBoost);
+}
+
+// ============================================================================
+// Config
+// ============================================================================
+
+void ThrustCurve_defaultConfig(ThrustCurveConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->linearize = false;          // Until the prop's expo is measured
+    config->voltageComp = true;
+    config->expo = 0.65f;
+    config->refCellMv = 4200.0f;
+    config->maxBoost = 1.3f;
+    config->voltageTauS = 1.0f;
+}
+
+void ThrustCurve_sanitize(ThrustCurveConfig* config) {
+    memset(config->reserved, 0, sizeof(config->reserved));
+    config->expo = clampf(config->expo, 0.0f, 1.0f);
+    config->refCellMv = clampf(config->refCellMv, 3000.0f, 4500.0f);
+    config->maxBoost = clampf(config->maxBoost, 1.0f, 2.0f);
+    config->voltageTauS = clampf(config->voltageTauS, 0.1f, 10.0f);
+}
+
+void ThrustCurve_init(ThrustCurve* tc, const ThrustCurveConfig* config) {
+    memset(tc, 0, sizeof(*tc));
+    tc->config = *config;
+    tc->scale = 1.0f;
+    buildTable(tc);
+}
+
+void ThrustCurve_setConfig(ThrustCurve* tc, const ThrustCurveConfig* config) {
+    tc->config = *config;
+    buildTable(tc);
+    updateScale(tc);
+}
+
+// ============================================================================
+// Voltage
+// ============================================================================
+
+void ThrustCurve_updateVoltage(ThrustCurve* tc, float cellMv, uint32_t nowMs) {
+    if (cellMv < THRUST_CURVE_MIN_CELL_MV) {
+        tc->cellMv = 0.0f;              // Start over from the next real reading
+    } else if (tc->cellMv <= 0.0f) {
+        tc->cellMv = cellMv;
+    } else {
+        float dt = (nowMs - tc->lastMs) * 1e-3f;
+        tc->cellMv += dt / (tc->config.voltageTauS + dt) * (cellMv - tc->cellMv);
+    }
+    tc->lastMs = nowMs;
+    updateScale(tc);
+}
@@ -0,0 +1,101 @@
+#ifndef THRUST_CURVE_H
+#define THRUST_CURVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * ThrustCurve - Mixer thrust to motor command, linear and sag-free
+ *
+ * The mixer works in thrust, but a propeller's thrust grows closer to
+ * the square of the motor command, and with it the square of the
+ * supply voltage:
+ *
+ *   thrust = ((1 - expo) c + expo c^2) (V / Vref)^2 ... roughly
+ *
+ * so rate gains that fly well at hover are twice as stiff near full
+ * throttle, and a pack sagging from 4.2 to 3.5 V per cell takes away a
+ * third of the thrust for every command. This stage undoes both between
+ * the mixer and the motors:
+ *
+ * - Linearization: c = inverse of the expo curve, precomputed into a
+ *   THRUST_CURVE_LUT_SIZE table over 0..1 (linear interpolation between
+ *   entries, worst error ~0.1 % of full scale at expo 1)
+ * - Voltage: the cell voltage is low-passed at the battery rate and
+ *   gives scale = refCellMv / cellMv (clamped to 1/maxBoost..maxBoost),
+ *   the command multiplier that restores V c. Readings below
+ *   THRUST_CURVE_MIN_CELL_MV (no battery sense, bench supply) leave it 1.
+ *
+ * Per output: one table lookup and one multiply (apply()). Reversible
+ * outputs (-1..1) get the same curve mirrored.
+ *
+ * Plain struct, no hardware.
+ *
+ * @file ThrustCurve.h
+ */
+
+#define THRUST_CURVE_CONFIG_KEY     "cfg_thrust"
+#define THRUST_CURVE_LUT_SIZE       33          // 32 segments over 0..1
+#define THRUST_CURVE_MIN_CELL_MV    2500.0f
+
+typedef struct {
+    bool linearize;
+    bool voltageComp;
+    uint8_t reserved[2];
+    float expo;                 // 0 = thrust linear in command, 1 = square
+    float refCellMv;            // Cell voltage the tuning is right at
+    float maxBoost;             // Command scale limit
+    float voltageTauS;          // Cell voltage filter
+} ThrustCurveConfig;
+
+typedef struct {
+    ThrustCurveConfig config;
+    float lut[THRUST_CURVE_LUT_SIZE];   // Thrust 0..1 -> command 0..1
+    float cellMv;               // Filtered, 0 = no reading yet
+    float scale;                // Voltage command multiplier
+    uint32_t lastMs;
+} ThrustCurve;
+
+/**
+ * Default: voltage compensation to 4.2 V per cell, boost up to 1.3x,
+ * 1 s voltage filter; linearization off with expo 0.65 ready (a typical
+ * 5" prop) until the airframe's curve has been measured
+ */
+void ThrustCurve_defaultConfig(ThrustCurveConfig* config);
+
+void ThrustCurve_sanitize(ThrustCurveConfig* config);
+
+/**
+ * Build the table and start with no voltage reading (scale 1)
+ */
+void ThrustCurve_init(ThrustCurve* tc, const ThrustCurveConfig* config);
+
+/**
+ * Rebuild the table for a new configuration, keeping the filtered
+ * voltage
+ */
+void ThrustCurve_setConfig(ThrustCurve* tc, const ThrustCurveConfig* config);
+
+/**
+ * A battery reading: filter it and recompute the scale
+ * @param cellMv Measured (loaded) voltage per cell, mV
+ * @param nowMs Time of the reading
+ */
+void ThrustCurve_updateVoltage(ThrustCurve* tc, float cellMv, uint32_t nowMs);
+
+/**
+ * Motor command for a mixer output
+ * @param thrust -1..1 (0..1 for one-way ESCs)
+ * @return Command, same sign, magnitude capped at 1
+ */
+static inline float ThrustCurve_apply(const ThrustCurve* tc, float thrust) {
+    float a = thrust < 0.0f ? -thrust : thrust;
+    float x = (a < 1.0f ? a : 1.0f) * (THRUST_CURVE_LUT_SIZE - 1);
+    int i = (int)x;
+    if (i > THRUST_CURVE_LUT_SIZE - 2) i = THRUST_CURVE_LUT_SIZE - 2;
+    float c = (tc->lut[i] + (x - i) * (tc->lut[i + 1] - tc->lut[i])) * tc->scale;
+    if (c > 1.0f) c = 1.0f;
+    return thrust < 0.0f ? -c : c;
+}
+
+#endif // THRUST_CURVE_H
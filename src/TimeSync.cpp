@@ -0,0 +1,107 @@
+#include "TimeSync.h"
+#include <string.h>
+
+/**
+ * TimeSync - Implementation
+ *
+ * @file TimeSync.cpp
+ */
+
+#define US_PER_S 1000000LL
+
+// Offset the model gives at a local time
+static int64_t predicted_offset(const TimeSync* ts, HAL_Micros localUs) {
+    return ts->offsetUs + (int64_t)ts->driftPpb * (localUs - ts->anchorUs) / 1000000000LL;
+}
+
+// ============================================================================
+// Calendar
+// ============================================================================
+
+int64_t TimeSync_unixSeconds(uint16_t year, uint8_t month, uint8_t day, uint8_t hour,
+                             uint8_t minute, uint8_t second) {
+    // Days from 1970-01-01, with March as the first month of the year
+    int32_t y = (int32_t)year - (month <= 2 ? 1 : 0);
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    int32_t yoe = y - era * 400;
+    int32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = (int64_t)era * 146097 + doe - 719468;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+// ============================================================================
+// Discipline
+// ============================================================================
+
+void TimeSync_init(TimeSync* ts) {
+    memset(ts, 0, sizeof(*ts));
+}
+
+void TimeSync_onPulse(TimeSync* ts, HAL_Micros edgeUs) {
+    ts->ppsUs = edgeUs;
+    ts->pulses++;
+}
+
+static void lock(TimeSync* ts, int64_t measuredUs, HAL_Micros edgeUs) {
+    if (ts->state == TIME_SYNC_PPS) {
+        int64_t err = measuredUs - predicted_offset(ts, edgeUs);
+        int64_t interval = edgeUs - ts->anchorUs;
+        ts->lastErrorUs = err > INT32_MAX ? INT32_MAX : (err < INT32_MIN ? INT32_MIN : (int32_t)err);
+        if (err > TIME_SYNC_STEP_US || err < -TIME_SYNC_STEP_US) {
+            // Missed pulses, a receiver jump or a glitch: start over
+            ts->driftPpb = 0;
+            ts->steps++;
+        } else if (interval > 0) {
+            // Rate seen over this interval, on top of the drift already applied
+            int64_t ppb = ts->driftPpb + err * 1000000000LL / interval;
+            if (ppb <= TIME_SYNC_MAX_DRIFT_PPB && ppb >= -TIME_SYNC_MAX_DRIFT_PPB)
+                ts->driftPpb += (int32_t)((ppb - ts->driftPpb) / TIME_SYNC_DRIFT_GAIN);
+        }
+    } else {
+        ts->driftPpb = 0;
+        ts->lastErrorUs = 0;
+    }
+    ts->offsetUs = measuredUs;
+    ts->anchorUs = edgeUs;
+    ts->state = TIME_SYNC_PPS;
+    ts->locks++;
+}
+
+void TimeSync_onUtc(TimeSync* ts, int64_t utcUs, uint32_t tAccNs, HAL_Micros rxUs) {
+    if (utcUs <= 0) return;
+
+    int64_t frac = utcUs % US_PER_S;
+    bool topOfSecond = frac < TIME_SYNC_EPOCH_TOL_US || frac > US_PER_S - TIME_SYNC_EPOCH_TOL_US;
+    int64_t sinceEdge = rxUs - ts->ppsUs;
+    if (ts->ppsUs && topOfSecond && tAccNs <= TIME_SYNC_MAX_TACC_NS && sinceEdge > 0 &&
+        sinceEdge < TIME_SYNC_PPS_WINDOW_US) {
+        int64_t secondUs = utcUs - frac + (frac >= US_PER_S / 2 ? US_PER_S : 0);
+        lock(ts, secondUs - ts->ppsUs, ts->ppsUs);
+        ts->ppsUs = 0;
+        return;
+    }
+
+    // A lock in holdover still beats the message latency
+    if (TimeSync_state(ts, rxUs) == TIME_SYNC_PPS) return;
+    ts->state = TIME_SYNC_COARSE;
+    ts->offsetUs = utcUs - rxUs;
+    ts->anchorUs = rxUs;
+    ts->driftPpb = 0;
+}
+
+// ============================================================================
+// Readout
+// ============================================================================
+
+TimeSyncState TimeSync_state(const TimeSync* ts, HAL_Micros localUs) {
+    if (ts->state == TIME_SYNC_PPS && localUs - ts->anchorUs > TIME_SYNC_HOLDOVER_US)
+        return TIME_SYNC_COARSE;
+    return (TimeSyncState)ts->state;
+}
+
+bool TimeSync_toUtc(const TimeSync* ts, HAL_Micros localUs, int64_t* utcUs) {
+    if (ts->state == TIME_SYNC_NONE) return false;
+    *utcUs = localUs + predicted_offset(ts, localUs);
+    return true;
+}
@@ -0,0 +1,96 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "HAL.h"
+
+/**
+ * TimeSync - UTC from GPS time messages, disciplined by the PPS pulse
+ *
+ * The GPS timepulse (CFG-TP5 default: 1 Hz, rising edge on the top of
+ * the UTC second) is stamped with HAL_Now() in its interrupt. The NAV-PVT
+ * of that same second arrives tens of ms later with the UTC it belongs
+ * to; the pair gives the offset UTC - HAL_Now() to within the interrupt
+ * latency (a few us). Successive pulses measure the crystal's rate error,
+ * which carries the offset between pulses and through short PPS gaps:
+ *
+ *   utc(local) = local + offset + drift * (local - anchor)
+ *
+ * States:
+ *   NONE   no UTC yet
+ *   COARSE time messages only: offset = utc - reception time, off by the
+ *          UART and polling latency (~10-100 ms)
+ *   PPS    locked to the pulse (sub-ms); falls back to COARSE when no
+ *          pulse has matched for TIME_SYNC_HOLDOVER_US
+ *
+ * Pure: no globals, no RTOS. One task owns a TimeSync; readers on other
+ * tasks take a copy under the owner's lock.
+ *
+ * @file TimeSync.h
+ */
+
+#define TIME_SYNC_PPS_WINDOW_US     900000      // PVT of a second follows its pulse within
+#define TIME_SYNC_EPOCH_TOL_US      1000        // Solution counts as top of second within
+#define TIME_SYNC_MAX_TACC_NS       1000000     // Receiver time accuracy needed for a lock
+#define TIME_SYNC_STEP_US           1000        // Larger jumps restart the drift estimate
+#define TIME_SYNC_HOLDOVER_US       60000000LL  // PPS lock kept without pulses
+#define TIME_SYNC_DRIFT_GAIN        8           // Drift EMA: 1/N of each new measurement
+#define TIME_SYNC_MAX_DRIFT_PPB     200000      // 200 ppm, anything more is a bad pulse
+
+typedef enum {
+    TIME_SYNC_NONE = 0,
+    TIME_SYNC_COARSE = 1,
+    TIME_SYNC_PPS = 2
+} TimeSyncState;
+
+typedef struct {
+    uint8_t state;              // TimeSyncState of the last measurement
+    int64_t offsetUs;           // UTC - local at anchorUs
+    HAL_Micros anchorUs;        // Local time of the last measurement
+    int32_t driftPpb;           // Local clock rate error (PPS only)
+    HAL_Micros ppsUs;           // Newest unmatched pulse, 0 = none
+    int32_t lastErrorUs;        // Measured minus predicted offset at the last pulse
+
+    // Statistics
+    uint32_t pulses;            // Edges seen
+    uint32_t locks;             // Pulses matched to a UTC second
+    uint32_t steps;             // Locks that moved the clock by > TIME_SYNC_STEP_US
+} TimeSync;
+
+/**
+ * Unix seconds of a UTC calendar date and time (proleptic Gregorian)
+ */
+int64_t TimeSync_unixSeconds(uint16_t year, uint8_t month, uint8_t day, uint8_t hour,
+                             uint8_t minute, uint8_t second);
+
+/**
+ * Forget everything (state NONE)
+ */
+void TimeSync_init(TimeSync* ts);
+
+/**
+ * A PPS edge, stamped in its interrupt
+ */
+void TimeSync_onPulse(TimeSync* ts, HAL_Micros edgeUs);
+
+/**
+ * A GPS solution with resolved UTC
+ * @param utcUs  UTC of the solution, us since 1970
+ * @param tAccNs Receiver time accuracy estimate
+ * @param rxUs   Local time the message was read
+ */
+void TimeSync_onUtc(TimeSync* ts, int64_t utcUs, uint32_t tAccNs, HAL_Micros rxUs);
+
+/**
+ * Quality of the clock at a local time (PPS degrades to COARSE in holdover)
+ */
+TimeSyncState TimeSync_state(const TimeSync* ts, HAL_Micros localUs);
+
+/**
+ * UTC of a local time
+ * @return false while the state is NONE (utcUs untouched)
+ */
+bool TimeSync_toUtc(const TimeSync* ts, HAL_Micros localUs, int64_t* utcUs);
+
+#endif // TIME_SYNC_H
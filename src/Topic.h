@@ -0,0 +1,135 @@
+#ifndef TOPIC_H
+#define TOPIC_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Topic - Lock-Free Single-Writer / Multi-Reader Latest-Value Slot
+ *
+ * Features:
+ * - Wait-free publish, never blocks the owning task
+ * - Any number of readers in any task, each gets a consistent copy:
+ *   two slots written alternately under a seqlock, so a reader copies the
+ *   slot the writer is not touching and only retries if it was lapped twice
+ * - Change notification by generation count: a reader keeps a TopicSub
+ *   cursor and checks updated() (one atomic load) before copying anything
+ *
+ * Exactly one task may publish() to a topic. T must be trivially copyable.
+ * Readers copy the message once into their own storage; nothing is
+ * returned by value through a manager singleton.
+ *
+ * @file Topic.h
+ */
+
+// Copy attempts before a reader gives up on a flooding writer
+#define TOPIC_READ_ATTEMPTS 4
+
+/**
+ * Per-reader cursor (generation last copied)
+ */
+struct TopicSub {
+  uint32_t generation = 0;
+};
+
+template <typename T> class Topic {
+public:
+  Topic() : _generation(0) {
+    for (int i = 0; i < 2; i++)
+      _slots[i].seq.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Publish a message (owning task only). Never blocks.
+   * @param msg Message to copy into the topic
+   */
+  void publish(const T &msg) {
+    uint32_t gen = _generation.load(std::memory_order_relaxed) + 1;
+    Slot &slot = _slots[gen & 1];
+
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed); // odd = writing
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.data, &msg, sizeof(T));
+    slot.seq.store(seq + 2, std::memory_order_release); // even = complete
+
+    _generation.store(gen, std::memory_order_release);
+  }
+
+  /**
+   * Copy out the newest message (any task)
+   * @param out Destination
+   * @return false if nothing was published yet (or the writer kept
+   *         lapping the reader); out is then untouched
+   */
+  bool read(T &out) const {
+    uint32_t unused;
+    return copy(out, unused);
+  }
+
+  /**
+   * Copy out the newest message if it changed since the cursor
+   * @param sub Reader cursor, advanced on success
+   * @param out Destination
+   * @return true if a newer message was copied
+   */
+  bool readIfUpdated(TopicSub &sub, T &out) const {
+    if (!updated(sub))
+      return false;
+    uint32_t gen;
+    if (!copy(out, gen))
+      return false;
+    sub.generation = gen;
+    return true;
+  }
+
+  /**
+   * Newer message than the cursor has seen (one atomic load, no copy)
+   */
+  bool updated(const TopicSub &sub) const {
+    return _generation.load(std::memory_order_acquire) != sub.generation;
+  }
+
+  /**
+   * Messages published since construction
+   */
+  uint32_t getGeneration() const {
+    return _generation.load(std::memory_order_acquire);
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    T data;
+  };
+
+  bool copy(T &out, uint32_t &genOut) const {
+    for (int attempt = 0; attempt < TOPIC_READ_ATTEMPTS; attempt++) {
+      uint32_t gen = _generation.load(std::memory_order_acquire);
+      if (gen == 0)
+        return false;
+
+      const Slot &slot = _slots[gen & 1];
+      uint32_t seqBefore = slot.seq.load(std::memory_order_acquire);
+      if (seqBefore & 1)
+        continue;
+
+      memcpy(&out, &slot.data, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint32_t seqAfter = slot.seq.load(std::memory_order_relaxed);
+      if (seqBefore != seqAfter)
+        continue;
+
+      genOut = gen;
+      return true;
+    }
+    return false;
+  }
+
+  Slot _slots[2];
+  std::atomic<uint32_t> _generation; // Written by the owning task only
+};
+
+#endif // TOPIC_H
@@ -0,0 +1,22 @@
+#include "Topics.h"
+
+/**
+ * Topics - Storage
+ *
+ * @file Topics.cpp
+ */
+
+Topic<SticksMsg> topicSticks;
+Topic<AttitudeMsg> topicAttitude;
+Topic<GPSFix> topicGps;
+Topic<NavigationState> topicNavState;
+Topic<BatteryMsg> topicBattery;
+Topic<ActuatorOutputsMsg> topicActuators;
+Topic<EscMsg> topicEsc;
+Topic<PowerMsg> topicPower;
+Topic<DepthMsg> topicDepth;
+Topic<AirspeedMsg> topicAirspeed;
+Topic<MagMsg> topicMag;
+Topic<BaroMsg> topicBaro;
+Topic<RangeMsg> topicRange;
+Topic<GyroNotchMsg> topicGyroNotch;
@@ -0,0 +1,153 @@
+#ifndef TOPICS_H
+#define TOPICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "BiquadFilter.h"
+#include "EscTelemetry.h"
+#include "Topic.h"
+#include "UBXParser.h"
+#include "NavigationManager.h"
+#include "PowerMonitor.h"
+
+/**
+ * Topics - Statically declared message bus between tasks
+ *
+ * Each topic has one writer task; any task reads it without a lock
+ * (see Topic.h). Managers stay the owners of their state, the writer
+ * publishes a copy once per update and other tasks read that instead of
+ * calling into the singleton across cores.
+ *
+ *   topic             writer    published
+ *   topicSticks       control   stick inputs after failsafe / auto
+ *   topicAttitude     control   every tick with a running IMU
+ *   topicGps          control   each new fix
+ *   topicNavState     control   after the navigation update
+ *   topicBattery      control   each new ADC block
+ *   topicActuators    control   after vehicle->loop()
+ *   topicEsc          control   after vehicle->loop(), with ESC feedback
+ *   topicPower        control   each battery block, with a current source
+ *   topicDepth        sensor    each depth sample
+ *   topicAirspeed     sensor    each pitot sample (Plane with a pitot)
+ *   topicMag          sensor    each magnetometer sample
+ *   topicBaro         sensor    each barometer sample (Copter / Plane)
+ *   topicRange        sensor    each forward range reading (Rover)
+ *   topicGyroNotch    noise     each dynamic notch move (Copter)
+ *
+ * @file Topics.h
+ */
+
+#define TOPIC_ACTUATOR_CHANNELS 8
+
+struct SticksMsg {
+  int16_t throttle;
+  int16_t roll;
+  int16_t pitch;
+  int16_t yaw;
+  uint8_t mode;
+  uint32_t sequence;
+  uint32_t timeMs;
+};
+
+struct AttitudeMsg {
+  float roll;     // rad
+  float pitch;    // rad
+  float yaw;      // rad, counter-clockwise (gyro-only, drifts)
+  float rates[3]; // Body rates x, y, z in rad/s
+  float heading;  // Navigation heading, degrees 0-360
+  uint32_t timeMs;
+};
+
+struct BatteryMsg {
+  uint16_t millivolts;
+  uint8_t percent;          // Sag compensated
+  int32_t remainingS;       // -1 = unknown
+  bool rtlRequired;
+  uint32_t timeMs;
+};
+
+struct PowerMsg {
+  PowerMonitor power;       // Totals, legs and return budget
+  uint8_t source;           // POWER_SOURCE_*
+  uint32_t timeMs;
+};
+
+struct DepthMsg {
+  float depth;              // m, positive down
+  float targetDepth;
+  bool diving;
+  uint32_t sampleCount;
+};
+
+struct AirspeedMsg {
+  float airspeed;           // m/s, indicated
+  float differentialPa;     // Zeroed pitot pressure
+  float temperature;        // deg C, sensor die
+  uint32_t sampleCount;
+  uint32_t timeMs;
+};
+
+struct MagMsg {
+  float field[3];           // uT, body axes, hard / soft iron removed
+  float raw[3];             // uT, as read
+  float radiusUt;           // Fitted field strength
+  float residual;           // Fit RMS, share of the radius
+  uint8_t coverage;         // Sectors seen by the last fit
+  bool valid;               // field is calibrated
+  bool planar;              // Horizontal-only fit: not tilt compensated
+  bool disturbed;           // Strength off the fit: not a heading source
+  uint32_t fits;
+  uint32_t accepted;        // Samples taken into the fit
+  uint32_t sampleCount;
+  uint32_t timeMs;
+};
+
+struct BaroMsg {
+  float pressurePa;
+  float temperature;        // deg C, sensor die
+  uint32_t sampleCount;
+  uint32_t timeMs;
+};
+
+struct RangeMsg {
+  float range;              // m, median of the last readings
+  uint32_t echoUs;          // Last echo pulse, 0 = nothing in range
+  uint32_t sampleCount;
+  uint32_t missed;          // Triggers the sensor never answered
+  uint32_t timeMs;
+};
+
+struct GyroNotchMsg {
+  float centerHz;
+  BiquadCoefs coefs;        // For the last gyro filter stage
+  float peakSnr;
+  uint32_t timeMs;
+};
+
+struct EscMsg {
+  EscTelemetry esc;         // Per-motor eRPM / temperature / current / health
+  uint8_t health;           // All motors ORed
+  uint32_t timeMs;
+};
+
+struct ActuatorOutputsMsg {
+  uint8_t outputs[TOPIC_ACTUATOR_CHANNELS]; // 0-100 per motor / servo
+  uint32_t timeMs;
+};
+
+extern Topic<SticksMsg> topicSticks;
+extern Topic<AttitudeMsg> topicAttitude;
+extern Topic<GPSFix> topicGps;
+extern Topic<NavigationState> topicNavState;
+extern Topic<BatteryMsg> topicBattery;
+extern Topic<ActuatorOutputsMsg> topicActuators;
+extern Topic<EscMsg> topicEsc;
+extern Topic<PowerMsg> topicPower;
+extern Topic<DepthMsg> topicDepth;
+extern Topic<AirspeedMsg> topicAirspeed;
+extern Topic<MagMsg> topicMag;
+extern Topic<BaroMsg> topicBaro;
+extern Topic<RangeMsg> topicRange;
+extern Topic<GyroNotchMsg> topicGyroNotch;
+
+#endif // TOPICS_H
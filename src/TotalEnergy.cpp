@@ -0,0 +1,142 @@
+#include "TotalEnergy.h"
+#include "FastMath.h"
+#include <string.h>
+
+/**
+ * TotalEnergy - Implementation
+ *
+ * @file TotalEnergy.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+#define GRAVITY_MPS2        9.80665f
+#define SPEED_RATE_TAU_S    0.5f    // V' filter: pitot / GPS speed is noisy
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// PI integrator step that stops while the output is pinned the same way
+static float integrate(float i, float ki, float err, float dt, float out, float lo,
+                       float hi, float limit) {
+    if ((out >= hi && err > 0.0f) || (out <= lo && err < 0.0f)) return i;
+    return clampf(i + ki * err * dt, -limit, limit);
+}
+
+// ============================================================================
+// Config
+// ============================================================================
+
+void TotalEnergy_defaultConfig(TecsConfig* config) {
+    config->enabled = true;
+    config->timeConst = 5.0f;
+    config->maxClimbMps = 5.0f;
+    config->maxSinkMps = 4.0f;
+    config->maxAccelMps2 = 2.0f;
+    config->minSpeedMps = 9.0f;
+    config->maxSpeedMps = 25.0f;
+    config->speedWeight = 1.0f;
+    config->trimThrottle = 0.5f;
+    config->throttleKp = 1.0f;
+    config->throttleKi = 0.2f;
+    config->throttleKff = 1.0f;
+    config->throttleILimit = 0.3f;
+    config->pitchKp = 1.0f;
+    config->pitchKi = 0.2f;
+    config->pitchILimitDeg = 5.0f;
+    config->maxPitchDeg = 15.0f;
+    config->minPitchDeg = -15.0f;
+}
+
+void TotalEnergy_sanitize(TecsConfig* config) {
+    config->timeConst = clampf(config->timeConst, 1.0f, 30.0f);
+    config->maxClimbMps = clampf(config->maxClimbMps, 0.5f, 20.0f);
+    config->maxSinkMps = clampf(config->maxSinkMps, 0.5f, 20.0f);
+    config->maxAccelMps2 = clampf(config->maxAccelMps2, 0.1f, 10.0f);
+    config->minSpeedMps = clampf(config->minSpeedMps, TECS_MIN_SPEED_MPS, 50.0f);
+    config->maxSpeedMps = clampf(config->maxSpeedMps, config->minSpeedMps, 60.0f);
+    config->speedWeight = clampf(config->speedWeight, 0.0f, 2.0f);
+    config->trimThrottle = clampf(config->trimThrottle, 0.0f, 1.0f);
+    config->throttleKp = clampf(config->throttleKp, 0.0f, 10.0f);
+    config->throttleKi = clampf(config->throttleKi, 0.0f, 10.0f);
+    config->throttleKff = clampf(config->throttleKff, 0.0f, 10.0f);
+    config->throttleILimit = clampf(config->throttleILimit, 0.0f, 1.0f);
+    config->pitchKp = clampf(config->pitchKp, 0.0f, 10.0f);
+    config->pitchKi = clampf(config->pitchKi, 0.0f, 10.0f);
+    config->pitchILimitDeg = clampf(config->pitchILimitDeg, 0.0f, 20.0f);
+    config->maxPitchDeg = clampf(config->maxPitchDeg, 1.0f, 45.0f);
+    config->minPitchDeg = clampf(config->minPitchDeg, -45.0f, -1.0f);
+}
+
+void TotalEnergy_init(TotalEnergy* tecs, const TecsConfig* config) {
+    memset(tecs, 0, sizeof(*tecs));
+    tecs->config = *config;
+    tecs->throttle = config->trimThrottle;
+}
+
+void TotalEnergy_setConfig(TotalEnergy* tecs, const TecsConfig* config) {
+    tecs->config = *config;
+    float pitchLimit = config->pitchILimitDeg * FAST_MATH_DEG_TO_RAD;
+    tecs->throttleI = clampf(tecs->throttleI, -config->throttleILimit, config->throttleILimit);
+    tecs->pitchI = clampf(tecs->pitchI, -pitchLimit, pitchLimit);
+}
+
+void TotalEnergy_reset(TotalEnergy* tecs) {
+    TotalEnergy_init(tecs, &tecs->config);
+}
+
+// ============================================================================
+// Update
+// ============================================================================
+
+void TotalEnergy_update(TotalEnergy* tecs, float heightSp, float speedSp, float height,
+                        float climbRate, float speed, float dt) {
+    const TecsConfig* c = &tecs->config;
+    if (dt <= 0.0f) return;
+
+    // Measured V', filtered
+    if (tecs->primed) {
+        float alpha = dt / (SPEED_RATE_TAU_S + dt);
+        tecs->speedRate += alpha * ((speed - tecs->speed) / dt - tecs->speedRate);
+    }
+    tecs->speed = speed;
+    tecs->primed = true;
+
+    // Setpoints: errors become rates over timeConst, within the airframe's limits
+    tecs->speedSp = clampf(speedSp, c->minSpeedMps, c->maxSpeedMps);
+    tecs->heightRateSp = clampf((heightSp - height) / c->timeConst, -c->maxSinkMps,
+                                c->maxClimbMps);
+    tecs->speedRateSp = clampf((tecs->speedSp - speed) / c->timeConst, -c->maxAccelMps2,
+                               c->maxAccelMps2);
+    tecs->underspeed = speed < c->minSpeedMps;
+
+    // Rates normalized by g V: both terms read as angles
+    float v = speed > TECS_MIN_SPEED_MPS ? speed : TECS_MIN_SPEED_MPS;
+    float gammaSp = tecs->heightRateSp / v, gamma = climbRate / v;
+    float accelSp = tecs->speedRateSp / GRAVITY_MPS2, accel = tecs->speedRate / GRAVITY_MPS2;
+
+    // Throttle: total energy rate
+    float steSp = gammaSp + accelSp;
+    float steErr = steSp - (gamma + accel);
+    if (tecs->underspeed) {
+        tecs->throttle = 1.0f;
+    } else {
+        float thr = c->trimThrottle + c->throttleKff * steSp + c->throttleKp * steErr +
+                    tecs->throttleI;
+        tecs->throttleI = integrate(tecs->throttleI, c->throttleKi, steErr, dt, thr, 0.0f,
+                                    1.0f, c->throttleILimit);
+        tecs->throttle = clampf(thr, 0.0f, 1.0f);
+    }
+
+    // Pitch: energy balance
+    float w = tecs->underspeed ? 2.0f : c->speedWeight;
+    float sebSp = (2.0f - w) * gammaSp - w * accelSp;
+    float sebErr = sebSp - ((2.0f - w) * gamma - w * accel);
+    float ffScale = 1.0f / (w > 1.0f ? w : 2.0f - w);   // w = 1: FF is the climb angle
+    float lo = c->minPitchDeg * FAST_MATH_DEG_TO_RAD, hi = c->maxPitchDeg * FAST_MATH_DEG_TO_RAD;
+    float pitch = sebSp * ffScale + c->pitchKp * sebErr + tecs->pitchI;
+    tecs->pitchI = integrate(tecs->pitchI, c->pitchKi, sebErr, dt, pitch, lo, hi,
+                             c->pitchILimitDeg * FAST_MATH_DEG_TO_RAD);
+    tecs->pitch = clampf(pitch, lo, hi);
+}
@@ -0,0 +1,114 @@
+#ifndef TOTAL_ENERGY_H
+#define TOTAL_ENERGY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * TotalEnergy - Total energy (TECS) speed / height control for Plane
+ *
+ * Throttle and pitch are not given one job each: throttle changes the
+ * aircraft's total energy, pitch only trades height against speed. With
+ * both rates normalized by g V (so they read as angles):
+ *
+ *   total    STE' = gamma + V'/g        gamma = h'/V, flight path angle
+ *   balance  SEB' = (2-w) gamma - w V'/g
+ *
+ *   height error / timeConst -> h' setpoint (+maxClimb / -maxSink)
+ *   speed error / timeConst  -> V' setpoint (+-maxAccel)
+ *   STE' error -> throttle PI + feed-forward around trimThrottle
+ *   SEB' error -> pitch PI + feed-forward
+ *
+ * - A climb asks for more throttle, not just more pitch: the aircraft
+ *   stops bleeding speed into the climb and stalling its way up, and a
+ *   descent gives the energy back through the throttle instead of
+ *   diving faster than it needs to
+ * - speedWeight w: 1 = balanced, 0 = pitch flies height only (no
+ *   airspeed reading worth trusting), 2 = pitch flies speed only
+ * - Underspeed (below minSpeed): full throttle and w = 2, the nose
+ *   comes down until the speed is back whatever the height error
+ * - Integrators are bounded and stop winding while their output is
+ *   saturated in the same direction
+ * - Meant to run at the fixed control rate; V' is a filtered
+ *   difference of the airspeed samples
+ *
+ * Plain struct, no hardware. Pitch is nose up, rad; throttle 0..1.
+ *
+ * @file TotalEnergy.h
+ */
+
+#define TECS_CONFIG_KEY     "cfg_tecs"
+#define TECS_MIN_SPEED_MPS  3.0f    // Floor for gamma = h'/V
+
+typedef struct {
+    bool enabled;
+    float timeConst;            // s, height / speed error to rate setpoint
+    float maxClimbMps;
+    float maxSinkMps;
+    float maxAccelMps2;
+    float minSpeedMps;          // Speed setpoint floor and underspeed trigger
+    float maxSpeedMps;
+    float speedWeight;          // 0..2, see above
+    float trimThrottle;         // Level cruise throttle, 0..1
+    float throttleKp;           // Throttle per unit STE' error
+    float throttleKi;
+    float throttleKff;          // Throttle per unit STE' setpoint
+    float throttleILimit;       // Throttle units
+    float pitchKp;              // rad per unit SEB' error
+    float pitchKi;
+    float pitchILimitDeg;
+    float maxPitchDeg;          // Nose up limit
+    float minPitchDeg;          // Nose down limit (negative)
+} TecsConfig;
+
+typedef struct {
+    TecsConfig config;
+    bool primed;                // Have a previous speed sample
+    float speed;                // Last speed, m/s
+    float speedRate;            // Filtered V', m/s^2
+    float throttleI;
+    float pitchI;               // rad
+    float heightRateSp;         // Last setpoints, m/s and m/s^2
+    float speedSp;
+    float speedRateSp;
+    bool underspeed;
+    float throttle;             // Outputs
+    float pitch;
+} TotalEnergy;
+
+/**
+ * Default: on, 5 s time constant, +5 / -4 m/s, 2 m/s^2, 9..25 m/s,
+ * weight 1, trim 0.5, throttle PI 1.0 / 0.2 with FF 1.0 (limit 0.3),
+ * pitch PI 1.0 / 0.2 (limit 5 deg), pitch -15..+15 deg
+ */
+void TotalEnergy_defaultConfig(TecsConfig* config);
+
+void TotalEnergy_sanitize(TecsConfig* config);
+
+void TotalEnergy_init(TotalEnergy* tecs, const TecsConfig* config);
+
+/**
+ * Replace the configuration, keeping the integrators (clamped to the
+ * new limits)
+ */
+void TotalEnergy_setConfig(TotalEnergy* tecs, const TecsConfig* config);
+
+/**
+ * Start over: integrators and the speed derivative (e.g. leaving AUTO)
+ */
+void TotalEnergy_reset(TotalEnergy* tecs);
+
+/**
+ * One control step
+ * @param heightSp Target height, m
+ * @param speedSp Target airspeed, m/s (clamped to min..max)
+ * @param height Height, m (same datum)
+ * @param climbRate h', m/s
+ * @param speed Airspeed (or the best stand-in), m/s
+ * @param dt Step, s
+ * Results in tecs->throttle (0..1) and tecs->pitch (rad, nose up)
+ */
+void TotalEnergy_update(TotalEnergy* tecs, float heightSp, float speedSp, float height,
+                        float climbRate, float speed, float dt);
+
+#endif // TOTAL_ENERGY_H
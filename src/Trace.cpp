@@ -0,0 +1,132 @@
+#include "Trace.h"
+#include "MemPlacement.h"
+#include <string.h>
+
+/**
+ * Trace - Implementation
+ *
+ * Writers only touch their own core's ring. The slot is claimed with an
+ * atomic fetch-add before the record is filled, so an ISR preempting a
+ * task mid-write takes the next slot instead of corrupting this one.
+ * Readers on the other core may see a record being overwritten; the dump
+ * pauses tracing first.
+ *
+ * @file Trace.cpp
+ */
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <xtensa/hal.h>
+#define TRACE_CYCLES() xthal_get_ccount()
+#define TRACE_CORE() ((uint8_t)xPortGetCoreID())
+#define TRACE_NOW_US() esp_timer_get_time()
+#define TRACE_IRAM IRAM_ATTR
+#else
+#include <time.h>
+static inline uint64_t trace_host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#define TRACE_CYCLES() ((uint32_t)trace_host_ns())
+#define TRACE_CORE() ((uint8_t)0)
+#define TRACE_NOW_US() ((int64_t)(trace_host_ns() / 1000ULL))
+#define TRACE_IRAM
+#endif
+
+#define TRACE_MASK (TRACE_RING_SIZE - 1)
+
+#if (TRACE_RING_SIZE & TRACE_MASK) != 0
+#error "TRACE_RING_SIZE must be a power of two"
+#endif
+
+// ============================================================================
+// State
+// ============================================================================
+
+typedef struct {
+    volatile uint32_t head;     // Next slot (free-running, masked on use)
+    uint32_t syncCycles;
+    int64_t syncUs;
+    TraceRecord records[TRACE_RING_SIZE];
+} TraceRing;
+
+static TraceRing gRings[TRACE_CORES];
+static volatile bool gEnabled = false;
+static uint32_t gCyclesPerUs = 1;
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void Trace_init(uint32_t cyclesPerUs) {
+    gEnabled = false;
+    memset(gRings, 0, sizeof(gRings));
+    gCyclesPerUs = cyclesPerUs ? cyclesPerUs : 1;
+    MemPlacement_note("trace", gRings, sizeof(gRings), MEM_CLASS_INTERNAL);
+    gEnabled = true;
+}
+
+void Trace_setEnabled(bool enabled) {
+    gEnabled = enabled;
+}
+
+bool Trace_isEnabled(void) {
+    return gEnabled;
+}
+
+void TRACE_IRAM Trace_record(uint8_t event, uint8_t phase, uint16_t arg) {
+    if (!gEnabled) return;
+
+    uint8_t core = TRACE_CORE();
+    if (core >= TRACE_CORES) return;
+
+    TraceRing* ring = &gRings[core];
+    uint32_t slot = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED) & TRACE_MASK;
+    TraceRecord* rec = &ring->records[slot];
+    rec->cycles = TRACE_CYCLES();
+    rec->event = event;
+    rec->phase = phase;
+    rec->arg = arg;
+}
+
+void Trace_sync(void) {
+    uint8_t core = TRACE_CORE();
+    if (core >= TRACE_CORES) return;
+
+    TraceRing* ring = &gRings[core];
+    ring->syncCycles = TRACE_CYCLES();
+    ring->syncUs = TRACE_NOW_US();
+}
+
+uint32_t Trace_getCyclesPerUs(void) {
+    return gCyclesPerUs;
+}
+
+bool Trace_getCoreInfo(uint8_t core, TraceCoreInfo* info) {
+    if (core >= TRACE_CORES || info == NULL) return false;
+
+    const TraceRing* ring = &gRings[core];
+    info->written = ring->head;
+    info->available = info->written < TRACE_RING_SIZE ? info->written : TRACE_RING_SIZE;
+    info->syncCycles = ring->syncCycles;
+    info->syncUs = ring->syncUs;
+    return true;
+}
+
+uint32_t Trace_read(uint8_t core, uint32_t offset, TraceRecord* out, uint32_t maxRecords) {
+    TraceCoreInfo info;
+    if (!Trace_getCoreInfo(core, &info) || out == NULL) return 0;
+    if (offset >= info.available) return 0;
+
+    uint32_t count = info.available - offset;
+    if (count > maxRecords) count = maxRecords;
+
+    const TraceRing* ring = &gRings[core];
+    uint32_t first = info.written - info.available + offset;
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = ring->records[(first + i) & TRACE_MASK];
+    }
+    return count;
+}
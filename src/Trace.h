@@ -0,0 +1,166 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Trace - Lightweight binary event trace (per-core ring buffers)
+ *
+ * Each core owns a fixed ring of 8-byte (cycles, event, phase, arg)
+ * records. A write reserves its slot with one atomic increment and reads
+ * CCOUNT, so tasks and ISRs on the same core can trace concurrently
+ * without locks; old records are overwritten. Cost is a few dozen cycles,
+ * cheap enough to stay in field builds (TRACE_ENABLED=0 compiles it out).
+ *
+ * Cores count cycles independently. Trace_sync() stores a (cycles,
+ * esp_timer) pair for the calling core; the host converts a record as
+ *   us = syncUs + (int32_t)(cycles - syncCycles) / cyclesPerUs
+ * which holds while records are within ~8 s of the sync point.
+ *
+ * The serial command {"c":"trace_dump"} pauses tracing and prints the
+ * rings as base64 chunks; tools/trace2chrome.py turns that into Chrome
+ * trace / Perfetto JSON.
+ *
+ * @file Trace.h
+ */
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 256     // Records per core (power of two)
+#endif
+
+#define TRACE_CORES 2
+#define TRACE_DUMP_CHUNK 48     // Records per serial dump line (512 base64 chars)
+
+// Chrome trace event phases
+#define TRACE_PHASE_BEGIN   'B'
+#define TRACE_PHASE_END     'E'
+#define TRACE_PHASE_INSTANT 'i'
+
+/**
+ * Traced events (ids are part of the dump format, append only)
+ */
+typedef enum {
+    TRACE_EV_RADIO_RX = 1,      // ESP-NOW receive callback (arg = frame length)
+    TRACE_EV_RX_VERIFY = 2,     // Radio frame decrypt + MAC (control task)
+    TRACE_EV_CONTROL = 3,       // Control tick
+    TRACE_EV_NAV = 4,           // Navigation update
+    TRACE_EV_DEPTH = 5,         // Depth sensor poll
+    TRACE_EV_TELEMETRY = 6,     // Telemetry build + send
+    TRACE_EV_KX = 7,            // Key exchange request (worker)
+    TRACE_EV_IMU_IRQ = 8,       // IMU data-ready interrupt
+    TRACE_EV_COUNT
+} TraceEvent;
+
+/**
+ * One trace record
+ */
+typedef struct {
+    uint32_t cycles;            // CCOUNT of the writing core
+    uint8_t event;              // TraceEvent
+    uint8_t phase;              // TRACE_PHASE_*
+    uint16_t arg;               // Event specific
+} TraceRecord;
+
+/**
+ * Ring state of one core
+ */
+typedef struct {
+    uint32_t written;           // Records ever written (wraps)
+    uint32_t available;         // Records still in the ring
+    uint32_t syncCycles;        // Cycle count at syncUs
+    int64_t syncUs;             // esp_timer_get_time() at syncCycles
+} TraceCoreInfo;
+
+/**
+ * Clear all rings and enable tracing
+ * @param cyclesPerUs CPU clock in MHz (reported with the dump)
+ */
+void Trace_init(uint32_t cyclesPerUs);
+
+/**
+ * Pause / resume recording (the dump pauses while it reads)
+ * @param enabled true to record
+ */
+void Trace_setEnabled(bool enabled);
+
+/**
+ * Check if tracing is recording
+ */
+bool Trace_isEnabled(void);
+
+/**
+ * Record an event on the calling core (task or ISR)
+ * @param event TraceEvent
+ * @param phase TRACE_PHASE_BEGIN, _END or _INSTANT
+ * @param arg Event specific argument
+ */
+void Trace_record(uint8_t event, uint8_t phase, uint16_t arg);
+
+/**
+ * Store the calling core's cycle / microsecond pair (call periodically
+ * from a task on each core)
+ */
+void Trace_sync(void);
+
+/**
+ * Get clock rate passed to Trace_init
+ */
+uint32_t Trace_getCyclesPerUs(void);
+
+/**
+ * Get ring state of a core
+ * @param core Core index
+ * @param info Output
+ * @return false if core is out of range
+ */
+bool Trace_getCoreInfo(uint8_t core, TraceCoreInfo* info);
+
+/**
+ * Copy records of a core, oldest first
+ * @param core Core index
+ * @param offset First record, counted from the oldest available one
+ * @param out Output buffer
+ * @param maxRecords Output capacity
+ * @return Number of records copied
+ */
+uint32_t Trace_read(uint8_t core, uint32_t offset, TraceRecord* out, uint32_t maxRecords);
+
+// ============================================================================
+// Macros
+// ============================================================================
+
+#ifdef __cplusplus
+/**
+ * Begin / end pair around the enclosing scope (use TRACE_SCOPE)
+ */
+class TraceScope {
+public:
+    explicit TraceScope(uint8_t event, uint16_t arg = 0) : _event(event) {
+        Trace_record(event, TRACE_PHASE_BEGIN, arg);
+    }
+    ~TraceScope() { Trace_record(_event, TRACE_PHASE_END, 0); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    uint8_t _event;
+};
+#endif
+
+#if TRACE_ENABLED
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(event) TraceScope TRACE_CONCAT(_traceScope, __LINE__)(event)
+#define TRACE_INSTANT(event, arg) Trace_record((event), TRACE_PHASE_INSTANT, (arg))
+#else
+#define TRACE_SCOPE(event) ((void)0)
+#define TRACE_INSTANT(event, arg) ((void)0)
+#endif
+
+#endif // TRACE_H
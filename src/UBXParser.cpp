@@ -0,0 +1,238 @@
+#include "UBXParser.h"
+#include "TimeSync.h"
+#include <string.h>
+
+/**
+ * UBXParser - Implementation
+ *
+ * In the idle state the next sync byte is found with memchr and, if the
+ * whole frame is already in the buffer, checked where it lies. Anything
+ * else goes through the byte state machine.
+ *
+ * @file UBXParser.cpp
+ */
+
+enum {
+    UBX_STATE_SYNC_1 = 0,
+    UBX_STATE_SYNC_2,
+    UBX_STATE_CLASS,
+    UBX_STATE_ID,
+    UBX_STATE_LEN_1,
+    UBX_STATE_LEN_2,
+    UBX_STATE_PAYLOAD,
+    UBX_STATE_CK_A,
+    UBX_STATE_CK_B,
+    UBX_STATE_SKIP,             // Oversized payload
+    UBX_STATE_SKIP_CK           // ... and its checksum
+};
+
+// ============================================================================
+// Internal Helpers
+// ============================================================================
+
+static void checksum(const uint8_t* data, size_t len, uint8_t* ckA, uint8_t* ckB) {
+    uint8_t a = *ckA, b = *ckB;
+    for (size_t i = 0; i < len; i++) {
+        a += data[i];
+        b += a;
+    }
+    *ckA = a;
+    *ckB = b;
+}
+
+static inline uint16_t rd16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t rd32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void emit(UBXParser* parser, UBXFrame* frame, uint8_t msgClass, uint8_t msgId,
+                        uint16_t length, const uint8_t* payload) {
+    frame->msgClass = msgClass;
+    frame->msgId = msgId;
+    frame->length = length;
+    frame->payload = payload;
+    parser->frames++;
+}
+
+/**
+ * Try to take a whole frame straight from the buffer
+ * @return Bytes consumed (frame or bad sync byte), 0 if incomplete
+ */
+static size_t feed_in_place(UBXParser* parser, const uint8_t* data, size_t len, UBXFrame* frame) {
+    if (len < UBX_HEADER_LEN || data[1] != UBX_SYNC_2) return 0;
+    uint16_t length = rd16(&data[4]);
+    if (length > UBX_MAX_PAYLOAD || len < (size_t)length + UBX_FRAME_OVERHEAD) return 0;
+
+    uint8_t ckA = 0, ckB = 0;
+    checksum(&data[2], 4 + length, &ckA, &ckB);
+    if (data[UBX_HEADER_LEN + length] != ckA || data[UBX_HEADER_LEN + length + 1] != ckB) {
+        parser->checksumErrors++;
+        return 1;               // Resync after the bad sync byte
+    }
+    emit(parser, frame, data[2], data[3], length, &data[UBX_HEADER_LEN]);
+    return length + UBX_FRAME_OVERHEAD;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void UBXParser_init(UBXParser* parser) {
+    memset(parser, 0, sizeof(*parser));
+}
+
+size_t UBXParser_feed(UBXParser* parser, const uint8_t* data, size_t len, UBXFrame* frame) {
+    frame->payload = NULL;
+    size_t i = 0;
+
+    while (i < len) {
+        if (parser->state == UBX_STATE_SYNC_1) {
+            const uint8_t* sync = (const uint8_t*)memchr(&data[i], UBX_SYNC_1, len - i);
+            if (!sync) return len;
+            i = sync - data;
+            size_t used = feed_in_place(parser, &data[i], len - i, frame);
+            if (used) return i + used;
+            // Frame continues in the next read
+            parser->state = UBX_STATE_SYNC_2;
+            i++;
+            continue;
+        }
+
+        if (parser->state == UBX_STATE_PAYLOAD) {
+            // Copy as much of the payload as this read holds
+            size_t n = parser->length - parser->index;
+            if (n > len - i) n = len - i;
+            memcpy(&parser->buffer[parser->index], &data[i], n);
+            checksum(&data[i], n, &parser->ckA, &parser->ckB);
+            parser->index += n;
+            i += n;
+            if (parser->index == parser->length) parser->state = UBX_STATE_CK_A;
+            continue;
+        }
+
+        uint8_t b = data[i++];
+        switch (parser->state) {
+            case UBX_STATE_SYNC_2:
+                if (b == UBX_SYNC_2) {
+                    parser->ckA = 0;
+                    parser->ckB = 0;
+                    parser->state = UBX_STATE_CLASS;
+                } else if (b != UBX_SYNC_1) {
+                    parser->state = UBX_STATE_SYNC_1;
+                }
+                break;
+            case UBX_STATE_CLASS:
+                parser->msgClass = b;
+                checksum(&b, 1, &parser->ckA, &parser->ckB);
+                parser->state = UBX_STATE_ID;
+                break;
+            case UBX_STATE_ID:
+                parser->msgId = b;
+                checksum(&b, 1, &parser->ckA, &parser->ckB);
+                parser->state = UBX_STATE_LEN_1;
+                break;
+            case UBX_STATE_LEN_1:
+                parser->length = b;
+                checksum(&b, 1, &parser->ckA, &parser->ckB);
+                parser->state = UBX_STATE_LEN_2;
+                break;
+            case UBX_STATE_LEN_2:
+                parser->length |= (uint16_t)b << 8;
+                checksum(&b, 1, &parser->ckA, &parser->ckB);
+                parser->index = 0;
+                if (parser->length > UBX_MAX_PAYLOAD) {
+                    parser->oversized++;
+                    parser->state = UBX_STATE_SKIP;
+                } else {
+                    parser->state = parser->length ? UBX_STATE_PAYLOAD : UBX_STATE_CK_A;
+                }
+                break;
+            case UBX_STATE_CK_A:
+                if (b == parser->ckA) {
+                    parser->state = UBX_STATE_CK_B;
+                } else {
+                    parser->checksumErrors++;
+                    parser->state = UBX_STATE_SYNC_1;
+                }
+                break;
+            case UBX_STATE_CK_B:
+                parser->state = UBX_STATE_SYNC_1;
+                if (b != parser->ckB) {
+                    parser->checksumErrors++;
+                    break;
+                }
+                emit(parser, frame, parser->msgClass, parser->msgId, parser->length, parser->buffer);
+                return i;
+            case UBX_STATE_SKIP:
+                if (++parser->index >= parser->length) {
+                    parser->index = 0;
+                    parser->state = UBX_STATE_SKIP_CK;
+                }
+                break;
+            case UBX_STATE_SKIP_CK:
+                if (++parser->index >= 2) parser->state = UBX_STATE_SYNC_1;
+                break;
+            default:
+                parser->state = UBX_STATE_SYNC_1;
+                break;
+        }
+    }
+    return len;
+}
+
+size_t UBXParser_buildFrame(uint8_t msgClass, uint8_t msgId, const void* payload,
+                            uint16_t payloadLen, uint8_t* out, size_t outSize) {
+    size_t total = (size_t)payloadLen + UBX_FRAME_OVERHEAD;
+    if (outSize < total) return 0;
+
+    out[0] = UBX_SYNC_1;
+    out[1] = UBX_SYNC_2;
+    out[2] = msgClass;
+    out[3] = msgId;
+    out[4] = (uint8_t)(payloadLen & 0xFF);
+    out[5] = (uint8_t)(payloadLen >> 8);
+    if (payloadLen) memcpy(&out[UBX_HEADER_LEN], payload, payloadLen);
+
+    uint8_t ckA = 0, ckB = 0;
+    checksum(&out[2], 4 + payloadLen, &ckA, &ckB);
+    out[UBX_HEADER_LEN + payloadLen] = ckA;
+    out[UBX_HEADER_LEN + payloadLen + 1] = ckB;
+    return total;
+}
+
+bool UBXParser_decodeNavPvt(const UBXFrame* frame, GPSFix* fix) {
+    if (!frame->payload || frame->msgClass != UBX_CLASS_NAV ||
+        frame->msgId != UBX_ID_NAV_PVT || frame->length < UBX_NAV_PVT_LEN) {
+        return false;
+    }
+    const uint8_t* p = frame->payload;
+    fix->iTOW = rd32(&p[0]);
+    fix->fixType = p[20];
+    fix->numSV = p[23];
+    fix->lng = (int32_t)rd32(&p[24]);
+    fix->lat = (int32_t)rd32(&p[28]);
+    fix->altMsl = (int32_t)rd32(&p[36]);
+    fix->hAcc = rd32(&p[40]);
+    fix->vAcc = rd32(&p[44]);
+    fix->velN = (int32_t)rd32(&p[48]);
+    fix->velE = (int32_t)rd32(&p[52]);
+    fix->velD = (int32_t)rd32(&p[56]);
+    fix->groundSpeed = (int32_t)rd32(&p[60]);
+    fix->course = (int32_t)rd32(&p[64]);
+    fix->sAcc = rd32(&p[68]);
+    // valid: validDate | validTime | fullyResolved, all needed for UTC
+    fix->tAcc = rd32(&p[12]);
+    fix->utcUs = 0;
+    if ((p[11] & 0x07) == 0x07) {
+        int64_t s = TimeSync_unixSeconds((uint16_t)(p[4] | (p[5] << 8)), p[6], p[7], p[8], p[9],
+                                         p[10]);
+        fix->utcUs = s * 1000000LL + (int32_t)rd32(&p[16]) / 1000;
+    }
+    // flags bit 0 = gnssFixOK; fix types 2-4 carry a position; bits 6-7 carrSoln
+    fix->valid = (p[21] & 0x01) && fix->fixType >= 2 && fix->fixType <= 4;
+    fix->carrSoln = (p[21] >> 6) & 0x03;
+    return true;
+}
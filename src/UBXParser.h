@@ -0,0 +1,131 @@
+#ifndef UBX_PARSER_H
+#define UBX_PARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * UBXParser - u-blox UBX binary protocol framing and NAV-PVT decoding
+ *
+ * Wire format: 0xB5 0x62 | class | id | length (LE16) | payload | CK_A CK_B
+ * with an 8-bit Fletcher checksum over class .. payload.
+ *
+ * UBXParser_feed() takes whole UART reads. A frame that lies entirely
+ * inside the buffer is checked and returned in place (payload points
+ * into the caller's buffer, nothing is copied); only a frame split
+ * across two reads is assembled in the parser's own buffer. Frames with
+ * a payload above UBX_MAX_PAYLOAD are skipped and counted.
+ *
+ * Plain struct, no hardware access.
+ *
+ * @file UBXParser.h
+ */
+
+#define UBX_SYNC_1              0xB5
+#define UBX_SYNC_2              0x62
+#define UBX_HEADER_LEN          6       // Sync, class, id, length
+#define UBX_MAX_PAYLOAD         100     // NAV-PVT is 92
+#define UBX_FRAME_OVERHEAD      8       // Header + checksum
+
+// Message classes / ids
+#define UBX_CLASS_NAV           0x01
+#define UBX_CLASS_ACK           0x05
+#define UBX_CLASS_CFG           0x06
+#define UBX_ID_NAV_PVT          0x07
+#define UBX_ID_ACK_NAK          0x00
+#define UBX_ID_ACK_ACK          0x01
+#define UBX_ID_CFG_PRT          0x00
+#define UBX_ID_CFG_MSG          0x01
+#define UBX_ID_CFG_RATE         0x08
+#define UBX_ID_CFG_TMODE3       0x71
+#define UBX_CLASS_RTCM3         0xF5    // CFG-MSG ids of RTCM3 output messages
+
+#define UBX_NAV_PVT_LEN         92
+
+// NAV-PVT carrier phase solution (RTK)
+#define GPS_CARR_NONE           0
+#define GPS_CARR_FLOAT          1       // Ambiguities unresolved, decimetres
+#define GPS_CARR_FIXED          2       // Centimetres
+
+/**
+ * GNSS solution, as delivered by NAV-PVT (NMEA fills what it has)
+ */
+typedef struct {
+    int32_t lat;                // deg * 1e7
+    int32_t lng;
+    int32_t altMsl;             // mm
+    int32_t velN;               // mm/s, NED
+    int32_t velE;
+    int32_t velD;
+    int32_t groundSpeed;        // mm/s
+    int32_t course;             // Heading of motion, deg * 1e5, 0-360
+    uint32_t hAcc;              // Horizontal accuracy estimate, mm
+    uint32_t vAcc;              // mm
+    uint32_t sAcc;              // Speed accuracy estimate, mm/s
+    uint32_t iTOW;              // GPS time of week, ms
+    int64_t utcUs;              // UTC of the solution, us since 1970; 0 = not resolved
+    uint32_t tAcc;              // Time accuracy estimate, ns (0 from NMEA: none)
+    uint32_t timeMs;            // millis() at reception (set by the driver)
+    uint8_t fixType;            // 0 = none, 2 = 2D, 3 = 3D
+    uint8_t numSV;
+    uint8_t carrSoln;           // GPS_CARR_*, NONE without corrections (and from NMEA)
+    bool valid;                 // gnssFixOK with at least a 2D fix
+} GPSFix;
+
+/**
+ * One complete, checksum-verified frame
+ */
+typedef struct {
+    uint8_t msgClass;
+    uint8_t msgId;
+    uint16_t length;
+    const uint8_t* payload;     // NULL = no frame; valid until the next feed
+} UBXFrame;
+
+typedef struct {
+    uint8_t state;
+    uint8_t msgClass;
+    uint8_t msgId;
+    uint16_t length;
+    uint16_t index;
+    uint8_t ckA;
+    uint8_t ckB;
+    uint8_t buffer[UBX_MAX_PAYLOAD];
+
+    // Statistics
+    uint32_t frames;
+    uint32_t checksumErrors;
+    uint32_t oversized;
+} UBXParser;
+
+/**
+ * Reset the parser (statistics included)
+ */
+void UBXParser_init(UBXParser* parser);
+
+/**
+ * Consume bytes up to and including the next complete frame
+ * @param parser Parser state
+ * @param data Received bytes
+ * @param len Number of bytes
+ * @param frame Output; payload is NULL if no frame completed
+ * @return Bytes consumed (call again with the rest while it is < len)
+ */
+size_t UBXParser_feed(UBXParser* parser, const uint8_t* data, size_t len, UBXFrame* frame);
+
+/**
+ * Build a complete frame (e.g. a CFG message)
+ * @param out Output buffer (payloadLen + UBX_FRAME_OVERHEAD bytes)
+ * @return Bytes written, or 0 if outSize is too small
+ */
+size_t UBXParser_buildFrame(uint8_t msgClass, uint8_t msgId, const void* payload,
+                            uint16_t payloadLen, uint8_t* out, size_t outSize);
+
+/**
+ * Decode a NAV-PVT frame (timeMs is left untouched)
+ * @return false if the frame is not a NAV-PVT of the expected length
+ */
+bool UBXParser_decodeNavPvt(const UBXFrame* frame, GPSFix* fix);
+
+#endif // UBX_PARSER_H
@@ -0,0 +1,77 @@
+#include "UpdateCheck.h"
+#include <string.h>
+
+/**
+ * UpdateCheck - Implementation
+ *
+ * @file UpdateCheck.cpp
+ */
+
+#define ALL_ITEMS ((uint8_t)((1u << UPDATE_CHECK_COUNT) - 1))
+
+static const char* const ITEM_NAMES[UPDATE_CHECK_COUNT] = {"radio", "config", "actuators",
+                                                           "sensors", "timing"};
+
+void UpdateCheck_begin(UpdateCheck* check, uint32_t nowMs) {
+    memset(check, 0, sizeof(*check));
+    check->startMs = nowMs;
+    check->cause = UPDATE_CHECK_COUNT;
+}
+
+void UpdateCheck_report(UpdateCheck* check, UpdateCheckItem item, bool ok) {
+    if (item >= UPDATE_CHECK_COUNT || check->verdict != UPDATE_VERDICT_PENDING) return;
+    uint8_t bit = 1u << item;
+    if ((check->passed | check->failed) & bit) return;
+    if (ok) {
+        check->passed |= bit;
+    } else {
+        check->failed |= bit;
+        if (check->cause == UPDATE_CHECK_COUNT) check->cause = item;
+    }
+}
+
+void UpdateCheck_timing(UpdateCheck* check, uint32_t ticks, uint32_t overruns) {
+    if (!check->timingStarted || ticks < check->timingTicks0 ||
+        overruns < check->timingOverruns0) {
+        check->timingStarted = true;
+        check->timingTicks0 = ticks;
+        check->timingOverruns0 = overruns;
+        return;
+    }
+    check->timingOverruns = overruns - check->timingOverruns0;
+    if (check->timingOverruns > UPDATE_CHECK_MAX_OVERRUNS)
+        UpdateCheck_report(check, UPDATE_CHECK_TIMING, false);
+    else if (ticks - check->timingTicks0 >= UPDATE_CHECK_TIMING_TICKS)
+        UpdateCheck_report(check, UPDATE_CHECK_TIMING, true);
+}
+
+UpdateVerdict UpdateCheck_update(UpdateCheck* check, uint32_t nowMs) {
+    if (check->verdict != UPDATE_VERDICT_PENDING) return check->verdict;
+    uint32_t elapsed = nowMs - check->startMs;
+    if (check->failed) {
+        check->verdict = UPDATE_VERDICT_FAIL;
+    } else if (check->passed == ALL_ITEMS) {
+        check->verdict = UPDATE_VERDICT_PASS;
+    } else if (elapsed >= UPDATE_CHECK_DEADLINE_MS) {
+        check->verdict = UPDATE_VERDICT_FAIL;
+        check->timedOut = true;
+        for (uint8_t i = 0; i < UPDATE_CHECK_COUNT; i++) {
+            if (!(check->passed & (1u << i))) {
+                check->cause = i;
+                break;
+            }
+        }
+    } else {
+        return UPDATE_VERDICT_PENDING;
+    }
+    check->verdictMs = elapsed;
+    return check->verdict;
+}
+
+bool UpdateCheck_sensorsOk(uint8_t expected, uint8_t found) {
+    return (expected & ~found) == 0;
+}
+
+const char* UpdateCheck_itemName(UpdateCheckItem item) {
+    return item < UPDATE_CHECK_COUNT ? ITEM_NAMES[item] : "none";
+}
@@ -0,0 +1,111 @@
+#ifndef UPDATE_CHECK_H
+#define UPDATE_CHECK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * UpdateCheck - First-boot health check of a freshly installed image
+ *
+ * After an OTA update the bootloader starts the new image once in
+ * PENDING_VERIFY: unless the image marks itself valid, the next reset
+ * goes back to the previous one. This decides, within
+ * UPDATE_CHECK_DEADLINE_MS of boot, whether it may:
+ *
+ *   RADIO      The radio boot stage succeeded
+ *   CONFIG     Config and crypto came up
+ *   ACTUATORS  Every fitted output of the vehicle holds a PWM channel
+ *   SENSORS    Every sensor the previous image found is found again
+ *              (UpdateCheck_sensorsOk; the mask is saved on each boot
+ *              that is not on trial)
+ *   TIMING     UPDATE_CHECK_TIMING_TICKS control ticks with at most
+ *              UPDATE_CHECK_MAX_OVERRUNS overruns
+ *
+ * PASS once every item passed; FAIL on the first failed item or when the
+ * deadline comes with items still open. The verdict is latched.
+ *
+ * Pure: no globals, no RTOS. The caller gathers the facts and acts on
+ * the verdict (mark valid / roll back).
+ *
+ * @file UpdateCheck.h
+ */
+
+#define UPDATE_CHECK_DEADLINE_MS    5000    // From app start
+#define UPDATE_CHECK_TIMING_TICKS   100     // Two seconds of control ticks
+#define UPDATE_CHECK_MAX_OVERRUNS   2       // Tolerated while caches warm up
+#define UPDATE_CHECK_SENSORS_KEY    "upd_sens"
+
+// Sensor mask bits (UpdateCheck_sensorsOk)
+#define UPDATE_SENSOR_IMU           0x01
+#define UPDATE_SENSOR_PITOT         0x02
+#define UPDATE_SENSOR_MAG           0x04
+#define UPDATE_SENSOR_BARO          0x08
+#define UPDATE_SENSOR_PWM_EXPANDER  0x10
+
+typedef enum {
+    UPDATE_CHECK_RADIO = 0,
+    UPDATE_CHECK_CONFIG,
+    UPDATE_CHECK_ACTUATORS,
+    UPDATE_CHECK_SENSORS,
+    UPDATE_CHECK_TIMING,
+    UPDATE_CHECK_COUNT
+} UpdateCheckItem;
+
+typedef enum {
+    UPDATE_VERDICT_PENDING = 0,
+    UPDATE_VERDICT_PASS,
+    UPDATE_VERDICT_FAIL
+} UpdateVerdict;
+
+typedef struct {
+    uint32_t startMs;
+    uint8_t passed;             // Bit per UpdateCheckItem
+    uint8_t failed;
+    UpdateVerdict verdict;
+    uint8_t cause;              // First failed item (or first still open at the deadline)
+    bool timedOut;
+    uint32_t verdictMs;         // Since startMs
+
+    // Control timing window
+    bool timingStarted;
+    uint32_t timingTicks0;
+    uint32_t timingOverruns0;
+    uint32_t timingOverruns;    // In the window so far
+} UpdateCheck;
+
+/**
+ * Start the check (nothing passed yet)
+ * @param nowMs Milliseconds since app start
+ */
+void UpdateCheck_begin(UpdateCheck* check, uint32_t nowMs);
+
+/**
+ * Record an item (ignored once it has a result or the verdict is in)
+ */
+void UpdateCheck_report(UpdateCheck* check, UpdateCheckItem item, bool ok);
+
+/**
+ * Feed the control task's cumulative run / overrun counters; the first
+ * call opens the window (a counter reset reopens it)
+ */
+void UpdateCheck_timing(UpdateCheck* check, uint32_t ticks, uint32_t overruns);
+
+/**
+ * Settle the verdict
+ * @return PENDING until every item passed, an item failed or the deadline
+ */
+UpdateVerdict UpdateCheck_update(UpdateCheck* check, uint32_t nowMs);
+
+/**
+ * @param expected Sensors found by the previous image
+ * @param found Sensors found now
+ * @return true if none of the expected ones is missing
+ */
+bool UpdateCheck_sensorsOk(uint8_t expected, uint8_t found);
+
+/**
+ * Short name of an item ("radio", ...)
+ */
+const char* UpdateCheck_itemName(UpdateCheckItem item);
+
+#endif // UPDATE_CHECK_H
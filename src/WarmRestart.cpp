@@ -0,0 +1,127 @@
+#include "WarmRestart.h"
+#include "Crc16.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * WarmRestart - Implementation
+ *
+ * A save is a struct copy plus one CRC over ~300 bytes (a few us at
+ * 240 MHz); nothing waits on flash.
+ *
+ * @file WarmRestart.cpp
+ */
+
+static uint16_t record_crc(const WarmRestartRecord* record) {
+    return Crc16_compute((const uint8_t*)record, offsetof(WarmRestartRecord, crc));
+}
+
+// ============================================================================
+// Record Store
+// ============================================================================
+
+void WarmRestart_clear(WarmRestartStore* store) {
+    // volatile: the wipe must not be dropped as a dead store before a reset
+    volatile uint8_t* p = (volatile uint8_t*)store;
+    for (size_t i = 0; i < sizeof(*store); i++) p[i] = 0;
+}
+
+bool WarmRestart_isValid(const WarmRestartRecord* record, uint32_t buildId) {
+    return record->magic == WARM_RESTART_MAGIC && record->version == WARM_RESTART_VERSION &&
+           record->size == sizeof(WarmRestartRecord) && record->buildId == buildId &&
+           record->crc == record_crc(record);
+}
+
+const WarmRestartRecord* WarmRestart_latest(const WarmRestartStore* store, uint32_t buildId) {
+    const WarmRestartRecord* best = NULL;
+    for (uint8_t i = 0; i < WARM_RESTART_SLOTS; i++) {
+        const WarmRestartRecord* r = &store->slots[i];
+        if (!WarmRestart_isValid(r, buildId)) continue;
+        if (!best || (int32_t)(r->sequence - best->sequence) > 0) best = r;
+    }
+    return best;
+}
+
+void WarmRestart_write(WarmRestartStore* store, const WarmRestartRecord* record,
+                       uint32_t buildId) {
+    const WarmRestartRecord* newest = WarmRestart_latest(store, buildId);
+    WarmRestartRecord* dst = &store->slots[0];
+    uint32_t sequence = 1;
+    if (newest) {
+        // Overwrite the other slot: the newest stays intact until this one is sealed
+        dst = newest == &store->slots[0] ? &store->slots[1] : &store->slots[0];
+        sequence = newest->sequence + 1;
+    }
+    memcpy(dst, record, sizeof(*dst));
+    dst->magic = WARM_RESTART_MAGIC;
+    dst->version = WARM_RESTART_VERSION;
+    dst->size = sizeof(WarmRestartRecord);
+    dst->buildId = buildId;
+    dst->sequence = sequence;
+    dst->crc = record_crc(dst);
+}
+
+// ============================================================================
+// RTC Memory
+// ============================================================================
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_idf_version.h>
+#include <esp_system.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <esp_app_desc.h>
+#else
+#include <esp_ota_ops.h>
+#endif
+
+RTC_NOINIT_ATTR static WarmRestartStore gStore;
+
+// First bytes of the running image's ELF SHA-256
+static uint32_t build_id(void) {
+    static uint32_t id = 0;
+    if (id == 0) {
+#if ESP_IDF_VERSION_MAJOR >= 5
+        const esp_app_desc_t* desc = esp_app_get_description();
+#else
+        const esp_app_desc_t* desc = esp_ota_get_app_description();
+#endif
+        memcpy(&id, desc->app_elf_sha256, sizeof(id));
+        if (id == 0) id = 1;
+    }
+    return id;
+}
+
+// Resets that keep RTC slow memory and mean "the same flight, interrupted"
+static bool resumable_reset(esp_reset_reason_t reason) {
+    switch (reason) {
+    case ESP_RST_SW:        // Liveness watchdog (esp_restart)
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+    case ESP_RST_BROWNOUT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool WarmRestart_take(WarmRestartRecord* out) {
+    const WarmRestartRecord* latest = NULL;
+    if (resumable_reset(esp_reset_reason()))
+        latest = WarmRestart_latest(&gStore, build_id());
+    if (!latest) {
+        WarmRestart_clear(&gStore);
+        return false;
+    }
+    memcpy(out, latest, sizeof(*out));
+    return true;
+}
+
+void WarmRestart_save(const WarmRestartRecord* record) {
+    WarmRestart_write(&gStore, record, build_id());
+}
+
+#endif // __XTENSA__
@@ -0,0 +1,131 @@
+#ifndef WARM_RESTART_H
+#define WARM_RESTART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MissionRunner.h"
+#include "SessionKeys.h"
+
+/**
+ * WarmRestart - Resume a mission after a watchdog, panic or brown-out reset
+ *
+ * The control task copies the state a reboot would otherwise lose into
+ * RTC slow memory every tick: home, the mission cursor, the failsafe state
+ * and the paired controller's session (keys and sequence window). The
+ * next boot restores it before the control task starts, instead of
+ * waiting for a new GPS fix to re-home and a new handshake.
+ *
+ * - Two slots written alternately with a write counter: a reset in the
+ *   middle of a write leaves the other slot intact
+ * - CRC-16 over the whole record, plus magic, layout version, size and a
+ *   build id (an OTA image never reads the previous image's record)
+ * - Only taken after a reset that kept RTC memory (watchdog, panic,
+ *   brown-out, software); a power-on wipes it
+ *
+ * The mission itself comes back from NVS; the cursor is only resumed if
+ * the loaded mission has the count and CRC the record was taken with.
+ *
+ * @file WarmRestart.h
+ */
+
+#define WARM_RESTART_MAGIC      0x5741524DUL    // "WARM"
+#define WARM_RESTART_VERSION    1
+#define WARM_RESTART_SLOTS      2
+
+/**
+ * Navigation state (NavigationManager)
+ */
+typedef struct {
+    float homeLat;
+    float homeLng;
+    bool homeSet;
+    bool missionActive;         // Flying the stored mission (not survey / follow)
+    bool rtlActive;
+    uint16_t waypointIndex;
+    uint16_t lastItem;          // Start of the current leg
+    bool lastItemValid;
+    MissionRunner runner;       // Next item, mission speed, jump counters
+    uint16_t missionCount;      // Mission the cursor belongs to
+    uint16_t missionCrc;
+    bool missionPersisted;      // NVS holds exactly that mission
+} WarmRestartNav;
+
+/**
+ * Paired controller's session
+ */
+typedef struct {
+    uint8_t mac[6];
+    bool valid;                 // A paired controller was known
+    bool keyed;                 // keys: its handshake session
+    bool haveSeq;
+    uint32_t highestSeq;        // Replay window restarts above this
+    SessionKeys keys;
+} WarmRestartTicket;
+
+/**
+ * One record (zero it before filling: padding is covered by the CRC)
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t buildId;
+    uint32_t sequence;          // Write counter, the newest valid slot wins
+    uint32_t uptimeMs;          // millis() at the write
+    uint8_t failsafeState;      // FailsafeState
+    uint32_t sincePacketMs;     // Time since the last valid frame
+    WarmRestartNav nav;
+    WarmRestartTicket ticket;
+    uint16_t crc;               // CRC-16/CCITT over everything above
+} WarmRestartRecord;
+
+/**
+ * Both slots (RTC_NOINIT on the target)
+ */
+typedef struct {
+    WarmRestartRecord slots[WARM_RESTART_SLOTS];
+} WarmRestartStore;
+
+// ============================================================================
+// Record Store (pure)
+// ============================================================================
+
+/**
+ * Wipe both slots (also erases the session keys)
+ */
+void WarmRestart_clear(WarmRestartStore* store);
+
+/**
+ * Whether a slot holds an intact record of this build
+ */
+bool WarmRestart_isValid(const WarmRestartRecord* record, uint32_t buildId);
+
+/**
+ * Write a record into the older slot
+ * Stamps magic, version, size, build id, sequence and CRC.
+ */
+void WarmRestart_write(WarmRestartStore* store, const WarmRestartRecord* record,
+                       uint32_t buildId);
+
+/**
+ * Newest intact record, NULL if there is none
+ */
+const WarmRestartRecord* WarmRestart_latest(const WarmRestartStore* store, uint32_t buildId);
+
+// ============================================================================
+// RTC Memory (target)
+// ============================================================================
+
+/**
+ * Record of the last run (boot, once)
+ * Power-on and deep-sleep wake-ups wipe the store instead.
+ * @return false: nothing to resume
+ */
+bool WarmRestart_take(WarmRestartRecord* out);
+
+/**
+ * Store the current state (control task)
+ */
+void WarmRestart_save(const WarmRestartRecord* record);
+
+#endif // WARM_RESTART_H
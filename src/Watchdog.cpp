@@ -0,0 +1,206 @@
+#include "Watchdog.h"
+#include "HAL.h"
+#include <string.h>
+
+/**
+ * Watchdog - Implementation
+ *
+ * Check-ins are a single 32-bit store from the owning task; the supervisor
+ * only reads the slots, so no lock is taken on either side.
+ *
+ * @file Watchdog.cpp
+ */
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_idf_version.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+#define WATCHDOG_IRAM IRAM_ATTR
+#else
+#define WATCHDOG_IRAM
+#endif
+
+#define WATCHDOG_PM_MAGIC 0x57444F47UL     // "WDOG"
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+void Watchdog_init(WatchdogTable* table) {
+    memset(table, 0, sizeof(*table));
+}
+
+int Watchdog_register(WatchdogTable* table, const char* name, uint32_t deadlineMs) {
+    if (table->count >= WATCHDOG_MAX_TASKS || deadlineMs == 0) return -1;
+    WatchdogSlot* s = &table->slots[table->count];
+    memset(s, 0, sizeof(*s));
+    s->name = name;
+    s->deadlineMs = deadlineMs;
+    return table->count++;
+}
+
+void Watchdog_checkIn(WatchdogTable* table, int slot, uint32_t nowMs) {
+    if (slot < 0 || slot >= table->count) return;
+    WatchdogSlot* s = &table->slots[slot];
+    if (s->armed) {
+        uint32_t gap = nowMs - s->lastCheckInMs;
+        if (gap > s->maxGapMs) s->maxGapMs = gap;
+    }
+    s->lastCheckInMs = nowMs;
+    s->armed = true;
+}
+
+int Watchdog_poll(WatchdogTable* table, uint32_t nowMs, uint32_t* lateMs) {
+    // The supervisor itself was held off: every task was, too
+    if (table->polled && nowMs - table->lastPollMs > WATCHDOG_BLACKOUT_MS)
+        table->resumeMs = nowMs;
+    table->lastPollMs = nowMs;
+    table->polled = true;
+
+    for (uint8_t i = 0; i < table->count; i++) {
+        const WatchdogSlot* s = &table->slots[i];
+        if (!s->armed) continue;
+        uint32_t since = nowMs - s->lastCheckInMs;
+        uint32_t sinceResume = nowMs - table->resumeMs;
+        if (since > s->deadlineMs && sinceResume > s->deadlineMs) {
+            if (lateMs) *lateMs = since;
+            return i;
+        }
+    }
+    return -1;
+}
+
+WATCHDOG_IRAM void Watchdog_recordPostMortem(WatchdogPostMortem* pm, const WatchdogSlot* slot,
+                                             WatchdogCause cause, uint32_t nowMs,
+                                             uint32_t lateMs) {
+    pm->resetCount++;
+    pm->cause = (uint8_t)cause;
+    pm->pending = true;
+    pm->uptimeMs = nowMs;
+    pm->lateMs = lateMs;
+    pm->deadlineMs = slot ? slot->deadlineMs : 0;
+    // No strncpy: this also runs from the task watchdog ISR
+    uint8_t n = 0;
+    if (slot && slot->name) {
+        for (; n < WATCHDOG_NAME_LEN - 1 && slot->name[n]; n++) pm->task[n] = slot->name[n];
+    }
+    pm->task[n] = '\0';
+}
+
+// ============================================================================
+// Supervisor (target only)
+// ============================================================================
+
+#if defined(__XTENSA__)
+
+// Not zeroed by the reset (garbage at power-on, checked by magic)
+RTC_NOINIT_ATTR static WatchdogPostMortem gPostMortem;
+
+static WatchdogPostMortem gLastReset;
+static bool gHaveLastReset = false;
+static WatchdogTable* gTable = nullptr;
+static void (*gPreReset)(void) = nullptr;
+static esp_timer_handle_t gPollTimer = nullptr;
+static volatile bool gTripped = false;
+static int8_t gSubscribed[WATCHDOG_MAX_TASKS] = {};     // 0 untried, 1 yes, -1 failed
+
+static void supervisor_poll(void* arg) {
+    WatchdogTable* table = (WatchdogTable*)arg;
+    uint32_t nowMs = HAL_GetMillis();
+    uint32_t lateMs = 0;
+    int slot = Watchdog_poll(table, nowMs, &lateMs);
+    if (slot < 0 || gTripped) return;
+
+    gTripped = true;
+    if (gPreReset) gPreReset();
+    Watchdog_recordPostMortem(&gPostMortem, &table->slots[slot], WATCHDOG_CAUSE_DEADLINE,
+                              nowMs, lateMs);
+    esp_restart();
+}
+
+// Weak hook in the esp_task_wdt ISR, called right before the panic
+extern "C" void IRAM_ATTR esp_task_wdt_isr_user_handler(void) {
+    if (gTripped || !gTable) return;
+    gTripped = true;
+    if (gPreReset) gPreReset();
+
+    // Blame the armed slot that has been silent the longest
+    uint32_t nowMs = (uint32_t)(HAL_Now() / 1000);
+    const WatchdogSlot* worst = nullptr;
+    uint32_t worstMs = 0;
+    for (uint8_t i = 0; i < gTable->count; i++) {
+        const WatchdogSlot* s = &gTable->slots[i];
+        uint32_t since = nowMs - s->lastCheckInMs;
+        if (s->armed && since >= worstMs) {
+            worst = s;
+            worstMs = since;
+        }
+    }
+    Watchdog_recordPostMortem(&gPostMortem, worst, WATCHDOG_CAUSE_TWDT, nowMs, worstMs);
+}
+
+static void load_post_mortem(void) {
+    if (gPostMortem.magic != WATCHDOG_PM_MAGIC || esp_reset_reason() == ESP_RST_POWERON) {
+        memset(&gPostMortem, 0, sizeof(gPostMortem));
+        gPostMortem.magic = WATCHDOG_PM_MAGIC;
+    }
+    if (gPostMortem.pending) {
+        gLastReset = gPostMortem;
+        gHaveLastReset = true;
+        gPostMortem.pending = false;
+    }
+}
+
+bool Watchdog_start(WatchdogTable* table, void (*preReset)(void)) {
+    if (gPollTimer) return true;
+    load_post_mortem();
+    gTable = table;
+    gPreReset = preReset;
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_task_wdt_config_t cfg = {
+        .timeout_ms = WATCHDOG_TWDT_TIMEOUT_MS,
+        .idle_core_mask = 1 << 0,       // Arduino default: core 0 idle task
+        .trigger_panic = true,
+    };
+    if (esp_task_wdt_reconfigure(&cfg) != ESP_OK) esp_task_wdt_init(&cfg);
+#else
+    // Updates the timeout / panic flag if Arduino already started it
+    esp_task_wdt_init((WATCHDOG_TWDT_TIMEOUT_MS + 999) / 1000, true);
+#endif
+
+    esp_timer_create_args_t args = {};
+    args.callback = supervisor_poll;
+    args.arg = table;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "watchdog";
+    if (esp_timer_create(&args, &gPollTimer) != ESP_OK) {
+        gPollTimer = nullptr;
+        return false;
+    }
+    if (esp_timer_start_periodic(gPollTimer, WATCHDOG_POLL_MS * 1000ULL) != ESP_OK) {
+        esp_timer_delete(gPollTimer);
+        gPollTimer = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void Watchdog_feed(WatchdogTable* table, int slot) {
+    if (slot < 0 || slot >= table->count) return;
+    Watchdog_checkIn(table, slot, HAL_GetMillis());
+    // Only the slot's own task ever touches its flag
+    if (gSubscribed[slot] == 0) gSubscribed[slot] = esp_task_wdt_add(NULL) == ESP_OK ? 1 : -1;
+    if (gSubscribed[slot] > 0) esp_task_wdt_reset();
+}
+
+bool Watchdog_getPostMortem(WatchdogPostMortem* pm) {
+    if (!gHaveLastReset) return false;
+    *pm = gLastReset;
+    return true;
+}
+
+#endif
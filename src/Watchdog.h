@@ -0,0 +1,137 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Watchdog - Per-task liveness deadlines with a safe-outputs reset
+ *
+ * Each supervised task owns a slot with its own deadline and checks in
+ * once per iteration (Watchdog_feed). A 10 ms esp_timer callback polls
+ * the slots; a slot that has not checked in within its deadline:
+ *   1. writes a post-mortem record to RTC memory (survives the reset),
+ *   2. runs the pre-reset hook (outputs to zero, no locks, no driver calls),
+ *   3. restarts the chip.
+ * Slots are armed by their first check-in, so tasks started late (or not
+ * at all in the fallback loop) never trip.
+ *
+ * If the supervisor itself was held off (flash erase / cache disabled
+ * stalls every task on both cores) the gap is not charged to the tasks:
+ * their deadlines restart from the first poll after it.
+ *
+ * The supervised tasks are also subscribed to the ESP-IDF task watchdog
+ * (esp_task_wdt) with a longer timeout and panic enabled, as a backstop
+ * for the case where the esp_timer task cannot run at all; its ISR runs
+ * the same hook and record before the panic reset.
+ *
+ * @file Watchdog.h
+ */
+
+#define WATCHDOG_MAX_TASKS       6
+#define WATCHDOG_POLL_MS         10      // Supervisor period
+#define WATCHDOG_BLACKOUT_MS     30      // Poll gap treated as a system-wide stall
+#define WATCHDOG_TWDT_TIMEOUT_MS 2000    // esp_task_wdt backstop
+#define WATCHDOG_NAME_LEN        12
+
+/**
+ * One supervised task
+ */
+typedef struct {
+    const char* name;
+    uint32_t deadlineMs;            // Max time between check-ins
+    volatile uint32_t lastCheckInMs;
+    volatile bool armed;            // Checked in at least once
+    uint32_t maxGapMs;              // Worst observed check-in gap
+} WatchdogSlot;
+
+/**
+ * Supervisor state
+ */
+typedef struct {
+    WatchdogSlot slots[WATCHDOG_MAX_TASKS];
+    uint8_t count;
+    uint32_t lastPollMs;
+    uint32_t resumeMs;              // Deadlines count from here after a blackout
+    bool polled;
+} WatchdogTable;
+
+/**
+ * Reset cause recorded before a watchdog restart
+ */
+typedef enum {
+    WATCHDOG_CAUSE_NONE = 0,
+    WATCHDOG_CAUSE_DEADLINE = 1,    // Slot missed its deadline (supervisor)
+    WATCHDOG_CAUSE_TWDT = 2         // esp_task_wdt backstop fired
+} WatchdogCause;
+
+/**
+ * Post-mortem record (kept in RTC memory across the reset)
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t resetCount;            // Watchdog resets since power-on
+    uint8_t cause;                  // WatchdogCause
+    bool pending;                   // Written, not yet reported
+    char task[WATCHDOG_NAME_LEN];
+    uint32_t uptimeMs;              // millis() at the trip
+    uint32_t lateMs;                // Time since the task's last check-in
+    uint32_t deadlineMs;
+} WatchdogPostMortem;
+
+/**
+ * Clear all slots
+ */
+void Watchdog_init(WatchdogTable* table);
+
+/**
+ * Add a supervised task (before Watchdog_start)
+ * @param name Static string
+ * @param deadlineMs Max time between check-ins (> 0)
+ * @return Slot index, or -1 if the table is full
+ */
+int Watchdog_register(WatchdogTable* table, const char* name, uint32_t deadlineMs);
+
+/**
+ * Record a check-in (arms the slot)
+ */
+void Watchdog_checkIn(WatchdogTable* table, int slot, uint32_t nowMs);
+
+/**
+ * One supervisor pass
+ * @param lateMs Set to the overdue slot's time since its last check-in
+ * @return Index of the first slot past its deadline, -1 if none
+ */
+int Watchdog_poll(WatchdogTable* table, uint32_t nowMs, uint32_t* lateMs);
+
+/**
+ * Fill a post-mortem record for a slot (resetCount is incremented)
+ */
+void Watchdog_recordPostMortem(WatchdogPostMortem* pm, const WatchdogSlot* slot,
+                               WatchdogCause cause, uint32_t nowMs, uint32_t lateMs);
+
+// ============================================================================
+// Target Only
+// ============================================================================
+
+/**
+ * Start the supervisor and configure the esp_task_wdt backstop
+ * @param preReset Called right before the restart, from the esp_timer task
+ *                 or the task watchdog ISR: must be IRAM-safe and lock-free
+ * @return true if the poll timer is running
+ */
+bool Watchdog_start(WatchdogTable* table, void (*preReset)(void));
+
+/**
+ * Check in from the slot's own task (also feeds esp_task_wdt, subscribing
+ * the calling task on its first call)
+ */
+void Watchdog_feed(WatchdogTable* table, int slot);
+
+/**
+ * Post-mortem of the previous reset
+ * @return true if the last reset was a watchdog reset (pm filled)
+ */
+bool Watchdog_getPostMortem(WatchdogPostMortem* pm);
+
+#endif // WATCHDOG_H
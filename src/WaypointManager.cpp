@@ -1,95 +1,290 @@
 #include "WaypointManager.h"
+#include "Crc16.h"
+#include "HAL.h"
+#include "MemPlacement.h"
+#include "NavFrame.h"
 
 WaypointManager& WaypointManager::getInstance() {
-    static WaypointManager instance;
+    // ~3.5 KB, read one waypoint at a time: PSRAM when there is some
+    BULK_BSS static WaypointManager instance;
     return instance;
 }
 
-WaypointManager::WaypointManager() : _homeSet(false) {
-    _waypoints.reserve(MAX_WAYPOINTS);
+WaypointManager::WaypointManager()
+    : _count(0), _staging(nullptr), _uploadReady(false), _homeSet(false), _revision(0),
+      _savedRevision(0), _savedCrc(0), _editMs(0) {
+    memset(&_upload, 0, sizeof(_upload));
+    MemPlacement_note("mission", this, sizeof(*this), MEM_CLASS_BULK);
+}
+
+void WaypointManager::store(uint16_t index, int32_t lat, int32_t lng, float alt, uint16_t speed) {
+    float dm = alt * 10.0f;
+    if (dm > INT16_MAX) dm = INT16_MAX;
+    if (dm < INT16_MIN) dm = INT16_MIN;
+    _lat[index] = lat;
+    _lng[index] = lng;
+    _alt[index] = (int16_t)lroundf(dm);
+    _param[index] = speed;
+    _cmd[index] = MISSION_CMD_WAYPOINT;
+    _arg[index] = 0;
+}
+
+void WaypointManager::storeRecord(uint16_t index, const WaypointRecord& item) {
+    _lat[index] = item.lat;
+    _lng[index] = item.lng;
+    _alt[index] = item.alt;
+    _param[index] = item.param;
+    _cmd[index] = item.cmd;
+    _arg[index] = item.arg;
+}
+
+void WaypointManager::touch() {
+    _editMs = HAL_GetMillis();
+    _revision++;
 }
 
 bool WaypointManager::addWaypoint(float lat, float lng, float alt, uint16_t speed) {
-    if (_waypoints.size() >= MAX_WAYPOINTS) return false;
-    
-    NAWaypoint wp;
-    wp.lat = lat;
-    wp.lng = lng;
-    wp.alt = alt;
-    wp.speed = speed;
-    _waypoints.push_back(wp);
+    return addWaypointE7(NavFrame_toE7(lat), NavFrame_toE7(lng), alt, speed);
+}
+
+bool WaypointManager::addWaypointE7(int32_t lat, int32_t lng, float alt, uint16_t speed) {
+    if (_count >= MAX_WAYPOINTS) return false;
+
+    store(_count++, lat, lng, alt, speed);
+    touch();
     return true;
 }
 
-bool WaypointManager::setWaypoint(uint8_t index, const NAWaypoint& wp) {
-    if (index >= MAX_WAYPOINTS) return false;
-    
-    // Resize if needed (allow setting index 0 even if empty, logic wise acts as add if sequential)
-    if (index >= _waypoints.size()) {
-       if (index == _waypoints.size()) {
-           _waypoints.push_back(wp);
-           return true;
-       }
-       return false; // Can't skip indices
+bool WaypointManager::addItem(const WaypointRecord& item) {
+    if (_count >= MAX_WAYPOINTS || item.cmd >= MISSION_CMD_COUNT) return false;
+
+    storeRecord(_count++, item);
+    touch();
+    return true;
+}
+
+bool WaypointManager::insertItem(uint16_t index, const WaypointRecord& item) {
+    if (_count >= MAX_WAYPOINTS || index > _count || item.cmd >= MISSION_CMD_COUNT) return false;
+
+    for (uint16_t i = _count; i > index; i--) {
+        _lat[i] = _lat[i - 1];
+        _lng[i] = _lng[i - 1];
+        _alt[i] = _alt[i - 1];
+        _param[i] = _param[i - 1];
+        _cmd[i] = _cmd[i - 1];
+        _arg[i] = _arg[i - 1];
     }
-    
-    _waypoints[index] = wp;
+    _count++;
+    storeRecord(index, item);
+    for (uint16_t i = 0; i < _count; i++) {
+        if (i != index && _cmd[i] == MISSION_CMD_JUMP && _param[i] >= index) _param[i]++;
+    }
+    touch();
+    return true;
+}
+
+bool WaypointManager::setWaypoint(uint16_t index, const NAWaypoint& wp) {
+    if (index >= MAX_WAYPOINTS) return false;
+    if (index > _count) return false; // Can't skip indices (index == count appends)
+
+    store(index, NavFrame_toE7(wp.lat), NavFrame_toE7(wp.lng), wp.alt, wp.speed);
+    if (index == _count) _count++;
+    touch();
     return true;
 }
 
 bool WaypointManager::clearMission() {
-    _waypoints.clear();
-    // Also clear NVS
-    ConfigManager::setInt(WAYPOINT_COUNT_KEY, 0);
+    // The empty mission reaches NVS through update(), like any edit
+    _count = 0;
+    touch();
+    return true;
+}
+
+bool WaypointManager::getWaypoint(uint16_t index, NAWaypoint& wp) {
+    if (index >= _count) return false;
+    wp.lat = _lat[index] / (double)NAV_FRAME_E7;
+    wp.lng = _lng[index] / (double)NAV_FRAME_E7;
+    wp.alt = getAlt(index);
+    wp.speed = _cmd[index] == MISSION_CMD_WAYPOINT ? _param[index] : 0;
     return true;
 }
 
-uint8_t WaypointManager::getWaypointCount() {
-    return (uint8_t)_waypoints.size();
+MissionView WaypointManager::getView() {
+    MissionView view;
+    view.cmd = _cmd;
+    view.param = _param;
+    view.arg = _arg;
+    view.alt = _alt;
+    view.count = _count;
+    return view;
 }
 
-bool WaypointManager::getWaypoint(uint8_t index, NAWaypoint& wp) {
-    if (index >= _waypoints.size()) return false;
-    wp = _waypoints[index];
+// ============================================================================
+// Persistence (comms task / boot)
+// ============================================================================
+
+void WaypointManager::packRecords(WaypointRecord* out) {
+    for (uint16_t i = 0; i < _count; i++) {
+        out[i].lat = _lat[i];
+        out[i].lng = _lng[i];
+        out[i].alt = _alt[i];
+        out[i].param = _param[i];
+        out[i].cmd = _cmd[i];
+        out[i].arg = _arg[i];
+    }
+}
+
+bool WaypointManager::copyRecords(WaypointRecord* out, uint16_t* count) {
+    // A pending upload is about to replace the arrays from the control task
+    if (_uploadReady) return false;
+    packRecords(out);
+    *count = _count;
+    return true;
+}
+
+bool WaypointManager::saveRecords(const WaypointRecord* records, uint16_t count) {
+    if (!ConfigManager::saveBlob(WAYPOINT_NVS_KEY, records, count * sizeof(WaypointRecord)))
+        return false;
+    // Retire the older copies so a bad blob can't bring back an old mission
+    ConfigManager::removeKey(WAYPOINT_V2_KEY);
+    ConfigManager::removeKey(WAYPOINT_LEGACY_KEY);
+    ConfigManager::setInt(WAYPOINT_COUNT_KEY, 0);
     return true;
 }
 
 bool WaypointManager::saveToNVS() {
-    uint8_t count = (uint8_t)_waypoints.size();
-    ConfigManager::setInt(WAYPOINT_COUNT_KEY, count);
-    
-    for (uint8_t i = 0; i < count; i++) {
-        char key[16];
-        snprintf(key, 16, "wp_lat_%d", i);
-        ConfigManager::setFloat(key, _waypoints[i].lat);
-        snprintf(key, 16, "wp_lng_%d", i);
-        ConfigManager::setFloat(key, _waypoints[i].lng);
-        snprintf(key, 16, "wp_alt_%d", i);
-        ConfigManager::setFloat(key, _waypoints[i].alt);
-        snprintf(key, 16, "wp_spd_%d", i);
-        ConfigManager::setInt(key, _waypoints[i].speed);
+    // Snapshot into records first (one blob write, and edits made while
+    // flash is busy stay dirty for the next write); only a save needs the
+    // buffer
+    uint32_t revision = _revision;
+    WaypointRecord* records = (WaypointRecord*)MemPlacement_alloc(
+        "mission_save", _count * sizeof(WaypointRecord), MEM_CLASS_BULK);
+    if (!records) return false;
+    packRecords(records);
+    bool ok = saveRecords(records, _count);
+    if (ok) {
+        _savedCrc = Crc16_compute((const uint8_t*)records, _count * sizeof(WaypointRecord));
+        _savedRevision = revision;
     }
-    return true; 
+    MemPlacement_free(records);
+    return ok;
+}
+
+bool WaypointManager::update(uint32_t nowMs, MissionPersistEvent* event) {
+    if (_uploadReady || _revision == _savedRevision) return false;
+    if ((uint32_t)(nowMs - _editMs) < MISSION_PERSIST_DELAY_MS) return false;
+
+    event->revision = _revision;
+    event->count = _count;
+    event->ok = saveToNVS();
+    if (!event->ok) _editMs = nowMs;    // Retry after another quiet period
+    return true;
 }
 
 bool WaypointManager::loadFromNVS() {
+    _count = 0;
+    _revision++;
+
+    WaypointRecord* records = (WaypointRecord*)MemPlacement_alloc(
+        "mission_load", MAX_WAYPOINTS * sizeof(WaypointRecord), MEM_CLASS_BULK);
+    if (!records) return false;
+    size_t len = ConfigManager::loadBlob(WAYPOINT_NVS_KEY, records,
+                                         MAX_WAYPOINTS * sizeof(WaypointRecord));
+    bool ok = len % sizeof(WaypointRecord) == 0;
+    if (ok) {
+        for (size_t i = 0; i < len / sizeof(WaypointRecord); i++) {
+            storeRecord(i, records[i]);
+        }
+        _count = len / sizeof(WaypointRecord);
+        _savedCrc = Crc16_compute((const uint8_t*)records, len);
+    }
+    MemPlacement_free(records);
+
+    if (len > 0) {
+        if (ok) _savedRevision = _revision;
+        return ok;
+    }
+    // A legacy mission stays dirty: update() rewrites it as a blob
+    bool legacy = loadLegacy();
+    if (_count == 0) _savedRevision = _revision;
+    return legacy;
+}
+
+bool WaypointManager::loadLegacy() {
+    // NAWaypoint blob from before fixed-point storage
+    NAWaypoint* buf = (NAWaypoint*)MemPlacement_alloc(
+        "mission_legacy", WAYPOINT_LEGACY_MAX * sizeof(NAWaypoint), MEM_CLASS_BULK);
+    if (!buf) return false;
+    size_t len = ConfigManager::loadBlob(WAYPOINT_LEGACY_KEY, buf,
+                                         WAYPOINT_LEGACY_MAX * sizeof(NAWaypoint));
+    if (len > 0) {
+        bool ok = len % sizeof(NAWaypoint) == 0;
+        for (size_t i = 0; ok && i < len / sizeof(NAWaypoint); i++) {
+            setWaypoint(i, buf[i]);
+        }
+        MemPlacement_free(buf);
+        return ok;
+    }
+    MemPlacement_free(buf);
+
+    // Pre-blob firmware stored one key per field
     int count = ConfigManager::getInt(WAYPOINT_COUNT_KEY, 0);
-    if (count > MAX_WAYPOINTS) count = MAX_WAYPOINTS;
-    
-    _waypoints.clear();
+    if (count > WAYPOINT_LEGACY_MAX) count = WAYPOINT_LEGACY_MAX;
+
     for (int i = 0; i < count; i++) {
-        NAWaypoint wp;
         char key[16];
         snprintf(key, 16, "wp_lat_%d", i);
-        wp.lat = ConfigManager::getFloat(key, 0.0f);
+        float lat = ConfigManager::getFloat(key, 0.0f);
         snprintf(key, 16, "wp_lng_%d", i);
-        wp.lng = ConfigManager::getFloat(key, 0.0f);
+        float lng = ConfigManager::getFloat(key, 0.0f);
         snprintf(key, 16, "wp_alt_%d", i);
-        wp.alt = ConfigManager::getFloat(key, 0.0f);
+        float alt = ConfigManager::getFloat(key, 0.0f);
         snprintf(key, 16, "wp_spd_%d", i);
-        wp.speed = ConfigManager::getInt(key, 1500);
-        _waypoints.push_back(wp);
+        addWaypoint(lat, lng, alt, ConfigManager::getInt(key, WAYPOINT_DEFAULT_SPEED));
+    }
+    return true;
+}
+
+// ============================================================================
+// Bulk Upload
+// ============================================================================
+
+MissionUploadStatus WaypointManager::beginUpload(uint16_t count, uint16_t crc) {
+    if (_uploadReady) return MISSION_UPLOAD_BUSY;
+    if (count > MAX_WAYPOINTS) return MISSION_UPLOAD_TOO_LARGE;
+
+    MemPlacement_free(_staging);
+    _staging = count ? (WaypointRecord*)MemPlacement_alloc(
+                           "mission_staging", count * sizeof(WaypointRecord), MEM_CLASS_BULK)
+                     : nullptr;
+    return MissionUpload_begin(&_upload, _staging, count, count, crc);
+}
+
+MissionUploadStatus WaypointManager::uploadChunk(uint16_t first, const WaypointRecord* records,
+                                                 uint16_t n) {
+    return MissionUpload_add(&_upload, first, records, n);
+}
+
+MissionUploadStatus WaypointManager::finishUpload() {
+    MissionUploadStatus status = MissionUpload_finish(&_upload);
+    if (status != MISSION_UPLOAD_OK) return status;
+
+    // Persisted by update() once the control task has swapped it in
+    _uploadReady = true;
+    return MISSION_UPLOAD_OK;
+}
+
+bool WaypointManager::applyUpload() {
+    if (!_uploadReady) return false;
+
+    for (uint16_t i = 0; i < _upload.expected; i++) {
+        storeRecord(i, _staging[i]);
     }
+    _count = _upload.expected;
+    touch();
+    MemPlacement_free(_staging);
+    _staging = nullptr;
+    _uploadReady = false;
     return true;
 }
 
@@ -2,13 +2,44 @@
 #define WAYPOINT_MANAGER_H
 
 #include <Arduino.h>
-#include <vector>
 #include "NAPacket.h" // For NAWaypoint definitions
 #include "ConfigManager.h"
+#include "MissionUpload.h"
 
-#define MAX_WAYPOINTS 50
-#define WAYPOINT_NVS_KEY "mission_wp"
+/**
+ * Mission storage: fixed capacity, structure of arrays, no heap.
+ * Items (MissionItem.h) have int32 deg * 1e7 coordinates (receiver
+ * precision) and int16 decimetre altitude, 14 bytes each. NVS holds the
+ * same fields as packed WaypointRecord entries; missions saved as
+ * NAWaypoint blobs by older firmware still load as plain waypoints. Only
+ * a bulk upload in progress (and a save / load) holds a temporary record
+ * buffer.
+ *
+ * Every edit is persisted without being asked: update() (comms task, next
+ * to the config write-back) packs a snapshot of the mission once edits
+ * have been quiet for MISSION_PERSIST_DELAY_MS and writes it as one blob,
+ * reporting the outcome as a telemetry event. The control task only ever
+ * swaps an upload in (applyUpload), never touches flash.
+ */
+#define MAX_WAYPOINTS 256
+#define WAYPOINT_NVS_KEY "mission_v3"
+#define WAYPOINT_LEGACY_KEY "mission_wp"    // NAWaypoint blob (<= 50 WPs)
+#define WAYPOINT_V2_KEY "mission_v2"        // Superseded 12-byte records, not loaded
 #define WAYPOINT_COUNT_KEY "mission_cnt"
+#define WAYPOINT_LEGACY_MAX 50
+#define WAYPOINT_DEFAULT_SPEED 1500
+
+// Quiet time after the last edit before the mission is written back
+#define MISSION_PERSIST_DELAY_MS 1000
+
+/**
+ * Outcome of a background mission write
+ */
+struct MissionPersistEvent {
+    bool ok;
+    uint16_t count;     // Items written
+    uint32_t revision;  // Mission revision the blob holds
+};
 
 class WaypointManager {
 public:
@@ -16,17 +47,50 @@ public:
 
     // Mission Management
     bool addWaypoint(float lat, float lng, float alt, uint16_t speed);
-    bool setWaypoint(uint8_t index, const NAWaypoint& wp);
+    bool addWaypointE7(int32_t lat, int32_t lng, float alt, uint16_t speed);
+    bool addItem(const WaypointRecord& item);
+    // Insert before index (<= count); JUMP targets past it move along
+    bool insertItem(uint16_t index, const WaypointRecord& item);
+    bool setWaypoint(uint16_t index, const NAWaypoint& wp);
     bool clearMission();
-    
-    // Mission Retrieval
-    uint8_t getWaypointCount();
-    bool getWaypoint(uint8_t index, NAWaypoint& wp);
-    const std::vector<NAWaypoint>& getMission() { return _waypoints; }
 
-    // Persistence
+    // Mission Retrieval (index < getWaypointCount(), not checked)
+    uint16_t getWaypointCount() { return _count; }
+    int32_t getLatE7(uint16_t index) { return _lat[index]; }
+    int32_t getLngE7(uint16_t index) { return _lng[index]; }
+    float getAlt(uint16_t index) { return _alt[index] * 0.1f; }
+    uint8_t getCommand(uint16_t index) { return _cmd[index]; }
+    uint16_t getParam(uint16_t index) { return _param[index]; } // WAYPOINT: speed
+    bool getWaypoint(uint16_t index, NAWaypoint& wp); // Converted copy
+    MissionView getView();
+    uint32_t getRevision() { return _revision; } // Bumped on every edit
+
+    // Persistence (comms task / boot): saveToNVS() writes now
     bool saveToNVS();
     bool loadFromNVS();
+    bool isPersisted() { return _savedRevision == _revision; }
+    uint16_t getPersistedCrc() { return _savedCrc; } // CRC-16 of the NVS blob
+    // Packed copy of the mission (MAX_WAYPOINTS records), false while an
+    // upload waits for its swap
+    bool copyRecords(WaypointRecord* out, uint16_t* count);
+
+    /**
+     * Write the mission back once edits have settled (comms task)
+     * Waits while an upload is pending its swap, so the control task
+     * never contends with the snapshot.
+     * @param nowMs Current time (millis)
+     * @param event Outcome, valid when true is returned
+     * @return true if a write was attempted
+     */
+    bool update(uint32_t nowMs, MissionPersistEvent* event);
+
+    // Bulk upload: the comms task stages and verifies the whole mission,
+    // the control task swaps it in with applyUpload(), update() persists it
+    MissionUploadStatus beginUpload(uint16_t count, uint16_t crc);
+    MissionUploadStatus uploadChunk(uint16_t first, const WaypointRecord* records, uint16_t n);
+    MissionUploadStatus finishUpload();
+    uint16_t getUploadNext() { return _upload.received; }
+    bool applyUpload(); // true if a new mission was swapped in
 
     // Home Location (Return to Launch)
     void setHome(float lat, float lng);
@@ -35,10 +99,32 @@ public:
 
 private:
     WaypointManager();
-    
-    std::vector<NAWaypoint> _waypoints;
+
+    void store(uint16_t index, int32_t lat, int32_t lng, float alt, uint16_t speed);
+    void storeRecord(uint16_t index, const WaypointRecord& item);
+    void touch();   // After every edit
+    bool loadLegacy();
+    bool saveRecords(const WaypointRecord* records, uint16_t count);
+    void packRecords(WaypointRecord* out);
+
+    int32_t _lat[MAX_WAYPOINTS];
+    int32_t _lng[MAX_WAYPOINTS];
+    int16_t _alt[MAX_WAYPOINTS];
+    uint16_t _param[MAX_WAYPOINTS];
+    uint8_t _cmd[MAX_WAYPOINTS];
+    uint8_t _arg[MAX_WAYPOINTS];
+    uint16_t _count;
+
+    MissionUpload _upload;
+    WaypointRecord* _staging;   // Heap, only while an upload is open / pending
+    volatile bool _uploadReady; // Verified, waiting for applyUpload()
+
     NAWaypoint _home;
     bool _homeSet;
+    uint32_t _revision;
+    uint32_t _savedRevision;    // Revision held by the NVS blob
+    uint16_t _savedCrc;         // Its CRC-16 (set before _savedRevision)
+    uint32_t _editMs;           // Last edit (millis)
 };
 
 #endif // WAYPOINT_MANAGER_H
@@ -0,0 +1,100 @@
+#include "WebAssets.h"
+#include <string.h>
+
+/**
+ * WebAssets - Implementation
+ *
+ * @file WebAssets.cpp
+ */
+
+// ============================================================================
+// Lookup and Caching
+// ============================================================================
+
+const WebAsset* WebAssets_find(const WebAsset* table, uint16_t count, const char* path) {
+    if (!path || path[0] == '\0')
+        return NULL;
+    size_t len = strcspn(path, "?#");
+    if (len == 1 && path[0] == '/') {
+        path = WEB_ASSETS_INDEX;
+        len = strlen(WEB_ASSETS_INDEX);
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        if (strlen(table[i].path) == len && strncmp(table[i].path, path, len) == 0)
+            return &table[i];
+    }
+    return NULL;
+}
+
+bool WebAssets_etagMatches(const char* ifNoneMatch, const char* etag) {
+    if (!ifNoneMatch || !etag || etag[0] == '\0')
+        return false;
+    size_t etagLen = strlen(etag);
+    const char* p = ifNoneMatch;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',')
+            p++;
+        if (*p == '\0')
+            break;
+        if (*p == '*')
+            return true;
+        // Weak comparison: W/"x" matches "x"
+        if (p[0] == 'W' && p[1] == '/')
+            p += 2;
+        size_t len = strcspn(p, ",");
+        while (len > 0 && (p[len - 1] == ' ' || p[len - 1] == '\t'))
+            len--;
+        if (len == etagLen && strncmp(p, etag, len) == 0)
+            return true;
+        p += strcspn(p, ",");
+    }
+    return false;
+}
+
+const char* WebAssets_cacheControl(const WebAsset* asset) {
+    return asset->immutable ? WEB_ASSETS_CACHE_IMMUTABLE : WEB_ASSETS_CACHE_REVALIDATE;
+}
+
+// ============================================================================
+// HTTP Routes
+// ============================================================================
+
+#if defined(__XTENSA__)
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "WebAssetsData.h"      // Generated by tools/embed_web.py
+
+static void send_asset(AsyncWebServerRequest *request, const WebAsset *asset) {
+  AsyncWebServerResponse *response;
+  if (request->hasHeader("If-None-Match") &&
+      WebAssets_etagMatches(request->getHeader("If-None-Match")->value().c_str(), asset->etag)) {
+    response = request->beginResponse(304);
+  } else {
+    // Filled straight from the flash mapping as the TCP window opens
+    response = request->beginResponse_P(200, asset->contentType, asset->data, asset->length);
+    response->addHeader("Content-Encoding", "gzip");
+  }
+  response->addHeader("ETag", asset->etag);
+  response->addHeader("Cache-Control", WebAssets_cacheControl(asset));
+  response->addHeader("Vary", "Accept-Encoding");
+  request->send(response);
+}
+
+bool WebAssets_begin(AsyncWebServer *server) {
+  if (WEB_ASSET_COUNT == 0)
+    return false;
+  for (uint16_t i = 0; i < WEB_ASSET_COUNT; i++) {
+    const WebAsset *asset = &WEB_ASSETS[i];
+    server->on(asset->path, HTTP_GET,
+               [asset](AsyncWebServerRequest *request) { send_asset(request, asset); });
+  }
+  const WebAsset *index = WebAssets_find(WEB_ASSETS, WEB_ASSET_COUNT, "/");
+  if (index) {
+    server->on("/", HTTP_GET,
+               [index](AsyncWebServerRequest *request) { send_asset(request, index); });
+  }
+  Serial.printf("[Web] %u configurator assets at /\n", (unsigned)WEB_ASSET_COUNT);
+  return true;
+}
+
+#endif // __XTENSA__
@@ -0,0 +1,80 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * WebAssets - Web configurator served from flash (port 80)
+ *
+ * tools/embed_web.py gzips the configurator build (web/) at compile time
+ * into const arrays, which the linker leaves in memory-mapped flash. Each
+ * asset gets its own GET route; a response is filled from the array in
+ * TCP-window sized pieces, so there is no file system, no decompression,
+ * no read buffer and no heap that grows with the asset size.
+ *
+ * - Content-Encoding: gzip (every browser that can run the app sends
+ *   Accept-Encoding: gzip)
+ * - Strong ETag per asset; If-None-Match answers 304 with no body
+ * - Cache-Control: bundler-hashed files under /assets/ are immutable for
+ *   a year, index.html is revalidated on each load (304 after the first)
+ * - "/" serves /index.html
+ *
+ * Without a web/ directory at build time nothing is registered.
+ *
+ * @file WebAssets.h
+ */
+
+#define WEB_ASSETS_INDEX            "/index.html"
+#define WEB_ASSETS_CACHE_IMMUTABLE  "public, max-age=31536000, immutable"
+#define WEB_ASSETS_CACHE_REVALIDATE "no-cache"
+
+class AsyncWebServer;
+
+/**
+ * One embedded file (rows generated by tools/embed_web.py)
+ */
+typedef struct {
+    const char* path;           // URL path, "/assets/app.js"
+    const char* contentType;
+    const uint8_t* data;        // Gzipped bytes in flash
+    uint32_t length;
+    const char* etag;           // Quoted, "\"0f668e0cbb3da393\""
+    bool immutable;             // Content-hashed name
+} WebAsset;
+
+// ============================================================================
+// Lookup and Caching (pure)
+// ============================================================================
+
+/**
+ * Asset for a request path ("/" is the index, query string ignored)
+ * @return NULL if not embedded
+ */
+const WebAsset* WebAssets_find(const WebAsset* table, uint16_t count, const char* path);
+
+/**
+ * If-None-Match against an ETag (weak comparison, lists and "*")
+ * @param ifNoneMatch Header value
+ * @param etag        Quoted ETag of the asset
+ * @return true if the client copy is current (answer 304)
+ */
+bool WebAssets_etagMatches(const char* ifNoneMatch, const char* etag);
+
+/**
+ * Cache-Control value of an asset
+ */
+const char* WebAssets_cacheControl(const WebAsset* asset);
+
+// ============================================================================
+// HTTP Routes (target)
+// ============================================================================
+
+/**
+ * Register one GET route per embedded asset (before server->begin())
+ * @return false if no asset was embedded
+ */
+bool WebAssets_begin(AsyncWebServer* server);
+
+#endif // WEB_ASSETS_H
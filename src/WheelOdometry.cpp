@@ -0,0 +1,137 @@
+#include "WheelOdometry.h"
+#include "FastMath.h"
+#include <string.h>
+
+/**
+ * WheelOdometry - Implementation
+ *
+ * @file WheelOdometry.cpp
+ */
+
+FAST_MATH_FLOAT_ONLY
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void buildGains(const OdometryConfig* config, PIDGains* gains) {
+    gains->kp = config->kp;
+    gains->ki = config->ki;
+    gains->kd = 0.0f;
+    gains->kff = config->kff;
+    gains->dCutoffHz = 0.0f;
+    gains->iLimit = 1.0f;
+    gains->outLimit = 1.0f;
+}
+
+// ============================================================================
+// Config
+// ============================================================================
+
+void WheelOdometry_defaultConfig(OdometryConfig* config) {
+    config->speedControl = true;
+    config->countsPerRev = 1440.0f;
+    config->wheelDiameterM = 0.12f;
+    config->trackWidthM = 0.30f;
+    config->maxSpeedMps = 1.5f;
+    config->kp = 0.5f;
+    config->ki = 2.0f;
+    config->kff = 1.0f;
+    config->filterHz = 5.0f;
+}
+
+void WheelOdometry_sanitize(OdometryConfig* config) {
+    config->countsPerRev = clampf(config->countsPerRev, 4.0f, 1.0e6f);
+    config->wheelDiameterM = clampf(config->wheelDiameterM, 0.01f, 2.0f);
+    config->trackWidthM = clampf(config->trackWidthM, 0.05f, 5.0f);
+    config->maxSpeedMps = clampf(config->maxSpeedMps, 0.1f, 20.0f);
+    config->kp = clampf(config->kp, 0.0f, 10.0f);
+    config->ki = clampf(config->ki, 0.0f, 50.0f);
+    config->kff = clampf(config->kff, 0.0f, 2.0f);
+    config->filterHz = clampf(config->filterHz, 0.5f, 25.0f);
+}
+
+void WheelOdometry_init(WheelOdometry* odo, const OdometryConfig* config) {
+    memset(odo, 0, sizeof(*odo));
+    odo->config = *config;
+    buildGains(config, &odo->gains);
+}
+
+void WheelOdometry_setConfig(WheelOdometry* odo, const OdometryConfig* config) {
+    PIDGains next;
+    buildGains(config, &next);
+    for (int w = 0; w < ODOM_WHEELS; w++) {
+        PIDGains gains = odo->gains;
+        PID_setGains(&gains, &odo->pid[w], &next);
+    }
+    odo->gains = next;
+    odo->config = *config;
+}
+
+void WheelOdometry_resetPose(WheelOdometry* odo) {
+    odo->x = 0.0f;
+    odo->y = 0.0f;
+    odo->heading = 0.0f;
+    odo->distance = 0.0f;
+}
+
+// ============================================================================
+// Odometry
+// ============================================================================
+
+void WheelOdometry_update(WheelOdometry* odo, const int32_t counts[ODOM_WHEELS], float dt) {
+    const OdometryConfig* c = &odo->config;
+    if (!odo->primed) {
+        // First reading: nothing to difference against
+        memcpy(odo->lastCounts, counts, sizeof(odo->lastCounts));
+        odo->primed = true;
+        return;
+    }
+    if (dt <= 0.0f) return;
+
+    float metersPerCount = FAST_MATH_PI * c->wheelDiameterM / c->countsPerRev;
+    float travel[ODOM_WHEELS];
+    float rc = 1.0f / (2.0f * FAST_MATH_PI * c->filterHz);
+    float alpha = dt / (rc + dt);
+    for (int w = 0; w < ODOM_WHEELS; w++) {
+        travel[w] = (float)(counts[w] - odo->lastCounts[w]) * metersPerCount;
+        odo->lastCounts[w] = counts[w];
+        odo->wheelSpeed[w] += alpha * (travel[w] / dt - odo->wheelSpeed[w]);
+    }
+
+    float ds = 0.5f * (travel[ODOM_LEFT] + travel[ODOM_RIGHT]);
+    float dth = (travel[ODOM_RIGHT] - travel[ODOM_LEFT]) / c->trackWidthM;
+    odo->speed = ds / dt;
+    odo->yawRate = dth / dt;
+
+    // Advance along the mean heading of the step
+    float s, co;
+    FastMath_sinCos(odo->heading + 0.5f * dth, &s, &co);
+    odo->x += ds * co;
+    odo->y += ds * s;
+    odo->heading = FastMath_wrapPi(odo->heading + dth);
+    odo->distance += ds < 0.0f ? -ds : ds;
+    odo->samples++;
+}
+
+void WheelOdometry_control(WheelOdometry* odo, const float targetMps[ODOM_WHEELS], float dt,
+                           float out[ODOM_WHEELS]) {
+    const OdometryConfig* c = &odo->config;
+    float scale = 1.0f / c->maxSpeedMps;
+    for (int w = 0; w < ODOM_WHEELS; w++) {
+        float target = clampf(targetMps[w], -c->maxSpeedMps, c->maxSpeedMps);
+        if (!c->speedControl) {
+            out[w] = target * scale;
+            continue;
+        }
+        float measured = odo->wheelSpeed[w];
+        bool stopped = target == 0.0f && measured < ODOM_STOP_MPS && measured > -ODOM_STOP_MPS;
+        if (stopped) {
+            PID_reset(&odo->pid[w]);
+            out[w] = 0.0f;
+            continue;
+        }
+        out[w] = PID_update(&odo->gains, &odo->pid[w], target * scale, measured * scale, dt,
+                            true);
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef WHEEL_ODOMETRY_H
+#define WHEEL_ODOMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "PIDController.h"
+
+/**
+ * WheelOdometry - Skid-steer wheel odometry and wheel speed control
+ *
+ * Fed with the raw quadrature counts of the left and right wheel once
+ * per control tick (HAL_EncoderRead):
+ *
+ *   counts -> wheel travel (countsPerRev, wheelDiameter)
+ *          -> body speed v = (dL + dR) / 2 / dt
+ *             yaw rate  w = (dR - dL) / track / dt
+ *          -> pose (x forward / y left at reset, heading CCW), midpoint
+ *             integration
+ *
+ * - Wheel speeds are low-passed (a few counts per tick at walking pace
+ *   is coarse); the pose uses the raw travel, so nothing is lost
+ * - Speed control: a PI per wheel (shared gains, normalized by
+ *   maxSpeed, feed-forward kff) turns a wheel speed target into a motor
+ *   command, so the wheel turns at the asked speed whatever the load,
+ *   slope or battery voltage - instead of a fixed PWM percentage
+ * - A wheel asked to stop that has stopped drops its integrator: no
+ *   creeping against the deadband
+ * - The counts are 32-bit and only differences are used, so the
+ *   counter may start anywhere
+ *
+ * Plain struct, no hardware.
+ *
+ * @file WheelOdometry.h
+ */
+
+#define ODOM_LEFT           0
+#define ODOM_RIGHT          1
+#define ODOM_WHEELS         2
+
+#define ODOM_CONFIG_KEY     "cfg_odom"
+#define ODOM_STOP_MPS       0.02f   // Below this a stopped target is reached
+
+typedef struct {
+    bool speedControl;          // false = targets straight to the motors
+    float countsPerRev;         // Quadrature counts per wheel turn (4 x lines x gear)
+    float wheelDiameterM;
+    float trackWidthM;          // Left to right wheel contact
+    float maxSpeedMps;          // Wheel speed at full command
+    float kp;                   // Motor command per normalized speed error
+    float ki;                   // 1/s
+    float kff;                  // Motor command per normalized target
+    float filterHz;             // Wheel speed low-pass
+} OdometryConfig;
+
+typedef struct {
+    OdometryConfig config;
+    PIDGains gains;
+    PIDState pid[ODOM_WHEELS];
+    bool primed;                // lastCounts valid
+    int32_t lastCounts[ODOM_WHEELS];
+    float wheelSpeed[ODOM_WHEELS];  // m/s, filtered
+    float speed;                // Body forward, m/s (unfiltered)
+    float yawRate;              // rad/s, counter-clockwise
+    float x;                    // m, forward at reset
+    float y;                    // m, left at reset
+    float heading;              // rad, counter-clockwise from reset
+    float distance;             // m travelled (centre, absolute)
+    uint32_t samples;
+} WheelOdometry;
+
+/**
+ * Default: speed control on, 1440 counts per turn (360 lines x4),
+ * 120 mm wheels, 300 mm track, 1.5 m/s at full command, PI 0.5 / 2.0
+ * with FF 1.0, 5 Hz speed filter
+ */
+void WheelOdometry_defaultConfig(OdometryConfig* config);
+
+void WheelOdometry_sanitize(OdometryConfig* config);
+
+void WheelOdometry_init(WheelOdometry* odo, const OdometryConfig* config);
+
+/**
+ * Replace the configuration without a step in the motor commands
+ */
+void WheelOdometry_setConfig(WheelOdometry* odo, const OdometryConfig* config);
+
+/**
+ * Pose back to the origin (speeds and controllers are kept)
+ */
+void WheelOdometry_resetPose(WheelOdometry* odo);
+
+/**
+ * Integrate one tick of encoder counts
+ * @param counts Left / right counts, + = wheel rolling forward
+ * @param dt Tick, s
+ */
+void WheelOdometry_update(WheelOdometry* odo, const int32_t counts[ODOM_WHEELS], float dt);
+
+/**
+ * Wheel speed control step (after update())
+ * @param targetMps Left / right wheel speed targets, m/s
+ * @param dt Tick, s
+ * @param out Motor commands, -1..1
+ */
+void WheelOdometry_control(WheelOdometry* odo, const float targetMps[ODOM_WHEELS], float dt,
+                           float out[ODOM_WHEELS]);
+
+#endif // WHEEL_ODOMETRY_H
@@ -0,0 +1,241 @@
+#include "WifiLink.h"
+#include "HAL.h"
+#include <string.h>
+#include <stdio.h>
+#include <strings.h>
+
+#if defined(ESP_PLATFORM)
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include <esp_now.h>
+#endif
+
+/**
+ * WifiLink - Implementation
+ *
+ * begin() runs in boot, service() / getStatus() in the comms task, so the
+ * state needs no lock; setIdle() (control task) only owns gIdle. Off
+ * target only the configuration helpers do anything.
+ *
+ * @file WifiLink.cpp
+ */
+
+static const char* const MODE_NAMES[WIFI_LINK_MODE_COUNT] = {"espnow", "ap", "sta"};
+
+static WifiLinkConfig gConfig;
+static WifiLinkStatus gStatus;
+static uint8_t gFailures = 0;
+static uint32_t gNextAttemptMs = 0;
+static uint32_t gLastCheckMs = 0;
+static volatile bool gIdle = false;
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+void WifiLink_defaults(WifiLinkConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->mode = WIFI_LINK_ESPNOW;
+    config->channel = WIFI_LINK_DEFAULT_CHANNEL;
+    config->txPower = WIFI_LINK_DEFAULT_TX_POWER;
+    config->lowLatency = 1;
+}
+
+bool WifiLink_sanitize(WifiLinkConfig* config) {
+    config->ssid[WIFI_LINK_SSID_MAX] = '\0';
+    config->pass[WIFI_LINK_PASS_MAX] = '\0';
+    if (config->channel < 1 || config->channel > WIFI_LINK_CHANNEL_MAX)
+        config->channel = WIFI_LINK_DEFAULT_CHANNEL;
+    if (config->txPower < WIFI_LINK_TX_POWER_MIN)
+        config->txPower = WIFI_LINK_TX_POWER_MIN;
+    if (config->txPower > WIFI_LINK_TX_POWER_MAX)
+        config->txPower = WIFI_LINK_TX_POWER_MAX;
+    config->lowLatency = config->lowLatency ? 1 : 0;
+
+    size_t passLen = strlen(config->pass);
+    bool usable = true;
+    if (config->mode >= WIFI_LINK_MODE_COUNT)
+        usable = false;
+    else if (config->mode == WIFI_LINK_AP)
+        usable = passLen >= WIFI_LINK_PASS_MIN;     // Never an open AP in front of /ws and OTA
+    else if (config->mode == WIFI_LINK_STA)
+        usable = config->ssid[0] != '\0' && (passLen == 0 || passLen >= WIFI_LINK_PASS_MIN);
+    if (!usable)
+        config->mode = WIFI_LINK_ESPNOW;
+    return usable;
+}
+
+uint32_t WifiLink_retryDelayMs(uint8_t failures) {
+    uint32_t delay = WIFI_LINK_RETRY_MIN_MS;
+    for (uint8_t i = 0; i < failures && delay < WIFI_LINK_RETRY_MAX_MS; i++)
+        delay *= 2;
+    return delay < WIFI_LINK_RETRY_MAX_MS ? delay : WIFI_LINK_RETRY_MAX_MS;
+}
+
+const char* WifiLink_modeName(WifiLinkMode mode) {
+    return (unsigned)mode < WIFI_LINK_MODE_COUNT ? MODE_NAMES[mode] : "?";
+}
+
+bool WifiLink_parseMode(const char* name, WifiLinkMode* mode) {
+    for (uint8_t i = 0; name && i < WIFI_LINK_MODE_COUNT; i++) {
+        if (strcasecmp(name, MODE_NAMES[i]) == 0) {
+            *mode = (WifiLinkMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+WifiLinkStatus WifiLink_getStatus(void) {
+    return gStatus;
+}
+
+#if defined(ESP_PLATFORM)
+
+// ============================================================================
+// Radio (target)
+// ============================================================================
+
+static uint8_t current_channel(void) {
+    uint8_t primary = 0;
+    wifi_second_chan_t second;
+    if (esp_wifi_get_channel(&primary, &second) != ESP_OK)
+        return 0;
+    return primary;
+}
+
+static void sta_connect(void) {
+    // Fixed channel: the driver scans only it, never hops
+    WiFi.begin(gConfig.ssid, gConfig.pass[0] ? gConfig.pass : nullptr, gConfig.channel);
+}
+
+bool WifiLink_applyPower(const WifiLinkConfig* config) {
+    bool sleep = gIdle || !config->lowLatency;
+    bool ok = esp_wifi_set_ps(sleep ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE) == ESP_OK;
+    ok &= esp_wifi_set_max_tx_power((int8_t)config->txPower) == ESP_OK;
+    gConfig.lowLatency = config->lowLatency;
+    gConfig.txPower = config->txPower;
+    return ok;
+}
+
+bool WifiLink_begin(const WifiLinkConfig* config) {
+    gConfig = *config;
+    memset(&gStatus, 0, sizeof(gStatus));
+    gStatus.mode = (WifiLinkMode)config->mode;
+    gFailures = 0;
+
+    WiFi.persistent(false);         // Nothing from an earlier firmware's NVS
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(config->mode == WIFI_LINK_ESPNOW || config->mode == WIFI_LINK_STA ? WIFI_STA
+                                                                                : WIFI_AP_STA);
+    // One 20 MHz channel: HT40 would spill onto the neighbour channel
+    esp_wifi_set_bandwidth(WIFI_IF_STA, WIFI_BW_HT20);
+
+    if (config->mode == WIFI_LINK_AP) {
+        esp_wifi_set_bandwidth(WIFI_IF_AP, WIFI_BW_HT20);
+        char ssid[WIFI_LINK_SSID_MAX + 1];
+        if (config->ssid[0]) {
+            strcpy(ssid, config->ssid);
+        } else {
+            uint8_t mac[6];
+            WiFi.macAddress(mac);
+            snprintf(ssid, sizeof(ssid), "NA-%02X%02X%02X", mac[3], mac[4], mac[5]);
+        }
+        if (!WiFi.softAP(ssid, config->pass, config->channel, 0, WIFI_LINK_AP_MAX_CLIENTS))
+            return false;
+        gStatus.ip = (uint32_t)WiFi.softAPIP();
+    } else {
+        esp_wifi_set_channel(config->channel, WIFI_SECOND_CHAN_NONE);
+        if (config->mode == WIFI_LINK_STA) {
+            sta_connect();
+            gNextAttemptMs = HAL_GetMillis() + WifiLink_retryDelayMs(0);
+        }
+    }
+    WifiLink_applyPower(config);
+
+    gStatus.channel = current_channel();
+    return gStatus.channel == config->channel;
+}
+
+bool WifiLink_setIdle(bool idle) {
+    if (idle && gStatus.mode == WIFI_LINK_AP)
+        return false;
+    gIdle = idle;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    if (idle) {
+        // Connectionless modem sleep: ESP-NOW is received in these windows
+        esp_wifi_connectionless_module_set_wake_interval(WIFI_LINK_IDLE_INTERVAL_MS);
+        esp_now_set_wake_window(WIFI_LINK_IDLE_WINDOW_MS);
+    }
+#endif
+    return WifiLink_applyPower(&gConfig);
+}
+
+void WifiLink_service(uint32_t nowMs) {
+    if (nowMs - gLastCheckMs < WIFI_LINK_CHECK_MS)
+        return;
+    gLastCheckMs = nowMs;
+
+    if (gStatus.mode == WIFI_LINK_AP) {
+        gStatus.clients = WiFi.softAPgetStationNum();
+    } else if (gStatus.mode == WIFI_LINK_STA) {
+        bool connected = WiFi.status() == WL_CONNECTED;
+        if (connected) {
+            gFailures = 0;
+            gStatus.rssi = (int8_t)WiFi.RSSI();
+            gStatus.ip = (uint32_t)WiFi.localIP();
+        } else {
+            gStatus.ip = 0;
+            if ((int32_t)(nowMs - gNextAttemptMs) >= 0) {
+                sta_connect();
+                gStatus.reconnects++;
+                if (gFailures < 255)
+                    gFailures++;
+                gNextAttemptMs = nowMs + WifiLink_retryDelayMs(gFailures);
+            }
+        }
+        gStatus.connected = connected;
+    }
+
+    // Something moved the radio (scan, stray reconnect): put it back.
+    // A connected STA is on the pinned channel by construction
+    gStatus.channel = current_channel();
+    if (gStatus.channel != gConfig.channel && !gStatus.connected) {
+        if (esp_wifi_set_channel(gConfig.channel, WIFI_SECOND_CHAN_NONE) == ESP_OK) {
+            gStatus.channelFixes++;
+            gStatus.channel = gConfig.channel;
+        }
+    }
+}
+
+#else
+
+bool WifiLink_applyPower(const WifiLinkConfig* config) {
+    gConfig.lowLatency = config->lowLatency;
+    gConfig.txPower = config->txPower;
+    return true;
+}
+
+bool WifiLink_begin(const WifiLinkConfig* config) {
+    gConfig = *config;
+    memset(&gStatus, 0, sizeof(gStatus));
+    gStatus.mode = (WifiLinkMode)config->mode;
+    gStatus.channel = config->channel;
+    gFailures = 0;
+    gNextAttemptMs = 0;
+    gLastCheckMs = 0;
+    return true;
+}
+
+bool WifiLink_setIdle(bool idle) {
+    if (idle && gStatus.mode == WIFI_LINK_AP)
+        return false;
+    gIdle = idle;
+    return true;
+}
+
+void WifiLink_service(uint32_t nowMs) {
+    (void)nowMs;
+}
+
+#endif // ESP_PLATFORM
@@ -0,0 +1,143 @@
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * WifiLink - Wi-Fi mode for ESP-NOW + WebSocket coexistence
+ *
+ * ESP-NOW and Wi-Fi share one radio and one channel. Anything that moves
+ * the channel (a scan, a reconnect hunting for the AP) cuts the control
+ * link, and modem sleep adds up to a DTIM interval of receive latency. So
+ * the channel is fixed and the radio never sleeps by default:
+ *
+ *   ESPNOW  ESP-NOW only, station interface idle on the channel (as before)
+ *   AP      own access point on the same channel; dashboards join it and
+ *           reach /ws at 192.168.4.1. WPA2 only (8-63 character password)
+ *   STA     join an existing network, scanning only the pinned channel;
+ *           auto-reconnect is off and WifiLink_service() retries on that
+ *           channel with backoff, so a lost AP never drags ESP-NOW away
+ *
+ * The controller must use the same channel. Power save is WIFI_PS_NONE
+ * unless lowLatency is cleared (WIFI_PS_MIN_MODEM); TX power is in
+ * 0.25 dBm steps as esp_wifi_set_max_tx_power() takes it. While the
+ * vehicle is parked (PowerPolicy ECO) the radio is in modem sleep and,
+ * on IDF 5, wakes for WIFI_LINK_IDLE_WINDOW_MS every
+ * WIFI_LINK_IDLE_INTERVAL_MS to receive ESP-NOW; the AP never sleeps.
+ *
+ * Stored as a config blob (WIFI_LINK_CONFIG_KEY); mode, channel and
+ * network apply at boot, power save and TX power at once.
+ *
+ * @file WifiLink.h
+ */
+
+#define WIFI_LINK_CONFIG_KEY        "cfg_wifi"
+#define WIFI_LINK_SSID_MAX          32
+#define WIFI_LINK_PASS_MIN          8       // WPA2
+#define WIFI_LINK_PASS_MAX          63
+#define WIFI_LINK_DEFAULT_CHANNEL   1
+#define WIFI_LINK_CHANNEL_MAX       13
+#define WIFI_LINK_TX_POWER_MIN      8       // 2 dBm
+#define WIFI_LINK_TX_POWER_MAX      84      // 21 dBm
+#define WIFI_LINK_DEFAULT_TX_POWER  78      // 19.5 dBm
+#define WIFI_LINK_AP_MAX_CLIENTS    2
+#define WIFI_LINK_RETRY_MIN_MS      1000
+#define WIFI_LINK_RETRY_MAX_MS      30000
+#define WIFI_LINK_CHECK_MS          500     // Channel / connection check period
+#define WIFI_LINK_IDLE_INTERVAL_MS  100     // Parked: ESP-NOW wake interval
+#define WIFI_LINK_IDLE_WINDOW_MS    50      // ... and awake time per interval
+
+typedef enum {
+    WIFI_LINK_ESPNOW = 0,
+    WIFI_LINK_AP,
+    WIFI_LINK_STA,
+    WIFI_LINK_MODE_COUNT
+} WifiLinkMode;
+
+/**
+ * Stored configuration
+ */
+typedef struct {
+    uint8_t mode;               // WifiLinkMode
+    uint8_t channel;            // 1-13, shared by ESP-NOW
+    uint8_t txPower;            // 0.25 dBm
+    uint8_t lowLatency;         // 1 = WIFI_PS_NONE
+    char ssid[WIFI_LINK_SSID_MAX + 1];  // AP: own name ("" = NA-<mac>); STA: network
+    char pass[WIFI_LINK_PASS_MAX + 1];
+} WifiLinkConfig;
+
+/**
+ * Live state
+ */
+typedef struct {
+    WifiLinkMode mode;          // In use (may differ from the stored one)
+    uint8_t channel;            // Radio channel now
+    bool connected;             // STA: associated with the network
+    uint8_t clients;            // AP: stations joined
+    int8_t rssi;                // STA: network RSSI
+    uint32_t reconnects;        // STA: connection attempts after the first
+    uint32_t channelFixes;      // Times the channel was found moved and reset
+    uint32_t ip;                // AP / STA address (network order), 0 = none
+} WifiLinkStatus;
+
+/**
+ * Defaults: ESP-NOW only, channel 1, 19.5 dBm, no power save
+ */
+void WifiLink_defaults(WifiLinkConfig* config);
+
+/**
+ * Clamp channel / power and terminate strings
+ * @return false if the mode cannot run (AP without a WPA2 password, STA
+ *         without a network); the mode is then set to ESPNOW
+ */
+bool WifiLink_sanitize(WifiLinkConfig* config);
+
+/**
+ * STA reconnect delay: doubles per failed attempt, capped
+ * @param failures Attempts since the last connection
+ */
+uint32_t WifiLink_retryDelayMs(uint8_t failures);
+
+/**
+ * Mode name ("espnow", "ap", "sta")
+ */
+const char* WifiLink_modeName(WifiLinkMode mode);
+
+/**
+ * Parse a mode name
+ * @return false if unknown
+ */
+bool WifiLink_parseMode(const char* name, WifiLinkMode* mode);
+
+/**
+ * Bring Wi-Fi up in the configured mode (before esp_now_init)
+ * @param config Sanitized configuration
+ * @return true if the radio is on the configured channel
+ */
+bool WifiLink_begin(const WifiLinkConfig* config);
+
+/**
+ * Apply power save and TX power now (safe while running)
+ */
+bool WifiLink_applyPower(const WifiLinkConfig* config);
+
+/**
+ * Enter / leave parked power save (modem sleep with ESP-NOW wake windows);
+ * leaving restores the configured power save
+ * @return false if the driver refused, or the AP is up (no sleep)
+ */
+bool WifiLink_setIdle(bool idle);
+
+/**
+ * Keep the channel pinned and the STA connection up (background task)
+ * @param nowMs Current time (millis)
+ */
+void WifiLink_service(uint32_t nowMs);
+
+/**
+ * Copy the live state
+ */
+WifiLinkStatus WifiLink_getStatus(void);
+
+#endif // WIFI_LINK_H
@@ -0,0 +1,366 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <string.h>
+#include "Benchmark.h"
+#include "BiquadFilter.h"
+#include "Crc16.h"
+#include "DspKernels.h"
+#include "DynamicNotch.h"
+#include "EncryptionManager.h"
+#include "HMACValidator.h"
+#include "JsonArena.h"
+#include "JsonTemplate.h"
+#include "MotorMixer.h"
+#include "NAPacket.h"
+#include "NavFrame.h"
+#include "TelemetryDelta.h"
+
+/**
+ * Hot-path microbenchmarks (env:bench)
+ *
+ * Replaces main.cpp in the bench build: no radio, tasks or vehicle, just
+ * the functions the control and comms paths run per frame, each timed
+ * BENCH_ITERATIONS times by Benchmark on the Arduino loop task (core 1).
+ * One JSON line per case, between a start and a done line:
+ *
+ *   pio run -e bench -t upload && pio device monitor -e bench
+ *
+ * Send any line over serial to run the suite again.
+ *
+ * The dsp_* cases run DspKernels next to an inline scalar loop doing the
+ * same work, so one run on each target (env:bench, env:bench_s3) shows
+ * both what esp-dsp buys on the S3 and how the two chips compare.
+ *
+ * The gyro_filter_* cases run one FIFO burst (IMU_BURST_MAX frames of
+ * x y z) through the gyro chain's worst case, a 4th order low-pass plus
+ * a notch: cycles per sample is cycles / 30. dyn_notch_analyze is one
+ * window of the dynamic notch tracker (window, 128-point FFT, peak fit),
+ * run by the noise task every 64 samples.
+ *
+ * @file bench_main.cpp
+ */
+
+#define BENCH_ITERATIONS 1000
+
+// ============================================================================
+// Fixtures
+// ============================================================================
+
+static const uint8_t BENCH_KEY[AES_256_KEY_SIZE] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa,
+    0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x0f, 0x1e, 0x2d, 0x3c, 0x4b, 0x5a,
+    0x69, 0x78, 0x87, 0x96, 0xa5, 0xb4, 0xc3, 0xd2, 0xe1, 0xf0};
+
+static NAPacket packet;
+static NATelemetry telemetry;
+static uint8_t iv[16];
+static uint8_t scratch[128];
+static uint8_t sector[4096]; // Blackbox sector payload
+static NavFrame frame;
+static MotorMixer<MixerFrameQuadX, int16_t> mixer{-1.0f, 1.0f};
+static JsonTemplate telemetryLine;
+static TelemetryDeltaEncoder deltaEncoder;
+
+#define DSP_BLOCK 64
+#define DSP_MAT 8
+alignas(DSP_ALIGN) static float dspA[DSP_MAT * DSP_MAT];
+alignas(DSP_ALIGN) static float dspB[DSP_MAT * DSP_MAT];
+alignas(DSP_ALIGN) static float dspC[DSP_MAT * DSP_MAT];
+alignas(DSP_ALIGN) static float dspSignal[DSP_BLOCK];
+alignas(DSP_ALIGN) static float dspOut[DSP_BLOCK];
+static float dspCoef[DSP_BIQUAD_COEFS];
+static float dspState[2];
+
+#define GYRO_BURST 10           // IMU_BURST_MAX
+static BiquadCascade gyroFilter;
+static BiquadCascadeQ gyroFilterQ;
+static float gyroBurst[GYRO_BURST * 3];
+static int32_t gyroBurstQ[GYRO_BURST * 3];
+static DynamicNotch dynNotch;
+
+alignas(JSON_ARENA_ALIGN) static uint8_t arenaBuffer[1024];
+static JsonArena arena(arenaBuffer, sizeof(arenaBuffer));
+
+// Results land here so the compiler cannot drop the calls
+static volatile uint32_t sink;
+
+static void setupFixtures() {
+  memset(&packet, 0, sizeof(packet));
+  packet.protocolVersion = PROTOCOL_VERSION;
+  packet.sequenceNumber = 1234;
+  packet.throttle = 1500;
+  NA_UPDATE_PACKET_CHECKSUM(&packet);
+
+  memset(&telemetry, 0, sizeof(telemetry));
+  telemetry.protocolVersion = PROTOCOL_VERSION;
+  telemetry.batteryVoltage = 11870;
+  telemetry.rssi = -62;
+  telemetry.latitude = 137563000;
+  telemetry.longitude = 1005018000;
+  NA_UPDATE_TELEMETRY_CHECKSUM(&telemetry);
+
+  EncryptionManager_init(BENCH_KEY);
+  HMACValidator_init(BENCH_KEY);
+  EncryptionManager_generateIV(iv);
+  HMACValidator_generate((uint8_t *)&packet.throttle, 10, packet.hmac);
+
+  NavFrame_init(&frame, 137563000, 1005018000);
+  JsonTemplate_init(&telemetryLine,
+                    "{\"t\":2,\"v\":##.###,\"r\":###,\"heap\":###}\r\n");
+  TelemetryDelta_initEncoder(&deltaEncoder);
+  for (size_t i = 0; i < sizeof(sector); i++)
+    sector[i] = (uint8_t)(i * 131 + 7);
+
+  for (int i = 0; i < DSP_MAT * DSP_MAT; i++) {
+    dspA[i] = 0.01f * (float)(i % 13) - 0.05f;
+    dspB[i] = 0.02f * (float)(i % 7) + 0.1f;
+  }
+  for (int i = 0; i < DSP_BLOCK; i++)
+    dspSignal[i] = (float)((i * 37) % 17) - 8.0f;
+  Dsp_biquadLowpass(dspCoef, 0.05f, 0.7071f);
+
+  BiquadChainConfig chain = {90.0f, 2, 180.0f, 5.0f};
+  BiquadChain_build(&gyroFilter, &chain, 1000.0f, 3);
+  BiquadCascadeQ_init(&gyroFilterQ, 3);
+  for (uint8_t i = 0; i < gyroFilter.stages; i++)
+    BiquadCascadeQ_addStage(&gyroFilterQ, &gyroFilter.coefs[i]);
+  for (int i = 0; i < GYRO_BURST * 3; i++) {
+    gyroBurstQ[i] = (i * 2731) % 8000 - 4000;   // Raw counts
+    gyroBurst[i] = (float)gyroBurstQ[i] / 65.5f; // deg/s
+  }
+  DynNotchConfig notch;
+  DynamicNotch_defaultConfig(&notch);
+  DynamicNotch_init(&dynNotch, &notch, 1000.0f);
+  for (int i = 0; i < DYN_NOTCH_FFT_SIZE; i++) {
+    float rates[3] = {dspSignal[i % DSP_BLOCK], dspSignal[(i * 3) % DSP_BLOCK], 0.0f};
+    DynamicNotch_push(&dynNotch, rates);
+  }
+}
+
+// ============================================================================
+// Cases
+// ============================================================================
+
+static void benchEmpty(void *ctx) { (void)ctx; }
+
+static void benchCrc16(void *ctx) {
+  (void)ctx;
+  sink = NA_CRC16((const uint8_t *)&packet, sizeof(packet) - 2);
+}
+
+static void benchCrc16Fast(void *ctx) {
+  (void)ctx;
+  sink = Crc16_compute((const uint8_t *)&packet, sizeof(packet) - 2);
+}
+
+static void benchCrc16Sector(void *ctx) {
+  (void)ctx;
+  sink = NA_CRC16(sector, sizeof(sector));
+}
+
+static void benchCrc16SectorFast(void *ctx) {
+  (void)ctx;
+  sink = Crc16_compute(sector, sizeof(sector));
+}
+
+// Control payload as processControlPacket() decrypts it (throttle..buttons)
+static void benchEncrypt(void *ctx) {
+  (void)ctx;
+  sink = EncryptionManager_encrypt((const uint8_t *)&packet.throttle, 10, iv,
+                                   scratch);
+}
+
+static void benchHmacValidate(void *ctx) {
+  (void)ctx;
+  sink = HMACValidator_validate((const uint8_t *)&packet.throttle, 10,
+                                packet.hmac);
+}
+
+// Distance / bearing to a waypoint, as the navigation tick does
+static void benchNavDistance(void *ctx) {
+  (void)ctx;
+  NavVector here = NavFrame_toLocal(&frame, 137571000, 1005027000);
+  NavVector target = NavFrame_toLocal(&frame, 137602000, 1005049000);
+  float d = NavFrame_distance(here, target) + NavFrame_bearing(here, target);
+  sink = (uint32_t)(d * 1000.0f);
+}
+
+static void benchMixQuadX(void *ctx) {
+  (void)ctx;
+  float in[MIXER_AXIS_COUNT] = {0.12f, -0.08f, 0.05f, 0.55f, 0.0f, 0.0f};
+  int16_t out[MixerFrameQuadX::kOutputs];
+  mixer.mix(in, out);
+  sink = out[0] + out[3];
+}
+
+// Covariance propagation size (PositionEstimator, 7 states)
+static void benchDspMatMul7(void *ctx) {
+  (void)ctx;
+  Dsp_matMul(dspA, dspB, dspC, 7, 7, 7);
+  sink = (uint32_t)dspC[0];
+}
+
+static void benchDspMatMul8(void *ctx) {
+  (void)ctx;
+  Dsp_matMul(dspA, dspB, dspC, DSP_MAT, DSP_MAT, DSP_MAT);
+  sink = (uint32_t)dspC[0];
+}
+
+static void benchScalarMatMul8(void *ctx) {
+  (void)ctx;
+  for (int i = 0; i < DSP_MAT; i++) {
+    for (int j = 0; j < DSP_MAT; j++) {
+      float sum = 0.0f;
+      for (int k = 0; k < DSP_MAT; k++)
+        sum += dspA[i * DSP_MAT + k] * dspB[k * DSP_MAT + j];
+      dspC[i * DSP_MAT + j] = sum;
+    }
+  }
+  sink = (uint32_t)dspC[0];
+}
+
+static void benchDspDot(void *ctx) {
+  (void)ctx;
+  sink = (uint32_t)Dsp_dot(dspSignal, dspSignal, DSP_BLOCK);
+}
+
+static void benchScalarDot(void *ctx) {
+  (void)ctx;
+  float sum = 0.0f;
+  for (int i = 0; i < DSP_BLOCK; i++)
+    sum += dspSignal[i] * dspSignal[i];
+  sink = (uint32_t)sum;
+}
+
+static void benchDspBiquad(void *ctx) {
+  (void)ctx;
+  Dsp_biquad(dspSignal, dspOut, DSP_BLOCK, dspCoef, dspState);
+  sink = (uint32_t)dspOut[DSP_BLOCK - 1];
+}
+
+static void benchScalarBiquad(void *ctx) {
+  (void)ctx;
+  for (int i = 0; i < DSP_BLOCK; i++) {
+    float d0 = dspSignal[i] - dspCoef[3] * dspState[0] - dspCoef[4] * dspState[1];
+    dspOut[i] = dspCoef[0] * d0 + dspCoef[1] * dspState[0] + dspCoef[2] * dspState[1];
+    dspState[1] = dspState[0];
+    dspState[0] = d0;
+  }
+  sink = (uint32_t)dspOut[DSP_BLOCK - 1];
+}
+
+// Filtered in place: each call continues the same stream
+static void benchGyroFilter(void *ctx) {
+  (void)ctx;
+  BiquadCascade_applyBlock(&gyroFilter, gyroBurst, GYRO_BURST);
+  sink = (uint32_t)gyroBurst[0];
+}
+
+static void benchGyroFilterQ(void *ctx) {
+  (void)ctx;
+  BiquadCascadeQ_applyBlock(&gyroFilterQ, gyroBurstQ, GYRO_BURST);
+  sink = (uint32_t)gyroBurstQ[0];
+}
+
+static void benchDynNotch(void *ctx) {
+  (void)ctx;
+  DynamicNotch_analyze(&dynNotch);
+  sink = (uint32_t)dynNotch.centerHz;
+}
+
+// Telemetry as an ArduinoJson document (what the template replaced)
+static void benchTelemetryJson(void *ctx) {
+  (void)ctx;
+  JsonArenaScope scope(arena);
+  JsonDocument doc(&arena);
+  doc["t"] = 2;
+  doc["v"] = telemetry.batteryVoltage / 1000.0f;
+  doc["r"] = telemetry.rssi;
+  doc["heap"] = 42;
+  doc["lat"] = telemetry.latitude;
+  doc["lng"] = telemetry.longitude;
+  sink = serializeJson(doc, (char *)scratch, sizeof(scratch));
+}
+
+static void benchTelemetryTemplate(void *ctx) {
+  (void)ctx;
+  JsonTemplate_setInt(&telemetryLine, 0, telemetry.batteryVoltage);
+  JsonTemplate_setInt(&telemetryLine, 1, 87);
+  JsonTemplate_setInt(&telemetryLine, 2, 42);
+  sink = telemetryLine.len;
+}
+
+// Mostly deltas: one keyframe per TELEMETRY_DELTA_KEYFRAME_INTERVAL calls
+static void benchTelemetryDelta(void *ctx) {
+  (void)ctx;
+  telemetry.uptime += 50;
+  sink = TelemetryDelta_encode(&deltaEncoder, &telemetry, scratch,
+                               sizeof(scratch), NULL);
+}
+
+typedef struct {
+  const char *name;
+  BenchFn fn;
+} BenchCase;
+
+static const BenchCase CASES[] = {
+    {"empty", benchEmpty},
+    {"crc16_packet", benchCrc16},
+    {"crc16_fast_packet", benchCrc16Fast},
+    {"crc16_sector", benchCrc16Sector},
+    {"crc16_fast_sector", benchCrc16SectorFast},
+    {"aes_ctr_encrypt", benchEncrypt},
+    {"hmac_validate", benchHmacValidate},
+    {"nav_distance", benchNavDistance},
+    {"mix_quadx", benchMixQuadX},
+    {"dsp_matmul_7x7", benchDspMatMul7},
+    {"dsp_matmul_8x8", benchDspMatMul8},
+    {"scalar_matmul_8x8", benchScalarMatMul8},
+    {"dsp_dot_64", benchDspDot},
+    {"scalar_dot_64", benchScalarDot},
+    {"dsp_biquad_64", benchDspBiquad},
+    {"scalar_biquad_64", benchScalarBiquad},
+    {"gyro_filter_burst", benchGyroFilter},
+    {"gyro_filter_q28_burst", benchGyroFilterQ},
+    {"dyn_notch_analyze", benchDynNotch},
+    {"telemetry_json", benchTelemetryJson},
+    {"telemetry_template", benchTelemetryTemplate},
+    {"telemetry_delta", benchTelemetryDelta},
+};
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+static void runSuite() {
+  uint32_t mhz = getCpuFrequencyMhz();
+  Serial.printf("{\"bench_start\":true,\"chip\":\"%s\",\"mhz\":%lu,\"iterations\":%d,"
+                "\"crc16\":\"%s\",\"dsp\":\"%s\"}\n",
+                ESP.getChipModel(), (unsigned long)mhz, BENCH_ITERATIONS, Crc16_implName(),
+                Dsp_implName());
+  char line[160];
+  for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+    BenchStats stats;
+    if (!Bench_run(CASES[i].fn, NULL, BENCH_ITERATIONS, &stats))
+      continue;
+    if (Bench_formatJson(CASES[i].name, &stats, mhz, line, sizeof(line)))
+      Serial.println(line);
+  }
+  Serial.println("{\"bench_done\":true}");
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000); // Let the monitor attach
+  setupFixtures();
+  runSuite();
+}
+
+void loop() {
+  if (Serial.available()) {
+    while (Serial.available())
+      Serial.read();
+    runSuite();
+  }
+  delay(10);
+}
@@ -0,0 +1,86 @@
+#include "DShot.h"
+
+/**
+ * DShot - Implementation
+ *
+ * @file DShot.cpp
+ */
+
+// ============================================================================
+// Frame Encoding
+// ============================================================================
+
+void DShot_timing(DShotRate rate, DShotTiming* timing) {
+    uint32_t bitTicks = DSHOT_TICK_HZ / ((uint32_t)rate * 1000UL);
+    timing->bitTicks = (uint16_t)bitTicks;
+    timing->oneHighTicks = (uint16_t)(bitTicks * 3 / 4);
+    timing->zeroHighTicks = (uint16_t)(bitTicks * 3 / 8);
+    timing->telemetryBitTicks = (uint16_t)(bitTicks * 4 / 5);
+}
+
+uint16_t DShot_throttleValue(int16_t speed) {
+    if (speed <= 0) return 0;
+    if (speed > 100) speed = 100;
+    return DSHOT_THROTTLE_MIN +
+           (uint16_t)(((uint32_t)speed * (DSHOT_THROTTLE_MAX - DSHOT_THROTTLE_MIN)) / 100);
+}
+
+uint16_t DShot_encodeFrame(uint16_t value, bool telemetry, bool bidirectional) {
+    uint16_t packet = (uint16_t)(((value & 0x07FF) << 1) | (telemetry ? 1 : 0));
+    uint16_t crc = packet ^ (packet >> 4) ^ (packet >> 8);
+    if (bidirectional) crc = ~crc;
+    return (uint16_t)((packet << 4) | (crc & 0x0F));
+}
+
+// ============================================================================
+// Telemetry Decoding
+// ============================================================================
+
+// 5-bit GCR code -> nibble, 0xFF = invalid code
+static const uint8_t GCR_DECODE[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x09, 0x0A, 0x0B, 0xFF, 0x0D, 0x0E, 0x0F,
+    0xFF, 0xFF, 0x02, 0x03, 0xFF, 0x05, 0x06, 0x07,
+    0xFF, 0x00, 0x08, 0x01, 0xFF, 0x04, 0x0C, 0xFF,
+};
+
+uint32_t DShot_collectBits(const DShotRun* runs, uint8_t count, uint16_t telemetryBitTicks) {
+    uint32_t raw = 0;
+    uint8_t bits = 0;
+    for (uint8_t i = 0; i < count && bits < DSHOT_TELEMETRY_BITS; i++) {
+        // Round the run to whole bits (at least one)
+        uint8_t n = (uint8_t)((runs[i].ticks + telemetryBitTicks / 2) / telemetryBitTicks);
+        if (n == 0) n = 1;
+        while (n-- && bits < DSHOT_TELEMETRY_BITS) {
+            raw = (raw << 1) | (runs[i].level ? 1 : 0);
+            bits++;
+        }
+    }
+    // Line returns to idle (high) after the last edge
+    while (bits < DSHOT_TELEMETRY_BITS) {
+        raw = (raw << 1) | 1;
+        bits++;
+    }
+    return raw;
+}
+
+bool DShot_decodeERPM(uint32_t raw, uint32_t* erpm) {
+    // Transition coded: a 1 is a level change from the previous bit
+    uint32_t gcr = (raw ^ (raw >> 1)) & 0xFFFFF;
+
+    uint16_t data = 0;
+    for (int8_t shift = 15; shift >= 0; shift -= 5) {
+        uint8_t nibble = GCR_DECODE[(gcr >> shift) & 0x1F];
+        if (nibble == 0xFF) return false;
+        data = (uint16_t)((data << 4) | nibble);
+    }
+
+    uint16_t csum = data ^ (data >> 4) ^ (data >> 8) ^ (data >> 12);
+    if ((csum & 0x0F) != 0x0F) return false;
+
+    uint16_t value = data >> 4;
+    uint32_t periodUs = (uint32_t)(value & 0x01FF) << (value >> 9);
+    // Longest encodable period means the motor is stopped
+    *erpm = (periodUs == 0 || value == 0x0FFF) ? 0 : 60000000UL / periodUs;
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef DSHOT_H
+#define DSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * DShot - Digital ESC frame encoding and bidirectional telemetry decoding
+ *
+ * Frame (16 bits, MSB first):
+ *   [11-bit value][telemetry request][4-bit CRC]
+ *   value 0 = stop, 1-47 = commands, 48-2047 = throttle
+ *   CRC = XOR of the three nibbles above it (inverted for bidirectional)
+ *
+ * Bits are pulse-width coded: a bit period of 1 / rate, high for 3/4
+ * of it for a 1 and 3/8 for a 0. Bidirectional DShot inverts the line
+ * (idles high) and the ESC answers ~30 us after each frame with its
+ * motor period: 21 bits at 5/4 of the frame bitrate, transition coded,
+ * GCR 5b/4b over [12-bit e-period][4-bit CRC], e-period = m << e with
+ * a 3-bit exponent and 9-bit mantissa in microseconds.
+ *
+ * Pure functions only (no hardware); DShotESC drives the RMT with them.
+ *
+ * @file DShot.h
+ */
+
+#define DSHOT_THROTTLE_MIN      48
+#define DSHOT_THROTTLE_MAX      2047
+#define DSHOT_FRAME_BITS        16
+#define DSHOT_TELEMETRY_BITS    21
+#define DSHOT_TICK_HZ           80000000UL  // RMT clock at clk_div 1
+
+typedef enum {
+    DSHOT150 = 150,
+    DSHOT300 = 300,
+    DSHOT600 = 600,
+} DShotRate;
+
+/**
+ * Bit timing in RMT ticks
+ */
+typedef struct {
+    uint16_t bitTicks;
+    uint16_t oneHighTicks;
+    uint16_t zeroHighTicks;
+    uint16_t telemetryBitTicks;     // Reply bit, 5/4 of the frame bitrate
+} DShotTiming;
+
+/**
+ * One level run of a captured reply
+ */
+typedef struct {
+    uint8_t level;
+    uint16_t ticks;
+} DShotRun;
+
+/**
+ * Compute bit timing for a rate
+ */
+void DShot_timing(DShotRate rate, DShotTiming* timing);
+
+/**
+ * Map a Motor speed (0 to 100, <= 0 stops) onto the DShot throttle range
+ */
+uint16_t DShot_throttleValue(int16_t speed);
+
+/**
+ * Build a 16-bit frame
+ * @param value 0-2047 (see above)
+ * @param telemetry Request telemetry on the ESC's serial wire
+ * @param bidirectional Inverted CRC, ESC replies with eRPM on the signal line
+ */
+uint16_t DShot_encodeFrame(uint16_t value, bool telemetry, bool bidirectional);
+
+/**
+ * Turn captured level runs into the 21-bit reply (MSB = first bit)
+ * Runs past 21 bits are ignored, missing bits are idle (1).
+ */
+uint32_t DShot_collectBits(const DShotRun* runs, uint8_t count, uint16_t telemetryBitTicks);
+
+/**
+ * Decode a 21-bit reply
+ * @param raw Bits from DShot_collectBits
+ * @param erpm Electrical RPM (0 when the motor is stopped)
+ * @return false on GCR or CRC error
+ */
+bool DShot_decodeERPM(uint32_t raw, uint32_t* erpm);
+
+#endif // DSHOT_H
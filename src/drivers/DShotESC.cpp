@@ -0,0 +1,164 @@
+#include "DShotESC.h"
+#include <driver/gpio.h>
+#include <soc/soc_caps.h>
+
+#define DSHOT_RX_FILTER_TICKS   40      // 0.5 us glitch filter
+#define DSHOT_RX_IDLE_BITS      4       // GCR never holds a level longer than 3 bits
+#define DSHOT_RX_BUFFER_SIZE    512
+
+// ESP32: any of the 8 RMT channels does TX or RX, a bidirectional ESC
+// takes two in a row. ESP32-S3: 0-3 are TX only and 4-7 RX only, so the
+// ESC on TX channel n listens on n + 4.
+#if SOC_RMT_TX_CANDIDATES_PER_GROUP < SOC_RMT_CHANNELS_PER_GROUP
+#define DSHOT_TX_CHANNELS       SOC_RMT_TX_CANDIDATES_PER_GROUP
+#define DSHOT_RX_OFFSET         SOC_RMT_TX_CANDIDATES_PER_GROUP
+#define DSHOT_RX_SHARES_TX      0
+#else
+#define DSHOT_TX_CHANNELS       RMT_CHANNEL_MAX
+#define DSHOT_RX_OFFSET         1
+#define DSHOT_RX_SHARES_TX      1
+#endif
+
+uint8_t DShotESC::nextChannel = 0;
+
+DShotESC::DShotESC(int pin, DShotRate rate, bool bidirectional)
+    : _pin(pin), _bidirectional(bidirectional), _txChannel(-1), _rxChannel(-1),
+      _frame(0xFFFF),  // Needs the telemetry bit, so never the first frame (speed 0)
+      lastSpeed(0), _rxBuffer(nullptr), _erpm(0), _erpmCount(0), _requestTelemetry(false),
+      _telemetryErrors(0) {
+    DShot_timing(rate, &_timing);
+    memset(_items, 0, sizeof(_items));
+}
+
+bool DShotESC::setup() {
+    if (_pin < 0) return false;     // Not fitted
+    uint8_t needed = (_bidirectional && DSHOT_RX_SHARES_TX) ? 2 : 1;
+    if (nextChannel + needed > DSHOT_TX_CHANNELS) {
+        Serial.printf("[DSHOT] No RMT channel for GPIO %d\n", _pin);
+        return false;
+    }
+
+    // RX first: its pin setup turns the output off, TX turns it back on
+    if (_bidirectional) {
+        rmt_channel_t rx = (rmt_channel_t)(nextChannel + DSHOT_RX_OFFSET);
+        rmt_config_t rxConfig = RMT_DEFAULT_CONFIG_RX((gpio_num_t)_pin, rx);
+        rxConfig.clk_div = 1;
+        rxConfig.rx_config.filter_en = true;
+        rxConfig.rx_config.filter_ticks_thresh = DSHOT_RX_FILTER_TICKS;
+        rxConfig.rx_config.idle_threshold = _timing.telemetryBitTicks * DSHOT_RX_IDLE_BITS;
+        if (rmt_config(&rxConfig) != ESP_OK ||
+            rmt_driver_install(rx, DSHOT_RX_BUFFER_SIZE, 0) != ESP_OK ||
+            rmt_get_ringbuf_handle(rx, &_rxBuffer) != ESP_OK) {
+            Serial.printf("[DSHOT] RMT RX setup failed on GPIO %d\n", _pin);
+            return false;
+        }
+        _rxChannel = (int8_t)rx;
+    }
+
+    rmt_channel_t tx = (rmt_channel_t)nextChannel;
+    rmt_config_t txConfig = RMT_DEFAULT_CONFIG_TX((gpio_num_t)_pin, tx);
+    txConfig.clk_div = 1;
+    txConfig.tx_config.idle_output_en = true;
+    txConfig.tx_config.idle_level = _bidirectional ? RMT_IDLE_LEVEL_HIGH : RMT_IDLE_LEVEL_LOW;
+    if (rmt_config(&txConfig) != ESP_OK || rmt_driver_install(tx, 0, 0) != ESP_OK) {
+        Serial.printf("[DSHOT] RMT TX setup failed on GPIO %d\n", _pin);
+        return false;
+    }
+    _txChannel = (int8_t)tx;
+    nextChannel += needed;
+
+    if (_bidirectional) {
+        // Shared wire: open drain so the ESC can pull the idle-high line low
+        gpio_set_direction((gpio_num_t)_pin, GPIO_MODE_INPUT_OUTPUT_OD);
+        gpio_pullup_en((gpio_num_t)_pin);
+        rmt_rx_start((rmt_channel_t)_rxChannel, true);
+    }
+
+    prepare(0);
+    transmit();
+    return true;
+}
+
+void DShotESC::prepare(int16_t speed) {
+    if (speed < 0) speed = 0;
+    if (speed > 100) speed = 100;
+    lastSpeed = speed;
+
+    uint16_t frame =
+        DShot_encodeFrame(DShot_throttleValue(speed), _requestTelemetry, _bidirectional);
+    _requestTelemetry = false;
+    if (frame == _frame) return;
+    _frame = frame;
+
+    // Bidirectional is inverted: low pulses on an idle-high line
+    uint32_t pulse = _bidirectional ? 0 : 1;
+    for (uint8_t i = 0; i < DSHOT_FRAME_BITS; i++) {
+        uint16_t high = (frame & (0x8000 >> i)) ? _timing.oneHighTicks : _timing.zeroHighTicks;
+        _items[i].duration0 = high;
+        _items[i].level0 = pulse;
+        _items[i].duration1 = _timing.bitTicks - high;
+        _items[i].level1 = !pulse;
+    }
+}
+
+void DShotESC::transmit() {
+    if (_txChannel < 0) return;
+    rmt_write_items((rmt_channel_t)_txChannel, _items, DSHOT_FRAME_BITS, false);
+}
+
+void DShotESC::readTelemetry() {
+    if (!_rxBuffer) return;
+
+    size_t size = 0;
+    rmt_item32_t* items;
+    while ((items = (rmt_item32_t*)xRingbufferReceive(_rxBuffer, &size, 0)) != nullptr) {
+        DShotRun runs[DSHOT_TELEMETRY_BITS];
+        uint8_t count = 0;
+        bool overflow = false;
+        for (size_t i = 0; i < size / sizeof(rmt_item32_t) && !overflow; i++) {
+            const uint16_t ticks[2] = {(uint16_t)items[i].duration0, (uint16_t)items[i].duration1};
+            const uint8_t levels[2] = {(uint8_t)items[i].level0, (uint8_t)items[i].level1};
+            for (uint8_t h = 0; h < 2; h++) {
+                if (ticks[h] == 0) break;   // Idle: end of capture
+                if (count == DSHOT_TELEMETRY_BITS) {
+                    overflow = true;
+                    break;
+                }
+                runs[count].level = levels[h];
+                runs[count].ticks = ticks[h];
+                count++;
+            }
+        }
+        vRingbufferReturnItem(_rxBuffer, items);
+
+        // More runs than reply bits: our own frame read back on the pin
+        if (overflow || count == 0) continue;
+
+        uint32_t erpm;
+        uint32_t raw = DShot_collectBits(runs, count, _timing.telemetryBitTicks);
+        if (DShot_decodeERPM(raw, &erpm)) {
+            _erpm = erpm;
+            _erpmCount++;
+        } else {
+            _telemetryErrors++;
+        }
+    }
+}
+
+void DShotESC::setSpeed(int16_t speed, float dt) {
+    readTelemetry();
+    prepare(speed);
+    transmit();
+}
+
+void DShotESC::setSpeeds(DShotESC* const* escs, const int16_t* speeds, uint8_t count, float dt) {
+    // Everything that isn't the RMT start goes first, so frames go out together
+    for (uint8_t i = 0; i < count; i++) {
+        if (!escs[i]) continue;
+        escs[i]->readTelemetry();
+        escs[i]->prepare(speeds[i]);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (escs[i]) escs[i]->transmit();
+    }
+}
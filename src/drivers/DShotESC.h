@@ -0,0 +1,122 @@
+#ifndef DSHOT_ESC_H
+#define DSHOT_ESC_H
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include "DShot.h"
+#include "../PinMap.h"
+
+/**
+ * DShotESC - Brushless ESC on DShot150/300/600, driven by the RMT
+ *
+ * Same calling interface as Motor (setup / setSpeed / setSpeeds /
+ * getCurrentSpeed), so a vehicle can switch output type at build time.
+ * Speed is 0 to 100 (negative stops: no 3D mode); no deadband or
+ * ramping, the ESC and the rate loop handle that.
+ *
+ * - Timing is fixed per rate, so each ESC keeps its 16 RMT items and
+ *   only rewrites their durations when the value changes
+ * - setSpeeds() builds every frame first, then starts all channels back
+ *   to back (the ESP32 RMT has no DMA or TX sync; the frames land
+ *   within a few microseconds of each other)
+ * - Bidirectional: a second RMT channel captures the ESC's reply on the
+ *   same pin; getERPM() returns the last value that passed its CRC
+ * - Serial (KISS / BLHeli32) telemetry: requestTelemetry() sets the
+ *   telemetry bit in the next frame, and the ESC answers with one
+ *   EscTelemetry frame on its telemetry wire
+ *
+ * RMT channels are taken in order (one per ESC, two with
+ * bidirectional), so four bidirectional ESCs use all eight.
+ */
+class DShotESC {
+public:
+    /**
+     * Constructor
+     * @param pin           ESP32 GPIO pin for the ESC signal
+     * @param rate          DSHOT150 / DSHOT300 / DSHOT600
+     * @param bidirectional Request eRPM telemetry on the signal line
+     */
+    DShotESC(int pin, DShotRate rate = DSHOT300, bool bidirectional = false);
+
+    /**
+     * Replace the signal pin from a hardware profile output (before setup);
+     * -1 = not fitted. Direction pins and PWM settings do not apply.
+     */
+    void configure(const PinMapOutput& out) { _pin = out.pin; }
+
+    /**
+     * Claim RMT channel(s) and configure the pin
+     * @return false if no RMT channel was left (ESC stays silent)
+     */
+    bool setup();
+
+    /**
+     * Send one frame now
+     * @param speed Throttle (0 to 100)
+     * @param dt Control period (unused, not ramped; same call as Motor)
+     */
+    void setSpeed(int16_t speed, float dt = 0.0f);
+
+    /**
+     * Send frames to several ESCs in one pass
+     * @param escs ESCs (null entries are skipped)
+     * @param speeds Throttle per ESC (0 to 100)
+     * @param count Number of ESCs
+     * @param dt Control period (unused, not ramped; same call as Motor)
+     */
+    static void setSpeeds(DShotESC* const* escs, const int16_t* speeds, uint8_t count,
+                          float dt = 0.0f);
+
+    int16_t getCurrentSpeed() const { return lastSpeed; }
+
+    /**
+     * Last decoded electrical RPM (bidirectional only), 0 if none
+     * Mechanical RPM = eRPM / (motor poles / 2)
+     */
+    uint32_t getERPM() const { return _erpm; }
+
+    /**
+     * Replies decoded so far (changes when getERPM() is fresh)
+     */
+    uint32_t getERPMCount() const { return _erpmCount; }
+
+    /**
+     * Set the telemetry bit in the next frame only
+     */
+    void requestTelemetry() { _requestTelemetry = true; }
+
+    /**
+     * Replies that failed GCR / CRC decoding
+     */
+    uint32_t getTelemetryErrors() const { return _telemetryErrors; }
+
+private:
+    int _pin;
+    bool _bidirectional;
+    int8_t _txChannel;
+    int8_t _rxChannel;
+    DShotTiming _timing;
+    rmt_item32_t _items[DSHOT_FRAME_BITS];
+    uint16_t _frame;
+    int16_t lastSpeed;
+    RingbufHandle_t _rxBuffer;
+    volatile uint32_t _erpm;
+    volatile uint32_t _erpmCount;
+    bool _requestTelemetry;
+    uint32_t _telemetryErrors;
+
+    static uint8_t nextChannel;
+
+    /**
+     * Encode speed into _items (skipped if the frame is unchanged)
+     */
+    void prepare(int16_t speed);
+    void transmit();
+
+    /**
+     * Decode any reply captured since the last frame
+     */
+    void readTelemetry();
+};
+
+#endif
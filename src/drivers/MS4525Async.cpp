@@ -0,0 +1,97 @@
+#include "MS4525Async.h"
+#include <math.h>
+
+// Output type A, 1 psi differential: 10 %..90 % of 14 bits spans -1..+1 psi
+#define MS4525_COUNTS_MIN   1638.3f     // 0.1 * 16383
+#define MS4525_COUNTS_SPAN  13106.4f    // 0.8 * 16383
+#define MS4525_PSI_MIN      -1.0f
+#define MS4525_PSI_SPAN     2.0f
+#define MS4525_PA_PER_PSI   6894.757f
+
+MS4525Async::MS4525Async()
+    : _begun(false), _reading(false), _readDone(false), _readOk(false), _lastUs(0),
+      _ready(false), _pa(0.0f), _temperatureC(0.0f), _zeroPa(0.0f), _zeroSum(0.0f),
+      _zeroCount(0), _samples(0), _errors(0) {
+    memset(_raw, 0, sizeof(_raw));
+}
+
+bool MS4525Async::begin() {
+    _ready = false;
+    _reading = false;
+    _zeroSum = 0.0f;
+    _zeroCount = 0;
+
+    uint8_t raw[4];
+    _begun = HAL_I2CRead(MS4525_ADDR, raw, 4, 10) == 4 && (raw[0] >> 6) != STATUS_FAULT;
+    return _begun;
+}
+
+void MS4525Async::onReadDone(HAL_I2CError result, void* ctx) {
+    MS4525Async* self = (MS4525Async*)ctx;
+    self->_readOk = result == HAL_I2C_OK;
+    self->_readDone = true;
+}
+
+bool MS4525Async::update(uint32_t nowUs) {
+    if (!_begun) return false;
+
+    bool fresh = false;
+
+    // 1. Collect a finished read
+    if (_reading && _readDone) {
+        _reading = false;
+        float pa, celsius;
+        Status status = _readOk ? parse(_raw, &pa, &celsius) : STATUS_FAULT;
+        if (status == STATUS_OK) {
+            _pa = pa;
+            _temperatureC = celsius;
+            if (_zeroCount < MS4525_ZERO_SAMPLES) {
+                _zeroSum += pa;
+                if (++_zeroCount == MS4525_ZERO_SAMPLES) {
+                    _zeroPa = _zeroSum / MS4525_ZERO_SAMPLES;
+                    _ready = true;
+                }
+            } else {
+                _samples++;
+                fresh = true;
+            }
+        } else if (status != STATUS_STALE) {
+            _errors++;
+        }
+    }
+
+    // 2. Next read once the period is up
+    if (!_reading && nowUs - _lastUs >= MS4525_PERIOD_US) {
+        HAL_I2CTransaction t = {};
+        t.slaveAddr = MS4525_ADDR;
+        t.txLen = 0;
+        t.rxLen = 4;
+        t.rx = _raw;
+        t.timeoutMs = 10;
+        t.callback = onReadDone;
+        t.ctx = this;
+
+        _readDone = false;
+        _lastUs = nowUs;
+        if (HAL_I2CSubmit(&t)) _reading = true;
+        else _errors++;
+    }
+
+    return fresh;
+}
+
+MS4525Async::Status MS4525Async::parse(const uint8_t* raw, float* pa, float* celsius) {
+    uint16_t pCounts = ((uint16_t)(raw[0] & 0x3F) << 8) | raw[1];
+    uint16_t tCounts = ((uint16_t)raw[2] << 3) | (raw[3] >> 5);
+
+    float psi = ((float)pCounts - MS4525_COUNTS_MIN) * MS4525_PSI_SPAN / MS4525_COUNTS_SPAN +
+                MS4525_PSI_MIN;
+    *pa = psi * MS4525_PA_PER_PSI;
+    *celsius = (float)tCounts * 200.0f / 2047.0f - 50.0f;
+    return (Status)(raw[0] >> 6);
+}
+
+float MS4525Async::airspeedFromPa(float pa) {
+    // Bernoulli: dp = rho V^2 / 2
+    return sqrtf(2.0f * fabsf(pa) / MS4525_AIR_DENSITY);
+}
@@ -0,0 +1,94 @@
+#ifndef MS4525_ASYNC_H
+#define MS4525_ASYNC_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+/**
+ * MS4525Async - Non-blocking MS4525DO differential pressure (pitot) driver
+ *
+ * The MS4525DO converts continuously; a plain 4-byte read returns the
+ * latest pressure and temperature with two status bits. update() is
+ * polled like MS5837Async: it queues a read on the HAL I2C queue every
+ * MS4525_PERIOD_US and picks the result up on a later call, so the
+ * sensor task never waits on the bus.
+ *
+ * - Part: 1 psi differential, output type A (10 %..90 % of the counts)
+ * - The first MS4525_ZERO_SAMPLES readings (on the ground, no wind) set
+ *   the zero offset; readings stay not ready until then
+ * - Airspeed is indicated (sea-level density): what the wing flies on
+ * - Stale (status 2) readings are skipped, faults (3) counted as errors
+ */
+
+#define MS4525_ADDR             0x28
+#define MS4525_PERIOD_US        20000   // 50 Hz, the control rate
+#define MS4525_ZERO_SAMPLES     50      // 1 s of zeroing at 50 Hz
+#define MS4525_AIR_DENSITY      1.225f  // kg/m^3, sea level ISA
+
+class MS4525Async {
+public:
+    enum Status : uint8_t {
+        STATUS_OK = 0,
+        STATUS_RESERVED = 1,
+        STATUS_STALE = 2,       // Already read since the last conversion
+        STATUS_FAULT = 3
+    };
+
+    MS4525Async();
+
+    /**
+     * Probe the sensor (blocks one bus transaction, boot only)
+     * Requires HAL_I2CInit()
+     * @return true if the sensor answered
+     */
+    bool begin();
+
+    /**
+     * Advance the read state machine (never waits)
+     * @param nowUs Current time (micros)
+     * @return true if a new zeroed reading was completed this call
+     */
+    bool update(uint32_t nowUs);
+
+    bool isReady() const { return _ready; }
+    float differentialPa() const { return _pa - _zeroPa; }
+    float temperature() const { return _temperatureC; }
+    float airspeed() const { return airspeedFromPa(differentialPa()); }    // m/s
+    uint32_t getSampleCount() const { return _samples; }
+    uint32_t getErrorCount() const { return _errors; }
+
+    /**
+     * Decode a 4-byte reading
+     * @param pa Output differential pressure, Pa (port 1 - port 2)
+     * @param celsius Output temperature, deg C
+     * @return Status bits of the reading
+     */
+    static Status parse(const uint8_t* raw, float* pa, float* celsius);
+
+    /**
+     * Indicated airspeed from the differential pressure (tubes either
+     * way round)
+     */
+    static float airspeedFromPa(float pa);
+
+private:
+    static void onReadDone(HAL_I2CError result, void* ctx);
+
+    bool _begun;
+    bool _reading;              // Read in flight on the bus
+    uint8_t _raw[4];
+    volatile bool _readDone;    // Set by the bus task
+    volatile bool _readOk;
+    uint32_t _lastUs;
+    bool _ready;
+
+    float _pa;
+    float _temperatureC;
+    float _zeroPa;
+    float _zeroSum;
+    uint16_t _zeroCount;
+    uint32_t _samples;
+    uint32_t _errors;
+};
+
+#endif
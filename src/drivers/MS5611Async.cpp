@@ -0,0 +1,183 @@
+#include "MS5611Async.h"
+
+// MS5611 I2C Configuration Constants
+#define MS5611_RESET        0x1E
+#define MS5611_ADC_READ     0x00
+#define MS5611_PROM_READ    0xA0
+#define MS5611_CONVERT_D1   0x40    // + 2 * OSR index
+#define MS5611_CONVERT_D2   0x50    // + 2 * OSR index
+
+MS5611Async::MS5611Async()
+    : _begun(false), _addr(ADDR_CSB_LOW), _osr(OSR_4096), _tempDivider(4),
+      _converting(CONVERT_NONE), _startUs(0), _reading(CONVERT_NONE), _readDone(false),
+      _readOk(false), _busError(false), _sinceTemp(0), _d2(0), _haveD2(false),
+      _ready(false), _pressureMbar(0.0f), _temperatureC(0.0f), _samples(0), _errors(0) {
+    memset(_prom, 0, sizeof(_prom));
+    memset(_adc, 0, sizeof(_adc));
+}
+
+bool MS5611Async::begin(uint8_t addr) {
+    _begun = false;
+    _ready = false;
+    _haveD2 = false;
+    _converting = CONVERT_NONE;
+    _reading = CONVERT_NONE;
+    _addr = addr;
+
+    uint8_t reset = MS5611_RESET;
+    if (HAL_I2CWrite(_addr, &reset, 1, 10) != HAL_I2C_OK) return false;
+    delay(10);  // Reset reloads PROM (2.8ms max)
+
+    for (uint8_t i = 0; i < 8; i++) {
+        uint8_t word[2];
+        if (HAL_I2CReadReg(_addr, MS5611_PROM_READ + i * 2, word, 2, 10) != 2) return false;
+        _prom[i] = ((uint16_t)word[0] << 8) | word[1];
+    }
+
+    _begun = crc4(_prom) == (_prom[7] & 0x0F);
+    return _begun;
+}
+
+uint32_t MS5611Async::conversionTimeUs(Osr osr) {
+    // Datasheet max times, 256: 0.6ms doubling up to 4096: 9.04ms
+    static const uint32_t times[] = {600, 1200, 2300, 4600, 9100};
+    return times[osr > OSR_4096 ? OSR_4096 : osr];
+}
+
+void MS5611Async::onCommandDone(HAL_I2CError result, void* ctx) {
+    if (result != HAL_I2C_OK)
+        ((MS5611Async*)ctx)->_busError = true;
+}
+
+void MS5611Async::onReadDone(HAL_I2CError result, void* ctx) {
+    MS5611Async* self = (MS5611Async*)ctx;
+    self->_readOk = result == HAL_I2C_OK;
+    self->_readDone = true;
+}
+
+void MS5611Async::startConversion(uint32_t nowUs) {
+    // Temperature first, then once every _tempDivider pressure samples
+    bool temp = _haveD2 ? _sinceTemp >= _tempDivider : _reading != CONVERT_D2;
+
+    HAL_I2CTransaction t = {};
+    t.slaveAddr = _addr;
+    t.txLen = 1;
+    t.tx[0] = (temp ? MS5611_CONVERT_D2 : MS5611_CONVERT_D1) + 2 * _osr;
+    t.timeoutMs = 10;
+    t.callback = onCommandDone;
+    t.ctx = this;
+    if (!HAL_I2CSubmit(&t)) {
+        _errors++;
+        _converting = CONVERT_NONE;
+        return;
+    }
+
+    _converting = temp ? CONVERT_D2 : CONVERT_D1;
+    _sinceTemp = temp ? 0 : _sinceTemp + 1;
+    _startUs = nowUs;
+}
+
+bool MS5611Async::submitRead() {
+    HAL_I2CTransaction t = {};
+    t.slaveAddr = _addr;
+    t.txLen = 1;
+    t.tx[0] = MS5611_ADC_READ;
+    t.rxLen = 3;
+    t.rx = _adc;
+    t.timeoutMs = 10;
+    t.callback = onReadDone;
+    t.ctx = this;
+
+    _readDone = false;
+    _reading = _converting;
+    if (!HAL_I2CSubmit(&t)) {
+        _errors++;
+        _reading = CONVERT_NONE;
+        return false;
+    }
+    return true;
+}
+
+bool MS5611Async::update(uint32_t nowUs) {
+    if (!_begun) return false;
+
+    bool fresh = false;
+
+    // 1. Collect a finished ADC read
+    if (_reading != CONVERT_NONE && _readDone) {
+        uint32_t raw = ((uint32_t)_adc[0] << 16) | ((uint32_t)_adc[1] << 8) | _adc[2];
+        // 0 means the read came before the conversion finished
+        if (!_readOk || raw == 0) {
+            _errors++;
+        } else if (_reading == CONVERT_D2) {
+            _d2 = raw;
+            _haveD2 = true;
+        } else if (_haveD2) {
+            compute(_prom, raw, _d2, &_pressureMbar, &_temperatureC);
+            _ready = true;
+            _samples++;
+            fresh = true;
+        }
+        _reading = CONVERT_NONE;
+    }
+
+    if (_busError) {
+        _busError = false;
+        _errors++;
+        _converting = CONVERT_NONE;     // Command lost, start over
+    }
+
+    // 2. Conversion done: read it and start the next one right behind it
+    // (the queue is FIFO, so the new command follows the ADC read)
+    if (_converting == CONVERT_NONE) {
+        if (_reading == CONVERT_NONE) startConversion(nowUs);
+    } else if (_reading == CONVERT_NONE &&
+               nowUs - _startUs >= conversionTimeUs(_osr)) {
+        if (submitRead()) startConversion(nowUs);
+        else _converting = CONVERT_NONE;
+    }
+
+    return fresh;
+}
+
+void MS5611Async::compute(const uint16_t* prom, uint32_t d1, uint32_t d2,
+                          float* mbar, float* celsius) {
+    int32_t dT = (int32_t)d2 - (int32_t)prom[5] * 256;
+    int32_t temp = 2000 + (int32_t)((int64_t)dT * prom[6] / 8388608LL);
+    int64_t off = (int64_t)prom[2] * 65536 + ((int64_t)prom[4] * dT) / 128;
+    int64_t sens = (int64_t)prom[1] * 32768 + ((int64_t)prom[3] * dT) / 256;
+
+    // Second order compensation (below 20 C only)
+    if (temp < 2000) {
+        int64_t t2 = (int64_t)(temp - 2000) * (temp - 2000);
+        int64_t offi = (5 * t2) / 2;
+        int64_t sensi = (5 * t2) / 4;
+        if (temp < -1500) {
+            int64_t t3 = (int64_t)(temp + 1500) * (temp + 1500);
+            offi += 7 * t3;
+            sensi += (11 * t3) / 2;
+        }
+        temp -= (int32_t)(((int64_t)dT * dT) / 2147483648LL);
+        off -= offi;
+        sens -= sensi;
+    }
+
+    int64_t p = (((int64_t)d1 * sens) / 2097152 - off) / 32768;    // 0.01 mbar
+    *mbar = p / 100.0f;
+    *celsius = temp / 100.0f;
+}
+
+uint8_t MS5611Async::crc4(const uint16_t* prom) {
+    uint16_t words[8];
+    for (uint8_t i = 0; i < 8; i++) words[i] = prom[i];
+    words[7] &= 0xFF00;     // CRC nibble out of the sum
+
+    uint16_t rem = 0;
+    for (uint8_t i = 0; i < 16; i++) {
+        rem ^= (i & 1) ? (words[i >> 1] & 0x00FF) : (words[i >> 1] >> 8);
+        for (uint8_t bit = 8; bit > 0; bit--) {
+            rem = (rem & 0x8000) ? (rem << 1) ^ 0x3000 : (rem << 1);
+        }
+    }
+    return (rem >> 12) & 0x0F;
+}
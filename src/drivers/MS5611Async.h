@@ -0,0 +1,124 @@
+#ifndef MS5611_ASYNC_H
+#define MS5611_ASYNC_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+/**
+ * MS5611Async - Non-blocking MS5611 barometer driver
+ *
+ * Same family and command set as the MS5837 depth sensor (D1 / D2
+ * conversions, PROM, ADC read), so the same polled state machine as
+ * MS5837Async: update() starts a conversion and returns; once the
+ * conversion time has passed the ADC read and the next conversion go on
+ * the HAL I2C queue back to back, and the result is picked up on the
+ * following call. Temperature is converted once every tempDivider
+ * pressure samples.
+ *
+ * What differs from the MS5837: the 1200 mbar range (compensation
+ * constants), the CRC in PROM word 7 instead of word 0, and the address
+ * (0x77 with CSB low, as on the GY-63 boards; 0x76 with CSB high) - on
+ * 0x77 it shares the bus with a depth sensor.
+ *
+ * Conversion time per OSR: 256=0.6ms ... 4096=9ms. At OSR 4096 the
+ * noise is ~0.012 mbar, about 10 cm of altitude.
+ */
+class MS5611Async {
+public:
+    enum Osr : uint8_t {
+        OSR_256 = 0,
+        OSR_512 = 1,
+        OSR_1024 = 2,
+        OSR_2048 = 3,
+        OSR_4096 = 4
+    };
+
+    static const uint8_t ADDR_CSB_LOW = 0x77;
+    static const uint8_t ADDR_CSB_HIGH = 0x76;
+
+    MS5611Async();
+
+    /**
+     * Reset the sensor and read calibration PROM (blocks ~10ms, boot only)
+     * Requires HAL_I2CInit()
+     * @return true if the sensor answered and the PROM CRC matched
+     */
+    bool begin(uint8_t addr = ADDR_CSB_LOW);
+
+    void setOsr(Osr osr) { _osr = osr > OSR_4096 ? OSR_4096 : osr; }
+    void setTemperatureDivider(uint8_t n) { _tempDivider = n ? n : 1; }
+    Osr getOsr() const { return _osr; }
+
+    /**
+     * Advance the conversion state machine (never waits)
+     * @param nowUs Current time (micros)
+     * @return true if a new pressure sample was completed this call
+     */
+    bool update(uint32_t nowUs);
+
+    bool isReady() const { return _ready; }
+    float pressure() const { return _pressureMbar; }     // mbar
+    float temperature() const { return _temperatureC; }  // deg C
+    uint32_t getSampleCount() const { return _samples; }
+    uint32_t getErrorCount() const { return _errors; }
+
+    /**
+     * Convert raw ADC values with first and second order compensation
+     * @param prom Calibration words C0..C7
+     * @param d1 Raw pressure
+     * @param d2 Raw temperature
+     * @param mbar Output pressure in mbar
+     * @param celsius Output temperature in deg C
+     */
+    static void compute(const uint16_t* prom, uint32_t d1, uint32_t d2,
+                        float* mbar, float* celsius);
+
+    /**
+     * PROM CRC4 (datasheet AN520, MS5611 layout)
+     * @param prom Calibration words C0..C7
+     * @return CRC4; must equal prom[7] & 0x0F
+     */
+    static uint8_t crc4(const uint16_t* prom);
+
+    /**
+     * Conversion time for an OSR setting, with margin
+     */
+    static uint32_t conversionTimeUs(Osr osr);
+
+private:
+    enum Conversion : uint8_t {
+        CONVERT_NONE,
+        CONVERT_D1,
+        CONVERT_D2
+    };
+
+    void startConversion(uint32_t nowUs);
+    bool submitRead();
+    static void onCommandDone(HAL_I2CError result, void* ctx);
+    static void onReadDone(HAL_I2CError result, void* ctx);
+
+    bool _begun;
+    uint8_t _addr;
+    Osr _osr;
+    uint8_t _tempDivider;
+
+    uint16_t _prom[8];
+    Conversion _converting;     // Running on the sensor
+    uint32_t _startUs;
+    Conversion _reading;        // ADC read in flight on the bus
+    uint8_t _adc[3];
+    volatile bool _readDone;    // Set by the bus task
+    volatile bool _readOk;
+    volatile bool _busError;
+    uint8_t _sinceTemp;
+    uint32_t _d2;
+    bool _haveD2;
+    bool _ready;
+
+    float _pressureMbar;
+    float _temperatureC;
+    uint32_t _samples;
+    uint32_t _errors;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef MS5837_ASYNC_H
+#define MS5837_ASYNC_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+/**
+ * MS5837Async - Non-blocking MS5837 pressure sensor driver
+ *
+ * The MS5837 needs a conversion command, a wait of up to 18ms, then an
+ * ADC read. Instead of sleeping through the wait (as the BlueRobotics
+ * library does, ~40ms per sample), update() is polled:
+ * - Starts a conversion and returns
+ * - On a later call, once the conversion time has passed, queues the ADC
+ *   read and the next conversion command on the HAL I2C queue back to
+ *   back; the result is picked up on the following call
+ * - Temperature (D2) is converted once every tempDivider pressure (D1)
+ *   samples; it drifts slowly, so most conversions go to pressure
+ *
+ * Conversion time per OSR: 256=0.6ms ... 4096=9ms, 8192=18ms.
+ * Higher OSR = lower noise, lower sample rate.
+ */
+class MS5837Async {
+public:
+    enum Model : uint8_t {
+        MODEL_30BA = 0,     // 30 bar (Bar30)
+        MODEL_02BA = 1      // 2 bar (Bar02)
+    };
+
+    enum Osr : uint8_t {
+        OSR_256 = 0,
+        OSR_512 = 1,
+        OSR_1024 = 2,
+        OSR_2048 = 3,
+        OSR_4096 = 4,
+        OSR_8192 = 5
+    };
+
+    MS5837Async();
+
+    /**
+     * Reset the sensor and read calibration PROM (blocks ~10ms, boot only)
+     * Requires HAL_I2CInit()
+     * @return true if the sensor answered and the PROM CRC matched
+     */
+    bool begin();
+
+    void setModel(Model model) { _model = model; }
+    void setOsr(Osr osr) { _osr = osr > OSR_8192 ? OSR_8192 : osr; }
+    void setFluidDensity(float density) { _density = density; }
+    void setTemperatureDivider(uint8_t n) { _tempDivider = n ? n : 1; }
+    Osr getOsr() const { return _osr; }
+
+    /**
+     * Advance the conversion state machine (never waits)
+     * @param nowUs Current time (micros)
+     * @return true if a new pressure sample was completed this call
+     */
+    bool update(uint32_t nowUs);
+
+    bool isReady() const { return _ready; }
+    float pressure() const { return _pressureMbar; }     // mbar
+    float temperature() const { return _temperatureC; }  // deg C
+    float depth() const;                                 // m below surface
+    uint32_t getErrorCount() const { return _errors; }
+
+    /**
+     * Convert raw ADC values with first and second order compensation
+     * @param model Sensor variant
+     * @param prom Calibration words C0..C6
+     * @param d1 Raw pressure
+     * @param d2 Raw temperature
+     * @param mbar Output pressure in mbar
+     * @param celsius Output temperature in deg C
+     */
+    static void compute(Model model, const uint16_t* prom, uint32_t d1, uint32_t d2,
+                        float* mbar, float* celsius);
+
+    /**
+     * PROM CRC4 (datasheet AN520)
+     * @param prom Calibration words C0..C6
+     * @return CRC4; must equal prom[0] >> 12
+     */
+    static uint8_t crc4(const uint16_t* prom);
+
+    /**
+     * Conversion time for an OSR setting, with margin
+     */
+    static uint32_t conversionTimeUs(Osr osr);
+
+private:
+    enum Conversion : uint8_t {
+        CONVERT_NONE,
+        CONVERT_D1,
+        CONVERT_D2
+    };
+
+    void startConversion(uint32_t nowUs);
+    bool submitRead();
+    static void onCommandDone(HAL_I2CError result, void* ctx);
+    static void onReadDone(HAL_I2CError result, void* ctx);
+
+    bool _begun;
+    Model _model;
+    Osr _osr;
+    float _density;
+    uint8_t _tempDivider;
+
+    uint16_t _prom[7];
+    Conversion _converting;     // Running on the sensor
+    uint32_t _startUs;
+    Conversion _reading;        // ADC read in flight on the bus
+    uint8_t _adc[3];
+    volatile bool _readDone;    // Set by the bus task
+    volatile bool _readOk;
+    volatile bool _busError;
+    uint8_t _sinceTemp;
+    uint32_t _d2;
+    bool _haveD2;
+    bool _ready;
+
+    float _pressureMbar;
+    float _temperatureC;
+    uint32_t _errors;
+};
+
+#endif
@@ -1,106 +1,154 @@
 #include "Motor.h"
+#include "HAL.h"
+#include "HotPath.h"
 
-// Motor Configuration Constants
-#define MOTOR_DEADBAND 10      // ±10 out of ±100 range
-#define MOTOR_MAX_RAMP 5       // Max 5% change per 20ms cycle = 25% per 100ms
-#define MOTOR_MIN_PWM 40       // Minimum PWM to overcome static friction
+// MotorConfig.maxRamp is in % per 20 ms (the original control period)
+#define MOTOR_RAMP_PERIOD_S 0.02f
 
-Motor::Motor(int pwmPin, int dirPin1, int dirPin2, int channel) 
-    : _pwmPin(pwmPin), _dir1(dirPin1), _dir2(dirPin2), _channel(channel),
-      lastSpeed(0), lastUpdateTime(0) {
+Motor::Motor(int pwmPin, int dirPin1, int dirPin2) 
+    : _pwmPin(pwmPin), _dir1(dirPin1), _dir2(dirPin2), _channel(-1),
+      _frequency(MOTOR_PWM_FREQUENCY),
+      _resolution(PinMap_pwmMaxResolution(MOTOR_PWM_FREQUENCY)),
+      _maxDuty((1UL << _resolution) - 1),
+      _output(0.0f), lastSpeed(0) {
+    setConfig(ConfigManager::MotorConfig());
 }
 
-void Motor::setup() {
-    pinMode(_pwmPin, OUTPUT);
-    pinMode(_dir1, OUTPUT);
-    pinMode(_dir2, OUTPUT);
+Motor::Motor(const PinMapOutput& out) : Motor(out.pin, out.dir1, out.dir2) {
+    configure(out);
+}
+
+void Motor::configure(const PinMapOutput& out) {
+    _pwmPin = out.pin;
+    _dir1 = out.dir1;
+    _dir2 = out.dir2;
+    _frequency = out.frequency ? out.frequency : MOTOR_PWM_FREQUENCY;
+    _resolution = out.resolution ? out.resolution : PinMap_pwmMaxResolution(_frequency);
+    _maxDuty = (1UL << _resolution) - 1;
+    updateScaling();
+}
+
+void Motor::setConfig(const ConfigManager::MotorConfig& config) {
+    _deadband = config.deadband;
+    _minPWM = config.minPWM;
+    _rampPerSec = config.maxRamp / MOTOR_RAMP_PERIOD_S;
+    updateScaling();
+}
+
+void Motor::updateScaling() {
+    // 1..100 maps linearly onto the minimum duty (minPWM of 255, overcomes
+    // friction) .. full scale at the channel's resolution
+    _minDuty = (_minPWM * _maxDuty) / 255;
+    // Rounded up so speed 100 reaches full scale; 99 x slope fits 32 bits
+    // at 16-bit resolution
+    _dutySlope = (uint32_t)(((((uint64_t)(_maxDuty - _minDuty)) << 16) + 98) / 99);
+}
+
+bool Motor::setup() {
+    if (_pwmPin < 0) return false;      // Not fitted
+    if (_dir1 >= 0) pinMode(_dir1, OUTPUT);
+    if (_dir2 >= 0) pinMode(_dir2, OUTPUT);
     
-    // ESP32 PWM Setup (LEDC)
-    ledcSetup(_channel, 1000, 8); // 1kHz, 8-bit
-    ledcAttachPin(_pwmPin, _channel);
+    // ESP32 PWM Setup (LEDC, timer shared by every motor at this frequency)
+    _channel = HAL_PWMAllocate(_pwmPin, _frequency, _resolution);
+    if (_channel < 0) {
+        Serial.printf("[MOTOR] No PWM channel for GPIO %d (%lu Hz, %u bit)\n", _pwmPin,
+                      (unsigned long)_frequency, _resolution);
+        return false;
+    }
     
-    lastUpdateTime = millis();
+    return true;
 }
 
-int16_t Motor::applyDeadband(int16_t input) {
+HOT_IRAM int16_t Motor::applyDeadband(int16_t input) {
     // Constraint input to valid range
     if (input > 100) input = 100;
     if (input < -100) input = -100;
     
     // Apply deadband: zero out small inputs
-    if (input > -MOTOR_DEADBAND && input < MOTOR_DEADBAND) {
+    if (input > -_deadband && input < _deadband) {
         return 0;
     }
     
     return input;
 }
 
-int16_t Motor::applyRamping(int16_t targetSpeed) {
-    uint32_t currentTime = millis();
-    uint32_t timeDelta = currentTime - lastUpdateTime;
-    lastUpdateTime = currentTime;
-    
-    // Prevent division issues on first call
-    if (timeDelta == 0) timeDelta = 1;
-    
-    // Calculate maximum change allowed based on time elapsed
-    // MOTOR_MAX_RAMP % per 20ms = 5% per 20ms
-    // For 20ms cycle: maxChange = 5
-    // For 50ms cycle: maxChange = 12
-    int16_t maxChange = (MOTOR_MAX_RAMP * timeDelta) / 20;
-    if (maxChange < 1) maxChange = 1;
-    
-    // Limit acceleration
-    int16_t speedDelta = targetSpeed - lastSpeed;
-    if (speedDelta > maxChange) {
-        speedDelta = maxChange;
-    } else if (speedDelta < -maxChange) {
-        speedDelta = -maxChange;
+HOT_IRAM int16_t Motor::applyRamping(int16_t targetSpeed, float dt) {
+    // Step is rate * dt in float: at 1 kHz and 250 %/s each call moves
+    // 0.25 %, which the output keeps instead of rounding it to 0 or 1
+    float delta = targetSpeed - _output;
+    if (_rampPerSec > 0.0f) {
+        float maxChange = _rampPerSec * dt;
+        if (delta > maxChange) {
+            delta = maxChange;
+        } else if (delta < -maxChange) {
+            delta = -maxChange;
+        }
     }
+    _output += delta;
     
-    return lastSpeed + speedDelta;
+    // Round half away from zero like lroundf, without the libm call (flash)
+    return (int16_t)(_output >= 0.0f ? _output + 0.5f : _output - 0.5f);
+}
+
+HOT_IRAM void Motor::setSpeed(int16_t speed, float dt) {
+    MotorBatch batch;
+    prepare(speed, dt, batch);
+    batch.commit();
+}
+
+HOT_IRAM void Motor::setSpeeds(Motor* const* motors, const int16_t* speeds, uint8_t count, float dt) {
+    MotorBatch batch;
+    for (uint8_t i = 0; i < count; i++) {
+        if (motors[i]) motors[i]->prepare(speeds[i], dt, batch);
+    }
+    batch.commit();
 }
 
-void Motor::setSpeed(int16_t speed) {
+HOT_IRAM void Motor::prepare(int16_t speed, float dt, MotorBatch& batch) {
     // Step 1: Apply deadband to prevent motor creep
     speed = applyDeadband(speed);
     
     // Step 2: Apply ramping to limit acceleration
-    speed = applyRamping(speed);
+    speed = applyRamping(speed, dt);
     
     // Store for next call
     lastSpeed = speed;
-    
-    // Step 3: Convert to PWM output
-    int pwmVal = 0;
-    
-    if (speed > 0) {
-        // Forward direction
-        digitalWrite(_dir1, HIGH);
-        digitalWrite(_dir2, LOW);
-        
-        // Map -100..100 to 0..255 PWM with minimum threshold
-        // Ensure minimum PWM to overcome friction
-        pwmVal = map(speed, 1, 100, MOTOR_MIN_PWM, 255);
-        
-    } else if (speed < 0) {
-        // Reverse direction
-        digitalWrite(_dir1, LOW);
-        digitalWrite(_dir2, HIGH);
-        
-        // Map -100..-1 to MOTOR_MIN_PWM..255
-        pwmVal = map(abs(speed), 1, 100, MOTOR_MIN_PWM, 255);
-        
-    } else {
-        // Stop
-        digitalWrite(_dir1, LOW);
-        digitalWrite(_dir2, LOW);
-        pwmVal = 0;
+    queueOutput(speed, batch);
+}
+
+HOT_IRAM void Motor::prepareNow(int16_t speed, MotorBatch& batch) {
+    if (speed > 100) speed = 100;
+    if (speed < -100) speed = -100;
+    _output = speed;
+    lastSpeed = speed;
+    queueOutput(speed, batch);
+}
+
+void Motor::prepareDuty(uint8_t duty, MotorBatch& batch) {
+    _output = 0.0f;
+    lastSpeed = 0;
+    if (_channel < 0) return;
+    batch.setPin(_dir1, duty > 0);
+    batch.setPin(_dir2, false);
+    batch.setDuty(_channel, (duty * _maxDuty) / 255);
+}
+
+HOT_IRAM void Motor::queueOutput(int16_t speed, MotorBatch& batch) {
+    // No channel (not fitted / setup failed): never touch the pins
+    if (_channel < 0) return;
+
+    // Step 3: Convert to PWM output on the precomputed line (one multiply
+    // and shift, no divide)
+    uint32_t pwmVal = 0;
+    int16_t magnitude = speed < 0 ? -speed : speed;
+    if (magnitude > 0) {
+        pwmVal = _minDuty + (((uint32_t)(magnitude - 1) * _dutySlope) >> 16);
+        if (pwmVal > _maxDuty) pwmVal = _maxDuty;
     }
-    
-    // Constrain final PWM value
-    if (pwmVal > 255) pwmVal = 255;
-    if (pwmVal < 0) pwmVal = 0;
-    
-    ledcWrite(_channel, pwmVal);
+
+    // Forward: dir1 high, reverse: dir2 high, stop: both low
+    batch.setPin(_dir1, speed > 0);
+    batch.setPin(_dir2, speed < 0);
+    batch.setDuty(_channel, pwmVal);
 }
@@ -2,14 +2,29 @@
 #define MOTOR_H
 
 #include <Arduino.h>
+#include "MotorBatch.h"
+#include "../PinMap.h"
+#include "../ConfigManager.h"
+
+#define MOTOR_PWM_FREQUENCY 1000   // Default; hardware profile may set e.g. 20 kHz
 
 /**
  * Motor - PWM-controlled motor driver with deadband and acceleration ramping
  * 
  * Features:
  * - Deadband: Prevents motor creep at low inputs
- * - Ramping: Limits acceleration to prevent vehicle flip
+ * - Ramping: Slew-rate limit in %/s to prevent vehicle flip, stepped by
+ *   the caller's control period (dt) with fractional accumulation, so
+ *   the ramp is the same at 50 Hz, 400 Hz or 1 kHz
  * - Speed range: -100 to +100
+ * - Deadband / ramp / minimum PWM per motor from MotorConfig (setConfig);
+ *   the speed-to-duty line is precomputed there, not per output
+ * - PWM channel comes from the HAL registry (HAL_PWMAllocate), at the
+ *   finest resolution the frequency allows unless the profile sets one
+ *
+ * setSpeed() drives one motor immediately. Vehicles with several motors
+ * use setSpeeds(), which prepares every motor first and commits them
+ * together through one MotorBatch (same instant, one clock read).
  */
 class Motor {
 public:
@@ -18,28 +33,93 @@ public:
      * @param pwmPin    ESP32 GPIO pin for PWM signal
      * @param dirPin1   Direction pin 1
      * @param dirPin2   Direction pin 2
-     * @param channel   LEDC channel (0-15)
      */
-    Motor(int pwmPin, int dirPin1, int dirPin2, int channel);
+    Motor(int pwmPin, int dirPin1, int dirPin2);
+
+    /**
+     * Constructor from a hardware profile output
+     */
+    Motor(const PinMapOutput& out);
+
+    /**
+     * Not fitted until configure() (arrays sized for the largest layout)
+     */
+    Motor() : Motor(-1, -1, -1) {}
+
+    /**
+     * Replace pins and PWM settings (before setup)
+     * @param out Pin -1 = not fitted; frequency / resolution 0 = default
+     */
+    void configure(const PinMapOutput& out);
+
+    /**
+     * Apply deadband, ramp and minimum PWM (any time, from the control task)
+     */
+    void setConfig(const ConfigManager::MotorConfig& config);
     
-    void setup();
+    /**
+     * Configure pins and request a PWM channel from the HAL registry
+     * @return false if no channel was available (motor stays off)
+     */
+    bool setup();
     
     /**
      * Set motor speed with deadband and ramping applied
      * @param speed Target speed (-100 to 100)
+     * @param dt Control period in seconds (scheduler period, not measured)
+     */
+    void setSpeed(int16_t speed, float dt);
+
+    /**
+     * Compute the next output and queue it without touching hardware
+     * @param speed Target speed (-100 to 100)
+     * @param dt Control period in seconds, for ramping
+     * @param batch Batch that receives duty and direction pins
+     */
+    void prepare(int16_t speed, float dt, MotorBatch& batch);
+
+    /**
+     * Set several motors and update them in one synchronous commit
+     * @param motors Motors (null entries are skipped)
+     * @param speeds Target speed per motor (-100 to 100)
+     * @param count Number of motors
+     * @param dt Control period in seconds
      */
-    void setSpeed(int16_t speed);
+    static void setSpeeds(Motor* const* motors, const int16_t* speeds, uint8_t count, float dt);
+
+    /**
+     * Queue a speed with no deadband and no ramp (emergency response)
+     * The ramp continues from this speed. IRAM, register writes only:
+     * callable from an interrupt or timer callback.
+     * @param speed Speed (-100 to 100)
+     * @param batch Batch that receives duty and direction pins
+     */
+    void prepareNow(int16_t speed, MotorBatch& batch);
+
+    /**
+     * Queue a raw forward duty (of 255) with no minimum PWM, deadband or
+     * ramp (motor calibration); the ramp restarts from standstill
+     */
+    void prepareDuty(uint8_t duty, MotorBatch& batch);
     
     int16_t getCurrentSpeed() const { return lastSpeed; }
 
 private:
     int _pwmPin, _dir1, _dir2, _channel;
+    uint32_t _frequency;
+    uint8_t _resolution;
+    uint32_t _maxDuty;          // 2^resolution - 1
+    uint8_t _deadband;          // ±range around 0 forced to stop
+    uint8_t _minPWM;            // Of 255, scaled to the resolution
+    uint32_t _minDuty;          // Duty at speed 1
+    uint32_t _dutySlope;        // Duty per speed step above 1, Q16
+    float _rampPerSec;          // Max change in %/s, 0 = no limit
+    float _output;              // Ramped speed, keeps the fractional part
     int16_t lastSpeed;
-    uint32_t lastUpdateTime;
     
     /**
      * Apply deadband to input to prevent motor creep
-     * Input between -MOTOR_DEADBAND and +MOTOR_DEADBAND becomes 0
+     * Input strictly between -deadband and +deadband becomes 0
      * 
      * @param input Raw speed input
      * @return Speed after deadband application
@@ -51,9 +131,20 @@ private:
      * Prevents sudden full acceleration which could flip vehicle
      * 
      * @param targetSpeed Desired speed after deadband
+     * @param dt Control period in seconds
      * @return Speed limited by max ramp rate
      */
-    int16_t applyRamping(int16_t targetSpeed);
+    int16_t applyRamping(int16_t targetSpeed, float dt);
+
+    /**
+     * Recompute _minDuty / _dutySlope (minimum PWM or resolution changed)
+     */
+    void updateScaling();
+
+    /**
+     * Queue duty and direction pins for a final speed
+     */
+    void queueOutput(int16_t speed, MotorBatch& batch);
 };
 
 #endif
@@ -0,0 +1,88 @@
+#include "MotorBatch.h"
+#include "HotPath.h"
+
+#if defined(__XTENSA__)
+#include <hal/ledc_ll.h>
+#include <soc/gpio_struct.h>
+#include <soc/ledc_struct.h>
+#include <soc/soc_caps.h>
+
+// Keeps the latch loop in one piece (no ISR between channels)
+static portMUX_TYPE batchMux = portMUX_INITIALIZER_UNLOCKED;
+#else
+#include "HAL.h"
+#define SOC_GPIO_PIN_COUNT 40
+#endif
+
+HOT_IRAM MotorBatch::MotorBatch()
+    : _setLo(0), _clrLo(0), _setHi(0), _clrHi(0), _channels(0) {
+    memset(_duty, 0, sizeof(_duty));
+}
+
+HOT_IRAM void MotorBatch::setPin(int pin, bool high) {
+    if (pin < 0 || pin >= SOC_GPIO_PIN_COUNT) return;
+    uint32_t bit = 1UL << (pin & 31);
+    if (pin < 32) {
+        _setLo = high ? _setLo | bit : _setLo & ~bit;
+        _clrLo = high ? _clrLo & ~bit : _clrLo | bit;
+    } else {
+        _setHi = high ? _setHi | bit : _setHi & ~bit;
+        _clrHi = high ? _clrHi & ~bit : _clrHi | bit;
+    }
+}
+
+HOT_IRAM void MotorBatch::setDuty(uint8_t channel, uint32_t duty) {
+    if (channel >= MAX_CHANNELS) return;
+    _duty[channel] = duty;
+    _channels |= 1 << channel;
+}
+
+#if defined(__XTENSA__)
+HOT_IRAM void MotorBatch::commit() {
+    // Arduino channels 0-7 are the high-speed group, 8-15 low-speed (the
+    // S3 has only 0-7, low-speed: group 0 is LEDC_LOW_SPEED_MODE there)
+    for (uint8_t ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (_channels & (1 << ch)) {
+            ledc_ll_set_duty_int_part(&LEDC, (ledc_mode_t)(ch / 8), (ledc_channel_t)(ch % 8),
+                                      _duty[ch]);
+        }
+    }
+
+    portENTER_CRITICAL(&batchMux);
+    GPIO.out_w1tc = _clrLo;
+    GPIO.out1_w1tc.val = _clrHi;
+    GPIO.out_w1ts = _setLo;
+    GPIO.out1_w1ts.val = _setHi;
+    for (uint8_t ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (_channels & (1 << ch)) {
+            ledc_mode_t mode = (ledc_mode_t)(ch / 8);
+            ledc_ll_set_duty_start(&LEDC, mode, (ledc_channel_t)(ch % 8), true);
+            if (mode == LEDC_LOW_SPEED_MODE)
+                ledc_ll_ls_channel_update(&LEDC, mode, (ledc_channel_t)(ch % 8));
+        }
+    }
+    portEXIT_CRITICAL(&batchMux);
+
+    _setLo = _clrLo = _setHi = _clrHi = 0;
+    _channels = 0;
+}
+#else
+// Host build (env:native, SITL): the same pin / duty order through the
+// Arduino and HAL shims, so outputs can be read back per pin and channel
+void MotorBatch::commit() {
+    for (uint8_t ch = 0; ch < MAX_CHANNELS; ch++) {
+        if (_channels & (1 << ch)) HAL_PWMWrite(ch, _duty[ch]);
+    }
+    for (int pin = 0; pin < SOC_GPIO_PIN_COUNT; pin++) {
+        uint32_t bit = 1UL << (pin & 31);
+        if ((pin < 32 ? _clrLo : _clrHi) & bit) digitalWrite(pin, LOW);
+    }
+    for (int pin = 0; pin < SOC_GPIO_PIN_COUNT; pin++) {
+        uint32_t bit = 1UL << (pin & 31);
+        if ((pin < 32 ? _setLo : _setHi) & bit) digitalWrite(pin, HIGH);
+    }
+
+    _setLo = _clrLo = _setHi = _clrHi = 0;
+    _channels = 0;
+}
+#endif
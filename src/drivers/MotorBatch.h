@@ -0,0 +1,48 @@
+#ifndef MOTOR_BATCH_H
+#define MOTOR_BATCH_H
+
+#include <Arduino.h>
+
+/**
+ * MotorBatch - Collects motor outputs and commits them in one pass
+ *
+ * Motor::prepare() only computes duty and direction and records them
+ * here; commit() then writes the hardware:
+ * 1. New duty into every channel's duty register (not yet active)
+ * 2. All direction pins at once through GPIO W1TC / W1TS
+ *    (clear before set, so an H-bridge never sees both inputs high)
+ * 3. duty_start (plus the low-speed update bit) on every channel back
+ *    to back, so all motors take their new duty on the same PWM period
+ *
+ * Channels must come from HAL_PWMAllocate (channel config also sets up
+ * the fade registers the plain duty write relies on).
+ */
+class MotorBatch {
+public:
+    MotorBatch();
+
+    /**
+     * Queue a direction pin level (GPIO 0-39, S3 0-48)
+     */
+    void setPin(int pin, bool high);
+
+    /**
+     * Queue a duty for an Arduino LEDC channel (0-15)
+     */
+    void setDuty(uint8_t channel, uint32_t duty);
+
+    /**
+     * Write everything queued, then start empty again
+     */
+    void commit();
+
+private:
+    static const uint8_t MAX_CHANNELS = 16;
+
+    uint32_t _setLo, _clrLo;    // GPIO 0-31
+    uint32_t _setHi, _clrHi;    // GPIO 32-39 (S3 32-48)
+    uint16_t _channels;         // Bitmask of queued channels
+    uint32_t _duty[MAX_CHANNELS];
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "PCA9685Async.h"
+#include <math.h>
+
+#define PCA9685_MODE1           0x00
+#define PCA9685_MODE2           0x01
+#define PCA9685_LED0_ON_L       0x06
+#define PCA9685_PRE_SCALE       0xFE
+
+#define PCA9685_MODE1_RESTART   0x80
+#define PCA9685_MODE1_AI        0x20    // Register auto-increment
+#define PCA9685_MODE1_SLEEP     0x10    // Oscillator off (prescaler is only writable here)
+#define PCA9685_MODE2_OUTDRV    0x04    // Totem pole outputs
+#define PCA9685_FULL_BIT        0x10    // Bit 4 of ON_H / OFF_H
+
+PCA9685Async::PCA9685Async()
+    : _begun(false), _dirty(false), _busy(false), _frequency(0.0f), _bursts(0), _errors(0) {
+    memset(_duty, 0, sizeof(_duty));
+    memset(_frame, 0, sizeof(_frame));
+}
+
+static bool writeReg(uint8_t reg, uint8_t value) {
+    uint8_t data[2] = {reg, value};
+    return HAL_I2CWrite(PCA9685_ADDR, data, 2, 10) == HAL_I2C_OK;
+}
+
+bool PCA9685Async::begin(uint16_t frequency) {
+    _begun = false;
+    uint8_t prescale = prescaleFor(frequency);
+
+    // Prescaler write needs the oscillator asleep; 500 us to restart it
+    bool ok = writeReg(PCA9685_MODE1, PCA9685_MODE1_SLEEP | PCA9685_MODE1_AI) &&
+              writeReg(PCA9685_PRE_SCALE, prescale) &&
+              writeReg(PCA9685_MODE2, PCA9685_MODE2_OUTDRV) &&
+              writeReg(PCA9685_MODE1, PCA9685_MODE1_AI);
+    if (!ok) return false;
+    HAL_DelayMicros(500);
+    if (!writeReg(PCA9685_MODE1, PCA9685_MODE1_RESTART | PCA9685_MODE1_AI)) return false;
+
+    _frequency = frequencyFor(prescale);
+    _begun = true;
+    _dirty = true;              // First flush turns every channel off
+    return true;
+}
+
+void PCA9685Async::setDuty(uint8_t channel, uint16_t duty) {
+    if (channel >= PCA9685_CHANNELS) return;
+    if (duty > PCA9685_DUTY_FULL) duty = PCA9685_DUTY_FULL;
+    if (_duty[channel] == duty) return;
+    _duty[channel] = duty;
+    _dirty = true;
+}
+
+void PCA9685Async::setMicroseconds(uint8_t channel, float us) {
+    setDuty(channel, dutyForMicroseconds(us, _frequency));
+}
+
+void PCA9685Async::onBurstDone(HAL_I2CError result, void* ctx) {
+    PCA9685Async* self = (PCA9685Async*)ctx;
+    if (result != HAL_I2C_OK) self->_errors++;
+    self->_busy = false;
+}
+
+bool PCA9685Async::flush() {
+    if (!_begun || !_dirty || _busy) return false;
+
+    buildFrame(_duty, _frame);
+    HAL_I2CTransaction t = {};
+    t.slaveAddr = PCA9685_ADDR;
+    t.txLen = PCA9685_FRAME_BYTES;
+    t.txExt = _frame;           // Longer than the inline buffer
+    t.timeoutMs = 10;
+    t.callback = onBurstDone;
+    t.ctx = this;
+
+    _busy = true;
+    if (!HAL_I2CSubmit(&t)) {
+        _busy = false;
+        _errors++;
+        return false;
+    }
+    _dirty = false;
+    _bursts++;
+    return true;
+}
+
+uint8_t PCA9685Async::prescaleFor(uint16_t frequency) {
+    if (frequency < PCA9685_MIN_HZ) frequency = PCA9685_MIN_HZ;
+    if (frequency > PCA9685_MAX_HZ) frequency = PCA9685_MAX_HZ;
+    long prescale = lroundf((float)PCA9685_OSC_HZ / (4096.0f * frequency)) - 1;
+    if (prescale < 3) prescale = 3;
+    if (prescale > 255) prescale = 255;
+    return (uint8_t)prescale;
+}
+
+float PCA9685Async::frequencyFor(uint8_t prescale) {
+    return (float)PCA9685_OSC_HZ / (4096.0f * (prescale + 1));
+}
+
+uint16_t PCA9685Async::dutyForMicroseconds(float us, float frequency) {
+    if (us <= 0.0f || frequency <= 0.0f) return 0;
+    float duty = us * frequency * (PCA9685_DUTY_FULL / 1000000.0f) + 0.5f;
+    return duty >= PCA9685_DUTY_FULL ? PCA9685_DUTY_FULL : (uint16_t)duty;
+}
+
+void PCA9685Async::buildFrame(const uint16_t duty[PCA9685_CHANNELS], uint8_t* frame) {
+    frame[0] = PCA9685_LED0_ON_L;
+    uint8_t* p = frame + 1;
+    for (uint8_t ch = 0; ch < PCA9685_CHANNELS; ch++, p += 4) {
+        uint16_t d = duty[ch];
+        if (d == 0) {
+            // Full off wins over everything else
+            p[0] = 0; p[1] = 0; p[2] = 0; p[3] = PCA9685_FULL_BIT;
+        } else if (d >= PCA9685_DUTY_FULL) {
+            p[0] = 0; p[1] = PCA9685_FULL_BIT; p[2] = 0; p[3] = 0;
+        } else {
+            // On at count 0, off after d counts
+            p[0] = 0; p[1] = 0; p[2] = (uint8_t)d; p[3] = (uint8_t)(d >> 8);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef PCA9685_ASYNC_H
+#define PCA9685_ASYNC_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+/**
+ * PCA9685Async - 16-channel I2C PWM expander (servos / ESCs / LEDs)
+ *
+ * Channel values are only stored by the set*() calls; flush() sends all
+ * 16 channels in one burst on the HAL I2C queue: register LED0_ON_L,
+ * then 64 data bytes, which the chip spreads over the channels with
+ * register auto-increment (MODE1 AI). One bus transaction per control
+ * tick, about 1.5 ms at 400 kHz, and the control task never waits.
+ *
+ * - Refresh rate 24-1526 Hz from the prescaler (25 MHz internal clock):
+ *   50 Hz analog servos, 300-400 Hz digital servos / ESCs, 1526 Hz LEDs
+ * - 12-bit duty per period; every channel starts its pulse at count 0
+ * - Duty 0 = full off (no pulse at all), PCA9685_DUTY_FULL = full on
+ * - While a burst is on the bus the frame buffer is left alone: new
+ *   values go out with the next flush()
+ * - Channels start full off until written, so nothing twitches at boot
+ */
+
+#define PCA9685_ADDR            0x40
+#define PCA9685_CHANNELS        16
+#define PCA9685_DUTY_FULL       4096    // 12-bit counter, this value = always on
+#define PCA9685_OSC_HZ          25000000UL
+#define PCA9685_MIN_HZ          24      // Prescaler 253
+#define PCA9685_MAX_HZ          1526    // Prescaler 3
+#define PCA9685_FRAME_BYTES     (1 + 4 * PCA9685_CHANNELS)
+
+#ifndef PCA9685_FREQUENCY_HZ
+#define PCA9685_FREQUENCY_HZ    50      // Refresh rate set at boot
+#endif
+
+class PCA9685Async {
+public:
+    PCA9685Async();
+
+    /**
+     * Set the refresh rate and wake the chip (blocks a few bus
+     * transactions, boot only). Requires HAL_I2CInit()
+     * @param frequency Refresh rate in Hz, clamped to 24-1526
+     * @return true if the chip answered
+     */
+    bool begin(uint16_t frequency);
+
+    /**
+     * Channel duty in 1/4096 of the period (0 = off, 4096 = on)
+     */
+    void setDuty(uint8_t channel, uint16_t duty);
+
+    /**
+     * Channel pulse width (servo / ESC), rounded to the nearest count
+     */
+    void setMicroseconds(uint8_t channel, float us);
+
+    /**
+     * Queue the burst if anything changed and the last one is done
+     * (never waits)
+     * @return true if a burst was submitted
+     */
+    bool flush();
+
+    bool isReady() const { return _begun; }
+    float getFrequency() const { return _frequency; }
+    uint16_t getDuty(uint8_t channel) const {
+        return channel < PCA9685_CHANNELS ? _duty[channel] : 0;
+    }
+    uint32_t getBurstCount() const { return _bursts; }
+    uint32_t getErrorCount() const { return _errors; }
+
+    /**
+     * Prescaler for a refresh rate: round(25 MHz / (4096 * f)) - 1,
+     * clamped to 3-253 (24-1526 Hz)
+     */
+    static uint8_t prescaleFor(uint16_t frequency);
+
+    /**
+     * Refresh rate a prescaler really produces, Hz
+     */
+    static float frequencyFor(uint8_t prescale);
+
+    /**
+     * Duty counts for a pulse width at a refresh rate (clamped to the period)
+     */
+    static uint16_t dutyForMicroseconds(float us, float frequency);
+
+    /**
+     * Encode a burst: register address, then ON_L ON_H OFF_L OFF_H per
+     * channel
+     * @param frame PCA9685_FRAME_BYTES output
+     */
+    static void buildFrame(const uint16_t duty[PCA9685_CHANNELS], uint8_t* frame);
+
+private:
+    static void onBurstDone(HAL_I2CError result, void* ctx);
+
+    bool _begun;
+    bool _dirty;
+    volatile bool _busy;        // Burst on the bus, _frame in use
+    float _frequency;
+    uint16_t _duty[PCA9685_CHANNELS];
+    uint8_t _frame[PCA9685_FRAME_BYTES];
+    uint32_t _bursts;
+    volatile uint32_t _errors;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "QMC5883LAsync.h"
+
+// Register map
+#define QMC_REG_DATA        0x00    // X LSB .. Z MSB, then status
+#define QMC_REG_STATUS      0x06
+#define QMC_REG_CONTROL1    0x09
+#define QMC_REG_CONTROL2    0x0A
+#define QMC_REG_SET_RESET   0x0B
+#define QMC_REG_CHIP_ID     0x0D
+
+#define QMC_STATUS_OVL      0x02
+#define QMC_CHIP_ID         0xFF
+
+// Continuous mode, 50 Hz, +-8 G, oversampling 512
+#define QMC_MODE_CONTINUOUS 0x01
+#define QMC_ODR_50HZ        (1 << 2)
+#define QMC_RANGE_8G        (1 << 4)
+#define QMC_OSR_512         (0 << 6)
+#define QMC_SOFT_RESET      0x80
+
+QMC5883LAsync::QMC5883LAsync()
+    : _begun(false), _reading(false), _readDone(false), _readOk(false), _lastUs(0),
+      _samples(0), _errors(0) {
+    memset(_raw, 0, sizeof(_raw));
+    memset(_field, 0, sizeof(_field));
+}
+
+bool QMC5883LAsync::writeReg(uint8_t reg, uint8_t value) {
+    uint8_t buf[2] = {reg, value};
+    return HAL_I2CWrite(QMC5883L_ADDR, buf, 2, 10) == HAL_I2C_OK;
+}
+
+bool QMC5883LAsync::begin() {
+    _begun = false;
+    _reading = false;
+
+    uint8_t id = 0;
+    if (HAL_I2CReadReg(QMC5883L_ADDR, QMC_REG_CHIP_ID, &id, 1, 10) != 1 || id != QMC_CHIP_ID)
+        return false;
+    bool ok = writeReg(QMC_REG_CONTROL2, QMC_SOFT_RESET);
+    delay(2);
+    ok = ok && writeReg(QMC_REG_SET_RESET, 0x01);           // Recommended period
+    ok = ok && writeReg(QMC_REG_CONTROL1,
+                        QMC_OSR_512 | QMC_RANGE_8G | QMC_ODR_50HZ | QMC_MODE_CONTINUOUS);
+    _begun = ok;
+    return _begun;
+}
+
+void QMC5883LAsync::onReadDone(HAL_I2CError result, void* ctx) {
+    QMC5883LAsync* self = (QMC5883LAsync*)ctx;
+    self->_readOk = result == HAL_I2C_OK;
+    self->_readDone = true;
+}
+
+bool QMC5883LAsync::update(uint32_t nowUs) {
+    if (!_begun) return false;
+
+    bool fresh = false;
+
+    // 1. Collect a finished read
+    if (_reading && _readDone) {
+        _reading = false;
+        float field[3];
+        Status status = _readOk ? parse(_raw, field) : STATUS_OVERFLOW;
+        if (status == STATUS_OK) {
+            memcpy(_field, field, sizeof(_field));
+            _samples++;
+            fresh = true;
+        } else {
+            _errors++;
+        }
+    }
+
+    // 2. Next read once the period is up
+    if (!_reading && nowUs - _lastUs >= QMC5883L_PERIOD_US) {
+        HAL_I2CTransaction t = {};
+        t.slaveAddr = QMC5883L_ADDR;
+        t.tx[0] = QMC_REG_DATA;
+        t.txLen = 1;
+        t.rxLen = sizeof(_raw);
+        t.rx = _raw;
+        t.timeoutMs = 10;
+        t.callback = onReadDone;
+        t.ctx = this;
+
+        _readDone = false;
+        _lastUs = nowUs;
+        if (HAL_I2CSubmit(&t)) _reading = true;
+        else _errors++;
+    }
+
+    return fresh;
+}
+
+QMC5883LAsync::Status QMC5883LAsync::parse(const uint8_t* raw, float field[3]) {
+    uint8_t status = raw[QMC_REG_STATUS];
+    if (status & QMC_STATUS_OVL) return STATUS_OVERFLOW;
+    for (int axis = 0; axis < 3; axis++) {
+        int16_t v = (int16_t)(raw[axis * 2] | (raw[axis * 2 + 1] << 8));
+        field[axis] = v * QMC5883L_UT_PER_LSB;
+    }
+    return STATUS_OK;
+}
@@ -0,0 +1,80 @@
+#ifndef QMC5883L_ASYNC_H
+#define QMC5883L_ASYNC_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+/**
+ * QMC5883LAsync - Non-blocking QMC5883L magnetometer driver
+ *
+ * The QMC5883L (GY-271 and most cheap "HMC5883L" boards) converts
+ * continuously at QMC5883L_ODR; one 7-byte read from register 0 returns
+ * X, Y, Z and the status byte. update() is polled like MS4525Async: it
+ * queues that read on the HAL I2C queue every QMC5883L_PERIOD_US and
+ * picks the result up on a later call, so the sensor task never waits
+ * on the bus.
+ *
+ * - Range +-8 G (3000 LSB/G): hard iron next to motors and batteries does
+ *   not saturate it, resolution is still 0.03 uT
+ * - Overflowing reads are counted as errors. DRDY is not checked: the
+ *   data read clears it before the status byte goes out in the same
+ *   burst, and a repeated sample at the ODR boundary is harmless
+ * - Output in uT on the chip axes; the board must be mounted with X / Y
+ *   / Z along the MPU6050's (z up), or the heading is wrong
+ */
+
+#define QMC5883L_ADDR           0x0D
+#define QMC5883L_PERIOD_US      20000   // 50 Hz, the output data rate
+#define QMC5883L_UT_PER_LSB     (100.0f / 3000.0f)
+
+class QMC5883LAsync {
+public:
+    enum Status : uint8_t {
+        STATUS_OK = 0,
+        STATUS_OVERFLOW = 1     // An axis is out of range
+    };
+
+    QMC5883LAsync();
+
+    /**
+     * Probe and configure the sensor (blocks a few bus transactions, boot
+     * only). Requires HAL_I2CInit()
+     * @return true if the sensor answered
+     */
+    bool begin();
+
+    /**
+     * Advance the read state machine (never waits)
+     * @param nowUs Current time (micros)
+     * @return true if a new reading was completed this call
+     */
+    bool update(uint32_t nowUs);
+
+    bool isReady() const { return _begun; }
+    const float* field() const { return _field; }          // uT, chip axes
+    uint32_t getSampleCount() const { return _samples; }
+    uint32_t getErrorCount() const { return _errors; }
+
+    /**
+     * Decode a 7-byte reading (X, Y, Z little endian, then status)
+     * @param field Output field, uT
+     */
+    static Status parse(const uint8_t* raw, float field[3]);
+
+private:
+    static void onReadDone(HAL_I2CError result, void* ctx);
+    bool writeReg(uint8_t reg, uint8_t value);
+
+    bool _begun;
+    bool _reading;              // Read in flight on the bus
+    uint8_t _raw[7];
+    volatile bool _readDone;    // Set by the bus task
+    volatile bool _readOk;
+    uint32_t _lastUs;
+
+    float _field[3];
+    uint32_t _samples;
+    uint32_t _errors;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include "SSD1306Async.h"
+
+#define SSD1306_CONTROL_CMD     0x00    // Control byte: commands follow
+#define SSD1306_CONTROL_DATA    0x40    // Control byte: display RAM follows
+#define SSD1306_COLUMN_ADDR     0x21
+#define SSD1306_PAGE_ADDR       0x22
+#define SSD1306_CLEAN           0xFF    // _dirtyFirst of a clean page
+
+// 5x7 glyphs, ASCII 0x20-0x7E, one byte per column, LSB at the top
+static const uint8_t FONT_5X7[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, // ' ' !
+    {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14}, // " #
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, // $ %
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, // & '
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00}, // ( )
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08}, // * +
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, // , -
+    {0x00, 0x60, 0x60, 0x00, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02}, // . /
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, // 0 1
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, // 2 3
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39}, // 4 5
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03}, // 6 7
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, // 8 9
+    {0x00, 0x36, 0x36, 0x00, 0x00}, {0x00, 0x56, 0x36, 0x00, 0x00}, // : ;
+    {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, // < =
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, // > ?
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, {0x7E, 0x11, 0x11, 0x11, 0x7E}, // @ A
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22}, // B C
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, // D E
+    {0x7F, 0x09, 0x09, 0x01, 0x01}, {0x3E, 0x41, 0x41, 0x51, 0x32}, // F G
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, // H I
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, // J K
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x04, 0x02, 0x7F}, // L M
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E}, // N O
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, // P Q
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x46, 0x49, 0x49, 0x49, 0x31}, // R S
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, // T U
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x7F, 0x20, 0x18, 0x20, 0x7F}, // V W
+    {0x63, 0x14, 0x08, 0x14, 0x63}, {0x03, 0x04, 0x78, 0x04, 0x03}, // X Y
+    {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00}, // Z [
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, // \ ]
+    {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40}, // ^ _
+    {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, // ` a
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, // b c
+    {0x38, 0x44, 0x44, 0x48, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18}, // d e
+    {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x08, 0x14, 0x54, 0x54, 0x3C}, // f g
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, // h i
+    {0x20, 0x40, 0x44, 0x3D, 0x00}, {0x00, 0x7F, 0x10, 0x28, 0x44}, // j k
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, // l m
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, // n o
+    {0x7C, 0x14, 0x14, 0x14, 0x08}, {0x08, 0x14, 0x14, 0x18, 0x7C}, // p q
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20}, // r s
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, // t u
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C}, // v w
+    {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, // x y
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, // z {
+    {0x00, 0x00, 0x7F, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00}, // | }
+    {0x08, 0x04, 0x08, 0x10, 0x08},                                 // ~
+};
+
+// 128x64, internal charge pump, horizontal addressing
+static const uint8_t INIT_SEQUENCE[] = {
+    SSD1306_CONTROL_CMD,
+    0xAE,               // Display off
+    0xD5, 0x80,         // Clock divide / oscillator
+    0xA8, 0x3F,         // Multiplex 64
+    0xD3, 0x00,         // No display offset
+    0x40,               // Start line 0
+    0x8D, 0x14,         // Charge pump on
+    0x20, 0x00,         // Horizontal addressing: column, then page wraps
+    0xA1,               // Segment remap (column 127 = SEG0)
+    0xC8,               // COM scan from the bottom
+    0xDA, 0x12,         // COM pins, alternative
+    0x81, 0xCF,         // Contrast
+    0xD9, 0xF1,         // Pre-charge
+    0xDB, 0x40,         // VCOMH deselect
+    0xA4,               // Show RAM
+    0xA6,               // Not inverted
+};
+
+SSD1306Async::SSD1306Async() : _begun(false), _busy(false), _bytesSent(0), _errors(0) {
+    memset(_buffer, 0, sizeof(_buffer));
+    memset(_dirtyFirst, SSD1306_CLEAN, sizeof(_dirtyFirst));
+    memset(_dirtyLast, 0, sizeof(_dirtyLast));
+    memset(_chunk, 0, sizeof(_chunk));
+}
+
+bool SSD1306Async::begin() {
+    _begun = false;
+    if (HAL_I2CWrite(SSD1306_ADDR, INIT_SEQUENCE, sizeof(INIT_SEQUENCE), 50) != HAL_I2C_OK)
+        return false;
+
+    // Panel RAM powers up random: clear it all to match the framebuffer
+    const uint8_t window[] = {SSD1306_CONTROL_CMD, SSD1306_COLUMN_ADDR, 0, SSD1306_WIDTH - 1,
+                              SSD1306_PAGE_ADDR, 0, SSD1306_PAGES - 1};
+    if (HAL_I2CWrite(SSD1306_ADDR, window, sizeof(window), 10) != HAL_I2C_OK) return false;
+    uint8_t zeros[1 + SSD1306_CHUNK_COLUMNS] = {SSD1306_CONTROL_DATA};
+    for (int sent = 0; sent < SSD1306_PAGES * SSD1306_WIDTH; sent += SSD1306_CHUNK_COLUMNS) {
+        if (HAL_I2CWrite(SSD1306_ADDR, zeros, sizeof(zeros), 10) != HAL_I2C_OK) return false;
+    }
+    clear();
+    memset(_dirtyFirst, SSD1306_CLEAN, sizeof(_dirtyFirst));
+
+    const uint8_t on[] = {SSD1306_CONTROL_CMD, 0xAF};
+    if (HAL_I2CWrite(SSD1306_ADDR, on, sizeof(on), 10) != HAL_I2C_OK) return false;
+    _begun = true;
+    return true;
+}
+
+void SSD1306Async::putByte(uint8_t page, uint8_t column, uint8_t value) {
+    if (_buffer[page][column] == value) return;
+    _buffer[page][column] = value;
+    if (_dirtyFirst[page] == SSD1306_CLEAN) {
+        _dirtyFirst[page] = column;
+        _dirtyLast[page] = column;
+    } else {
+        if (column < _dirtyFirst[page]) _dirtyFirst[page] = column;
+        if (column > _dirtyLast[page]) _dirtyLast[page] = column;
+    }
+}
+
+void SSD1306Async::setLine(uint8_t row, const char* text) {
+    if (row >= SSD1306_TEXT_ROWS) return;
+    uint8_t column = 0;
+    bool ended = text == nullptr;
+    for (uint8_t i = 0; i < SSD1306_TEXT_COLUMNS; i++) {
+        char c = ended ? ' ' : text[i];
+        if (c == '\0') {
+            ended = true;
+            c = ' ';
+        }
+        if (c < 0x20 || c > 0x7E) c = '?';
+        const uint8_t* glyph = FONT_5X7[c - 0x20];
+        for (uint8_t x = 0; x < 5; x++) putByte(row, column++, glyph[x]);
+        putByte(row, column++, 0x00);
+    }
+    // Columns 126-127 stay blank
+    while (column < SSD1306_WIDTH) putByte(row, column++, 0x00);
+}
+
+void SSD1306Async::clear() {
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        for (uint8_t column = 0; column < SSD1306_WIDTH; column++) putByte(page, column, 0x00);
+    }
+}
+
+bool SSD1306Async::nextDirty(uint8_t* page, uint8_t* first, uint8_t* last) const {
+    for (uint8_t p = 0; p < SSD1306_PAGES; p++) {
+        if (_dirtyFirst[p] == SSD1306_CLEAN) continue;
+        *page = p;
+        *first = _dirtyFirst[p];
+        *last = _dirtyLast[p];
+        return true;
+    }
+    return false;
+}
+
+void SSD1306Async::onChunkDone(HAL_I2CError result, void* ctx) {
+    SSD1306Async* self = (SSD1306Async*)ctx;
+    if (result != HAL_I2C_OK) self->_errors++;
+    self->_busy = false;
+}
+
+bool SSD1306Async::flush() {
+    if (!_begun || _busy) return false;
+    uint8_t page, first, last;
+    if (!nextDirty(&page, &first, &last)) return false;
+    if (last - first >= SSD1306_CHUNK_COLUMNS) last = first + SSD1306_CHUNK_COLUMNS - 1;
+
+    // Window first: FIFO order on the queue keeps it ahead of its data
+    HAL_I2CTransaction cmd = {};
+    cmd.slaveAddr = SSD1306_ADDR;
+    cmd.tx[0] = SSD1306_CONTROL_CMD;
+    cmd.tx[1] = SSD1306_COLUMN_ADDR;
+    cmd.tx[2] = first;
+    cmd.tx[3] = last;
+    cmd.tx[4] = SSD1306_PAGE_ADDR;
+    cmd.tx[5] = page;
+    cmd.tx[6] = page;
+    cmd.txLen = 7;
+    cmd.timeoutMs = 10;
+    if (!HAL_I2CSubmit(&cmd)) {
+        _errors++;
+        return false;
+    }
+
+    uint8_t count = last - first + 1;
+    _chunk[0] = SSD1306_CONTROL_DATA;
+    memcpy(_chunk + 1, &_buffer[page][first], count);
+    HAL_I2CTransaction data = {};
+    data.slaveAddr = SSD1306_ADDR;
+    data.txLen = 1 + count;
+    data.txExt = _chunk;
+    data.timeoutMs = 10;
+    data.callback = onChunkDone;
+    data.ctx = this;
+    _busy = true;
+    if (!HAL_I2CSubmit(&data)) {
+        _busy = false;
+        _errors++;
+        return false;
+    }
+
+    // Whatever changes from here on marks the page again
+    if (last >= _dirtyLast[page]) _dirtyFirst[page] = SSD1306_CLEAN;
+    else _dirtyFirst[page] = last + 1;
+    _bytesSent += 1 + count;
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef SSD1306_ASYNC_H
+#define SSD1306_ASYNC_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+/**
+ * SSD1306Async - 128x64 I2C OLED with a local framebuffer
+ *
+ * Drawing only changes the framebuffer in RAM; every byte that really
+ * changed widens its page's dirty column range. flush() then sends at
+ * most one piece of one dirty page on the HAL I2C queue and returns:
+ *
+ *   command txn: set column first..last, page p   (7 bytes, inline)
+ *   data txn:    0x40 + up to SSD1306_CHUNK_COLUMNS bytes
+ *
+ * so a screen where one number changed costs a few bytes of bus time,
+ * and a full redraw is spread over 16 calls instead of one 1 KB write
+ * holding the bus in front of the IMU / PWM transactions.
+ *
+ * - Text is 5x7 in 6x8 cells, 21 columns x 8 rows, rows on pages
+ * - The panel is cleared by begin() (blocking, boot only), after which
+ *   framebuffer and panel agree
+ * - One piece in flight at a time; the data is copied at submit, so
+ *   drawing may continue meanwhile
+ * - Owned by one task: draw and flush from the same one
+ */
+
+#define SSD1306_ADDR            0x3C
+#define SSD1306_WIDTH           128
+#define SSD1306_PAGES           8       // 8 pixel rows each
+#define SSD1306_CHUNK_COLUMNS   64      // Data bytes per transaction (Wire buffer is 128)
+#define SSD1306_TEXT_COLUMNS    21
+#define SSD1306_TEXT_ROWS       SSD1306_PAGES
+
+class SSD1306Async {
+public:
+    SSD1306Async();
+
+    /**
+     * Configure the panel, clear it and switch it on (blocking, boot
+     * only). Requires HAL_I2CInit()
+     * @return true if the panel answered
+     */
+    bool begin();
+
+    /**
+     * Draw one text row, padded with blanks to the full width
+     * @param row 0-7
+     * @param text Printable ASCII; anything else is drawn as '?'
+     */
+    void setLine(uint8_t row, const char* text);
+
+    /**
+     * Blank the framebuffer
+     */
+    void clear();
+
+    /**
+     * Send the next dirty piece if the last one is done (never waits)
+     * @return true if a piece was submitted
+     */
+    bool flush();
+
+    /**
+     * First dirty page and its column range
+     * @return false if the panel is up to date
+     */
+    bool nextDirty(uint8_t* page, uint8_t* first, uint8_t* last) const;
+
+    bool isReady() const { return _begun; }
+    uint8_t getByte(uint8_t page, uint8_t column) const {
+        return page < SSD1306_PAGES && column < SSD1306_WIDTH ? _buffer[page][column] : 0;
+    }
+    uint32_t getBytesSent() const { return _bytesSent; }
+    uint32_t getErrorCount() const { return _errors; }
+
+private:
+    static void onChunkDone(HAL_I2CError result, void* ctx);
+
+    void putByte(uint8_t page, uint8_t column, uint8_t value);
+
+    bool _begun;
+    volatile bool _busy;        // Piece on the bus
+    uint8_t _buffer[SSD1306_PAGES][SSD1306_WIDTH];
+    uint8_t _dirtyFirst[SSD1306_PAGES];
+    uint8_t _dirtyLast[SSD1306_PAGES];  // first > last = clean
+    uint8_t _chunk[1 + SSD1306_CHUNK_COLUMNS];
+    uint32_t _bytesSent;
+    volatile uint32_t _errors;
+};
+
+#endif
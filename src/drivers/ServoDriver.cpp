@@ -1,25 +1,57 @@
 #include "ServoDriver.h"
+#include "HAL.h"
 
-ServoDriver::ServoDriver(int pin) : _pin(pin), _centerAngle(90) {}
+ServoDriver::ServoDriver(int pin, int initialAngle, uint16_t frequency)
+    : _pin(pin), _centerAngle(initialAngle), _channel(-1),
+      _frequency(constrain(frequency, 1, SERVO_MAX_FREQUENCY_HZ)),
+      _minUs(SERVO_MIN_US), _maxUs(SERVO_MAX_US),
+      _countsPerUs(_frequency * (float)(1UL << SERVO_RESOLUTION) / 1000000.0f),
+      _pulseUs(0.0f) {}
 
-ServoDriver::ServoDriver(int pin, int initialAngle) : _pin(pin), _centerAngle(initialAngle) {}
+void ServoDriver::configure(const PinMapOutput& out) {
+    _pin = out.pin;
+    if (out.frequency) {
+        _frequency = constrain(out.frequency, 1, SERVO_MAX_FREQUENCY_HZ);
+        _countsPerUs = _frequency * (float)(1UL << SERVO_RESOLUTION) / 1000000.0f;
+    }
+}
+
+bool ServoDriver::setup() {
+    if (_pin < 0) return false;     // Not fitted
+    _channel = HAL_PWMAllocate(_pin, _frequency, SERVO_RESOLUTION);
+    if (_channel < 0) {
+        Serial.printf("[SERVO] No PWM channel for GPIO %d\n", _pin);
+        return false;
+    }
+    // The pulse is on from here; nothing to wait for while the horn moves
+    write(_centerAngle);
+    return true;
+}
 
-void ServoDriver::setup() {
-    _servo.attach(_pin);
-    _servo.write(_centerAngle);
-    delay(50);  // Allow servo to settle
+void ServoDriver::setPulseRange(uint16_t minUs, uint16_t maxUs) {
+    if (minUs >= maxUs) return;
+    _minUs = constrain(minUs, SERVO_MIN_US, SERVO_MAX_US);
+    _maxUs = constrain(maxUs, SERVO_MIN_US, SERVO_MAX_US);
 }
 
 void ServoDriver::write(int angle) {
     // Constrain to valid servo range (0-180 degrees)
-    int originalAngle = angle;
     if (angle < 0) angle = 0;
     if (angle > 180) angle = 180;
-    
-    // Log if trying to exceed bounds
-    if (angle != originalAngle) {
-        Serial.printf("[SERVO] Constrained %d to %d\n", originalAngle, angle);
-    }
-    
-    _servo.write(angle);
+    writeMicroseconds(_minUs + angle * (_maxUs - _minUs) / 180.0f);
+}
+
+void ServoDriver::writeNormalized(float value) {
+    if (value < -1.0f) value = -1.0f;
+    if (value > 1.0f) value = 1.0f;
+    writeMicroseconds(_minUs + (value + 1.0f) * 0.5f * (_maxUs - _minUs));
+}
+
+void ServoDriver::writeMicroseconds(float us) {
+    // Hot path: clamp without logging
+    if (us < _minUs) us = _minUs;
+    if (us > _maxUs) us = _maxUs;
+    _pulseUs = us;
+    if (_channel < 0) return;
+    HAL_PWMWrite(_channel, (uint32_t)(us * _countsPerUs + 0.5f));
 }
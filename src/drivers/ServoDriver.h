@@ -2,19 +2,79 @@
 #define SERVO_DRIVER_H
 
 #include <Arduino.h>
-#include <ESP32Servo.h>
+#include "../PinMap.h"
+
+/**
+ * ServoDriver - Hobby servo on a LEDC channel from the HAL registry
+ *
+ * The channel is requested in setup() (no ESP32Servo, which kept its own
+ * channel table); servos at the same refresh rate share one timer.
+ *
+ * Output is written as pulse width, straight into a 16-bit duty:
+ * - 50 Hz: 0.3 us per count, 333 Hz (digital servos): 0.05 us per count
+ * - writeMicroseconds() / writeNormalized() clamp silently to the pulse
+ *   range, so they are safe to call every control cycle
+ * - write(angle) maps 0-180 onto the pulse range (coarse, 1 degree steps)
+ */
+
+#define SERVO_FREQUENCY_HZ      50
+#define SERVO_MAX_FREQUENCY_HZ  333     // Pulse period must exceed SERVO_MAX_US
+#define SERVO_RESOLUTION        16
+#define SERVO_MIN_US            544     // Same range as the Arduino Servo library
+#define SERVO_MAX_US            2400
 
 class ServoDriver {
 public:
-    ServoDriver(int pin);
-    ServoDriver(int pin, int initialAngle);
-    void setup();
+    /**
+     * Constructor
+     * @param pin           ESP32 GPIO pin for the servo signal
+     * @param initialAngle  Angle written in setup()
+     * @param frequency     Refresh rate in Hz (50 analog, up to 333 digital)
+     */
+    ServoDriver(int pin, int initialAngle = 90, uint16_t frequency = SERVO_FREQUENCY_HZ);
+
+    /**
+     * Replace pin and refresh rate from a hardware profile output (before
+     * setup); pin -1 = not fitted, frequency 0 = keep. Resolution is fixed
+     * at SERVO_RESOLUTION.
+     */
+    void configure(const PinMapOutput& out);
+
+    /**
+     * Request a PWM channel and move to the initial angle
+     * @return false if no channel was available
+     */
+    bool setup();
+
+    /**
+     * Limit the pulse range (e.g. to the control surface travel)
+     * Used by write(), writeNormalized() and as the writeMicroseconds() clamp
+     */
+    void setPulseRange(uint16_t minUs, uint16_t maxUs);
+
     void write(int angle); // 0-180
 
+    /**
+     * Set pulse width, clamped to the pulse range
+     */
+    void writeMicroseconds(float us);
+
+    /**
+     * Set position as -1..1 across the pulse range (0 = center)
+     */
+    void writeNormalized(float value);
+
+    float getMicroseconds() const { return _pulseUs; }
+
 private:
     int _pin;
     int _centerAngle;
-    Servo _servo;
+    int _channel;
+    uint16_t _frequency;
+    uint16_t _minUs;
+    uint16_t _maxUs;
+    float _countsPerUs;     // Duty counts per microsecond of pulse
+    float _pulseUs;
 };
 
 #endif
@@ -0,0 +1,93 @@
+#include "UltrasonicRMT.h"
+#include "../Rangefinder.h"
+#include <soc/soc_caps.h>
+
+#define RANGE_CLK_DIV           80      // 1 us ticks from the 80 MHz APB clock
+#define RANGE_TRIGGER_US        10
+#define RANGE_RX_FILTER_TICKS   100     // APB cycles: ignore glitches under 1.25 us
+#define RANGE_RX_BUFFER_SIZE    256
+
+// The last TX and RX channels (ESP32: any channel does either; ESP32-S3:
+// 0-3 TX only, 4-7 RX only)
+#if SOC_RMT_TX_CANDIDATES_PER_GROUP < SOC_RMT_CHANNELS_PER_GROUP
+#define RANGE_TX_CHANNEL        (SOC_RMT_TX_CANDIDATES_PER_GROUP - 1)
+#else
+#define RANGE_TX_CHANNEL        (RMT_CHANNEL_MAX - 2)
+#endif
+#define RANGE_RX_CHANNEL        (RMT_CHANNEL_MAX - 1)
+
+static_assert(RANGE_ECHO_TIMEOUT_US <= 0xFFFF, "RMT idle threshold is 16 bits");
+static_assert(RANGE_ECHO_TIMEOUT_US < 0x8000, "Echo must fit one 15-bit RMT run");
+
+UltrasonicRMT::UltrasonicRMT()
+    : _txChannel((rmt_channel_t)RANGE_TX_CHANNEL), _rxChannel((rmt_channel_t)RANGE_RX_CHANNEL),
+      _rxBuffer(nullptr), _begun(false), _pending(false), _lastTriggerUs(0), _echoUs(0),
+      _samples(0), _missed(0) {
+    _trigger.level0 = 1;
+    _trigger.duration0 = RANGE_TRIGGER_US;
+    _trigger.level1 = 0;
+    _trigger.duration1 = RANGE_TRIGGER_US;
+}
+
+bool UltrasonicRMT::begin(int trigPin, int echoPin) {
+    if (trigPin < 0 || echoPin < 0) return false;     // Not fitted
+
+    rmt_config_t rxConfig = RMT_DEFAULT_CONFIG_RX((gpio_num_t)echoPin, _rxChannel);
+    rxConfig.clk_div = RANGE_CLK_DIV;
+    rxConfig.rx_config.filter_en = true;
+    rxConfig.rx_config.filter_ticks_thresh = RANGE_RX_FILTER_TICKS;
+    rxConfig.rx_config.idle_threshold = RANGE_ECHO_TIMEOUT_US;
+    if (rmt_config(&rxConfig) != ESP_OK ||
+        rmt_driver_install(_rxChannel, RANGE_RX_BUFFER_SIZE, 0) != ESP_OK ||
+        rmt_get_ringbuf_handle(_rxChannel, &_rxBuffer) != ESP_OK) {
+        Serial.printf("[RANGE] RMT RX setup failed on GPIO %d\n", echoPin);
+        return false;
+    }
+
+    rmt_config_t txConfig = RMT_DEFAULT_CONFIG_TX((gpio_num_t)trigPin, _txChannel);
+    txConfig.clk_div = RANGE_CLK_DIV;
+    txConfig.tx_config.idle_output_en = true;
+    txConfig.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    if (rmt_config(&txConfig) != ESP_OK || rmt_driver_install(_txChannel, 0, 0) != ESP_OK) {
+        Serial.printf("[RANGE] RMT TX setup failed on GPIO %d\n", trigPin);
+        rmt_driver_uninstall(_rxChannel);
+        _rxBuffer = nullptr;
+        return false;
+    }
+
+    rmt_rx_start(_rxChannel, true);
+    _begun = true;
+    return true;
+}
+
+bool UltrasonicRMT::collect() {
+    bool fresh = false;
+    size_t size = 0;
+    rmt_item32_t* items;
+    while ((items = (rmt_item32_t*)xRingbufferReceive(_rxBuffer, &size, 0)) != nullptr) {
+        // One capture per echo: the high run, then the line idles low. A
+        // run cut off by the idle threshold comes back with duration 0
+        if (size >= sizeof(rmt_item32_t) && items[0].level0 == 1 && _pending) {
+            _echoUs = items[0].duration0;
+            _pending = false;
+            _samples++;
+            fresh = true;
+        }
+        vRingbufferReturnItem(_rxBuffer, items);
+    }
+    return fresh;
+}
+
+bool UltrasonicRMT::update(uint32_t nowUs) {
+    if (!_begun) return false;
+
+    bool fresh = collect();
+
+    if (nowUs - _lastTriggerUs >= RANGE_PERIOD_MS * 1000UL) {
+        if (_pending) _missed++;
+        rmt_write_items(_txChannel, &_trigger, 1, false);
+        _pending = true;
+        _lastTriggerUs = nowUs;
+    }
+    return fresh;
+}
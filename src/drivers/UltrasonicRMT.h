@@ -0,0 +1,63 @@
+#ifndef ULTRASONIC_RMT_H
+#define ULTRASONIC_RMT_H
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+
+/**
+ * UltrasonicRMT - Trigger / echo ultrasonic ranger timed by the RMT
+ *
+ * No pulseIn(): one RMT channel sends the 10 us trigger pulse and
+ * another captures the echo line at 1 us resolution into its ring
+ * buffer, so neither the trigger nor the echo (up to 25 ms) is waited
+ * for. update() is polled like the I2C drivers: it collects a finished
+ * capture and fires the next trigger every RANGE_PERIOD_MS.
+ *
+ * - An echo held past RANGE_ECHO_TIMEOUT_US ends the capture with an
+ *   open run: no target, reported as echo 0
+ * - A trigger with no capture at all before the next one (echo line
+ *   dead, sensor unpowered) is counted as missed and reports nothing,
+ *   so the reading goes stale
+ * - RMT channels are taken from the top (DShotESC counts up from 0)
+ */
+class UltrasonicRMT {
+public:
+    UltrasonicRMT();
+
+    /**
+     * Claim the RMT channels and arm the echo capture
+     * @return false if a pin is -1 or the RMT setup failed
+     */
+    bool begin(int trigPin, int echoPin);
+
+    /**
+     * Collect an echo / fire the next trigger (never waits)
+     * @param nowUs Current time (micros)
+     * @return true if a new reading was completed this call
+     */
+    bool update(uint32_t nowUs);
+
+    /**
+     * Last echo pulse width, us (0 = no target in range)
+     */
+    uint32_t echoUs() const { return _echoUs; }
+    uint32_t getSampleCount() const { return _samples; }
+    uint32_t getMissedCount() const { return _missed; }
+
+private:
+    rmt_channel_t _txChannel;
+    rmt_channel_t _rxChannel;
+    RingbufHandle_t _rxBuffer;
+    rmt_item32_t _trigger;
+    bool _begun;
+    bool _pending;              // Triggered, no capture yet
+    uint32_t _lastTriggerUs;
+
+    uint32_t _echoUs;
+    uint32_t _samples;
+    uint32_t _missed;
+
+    bool collect();
+};
+
+#endif
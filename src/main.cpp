@@ -1,29 +1,123 @@
+#include "AltitudeHold.h"
+#include "AttitudeEstimator.h"
+#include "BaroAltitude.h"
+#include "BatteryEstimator.h"
 #include "BatteryManager.h"
+#include "Blackbox.h"
+#include "BiquadFilter.h"
+#include "BlackboxReader.h"
+#include "BleService.h"
+#include "BootSequence.h"
+#include "ClockSync.h"
+#include "CommandRouter.h"
+#include "ConfigBackup.h"
 #include "ConfigManager.h"
+#include "ConfigSync.h"
+#include "ControlArbiter.h"
+#include "Crc16.h"
+#include "CrsfTelemetry.h"
+#include "CryptoBackend.h"
+#include "DynamicNotch.h"
 #include "EncryptionManager.h"
 #include "FailsafeManager.h"
+#include "FastMath.h"
+#include "Features.h"
+#include "FlyByWire.h"
+#include "GPSManager.h"
+#include "Geofence.h"
 #include "HAL.h"
 #include "HMACValidator.h"
+#include "HostProtocol.h"
+#include "IMUManager.h"
+#include "ImuCal.h"
+#include "InputConditioner.h"
+#include "JobExecutor.h"
+#include "JsonArena.h"
+#include "JsonTemplate.h"
 #include "JoystickCalibrator.h"
+#include "LatencyProbe.h"
+#include "LinkRate.h"
+#include "Log.h"
+#include "MagCal.h"
+#include "MavLink.h"
+#include "MavMission.h"
+#include "MemPlacement.h"
 #include "MemoryProfiler.h"
+#include "Metrics.h"
+#include "MotorCal.h"
+#include "NAPacketAEAD.h"
+#include "NAPacketCompact.h"
+#include "NAHandshakeX25519.h"
+#include "NAHandshakeResume.h"
+#include "NAFormationBeacon.h"
+#include "NAFleetOta.h"
+#include "NARtcmFragment.h"
+#include "OccupancyGrid.h"
 #include "OTAUpdater.h"
+#include "OTASignature.h"
+#include "PathPlanner.h"
+#include "PeerSessionTable.h"
+#include "PositionEstimator.h"
+#include "PowerMonitor.h"
+#include "PowerPolicy.h"
 #include "RSSIManager.h"
 #include "RateLimitManager.h"
+#include "RateProfile.h"
+#include "RcInput.h"
+#include "RcReceiver.h"
+#include "RpmFilter.h"
+#include "ReplayWindow.h"
+#include "RxFilter.h"
+#include "SecureRandom.h"
+#include "SessionKeys.h"
+#include "SessionResume.h"
 #include "KeyExchangeManager.h"
 #include "NavigationManager.h"
 #include "WaypointManager.h"
 #include "TelemetryWebSocket.h"
+#include "TelemetryDelta.h"
+#include "TelemetrySnapshot.h"
+#include "TelemetryStreams.h"
+#include "TelemetryTrend.h"
+#include "MissionLibrary.h"
+#include "StatusScreen.h"
+#include "ThrustAllocator.h"
+#include "ThrustCurve.h"
+#include "Topics.h"
+#include "TotalEnergy.h"
+#include "UpdateCheck.h"
+#include "Watchdog.h"
+#include "WarmRestart.h"
+#include "WebAssets.h"
+#include "WheelOdometry.h"
+#include "WifiLink.h"
+#include "EspNowTx.h"
 #include "DepthManager.h"
+#include "drivers/MS4525Async.h"
+#include "drivers/MS5611Async.h"
+#include "drivers/PCA9685Async.h"
+#include "drivers/QMC5883LAsync.h"
+#include "drivers/SSD1306Async.h"
+#include "drivers/UltrasonicRMT.h"
+#include "TaskScheduler.h"
+#include "Trace.h"
+#include "LoopTiming.h"
+#include "SPSCRing.h"
+#include "SerialLineReader.h"
 #include <ESPAsyncWebServer.h>
 #include "vehicles/Copter.h"
 #include "vehicles/Plane.h"
 #include "vehicles/Rover.h"
 #include "vehicles/Sub.h"
 #include "vehicles/Vehicle.h"
+#include "vehicles/VehicleRegistry.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <WiFi.h>
+#include <esp_idf_version.h>
 #include <esp_now.h>
+#include <esp_pm.h>
+#include <esp_system.h>
 #include <mbedtls/base64.h>
 
 // Helper macro for safe object allocation
@@ -36,107 +130,1428 @@
 FailsafeManager failsafeManager;
 ConfigManager *configManager = nullptr;
 BatteryManager *batteryManager = nullptr;
+#if FEATURE_GPS
+GPSManager *gpsManager = nullptr;
+#else
+GPSManager *const gpsManager = nullptr; // Every "if (gpsManager)" folds away
+#endif
 RSSIManager *rssiManager = nullptr;
 JoystickCalibrator *joystickCalibrator = nullptr;
-Vehicle *vehicle = nullptr;
+
+// Vehicle. A VEHICLE_TYPE_* build fixes it at compile time: built
+// statically and held by its final type, so every call is direct.
+// Otherwise the type comes from config at boot (VehicleRegistry), built in
+// a static slot before the scheduler starts. No heap either way
+#if defined(VEHICLE_TYPE_ROVER)
+typedef Rover ActiveVehicle;
+#elif defined(VEHICLE_TYPE_PLANE)
+typedef Plane ActiveVehicle;
+#elif defined(VEHICLE_TYPE_SUB)
+typedef Sub ActiveVehicle;
+#elif defined(VEHICLE_TYPE_COPTER)
+typedef Copter ActiveVehicle;
+#endif
+#if defined(VEHICLE_TYPE_ROVER) || defined(VEHICLE_TYPE_PLANE) ||             \
+    defined(VEHICLE_TYPE_SUB) || defined(VEHICLE_TYPE_COPTER)
+#define VEHICLE_TYPE_FIXED 1
+ActiveVehicle activeVehicle;
+ActiveVehicle *const vehicle = &activeVehicle;
+#else
+Vehicle *vehicle = nullptr; // Set in setup(), before any task runs
+#endif
 
 // Protocol state
+// latestPacket is owned by the control task. Producers hand frames over
+// through lock-free SPSC rings (ESP-NOW callback -> radioRxRing,
+// /ws binary messages (AsyncTCP task) -> wsRxRing, serial command task
+// -> serialRxRing). Radio and /ws frames are still encrypted: the rx
+// verify worker on core 0 drains them in order, decrypts and
+// authenticates each and passes the good ones on (radioVerifiedRing /
+// wsVerifiedRing), so a burst costs neither the Wi-Fi task nor the
+// control task more time. Each tick the arbiter picks one of the newest
+// verified frames (and the serial / RC receiver's) to drive.
 NAPacket latestPacket;
+// Radio frames carry their latency probe stamps (0 while it is off)
+struct RadioFrame {
+  NAPacket pkt;
+  uint8_t mac[6];        // Sender: selects its session
+  uint32_t rxUs;         // OnDataRecv entry
+  uint32_t queuedUs;     // Passed the filters, pushed
+  uint32_t dequeuedUs;   // Taken by the verify worker
+  uint32_t verifiedUs;   // Authenticated, handed to the control task
+  HAL_Micros arrivedUs;  // Pushed (always): stick sample time
+};
+typedef SPSCRing<RadioFrame, 8> ControlRxRing;  // Room for a burst
+typedef SPSCRing<RadioFrame, 4> ControlRing;
+ControlRxRing radioRxRing;
+ControlRxRing wsRxRing;
+ControlRing radioVerifiedRing;
+ControlRing wsVerifiedRing;
+TaskHandle_t rxVerifyTask = nullptr;    // Null: the control task verifies
+uint32_t rxVerifyFrames = 0;            // Verify worker
+uint32_t rxVerifyForged = 0;            // Failed decryption / authentication
+uint32_t rxVerifyBatches = 0;           // Wake-ups that found frames
+uint32_t rxVerifyMaxBatch = 0;
+const uint32_t RX_VERIFY_IDLE_MS = 20;  // Session upkeep while no frame comes
+const uint32_t RX_VERIFY_STACK = 6144;  // mbedtls GCM / HKDF
+struct SerialFrame {
+  NAPacket pkt;
+  HAL_Micros arrivedUs;  // Pushed: stick sample time
+};
+SPSCRing<SerialFrame, 4> serialRxRing;
+
+// Redundant control links ({"c":"set_arbiter"}): de-duplicated by
+// sequence, newest frame wins. The control task offers and selects;
+// arbiterMux covers it against get_arbiter / set_arbiter.
+ControlArbiter controlArbiter;
+ControlArbiterConfig arbiterConfig;
+portMUX_TYPE arbiterMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Clock scaling and light sleep while parked ({"c":"set_pm"}). The control
+// task runs the policy and holds / releases the esp_pm locks; pmMux covers
+// the policy and config against get_pm / set_pm. pmLocks is false when the
+// build has no power management (everything stays at full clock).
+PowerPolicy powerPolicy;
+PowerPolicyConfig pmConfig;
+volatile uint32_t pmConfigRevision = 0;
+portMUX_TYPE pmMux = portMUX_INITIALIZER_UNLOCKED;
+esp_pm_lock_handle_t pmCpuLock = nullptr;
+esp_pm_lock_handle_t pmSleepLock = nullptr;
+bool pmLocks = false;
+bool pmLightSleep = false;
+volatile uint32_t hostActivityMs = 0;   // Last host command (serial / BLE)
+
+// Wired RC receiver on UART1 (RC_INPUT_PIN): its reader task hands frames
+// to the control task through the receiver's own ring. rcMux guards the
+// channel map and the latency histograms (set_rc / get_rc).
+#if RC_INPUT_PIN >= 0
+RcReceiver *rcReceiver = nullptr;
+#else
+RcReceiver *const rcReceiver = nullptr; // Every "if (rcReceiver)" folds away
+#endif
+static_assert(RC_INPUT_PIN < 0 || COPTER_ESC_TELEMETRY_PIN < 0,
+              "RC receiver and Copter ESC telemetry both need UART1");
+RcConfig rcConfig;
+LatencyHistogram rcLatency[2]; // Frame end -> control tick, -> outputs committed
+portMUX_TYPE rcMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Stick-to-motor latency probe ({"c":"set_latency"}). Frames are stamped
+// only while enabled; the control task records, comms / telemetry read.
+volatile bool latencyProbeEnabled = false;
+LatencyProbe latencyProbe;
+portMUX_TYPE latencyMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Stick shaping between frames ({"c":"set_input"}). The control task
+// owns inputConditioner and picks up inputConfig when
+// inputConfigRevision moves; inputMux guards both for the commands.
+InputConditioner inputConditioner;
+InputCondConfig inputConfig;
+uint32_t inputConfigRevision = 0;
+portMUX_TYPE inputMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Link rate negotiation (telemetry task; linkRateMux for get_link).
+// Controller acks come in through linkAckRing (ESP-NOW callback -> telemetry)
+LinkRate linkRate;
+SPSCRing<LinkRateFrame, 4> linkAckRing;
+portMUX_TYPE linkRateMux = portMUX_INITIALIZER_UNLOCKED;
+// ESP-NOW rate on the fast PHY (set_tx_route); the long-range PHY replaces
+// it while LinkRate has the link on LR. Guarded by linkRateMux
+wifi_phy_rate_t espnowFastRate = WIFI_PHY_RATE_1M_L;
+// Compact control frames taken, and dropped for want of a full frame to
+// expand their sequence from (peerMux)
+uint32_t compactFrames = 0;
+uint32_t compactUnsynced = 0;
+static_assert(LINK_RATE_FRAME_SIZE != sizeof(NAPacket) &&
+                  LINK_RATE_FRAME_SIZE != sizeof(NAHandshakePacket) &&
+                  LINK_RATE_FRAME_SIZE != sizeof(NAPacketAEAD) &&
+                  LINK_RATE_FRAME_SIZE != sizeof(NAHandshakeX25519) &&
+                  LINK_RATE_FRAME_SIZE != sizeof(NAFormationBeacon),
+              "link rate frames must be distinguishable by length");
+
+// Controller clock offset (telemetry task; clockSyncMux for get_latency).
+// Replies come in through clockSyncRing, stamped on arrival
+struct ClockSyncRx {
+  ClockSyncFrame frame;
+  HAL_Micros rxUs;
+};
+ClockSync clockSync;
+SPSCRing<ClockSyncRx, 4> clockSyncRing;
+portMUX_TYPE clockSyncMux = portMUX_INITIALIZER_UNLOCKED;
+static_assert(CLOCK_SYNC_FRAME_SIZE != sizeof(NAPacket) &&
+                  CLOCK_SYNC_FRAME_SIZE != sizeof(NAHandshakePacket) &&
+                  CLOCK_SYNC_FRAME_SIZE != sizeof(NAPacketAEAD) &&
+                  CLOCK_SYNC_FRAME_SIZE != sizeof(NAHandshakeX25519) &&
+                  CLOCK_SYNC_FRAME_SIZE != sizeof(NAHandshakeResume) &&
+                  CLOCK_SYNC_FRAME_SIZE != sizeof(NAFormationBeacon) &&
+                  CLOCK_SYNC_FRAME_SIZE != LINK_RATE_FRAME_SIZE,
+              "clock sync frames must be distinguishable by length");
+
+// Telemetry streams ({"c":"set_streams"}): one scheduler per link, run by
+// the telemetry task. streamsMux guards the config and both schedulers
+// (get_streams reads their counters).
+TelemetryStreamsConfig streamsConfig;
+TelemetryStreams radioStreams;
+TelemetryStreams hostStreams;
+portMUX_TYPE streamsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Trend windows ({"c":"set_trend"}): the telemetry task aggregates and
+// publishes; trendMux guards the config and the last closed window.
+TelemetryTrendConfig trendConfig;
+TelemetryTrend telemetryTrend;
+TelemetryTrendWindow lastTrend;
+uint32_t trendWindows = 0;
+portMUX_TYPE trendMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Formation beacons ({"c":"set_formation"}): the Wi-Fi task only checks
+// group / version and queues; the telemetry task authenticates, keeps the
+// neighbour table and sends our own beacon. The control task feeds the
+// leader to navigation and publishes formationSelf. formationMux guards
+// the config, the table and formationSelf.
+struct BeaconFrame {
+  uint8_t mac[6];
+  NAFormationBeacon beacon;
+  uint32_t rxMs;
+};
+SPSCRing<BeaconFrame, 8> beaconRxRing;
+struct FormationConfig {
+  bool enabled;
+  uint8_t group;
+  uint8_t rateHz;
+  uint32_t budgetBps;
+  uint8_t leader[6]; // Followed neighbour
+  bool haveLeader;
+};
+FormationConfig formationConfig = {
+    false, 0, FORMATION_DEFAULT_RATE_HZ, FORMATION_DEFAULT_BUDGET_BPS, {0}, false};
+FormationTable formationTable;
+FormationState formationSelf;
+CryptoHmacKey formationKey;         // Telemetry task only
+bool formationKeyReady = false;
+volatile bool formationRekey = true; // Shared secret changed
+uint32_t formationSequence = 0;
+uint32_t formationSent = 0;
+uint32_t formationBadTag = 0;
+uint16_t formationIntervalMs = 0;
+uint8_t formationVehicleType = 0;   // VehicleType, set at boot
+portMUX_TYPE formationMux = portMUX_INITIALIZER_UNLOCKED;
+
+#define FORMATION_KEY_LABEL "NA formation beacon v1"
+
+// RTK corrections ({"c":"set_rtk"}). Base: the GPS task cuts the
+// receiver's RTCM3 frames into rtkTxRing, the telemetry task tags them
+// and broadcasts one fragment when the radio is idle. Rover: fragments
+// from ESP-NOW (Wi-Fi task) or /ws (AsyncTCP task) are queued; the
+// telemetry task checks the tag, reassembles and hands whole frames to
+// the receiver.
+enum RtkMode : uint8_t { RTK_OFF = 0, RTK_ROVER, RTK_BASE };
+static const char *const RTK_MODE_NAMES[] = {"off", "rover", "base"};
+volatile uint8_t rtkMode = RTK_OFF;
+SPSCRing<NARtcmFragment, 8> rtkTxRing;  // GPS task -> telemetry task
+SPSCRing<NARtcmFragment, 8> rtkRxRing;  // Wi-Fi task -> telemetry task
+SPSCRing<NARtcmFragment, 4> rtkWsRing;  // AsyncTCP task -> telemetry task
+RtcmReassembler rtkReassembler;         // Telemetry task only
+CryptoHmacKey rtkKey;                   // Telemetry task only
+bool rtkKeyReady = false;
+volatile bool rtkRekey = true;          // Shared secret changed
+uint8_t rtkSequence = 0;                // GPS task only
+uint32_t rtkSent = 0;
+uint32_t rtkBadTag = 0;
+
+#define RTK_KEY_LABEL "NA rtk corrections v1"
+
+/**
+ * RTK base (GPS task): cut each RTCM3 frame from the receiver into
+ * fragments for the telemetry task to tag and send
+ */
+void rtkBaseFrame(const uint8_t *frame, uint16_t len, void *ctx) {
+  uint8_t seq = rtkSequence++;
+  uint8_t count = RtcmRelay_fragmentCount(len);
+  for (uint8_t i = 0; i < count; i++) {
+    NARtcmFragment frag;
+    NA_Rtcm_build(&frag, seq, i, frame, len);
+    rtkTxRing.push(frag);
+  }
+}
+
+// Radio sessions per sender MAC: sequence window, plus own keys once that
+// sender completed a handshake (slot = EncryptionManager / HMACValidator
+// peer key set). The Wi-Fi task finds or adds keyless slots and checks
+// windows; only the rx verify worker keys, ratchets, evicts keyed slots
+// and advances windows, so it may read a keyed slot's keys without the
+// lock (it writes them under it: the control task snapshots them).
+// linkPeer is the paired controller: pinned, and its keys are also the
+// link keys (telemetry, serial, frames from keyless slots).
+PeerSessionTable peerSessions;
+uint8_t linkPeer[6];
+bool haveLinkPeer = false;
+portMUX_TYPE peerMux = portMUX_INITIALIZER_UNLOCKED;
+
+static_assert(PEER_SESSION_MAX <= EM_PEER_KEY_SETS &&
+                  PEER_SESSION_MAX <= HMAC_PEER_KEY_SETS &&
+                  PEER_SESSION_MAX <= RX_FILTER_MAX_PEERS,
+              "every session slot needs a key set and an allowlist entry");
+
+// An INIT from another MAC takes over the pairing only once the paired
+// controller has been silent this long; before that it gets its own session
+#define PEER_RELINK_IDLE_MS 2000
+
+// Handshake result for the rx verify worker (key exchange worker ->
+// verify worker).
+// keys: HKDF session (valid, ratchets) or the raw secret in every key
+// (invalid). pendingLinkReset: the link secret was replaced from serial,
+// every peer falls back to it.
+struct PendingPeerSession {
+  uint8_t mac[6];
+  bool link;         // Sender becomes / stays the paired controller
+  SessionKeys keys;
+};
+PendingPeerSession pendingPeer;
+volatile bool pendingSessionReady = false;
+volatile bool pendingLinkReset = false;
+portMUX_TYPE sessionMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Resumption tickets of installed HKDF sessions (control task only). A
+// resume request is copied by the Wi-Fi task into a one-slot mailbox
+// (under sessionMux, a newer one replaces it) and redeemed by the control
+// task, which owns the keys.
+SessionResumeTable resumeTickets;
+NAHandshakeResume pendingResume;
+uint8_t pendingResumeMac[6];
+volatile bool pendingResumeReady = false;
+
+// ESP-NOW link-layer CCMP for keyed peers ({"c":"set_ccmp"}). The driver
+// key of a peer silent for CCMP_IDLE_MS is dropped, so a controller that
+// lost its keys (reboot) can handshake in the clear again. Flags live in
+// the peer table (peerMux); linkCipherSinceMs is control task only.
+bool espnowCcmp = false;
+const uint32_t CCMP_IDLE_MS = 3000;
+uint32_t linkCipherSinceMs[PEER_SESSION_MAX] = {0};
+
+// Attitude, advanced once per IMU sample by the control task.
+// Yaw has no north of its own: the position EKF learns its offset from
+// GPS course or the magnetometer and fuses GPS with the earth-frame
+// acceleration summed here.
+AttitudeEstimator attitude;
+uint32_t lastImuUs = 0;
+float lastGyro[3] = {0.0f, 0.0f, 0.0f}; // Body rates of the newest sample
+
+// IMU calibration ({"c":"cal_imu"}): stored gyro bias (with temperature
+// slope) and accel offsets correct every sample from the first one; the
+// control task refines them while still. imuCalMux guards the copy for
+// get_imu, the command requests and the record waiting for the comms
+// task to store it (at most every IMU_CAL_SAVE_INTERVAL_MS once it has one).
+ImuCal imuCal;
+ImuCal imuCalShared;
+ImuCalRecord imuCalPending;
+bool imuCalSavePending = false;
+bool imuCalLevelRequest = false;
+bool imuCalResetRequest = false;
+uint32_t imuCalSaves = 0;               // Comms task
+portMUX_TYPE imuCalMux = portMUX_INITIALIZER_UNLOCKED;
+const uint32_t IMU_CAL_SAVE_INTERVAL_MS = 60000;
+
+// Gyro rate filter ({"c":"set_gyro_filter"}): the estimator integrates the
+// raw rates, the rate loop and telemetry get the filtered ones. The control
+// task owns gyroFilter and rebuilds it when gyroFilterRevision moves;
+// gyroFilterMux guards gyroFilterConfig for the commands.
+BiquadCascade gyroFilter;
+BiquadChainConfig gyroFilterConfig;
+uint32_t gyroFilterRevision = 0;
+portMUX_TYPE gyroFilterMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Dynamic notch ({"c":"set_dyn_notch"}, Copter). The control task feeds
+// raw rates through gyroNoiseRing to the noise task, which tracks the
+// motor noise peak and publishes notch coefficients on topicGyroNotch;
+// the control task swaps them into the last stage of gyroFilter.
+// dynNotchMux guards dynNotchConfig for the commands.
+struct GyroNoiseFrame {
+  float rates[3];
+};
+SPSCRing<GyroNoiseFrame, 128> gyroNoiseRing;
+DynamicNotch dynNotch;                    // Noise task
+DynNotchConfig dynNotchConfig;
+uint32_t dynNotchRevision = 0;
+portMUX_TYPE dynNotchMux = portMUX_INITIALIZER_UNLOCKED;
+bool dynNotchAvailable = false;           // Noise task scheduled
+
+// Inner / outer split of the control task ({"c":"get_perf"} "rates"),
+// picked per vehicle type by startScheduler (flat 50Hz for the
+// cooperative fallback). The control task owns rateSchedule; "reset"
+// from a command is a request it takes on its next tick.
+RateSchedule rateSchedule;
+bool rateStatsResetRequest = false;
+float controlOuterDt = 0.0f;            // Time the outer loop covers this tick, s
+bool motorCalOwnsOutputs = false;       // Last outer tick: a calibration drives the motors
+static_assert(RATE_PROFILE_COUNT == VEHICLE_TYPE_COUNT, "one rate profile per vehicle type");
+
+// RPM harmonic notches ({"c":"set_rpm_filter"}), fed by the vehicle's ESC
+// eRPM each control tick. The control task owns rpmFilter;
+// rpmFilterMux guards rpmFilterConfig for the commands.
+RpmFilter rpmFilter;
+RpmFilterConfig rpmFilterConfig;
+uint32_t rpmFilterRevision = 0;
+portMUX_TYPE rpmFilterMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Fixed-wing stabilization ({"c":"set_fbw"}), handed to the vehicle by
+// the control task; fbwMux guards fbwConfig for the commands
+FbwConfig fbwConfig;
+uint32_t fbwRevision = 0;
+portMUX_TYPE fbwMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Motor thrust linearization / voltage compensation ({"c":"set_thrust"}),
+// handed to the vehicle by the control task with each battery reading;
+// thrustMux guards thrustConfig for the commands
+ThrustCurveConfig thrustConfig;
+uint32_t thrustRevision = 0;
+portMUX_TYPE thrustMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Plane mission speed / altitude ({"c":"set_tecs"}): the controller runs
+// in the control task, tecsMux guards tecsConfig for the commands
+TotalEnergy tecs;
+TecsConfig tecsConfig;
+uint32_t tecsRevision = 0;
+portMUX_TYPE tecsMux = portMUX_INITIALIZER_UNLOCKED;
+bool tecsActive = false;
+bool tecsPitot = false;                  // Last step flew on the pitot
+const uint32_t AIRSPEED_STALE_MS = 200;  // Older pitot reading: GPS speed
+
+// Rover wheel odometry ({"c":"set_odom"}), handed to the vehicle by the
+// control task; odomMux guards odomConfig for the commands
+OdometryConfig odomConfig;
+uint32_t odomRevision = 0;
+portMUX_TYPE odomMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Pitot (MS4525DO), polled by the sensor task when it answered at boot
+#if FEATURE_PITOT
+MS4525Async pitot;
+#endif
+bool pitotFitted = false;
+
+// Forward rangefinder (ultrasonic, echo timed by the RMT) for the
+// obstacle slow-down ({"c":"set_range"}): the sensor task triggers it
+// and publishes the median range, the control task hands that and the
+// envelope to navigation; rangeMux guards rangeEnvelope for the commands
+#if FEATURE_RANGE
+UltrasonicRMT ranger;
+RangeFilter rangeFilter;
+#endif
+bool rangeFitted = false;
+RangeEnvelope rangeEnvelope;
+uint32_t rangeRevision = 0;
+portMUX_TYPE rangeMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Per-motor minPWM / deadband trims ({"c":"set_motor_trim"}) and the
+// breakaway calibration that finds minPWM ({"c":"motor_cal"}): the
+// control task runs the calibration and applies the trims over
+// MotorConfig; motorTrimMux guards the table, the request and the status
+// copy, and a finished run is stored by the comms task
+MotorTrimTable motorTrims;
+uint32_t motorTrimRevision = 0;
+bool motorTrimSavePending = false;
+int8_t motorCalRequest = -1;            // Motor to calibrate, -1 = none
+bool motorCalAbortRequest = false;
+MotorCal motorCalStatus;                // Copy for the commands
+int8_t motorCalStatusMotor = -1;
+portMUX_TYPE motorTrimMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Magnetometer (QMC5883L) with online hard / soft-iron calibration
+// ({"c":"set_mag"}): the sensor task polls it, refines the fit and
+// publishes the corrected field, the control task fuses its heading.
+// magMux guards magConfig, the reset request and the fit waiting for the
+// comms task to store it (at once for the first fit, then at most every
+// MAG_CAL_SAVE_INTERVAL_MS).
+#if FEATURE_MAG
+QMC5883LAsync mag;
+MagCal magCal;
+#endif
+bool magFitted = false;
+MagConfig magConfig;
+MagCalRecord magCalPending;
+bool magCalSavePending = false;
+bool magCalResetRequest = false;
+uint32_t magCalSaves = 0;               // Comms task
+uint32_t magHeadingFused = 0;           // Control task
+uint32_t magHeadingDisturbed = 0;
+portMUX_TYPE magMux = portMUX_INITIALIZER_UNLOCKED;
+const uint32_t MAG_CAL_SAVE_INTERVAL_MS = 60000;
+const uint32_t MAG_STALE_MS = 200;
+
+// Barometer (MS5611): the sensor task polls it, the control task blends
+// it with the IMU's vertical acceleration into altitude and climb rate
+// (Plane energy controller, Copter altitude hold {"c":"set_alt"}).
+// altHoldMux guards altHoldConfig and the re-zero request.
+#if FEATURE_BARO
+MS5611Async baro;
+#endif
+bool baroFitted = false;
+BaroAltitude baroAlt;                   // Control task
+uint32_t baroAltSamples = 0;
+bool baroAltValid = false;              // Ready and fresh
+AltitudeHold altHold;
+AltHoldConfig altHoldConfig;
+uint32_t altHoldRevision = 0;
+bool baroZeroRequest = false;
+portMUX_TYPE altHoldMux = portMUX_INITIALIZER_UNLOCKED;
+const uint32_t BARO_STALE_MS = 200;
+const int16_t ALT_HOLD_IDLE_STICK = 100; // Below: throttle straight through (ground, landing)
+
+// PCA9685 PWM expander, flushed by the control task once per tick:
+// channels 0-7 repeat the vehicle's actuator outputs as 1000-2000 us,
+// 8-15 are auxiliary pulses set with {"c":"set_aux"} (pwmAuxMux)
+PCA9685Async pwmExpander;
+volatile bool pwmExpanderFitted = false;
+uint16_t pwmAuxUs[PCA9685_CHANNELS - TOPIC_ACTUATOR_CHANNELS] = {0};
+portMUX_TYPE pwmAuxMux = portMUX_INITIALIZER_UNLOCKED;
+const float PWM_EXPANDER_MIN_US = 1000.0f;
+const float PWM_EXPANDER_SPAN_US = 1000.0f;
+
+// Hull status OLED (SSD1306), drawn and flushed by the display task only
+SSD1306Async oled;
+volatile bool oledFitted = false;
+
+float earthAccelSum[3] = {0.0f, 0.0f, 0.0f};
+uint16_t earthAccelCount = 0;
+const float GRAVITY = 9.80665f;
+
+// Position / heading EKF in the navigation frame (control task)
+PositionEstimator position;
+uint32_t positionFixCount = 0;
+uint32_t positionDepthCount = 0;
+uint32_t positionOdomCount = 0;
+HAL_Micros lastPositionUs = 0;
+int32_t positionOriginLat = 0; // Frame the estimate is in (deg * 1e7)
+int32_t positionOriginLng = 0;
+int32_t positionAltRef = 0;               // mm MSL of up = 0
+const float HEADING_GPS_MIN_SPEED = 2.0f; // m/s, GPS course valid above this
+const float DEPTH_SIGMA = 0.05f;          // m, MS5837 depth 1-sigma
+const float ODOM_SPEED_SIGMA = 0.1f;      // m/s, wheel speed 1-sigma (slip)
+
+// Geofence: edited by the comms task, checked every control tick
+Geofence geofence;
+GeofenceResult geofenceResult = GEOFENCE_OK; // Last check (breach latch)
+portMUX_TYPE geofenceMux = portMUX_INITIALIZER_UNLOCKED;
+const char *GEOFENCE_NVS_KEY = "fence";
+const char *GEOFENCE_DIST_KEY = "fence_dist";
+
+// One fence vertex, packed (NVS format)
+struct __attribute__((packed)) GeofenceRecord {
+  int32_t lat; // deg * 1e7
+  int32_t lng;
+  uint8_t polygon;
+  uint8_t type; // GeofenceType
+};
+// Save / load staging (comms task and boot only), 1.3 KB off the stack
+BULK_BSS GeofenceRecord geofenceRecords[GEOFENCE_MAX_POLYGONS * GEOFENCE_MAX_VERTICES];
+
+// No-go map ({"c":"map_set"}) and the planner that routes mission legs
+// around it ({"c":"plan_mission"}, and before every start_mission):
+// both comms task only, 15 KB of planner scratch kept off the stack
+BULK_BSS OccupancyGrid occGrid;
+BULK_BSS PathPlanner pathPlanner;
+
+// Liveness deadlines of the scheduler tasks (each feeds its own slot)
+WatchdogTable watchdog;
+int watchdogControl = -1;
+int watchdogComms = -1;
+int watchdogTelemetry = -1;
+const uint32_t WATCHDOG_CONTROL_MS = 60;    // 3 control periods
+const uint32_t WATCHDOG_TELEMETRY_MS = 250; // WebSocket send can block briefly
+const uint32_t WATCHDOG_COMMS_MS = 500;     // NVS write-back may erase a sector
+
+// Boot graph (setup() and the boot worker), reported by get_boot together
+// with the first radio control frame that passed the filters
+BootSequence bootSequence;
+volatile uint32_t bootFirstControlUs = 0; // HAL_GetMicros(), 0 = none yet
+
+// Battery model, advanced by the control task once per battery ADC block
+BatteryEstimator batteryModel;
+uint32_t batteryBlock = 0;
+const uint8_t BATTERY_CELLS = 1;
+
+// Energy accounting ({"c":"set_power"}), advanced with the battery model
+// when a current source exists. The control task owns powerMonitor;
+// powerMux guards powerConfig for the commands.
+PowerMonitor powerMonitor;
+PowerConfig powerConfig;
+uint32_t powerRevision = 0;
+portMUX_TYPE powerMux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t powerSource = POWER_SOURCE_NONE;
+
+// Topic bus sources last published (gps: control task, depth / airspeed:
+// sensor task)
+uint32_t gpsTopicFixes = 0;
+uint32_t depthTopicSamples = 0;
+uint32_t airspeedTopicSamples = 0;
+
+NAPacket serialPacket; // Stick state of the serial "sm" command (comms task)
 uint32_t packetSequence = 0;
+
+// Binary host protocol negotiated via ping (comms task writes, telemetry reads)
+volatile bool hostBinaryMode = false;
+
+// Telemetry routing: unicast to the paired controller (MAC retries, faster
+// PHY rate), broadcast only while unpaired so controllers can discover us
+const uint8_t BROADCAST_MAC[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+uint8_t telemetryPeer[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+bool telemetryUnicastEnabled = true; // Set via set_tx_route
+WifiLinkConfig wifiConfig;           // Comms task after boot (set_wifi)
+#if FEATURE_BLE
+bool bleEnabled = false;             // Stored by set_ble, comms task after boot
+#endif
+portMUX_TYPE telemetryRouteMux = portMUX_INITIALIZER_UNLOCKED;
 uint8_t encryptionKey[32] = {0}; // Phase 9: Pre-shared key (PSK)
 uint8_t hmacSecret[32] = {0};    // Phase 9: HMAC secret
 uint32_t lastRateLimitRefill = 0;
 const uint32_t REFILL_INTERVAL_MS = 10;
+const uint32_t TASK_SCAN_INTERVAL_MS = 1000; // Stack high-water marks
+
+// Housekeeping in the slack after each comms / telemetry tick; each
+// executor belongs to its task (initBackgroundJobs)
+JobExecutor commsJobs;
+JobExecutor telemetryJobs;
+const uint32_t CONTROL_BUSY_PERCENT = 75; // Of the control period: hold jobs back
+
+// JSON documents of the command path (comms task) come from a fixed arena
+// reset after every command, not the heap. Override the cap with -D
+#ifndef JSON_COMMAND_ARENA_SIZE
+#define JSON_COMMAND_ARENA_SIZE 12288 // get_perf / ping responses + request
+#endif
+alignas(JSON_ARENA_ALIGN) static uint8_t commandArenaBuffer[JSON_COMMAND_ARENA_SIZE];
+JsonArena commandArena(commandArenaBuffer, sizeof(commandArenaBuffer));
 
-// Phase 10: GPS Serial
-HardwareSerial GPSSerial(2); // UART2
+// Serial JSON telemetry line: laid out once, numbers patched in place
+// each tick (same keys as before, fixed width, space padded)
+static const char SERIAL_TELEMETRY_PATTERN[] =
+    "{\"t\":2,\"v\":##.###,\"r\":###,\"heap\":###}\r\n";
+enum SerialTelemetryField {
+  SERIAL_TEL_VOLTAGE, // V, millivolt resolution
+  SERIAL_TEL_LINK,    // Link quality 0-100 (0 without RSSI manager)
+  SERIAL_TEL_HEAP     // Heap utilization %
+};
+static JsonTemplate serialTelemetryLine;
 
 // Phase 11: Web Server
+#if FEATURE_WEB
 AsyncWebServer server(80);
+#endif
+
+bool parseMacAddress(const char *str, uint8_t out[6]) {
+  unsigned int b[6];
+  if (!str || sscanf(str, "%x:%x:%x:%x:%x:%x", &b[0], &b[1], &b[2], &b[3],
+                     &b[4], &b[5]) != 6)
+    return false;
+  for (int i = 0; i < 6; i++) {
+    if (b[i] > 0xFF)
+      return false;
+    out[i] = (uint8_t)b[i];
+  }
+  return true;
+}
+
+bool readPairedMac(uint8_t out[6]) {
+  char mac[ConfigManager::MAC_STRING_LEN];
+  if (!configManager)
+    return false;
+  configManager->getPairedMACAddress(mac, sizeof(mac));
+  return parseMacAddress(mac, out);
+}
+
+bool parseHexBytes(const char *hex, uint8_t *out, size_t len) {
+  if (!hex || strlen(hex) != 2 * len)
+    return false;
+  for (size_t i = 0; i < len; i++) {
+    unsigned int b;
+    if (!isxdigit(hex[2 * i]) || !isxdigit(hex[2 * i + 1]) ||
+        sscanf(hex + 2 * i, "%2x", &b) != 1)
+      return false;
+    out[i] = (uint8_t)b;
+  }
+  return true;
+}
+
+/**
+ * Point telemetry at the paired controller, or back to broadcast
+ * @param mac Controller address, NULL for broadcast
+ */
+void setTelemetryRoute(const uint8_t *mac) {
+  const uint8_t *dest = BROADCAST_MAC;
+  if (mac && telemetryUnicastEnabled && EspNowTx_addPeer(mac))
+    dest = mac;
+
+  portENTER_CRITICAL(&telemetryRouteMux);
+  memcpy(telemetryPeer, dest, 6);
+  portEXIT_CRITICAL(&telemetryRouteMux);
+
+  char macStr[18];
+  snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", dest[0],
+           dest[1], dest[2], dest[3], dest[4], dest[5]);
+  JsonDocument doc;
+  doc["msg"] = "Telemetry route";
+  doc["mac"] = macStr;
+  doc["uni"] = dest != BROADCAST_MAC;
+  serializeJson(doc, Serial);
+  Serial.println();
+}
+
+/**
+ * Make a MAC the paired controller's pinned session slot
+ * Caller holds peerMux.
+ * @return Slot, or PEER_SESSION_NONE
+ */
+int pinLinkPeer(const uint8_t *mac, uint8_t *evicted, bool *didEvict) {
+  if (haveLinkPeer)
+    PeerSessionTable_setPinned(&peerSessions,
+                               PeerSessionTable_find(&peerSessions, linkPeer), false);
+  memcpy(linkPeer, mac, 6);
+  haveLinkPeer = true;
+  int slot = PeerSessionTable_acquire(&peerSessions, mac, true, evicted, didEvict);
+  PeerSessionTable_setPinned(&peerSessions, slot, true);
+  return slot;
+}
+
+/**
+ * Whether a finished handshake makes its sender the paired controller
+ * (key exchange worker). Answers to our own INIT and re-keys of the pair
+ * keep the pairing; an INIT from another MAC takes over only once the
+ * paired controller has gone quiet, so a relay or follower joining gets
+ * a session of its own instead of the link.
+ */
+bool claimsLink(const uint8_t *mac, bool init) {
+  portENTER_CRITICAL(&peerMux);
+  bool link = !haveLinkPeer || memcmp(linkPeer, mac, 6) == 0;
+  if (!link && init) {
+    int slot = PeerSessionTable_find(&peerSessions, linkPeer);
+    const ReplayWindow *win = slot != PEER_SESSION_NONE ? &peerSessions.peers[slot].replay
+                                                        : nullptr;
+    link = !win || !win->haveSeq ||
+           (uint32_t)(HAL_GetMillis() - win->lastAcceptMs) > PEER_RELINK_IDLE_MS;
+  }
+  portEXIT_CRITICAL(&peerMux);
+  return link;
+}
+
+/**
+ * Hand a finished handshake to the rx verify worker
+ */
+void postPeerSession(const PendingPeerSession &next) {
+  portENTER_CRITICAL(&sessionMux);
+  pendingPeer = next;
+  pendingSessionReady = true;
+  portEXIT_CRITICAL(&sessionMux);
+}
+
+/**
+ * The link secret was replaced (serial): drop every peer's own keys and
+ * any handshake still waiting, restart all windows (verify worker applies)
+ */
+void resetPeerSessions() {
+  portENTER_CRITICAL(&sessionMux);
+  SessionKeys_wipe(&pendingPeer.keys);
+  pendingSessionReady = false;
+  pendingLinkReset = true;
+  portEXIT_CRITICAL(&sessionMux);
+}
+
+// Security switches read per packet and per telemetry frame, kept current
+// by onSecurityChanged() instead of copying the whole section each time
+volatile bool securityEncryption = false;
+volatile bool securityHmac = true;
+
+/**
+ * Security section changed (set_security_config, comms task): apply only
+ * what differs. A new secret re-keys the link; a new rate is set on the
+ * live buckets, so their tokens and counters carry over
+ */
+static void onSecurityChanged(const ConfigManager::Change &change, void *ctx) {
+  const ConfigManager::SecurityConfig &before = *change.before.security;
+  const ConfigManager::SecurityConfig &after = *change.after.security;
+  securityEncryption = after.encryptionEnabled;
+  securityHmac = after.hmacEnabled;
+  if (memcmp(before.sharedSecret, after.sharedSecret, sizeof(after.sharedSecret)) != 0) {
+    EncryptionManager_init(after.sharedSecret);
+    HMACValidator_init(after.sharedSecret);
+    formationRekey = true;
+    rtkRekey = true;
+    resetPeerSessions();
+  }
+  if (after.rateLimitCPS != before.rateLimitCPS)
+    RateLimitManager_setRate(after.rateLimitCPS);
+}
+
+/**
+ * Install a peer's current epoch keys (rx verify worker)
+ * The paired controller's keys are the link keys as well.
+ */
+void applyPeerKeys(int slot, const SessionKeys &keys, bool link) {
+  EncryptionManager_setPeerKey(slot, keys.c2vEnc);
+  HMACValidator_setPeerKey(slot, keys.c2vMac);
+  if (link) {
+    EncryptionManager_setKeys(keys.c2vEnc, keys.v2cEnc);
+    HMACValidator_setKeys(keys.c2vMac, keys.v2cMac);
+  }
+}
+
+/**
+ * Give an installed session's link key to the ESP-NOW driver (rx verify
+ * worker, once any clear answer to the peer has gone out). With CCMP off,
+ * or without an HKDF session, the peer stays on clear frames.
+ */
+void applyLinkCipher(const uint8_t *mac) {
+  portENTER_CRITICAL(&peerMux);
+  int slot = PeerSessionTable_find(&peerSessions, mac);
+  bool keyed = slot != PEER_SESSION_NONE && peerSessions.peers[slot].keyed;
+  portEXIT_CRITICAL(&peerMux);
+  if (!keyed)
+    return;
+
+  // Keyed slots only change in this task
+  uint8_t lmk[SESSION_LINK_KEY_SIZE];
+  bool on = espnowCcmp && SessionKeys_linkKey(&peerSessions.peers[slot].keys, lmk) &&
+            EspNowTx_setPeerKey(mac, lmk);
+  memset(lmk, 0, sizeof(lmk));
+  if (!on)
+    EspNowTx_clearPeerKey(mac);
+  else
+    linkCipherSinceMs[slot] = HAL_GetMillis();
+  portENTER_CRITICAL(&peerMux);
+  peerSessions.peers[slot].linkCipher = on;
+  portEXIT_CRITICAL(&peerMux);
+  if (espnowCcmp && !on)
+    LOG_WARN("[KX] CCMP key not installed, software crypto only\n");
+}
+
+/**
+ * Put one peer back on clear frames before a handshake answer to it
+ * (any task). The flag goes first: CCMP frames are refused from then on.
+ */
+void dropLinkCipher(const uint8_t *mac) {
+  portENTER_CRITICAL(&peerMux);
+  int slot = PeerSessionTable_find(&peerSessions, mac);
+  bool had = slot != PEER_SESSION_NONE && peerSessions.peers[slot].linkCipher;
+  if (had)
+    peerSessions.peers[slot].linkCipher = false;
+  portEXIT_CRITICAL(&peerMux);
+  if (had)
+    EspNowTx_clearPeerKey(mac);
+}
+
+/**
+ * Put peers back on clear frames (rx verify worker): all of them when the
+ * keys are reset, else those without an accepted frame for CCMP_IDLE_MS
+ */
+void expireLinkCiphers(bool all, uint32_t now) {
+  uint8_t macs[PEER_SESSION_MAX][6];
+  uint8_t count = 0;
+  portENTER_CRITICAL(&peerMux);
+  for (int i = 0; i < PEER_SESSION_MAX; i++) {
+    PeerSession *p = &peerSessions.peers[i];
+    if (!p->linkCipher)
+      continue;
+    uint32_t last = p->replay.haveSeq ? p->replay.lastAcceptMs : linkCipherSinceMs[i];
+    if (all || now - last >= CCMP_IDLE_MS) {
+      p->linkCipher = false;
+      memcpy(macs[count++], p->mac, 6);
+    }
+  }
+  portEXIT_CRITICAL(&peerMux);
+  for (uint8_t i = 0; i < count; i++)
+    EspNowTx_clearPeerKey(macs[i]);
+}
+
+/**
+ * Rebuild the allowlist: the paired controller plus every keyed peer
+ * (rx verify worker)
+ */
+void refreshRxAllowlist() {
+  uint8_t macs[PEER_SESSION_MAX][6];
+  uint8_t count = 0;
+  uint8_t link[6];
+  portENTER_CRITICAL(&peerMux);
+  bool paired = haveLinkPeer;
+  memcpy(link, linkPeer, 6);
+  for (int i = 0; i < PEER_SESSION_MAX; i++) {
+    if (peerSessions.peers[i].keyed)
+      memcpy(macs[count++], peerSessions.peers[i].mac, 6);
+  }
+  portEXIT_CRITICAL(&peerMux);
+
+  if (!paired)
+    return;  // Unpaired: any sender may pair
+  RxFilter_setPeer(link);
+  for (uint8_t i = 0; i < count; i++)
+    RxFilter_addPeer(macs[i]);
+}
+
+/**
+ * Install a session for its MAC (rx verify worker)
+ * @return Slot, or PEER_SESSION_NONE if the table is full
+ */
+int installPeerSession(const PendingPeerSession &next) {
+  uint8_t evicted[6];
+  bool didEvict = false;
+  portENTER_CRITICAL(&peerMux);
+  int slot = next.link ? pinLinkPeer(next.mac, evicted, &didEvict)
+                       : PeerSessionTable_acquire(&peerSessions, next.mac, true,
+                                                  evicted, &didEvict);
+  if (slot != PEER_SESSION_NONE) {
+    PeerSession *peer = &peerSessions.peers[slot];
+    peer->keys = next.keys;
+    peer->keyed = true;
+    peer->installs++;
+    ReplayWindow_init(&peer->replay);  // Peer restarts its counter
+  }
+  portEXIT_CRITICAL(&peerMux);
+
+  if (slot == PEER_SESSION_NONE) {
+    LOG_WARN("[KX] Peer table full, session dropped\n");
+  } else {
+    applyPeerKeys(slot, next.keys, next.link);
+    refreshRxAllowlist();
+    if (didEvict) {
+      EspNowTx_clearPeerKey(evicted);
+      LOG_WARN("[KX] Peer %02X:%02X:%02X:%02X:%02X:%02X evicted\n", evicted[0],
+               evicted[1], evicted[2], evicted[3], evicted[4], evicted[5]);
+    }
+  }
+  return slot;
+}
+
+/**
+ * Apply a link reset or a session posted by the key exchange (rx verify
+ * worker, every wake-up: a new peer's frames are filtered out until then)
+ */
+void adoptPendingSession() {
+  if (!pendingSessionReady && !pendingLinkReset)
+    return;
+
+  if (pendingLinkReset) {
+    pendingLinkReset = false;
+    expireLinkCiphers(true, 0);
+    portENTER_CRITICAL(&peerMux);
+    PeerSessionTable_clearKeys(&peerSessions);
+    portEXIT_CRITICAL(&peerMux);
+    SessionResume_init(&resumeTickets);
+    for (uint8_t i = 0; i < PEER_SESSION_MAX; i++) {
+      EncryptionManager_clearPeerKey(i);
+      HMACValidator_clearPeerKey(i);
+    }
+    refreshRxAllowlist();
+  }
+  if (!pendingSessionReady)
+    return;
+
+  PendingPeerSession next;
+  portENTER_CRITICAL(&sessionMux);
+  next = pendingPeer;
+  SessionKeys_wipe(&pendingPeer.keys);
+  pendingSessionReady = false;
+  portEXIT_CRITICAL(&sessionMux);
+
+  if (installPeerSession(next) != PEER_SESSION_NONE) {
+    SessionResume_issue(&resumeTickets, next.mac, &next.keys, HAL_GetMillis());
+    applyLinkCipher(next.mac);  // Handshake answer already sent
+  }
+  SessionKeys_wipe(&next.keys);
+}
+
+/**
+ * Redeem a resume request posted by the Wi-Fi task (rx verify worker,
+ * every wake-up): a handful of HMACs instead of a key exchange. The answer goes
+ * out once the new keys are installed; a rejected request gets none and
+ * the controller falls back to a full handshake.
+ */
+void redeemPendingResume() {
+  if (!pendingResumeReady)
+    return;
+  NAHandshakeResume req;
+  PendingPeerSession next;
+  portENTER_CRITICAL(&sessionMux);
+  req = pendingResume;
+  memcpy(next.mac, pendingResumeMac, 6);
+  pendingResumeReady = false;
+  portEXIT_CRITICAL(&sessionMux);
+
+  uint8_t vehicleNonce[SESSION_RESUME_NONCE_SIZE];
+  uint8_t accept[SESSION_RESUME_TAG_SIZE];
+  if (SecureRandom_fill(vehicleNonce, sizeof(vehicleNonce)) != 0)
+    return;
+  uint32_t startUs = HAL_GetMicros();
+  SessionResumeResult result =
+      SessionResume_redeem(&resumeTickets, next.mac, req.ticketId, req.nonce, req.tag,
+                           vehicleNonce, HAL_GetMillis(), &next.keys, accept);
+  if (result != SESSION_RESUME_OK) {
+    LOG_WARN("[KX] Resume rejected (%d)\n", (int)result);
+    return;
+  }
+
+  // Same role as before: the pair stays the pair, others get a session
+  next.link = claimsLink(next.mac, false);
+  if (installPeerSession(next) != PEER_SESSION_NONE) {
+    EspNowTx_addPeer(next.mac);
+    dropLinkCipher(next.mac);   // Answer in the clear, then the new key
+    NAHandshakeResume resp;
+    NA_Resume_buildFrame(&resp, PACKET_TYPE_HANDSHAKE_PUBKEY, req.ticketId, vehicleNonce,
+                         accept);
+    esp_now_send(next.mac, (uint8_t *)&resp, sizeof(resp));
+    applyLinkCipher(next.mac);
+    LOG_INFO("[KX] Session Resumed (%lu us)\n", (unsigned long)(HAL_GetMicros() - startUs));
+  }
+  SessionKeys_wipe(&next.keys);
+}
+
+/**
+ * Feed link quality with a received control frame (Wi-Fi task)
+ * Once paired, only the paired controller counts: another sender's
+ * sequence numbers would read as loss.
+ */
+void recordLinkFrame(const uint8_t *mac, int8_t rssi, uint32_t sequenceNumber) {
+  if (!rssiManager)
+    return;
+  portENTER_CRITICAL(&telemetryRouteMux);
+  bool fromPeer = memcmp(telemetryPeer, BROADCAST_MAC, 6) == 0 ||
+                  memcmp(telemetryPeer, mac, 6) == 0;
+  portEXIT_CRITICAL(&telemetryRouteMux);
+  if (fromPeer)
+    rssiManager->recordFrame(rssi, sequenceNumber);
+}
+
+/**
+ * Cheap checks on a control frame before it is queued for the crypto in
+ * the rx verify worker (Wi-Fi task, or AsyncTCP for /ws). Rate limiting
+ * comes last so junk frames never spend the paired controller's tokens.
+ * @param rssi Radio frame RSSI, nullptr if not received over the air
+ * @param ring Producer's ring (one per producing task)
+ */
+void acceptControlFrame(const uint8_t *mac, const int8_t *rssi, const NAPacket &pkt,
+                        uint32_t rxUs, ControlRxRing &ring) {
+  if (RxFilter_checkControl(mac, &pkt) != RX_FILTER_PASS)
+    return;
+
+  // Sender's session; a new keyless slot may only replace another keyless one.
+  // A compact frame's sequence is rebuilt from the window: it needs a keyed
+  // session that has accepted a full frame since the window last reset.
+  RadioFrame frame;
+  frame.pkt = pkt;
+  bool compact = pkt.encryptionFlag == NA_ENCRYPTION_COMPACT;
+  ReplayStatus replay = REPLAY_OK;
+  portENTER_CRITICAL(&peerMux);
+  int slot = PeerSessionTable_find(&peerSessions, mac);
+  if (slot == PEER_SESSION_NONE && !compact)
+    slot = PeerSessionTable_acquire(&peerSessions, mac, false, nullptr, nullptr);
+  if (slot != PEER_SESSION_NONE) {
+    ReplayWindow *window = &peerSessions.peers[slot].replay;
+    if (compact && !(peerSessions.peers[slot].keyed && window->haveSeq)) {
+      replay = REPLAY_TOO_OLD;
+      compactUnsynced++;
+    } else {
+      if (compact) {
+        frame.pkt.sequenceNumber =
+            NA_Compact_expandSequence(window->highest, (uint16_t)pkt.sequenceNumber);
+        compactFrames++;
+      }
+      replay = ReplayWindow_check(window, frame.pkt.sequenceNumber, HAL_GetMillis());
+    }
+  }
+  portEXIT_CRITICAL(&peerMux);
+  if (slot == PEER_SESSION_NONE) {
+    RxFilter_record(RX_FILTER_SOURCE);
+    return;
+  }
+  if (rssi)
+    recordLinkFrame(mac, *rssi, frame.pkt.sequenceNumber);
+
+  if (replay != REPLAY_OK) {
+    RxFilter_record(RX_FILTER_SEQUENCE);
+    return;
+  }
+
+  if (RateLimitManager_check(mac, RATE_CLASS_CONTROL) != RATE_LIMIT_ALLOWED) {
+    RxFilter_record(RX_FILTER_RATE);
+    return;
+  }
+  RxFilter_record(RX_FILTER_PASS);
+  if (bootFirstControlUs == 0)
+    bootFirstControlUs = HAL_GetMicros();
+  memcpy(frame.mac, mac, 6);
+  frame.rxUs = rxUs;
+  frame.queuedUs = rxUs ? HAL_GetMicros() : 0;
+  frame.arrivedUs = HAL_Now();
+  ring.push(frame);
+  if (rxVerifyTask)
+    xTaskNotifyGive(rxVerifyTask);
+}
+
+// Source of /ws control frames while unpaired (locally administered)
+static const uint8_t WS_CONTROL_MAC[6] = {0x02, 'N', 'A', 'W', 'S', 0x00};
+
+/**
+ * Binary control frame from a /ws client (AsyncTCP task)
+ * A browser ground station drives as the paired controller: same keys,
+ * replay window and rate bucket, so one pilot at a time, and a frame
+ * must authenticate exactly as it would over ESP-NOW. RTK correction
+ * fragments (a ground station's NTRIP client) share the socket.
+ */
+void onWebSocketControl(const uint8_t *data, size_t len) {
+  if (len == sizeof(NARtcmFragment) && data[1] == NA_RTCM_TYPE) {
+    if (rtkMode == RTK_ROVER && data[0] == PROTOCOL_VERSION)
+      rtkWsRing.push(*(const NARtcmFragment *)data);
+    return;
+  }
+  uint32_t rxUs = latencyProbeEnabled ? HAL_GetMicros() : 0;
+  uint8_t mac[6];
+  portENTER_CRITICAL(&peerMux);
+  memcpy(mac, haveLinkPeer ? linkPeer : WS_CONTROL_MAC, 6);
+  portEXIT_CRITICAL(&peerMux);
+
+  NAPacket pkt;
+  if (len == sizeof(NAPacket)) {
+    memcpy(&pkt, data, sizeof(pkt));
+  } else if (len == sizeof(NAPacketAEAD)) {
+    NA_AEAD_toPacket((const NAPacketAEAD *)data, &pkt);
+  } else if (len == sizeof(NAPacketCompact) && NA_COMPACT_CONTROL &&
+             data[0] == NA_COMPACT_TYPE) {
+    NA_Compact_toPacket((const NAPacketCompact *)data, &pkt);
+  } else {
+    RxFilter_record(RX_FILTER_LENGTH);
+    return;
+  }
+  if (pkt.encryptionFlag == NA_ENCRYPTION_LINK) {
+    RxFilter_record(RX_FILTER_FORMAT);  // Nothing under /ws authenticates it
+    return;
+  }
+  acceptControlFrame(mac, nullptr, pkt, rxUs, wsRxRing);
+}
+
+/**
+ * Radio handshake finished (KeyExchangeManager worker task)
+ * Posts the sender's new session keys; for an INIT also answers with our
+ * public key and, if it takes over the link, records it as our pair.
+ */
+void onKeyExchangeDone(const uint8_t *mac, bool ok, KeyExchangeCurve curve,
+                       uint8_t kxVersion, const uint8_t *secret,
+                       const uint8_t *publicKey) {
+  if (!ok) {
+    LOG_ERROR("[KX] Key Computation Failed\n");
+    return;
+  }
+
+  // Keys are installed by the rx verify worker, for this sender only
+  PendingPeerSession next;
+  memcpy(next.mac, mac, 6);
+  if (kxVersion == NA_KX_VERSION_X25519_HKDF) {
+    // Directional HKDF keys
+    if (!SessionKeys_derive(&next.keys, secret, KEY_EXCHANGE_SHARED_SECRET_SIZE)) {
+      LOG_ERROR("[KX] Session Key Derivation Failed\n");
+      return;
+    }
+  } else {
+    // Raw secret, same key both directions, no ratchet
+    static_assert(KEY_EXCHANGE_SHARED_SECRET_SIZE == SESSION_KEY_SIZE, "raw key size");
+    SessionKeys_wipe(&next.keys);
+    memcpy(next.keys.c2vEnc, secret, SESSION_KEY_SIZE);
+    memcpy(next.keys.c2vMac, secret, SESSION_KEY_SIZE);
+    memcpy(next.keys.v2cEnc, secret, SESSION_KEY_SIZE);
+    memcpy(next.keys.v2cMac, secret, SESSION_KEY_SIZE);
+  }
+  next.link = claimsLink(mac, publicKey != nullptr);
+
+  // The old session's CCMP key goes now; the new one only once the answer
+  // is out, which is why the session is posted after it
+  dropLinkCipher(mac);
+  if (publicKey) {
+    // Unicast needs the controller registered as a peer
+    EspNowTx_addPeer(mac);
+
+    // Send Response with Our Public Key, in the frame the controller used
+    if (curve == KX_CURVE_X25519) {
+      NAHandshakeX25519 resp;
+      NA_X25519_buildFrame(&resp, PACKET_TYPE_HANDSHAKE_PUBKEY, kxVersion, publicKey);
+      esp_now_send(mac, (uint8_t *)&resp, sizeof(resp));
+    } else {
+      NAHandshakePacket resp;
+      resp.protocolVersion = PROTOCOL_VERSION;
+      resp.type = PACKET_TYPE_HANDSHAKE_PUBKEY;
+      memcpy(resp.publicKey, publicKey, KEY_EXCHANGE_PUBKEY_SIZE);
+      resp.checksum = NA_CRC16((uint8_t *)&resp, sizeof(NAHandshakePacket) - 2);
+      esp_now_send(mac, (uint8_t *)&resp, sizeof(resp));
+    }
+  }
+  postPeerSession(next);
+  SessionKeys_wipe(&next.keys);
+
+  if (!publicKey) {
+    LOG_INFO("[KX] Key Exchange Success! Secure Link Established. (%lu us)\n",
+             (unsigned long)KeyExchangeManager::getInstance().getLastHandshakeUs());
+    return;
+  }
+  LOG_INFO("[KX] 2-Way Handshake Complete! Secure Link Established. (%lu us)\n",
+           (unsigned long)KeyExchangeManager::getInstance().getLastHandshakeUs());
+  if (!next.link) {
+    LOG_INFO("[KX] Peer session added, pairing unchanged\n");
+    return;
+  }
+
+  // The controller that completed the handshake is our pair
+  if (configManager) {
+    char macStr[18];
+    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    configManager->setPairedMACAddress(macStr);
+  }
+  setTelemetryRoute(mac);
+}
 
 // ESP-NOW Callback
+#if ESP_IDF_VERSION_MAJOR >= 5
+void OnDataRecv(const esp_now_recv_info_t *info, const uint8_t *incomingData, int len) {
+  const uint8_t *mac = info->src_addr;
+  int8_t rssi = info->rx_ctrl ? info->rx_ctrl->rssi : RSSIManager::getLastFrameRSSI();
+#else
 void OnDataRecv(const uint8_t *mac, const uint8_t *incomingData, int len) {
+  int8_t rssi = RSSIManager::getLastFrameRSSI();
+#endif
+  // Wi-Fi task share of the receive path (rx_verify is the verify worker's)
+  PROFILE_SCOPE("rx_accept");
+  uint32_t rxUs = latencyProbeEnabled ? HAL_GetMicros() : 0;
+  TRACE_INSTANT(TRACE_EV_RADIO_RX, (uint16_t)len);
   // Phase 10: Handshake Packet Handling
   if (len == sizeof(NAHandshakePacket)) {
+    // Handshakes cost an ECC operation each: tight per-peer/class budget
+    if (RateLimitManager_check(mac, RATE_CLASS_HANDSHAKE) != RATE_LIMIT_ALLOWED)
+      return;
     NAHandshakePacket* hpkt = (NAHandshakePacket*)incomingData;
     if (hpkt->protocolVersion == PROTOCOL_VERSION) {
        if (hpkt->type == PACKET_TYPE_HANDSHAKE_INIT) {
-          // 2-Way Handshake:
-          // Received INIT with Peer's Public Key.
-          // 1. Generate Our Pair
-          // 2. Compute Secret (using Peer's Key)
-          // 3. Respond with Our Public Key
-          Serial.println("[KX] Handshake Init (with Key) Received");
-          
-          KeyExchangeManager& kx = KeyExchangeManager::getInstance();
-          kx.reset();
-          
-          if (kx.generateKeyPair()) {
-              // Compute Secret immediately using the key from the packet
-              if (kx.computeSharedSecret(hpkt->publicKey)) {
-                  // Success! Get the secret
-                  uint8_t secret[32];
-                  kx.getSharedSecret(secret);
-                  
-                  // Apply keys
-                  EncryptionManager_init(secret);
-                  HMACValidator_init(secret);
-                  
-                  // Send Response with Our Public Key
-                  NAHandshakePacket resp;
-                  resp.protocolVersion = PROTOCOL_VERSION;
-                  resp.type = PACKET_TYPE_HANDSHAKE_PUBKEY;
-                  kx.getPublicKey(resp.publicKey);
-                  resp.checksum = NA_CRC16((uint8_t*)&resp, sizeof(NAHandshakePacket) - 2);
-                  
-                  esp_now_send(mac, (uint8_t*)&resp, sizeof(resp));
-                  Serial.println("[KX] 2-Way Handshake Complete! Secure Link Established.");
-              } else {
-                  Serial.println("[KX] Compute Secret Failed");
-              }
-          } else {
-              Serial.println("[KX] Key Gen Failed");
-          }
+          // 2-Way Handshake: Peer's Public Key in INIT. The worker installs
+          // our pregenerated pair, computes the secret and answers with our
+          // key (onKeyExchangeDone) - no ECC math in the Wi-Fi task
+          LOG_INFO("[KX] Handshake Init (with Key) Received\n");
+          if (!KeyExchangeManager::getInstance().submitHandshakeInit(mac, hpkt->publicKey,
+                                                                    KX_CURVE_P256, NA_KX_VERSION_P256))
+              LOG_WARN("[KX] Key Exchange Worker Not Running\n");
        } else if (hpkt->type == PACKET_TYPE_HANDSHAKE_PUBKEY) {
-          // Received Peer Public Key -> Compute Secret
-          Serial.println("[KX] Peer Public Key Received");
-          if (KeyExchangeManager::getInstance().computeSharedSecret(hpkt->publicKey)) {
-              uint8_t secret[32];
-              KeyExchangeManager::getInstance().getSharedSecret(secret);
-              
-              // Apply new keys to security managers
-              EncryptionManager_init(secret);
-              HMACValidator_init(secret);
-              
-              Serial.println("[KX] Key Exchange Success! Secure Link Established.");
-          } else {
-             Serial.println("[KX] Key Computation Failed");
-          }
+          // Received Peer Public Key -> Compute Secret (worker)
+          LOG_INFO("[KX] Peer Public Key Received\n");
+          if (!KeyExchangeManager::getInstance().submitPeerPublicKey(mac, hpkt->publicKey,
+                                                                    KX_CURVE_P256, NA_KX_VERSION_P256))
+              LOG_WARN("[KX] Key Exchange Worker Not Running\n");
        }
     }
   }
+  else if (len == sizeof(NAHandshakeX25519)) {
+    // Compact handshake: kxVersion selects the curve, same flow as above
+    if (RateLimitManager_check(mac, RATE_CLASS_HANDSHAKE) != RATE_LIMIT_ALLOWED)
+      return;
+    const NAHandshakeX25519 *hpkt = (const NAHandshakeX25519 *)incomingData;
+    uint8_t version = hpkt->kxVersion;
+    if (hpkt->protocolVersion == PROTOCOL_VERSION &&
+        (version == NA_KX_VERSION_X25519 || version == NA_KX_VERSION_X25519_HKDF)) {
+      KeyExchangeManager &kx = KeyExchangeManager::getInstance();
+      bool posted = false;
+      if (hpkt->type == PACKET_TYPE_HANDSHAKE_INIT) {
+        LOG_INFO("[KX] X25519 Handshake Init Received\n");
+        posted = kx.submitHandshakeInit(mac, hpkt->publicKey, KX_CURVE_X25519, version);
+      } else if (hpkt->type == PACKET_TYPE_HANDSHAKE_PUBKEY) {
+        LOG_INFO("[KX] X25519 Peer Public Key Received\n");
+        posted = kx.submitPeerPublicKey(mac, hpkt->publicKey, KX_CURVE_X25519, version);
+      }
+      if (!posted)
+        LOG_WARN("[KX] Key Exchange Worker Not Running\n");
+    }
+  }
+  else if (len == sizeof(NAHandshakeResume)) {
+    // Ticket resumption: copied here, redeemed by the rx verify worker
+    if (RateLimitManager_check(mac, RATE_CLASS_HANDSHAKE) != RATE_LIMIT_ALLOWED)
+      return;
+    const NAHandshakeResume *hpkt = (const NAHandshakeResume *)incomingData;
+    if (hpkt->protocolVersion == PROTOCOL_VERSION && hpkt->type == PACKET_TYPE_HANDSHAKE_INIT &&
+        hpkt->kxVersion == NA_KX_VERSION_RESUME &&
+        hpkt->checksum == NA_CRC16((uint8_t *)hpkt, sizeof(NAHandshakeResume) - 2)) {
+      portENTER_CRITICAL(&sessionMux);
+      pendingResume = *hpkt;
+      memcpy(pendingResumeMac, mac, 6);
+      pendingResumeReady = true;
+      portEXIT_CRITICAL(&sessionMux);
+    }
+  }
   else if (len == sizeof(NAPacket)) {
+    // Bounded copy only: decryption and HMAC validation run in the rx
+    // verify worker so the Wi-Fi task is released immediately. Cheap
+    // rejection and rate limiting happen here, the only place the sender's
+    // MAC is known
+    acceptControlFrame(mac, &rssi, *(const NAPacket *)incomingData, rxUs, radioRxRing);
+  }
+  else if (len == sizeof(NAPacketAEAD)) {
+    // Compact GCM frame: unpacked here, verified by the rx verify worker
     NAPacket pkt;
-    memcpy(&pkt, incomingData, sizeof(NAPacket));
-
-    // Phase 9 Security Hardening: Apply Rate Limit FIRST to prevent CPU exhaustion
-    if (RateLimitManager_checkCommand(pkt.mode) != RATE_LIMIT_ALLOWED) {
-      failsafeManager.recordPacketReceived(millis(), false);
-      return; 
+    NA_AEAD_toPacket((const NAPacketAEAD *)incomingData, &pkt);
+    acceptControlFrame(mac, &rssi, pkt, rxUs, radioRxRing);
+  }
+  else if (len == sizeof(NAPacketCompact) && NA_COMPACT_CONTROL) {
+    // High-rate stick frame: sequence rebuilt in acceptControlFrame
+    if (incomingData[0] != NA_COMPACT_TYPE) {
+      RxFilter_record(RX_FILTER_FORMAT);
+      return;
+    }
+    NAPacket pkt;
+    NA_Compact_toPacket((const NAPacketCompact *)incomingData, &pkt);
+    acceptControlFrame(mac, &rssi, pkt, rxUs, radioRxRing);
+  }
+  else if (len == LINK_RATE_FRAME_SIZE) {
+    // Rate ack from the controller we send telemetry to (any while unpaired)
+    LinkRateFrame ack;
+    portENTER_CRITICAL(&telemetryRouteMux);
+    bool fromPeer = memcmp(telemetryPeer, BROADCAST_MAC, 6) == 0 ||
+                    memcmp(telemetryPeer, mac, 6) == 0;
+    portEXIT_CRITICAL(&telemetryRouteMux);
+    if (!fromPeer)
+      RxFilter_record(RX_FILTER_SOURCE);
+    else if (!LinkRate_decode(incomingData, len, &ack))
+      RxFilter_record(RX_FILTER_CHECKSUM);
+    else
+      linkAckRing.push(ack);
+  }
+  else if (len == CLOCK_SYNC_FRAME_SIZE) {
+    // Clock sync reply: only the controller we are synchronizing with
+    ClockSyncRx rx;
+    rx.rxUs = HAL_Now();
+    portENTER_CRITICAL(&telemetryRouteMux);
+    bool fromPeer = memcmp(telemetryPeer, mac, 6) == 0;
+    portEXIT_CRITICAL(&telemetryRouteMux);
+    if (!fromPeer)
+      RxFilter_record(RX_FILTER_SOURCE);
+    else if (!ClockSync_decode(incomingData, len, &rx.frame))
+      RxFilter_record(RX_FILTER_CHECKSUM);
+    else
+      clockSyncRing.push(rx);
+  }
+  else if (len == sizeof(NAFormationBeacon)) {
+    // Neighbour state: cheap checks, then queued for the telemetry task.
+    // Not rate limited per class: that would spend control tokens, and the
+    // ring already bounds the work (a flood only overwrites older beacons)
+    const NAFormationBeacon *beacon = (const NAFormationBeacon *)incomingData;
+    portENTER_CRITICAL(&formationMux);
+    bool member = formationConfig.enabled && beacon->group == formationConfig.group;
+    portEXIT_CRITICAL(&formationMux);
+    if (member && beacon->protocolVersion == PROTOCOL_VERSION &&
+        beacon->type == NA_BEACON_TYPE) {
+      BeaconFrame frame;
+      memcpy(frame.mac, mac, 6);
+      frame.beacon = *beacon;
+      frame.rxMs = HAL_GetMillis();
+      beaconRxRing.push(frame);
     }
+  }
+  else if (len == sizeof(NARtcmFragment)) {
+    // RTK correction from a base vehicle: queued for the telemetry task,
+    // which authenticates it; ignored unless we are a rover
+    const NARtcmFragment *frag = (const NARtcmFragment *)incomingData;
+    if (rtkMode == RTK_ROVER && frag->protocolVersion == PROTOCOL_VERSION &&
+        frag->type == NA_RTCM_TYPE)
+      rtkRxRing.push(*frag);
+  }
+#if FEATURE_OTA
+  else if (len == sizeof(NAFleetAnnounce) || len == sizeof(NAFleetChunk) ||
+           len == sizeof(NAFleetNack)) {
+    // Fleet firmware: broadcast from any vehicle, checked and queued by
+    // the OTA fleet task (dropped unless it is sending or listening)
+    OTAUpdater_fleetFrame(incomingData, len);
+  }
+#endif
+  else {
+    RxFilter_record(RX_FILTER_LENGTH);
+  }
+}
 
-    bool valid = true;
-    ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
+/**
+ * Validate a control packet taken from the radio / ws ring (rx verify
+ * worker, or the control task when the worker could not start)
+ * @param pkt Packet, decrypted in place if encrypted
+ * @param mac Sender: its own keys if it has a session, else the link keys
+ * @return true if the packet may be applied to the vehicle
+ */
+bool processControlPacket(NAPacket &pkt, const uint8_t *mac) {
+    PROFILE_SCOPE("rx_verify");
+    TRACE_SCOPE(TRACE_EV_RX_VERIFY);
+    // Phase 9 Security Hardening: rate limits are applied on reception
+    // (OnDataRecv per peer, serial/host link per class) before any crypto
+
+    // Duplicates and stale frames are dropped before any crypto work; they
+    // are not fresh link activity, so the failsafe does not see them.
+    // OnDataRecv already checked; this catches copies queued together
+    uint32_t now = HAL_GetMillis();
+    portENTER_CRITICAL(&peerMux);
+    int slot = PeerSessionTable_find(&peerSessions, mac);
+    ReplayStatus replay = REPLAY_DUPLICATE;   // Slot lost since queued
+    bool keyed = false;
+    bool link = false;
+    bool linkCipher = false;
+    SessionKeys session;
+    if (slot != PEER_SESSION_NONE) {
+      replay = ReplayWindow_check(&peerSessions.peers[slot].replay, pkt.sequenceNumber, now);
+      keyed = peerSessions.peers[slot].keyed;
+      link = peerSessions.peers[slot].pinned;
+      linkCipher = peerSessions.peers[slot].linkCipher;
+      if (keyed && replay == REPLAY_OK)
+        session = peerSessions.peers[slot].keys;
+    }
+    portEXIT_CRITICAL(&peerMux);
+    if (replay != REPLAY_OK)
+      return false;
+
+    // HKDF session: ratchet first if this frame opens the next epoch. A
+    // frame from an older epoch (or further ahead) is not this session's.
+    // The ratchet runs on a copy, published under peerMux once the frame
+    // authenticates (saveWarmRestart reads the keys on the control task)
+    bool ratcheted = false;
+    if (keyed && session.valid) {
+      int32_t steps = SessionKeys_stepsFor(&session, pkt.sequenceNumber);
+      if (steps == 1) {
+        if (!SessionKeys_ratchet(&session)) {
+          SessionKeys_wipe(&session);
+          return false;
+        }
+        applyPeerKeys(slot, session, link);
+        ratcheted = true;
+      } else if (steps != 0) {
+        SessionKeys_wipe(&session);
+        return false;
+      }
+    }
+
+    bool valid = true;
 
     // Enforce Encryption if enabled in config or if session is established
-    bool requireEncryption = sec.encryptionEnabled || EncryptionManager_isReady();
+    bool requireEncryption = securityEncryption || keyed || EncryptionManager_isReady();
+
+    bool aead = pkt.encryptionFlag == NA_ENCRYPTION_AEAD;
+    bool compact = pkt.encryptionFlag == NA_ENCRYPTION_COMPACT;
+    uint16_t payloadLen = 10; // throttle to buttons
 
-    if (pkt.encryptionFlag == 1) {
-      if (!EncryptionManager_isReady()) {
+    if (compact) {
+      // Truncated-tag GCM under the peer's own keys only
+      valid = keyed && NA_Compact_decryptPacketFrom(slot, &pkt);
+    } else if (pkt.encryptionFlag == NA_ENCRYPTION_LINK) {
+      // Decrypted and authenticated by the Wi-Fi MAC (CCMP); only from a
+      // peer whose session key the driver holds
+      valid = keyed && linkCipher;
+    } else if (aead) {
+      // Single GCM pass: decrypt + authenticate (tag replaces HMAC and CRC)
+      if (keyed) {
+        valid = NA_AEAD_decryptPacketFrom(slot, &pkt);
+      } else if (!EncryptionManager_isReady() || !NA_AEAD_decryptPacket(&pkt)) {
+        valid = false;
+      }
+    } else if (pkt.encryptionFlag == NA_ENCRYPTION_CTR_HMAC) {
+      // Decrypt in place (CTR mode), then validate HMAC
+      if (keyed) {
+        valid = EncryptionManager_decryptFrom(slot, (uint8_t *)&pkt.throttle, payloadLen,
+                                              pkt.iv, (uint8_t *)&pkt.throttle) &&
+                HMACValidator_validateFrom(slot, (uint8_t *)&pkt.throttle, payloadLen,
+                                           pkt.hmac);
+      } else if (!EncryptionManager_isReady()) {
         valid = false;
       } else {
-        // Decrypt in place (CTR mode)
-        uint16_t payloadLen = 10; // throttle to buttons
         if (EncryptionManager_decrypt((uint8_t *)&pkt.throttle, payloadLen,
                                       pkt.iv, (uint8_t *)&pkt.throttle)) {
           // Validate HMAC
@@ -153,442 +1568,7508 @@ void OnDataRecv(const uint8_t *mac, const uint8_t *incomingData, int len) {
       valid = false;
     }
 
-    if (valid && NA_PACKET_IS_VALID(&pkt)) {
-      memcpy(&latestPacket, &pkt, sizeof(NAPacket));
-      failsafeManager.recordPacketReceived(millis(), true);
-      if (rssiManager)
-        rssiManager->updateRSSI(-60);
-      if (vehicle)
-        vehicle->setInputs(&latestPacket);
-    } else {
-      failsafeManager.recordPacketReceived(millis(), false);
+    bool intact = aead || compact ? pkt.protocolVersion == PROTOCOL_VERSION
+                       : NA_PACKET_IS_VALID(&pkt);
+
+    if (valid && intact) {
+      // Only authenticated frames may move the window (or the epoch).
+      // A keyless slot may have been reused for another MAC meanwhile.
+      if (keyed)
+        SessionKeys_accept(&session, pkt.sequenceNumber);
+      portENTER_CRITICAL(&peerMux);
+      if (PeerSessionTable_find(&peerSessions, mac) == slot) {
+        ReplayWindow_accept(&peerSessions.peers[slot].replay, pkt.sequenceNumber, now);
+        PeerSessionTable_touch(&peerSessions, slot);
+        if (keyed)
+          peerSessions.peers[slot].keys = session;
+      }
+      portEXIT_CRITICAL(&peerMux);
+      if (keyed)
+        SessionKeys_wipe(&session);
+      failsafeManager.recordPacketReceived(HAL_GetMillis(), true);
+      return true;
+    }
+
+    // Forged or corrupt frame: stay on the current epoch (keyed slots
+    // only change in this task, so the stored keys are still that epoch)
+    if (ratcheted)
+      applyPeerKeys(slot, peerSessions.peers[slot].keys, link);
+    if (keyed)
+      SessionKeys_wipe(&session);
+    failsafeManager.recordPacketReceived(HAL_GetMillis(), false);
+    return false;
+}
+
+/**
+ * Verify every frame queued on one input ring, in arrival order, and pass
+ * the authentic ones to the control task
+ * @return Frames taken
+ */
+static uint32_t verifyControlRing(ControlRxRing &in, ControlRing &out) {
+  RadioFrame frame;
+  uint32_t taken = 0;
+  while (in.readNext(frame)) {
+    taken++;
+    frame.dequeuedUs = frame.rxUs ? HAL_GetMicros() : 0;
+    bool ok = processControlPacket(frame.pkt, frame.mac);
+    frame.verifiedUs = frame.rxUs ? HAL_GetMicros() : 0;
+    if (ok)
+      out.push(frame);
+    else
+      rxVerifyForged++;
+  }
+  return taken;
+}
+
+/**
+ * Session upkeep, then the queued radio and /ws frames (rx verify
+ * worker, or each control tick when the worker could not start)
+ */
+void verifyControlFrames() {
+  adoptPendingSession();
+  redeemPendingResume();
+  expireLinkCiphers(false, HAL_GetMillis());
+  uint32_t taken = verifyControlRing(radioRxRing, radioVerifiedRing) +
+                   verifyControlRing(wsRxRing, wsVerifiedRing);
+  if (taken == 0)
+    return;
+  rxVerifyFrames += taken;
+  rxVerifyBatches++;
+  if (taken > rxVerifyMaxBatch)
+    rxVerifyMaxBatch = taken;
+}
+
+/**
+ * Crypto worker on the core the control task does not use: woken by each
+ * queued frame, it verifies whatever has piled up since in one pass
+ */
+static void rxVerifyEntry(void *arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RX_VERIFY_IDLE_MS));
+    verifyControlFrames();
+  }
+}
+
+/**
+ * Start the rx verify worker (setup, once boot has restored the sessions);
+ * without it the control task verifies as before
+ */
+bool startRxVerifyWorker() {
+  if (xTaskCreatePinnedToCore(rxVerifyEntry, "rx_verify", RX_VERIFY_STACK, nullptr,
+                              SCHED_PRIORITY_RX_VERIFY, &rxVerifyTask,
+                              SCHED_BACKGROUND_CORE) != pdPASS) {
+    rxVerifyTask = nullptr;
+    LOG_WARN("[RX] Verify worker not started, verifying in the control task\n");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Bulk mission upload frame from the host; one ACK per frame
+ * Only BEGIN draws a command token: the chunks belong to an upload the
+ * rate limiter already admitted.
+ */
+void handleMissionFrame(uint8_t type, const uint8_t *payload, int payloadLen) {
+  WaypointManager &wpm = WaypointManager::getInstance();
+  MissionUploadStatus status = MISSION_UPLOAD_BAD_FRAME;
+
+  if (type == HOST_FRAME_MISSION_BEGIN && payloadLen == sizeof(HostMissionBegin)) {
+    if (RateLimitManager_check(NULL, RATE_CLASS_COMMAND) != RATE_LIMIT_ALLOWED)
+      return;
+    HostMissionBegin begin;
+    memcpy(&begin, payload, sizeof(begin));
+    status = wpm.beginUpload(begin.count, begin.crc);
+  } else if (type == HOST_FRAME_MISSION_DATA && payloadLen >= 2 &&
+             (payloadLen - 2) % sizeof(WaypointRecord) == 0) {
+    uint16_t first;
+    memcpy(&first, payload, sizeof(first));
+    WaypointRecord records[HOST_MISSION_CHUNK_MAX];
+    uint16_t n = (payloadLen - 2) / sizeof(WaypointRecord);
+    memcpy(records, payload + 2, n * sizeof(WaypointRecord));
+    status = wpm.uploadChunk(first, records, n);
+  } else if (type == HOST_FRAME_MISSION_END) {
+    status = wpm.finishUpload();
+    if (status == MISSION_UPLOAD_OK)
+      Serial.printf("[Mission] Uploaded %u waypoints\n", wpm.getUploadNext());
+  }
+
+  HostMissionAck ack;
+  ack.status = status;
+  ack.next = wpm.getUploadNext();
+  uint8_t frame[HOST_FRAME_MAX_ENCODED];
+  size_t frameLen = HostProtocol_buildFrame(HOST_FRAME_MISSION_ACK, &ack, sizeof(ack),
+                                            frame, sizeof(frame));
+  Serial.write(frame, frameLen);
+}
+
+/**
+ * Handle a COBS frame from the host (binary protocol, no JSON)
+ * @param encoded Frame body between the 0x00 delimiters
+ * @param encodedLen Body length
+ */
+void handleBinaryFrame(const uint8_t *encoded, size_t encodedLen) {
+  uint8_t type;
+  uint8_t payload[HOST_FRAME_MAX_PAYLOAD];
+  int payloadLen = HostProtocol_parseFrame(encoded, encodedLen, &type,
+                                           payload, sizeof(payload));
+  if (payloadLen < 0) {
+    failsafeManager.recordPacketReceived(HAL_GetMillis(), false);
+    return;
+  }
+
+  if (type == HOST_FRAME_CONTROL && payloadLen == sizeof(NAPacket)) {
+    if (RateLimitManager_check(NULL, RATE_CLASS_CONTROL) != RATE_LIMIT_ALLOWED)
+      return;
+
+    NAPacket pkt;
+    memcpy(&pkt, payload, sizeof(NAPacket));
+    if (!NA_PACKET_IS_VALID(&pkt)) {
+      failsafeManager.recordPacketReceived(HAL_GetMillis(), false);
+      return;
+    }
+
+    failsafeManager.recordPacketReceived(HAL_GetMillis(), true);
+
+    // Same stick fields as the JSON "sm" command
+    serialPacket.throttle = pkt.throttle;
+    serialPacket.roll = pkt.roll;
+    serialPacket.pitch = pkt.pitch;
+    serialPacket.yaw = pkt.yaw;
+    serialPacket.protocolVersion = PROTOCOL_VERSION;
+    serialPacket.encryptionFlag = 0;
+    serialPacket.sequenceNumber = ++packetSequence;
+    NA_UPDATE_PACKET_CHECKSUM(&serialPacket);
+    serialRxRing.push({serialPacket, HAL_Now()});
+  } else if (type >= HOST_FRAME_MISSION_BEGIN && type <= HOST_FRAME_MISSION_END) {
+    handleMissionFrame(type, payload, payloadLen);
+  }
+}
+
+// ============================================================================
+// MAVLink Bridge
+// ============================================================================
+
+#ifndef MAVLINK_SYSTEM_ID
+#define MAVLINK_SYSTEM_ID 1
+#endif
+#define MAVLINK_COMPONENT_ID 1        // MAV_COMP_ID_AUTOPILOT1
+#define MAVLINK_ACTIVE_MS 5000        // Stream while the GCS was heard this recently
+#define MAVLINK_ATTITUDE_TICKS 2      // Telemetry ticks (TELEMETRY_PERIOD_MS) per message
+#define MAVLINK_POSITION_TICKS 4
+#define MAVLINK_HEARTBEAT_TICKS 20
+
+struct MavLinkStats {
+  uint32_t received;   // Valid frames
+  uint32_t badFrames;  // Short / CRC
+  uint32_t unknown;    // No CRC_EXTRA: a message we do not speak
+  uint32_t signedFrames;
+  uint32_t sent;
+  uint32_t dropped;    // Log queue full
+  uint32_t missionsIn; // Uploads committed
+};
+
+MavLinkTx mavlinkTx = {MAVLINK_SYSTEM_ID, MAVLINK_COMPONENT_ID, 0};
+portMUX_TYPE mavlinkMux = portMUX_INITIALIZER_UNLOCKED; // mavlinkTx: comms + telemetry
+volatile uint32_t mavlinkRxMs = 0;    // Last valid frame (millis), 0 = never
+MavLinkStats mavlinkStats;
+MavMissionUpload mavlinkUpload;       // Comms task only
+WaypointRecord *mavlinkUploadBuffer = nullptr;
+
+// Parameters the GCS can read and write, all REAL32
+static const char *const MAVLINK_PARAMS[] = {"PID_KP", "PID_KI", "PID_KD",
+                                             "NAV_MODE", "NAV_L1", "NAV_CUT"};
+#define MAVLINK_PARAM_COUNT (sizeof(MAVLINK_PARAMS) / sizeof(MAVLINK_PARAMS[0]))
+
+bool mavlinkActive(uint32_t now) {
+  uint32_t rx = mavlinkRxMs;
+  return rx != 0 && now - rx < MAVLINK_ACTIVE_MS;
+}
+
+/**
+ * Seal the payload already in frame and queue it (any task); the Log
+ * queue keeps each frame in one piece next to the text output
+ */
+static void mavlinkSend(uint8_t *frame, uint32_t msgid, uint8_t len) {
+  portENTER_CRITICAL(&mavlinkMux);
+  size_t frameLen = MavLink_finish(&mavlinkTx, frame, msgid, len);
+  portEXIT_CRITICAL(&mavlinkMux);
+  if (frameLen && Log_write(frame, frameLen))
+    mavlinkStats.sent++;
+  else
+    mavlinkStats.dropped++;
+}
+
+static bool mavlinkForUs(uint8_t targetSystem, uint8_t targetComponent) {
+  return (targetSystem == 0 || targetSystem == MAVLINK_SYSTEM_ID) &&
+         (targetComponent == 0 || targetComponent == MAVLINK_COMPONENT_ID);
+}
+
+static float mavlinkParamGet(uint16_t index) {
+  NavGuidanceConfig guidance = NavigationManager::getInstance().getGuidance();
+  ConfigManager::PIDConfig pid;
+  if (configManager)
+    pid = configManager->getPIDConfig();
+  switch (index) {
+  case 0: return pid.kp;
+  case 1: return pid.ki;
+  case 2: return pid.kd;
+  case 3: return guidance.mode == NAV_GUIDANCE_L1 ? 1.0f : 0.0f;
+  case 4: return guidance.lookahead;
+  default: return guidance.cornerCut;
+  }
+}
+
+static void mavlinkParamSet(uint16_t index, float value) {
+  if (index < 3) {
+    if (!configManager)
+      return;
+    ConfigManager::PIDConfig pid = configManager->getPIDConfig();
+    float *gains[] = {&pid.kp, &pid.ki, &pid.kd};
+    *gains[index] = value;
+    configManager->setPIDConfig(pid);
+    return;
+  }
+  // NavigationManager clamps these, as for set_nav
+  NavGuidanceConfig guidance = NavigationManager::getInstance().getGuidance();
+  if (index == 3)
+    guidance.mode = value != 0.0f ? NAV_GUIDANCE_L1 : NAV_GUIDANCE_DIRECT;
+  else if (index == 4)
+    guidance.lookahead = value;
+  else
+    guidance.cornerCut = value;
+  NavigationManager::getInstance().setGuidance(guidance);
+}
+
+static void mavlinkParamValue(uint16_t index) {
+  uint8_t frame[MAVLINK_MAX_FRAME];
+  MavParamValue *value = (MavParamValue *)MavLink_payload(frame);
+  memset(value, 0, sizeof(*value));
+  value->paramValue = mavlinkParamGet(index);
+  value->paramCount = MAVLINK_PARAM_COUNT;
+  value->paramIndex = index;
+  MavLink_setParamId(value->paramId, MAVLINK_PARAMS[index]);
+  value->paramType = MAV_PARAM_TYPE_REAL32;
+  mavlinkSend(frame, MAVLINK_MSG_PARAM_VALUE, sizeof(*value));
+}
+
+static void mavlinkMissionAck(const MavLinkView &from, uint8_t result, uint8_t missionType) {
+  uint8_t frame[MAVLINK_MAX_FRAME];
+  MavMissionAck *ack = (MavMissionAck *)MavLink_payload(frame);
+  ack->targetSystem = from.systemId;
+  ack->targetComponent = from.componentId;
+  ack->type = result;
+  ack->missionType = missionType;
+  mavlinkSend(frame, MAVLINK_MSG_MISSION_ACK, sizeof(*ack));
+}
+
+static void mavlinkMissionRequest(const MavMissionUpload &up) {
+  uint8_t frame[MAVLINK_MAX_FRAME];
+  MavMissionRequestInt *req = (MavMissionRequestInt *)MavLink_payload(frame);
+  req->seq = up.next;
+  req->targetSystem = up.peerSystem;
+  req->targetComponent = up.peerComponent;
+  req->missionType = MAV_MISSION_TYPE_MISSION;
+  mavlinkSend(frame, MAVLINK_MSG_MISSION_REQUEST_INT, sizeof(*req));
+}
+
+static void mavlinkUploadEnd() {
+  MavMissionUpload_end(&mavlinkUpload);
+  MemPlacement_free(mavlinkUploadBuffer);
+  mavlinkUploadBuffer = nullptr;
+}
+
+/**
+ * Hand a complete MAVLink mission to the store as one bulk upload
+ * @return MAV_MISSION_RESULT for the final ACK
+ */
+static uint8_t mavlinkCommitMission(const WaypointRecord *records, uint16_t count) {
+  WaypointManager &wpm = WaypointManager::getInstance();
+  uint16_t crc = Crc16_compute((const uint8_t *)records, count * sizeof(WaypointRecord));
+  MissionUploadStatus status = wpm.beginUpload(count, crc);
+  if (status == MISSION_UPLOAD_OK && count)
+    status = wpm.uploadChunk(0, records, count);
+  if (status == MISSION_UPLOAD_OK)
+    status = wpm.finishUpload();
+  if (status == MISSION_UPLOAD_OK) {
+    mavlinkStats.missionsIn++;
+    LOG_INFO("[MAVLink] Mission of %u items accepted\n", count);
+    return MAV_MISSION_ACCEPTED;
+  }
+  return status == MISSION_UPLOAD_BUSY ? MAV_MISSION_DENIED : MAV_MISSION_ERROR;
+}
+
+static void mavlinkUploadStep(MavMissionStep step, const MavLinkView &from) {
+  if (step == MAV_MISSION_STEP_REQUEST) {
+    mavlinkMissionRequest(mavlinkUpload);
+  } else if (step == MAV_MISSION_STEP_COMPLETE) {
+    uint8_t result = mavlinkCommitMission(mavlinkUploadBuffer, mavlinkUpload.count);
+    mavlinkMissionAck(from, result, MAV_MISSION_TYPE_MISSION);
+    mavlinkUploadEnd();
+  } else if (step == MAV_MISSION_STEP_ABORT) {
+    mavlinkMissionAck(from, mavlinkUpload.result, MAV_MISSION_TYPE_MISSION);
+    mavlinkUploadEnd();
+  }
+}
+
+static void mavlinkMissionCount(const MavLinkView &view) {
+  const MavMissionCount *msg = (const MavMissionCount *)view.payload;
+  if (msg->missionType != MAV_MISSION_TYPE_MISSION) {
+    mavlinkMissionAck(view, MAV_MISSION_UNSUPPORTED, msg->missionType);
+    return;
+  }
+  mavlinkUploadEnd();
+  if (msg->count == 0) {
+    mavlinkMissionAck(view, mavlinkCommitMission(nullptr, 0), MAV_MISSION_TYPE_MISSION);
+    return;
+  }
+  if (msg->count > MAX_WAYPOINTS) {
+    mavlinkMissionAck(view, MAV_MISSION_NO_SPACE, MAV_MISSION_TYPE_MISSION);
+    return;
+  }
+  mavlinkUploadBuffer = (WaypointRecord *)MemPlacement_alloc(
+      "mavlink_mission", msg->count * sizeof(WaypointRecord), MEM_CLASS_BULK);
+  if (!mavlinkUploadBuffer) {
+    mavlinkMissionAck(view, MAV_MISSION_NO_SPACE, MAV_MISSION_TYPE_MISSION);
+    return;
+  }
+  mavlinkUploadStep(MavMissionUpload_begin(&mavlinkUpload, mavlinkUploadBuffer, msg->count,
+                                           view.systemId, view.componentId, HAL_GetMillis()),
+                    view);
+}
+
+static void mavlinkMissionItem(uint16_t seq, const MavLinkView &to, uint8_t missionType) {
+  WaypointManager &wpm = WaypointManager::getInstance();
+  if (missionType != MAV_MISSION_TYPE_MISSION || seq >= wpm.getWaypointCount()) {
+    mavlinkMissionAck(to, MAV_MISSION_INVALID_SEQUENCE, missionType);
+    return;
+  }
+  WaypointRecord record;
+  record.lat = wpm.getLatE7(seq);
+  record.lng = wpm.getLngE7(seq);
+  record.alt = (int16_t)lroundf(wpm.getAlt(seq) * 10.0f);
+  record.param = wpm.getParam(seq);
+  record.cmd = wpm.getCommand(seq);
+  record.arg = wpm.getView().arg[seq];
+
+  uint8_t frame[MAVLINK_MAX_FRAME];
+  MavMissionItemInt *item = (MavMissionItemInt *)MavLink_payload(frame);
+  MavMission_toItem(&record, seq, item);
+  item->targetSystem = to.systemId;
+  item->targetComponent = to.componentId;
+  item->current = seq == 0;
+  mavlinkSend(frame, MAVLINK_MSG_MISSION_ITEM_INT, sizeof(*item));
+}
+
+/**
+ * MAVLink frame from the host (comms task)
+ * Only requests that change state draw a command token, as with the
+ * bulk mission frames: mission items and reads belong to a transfer or
+ * a listing the GCS drives.
+ */
+void handleMavlinkFrame(uint8_t *frame, size_t frameLen) {
+  MavLinkView view;
+  MavLinkParseResult parsed = MavLink_parse(frame, frameLen, &view);
+  if (parsed != MAVLINK_PARSE_OK) {
+    if (parsed == MAVLINK_PARSE_UNKNOWN)
+      mavlinkStats.unknown++;
+    else if (parsed == MAVLINK_PARSE_SIGNED)
+      mavlinkStats.signedFrames++;
+    else
+      mavlinkStats.badFrames++;
+    return;
+  }
+  mavlinkStats.received++;
+  mavlinkRxMs = HAL_GetMillis();
+
+  // Messages only a vehicle sends fall through to default
+  const uint8_t *p = view.payload;
+  switch (view.msgid) {
+  case MAVLINK_MSG_PARAM_REQUEST_LIST: {
+    const MavParamRequestList *msg = (const MavParamRequestList *)p;
+    if (mavlinkForUs(msg->targetSystem, msg->targetComponent))
+      for (uint16_t i = 0; i < MAVLINK_PARAM_COUNT; i++)
+        mavlinkParamValue(i);
+    break;
+  }
+
+  case MAVLINK_MSG_PARAM_REQUEST_READ: {
+    const MavParamRequestRead *msg = (const MavParamRequestRead *)p;
+    if (!mavlinkForUs(msg->targetSystem, msg->targetComponent))
+      break;
+    for (uint16_t i = 0; i < MAVLINK_PARAM_COUNT; i++)
+      if (msg->paramIndex == i ||
+          (msg->paramIndex < 0 && MavLink_paramIdEquals(msg->paramId, MAVLINK_PARAMS[i])))
+        mavlinkParamValue(i);
+    break;
+  }
+
+  case MAVLINK_MSG_PARAM_SET: {
+    const MavParamSet *msg = (const MavParamSet *)p;
+    if (!mavlinkForUs(msg->targetSystem, msg->targetComponent) ||
+        RateLimitManager_check(NULL, RATE_CLASS_COMMAND) != RATE_LIMIT_ALLOWED)
+      break;
+    for (uint16_t i = 0; i < MAVLINK_PARAM_COUNT; i++) {
+      if (MavLink_paramIdEquals(msg->paramId, MAVLINK_PARAMS[i])) {
+        mavlinkParamSet(i, msg->paramValue);
+        mavlinkParamValue(i);   // The value in force, after clamping
+        break;
+      }
+    }
+    break;
+  }
+
+  case MAVLINK_MSG_MISSION_REQUEST_LIST: {
+    const MavMissionRequestList *msg = (const MavMissionRequestList *)p;
+    if (!mavlinkForUs(msg->targetSystem, msg->targetComponent))
+      break;
+    uint8_t out[MAVLINK_MAX_FRAME];
+    MavMissionCount *count = (MavMissionCount *)MavLink_payload(out);
+    count->count = msg->missionType == MAV_MISSION_TYPE_MISSION
+                       ? WaypointManager::getInstance().getWaypointCount()
+                       : 0;
+    count->targetSystem = view.systemId;
+    count->targetComponent = view.componentId;
+    count->missionType = msg->missionType;
+    mavlinkSend(out, MAVLINK_MSG_MISSION_COUNT, sizeof(*count));
+    break;
+  }
+
+  case MAVLINK_MSG_MISSION_REQUEST_INT: {
+    const MavMissionRequestInt *msg = (const MavMissionRequestInt *)p;
+    if (mavlinkForUs(msg->targetSystem, msg->targetComponent))
+      mavlinkMissionItem(msg->seq, view, msg->missionType);
+    break;
+  }
+
+  case MAVLINK_MSG_MISSION_COUNT: {
+    const MavMissionCount *msg = (const MavMissionCount *)p;
+    if (mavlinkForUs(msg->targetSystem, msg->targetComponent) &&
+        RateLimitManager_check(NULL, RATE_CLASS_COMMAND) == RATE_LIMIT_ALLOWED)
+      mavlinkMissionCount(view);
+    break;
+  }
+
+  case MAVLINK_MSG_MISSION_ITEM_INT: {
+    const MavMissionItemInt *msg = (const MavMissionItemInt *)p;
+    if (mavlinkForUs(msg->targetSystem, msg->targetComponent) && mavlinkUpload.active &&
+        view.systemId == mavlinkUpload.peerSystem &&
+        view.componentId == mavlinkUpload.peerComponent)
+      mavlinkUploadStep(MavMissionUpload_item(&mavlinkUpload, msg, HAL_GetMillis()), view);
+    break;
+  }
+
+  case MAVLINK_MSG_MISSION_CLEAR_ALL: {
+    const MavMissionClearAll *msg = (const MavMissionClearAll *)p;
+    if (!mavlinkForUs(msg->targetSystem, msg->targetComponent) ||
+        RateLimitManager_check(NULL, RATE_CLASS_COMMAND) != RATE_LIMIT_ALLOWED)
+      break;
+    mavlinkUploadEnd();
+    mavlinkMissionAck(view,
+                      msg->missionType == MAV_MISSION_TYPE_MISSION
+                          ? mavlinkCommitMission(nullptr, 0)
+                          : MAV_MISSION_UNSUPPORTED,
+                      msg->missionType);
+    break;
+  }
+
+  case MAVLINK_MSG_MISSION_ACK: {
+    // The GCS giving up on an upload it started
+    const MavMissionAck *msg = (const MavMissionAck *)p;
+    if (mavlinkForUs(msg->targetSystem, msg->targetComponent) && mavlinkUpload.active &&
+        view.systemId == mavlinkUpload.peerSystem)
+      mavlinkUploadEnd();
+    break;
+  }
+
+  case MAVLINK_MSG_COMMAND_LONG: {
+    // No commands are mapped yet: say so rather than let the GCS retry
+    const MavCommandLong *msg = (const MavCommandLong *)p;
+    if (!mavlinkForUs(msg->targetSystem, msg->targetComponent) ||
+        RateLimitManager_check(NULL, RATE_CLASS_COMMAND) != RATE_LIMIT_ALLOWED)
+      break;
+    uint8_t out[MAVLINK_MAX_FRAME];
+    MavCommandAck *ack = (MavCommandAck *)MavLink_payload(out);
+    ack->command = msg->command;
+    ack->result = MAV_RESULT_UNSUPPORTED;
+    mavlinkSend(out, MAVLINK_MSG_COMMAND_ACK, sizeof(*ack));
+    break;
+  }
+
+  default:
+    break;
+  }
+}
+
+/**
+ * Mission upload request timeouts (comms task)
+ */
+void mavlinkPoll(uint32_t now) {
+  if (!mavlinkUpload.active)
+    return;
+  MavMissionStep step = MavMissionUpload_poll(&mavlinkUpload, now);
+  if (step == MAV_MISSION_STEP_NONE)
+    return;
+  MavLinkView peer = {};
+  peer.systemId = mavlinkUpload.peerSystem;
+  peer.componentId = mavlinkUpload.peerComponent;
+  mavlinkUploadStep(step, peer);
+}
+
+/**
+ * MAVLink stream (telemetry task): ATTITUDE at 10 Hz, GLOBAL_POSITION_INT
+ * at 5 Hz with a fix, HEARTBEAT / SYS_STATUS / MISSION_CURRENT at 1 Hz
+ */
+void mavlinkTelemetry(const TelemetrySnapshot &snap, uint32_t now) {
+  static uint8_t tick = 0;
+  static bool haveHomeAlt = false;
+  static int32_t homeAltMm = 0;   // First fix this boot: relative_alt zero
+  tick = (tick + 1) % MAVLINK_HEARTBEAT_TICKS;
+  uint8_t frame[MAVLINK_MAX_FRAME];
+
+  AttitudeMsg att;
+  if (tick % MAVLINK_ATTITUDE_TICKS == 0 && topicAttitude.read(att)) {
+    MavAttitude *msg = (MavAttitude *)MavLink_payload(frame);
+    msg->timeBootMs = now;
+    // The estimator works in the IMU frame (x forward, y left, z up);
+    // MAVLink wants forward-right-down: pitch and the y / z rates flip
+    msg->roll = att.roll;
+    msg->pitch = -att.pitch;
+    float yaw = att.heading * DEG_TO_RAD;
+    msg->yaw = yaw > PI ? yaw - 2.0f * PI : yaw;
+    msg->rollSpeed = att.rates[0];
+    msg->pitchSpeed = -att.rates[1];
+    msg->yawSpeed = -att.rates[2];
+    mavlinkSend(frame, MAVLINK_MSG_ATTITUDE, sizeof(*msg));
+  }
+
+  GPSFix fix;
+  if (tick % MAVLINK_POSITION_TICKS == 0 && (snap.status & TELEMETRY_STATUS_GPS_LOCK) &&
+      topicGps.read(fix)) {
+    if (!haveHomeAlt) {
+      homeAltMm = fix.altMsl;
+      haveHomeAlt = true;
+    }
+    MavGlobalPositionInt *msg = (MavGlobalPositionInt *)MavLink_payload(frame);
+    msg->timeBootMs = now;
+    msg->lat = fix.lat;
+    msg->lon = fix.lng;
+    msg->alt = fix.altMsl;
+    msg->relativeAlt = fix.altMsl - homeAltMm;
+    msg->vx = (int16_t)constrain(fix.velN / 10, INT16_MIN, INT16_MAX);
+    msg->vy = (int16_t)constrain(fix.velE / 10, INT16_MIN, INT16_MAX);
+    msg->vz = (int16_t)constrain(fix.velD / 10, INT16_MIN, INT16_MAX);
+    msg->hdg = (uint16_t)(fmodf(snap.heading + 360.0f, 360.0f) * 100.0f);
+    mavlinkSend(frame, MAVLINK_MSG_GLOBAL_POSITION_INT, sizeof(*msg));
+  }
+
+  if (tick != 0)
+    return;
+
+  bool armed = snap.failsafe == FAILSAFE_ARMED;
+  bool mission = snap.navFlags & TELEMETRY_NAV_MISSION_ACTIVE;
+  MavHeartbeat *hb = (MavHeartbeat *)MavLink_payload(frame);
+  memset(hb, 0, sizeof(*hb));
+  switch (formationVehicleType) {
+  case VEHICLE_PLANE: hb->type = MAV_TYPE_FIXED_WING; break;
+  case VEHICLE_SUB: hb->type = MAV_TYPE_SUBMARINE; break;
+  case VEHICLE_COPTER: hb->type = MAV_TYPE_QUADROTOR; break;
+  default: hb->type = MAV_TYPE_GROUND_ROVER; break;
+  }
+  hb->autopilot = MAV_AUTOPILOT_GENERIC;
+  hb->baseMode = MAV_MODE_FLAG_MANUAL_INPUT_ENABLED |
+                 (armed ? MAV_MODE_FLAG_SAFETY_ARMED : 0) |
+                 (mission ? MAV_MODE_FLAG_AUTO_ENABLED : 0);
+  hb->systemStatus = snap.failsafe >= FAILSAFE_SIGNAL_LOSS ? MAV_STATE_CRITICAL
+                     : armed                               ? MAV_STATE_ACTIVE
+                                                           : MAV_STATE_STANDBY;
+  hb->mavlinkVersion = 3;
+  mavlinkSend(frame, MAVLINK_MSG_HEARTBEAT, sizeof(*hb));
+
+  MavSysStatus *sys = (MavSysStatus *)MavLink_payload(frame);
+  memset(sys, 0, sizeof(*sys));
+  uint32_t sensors = MAV_SYS_STATUS_SENSOR_3D_GYRO | MAV_SYS_STATUS_SENSOR_3D_ACCEL;
+  if (gpsManager)
+    sensors |= MAV_SYS_STATUS_SENSOR_GPS;
+  sys->sensorsPresent = sensors;
+  sys->sensorsEnabled = sensors;
+  sys->sensorsHealth = (snap.status & TELEMETRY_STATUS_GPS_LOCK)
+                           ? sensors
+                           : sensors & ~MAV_SYS_STATUS_SENSOR_GPS;
+  sys->load = (uint16_t)(snap.cpuPct * 10.0f);
+  sys->voltageBattery = snap.batteryMv ? snap.batteryMv : UINT16_MAX;
+  sys->currentBattery = -1;
+  BatteryMsg battery;
+  sys->batteryRemaining = snap.batteryMv && topicBattery.read(battery) ? battery.percent : -1;
+  if (rssiManager)
+    sys->dropRateComm = rssiManager->getPacketLossPercent() * 100;
+  sys->errorsComm = (uint16_t)mavlinkStats.badFrames;
+  mavlinkSend(frame, MAVLINK_MSG_SYS_STATUS, sizeof(*sys));
+
+  MavMissionCurrent *current = (MavMissionCurrent *)MavLink_payload(frame);
+  current->seq = snap.wpIndex;
+  mavlinkSend(frame, MAVLINK_MSG_MISSION_CURRENT, sizeof(*current));
+}
+
+// ============================================================================
+// Serial Commands
+// ============================================================================
+
+CommandRouter commandRouter; // Comms task only
+// Where command replies go: the serial port, or the BLE reply buffer while
+// a line written over BLE runs (comms task only)
+Print *commandOut = &Serial;
+
+static void cmdSm(JsonDocument &doc) {
+  // Highest-rate command: one member lookup per axis
+  JsonVariantConst t = doc["t"], s = doc["s"], p = doc["p"], y = doc["y"];
+  if (!t.isNull())
+    serialPacket.throttle = t;
+  if (!s.isNull())
+    serialPacket.roll = s;
+  if (!p.isNull())
+    serialPacket.pitch = p;
+  if (!y.isNull())
+    serialPacket.yaw = y;
+  serialPacket.protocolVersion = PROTOCOL_VERSION;
+  serialPacket.encryptionFlag = 0;
+  serialPacket.sequenceNumber = ++packetSequence;
+  NA_UPDATE_PACKET_CHECKSUM(&serialPacket);
+  serialRxRing.push({serialPacket, HAL_Now()});
+  commandOut->println("{\"ok\":true}");
+}
+
+static void cmdPing(JsonDocument &doc) {
+  JsonDocument pongDoc(&commandArena);
+  pongDoc["ok"] = true;
+  pongDoc["uptime"] = HAL_GetMillis();
+  RateLimitStats stats = RateLimitManager_getStats();
+  pongDoc["rl_allowed"] = stats.totalCommandsAllowed;
+  pongDoc["rl_blocked"] = stats.totalCommandsBlocked;
+  pongDoc["rl_peer_blocked"] = stats.peerBlocked;
+  pongDoc["rl_class_blocked"] = stats.classBlocked;
+  pongDoc["rl_buckets"] = stats.bucketsUsed;
+  // Pre-crypto rejects per stage (RxFilter)
+  RxFilterStats rx = RxFilter_getStats();
+  JsonObject rxDoc = pongDoc["rx"].to<JsonObject>();
+  rxDoc["ok"] = rx.passed;
+  rxDoc["len"] = rx.rejected[RX_FILTER_LENGTH];
+  rxDoc["fmt"] = rx.rejected[RX_FILTER_FORMAT];
+  rxDoc["src"] = rx.rejected[RX_FILTER_SOURCE];
+  rxDoc["crc"] = rx.rejected[RX_FILTER_CHECKSUM];
+  rxDoc["seq"] = rx.rejected[RX_FILTER_SEQUENCE];
+  rxDoc["rate"] = rx.rejected[RX_FILTER_RATE];
+  // Crypto stage (rx verify worker): verified, failed, largest burst
+  // taken in one pass, frames lapped in the input rings before it ran
+  rxDoc["ver"] = rxVerifyFrames - rxVerifyForged;
+  rxDoc["auth"] = rxVerifyForged;
+  rxDoc["batch"] = rxVerifyMaxBatch;
+  rxDoc["lap"] = radioRxRing.getDroppedCount() + wsRxRing.getDroppedCount();
+  rxDoc["worker"] = rxVerifyTask != nullptr;
+  pongDoc["vehicle"] = vehicle->getName();
+  pongDoc["crypto"] = CryptoBackend_getName();
+  pongDoc["aes_cpb"] = CryptoBackend_getAesCyclesPerByte();
+  pongDoc["sha_cpb"] = CryptoBackend_getShaCyclesPerByte();
+  pongDoc["load0"] = LoopTiming_getCoreLoad(0);
+  pongDoc["load1"] = LoopTiming_getCoreLoad(1);
+  // JSON arenas: high-water mark vs cap, failed allocations (overflow)
+  JsonObject arenaDoc = pongDoc["json"].to<JsonObject>();
+  arenaDoc["cmd_hw"] = commandArena.highWater();
+  arenaDoc["cmd_cap"] = commandArena.capacity();
+  arenaDoc["fail"] = commandArena.failures();
+  // Binary protocol: advertise version, switch on request ("bin":0 = JSON)
+  if (!doc["bin"].isNull())
+    hostBinaryMode = (int)doc["bin"] == HOST_PROTOCOL_VERSION;
+  pongDoc["bin"] = HOST_PROTOCOL_VERSION;
+  pongDoc["bin_on"] = (bool)hostBinaryMode;
+  serializeJson(pongDoc, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetSecurityConfig(JsonDocument &doc) {
+  if (configManager) {
+    ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
+    JsonDocument res(&commandArena);
+    res["c"] = "get_security_config";
+    res["ok"] = true;
+    res["encryption_enabled"] = sec.encryptionEnabled;
+    res["hmac_enabled"] = sec.hmacEnabled;
+    res["rate_limit_enabled"] = sec.rateLimitEnabled;
+    res["rate_limit_cps"] = sec.rateLimitCPS;
+    SecureRandomStats rng = SecureRandom_getStats();
+    res["rng_draws"] = rng.requests;
+    res["rng_reseeds"] = rng.reseeds;
+    serializeJson(res, *commandOut);
+    commandOut->println();
+  }
+}
+
+static void cmdSetSecurityConfig(JsonDocument &doc) {
+  if (configManager) {
+    ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
+    if (!doc["encryption_enabled"].isNull())
+      sec.encryptionEnabled = doc["encryption_enabled"];
+    if (!doc["hmac_enabled"].isNull())
+      sec.hmacEnabled = doc["hmac_enabled"];
+    if (!doc["rate_limit_enabled"].isNull())
+      sec.rateLimitEnabled = doc["rate_limit_enabled"];
+    if (!doc["rate_limit_cps"].isNull())
+      sec.rateLimitCPS = doc["rate_limit_cps"];
+    if (!doc["shared_secret"].isNull()) {
+      const char *secret = doc["shared_secret"];
+      memset(sec.sharedSecret, 0, 32);
+      strncpy((char *)sec.sharedSecret, secret, 31);
+    }
+    configManager->setSecurityConfig(sec); // onSecurityChanged() applies it
+    commandOut->println("{\"ok\":true}");
+  }
+}
+
+// Parameter sync (ConfigSync.h): a section's hash is that of its JSON,
+// rendered on its own so the full config is never one document
+static uint32_t configSectionHashes(uint32_t *hashes) {
+  for (uint8_t i = 0; i < ConfigManager::SECTION_COUNT; i++) {
+    JsonDocument section(&commandArena);
+    configManager->exportSection((ConfigManager::Section)i, section.to<JsonObject>());
+    char text[CONFIG_SYNC_SECTION_MAX];
+    hashes[i] = ConfigSync_hash(text, serializeJson(section, text, sizeof(text)));
+  }
+  return ConfigSync_manifest(CONFIG_SCHEMA_VERSION, hashes, ConfigManager::SECTION_COUNT);
+}
+
+static void cmdCfgHash(JsonDocument &doc) {
+  if (!configManager)
+    return;
+  uint32_t hashes[ConfigManager::SECTION_COUNT];
+  uint32_t manifest = configSectionHashes(hashes);
+  JsonDocument res(&commandArena);
+  res["c"] = "cfg_hash";
+  res["v"] = CONFIG_SCHEMA_VERSION;
+  res["h"] = manifest;
+  JsonObject sections = res["s"].to<JsonObject>();
+  for (uint8_t i = 0; i < ConfigManager::SECTION_COUNT; i++)
+    sections[ConfigManager::sectionName((ConfigManager::Section)i)] = hashes[i];
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdCfgSync(JsonDocument &doc) {
+  // One line per section the configurator does not hold, then a summary
+  if (!configManager)
+    return;
+  uint32_t hashes[ConfigManager::SECTION_COUNT];
+  uint32_t manifest = configSectionHashes(hashes);
+  bool current = !doc["h"].isNull() && (uint32_t)doc["h"] == manifest;
+  JsonObjectConst have = doc["have"];
+  uint8_t sent = 0;
+  for (uint8_t i = 0; !current && i < ConfigManager::SECTION_COUNT; i++) {
+    ConfigManager::Section section = (ConfigManager::Section)i;
+    const char *name = ConfigManager::sectionName(section);
+    if (!have[name].isNull() && (uint32_t)have[name] == hashes[i])
+      continue;
+    JsonDocument line(&commandArena);
+    line["c"] = "cfg";
+    line["s"] = name;
+    line["h"] = hashes[i];
+    configManager->exportSection(section, line["d"].to<JsonObject>());
+    serializeJson(line, *commandOut);
+    commandOut->println();
+    sent++;
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "cfg_sync";
+  res["h"] = manifest;
+  res["sent"] = sent;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+#if FEATURE_OTA
+static void cmdStartOtaUpdate(JsonDocument &doc) {
+  const char *url = doc["url"];
+  const char *sha = doc["sha"]; // Optional, hex SHA-256 of the final image
+  const char *sig = doc["sig"]; // Optional, hex ECDSA r || s over it
+  uint8_t expected[32];
+  uint8_t signature[OTA_SIGNATURE_SIZE];
+  if (url && sha && !parseHexBytes(sha, expected, sizeof(expected))) {
+    commandOut->println("{\"ok\":false,\"msg\":\"Invalid sha\"}");
+  } else if (url && sig && !parseHexBytes(sig, signature, sizeof(signature))) {
+    commandOut->println("{\"ok\":false,\"msg\":\"Invalid sig\"}");
+  } else if (url) {
+    if (configManager)
+      configManager->flush(); // OTA ends in a reboot
+    // Runs in the background; poll get_ota_progress
+    bool ok = OTAUpdater_startSignedDownload(url, sha ? expected : NULL,
+                                             sig ? signature : NULL);
+    JsonDocument res(&commandArena);
+    res["ok"] = ok;
+    if (!ok)
+      res["msg"] = OTAUpdater_getErrorMessage();
+    serializeJson(res, *commandOut);
+    commandOut->println();
+  }
+}
+
+static void cmdCheckOta(JsonDocument &doc) {
+  // {"c":"check_ota","url":"https://.../manifest.json","install":true}:
+  // conditional manifest GET in the background; result in get_ota_stats
+  const char *url = doc["url"];
+  bool install = doc["install"] | false;
+  if (install && configManager)
+    configManager->flush(); // OTA ends in a reboot
+  JsonDocument res(&commandArena);
+  res["ok"] = OTAUpdater_startCheck(url, install);
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetOtaProgress(JsonDocument &doc) {
+  OTAProgress ota = OTAUpdater_getProgressInfo();
+  JsonDocument res(&commandArena);
+  res["status"] = (int)ota.status;
+  res["progress"] = ota.progress;
+  res["bytes"] = ota.bytesDownloaded;
+  res["total"] = ota.totalSize;
+  if (ota.resumedFrom)
+    res["resumed"] = ota.resumedFrom;
+  if (ota.status == OTA_STATUS_ERROR)
+    res["err"] = (int)ota.lastError;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetOtaKey(JsonDocument &doc) {
+  // Hex X || Y of the P-256 signing key, "" to accept unsigned images
+  const char *key = doc["key"];
+  uint8_t raw[OTA_SIGNATURE_KEY_SIZE];
+  bool ok = false;
+  if (key && key[0] == '\0')
+    ok = OTAUpdater_setSigningKey(NULL);
+  else if (parseHexBytes(key, raw, sizeof(raw)))
+    ok = OTAUpdater_setSigningKey(raw);
+  JsonDocument res(&commandArena);
+  res["ok"] = ok;
+  res["signed"] = OTAUpdater_hasSigningKey();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetOtaStats(JsonDocument &doc) {
+  OTAStats ota = OTAUpdater_getStats();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_ota_stats";
+  res["n"] = ota.totalAttempts;
+  res["ok"] = ota.successfulUpdates;
+  res["fail"] = ota.failedUpdates;
+  res["bps"] = ota.throughputBps;
+  res["stall_ms"] = ota.stallMs;
+  res["signed"] = OTAUpdater_hasSigningKey();
+  OTACheckInfo check = OTAUpdater_getCheckInfo();
+  JsonObject chk = res["check"].to<JsonObject>();
+  chk["n"] = check.checks;
+  chk["not_modified"] = check.notModified;
+  chk["bytes"] = check.manifestBytes;
+  if (check.checks) {
+    chk["http"] = check.httpCode;
+    chk["res"] = check.result;
+  }
+  if (check.latest[0]) {
+    chk["latest"] = check.latest;
+    chk["size"] = check.size;
+    chk["delta"] = check.delta;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdFleetOta(JsonDocument &doc) {
+  // {"send":true} serves the running image, {"listen":true} takes fleet
+  // images while parked; no keys reports the state
+  bool ok = true;
+  const char *msg = NULL;
+  if (doc["listen"].is<bool>() && !OTAUpdater_setFleetListen(doc["listen"].as<bool>())) {
+    ok = false;
+    msg = "Listen not saved";
+  }
+  if (ok && doc["send"].is<bool>()) {
+    if (!doc["send"].as<bool>())
+      OTAUpdater_stopFleetSend();
+    else if (!OTAUpdater_startFleetSend()) {
+      ok = false;
+      msg = OTAUpdater_getErrorMessage();
+    }
+  }
+  static const char *const ROLE_NAMES[3] = {"idle", "send", "receive"};
+  OTAFleetInfo fleet = OTAUpdater_getFleetInfo();
+  JsonDocument res(&commandArena);
+  res["c"] = "fleet_ota";
+  res["ok"] = ok;
+  if (msg)
+    res["msg"] = msg;
+  res["role"] = ROLE_NAMES[fleet.role];
+  res["listen"] = fleet.listening;
+  if (fleet.role != OTA_FLEET_IDLE) {
+    res["id"] = fleet.imageId;
+    res["chunks"] = fleet.chunks;
+    res["pending"] = fleet.pending;
+    res["round"] = fleet.round;
+    res["frames"] = fleet.frames;
+    res["nacks"] = fleet.nacks;
+    res["suppressed"] = fleet.suppressed;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+#endif
+
+static void cmdGetPerf(JsonDocument &doc) {
+  // Per-task loop timing: log2 histograms, bucket b = [2^(b-1), 2^b) us
+  JsonDocument res(&commandArena);
+  res["c"] = "get_perf";
+  JsonArray load = res["load"].to<JsonArray>();
+  for (uint8_t core = 0; core < LOOP_TIMING_CORES; core++)
+    load.add(LoopTiming_getCoreLoad(core));
+  JsonArray tasks = res["tasks"].to<JsonArray>();
+  for (uint8_t i = 0; i < TaskScheduler_getTaskCount(); i++) {
+    SchedulerTaskStats st;
+    LoopTimer timing;
+    if (!TaskScheduler_getStats(i, &st) || !TaskScheduler_getTiming(i, &timing))
+      continue;
+    JsonObject t = tasks.add<JsonObject>();
+    t["name"] = st.name;
+    t["core"] = st.core;
+    t["n"] = timing.count;
+    t["over"] = st.overrunCount;
+    t["p_max"] = timing.maxPeriodUs;
+    t["e_max"] = timing.maxExecUs;
+    t["j_max"] = timing.maxJitterUs;
+    JsonArray p = t["p"].to<JsonArray>();
+    JsonArray e = t["e"].to<JsonArray>();
+    JsonArray j = t["j"].to<JsonArray>();
+    for (uint8_t b = 0; b < LOOP_HIST_BUCKETS; b++) {
+      p.add(timing.periodHist[b]);
+      e.add(timing.execHist[b]);
+      j.add(timing.jitterHist[b]);
+    }
+  }
+  LogStats logStats = Log_getStats();
+  JsonObject logQueue = res["log"].to<JsonObject>();
+  logQueue["queued"] = logStats.queued;
+  logQueue["dropped"] = logStats.dropped;
+  logQueue["cut"] = logStats.truncated + logStats.oversize;
+  logQueue["high"] = logStats.highWater;
+  // Control task loops (RateProfile): rates, outer runs held back /
+  // forced, deadline misses and worst tick by kind
+  RateSchedule sched = rateSchedule;
+  JsonObject rates = res["rates"].to<JsonObject>();
+  if (sched.innerPeriodUs) {
+    rates["inner_hz"] = 1000 / sched.profile.innerPeriodMs;
+    rates["outer_hz"] = 1000 / (sched.profile.innerPeriodMs * sched.profile.outerDiv);
+  }
+  rates["ticks"] = sched.ticks;
+  rates["outer"] = sched.outerRuns;
+  rates["defer"] = sched.outerDeferred;
+  rates["forced"] = sched.outerForced;
+  rates["miss_in"] = sched.innerMisses;
+  rates["miss_out"] = sched.outerMisses;
+  rates["max_in"] = sched.maxInnerUs;
+  rates["max_out"] = sched.maxOuterUs;
+  if (doc["reset"] | false) {
+    TaskScheduler_resetStats();
+    rateStatsResetRequest = true;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetProf(JsonDocument &doc) {
+  // Scope timings (PROFILE_SCOPE), microseconds
+  JsonDocument res(&commandArena);
+  res["c"] = "get_prof";
+  JsonArray tasks = res["tasks"].to<JsonArray>();
+  for (uint8_t i = 0; i < MemoryProfiler_getTaskCount(); i++) {
+    const TaskTimingInfo *t = MemoryProfiler_getTaskTiming(i);
+    JsonObject o = tasks.add<JsonObject>();
+    o["name"] = t->taskName;
+    o["n"] = t->callCount;
+    o["min"] = t->minExecutionTimeUs;
+    o["max"] = t->maxExecutionTimeUs;
+    o["mean"] = t->meanExecutionTimeUs;
+    o["ewma"] = t->ewmaExecutionTimeUs;
+  }
+  MemPlacementStats place = MemPlacement_getStats();
+  JsonObject mem = res["place"].to<JsonObject>();
+  mem["internal"] = place.internalBytes;
+  mem["psram"] = place.psramBytes;
+  mem["fallback"] = place.fallbacks;
+  mem["fail"] = place.failures;
+  MemPlacementEntry entries[MEM_PLACEMENT_MAX_ENTRIES];
+  uint8_t placed = MemPlacement_getEntries(entries, MEM_PLACEMENT_MAX_ENTRIES);
+  JsonArray buffers = mem["buf"].to<JsonArray>();
+  for (uint8_t i = 0; i < placed; i++) {
+    JsonObject o = buffers.add<JsonObject>();
+    o["tag"] = entries[i].tag;
+    o["bytes"] = entries[i].size;
+    o["at"] = MemPlacement_regionName((MemRegion)entries[i].region);
+  }
+  if (doc["reset"] | false)
+    MemoryProfiler_reset();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetTasks(JsonDocument &doc) {
+  // All FreeRTOS tasks: "hwm" = stack never used (bytes), "size" = 0 if
+  // the creator did not register it, "core" = -1 if unpinned
+  uint8_t count = MemoryProfiler_scanTasks();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_tasks";
+  JsonArray arr = res["tasks"].to<JsonArray>();
+  for (uint8_t i = 0; i < count; i++) {
+    const TaskStackInfo *t = MemoryProfiler_getSystemTask(i);
+    JsonObject o = arr.add<JsonObject>();
+    o["name"] = t->name;
+    o["core"] = t->core == PROFILE_CORE_ANY ? -1 : t->core;
+    o["prio"] = t->priority;
+    o["size"] = t->stackSize;
+    o["hwm"] = t->stackHighWater;
+    o["run"] = t->runTime;
+    o["cpu"] = t->cpuPercent;
+  }
+  MemoryStats mem = MemoryProfiler_getMemoryStats();
+  res["stack_used"] = mem.stackUsed;
+  res["stack_free"] = mem.stackFree;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void addJobStats(JsonObject out, const JobExecutor &ex) {
+  out["passes"] = ex.passes;
+  out["busy"] = ex.busyPasses;
+  JsonArray arr = out["jobs"].to<JsonArray>();
+  for (uint8_t i = 0; i < ex.count; i++) {
+    const Job *job = &ex.jobs[i];
+    JsonObject o = arr.add<JsonObject>();
+    o["name"] = job->name;
+    o["period"] = job->periodMs;
+    o["budget"] = job->budgetUs;
+    o["runs"] = job->runs;
+    o["over"] = job->overruns;
+    o["defer"] = job->deferrals;
+    o["forced"] = job->forced;
+    o["max_us"] = job->maxUs;
+    o["late"] = job->maxLateMs;
+  }
+}
+
+static void cmdGetJobs(JsonDocument &doc) {
+  // Background jobs per task: "budget" / "max_us" in us, "late" = worst
+  // start past due (ms), "busy" = passes held back by the control loop
+  JsonDocument res(&commandArena);
+  res["c"] = "get_jobs";
+  addJobStats(res["comms"].to<JsonObject>(), commsJobs);
+  addJobStats(res["telemetry"].to<JsonObject>(), telemetryJobs);
+  serializeJson(res, *commandOut);
+  commandOut->println();
+  // Counters only: a reset racing the telemetry task loses at most a count
+  if (doc["reset"] | false) {
+    JobExecutor_resetStats(&commsJobs);
+    JobExecutor_resetStats(&telemetryJobs);
+  }
+}
+
+static void cmdGetWatchdog(JsonDocument &doc) {
+  // "gap" = worst check-in gap since boot (ms); "last" = previous reset,
+  // present only if it was a watchdog reset
+  JsonDocument res(&commandArena);
+  res["c"] = "get_watchdog";
+  JsonArray arr = res["tasks"].to<JsonArray>();
+  for (uint8_t i = 0; i < watchdog.count; i++) {
+    const WatchdogSlot *s = &watchdog.slots[i];
+    JsonObject o = arr.add<JsonObject>();
+    o["name"] = s->name;
+    o["deadline"] = s->deadlineMs;
+    o["gap"] = s->maxGapMs;
+    o["armed"] = s->armed;
+  }
+  WatchdogPostMortem pm;
+  if (Watchdog_getPostMortem(&pm)) {
+    JsonObject last = res["last"].to<JsonObject>();
+    last["task"] = pm.task;
+    last["cause"] = pm.cause;
+    last["late"] = pm.lateMs;
+    last["deadline"] = pm.deadlineMs;
+    last["uptime"] = pm.uptimeMs;
+    last["resets"] = pm.resetCount;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetBoot(JsonDocument &doc) {
+  // Stage start / length in ms since app start (the ROM and bootloader
+  // before it are not counted); "ctrl" = first accepted control frame
+  static const char *const STATE_NAMES[] = {"pending", "running", "ok", "failed", "skipped"};
+  BootSequence boot;
+  BootSequence_snapshot(&bootSequence, &boot);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_boot";
+  res["reset"] = (int)esp_reset_reason();
+  res["main"] = BootSequence_laneEndUs(&boot, BOOT_LANE_MAIN) / 1000.0f;
+  res["bg"] = BootSequence_laneEndUs(&boot, BOOT_LANE_BACKGROUND) / 1000.0f;
+  res["ctrl"] = bootFirstControlUs / 1000.0f;
+  JsonArray arr = res["stages"].to<JsonArray>();
+  for (uint8_t i = 0; i < boot.count; i++) {
+    JsonObject o = arr.add<JsonObject>();
+    o["n"] = boot.stages[i].name;
+    o["lane"] = boot.stages[i].lane;
+    o["st"] = STATE_NAMES[boot.state[i]];
+    o["at"] = boot.startUs[i] / 1000.0f;
+    o["ms"] = boot.durationUs[i] / 1000.0f;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetAlloc(JsonDocument &doc) {
+  // Heap allocation accounting (env:esp32dev_alloc); "la" should stay 0
+  AllocStats al = MemoryProfiler_getAllocStats();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_alloc";
+  res["on"] = al.tracking;
+  res["n"] = al.allocCount;
+  res["free"] = al.freeCount;
+  res["bytes"] = al.allocBytes;
+  res["fail"] = al.failedCount;
+  res["sites"] = al.siteCount;
+  res["untracked"] = al.untrackedCount;
+  res["la"] = al.lastLoopAllocs;
+  res["la_max"] = al.maxLoopAllocs;
+  res["la_loops"] = al.loopsWithAllocs;
+  AllocSite top[ALLOC_TOP_SITES];
+  uint8_t count = MemoryProfiler_getTopAllocSites(top, ALLOC_TOP_SITES);
+  JsonArray arr = res["top"].to<JsonArray>();
+  for (uint8_t i = 0; i < count; i++) {
+    char pc[11];
+    snprintf(pc, sizeof(pc), "0x%08lx", (unsigned long)top[i].caller);
+    JsonObject o = arr.add<JsonObject>();
+    o["pc"] = pc; // addr2line -e firmware.elf
+    o["task"] = top[i].task;
+    o["n"] = top[i].count;
+    o["bytes"] = top[i].bytes;
+  }
+  if (doc["reset"] | false)
+    MemoryProfiler_reset();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdTraceDump(JsonDocument &doc) {
+  // Trace rings: a header line, base64 record chunks per core, an end
+  // line. Recording pauses while the rings are read
+  static TraceRecord chunk[TRACE_DUMP_CHUNK];
+  static char b64[((sizeof(chunk) + 2) / 3) * 4 + 1];
+  Trace_setEnabled(false);
+
+  JsonDocument res(&commandArena);
+  res["c"] = "trace";
+  res["mhz"] = Trace_getCyclesPerUs();
+  JsonArray cores = res["cores"].to<JsonArray>();
+  for (uint8_t core = 0; core < TRACE_CORES; core++) {
+    TraceCoreInfo info;
+    Trace_getCoreInfo(core, &info);
+    JsonObject o = cores.add<JsonObject>();
+    o["n"] = info.written;
+    o["avail"] = info.available;
+    o["sync_cyc"] = info.syncCycles;
+    o["sync_us"] = info.syncUs;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+
+  for (uint8_t core = 0; core < TRACE_CORES; core++) {
+    uint32_t offset = 0;
+    uint32_t n;
+    for (uint16_t seq = 0;
+         (n = Trace_read(core, offset, chunk, TRACE_DUMP_CHUNK)) > 0; seq++) {
+      size_t b64Len = 0;
+      mbedtls_base64_encode((unsigned char *)b64, sizeof(b64), &b64Len,
+                            (const unsigned char *)chunk, n * sizeof(TraceRecord));
+      b64[b64Len] = '\0';
+      commandOut->printf("{\"c\":\"trace\",\"core\":%u,\"seq\":%u,\"d\":\"%s\"}\n",
+                    core, seq, b64);
+      offset += n;
+    }
+  }
+  commandOut->println("{\"c\":\"trace\",\"end\":true}");
+  Trace_setEnabled(true);
+}
+
+#if FEATURE_WEB
+static void cmdGetWsStats(JsonDocument &doc) {
+  WSClientStats wsStats[WS_MAX_CLIENTS];
+  uint8_t n = TelemetryWebSocket::getInstance().getClientStats(wsStats, WS_MAX_CLIENTS);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_ws_stats";
+  JsonArray clients = res["clients"].to<JsonArray>();
+  for (uint8_t i = 0; i < n; i++) {
+    JsonObject c = clients.add<JsonObject>();
+    c["id"] = wsStats[i].id;
+    c["bin"] = wsStats[i].format == WS_FORMAT_BINARY;
+    c["f"] = wsStats[i].fields;
+    c["div"] = wsStats[i].divisor;
+    c["sent"] = wsStats[i].sent;
+    c["drop"] = wsStats[i].dropped;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+#endif
+
+static void cmdSetTxRoute(JsonDocument &doc) {
+  // {"c":"set_tx_route","uni":true,"rate":24} - rate in Mbps (1, 2, 6, 24, 54),
+  // or "mcs":0-7 for an 802.11n rate. Applied now on the fast PHY, else
+  // when the link leaves long range
+  if (!doc["uni"].isNull())
+    telemetryUnicastEnabled = doc["uni"];
+  uint8_t pairedMac[6];
+  bool paired = readPairedMac(pairedMac);
+  setTelemetryRoute(paired ? pairedMac : nullptr);
+
+  bool rateOk = true;
+  if (!doc["rate"].isNull() || !doc["mcs"].isNull()) {
+    int mbps = doc["rate"];
+    wifi_phy_rate_t rate = WIFI_PHY_RATE_1M_L;
+    if (mbps == 2) rate = WIFI_PHY_RATE_2M_L;
+    else if (mbps == 6) rate = WIFI_PHY_RATE_6M;
+    else if (mbps == 24) rate = WIFI_PHY_RATE_24M;
+    else if (mbps == 54) rate = WIFI_PHY_RATE_54M;
+    if (!doc["mcs"].isNull())
+      rate = (wifi_phy_rate_t)(WIFI_PHY_RATE_MCS0_LGI + constrain(doc["mcs"].as<int>(), 0, 7));
+    portENTER_CRITICAL(&linkRateMux);
+    espnowFastRate = rate;
+    bool onFastPhy = linkRate.phy == LINK_PHY_FAST;
+    portEXIT_CRITICAL(&linkRateMux);
+    if (onFastPhy)
+      rateOk = EspNowTx_setPhyRate(rate);
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "set_tx_route";
+  res["ok"] = rateOk;
+  res["uni"] = telemetryUnicastEnabled && paired;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetCcmp(JsonDocument &doc) {
+  // {"c":"set_ccmp","on":true} - ESP-NOW link-layer encryption for keyed
+  // peers. On: sessions installed from now on (handshake / resume) get a
+  // CCMP key; the controller must run the same mode. Off: dropped at once.
+  bool on = doc["on"] | espnowCcmp;
+  espnowCcmp = on;
+  if (!on)
+    expireLinkCiphers(true, 0);
+  bool ok = ConfigManager::saveBlob(ESPNOW_CCMP_CONFIG_KEY, &on, sizeof(on));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_ccmp";
+  res["ok"] = ok;
+  res["on"] = on;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+/**
+ * Wi-Fi TX power and sleep; while BLE is up Wi-Fi keeps modem sleep
+ * whatever lowlat says (the radio is time-shared), lowlat stays stored
+ */
+static bool applyWifiPower(const WifiLinkConfig &config) {
+  WifiLinkConfig power = config;
+#if FEATURE_BLE
+  if (BleService::getInstance().isStarted())
+    power.lowLatency = 0;
+#endif
+  return WifiLink_applyPower(&power);
+}
+
+static void cmdSetWifi(JsonDocument &doc) {
+  // {"c":"set_wifi","mode":"ap","ch":6,"ssid":"..","pass":"..","tx":19.5,"lowlat":true}
+  // mode / ch / ssid / pass are stored and applied on the next boot,
+  // tx (dBm) and lowlat at once
+  WifiLinkConfig next = wifiConfig;
+  WifiLinkMode mode;
+  bool modeOk =
+      doc["mode"].isNull() || WifiLink_parseMode(doc["mode"].as<const char *>(), &mode);
+  if (modeOk && !doc["mode"].isNull())
+    next.mode = mode;
+  next.channel = doc["ch"] | next.channel;
+  if (!doc["ssid"].isNull())
+    strlcpy(next.ssid, doc["ssid"] | "", sizeof(next.ssid));
+  if (!doc["pass"].isNull())
+    strlcpy(next.pass, doc["pass"] | "", sizeof(next.pass));
+  if (!doc["tx"].isNull())
+    next.txPower = (uint8_t)constrain((int)(doc["tx"].as<float>() * 4.0f + 0.5f), 0, 255);
+  if (!doc["lowlat"].isNull())
+    next.lowLatency = doc["lowlat"].as<bool>();
+  if (!modeOk || !WifiLink_sanitize(&next)) {
+    commandOut->println("{\"ok\":false,\"err\":\"AP needs an 8+ char pass, STA an ssid\"}");
+  } else {
+    bool reboot = next.mode != wifiConfig.mode || next.channel != wifiConfig.channel ||
+                  strcmp(next.ssid, wifiConfig.ssid) != 0 ||
+                  strcmp(next.pass, wifiConfig.pass) != 0;
+    bool ok = ConfigManager::saveBlob(WIFI_LINK_CONFIG_KEY, &next, sizeof(next));
+    ok &= applyWifiPower(next);
+    wifiConfig = next;
+    JsonDocument res(&commandArena);
+    res["c"] = "set_wifi";
+    res["ok"] = ok;
+    res["reboot"] = reboot;
+    serializeJson(res, *commandOut);
+    commandOut->println();
+  }
+}
+
+static void cmdGetWifi(JsonDocument &doc) {
+  WifiLinkStatus st = WifiLink_getStatus();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_wifi";
+  res["mode"] = WifiLink_modeName(st.mode);
+  res["ch"] = st.channel;
+  res["cfg_ch"] = wifiConfig.channel;
+  res["ssid"] = wifiConfig.ssid;
+  res["tx"] = wifiConfig.txPower * 0.25f;
+  res["lowlat"] = wifiConfig.lowLatency != 0;
+  res["conn"] = st.connected;
+  res["clients"] = st.clients;
+  res["rssi"] = st.rssi;
+  char ip[16];
+  snprintf(ip, sizeof(ip), "%u.%u.%u.%u", (unsigned)(st.ip & 0xFF),
+           (unsigned)((st.ip >> 8) & 0xFF), (unsigned)((st.ip >> 16) & 0xFF),
+           (unsigned)(st.ip >> 24));
+  res["ip"] = ip;
+  res["retry"] = st.reconnects;
+  res["ch_fix"] = st.channelFixes;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+#if FEATURE_BLE
+/**
+ * Bring up the BLE phone link (Wi-Fi drops to modem sleep first)
+ */
+static bool startBle() {
+  WifiLinkConfig power = wifiConfig;
+  power.lowLatency = 0;
+  WifiLink_applyPower(&power);
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  char name[16];
+  snprintf(name, sizeof(name), "NA-%02X%02X%02X", mac[3], mac[4], mac[5]);
+  return BleService::getInstance().begin(name);
+}
+
+static void cmdSetBle(JsonDocument &doc) {
+  // {"c":"set_ble","on":true}: BLE telemetry / command link for a phone;
+  // stored, on starts at once, off takes a reboot (the controller's
+  // memory is not given back)
+  bool next = doc["on"] | bleEnabled;
+  bool ok = true;
+  if (next != bleEnabled) {
+    uint8_t stored = next;
+    ok = ConfigManager::saveBlob(BLE_CONFIG_KEY, &stored, sizeof(stored));
+    bleEnabled = next;
+  }
+  if (bleEnabled)
+    ok &= startBle();
+  JsonDocument res(&commandArena);
+  res["c"] = "set_ble";
+  res["ok"] = ok;
+  res["on"] = bleEnabled;
+  res["reboot"] = !bleEnabled && BleService::getInstance().isStarted();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetBle(JsonDocument &doc) {
+  BleStats st = BleService::getInstance().getStats();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_ble";
+  res["on"] = bleEnabled;
+  res["up"] = st.started;
+  res["conn"] = st.connected;
+  res["mtu"] = st.mtu;
+  res["n_conn"] = st.connections;
+  res["batches"] = st.batches;                  // Telemetry notifications
+  res["frames"] = st.frames;                    // Telemetry frames in them
+  res["cmds"] = st.commands;
+  res["cmd_drop"] = st.commandsDropped;
+  res["replies"] = st.replies;
+  res["too_long"] = st.repliesTruncated;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+#endif
+
+static void cmdGetTxStats(JsonDocument &doc) {
+  EspNowTxStats txStats[ESPNOW_TX_MAX_PEERS];
+  uint8_t n = EspNowTx_getAllStats(txStats, ESPNOW_TX_MAX_PEERS);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_tx_stats";
+  JsonArray peers = res["peers"].to<JsonArray>();
+  for (uint8_t i = 0; i < n; i++) {
+    char mac[18];
+    snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X",
+             txStats[i].mac[0], txStats[i].mac[1], txStats[i].mac[2],
+             txStats[i].mac[3], txStats[i].mac[4], txStats[i].mac[5]);
+    JsonObject p = peers.add<JsonObject>();
+    p["mac"] = mac;
+    p["sent"] = txStats[i].sent;
+    p["ok"] = txStats[i].delivered;
+    p["fail"] = txStats[i].failed;
+    p["tmo"] = txStats[i].timeouts;
+    p["coal"] = txStats[i].coalesced;
+    p["lat_us"] = txStats[i].avgLatencyUs;
+    p["max_us"] = txStats[i].maxLatencyUs;
+    p["ivl"] = txStats[i].intervalMs;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetLink(JsonDocument &doc) {
+  JsonDocument res(&commandArena);
+  res["c"] = "get_link";
+  if (rssiManager) {
+    LinkStats link = rssiManager->getLinkStats();
+    res["rssi"] = rssiManager->getRSSI_dBm();
+    res["avg"] = rssiManager->getAverageRSSI_dBm();
+    res["loss"] = rssiManager->getPacketLossPercent();
+    res["q"] = rssiManager->getLinkQuality();
+    res["sig"] = rssiManager->getSignalQuality();
+    res["rx"] = link.received;
+    res["lost"] = link.lost;
+    res["dup"] = link.duplicates;
+    res["late"] = link.late;
+    res["resync"] = link.resyncs;
+  }
+  portENTER_CRITICAL(&linkRateMux);
+  LinkRate rate = linkRate;
+  portEXIT_CRITICAL(&linkRateMux);
+  LinkTierRates rates = LinkRate_rates(rate.tier);
+  res["tier"] = LinkRate_tierName(rate.tier);
+  res["ctl_hz"] = rates.controlHz;
+  res["tel_hz"] = rates.telemetryHz;
+  res["agreed"] = LinkRate_tierName(rate.agreed);
+  res["grade"] = (int)rate.grade; // 0 bad, 1 fair, 2 good
+  res["nego"] = rate.negotiating;
+  res["pend"] = rate.pending;
+  res["prop"] = rate.proposals;
+  res["acks"] = rate.acks;
+  res["noack"] = rate.unanswered;
+  res["phy"] = LinkRate_phyName(rate.phy);
+  res["phy_agreed"] = LinkRate_phyName(rate.agreedPhy);
+  res["lr_local"] = rate.localLr;
+  res["lr_peer"] = rate.peerLr;
+  res["phy_sw"] = rate.phySwitches;
+  uint8_t ccmpPeers = 0;
+  portENTER_CRITICAL(&peerMux);
+  uint32_t compactRx = compactFrames;
+  uint32_t compactResync = compactUnsynced;
+  for (int i = 0; i < PEER_SESSION_MAX; i++)
+    ccmpPeers += peerSessions.peers[i].linkCipher;
+  portEXIT_CRITICAL(&peerMux);
+  res["compact_local"] = rate.localCompact;
+  res["compact_peer"] = rate.peerCompact;
+  res["compact_rx"] = compactRx;
+  res["compact_resync"] = compactResync;
+  res["ccmp"] = espnowCcmp;
+  res["ccmp_peers"] = ccmpPeers;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetMavlink(JsonDocument &doc) {
+  JsonDocument res(&commandArena);
+  res["c"] = "get_mavlink";
+  res["active"] = mavlinkActive(HAL_GetMillis());
+  res["sys"] = MAVLINK_SYSTEM_ID;
+  res["rx"] = mavlinkStats.received;
+  res["bad"] = mavlinkStats.badFrames;
+  res["unknown"] = mavlinkStats.unknown;
+  res["signed"] = mavlinkStats.signedFrames;
+  res["tx"] = mavlinkStats.sent;
+  res["drop"] = mavlinkStats.dropped;
+  res["missions"] = mavlinkStats.missionsIn;
+  if (mavlinkUpload.active) {
+    res["up_next"] = mavlinkUpload.next;
+    res["up_count"] = mavlinkUpload.count;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+/**
+ * {"attitude":20,"perf":1} into a per-stream array
+ * @return false on an unknown stream name
+ */
+static bool streamValuesFromJson(JsonObjectConst obj, uint8_t values[TELEMETRY_STREAM_COUNT]) {
+  for (JsonPairConst kv : obj) {
+    TelemetryStreamId id = TelemetryStreams_parse(kv.key().c_str());
+    if (id == TELEMETRY_STREAM_COUNT)
+      return false;
+    values[id] = kv.value() | values[id];
+  }
+  return true;
+}
+
+// Stream rates and the telemetry switch to the RC reader task (boot,
+// set_streams, set_rc)
+static void applyRcTelemetry() {
+  if (!rcReceiver)
+    return;
+  portENTER_CRITICAL(&streamsMux);
+  TelemetryStreamsConfig streams = streamsConfig;
+  portEXIT_CRITICAL(&streamsMux);
+  portENTER_CRITICAL(&rcMux);
+  bool on = rcConfig.telemetry && RC_TELEMETRY_PIN >= 0;
+  portEXIT_CRITICAL(&rcMux);
+  rcReceiver->setTelemetryConfig(streams, on);
+}
+
+static void cmdSetStreams(JsonDocument &doc) {
+  // {"c":"set_streams","on":true,"radio":48,"hz":{"attitude":20},"prio":{"perf":2}}
+  // Picked up on the next telemetry tick and stored
+  portENTER_CRITICAL(&streamsMux);
+  TelemetryStreamsConfig next = streamsConfig;
+  portEXIT_CRITICAL(&streamsMux);
+  next.enabled = doc["on"] | next.enabled;
+  next.radioBudget = doc["radio"] | next.radioBudget;
+  next.serialBudget = doc["serial"] | next.serialBudget;
+  if (!streamValuesFromJson(doc["hz"], next.hz) ||
+      !streamValuesFromJson(doc["prio"], next.priority)) {
+    commandOut->println("{\"ok\":false,\"err\":\"stream: attitude, position, nav, battery, depth or perf\"}");
+    return;
+  }
+  TelemetryStreams_sanitize(&next);
+  portENTER_CRITICAL(&streamsMux);
+  streamsConfig = next;
+  portEXIT_CRITICAL(&streamsMux);
+  applyRcTelemetry();
+  bool ok = ConfigManager::saveBlob(TELEMETRY_STREAMS_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_streams";
+  res["ok"] = ok;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetStreams(JsonDocument &doc) {
+  portENTER_CRITICAL(&streamsMux);
+  TelemetryStreamsConfig config = streamsConfig;
+  TelemetryStreams radio = radioStreams;
+  TelemetryStreams host = hostStreams;
+  portEXIT_CRITICAL(&streamsMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_streams";
+  res["on"] = config.enabled;
+  res["radio"] = config.radioBudget;
+  res["serial"] = config.serialBudget;
+  // Per stream: rate, priority, records sent / deferred on each link
+  JsonObject streams = res["s"].to<JsonObject>();
+  for (int i = 0; i < TELEMETRY_STREAM_COUNT; i++) {
+    JsonObject o = streams[TelemetryStreams_name((TelemetryStreamId)i)].to<JsonObject>();
+    o["hz"] = config.hz[i];
+    o["prio"] = config.priority[i];
+    o["tx"] = radio.sent[i];
+    o["defer"] = radio.deferred[i];
+    o["host"] = host.sent[i];
+  }
+  res["frames"] = radio.frames;
+  res["bytes"] = radio.bytes;
+  res["ev_drop"] = radio.eventsDropped;
+  res["host_frames"] = host.frames;
+  res["host_bytes"] = host.bytes;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetTrend(JsonDocument &doc) {
+  // {"c":"set_trend","on":true,"win":10000}
+  portENTER_CRITICAL(&trendMux);
+  TelemetryTrendConfig next = trendConfig;
+  portEXIT_CRITICAL(&trendMux);
+  next.enabled = doc["on"] | next.enabled;
+  next.windowMs = doc["win"] | next.windowMs;
+  TelemetryTrend_sanitize(&next);
+  portENTER_CRITICAL(&trendMux);
+  trendConfig = next;
+  portEXIT_CRITICAL(&trendMux);
+  bool ok = ConfigManager::saveBlob(TELEMETRY_TREND_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_trend";
+  res["ok"] = ok;
+  res["win"] = next.windowMs;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetTrend(JsonDocument &doc) {
+  portENTER_CRITICAL(&trendMux);
+  TelemetryTrendConfig config = trendConfig;
+  TelemetryTrendWindow last = lastTrend;
+  uint32_t windows = trendWindows;
+  portEXIT_CRITICAL(&trendMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_trend";
+  res["on"] = config.enabled;
+  res["win"] = config.windowMs;
+  res["windows"] = windows;
+  // Last closed window: [min, max, mean] per metric it had a source for
+  if (windows > 0) {
+    JsonObject w = res["last"].to<JsonObject>();
+    w["u"] = last.start;
+    w["n"] = last.samples;
+    for (int i = 0; i < TELEMETRY_TREND_COUNT; i++) {
+      if (!(last.present & (1 << i)))
+        continue;
+      JsonArray a = w[TelemetryTrend_name((TelemetryTrendMetric)i)].to<JsonArray>();
+      a.add(last.stat[i].min);
+      a.add(last.stat[i].max);
+      a.add(last.stat[i].mean);
+    }
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetReplay(JsonDocument &doc) {
+  // Paired controller's window (or the most recent sender while unpaired)
+  ReplayStats replay = {};
+  uint32_t highest = 0;
+  portENTER_CRITICAL(&peerMux);
+  int slot = haveLinkPeer ? PeerSessionTable_find(&peerSessions, linkPeer)
+                          : PEER_SESSION_NONE;
+  for (int i = 0; !haveLinkPeer && i < PEER_SESSION_MAX; i++) {
+    if (peerSessions.peers[i].used &&
+        (slot == PEER_SESSION_NONE ||
+         peerSessions.peers[i].lastUsed > peerSessions.peers[slot].lastUsed))
+      slot = i;
+  }
+  if (slot != PEER_SESSION_NONE) {
+    replay = peerSessions.peers[slot].replay.stats;
+    highest = peerSessions.peers[slot].replay.highest;
+  }
+  portEXIT_CRITICAL(&peerMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_replay";
+  res["seq"] = highest;
+  res["ok"] = replay.accepted;
+  res["lost"] = replay.lost;
+  res["reord"] = replay.reordered;
+  res["dup"] = replay.duplicates;
+  res["old"] = replay.tooOld;
+  res["resync"] = replay.resyncs;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetPeers(JsonDocument &doc) {
+  // Radio session table: {"c":"get_peers","peers":[{"mac":..,"link":..}],..}
+  struct {
+    uint8_t mac[6];
+    bool link, keyed, hkdf;
+    uint32_t epoch, installs, seq, accepted;
+  } rows[PEER_SESSION_MAX];
+  uint8_t count = 0;
+  portENTER_CRITICAL(&peerMux);
+  for (int i = 0; i < PEER_SESSION_MAX; i++) {
+    const PeerSession *p = &peerSessions.peers[i];
+    if (!p->used)
+      continue;
+    memcpy(rows[count].mac, p->mac, 6);
+    rows[count].link = p->pinned;
+    rows[count].keyed = p->keyed;
+    rows[count].hkdf = p->keys.valid;
+    rows[count].epoch = p->keys.epoch;
+    rows[count].installs = p->installs;
+    rows[count].seq = p->replay.highest;
+    rows[count].accepted = p->replay.stats.accepted;
+    count++;
+  }
+  uint32_t evictions = peerSessions.evictions;
+  uint32_t rejected = peerSessions.rejected;
+  portEXIT_CRITICAL(&peerMux);
+
+  JsonDocument res(&commandArena);
+  res["c"] = "get_peers";
+  res["evict"] = evictions;
+  res["full"] = rejected;
+  JsonArray peers = res["peers"].to<JsonArray>();
+  for (uint8_t i = 0; i < count; i++) {
+    char macStr[18];
+    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", rows[i].mac[0],
+             rows[i].mac[1], rows[i].mac[2], rows[i].mac[3], rows[i].mac[4],
+             rows[i].mac[5]);
+    JsonObject p = peers.add<JsonObject>();
+    p["mac"] = macStr;
+    p["link"] = rows[i].link;
+    p["keyed"] = rows[i].keyed;
+    p["hkdf"] = rows[i].hkdf;
+    p["epoch"] = rows[i].epoch;
+    p["kx"] = rows[i].installs;
+    p["seq"] = rows[i].seq;
+    p["ok"] = rows[i].accepted;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetFormation(JsonDocument &doc) {
+  // {"c":"set_formation","on":true,"group":1,"hz":5,"budget":2000}
+  // budget = air bytes/s for every beacon in range (0 = rate only)
+  portENTER_CRITICAL(&formationMux);
+  if (!doc["on"].isNull())
+    formationConfig.enabled = doc["on"];
+  formationConfig.group = doc["group"] | formationConfig.group;
+  uint8_t hz = doc["hz"] | formationConfig.rateHz;
+  formationConfig.rateHz = hz < 1 ? 1 : hz > FORMATION_MAX_RATE_HZ ? FORMATION_MAX_RATE_HZ : hz;
+  formationConfig.budgetBps = doc["budget"] | formationConfig.budgetBps;
+  if (!formationConfig.enabled)
+    FormationTable_init(&formationTable);
+  FormationConfig config = formationConfig;
+  portEXIT_CRITICAL(&formationMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "set_formation";
+  res["on"] = config.enabled;
+  res["group"] = config.group;
+  res["hz"] = config.rateHz;
+  res["budget"] = config.budgetBps;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdFollow(JsonDocument &doc) {
+  // {"c":"follow","mac":"AA:BB:CC:DD:EE:FF","right":3,"back":5,"lead":0.5,"speed":1600}
+  // or {"c":"follow","on":false}; offsets in the leader's heading frame
+  NavigationManager &nav = NavigationManager::getInstance();
+  uint8_t leader[6];
+  if (!doc["on"].isNull() && !doc["on"].as<bool>()) {
+    nav.stopMission();
+    portENTER_CRITICAL(&formationMux);
+    formationConfig.haveLeader = false;
+    portEXIT_CRITICAL(&formationMux);
+    commandOut->println("{\"ok\":true}");
+  } else if (!doc["mac"].is<const char *>() || !parseMacAddress(doc["mac"].as<const char *>(), leader)) {
+    commandOut->println("{\"ok\":false,\"msg\":\"Invalid mac\"}");
+  } else {
+    NavFollowConfig follow = nav.getFollow();
+    follow.right = doc["right"] | follow.right;
+    follow.back = doc["back"] | follow.back;
+    follow.leadS = doc["lead"] | follow.leadS;
+    follow.speed = doc["speed"] | follow.speed;
+    portENTER_CRITICAL(&formationMux);
+    memcpy(formationConfig.leader, leader, 6);
+    formationConfig.haveLeader = true;
+    bool enabled = formationConfig.enabled;
+    portEXIT_CRITICAL(&formationMux);
+    nav.startFollow(follow);
+    commandOut->println(enabled ? "{\"ok\":true}"
+                           : "{\"ok\":true,\"msg\":\"Formation off\"}");
+  }
+}
+
+static void cmdGetFormation(JsonDocument &doc) {
+  // {"c":"get_formation","ms":200,"sent":..,"nb":[{"mac":..,"seq":..,"age":..}]}
+  struct {
+    uint8_t mac[6];
+    uint32_t seq, age, beacons;
+    uint16_t wp;
+    uint8_t type, flags;
+  } rows[FORMATION_MAX_NEIGHBORS];
+  uint8_t count = 0;
+  uint32_t now = HAL_GetMillis();
+  portENTER_CRITICAL(&formationMux);
+  for (int i = 0; i < FORMATION_MAX_NEIGHBORS; i++) {
+    const FormationNeighbor *n = &formationTable.neighbors[i];
+    if (!FormationTable_isLive(n, now))
+      continue;
+    memcpy(rows[count].mac, n->mac, 6);
+    rows[count].seq = n->sequence;
+    rows[count].age = now - n->lastSeenMs;
+    rows[count].beacons = n->beacons;
+    rows[count].wp = n->state.missionIndex;
+    rows[count].type = n->state.vehicleType;
+    rows[count].flags = n->state.flags;
+    count++;
+  }
+  FormationConfig config = formationConfig;
+  uint32_t stale = formationTable.stale;
+  uint32_t dropped = formationTable.dropped;
+  portEXIT_CRITICAL(&formationMux);
+
+  JsonDocument res(&commandArena);
+  res["c"] = "get_formation";
+  res["on"] = config.enabled;
+  res["group"] = config.group;
+  res["ms"] = formationIntervalMs;
+  res["sent"] = formationSent;
+  res["bad"] = formationBadTag;
+  res["stale"] = stale;
+  res["full"] = dropped;
+  NavigationState nav = {};
+  topicNavState.read(nav);
+  res["follow"] = nav.isFollowing;
+  JsonArray nb = res["nb"].to<JsonArray>();
+  for (uint8_t i = 0; i < count; i++) {
+    char macStr[18];
+    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", rows[i].mac[0],
+             rows[i].mac[1], rows[i].mac[2], rows[i].mac[3], rows[i].mac[4],
+             rows[i].mac[5]);
+    JsonObject n = nb.add<JsonObject>();
+    n["mac"] = macStr;
+    n["seq"] = rows[i].seq;
+    n["age"] = rows[i].age;
+    n["rx"] = rows[i].beacons;
+    n["wp"] = rows[i].wp;
+    n["type"] = rows[i].type;
+    n["flags"] = rows[i].flags;
+    n["leader"] = config.haveLeader && memcmp(rows[i].mac, config.leader, 6) == 0;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetRtk(JsonDocument &doc) {
+  // {"c":"set_rtk","mode":"rover"}: off, rover (take corrections) or base (send them)
+  const char *name = doc["mode"] | "";
+  int mode = -1;
+  for (int i = 0; i < (int)(sizeof(RTK_MODE_NAMES) / sizeof(RTK_MODE_NAMES[0])); i++) {
+    if (strcmp(name, RTK_MODE_NAMES[i]) == 0)
+      mode = i;
+  }
+  if (mode < 0) {
+    commandOut->println("{\"ok\":false,\"msg\":\"Invalid mode\"}");
+    return;
+  }
+  if (mode != RTK_OFF && !gpsManager) {
+    commandOut->println("{\"ok\":false,\"msg\":\"No GPS\"}");
+    return;
+  }
+  rtkMode = (uint8_t)mode;
+  if (gpsManager)
+    gpsManager->setBase(mode == RTK_BASE, rtkBaseFrame, nullptr);
+  JsonDocument res(&commandArena);
+  res["c"] = "set_rtk";
+  res["mode"] = RTK_MODE_NAMES[mode];
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetRtk(JsonDocument &doc) {
+  // {"c":"get_rtk","mode":"rover","carr":2,"h_acc":14,"frames":..,"in":..}
+  GPSFix fix;
+  memset(&fix, 0, sizeof(fix));
+  bool have = gpsManager && gpsManager->getFix(fix);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_rtk";
+  res["mode"] = RTK_MODE_NAMES[rtkMode];
+  res["carr"] = fix.carrSoln;                   // 0 none, 1 float, 2 fixed
+  res["h_acc"] = fix.hAcc;                      // mm
+  res["age"] = have ? HAL_GetMillis() - fix.timeMs : 0;
+  // Rover: fragments with a bad tag, frames rebuilt / lost, queued to the receiver
+  res["bad"] = rtkBadTag;
+  res["frames"] = rtkReassembler.frames;
+  res["lost"] = rtkReassembler.lost;
+  res["crc"] = rtkReassembler.crcErrors;
+  res["in"] = gpsManager ? gpsManager->getCorrectionsIn() : 0;
+  res["full"] = gpsManager ? gpsManager->getCorrectionsDropped() : 0;
+  // Base: frames from the receiver, fragments sent
+  res["out"] = gpsManager ? gpsManager->getCorrectionsOut() : 0;
+  res["sent"] = rtkSent;
+  res["base"] = gpsManager ? gpsManager->isBase() : false;  // Receiver set up as base
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetLatency(JsonDocument &doc) {
+  // {"c":"set_latency","on":true,"reset":true}
+  if (doc["reset"] | false) {
+    portENTER_CRITICAL(&latencyMux);
+    LatencyProbe_init(&latencyProbe);
+    portEXIT_CRITICAL(&latencyMux);
+  }
+  if (!doc["on"].isNull())
+    latencyProbeEnabled = doc["on"].as<bool>();
+  JsonDocument res(&commandArena);
+  res["c"] = "set_latency";
+  res["on"] = (bool)latencyProbeEnabled;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetInput(JsonDocument &doc) {
+  // {"c":"set_input","mode":"extrapolate","gap":100,"cutoff":15}
+  // Applied on the next control tick and stored
+  portENTER_CRITICAL(&inputMux);
+  InputCondConfig next = inputConfig;
+  portEXIT_CRITICAL(&inputMux);
+  InputCondMode mode;
+  bool modeOk =
+      doc["mode"].isNull() || InputConditioner_parseMode(doc["mode"].as<const char *>(), &mode);
+  if (!modeOk) {
+    commandOut->println("{\"ok\":false,\"err\":\"mode: hold, extrapolate or slew\"}");
+    return;
+  }
+  if (!doc["mode"].isNull())
+    next.mode = mode;
+  next.maxGapMs = doc["gap"] | next.maxGapMs;
+  next.cutoffHz = doc["cutoff"] | next.cutoffHz;
+  InputConditioner_sanitize(&next);
+  portENTER_CRITICAL(&inputMux);
+  inputConfig = next;
+  inputConfigRevision++;
+  portEXIT_CRITICAL(&inputMux);
+  bool ok = ConfigManager::saveBlob(INPUT_COND_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_input";
+  res["ok"] = ok;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetGyroFilter(JsonDocument &doc) {
+  // {"c":"set_gyro_filter","lpf":90,"order":4,"notch":180,"q":5}
+  // 0 turns a filter off. Rebuilt on the next control tick and stored
+  portENTER_CRITICAL(&gyroFilterMux);
+  BiquadChainConfig next = gyroFilterConfig;
+  portEXIT_CRITICAL(&gyroFilterMux);
+  next.lowpassHz = doc["lpf"] | next.lowpassHz;
+  if (!doc["order"].isNull())
+    next.lowpassStages = (uint8_t)((doc["order"].as<int>() + 1) / 2);
+  next.notchHz = doc["notch"] | next.notchHz;
+  next.notchQ = doc["q"] | next.notchQ;
+  BiquadChain_sanitize(&next, IMU_SAMPLE_RATE_HZ);
+  portENTER_CRITICAL(&gyroFilterMux);
+  gyroFilterConfig = next;
+  gyroFilterRevision++;
+  portEXIT_CRITICAL(&gyroFilterMux);
+  bool ok = ConfigManager::saveBlob(GYRO_FILTER_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_gyro_filter";
+  res["ok"] = ok;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetGyroFilter(JsonDocument &doc) {
+  portENTER_CRITICAL(&gyroFilterMux);
+  BiquadChainConfig config = gyroFilterConfig;
+  portEXIT_CRITICAL(&gyroFilterMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_gyro_filter";
+  res["lpf"] = config.lowpassHz;
+  res["order"] = config.lowpassStages * 2;
+  res["notch"] = config.notchHz;
+  res["q"] = config.notchQ;
+  res["stages"] = gyroFilter.stages;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetDynNotch(JsonDocument &doc) {
+  // {"c":"set_dyn_notch","on":true,"min":80,"max":400,"q":4} (Copter)
+  // Applied on the next control tick and stored
+  portENTER_CRITICAL(&dynNotchMux);
+  DynNotchConfig next = dynNotchConfig;
+  portEXIT_CRITICAL(&dynNotchMux);
+  next.enabled = doc["on"] | next.enabled;
+  next.minHz = doc["min"] | next.minHz;
+  next.maxHz = doc["max"] | next.maxHz;
+  next.q = doc["q"] | next.q;
+  DynamicNotch_sanitize(&next, IMU_SAMPLE_RATE_HZ);
+  portENTER_CRITICAL(&dynNotchMux);
+  dynNotchConfig = next;
+  dynNotchRevision++;
+  portEXIT_CRITICAL(&dynNotchMux);
+  bool ok = ConfigManager::saveBlob(DYN_NOTCH_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_dyn_notch";
+  res["ok"] = ok;
+  res["available"] = dynNotchAvailable;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetDynNotch(JsonDocument &doc) {
+  portENTER_CRITICAL(&dynNotchMux);
+  DynNotchConfig config = dynNotchConfig;
+  portEXIT_CRITICAL(&dynNotchMux);
+  GyroNotchMsg notch;
+  bool tracking = topicGyroNotch.read(notch);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_dyn_notch";
+  res["on"] = config.enabled;
+  res["available"] = dynNotchAvailable;
+  res["min"] = config.minHz;
+  res["max"] = config.maxHz;
+  res["q"] = config.q;
+  if (tracking) {
+    res["hz"] = notch.centerHz;
+    res["snr"] = notch.peakSnr;
+  }
+  res["analyses"] = dynNotch.analyses;
+  res["locks"] = dynNotch.locks;
+  res["dropped"] = gyroNoiseRing.getDroppedCount();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetRpmFilter(JsonDocument &doc) {
+  // {"c":"set_rpm_filter","on":true,"harmonics":3,"min":80,"q":5,"poles":14}
+  // Applied on the next control tick and stored
+  portENTER_CRITICAL(&rpmFilterMux);
+  RpmFilterConfig next = rpmFilterConfig;
+  portEXIT_CRITICAL(&rpmFilterMux);
+  next.enabled = doc["on"] | next.enabled;
+  next.harmonics = doc["harmonics"] | next.harmonics;
+  next.minHz = doc["min"] | next.minHz;
+  next.q = doc["q"] | next.q;
+  next.motorPoles = doc["poles"] | next.motorPoles;
+  RpmFilter_sanitize(&next, IMU_SAMPLE_RATE_HZ);
+  portENTER_CRITICAL(&rpmFilterMux);
+  rpmFilterConfig = next;
+  rpmFilterRevision++;
+  portEXIT_CRITICAL(&rpmFilterMux);
+  bool ok = ConfigManager::saveBlob(RPM_FILTER_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_rpm_filter";
+  res["ok"] = ok;
+  res["esc"] = vehicle->getEscTelemetry() != nullptr;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetFbw(JsonDocument &doc) {
+  // {"c":"set_fbw","on":true,"bank":45,"pitch":20,"angle":4,"roll_rate":120,
+  //  "pitch_rate":60,"p":0.5,"i":0.3,"d":0.01,"ff":0.4,"cruise":12,
+  //  "rudder_mix":0.2,"turn_yaw":0.5,"slew":4}; no fields = read back.
+  // Applied on the next control tick and stored
+  portENTER_CRITICAL(&fbwMux);
+  FbwConfig next = fbwConfig;
+  portEXIT_CRITICAL(&fbwMux);
+  next.enabled = doc["on"] | next.enabled;
+  next.maxBankDeg = doc["bank"] | next.maxBankDeg;
+  next.maxPitchDeg = doc["pitch"] | next.maxPitchDeg;
+  next.angleGain = doc["angle"] | next.angleGain;
+  next.maxRollRateDps = doc["roll_rate"] | next.maxRollRateDps;
+  next.maxPitchRateDps = doc["pitch_rate"] | next.maxPitchRateDps;
+  next.rateKp = doc["p"] | next.rateKp;
+  next.rateKi = doc["i"] | next.rateKi;
+  next.rateKd = doc["d"] | next.rateKd;
+  next.rateKff = doc["ff"] | next.rateKff;
+  next.cruiseMps = doc["cruise"] | next.cruiseMps;
+  next.rudderMix = doc["rudder_mix"] | next.rudderMix;
+  next.turnYawGain = doc["turn_yaw"] | next.turnYawGain;
+  next.slewPerSec = doc["slew"] | next.slewPerSec;
+  FlyByWire_sanitize(&next);
+  bool changed = memcmp(&next, &fbwConfig, sizeof(next)) != 0;
+  bool ok = true;
+  if (changed) {
+    portENTER_CRITICAL(&fbwMux);
+    fbwConfig = next;
+    fbwRevision++;
+    portEXIT_CRITICAL(&fbwMux);
+    ok = ConfigManager::saveBlob(FBW_CONFIG_KEY, &next, sizeof(next));
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "set_fbw";
+  res["ok"] = ok;
+  res["on"] = next.enabled;
+  res["bank"] = next.maxBankDeg;
+  res["pitch"] = next.maxPitchDeg;
+  res["angle"] = next.angleGain;
+  res["roll_rate"] = next.maxRollRateDps;
+  res["pitch_rate"] = next.maxPitchRateDps;
+  res["p"] = next.rateKp;
+  res["i"] = next.rateKi;
+  res["d"] = next.rateKd;
+  res["ff"] = next.rateKff;
+  res["cruise"] = next.cruiseMps;
+  res["rudder_mix"] = next.rudderMix;
+  res["turn_yaw"] = next.turnYawGain;
+  res["slew"] = next.slewPerSec;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetTecs(JsonDocument &doc) {
+  // {"c":"set_tecs","on":true,"tc":5,"climb":5,"sink":4,"accel":2,"vmin":9,
+  //  "vmax":25,"w":1,"trim":0.5,"thr_p":1,"thr_i":0.2,"thr_ff":1,"thr_imax":0.3,
+  //  "pitch_p":1,"pitch_i":0.2,"pitch_imax":5,"pitch_max":15,"pitch_min":-15};
+  // no fields = read back. Applied on the next control tick and stored
+  portENTER_CRITICAL(&tecsMux);
+  TecsConfig next = tecsConfig;
+  portEXIT_CRITICAL(&tecsMux);
+  next.enabled = doc["on"] | next.enabled;
+  next.timeConst = doc["tc"] | next.timeConst;
+  next.maxClimbMps = doc["climb"] | next.maxClimbMps;
+  next.maxSinkMps = doc["sink"] | next.maxSinkMps;
+  next.maxAccelMps2 = doc["accel"] | next.maxAccelMps2;
+  next.minSpeedMps = doc["vmin"] | next.minSpeedMps;
+  next.maxSpeedMps = doc["vmax"] | next.maxSpeedMps;
+  next.speedWeight = doc["w"] | next.speedWeight;
+  next.trimThrottle = doc["trim"] | next.trimThrottle;
+  next.throttleKp = doc["thr_p"] | next.throttleKp;
+  next.throttleKi = doc["thr_i"] | next.throttleKi;
+  next.throttleKff = doc["thr_ff"] | next.throttleKff;
+  next.throttleILimit = doc["thr_imax"] | next.throttleILimit;
+  next.pitchKp = doc["pitch_p"] | next.pitchKp;
+  next.pitchKi = doc["pitch_i"] | next.pitchKi;
+  next.pitchILimitDeg = doc["pitch_imax"] | next.pitchILimitDeg;
+  next.maxPitchDeg = doc["pitch_max"] | next.maxPitchDeg;
+  next.minPitchDeg = doc["pitch_min"] | next.minPitchDeg;
+  TotalEnergy_sanitize(&next);
+  bool changed = memcmp(&next, &tecsConfig, sizeof(next)) != 0;
+  bool ok = true;
+  if (changed) {
+    portENTER_CRITICAL(&tecsMux);
+    tecsConfig = next;
+    tecsRevision++;
+    portEXIT_CRITICAL(&tecsMux);
+    ok = ConfigManager::saveBlob(TECS_CONFIG_KEY, &next, sizeof(next));
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "set_tecs";
+  res["ok"] = ok;
+  res["on"] = next.enabled;
+  res["tc"] = next.timeConst;
+  res["climb"] = next.maxClimbMps;
+  res["sink"] = next.maxSinkMps;
+  res["accel"] = next.maxAccelMps2;
+  res["vmin"] = next.minSpeedMps;
+  res["vmax"] = next.maxSpeedMps;
+  res["w"] = next.speedWeight;
+  res["trim"] = next.trimThrottle;
+  res["thr_p"] = next.throttleKp;
+  res["thr_i"] = next.throttleKi;
+  res["thr_ff"] = next.throttleKff;
+  res["thr_imax"] = next.throttleILimit;
+  res["pitch_p"] = next.pitchKp;
+  res["pitch_i"] = next.pitchKi;
+  res["pitch_imax"] = next.pitchILimitDeg;
+  res["pitch_max"] = next.maxPitchDeg;
+  res["pitch_min"] = next.minPitchDeg;
+  res["active"] = tecsActive;
+  res["pitot"] = pitotFitted;
+  res["src"] = tecsPitot ? "pitot" : "gps";
+  res["alt_src"] = baroAltValid ? "baro" : "ekf";
+  AirspeedMsg air;
+  if (topicAirspeed.read(air))
+    res["airspeed"] = air.airspeed;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetAlt(JsonDocument &doc) {
+  // {"c":"set_alt","on":true,"kp":1,"climb":2,"sink":1.5,"rate_p":0.15,
+  //  "rate_i":0.1,"imax":0.2,"hover":0.45,"dz":0.1,"zero":true};
+  // no fields = read back. Applied on the next control tick and stored;
+  // zero: take a new ground reference (ignored while holding)
+  portENTER_CRITICAL(&altHoldMux);
+  AltHoldConfig next = altHoldConfig;
+  portEXIT_CRITICAL(&altHoldMux);
+  if (!doc["on"].isNull())
+    next.enabled = doc["on"].as<bool>();
+  next.posKp = doc["kp"] | next.posKp;
+  next.maxClimbMps = doc["climb"] | next.maxClimbMps;
+  next.maxSinkMps = doc["sink"] | next.maxSinkMps;
+  next.rateKp = doc["rate_p"] | next.rateKp;
+  next.rateKi = doc["rate_i"] | next.rateKi;
+  next.iLimit = doc["imax"] | next.iLimit;
+  next.hoverThrottle = doc["hover"] | next.hoverThrottle;
+  next.deadband = doc["dz"] | next.deadband;
+  bool zero = doc["zero"] | false;
+  AltitudeHold_sanitize(&next);
+  bool changed = memcmp(&next, &altHoldConfig, sizeof(next)) != 0;
+  portENTER_CRITICAL(&altHoldMux);
+  if (changed) {
+    altHoldConfig = next;
+    altHoldRevision++;
+  }
+  baroZeroRequest |= zero;
+  portEXIT_CRITICAL(&altHoldMux);
+  bool ok = !changed || ConfigManager::saveBlob(ALT_HOLD_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_alt";
+  res["ok"] = ok;
+  res["on"] = next.enabled;
+  res["kp"] = next.posKp;
+  res["climb"] = next.maxClimbMps;
+  res["sink"] = next.maxSinkMps;
+  res["rate_p"] = next.rateKp;
+  res["rate_i"] = next.rateKi;
+  res["imax"] = next.iLimit;
+  res["hover"] = next.hoverThrottle;
+  res["dz"] = next.deadband;
+  // State, copied from the control task without a lock: display only
+  res["baro"] = baroFitted;
+  res["valid"] = baroAltValid;
+  res["alt"] = baroAlt.altitude;
+  res["vz"] = baroAlt.climbRate;
+  res["bias"] = baroAlt.accelBias;
+  res["hold"] = altHold.engaged;
+  res["target"] = altHold.target;
+  BaroMsg msg;
+  if (topicBaro.read(msg)) {
+    res["pa"] = msg.pressurePa;
+    res["temp"] = msg.temperature;
+    res["n"] = msg.sampleCount;
+  }
+#if FEATURE_BARO
+  res["err"] = baro.getErrorCount();
+#endif
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetThrust(JsonDocument &doc) {
+  // {"c":"set_thrust","lin":true,"expo":0.65,"vcomp":true,"ref":4200,
+  //  "boost":1.3,"tc":1}; no fields = read back. Applied on the next
+  // control tick and stored
+  portENTER_CRITICAL(&thrustMux);
+  ThrustCurveConfig next = thrustConfig;
+  portEXIT_CRITICAL(&thrustMux);
+  next.linearize = doc["lin"] | next.linearize;
+  next.expo = doc["expo"] | next.expo;
+  next.voltageComp = doc["vcomp"] | next.voltageComp;
+  next.refCellMv = doc["ref"] | next.refCellMv;
+  next.maxBoost = doc["boost"] | next.maxBoost;
+  next.voltageTauS = doc["tc"] | next.voltageTauS;
+  ThrustCurve_sanitize(&next);
+  bool changed = memcmp(&next, &thrustConfig, sizeof(next)) != 0;
+  bool ok = true;
+  if (changed) {
+    portENTER_CRITICAL(&thrustMux);
+    thrustConfig = next;
+    thrustRevision++;
+    portEXIT_CRITICAL(&thrustMux);
+    ok = ConfigManager::saveBlob(THRUST_CURVE_CONFIG_KEY, &next, sizeof(next));
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "set_thrust";
+  res["ok"] = ok;
+  res["lin"] = next.linearize;
+  res["expo"] = next.expo;
+  res["vcomp"] = next.voltageComp;
+  res["ref"] = next.refCellMv;
+  res["boost"] = next.maxBoost;
+  res["tc"] = next.voltageTauS;
+  // State, copied from the control task without a lock: display only
+  const ThrustCurve *curve = vehicle->getThrustCurve();
+  res["fitted"] = curve != nullptr;
+  if (curve) {
+    res["cell_mv"] = curve->cellMv;
+    res["scale"] = curve->scale;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetOdom(JsonDocument &doc) {
+  // {"c":"set_odom","on":true,"cpr":1440,"wheel":0.12,"track":0.3,"vmax":1.5,
+  //  "p":0.5,"i":2,"ff":1,"hz":5}; no fields = read back. Applied on the
+  // next control tick and stored; "on":false = encoders for odometry only
+  portENTER_CRITICAL(&odomMux);
+  OdometryConfig next = odomConfig;
+  portEXIT_CRITICAL(&odomMux);
+  next.speedControl = doc["on"] | next.speedControl;
+  next.countsPerRev = doc["cpr"] | next.countsPerRev;
+  next.wheelDiameterM = doc["wheel"] | next.wheelDiameterM;
+  next.trackWidthM = doc["track"] | next.trackWidthM;
+  next.maxSpeedMps = doc["vmax"] | next.maxSpeedMps;
+  next.kp = doc["p"] | next.kp;
+  next.ki = doc["i"] | next.ki;
+  next.kff = doc["ff"] | next.kff;
+  next.filterHz = doc["hz"] | next.filterHz;
+  WheelOdometry_sanitize(&next);
+  bool changed = memcmp(&next, &odomConfig, sizeof(next)) != 0;
+  bool ok = true;
+  if (changed) {
+    portENTER_CRITICAL(&odomMux);
+    odomConfig = next;
+    odomRevision++;
+    portEXIT_CRITICAL(&odomMux);
+    ok = ConfigManager::saveBlob(ODOM_CONFIG_KEY, &next, sizeof(next));
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "set_odom";
+  res["ok"] = ok;
+  res["fitted"] = vehicle->getOdometry() != nullptr;
+  res["on"] = next.speedControl;
+  res["cpr"] = next.countsPerRev;
+  res["wheel"] = next.wheelDiameterM;
+  res["track"] = next.trackWidthM;
+  res["vmax"] = next.maxSpeedMps;
+  res["p"] = next.kp;
+  res["i"] = next.ki;
+  res["ff"] = next.kff;
+  res["hz"] = next.filterHz;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetRange(JsonDocument &doc) {
+  // {"c":"set_range","on":true,"slow":2,"stop":0.5}: obstacle envelope in
+  // m; no fields = read back. Applied on the next control tick and
+  // stored; "on":false = ranges published, speed left alone
+  portENTER_CRITICAL(&rangeMux);
+  RangeEnvelope next = rangeEnvelope;
+  portEXIT_CRITICAL(&rangeMux);
+  next.enabled = doc["on"] | next.enabled;
+  next.slowM = doc["slow"] | next.slowM;
+  next.stopM = doc["stop"] | next.stopM;
+  RangeEnvelope_sanitize(&next);
+  bool changed = memcmp(&next, &rangeEnvelope, sizeof(next)) != 0;
+  bool ok = true;
+  if (changed) {
+    portENTER_CRITICAL(&rangeMux);
+    rangeEnvelope = next;
+    rangeRevision++;
+    portEXIT_CRITICAL(&rangeMux);
+    ok = ConfigManager::saveBlob(RANGE_CONFIG_KEY, &next, sizeof(next));
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "set_range";
+  res["ok"] = ok;
+  res["on"] = next.enabled;
+  res["slow"] = next.slowM;
+  res["stop"] = next.stopM;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetRange(JsonDocument &doc) {
+  // {"c":"get_range","fitted":true,"m":1.42,"age":12,"scale":0.61,...}
+  RangeMsg range = {};
+  bool have = topicRange.read(range);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_range";
+  res["fitted"] = rangeFitted;
+  res["m"] = range.range;                       // Median
+  res["echo"] = range.echoUs;                   // Last pulse, us (0 = clear)
+  res["age"] = have ? HAL_GetMillis() - range.timeMs : 0;
+  res["n"] = range.sampleCount;
+  res["missed"] = range.missed;                 // Triggers with no echo line activity
+  res["scale"] = NavigationManager::getInstance().getObstacleScale();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdMotorCal(JsonDocument &doc) {
+  // {"c":"motor_cal","m":0}: ramp motor 0 from standstill until it turns
+  // and store the breakaway as its minPWM (disarmed, wheels free or in
+  // water); "stop":true ends a run; no fields = progress
+  int m = doc["m"] | -1;
+  bool stop = doc["stop"] | false;
+  const char *err = nullptr;
+  if (m >= 0) {
+    if (m >= vehicle->getMotorCount())
+      err = "No such motor";
+    else if (failsafeManager.isArmed() || NavigationManager::getInstance().getState().isMissionActive)
+      err = "Disarm first";
+  }
+  portENTER_CRITICAL(&motorTrimMux);
+  if (!err && m >= 0)
+    motorCalRequest = (int8_t)m;
+  motorCalAbortRequest |= stop;
+  MotorCal cal = motorCalStatus;
+  int8_t motor = motorCalStatusMotor;
+  portEXIT_CRITICAL(&motorTrimMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "motor_cal";
+  res["ok"] = err == nullptr;
+  if (err)
+    res["err"] = err;
+  res["m"] = motor;
+  res["state"] = MotorCal_stateName(cal.state);
+  res["fb"] = cal.feedback == MOTOR_CAL_FEEDBACK_ENCODER ? "enc" : "amps";
+  res["duty"] = cal.duty;
+  if (cal.state == MOTOR_CAL_DONE) {
+    res["breakaway"] = cal.breakaway;
+    res["min"] = MotorCal_minPwm(&cal);
+  }
+  res["counts"] = cal.lastCounts;               // Edges in the last step
+  res["amps"] = cal.lastAmps;                   // Last step less the baseline
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetMotorTrim(JsonDocument &doc) {
+  // {"c":"set_motor_trim","m":1,"min":45,"db":8}: per-motor minPWM (of
+  // 255) / deadband (of 100) over MotorConfig; "clear":true = follow
+  // MotorConfig again; no fields = read back every motor
+  int m = doc["m"] | -1;
+  bool ok = m < vehicle->getMotorCount() && m < MOTOR_TRIM_MAX;
+  portENTER_CRITICAL(&motorTrimMux);
+  MotorTrimTable next = motorTrims;
+  portEXIT_CRITICAL(&motorTrimMux);
+  if (ok && m >= 0) {
+    MotorTrim &trim = next.motors[m];
+    if (doc["clear"] | false)
+      trim.minPWM = trim.deadband = MOTOR_TRIM_INHERIT;
+    if (!doc["min"].isNull())
+      trim.minPWM = (uint8_t)constrain(doc["min"].as<int>(), 0, MOTOR_TRIM_INHERIT - 1);
+    if (!doc["db"].isNull())
+      trim.deadband = (uint8_t)constrain(doc["db"].as<int>(), 0, MOTOR_TRIM_MAX_DEADBAND);
+    MotorTrim_sanitize(&next);
+    if (memcmp(&next, &motorTrims, sizeof(next)) != 0) {
+      portENTER_CRITICAL(&motorTrimMux);
+      motorTrims = next;
+      motorTrimRevision++;
+      portEXIT_CRITICAL(&motorTrimMux);
+      ok = ConfigManager::saveBlob(MOTOR_TRIM_CONFIG_KEY, &next, sizeof(next));
+    }
+  }
+  JsonDocument res(&commandArena);
+  res["c"] = "set_motor_trim";
+  res["ok"] = ok;
+  ConfigManager::MotorConfig base = configManager->getMotorConfig();
+  JsonArray motors = res["motors"].to<JsonArray>();
+  for (uint8_t i = 0; i < vehicle->getMotorCount() && i < MOTOR_TRIM_MAX; i++) {
+    // Values in use; "own" = trimmed rather than MotorConfig's
+    JsonObject o = motors.add<JsonObject>();
+    o["min"] = MotorTrim_resolve(next.motors[i].minPWM, base.minPWM);
+    o["db"] = MotorTrim_resolve(next.motors[i].deadband, base.deadband);
+    o["own"] = next.motors[i].minPWM != MOTOR_TRIM_INHERIT ||
+               next.motors[i].deadband != MOTOR_TRIM_INHERIT;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetAux(JsonDocument &doc) {
+  // {"c":"set_aux","ch":8,"us":1500}: PCA9685 auxiliary pulse, channels
+  // 8-15 (0 us = no pulse); no fields = read back. Not stored: outputs
+  // start off after a reboot
+  int ch = doc["ch"] | -1;
+  bool ok = true;
+  if (!doc["ch"].isNull()) {
+    ok = ch >= TOPIC_ACTUATOR_CHANNELS && ch < PCA9685_CHANNELS;
+    if (ok) {
+      uint16_t us = (uint16_t)constrain(doc["us"] | 0, 0, 20000);
+      portENTER_CRITICAL(&pwmAuxMux);
+      pwmAuxUs[ch - TOPIC_ACTUATOR_CHANNELS] = us;
+      portEXIT_CRITICAL(&pwmAuxMux);
+    }
+  }
+  uint16_t aux[PCA9685_CHANNELS - TOPIC_ACTUATOR_CHANNELS];
+  portENTER_CRITICAL(&pwmAuxMux);
+  memcpy(aux, pwmAuxUs, sizeof(aux));
+  portEXIT_CRITICAL(&pwmAuxMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "set_aux";
+  res["ok"] = ok;
+  res["fitted"] = (bool)pwmExpanderFitted;
+  res["hz"] = pwmExpander.getFrequency();
+  res["bursts"] = pwmExpander.getBurstCount();
+  res["errors"] = pwmExpander.getErrorCount();
+  JsonArray us = res["us"].to<JsonArray>();
+  for (uint8_t i = 0; i < PCA9685_CHANNELS - TOPIC_ACTUATOR_CHANNELS; i++)
+    us.add(aux[i]);
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetEsc(JsonDocument &doc) {
+  // Per-motor ESC feedback and the RPM filter it drives
+  portENTER_CRITICAL(&rpmFilterMux);
+  RpmFilterConfig config = rpmFilterConfig;
+  portEXIT_CRITICAL(&rpmFilterMux);
+  EscMsg msg;
+  JsonDocument res(&commandArena);
+  res["c"] = "get_esc";
+  res["rpm_filter"] = config.enabled;
+  res["harmonics"] = config.harmonics;
+  res["min"] = config.minHz;
+  res["q"] = config.q;
+  res["poles"] = config.motorPoles;
+  if (topicEsc.read(msg)) {
+    res["health"] = msg.health;
+    JsonArray motors = res["motors"].to<JsonArray>();
+    for (uint8_t i = 0; i < msg.esc.motorCount; i++) {
+      const EscMotorTelemetry &m = msg.esc.motors[i];
+      JsonObject o = motors.add<JsonObject>();
+      o["rpm"] = (uint32_t)(RpmFilter_erpmToHz(m.last.erpm, config.motorPoles) * 60.0f);
+      if (m.last.fields & ESC_FIELD_TEMP)
+        o["temp"] = m.last.tempC;
+      if (m.last.fields & ESC_FIELD_VOLTAGE)
+        o["v"] = m.last.centiVolts / 100.0f;
+      if (m.last.fields & ESC_FIELD_CURRENT)
+        o["a"] = m.last.centiAmps / 100.0f;
+      if (m.last.fields & ESC_FIELD_CONSUMPTION)
+        o["mah"] = m.last.mAh;
+      o["health"] = m.health;
+      o["n"] = m.samples;
+      o["err"] = m.errors;
+    }
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetInput(JsonDocument &doc) {
+  portENTER_CRITICAL(&inputMux);
+  InputCondConfig config = inputConfig;
+  uint32_t samples = inputConditioner.samples;
+  uint32_t shaped = inputConditioner.shapedTicks;
+  uint32_t gaps = inputConditioner.expiredGaps;
+  portEXIT_CRITICAL(&inputMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_input";
+  res["mode"] = InputConditioner_modeName((InputCondMode)config.mode);
+  res["gap"] = config.maxGapMs;
+  res["cutoff"] = config.cutoffHz;
+  res["n"] = samples;
+  res["shaped"] = shaped;
+  res["gaps"] = gaps;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetRc(JsonDocument &doc) {
+  // {"c":"set_rc","on":true,"proto":"crsf","map":[2,0,1,3],"rev":0,"auto":4,"center":false,
+  //  "tele":true}
+  // map: channel (0-15, -1 = none) of throttle, roll, pitch, yaw; rev: bit
+  // per axis; auto: switch channel for MODE_AUTO (-1 = off); tele: CRSF
+  // telemetry downlink. proto is applied on the next boot, the rest on the
+  // next frame
+  portENTER_CRITICAL(&rcMux);
+  RcConfig next = rcConfig;
+  portEXIT_CRITICAL(&rcMux);
+  RcProtocol protocol;
+  bool protoOk =
+      doc["proto"].isNull() || RcInput_parseProtocol(doc["proto"].as<const char *>(), &protocol);
+  if (!protoOk) {
+    commandOut->println("{\"ok\":false,\"err\":\"proto: sbus or crsf\"}");
+    return;
+  }
+  if (!doc["proto"].isNull())
+    next.protocol = protocol;
+  if (!doc["on"].isNull())
+    next.enabled = doc["on"].as<bool>();
+  JsonArrayConst map = doc["map"];
+  for (uint8_t a = 0; a < RC_AXES && a < map.size(); a++) {
+    int ch = map[a] | -1;
+    next.axes[a] = ch < 0 ? RC_CHANNEL_NONE : (uint8_t)min(ch, RC_MAX_CHANNELS);
+  }
+  next.reverse = doc["rev"] | next.reverse;
+  if (!doc["auto"].isNull()) {
+    int ch = doc["auto"].as<int>();
+    next.autoChannel = ch < 0 ? RC_CHANNEL_NONE : (uint8_t)min(ch, RC_MAX_CHANNELS);
+  }
+  if (!doc["center"].isNull())
+    next.throttleCentered = doc["center"].as<bool>();
+  if (!doc["tele"].isNull())
+    next.telemetry = doc["tele"].as<bool>();
+  RcInput_sanitize(&next);
+  portENTER_CRITICAL(&rcMux);
+  rcConfig = next;
+  portEXIT_CRITICAL(&rcMux);
+  applyRcTelemetry();
+  bool ok = ConfigManager::saveBlob(RC_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_rc";
+  res["ok"] = ok;
+  res["reboot"] = rcReceiver && next.protocol != rcReceiver->getProtocol();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetRc(JsonDocument &doc) {
+  portENTER_CRITICAL(&rcMux);
+  RcConfig config = rcConfig;
+  LatencyHistogram latency[2] = {rcLatency[0], rcLatency[1]};
+  portEXIT_CRITICAL(&rcMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_rc";
+  res["fitted"] = rcReceiver != nullptr;
+  res["pin"] = RC_INPUT_PIN;
+  res["on"] = (bool)config.enabled;
+  res["proto"] = RcInput_protocolName((RcProtocol)config.protocol);
+  JsonArray map = res["map"].to<JsonArray>();
+  for (uint8_t a = 0; a < RC_AXES; a++) {
+    if (config.axes[a] == RC_CHANNEL_NONE)
+      map.add(-1);
+    else
+      map.add(config.axes[a]);
+  }
+  res["rev"] = config.reverse;
+  res["auto"] = config.autoChannel == RC_CHANNEL_NONE ? -1 : (int)config.autoChannel;
+  res["center"] = (bool)config.throttleCentered;
+  res["tele"] = (bool)config.telemetry;
+  res["telePin"] = RC_TELEMETRY_PIN;
+  if (rcReceiver) {
+    RcChannels channels;
+    RcReceiverStats st = rcReceiver->getStats(&channels);
+    res["n"] = st.frames;
+    res["crc"] = st.crcErrors;
+    res["len"] = st.badLength;
+    res["fs"] = st.failsafeFrames;
+    res["lost"] = st.lostFrames;
+    res["ovf"] = st.overflows;
+    res["line"] = st.lineErrors;
+    if (st.lastFrameUs)
+      res["age"] = HAL_MicrosToMillis(HAL_Elapsed(st.lastFrameUs, HAL_Now()));
+    if (st.haveLink) {
+      res["rssi"] = st.link.rssiDbm;
+      res["lq"] = st.link.lq;
+      res["snr"] = st.link.snr;
+    }
+    JsonArray ch = res["ch"].to<JsonArray>();
+    for (uint8_t c = 0; c < RC_MAX_CHANNELS; c++)
+      ch.add(channels.channels[c]);
+    // Downlink: frames written and, per stream, records sent / deferred
+    const TelemetryStreams &down = rcReceiver->getDownlink();
+    JsonObject tx = res["tx"].to<JsonObject>();
+    tx["n"] = st.telemetryFrames;
+    tx["drop"] = st.telemetryDropped;
+    for (uint8_t i = 0; i < TELEMETRY_STREAM_COUNT; i++) {
+      if (!(CRSF_TELEMETRY_STREAMS & (1 << i)))
+        continue;
+      JsonArray s = tx[TelemetryStreams_name((TelemetryStreamId)i)].to<JsonArray>();
+      s.add(down.sent[i]);
+      s.add(down.deferred[i]);
+    }
+  }
+  // Frame end (UART event) to the control tick, and to committed outputs
+  static const char *const LATENCY_NAMES[2] = {"queue", "total"};
+  JsonObject lat = res["lat"].to<JsonObject>();
+  for (uint8_t i = 0; i < 2; i++) {
+    JsonObject st = lat[LATENCY_NAMES[i]].to<JsonObject>();
+    st["n"] = latency[i].count;
+    st["p50"] = LatencyProbe_percentile(&latency[i], 50);
+    st["p99"] = LatencyProbe_percentile(&latency[i], 99);
+    st["max"] = latency[i].maxUs;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetArbiter(JsonDocument &doc) {
+  // {"c":"set_arbiter","mode":"newest","timeout":250}
+  // mode: newest (latest arrival of any link) or priority (rc, serial,
+  // radio, ws); timeout: ms without a frame before a link is unhealthy
+  portENTER_CRITICAL(&arbiterMux);
+  ControlArbiterConfig next = arbiterConfig;
+  portEXIT_CRITICAL(&arbiterMux);
+  if (!doc["mode"].isNull()) {
+    ControlArbiterMode mode;
+    if (!ControlArbiter_parseMode(doc["mode"].as<const char *>(), &mode)) {
+      commandOut->println("{\"ok\":false,\"err\":\"mode: newest or priority\"}");
+      return;
+    }
+    next.mode = mode;
+  }
+  next.timeoutMs = doc["timeout"] | next.timeoutMs;
+  ControlArbiter_sanitize(&next);
+  portENTER_CRITICAL(&arbiterMux);
+  arbiterConfig = next;
+  portEXIT_CRITICAL(&arbiterMux);
+  bool ok = ConfigManager::saveBlob(CONTROL_ARBITER_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_arbiter";
+  res["ok"] = ok;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetArbiter(JsonDocument &doc) {
+  portENTER_CRITICAL(&arbiterMux);
+  ControlArbiterConfig config = arbiterConfig;
+  ControlArbiter arb = controlArbiter;
+  portEXIT_CRITICAL(&arbiterMux);
+  HAL_Micros now = HAL_Now();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_arbiter";
+  res["mode"] = ControlArbiter_modeName((ControlArbiterMode)config.mode);
+  res["timeout"] = config.timeoutMs;
+  res["active"] = arb.lastLink == CONTROL_ARBITER_NONE
+                      ? "none"
+                      : ControlArbiter_linkName((ControlLink)arb.lastLink);
+  res["sw"] = arb.switches;
+  // Per link: frames offered / applied / duplicate / stale, outages, age
+  JsonObject links = res["links"].to<JsonObject>();
+  for (uint8_t i = 0; i < CONTROL_LINK_COUNT; i++) {
+    const ControlLinkHealth &h = arb.links[i];
+    JsonObject l = links[ControlArbiter_linkName((ControlLink)i)].to<JsonObject>();
+    l["ok"] = h.healthy;
+    l["n"] = h.frames;
+    l["won"] = h.applied;
+    l["dup"] = h.duplicates;
+    l["stale"] = h.stale;
+    l["out"] = h.outages;
+    if (h.lastUs)
+      l["age"] = HAL_MicrosToMillis(HAL_Elapsed(h.lastUs, now));
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetPm(JsonDocument &doc) {
+  // {"c":"set_pm","on":true,"sleep":true,"mhz":80,"idle":10000}
+  // on: scale down once parked; sleep: automatic light sleep while parked;
+  // mhz: parked clock (80 or 160); idle: ms not armed / on a mission first
+  portENTER_CRITICAL(&pmMux);
+  PowerPolicyConfig next = pmConfig;
+  portEXIT_CRITICAL(&pmMux);
+  if (!doc["on"].isNull())
+    next.enabled = doc["on"].as<bool>();
+  if (!doc["sleep"].isNull())
+    next.lightSleep = doc["sleep"].as<bool>();
+  next.minMhz = doc["mhz"] | next.minMhz;
+  next.idleDelayMs = doc["idle"] | next.idleDelayMs;
+  PowerPolicy_sanitize(&next);
+  portENTER_CRITICAL(&pmMux);
+  pmConfig = next;
+  pmConfigRevision++;
+  portEXIT_CRITICAL(&pmMux);
+  bool ok = ConfigManager::saveBlob(POWER_POLICY_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_pm";
+  res["ok"] = ok;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetPm(JsonDocument &doc) {
+  portENTER_CRITICAL(&pmMux);
+  PowerPolicyConfig config = pmConfig;
+  PowerPolicy pp = powerPolicy;
+  portEXIT_CRITICAL(&pmMux);
+  uint32_t now = HAL_GetMillis();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_pm";
+  res["on"] = config.enabled != 0;
+  res["sleep"] = config.lightSleep != 0;
+  res["mhz"] = config.minMhz;
+  res["idle"] = config.idleDelayMs;
+  res["mode"] = PowerPolicy_modeName(pp.applied);
+  res["pm"] = pmLocks;              // false: no esp_pm in this build
+  res["light"] = pmLightSleep;      // Light sleep accepted by esp_pm
+  res["cpu"] = getCpuFrequencyMhz();
+  res["eco_ms"] = PowerPolicy_ecoMs(&pp, now);
+  res["eco_n"] = pp.ecoEntries;
+  // Wake latency: waking frame's arrival -> full clock in place
+  res["wakes"] = pp.wakes;
+  res["wake_us"] = pp.lastWakeUs;
+  res["wake_max"] = pp.maxWakeUs;
+  res["slow"] = pp.slowWakes;
+  res["bound"] = POWER_POLICY_WAKE_BOUND_US;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetLatency(JsonDocument &doc) {
+  LatencyProbe snapshot;
+  portENTER_CRITICAL(&latencyMux);
+  snapshot = latencyProbe;
+  portEXIT_CRITICAL(&latencyMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_latency";
+  res["on"] = (bool)latencyProbeEnabled;
+  res["seq"] = snapshot.echo.sequence;
+
+  // Controller clock: vehicle stamps + offset = controller time
+  ClockSync sync;
+  portENTER_CRITICAL(&clockSyncMux);
+  sync = clockSync;
+  portEXIT_CRITICAL(&clockSyncMux);
+  JsonObject clock = res["clock"].to<JsonObject>();
+  bool synced = ClockSync_isValid(&sync, HAL_Now());
+  clock["ok"] = synced;
+  if (synced) {
+    clock["offset"] = sync.offsetUs;
+    clock["rtt"] = sync.rttUs;
+    clock["drift"] = sync.driftPpb;
+  }
+  clock["n"] = sync.replies;
+  clock["rej"] = sync.rejected;
+
+  JsonObject stages = res["stages"].to<JsonObject>();
+  for (uint8_t i = 0; i < LATENCY_STAGE_COUNT; i++) {
+    const LatencyHistogram &h = snapshot.stages[i];
+    JsonObject st = stages[LatencyProbe_stageName((LatencyStage)i)].to<JsonObject>();
+    st["n"] = h.count;
+    st["p50"] = LatencyProbe_percentile(&h, 50);
+    st["p99"] = LatencyProbe_percentile(&h, 99);
+    st["max"] = h.maxUs;
+    JsonArray hist = st["hist"].to<JsonArray>();
+    for (uint8_t b = 0; b < LATENCY_HIST_BUCKETS; b++)
+      hist.add(h.buckets[b]);
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetBlackbox(JsonDocument &doc) {
+  BlackboxStats bb = Blackbox_getStats();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_blackbox";
+  res["on"] = bb.active;
+  res["session"] = bb.session;
+  res["sectors"] = bb.sectors;
+  res["head"] = bb.head;
+  res["ready"] = bb.erasedAhead;
+  res["rec"] = bb.records;
+  res["drop"] = bb.dropped;
+  res["written"] = bb.sectorsWritten;
+  res["erases"] = bb.erases;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetI2c(JsonDocument &doc) {
+  HAL_I2CQueueStats i2c = HAL_I2CGetQueueStats();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_i2c";
+  res["ok"] = i2c.completed;
+  res["fail"] = i2c.failed;
+  res["rej"] = i2c.rejected;
+  res["hw"] = i2c.highWater;
+  res["depth_err"] = DepthManager::getInstance().getErrorCount();
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetImu(JsonDocument &doc) {
+  IMUStats imu = IMUManager::getInstance().getStats();
+  ImuCal cal;
+  portENTER_CRITICAL(&imuCalMux);
+  cal = imuCalShared;
+  portEXIT_CRITICAL(&imuCalMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_imu";
+  res["ready"] = IMUManager::getInstance().isReady();
+  res["n"] = imu.samples;
+  res["drop"] = imu.dropped;
+  res["ovf"] = imu.fifoOverflows;
+  res["err"] = imu.i2cErrors;
+  res["burst"] = imu.maxBurst;
+
+  // Calibration: bias (deg/s) at the current die temperature
+  JsonObject c = res["cal"].to<JsonObject>();
+  c["gyro"] = (cal.cal.flags & IMU_CAL_HAVE_GYRO) != 0;
+  c["slope"] = (cal.cal.flags & IMU_CAL_HAVE_SLOPE) != 0;
+  c["level"] = (cal.cal.flags & IMU_CAL_HAVE_ACCEL) != 0;
+  c["t"] = cal.lastTempC;
+  c["ref"] = cal.cal.refTempC;
+  float bias[3];
+  ImuCal_gyroBias(&cal, cal.lastTempC, bias);
+  JsonArray b = c["bias"].to<JsonArray>();
+  JsonArray a = c["acc"].to<JsonArray>();
+  for (int i = 0; i < 3; i++) {
+    b.add(bias[i] * RAD_TO_DEG);
+    a.add(cal.cal.accelOffset[i]);
+  }
+  c["still"] = cal.stillWindows;
+  c["moving"] = cal.movingWindows;
+  c["turn"] = cal.rejectedWindows;
+  c["saves"] = imuCalSaves;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdCalImu(JsonDocument &doc) {
+  // {"c":"cal_imu","level":true} - take accel offsets from the next still
+  // half second (vehicle level); {"c":"cal_imu","reset":true} - drop the
+  // stored calibration and learn the gyro bias again
+  bool level = doc["level"] | false;
+  bool reset = doc["reset"] | false;
+  portENTER_CRITICAL(&imuCalMux);
+  imuCalResetRequest |= reset;
+  imuCalLevelRequest |= level;
+  portEXIT_CRITICAL(&imuCalMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "cal_imu";
+  res["ok"] = level || reset;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetMag(JsonDocument &doc) {
+  // {"c":"set_mag","on":true,"learn":true,"decl":-1.5,"reset":false}
+  // on: fuse the compass heading; learn: refine the calibration while
+  // turning; decl: declination in degrees, east positive; reset: drop the
+  // stored calibration and learn it again (turn the vehicle around)
+  portENTER_CRITICAL(&magMux);
+  MagConfig next = magConfig;
+  portEXIT_CRITICAL(&magMux);
+  if (!doc["on"].isNull())
+    next.enabled = doc["on"].as<bool>();
+  if (!doc["learn"].isNull())
+    next.learn = doc["learn"].as<bool>();
+  next.declinationDeg = doc["decl"] | next.declinationDeg;
+  bool reset = doc["reset"] | false;
+  MagCal_sanitize(&next);
+  portENTER_CRITICAL(&magMux);
+  magConfig = next;
+  magCalResetRequest |= reset;
+  portEXIT_CRITICAL(&magMux);
+  bool ok = ConfigManager::saveBlob(MAG_CAL_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_mag";
+  res["ok"] = ok;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetMag(JsonDocument &doc) {
+  portENTER_CRITICAL(&magMux);
+  MagConfig config = magConfig;
+  portEXIT_CRITICAL(&magMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_mag";
+  res["fitted"] = magFitted;
+  res["on"] = config.enabled != 0;
+  res["learn"] = config.learn != 0;
+  res["decl"] = config.declinationDeg;
+  MagMsg msg;
+  if (topicMag.read(msg)) {
+    res["n"] = msg.sampleCount;
+    res["age"] = HAL_GetMillis() - msg.timeMs;
+    JsonArray raw = res["raw"].to<JsonArray>();
+    JsonArray field = res["field"].to<JsonArray>();
+    for (int i = 0; i < 3; i++) {
+      raw.add(msg.raw[i]);
+      field.add(msg.field[i]);
+    }
+    // Calibration: radius in uT, residual as a share of it
+    JsonObject c = res["cal"].to<JsonObject>();
+    c["valid"] = msg.valid;
+    c["planar"] = msg.planar;
+    c["radius"] = msg.radiusUt;
+    c["res"] = msg.residual;
+    c["cover"] = msg.coverage;
+    c["fits"] = msg.fits;
+    c["used"] = msg.accepted;
+    res["disturbed"] = msg.disturbed;
+  }
+  res["fused"] = magHeadingFused;
+  res["gated"] = magHeadingDisturbed;
+  res["saves"] = magCalSaves;
+#if FEATURE_MAG
+  res["err"] = mag.getErrorCount();
+#endif
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetAtt(JsonDocument &doc) {
+  float roll, pitch, yaw;
+  AttitudeEstimator_getEuler(&attitude, &roll, &pitch, &yaw);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_att";
+  res["r"] = roll * RAD_TO_DEG;
+  res["p"] = pitch * RAD_TO_DEG;
+  res["y"] = yaw * RAD_TO_DEG;
+  res["hdg_ok"] = position.headingAligned;
+  res["fixed"] = ATTITUDE_FIXED_POINT;
+  res["n"] = attitude.updates;
+  res["rej"] = attitude.accelRejected;
+  res["cyc"] = AttitudeEstimator_getAvgCycles(&attitude);
+  res["cyc_max"] = attitude.maxCycles;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetBatt(JsonDocument &doc) {
+  JsonDocument res(&commandArena);
+  res["c"] = "get_batt";
+  res["mv"] = batteryModel.mv;
+  res["ocv"] = batteryModel.ocvMv;
+  res["sag"] = batteryModel.sagMv;
+  res["pct"] = BatteryEstimator_getPercent(&batteryModel);
+  res["rem"] = BatteryEstimator_getRemainingSeconds(&batteryModel);
+  res["rtl"] = BatteryEstimator_rtlRequired(&batteryModel);
+  res["dma"] = batteryManager ? batteryManager->isContinuous() : false;
+  res["cal"] = (uint8_t)HAL_ADCGetCalSource();   // 0 nominal, 1 eFuse Vref, 2 two-point
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetPower(JsonDocument &doc) {
+  // {"c":"set_power","offset":330,"gain":25,"cap":2200,"reserve":20,"margin":1.3}
+  // offset: sensor mV at 0 A, gain: A per sensor V
+  portENTER_CRITICAL(&powerMux);
+  PowerConfig next = powerConfig;
+  portEXIT_CRITICAL(&powerMux);
+  next.offsetMv = doc["offset"] | next.offsetMv;
+  next.ampsPerVolt = doc["gain"] | next.ampsPerVolt;
+  next.capacityMah = doc["cap"] | next.capacityMah;
+  next.reservePercent = doc["reserve"] | next.reservePercent;
+  next.returnMargin = doc["margin"] | next.returnMargin;
+  PowerMonitor_sanitize(&next);
+  portENTER_CRITICAL(&powerMux);
+  powerConfig = next;
+  powerRevision++;
+  portEXIT_CRITICAL(&powerMux);
+  bool ok = ConfigManager::saveBlob(POWER_CONFIG_KEY, &next, sizeof(next));
+  JsonDocument res(&commandArena);
+  res["c"] = "set_power";
+  res["ok"] = ok;
+  res["adc"] = batteryManager ? batteryManager->hasCurrentSense() : false;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetPower(JsonDocument &doc) {
+  // Totals, return budget and the most recent legs (newest first)
+  portENTER_CRITICAL(&powerMux);
+  PowerConfig config = powerConfig;
+  portEXIT_CRITICAL(&powerMux);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_power";
+  res["offset"] = config.offsetMv;
+  res["gain"] = config.ampsPerVolt;
+  res["cap"] = config.capacityMah;
+  res["reserve"] = config.reservePercent;
+  res["margin"] = config.returnMargin;
+  PowerMsg msg;
+  if (!topicPower.read(msg)) {
+    res["src"] = POWER_SOURCE_NONE;
+  } else {
+    const PowerMonitor &pm = msg.power;
+    res["src"] = msg.source;
+    res["a"] = pm.amps;
+    res["w"] = pm.watts;
+    res["a_max"] = pm.peakAmps;
+    res["mah"] = pm.mAh;
+    res["wh"] = pm.wh;
+    res["m"] = pm.meters;
+    res["mah_km"] = PowerMonitor_mahPerMeter(&pm) * 1000.0f;    // Negative: unknown
+    res["avail"] = PowerMonitor_availableMah(&pm);
+    res["home"] = pm.returnMah;
+    res["rtl"] = pm.rtl;
+    JsonArray legs = res["legs"].to<JsonArray>();
+    for (uint16_t i = 0;; i++) {
+      const PowerLeg *leg = PowerMonitor_getLeg(&pm, i);
+      if (!leg) break;
+      JsonObject o = legs.add<JsonObject>();
+      if (leg->item == POWER_LEG_RTL)
+        o["rtl"] = true;
+      else
+        o["i"] = leg->item;
+      o["mah"] = leg->mAh;
+      o["wh"] = leg->wh;
+      o["m"] = leg->meters;
+      o["s"] = leg->ms / 1000.0f;
+    }
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetGps(JsonDocument &doc) {
+  GPSFix fix;
+  memset(&fix, 0, sizeof(fix));
+  bool have = gpsManager && gpsManager->getFix(fix);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_gps";
+  res["ubx"] = gpsManager ? gpsManager->isUBX() : false;
+  res["fixes"] = gpsManager ? gpsManager->getFixCount() : 0;
+  res["bytes"] = gpsManager ? gpsManager->getBytesRead() : 0;
+  res["ck_err"] = gpsManager ? gpsManager->getChecksumErrors() : 0;
+  res["ok"] = have && fix.valid;
+  res["type"] = fix.fixType;
+  res["sv"] = fix.numSV;
+  res["lat"] = fix.lat;           // deg * 1e7
+  res["lng"] = fix.lng;
+  res["h_acc"] = fix.hAcc;        // mm
+  res["rtk"] = fix.carrSoln;      // 0 none, 1 float, 2 fixed
+  res["spd"] = fix.groundSpeed;   // mm/s
+  res["age"] = have ? HAL_GetMillis() - fix.timeMs : 0;
+  if (gpsManager) {
+    TimeSync time = gpsManager->getTimeSync();
+    int64_t utcUs = 0;
+    res["ts"] = gpsManager->toUtc(HAL_Now(), utcUs); // TimeSyncState
+    res["utc"] = utcUs / 1000;                       // ms since 1970
+    res["pps"] = time.pulses;
+    res["locks"] = time.locks;
+    res["steps"] = time.steps;
+    res["t_err"] = time.lastErrorUs;                 // us at the last pulse
+    res["drift"] = time.driftPpb;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdGetPwm(JsonDocument &doc) {
+  JsonDocument res(&commandArena);
+  res["c"] = "get_pwm";
+  JsonArray chs = res["ch"].to<JsonArray>();
+  for (uint8_t ch = 0; ch < 16; ch++) {
+    HAL_PWMChannelInfo info;
+    if (!HAL_PWMGetChannelInfo(ch, &info) || !info.allocated) continue;
+    JsonObject o = chs.add<JsonObject>();
+    o["ch"] = ch;
+    o["pin"] = info.pin;
+    o["tmr"] = info.timer;
+    o["hz"] = info.frequency;
+    o["bits"] = info.resolution;
+    o["duty"] = info.duty;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetPid(JsonDocument &doc) {
+  if (configManager) {
+    ConfigManager::PIDConfig pid = configManager->getPIDConfig();
+    pid.kp = doc["kp"] | pid.kp;
+    pid.ki = doc["ki"] | pid.ki;
+    pid.kd = doc["kd"] | pid.kd;
+    configManager->setPIDConfig(pid);
+  }
+}
+
+static void cmdSetNav(JsonDocument &doc) {
+  // Path following: "mode" 0 = direct, 1 = L1; "l1" lookahead m; "cut" 0-1
+  NavGuidanceConfig guidance = NavigationManager::getInstance().getGuidance();
+  if (!doc["mode"].isNull())
+    guidance.mode = (int)doc["mode"] ? NAV_GUIDANCE_L1 : NAV_GUIDANCE_DIRECT;
+  guidance.lookahead = doc["l1"] | guidance.lookahead;
+  guidance.cornerCut = doc["cut"] | guidance.cornerCut;
+  NavigationManager::getInstance().setGuidance(guidance);
+  guidance = NavigationManager::getInstance().getGuidance();
+  // Speed profile: "prof" on/off; "acc" throttle/s, "jerk" throttle/s^2,
+  // "brake" m from full speed to stop, "corner" hairpin speed fraction
+  SpeedProfileConfig speed = NavigationManager::getInstance().getSpeedProfile();
+  speed.enabled = doc["prof"] | speed.enabled;
+  speed.accel = doc["acc"] | speed.accel;
+  speed.jerk = doc["jerk"] | speed.jerk;
+  speed.brakeM = doc["brake"] | speed.brakeM;
+  speed.minFraction = doc["corner"] | speed.minFraction;
+  NavigationManager::getInstance().setSpeedProfile(speed);
+  speed = NavigationManager::getInstance().getSpeedProfile();
+  JsonDocument res(&commandArena);
+  res["c"] = "set_nav";
+  res["mode"] = (int)guidance.mode;
+  res["l1"] = guidance.lookahead;
+  res["cut"] = guidance.cornerCut;
+  res["prof"] = speed.enabled;
+  res["acc"] = speed.accel;
+  res["jerk"] = speed.jerk;
+  res["brake"] = speed.brakeM;
+  res["corner"] = speed.minFraction;
+  NavigationState nav = {};
+  topicNavState.read(nav);
+  res["xte"] = nav.crossTrackError;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdUploadWp(JsonDocument &doc) {
+  if (!doc["lat"].isNull() && !doc["lng"].isNull()) {
+       uint16_t speed = doc["speed"] | 1500;
+       WaypointManager::getInstance().addWaypointE7(NavFrame_toE7(doc["lat"].as<double>()),
+                                                    NavFrame_toE7(doc["lng"].as<double>()),
+                                                    doc["alt"] | 0, speed);
+       commandOut->println("{\"ok\":true, \"msg\":\"WP Added\"}");
+  }
+}
+
+static void cmdUploadItem(JsonDocument &doc) {
+  // Mission command item (MissionItem.h): appended like upload_wp
+  static const char* const kItemNames[MISSION_CMD_COUNT] = {
+      "wp", "loiter", "speed", "depth", "jump", "rtl"};
+  const char* type = doc["t"] | "wp";
+  uint8_t cmdId = MISSION_CMD_COUNT;
+  for (uint8_t i = 0; i < MISSION_CMD_COUNT; i++) {
+      if (strcmp(type, kItemNames[i]) == 0) cmdId = i;
+  }
+  WaypointRecord item;
+  memset(&item, 0, sizeof(item));
+  item.cmd = cmdId;
+  if (MissionItem_isPosition(cmdId)) {
+      item.lat = NavFrame_toE7(doc["lat"] | 0.0);
+      item.lng = NavFrame_toE7(doc["lng"] | 0.0);
+  }
+  item.alt = (int16_t)lroundf((doc[cmdId == MISSION_CMD_SET_DEPTH ? "d" : "alt"] | 0.0f) * 10.0f);
+  item.param = doc["p"] | 0;
+  item.arg = doc["n"] | 0;
+  if (WaypointManager::getInstance().addItem(item)) {
+      commandOut->printf("{\"ok\":true, \"i\":%u}\n", WaypointManager::getInstance().getWaypointCount() - 1);
+  } else {
+      commandOut->println("{\"ok\":false, \"err\":\"Bad item\"}");
+  }
+}
+
+static void cmdSurvey(JsonDocument &doc) {
+  // Generated on board: {"t":"lawn"|"spiral","sp":m,"hdg":deg,"speed":us} and
+  // either "lat","lng","w","l" (rectangle, l along hdg) or "poly":[[lat,lng],...]
+  SurveyType type = strcmp(doc["t"] | "lawn", "spiral") == 0 ? SURVEY_SPIRAL : SURVEY_LAWNMOWER;
+  float spacing = doc["sp"] | 0.0f;
+  float heading = doc["hdg"] | 0.0f;
+  SurveyPattern pattern;
+  NavFrame anchor;
+  bool ok = false;
+  JsonArrayConst poly = doc["poly"].as<JsonArrayConst>();
+  if (!poly.isNull() && poly.size() >= 3 && poly.size() <= SURVEY_MAX_VERTICES) {
+      NavVector vertices[SURVEY_MAX_VERTICES];
+      uint8_t count = 0;
+      NavFrame_init(&anchor, NavFrame_toE7(poly[0][0].as<double>()), NavFrame_toE7(poly[0][1].as<double>()));
+      for (JsonArrayConst v : poly) {
+          vertices[count++] = NavFrame_toLocal(&anchor, NavFrame_toE7(v[0].as<double>()),
+                                               NavFrame_toE7(v[1].as<double>()));
+      }
+      ok = SurveyPattern_initPolygon(&pattern, type, vertices, count, spacing, heading);
+  } else if (!doc["lat"].isNull() && !doc["lng"].isNull()) {
+      NavFrame_init(&anchor, NavFrame_toE7(doc["lat"].as<double>()), NavFrame_toE7(doc["lng"].as<double>()));
+      NavVector center = {0.0f, 0.0f};
+      ok = SurveyPattern_initRect(&pattern, type, center, doc["w"] | 0.0f, doc["l"] | 0.0f, spacing, heading);
+  }
+  if (ok) {
+      NavigationManager::getInstance().startSurvey(pattern, anchor.originLat, anchor.originLng,
+                                                   doc["speed"] | WAYPOINT_DEFAULT_SPEED);
+      commandOut->println("{\"ok\":true, \"msg\":\"Survey Started\"}");
+  } else {
+      commandOut->println("{\"ok\":false, \"err\":\"Bad survey\"}");
+  }
+}
+
+static void cmdFenceAdd(JsonDocument &doc) {
+  // {"t":"in"|"out","poly":[[lat,lng],...]} (3-32 vertices)
+  GeofenceType type = strcmp(doc["t"] | "in", "out") == 0 ? GEOFENCE_EXCLUSION : GEOFENCE_INCLUSION;
+  JsonArrayConst poly = doc["poly"].as<JsonArrayConst>();
+  int32_t lat[GEOFENCE_MAX_VERTICES], lng[GEOFENCE_MAX_VERTICES];
+  uint8_t count = 0;
+  for (JsonArrayConst v : poly) {
+    if (count >= GEOFENCE_MAX_VERTICES) {
+      count = 0; // Too many: refused below
+      break;
+    }
+    lat[count] = NavFrame_toE7(v[0].as<double>());
+    lng[count] = NavFrame_toE7(v[1].as<double>());
+    count++;
+  }
+  portENTER_CRITICAL(&geofenceMux);
+  bool ok = Geofence_addPolygon(&geofence, type, lat, lng, count);
+  portEXIT_CRITICAL(&geofenceMux);
+  if (ok && saveGeofence()) {
+    commandOut->printf("{\"ok\":true, \"n\":%u}\n", geofence.polygonCount);
+  } else {
+    commandOut->println("{\"ok\":false, \"err\":\"Bad fence\"}");
+  }
+}
+
+static void cmdFenceDist(JsonDocument &doc) {
+  float meters = doc["m"] | 0.0f;
+  portENTER_CRITICAL(&geofenceMux);
+  Geofence_setMaxDistance(&geofence, meters);
+  portEXIT_CRITICAL(&geofenceMux);
+  ConfigManager::setFloat(GEOFENCE_DIST_KEY, geofence.maxDistance);
+  commandOut->println("{\"ok\":true}");
+}
+
+static void cmdFenceClear(JsonDocument &doc) {
+  portENTER_CRITICAL(&geofenceMux);
+  Geofence_clearPolygons(&geofence);
+  portEXIT_CRITICAL(&geofenceMux);
+  saveGeofence();
+  commandOut->println("{\"ok\":true}");
+}
+
+static void cmdGetFence(JsonDocument &doc) {
+  JsonDocument res(&commandArena);
+  res["c"] = "get_fence";
+  res["n"] = geofence.polygonCount;
+  res["dist"] = geofence.maxDistance;
+  res["breach"] = (int)geofenceResult;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+/**
+ * Restore the no-go map at boot (empty if none was stored)
+ */
+void loadOccupancyGrid() {
+  OccupancyGridRecord record;
+  if (ConfigManager::loadBlob(OCC_GRID_NVS_KEY, &record, sizeof(record)) != sizeof(record) ||
+      !OccupancyGrid_load(&occGrid, &record))
+    OccupancyGrid_init(&occGrid);
+}
+
+/**
+ * Route every mission leg that crosses a no-go cell around it (comms task)
+ *
+ * Walks the position items in order, the first leg starting at the
+ * current GPS fix (if any), and inserts the planner's turn points as
+ * waypoints in front of the item they lead to, at its altitude and
+ * speed. Legs already clear are left alone, so planning twice changes
+ * nothing. JUMP and RTL legs are not checked. Not while a mission runs:
+ * inserting moves the items under the control task.
+ * @param added Waypoints inserted
+ * @param item Item whose leg failed, on failure
+ * @return PLAN_OK / PLAN_DIRECT, or why a leg has no route
+ */
+PlanResult planMission(uint16_t *added, uint16_t *item) {
+  WaypointManager &wpm = WaypointManager::getInstance();
+  NavigationManager &nav = NavigationManager::getInstance();
+  *added = 0;
+  *item = 0;
+  if (!occGrid.anchored || occGrid.blocked == 0)
+    return PLAN_DIRECT;
+
+  NavVector from = {0.0f, 0.0f};
+  bool haveFrom = false;
+  if (nav.isGPSLocked()) {
+    int32_t lat, lng;
+    nav.getGPSLocationE7(lat, lng);
+    from = OccupancyGrid_toLocal(&occGrid, lat, lng);
+    haveFrom = true;
+  }
+  PlanResult result = PLAN_DIRECT;
+  for (uint16_t i = 0; i < wpm.getWaypointCount(); i++) {
+    if (!MissionItem_isPosition(wpm.getCommand(i)))
+      continue;
+    NavVector to = OccupancyGrid_toLocal(&occGrid, wpm.getLatE7(i), wpm.getLngE7(i));
+    if (haveFrom) {
+      NavVector points[PLANNER_MAX_POINTS];
+      uint8_t count;
+      PlanResult r = PathPlanner_plan(&pathPlanner, &occGrid, from, to, points, &count);
+      if (r > PLAN_OK) {
+        *item = i;
+        return r;
+      }
+      if (r == PLAN_OK)
+        result = PLAN_OK;
+      WaypointRecord detour = {};
+      detour.cmd = MISSION_CMD_WAYPOINT;
+      detour.alt = (int16_t)lroundf(wpm.getAlt(i) * 10.0f);
+      detour.param = wpm.getCommand(i) == MISSION_CMD_WAYPOINT ? wpm.getParam(i) : 0;
+      for (uint8_t k = 0; k < count; k++, i++) {
+        int32_t lat, lng;   // Not through pointers into the packed record
+        NavFrame_toGlobal(&occGrid.frame, points[k], &lat, &lng);
+        detour.lat = lat;
+        detour.lng = lng;
+        if (!wpm.insertItem(i, detour)) {
+          *item = i;
+          return PLAN_TOO_MANY_POINTS;    // Mission store full
+        }
+        (*added)++;
+      }
+    }
+    from = to;
+    haveFrom = true;
+  }
+  return result;
+}
+
+static void replyMap(const char *name, bool ok, int row) {
+  JsonDocument res(&commandArena);
+  res["c"] = name;
+  res["ok"] = ok;
+  res["anchored"] = occGrid.anchored;
+  res["lat"] = occGrid.map.originLat / (double)NAV_FRAME_E7;
+  res["lng"] = occGrid.map.originLng / (double)NAV_FRAME_E7;
+  res["cell"] = occGrid.map.cellM;
+  res["dim"] = OCC_GRID_DIM;
+  res["blocked"] = occGrid.blocked;
+  if (row >= 0 && row < OCC_GRID_DIM) {
+    uint8_t bytes[OCC_GRID_ROW_BYTES];
+    char hex[2 * OCC_GRID_ROW_BYTES + 1];
+    OccupancyGrid_getRow(&occGrid, row, bytes);
+    for (int i = 0; i < OCC_GRID_ROW_BYTES; i++)
+      snprintf(hex + 2 * i, 3, "%02x", bytes[i]);
+    res["r"] = row;
+    res["hex"] = hex;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdMapSet(JsonDocument &doc) {
+  // One edit per message, stored at once:
+  //   {"c":"map_set","cell":2[,"lat":..,"lng":..]}  new clear map around
+  //                                                 the point (default home)
+  //   {"c":"map_set","clear":true}                   free every cell
+  //   {"c":"map_set","poly":[[lat,lng],...],"v":true} block (v false: free)
+  //                                                 the cells inside
+  //   {"c":"map_set","r":12,"hex":"00ff.."}          one row, bit 0 = west
+  bool ok = false;
+  if (!doc["cell"].isNull()) {
+    float lat, lng;
+    bool home = WaypointManager::getInstance().getHome(lat, lng);
+    if (!doc["lat"].isNull() && !doc["lng"].isNull()) {
+      OccupancyGrid_anchor(&occGrid, NavFrame_toE7(doc["lat"].as<double>()),
+                           NavFrame_toE7(doc["lng"].as<double>()), doc["cell"] | 0.0f);
+      ok = true;
+    } else if (home) {
+      OccupancyGrid_anchor(&occGrid, NavFrame_toE7(lat), NavFrame_toE7(lng), doc["cell"] | 0.0f);
+      ok = true;
+    }
+  } else if (doc["clear"] | false) {
+    OccupancyGrid_clear(&occGrid);
+    ok = true;
+  } else if (!doc["poly"].isNull()) {
+    JsonArrayConst poly = doc["poly"].as<JsonArrayConst>();
+    NavVector vertices[OCC_GRID_MAX_POLYGON];
+    uint8_t count = 0;
+    for (JsonArrayConst v : poly) {
+      if (count == OCC_GRID_MAX_POLYGON) {
+        count = 0;  // Too many: rejected below
+        break;
+      }
+      vertices[count++] = OccupancyGrid_toLocal(&occGrid, NavFrame_toE7(v[0].as<double>()),
+                                                NavFrame_toE7(v[1].as<double>()));
+    }
+    ok = OccupancyGrid_fillPolygon(&occGrid, vertices, count, doc["v"] | true) >= 0;
+  } else if (!doc["r"].isNull()) {
+    uint8_t bytes[OCC_GRID_ROW_BYTES];
+    ok = parseHexBytes(doc["hex"] | "", bytes, sizeof(bytes)) &&
+         OccupancyGrid_setRow(&occGrid, doc["r"] | -1, bytes);
+  }
+  if (ok)
+    ok = ConfigManager::saveBlob(OCC_GRID_NVS_KEY, &occGrid.map, sizeof(occGrid.map));
+  replyMap("map_set", ok, -1);
+}
+
+static void cmdGetMap(JsonDocument &doc) {
+  // {"c":"get_map"[,"r":12]}: the map, with one row as hex when asked
+  replyMap("get_map", true, doc["r"] | -1);
+}
+
+static void cmdPlanMission(JsonDocument &doc) {
+  // {"c":"plan_mission"}: route the stored mission around the map now
+  // (start_mission does the same on its own)
+  if (NavigationManager::getInstance().getState().isMissionActive) {
+    commandOut->println("{\"ok\":false, \"err\":\"Mission running\"}");
+    return;
+  }
+  uint16_t added = 0, item = 0;
+  uint32_t startUs = HAL_GetMicros();
+  PlanResult plan = planMission(&added, &item);
+  uint32_t us = HAL_GetMicros() - startUs;
+  JsonDocument res(&commandArena);
+  res["c"] = "plan_mission";
+  res["ok"] = plan <= PLAN_OK;
+  res["res"] = PathPlanner_resultName(plan);
+  res["added"] = added;
+  if (plan > PLAN_OK)
+    res["item"] = item;
+  res["n"] = WaypointManager::getInstance().getWaypointCount();
+  res["us"] = us;
+  res["expanded"] = pathPlanner.expanded;
+  res["peak"] = pathPlanner.openPeak;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetVehicle(JsonDocument &doc) {
+  // {"c":"set_vehicle","type":"rover"}: stored, applied on the next boot
+#if defined(VEHICLE_TYPE_FIXED)
+  commandOut->println("{\"ok\":false, \"err\":\"Vehicle fixed by build\"}");
+#else
+  VehicleType type;
+  if (!VehicleRegistry_parse(doc["type"] | "", &type)) {
+    commandOut->println("{\"ok\":false, \"err\":\"Unknown vehicle\"}");
+  } else {
+    VehicleRegistry_saveType(type);
+    commandOut->println("{\"ok\":true, \"reboot\":true}");
+  }
+#endif
+}
+
+static void cmdGetHw(JsonDocument &doc) {
+  // Outputs of the running vehicle (freq / res 0 = driver default)
+  const PinMapProfile &hw = vehicle->getHardware();
+  JsonDocument res(&commandArena);
+  res["c"] = "get_hw";
+  res["vehicle"] = vehicle->getName();
+  JsonArray arr = res["out"].to<JsonArray>();
+  for (uint8_t i = 0; i < hw.count; i++) {
+    JsonObject o = arr.add<JsonObject>();
+    o["pin"] = hw.outputs[i].pin;
+    o["dir1"] = hw.outputs[i].dir1;
+    o["dir2"] = hw.outputs[i].dir2;
+    o["freq"] = hw.outputs[i].frequency;
+    o["res"] = hw.outputs[i].resolution;
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetHw(JsonDocument &doc) {
+  // {"c":"set_hw","out":0,"pin":26,"dir1":27,"dir2":14,"freq":20000,"res":10}
+  // or {"c":"set_hw","reset":true}; stored, applied on the next boot
+  if (doc["reset"] | false) {
+    ConfigManager::resetHardwareProfile(vehicle->getName());
+    commandOut->println("{\"ok\":true, \"reboot\":true}");
+  } else {
+    PinMapProfile hw = vehicle->getHardware();
+    int out = doc["out"] | -1;
+    if (out < 0 || out >= hw.count) {
+      commandOut->println("{\"ok\":false, \"err\":\"Bad output\"}");
+    } else {
+      PinMapOutput &o = hw.outputs[out];
+      o.pin = doc["pin"] | o.pin;
+      o.dir1 = doc["dir1"] | o.dir1;
+      o.dir2 = doc["dir2"] | o.dir2;
+      o.frequency = doc["freq"] | o.frequency;
+      o.resolution = doc["res"] | o.resolution;
+      uint8_t badOutput = 0;
+      int8_t badPin = -1;
+      PinMapError err = PinMap_validate(&hw, &badOutput, &badPin);
+      if (err != PINMAP_OK) {
+        JsonDocument res(&commandArena);
+        res["ok"] = false;
+        res["err"] = PinMap_errorName(err);
+        res["out"] = badOutput;
+        res["pin"] = badPin;
+        const char *owner = PinMap_reservedBy(badPin);
+        if (owner) res["owner"] = owner;
+        serializeJson(res, *commandOut);
+        commandOut->println();
+      } else {
+        ConfigManager::saveHardwareProfile(vehicle->getName(), hw);
+        commandOut->println("{\"ok\":true, \"reboot\":true}");
+      }
+    }
+  }
+}
+
+static void loadThrustConfig(ThrustConfig &config) {
+  if (ConfigManager::loadBlob(THRUST_CONFIG_KEY, &config, sizeof(config)) != sizeof(config) ||
+      !ThrustAllocator_sanitize(&config))
+    ThrustAllocator_defaultConfig(&config);
+}
+
+static void cmdGetThrusters(JsonDocument &doc) {
+  // Sub thruster geometry and the allocation it gives (stored config,
+  // which the running vehicle uses after a reboot)
+  ThrustConfig config;
+  loadThrustConfig(config);
+  ThrustAllocator alloc;
+  ThrustAllocator_init(&alloc, &config);
+  JsonDocument res(&commandArena);
+  res["c"] = "get_thrusters";
+  res["rank"] = alloc.rank;
+  res["axes"] = alloc.axisMask;
+  JsonArray arr = res["t"].to<JsonArray>();
+  for (uint8_t i = 0; i < config.count; i++) {
+    const ThrusterGeometry &t = config.thrusters[i];
+    JsonObject o = arr.add<JsonObject>();
+    o["x"] = t.x;
+    o["y"] = t.y;
+    o["z"] = t.z;
+    o["dx"] = t.dx;
+    o["dy"] = t.dy;
+    o["dz"] = t.dz;
+    JsonArray k = o["k"].to<JsonArray>();
+    for (uint8_t a = 0; a < MIXER_AXIS_COUNT; a++) k.add(alloc.alloc[i][a]);
+  }
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdSetThruster(JsonDocument &doc) {
+  // {"c":"set_thruster","n":6} thruster count,
+  // {"c":"set_thruster","i":2,"x":0.1,"y":-0.2,"z":0,"dx":0,"dy":0,"dz":-1}
+  // or {"c":"set_thruster","reset":true}; stored, applied on the next boot
+  if (doc["reset"] | false) {
+    ConfigManager::removeKey(THRUST_CONFIG_KEY);
+    commandOut->println("{\"ok\":true, \"reboot\":true}");
+    return;
+  }
+  ThrustConfig config;
+  loadThrustConfig(config);
+  int n = doc["n"] | (int)config.count;
+  int i = doc["i"] | -1;
+  if (n < 1 || n > THRUST_MAX_THRUSTERS || i >= n) {
+    commandOut->println("{\"ok\":false, \"err\":\"Bad thruster\"}");
+    return;
+  }
+  for (int j = config.count; j < n; j++) {
+    config.thrusters[j] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};   // Until set
+  }
+  config.count = n;
+  if (i >= 0) {
+    ThrusterGeometry &t = config.thrusters[i];
+    t.x = doc["x"] | t.x;
+    t.y = doc["y"] | t.y;
+    t.z = doc["z"] | t.z;
+    t.dx = doc["dx"] | t.dx;
+    t.dy = doc["dy"] | t.dy;
+    t.dz = doc["dz"] | t.dz;
+  }
+  ThrustAllocator alloc;
+  if (!ThrustAllocator_sanitize(&config) || !ThrustAllocator_init(&alloc, &config)) {
+    commandOut->println("{\"ok\":false, \"err\":\"Bad geometry\"}");
+    return;
+  }
+  ConfigManager::saveBlob(THRUST_CONFIG_KEY, &config, sizeof(config));
+  JsonDocument res(&commandArena);
+  res["ok"] = true;
+  res["reboot"] = true;
+  res["rank"] = alloc.rank;
+  res["axes"] = alloc.axisMask;
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+static void cmdStickCurve(JsonDocument &doc) {
+  // {"c":"stick_curve","axis":1,"expo":30,"rate":100}, axis 0-3 = T/R/P/Y
+  int axis = doc["axis"] | -1;
+  if (!joystickCalibrator || axis < 0 || axis >= JOYSTICK_AXES) {
+    commandOut->println("{\"ok\":false, \"err\":\"Bad axis\"}");
+  } else {
+    joystickCalibrator->setCurve((JoystickCalibrator::CalibrationAxis)axis,
+                                 doc["expo"] | 0, doc["rate"] | 100);
+    commandOut->println("{\"ok\":true}");
+  }
+}
+
+static void cmdStartMission(JsonDocument &doc) {
+    // Already running: its legs were routed when it started
+    uint16_t added = 0, item = 0;
+    PlanResult plan = NavigationManager::getInstance().getState().isMissionActive
+                          ? PLAN_DIRECT : planMission(&added, &item);
+    if (plan > PLAN_OK) {
+        commandOut->printf("{\"ok\":false, \"msg\":\"No route\", \"plan\":\"%s\", \"item\":%u}\n",
+                      PathPlanner_resultName(plan), item);
+    } else if (WaypointManager::getInstance().getWaypointCount() > 0) {
+        NavigationManager::getInstance().startMission();
+        commandOut->println("{\"ok\":true, \"msg\":\"Mission Started\"}");
+    } else {
+        commandOut->println("{\"ok\":false, \"msg\":\"No Waypoints\"}");
+    }
+}
+
+static void cmdStopMission(JsonDocument &doc) {
+    NavigationManager::getInstance().stopMission();
+    commandOut->println("{\"ok\":true}");
+}
+
+static void cmdClearMission(JsonDocument &doc) {
+    WaypointManager::getInstance().clearMission();
+    NavigationManager::getInstance().stopMission();
+    commandOut->println("{\"ok\":true}");
+}
+
+static int missionLibrarySlot(JsonDocument &doc) {
+    // {"id":3} or {"name":"harbour"}
+    const MissionLibraryIndex *index = MissionLibrary_getIndex();
+    if (!doc["name"].isNull())
+        return MissionLibrary_find(index, doc["name"] | "");
+    int id = doc["id"] | -1;
+    return id >= 0 && id < index->slotCount && index->slots[id].used ? id : -1;
+}
+
+static void cmdSaveMission(JsonDocument &doc) {
+    // {"c":"save_mission","name":"harbour"}: the current mission into the
+    // library, replacing a mission of that name
+    WaypointRecord *records = (WaypointRecord *)MemPlacement_alloc(
+        "mission_library", MAX_WAYPOINTS * sizeof(WaypointRecord), MEM_CLASS_BULK);
+    if (!records) {
+        commandOut->println("{\"ok\":false, \"err\":\"No memory\"}");
+        return;
+    }
+    uint16_t count = 0;
+    if (!WaypointManager::getInstance().copyRecords(records, &count)) {
+        MemPlacement_free(records);
+        commandOut->println("{\"ok\":false, \"err\":\"Upload pending\"}");
+        return;
+    }
+    uint8_t slot = 0;
+    MissionLibraryStatus status = MissionLibrary_save(doc["name"] | "", records, count, &slot);
+    MemPlacement_free(records);
+
+    JsonDocument res(&commandArena);
+    res["c"] = "save_mission";
+    res["ok"] = status == MISSION_LIBRARY_OK;
+    res["res"] = MissionLibrary_statusName(status);
+    if (status == MISSION_LIBRARY_OK) {
+        res["id"] = slot;
+        res["n"] = count;
+    }
+    serializeJson(res, *commandOut);
+    commandOut->println();
+}
+
+static void cmdLoadMission(JsonDocument &doc) {
+    // {"c":"load_mission","id":3}: stream a stored mission through the bulk
+    // upload path; the control task swaps it in, update() persists it
+    if (NavigationManager::getInstance().getState().isMissionActive) {
+        commandOut->println("{\"ok\":false, \"err\":\"Mission running\"}");
+        return;
+    }
+    int slot = missionLibrarySlot(doc);
+    const MissionLibraryIndex *index = MissionLibrary_getIndex();
+    MissionLibraryStatus lib = slot < 0 ? MISSION_LIBRARY_NOT_FOUND : MISSION_LIBRARY_OK;
+    MissionUploadStatus status = MISSION_UPLOAD_OK;
+    if (lib == MISSION_LIBRARY_OK) {
+        WaypointManager &wpm = WaypointManager::getInstance();
+        const MissionLibraryEntry &entry = index->slots[slot];
+        status = wpm.beginUpload(entry.count, entry.crc);
+        WaypointRecord chunk[HOST_MISSION_CHUNK_MAX];
+        for (uint16_t first = 0; status == MISSION_UPLOAD_OK && first < entry.count;) {
+            uint16_t n = entry.count - first;
+            if (n > HOST_MISSION_CHUNK_MAX)
+                n = HOST_MISSION_CHUNK_MAX;
+            lib = MissionLibrary_read(slot, first, chunk, n);
+            if (lib != MISSION_LIBRARY_OK)
+                break;
+            status = wpm.uploadChunk(first, chunk, n);
+            first += n;
+        }
+        // An unfinished upload is dropped by the next beginUpload()
+        if (lib == MISSION_LIBRARY_OK && status == MISSION_UPLOAD_OK)
+            status = wpm.finishUpload();
+    }
+
+    JsonDocument res(&commandArena);
+    res["c"] = "load_mission";
+    res["ok"] = lib == MISSION_LIBRARY_OK && status == MISSION_UPLOAD_OK;
+    res["res"] = MissionLibrary_statusName(lib);
+    res["upload"] = (int)status;
+    if (slot >= 0) {
+        res["id"] = slot;
+        res["name"] = index->slots[slot].name;
+        res["n"] = index->slots[slot].count;
+    }
+    serializeJson(res, *commandOut);
+    commandOut->println();
+}
+
+static void cmdListMissions(JsonDocument &doc) {
+    // Rows of [id, name, items, crc]
+    const MissionLibraryIndex *index = MissionLibrary_getIndex();
+    JsonDocument res(&commandArena);
+    res["c"] = "list_missions";
+    res["slots"] = index->slotCount;
+    JsonArray arr = res["missions"].to<JsonArray>();
+    for (uint8_t i = 0; i < index->slotCount; i++) {
+        const MissionLibraryEntry &entry = index->slots[i];
+        if (!entry.used)
+            continue;
+        JsonArray row = arr.add<JsonArray>();
+        row.add(i);
+        row.add(entry.name);
+        row.add(entry.count);
+        row.add(entry.crc);
+    }
+    serializeJson(res, *commandOut);
+    commandOut->println();
+}
+
+static void cmdDeleteMission(JsonDocument &doc) {
+    int slot = missionLibrarySlot(doc);
+    MissionLibraryStatus status =
+        slot < 0 ? MISSION_LIBRARY_NOT_FOUND : MissionLibrary_remove((uint8_t)slot);
+    commandOut->printf("{\"ok\":%s, \"res\":\"%s\"}\n",
+                  status == MISSION_LIBRARY_OK ? "true" : "false",
+                  MissionLibrary_statusName(status));
+}
+
+static void cmdRtl(JsonDocument &doc) {
+    NavigationManager::getInstance().executeRTL();
+    commandOut->println("{\"ok\":true}");
+}
+
+static void cmdSetDepth(JsonDocument &doc) {
+#if !FEATURE_DEPTH
+    commandOut->println("{\"ok\":false, \"err\":\"No depth sensor in this build\"}");
+#else
+    if (!doc["osr"].isNull() &&
+        !DepthManager::getInstance().setOversampling(doc["osr"].as<uint16_t>())) {
+        commandOut->println("{\"ok\":false, \"err\":\"Bad OSR\"}");
+    } else if (!doc["kp"].isNull() || !doc["ki"].isNull() || !doc["kd"].isNull()) {
+        // Retune the depth PID (bumpless)
+        const PIDGains& g = DepthManager::getInstance().getPID();
+        DepthManager::getInstance().setPID(doc["kp"] | g.kp, doc["ki"] | g.ki, doc["kd"] | g.kd);
+        commandOut->println("{\"ok\":true}");
+    } else if (!doc["d"].isNull()) {
+        DepthManager::getInstance().setTargetDepth(doc["d"]);
+        DepthManager::getInstance().setDiving(true);
+        commandOut->println("{\"ok\":true}");
+    } else if (!doc["osr"].isNull()) {
+        commandOut->println("{\"ok\":true}");
+    }
+#endif
+}
+
+static void cmdKxInit(JsonDocument &doc) {
+    // Phase 2: Secure Serial Handshake (Step 1: Generate & Send PubKey)
+    // Optional "curve": "x25519" (32-byte key), P-256 otherwise
+    KeyExchangeManager& kx = KeyExchangeManager::getInstance();
+    const char* curve = doc["curve"] | "p256";
+    kx.setCurve(strcmp(curve, "x25519") == 0 ? KX_CURVE_X25519 : KX_CURVE_P256);
+    if (kx.generateKeyPair()) {
+        uint8_t pubKey[64];
+        size_t pubLen = KeyExchangeManager::getPublicKeySize(kx.getCurve());
+        kx.getPublicKey(pubKey);
+        
+        char b64PubKey[128];
+        size_t b64Len = 0;
+        mbedtls_base64_encode((unsigned char*)b64PubKey, sizeof(b64PubKey), &b64Len, pubKey, pubLen);
+        
+        JsonDocument res(&commandArena);
+        res["c"] = "kx_init";
+        res["ok"] = true;
+        res["curve"] = kx.getCurve() == KX_CURVE_X25519 ? "x25519" : "p256";
+        res["pub"] = b64PubKey;
+        serializeJson(res, *commandOut);
+        commandOut->println();
+    } else {
+        commandOut->println("{\"ok\":false, \"err\":\"KeyGen Failed\"}");
+    }
+}
+
+static void cmdKxFin(JsonDocument &doc) {
+    // Phase 2: Secure Serial Handshake (Step 2: Receive Peer Key & Compute Secret)
+    const char* peerKeyB64 = doc["pub"];
+    if (peerKeyB64) {
+        uint8_t peerPubKey[64];
+        size_t decodedLen = 0;
+        int ret = mbedtls_base64_decode(peerPubKey, sizeof(peerPubKey), &decodedLen, (const unsigned char*)peerKeyB64, strlen(peerKeyB64));
+        
+        size_t pubLen = KeyExchangeManager::getPublicKeySize(
+            KeyExchangeManager::getInstance().getCurve());
+        if (ret == 0 && decodedLen == pubLen) {
+            if (KeyExchangeManager::getInstance().computeSharedSecret(peerPubKey)) {
+                uint8_t secret[32];
+                KeyExchangeManager::getInstance().getSharedSecret(secret);
+                
+                EncryptionManager_init(secret);
+                HMACValidator_init(secret);
+                resetPeerSessions();
+                
+                commandOut->println("{\"ok\":true, \"msg\":\"KX Complete\"}");
+            } else {
+                commandOut->println("{\"ok\":false, \"err\":\"Compute Failed\"}");
+            }
+        } else {
+            commandOut->println("{\"ok\":false, \"err\":\"B64 Decode Failed\"}");
+        }
+    }
+}
+
+static void cmdKxBench(JsonDocument &doc) {
+    // Full local exchange per curve (keygen x2 + secret), microseconds
+    KeyExchangeManager& kx = KeyExchangeManager::getInstance();
+    JsonDocument res(&commandArena);
+    res["c"] = "kx_bench";
+    res["p256_us"] = kx.benchmark(KX_CURVE_P256);
+    res["x25519_us"] = kx.benchmark(KX_CURVE_X25519);
+    serializeJson(res, *commandOut);
+    commandOut->println();
+}
+
+static void cmdGetCmdStats(JsonDocument &doc) {
+  // Per command: calls, rejected (rate limit / auth), mean and max handler us
+  JsonDocument res(&commandArena);
+  res["c"] = "get_cmd_stats";
+  res["unknown"] = commandRouter.unknown;
+  JsonObject cmds = res["cmds"].to<JsonObject>();
+  for (uint8_t i = 0; i < commandRouter.count; i++) {
+    const CommandStats &st = commandRouter.stats[i];
+    if (st.calls == 0 && st.rejected == 0)
+      continue;
+    JsonArray row = cmds[commandRouter.specs[i].name].to<JsonArray>();
+    row.add(st.calls);
+    row.add(st.rejected);
+    row.add(st.calls ? st.totalUs / st.calls : 0);
+    row.add(st.maxUs);
+  }
+  if (doc["reset"] | false)
+    memset(commandRouter.stats, 0, sizeof(commandRouter.stats));
+  serializeJson(res, *commandOut);
+  commandOut->println();
+}
+
+// Serial command table: name, handler, rate class, auth. Dispatched by
+// name hash (CommandRouter), so the order is free; add commands here
+static constexpr CommandSpec SERIAL_COMMANDS[] = {
+    {"sm",                  cmdSm,                RATE_CLASS_CONTROL, COMMAND_AUTH_NONE, "t s p y"},
+    {"ping",                cmdPing,              RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "bin"},
+    {"get_security_config", cmdGetSecurityConfig, RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_security_config", cmdSetSecurityConfig, RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "encryption_enabled hmac_enabled rate_limit_enabled rate_limit_cps shared_secret"},
+    {"cfg_hash",            cmdCfgHash,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"cfg_sync",            cmdCfgSync,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "h have"},
+#if FEATURE_OTA
+    {"start_ota_update",    cmdStartOtaUpdate,    RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "url sha sig"},
+    {"check_ota",           cmdCheckOta,          RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "url install"},
+    {"get_ota_progress",    cmdGetOtaProgress,    RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_ota_key",         cmdSetOtaKey,         RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC, "key"},
+    {"get_ota_stats",       cmdGetOtaStats,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"fleet_ota",           cmdFleetOta,          RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "listen send"},
+#endif
+    {"get_perf",            cmdGetPerf,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "reset"},
+    {"get_prof",            cmdGetProf,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "reset"},
+    {"get_tasks",           cmdGetTasks,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_jobs",            cmdGetJobs,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "reset"},
+    {"get_watchdog",        cmdGetWatchdog,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_boot",            cmdGetBoot,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_alloc",           cmdGetAlloc,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "reset"},
+    {"trace_dump",          cmdTraceDump,         RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+#if FEATURE_WEB
+    {"get_ws_stats",        cmdGetWsStats,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+#endif
+    {"set_tx_route",        cmdSetTxRoute,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "uni rate mcs"},
+    {"set_wifi",            cmdSetWifi,           RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "mode ch ssid pass tx lowlat"},
+    {"get_wifi",            cmdGetWifi,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+#if FEATURE_BLE
+    {"set_ble",             cmdSetBle,            RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC, "on"},
+    {"get_ble",             cmdGetBle,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+#endif
+    {"get_tx_stats",        cmdGetTxStats,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_link",            cmdGetLink,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_mavlink",         cmdGetMavlink,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_ccmp",            cmdSetCcmp,           RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC, "on"},
+    {"set_streams",         cmdSetStreams,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on radio serial hz prio"},
+    {"get_streams",         cmdGetStreams,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_trend",           cmdSetTrend,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "on win"},
+    {"get_trend",           cmdGetTrend,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_replay",          cmdGetReplay,         RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_peers",           cmdGetPeers,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_formation",       cmdSetFormation,      RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on group hz budget"},
+    {"follow",              cmdFollow,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on mac right back lead speed"},
+    {"get_formation",       cmdGetFormation,      RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_rtk",             cmdSetRtk,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "mode"},
+    {"get_rtk",             cmdGetRtk,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_latency",         cmdSetLatency,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "reset on"},
+    {"get_latency",         cmdGetLatency,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_input",           cmdSetInput,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "mode gap cutoff"},
+    {"get_input",           cmdGetInput,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_rc",              cmdSetRc,             RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "proto on map rev auto center tele"},
+    {"get_rc",              cmdGetRc,             RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_arbiter",         cmdSetArbiter,        RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "mode timeout"},
+    {"get_arbiter",         cmdGetArbiter,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_pm",              cmdSetPm,             RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "on sleep mhz idle"},
+    {"get_pm",              cmdGetPm,             RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_gyro_filter",     cmdSetGyroFilter,     RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "lpf order notch q"},
+    {"get_gyro_filter",     cmdGetGyroFilter,     RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_dyn_notch",       cmdSetDynNotch,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on min max q"},
+    {"get_dyn_notch",       cmdGetDynNotch,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_rpm_filter",      cmdSetRpmFilter,      RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on harmonics min q poles"},
+    {"get_esc",             cmdGetEsc,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_fbw",             cmdSetFbw,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on bank pitch angle roll_rate pitch_rate p i d ff cruise rudder_mix turn_yaw slew"},
+    {"set_tecs",            cmdSetTecs,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on tc climb sink accel vmin vmax w trim thr_p thr_i thr_ff thr_imax pitch_p pitch_i "
+     "pitch_imax pitch_max pitch_min"},
+    {"set_alt",             cmdSetAlt,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on kp climb sink rate_p rate_i imax hover dz zero"},
+    {"set_thrust",          cmdSetThrust,         RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "lin expo vcomp ref boost tc"},
+    {"set_odom",            cmdSetOdom,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on cpr wheel track vmax p i ff hz"},
+    {"set_range",           cmdSetRange,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on slow stop"},
+    {"get_range",           cmdGetRange,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"motor_cal",           cmdMotorCal,          RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC, "m stop"},
+    {"set_motor_trim",      cmdSetMotorTrim,      RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "m min db clear"},
+    {"set_aux",             cmdSetAux,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "ch us"},
+    {"get_blackbox",        cmdGetBlackbox,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_i2c",             cmdGetI2c,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_imu",             cmdGetImu,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"cal_imu",             cmdCalImu,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "level reset"},
+    {"set_mag",             cmdSetMag,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "on learn decl reset"},
+    {"get_mag",             cmdGetMag,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_att",             cmdGetAtt,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_batt",            cmdGetBatt,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_power",           cmdSetPower,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "offset gain cap reserve margin"},
+    {"get_power",           cmdGetPower,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_gps",             cmdGetGps,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_pwm",             cmdGetPwm,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_pid",             cmdSetPid,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "kp ki kd"},
+    {"set_nav",             cmdSetNav,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "mode l1 cut prof acc jerk brake corner"},
+    {"upload_wp",           cmdUploadWp,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "lat lng speed alt"},
+    {"upload_item",         cmdUploadItem,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "t lat lng alt d p n"},
+    {"survey",              cmdSurvey,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "t sp hdg poly lat lng w l speed"},
+    {"fence_add",           cmdFenceAdd,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "t poly"},
+    {"fence_dist",          cmdFenceDist,         RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "m"},
+    {"fence_clear",         cmdFenceClear,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_fence",           cmdGetFence,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"map_set",             cmdMapSet,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "cell lat lng clear poly v r hex"},
+    {"get_map",             cmdGetMap,            RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "r"},
+    {"plan_mission",        cmdPlanMission,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_vehicle",         cmdSetVehicle,        RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC, "type"},
+    {"get_hw",              cmdGetHw,             RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_hw",              cmdSetHw,             RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "reset out pin dir1 dir2 freq res"},
+    {"get_thrusters",       cmdGetThrusters,      RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_thruster",        cmdSetThruster,       RATE_CLASS_COMMAND, COMMAND_AUTH_HMAC,
+     "reset n i x y z dx dy dz"},
+    {"stick_curve",         cmdStickCurve,        RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "axis expo rate"},
+    {"start_mission",       cmdStartMission,      RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"stop_mission",        cmdStopMission,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"clear_mission",       cmdClearMission,      RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"save_mission",        cmdSaveMission,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "name"},
+    {"load_mission",        cmdLoadMission,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "id name"},
+    {"list_missions",       cmdListMissions,      RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"delete_mission",      cmdDeleteMission,     RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "id name"},
+    {"rtl",                 cmdRtl,               RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"set_depth",           cmdSetDepth,          RATE_CLASS_COMMAND, COMMAND_AUTH_NONE,
+     "osr kp ki kd d"},
+    {"kx_init",             cmdKxInit,            RATE_CLASS_HANDSHAKE, COMMAND_AUTH_NONE, "curve"},
+    {"kx_fin",              cmdKxFin,             RATE_CLASS_HANDSHAKE, COMMAND_AUTH_NONE, "pub"},
+    {"kx_bench",            cmdKxBench,           RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, ""},
+    {"get_cmd_stats",       cmdGetCmdStats,       RATE_CLASS_COMMAND, COMMAND_AUTH_NONE, "reset"},
+};
+static constexpr uint8_t SERIAL_COMMAND_COUNT =
+    sizeof(SERIAL_COMMANDS) / sizeof(SERIAL_COMMANDS[0]);
+static_assert(CommandRouter_uniqueHashes(SERIAL_COMMANDS, SERIAL_COMMAND_COUNT),
+              "serial command names must hash uniquely");
+
+/**
+ * Parse, check and dispatch one JSON command line; the reply goes to
+ * commandOut
+ */
+void runJsonCommand(char *line, size_t lineLen) {
+  // Every document below lives in the command arena, released on return
+  JsonArenaScope arenaScope(commandArena);
+
+  // Parse from a const view so ArduinoJson copies strings out of the line.
+  // The name is peeked first so only the members the handler reads are
+  // kept; the rest is skipped by the parser
+  char peeked[COMMAND_NAME_MAX];
+  const CommandSpec *filterSpec =
+      CommandRouter_peekName(line, lineLen, peeked, sizeof(peeked))
+          ? CommandRouter_spec(&commandRouter, peeked)
+          : nullptr;
+  JsonDocument filter(&commandArena);
+  bool filtered = CommandRouter_buildFilter(filterSpec, filter);
+  JsonDocument doc(&commandArena);
+  DeserializationError error =
+      filtered ? deserializeJson(doc, (const char *)line, lineLen,
+                                 DeserializationOption::Filter(filter))
+               : deserializeJson(doc, (const char *)line, lineLen);
+  // A repeated "c" can make the peek disagree with the parser: reparse whole
+  if (!error && filtered && strcmp(doc["c"] | "", filterSpec->name) != 0)
+    error = deserializeJson(doc, (const char *)line, lineLen);
+
+  if (error) {
+    JsonDocument errDoc(&commandArena);
+    errDoc["err"] = "JSON parse failed";
+    serializeJson(errDoc, *commandOut);
+    commandOut->println();
+    return;
+  }
+
+  const char *command = doc["c"];
+  if (!command)
+    return;
+
+  // One hash + probe instead of a strcmp chain; unknown names are still
+  // rate limited and count as link activity, as before
+  int index = CommandRouter_find(&commandRouter, command);
+  const CommandSpec *spec = index >= 0 ? &SERIAL_COMMANDS[index] : nullptr;
+
+  // Rate Limiting: stick updates, configuration commands and key exchange
+  // draw from separate class budgets so a command flood cannot stall control
+  RateLimitClass cls = spec ? (RateLimitClass)spec->rateClass : RATE_CLASS_COMMAND;
+  if (RateLimitManager_check(NULL, cls) != RATE_LIMIT_ALLOWED) {
+    CommandRouter_recordReject(&commandRouter, index);
+    JsonDocument errDoc(&commandArena);
+    errDoc["err"] = "Rate limit exceeded";
+    serializeJson(errDoc, *commandOut);
+    commandOut->println();
+    return;
+  }
+
+  // HMAC Validation for JSON: MAC over the raw line minus the "hmac" member,
+  // checked in place (doc already holds its own copy of every string)
+  bool hmacValid = true;
+  bool hasHmac = !doc["hmac"].isNull();
+  if (hasHmac) {
+    hmacValid = HMACValidator_validateJsonLine(line, &lineLen);
+
+    if (!hmacValid) {
+      JsonDocument errDoc(&commandArena);
+      errDoc["err"] = "HMAC validation failed";
+      serializeJson(errDoc, *commandOut);
+      commandOut->println();
+      return;
+    }
+  }
+
+  // Privileged commands must be signed once the link is secured
+  if (spec && spec->auth == COMMAND_AUTH_HMAC && !hasHmac) {
+    if (securityEncryption && securityHmac) {
+      CommandRouter_recordReject(&commandRouter, index);
+      JsonDocument errDoc(&commandArena);
+      errDoc["err"] = "HMAC required";
+      serializeJson(errDoc, *commandOut);
+      commandOut->println();
+      return;
+    }
+  }
+
+  failsafeManager.recordPacketReceived(HAL_GetMillis(), hmacValid);
+
+  if (!spec)
+    return;
+  uint32_t startUs = HAL_GetMicros();
+  spec->handler(doc);
+  CommandRouter_recordCall(&commandRouter, index, HAL_GetMicros() - startUs);
+}
+
+/**
+ * Handle incoming serial commands (JSON via Web Configurator)
+ */
+void handleSerialCommand() {
+  // Complete frames only; a partial one stays in SerialLineReader
+  static uint8_t frame[SERIAL_LINE_MAX];
+  SerialFrameType frameType;
+  size_t frameLen =
+      SerialLineReader_readFrame(frame, sizeof(frame), &frameType);
+  if (frameLen == 0)
+    return;
+  hostActivityMs = HAL_GetMillis();   // A host on the port keeps full clock
+
+  if (frameType == SERIAL_FRAME_BINARY) {
+    handleBinaryFrame(frame, frameLen);
+    return;
+  }
+  if (frameType == SERIAL_FRAME_MAVLINK) {
+    handleMavlinkFrame(frame, frameLen);
+    return;
+  }
+
+  runJsonCommand((char *)frame, frameLen);
+}
+
+#if FEATURE_BLE
+/**
+ * Run the next command line written over BLE, its reply into the BLE
+ * reply buffer; then notify the next chunks of the reply
+ */
+void handleBleCommand() {
+  BleService &ble = BleService::getInstance();
+  static BleCommandLine line; // Comms task only
+  if (ble.takeCommand(line)) {
+    hostActivityMs = HAL_GetMillis();
+    commandOut = &ble.beginReply();
+    runJsonCommand(line.text, line.len);
+    commandOut = &Serial;
+    ble.endReply();
+  }
+  ble.serviceReplies();
+}
+#endif
+
+// ============================================================================
+// Scheduler Tasks (Phase 15)
+// ============================================================================
+
+// Control path: core 1, highest application priority. Outer loop at
+// 50Hz; the task runs at the vehicle's inner rate (RateProfile)
+#define CONTROL_PERIOD_MS 20
+// Background work: core 0, below the Wi-Fi stack
+#define TELEMETRY_PERIOD_MS 50 // 20Hz Telemetry
+#define COMMS_PERIOD_MS 10
+#define SENSOR_PERIOD_MS 10 // Depth poll; OSR 4096 conversion is ~9ms
+#define BLACKBOX_PERIOD_MS 20 // One flash page / erase per tick at most
+#define LOG_PERIOD_MS 10 // ~115 bytes per tick at 115200 baud
+#define NOISE_PERIOD_MS 20 // Gyro spectrum: ~20 samples per tick, FFT every 64
+#define DISPLAY_PERIOD_MS 50 // One OLED piece (<= 64 bytes) per tick at most
+#define DISPLAY_RENDER_MS 500
+
+// UART TX ring for Serial, sized so the log task never waits on it
+#define SERIAL_TX_BUFFER_SIZE 1024
+
+// Telemetry frames and lines go through the log queue whole
+static_assert(HOST_FRAME_MAX_ENCODED <= LOG_SLOT_SIZE, "host frame exceeds a log slot");
+static_assert(sizeof(SERIAL_TELEMETRY_PATTERN) - 1 <= LOG_SLOT_SIZE,
+              "telemetry line exceeds a log slot");
+
+// Position given to NavigationManager this tick (blackbox replay input)
+static int32_t navInputLatE7 = 0;
+static int32_t navInputLngE7 = 0;
+
+/**
+ * One blackbox record of this control tick (control task)
+ * @param pilot Sticks before failsafe / auto, cmd what the vehicle got
+ */
+void logBlackbox(const NAPacket &cmd, const NAPacket &pilot, float heading, bool imuReady,
+                 uint32_t loopCycles) {
+  static const uint32_t cpuMhz = getCpuFrequencyMhz();
+  BlackboxRecord rec = {};
+  rec.timeMs = HAL_GetMillis();
+  rec.sequence = cmd.sequenceNumber;
+  rec.throttle = cmd.throttle;
+  rec.roll = cmd.roll;
+  rec.pitch = cmd.pitch;
+  rec.yaw = cmd.yaw;
+  rec.mode = cmd.mode;
+  rec.failsafe = (uint8_t)failsafeManager.getState();
+  ActuatorOutputsMsg actuators;
+  if (topicActuators.read(actuators))
+    memcpy(rec.outputs, actuators.outputs, sizeof(rec.outputs));
+
+  float roll, pitch, yaw;
+  AttitudeEstimator_getEuler(&attitude, &roll, &pitch, &yaw);
+  rec.attRoll = (int16_t)(roll * RAD_TO_DEG * 100.0f);
+  rec.attPitch = (int16_t)(pitch * RAD_TO_DEG * 100.0f);
+  float cdeg = fmodf(heading, 360.0f) * 100.0f;
+  rec.heading = (uint16_t)(cdeg < 0.0f ? cdeg + 36000.0f : cdeg);
+
+  NavigationState nav;
+  memset(&nav, 0, sizeof(nav));
+  topicNavState.read(nav);
+  float dm = nav.distanceToTarget * 10.0f;
+  rec.navDistance = dm > 65535.0f ? 65535 : (dm > 0.0f ? (uint16_t)dm : 0);
+  rec.waypoint = nav.currentWaypointIndex;
+  DepthMsg depth = {};
+  topicDepth.read(depth);
+  rec.navFlags = (nav.isMissionActive ? BLACKBOX_NAV_MISSION : 0) |
+                 (nav.isRTLActive ? BLACKBOX_NAV_RTL : 0) |
+                 (nav.isLoitering ? BLACKBOX_NAV_LOITER : 0) |
+                 (nav.isSurveyActive ? BLACKBOX_NAV_SURVEY : 0) |
+                 (depth.diving ? BLACKBOX_NAV_DIVING : 0);
+  rec.depth = (int16_t)(depth.depth * 100.0f);
+  BatteryMsg battery = {};
+  topicBattery.read(battery);
+  rec.battery = battery.millivolts;
+  uint32_t loopUs = loopCycles / cpuMhz;
+  rec.loopUs = loopUs > 0xFFFF ? 0xFFFF : (uint16_t)loopUs;
+  int64_t utcUs;
+  if (gpsManager &&
+      (rec.timeSync = gpsManager->toUtc(HAL_Now(), utcUs)) != TIME_SYNC_NONE) {
+    rec.utcS = (uint32_t)(utcUs / 1000000);
+    rec.utcMs = (uint16_t)(utcUs / 1000 % 1000);
+  }
+
+  rec.pilot[0] = pilot.throttle;
+  rec.pilot[1] = pilot.roll;
+  rec.pilot[2] = pilot.pitch;
+  rec.pilot[3] = pilot.yaw;
+  rec.pilotMode = pilot.mode;
+  uint32_t linkAge = failsafeManager.getTimeSinceLastPacket(rec.timeMs);
+  rec.linkAgeMs = linkAge > 0xFFFF ? 0xFFFF : (uint16_t)linkAge;
+  rec.navLat = navInputLatE7;
+  rec.navLng = navInputLngE7;
+  for (int i = 0; i < 3; i++)
+    rec.gyro[i] = (int16_t)constrain(lastGyro[i] * 1000.0f, -32767.0f, 32767.0f);
+  rec.depthTarget = (int16_t)(DepthManager::getInstance().getTargetDepth() * 100.0f);
+  rec.inputs = (NavigationManager::getInstance().isGPSLocked() ? BLACKBOX_IN_GPS : 0) |
+               (imuReady ? BLACKBOX_IN_ATTITUDE : 0);
+  Blackbox_log(&rec);
+}
+
+/**
+ * Control task: failsafe, GPS/navigation, vehicle mixing.
+ * Only this task touches the vehicle and navigation state machine.
+ */
+/**
+ * Take calibration requests from cal_imu, publish the model and hand
+ * it to the comms task for storage when it has moved (control task)
+ */
+void serviceImuCal(uint32_t now) {
+  static uint32_t lastSaveMs = 0;
+  static uint32_t windows = 0;
+  portENTER_CRITICAL(&imuCalMux);
+  bool level = imuCalLevelRequest;
+  bool reset = imuCalResetRequest;
+  imuCalLevelRequest = false;
+  imuCalResetRequest = false;
+  portEXIT_CRITICAL(&imuCalMux);
+  if (reset)
+    ImuCal_reset(&imuCal);
+  if (level)
+    ImuCal_requestLevel(&imuCal);
+
+  // A new or dropped calibration is stored at once, drift at most every
+  // IMU_CAL_SAVE_INTERVAL_MS
+  bool urgent = imuCal.cal.flags != imuCal.saved.flags;
+  bool save = ImuCal_needsSave(&imuCal) &&
+              (urgent || now - lastSaveMs >= IMU_CAL_SAVE_INTERVAL_MS);
+  uint32_t seen = imuCal.stillWindows + imuCal.movingWindows;
+  if (!save && !reset && !level && seen == windows)
+    return;
+  windows = seen;
+  portENTER_CRITICAL(&imuCalMux);
+  imuCalShared = imuCal;
+  if (save) {
+    imuCalPending = imuCal.cal;
+    imuCalSavePending = true;
+  }
+  portEXIT_CRITICAL(&imuCalMux);
+  if (save) {
+    ImuCal_markSaved(&imuCal);
+    lastSaveMs = now;
+  }
+}
+
+/**
+ * Run every queued IMU sample through the attitude estimator (control task)
+ * @return true if the IMU is running
+ */
+bool updateAttitude() {
+  IMUManager &imu = IMUManager::getInstance();
+  if (!imu.isReady())
+    return false;
+
+  static uint32_t filterRevision = 0;
+  static uint32_t notchRevision = 0;
+  static int8_t notchStage = -1;          // Dynamic notch stage in gyroFilter
+  static TopicSub notchSub;
+  static bool filterSettled = false;
+  if (gyroFilterRevision != filterRevision || dynNotchRevision != notchRevision) {
+    portENTER_CRITICAL(&gyroFilterMux);
+    filterRevision = gyroFilterRevision;
+    BiquadChainConfig config = gyroFilterConfig;
+    portEXIT_CRITICAL(&gyroFilterMux);
+    portENTER_CRITICAL(&dynNotchMux);
+    notchRevision = dynNotchRevision;
+    DynNotchConfig notch = dynNotchConfig;
+    portEXIT_CRITICAL(&dynNotchMux);
+    BiquadChain_build(&gyroFilter, &config, IMU_SAMPLE_RATE_HZ, 3);
+    notchStage = -1;
+    BiquadCoefs coefs;
+    if (dynNotchAvailable && notch.enabled &&
+        Biquad_notch(&coefs, notch.maxHz, IMU_SAMPLE_RATE_HZ, notch.q) &&
+        BiquadCascade_addStage(&gyroFilter, &coefs))
+      notchStage = (int8_t)(gyroFilter.stages - 1);
+    filterSettled = false;
+  }
+  GyroNotchMsg notchMsg;
+  if (notchStage >= 0 && topicGyroNotch.readIfUpdated(notchSub, notchMsg))
+    BiquadCascade_setStage(&gyroFilter, (uint8_t)notchStage, &notchMsg.coefs);
+
+  // RPM notches move once per tick, on the ESCs' latest eRPM
+  static uint32_t rpmRevision = 0;
+  static bool rpmActive = false;
+  const EscTelemetry *esc = vehicle->getEscTelemetry();
+  if (rpmFilterRevision != rpmRevision) {
+    portENTER_CRITICAL(&rpmFilterMux);
+    rpmRevision = rpmFilterRevision;
+    RpmFilterConfig config = rpmFilterConfig;
+    portEXIT_CRITICAL(&rpmFilterMux);
+    rpmActive = config.enabled && esc;
+    RpmFilter_init(&rpmFilter, &config, esc ? esc->motorCount : 0, IMU_SAMPLE_RATE_HZ);
+  }
+  if (rpmActive) {
+    float motorHz[RPM_FILTER_MAX_MOTORS] = {};
+    for (uint8_t m = 0; m < rpmFilter.motorCount; m++) {
+      const EscMotorTelemetry &motor = esc->motors[m];
+      // No or stale eRPM: 0 Hz, that motor's notches pass through
+      if ((motor.last.fields & ESC_FIELD_ERPM) && !(motor.health & ESC_HEALTH_STALE))
+        motorHz[m] = RpmFilter_erpmToHz(motor.last.erpm, rpmFilter.config.motorPoles);
+    }
+    RpmFilter_update(&rpmFilter, motorHz);
+  }
+
+  // Drain a FIFO burst at a time so the filter runs over the whole block
+  IMUSample samples[IMU_BURST_MAX];
+  float rates[IMU_BURST_MAX][3];
+  size_t count;
+  do {
+    count = 0;
+    while (count < IMU_BURST_MAX && imu.readSample(samples[count])) {
+      // Learn from the raw sample, then everything downstream is corrected
+      IMUSample &raw = samples[count];
+      ImuCal_feed(&imuCal, raw.gyro, raw.accel, raw.tempC);
+      ImuCal_apply(&imuCal, raw.gyro, raw.accel, raw.tempC);
+      memcpy(rates[count], samples[count].gyro, sizeof(rates[0]));
+      if (notchStage >= 0) {
+        GyroNoiseFrame frame;
+        memcpy(frame.rates, samples[count].gyro, sizeof(frame.rates));
+        gyroNoiseRing.push(frame);
+      }
+      count++;
+    }
+    if (!count)
+      break;
+    if (!filterSettled) {
+      // Start from the current rate instead of ringing up from zero
+      BiquadCascade_settle(&gyroFilter, rates[0]);
+      filterSettled = true;
+    }
+    BiquadCascade_applyBlock(&gyroFilter, &rates[0][0], count);
+    if (rpmActive)
+      RpmFilter_applyBlock(&rpmFilter, &rates[0][0], count);
+
+    for (size_t n = 0; n < count; n++) {
+      const IMUSample &sample = samples[n];
+      float dt = lastImuUs ? (sample.timestampUs - lastImuUs) * 1e-6f
+                           : IMU_SAMPLE_PERIOD_US * 1e-6f;
+      lastImuUs = sample.timestampUs;
+      AttitudeEstimator_update(&attitude, sample.gyro, sample.accel, dt);
+
+      float earth[3];
+      AttitudeEstimator_toEarth(&attitude, sample.accel, earth);
+      for (int i = 0; i < 3; i++)
+        earthAccelSum[i] += earth[i];
+      earthAccelCount++;
+
+      VehicleAttitude att;
+      AttitudeEstimator_getEuler(&attitude, &att.roll, &att.pitch, &att.yaw);
+      memcpy(att.rates, rates[n], sizeof(att.rates));
+      memcpy(lastGyro, rates[n], sizeof(lastGyro));
+      att.valid = true;
+      vehicle->setAttitude(att);
+    }
+  } while (count == IMU_BURST_MAX);
+  serviceImuCal(HAL_GetMillis());
+  return true;
+}
+
+/**
+ * Attitude estimator yaw as a clockwise heading, degrees (no north)
+ */
+float gyroHeading() {
+  float roll, pitch, yaw;
+  AttitudeEstimator_getEuler(&attitude, &roll, &pitch, &yaw);
+  return -yaw * RAD_TO_DEG;
+}
+
+/**
+ * Fuse the compass heading into the position EKF every MAG_CAL_FUSE_MS
+ * (control task): a calibrated, fresh field whose strength matches the
+ * fit. Aligns yaw without moving and holds it at standstill.
+ */
+void fuseMagHeading(bool imuReady) {
+  static uint32_t lastFuseMs = 0;
+  static uint32_t lastSample = 0;
+  uint32_t now = HAL_GetMillis();
+  if (!imuReady || now - lastFuseMs < MAG_CAL_FUSE_MS)
+    return;
+  MagMsg msg;
+  if (!topicMag.read(msg) || !msg.valid || msg.sampleCount == lastSample ||
+      now - msg.timeMs > MAG_STALE_MS)
+    return;
+  portENTER_CRITICAL(&magMux);
+  MagConfig config = magConfig;
+  portEXIT_CRITICAL(&magMux);
+  if (!config.enabled)
+    return;
+  lastFuseMs = now;
+  lastSample = msg.sampleCount;
+  if (msg.disturbed) {
+    magHeadingDisturbed++;
+    return;
+  }
+  float earth[3];
+  AttitudeEstimator_toEarth(&attitude, msg.field, earth);
+  float yaw = gyroHeading();
+  PositionEstimator_updateHeading(&position, yaw,
+                                  MagCal_heading(earth, yaw, config.declinationDeg),
+                                  MAG_CAL_HEADING_SIGMA_DEG);
+  magHeadingFused++;
+}
+
+/**
+ * Blend the latest barometer sample with this tick's vertical
+ * acceleration (control task). Needs no navigation frame: the altitude
+ * is above the ground pressure taken at boot, or at the last
+ * {"c":"set_alt","zero":true} (not while holding).
+ */
+void updateBaroAltitude(float accelUp, float dt) {
+  portENTER_CRITICAL(&altHoldMux);
+  bool zero = baroZeroRequest;
+  baroZeroRequest = false;
+  portEXIT_CRITICAL(&altHoldMux);
+  if (zero && !altHold.engaged)
+    BaroAltitude_zero(&baroAlt);
+
+  BaroMsg msg;
+  bool fresh = topicBaro.read(msg) && HAL_GetMillis() - msg.timeMs < BARO_STALE_MS;
+  if (fresh && msg.sampleCount != baroAltSamples) {
+    baroAltSamples = msg.sampleCount;
+    BaroAltitude_updateBaro(&baroAlt, msg.pressurePa);
+  }
+  BaroAltitude_predict(&baroAlt, accelUp, dt);
+  baroAltValid = fresh && BaroAltitude_isReady(&baroAlt);
+}
+
+/**
+ * Advance the position EKF by one control tick and fuse what is new:
+ * the GPS fix, its course while moving, the compass, and depth on the Sub
+ */
+void updatePosition(bool imuReady) {
+  float dt = HAL_StepSeconds(&lastPositionUs, HAL_Now(), 0.0f, POS_EST_MAX_DT);
+
+  float accel[3] = {0.0f, 0.0f, 0.0f};
+  if (earthAccelCount) {
+    for (int i = 0; i < 3; i++)
+      accel[i] = earthAccelSum[i] / earthAccelCount;
+    accel[2] -= GRAVITY;
+    memset(earthAccelSum, 0, sizeof(earthAccelSum));
+    earthAccelCount = 0;
+#if FEATURE_DEPTH
+    // Depth rate estimate between pressure samples (updateControl() runs later this tick)
+    if (imuReady)
+      DepthManager::getInstance().setVerticalAccel(accel[2]);
+#endif
+  }
+#if FEATURE_BARO
+  updateBaroAltitude(accel[2], dt);
+#endif
+
+  const NavFrame &frame = NavigationManager::getInstance().getFrame();
+  if (!frame.valid)
+    return;
+  if (frame.originLat != positionOriginLat || frame.originLng != positionOriginLng) {
+    // Re-anchored (home set, new mission): the estimate is in the old frame
+    PositionEstimator_resetPosition(&position);
+    positionOriginLat = frame.originLat;
+    positionOriginLng = frame.originLng;
+  }
+  PositionEstimator_predict(&position, accel, dt);
+
+  GPSFix fix;
+  if (gpsManager && gpsManager->getFixCount() != positionFixCount &&
+      gpsManager->getFix(fix)) {
+    positionFixCount = gpsManager->getFixCount();
+    if (fix.valid) {
+      if (!position.initialized)
+        positionAltRef = fix.altMsl;
+      PositionGPSInput gps;
+      gps.position = NavFrame_toLocal(&frame, fix.lat, fix.lng);
+      gps.up = (fix.altMsl - positionAltRef) * 1e-3f;
+      gps.velE = fix.velE * 1e-3f;
+      gps.velN = fix.velN * 1e-3f;
+      gps.velU = -fix.velD * 1e-3f;
+      gps.hAcc = fix.hAcc * 1e-3f;
+      gps.vAcc = fix.vAcc * 1e-3f; // 0 from NMEA: no vertical
+      gps.sAcc = fix.sAcc * 1e-3f;
+      gps.rtkFixed = fix.carrSoln == GPS_CARR_FIXED;
+#if defined(VEHICLE_TYPE_SUB)
+      gps.vAcc = 0.0f; // Depth sensor owns the vertical
+#endif
+      PositionEstimator_updateGPS(&position, &gps);
+
+      float speed = fix.groundSpeed * 1e-3f;
+      if (imuReady && speed > HEADING_GPS_MIN_SPEED) {
+        float sAcc = gps.sAcc > 0.0f ? gps.sAcc : POS_EST_DEFAULT_VEL_SIGMA;
+        PositionEstimator_updateHeading(&position, gyroHeading(), fix.course * 1e-5f,
+                                        FastMath_atan2(sAcc, speed) * FAST_MATH_RAD_TO_DEG);
+      }
+    }
+  }
+  fuseMagHeading(imuReady);
+
+  // Wheel odometry (Rover with encoders): speed along the fused heading,
+  // or standing still whatever the heading
+  const WheelOdometry *odo = vehicle->getOdometry();
+  if (odo && odo->samples != positionOdomCount) {
+    positionOdomCount = odo->samples;
+    float v = odo->speed;
+    bool still = v < ODOM_STOP_MPS && v > -ODOM_STOP_MPS;
+    if (still) {
+      PositionEstimator_updateVelocity(&position, 0.0f, 0.0f, ODOM_SPEED_SIGMA);
+    } else if (imuReady && position.headingAligned) {
+      float s, c;
+      float heading = PositionEstimator_getHeading(&position, gyroHeading());
+      FastMath_sinCos(heading * FAST_MATH_DEG_TO_RAD, &s, &c);
+      float headingVar = position.P[POS_EST_PSI][POS_EST_PSI] * v * v;
+      PositionEstimator_updateVelocity(&position, v * s, v * c,
+                                       sqrtf(ODOM_SPEED_SIGMA * ODOM_SPEED_SIGMA + headingVar));
+    }
+  }
+
+#if defined(VEHICLE_TYPE_SUB)
+  DepthManager &depth = DepthManager::getInstance();
+  if (depth.getSampleCount() != positionDepthCount) {
+    positionDepthCount = depth.getSampleCount();
+    PositionEstimator_updateHeight(&position, -depth.getActualDepth(), DEPTH_SIGMA);
+  }
+#endif
+}
+
+/**
+ * Leader's latest beacon to navigation while following (control task)
+ */
+void feedFormationLeader() {
+  NavigationManager &nav = NavigationManager::getInstance();
+  if (!nav.getState().isFollowing)
+    return;
+  FormationState leader;
+  uint32_t seenMs = 0;
+  bool found = false;
+  portENTER_CRITICAL(&formationMux);
+  const FormationNeighbor *n =
+      formationConfig.haveLeader
+          ? FormationTable_find(&formationTable, formationConfig.leader, HAL_GetMillis())
+          : nullptr;
+  if (n) {
+    leader = n->state;
+    seenMs = n->lastSeenMs;
+    found = true;
+  }
+  portEXIT_CRITICAL(&formationMux);
+  // Unknown / lost leader: navigation holds once the last one goes stale
+  if (found)
+    nav.setLeader(leader, seenMs);
+}
+
+/**
+ * Forward range to navigation (control task): the obstacle slow-down
+ * follows each sensor reading within a control period. A fitted sensor
+ * that goes silent stops the vehicle as an obstacle at 0 m would.
+ */
+void feedObstacleRange(uint32_t now) {
+  NavigationManager &nav = NavigationManager::getInstance();
+  static uint32_t rangeApplied = 0;
+  if (rangeRevision != rangeApplied) {
+    portENTER_CRITICAL(&rangeMux);
+    rangeApplied = rangeRevision;
+    RangeEnvelope envelope = rangeEnvelope;
+    portEXIT_CRITICAL(&rangeMux);
+    nav.setObstacleEnvelope(envelope);
+  }
+  if (!rangeFitted)
+    return;
+  RangeMsg range;
+  bool fresh = topicRange.read(range) && now - range.timeMs < RANGE_STALE_MS;
+  nav.setObstacleRange(fresh ? range.range : 0.0f);
+}
+
+/**
+ * Own state for the next beacon (control task)
+ * Fused position when the estimator is healthy, else the raw fix.
+ */
+void publishFormationSelf(float heading) {
+  NavigationManager &nav = NavigationManager::getInstance();
+  const GPSFix &fix = nav.getGPSFix();
+  NavigationState navState = nav.getState();
+  FormationState self;
+  memset(&self, 0, sizeof(self));
+  if (PositionEstimator_isHealthy(&position) && nav.getFrame().valid) {
+    NavFrame_toGlobal(&nav.getFrame(), PositionEstimator_getPosition(&position), &self.latE7,
+                      &self.lngE7);
+    self.flags |= FORMATION_FLAG_POSITION;
+  } else if (fix.valid) {
+    self.latE7 = fix.lat;
+    self.lngE7 = fix.lng;
+    self.flags |= FORMATION_FLAG_POSITION;
+  }
+  if (fix.valid) {
+    self.velEast = fix.velE * 1e-3f;
+    self.velNorth = fix.velN * 1e-3f;
+  }
+  self.heading = heading;
+  self.missionIndex = navState.currentWaypointIndex;
+  self.vehicleType = formationVehicleType;
+  if (navState.isMissionActive || navState.isSurveyActive)
+    self.flags |= FORMATION_FLAG_MISSION;
+  if (navState.isFollowing)
+    self.flags |= FORMATION_FLAG_FOLLOWING;
+  portENTER_CRITICAL(&formationMux);
+  formationSelf = self;
+  portEXIT_CRITICAL(&formationMux);
+}
+
+/**
+ * Plane in AUTO: throttle and pitch from the total energy controller,
+ * tracking the leg's altitude and speed (control task, fixed rate)
+ * The mission speed reads as cm/s here (1500 = 15 m/s). Pitot airspeed
+ * when fresh, else GPS ground speed (wrong by the wind, still better
+ * than open-loop throttle). Height and climb rate from the barometer
+ * when fresh, else the position EKF. Without a position estimate or a
+ * waypoint altitude the leg speed stays raw throttle, as before.
+ */
+void updateEnergyControl(NAPacket &cmd, bool navigating) {
+  static uint32_t tecsApplied = 0;
+  if (tecsRevision != tecsApplied) {
+    portENTER_CRITICAL(&tecsMux);
+    tecsApplied = tecsRevision;
+    TecsConfig config = tecsConfig;
+    portEXIT_CRITICAL(&tecsMux);
+    TotalEnergy_setConfig(&tecs, &config);
+  }
+
+  NavigationManager &nav = NavigationManager::getInstance();
+  float altSp = 0.0f;
+  bool run = navigating && formationVehicleType == VEHICLE_PLANE && tecs.config.enabled &&
+             !nav.getState().isFollowing && position.initialized && nav.getLegAltitude(altSp);
+  if (!run) {
+    if (tecsActive)
+      TotalEnergy_reset(&tecs); // Next engagement starts from trim
+    tecsActive = false;
+    return;
+  }
+  tecsActive = true;
+
+  AirspeedMsg air;
+  tecsPitot = topicAirspeed.read(air) && HAL_GetMillis() - air.timeMs < AIRSPEED_STALE_MS;
+  float speed = tecsPitot ? air.airspeed
+                          : sqrtf(position.x[POS_EST_VE] * position.x[POS_EST_VE] +
+                                  position.x[POS_EST_VN] * position.x[POS_EST_VN]);
+  float height = baroAltValid ? baroAlt.altitude : position.x[POS_EST_PU];
+  float climb = baroAltValid ? baroAlt.climbRate : position.x[POS_EST_VU];
+  TotalEnergy_update(&tecs, altSp, nav.getLegSpeed() * 0.01f, height, climb, speed,
+                     controlOuterDt);
+
+  // Pitch goes through the fly-by-wire angle loop: stick = pitch / maxPitch
+  portENTER_CRITICAL(&fbwMux);
+  FbwConfig fbw = fbwConfig;
+  portEXIT_CRITICAL(&fbwMux);
+  cmd.throttle = (int16_t)(tecs.throttle * 1000.0f);
+  if (fbw.enabled) {
+    float stick = tecs.pitch / (fbw.maxPitchDeg * FAST_MATH_DEG_TO_RAD);
+    cmd.pitch = (int16_t)(constrain(stick, -1.0f, 1.0f) * 1000.0f);
+  }
+}
+
+/**
+ * Copter altitude hold (control task, fixed rate). With the barometer
+ * fresh and the throttle stick above idle, the stick becomes a climb
+ * rate around its centre; in AUTO the leg's waypoint altitude is the
+ * target instead. Stick at idle (or a failsafe cutting it) hands the
+ * throttle straight back: that is how it lands and stays down.
+ */
+void updateAltitudeHold(NAPacket &cmd, bool navigating) {
+  static uint32_t altHoldApplied = 0;
+  if (altHoldRevision != altHoldApplied) {
+    portENTER_CRITICAL(&altHoldMux);
+    altHoldApplied = altHoldRevision;
+    AltHoldConfig config = altHoldConfig;
+    portEXIT_CRITICAL(&altHoldMux);
+    AltitudeHold_setConfig(&altHold, &config);
+  }
+
+  float legAlt = 0.0f;
+  bool mission = navigating && NavigationManager::getInstance().getLegAltitude(legAlt);
+  bool run = formationVehicleType == VEHICLE_COPTER && altHold.config.enabled && baroAltValid &&
+             (mission || cmd.throttle > ALT_HOLD_IDLE_STICK);
+  if (!run) {
+    if (altHold.engaged)
+      AltitudeHold_release(&altHold);
+    return;
+  }
+  if (!altHold.engaged)
+    AltitudeHold_engage(&altHold, baroAlt.altitude);
+
+  float pilotRate = 0.0f;
+  if (mission)
+    AltitudeHold_setTarget(&altHold, legAlt);
+  else
+    pilotRate = AltitudeHold_stickRate(&altHold.config, cmd.throttle * 1e-3f);
+
+  // Body z against up, from the attitude quaternion
+  float q[4];
+  AttitudeEstimator_getQuaternion(&attitude, q);
+  float cosTilt = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+  float throttle = AltitudeHold_update(&altHold, pilotRate, baroAlt.altitude, baroAlt.climbRate,
+                                       cosTilt, controlOuterDt);
+  cmd.throttle = (int16_t)(throttle * 1000.0f);
+}
+
+/**
+ * Heading for navigation in degrees (0-360)
+ * Fused heading once the EKF has aligned yaw to GPS course or the compass
+ * (works at low speed and while stationary), GPS course until then or
+ * without an IMU.
+ */
+float estimateHeading(bool imuReady) {
+  if (!imuReady || !position.headingAligned)
+    return NavigationManager::getInstance().getGPSCourse();
+  return PositionEstimator_getHeading(&position, gyroHeading());
+}
+
+/**
+ * Send this tick's outputs to the PCA9685 (control task, after the
+ * vehicle loop): one burst on the I2C queue, skipped while the last one
+ * is still on the bus
+ */
+void updatePwmExpander() {
+  uint8_t outputs[TOPIC_ACTUATOR_CHANNELS] = {0};
+  vehicle->getMixedOutput(outputs, sizeof(outputs));
+  for (uint8_t i = 0; i < TOPIC_ACTUATOR_CHANNELS; i++)
+    pwmExpander.setMicroseconds(i, PWM_EXPANDER_MIN_US + outputs[i] * (PWM_EXPANDER_SPAN_US / 100.0f));
+
+  uint16_t aux[PCA9685_CHANNELS - TOPIC_ACTUATOR_CHANNELS];
+  portENTER_CRITICAL(&pwmAuxMux);
+  memcpy(aux, pwmAuxUs, sizeof(aux));
+  portEXIT_CRITICAL(&pwmAuxMux);
+  for (uint8_t i = 0; i < PCA9685_CHANNELS - TOPIC_ACTUATOR_CHANNELS; i++)
+    pwmExpander.setMicroseconds(TOPIC_ACTUATOR_CHANNELS + i, aux[i]);
+  pwmExpander.flush();
+}
+
+/**
+ * Publish this tick's control task state to the topic bus
+ * (sensor-rate topics only when their source advanced)
+ */
+void publishControlTopics(const NAPacket &cmd, float heading, bool imuReady,
+                          bool batteryAdvanced, uint32_t now) {
+  SticksMsg sticks;
+  sticks.throttle = cmd.throttle;
+  sticks.roll = cmd.roll;
+  sticks.pitch = cmd.pitch;
+  sticks.yaw = cmd.yaw;
+  sticks.mode = cmd.mode;
+  sticks.sequence = cmd.sequenceNumber;
+  sticks.timeMs = now;
+  topicSticks.publish(sticks);
+
+  if (imuReady) {
+    AttitudeMsg att;
+    AttitudeEstimator_getEuler(&attitude, &att.roll, &att.pitch, &att.yaw);
+    memcpy(att.rates, lastGyro, sizeof(att.rates));
+    att.heading = heading;
+    att.timeMs = now;
+    topicAttitude.publish(att);
+  }
+
+  topicNavState.publish(NavigationManager::getInstance().getState());
+
+  if (batteryAdvanced && powerSource != POWER_SOURCE_NONE) {
+    PowerMsg power;
+    power.power = powerMonitor;
+    power.source = powerSource;
+    power.timeMs = now;
+    topicPower.publish(power);
+  }
+
+  if (batteryAdvanced) {
+    BatteryMsg battery;
+    battery.millivolts = batteryManager->getVoltageMillivolts();
+    battery.percent = BatteryEstimator_getPercent(&batteryModel);
+    battery.remainingS = BatteryEstimator_getRemainingSeconds(&batteryModel);
+    battery.rtlRequired = BatteryEstimator_rtlRequired(&batteryModel);
+    battery.timeMs = now;
+    topicBattery.publish(battery);
+  }
+
+  ActuatorOutputsMsg actuators;
+  memset(&actuators, 0, sizeof(actuators));
+  vehicle->getMixedOutput(actuators.outputs, sizeof(actuators.outputs));
+  actuators.timeMs = now;
+  topicActuators.publish(actuators);
+
+  const EscTelemetry *esc = vehicle->getEscTelemetry();
+  if (esc) {
+    EscMsg escMsg;
+    escMsg.esc = *esc;
+    escMsg.health = ESC_HEALTH_OK;
+    for (uint8_t i = 0; i < esc->motorCount; i++)
+      escMsg.health |= esc->motors[i].health;
+    escMsg.timeMs = now;
+    topicEsc.publish(escMsg);
+  }
+}
+
+/**
+ * Pack current for this block: the ADC sensor once it has a gain, else
+ * the ESCs' summed current telemetry
+ * @return POWER_SOURCE_NONE if neither is available
+ */
+static uint8_t readPackCurrent(const PowerConfig &config, float &amps) {
+  if (batteryManager->hasCurrentSense() && config.ampsPerVolt > 0.0f) {
+    amps = PowerMonitor_ampsFromMv(&config, batteryManager->getCurrentSenseMillivolts());
+    return POWER_SOURCE_ADC;
+  }
+  const EscTelemetry *esc = vehicle->getEscTelemetry();
+  if (!esc)
+    return POWER_SOURCE_NONE;
+  bool any = false;
+  amps = 0.0f;
+  for (uint8_t i = 0; i < esc->motorCount; i++) {
+    const EscMotorTelemetry &m = esc->motors[i];
+    if (!(m.last.fields & ESC_FIELD_CURRENT) || (m.health & ESC_HEALTH_STALE))
+      continue;
+    amps += m.last.centiAmps / 100.0f;
+    any = true;
+  }
+  return any ? POWER_SOURCE_ESC : POWER_SOURCE_NONE;
+}
+
+/**
+ * Integrate energy for the new battery block, book it to the mission leg
+ * being flown and check the return budget (control task)
+ */
+static void updatePowerMonitor() {
+  static uint32_t revision = 0;
+  if (powerRevision != revision) {
+    portENTER_CRITICAL(&powerMux);
+    revision = powerRevision;
+    PowerConfig config = powerConfig;
+    portEXIT_CRITICAL(&powerMux);
+    PowerMonitor_setConfig(&powerMonitor, &config);
+  }
+
+  float amps = 0.0f;
+  powerSource = readPackCurrent(powerMonitor.config, amps);
+  if (powerSource == POWER_SOURCE_NONE)
+    return;
+
+  NavigationManager &nav = NavigationManager::getInstance();
+  NavigationState state = nav.getState();
+  uint32_t now = HAL_GetMillis();
+  PowerMonitor_update(&powerMonitor, batteryManager->getBlockMillivolts(), amps,
+                      nav.getGPSSpeed(), now);
+
+  // One leg per mission item flown, and one for the flight home
+  uint16_t item = state.isRTLActive ? POWER_LEG_RTL : state.currentWaypointIndex;
+  if (state.isRTLActive || state.isMissionActive) {
+    const PowerLeg *leg = PowerMonitor_getLeg(&powerMonitor, 0);
+    if (!powerMonitor.legOpen || !leg || leg->item != item)
+      PowerMonitor_startLeg(&powerMonitor, item);
+  } else if (powerMonitor.legOpen) {
+    PowerMonitor_endLeg(&powerMonitor);
+  }
+
+  float homeDistance = -1.0f;
+  if (nav.hasHome() && nav.isGPSLocked()) {
+    NavFrame home;
+    NavFrame_init(&home, NavFrame_toE7(state.homeLat), NavFrame_toE7(state.homeLng));
+    int32_t latE7, lngE7;
+    nav.getGPSLocationE7(latE7, lngE7);
+    NavVector origin = {0.0f, 0.0f};
+    homeDistance = NavFrame_distance(origin, NavFrame_toLocal(&home, latE7, lngE7));
+  }
+  PowerMonitor_checkReturn(&powerMonitor, homeDistance, now);
+}
+
+/**
+ * Feed the battery model with each new ADC block (control task)
+ * Load is the summed motor output, so sag is matched to the throttle
+ * that caused it.
+ * @return true when the model was advanced
+ */
+bool updateBatteryModel() {
+  if (!batteryManager || batteryManager->getBlockCount() == batteryBlock)
+    return false;
+  batteryBlock = batteryManager->getBlockCount();
+
+  uint8_t motorPwm[8] = {0};
+  float load = 0.0f;
+  vehicle->getMixedOutput(motorPwm, sizeof(motorPwm));
+  for (uint8_t i = 0; i < sizeof(motorPwm); i++)
+    load += motorPwm[i] / 100.0f;
+  BatteryEstimator_update(&batteryModel, batteryManager->getBlockMillivolts(), load,
+                          HAL_GetMillis());
+  updatePowerMonitor();
+  return true;
+}
+
+/**
+ * Persist the fence polygons (comms task, after an edit)
+ */
+bool saveGeofence() {
+  GeofenceRecord *records = geofenceRecords;
+  size_t n = 0;
+  portENTER_CRITICAL(&geofenceMux);
+  for (uint8_t p = 0; p < geofence.polygonCount; p++) {
+    const GeofencePolygon &poly = geofence.polygons[p];
+    for (uint8_t v = 0; v < poly.vertexCount; v++, n++) {
+      records[n].lat = poly.lat[v];
+      records[n].lng = poly.lng[v];
+      records[n].polygon = p;
+      records[n].type = poly.type;
+    }
+  }
+  portEXIT_CRITICAL(&geofenceMux);
+  if (n == 0) {
+    ConfigManager::removeKey(GEOFENCE_NVS_KEY);
+    return true;
+  }
+  return ConfigManager::saveBlob(GEOFENCE_NVS_KEY, records, n * sizeof(GeofenceRecord));
+}
+
+/**
+ * Restore the fence at boot (before the control task runs)
+ */
+void loadGeofence() {
+  Geofence_init(&geofence);
+  Geofence_setMaxDistance(&geofence, ConfigManager::getFloat(GEOFENCE_DIST_KEY, 0.0f));
+
+  GeofenceRecord *records = geofenceRecords;
+  size_t n = ConfigManager::loadBlob(GEOFENCE_NVS_KEY, records, sizeof(geofenceRecords)) /
+             sizeof(GeofenceRecord);
+  int32_t lat[GEOFENCE_MAX_VERTICES], lng[GEOFENCE_MAX_VERTICES];
+  for (size_t i = 0; i < n;) {
+    uint8_t count = 0;
+    size_t first = i;
+    while (i < n && records[i].polygon == records[first].polygon) {
+      if (count < GEOFENCE_MAX_VERTICES) {
+        lat[count] = records[i].lat;
+        lng[count] = records[i].lng;
+        count++;
+      }
+      i++;
+    }
+    Geofence_addPolygon(&geofence, (GeofenceType)records[first].type, lat, lng, count);
+  }
+}
+
+/**
+ * Check the fence at the navigation position and RTL on a new breach
+ * (latched until back inside, so an RTL that is cancelled is not
+ * re-triggered every tick)
+ */
+void checkGeofence() {
+  NavigationManager &nav = NavigationManager::getInstance();
+  const NavFrame &frame = nav.getFrame();
+  if (!frame.valid)
+    return;
+
+  NavVector pos;
+  if (PositionEstimator_isHealthy(&position)) {
+    pos = PositionEstimator_getPosition(&position);
+  } else if (nav.isGPSLocked()) {
+    int32_t latE7 = 0, lngE7 = 0;
+    nav.getGPSLocationE7(latE7, lngE7);
+    pos = NavFrame_toLocal(&frame, latE7, lngE7);
+  } else {
+    return;
+  }
+
+  // The frame origin is home once it is set
+  NavigationState state = nav.getState();
+  bool homeSet = state.homeLat != 0 || state.homeLng != 0;
+  NavVector home = {0.0f, 0.0f};
+
+  portENTER_CRITICAL(&geofenceMux);
+  Geofence_setFrame(&geofence, &frame);
+  GeofenceResult result = Geofence_check(&geofence, pos, homeSet ? &home : NULL);
+  portEXIT_CRITICAL(&geofenceMux);
+
+  if (result != GEOFENCE_OK && geofenceResult == GEOFENCE_OK && !state.isRTLActive) {
+    LOG_WARN("[Fence] Breach (%d)! Triggering RTL.\n", (int)result);
+    nav.executeRTL();
+  }
+  geofenceResult = result;
+}
+
+/**
+ * Act on the failsafe state (control task, before the auto inputs)
+ *
+ * RTL runs through the navigation auto path; every other action zeroes
+ * the sticks and drops auto. The vehicle's policy picks the action.
+ */
+void applyFailsafe(NAPacket &cmd) {
+  static FailsafeAction lastAction = FAILSAFE_ACTION_NONE;
+  NavigationManager &nav = NavigationManager::getInstance();
+  NavigationState navState = nav.getState();
+  bool rtlAvailable = (navState.homeLat != 0 || navState.homeLng != 0) && nav.isGPSLocked();
+  FailsafePolicy policy = vehicle->getFailsafePolicy();
+  bool fault = vehicle->checkCriticalFault();
+  FailsafeAction action = failsafeManager.getAction(policy, rtlAvailable, fault);
+
+  if (action != lastAction) {
+    LOG_WARN("[Failsafe] Action %d -> %d (%s)\n", (int)lastAction, (int)action,
+             failsafeManager.getStateString());
+    // Start RTL once on entry; a pilot cancel or arrival is not undone
+    if (action == FAILSAFE_ACTION_RTL && !navState.isRTLActive)
+      nav.executeRTL();
+    lastAction = action;
+  }
+
+  if (action == FAILSAFE_ACTION_NONE)
+    return;
+  if (action == FAILSAFE_ACTION_RTL && nav.getState().isRTLActive) {
+    cmd.mode |= MODE_AUTO;
+    return;
+  }
+  cmd.throttle = 0;
+  cmd.roll = 0;
+  cmd.pitch = 0;
+  cmd.yaw = 0;
+  cmd.mode &= ~MODE_AUTO;
+  if (action == FAILSAFE_ACTION_SURFACE)
+    DepthManager::getInstance().setDiving(false);
+}
+
+/**
+ * Copy what a reset would lose into RTC memory (control task, every tick:
+ * the replay window restored after a reset is at most one frame behind)
+ */
+void saveWarmRestart(uint32_t now) {
+  WarmRestartRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.uptimeMs = now;
+  rec.failsafeState = (uint8_t)failsafeManager.getState();
+  rec.sincePacketMs = failsafeManager.getTimeSinceLastPacket(now);
+  NavigationManager::getInstance().captureResume(rec.nav);
+
+  portENTER_CRITICAL(&peerMux);
+  int slot = haveLinkPeer ? PeerSessionTable_find(&peerSessions, linkPeer) : PEER_SESSION_NONE;
+  if (slot != PEER_SESSION_NONE) {
+    const PeerSession *peer = &peerSessions.peers[slot];
+    memcpy(rec.ticket.mac, linkPeer, 6);
+    rec.ticket.valid = true;
+    rec.ticket.keyed = peer->keyed;
+    rec.ticket.haveSeq = peer->replay.haveSeq;
+    rec.ticket.highestSeq = peer->replay.highest;
+    if (peer->keyed)
+      rec.ticket.keys = peer->keys;
+  }
+  portEXIT_CRITICAL(&peerMux);
+
+  WarmRestart_save(&rec);
+  SessionKeys_wipe(&rec.ticket.keys);
+}
+
+/**
+ * Sender id of a control frame for the arbiter (low MAC bytes: the
+ * vendor prefix is the same for every ESP32)
+ */
+static uint32_t macTag(const uint8_t *mac) {
+  return ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+}
+
+/**
+ * Hand a frame's sticks to the input conditioner (control task)
+ */
+static void sampleSticks(const NAPacket &pkt, HAL_Micros arrivedUs) {
+  int16_t axes[INPUT_COND_AXES] = {pkt.throttle, pkt.roll, pkt.pitch, pkt.yaw};
+  portENTER_CRITICAL(&inputMux);
+  InputConditioner_sample(&inputConditioner, axes, arrivedUs);
+  portEXIT_CRITICAL(&inputMux);
+}
+
+/**
+ * Configure dynamic frequency scaling (boot, and from set_pm through the
+ * control task): full clock while a lock is held, minMhz otherwise.
+ * Light sleep needs tickless idle in the build; without it the clock is
+ * still scaled. Returns false if the build has no power management.
+ */
+static bool configurePowerManagement(const PowerPolicyConfig &config) {
+  static const int maxMhz = getCpuFrequencyMhz();   // Boot clock, before scaling
+  int minMhz = config.minMhz < maxMhz ? config.minMhz : maxMhz;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t pm = {};
+#else
+  esp_pm_config_esp32_t pm = {};
+#endif
+  pm.max_freq_mhz = maxMhz;
+  pm.min_freq_mhz = minMhz;
+  pm.light_sleep_enable = config.lightSleep != 0;
+  esp_err_t err = esp_pm_configure(&pm);
+  if (err != ESP_OK && pm.light_sleep_enable) {
+    pm.light_sleep_enable = false;
+    err = esp_pm_configure(&pm);
+  }
+  pmLightSleep = err == ESP_OK && pm.light_sleep_enable;
+  return err == ESP_OK;
+}
+
+/**
+ * Put a power mode in place (control task). FULL takes the locks before
+ * the radio wakes; ECO lets the radio sleep before releasing them.
+ */
+static void applyPowerMode(PowerMode mode) {
+  if (mode == POWER_MODE_FULL) {
+    if (pmLocks) {
+      esp_pm_lock_acquire(pmCpuLock);
+      esp_pm_lock_acquire(pmSleepLock);
+    }
+    WifiLink_setIdle(false);
+  } else {
+    WifiLink_setIdle(true);
+    if (pmLocks) {
+      esp_pm_lock_release(pmSleepLock);
+      esp_pm_lock_release(pmCpuLock);
+    }
+  }
+}
+
+/**
+ * Run the power policy for this tick (control task, after the arbiter:
+ * a frame applied in ECO is handled at full clock)
+ */
+static void updatePowerMode(uint32_t now) {
+  static uint32_t revision = 0;
+  static PowerPolicyConfig config = pmConfig;
+  if (pmConfigRevision != revision) {
+    portENTER_CRITICAL(&pmMux);
+    revision = pmConfigRevision;
+    config = pmConfig;
+    portEXIT_CRITICAL(&pmMux);
+    if (pmCpuLock && pmSleepLock)
+      pmLocks = configurePowerManagement(config);
+  }
+
+  NavigationState navState = NavigationManager::getInstance().getState();
+  bool moving = failsafeManager.isArmed() || navState.isMissionActive || navState.isRTLActive ||
+                navState.isSurveyActive;
+  bool busy = moving || failsafeManager.isSignalLost() || now - hostActivityMs < config.idleDelayMs;
+#if FEATURE_OTA
+  // Fleet firmware is only taken while parked, and keeps the radio awake
+  OTAUpdater_setFleetHold(moving);
+  busy |= OTAUpdater_isBusy();
+#endif
+
+  portENTER_CRITICAL(&pmMux);
+  PowerMode mode = PowerPolicy_update(&powerPolicy, &config, busy, now);
+  PowerMode applied = powerPolicy.applied;
+  portEXIT_CRITICAL(&pmMux);
+  if (mode == applied)
+    return;
+
+  applyPowerMode(mode);
+  portENTER_CRITICAL(&pmMux);
+  PowerPolicy_applied(&powerPolicy, mode, HAL_GetMillis(), HAL_Now());
+  uint32_t wakeUs = powerPolicy.lastWakeUs;
+  portEXIT_CRITICAL(&pmMux);
+  if (mode == POWER_MODE_ECO)
+    LOG_INFO("[PM] Parked: eco%s\n", pmLightSleep ? ", light sleep" : "");
+  else
+    LOG_INFO("[PM] Full clock (wake %lu us)\n", (unsigned long)wakeUs);
+}
+
+/**
+ * MotorConfig to every brushed motor, with that motor's trims over it
+ * (control task)
+ */
+static void applyMotorConfig() {
+  static uint32_t motorRevision = 0;
+  static uint32_t trimRevision = 0;
+  if (!configManager || (configManager->getMotorRevision() == motorRevision &&
+                         motorTrimRevision == trimRevision))
+    return;
+  motorRevision = configManager->getMotorRevision();
+  ConfigManager::MotorConfig base = configManager->getMotorConfig();
+  portENTER_CRITICAL(&motorTrimMux);
+  trimRevision = motorTrimRevision;
+  MotorTrimTable trims = motorTrims;
+  portEXIT_CRITICAL(&motorTrimMux);
+
+  vehicle->setMotorConfig(base);
+  uint8_t count = vehicle->getMotorCount();
+  for (uint8_t i = 0; i < count && i < MOTOR_TRIM_MAX; i++) {
+    Motor *motor = vehicle->getMotor(i);
+    if (!motor)
+      continue;
+    ConfigManager::MotorConfig config = base;
+    config.minPWM = MotorTrim_resolve(trims.motors[i].minPWM, base.minPWM);
+    config.deadband = MotorTrim_resolve(trims.motors[i].deadband, base.deadband);
+    motor->setConfig(config);
+  }
+}
+
+/**
+ * Breakaway calibration of one motor, the others held at 0 (control
+ * task). Feedback is the wheel encoder when the motor has one, else the
+ * pack current; a run stops when the vehicle is armed
+ * @return true while a run owns the motors (the vehicle's outputs are
+ *         skipped this tick)
+ */
+static bool runMotorCal(uint32_t now, bool batteryAdvanced) {
+  static MotorCal cal;
+  static int8_t calMotor = -1;
+  static MotorBatch batch;
+
+  portENTER_CRITICAL(&motorTrimMux);
+  int8_t request = motorCalRequest;
+  bool abort = motorCalAbortRequest;
+  motorCalRequest = -1;
+  motorCalAbortRequest = false;
+  portEXIT_CRITICAL(&motorTrimMux);
+
+  uint8_t count = vehicle->getMotorCount();
+  int32_t counts = 0;
+  if (request >= 0 && request < count && !MotorCal_isRunning(&cal)) {
+    calMotor = request;
+    if (vehicle->readMotorCounts(calMotor, counts)) {
+      MotorCal_start(&cal, MOTOR_CAL_FEEDBACK_ENCODER, now, counts);
+    } else if (powerSource != POWER_SOURCE_NONE) {
+      MotorCal_start(&cal, MOTOR_CAL_FEEDBACK_CURRENT, now, 0);
+    } else {
+      memset(&cal, 0, sizeof(cal));
+      cal.state = MOTOR_CAL_FAILED;
+      LOG_WARN("[MotorCal] Motor %d: no encoder or current sensor\n", calMotor);
+    }
+  }
+  if (!MotorCal_isRunning(&cal)) {
+    if (request >= 0) {
+      portENTER_CRITICAL(&motorTrimMux);
+      motorCalStatus = cal;
+      motorCalStatusMotor = calMotor;
+      portEXIT_CRITICAL(&motorTrimMux);
+    }
+    return false;
+  }
+
+  uint8_t duty = 0;
+  if (abort || failsafeManager.isArmed()) {
+    MotorCal_abort(&cal);
+    LOG_INFO("[MotorCal] Motor %d: stopped\n", calMotor);
+  } else {
+    if (cal.feedback == MOTOR_CAL_FEEDBACK_ENCODER)
+      vehicle->readMotorCounts(calMotor, counts);
+    float amps = batteryAdvanced && powerSource != POWER_SOURCE_NONE ? powerMonitor.amps : NAN;
+    duty = MotorCal_update(&cal, now, counts, amps);
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    Motor *motor = vehicle->getMotor(i);
+    if (motor)
+      motor->prepareDuty(i == calMotor ? duty : 0, batch);
+  }
+  batch.commit();
+
+  portENTER_CRITICAL(&motorTrimMux);
+  if (cal.state == MOTOR_CAL_DONE && calMotor < MOTOR_TRIM_MAX) {
+    motorTrims.motors[calMotor].minPWM = MotorCal_minPwm(&cal);
+    motorTrimRevision++;
+    motorTrimSavePending = true;
+  }
+  motorCalStatus = cal;
+  motorCalStatusMotor = calMotor;
+  portEXIT_CRITICAL(&motorTrimMux);
+  if (cal.state == MOTOR_CAL_DONE)
+    LOG_INFO("[MotorCal] Motor %d breaks away at duty %u: minPWM %u\n", calMotor,
+             cal.breakaway, MotorCal_minPwm(&cal));
+  else if (cal.state == MOTOR_CAL_FAILED)
+    LOG_WARN("[MotorCal] Motor %d: no breakaway up to duty %u\n", calMotor, MOTOR_CAL_MAX_DUTY);
+  return true;
+}
+
+/**
+ * Outer loop tick (RateProfile): links and sticks, failsafe, navigation,
+ * battery, then the inner loop's work on the new inputs
+ */
+void controlOuterTick(uint32_t currentTime) {
+  PROFILE_SCOPE("control");
+  TRACE_SCOPE(TRACE_EV_CONTROL);
+  uint32_t loopStartCycles = PROFILE_CYCLES();
+  Watchdog_feed(&watchdog, watchdogControl);
+  Trace_sync();
+  failsafeManager.update(currentTime);
+
+  // Phase 10: Autonomous Navigation Logic
+  // 0. Swap in a bulk-uploaded mission (only this task reads the mission)
+  WaypointManager::getInstance().applyUpload();
+
+  // 1. Latest GPS fix (the gps task owns the UART)
+  GPSFix gpsFix;
+  if (gpsManager && gpsManager->getFix(gpsFix)) {
+      NavigationManager::getInstance().setGPSFix(gpsFix);
+      if (gpsManager->getFixCount() != gpsTopicFixes) {
+          gpsTopicFixes = gpsManager->getFixCount();
+          topicGps.publish(gpsFix);
+      }
+  }
+  
+  // 2. Update Nav Manager (fused position / heading, raw GPS as fallback)
+  bool imuReady = updateAttitude();
+  updatePosition(imuReady);
+  float currentHeading = estimateHeading(imuReady);
+  feedFormationLeader();
+  feedObstacleRange(HAL_GetMillis());
+  {
+    TRACE_SCOPE(TRACE_EV_NAV);
+    NavigationManager &nav = NavigationManager::getInstance();
+    if (PositionEstimator_isHealthy(&position)) {
+      NavVector fused = PositionEstimator_getPosition(&position);
+      nav.update(fused, currentHeading);
+      NavFrame_toGlobal(&nav.getFrame(), fused, &navInputLatE7, &navInputLngE7);
+    } else {
+      nav.getGPSLocationE7(navInputLatE7, navInputLngE7);
+      nav.update(navInputLatE7, navInputLngE7, currentHeading);
+    }
+  }
+  publishFormationSelf(currentHeading);
+
+  checkGeofence();
+
+  // Stick shaping edited from a command: samples are kept
+  static uint32_t inputRevision = 0;
+  if (inputConfigRevision != inputRevision) {
+    portENTER_CRITICAL(&inputMux);
+    inputRevision = inputConfigRevision;
+    InputConditioner_setConfig(&inputConditioner, &inputConfig);
+    portEXIT_CRITICAL(&inputMux);
+  }
+
+  // Take the newest verified frame from each link (older ones are
+  // superseded) and offer it; only the arbiter's pick drives
+  RadioFrame frames[2];
+  bool verified[2] = {false, false};
+  LatencyTrace latency;
+  bool probing = false;
+  if (!rxVerifyTask)
+    verifyControlFrames();
+  ControlRing *const controlRings[2] = {&radioVerifiedRing, &wsVerifiedRing}; // CONTROL_LINK_ order
+  for (uint8_t i = 0; i < 2; i++)
+    verified[i] = controlRings[i]->readLatest(frames[i]);
+  SerialFrame serialRx;
+  bool haveSerial = serialRxRing.readLatest(serialRx);
+  RcSample rc;
+  RcConfig map;
+  bool haveRc = false;
+  uint32_t rcDequeuedUs = 0;
+  if (rcReceiver && rcReceiver->readLatest(rc)) {
+    rcDequeuedUs = HAL_GetMicros();
+    portENTER_CRITICAL(&rcMux);
+    map = rcConfig;
+    portEXIT_CRITICAL(&rcMux);
+    // A receiver in failsafe counts as no frame: the link timeout acts
+    bool live = !(rc.channels.flags & RC_FLAG_FAILSAFE);
+    if (map.enabled) {
+      failsafeManager.recordPacketReceived(HAL_GetMillis(), live);
+      haveRc = live;
+    }
+  }
+
+  portENTER_CRITICAL(&arbiterMux);
+  for (uint8_t i = 0; i < 2; i++) {
+    if (verified[i])
+      ControlArbiter_offer(&controlArbiter, (ControlLink)i, macTag(frames[i].mac),
+                           frames[i].pkt.sequenceNumber, frames[i].arrivedUs);
+  }
+  if (haveSerial)
+    ControlArbiter_offer(&controlArbiter, CONTROL_LINK_SERIAL, 0, serialRx.pkt.sequenceNumber,
+                         serialRx.arrivedUs);
+  if (haveRc)
+    ControlArbiter_offer(&controlArbiter, CONTROL_LINK_RC, 0, rc.sequence, rc.rxUs);
+  int winner = ControlArbiter_select(&controlArbiter, &arbiterConfig);
+  int64_t winnerUs = winner >= 0 ? controlArbiter.appliedUs : 0;
+  uint8_t healthChanged = ControlArbiter_update(&controlArbiter, &arbiterConfig, HAL_Now());
+  uint8_t healthy = ControlArbiter_healthyMask(&controlArbiter);
+  portEXIT_CRITICAL(&arbiterMux);
+  for (uint8_t i = 0; i < CONTROL_LINK_COUNT; i++) {
+    if (healthChanged & (1 << i))
+      LOG_INFO("[CTL] Link %s %s\n", ControlArbiter_linkName((ControlLink)i),
+               (healthy & (1 << i)) ? "up" : "lost");
+  }
+
+  bool rcApplied = false;
+  if (winner == CONTROL_LINK_RADIO || winner == CONTROL_LINK_WS) {
+    const RadioFrame &frame = frames[winner];
+    memcpy(&latestPacket, &frame.pkt, sizeof(NAPacket));
+    sampleSticks(latestPacket, frame.arrivedUs);
+    probing = frame.rxUs != 0 && latencyProbeEnabled;
+    latency.sequence = frame.pkt.sequenceNumber;
+    latency.stampUs[LATENCY_POINT_RX] = frame.rxUs;
+    latency.stampUs[LATENCY_POINT_QUEUED] = frame.queuedUs;
+    latency.stampUs[LATENCY_POINT_DEQUEUED] = frame.dequeuedUs;
+    latency.stampUs[LATENCY_POINT_VERIFIED] = frame.verifiedUs;
+  } else if (winner == CONTROL_LINK_SERIAL) {
+    // Serial "sm" only drives the stick axes
+    latestPacket.throttle = serialRx.pkt.throttle;
+    latestPacket.roll = serialRx.pkt.roll;
+    latestPacket.pitch = serialRx.pkt.pitch;
+    latestPacket.yaw = serialRx.pkt.yaw;
+    latestPacket.sequenceNumber = serialRx.pkt.sequenceNumber;
+    sampleSticks(latestPacket, serialRx.arrivedUs);
+  } else if (winner == CONTROL_LINK_RC) {
+    int16_t sticks[RC_AXES];
+    bool autoOn = RcInput_toSticks(&map, &rc.channels, sticks);
+    latestPacket.throttle = sticks[0];
+    latestPacket.roll = sticks[1];
+    latestPacket.pitch = sticks[2];
+    latestPacket.yaw = sticks[3];
+    if (map.autoChannel != RC_CHANNEL_NONE)
+      latestPacket.mode = autoOn ? (latestPacket.mode | MODE_AUTO)
+                                 : (latestPacket.mode & ~MODE_AUTO);
+    latestPacket.sequenceNumber = rc.sequence;
+    sampleSticks(latestPacket, rc.rxUs);
+    rcApplied = true;
+  }
+  // A parked vehicle wakes on the first applied frame, before it drives
+  if (winner >= 0) {
+    portENTER_CRITICAL(&pmMux);
+    PowerPolicy_frame(&powerPolicy, winnerUs);
+    portEXIT_CRITICAL(&pmMux);
+  }
+  updatePowerMode(currentTime);
+  NAPacket cmd = latestPacket;
+
+  // Sticks for this tick, shaped across the gap since the last frame
+  // (past maxGapMs: the last frame, as before, until failsafe acts)
+  int16_t axes[INPUT_COND_AXES];
+  portENTER_CRITICAL(&inputMux);
+  bool fresh = InputConditioner_output(&inputConditioner, HAL_Now(),
+                                       controlOuterDt, axes);
+  portEXIT_CRITICAL(&inputMux);
+  if (fresh) {
+    cmd.throttle = axes[0];
+    cmd.roll = axes[1];
+    cmd.pitch = axes[2];
+    cmd.yaw = axes[3];
+  }
+  NAPacket pilot = cmd; // Blackbox: replay input
+
+  // Failsafe actions, every tick: a lost link stops driving the motors
+  // from the last packet within one control period
+  applyFailsafe(cmd);
+
+  // 3. Apply Auto Inputs if Mode is Auto
+  bool navigating = false;
+  if (cmd.mode & MODE_AUTO) {
+      int16_t navThrottle = 0;
+      int16_t navYaw = 0;
+      if (NavigationManager::getInstance().getNavigationOutput(navThrottle, navYaw)) {
+          cmd.throttle = navThrottle;
+          cmd.roll = navYaw; // Use Roll channel for Steering
+          navigating = true;
+      } else if (NavigationManager::getInstance().getState().isRTLActive) {
+          // RTL Reached Home
+          NavigationManager::getInstance().stopMission();
+          cmd.throttle = 0;
+          cmd.roll = 0;
+          latestPacket.throttle = 0;
+          latestPacket.roll = 0;
+          // ...and the conditioner must not bring the old sticks back
+          portENTER_CRITICAL(&inputMux);
+          InputCondConfig shaping = inputConditioner.config;
+          InputConditioner_init(&inputConditioner, &shaping);
+          portEXIT_CRITICAL(&inputMux);
+          LOG_INFO("[Nav] RTL Mission Complete: Reached Home.\n");
+      }
+  }
+  updateEnergyControl(cmd, navigating);
+  updateAltitudeHold(cmd, navigating);
+  
+  // Phase 14: RTL Triggers (Battery & Failsafe)
+  // Sag-compensated charge / time left, latched with hysteresis
+  bool batteryAdvanced = updateBatteryModel();
+  if (batteryAdvanced && BatteryEstimator_rtlRequired(&batteryModel)) {
+      if (!NavigationManager::getInstance().getState().isRTLActive) {
+          LOG_WARN("[Battery] Low battery (%u%%, %lds left)! Triggering RTL.\n",
+                   BatteryEstimator_getPercent(&batteryModel),
+                   (long)BatteryEstimator_getRemainingSeconds(&batteryModel));
+          NavigationManager::getInstance().executeRTL();
+      }
+  }
+  // Not enough charge left to fly home from here at the measured mAh/m
+  if (batteryAdvanced && powerMonitor.rtl &&
+      !NavigationManager::getInstance().getState().isRTLActive) {
+      LOG_WARN("[Power] Return budget short (%.0f mAh left, %.0f mAh home)! Triggering RTL.\n",
+               (double)PowerMonitor_availableMah(&powerMonitor), (double)powerMonitor.returnMah);
+      NavigationManager::getInstance().executeRTL();
+  }
+
+  // Set Home on first valid GPS fix (unless a warm restart brought it back)
+  if (!NavigationManager::getInstance().hasHome() &&
+      NavigationManager::getInstance().isGPSLocked()) {
+      float hLat, hLng;
+      NavigationManager::getInstance().getGPSLocation(hLat, hLng);
+      NavigationManager::getInstance().setHome(hLat, hLng);
+  }
+
+  // Hot-swap PID gains edited from the configurator (no reboot)
+  static uint32_t pidRevision = 0;
+  if (configManager && configManager->getPIDRevision() != pidRevision) {
+    pidRevision = configManager->getPIDRevision();
+    vehicle->setPIDConfig(configManager->getPIDConfig());
+  }
+  static uint32_t fbwApplied = 0;
+  if (fbwRevision != fbwApplied) {
+    portENTER_CRITICAL(&fbwMux);
+    fbwApplied = fbwRevision;
+    FbwConfig fbw = fbwConfig;
+    portEXIT_CRITICAL(&fbwMux);
+    vehicle->setFlyByWireConfig(fbw);
+  }
+  static uint32_t odomApplied = 0;
+  if (odomRevision != odomApplied) {
+    portENTER_CRITICAL(&odomMux);
+    odomApplied = odomRevision;
+    OdometryConfig odom = odomConfig;
+    portEXIT_CRITICAL(&odomMux);
+    vehicle->setOdometryConfig(odom);
+  }
+  static uint32_t thrustApplied = 0;
+  if (thrustRevision != thrustApplied) {
+    portENTER_CRITICAL(&thrustMux);
+    thrustApplied = thrustRevision;
+    ThrustCurveConfig thrust = thrustConfig;
+    portEXIT_CRITICAL(&thrustMux);
+    vehicle->setThrustCurveConfig(thrust);
+  }
+  if (batteryAdvanced)
+    vehicle->setSupplyVoltage(batteryModel.mv / BATTERY_CELLS, currentTime);
+  applyMotorConfig();
+
+#if FEATURE_DEPTH
+  // Depth hold at the outer loop rate, on the sensor task's latest depth
+  DepthManager::getInstance().updateControl(controlOuterDt);
+#endif
+
+  {
+    PROFILE_SCOPE("vehicle");
+    motorCalOwnsOutputs = runMotorCal(currentTime, batteryAdvanced);
+    if (!motorCalOwnsOutputs)
+      vehicle->setInputs(&cmd);
+    if (probing)
+      latency.stampUs[LATENCY_POINT_INPUTS] = HAL_GetMicros();
+    if (!motorCalOwnsOutputs)
+      vehicle->loop(RateSchedule_innerDt(&rateSchedule));
+  }
+  if (probing) {
+    // loop() has committed the actuator outputs (MotorBatch / LEDC)
+    latency.stampUs[LATENCY_POINT_COMMIT] = HAL_GetMicros();
+    portENTER_CRITICAL(&latencyMux);
+    LatencyProbe_record(&latencyProbe, &latency);
+    portEXIT_CRITICAL(&latencyMux);
+  }
+  if (rcApplied) {
+    uint32_t rxUs = (uint32_t)rc.rxUs;
+    uint32_t committedUs = HAL_GetMicros();
+    portENTER_CRITICAL(&rcMux);
+    LatencyProbe_add(&rcLatency[0], rcDequeuedUs - rxUs);
+    LatencyProbe_add(&rcLatency[1], committedUs - rxUs);
+    portEXIT_CRITICAL(&rcMux);
+  }
+  if (pwmExpanderFitted)
+    updatePwmExpander();
+
+  publishControlTopics(cmd, currentHeading, imuReady, batteryAdvanced, currentTime);
+  saveWarmRestart(currentTime);
+
+  uint32_t loopCycles = PROFILE_CYCLES() - loopStartCycles;
+  logBlackbox(cmd, pilot, currentHeading, imuReady, loopCycles);
+  MemoryProfiler_recordLoop(loopCycles);
+}
+
+/**
+ * Inner loop tick between outer ones: the gyro samples since the last
+ * tick, then the vehicle's rate loop and actuator commit on the inputs
+ * the last outer tick set
+ */
+void controlInnerTick() {
+  PROFILE_SCOPE("inner");
+  updateAttitude();
+  if (!motorCalOwnsOutputs)
+    vehicle->loop(RateSchedule_innerDt(&rateSchedule));
+}
+
+/**
+ * Control task body, at the vehicle's inner rate: the outer loop every
+ * outerDiv ticks, held back a tick after a deadline miss (RateProfile)
+ */
+void controlTick(uint32_t currentTime) {
+  uint32_t startUs = HAL_GetMicros();
+  if (rateStatsResetRequest) {
+    rateStatsResetRequest = false;
+    RateSchedule_resetStats(&rateSchedule);
+  }
+  bool outer = RateSchedule_begin(&rateSchedule);
+  if (outer) {
+    controlOuterDt = RateSchedule_outerDt(&rateSchedule);
+    controlOuterTick(currentTime);
+  } else {
+    controlInnerTick();
+  }
+  RateSchedule_end(&rateSchedule, outer, HAL_GetMicros() - startUs);
+}
+
+#if FEATURE_MAG
+/**
+ * Take a new magnetometer sample (sensor task): refine the calibration,
+ * hand a new fit to the comms task for storage and publish the field
+ */
+void serviceMag(uint32_t now) {
+  static uint32_t lastSaveMs = 0;
+  static bool fitStored = false;          // Since boot / reset
+  static bool unsaved = false;
+  portENTER_CRITICAL(&magMux);
+  bool reset = magCalResetRequest;
+  bool learn = magConfig.learn;
+  magCalResetRequest = false;
+  portEXIT_CRITICAL(&magMux);
+  if (reset) {
+    MagCal_reset(&magCal);
+    fitStored = false;
+  }
+  const float *raw = mag.field();
+  if (learn && MagCal_feed(&magCal, raw))
+    unsaved = true;
+
+  // First fit at once, refinements at most every MAG_CAL_SAVE_INTERVAL_MS
+  bool save = reset || (unsaved && (!fitStored || now - lastSaveMs >= MAG_CAL_SAVE_INTERVAL_MS));
+  if (save) {
+    portENTER_CRITICAL(&magMux);
+    magCalPending = magCal.cal;
+    magCalSavePending = true;
+    portEXIT_CRITICAL(&magMux);
+    fitStored = magCal.cal.valid;
+    unsaved = false;
+    lastSaveMs = now;
+  }
+
+  MagMsg msg;
+  MagCal_correct(&magCal, raw, msg.field);
+  for (int i = 0; i < 3; i++)
+    msg.raw[i] = raw[i];
+  msg.radiusUt = magCal.cal.radiusUt;
+  msg.residual = magCal.cal.residual;
+  msg.coverage = magCal.cal.coverage;
+  msg.valid = magCal.cal.valid;
+  msg.planar = magCal.cal.planar;
+  msg.disturbed = MagCal_disturbed(&magCal, msg.field);
+  msg.fits = magCal.fits;
+  msg.accepted = magCal.accepted;
+  msg.sampleCount = mag.getSampleCount();
+  msg.timeMs = now;
+  topicMag.publish(msg);
+}
+#endif
+
+/**
+ * Sensor task: slow / blocking peripheral reads kept off the control core.
+ */
+void sensorTick(uint32_t currentTime) {
+  PROFILE_SCOPE("sensor");
+  TRACE_SCOPE(TRACE_EV_DEPTH);
+#if FEATURE_DEPTH
+  // Phase 13: Sub-Surface Logic (polls the MS5837 conversion, never waits)
+  DepthManager &depth = DepthManager::getInstance();
+  depth.update();
+  if (depth.getSampleCount() != depthTopicSamples) {
+    depthTopicSamples = depth.getSampleCount();
+    DepthMsg msg;
+    msg.depth = depth.getActualDepth();
+    msg.targetDepth = depth.getTargetDepth();
+    msg.diving = depth.isDiving();
+    msg.sampleCount = depthTopicSamples;
+    topicDepth.publish(msg);
+  }
+#endif
+
+#if FEATURE_PITOT
+  // Pitot for the Plane energy controller (one queued read per 20 ms)
+  if (pitotFitted && pitot.update(HAL_GetMicros())) {
+    airspeedTopicSamples = pitot.getSampleCount();
+    AirspeedMsg msg;
+    msg.airspeed = pitot.airspeed();
+    msg.differentialPa = pitot.differentialPa();
+    msg.temperature = pitot.temperature();
+    msg.sampleCount = airspeedTopicSamples;
+    msg.timeMs = HAL_GetMillis();
+    topicAirspeed.publish(msg);
+  }
+#endif
+
+#if FEATURE_RANGE
+  // Forward rangefinder (RMT-timed echo, a trigger every RANGE_PERIOD_MS)
+  if (rangeFitted && ranger.update(HAL_GetMicros())) {
+    RangeMsg msg;
+    msg.range = RangeFilter_add(&rangeFilter, Rangefinder_echoToMeters(ranger.echoUs()));
+    msg.echoUs = ranger.echoUs();
+    msg.sampleCount = ranger.getSampleCount();
+    msg.missed = ranger.getMissedCount();
+    msg.timeMs = HAL_GetMillis();
+    topicRange.publish(msg);
+  }
+#endif
+
+#if FEATURE_MAG
+  // Magnetometer (one queued read per 20 ms)
+  if (magFitted && mag.update(HAL_GetMicros()))
+    serviceMag(HAL_GetMillis());
+#endif
+
+#if FEATURE_BARO
+  // Barometer (polls the MS5611 conversion, never waits)
+  if (baroFitted && baro.update(HAL_GetMicros())) {
+    BaroMsg msg;
+    msg.pressurePa = baro.pressure() * 100.0f;
+    msg.temperature = baro.temperature();
+    msg.sampleCount = baro.getSampleCount();
+    msg.timeMs = HAL_GetMillis();
+    topicBaro.publish(msg);
+  }
+#endif
+}
+
+/**
+ * Blackbox task: flash writes of the flight log, lowest priority.
+ */
+void blackboxTick(uint32_t currentTime) {
+  Blackbox_service();
+}
+
+/**
+ * Log task: move queued log lines and telemetry frames to the UART.
+ * A message is written only once the TX ring has room for all of it, so
+ * it never blocks and never splits around a command reply from comms.
+ */
+void logTick(uint32_t currentTime) {
+  const uint8_t *data;
+  size_t len;
+  while ((len = Log_peek(&data)) > 0) {
+    if ((size_t)Serial.availableForWrite() < len)
+      break;
+    Log_consume(Serial.write(data, len));
+  }
+}
+
+/**
+ * Display task: redraw the status text twice a second from the topics,
+ * then send at most one changed piece of the screen per tick. Only rows
+ * whose text changed reach the bus.
+ */
+void displayTick(uint32_t currentTime) {
+  if (!oledFitted)
+    return;
+  static uint32_t lastRenderMs = 0;
+  static bool rendered = false;
+  if (!rendered || currentTime - lastRenderMs >= DISPLAY_RENDER_MS) {
+    rendered = true;
+    lastRenderMs = currentTime;
+
+    StatusScreenData data;
+    memset(&data, 0, sizeof(data));
+    data.vehicle = vehicle->getName();
+    switch (failsafeManager.getState()) {
+    case FAILSAFE_ARMED:
+      data.link = STATUS_LINK_OK;
+      break;
+    case FAILSAFE_SIGNAL_LOSS:
+      data.link = STATUS_LINK_LOST;
+      break;
+    case FAILSAFE_EMERGENCY:
+      data.link = STATUS_LINK_FAILSAFE;
+      break;
+    default:
+      data.link = STATUS_LINK_NONE;
+      break;
+    }
+    BatteryMsg battery;
+    if (topicBattery.read(battery)) {
+      data.batteryValid = true;
+      data.millivolts = battery.millivolts;
+      data.percent = battery.percent;
+    }
+    GPSFix fix;
+    if (topicGps.read(fix)) {
+      data.gpsValid = true;
+      data.fixType = fix.fixType;
+      data.numSV = fix.numSV;
+      data.carrSoln = fix.carrSoln;
+      data.hAccMm = fix.hAcc;
+    }
+    NavigationState nav;
+    if (topicNavState.read(nav)) {
+      data.missionActive = nav.isMissionActive;
+      data.rtlActive = nav.isRTLActive;
+      data.loitering = nav.isLoitering;
+      data.surveyActive = nav.isSurveyActive;
+      data.following = nav.isFollowing;
+      data.waypointIndex = nav.currentWaypointIndex;
+      data.distanceM = nav.distanceToTarget;
+    }
+    data.waypointCount = WaypointManager::getInstance().getWaypointCount();
+    data.uptimeS = currentTime / 1000;
+
+    char lines[STATUS_SCREEN_ROWS][STATUS_SCREEN_COLUMNS + 1];
+    StatusScreen_format(&data, lines);
+    for (uint8_t row = 0; row < STATUS_SCREEN_ROWS; row++)
+      oled.setLine(row, lines[row]);
+  }
+  oled.flush();
+}
+
+/**
+ * Noise task: gyro spectrum for the dynamic notch (Copter only). Drains
+ * the raw rates the control task queued and publishes a new notch each
+ * time the tracked peak moves.
+ */
+void noiseTick(uint32_t currentTime) {
+  static uint32_t revision = 0;
+  if (dynNotchRevision != revision) {
+    portENTER_CRITICAL(&dynNotchMux);
+    revision = dynNotchRevision;
+    DynNotchConfig config = dynNotchConfig;
+    portEXIT_CRITICAL(&dynNotchMux);
+    DynamicNotch_init(&dynNotch, &config, IMU_SAMPLE_RATE_HZ);
+  }
+  if (!dynNotch.config.enabled)
+    return;
+
+  GyroNoiseFrame frame;
+  bool moved = false;
+  while (gyroNoiseRing.readNext(frame)) {
+    if (DynamicNotch_push(&dynNotch, frame.rates))
+      moved |= DynamicNotch_analyze(&dynNotch);
+  }
+  if (moved) {
+    GyroNotchMsg msg;
+    msg.centerHz = dynNotch.centerHz;
+    DynamicNotch_coefs(&dynNotch, &msg.coefs);
+    msg.peakSnr = dynNotch.peakSnr;
+    msg.timeMs = currentTime;
+    topicGyroNotch.publish(msg);
+  }
+}
+
+/**
+ * Telemetry event for a background mission write (comms task)
+ */
+void reportMissionSaved(const MissionPersistEvent &saved) {
+  JsonArenaScope arenaScope(commandArena);
+  JsonDocument doc(&commandArena);
+  doc["t"] = 1;
+  doc["msg"] = saved.ok ? "Mission saved" : "Mission save failed";
+  doc["ok"] = saved.ok;
+  doc["n"] = saved.count;
+  doc["rev"] = saved.revision;
+  char line[LOG_SLOT_SIZE];
+  size_t len = serializeJson(doc, line, sizeof(line) - 1);
+  line[len++] = '\r';
+  line[len++] = '\n';
+  Log_write((const uint8_t *)line, len);
+}
+
+// ============================================================================
+// Background Jobs
+// ============================================================================
+
+/**
+ * Control task near its budget: last tick past CONTROL_BUSY_PERCENT of
+ * the period, or an overrun since the caller last looked. Flash writes
+ * stall the cache of both cores, so they wait for a quiet control loop.
+ */
+bool controlLoopBusy(uint32_t *seenOverruns) {
+  SchedulerTaskStats control; // Task 0 (startScheduler)
+  if (!TaskScheduler_isRunning() || !TaskScheduler_getStats(0, &control))
+    return false;
+  bool overran = control.overrunCount != *seenOverruns;
+  *seenOverruns = control.overrunCount;
+  return overran || control.lastExecTimeUs > control.periodMs * 10 * CONTROL_BUSY_PERCENT;
+}
+
+/**
+ * Time left of a task period that started at startUs
+ */
+uint32_t jobSliceUs(uint32_t startUs, uint32_t periodMs) {
+  uint32_t elapsed = HAL_GetMicros() - startUs;
+  return elapsed < periodMs * 1000 ? periodMs * 1000 - elapsed : 0;
+}
+
+// Coalesced NVS write-back of config and mission changes, off the
+// control core (comms task)
+void configJob(uint32_t nowMs) {
+  if (configManager)
+    configManager->update(nowMs);
+}
+
+void calSaveJob(uint32_t nowMs) {
+  ImuCalRecord calRecord;
+  portENTER_CRITICAL(&imuCalMux);
+  bool saveCal = imuCalSavePending;
+  calRecord = imuCalPending;
+  imuCalSavePending = false;
+  portEXIT_CRITICAL(&imuCalMux);
+  if (saveCal && ConfigManager::saveBlob(IMU_CAL_CONFIG_KEY, &calRecord, sizeof(calRecord)))
+    imuCalSaves++;
+  MagCalRecord magRecord;
+  portENTER_CRITICAL(&magMux);
+  bool saveMag = magCalSavePending;
+  magRecord = magCalPending;
+  magCalSavePending = false;
+  portEXIT_CRITICAL(&magMux);
+  if (saveMag && ConfigManager::saveBlob(MAG_CAL_RECORD_KEY, &magRecord, sizeof(magRecord)))
+    magCalSaves++;
+  MotorTrimTable trims;
+  portENTER_CRITICAL(&motorTrimMux);
+  bool saveTrims = motorTrimSavePending;
+  trims = motorTrims;
+  motorTrimSavePending = false;
+  portEXIT_CRITICAL(&motorTrimMux);
+  if (saveTrims)
+    ConfigManager::saveBlob(MOTOR_TRIM_CONFIG_KEY, &trims, sizeof(trims));
+}
+
+void missionSaveJob(uint32_t nowMs) {
+  MissionPersistEvent saved;
+  if (WaypointManager::getInstance().update(nowMs, &saved))
+    reportMissionSaved(saved);
+}
+
+void taskScanJob(uint32_t nowMs) {
+  MemoryProfiler_scanTasks();
+}
+
+#if FEATURE_WEB
+void wsCleanupJob(uint32_t nowMs) {
+  TelemetryWebSocket::getInstance().cleanUp();
+}
+#endif
+
+/**
+ * Register the housekeeping jobs (before the tasks start). Budgets are
+ * typical NVS write times; a GC erase runs over and is counted.
+ */
+void initBackgroundJobs(uint32_t nowMs) {
+  JobExecutor_init(&commsJobs, HAL_GetMicros);
+  JobExecutor_add(&commsJobs, "config", configJob, 50, 4000, nowMs);
+  JobExecutor_add(&commsJobs, "cal_save", calSaveJob, 100, 4000, nowMs);
+  JobExecutor_add(&commsJobs, "mission", missionSaveJob, 100, 6000, nowMs);
+  JobExecutor_add(&commsJobs, "task_scan", taskScanJob, TASK_SCAN_INTERVAL_MS, 1000, nowMs);
+  JobExecutor_init(&telemetryJobs, HAL_GetMicros);
+#if FEATURE_WEB
+  JobExecutor_add(&telemetryJobs, "ws_cleanup", wsCleanupJob, 1000, 300, nowMs);
+#endif
+}
+
+/**
+ * Comms task: serial command handling, then housekeeping jobs in the
+ * rest of the period.
+ */
+void commsTick(uint32_t currentTime) {
+  PROFILE_SCOPE("comms");
+  static uint32_t controlOverruns = 0;
+  uint32_t startUs = HAL_GetMicros();
+  Watchdog_feed(&watchdog, watchdogComms);
+  LoopTiming_updateCoreLoad();
+  Trace_sync();
+  handleSerialCommand();
+#if FEATURE_BLE
+  handleBleCommand();
+#endif
+  mavlinkPoll(currentTime);
+  WifiLink_service(currentTime);
+
+  if (currentTime - lastRateLimitRefill >= REFILL_INTERVAL_MS) {
+    RateLimitManager_refill();
+    lastRateLimitRefill = currentTime;
+  }
+
+  JobExecutor_run(&commsJobs, currentTime, jobSliceUs(startUs, COMMS_PERIOD_MS),
+                  controlLoopBusy(&controlOverruns));
+}
+
+// ESP-NOW telemetry: keyframes + deltas (telemetry task only)
+TelemetryDeltaEncoder telemetryEncoder;
+
+/**
+ * Key for a broadcast frame tag: derived from the shared secret under its
+ * own label, never the secret itself, so a tag is never usable as a
+ * control frame HMAC
+ * @param ready Whether key holds a previous key to free
+ * @return true if key is set
+ */
+bool deriveBroadcastKey(const char *label, CryptoHmacKey *key, bool ready) {
+  ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
+  CryptoHmacKey master;
+  uint8_t derived[32];
+  CryptoBackend_hmacSetKey(&master, sec.sharedSecret, sizeof(sec.sharedSecret));
+  CryptoBackend_hmacSha256(&master, (const uint8_t *)label, strlen(label), derived);
+  CryptoBackend_hmacFree(&master);
+  if (ready)
+    CryptoBackend_hmacFree(key);
+  bool ok = CryptoBackend_hmacSetKey(key, derived, sizeof(derived)) == 0;
+  memset(derived, 0, sizeof(derived));
+  return ok;
+}
+
+/**
+ * Truncated beacon tag: HMAC-SHA256 under the formation key
+ */
+void formationTag(const NAFormationBeacon &beacon, uint8_t tag[NA_BEACON_TAG_SIZE]) {
+  uint8_t mac[32];
+  CryptoBackend_hmacSha256(&formationKey, (const uint8_t *)&beacon, NA_BEACON_AUTH_SIZE,
+                           mac);
+  memcpy(tag, mac, NA_BEACON_TAG_SIZE);
+}
+
+/**
+ * Formation beacons (telemetry task): authenticate queued neighbour
+ * beacons into the table, then send our own once the budgeted interval
+ * is up. Jittered by up to 1/8 interval so vehicles that started together
+ * do not stay in lockstep and collide.
+ */
+void formationTick(uint32_t currentTime) {
+  if (formationRekey) {
+    formationRekey = false;
+    formationKeyReady = deriveBroadcastKey(FORMATION_KEY_LABEL, &formationKey, formationKeyReady);
+  }
+  if (!formationKeyReady)
+    return;
+
+  BeaconFrame rx;
+  while (beaconRxRing.readNext(rx)) {
+    uint8_t tag[NA_BEACON_TAG_SIZE];
+    formationTag(rx.beacon, tag);
+    uint8_t diff = 0;
+    for (int i = 0; i < NA_BEACON_TAG_SIZE; i++)
+      diff |= tag[i] ^ rx.beacon.tag[i];
+    if (diff) {
+      formationBadTag++;
+      continue;
+    }
+    FormationState state;
+    NA_Beacon_toState(&rx.beacon, &state);
+    portENTER_CRITICAL(&formationMux);
+    FormationTable_update(&formationTable, rx.mac, rx.beacon.sequence, &state, rx.rxMs);
+    portEXIT_CRITICAL(&formationMux);
+  }
+
+  static uint32_t nextBeaconMs = 0;
+  portENTER_CRITICAL(&formationMux);
+  FormationConfig config = formationConfig;
+  FormationState self = formationSelf;
+  uint8_t neighbors = FormationTable_liveCount(&formationTable, currentTime);
+  portEXIT_CRITICAL(&formationMux);
+  if (!config.enabled || (int32_t)(currentTime - nextBeaconMs) < 0 ||
+      !EspNowTx_canSend(BROADCAST_MAC, currentTime))
+    return;
+
+  uint16_t interval = FormationTable_intervalMs(config.rateHz, config.budgetBps, neighbors);
+  formationIntervalMs = interval;
+  nextBeaconMs = currentTime + interval + esp_random() % (interval / 8 + 1);
+
+  NAFormationBeacon beacon;
+  NA_Beacon_build(&beacon, config.group, ++formationSequence, &self);
+  formationTag(beacon, beacon.tag);
+  if (EspNowTx_send(BROADCAST_MAC, (const uint8_t *)&beacon, sizeof(beacon), currentTime))
+    formationSent++;
+}
+
+/**
+ * Truncated correction tag: HMAC-SHA256 under the RTK key
+ */
+void rtkTag(const NARtcmFragment &frag, uint8_t tag[NA_RTCM_TAG_SIZE]) {
+  uint8_t mac[32];
+  CryptoBackend_hmacSha256(&rtkKey, (const uint8_t *)&frag, NA_RTCM_AUTH_SIZE, mac);
+  memcpy(tag, mac, NA_RTCM_TAG_SIZE);
+}
+
+/**
+ * One queued correction fragment on a rover (telemetry task): a frame
+ * that completes goes straight into the receiver's UART TX ring
+ */
+void rtkAccept(const NARtcmFragment &frag) {
+  uint8_t tag[NA_RTCM_TAG_SIZE];
+  rtkTag(frag, tag);
+  uint8_t diff = 0;
+  for (int i = 0; i < NA_RTCM_TAG_SIZE; i++)
+    diff |= tag[i] ^ frag.tag[i];
+  if (diff) {
+    rtkBadTag++;
+    return;
+  }
+  const uint8_t *frame;
+  uint16_t frameLen;
+  if (RtcmReassembler_add(&rtkReassembler, frag.seq, NA_Rtcm_index(&frag), NA_Rtcm_count(&frag),
+                          frag.data, frag.len, &frame, &frameLen) &&
+      gpsManager)
+    gpsManager->injectCorrections(frame, frameLen);
+}
+
+/**
+ * RTK corrections (telemetry task). A base sends at most one fragment per
+ * tick and only while no other broadcast is in flight, so corrections
+ * fill idle airtime and never queue ahead of the control link.
+ */
+void rtkTick(uint32_t currentTime) {
+  if (rtkRekey) {
+    rtkRekey = false;
+    rtkKeyReady = deriveBroadcastKey(RTK_KEY_LABEL, &rtkKey, rtkKeyReady);
+  }
+  if (!rtkKeyReady)
+    return;
+
+  static NARtcmFragment pending;
+  static bool havePending = false;
+  NARtcmFragment frag;
+  switch (rtkMode) {
+  case RTK_ROVER:
+    // Radio first, then /ws: one source at a time (interleaved, the
+    // reassembler drops frames of both)
+    while (rtkRxRing.readNext(frag) || rtkWsRing.readNext(frag))
+      rtkAccept(frag);
+    break;
+  case RTK_BASE:
+    if (!havePending)
+      havePending = rtkTxRing.readNext(pending);
+    if (havePending && EspNowTx_canSend(BROADCAST_MAC, currentTime)) {
+      havePending = false;
+      rtkTag(pending, pending.tag);
+      if (EspNowTx_send(BROADCAST_MAC, (const uint8_t *)&pending, sizeof(pending), currentTime))
+        rtkSent++;
+    }
+    break;
+  default:
+    havePending = false;
+    break;
+  }
+}
+
+/**
+ * Link rate (telemetry task): apply controller acks, grade the link once
+ * per LINK_RATE_EVAL_MS from control frame loss / RSSI and our own failed
+ * sends to the telemetry peer
+ * @return Telemetry ticks per ESP-NOW telemetry frame
+ */
+uint8_t linkRateTick(const uint8_t *peer, uint32_t currentTime) {
+  static uint32_t lastEvalMs = 0;
+  static uint8_t lastPeer[6] = {0};
+  static uint32_t lastSent = 0, lastFailed = 0;
+
+  LinkRateFrame ack;
+  while (linkAckRing.readNext(ack)) {
+    portENTER_CRITICAL(&linkRateMux);
+    bool settled = LinkRate_onAck(&linkRate, &ack);
+    LinkTier tier = linkRate.tier;
+    portEXIT_CRITICAL(&linkRateMux);
+    if (settled)
+      LOG_INFO("[Link] Rate agreed: %s\n", LinkRate_tierName(tier));
+  }
+
+  if (rssiManager && currentTime - lastEvalMs >= LINK_RATE_EVAL_MS) {
+    lastEvalMs = currentTime;
+    EspNowTxStats tx;
+    uint32_t sent = 0, failed = 0;
+    if (EspNowTx_getPeerStats(peer, &tx)) {
+      sent = tx.sent;
+      failed = tx.failed + tx.timeouts;
     }
+    if (memcmp(peer, lastPeer, 6) != 0) {
+      // New destination: its counters are not this period's
+      memcpy(lastPeer, peer, 6);
+      lastSent = sent;
+      lastFailed = failed;
+    }
+    LinkSample sample;
+    sample.lossPercent = rssiManager->getPacketLossPercent();
+    sample.rssiDbm = rssiManager->getAverageRSSI_dBm();
+    sample.signalLost = rssiManager->isSignalLost();
+    sample.txSent = sent - lastSent;
+    sample.txFailed = failed - lastFailed;
+    lastSent = sent;
+    lastFailed = failed;
+
+    portENTER_CRITICAL(&linkRateMux);
+    LinkTier before = linkRate.tier;
+    LinkRate_evaluate(&linkRate, &sample);
+    LinkTier after = linkRate.tier;
+    portEXIT_CRITICAL(&linkRateMux);
+    if (after != before)
+      LOG_INFO("[Link] Rate %s -> %s\n", LinkRate_tierName(before),
+               LinkRate_tierName(after));
+  }
+
+  // PHY follows the rung LinkRate is on: LR or the configured fast rate
+  static LinkPhy appliedPhy = LINK_PHY_FAST;
+  portENTER_CRITICAL(&linkRateMux);
+  uint8_t divider = LinkRate_telemetryDivider(&linkRate, 1000 / TELEMETRY_PERIOD_MS);
+  LinkPhy phy = linkRate.phy;
+  wifi_phy_rate_t fastRate = espnowFastRate;
+  portEXIT_CRITICAL(&linkRateMux);
+  if (phy != appliedPhy &&
+      EspNowTx_setPhyRate(phy == LINK_PHY_LONG_RANGE ? ESPNOW_TX_LR_RATE : fastRate)) {
+    LOG_INFO("[Link] PHY %s -> %s\n", LinkRate_phyName(appliedPhy), LinkRate_phyName(phy));
+    appliedPhy = phy;
   }
+  return divider;
 }
 
 /**
- * Handle incoming serial commands (JSON via Web Configurator)
+ * Controller clock sync (telemetry task): take replies, and the next
+ * request when one is due and the tick's slot is free. Not while
+ * unpaired: a broadcast has no one clock to follow
+ * @return true if request should go out this tick
  */
-void handleSerialCommand() {
-  if (!Serial.available())
-    return;
+bool clockSyncTick(const uint8_t *peer, uint32_t currentTime, bool slotFree,
+                   ClockSyncFrame &request) {
+  ClockSyncRx rx;
+  while (clockSyncRing.readNext(rx)) {
+    portENTER_CRITICAL(&clockSyncMux);
+    ClockSync_onReply(&clockSync, &rx.frame, rx.rxUs);
+    portEXIT_CRITICAL(&clockSyncMux);
+  }
 
-  String cmd = Serial.readStringUntil('\n');
-  cmd.trim();
+  if (!slotFree || memcmp(peer, BROADCAST_MAC, 6) == 0 ||
+      !EspNowTx_canSend(peer, currentTime))
+    return false;
+  portENTER_CRITICAL(&clockSyncMux);
+  bool due = ClockSync_takeRequest(&clockSync, HAL_Now(), &request);
+  portEXIT_CRITICAL(&clockSyncMux);
+  return due;
+}
 
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, cmd);
+/**
+ * Read every telemetry source once for this tick
+ */
+static void sampleTelemetry(TelemetrySnapshot *snap, uint32_t now,
+                            bool encrypted) {
+  memset(snap, 0, sizeof(*snap));
+  snap->uptime = now;
+  snap->encrypted = encrypted;
+  int64_t utcUs;
+  if (gpsManager) {
+    snap->timeSync = gpsManager->toUtc(HAL_Now(), utcUs);
+    if (snap->timeSync != TIME_SYNC_NONE)
+      snap->utcMs = utcUs / 1000;
+  }
+  if (rssiManager) {
+    snap->rssi = rssiManager->getAverageRSSI_dBm();
+    snap->linkQuality = rssiManager->getLinkQuality();
+  }
 
-  if (error) {
-    JsonDocument errDoc;
-    errDoc["err"] = "JSON parse failed";
-    serializeJson(errDoc, Serial);
-    Serial.println();
-    return;
+  // Control / sensor task state through the topic bus, not the managers
+  BatteryMsg battery;
+  if (topicBattery.read(battery))
+    snap->batteryMv = battery.millivolts;
+  GPSFix fix;
+  if (topicGps.read(fix) && fix.valid && now - fix.timeMs < GPS_FIX_TIMEOUT_MS) {
+    snap->lat = (float)(fix.lat / (double)NAV_FRAME_E7);
+    snap->lng = (float)(fix.lng / (double)NAV_FRAME_E7);
+    snap->latE7 = fix.lat;
+    snap->lngE7 = fix.lng;
+    snap->groundSpeed = fix.groundSpeed / 1000.0f;
+    snap->status |= TELEMETRY_STATUS_GPS_LOCK;
+  }
+  AttitudeMsg att;
+  if (topicAttitude.read(att)) {
+    snap->roll = att.roll * RAD_TO_DEG;
+    snap->pitch = att.pitch * RAD_TO_DEG;
+    snap->heading = att.heading;
+  }
+  NavigationState nav;
+  if (topicNavState.read(nav)) {
+    snap->wpIndex = nav.currentWaypointIndex;
+    snap->navFlags = (nav.isMissionActive ? TELEMETRY_NAV_MISSION_ACTIVE : 0) |
+                     (nav.isWaypointReached ? TELEMETRY_NAV_WP_REACHED : 0) |
+                     (nav.isRTLActive ? TELEMETRY_NAV_RTL_ACTIVE : 0);
+    snap->dist = nav.distanceToTarget;
+    snap->headingError = nav.headingError;
+  }
+  DepthMsg depth;
+  if (topicDepth.read(depth)) {
+    snap->depth = depth.depth;
+    snap->targetDepth = depth.targetDepth;
+    snap->diving = depth.diving;
   }
+  snap->failsafe = (uint8_t)failsafeManager.getState();
 
-  const char *command = doc["c"];
-  if (!command)
-    return;
+  MemoryStats mem = MemoryProfiler_getMemoryStats();
+  CPUStats cpu = MemoryProfiler_getCPUStats();
+  snap->heapPct = mem.memoryUtilization;
+  snap->cpuPct = cpu.cpuLoadPercent;
+  snap->maxLoopUs = cpu.maxLoopExecutionTimeUs;
+}
 
-  // Rate Limiting
-  if (RateLimitManager_checkCommand(1) != RATE_LIMIT_ALLOWED) {
-    JsonDocument errDoc;
-    errDoc["err"] = "Rate limit exceeded";
-    serializeJson(errDoc, Serial);
-    Serial.println();
-    return;
+/**
+ * Telemetry task: sample once, then send the same values over Serial /
+ * ESP-NOW / WebSocket.
+ */
+void telemetryTick(uint32_t currentTime) {
+  PROFILE_SCOPE("telemetry");
+  TRACE_SCOPE(TRACE_EV_TELEMETRY);
+  static uint32_t controlOverruns = 0;
+  uint32_t startUs = HAL_GetMicros();
+  Watchdog_feed(&watchdog, watchdogTelemetry);
+
+  TelemetrySnapshot snap;
+  sampleTelemetry(&snap, currentTime, securityEncryption);
+
+  // Plaintext and wire frame are separate buffers: encryption never
+  // overwrites the values the plaintext sinks read
+  NATelemetry plain;
+  TelemetrySnapshot_toPacket(&snap, &plain);
+  NATelemetry wire = plain;
+  if (snap.encrypted) {
+    wire.encryptionFlag = 1;
+    EncryptionManager_generateIV(wire.iv);
+    // Encrypt batteryVoltage, rssi, uptime, lat, lng, status (relative offset 2, len 19)
+    // battery(4)+rssi(2)+uptime(4)+lat(4)+lng(4)+status(1) = 19 bytes
+    EncryptionManager_encrypt((const uint8_t *)&plain.batteryVoltage, 19,
+                              wire.iv, (uint8_t *)&wire.batteryVoltage);
+    HMACValidator_generate((uint8_t *)&wire.batteryVoltage, 19, wire.hmac);
   }
+  NA_UPDATE_TELEMETRY_CHECKSUM(&wire);
 
-  // HMAC Validation for JSON
-  bool hmacValid = true;
-  if (!doc["hmac"].isNull()) {
-    uint8_t receivedHmac[32];
-    size_t decodedLen = 0;
-    const char *hmacStr = doc["hmac"];
-    int ret =
-        mbedtls_base64_decode(receivedHmac, sizeof(receivedHmac), &decodedLen,
-                              (const unsigned char *)hmacStr, strlen(hmacStr));
-
-    if (ret != 0 || decodedLen != 32) {
-      hmacValid = false;
+  // Streams, when enabled: host binary always, the radio only in the
+  // clear (the encrypted link keeps NATelemetry keyframes / deltas)
+  static TelemetryEventWatch hostWatch;
+  static TelemetryEventWatch radioWatch;
+  portENTER_CRITICAL(&streamsMux);
+  bool hostStreamsOn = streamsConfig.enabled && hostBinaryMode;
+  bool radioStreamsOn = streamsConfig.enabled && !snap.encrypted;
+  if (hostStreamsOn) {
+    TelemetryStreams_tick(&hostStreams, &streamsConfig, TELEMETRY_PERIOD_MS);
+    TelemetryStreams_watch(&hostStreams, &hostWatch, &snap);
+  }
+  if (radioStreamsOn) {
+    TelemetryStreams_tick(&radioStreams, &streamsConfig, TELEMETRY_PERIOD_MS);
+    TelemetryStreams_watch(&radioStreams, &radioWatch, &snap);
+  }
+  portEXIT_CRITICAL(&streamsMux);
+
+  // Trend windows: one summary per window on each link, when one closes
+  portENTER_CRITICAL(&trendMux);
+  TelemetryTrendConfig trendCfg = trendConfig;
+  portEXIT_CRITICAL(&trendMux);
+  // Single-word read of the control task's last reading
+  float amps = powerSource != POWER_SOURCE_NONE ? powerMonitor.amps : NAN;
+  TelemetryTrendWindow trendWindow;
+  bool trendClosed = TelemetryTrend_update(&telemetryTrend, &trendCfg, &snap, amps, &trendWindow);
+  if (trendClosed) {
+    portENTER_CRITICAL(&trendMux);
+    lastTrend = trendWindow;
+    trendWindows++;
+    portEXIT_CRITICAL(&trendMux);
+  }
+  // CRSF downlink: the RC task answers the receiver's slots from this
+  if (rcReceiver)
+    rcReceiver->setTelemetry(snap);
+
+  if (mavlinkActive(currentTime)) {
+    // A GCS on the port: MAVLink instead of our own telemetry
+    mavlinkTelemetry(snap, currentTime);
+  } else if (hostBinaryMode) {
+    // Full-rate binary telemetry, no JSON serialize
+    uint8_t frame[HOST_FRAME_MAX_ENCODED];
+    size_t frameLen;
+    if (hostStreamsOn) {
+      uint8_t packed[TELEMETRY_STREAM_MAX_FRAME];
+      portENTER_CRITICAL(&streamsMux);
+      size_t packedLen = TelemetryStreams_pack(&hostStreams, &streamsConfig, &snap,
+                                               streamsConfig.serialBudget, packed,
+                                               sizeof(packed));
+      portEXIT_CRITICAL(&streamsMux);
+      frameLen = packedLen ? HostProtocol_buildFrame(HOST_FRAME_STREAMS, packed, packedLen,
+                                                     frame, sizeof(frame))
+                           : 0;
     } else {
-      JsonDocument valDoc;
-      valDoc.set(doc);
-      valDoc.remove("hmac");
-      String cmdToValidate;
-      serializeJson(valDoc, cmdToValidate);
-
-      if (!HMACValidator_validate((uint8_t *)cmdToValidate.c_str(),
-                                  cmdToValidate.length(), receivedHmac)) {
-        hmacValid = false;
-      }
+      frameLen = HostProtocol_buildFrame(HOST_FRAME_TELEMETRY, &wire, sizeof(wire), frame,
+                                         sizeof(frame));
     }
-
-    if (!hmacValid) {
-      JsonDocument errDoc;
-      errDoc["err"] = "HMAC validation failed";
-      serializeJson(errDoc, Serial);
-      Serial.println();
-      return;
+    if (frameLen)
+      Log_write(frame, frameLen);
+    if (trendClosed) {
+      uint8_t packed[TELEMETRY_STREAM_MAX_FRAME];
+      portENTER_CRITICAL(&streamsMux);
+      uint8_t sequence = hostStreams.sequence++;
+      portEXIT_CRITICAL(&streamsMux);
+      size_t packedLen = TelemetryTrend_pack(&trendWindow, sequence, packed, sizeof(packed));
+      frameLen = packedLen ? HostProtocol_buildFrame(HOST_FRAME_STREAMS, packed, packedLen,
+                                                     frame, sizeof(frame))
+                           : 0;
+      if (frameLen)
+        Log_write(frame, frameLen);
+    }
+  } else {
+    JsonTemplate_setInt(&serialTelemetryLine, SERIAL_TEL_VOLTAGE, snap.batteryMv);
+    JsonTemplate_setInt(&serialTelemetryLine, SERIAL_TEL_LINK, snap.linkQuality);
+    JsonTemplate_setInt(&serialTelemetryLine, SERIAL_TEL_HEAP,
+                        (int32_t)snap.heapPct);
+    Log_write((const uint8_t *)serialTelemetryLine.text,
+              serialTelemetryLine.len);
+    // Trend log record: one line per metric the window has
+    for (int i = 0; trendClosed && i < TELEMETRY_TREND_COUNT; i++) {
+      char line[TELEMETRY_TREND_JSON_MAX];
+      size_t len = TelemetryTrend_jsonLine(&trendWindow, (TelemetryTrendMetric)i, line,
+                                           sizeof(line));
+      if (len)
+        Log_write((const uint8_t *)line, len);
     }
   }
 
-  failsafeManager.recordPacketReceived(millis(), hmacValid);
-
-  // Router
-  if (strcmp(command, "sm") == 0) {
-    if (!doc["t"].isNull())
-      latestPacket.throttle = doc["t"];
-    if (!doc["s"].isNull())
-      latestPacket.roll = doc["s"];
-    if (!doc["p"].isNull())
-      latestPacket.pitch = doc["p"];
-    if (!doc["y"].isNull())
-      latestPacket.yaw = doc["y"];
-    latestPacket.protocolVersion = PROTOCOL_VERSION;
-    latestPacket.encryptionFlag = 0;
-    latestPacket.sequenceNumber = ++packetSequence;
-    NA_UPDATE_PACKET_CHECKSUM(&latestPacket);
-    if (vehicle)
-      vehicle->setInputs(&latestPacket);
-    Serial.println("{\"ok\":true}");
-
-  } else if (strcmp(command, "ping") == 0) {
-    JsonDocument pongDoc;
-    pongDoc["ok"] = true;
-    pongDoc["uptime"] = millis();
-    RateLimitStats stats = RateLimitManager_getStats();
-    pongDoc["rl_allowed"] = stats.totalCommandsAllowed;
-    pongDoc["rl_blocked"] = stats.totalCommandsBlocked;
-    serializeJson(pongDoc, Serial);
-    Serial.println();
-
-  } else if (strcmp(command, "get_security_config") == 0) {
-    if (configManager) {
-      ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
-      JsonDocument res;
-      res["c"] = "get_security_config";
-      res["ok"] = true;
-      res["encryption_enabled"] = sec.encryptionEnabled;
-      res["hmac_enabled"] = sec.hmacEnabled;
-      res["rate_limit_enabled"] = sec.rateLimitEnabled;
-      res["rate_limit_cps"] = sec.rateLimitCPS;
-      serializeJson(res, Serial);
-      Serial.println();
-    }
-  } else if (strcmp(command, "set_security_config") == 0) {
-    if (configManager) {
-      ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
-      if (!doc["encryption_enabled"].isNull())
-        sec.encryptionEnabled = doc["encryption_enabled"];
-      if (!doc["hmac_enabled"].isNull())
-        sec.hmacEnabled = doc["hmac_enabled"];
-      if (!doc["rate_limit_enabled"].isNull())
-        sec.rateLimitEnabled = doc["rate_limit_enabled"];
-      if (!doc["rate_limit_cps"].isNull())
-        sec.rateLimitCPS = doc["rate_limit_cps"];
-      if (!doc["shared_secret"].isNull()) {
-        const char *secret = doc["shared_secret"];
-        memset(sec.sharedSecret, 0, 32);
-        strncpy((char *)sec.sharedSecret, secret, 31);
-      }
-      configManager->setSecurityConfig(sec);
-      EncryptionManager_init(sec.sharedSecret);
-      HMACValidator_init(sec.sharedSecret);
-      RateLimitManager_init(sec.rateLimitCPS);
-      Serial.println("{\"ok\":true}");
-    }
-  } else if (strcmp(command, "start_ota_update") == 0) {
-    const char *url = doc["url"];
-    if (url) {
-      bool ok = OTAUpdater_startDownload(url, NULL);
-      JsonDocument res;
-      res["ok"] = ok;
-      if (!ok)
-        res["msg"] = OTAUpdater_getErrorMessage();
-      serializeJson(res, Serial);
-      Serial.println();
-    }
-  } else if (strcmp(command, "get_ota_progress") == 0) {
-    JsonDocument res;
-    res["status"] = (int)OTAUpdater_getStatus();
-    res["progress"] = OTAUpdater_getProgress();
-    res["bytes"] = OTAUpdater_getBytesDownloaded();
-    res["total"] = OTAUpdater_getTotalSize();
-    res["total"] = OTAUpdater_getTotalSize();
-    serializeJson(res, Serial);
-    Serial.println();
-  } else if (strcmp(command, "upload_wp") == 0) {
-    if (!doc["lat"].isNull() && !doc["lng"].isNull()) {
-         uint16_t speed = doc["speed"] | 1500;
-         WaypointManager::getInstance().addWaypoint(doc["lat"], doc["lng"], doc["alt"] | 0, speed);
-         Serial.println("{\"ok\":true, \"msg\":\"WP Added\"}");
-    }
-  } else if (strcmp(command, "start_mission") == 0) {
-      if (WaypointManager::getInstance().getWaypointCount() > 0) {
-          NavigationManager::getInstance().startMission();
-          Serial.println("{\"ok\":true, \"msg\":\"Mission Started\"}");
-      } else {
-          Serial.println("{\"ok\":false, \"msg\":\"No Waypoints\"}");
-      }
-  } else if (strcmp(command, "stop_mission") == 0) {
-      NavigationManager::getInstance().stopMission();
-      Serial.println("{\"ok\":true}");
-  } else if (strcmp(command, "clear_mission") == 0) {
-      WaypointManager::getInstance().clearMission();
-      NavigationManager::getInstance().stopMission();
-      Serial.println("{\"ok\":true}");
-  } else if (strcmp(command, "rtl") == 0) {
-      NavigationManager::getInstance().executeRTL();
-      Serial.println("{\"ok\":true}");
-  } else if (strcmp(command, "set_depth") == 0) {
-      if (!doc["d"].isNull()) {
-          DepthManager::getInstance().setTargetDepth(doc["d"]);
-          DepthManager::getInstance().setDiving(true);
-          Serial.println("{\"ok\":true}");
-      }
-  } else if (strcmp(command, "kx_init") == 0) {
-      // Phase 2: Secure Serial Handshake (Step 1: Generate & Send PubKey)
-      KeyExchangeManager& kx = KeyExchangeManager::getInstance();
-      kx.reset();
-      if (kx.generateKeyPair()) {
-          uint8_t pubKey[64];
-          kx.getPublicKey(pubKey);
-          
-          char b64PubKey[128];
-          size_t b64Len = 0;
-          mbedtls_base64_encode((unsigned char*)b64PubKey, sizeof(b64PubKey), &b64Len, pubKey, 64);
-          
-          JsonDocument res;
-          res["c"] = "kx_init";
-          res["ok"] = true;
-          res["pub"] = b64PubKey;
-          serializeJson(res, Serial);
-          Serial.println();
-      } else {
-          Serial.println("{\"ok\":false, \"err\":\"KeyGen Failed\"}");
-      }
-  } else if (strcmp(command, "kx_fin") == 0) {
-      // Phase 2: Secure Serial Handshake (Step 2: Receive Peer Key & Compute Secret)
-      const char* peerKeyB64 = doc["pub"];
-      if (peerKeyB64) {
-          uint8_t peerPubKey[64];
-          size_t decodedLen = 0;
-          int ret = mbedtls_base64_decode(peerPubKey, sizeof(peerPubKey), &decodedLen, (const unsigned char*)peerKeyB64, strlen(peerKeyB64));
-          
-          if (ret == 0 && decodedLen == 64) {
-              if (KeyExchangeManager::getInstance().computeSharedSecret(peerPubKey)) {
-                  uint8_t secret[32];
-                  KeyExchangeManager::getInstance().getSharedSecret(secret);
-                  
-                  EncryptionManager_init(secret);
-                  HMACValidator_init(secret);
-                  
-                  Serial.println("{\"ok\":true, \"msg\":\"KX Complete\"}");
-              } else {
-                  Serial.println("{\"ok\":false, \"err\":\"Compute Failed\"}");
-              }
-          } else {
-              Serial.println("{\"ok\":false, \"err\":\"B64 Decode Failed\"}");
-          }
-      }
+#if FEATURE_BLE
+  // Phone on BLE: the host telemetry frame, several per notification
+  BleService &ble = BleService::getInstance();
+  if (ble.isConnected()) {
+    uint8_t frame[HOST_FRAME_MAX_ENCODED];
+    size_t frameLen = HostProtocol_buildFrame(HOST_FRAME_TELEMETRY, &wire, sizeof(wire), frame,
+                                              sizeof(frame));
+    if (frameLen)
+      ble.sendTelemetry(frame, frameLen, currentTime);
+  }
+#endif
+
+  uint8_t peer[6];
+  portENTER_CRITICAL(&telemetryRouteMux);
+  memcpy(peer, telemetryPeer, sizeof(peer));
+  portEXIT_CRITICAL(&telemetryRouteMux);
+
+  // New destination: it has never seen our keyframe
+  static uint8_t lastPeer[6] = {0};
+  if (memcmp(peer, lastPeer, sizeof(peer)) != 0) {
+    memcpy(lastPeer, peer, sizeof(peer));
+    TelemetryDelta_requestKeyframe(&telemetryEncoder);
+    // ...and its clock is not the one we were following
+    portENTER_CRITICAL(&clockSyncMux);
+    ClockSync_init(&clockSync);
+    portEXIT_CRITICAL(&clockSyncMux);
+  }
+
+  uint8_t divider = linkRateTick(peer, currentTime);
+  static uint8_t telemetryPhase = 0;
+  bool telemetryDue = ++telemetryPhase >= divider;
+  if (telemetryDue)
+    telemetryPhase = 0;
+
+  LatencyEcho echo;
+  bool haveEcho = false;
+  if (latencyProbeEnabled && EspNowTx_canSend(peer, currentTime)) {
+    portENTER_CRITICAL(&latencyMux);
+    haveEcho = LatencyProbe_takeEcho(&latencyProbe, &echo);
+    portEXIT_CRITICAL(&latencyMux);
+  }
+  LinkRateFrame proposal;
+  bool haveProposal = false;
+  if (!haveEcho && EspNowTx_canSend(peer, currentTime)) {
+    portENTER_CRITICAL(&linkRateMux);
+    haveProposal = LinkRate_takeProposal(&linkRate, currentTime, &proposal);
+    portEXIT_CRITICAL(&linkRateMux);
   }
+  ClockSyncFrame syncRequest;
+  bool haveSync = clockSyncTick(peer, currentTime, !haveEcho && !haveProposal, syncRequest);
+  // Trend summary rides the radio like a stream (enabled, in the clear)
+  // and waits for a free slot
+  static bool trendPending = false;
+  static TelemetryTrendWindow trendToSend;
+  if (!radioStreamsOn) {
+    trendPending = false;
+  } else if (trendClosed) {
+    trendPending = true;
+    trendToSend = trendWindow;
+  }
+  bool haveTrend = trendPending && !haveEcho && !haveProposal && !haveSync &&
+                   EspNowTx_canSend(peer, currentTime);
+
+  if (haveEcho) {
+    // Probe mode: the newest stage echo takes this tick's slot, the
+    // telemetry sample is superseded (the encoder state is untouched)
+    uint8_t echoFrame[LATENCY_ECHO_SIZE];
+    size_t echoLen = LatencyProbe_encodeEcho(&echo, echoFrame, sizeof(echoFrame));
+    EspNowTx_send(peer, echoFrame, echoLen, currentTime);
+    if (telemetryDue)
+      EspNowTx_markCoalesced(peer);
+  } else if (haveProposal) {
+    // Rate proposal / retry: same, a few frames per tier change
+    uint8_t rateFrame[LINK_RATE_FRAME_SIZE];
+    size_t rateLen = LinkRate_encode(&proposal, rateFrame, sizeof(rateFrame));
+    EspNowTx_send(peer, rateFrame, rateLen, currentTime);
+    if (telemetryDue)
+      EspNowTx_markCoalesced(peer);
+  } else if (haveSync) {
+    // Clock sync request: one frame a second once synchronized
+    uint8_t syncFrame[CLOCK_SYNC_FRAME_SIZE];
+    size_t syncLen = ClockSync_encode(&syncRequest, syncFrame, sizeof(syncFrame));
+    EspNowTx_send(peer, syncFrame, syncLen, currentTime);
+    if (telemetryDue)
+      EspNowTx_markCoalesced(peer);
+  } else if (haveTrend) {
+    // One frame per trend window, ahead of this tick's telemetry
+    uint8_t trendFrame[TELEMETRY_STREAM_MAX_FRAME];
+    portENTER_CRITICAL(&streamsMux);
+    uint8_t sequence = radioStreams.sequence++;
+    portEXIT_CRITICAL(&streamsMux);
+    size_t trendLen = TelemetryTrend_pack(&trendToSend, sequence, trendFrame, sizeof(trendFrame));
+    EspNowTx_send(peer, trendFrame, trendLen, currentTime);
+    trendPending = false;
+    if (telemetryDue)
+      EspNowTx_markCoalesced(peer);
+  } else if (!telemetryDue) {
+    // Slower link tier: no radio telemetry this tick
+  } else if (EspNowTx_canSend(peer, currentTime) && radioStreamsOn) {
+    // Due streams under the radio budget; ticks with nothing due send nothing
+    uint8_t txFrame[TELEMETRY_STREAM_MAX_FRAME];
+    portENTER_CRITICAL(&streamsMux);
+    size_t txLen = TelemetryStreams_pack(&radioStreams, &streamsConfig, &snap,
+                                         streamsConfig.radioBudget, txFrame, sizeof(txFrame));
+    portEXIT_CRITICAL(&streamsMux);
+    if (txLen)
+      EspNowTx_send(peer, txFrame, txLen, currentTime);
+  } else if (EspNowTx_canSend(peer, currentTime)) {
+    // Encode only what actually goes out, so no keyframe is ever skipped
+    uint8_t txFrame[sizeof(NATelemetry)];
+    bool isKeyframe = false;
+    size_t txLen = TelemetryDelta_encode(&telemetryEncoder, &wire,
+                                         txFrame, sizeof(txFrame), &isKeyframe);
+    if (!EspNowTx_send(peer, txFrame, txLen, currentTime) &&
+        isKeyframe)
+      TelemetryDelta_requestKeyframe(&telemetryEncoder);
+  } else {
+    // Previous frame still in flight / backing off: this sample is superseded
+    EspNowTx_markCoalesced(peer);
+  }
+
+  formationTick(currentTime);
+  rtkTick(currentTime);
+  
+#if FEATURE_WEB
+  // Phase 11: WebSocket Broadcast
+  TelemetryWebSocket::getInstance().broadcast(snap);
+#endif
+
+  JobExecutor_run(&telemetryJobs, currentTime, jobSliceUs(startUs, TELEMETRY_PERIOD_MS),
+                  controlLoopBusy(&controlOverruns));
 }
 
-void setup() {
+/**
+ * Register and start scheduler tasks
+ * @return true if all tasks are running
+ */
+bool startScheduler() {
+  if (!TaskScheduler_init())
+    return false;
+
+  RateSchedule_init(&rateSchedule, RateProfile_forVehicle(formationVehicleType));
+  TaskScheduler_addTask("control", controlTick, rateSchedule.profile.innerPeriodMs,
+                        SCHED_PRIORITY_CONTROL, SCHED_CONTROL_CORE, 6144);
+#if FEATURE_DEPTH || FEATURE_PITOT || FEATURE_MAG || FEATURE_BARO
+  TaskScheduler_addTask("sensor", sensorTick, SENSOR_PERIOD_MS,
+                        SCHED_PRIORITY_SENSOR, SCHED_BACKGROUND_CORE, 4096);
+#endif
+  TaskScheduler_addTask("telemetry", telemetryTick, TELEMETRY_PERIOD_MS,
+                        SCHED_PRIORITY_TELEMETRY, SCHED_BACKGROUND_CORE, 6144);
+  TaskScheduler_addTask("comms", commsTick, COMMS_PERIOD_MS,
+                        SCHED_PRIORITY_COMMS, SCHED_BACKGROUND_CORE, 8192);
+  // Always added: the log may still be opening on the boot worker, and
+  // Blackbox_service() returns at once while it is inactive
+  TaskScheduler_addTask("blackbox", blackboxTick, BLACKBOX_PERIOD_MS,
+                        SCHED_PRIORITY_BLACKBOX, SCHED_BACKGROUND_CORE, 3072);
+  TaskScheduler_addTask("log", logTick, LOG_PERIOD_MS,
+                        SCHED_PRIORITY_LOG, SCHED_BACKGROUND_CORE, 2048);
+  TaskScheduler_addTask("display", displayTick, DISPLAY_PERIOD_MS,
+                        SCHED_PRIORITY_DISPLAY, SCHED_BACKGROUND_CORE, 3072);
+  // Only a Copter has motor noise worth tracking
+  if (formationVehicleType == VEHICLE_COPTER)
+    dynNotchAvailable = TaskScheduler_addTask("noise", noiseTick, NOISE_PERIOD_MS,
+                                              SCHED_PRIORITY_NOISE, SCHED_BACKGROUND_CORE,
+                                              3072) >= 0;
+
+  for (uint8_t i = 0; i < TaskScheduler_getTaskCount(); i++) {
+    SchedulerTaskStats st;
+    if (TaskScheduler_getStats(i, &st))
+      MemoryProfiler_setTaskStackSize(st.name, st.stackBytes);
+  }
+  // Sessions are restored by now (bootResume): the worker owns them next
+  if (startRxVerifyWorker())
+    MemoryProfiler_setTaskStackSize("rx_verify", RX_VERIFY_STACK);
+  return TaskScheduler_start();
+}
+
+// ============================================================================
+// Boot Stages
+// ============================================================================
+// MAIN lane (setup(), in order): what the first control frame needs.
+// BACKGROUND lane (boot worker, core 0): slow or optional devices, brought
+// up while the scheduler already runs. Their users check for a null
+// manager or !isReady(), as they did for a missing device.
+
+bool bootSerial() {
+  Log_init();
+  Serial.setTxBufferSize(SERIAL_TX_BUFFER_SIZE); // Before begin()
   Serial.begin(115200);
-  delay(100);
+  SerialLineReader_init();
+  return CommandRouter_init(&commandRouter, SERIAL_COMMANDS, SERIAL_COMMAND_COUNT);
+}
+
+bool bootFailsafe() {
   failsafeManager.setup();
+  return true;
+}
+
+// Outputs at neutral before anything slow runs
+bool bootActuators() {
+#if defined(VEHICLE_TYPE_ROVER)
+  formationVehicleType = VEHICLE_ROVER;
+#elif defined(VEHICLE_TYPE_PLANE)
+  formationVehicleType = VEHICLE_PLANE;
+#elif defined(VEHICLE_TYPE_SUB)
+  formationVehicleType = VEHICLE_SUB;
+#elif defined(VEHICLE_TYPE_COPTER)
+  formationVehicleType = VEHICLE_COPTER;
+#else
+  formationVehicleType = VehicleRegistry_loadType();
+  vehicle = VehicleRegistry_create((VehicleType)formationVehicleType);
+#endif
+  Serial.printf("[Vehicle] %s\n", vehicle->getName());
+  // Claim the vehicle's motor / servo pins and PWM channels
+  vehicle->setup();
+  return true;
+}
+
+// Cloned by /config/backup next to the ConfigManager sections; per-unit
+// calibration (IMU, compass record, map, hardware profile, pairing) stays
+static const char *const CONFIG_BACKUP_KEYS[] = {
+    WAYPOINT_NVS_KEY,           WAYPOINT_LEGACY_KEY,        GEOFENCE_NVS_KEY,
+    ALT_HOLD_CONFIG_KEY,        GYRO_FILTER_CONFIG_KEY,     CONTROL_ARBITER_CONFIG_KEY,
+    ESPNOW_CCMP_CONFIG_KEY,     FBW_CONFIG_KEY,             INPUT_COND_CONFIG_KEY,
+    MAG_CAL_CONFIG_KEY,         POWER_CONFIG_KEY,           POWER_POLICY_CONFIG_KEY,
+    RC_CONFIG_KEY,              RPM_FILTER_CONFIG_KEY,      TELEMETRY_STREAMS_CONFIG_KEY,
+    TELEMETRY_TREND_CONFIG_KEY, THRUST_CONFIG_KEY,          THRUST_CURVE_CONFIG_KEY,
+    TECS_CONFIG_KEY,            ODOM_CONFIG_KEY,            WIFI_LINK_CONFIG_KEY,
+    DYN_NOTCH_CONFIG_KEY,       RANGE_CONFIG_KEY,           BLE_CONFIG_KEY,
+};
+
+bool bootConfig() {
+  PeerSessionTable_init(&peerSessions);
+  SessionResume_init(&resumeTickets);
+  FormationTable_init(&formationTable);
+  SAFE_NEW(configManager, ConfigManager);
+  if (!configManager)
+    return false;
+  configManager->begin();
+  ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
+  // Telemetry IVs: per-boot random prefix + counter, no DRBG call per packet
+  EncryptionManager_setIVMode(EM_IV_MODE_COUNTER);
+  EncryptionManager_init(sec.sharedSecret);
+  HMACValidator_init(sec.sharedSecret);
+  // Configured rate may exceed the 8-bit initial token count
+  RateLimitManager_init(RATE_LIMIT_CAPACITY);
+  RateLimitManager_setRate(sec.rateLimitCPS);
+  securityEncryption = sec.encryptionEnabled;
+  securityHmac = sec.hmacEnabled;
+  configManager->addObserver(ConfigManager::SECTION_SECURITY, onSecurityChanged, nullptr);
+  for (const char *key : CONFIG_BACKUP_KEYS)
+    configManager->addBackupKey(key);
+  if (ConfigManager::loadBlob(INPUT_COND_CONFIG_KEY, &inputConfig, sizeof(inputConfig)) !=
+      sizeof(inputConfig))
+    InputConditioner_defaultConfig(&inputConfig);
+  InputConditioner_sanitize(&inputConfig);
+  InputConditioner_init(&inputConditioner, &inputConfig);
+  if (ConfigManager::loadBlob(GYRO_FILTER_CONFIG_KEY, &gyroFilterConfig,
+                              sizeof(gyroFilterConfig)) != sizeof(gyroFilterConfig))
+    BiquadChain_defaultConfig(&gyroFilterConfig);
+  BiquadChain_sanitize(&gyroFilterConfig, IMU_SAMPLE_RATE_HZ);
+  gyroFilterRevision++;                   // Built by the control task
+  if (ConfigManager::loadBlob(DYN_NOTCH_CONFIG_KEY, &dynNotchConfig, sizeof(dynNotchConfig)) !=
+      sizeof(dynNotchConfig))
+    DynamicNotch_defaultConfig(&dynNotchConfig);
+  DynamicNotch_sanitize(&dynNotchConfig, IMU_SAMPLE_RATE_HZ);
+  dynNotchRevision++;
+  if (ConfigManager::loadBlob(RPM_FILTER_CONFIG_KEY, &rpmFilterConfig, sizeof(rpmFilterConfig)) !=
+      sizeof(rpmFilterConfig))
+    RpmFilter_defaultConfig(&rpmFilterConfig);
+  RpmFilter_sanitize(&rpmFilterConfig, IMU_SAMPLE_RATE_HZ);
+  rpmFilterRevision++;
+  ImuCalRecord calRecord;
+  if (ConfigManager::loadBlob(IMU_CAL_CONFIG_KEY, &calRecord, sizeof(calRecord)) !=
+      sizeof(calRecord))
+    ImuCal_defaultRecord(&calRecord);
+  ImuCal_sanitize(&calRecord);
+  ImuCal_init(&imuCal, &calRecord);
+  imuCalShared = imuCal;
+  if (calRecord.flags & IMU_CAL_HAVE_GYRO)
+    Serial.printf("[IMU] Stored gyro bias from %.1f C\n", calRecord.refTempC);
+  if (ConfigManager::loadBlob(MAG_CAL_CONFIG_KEY, &magConfig, sizeof(magConfig)) !=
+      sizeof(magConfig))
+    MagCal_defaultConfig(&magConfig);
+  MagCal_sanitize(&magConfig);
+#if FEATURE_MAG
+  MagCalRecord magRecord;
+  if (ConfigManager::loadBlob(MAG_CAL_RECORD_KEY, &magRecord, sizeof(magRecord)) !=
+      sizeof(magRecord))
+    MagCal_defaultRecord(&magRecord);
+  MagCal_sanitizeRecord(&magRecord);
+  MagCal_init(&magCal, &magRecord);
+#endif
+  if (ConfigManager::loadBlob(POWER_CONFIG_KEY, &powerConfig, sizeof(powerConfig)) !=
+      sizeof(powerConfig))
+    PowerMonitor_defaultConfig(&powerConfig);
+  PowerMonitor_sanitize(&powerConfig);
+  powerRevision++;
+  if (ConfigManager::loadBlob(FBW_CONFIG_KEY, &fbwConfig, sizeof(fbwConfig)) != sizeof(fbwConfig))
+    FlyByWire_defaultConfig(&fbwConfig);
+  FlyByWire_sanitize(&fbwConfig);
+  fbwRevision++;
+  if (ConfigManager::loadBlob(THRUST_CURVE_CONFIG_KEY, &thrustConfig, sizeof(thrustConfig)) !=
+      sizeof(thrustConfig))
+    ThrustCurve_defaultConfig(&thrustConfig);
+  ThrustCurve_sanitize(&thrustConfig);
+  thrustRevision++;
+  if (ConfigManager::loadBlob(TECS_CONFIG_KEY, &tecsConfig, sizeof(tecsConfig)) !=
+      sizeof(tecsConfig))
+    TotalEnergy_defaultConfig(&tecsConfig);
+  TotalEnergy_sanitize(&tecsConfig);
+  TotalEnergy_init(&tecs, &tecsConfig);
+  tecsRevision++;
+  if (ConfigManager::loadBlob(ALT_HOLD_CONFIG_KEY, &altHoldConfig, sizeof(altHoldConfig)) !=
+      sizeof(altHoldConfig))
+    AltitudeHold_defaultConfig(&altHoldConfig);
+  AltitudeHold_sanitize(&altHoldConfig);
+  AltitudeHold_init(&altHold, &altHoldConfig);
+  BaroAltitude_init(&baroAlt, BARO_ALT_TIME_CONST_S);
+  if (ConfigManager::loadBlob(ODOM_CONFIG_KEY, &odomConfig, sizeof(odomConfig)) !=
+      sizeof(odomConfig))
+    WheelOdometry_defaultConfig(&odomConfig);
+  WheelOdometry_sanitize(&odomConfig);
+  odomRevision++;
+  if (ConfigManager::loadBlob(RANGE_CONFIG_KEY, &rangeEnvelope, sizeof(rangeEnvelope)) !=
+      sizeof(rangeEnvelope))
+    RangeEnvelope_defaults(&rangeEnvelope);
+  RangeEnvelope_sanitize(&rangeEnvelope);
+  rangeRevision++;
+  if (ConfigManager::loadBlob(MOTOR_TRIM_CONFIG_KEY, &motorTrims, sizeof(motorTrims)) !=
+      sizeof(motorTrims))
+    MotorTrim_defaults(&motorTrims);
+  MotorTrim_sanitize(&motorTrims);
+  motorTrimRevision++;
+  if (ConfigManager::loadBlob(TELEMETRY_STREAMS_CONFIG_KEY, &streamsConfig,
+                              sizeof(streamsConfig)) != sizeof(streamsConfig))
+    TelemetryStreams_defaultConfig(&streamsConfig);
+  TelemetryStreams_sanitize(&streamsConfig);
+  TelemetryStreams_init(&radioStreams);
+  TelemetryStreams_init(&hostStreams);
+  if (ConfigManager::loadBlob(TELEMETRY_TREND_CONFIG_KEY, &trendConfig,
+                              sizeof(trendConfig)) != sizeof(trendConfig))
+    TelemetryTrend_defaultConfig(&trendConfig);
+  TelemetryTrend_sanitize(&trendConfig);
+  TelemetryTrend_init(&telemetryTrend);
+  if (ConfigManager::loadBlob(RC_CONFIG_KEY, &rcConfig, sizeof(rcConfig)) != sizeof(rcConfig))
+    RcInput_defaultConfig(&rcConfig);
+  RcInput_sanitize(&rcConfig);
+  if (ConfigManager::loadBlob(CONTROL_ARBITER_CONFIG_KEY, &arbiterConfig,
+                              sizeof(arbiterConfig)) != sizeof(arbiterConfig))
+    ControlArbiter_defaultConfig(&arbiterConfig);
+  ControlArbiter_sanitize(&arbiterConfig);
+  ControlArbiter_init(&controlArbiter);
+  if (ConfigManager::loadBlob(ESPNOW_CCMP_CONFIG_KEY, &espnowCcmp, sizeof(espnowCcmp)) !=
+      sizeof(espnowCcmp))
+    espnowCcmp = false;
+  if (ConfigManager::loadBlob(POWER_POLICY_CONFIG_KEY, &pmConfig, sizeof(pmConfig)) !=
+      sizeof(pmConfig))
+    PowerPolicy_defaultConfig(&pmConfig);
+  PowerPolicy_sanitize(&pmConfig);
+#if RC_INPUT_PIN >= 0
+  // Up before the radio: a wired receiver does not wait for Wi-Fi
+  RcReceiver *rc = nullptr;
+  SAFE_NEW(rc, RcReceiver);
+  if (rc && rc->setup((RcProtocol)rcConfig.protocol, SCHED_PRIORITY_RC, SCHED_CONTROL_CORE)) {
+    rcReceiver = rc;
+    Serial.printf("[RC] %s on GPIO %d\n", RcInput_protocolName((RcProtocol)rcConfig.protocol),
+                  RC_INPUT_PIN);
+    applyRcTelemetry();
+  }
+#endif
+
+  uint8_t pairedMac[6];
+  RxFilter_init();
+  if (readPairedMac(pairedMac)) {
+    portENTER_CRITICAL(&peerMux);
+    pinLinkPeer(pairedMac, nullptr, nullptr);
+    portEXIT_CRITICAL(&peerMux);
+    RxFilter_setPeer(pairedMac);
+    setTelemetryRoute(pairedMac);
+  }
+  return true;
+}
 
-  WiFi.mode(WIFI_STA);
+// Receive path last: filters and keys are in place for the first frame
+bool bootRadio() {
+  // Fixed channel and no modem sleep before ESP-NOW comes up
+  if (ConfigManager::loadBlob(WIFI_LINK_CONFIG_KEY, &wifiConfig, sizeof(wifiConfig)) !=
+      sizeof(wifiConfig))
+    WifiLink_defaults(&wifiConfig);
+  if (!WifiLink_sanitize(&wifiConfig))
+    Serial.println("[WiFi] Stored mode unusable, ESP-NOW only");
+  if (!WifiLink_begin(&wifiConfig))
+    Serial.println("[WiFi] Channel not applied");
+  Serial.printf("[WiFi] %s, channel %u\n", WifiLink_modeName((WifiLinkMode)wifiConfig.mode),
+                wifiConfig.channel);
   if (esp_now_init() != ESP_OK)
-    return;
+    return false;
   esp_now_register_recv_cb(OnDataRecv);
+  RSSIManager::beginFrameCapture();
+  EspNowTx_init();
+  EspNowTx_setMasterKey((const uint8_t *)ESPNOW_TX_PMK);
+  TelemetryDelta_initEncoder(&telemetryEncoder);
+  LinkRate_init(&linkRate);
+  // Capabilities go to the controller in the first rate proposal
+  LinkRate_setCompact(&linkRate, NA_COMPACT_CONTROL);
+  bool longRange = ESPNOW_LONG_RANGE && EspNowTx_enableLongRange();
+  LinkRate_setLongRange(&linkRate, longRange);
 
-  SAFE_NEW(configManager, ConfigManager);
-  if (configManager) {
-    configManager->begin();
-    ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
-    EncryptionManager_init(sec.sharedSecret);
-    HMACValidator_init(sec.sharedSecret);
-    RateLimitManager_init(sec.rateLimitCPS);
+  // Full clock held from here; the control task releases it once parked
+  if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "full", &pmCpuLock) == ESP_OK &&
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "full_awake", &pmSleepLock) == ESP_OK) {
+    esp_pm_lock_acquire(pmCpuLock);
+    esp_pm_lock_acquire(pmSleepLock);
+    pmLocks = configurePowerManagement(pmConfig);
   }
-  
-  // Phase 10: Init Key Exchange
+  if (!pmLocks)
+    Serial.println("[PM] No power management in this build, full clock only");
+  PowerPolicy_init(&powerPolicy, HAL_GetMillis());
+  return true;
+}
+
+// Phase 10: Init Key Exchange (comms commands use it from the first tick)
+bool bootKeyExchange() {
   if (!KeyExchangeManager::getInstance().init()) {
-      Serial.println("KeyExchange Init Failed");
+    Serial.println("KeyExchange Init Failed");
+    return false;
   }
-  
-  // Phase 10: Init Navigation and GPS
-  GPSSerial.begin(9600, SERIAL_8N1, 16, 17); // RX=16, TX=17
-  NavigationManager::getInstance().init();
-  DepthManager::getInstance().begin();
-  
-  // Phase 11: Init WebSockets
-  TelemetryWebSocket::getInstance().begin(&server);
-  server.begin(); // Start Web Server
+  if (!KeyExchangeManager::getInstance().startWorker(SCHED_PRIORITY_KX, SCHED_BACKGROUND_CORE,
+                                                     onKeyExchangeDone)) {
+    Serial.println("KeyExchange Worker Failed");
+    return false;
+  }
+  return true;
+}
 
-  SAFE_NEW(batteryManager, BatteryManager);
-  if (batteryManager)
-    batteryManager->setup();
+// Estimator and bookkeeping state read by the first control tick
+bool bootState() {
+  AttitudeEstimator_init(&attitude, ATTITUDE_DEFAULT_KP, ATTITUDE_DEFAULT_KI);
+  PositionEstimator_init(&position);
+  NavigationManager::getInstance().init();
+  WaypointManager::getInstance().loadFromNVS();
+  MissionLibraryStatus library = MissionLibrary_begin();
+  if (library != MISSION_LIBRARY_OK) {
+    Serial.printf("[Mission] Library: %s\n", MissionLibrary_statusName(library));
+  } else {
+    const MissionLibraryIndex *index = MissionLibrary_getIndex();
+    uint8_t stored = 0;
+    for (uint8_t i = 0; i < index->slotCount; i++)
+      stored += index->slots[i].used;
+    Serial.printf("[Mission] Library: %u / %u stored\n", stored, index->slotCount);
+  }
+  BatteryEstimator_init(&batteryModel, BATTERY_CELLS);
+  PowerConfig powerDefaults;    // Stored settings follow through powerRevision
+  PowerMonitor_defaultConfig(&powerDefaults);
+  PowerMonitor_init(&powerMonitor, &powerDefaults);
+  loadGeofence();
+  loadOccupancyGrid();
+  MemPlacement_note("geofence_io", geofenceRecords, sizeof(geofenceRecords), MEM_CLASS_BULK);
+  MemPlacement_note("occ_grid", &occGrid, sizeof(occGrid), MEM_CLASS_BULK);
+  MemPlacement_note("planner", &pathPlanner, sizeof(pathPlanner), MEM_CLASS_BULK);
   SAFE_NEW(rssiManager, RSSIManager);
   SAFE_NEW(joystickCalibrator, JoystickCalibrator, configManager);
-
-  OTAUpdater_init();
   MemoryProfiler_init();
+  MemoryProfiler_setTaskStackSize("loopTask", getArduinoLoopTaskStackSize());
+  MemoryProfiler_setTaskStackSize("boot", BOOT_WORKER_STACK);
+  LoopTiming_startIdleMonitor();
+  Trace_init(getCpuFrequencyMhz());
+  JsonTemplate_init(&serialTelemetryLine, SERIAL_TELEMETRY_PATTERN);
+  return true;
+}
 
-  // Create vehicle instance
-#if defined(VEHICLE_TYPE_ROVER)
-  SAFE_NEW(vehicle, Rover);
-#elif defined(VEHICLE_TYPE_PLANE)
-  SAFE_NEW(vehicle, Plane);
-#elif defined(VEHICLE_TYPE_SUB)
-  SAFE_NEW(vehicle, Sub);
-#else
-  SAFE_NEW(vehicle, Copter);
+/**
+ * Put the paired controller's session back as it was before the reset
+ * (boot, before the control task starts). Only for the configured pair:
+ * the window restarts above the last accepted sequence number, so frames
+ * from before the reset stay rejected.
+ */
+bool resumeLinkSession(const WarmRestartTicket &ticket) {
+  if (!ticket.valid)
+    return false;
+  portENTER_CRITICAL(&peerMux);
+  int slot = haveLinkPeer && memcmp(linkPeer, ticket.mac, 6) == 0
+                 ? PeerSessionTable_find(&peerSessions, linkPeer)
+                 : PEER_SESSION_NONE;
+  if (slot != PEER_SESSION_NONE) {
+    PeerSession *peer = &peerSessions.peers[slot];
+    ReplayWindow_init(&peer->replay);
+    if (ticket.haveSeq)
+      ReplayWindow_accept(&peer->replay, ticket.highestSeq, HAL_GetMillis());
+    if (ticket.keyed) {
+      peer->keys = ticket.keys;
+      peer->keyed = true;
+      peer->installs++;
+    }
+  }
+  portEXIT_CRITICAL(&peerMux);
+
+  if (slot == PEER_SESSION_NONE)
+    return false;
+  if (ticket.keyed) {
+    applyPeerKeys(slot, ticket.keys, true);
+    refreshRxAllowlist();
+  }
+  return true;
+}
+
+// Warm restart: home, mission cursor, failsafe state and the link session
+// of the run a watchdog / panic / brown-out reset interrupted
+bool bootResume() {
+  WarmRestartRecord rec;
+  if (!WarmRestart_take(&rec))
+    return true;
+  failsafeManager.resume((FailsafeState)rec.failsafeState, rec.sincePacketMs);
+  bool mission = NavigationManager::getInstance().resume(rec.nav);
+  bool session = resumeLinkSession(rec.ticket);
+  SessionKeys_wipe(&rec.ticket.keys);
+  Serial.printf("[Boot] Warm restart after %lu ms: home %s, mission %s, session %s\n",
+                (unsigned long)rec.uptimeMs, rec.nav.homeSet ? "restored" : "unset",
+                mission ? "resumed" : "idle", session ? "restored" : "new");
+  return true;
+}
+
+// Shared I2C bus (depth, IMU, PWM, OLED): one owner task runs all transactions
+bool bootI2C() {
+  HAL_I2CInit(21, 22, 400000);
+  if (!HAL_I2CStartQueue(SCHED_PRIORITY_I2C, SCHED_BACKGROUND_CORE))
+    return false;
+  // PWM expander (optional): set up before the control task may flush it
+  if (pwmExpander.begin(PCA9685_FREQUENCY_HZ)) {
+    pwmExpanderFitted = true;
+    LOG_INFO("[PWM] PCA9685 at %.1f Hz\n", pwmExpander.getFrequency());
+  }
+  // Status OLED (optional): cleared here, drawn by the display task
+  if (oled.begin()) {
+    oledFitted = true;
+    LOG_INFO("[OLED] SSD1306 status display on\n");
+  }
+  return true;
+}
+
+// IMU: 1 kHz FIFO sampling task next to the control loop
+bool bootImu() {
+  return IMUManager::getInstance().begin(IMU_DLPF_42HZ, SCHED_PRIORITY_IMU,
+                                         SCHED_CONTROL_CORE);
+}
+
+// Sensors on the bus: MS5837 depth, MS4525 pitot, QMC5883L compass,
+// MS5611 barometer (any may be absent; the pitot zeroes over its first
+// second, keep it out of the wind; the barometer takes its ground
+// reference over its first half second), and the forward rangefinder
+// when its pins are set
+bool bootDepth() {
+#if FEATURE_DEPTH
+  DepthManager::getInstance().begin();
+#endif
+#if FEATURE_PITOT
+  pitotFitted = pitot.begin();
+  if (pitotFitted)
+    LOG_INFO("[Pitot] MS4525 found\n");
+#endif
+#if FEATURE_MAG
+  magFitted = mag.begin();
+  if (magFitted)
+    LOG_INFO("[Mag] QMC5883L found\n");
+#endif
+#if FEATURE_BARO
+  baroFitted = baro.begin();
+  if (baroFitted)
+    LOG_INFO("[Baro] MS5611 found\n");
+#endif
+#if FEATURE_RANGE
+  RangeFilter_init(&rangeFilter);
+  rangeFitted = ranger.begin(RANGE_TRIG_PIN, RANGE_ECHO_PIN);
+  if (rangeFitted)
+    LOG_INFO("[Range] Ultrasonic on GPIO %d / %d\n", RANGE_TRIG_PIN, RANGE_ECHO_PIN);
 #endif
+  return true;
+}
 
-  if (vehicle)
-    vehicle->setup();
+// Published only once set up: the tasks treat null as "not fitted yet"
+bool bootGps() {
+#if FEATURE_GPS
+  GPSManager *gps = nullptr;
+  SAFE_NEW(gps, GPSManager);
+  if (!gps)
+    return false;
+  gps->setup(SCHED_PRIORITY_GPS, SCHED_BACKGROUND_CORE);
+  gpsManager = gps;
+#endif
+  return true;
 }
 
-uint32_t lastTelemetryTime = 0;
-NATelemetry telemetry;
+bool bootBattery() {
+  BatteryManager *battery = nullptr;
+  SAFE_NEW(battery, BatteryManager);
+  if (!battery)
+    return false;
+  battery->setup(SCHED_PRIORITY_SENSOR, SCHED_BACKGROUND_CORE);
+  batteryManager = battery;
+  return true;
+}
 
-void loop() {
-  uint32_t currentTime = millis();
-  failsafeManager.update(currentTime);
-  handleSerialCommand();
+#if FEATURE_WEB
+// GET /metrics: one copy of the counters per scrape (async_tcp task)
+static_assert(METRICS_MAX_TASKS >= SCHED_MAX_TASKS, "metrics task slots");
+static_assert(METRICS_RX_STAGES == RX_FILTER_STAGE_COUNT - 1, "metrics rx stages");
 
-  if (currentTime - lastRateLimitRefill >= REFILL_INTERVAL_MS) {
-    RateLimitManager_refill();
-    lastRateLimitRefill = currentTime;
+static void captureMetrics(MetricsSnapshot *snap) {
+  snap->uptimeS = HAL_GetMillis() / 1000;
+  snap->heapFree = ESP.getFreeHeap();
+  snap->heapMinFree = ESP.getMinFreeHeap();
+  snap->heapLargestBlock = ESP.getMaxAllocHeap();
+  snap->heapSize = ESP.getHeapSize();
+
+  for (uint8_t core = 0; core < METRICS_CORES; core++) {
+    float load = LoopTiming_getCoreLoad(core);
+    snap->coreLoad[core] = load < 0.0f ? NAN : load / 100.0f;
   }
-  
-  // Phase 10: Autonomous Navigation Logic
-  // 1. Read GPS
-  while (GPSSerial.available() > 0) {
-      NavigationManager::getInstance().feedGPS(GPSSerial.read());
+  snap->loopMaxUs = MemoryProfiler_getCPUStats().maxLoopExecutionTimeUs;
+  snap->taskCount = 0;
+  for (uint8_t i = 0; i < TaskScheduler_getTaskCount(); i++) {
+    SchedulerTaskStats st;
+    if (!TaskScheduler_getStats(i, &st))
+      continue;
+    uint8_t n = snap->taskCount++;
+    strlcpy(snap->taskNames[n], st.name, METRICS_TASK_NAME_MAX);
+    snap->taskRuns[n] = st.runCount;
+    snap->taskOverruns[n] = st.overrunCount;
+    snap->taskExecMaxUs[n] = st.maxExecTimeUs;
+    snap->taskJitterMaxUs[n] = st.maxJitterUs;
   }
-  
-  // 2. Update Nav Manager (Using GPS Course as Heading for now)
-  // TODO: Use Compass if available
-  float lat = 0, lng = 0;
-  NavigationManager::getInstance().getGPSLocation(lat, lng);
-  // Note: TinyGPS course is 0-360, need to check if we need conversion. 
-  // NavManager uses it for diff.
-  // We need to pass current GPS course if moving.
-  // Using GPS Course as heading (valid if moving > 1-2 m/s normally)
-  float currentHeading = NavigationManager::getInstance().getGPSCourse();
-  NavigationManager::getInstance().update(lat, lng, currentHeading);
 
-  // 3. Apply Auto Inputs if Mode is Auto
-  if (latestPacket.mode & MODE_AUTO) {
-      int16_t navThrottle = 0;
-      int16_t navYaw = 0;
-      if (NavigationManager::getInstance().getNavigationOutput(navThrottle, navYaw)) {
-          latestPacket.throttle = navThrottle;
-          latestPacket.roll = navYaw; // Use Roll channel for Steering
-      } else if (NavigationManager::getInstance().getState().isRTLActive) {
-          // RTL Reached Home
-          NavigationManager::getInstance().stopMission();
-          latestPacket.throttle = 0;
-          latestPacket.roll = 0;
-          Serial.println("[Nav] RTL Mission Complete: Reached Home.");
-      }
-  }
-  
-  // Phase 14: RTL Triggers (Battery & Failsafe)
-  if (batteryManager && batteryManager->getVoltageMillivolts() < 3400) { // RTL_VOLTAGE_MV
-      if (!NavigationManager::getInstance().getState().isRTLActive) {
-          Serial.println("[Battery] Low voltage! Triggering RTL.");
-          NavigationManager::getInstance().executeRTL();
-      }
+  RateLimitStats rate = RateLimitManager_getStats();
+  snap->rateAllowed = rate.totalCommandsAllowed;
+  snap->rateBlocked = rate.totalCommandsBlocked;
+  snap->ratePeerBlocked = rate.peerBlocked;
+  snap->rateClassBlocked = rate.classBlocked;
+
+  RxFilterStats rx = RxFilter_getStats();
+  snap->rxPassed = rx.passed;
+  for (uint8_t i = 0; i < METRICS_RX_STAGES; i++)
+    snap->rxRejected[i] = rx.rejected[RX_FILTER_LENGTH + i];
+
+  snap->failsafeState = failsafeManager.getState();
+  snap->failsafePackets = failsafeManager.getTotalPackets();
+  snap->failsafeBadHmac = failsafeManager.getInvalidHmacPackets();
+  snap->failsafeFault = vehicle->checkCriticalFault();
+
+  if (rssiManager) {
+    LinkStats link = rssiManager->getLinkStats();
+    snap->linkRssiDbm = rssiManager->getRSSI_dBm();
+    snap->linkQuality = rssiManager->getRSSIPercentage();
+    snap->linkReceived = link.received;
+    snap->linkLost = link.lost;
+    snap->linkDuplicates = link.duplicates;
   }
 
-  // Set Home on first valid GPS fix
-  static bool homeSet = false;
-  if (!homeSet && NavigationManager::getInstance().isGPSLocked()) {
-      float hLat, hLng;
-      NavigationManager::getInstance().getGPSLocation(hLat, hLng);
-      NavigationManager::getInstance().setHome(hLat, hLng);
-      homeSet = true;
+  CryptoBackendStats crypto = CryptoBackend_getStats();
+  snap->cryptoAesCalls = crypto.aesCalls;
+  snap->cryptoAesBytes = crypto.aesBytes;
+  snap->cryptoShaCalls = crypto.shaCalls;
+  snap->cryptoShaBytes = crypto.shaBytes;
+
+#if FEATURE_OTA
+  OTAStats ota = OTAUpdater_getStats();
+  snap->otaStatus = OTAUpdater_getProgressInfo().status;
+  snap->otaAttempts = ota.totalAttempts;
+  snap->otaSuccess = ota.successfulUpdates;
+  snap->otaFailed = ota.failedUpdates;
+  snap->otaRollbacks = ota.rollbacks;
+#endif
+
+  snap->logDropped = Log_getStats().dropped;
+}
+
+// /config/restore: refused in motion; on a secured link only a signed image
+static bool canRestoreConfig() {
+  return !failsafeManager.isArmed() &&
+         !NavigationManager::getInstance().getState().isMissionActive;
+}
+
+static bool authorizeConfigRestore(const uint8_t *image, size_t len, const char *hmacB64) {
+  if (hmacB64)
+    return HMACValidator_validateBase64(image, len, hmacB64);
+  return !(securityEncryption && securityHmac);
+}
+
+static void configRestored() {
+  Serial.println("[Config] Restored from image, restarting");
+  ESP.restart();
+}
+#endif
+
+// Phase 11: Init WebSockets
+bool bootWeb() {
+#if FEATURE_WEB
+  TelemetryWebSocket::getInstance().setControlHandler(onWebSocketControl);
+  TelemetryWebSocket::getInstance().begin(&server);
+  BlackboxReader_begin(&server); // Log download routes under /log
+  WebAssets_begin(&server);      // Configurator at /, gzipped from flash
+  Metrics_begin(&server, captureMetrics); // Prometheus text at /metrics
+  static const ConfigBackupHooks backupHooks = {canRestoreConfig, authorizeConfigRestore,
+                                                configRestored};
+  ConfigBackup_begin(&server, configManager, &backupHooks); // /config/backup, /restore
+  server.begin();                // Start Web Server
+#endif
+#if FEATURE_BLE
+  // Phone fallback link, when stored on
+  uint8_t stored = 0;
+  ConfigManager::loadBlob(BLE_CONFIG_KEY, &stored, sizeof(stored));
+  bleEnabled = stored != 0;
+  if (bleEnabled && !startBle())
+    Serial.println("[BLE] Start failed");
+#endif
+  return true;
+}
+
+bool bootOta() {
+#if FEATURE_OTA
+  OTAUpdater_init();
+#endif
+  return true;
+}
+
+bool bootBlackbox() {
+  Blackbox_begin();
+  return true;
+}
+
+/**
+ * Where the large buffers ended up (loop task, once the boot is complete)
+ */
+static void reportMemoryPlacement() {
+  uint32_t freeBytes, totalBytes;
+  MemPlacement_getHeap(MEM_REGION_INTERNAL, &freeBytes, &totalBytes);
+  Serial.printf("[Mem] Internal %lu / %lu KB free", (unsigned long)(freeBytes / 1024),
+                (unsigned long)(totalBytes / 1024));
+  if (MemPlacement_hasPsram()) {
+    MemPlacement_getHeap(MEM_REGION_PSRAM, &freeBytes, &totalBytes);
+    Serial.printf(", PSRAM %lu / %lu KB free\n", (unsigned long)(freeBytes / 1024),
+                  (unsigned long)(totalBytes / 1024));
+  } else {
+    Serial.println(", no PSRAM");
   }
-  
-  // Phase 13: Sub-Surface Logic
-  DepthManager::getInstance().update();
-  
-  // Apply Depth Hold if bit set (reusing a spare bit in mode for now or status)
-  // For now, let's just update the manager
+  MemPlacementEntry entries[MEM_PLACEMENT_MAX_ENTRIES];
+  uint8_t count = MemPlacement_getEntries(entries, MEM_PLACEMENT_MAX_ENTRIES);
+  for (uint8_t i = 0; i < count; i++)
+    Serial.printf("[Mem]   %-16s %6lu B %s\n", entries[i].tag, (unsigned long)entries[i].size,
+                  MemPlacement_regionName((MemRegion)entries[i].region));
+}
 
-  if (vehicle)
-    vehicle->loop();
+enum BootStageId {
+  BOOT_SERIAL,
+  BOOT_FAILSAFE,
+  BOOT_ACTUATORS,
+  BOOT_CONFIG,
+  BOOT_RADIO,
+  BOOT_KX,
+  BOOT_STATE,
+  BOOT_RESUME,
+  BOOT_I2C,
+  BOOT_IMU,
+  BOOT_DEPTH,
+  BOOT_GPS,
+  BOOT_BATTERY,
+  BOOT_WEB,
+  BOOT_OTA,
+  BOOT_BLACKBOX,
+  BOOT_STAGE_COUNT
+};
 
-  MemoryProfiler_recordTaskTime("main_loop", micros() - (currentTime * 1000));
+const BootStage BOOT_STAGES[BOOT_STAGE_COUNT] = {
+    {"serial", bootSerial, BOOT_LANE_MAIN, 0, 0},
+    {"failsafe", bootFailsafe, BOOT_LANE_MAIN, 0, 0},
+    {"actuators", bootActuators, BOOT_LANE_MAIN, 0, 0},
+    {"config", bootConfig, BOOT_LANE_MAIN, 0, 0},
+    {"radio", bootRadio, BOOT_LANE_MAIN, BOOT_FLAG_CRITICAL, BOOT_AFTER(BOOT_CONFIG)},
+    {"kx", bootKeyExchange, BOOT_LANE_MAIN, 0, BOOT_AFTER(BOOT_CONFIG)},
+    {"state", bootState, BOOT_LANE_MAIN, 0, BOOT_AFTER(BOOT_CONFIG)},
+    {"resume", bootResume, BOOT_LANE_MAIN, 0,
+     BOOT_AFTER(BOOT_FAILSAFE) | BOOT_AFTER(BOOT_CONFIG) | BOOT_AFTER(BOOT_STATE)},
+    {"i2c", bootI2C, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_SERIAL)},
+    {"imu", bootImu, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_I2C)},
+    {"depth", bootDepth, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_I2C)},
+    {"gps", bootGps, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_SERIAL)},
+    {"battery", bootBattery, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_SERIAL)},
+    {"web", bootWeb, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_RADIO)},
+    {"ota", bootOta, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_CONFIG)},
+    {"blackbox", bootBlackbox, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(BOOT_SERIAL)},
+};
 
-  if (currentTime - lastTelemetryTime >= 50) { // 20Hz Telemetry
-    lastTelemetryTime = currentTime;
-    telemetry.protocolVersion = PROTOCOL_VERSION;
-    telemetry.uptime = currentTime;
-    if (batteryManager)
-      telemetry.batteryVoltage =
-          batteryManager->getVoltageMillivolts() / 1000.0f;
-    
-    // Populate GPS if available
-    if (NavigationManager::getInstance().isGPSLocked()) {
-        float lat, lng;
-        NavigationManager::getInstance().getGPSLocation(lat, lng);
-        telemetry.latitude = lat;
-        telemetry.longitude = lng;
-        telemetry.status |= 0x02; // Set gps_lock bit
-    } else {
-        telemetry.latitude = 0;
-        telemetry.longitude = 0;
-        telemetry.status &= ~0x02;
-    }
+// ============================================================================
+// Post-Update Check
+// ============================================================================
+// First boot of a new image: confirmed once UpdateCheck passes, rolled
+// back otherwise. Run by the Arduino loop task, which is otherwise idle.
+#if FEATURE_OTA
+// The Arduino core marks a new image valid before setup() unless told to wait
+extern "C" bool verifyRollbackLater() { return true; }
 
-    ConfigManager::SecurityConfig sec = configManager->getSecurityConfig();
-    if (sec.encryptionEnabled) {
-      telemetry.encryptionFlag = 1;
-      EncryptionManager_generateIV(telemetry.iv);
-      // Encrypt batteryVoltage, rssi, uptime, lat, lng, status (relative offset 2, len 19)
-      // battery(4)+rssi(2)+uptime(4)+lat(4)+lng(4)+status(1) = 19 bytes
-      EncryptionManager_encrypt((uint8_t *)&telemetry.batteryVoltage, 19,
-                                telemetry.iv,
-                                (uint8_t *)&telemetry.batteryVoltage);
-      HMACValidator_generate((uint8_t *)&telemetry.batteryVoltage, 19,
-                             telemetry.hmac);
-    } else {
-      telemetry.encryptionFlag = 0;
+UpdateCheck updateCheck;
+bool updateCheckPending = false; // Running image on trial (setup)
+
+static uint8_t fittedSensors(const BootSequence &boot) {
+  uint8_t found = 0;
+  if (boot.state[BOOT_IMU] == BOOT_STAGE_OK)
+    found |= UPDATE_SENSOR_IMU;
+  if (pitotFitted)
+    found |= UPDATE_SENSOR_PITOT;
+  if (magFitted)
+    found |= UPDATE_SENSOR_MAG;
+  if (baroFitted)
+    found |= UPDATE_SENSOR_BARO;
+  if (pwmExpanderFitted)
+    found |= UPDATE_SENSOR_PWM_EXPANDER;
+  return found;
+}
+
+// Every fitted output of the vehicle's profile drives a LEDC channel
+static bool actuatorsAllocated() {
+  const PinMapProfile &hw = vehicle->getHardware();
+  for (uint8_t i = 0; i < hw.count; i++) {
+    if (hw.outputs[i].pin < 0)
+      continue;
+    bool claimed = false;
+    for (uint8_t ch = 0; ch < 16 && !claimed; ch++) {
+      HAL_PWMChannelInfo info;
+      claimed = HAL_PWMGetChannelInfo(ch, &info) && info.allocated &&
+                info.pin == (uint8_t)hw.outputs[i].pin;
     }
+    if (!claimed)
+      return false;
+  }
+  return true;
+}
+
+static void reportStage(const BootSequence &boot, uint8_t stage, UpdateCheckItem item) {
+  if (boot.state[stage] == BOOT_STAGE_OK || boot.state[stage] == BOOT_STAGE_FAILED ||
+      boot.state[stage] == BOOT_STAGE_SKIPPED)
+    UpdateCheck_report(&updateCheck, item, boot.state[stage] == BOOT_STAGE_OK);
+}
+
+/**
+ * One step of the first-boot check (every 50 ms), or on a boot not on
+ * trial, remember which sensors this image found once they are all up
+ * @return true when finished
+ */
+static bool updateCheckStep(uint32_t now) {
+  BootSequence boot;
+  BootSequence_snapshot(&bootSequence, &boot);
+  bool sensorsUp = boot.state[BOOT_I2C] >= BOOT_STAGE_OK && boot.state[BOOT_IMU] >= BOOT_STAGE_OK &&
+                   boot.state[BOOT_DEPTH] >= BOOT_STAGE_OK;
+  static uint8_t expected = 0;
+  static bool expectedLoaded = false;
+  if (!expectedLoaded && boot.state[BOOT_CONFIG] >= BOOT_STAGE_OK) {
+    ConfigManager::loadBlob(UPDATE_CHECK_SENSORS_KEY, &expected, sizeof(expected));
+    expectedLoaded = true;
+  }
 
-    NA_UPDATE_TELEMETRY_CHECKSUM(&telemetry);
+  if (!updateCheckPending) {
+    if (!sensorsUp || !expectedLoaded)
+      return false;
+    uint8_t found = fittedSensors(boot);
+    if (found != expected)
+      ConfigManager::saveBlob(UPDATE_CHECK_SENSORS_KEY, &found, sizeof(found));
+    return true;
+  }
+
+  reportStage(boot, BOOT_RADIO, UPDATE_CHECK_RADIO);
+  if (boot.state[BOOT_CONFIG] == BOOT_STAGE_OK && boot.state[BOOT_STATE] == BOOT_STAGE_OK)
+    UpdateCheck_report(&updateCheck, UPDATE_CHECK_CONFIG, true);
+  else
+    reportStage(boot, BOOT_CONFIG, UPDATE_CHECK_CONFIG);
+  if (boot.state[BOOT_ACTUATORS] == BOOT_STAGE_OK)
+    UpdateCheck_report(&updateCheck, UPDATE_CHECK_ACTUATORS, actuatorsAllocated());
+  if (sensorsUp && expectedLoaded)
+    UpdateCheck_report(&updateCheck, UPDATE_CHECK_SENSORS,
+                       UpdateCheck_sensorsOk(expected, fittedSensors(boot)));
+  SchedulerTaskStats control; // Task 0 (startScheduler)
+  if (TaskScheduler_isRunning() && TaskScheduler_getStats(0, &control))
+    UpdateCheck_timing(&updateCheck, control.runCount, control.overrunCount);
+
+  UpdateVerdict verdict = UpdateCheck_update(&updateCheck, now);
+  if (verdict == UPDATE_VERDICT_PENDING)
+    return false;
+  const char *cause = UpdateCheck_itemName((UpdateCheckItem)updateCheck.cause);
+  if (verdict == UPDATE_VERDICT_PASS && OTAUpdater_confirmImage()) {
+    LOG_INFO("[Update] New image passed its check in %lu ms\n",
+             (unsigned long)updateCheck.verdictMs);
+    return true;
+  }
+  // Straight to the port: the log task may not drain before the reboot
+  Serial.printf("[Update] New image failed: %s%s\n",
+                verdict == UPDATE_VERDICT_PASS ? "confirm" : cause,
+                updateCheck.timedOut ? " (timeout)" : "");
+  if (configManager)
+    configManager->flush();
+  OTAUpdater_rejectImage();
+  return true; // Nothing to go back to: keep running this one
+}
+#endif
+
+void setup() {
+#if FEATURE_OTA
+  updateCheckPending = OTAUpdater_isPendingVerify();
+  if (updateCheckPending)
+    UpdateCheck_begin(&updateCheck, HAL_GetMillis());
+#endif
+  if (!BootSequence_init(&bootSequence, BOOT_STAGES, BOOT_STAGE_COUNT) ||
+      !BootSequence_run(&bootSequence, SCHED_PRIORITY_BOOT, SCHED_BACKGROUND_CORE)) {
+#if FEATURE_OTA
+    // A new image that cannot bring up the radio goes back at once
+    if (updateCheckPending)
+      OTAUpdater_rejectImage();
+#endif
+    return;
+  }
 
-    JsonDocument telDoc;
-    telDoc["t"] = 2;
-    telDoc["v"] = batteryManager
-                      ? batteryManager->getVoltageMillivolts() / 1000.0f
-                      : 0.0f;
-    if (rssiManager)
-      telDoc["r"] = rssiManager->getRSSIPercentage();
-    MemoryStats memStats = MemoryProfiler_getMemoryStats();
-    telDoc["heap"] = (int)memStats.memoryUtilization;
+  // Liveness watchdog: a stalled task zeroes the outputs and resets the chip
+  Watchdog_init(&watchdog);
+  watchdogControl = Watchdog_register(&watchdog, "control", WATCHDOG_CONTROL_MS);
+  watchdogComms = Watchdog_register(&watchdog, "comms", WATCHDOG_COMMS_MS);
+  watchdogTelemetry = Watchdog_register(&watchdog, "telemetry", WATCHDOG_TELEMETRY_MS);
+  if (!Watchdog_start(&watchdog, HAL_PWMEmergencyStop))
+    Serial.println("[Watchdog] Start failed");
+  WatchdogPostMortem pm;
+  if (Watchdog_getPostMortem(&pm))
+    Serial.printf("[Watchdog] Last reset: %s %lu ms late (deadline %lu ms, reset #%lu)\n",
+                  pm.task, (unsigned long)pm.lateMs, (unsigned long)pm.deadlineMs,
+                  (unsigned long)pm.resetCount);
 
-    serializeJson(telDoc, Serial);
-    Serial.println();
+  initBackgroundJobs(HAL_GetMillis());
 
-    uint8_t broadcastAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-    esp_now_send(broadcastAddress, (uint8_t *)&telemetry, sizeof(telemetry));
-    
-    // Phase 11: WebSocket Broadcast
-    TelemetryWebSocket::getInstance().broadcast(telemetry);
+  // Phase 15: Hand the control path over to pinned FreeRTOS tasks while
+  // the background lane is still bringing up sensors
+  if (!startScheduler()) {
+    Serial.println("[Scheduler] Start failed, falling back to loop()");
+    RateSchedule_init(&rateSchedule, &RATE_PROFILE_FLAT);
   }
-  
-  // Clean up WS clients periodically
-  TelemetryWebSocket::getInstance().cleanUp();
+}
+
+uint32_t lastTelemetryTime = 0;
+
+void loop() {
+  // All periodic work runs in scheduler tasks; the Arduino loop task is no
+  // longer needed once they are up.
+  if (TaskScheduler_isRunning()) {
+#if FEATURE_OTA
+    static bool updateChecked = false;
+    if (!updateChecked) {
+      updateChecked = updateCheckStep(HAL_GetMillis());
+      delay(50);
+      return;
+    }
+#endif
+    BootSequence boot;
+    BootSequence_snapshot(&bootSequence, &boot);
+    if (!BootSequence_isComplete(&boot)) {
+      delay(50);
+      return;
+    }
+    reportMemoryPlacement();
+    vTaskDelete(NULL);
+    return;
+  }
+
+  // Fallback: single-threaded cooperative loop (scheduler failed to start)
+  uint32_t currentTime = HAL_GetMillis();
+#if FEATURE_OTA
+  static bool fallbackChecked = false;
+  if (!fallbackChecked)
+    fallbackChecked = updateCheckStep(currentTime);
+#endif
+  controlTick(currentTime);
+  commsTick(currentTime);
+  sensorTick(currentTime);
+
+  if (currentTime - lastTelemetryTime >= TELEMETRY_PERIOD_MS) {
+    lastTelemetryTime = currentTime;
+    telemetryTick(currentTime);
+  }
+
+  logTick(currentTime);
 
-  uint32_t loopElapsed = millis() - currentTime;
-  uint32_t delayTime = (loopElapsed < 20) ? (20 - loopElapsed) : 0;
+  uint32_t loopElapsed = HAL_GetMillis() - currentTime;
+  uint32_t delayTime = (loopElapsed < CONTROL_PERIOD_MS) ? (CONTROL_PERIOD_MS - loopElapsed) : 0;
   delay(delayTime);
 }
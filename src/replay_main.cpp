@@ -0,0 +1,376 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "BlackboxReplay.h"
+#include "DepthManager.h"
+#include "FailsafeManager.h"
+#include "NavigationManager.h"
+#include "RateProfile.h"
+#include "WaypointManager.h"
+#include "vehicles/VehicleRegistry.h"
+
+/**
+ * Blackbox replay (host only, tools/replay.py)
+ *
+ * Runs a downloaded flight back through the control stack: each record's
+ * inputs go through FailsafeManager, NavigationManager, DepthManager and
+ * the vehicle in controlTick() order, and the record the firmware would
+ * have logged is compared with the one it did log. The clock is
+ * NativeClock's manual mode set to each record's time_ms, so the run is
+ * deterministic and takes milliseconds per minute of flight.
+ *
+ *   replay [--session N] [--vehicle rover|plane|sub|copter]
+ *          [--mission wp.json] [--tol PCT] [--diffs N] LOG
+ *
+ * LOG is a /log/flight download, or a /log/raw image with --session.
+ * The mission is not in the log: --mission gives the uploaded items as
+ * [[lat, lng, alt, speed], ...] in degrees, so waypoint switching can be
+ * replayed. What the log holds as outcomes rather than inputs is taken
+ * from it on its edges: a mission start, an RTL the failsafe did not
+ * start (battery, fence, command) and dive / target changes.
+ *
+ * Prints one {"diff":{...}} line per mismatching tick (the first --diffs
+ * of them) and a {"replay":{...}} summary last. Exit status 1 on any
+ * mismatch, so a build can be bisected against a flight with
+ * `git bisect run tools/replay.py LOG`.
+ *
+ * @file replay_main.cpp
+ */
+
+#define REPLAY_DEFAULT_TOL_PCT 1
+#define REPLAY_DEFAULT_DIFFS 20
+#define REPLAY_DT_S 0.02f // CONTROL_PERIOD_MS (outer loop)
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+struct Options {
+  const char *log;
+  const char *mission;
+  const char *vehicle;
+  int session; // < 0: LOG is a flight download
+  uint8_t tolerance;
+  uint32_t diffs;
+};
+
+static Vehicle *vehicle = nullptr;
+static VehicleType vehicleType = VEHICLE_DEFAULT_TYPE;
+static FailsafeManager failsafe;
+
+static uint8_t *readFile(const char *path, size_t *size) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return nullptr;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *buf = n > 0 ? (uint8_t *)malloc((size_t)n + 1) : nullptr;
+  if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+    free(buf);
+    buf = nullptr;
+  }
+  fclose(f);
+  if (buf) {
+    buf[n] = '\0';
+    *size = (size_t)n;
+  }
+  return buf;
+}
+
+static bool parseArgs(int argc, char **argv, Options &opt) {
+  opt = {nullptr, nullptr, nullptr, -1, REPLAY_DEFAULT_TOL_PCT, REPLAY_DEFAULT_DIFFS};
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool more = i + 1 < argc;
+    if (!strcmp(arg, "--session") && more)
+      opt.session = atoi(argv[++i]);
+    else if (!strcmp(arg, "--vehicle") && more)
+      opt.vehicle = argv[++i];
+    else if (!strcmp(arg, "--mission") && more)
+      opt.mission = argv[++i];
+    else if (!strcmp(arg, "--tol") && more)
+      opt.tolerance = (uint8_t)atoi(argv[++i]);
+    else if (!strcmp(arg, "--diffs") && more)
+      opt.diffs = (uint32_t)atoi(argv[++i]);
+    else if (arg[0] != '-' && !opt.log)
+      opt.log = arg;
+    else
+      return false;
+  }
+  return opt.log != nullptr;
+}
+
+static bool loadMission(const char *path) {
+  size_t size;
+  char *text = (char *)readFile(path, &size);
+  if (!text)
+    return false;
+  JsonDocument doc;
+  bool ok = deserializeJson(doc, text) == DeserializationError::Ok && doc.is<JsonArray>();
+  free(text);
+  if (!ok)
+    return false;
+  WaypointManager &wm = WaypointManager::getInstance();
+  wm.clearMission();
+  for (JsonArray item : doc.as<JsonArray>()) {
+    wm.addWaypointE7(NavFrame_toE7(item[0].as<double>()), NavFrame_toE7(item[1].as<double>()),
+                     item[2] | 0.0f, item[3] | WAYPOINT_DEFAULT_SPEED);
+  }
+  return true;
+}
+
+// ============================================================================
+// Control tick
+// ============================================================================
+
+// main.cpp applyFailsafe(), on the replay's failsafe manager
+static void applyFailsafe(NAPacket &cmd) {
+  static FailsafeAction lastAction = FAILSAFE_ACTION_NONE;
+  NavigationManager &nav = NavigationManager::getInstance();
+  NavigationState navState = nav.getState();
+  bool rtlAvailable = (navState.homeLat != 0 || navState.homeLng != 0) && nav.isGPSLocked();
+  FailsafeAction action = failsafe.getAction(vehicle->getFailsafePolicy(), rtlAvailable,
+                                             vehicle->checkCriticalFault());
+  if (action != lastAction) {
+    if (action == FAILSAFE_ACTION_RTL && !navState.isRTLActive)
+      nav.executeRTL();
+    lastAction = action;
+  }
+
+  if (action == FAILSAFE_ACTION_NONE)
+    return;
+  if (action == FAILSAFE_ACTION_RTL && nav.getState().isRTLActive) {
+    cmd.mode |= MODE_AUTO;
+    return;
+  }
+  cmd.throttle = 0;
+  cmd.roll = 0;
+  cmd.pitch = 0;
+  cmd.yaw = 0;
+  cmd.mode &= ~MODE_AUTO;
+  if (action == FAILSAFE_ACTION_SURFACE)
+    DepthManager::getInstance().setDiving(false);
+}
+
+// What the log decided outside the control tick, on its edges
+static void applyEvents(const BlackboxRecord &rec, uint8_t lastFlags) {
+  NavigationManager &nav = NavigationManager::getInstance();
+  DepthManager &depth = DepthManager::getInstance();
+  uint8_t rising = rec.navFlags & ~lastFlags;
+
+  if ((rising & BLACKBOX_NAV_MISSION) && !nav.getState().isMissionActive)
+    nav.startMission();
+  // A failsafe RTL is the replay's own to start (applyFailsafe)
+  if ((rising & BLACKBOX_NAV_RTL) && !nav.getState().isRTLActive &&
+      rec.failsafe == FAILSAFE_ARMED)
+    nav.executeRTL();
+
+  float target = rec.depthTarget / 100.0f;
+  if (fabsf(depth.getTargetDepth() - target) > 0.005f)
+    depth.setTargetDepth(target);
+  if ((rec.navFlags ^ lastFlags) & BLACKBOX_NAV_DIVING)
+    depth.setDiving(rec.navFlags & BLACKBOX_NAV_DIVING);
+}
+
+// One control tick on a record's inputs; the record it would log
+static void replayTick(const BlackboxRecord &rec, uint8_t lastFlags, BlackboxRecord &out) {
+  NavigationManager &nav = NavigationManager::getInstance();
+  DepthManager &depth = DepthManager::getInstance();
+  NativeClock_setMicros((uint64_t)rec.timeMs * 1000);
+  failsafe.update(rec.timeMs);
+
+  GPSFix fix;
+  memset(&fix, 0, sizeof(fix));
+  fix.lat = rec.navLat;
+  fix.lng = rec.navLng;
+  fix.timeMs = rec.timeMs;
+  fix.valid = rec.inputs & BLACKBOX_IN_GPS;
+  fix.fixType = fix.valid ? 3 : 0;
+  nav.setGPSFix(fix);
+  applyEvents(rec, lastFlags);
+  float heading = rec.heading / 100.0f;
+  nav.update(rec.navLat, rec.navLng, heading);
+
+  // Packets of this tick land after the failsafe update, as on target
+  if (rec.linkAgeMs != 0xFFFF)
+    failsafe.recordPacketReceived(rec.timeMs - rec.linkAgeMs);
+
+  NAPacket cmd;
+  memset(&cmd, 0, sizeof(cmd));
+  cmd.throttle = rec.pilot[0];
+  cmd.roll = rec.pilot[1];
+  cmd.pitch = rec.pilot[2];
+  cmd.yaw = rec.pilot[3];
+  cmd.mode = rec.pilotMode;
+  cmd.sequenceNumber = rec.sequence;
+  applyFailsafe(cmd);
+
+  if (cmd.mode & MODE_AUTO) {
+    int16_t navThrottle = 0, navYaw = 0;
+    if (nav.getNavigationOutput(navThrottle, navYaw)) {
+      cmd.throttle = navThrottle;
+      cmd.roll = navYaw;
+    } else if (nav.getState().isRTLActive) {
+      nav.stopMission();
+      cmd.throttle = 0;
+      cmd.roll = 0;
+    }
+  }
+
+  if (!nav.hasHome() && nav.isGPSLocked()) {
+    float lat, lng;
+    nav.getGPSLocation(lat, lng);
+    nav.setHome(lat, lng);
+  }
+
+  if (vehicleType == VEHICLE_SUB)
+    depth.replaySample(rec.depth / 100.0f);
+  if (rec.inputs & BLACKBOX_IN_ATTITUDE) {
+    // Logged heading stands in for the estimator yaw (CCW)
+    VehicleAttitude att = {(float)(rec.attRoll / 100.0f * DEG_TO_RAD),
+                           (float)(rec.attPitch / 100.0f * DEG_TO_RAD),
+                           (float)(-heading * DEG_TO_RAD),
+                           {rec.gyro[0] / 1000.0f, rec.gyro[1] / 1000.0f, rec.gyro[2] / 1000.0f},
+                           true};
+    vehicle->setAttitude(att);
+  }
+  depth.updateControl(REPLAY_DT_S);
+  vehicle->setInputs(&cmd);
+  // The inner loop ticks the firmware ran per record (RateProfile)
+  const RateProfile *rates = RateProfile_forVehicle(vehicleType);
+  for (uint8_t i = 0; i < rates->outerDiv; i++)
+    vehicle->loop(rates->innerPeriodMs * 1e-3f);
+
+  out = rec;
+  out.throttle = cmd.throttle;
+  out.roll = cmd.roll;
+  out.pitch = cmd.pitch;
+  out.yaw = cmd.yaw;
+  out.mode = cmd.mode;
+  out.failsafe = (uint8_t)failsafe.getState();
+  vehicle->getMixedOutput(out.outputs, sizeof(out.outputs));
+  const NavigationState &state = nav.getState();
+  out.waypoint = state.currentWaypointIndex;
+  out.navFlags = (state.isMissionActive ? BLACKBOX_NAV_MISSION : 0) |
+                 (state.isRTLActive ? BLACKBOX_NAV_RTL : 0) |
+                 (state.isLoitering ? BLACKBOX_NAV_LOITER : 0) |
+                 (state.isSurveyActive ? BLACKBOX_NAV_SURVEY : 0) |
+                 (depth.isDiving() ? BLACKBOX_NAV_DIVING : 0);
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+static void printDiff(const BlackboxRecord &logged, const BlackboxRecord &replayed,
+                      uint8_t diff) {
+  char kinds[48] = "";
+  for (uint8_t bit = 1; bit < (1 << BLACKBOX_REPLAY_DIFF_KINDS); bit <<= 1) {
+    if (!(diff & bit))
+      continue;
+    if (kinds[0])
+      strcat(kinds, ",");
+    strcat(kinds, BlackboxReplay_diffName(bit));
+  }
+  const BlackboxRecord *r[2] = {&logged, &replayed};
+  printf("{\"diff\":{\"t\":%u,\"kinds\":\"%s\"", (unsigned)logged.timeMs, kinds);
+  for (int i = 0; i < 2; i++) {
+    printf(",\"%s\":{\"in\":[%d,%d,%d,%d],\"mode\":%u,\"fs\":%u,\"out\":[%u,%u,%u,%u],"
+           "\"wp\":%u,\"nav\":%u}",
+           i ? "replay" : "log", r[i]->throttle, r[i]->roll, r[i]->pitch, r[i]->yaw,
+           r[i]->mode, r[i]->failsafe, r[i]->outputs[0], r[i]->outputs[1], r[i]->outputs[2],
+           r[i]->outputs[3], r[i]->waypoint, r[i]->navFlags);
+  }
+  printf("}}\n");
+}
+
+static double hostSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void printSummary(const BlackboxReplayCursor &cursor, const BlackboxReplayStats &stats,
+                         double wallS) {
+  float rms = 0.0f;
+  uint8_t max = 0;
+  for (uint8_t i = 0; i < BLACKBOX_REPLAY_OUTPUTS; i++) {
+    rms = fmaxf(rms, BlackboxReplay_outputRms(&stats, i));
+    if (stats.maxOutput[i] > max)
+      max = stats.maxOutput[i];
+  }
+  printf("{\"replay\":{\"vehicle\":\"%s\",\"records\":%u,\"skipped_sectors\":%u,"
+         "\"mismatches\":%u,\"first_ms\":%u,\"first\":%u,"
+         "\"inputs\":%u,\"outputs\":%u,\"failsafe\":%u,\"nav\":%u,"
+         "\"out_max\":%u,\"out_rms\":%.3f,\"in_max\":%d,"
+         "\"wall_ms\":%.1f,\"ticks_per_s\":%.0f}}\n",
+         vehicle->getName(), (unsigned)cursor.records, (unsigned)cursor.skipped,
+         (unsigned)stats.mismatches, (unsigned)stats.firstMs, stats.firstDiff,
+         (unsigned)stats.kinds[0], (unsigned)stats.kinds[1], (unsigned)stats.kinds[2],
+         (unsigned)stats.kinds[3], max, rms, stats.maxInput, wallS * 1000.0,
+         wallS > 0.0 ? stats.ticks / wallS : 0.0);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    fprintf(stderr, "usage: %s [--session N] [--vehicle NAME] [--mission wp.json] "
+                    "[--tol PCT] [--diffs N] LOG\n", argv[0]);
+    return 2;
+  }
+  size_t size = 0;
+  uint8_t *image = readFile(opt.log, &size);
+  BlackboxReplayCursor cursor;
+  bool opened = image && (opt.session < 0
+                              ? BlackboxReplay_openFlight(&cursor, image, size)
+                              : BlackboxReplay_openSession(&cursor, image, size,
+                                                           (uint16_t)opt.session));
+  if (!opened) {
+    printf("{\"error\":\"log\",\"path\":\"%s\"}\n", opt.log);
+    return 2;
+  }
+  if (opt.vehicle && !VehicleRegistry_parse(opt.vehicle, &vehicleType)) {
+    printf("{\"error\":\"vehicle\",\"name\":\"%s\"}\n", opt.vehicle);
+    return 2;
+  }
+  if (opt.mission && !loadMission(opt.mission)) {
+    printf("{\"error\":\"mission\",\"path\":\"%s\"}\n", opt.mission);
+    return 2;
+  }
+
+  const BlackboxRecord *rec = BlackboxReplay_next(&cursor);
+  NativeClock_setMicros(rec ? (uint64_t)rec->timeMs * 1000 : 0);
+  vehicle = VehicleRegistry_create(vehicleType);
+  vehicle->setup();
+  NavigationManager::getInstance().init();
+  failsafe.setup();
+  if (vehicleType == VEHICLE_SUB)
+    DepthManager::getInstance().begin();
+
+  BlackboxReplayTolerance tol = {opt.tolerance, 0};
+  BlackboxReplayStats stats;
+  memset(&stats, 0, sizeof(stats));
+  uint8_t lastFlags = 0;
+  double wallStart = hostSeconds();
+  for (; rec; rec = BlackboxReplay_next(&cursor)) {
+    BlackboxRecord logged = *rec; // Packed in the image: work on a copy
+    BlackboxRecord replayed;
+    replayTick(logged, lastFlags, replayed);
+    lastFlags = logged.navFlags;
+    uint8_t diff = BlackboxReplay_compare(&stats, &tol, &logged, &replayed);
+    if (diff && stats.mismatches <= opt.diffs)
+      printDiff(logged, replayed, diff);
+  }
+  printSummary(cursor, stats, hostSeconds() - wallStart);
+  free(image);
+  return stats.mismatches ? 1 : 0;
+}
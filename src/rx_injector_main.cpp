@@ -0,0 +1,234 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <string.h>
+#include "EncryptionManager.h"
+#include "HMACValidator.h"
+#include "NAPacket.h"
+#include "RxStress.h"
+#include "WifiLink.h"
+
+/**
+ * Receive pipeline flood injector (env:rx_injector)
+ *
+ * Replaces main.cpp on a second ESP32: sends RxStress traffic at the
+ * vehicle over ESP-NOW so its receive path can be measured on target.
+ * One JSON line over serial starts a run, all keys optional:
+ *
+ *   {"mac":"24:6F:28:00:00:01","ch":1,"pps":2000,"s":10,"valid":70,
+ *    "crc":10,"hmac":10,"replay":5,"big":5,"enc":50,"secret":"..."}
+ *
+ * "secret" is the vehicle's shared_secret (set_security_config), so
+ * encrypted frames are sealed exactly like the controller seals them;
+ * without it every frame goes out clear. One JSON line per second and a
+ * summary at the end: frames sent per kind, achieved rate, and frames
+ * the radio refused (queue full) or lost (no ACK).
+ *
+ * The vehicle side is read with its own commands: reset get_prof before
+ * the run, then ping (rx stage counters), get_prof (rx_accept in the
+ * Wi-Fi task, rx_verify in the control task) and get_perf (control loop
+ * jitter). See docs/systems/connectivity.md.
+ *
+ * @file rx_injector_main.cpp
+ */
+
+#define INJECT_DEFAULT_PPS 1000
+#define INJECT_MAX_PPS 5000
+#define INJECT_DEFAULT_SECONDS 10
+#define INJECT_MAX_SECONDS 600
+
+// ============================================================================
+// State
+// ============================================================================
+
+static const uint8_t BROADCAST[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static uint8_t target[6];
+static bool keyed = false;
+static uint8_t frame[RX_STRESS_FRAME_MAX];
+static RxStressGen gen;
+static char line[512];
+static size_t lineLen = 0;
+
+static volatile uint32_t delivered = 0;
+static volatile uint32_t lost = 0;
+
+static void onSent(const uint8_t *mac, esp_now_send_status_t status) {
+  (void)mac;
+  if (status == ESP_NOW_SEND_SUCCESS)
+    delivered++;
+  else
+    lost++;
+}
+
+// Same sealing as the controller: HMAC and CRC over the plaintext, then
+// the payload (throttle..buttons) encrypted in place
+static void sealKeyed(NAPacket *pkt, bool encrypted, void *ctx) {
+  (void)ctx;
+  if (!encrypted || !keyed) {
+    RxStress_sealClear(pkt, false, NULL);
+    return;
+  }
+  pkt->encryptionFlag = NA_ENCRYPTION_CTR_HMAC;
+  EncryptionManager_generateIV(pkt->iv);
+  HMACValidator_generate((uint8_t *)&pkt->throttle, 10, pkt->hmac);
+  NA_UPDATE_PACKET_CHECKSUM(pkt);
+  EncryptionManager_encrypt((const uint8_t *)&pkt->throttle, 10, pkt->iv,
+                            (uint8_t *)&pkt->throttle);
+}
+
+static bool parseMac(const char *text, uint8_t *mac) {
+  unsigned int b[6];
+  if (!text || sscanf(text, "%x:%x:%x:%x:%x:%x", &b[0], &b[1], &b[2], &b[3],
+                      &b[4], &b[5]) != 6)
+    return false;
+  for (int i = 0; i < 6; i++)
+    mac[i] = (uint8_t)b[i];
+  return true;
+}
+
+static bool setTarget(const uint8_t *mac) {
+  if (esp_now_is_peer_exist(target))
+    esp_now_del_peer(target);
+  memcpy(target, mac, 6);
+  esp_now_peer_info_t peer;
+  memset(&peer, 0, sizeof(peer));
+  memcpy(peer.peer_addr, target, 6);
+  peer.channel = 0; // Current channel
+  peer.ifidx = WIFI_IF_STA;
+  peer.encrypt = false;
+  return esp_now_add_peer(&peer) == ESP_OK;
+}
+
+// ============================================================================
+// Run
+// ============================================================================
+
+static void printProgress(const char *key, uint32_t sent, uint32_t busy,
+                          uint32_t elapsedMs) {
+  Serial.printf("{\"%s\":true,\"ms\":%lu,\"sent\":%lu,\"busy\":%lu,\"acked\":%lu,"
+                "\"lost\":%lu,\"pps\":%lu",
+                key, (unsigned long)elapsedMs, (unsigned long)sent,
+                (unsigned long)busy, (unsigned long)delivered, (unsigned long)lost,
+                (unsigned long)(elapsedMs ? (uint64_t)sent * 1000 / elapsedMs : 0));
+  for (int k = 0; k < RX_STRESS_KINDS; k++)
+    Serial.printf(",\"%s\":%lu", RxStress_kindName((RxStressKind)k),
+                  (unsigned long)gen.generated[k]);
+  Serial.println("}");
+}
+
+static void runFlood(JsonDocument &doc) {
+  uint8_t mac[6];
+  if (!doc["mac"].isNull() && (!parseMac(doc["mac"], mac) || !setTarget(mac))) {
+    Serial.println("{\"error\":\"mac\"}");
+    return;
+  }
+  if (!doc["ch"].isNull()) {
+    uint8_t ch = doc["ch"];
+    esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE);
+  }
+  if (!doc["secret"].isNull()) {
+    uint8_t secret[32] = {0};
+    strncpy((char *)secret, doc["secret"] | "", 31); // As set_security_config
+    keyed = EncryptionManager_init(secret) && HMACValidator_init(secret);
+  }
+
+  RxStressMix mix;
+  RxStress_defaultMix(&mix);
+  mix.weights[RX_STRESS_VALID] = doc["valid"] | mix.weights[RX_STRESS_VALID];
+  mix.weights[RX_STRESS_BAD_CRC] = doc["crc"] | mix.weights[RX_STRESS_BAD_CRC];
+  mix.weights[RX_STRESS_BAD_HMAC] = doc["hmac"] | mix.weights[RX_STRESS_BAD_HMAC];
+  mix.weights[RX_STRESS_REPLAY] = doc["replay"] | mix.weights[RX_STRESS_REPLAY];
+  mix.weights[RX_STRESS_OVERSIZED] = doc["big"] | mix.weights[RX_STRESS_OVERSIZED];
+  mix.encryptedPercent = doc["enc"] | mix.encryptedPercent;
+
+  uint32_t pps = doc["pps"] | INJECT_DEFAULT_PPS;
+  uint32_t seconds = doc["s"] | INJECT_DEFAULT_SECONDS;
+  if (pps < 1 || pps > INJECT_MAX_PPS || seconds < 1 || seconds > INJECT_MAX_SECONDS) {
+    Serial.println("{\"error\":\"range\"}");
+    return;
+  }
+
+  // Neutral sticks, zero throttle: accepted frames never move the vehicle
+  NAPacket templ;
+  memset(&templ, 0, sizeof(templ));
+  templ.protocolVersion = PROTOCOL_VERSION;
+  if (!RxStress_init(&gen, &mix, &templ, esp_random(), sealKeyed, NULL)) {
+    Serial.println("{\"error\":\"mix\"}");
+    return;
+  }
+
+  Serial.printf("{\"inject_start\":true,\"pps\":%lu,\"s\":%lu,\"keyed\":%s}\n",
+                (unsigned long)pps, (unsigned long)seconds, keyed ? "true" : "false");
+  delivered = 0;
+  lost = 0;
+  uint32_t sent = 0;
+  uint32_t busy = 0;
+  uint32_t gapUs = 1000000 / pps;
+  uint32_t startUs = micros();
+  uint32_t nextUs = startUs;
+  uint32_t reportMs = millis() + 1000;
+  uint32_t total = pps * seconds;
+
+  // Fixed schedule: a late frame does not push the ones after it back
+  for (uint32_t i = 0; i < total; i++) {
+    while ((int32_t)(micros() - nextUs) < 0) {
+    }
+    nextUs += gapUs;
+    uint16_t len;
+    RxStress_next(&gen, frame, &len, NULL);
+    if (esp_now_send(target, frame, len) == ESP_OK)
+      sent++;
+    else
+      busy++; // Radio queue full: the injector, not the vehicle, is the limit
+
+    if ((int32_t)(millis() - reportMs) >= 0) {
+      reportMs += 1000;
+      printProgress("inject", sent, busy, (micros() - startUs) / 1000);
+    }
+    if (Serial.available())
+      break; // Any input aborts
+  }
+  delay(50); // Last send callbacks
+  printProgress("inject_done", sent, busy, (micros() - startUs) / 1000);
+}
+
+// ============================================================================
+// Setup / Loop
+// ============================================================================
+
+void setup() {
+  Serial.begin(115200);
+  WiFi.mode(WIFI_STA);
+  esp_wifi_set_ps(WIFI_PS_NONE);
+  esp_wifi_set_channel(WIFI_LINK_DEFAULT_CHANNEL, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("{\"error\":\"esp_now\"}");
+    return;
+  }
+  esp_now_register_send_cb(onSent);
+  setTarget(BROADCAST); // Until a mac is given
+  Serial.printf("{\"injector\":true,\"mac\":\"%s\"}\n", WiFi.macAddress().c_str());
+}
+
+void loop() {
+  while (Serial.available()) {
+    char c = (char)Serial.read();
+    if (c == '\n' || c == '\r') {
+      if (lineLen == 0)
+        continue;
+      line[lineLen] = '\0';
+      lineLen = 0;
+      JsonDocument doc;
+      if (deserializeJson(doc, line) != DeserializationError::Ok) {
+        Serial.println("{\"error\":\"json\"}");
+        continue;
+      }
+      runFlood(doc);
+    } else if (lineLen < sizeof(line) - 1) {
+      line[lineLen++] = c;
+    }
+  }
+  delay(10);
+}
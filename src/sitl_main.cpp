@@ -0,0 +1,543 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ConfigManager.h"
+#include "DepthManager.h"
+#include "HAL.h"
+#include "NavFrame.h"
+#include "NavigationManager.h"
+#include "NativeHAL.h"
+#include "SimModel.h"
+#include "ThrustAllocator.h"
+#include "WaypointManager.h"
+#include "drivers/MS5837Async.h"
+#include "vehicles/Copter.h"
+#include "vehicles/VehicleRegistry.h"
+
+/**
+ * Software-in-the-loop simulator (host only, tools/sitl.py)
+ *
+ * Runs the real vehicle classes, NavigationManager, WaypointManager and
+ * DepthManager against SimModel physics on the native HAL, with the
+ * clock in NativeClock's manual mode: a minute of mission takes a few
+ * milliseconds unless the scenario asks for pacing. One scenario JSON
+ * file per run, all keys optional except "vehicle":
+ *
+ *   {"vehicle":"rover","origin":[13.7,100.5],"seed":1,"duration":120,
+ *    "speedup":0,"gps":{"hz":5,"noise":0.3},"current":[0,0.3],
+ *    "params":{"maxSpeed":1.2},"mission":[[20,0],[20,20,0,1200]],
+ *    "depth":2.0,"sticks":[[0,550,0,0,0],[5,550,300,0,0]],
+ *    "thrusters":[[0,0,0,1,0,0],...]}
+ *
+ * "mission" items are north / east metres from the origin (optional alt,
+ * speed); "sticks" rows are [t, throttle, roll, pitch, yaw] held from t
+ * on; "speedup" paces the run at that many times real time (0 = as fast
+ * as possible). The glue follows main.cpp's control task: GPS fix into
+ * NavigationManager, GPS course as heading, MODE_AUTO output on throttle
+ * and roll, depth loop, setInputs() / loop() at 50 Hz. Physics run at
+ * 200 Hz; outputs are read back from the PWM channels and direction
+ * pins the vehicle drives. The MS5837 is emulated on the I2C bus, so the
+ * depth path is the real driver's conversions and timing.
+ *
+ * Firmware logging goes to stdout as on target; the last line is the
+ * summary, {"sitl":{...}}, which tools/sitl.py checks against the
+ * scenario's limits.
+ *
+ * @file sitl_main.cpp
+ */
+
+#define SITL_PHYSICS_SUBSTEPS 4
+#define SITL_DEPTH_PERIOD_US 10000
+#define SITL_DEFAULT_GPS_HZ 5
+#define SITL_DEFAULT_DURATION_S 120.0f
+#define SITL_MAX_STICKS 32
+#define SITL_MAX_LEGS 64
+#define SITL_SETTLE_S 1.0f // Depth / rate metrics start after this
+#define SITL_ATM_PA 101300.0f
+#define SITL_WATER_DENSITY 1029.0f // As DepthManager::begin()
+#define MS5837_EMU_ADDR 0x76
+
+// ============================================================================
+// Scenario
+// ============================================================================
+
+struct Sticks {
+  float t;
+  int16_t throttle, roll, pitch, yaw;
+};
+
+static SimModel sim;
+static Vehicle *vehicle = nullptr;
+static VehicleType vehicleType;
+static NavVector legs[SITL_MAX_LEGS + 1]; // Origin, then the mission items
+static uint8_t legCount = 0;
+static Sticks sticks[SITL_MAX_STICKS];
+static uint8_t stickCount = 0;
+static float duration = SITL_DEFAULT_DURATION_S;
+static float speedup = 0.0f;
+static uint32_t gpsPeriodUs = 1000000 / SITL_DEFAULT_GPS_HZ;
+static float targetDepth = -1.0f; // < 0: no depth hold
+
+static bool readFile(const char *path, char *buf, size_t size) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  size_t n = fread(buf, 1, size - 1, f);
+  fclose(f);
+  buf[n] = '\0';
+  return n > 0;
+}
+
+static void applyParams(JsonObject p, SimParams &params) {
+  params.mass = p["mass"] | params.mass;
+  params.maxThrust = p["maxThrust"] | params.maxThrust;
+  params.maxSpeed = p["maxSpeed"] | params.maxSpeed;
+  params.motorTau = p["motorTau"] | params.motorTau;
+  params.track = p["track"] | params.track;
+  params.surgeDrag = p["surgeDrag"] | params.surgeDrag;
+  params.swayDrag = p["swayDrag"] | params.swayDrag;
+  params.heaveDrag = p["heaveDrag"] | params.heaveDrag;
+  params.yawInertia = p["yawInertia"] | params.yawInertia;
+  params.yawDrag = p["yawDrag"] | params.yawDrag;
+  params.tiltInertia = p["tiltInertia"] | params.tiltInertia;
+  params.tiltDrag = p["tiltDrag"] | params.tiltDrag;
+  params.armLength = p["armLength"] | params.armLength;
+  params.yawTorque = p["yawTorque"] | params.yawTorque;
+  params.buoyancy = p["buoyancy"] | params.buoyancy;
+}
+
+// Thruster layout for the Sub: into NVS (the Sub loads it in setup())
+// and into the model, so mixer changes are flown as configured
+static bool applyThrusters(JsonArray rows, SimParams &params) {
+  ThrustConfig config;
+  memset(&config, 0, sizeof(config));
+  for (JsonArray r : rows) {
+    if (config.count >= THRUST_MAX_THRUSTERS || r.size() != 6)
+      return false;
+    config.thrusters[config.count++] = {r[0].as<float>(), r[1].as<float>(),
+                                        r[2].as<float>(), r[3].as<float>(),
+                                        r[4].as<float>(), r[5].as<float>()};
+  }
+  if (!ThrustAllocator_sanitize(&config))
+    return false;
+  params.thrusters = config;
+  return ConfigManager::saveBlob(THRUST_CONFIG_KEY, &config, sizeof(config));
+}
+
+static bool loadScenario(JsonDocument &doc) {
+  const char *name = doc["vehicle"] | "";
+  SimKind kind = SimModel_kindFromName(name);
+  static const VehicleType types[SIM_KIND_COUNT] = {VEHICLE_ROVER, VEHICLE_ROVER,
+                                                    VEHICLE_SUB, VEHICLE_COPTER};
+  if (kind == SIM_KIND_COUNT) {
+    Serial.printf("{\"error\":\"vehicle\",\"name\":\"%s\"}\n", name);
+    return false;
+  }
+  vehicleType = types[kind];
+
+  SimParams params;
+  SimModel_defaultParams(kind, &params);
+  applyParams(doc["params"], params);
+  params.currentN = doc["current"][0] | 0.0f;
+  params.currentE = doc["current"][1] | 0.0f;
+  if (!doc["thrusters"].isNull() && !applyThrusters(doc["thrusters"], params)) {
+    Serial.println("{\"error\":\"thrusters\"}");
+    return false;
+  }
+
+  double lat = doc["origin"][0] | 13.7;
+  double lng = doc["origin"][1] | 100.5;
+  SimModel_init(&sim, &params, (int32_t)lround(lat * 1e7), (int32_t)lround(lng * 1e7),
+                doc["seed"] | 1u);
+  sim.gpsNoiseM = doc["gps"]["noise"] | sim.gpsNoiseM;
+  uint32_t hz = doc["gps"]["hz"] | SITL_DEFAULT_GPS_HZ;
+  gpsPeriodUs = 1000000 / (hz ? hz : 1);
+
+  duration = doc["duration"] | SITL_DEFAULT_DURATION_S;
+  speedup = doc["speedup"] | 0.0f;
+  targetDepth = doc["depth"] | -1.0f;
+
+  legs[0] = {0.0f, 0.0f};
+  legCount = 1;
+  for (JsonArray item : doc["mission"].as<JsonArray>()) {
+    if (legCount > SITL_MAX_LEGS)
+      break;
+    legs[legCount++] = {item[0] | 0.0f, item[1] | 0.0f};
+  }
+  stickCount = 0;
+  for (JsonArray row : doc["sticks"].as<JsonArray>()) {
+    if (stickCount >= SITL_MAX_STICKS)
+      break;
+    sticks[stickCount++] = {row[0] | 0.0f, (int16_t)(row[1] | 0), (int16_t)(row[2] | 0),
+                            (int16_t)(row[3] | 0), (int16_t)(row[4] | 0)};
+  }
+  return true;
+}
+
+// Mission goes in once home is known, in the frame of the sim origin
+static void uploadMission(JsonDocument &doc) {
+  WaypointManager &wm = WaypointManager::getInstance();
+  wm.clearMission();
+  for (JsonArray item : doc["mission"].as<JsonArray>()) {
+    NavVector p = {item[0] | 0.0f, item[1] | 0.0f};
+    int32_t lat, lng;
+    NavFrame_toGlobal(&sim.frame, p, &lat, &lng);
+    wm.addWaypointE7(lat, lng, item[2] | 0.0f, item[3] | WAYPOINT_DEFAULT_SPEED);
+  }
+}
+
+// ============================================================================
+// MS5837 emulation
+// ============================================================================
+
+struct DepthSensorEmu {
+  uint16_t prom[7];
+  uint32_t d1, d2;
+  uint8_t pending;   // 0 none, else the command being converted
+  uint32_t startUs;
+  uint32_t readyUs;
+  float depth;       // Latest noisy depth, sampled at conversion start
+};
+
+static DepthSensorEmu depthEmu;
+
+static void depthEmuInit(DepthSensorEmu &emu) {
+  // Plausible 30BA calibration; C5 makes D2 = C5 * 256 read 20.00 C,
+  // which zeroes dT and every second-order term
+  static const uint16_t prom[7] = {0, 34982, 36352, 20328, 22354, 26646, 26146};
+  memcpy(emu.prom, prom, sizeof(prom));
+  emu.prom[0] = (uint16_t)MS5837Async::crc4(emu.prom) << 12;
+  emu.d2 = (uint32_t)emu.prom[5] << 8;
+  emu.pending = 0;
+}
+
+// Inverse of MS5837Async::compute() at dT = 0
+static uint32_t depthEmuD1(const DepthSensorEmu &emu, float depth) {
+  double pressure01 = (SITL_ATM_PA + depth * SITL_WATER_DENSITY * SIM_GRAVITY) / 10.0;
+  double sens = (double)emu.prom[1] * 32768.0;
+  double off = (double)emu.prom[2] * 65536.0;
+  double d1 = (pressure01 * 8192.0 + off) * 2097152.0 / sens;
+  return d1 < 0.0 ? 0 : d1 > 16777215.0 ? 16777215 : (uint32_t)d1;
+}
+
+static bool depthEmuTransfer(const uint8_t *tx, uint8_t txLen, uint8_t *rx, uint8_t rxLen,
+                             void *ctx) {
+  DepthSensorEmu &emu = *(DepthSensorEmu *)ctx;
+  if (txLen == 0)
+    return rxLen == 0; // Probe ACKs, bare reads are not part of the protocol
+  uint8_t cmd = tx[0];
+
+  if (cmd == 0x1E) { // Reset
+    emu.pending = 0;
+  } else if (cmd >= 0xA0 && cmd <= 0xAC && rxLen == 2) { // PROM word
+    uint16_t word = emu.prom[(cmd - 0xA0) / 2];
+    rx[0] = word >> 8;
+    rx[1] = word & 0xFF;
+  } else if ((cmd & 0xF0) == 0x40 || (cmd & 0xF0) == 0x50) { // Convert D1 / D2
+    uint8_t osr = (cmd & 0x0F) / 2;
+    emu.pending = cmd & 0xF0;
+    emu.startUs = micros();
+    emu.readyUs = MS5837Async::conversionTimeUs((MS5837Async::Osr)osr);
+    if (emu.pending == 0x40)
+      emu.d1 = depthEmuD1(emu, SimModel_depth(&sim));
+  } else if (cmd == 0x00 && rxLen == 3) { // ADC read
+    uint32_t adc = 0; // Early read: the chip returns 0
+    if (emu.pending && micros() - emu.startUs >= emu.readyUs)
+      adc = emu.pending == 0x40 ? emu.d1 : emu.d2;
+    emu.pending = 0;
+    rx[0] = adc >> 16;
+    rx[1] = (adc >> 8) & 0xFF;
+    rx[2] = adc & 0xFF;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// ============================================================================
+// Outputs
+// ============================================================================
+
+// Signed command per output slot, from the PWM channel on its pin and
+// the direction pins (forward HIGH = +, reverse HIGH = -)
+static uint8_t readOutputs(const PinMapProfile &hw, float *out) {
+  uint8_t count = hw.count < SIM_MAX_OUTPUTS ? hw.count : SIM_MAX_OUTPUTS;
+  for (uint8_t i = 0; i < count; i++) {
+    const PinMapOutput &o = hw.outputs[i];
+    out[i] = 0.0f;
+    if (o.pin < 0)
+      continue;
+    HAL_PWMChannelInfo info;
+    for (uint8_t ch = 0; HAL_PWMGetChannelInfo(ch, &info); ch++) {
+      if (!info.allocated || info.pin != o.pin)
+        continue;
+      float magnitude = info.duty / (float)((1UL << info.resolution) - 1);
+      if (o.dir1 < 0 && o.dir2 < 0) {
+        out[i] = magnitude; // ESC / servo: no direction
+      } else {
+        bool forward = o.dir1 >= 0 && digitalRead(o.dir1) == HIGH;
+        bool reverse = o.dir2 >= 0 && digitalRead(o.dir2) == HIGH;
+        out[i] = forward == reverse ? 0.0f : forward ? magnitude : -magnitude;
+      }
+      break;
+    }
+  }
+  return count;
+}
+
+// ============================================================================
+// Metrics
+// ============================================================================
+
+struct Metrics {
+  bool started;
+  bool complete;
+  float missionS;
+  double xtrackSq;
+  float xtrackMax;
+  uint32_t xtrackN;
+  bool depthReached;
+  double depthSq;
+  float depthMax;
+  uint32_t depthN;
+  double rateSq;
+  uint32_t rateN;
+  float tiltMax;
+};
+
+static Metrics metrics;
+
+// Distance from the planned polyline (origin, then each item): the truth
+// the nav code never sees, so noise and its own estimate cannot hide it
+static float pathError(float north, float east) {
+  float best = INFINITY;
+  for (uint8_t i = 0; i + 1 < legCount; i++) {
+    float ax = legs[i].north, ay = legs[i].east;
+    float dx = legs[i + 1].north - ax, dy = legs[i + 1].east - ay;
+    float len2 = dx * dx + dy * dy;
+    float t = len2 > 0.0f ? ((north - ax) * dx + (east - ay) * dy) / len2 : 0.0f;
+    t = t < 0.0f ? 0.0f : t > 1.0f ? 1.0f : t;
+    float ex = north - (ax + t * dx), ey = east - (ay + t * dy);
+    float d = sqrtf(ex * ex + ey * ey);
+    if (d < best)
+      best = d;
+  }
+  return best;
+}
+
+static void sampleMetrics(const NAPacket &cmd) {
+  const SimState &s = sim.state;
+  if (metrics.started && !metrics.complete && legCount > 1) {
+    float e = pathError(s.north, s.east);
+    metrics.xtrackSq += (double)e * e;
+    metrics.xtrackN++;
+    if (e > metrics.xtrackMax)
+      metrics.xtrackMax = e;
+  }
+  if (targetDepth >= 0.0f) {
+    float e = fabsf(s.down - targetDepth);
+    if (!metrics.depthReached && s.down >= targetDepth * 0.9f)
+      metrics.depthReached = true; // Hold quality, not the descent
+    if (metrics.depthReached) {
+      metrics.depthSq += (double)e * e;
+      metrics.depthN++;
+      if (e > metrics.depthMax)
+        metrics.depthMax = e;
+    }
+  }
+  if (vehicleType == VEHICLE_COPTER && s.timeS > SITL_SETTLE_S && s.down < -0.05f) {
+    // Stick command against the body rate it asked for (FRD)
+    float want[3] = {cmd.roll / 1000.0f * COPTER_MAX_RATE_RP_DPS * DEG_TO_RAD,
+                     cmd.pitch / 1000.0f * COPTER_MAX_RATE_RP_DPS * DEG_TO_RAD,
+                     cmd.yaw / 1000.0f * COPTER_MAX_RATE_YAW_DPS * DEG_TO_RAD};
+    for (int i = 0; i < 3; i++) {
+      float e = want[i] - s.rates[i];
+      metrics.rateSq += (double)e * e;
+    }
+    metrics.rateN++;
+  }
+  float tilt = fmaxf(fabsf(s.roll), fabsf(s.pitch));
+  if (tilt > metrics.tiltMax)
+    metrics.tiltMax = tilt;
+}
+
+static double hostSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void printSummary(double wallS) {
+  const SimState &s = sim.state;
+  const NavigationState &nav = NavigationManager::getInstance().getState();
+  Serial.printf("{\"sitl\":{\"vehicle\":\"%s\",\"complete\":%s,\"mission_s\":%.2f,"
+                "\"wp\":%u,\"xtrack_rms\":%.3f,\"xtrack_max\":%.3f,"
+                "\"depth_reached\":%s,\"depth_rms\":%.3f,\"depth_max\":%.3f,"
+                "\"rate_rms\":%.4f,"
+                "\"tilt_max_deg\":%.2f,\"north\":%.2f,\"east\":%.2f,\"down\":%.2f,"
+                "\"sim_s\":%.2f,\"wall_ms\":%.1f,\"speedup\":%.0f}}\n",
+                vehicle->getName(), metrics.complete ? "true" : "false",
+                metrics.missionS, (unsigned)nav.currentWaypointIndex,
+                metrics.xtrackN ? sqrt(metrics.xtrackSq / metrics.xtrackN) : 0.0,
+                metrics.xtrackMax, metrics.depthReached ? "true" : "false",
+                metrics.depthN ? sqrt(metrics.depthSq / metrics.depthN) : 0.0,
+                metrics.depthMax,
+                metrics.rateN ? sqrt(metrics.rateSq / metrics.rateN) : 0.0,
+                metrics.tiltMax * RAD_TO_DEG, s.north, s.east, s.down, s.timeS,
+                wallS * 1000.0, wallS > 0.0 ? s.timeS / wallS : 0.0);
+}
+
+// ============================================================================
+// Run
+// ============================================================================
+
+static void currentSticks(float t, NAPacket &cmd) {
+  for (uint8_t i = 0; i < stickCount && sticks[i].t <= t; i++) {
+    cmd.throttle = (uint16_t)sticks[i].throttle;
+    cmd.roll = sticks[i].roll;
+    cmd.pitch = sticks[i].pitch;
+    cmd.yaw = sticks[i].yaw;
+  }
+}
+
+static void run(JsonDocument &doc) {
+  NavigationManager &nav = NavigationManager::getInstance();
+  DepthManager &depth = DepthManager::getInstance();
+  bool hasMission = legCount > 1;
+  bool homed = false;
+
+  const uint32_t controlUs = (uint32_t)(NAV_CONTROL_DT_S * 1e6f);
+  const uint32_t physicsUs = controlUs / SITL_PHYSICS_SUBSTEPS;
+  const uint32_t steps = (uint32_t)(duration * 1e6f / controlUs);
+  uint32_t nextGpsUs = micros();
+  uint32_t nextDepthUs = micros();
+  float out[SIM_MAX_OUTPUTS] = {0};
+  uint8_t outCount = 0;
+  double wallStart = hostSeconds();
+
+  for (uint32_t step = 0; step < steps; step++) {
+    float velD = sim.state.velD;
+    // Physics and sensors across the control period
+    for (int sub = 0; sub < SITL_PHYSICS_SUBSTEPS; sub++) {
+      SimModel_step(&sim, out, outCount, physicsUs * 1e-6f);
+      NativeClock_advanceMicros(physicsUs);
+      uint32_t now = micros();
+      if ((int32_t)(now - nextGpsUs) >= 0) {
+        nextGpsUs += gpsPeriodUs;
+        GPSFix fix;
+        SimModel_gps(&sim, millis(), &fix);
+        nav.setGPSFix(fix);
+      }
+      if (vehicleType == VEHICLE_SUB && (int32_t)(now - nextDepthUs) >= 0) {
+        nextDepthUs += SITL_DEPTH_PERIOD_US;
+        depth.update(); // Sensor task
+      }
+    }
+
+    // Control task
+    NAPacket cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    currentSticks(sim.state.timeS, cmd);
+
+    if (nav.isGPSLocked()) {
+      int32_t lat, lng;
+      nav.getGPSLocationE7(lat, lng);
+      nav.update(lat, lng, nav.getGPSCourse());
+      if (!homed) {
+        float homeLat, homeLng;
+        nav.getGPSLocation(homeLat, homeLng);
+        nav.setHome(homeLat, homeLng);
+        homed = true;
+        if (hasMission) {
+          uploadMission(doc);
+          nav.startMission();
+          metrics.started = true;
+        }
+      }
+    }
+    if (metrics.started && !metrics.complete) {
+      cmd.mode |= MODE_AUTO;
+      int16_t navThrottle = 0, navYaw = 0;
+      if (nav.getNavigationOutput(navThrottle, navYaw)) {
+        cmd.throttle = navThrottle;
+        cmd.roll = navYaw;
+      }
+      if (!nav.getState().isMissionActive) {
+        metrics.complete = true;
+        metrics.missionS = sim.state.timeS;
+      }
+    }
+
+    if (vehicleType == VEHICLE_COPTER) {
+      SimAttitude a;
+      SimModel_attitude(&sim, &a);
+      // AttitudeEstimator convention: MPU axes (y left, z up), yaw CCW
+      VehicleAttitude att = {a.roll, a.pitch, -a.heading,
+                             {a.rates[0], -a.rates[1], -a.rates[2]}, true};
+      vehicle->setAttitude(att);
+    }
+    if (vehicleType == VEHICLE_SUB) {
+      // The tick's mean vertical acceleration, as main.cpp averages the IMU's
+      depth.setVerticalAccel(-(sim.state.velD - velD) / NAV_CONTROL_DT_S);
+    }
+    depth.updateControl(NAV_CONTROL_DT_S);
+    vehicle->setInputs(&cmd);
+    vehicle->loop(NAV_CONTROL_DT_S);
+    outCount = readOutputs(vehicle->getHardware(), out);
+    sampleMetrics(cmd);
+
+    if (metrics.complete && sim.state.timeS >= metrics.missionS + SITL_SETTLE_S)
+      break; // Stopped at the last item: nothing left to measure
+    if (speedup > 0.0f) {
+      double ahead = sim.state.timeS / speedup - (hostSeconds() - wallStart);
+      if (ahead > 0.0) {
+        struct timespec ts = {(time_t)ahead, (long)((ahead - (time_t)ahead) * 1e9)};
+        nanosleep(&ts, NULL);
+      }
+    }
+  }
+  printSummary(hostSeconds() - wallStart);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+  static char text[16384];
+  if (argc < 2 || !readFile(argv[1], text, sizeof(text))) {
+    fprintf(stderr, "usage: %s scenario.json\n", argv[0]);
+    return 2;
+  }
+  JsonDocument doc;
+  if (deserializeJson(doc, text) != DeserializationError::Ok) {
+    Serial.println("{\"error\":\"json\"}");
+    return 2;
+  }
+
+  NativeClock_setMicros(1000000); // millis() == 0 reads as "never" in places
+  if (!loadScenario(doc))
+    return 2;
+
+  vehicle = VehicleRegistry_create(vehicleType);
+  vehicle->setup();
+  NavigationManager::getInstance().init();
+
+  if (vehicleType == VEHICLE_SUB) {
+    depthEmuInit(depthEmu);
+    NativeI2C_attach(MS5837_EMU_ADDR, depthEmuTransfer, &depthEmu);
+    DepthManager &depth = DepthManager::getInstance();
+    depth.begin();
+    if (targetDepth >= 0.0f) {
+      depth.setTargetDepth(targetDepth);
+      depth.setDiving(true);
+    }
+  }
+
+  memset(&metrics, 0, sizeof(metrics));
+  run(doc);
+  return 0;
+}
@@ -1,26 +1,96 @@
 #include "Copter.h"
+#include "Log.h"
 
-Copter::Copter() {
-    for (int i = 0; i < 4; i++) motors[i] = nullptr;
+#if COPTER_DSHOT
+// ESC signal pins FR, FL, BL, BR; the ESCs handle direction and braking
+static const PinMapProfile COPTER_HARDWARE = {4, {
+    {23, -1, -1, 0, 0}, {13, -1, -1, 0, 0}, {18, -1, -1, 0, 0}, {19, -1, -1, 0, 0}}};
+#define COPTER_MOTOR(i) {COPTER_HARDWARE.outputs[i].pin, COPTER_DSHOT_RATE, COPTER_DSHOT_BIDIR != 0}
+#else
+// Standard Quad X FR, FL, BL, BR: PWM pin, direction pins; PWM channel
+// from the HAL registry
+static const PinMapProfile COPTER_HARDWARE = {4, {
+    {23, 32, 33, 0, 0}, {13, 12, 15, 0, 0}, {18, 25, 26, 0, 0}, {19, 27, 14, 0, 0}}};
+#define COPTER_MOTOR(i) CopterMotor(COPTER_HARDWARE.outputs[i])
+#endif
+
+Copter::Copter()
+    : motors{COPTER_MOTOR(0), COPTER_MOTOR(1), COPTER_MOTOR(2), COPTER_MOTOR(3)} {
+    hardware = COPTER_HARDWARE;
     memset(&currentInputs, 0, sizeof(NAPacket));
+    EscTelemetry_init(&escTelemetry, 4);
+    RateController_init(&rateController, COPTER_MAX_RATE_RP_DPS * DEG_TO_RAD,
+                        COPTER_MAX_RATE_YAW_DPS * DEG_TO_RAD);
+    setPIDConfig(ConfigManager::PIDConfig());
+    ThrustCurveConfig curve;
+    ThrustCurve_defaultConfig(&curve);
+    ThrustCurve_init(&thrustCurve, &curve);
 }
 
 void Copter::setup() {
-    // Initialize Motors (Standard Quad X)
-    // Initialize Motors (Standard Quad X) 
-    // Format: Motor(pwmPin, dirPin1, dirPin2, channel)
-    // Using placeholder direction pins (32, 33, 34, 35 for directions)
-    motors[0] = new Motor(16, 32, 33, 0); motors[0]->setup(); // FR
-    motors[1] = new Motor(17, 34, 35, 1); motors[1]->setup(); // FL
-    motors[2] = new Motor(18, 25, 26, 2); motors[2]->setup(); // BL
-    motors[3] = new Motor(19, 27, 14, 3); motors[3]->setup(); // BR
+    if (!loadHardware()) return;
+    for (int i = 0; i < 4; i++) {
+        motors[i].configure(hardware.outputs[i]);
+        motors[i].setup();
+    }
+#if COPTER_ESC_TELEMETRY
+    escSerial.begin(COPTER_ESC_TELEMETRY_BAUD, SERIAL_8N1, COPTER_ESC_TELEMETRY_PIN, -1);
+#endif
 
     Serial.println("Copter initialized - 4x Motors ready");
 }
 
-void Copter::loop() {
-    // Safety timeout check
-    // In real implementation, FailsafeManager handles this
+void Copter::loop(float dt) {
+    collectTelemetry();
+
+    // No IMU: fly the sticks open loop as before
+    if (!currentAttitude.valid) {
+        updateMotors(currentInputs.throttle, currentInputs.roll,
+                     currentInputs.pitch, currentInputs.yaw, dt);
+        return;
+    }
+
+    // Sticks command rate: roll right, nose up, nose right are positive.
+    // MPU axes are x forward, y left, z up, so pitch and yaw flip sign.
+    float command[RATE_AXIS_COUNT] = {currentInputs.roll / 1000.0f,
+                                      currentInputs.pitch / 1000.0f,
+                                      currentInputs.yaw / 1000.0f};
+    float rates[RATE_AXIS_COUNT] = {currentAttitude.rates[0],
+                                    -currentAttitude.rates[1],
+                                    -currentAttitude.rates[2]};
+
+    bool airborne = currentInputs.throttle > COPTER_I_MIN_THROTTLE;
+    RateController_update(&rateController, command, rates, dt, airborne);
+
+    updateMotors(currentInputs.throttle,
+                 (int16_t)(rateController.output[RATE_AXIS_ROLL] * 1000.0f),
+                 (int16_t)(rateController.output[RATE_AXIS_PITCH] * 1000.0f),
+                 (int16_t)(rateController.output[RATE_AXIS_YAW] * 1000.0f), dt);
+}
+
+void Copter::setMotorConfig(const ConfigManager::MotorConfig& motor) {
+#if !COPTER_DSHOT
+    for (int i = 0; i < 4; i++) motors[i].setConfig(motor);
+#endif
+}
+
+void Copter::setThrustCurveConfig(const ThrustCurveConfig& config) {
+    ThrustCurve_setConfig(&thrustCurve, &config);
+}
+
+void Copter::setSupplyVoltage(float cellMv, uint32_t nowMs) {
+    ThrustCurve_updateVoltage(&thrustCurve, cellMv, nowMs);
+}
+
+void Copter::setPIDConfig(const ConfigManager::PIDConfig& pid) {
+    // One PID set from the configurator: roll and pitch share it, yaw
+    // runs PI only (its D term mostly amplifies prop noise)
+    RatePIDGains gains;
+    RatePID_defaultGains(&gains, pid.kp, pid.ki, pid.kd);
+    RateController_setGains(&rateController, RATE_AXIS_ROLL, &gains);
+    RateController_setGains(&rateController, RATE_AXIS_PITCH, &gains);
+    gains.kd = 0.0f;
+    RateController_setGains(&rateController, RATE_AXIS_YAW, &gains);
 }
 
 void Copter::setInputs(NAPacket* packet) {
@@ -34,62 +104,66 @@ void Copter::setInputs(NAPacket* packet) {
     }
 }
 
-void Copter::updateMotors(int16_t throttle, int16_t roll, int16_t pitch, int16_t yaw) {
-    // Scale inputs from -1000..1000 to -100..100
-    throttle /= 10;
-    roll /= 10;
-    pitch /= 10;
-    yaw /= 10;
-    
-    // X-configuration quadcopter mixing:
-    // Motor layout:
-    //    2(BL)   1(FL)
-    //      \    /
-    //       \  /
-    //       /  \
-    //      /    \
-    //    3(BR)   0(FR)
-    
+void Copter::updateMotors(int16_t throttle, int16_t roll, int16_t pitch, int16_t yaw, float dt) {
+    // Inputs -1000..1000, Quad X table (see MotorMixer.h for the layout)
+    float in[MIXER_AXIS_COUNT] = {roll / 1000.0f, pitch / 1000.0f, yaw / 1000.0f,
+                                  throttle / 1000.0f, 0.0f, 0.0f};
+    float thrust[4];
+    mixer.mix(in, thrust);
+
+    // Thrust -> command: undo the prop curve and the pack sag
     int16_t motorOutputs[4];
-    motorOutputs[0] = throttle - roll + pitch - yaw;   // FR
-    motorOutputs[1] = throttle + roll + pitch + yaw;   // FL
-    motorOutputs[2] = throttle + roll - pitch - yaw;   // BL
-    motorOutputs[3] = throttle - roll - pitch + yaw;   // BR
-    
-    mixMotors(motorOutputs);
+    for (int i = 0; i < 4; i++)
+        motorOutputs[i] = (int16_t)lroundf(ThrustCurve_apply(&thrustCurve, thrust[i]) * MIXER_INT_SCALE);
+
+    // Apply to hardware (all four in one pass)
+    CopterMotor* out[4] = {&motors[0], &motors[1], &motors[2], &motors[3]};
+    CopterMotor::setSpeeds(out, motorOutputs, 4, dt);
 }
 
-void Copter::mixMotors(int16_t* motorOutputs) {
-    // Find max output to check for saturation
-    int16_t maxOutput = 0;
-    for (int i = 0; i < 4; i++) {
-        int16_t absVal = motorOutputs[i] < 0 ? -motorOutputs[i] : motorOutputs[i];
-        if (absVal > maxOutput) maxOutput = absVal;
+void Copter::collectTelemetry() {
+#if COPTER_DSHOT
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < 4; i++) {
+        uint32_t count = motors[i].getERPMCount();
+        if (count == erpmCounts[i]) continue;
+        erpmCounts[i] = count;
+        EscSample sample = {};
+        sample.fields = ESC_FIELD_ERPM;
+        sample.erpm = motors[i].getERPM();
+        EscTelemetry_record(&escTelemetry, i, &sample, now);
     }
-    
-    // Normalize if any motor would saturate
-    if (maxOutput > 100) {
-        int16_t scale = (100 * 100) / maxOutput;
-        for (int i = 0; i < 4; i++) {
-            motorOutputs[i] = (motorOutputs[i] * scale) / 100;
-        }
-    }
-    
-    // Apply to hardware
-    for (int i = 0; i < 4; i++) {
-        motors[i]->setSpeed(motorOutputs[i]);
+
+#if COPTER_ESC_TELEMETRY
+    // The reply to last tick's request has long arrived (10 bytes, < 1 ms);
+    // anything else on the wire is dropped with it
+    uint8_t frame[ESC_KISS_FRAME_LEN];
+    size_t len = escSerial.read(frame, sizeof(frame));
+    while (escSerial.available()) escSerial.read();
+    if (kissPending && len == ESC_KISS_FRAME_LEN) {
+        EscSample sample;
+        if (EscTelemetry_parseKiss(frame, &sample))
+            EscTelemetry_record(&escTelemetry, kissMotor, &sample, now);
+        else
+            EscTelemetry_recordError(&escTelemetry, kissMotor);
     }
+    kissMotor = (kissMotor + 1) % 4;
+    motors[kissMotor].requestTelemetry();   // Rides on this tick's frame
+    kissPending = true;
+#endif
+
+    int16_t commanded[4];
+    for (uint8_t i = 0; i < 4; i++) commanded[i] = motors[i].getCurrentSpeed();
+    uint8_t health = EscTelemetry_checkHealth(&escTelemetry, commanded, now);
+    if (health & ~escHealth)
+        LOG_WARN("[ESC] Motor health 0x%02x\n", health);      // Control task: no Serial
+    escHealth = health;
+#endif
 }
 
 void Copter::getMixedOutput(uint8_t *motorPwm, uint8_t motorCount) {
   // Return current motor speeds scaled to 0-255 or 0-100
   for (int i = 0; i < 4 && i < motorCount; i++) {
-    if (motors[i]) {
-      motorPwm[i] = (uint8_t)abs(motors[i]->getCurrentSpeed());
-    } else {
-      motorPwm[i] = 0;
-    }
+    motorPwm[i] = (uint8_t)abs(motors[i].getCurrentSpeed());
   }
 }
-
-String Copter::getName() const { return "COPTER"; }
@@ -3,22 +3,86 @@
 
 #include "Vehicle.h"
 #include "../drivers/Motor.h"
+#include "../drivers/DShot.h"
+#include "../MotorMixer.h"
+#include "../RateController.h"
+#include "../ThrustCurve.h"
 
-class Copter : public Vehicle {
+// Full-stick body rates for the rate controller
+#define COPTER_MAX_RATE_RP_DPS  360.0f
+#define COPTER_MAX_RATE_YAW_DPS 180.0f
+#define COPTER_I_MIN_THROTTLE   100     // Integrators hold below this (on the ground)
+
+// Motor output: 0 = brushed H-bridge PWM (Motor), 1 = brushless ESCs on
+// DShot (DShotESC). Both take speeds through the same setSpeeds() call.
+#ifndef COPTER_DSHOT
+#define COPTER_DSHOT 0
+#endif
+#ifndef COPTER_DSHOT_RATE
+#define COPTER_DSHOT_RATE DSHOT300
+#endif
+#ifndef COPTER_DSHOT_BIDIR
+#define COPTER_DSHOT_BIDIR 0
+#endif
+// KISS / BLHeli32 serial telemetry (DShot only): RX pin of the ESCs'
+// joined telemetry wires on UART1, -1 = not wired. One ESC is asked per
+// control tick, so each reports every fourth tick.
+#ifndef COPTER_ESC_TELEMETRY_PIN
+#define COPTER_ESC_TELEMETRY_PIN -1
+#endif
+#define COPTER_ESC_TELEMETRY_BAUD 115200
+#define COPTER_ESC_TELEMETRY (COPTER_DSHOT && COPTER_ESC_TELEMETRY_PIN >= 0)
+
+#if COPTER_DSHOT
+#include "../drivers/DShotESC.h"    // RMT driver: only when it is used
+typedef DShotESC CopterMotor;
+#else
+typedef Motor CopterMotor;
+#endif
+
+class Copter final : public Vehicle {
 public:
     Copter();
     void setup() override;
-    void loop() override;
+    void loop(float dt) override;
     void setInputs(NAPacket* packet) override;
     void getMixedOutput(uint8_t* motorPwm, uint8_t motorCount) override;
-    String getName() const override;
-    
+    const char* getName() const override { return "COPTER"; }
+    void setAttitude(const VehicleAttitude& attitude) override { currentAttitude = attitude; }
+    void setPIDConfig(const ConfigManager::PIDConfig& pid) override;
+    void setMotorConfig(const ConfigManager::MotorConfig& motor) override;
+#if !COPTER_DSHOT
+    uint8_t getMotorCount() const override { return 4; }
+    Motor* getMotor(uint8_t index) override { return index < 4 ? &motors[index] : nullptr; }
+#endif
+    void setThrustCurveConfig(const ThrustCurveConfig& config) override;
+    void setSupplyVoltage(float cellMv, uint32_t nowMs) override;
+    const ThrustCurve* getThrustCurve() const override { return &thrustCurve; }
+    const EscTelemetry* getEscTelemetry() const override {
+        return (COPTER_DSHOT_BIDIR || COPTER_ESC_TELEMETRY) ? &escTelemetry : nullptr;
+    }
+
 private:
-    Motor* motors[4];  // FR, FL, BL, BR
+    CopterMotor motors[4];   // FR, FL, BL, BR
     NAPacket currentInputs;
-    
-    void updateMotors(int16_t throttle, int16_t roll, int16_t pitch, int16_t yaw);
-    void mixMotors(int16_t* motorOutputs);
+    VehicleAttitude currentAttitude = {};
+    RateController rateController;
+    MotorMixer<MixerFrameQuadX> mixer{COPTER_DSHOT ? 0.0f : -1.0f, 1.0f};
+    ThrustCurve thrustCurve;     // Mixer thrust -> motor command
+    EscTelemetry escTelemetry;
+    uint8_t escHealth = ESC_HEALTH_OK;
+#if COPTER_DSHOT
+    uint32_t erpmCounts[4] = {};
+#endif
+#if COPTER_ESC_TELEMETRY
+    HardwareSerial escSerial{1};
+    uint8_t kissMotor = 0;
+    bool kissPending = false;
+#endif
+
+    // Take in ESC replies, ask the next ESC, check motor health
+    void collectTelemetry();
+    void updateMotors(int16_t throttle, int16_t roll, int16_t pitch, int16_t yaw, float dt);
 };
 
 #endif
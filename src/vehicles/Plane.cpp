@@ -1,27 +1,96 @@
 #include "Plane.h"
+#include "../IMUManager.h"
 
-Plane::Plane() : motor(nullptr), ailerons(nullptr), elevator(nullptr) {
+// Throttle motor GPIO 27 (14/12 DIR), aileron servo GPIO 18, elevator servo GPIO 23
+static const PinMapProfile PLANE_HARDWARE = {3, {
+    {27, 14, 12, 0, 0},
+    {18, -1, -1, 0, PLANE_SERVO_FREQUENCY_HZ},
+    {23, -1, -1, 0, PLANE_SERVO_FREQUENCY_HZ}}};
+
+Plane::Plane()
+    : motor(PLANE_HARDWARE.outputs[0]),
+      ailerons(PLANE_HARDWARE.outputs[1].pin, 90, PLANE_SERVO_FREQUENCY_HZ),
+      elevator(PLANE_HARDWARE.outputs[2].pin, 90, PLANE_SERVO_FREQUENCY_HZ),
+      rudder(PLANE_RUDDER_PIN, 90, PLANE_SERVO_FREQUENCY_HZ) {
+    hardware = PLANE_HARDWARE;
     memset(&currentInputs, 0, sizeof(NAPacket));
+    FbwConfig config;
+    FlyByWire_defaultConfig(&config);
+    FlyByWire_init(&fbw, &config);
 }
 
 void Plane::setup() {
-    // Motor for throttle (GPIO 27, Channel 6)
-    motor = new Motor(27, 14, 12, 6);
-    motor->setup();
+    if (!loadHardware()) return;
+    motor.configure(hardware.outputs[0]);
+    ailerons.configure(hardware.outputs[1]);
+    elevator.configure(hardware.outputs[2]);
+
+    motor.setup();
     
     // Servo for ailerons (left/right wing)
-    ailerons = new ServoDriver(22);
-    ailerons->setup();
+    ailerons.setPulseRange(PLANE_SERVO_MIN_US, PLANE_SERVO_MAX_US);
+    ailerons.setup();
     
     // Servo for elevator (pitch control)
-    elevator = new ServoDriver(23);
-    elevator->setup();
+    elevator.setPulseRange(PLANE_SERVO_MIN_US, PLANE_SERVO_MAX_US);
+    elevator.setup();
+
+    // Outside the profile: only claim a pin that is free to drive
+    if (PLANE_RUDDER_PIN >= 0) {
+        if (PinMap_isOutput(PLANE_RUDDER_PIN) && !PinMap_reservedBy(PLANE_RUDDER_PIN)) {
+            rudder.setPulseRange(PLANE_SERVO_MIN_US, PLANE_SERVO_MAX_US);
+            rudderFitted = rudder.setup();
+        } else {
+            Serial.printf("[HW] PLANE rudder GPIO %d not usable - no rudder\n", PLANE_RUDDER_PIN);
+        }
+    }
     
-    Serial.println("Plane initialized - Motor + 2x Servos ready");
+    Serial.printf("Plane initialized - Motor + %dx Servos ready\n", rudderFitted ? 3 : 2);
 }
 
-void Plane::loop() {
-    updateControls(currentInputs.throttle, currentInputs.roll, currentInputs.pitch);
+void Plane::loop(float dt) {
+    // FBW off or no IMU: sticks straight to the surfaces
+    if (!fbw.config.enabled || !currentAttitude.valid) {
+        updateControls(currentInputs.throttle, currentInputs.roll, currentInputs.pitch, dt);
+        if (rudderFitted) rudder.writeNormalized(currentInputs.yaw / 1000.0f);
+        return;
+    }
+
+    // Sticks (or the nav steering on roll) command bank and pitch.
+    // Estimator pitch is about y (left), + = nose down.
+    FlyByWire_updateAngle(&fbw, currentInputs.roll / 1000.0f, currentInputs.pitch / 1000.0f,
+                          currentAttitude.roll, -currentAttitude.pitch, 0.0f);
+    float surfaces[FBW_SURFACE_COUNT];
+    FlyByWire_output(&fbw, currentInputs.yaw / 1000.0f, dt, surfaces);
+
+    motor.setSpeed(currentInputs.throttle / 10, dt);
+    ailerons.writeNormalized(surfaces[FBW_SURFACE_AILERON]);
+    elevator.writeNormalized(surfaces[FBW_SURFACE_ELEVATOR]);
+    if (rudderFitted) rudder.writeNormalized(surfaces[FBW_SURFACE_RUDDER]);
+}
+
+void Plane::setAttitude(const VehicleAttitude& attitude) {
+    currentAttitude = attitude;
+    if (!fbw.config.enabled || !attitude.valid) return;
+
+    // Rate loop on every gyro sample (1 kHz); the angle loop and the
+    // servos run at the control rate. MPU y points left: pitch up = -y.
+    float rates[FBW_AXIS_COUNT] = {attitude.rates[0], -attitude.rates[1]};
+    bool airborne = currentInputs.throttle > PLANE_I_MIN_THROTTLE;
+    FlyByWire_updateRate(&fbw, rates, IMU_SAMPLE_PERIOD_US * 1e-6f, airborne);
+}
+
+void Plane::setFlyByWireConfig(const FbwConfig& config) {
+    if (config.enabled && !fbw.config.enabled) {
+        // Engaging: start from level surfaces, no stale integrators
+        FlyByWire_init(&fbw, &config);
+    } else {
+        FlyByWire_setConfig(&fbw, &config);
+    }
+}
+
+void Plane::setMotorConfig(const ConfigManager::MotorConfig& config) {
+    motor.setConfig(config);
 }
 
 void Plane::setInputs(NAPacket* packet) {
@@ -29,33 +98,24 @@ void Plane::setInputs(NAPacket* packet) {
         currentInputs.throttle = packet->throttle;
         currentInputs.roll = packet->roll;
         currentInputs.pitch = packet->pitch;
+        currentInputs.yaw = packet->yaw;
     }
 }
 
-void Plane::updateControls(int16_t throttle, int16_t roll, int16_t pitch) {
-    // Scale inputs
-    throttle /= 10;  // -100 to 100
-    roll /= 10;      // -100 to 100
-    pitch /= 10;     // -100 to 100
-    
-    // Throttle directly to motor
-    motor->setSpeed(throttle);
+void Plane::updateControls(int16_t throttle, int16_t roll, int16_t pitch, float dt) {
+    // Throttle directly to motor (-100 to 100)
+    motor.setSpeed(throttle / 10, dt);
     
+    // Surfaces keep the full -1000..1000 input resolution:
+    // 1000-2000 us, 1 input step = 0.5 us (~1.6 duty counts at 50 Hz)
     // Aileron mixing: differential control of left/right wings
-    // Center is 90°, deflection ±45° = ±2000 microseconds
-    int16_t aileronAngle = 90 + (roll / 2);  // -50 to +50 range
-    aileronAngle = constrain(aileronAngle, 45, 135);
-    ailerons->write(aileronAngle);
+    ailerons.writeNormalized(roll / 1000.0f);
     
     // Elevator for pitch control
-    int16_t elevatorAngle = 90 + (pitch / 2);  // -50 to +50 range
-    elevatorAngle = constrain(elevatorAngle, 45, 135);
-    elevator->write(elevatorAngle);
+    elevator.writeNormalized(pitch / 1000.0f);
 }
 
 void Plane::getMixedOutput(uint8_t *motorPwm, uint8_t motorCount) {
-  if (motorCount >= 1 && motor) motorPwm[0] = (uint8_t)abs(motor->getCurrentSpeed());
+  if (motorCount >= 1) motorPwm[0] = (uint8_t)abs(motor.getCurrentSpeed());
   // Servos are not technically "motors" in the same sense but could be added here
 }
-
-String Plane::getName() const { return "PLANE"; }
@@ -4,23 +4,47 @@
 #include "Vehicle.h"
 #include "../drivers/Motor.h"
 #include "../drivers/ServoDriver.h"
+#include "../FlyByWire.h"
 
-class Plane : public Vehicle {
+// Control surface servos: 50 Hz suits any servo, digital servos take up to 333
+#ifndef PLANE_SERVO_FREQUENCY_HZ
+#define PLANE_SERVO_FREQUENCY_HZ 50
+#endif
+#define PLANE_SERVO_MIN_US 1000     // Full surface travel
+#define PLANE_SERVO_MAX_US 2000
+// Rudder servo, -1 = none (the default airframe steers with ailerons);
+// takes the pilot's yaw plus the fly-by-wire turn coordination
+#ifndef PLANE_RUDDER_PIN
+#define PLANE_RUDDER_PIN -1
+#endif
+#define PLANE_I_MIN_THROTTLE 100    // Integrators hold below this (on the ground)
+
+class Plane final : public Vehicle {
 public:
     Plane();
     void setup() override;
-    void loop() override;
+    void loop(float dt) override;
     void setInputs(NAPacket* packet) override;
     void getMixedOutput(uint8_t* motorPwm, uint8_t motorCount) override;
-    String getName() const override;
+    void setMotorConfig(const ConfigManager::MotorConfig& motor) override;
+    uint8_t getMotorCount() const override { return 1; }
+    Motor* getMotor(uint8_t index) override { return index == 0 ? &motor : nullptr; }
+    const char* getName() const override { return "PLANE"; }
+    FailsafePolicy getFailsafePolicy() const override { return {FAILSAFE_ACTION_RTL, FAILSAFE_ACTION_RTL}; }
+    void setAttitude(const VehicleAttitude& attitude) override;
+    void setFlyByWireConfig(const FbwConfig& config) override;
     
 private:
-    Motor* motor;           // Throttle motor
-    ServoDriver* ailerons;  // Left/Right wing control
-    ServoDriver* elevator;  // Pitch control
+    Motor motor;            // Throttle motor
+    ServoDriver ailerons;   // Left/Right wing control
+    ServoDriver elevator;   // Pitch control
+    ServoDriver rudder;     // Optional (PLANE_RUDDER_PIN)
+    bool rudderFitted = false;
     NAPacket currentInputs;
+    VehicleAttitude currentAttitude = {};
+    FlyByWire fbw;
     
-    void updateControls(int16_t throttle, int16_t roll, int16_t pitch);
+    void updateControls(int16_t throttle, int16_t roll, int16_t pitch, float dt);
 };
 
 #endif
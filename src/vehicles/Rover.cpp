@@ -1,24 +1,87 @@
 #include "Rover.h"
+#include "../HAL.h"
 
-Rover::Rover() : motorLeft(nullptr), motorRight(nullptr) {
+// Left motor GPIO 26 PWM, 27/14 DIR; right motor GPIO 25 PWM, 13/12 DIR
+static const PinMapProfile ROVER_HARDWARE = {2, {{26, 27, 14, 0, 0}, {25, 13, 12, 0, 0}}};
+
+Rover::Rover() : motorLeft(ROVER_HARDWARE.outputs[0]), motorRight(ROVER_HARDWARE.outputs[1]) {
+    hardware = ROVER_HARDWARE;
     memset(&currentInputs, 0, sizeof(NAPacket));
+    OdometryConfig config;
+    WheelOdometry_defaultConfig(&config);
+    WheelOdometry_init(&odometry, &config);
 }
 
 void Rover::setup() {
-    // Initialize left motor (GPIO 26 PWM, 27/14 DIR, Channel 0)
-    motorLeft = new Motor(26, 27, 14, 0);
-    motorLeft->setup();
-    
-    // Initialize right motor (GPIO 25 PWM, 13/12 DIR, Channel 1)
-    motorRight = new Motor(25, 13, 12, 1);
-    motorRight->setup();
+    if (!loadHardware()) return;
+    motorLeft.configure(hardware.outputs[0]);
+    motorRight.configure(hardware.outputs[1]);
+
+    motorLeft.setup();
+    motorRight.setup();
+    encodersFitted = attachEncoders();
     
-    Serial.println("Rover initialized - 2x Motors ready");
+    Serial.printf("Rover initialized - 2x Motors ready%s\n",
+                  encodersFitted ? ", wheel encoders" : "");
+}
+
+bool Rover::attachEncoders() {
+    const int pins[ODOM_WHEELS][2] = {{ROVER_ENCODER_LEFT_A, ROVER_ENCODER_LEFT_B},
+                                      {ROVER_ENCODER_RIGHT_A, ROVER_ENCODER_RIGHT_B}};
+    for (int w = 0; w < ODOM_WHEELS; w++) {
+        for (int p = 0; p < 2; p++) {
+            int pin = pins[w][p];
+            if (pin < 0) return false;
+            // Outside the profile: the board's and the motors' pins are taken
+            bool taken = PinMap_reservedBy(pin) != nullptr;
+            for (uint8_t i = 0; i < hardware.count; i++) {
+                const PinMapOutput& out = hardware.outputs[i];
+                taken |= pin == out.pin || pin == out.dir1 || pin == out.dir2;
+            }
+            if (taken) {
+                Serial.printf("[HW] ROVER encoder GPIO %d not usable - open loop\n", pin);
+                return false;
+            }
+        }
+    }
+    for (int w = 0; w < ODOM_WHEELS; w++) {
+        encoders[w] = HAL_EncoderAttach(pins[w][0], pins[w][1], ROVER_ENCODER_FILTER_NS);
+        if (encoders[w] < 0) {
+            Serial.println("[HW] ROVER no pulse counter left - open loop");
+            return false;
+        }
+    }
+    return true;
 }
 
-void Rover::loop() {
+void Rover::loop(float dt) {
+    if (encodersFitted) {
+        int32_t counts[ODOM_WHEELS];
+        for (int w = 0; w < ODOM_WHEELS; w++) counts[w] = HAL_EncoderRead(encoders[w]);
+        WheelOdometry_update(&odometry, counts, dt);
+    }
     // Apply current inputs to motors (with failsafe/deadband/ramping)
-    drive(currentInputs.throttle, currentInputs.roll);
+    drive(currentInputs.throttle, currentInputs.roll, dt);
+}
+
+void Rover::setMotorConfig(const ConfigManager::MotorConfig& motor) {
+    motorLeft.setConfig(motor);
+    motorRight.setConfig(motor);
+}
+
+Motor* Rover::getMotor(uint8_t index) {
+    return index == 0 ? &motorLeft : index == 1 ? &motorRight : nullptr;
+}
+
+bool Rover::readMotorCounts(uint8_t index, int32_t& counts) {
+    // Wheels are in output order: left, right
+    if (!encodersFitted || index >= ODOM_WHEELS) return false;
+    counts = HAL_EncoderRead(encoders[index]);
+    return true;
+}
+
+void Rover::setOdometryConfig(const OdometryConfig& config) {
+    WheelOdometry_setConfig(&odometry, &config);
 }
 
 void Rover::setInputs(NAPacket* packet) {
@@ -28,26 +91,31 @@ void Rover::setInputs(NAPacket* packet) {
     }
 }
 
-void Rover::drive(int16_t throttle, int16_t steering) {
+void Rover::drive(int16_t throttle, int16_t steering, float dt) {
     // Differential drive kinematics (skid-steer)
     // throttle: -1000 to +1000 (forward/backward)
     // steering: -1000 to +1000 (left/right turn)
-    
-    int16_t leftSpeed = throttle + steering;    // Add steering to left
-    int16_t rightSpeed = throttle - steering;   // Subtract steering from right
-    
-    // Constrain to motor range
-    leftSpeed = constrain(leftSpeed, -1000, 1000);
-    rightSpeed = constrain(rightSpeed, -1000, 1000);
-    
-    // Scale to motor range (-100 to 100)
-    motorLeft->setSpeed(leftSpeed / 10);
-    motorRight->setSpeed(rightSpeed / 10);
+    // At the limits the mixer gives up throttle, never steering
+    float in[MIXER_AXIS_COUNT] = {0.0f, 0.0f, steering / 1000.0f,
+                                  0.0f, throttle / 1000.0f, 0.0f};
+    int16_t speeds[2];
+    mixer.mix(in, speeds);
+
+    // With encoders the mix is a wheel speed target (full = maxSpeed)
+    // and the speed loop finds the PWM
+    if (encodersFitted) {
+        float target[ODOM_WHEELS], out[ODOM_WHEELS];
+        for (int w = 0; w < ODOM_WHEELS; w++)
+            target[w] = speeds[w] / 100.0f * odometry.config.maxSpeedMps;
+        WheelOdometry_control(&odometry, target, dt, out);
+        for (int w = 0; w < ODOM_WHEELS; w++) speeds[w] = (int16_t)lroundf(out[w] * 100.0f);
+    }
+
+    Motor* motors[2] = {&motorLeft, &motorRight};
+    Motor::setSpeeds(motors, speeds, 2, dt);
 }
 
 void Rover::getMixedOutput(uint8_t *motorPwm, uint8_t motorCount) {
-  if (motorCount >= 1 && motorLeft) motorPwm[0] = (uint8_t)abs(motorLeft->getCurrentSpeed());
-  if (motorCount >= 2 && motorRight) motorPwm[1] = (uint8_t)abs(motorRight->getCurrentSpeed());
+  if (motorCount >= 1) motorPwm[0] = (uint8_t)abs(motorLeft.getCurrentSpeed());
+  if (motorCount >= 2) motorPwm[1] = (uint8_t)abs(motorRight.getCurrentSpeed());
 }
-
-String Rover::getName() const { return "ROVER"; }
@@ -3,22 +3,52 @@
 
 #include "Vehicle.h"
 #include "../drivers/Motor.h"
+#include "../MotorMixer.h"
+#include "../WheelOdometry.h"
 
-class Rover : public Vehicle {
+// Quadrature wheel encoders (PCNT), -1 = none: all four pins or the
+// Rover stays open loop. Swap A / B if a wheel counts backwards.
+#ifndef ROVER_ENCODER_LEFT_A
+#define ROVER_ENCODER_LEFT_A -1
+#endif
+#ifndef ROVER_ENCODER_LEFT_B
+#define ROVER_ENCODER_LEFT_B -1
+#endif
+#ifndef ROVER_ENCODER_RIGHT_A
+#define ROVER_ENCODER_RIGHT_A -1
+#endif
+#ifndef ROVER_ENCODER_RIGHT_B
+#define ROVER_ENCODER_RIGHT_B -1
+#endif
+#define ROVER_ENCODER_FILTER_NS 1000    // Ignore edges shorter than 1 us
+
+class Rover final : public Vehicle {
 public:
     Rover();
     void setup() override;
-    void loop() override;
+    void loop(float dt) override;
     void setInputs(NAPacket* packet) override;
     void getMixedOutput(uint8_t* motorPwm, uint8_t motorCount) override;
-    String getName() const override;
-    
+    void setMotorConfig(const ConfigManager::MotorConfig& motor) override;
+    uint8_t getMotorCount() const override { return 2; }
+    Motor* getMotor(uint8_t index) override;
+    bool readMotorCounts(uint8_t index, int32_t& counts) override;
+    void setOdometryConfig(const OdometryConfig& config) override;
+    const char* getName() const override { return "ROVER"; }
+    FailsafePolicy getFailsafePolicy() const override { return {FAILSAFE_ACTION_NEUTRAL, FAILSAFE_ACTION_RTL}; }
+    const WheelOdometry* getOdometry() const override { return encodersFitted ? &odometry : nullptr; }
+
 private:
-    Motor* motorLeft;
-    Motor* motorRight;
+    Motor motorLeft;
+    Motor motorRight;
     NAPacket currentInputs;
-    
-    void drive(int16_t throttle, int16_t steering);
+    MotorMixer<MixerFrameRover, int16_t> mixer;
+    WheelOdometry odometry;
+    int encoders[ODOM_WHEELS] = {-1, -1};   // HAL encoder per wheel
+    bool encodersFitted = false;
+
+    bool attachEncoders();
+    void drive(int16_t throttle, int16_t steering, float dt);
 };
 
 #endif
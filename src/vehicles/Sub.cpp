@@ -1,33 +1,98 @@
 #include "Sub.h"
 #include "DepthManager.h"
+#include "HotPath.h"
+#include "Log.h"
 
-Sub::Sub() : forwardMotor(nullptr), yawMotor(nullptr), verticalMotor(nullptr), trimBallast(nullptr) {
+// Forward, yaw (steering) and vertical (depth) thrusters, trim ballast servo.
+// Layouts with more thrusters keep these pins for the first three; the
+// rest start not fitted (set_hw) and the servo stays the last output.
+static const PinMapProfile SUB_HARDWARE = {4, {
+    {27, 14, 12, 0, 0},
+    {26, 13, 32, 0, 0},
+    {25, 33, 18, 0, 0},
+    {23, -1, -1, 0, 0}}};
+
+Sub::Sub() : trimBallast(SUB_HARDWARE.outputs[3].pin) {
+    hardware = SUB_HARDWARE;
+    for (uint8_t i = 0; i < 3; i++) thrusters[i].configure(SUB_HARDWARE.outputs[i]);
     memset(&currentInputs, 0, sizeof(NAPacket));
+    memset(ascent, 0, sizeof(ascent));
+    ThrustConfig config;
+    ThrustAllocator_defaultConfig(&config);
+    ThrustAllocator_init(&allocator, &config);
+    LeakDetector_init(&leak, onLeak, this);
+}
+
+void Sub::loadThrusters() {
+    ThrustConfig config;
+    bool saved = ConfigManager::loadBlob(THRUST_CONFIG_KEY, &config, sizeof(config)) == sizeof(config) &&
+                 ThrustAllocator_sanitize(&config) && ThrustAllocator_init(&allocator, &config);
+    if (!saved) {
+        ThrustAllocator_defaultConfig(&config);
+        ThrustAllocator_init(&allocator, &config);
+    }
+
+    uint8_t n = allocator.count;
+    hardware.count = n + 1;
+    for (uint8_t i = 0; i < n; i++) {
+        hardware.outputs[i] = i < 3 ? SUB_HARDWARE.outputs[i] : PinMapOutput{-1, -1, -1, 0, 0};
+    }
+    hardware.outputs[n] = SUB_HARDWARE.outputs[3];
+
+    // Leak ascent: the allocator's answer to full heave, nothing else
+    float in[MIXER_AXIS_COUNT] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+    float out[THRUST_MAX_THRUSTERS];
+    ThrustAllocator_allocate(&allocator, in, out);
+    for (uint8_t i = 0; i < n; i++) ascent[i] = MixerOutput<int16_t>::convert(out[i]);
 }
 
 void Sub::setup() {
-    // Forward thruster
-    forwardMotor = new Motor(27, 14, 12, 6);
-    forwardMotor->setup();
-    
-    // Yaw thruster (steering)
-    yawMotor = new Motor(26, 13, 11, 7);
-    yawMotor->setup();
-    
-    // Vertical thruster (depth control)
-    verticalMotor = new Motor(25, 10, 9, 8);
-    verticalMotor->setup();
-    
-    // Trim ballast servo
-    trimBallast = new ServoDriver(23);
-    trimBallast->setup();
+    loadThrusters();
+    if (!loadHardware()) return;
+    uint8_t n = allocator.count;
+    for (uint8_t i = 0; i < n; i++) {
+        thrusters[i].configure(hardware.outputs[i]);
+        thrusters[i].setup();
+    }
+    trimBallast.configure(hardware.outputs[n]);
+    trimBallast.setup();
+
+    // After the thrusters: the handler may run as soon as this returns
+    bool leakSensor = LeakDetector_start(&leak, SUB_LEAK_PIN, SUB_LEAK_ACTIVE_HIGH);
     
-    Serial.println("Sub initialized - 3x Thrusters + Trim ready");
+    Serial.printf("Sub initialized - %ux Thrusters (%u axes) + Trim ready (leak sensor: %s)\n",
+                  n, allocator.rank, leakSensor ? "on" : "off");
+    if (!(allocator.axisMask & (1 << MIXER_THRUST)))
+        LOG_WARN("[Sub] Thruster layout cannot heave: no depth control or leak ascent\n");
 }
 
-void Sub::loop() {
+void Sub::loop(float dt) {
+    if (LeakDetector_isLatched(&leak)) {
+        // Keep the timer's ascent; the pilot and depth hold are out
+        surfaceNow();
+        if (!leakReported) {
+            leakReported = true;
+            LOG_WARN("[Sub] LEAK: surfacing (%lu us edge to thrust, %lu bounces)\n",
+                     (unsigned long)leak.reactionUs, (unsigned long)leak.rejected);
+        }
+        return;
+    }
     updateThrusters(currentInputs.throttle, currentInputs.roll, 
-                   currentInputs.pitch, currentInputs.yaw);
+                   currentInputs.pitch, currentInputs.yaw, dt);
+}
+
+HOT_IRAM void Sub::surfaceNow() {
+    MotorBatch batch;
+    for (uint8_t i = 0; i < allocator.count; i++) thrusters[i].prepareNow(ascent[i], batch);
+    batch.commit();
+}
+
+HOT_IRAM void Sub::onLeak(void* arg) {
+    ((Sub*)arg)->surfaceNow();
+}
+
+void Sub::setMotorConfig(const ConfigManager::MotorConfig& motor) {
+    for (uint8_t i = 0; i < THRUST_MAX_THRUSTERS; i++) thrusters[i].setConfig(motor);
 }
 
 void Sub::setInputs(NAPacket* packet) {
@@ -39,36 +104,41 @@ void Sub::setInputs(NAPacket* packet) {
     }
 }
 
-void Sub::updateThrusters(int16_t throttle, int16_t steering, int16_t depth, int16_t yaw) {
-    // Scale inputs
-    throttle /= 10;
-    steering /= 10;
-    depth /= 10;
-    yaw /= 10;
-    
-    // Apply to thrusters
-    forwardMotor->setSpeed(throttle);
-    yawMotor->setSpeed(steering);
-    
+void Sub::updateThrusters(int16_t throttle, int16_t steering, int16_t depth, int16_t yaw,
+                          float dt) {
     // Depth Control: Manual vs Auto
+    float vertical = depth / 1000.0f;
     if (DepthManager::getInstance().isDiving()) {
-        // Map -1.0..1.0 from PDF to -100..100 for motor
-        float depthOutput = DepthManager::getInstance().getVerticalOutput() * 100.0f;
-        verticalMotor->setSpeed((int16_t)depthOutput);
-    } else {
-        verticalMotor->setSpeed(depth);
+        // -1.0..1.0 from the depth PID
+        vertical = DepthManager::getInstance().getVerticalOutput();
+    }
+
+    float in[MIXER_AXIS_COUNT] = {0.0f, 0.0f, steering / 1000.0f,
+                                  vertical, throttle / 1000.0f, 0.0f};
+    float out[THRUST_MAX_THRUSTERS];
+    ThrustAllocator_allocate(&allocator, in, out);
+
+    // Apply to thrusters
+    int16_t thrust[THRUST_MAX_THRUSTERS];
+    Motor* motors[THRUST_MAX_THRUSTERS];
+    for (uint8_t i = 0; i < allocator.count; i++) {
+        thrust[i] = MixerOutput<int16_t>::convert(out[i]);
+        motors[i] = &thrusters[i];
     }
+    Motor::setSpeeds(motors, thrust, allocator.count, dt);
     
     // Trim ballast (0-180 degrees, 90 = neutral)
-    int16_t trimAngle = 90 + (yaw / 2);
+    int16_t trimAngle = 90 + (yaw / 20);
     trimAngle = constrain(trimAngle, 45, 135);
-    trimBallast->write(trimAngle);
+    trimBallast.write(trimAngle);
 }
 
 void Sub::getMixedOutput(uint8_t *motorPwm, uint8_t motorCount) {
-  if (motorCount >= 1 && forwardMotor) motorPwm[0] = (uint8_t)abs(forwardMotor->getCurrentSpeed());
-  if (motorCount >= 2 && yawMotor) motorPwm[1] = (uint8_t)abs(yawMotor->getCurrentSpeed());
-  if (motorCount >= 3 && verticalMotor) motorPwm[2] = (uint8_t)abs(verticalMotor->getCurrentSpeed());
+  for (uint8_t i = 0; i < allocator.count && i < motorCount; i++)
+    motorPwm[i] = (uint8_t)abs(thrusters[i].getCurrentSpeed());
 }
 
-String Sub::getName() const { return "SUB"; }
+bool Sub::checkCriticalFault() {
+    // Water ingress / depth fault: surface whatever the link says
+    return LeakDetector_isLatched(&leak) || DepthManager::getInstance().checkFailsafe();
+}
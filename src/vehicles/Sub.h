@@ -4,24 +4,61 @@
 #include "Vehicle.h"
 #include "../drivers/Motor.h"
 #include "../drivers/ServoDriver.h"
+#include "../ThrustAllocator.h"
+#include "../LeakDetector.h"
 
-class Sub : public Vehicle {
+// Leak sensor input (e.g. Blue Robotics SOS probes), -1 = not fitted.
+// A leak latches an emergency ascent straight from the debounce timer.
+#ifndef SUB_LEAK_PIN
+#define SUB_LEAK_PIN -1
+#endif
+#ifndef SUB_LEAK_ACTIVE_HIGH
+#define SUB_LEAK_ACTIVE_HIGH 1
+#endif
+
+class Sub final : public Vehicle {
 public:
     Sub();
     void setup() override;
-    void loop() override;
+    void loop(float dt) override;
     void setInputs(NAPacket* packet) override;
     void getMixedOutput(uint8_t* motorPwm, uint8_t motorCount) override;
-    String getName() const override;
+    void setMotorConfig(const ConfigManager::MotorConfig& motor) override;
+    uint8_t getMotorCount() const override { return allocator.count; }
+    Motor* getMotor(uint8_t index) override { return index < allocator.count ? &thrusters[index] : nullptr; }
+    const char* getName() const override { return "SUB"; }
+    FailsafePolicy getFailsafePolicy() const override { return {FAILSAFE_ACTION_NEUTRAL, FAILSAFE_ACTION_SURFACE}; }
+    bool checkCriticalFault() override;
+
+    const LeakDetector& getLeakDetector() const { return leak; }
+    const ThrustAllocator& getAllocator() const { return allocator; }
     
 private:
-    Motor* forwardMotor;
-    Motor* yawMotor;
-    Motor* verticalMotor;
-    ServoDriver* trimBallast;
+    // Outputs 0..n-1 are the thrusters of the geometry table, output n
+    // the trim ballast servo
+    Motor thrusters[THRUST_MAX_THRUSTERS];
+    ServoDriver trimBallast;
     NAPacket currentInputs;
+    ThrustAllocator allocator;
+    int16_t ascent[THRUST_MAX_THRUSTERS];      // Full heave, precomputed for the leak timer
+    LeakDetector leak;
+    bool leakReported = false;
+
+    /**
+     * Full ascent, horizontal thrusters off, in one commit (leak timer
+     * context; the control loop keeps holding it afterwards)
+     */
+    void surfaceNow();
+    static void onLeak(void* arg);
+
+    /**
+     * Thruster geometry from NVS (THRUST_CONFIG_KEY, default Sub3 hull):
+     * builds the allocator and sizes the hardware profile to match
+     */
+    void loadThrusters();
     
-    void updateThrusters(int16_t throttle, int16_t steering, int16_t depth, int16_t yaw);
+    void updateThrusters(int16_t throttle, int16_t steering, int16_t depth, int16_t yaw,
+                         float dt);
 };
 
 #endif
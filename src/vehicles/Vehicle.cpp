@@ -0,0 +1,25 @@
+#include "Vehicle.h"
+
+bool Vehicle::loadHardware() {
+  PinMapProfile saved;
+  if (ConfigManager::loadHardwareProfile(getName(), saved)) {
+    if (saved.count == hardware.count) {
+      hardware = saved;
+    } else {
+      Serial.printf("[HW] %s: saved profile has %u outputs, expected %u - using defaults\n",
+                    getName(), saved.count, hardware.count);
+    }
+  }
+
+  uint8_t badOutput = 0;
+  int8_t badPin = -1;
+  PinMapError err = PinMap_validate(&hardware, &badOutput, &badPin);
+  if (err != PINMAP_OK) {
+    const char *owner = PinMap_reservedBy(badPin);
+    Serial.printf("[HW] %s output %u GPIO %d: %s%s%s - outputs disabled\n", getName(),
+                  badOutput, badPin, PinMap_errorName(err), owner ? " by " : "",
+                  owner ? owner : "");
+    return false;
+  }
+  return true;
+}
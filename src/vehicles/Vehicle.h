@@ -1,16 +1,91 @@
 #ifndef VEHICLE_H
 #define VEHICLE_H
 
+#include "../ConfigManager.h"
+#include "../EscTelemetry.h"
+#include "../FailsafeManager.h"
+#include "../FlyByWire.h"
+#include "../ThrustCurve.h"
+#include "../WheelOdometry.h"
 #include "NAPacket.h"
 #include <Arduino.h>
 
+class Motor;
+
+/**
+ * Estimated attitude handed to the vehicle each control tick
+ */
+struct VehicleAttitude {
+  float roll;     // rad
+  float pitch;    // rad
+  float yaw;      // rad, counter-clockwise (gyro-only, drifts)
+  float rates[3]; // Body rates x, y, z in rad/s
+  bool valid;     // false until the IMU is running
+};
+
+/**
+ * Vehicle interface
+ *
+ * main.cpp builds exactly one concrete vehicle, without heap: either a
+ * static instance held by its final type (VEHICLE_TYPE_* builds, calls
+ * resolved at compile time) or one picked from config at boot in the
+ * VehicleRegistry slot. Actuators are members of the vehicle; setup()
+ * only claims their pins / channels.
+ *
+ * Pins and PWM settings come from the vehicle's hardware profile: the
+ * constructor fills the defaults, setup() overlays the profile saved in
+ * config (loadHardware) and configures the actuators from it. A profile
+ * that fails validation leaves every output unclaimed.
+ */
 class Vehicle {
 public:
   virtual void setup() = 0;
-  virtual void loop() = 0;
+  // dt = inner loop period in seconds (RateProfile: fixed, not measured);
+  // called every inner tick, setInputs() only on outer ones
+  virtual void loop(float dt) = 0;
   virtual void setInputs(NAPacket *packet) = 0;
   virtual void getMixedOutput(uint8_t *motorPwm, uint8_t motorCount) = 0;
-  virtual String getName() const = 0;
+  virtual const char *getName() const = 0;
+  virtual void setAttitude(const VehicleAttitude &attitude) {}
+  virtual void setPIDConfig(const ConfigManager::PIDConfig &pid) {}
+  // Deadband / ramp / minimum PWM for brushed motors (control task)
+  virtual void setMotorConfig(const ConfigManager::MotorConfig &motor) {}
+  // Brushed motors in output order, for per-motor trims and calibration
+  // (control task); none where the outputs are ESCs or servos
+  virtual uint8_t getMotorCount() const { return 0; }
+  virtual Motor *getMotor(uint8_t index) { return nullptr; }
+  // Encoder count of the wheel a motor drives, false without one
+  virtual bool readMotorCounts(uint8_t index, int32_t &counts) { return false; }
+  // Stabilized-flight tuning for fixed wing (control task)
+  virtual void setFlyByWireConfig(const FbwConfig &config) {}
+  // Wheel encoder odometry / speed control for ground vehicles (control task)
+  virtual void setOdometryConfig(const OdometryConfig &config) {}
+  // Motor thrust linearization / voltage compensation (control task)
+  virtual void setThrustCurveConfig(const ThrustCurveConfig &config) {}
+  // Loaded pack voltage per cell, on each new battery reading (control task)
+  virtual void setSupplyVoltage(float cellMv, uint32_t nowMs) {}
+
+  // Failsafe response: neutral throttle unless the vehicle can do better
+  virtual FailsafePolicy getFailsafePolicy() const {
+    return {FAILSAFE_ACTION_NEUTRAL, FAILSAFE_ACTION_NEUTRAL};
+  }
+  // Fault that must be acted on regardless of the link (checked every tick)
+  virtual bool checkCriticalFault() { return false; }
+  // ESC feedback (RPM, current, temperature, health), null without any
+  virtual const EscTelemetry *getEscTelemetry() const { return nullptr; }
+  // Wheel odometry (control task), null without encoders
+  virtual const WheelOdometry *getOdometry() const { return nullptr; }
+  // Thrust stage between mixer and motors, null where there is none
+  virtual const ThrustCurve *getThrustCurve() const { return nullptr; }
+
+  // Outputs in use (defaults until setup() has loaded the saved profile)
+  const PinMapProfile &getHardware() const { return hardware; }
+
+protected:
+  PinMapProfile hardware = {};
+
+  // Overlay the saved profile and validate; false = leave outputs off
+  bool loadHardware();
 };
 
 #endif
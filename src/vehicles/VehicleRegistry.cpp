@@ -0,0 +1,82 @@
+#include "VehicleRegistry.h"
+#include "Copter.h"
+#include "Plane.h"
+#include "Rover.h"
+#include "Sub.h"
+#include <new>
+#include <strings.h>
+
+/**
+ * VehicleRegistry - Implementation
+ *
+ * @file VehicleRegistry.cpp
+ */
+
+// ============================================================================
+// Static Slot
+// ============================================================================
+
+template <typename T> constexpr T maxOf(T a, T b) { return a > b ? a : b; }
+
+static const size_t SLOT_SIZE =
+    maxOf(maxOf(sizeof(Rover), sizeof(Plane)), maxOf(sizeof(Sub), sizeof(Copter)));
+static const size_t SLOT_ALIGN =
+    maxOf(maxOf(alignof(Rover), alignof(Plane)), maxOf(alignof(Sub), alignof(Copter)));
+
+alignas(SLOT_ALIGN) static uint8_t slot[SLOT_SIZE];
+static Vehicle *instance = nullptr;
+
+static const char *const NAMES[VEHICLE_TYPE_COUNT] = {"ROVER", "PLANE", "SUB", "COPTER"};
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+Vehicle *VehicleRegistry_create(VehicleType type) {
+  if (instance)
+    return instance;
+
+  switch (type) {
+  case VEHICLE_ROVER:
+    instance = new (slot) Rover();
+    break;
+  case VEHICLE_PLANE:
+    instance = new (slot) Plane();
+    break;
+  case VEHICLE_SUB:
+    instance = new (slot) Sub();
+    break;
+  case VEHICLE_COPTER:
+  default:
+    instance = new (slot) Copter();
+    break;
+  }
+  return instance;
+}
+
+VehicleType VehicleRegistry_loadType() {
+  int type = ConfigManager::getInt(VEHICLE_CONFIG_KEY, VEHICLE_DEFAULT_TYPE);
+  return (type >= 0 && type < VEHICLE_TYPE_COUNT) ? (VehicleType)type
+                                                   : VEHICLE_DEFAULT_TYPE;
+}
+
+bool VehicleRegistry_saveType(VehicleType type) {
+  if (type >= VEHICLE_TYPE_COUNT)
+    return false;
+  ConfigManager::setInt(VEHICLE_CONFIG_KEY, type);
+  return true;
+}
+
+const char *VehicleRegistry_name(VehicleType type) {
+  return type < VEHICLE_TYPE_COUNT ? NAMES[type] : "?";
+}
+
+bool VehicleRegistry_parse(const char *name, VehicleType *type) {
+  for (uint8_t i = 0; name && i < VEHICLE_TYPE_COUNT; i++) {
+    if (strcasecmp(name, NAMES[i]) == 0) {
+      *type = (VehicleType)i;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,61 @@
+#ifndef VEHICLE_REGISTRY_H
+#define VEHICLE_REGISTRY_H
+
+#include "Vehicle.h"
+
+/**
+ * VehicleRegistry - Vehicle type chosen from config at boot
+ *
+ * One image serves every hull: the type is read from NVS ("vehicle" key)
+ * and the vehicle is constructed by placement-new in a static slot sized
+ * for the largest vehicle, so boot still does no heap allocation. Each
+ * vehicle brings its own mixer frame (Rover skid steer, Sub 3 thrusters,
+ * Copter quad X, Plane surfaces). A change takes effect on the next boot.
+ *
+ * Builds with a VEHICLE_TYPE_* define keep a fixed, statically typed
+ * vehicle instead (see main.cpp) and ignore the key.
+ *
+ * @file VehicleRegistry.h
+ */
+
+enum VehicleType : uint8_t {
+  VEHICLE_ROVER = 0,
+  VEHICLE_PLANE = 1,
+  VEHICLE_SUB = 2,
+  VEHICLE_COPTER = 3,
+  VEHICLE_TYPE_COUNT
+};
+
+#define VEHICLE_DEFAULT_TYPE VEHICLE_COPTER
+#define VEHICLE_CONFIG_KEY "vehicle"
+
+/**
+ * Construct the vehicle in the static slot (once; later calls return it)
+ * @param type Out-of-range types fall back to VEHICLE_DEFAULT_TYPE
+ * @return The vehicle, never null
+ */
+Vehicle *VehicleRegistry_create(VehicleType type);
+
+/**
+ * Type stored in config, VEHICLE_DEFAULT_TYPE if unset or invalid
+ */
+VehicleType VehicleRegistry_loadType();
+
+/**
+ * Store the type for the next boot
+ * @return false if out of range
+ */
+bool VehicleRegistry_saveType(VehicleType type);
+
+/**
+ * Upper-case name ("ROVER", ...), as returned by Vehicle::getName()
+ */
+const char *VehicleRegistry_name(VehicleType type);
+
+/**
+ * Case-insensitive name lookup
+ * @return false if no vehicle has that name
+ */
+bool VehicleRegistry_parse(const char *name, VehicleType *type);
+
+#endif // VEHICLE_REGISTRY_H
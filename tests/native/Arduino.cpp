@@ -0,0 +1,147 @@
+#include "Arduino.h"
+#include "esp_timer.h"
+#include <stdarg.h>
+#include <time.h>
+
+/**
+ * Arduino core shim - Implementation
+ *
+ * @file Arduino.cpp
+ */
+
+// ============================================================================
+// Time
+// ============================================================================
+
+static bool gManualClock = false;
+static uint64_t gManualUs = 0;
+
+static uint64_t host_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static uint64_t now_us(void) {
+    static const uint64_t start = host_us();
+    return gManualClock ? gManualUs : host_us() - start;
+}
+
+uint32_t millis(void) { return (uint32_t)(now_us() / 1000); }
+
+uint32_t micros(void) { return (uint32_t)now_us(); }
+
+int64_t esp_timer_get_time(void) { return (int64_t)now_us(); }
+
+void delay(uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+void delayMicroseconds(uint32_t us) {
+    if (gManualClock) {
+        gManualUs += us;
+        return;
+    }
+    uint64_t end = host_us() + us;
+    while (host_us() < end) {
+    }
+}
+
+void NativeClock_setMicros(uint64_t us) {
+    gManualClock = true;
+    gManualUs = us;
+}
+
+void NativeClock_advanceMicros(uint64_t us) {
+    if (!gManualClock) NativeClock_setMicros(now_us());
+    gManualUs += us;
+}
+
+void NativeClock_useHostTime(void) { gManualClock = false; }
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+#define NATIVE_GPIO_COUNT 40
+
+static uint8_t gPinLevel[NATIVE_GPIO_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < NATIVE_GPIO_COUNT && mode == INPUT_PULLUP) gPinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < NATIVE_GPIO_COUNT) gPinLevel[pin] = level ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) { return pin < NATIVE_GPIO_COUNT ? gPinLevel[pin] : LOW; }
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode) {
+    (void)interrupt;
+    (void)handler;
+    (void)mode;
+}
+
+void detachInterrupt(uint8_t interrupt) { (void)interrupt; }
+
+// ============================================================================
+// Serial
+// ============================================================================
+
+HardwareSerial Serial;
+
+static char gRx[1024];
+static size_t gRxHead = 0;
+static size_t gRxTail = 0;
+static void (*gOnReceive)(void) = NULL;
+
+void NativeSerial_feed(const char* data, size_t len) {
+    for (size_t i = 0; i < len && gRxTail < sizeof(gRx); i++) gRx[gRxTail++] = data[i];
+    if (gOnReceive) gOnReceive();
+}
+
+void HardwareSerial::onReceive(void (*callback)(void), bool onlyOnTimeout) {
+    (void)onlyOnTimeout;
+    gOnReceive = callback;
+}
+
+size_t HardwareSerial::readBytes(uint8_t* buf, size_t len) {
+    size_t n = 0;
+    int c;
+    while (n < len && (c = read()) >= 0) buf[n++] = (uint8_t)c;
+    return n;
+}
+
+int HardwareSerial::available() { return (int)(gRxTail - gRxHead); }
+
+int HardwareSerial::read() {
+    if (gRxHead == gRxTail) return -1;
+    int c = (uint8_t)gRx[gRxHead++];
+    if (gRxHead == gRxTail) gRxHead = gRxTail = 0;
+    return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+
+size_t HardwareSerial::write(const uint8_t* data, size_t len) {
+    return fwrite(data, 1, len, stdout);
+}
+
+size_t HardwareSerial::print(const char* s) { return fputs(s, stdout) == EOF ? 0 : strlen(s); }
+
+size_t HardwareSerial::print(char c) { return write((uint8_t)c); }
+
+size_t HardwareSerial::print(long v) { return ::printf("%ld", v); }
+
+size_t HardwareSerial::print(unsigned long v) { return ::printf("%lu", v); }
+
+size_t HardwareSerial::print(double v, int digits) { return ::printf("%.*f", digits, v); }
+
+size_t HardwareSerial::println(void) { return print("\r\n"); }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n < 0 ? 0 : (size_t)n;
+}
@@ -0,0 +1,168 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+/**
+ * Arduino core shim for the native (host) build
+ *
+ * Just enough of the Arduino / ESP32 API for the pure-logic modules and
+ * their tests: time, Serial (to stdout), digital pins, a small String and
+ * the FreeRTOS critical-section macros. Only used by env:native (-Itests/native); the
+ * firmware build never sees it.
+ *
+ * esp_timer_get_time() (esp_timer.h) reads the same clock as micros().
+ *
+ * Time runs on the host clock until a test sets it; after
+ * NativeClock_setMicros() it only moves with NativeClock_advanceMicros()
+ * (and delay()), so rate limiters and timeouts can be stepped exactly.
+ *
+ * @file Arduino.h
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+// ============================================================================
+// Core Definitions
+// ============================================================================
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// ESP32 attributes and FreeRTOS critical sections: single-threaded host
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+// ============================================================================
+// Time
+// ============================================================================
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+/**
+ * Switch to the manual clock and set it
+ */
+void NativeClock_setMicros(uint64_t us);
+
+/**
+ * Move the manual clock forward (switches to it if needed)
+ */
+void NativeClock_advanceMicros(uint64_t us);
+
+/**
+ * Back to the host clock
+ */
+void NativeClock_useHostTime(void);
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+/**
+ * Interrupts are accepted and never fire (no edges on the host)
+ */
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+// ============================================================================
+// String
+// ============================================================================
+
+/**
+ * The part of Arduino String the modules use (ConfigManager's paired MAC);
+ * ArduinoJson takes it through c_str() / length()
+ */
+class String {
+public:
+    String(const char* s = "") : _s(s ? s : "") {}
+    const char* c_str() const { return _s.c_str(); }
+    size_t length() const { return _s.size(); }
+    bool concat(const char* s) { _s += s ? s : ""; return true; }
+    bool concat(char c) { _s += c; return true; }
+    bool operator==(const char* s) const { return _s == (s ? s : ""); }
+    bool operator==(const String& other) const { return _s == other._s; }
+    bool operator!=(const char* s) const { return !(*this == s); }
+
+private:
+    std::string _s;
+};
+
+// ============================================================================
+// Serial
+// ============================================================================
+
+/**
+ * Serial to stdout; input is a buffer a test can fill (NativeSerial_feed)
+ */
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    int available();
+    int read();
+    size_t readBytes(uint8_t* buf, size_t len);
+    size_t readBytes(char* buf, size_t len) { return readBytes((uint8_t*)buf, len); }
+    void onReceive(void (*callback)(void), bool onlyOnTimeout = false);
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* data, size_t len);
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(long v);
+    size_t print(unsigned long v);
+    size_t print(int v) { return print((long)v); }
+    size_t print(unsigned int v) { return print((unsigned long)v); }
+    size_t print(double v, int digits = 2);
+    size_t println(void);
+    template <typename T> size_t println(T v) { return print(v) + println(); }
+    size_t println(double v, int digits) { return print(v, digits) + println(); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void flush() { fflush(stdout); }
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * Queue bytes for Serial.read() (runs the onReceive callback)
+ */
+void NativeSerial_feed(const char* data, size_t len);
+
+#endif // NATIVE_ARDUINO_H
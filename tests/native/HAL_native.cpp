@@ -0,0 +1,387 @@
+#include "HAL.h"
+#include "NativeHAL.h"
+#include "PinMap.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <string.h>
+
+/**
+ * HAL - Native (host) implementation for env:native
+ *
+ * The LEDC registry places channels on timers with the same rules as the
+ * target (share a timer running the same frequency / resolution, else
+ * take a free one, 8 channels and 4 timers per group), so allocation
+ * failures reproduce on the host; duties are just stored. The I2C bus
+ * holds only the device models attached through NativeHAL.h (every other
+ * address NACKs; queued transactions complete inline), the serial calls
+ * go to the Serial shim. Encoders count what NativeEncoder_set() gives
+ * them. ADC is not provided.
+ *
+ * @file HAL_native.cpp
+ */
+
+#define MAX_PWM_CHANNELS 16
+#define PWM_GROUPS 2
+#define PWM_CHANNELS_PER_GROUP 8
+#define PWM_TIMERS_PER_GROUP 4
+
+typedef struct {
+  bool allocated;
+  uint8_t pin;
+  uint8_t timer;
+  uint32_t frequency;
+  uint8_t resolution;
+  uint32_t duty;
+  uint8_t dutyCycle;
+} NativePWMChannel;
+
+typedef struct {
+  uint8_t users;
+  uint32_t frequency;
+  uint8_t resolution;
+} NativePWMTimer;
+
+static NativePWMChannel pwm_channels[MAX_PWM_CHANNELS];
+static NativePWMTimer pwm_timers[PWM_GROUPS * PWM_TIMERS_PER_GROUP];
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+bool HAL_PinInit(uint8_t pin, HAL_PinMode mode) {
+  static const uint8_t modes[] = {INPUT, INPUT_PULLUP, INPUT_PULLDOWN, OUTPUT};
+  pinMode(pin, modes[mode]);
+  return true;
+}
+
+HAL_PinLevel HAL_PinRead(uint8_t pin) {
+  return digitalRead(pin) ? HAL_PIN_HIGH : HAL_PIN_LOW;
+}
+
+bool HAL_PinWrite(uint8_t pin, HAL_PinLevel level) {
+  digitalWrite(pin, level);
+  return true;
+}
+
+bool HAL_PinToggle(uint8_t pin) {
+  digitalWrite(pin, !digitalRead(pin));
+  return true;
+}
+
+bool HAL_PinDeinit(uint8_t pin) {
+  (void)pin;
+  return true;
+}
+
+// ============================================================================
+// PWM Registry
+// ============================================================================
+
+static int pwm_free_channel(uint8_t group) {
+  for (uint8_t i = 0; i < PWM_CHANNELS_PER_GROUP; i++) {
+    uint8_t ch = group * PWM_CHANNELS_PER_GROUP + i;
+    if (!pwm_channels[ch].allocated)
+      return ch;
+  }
+  return -1;
+}
+
+int HAL_PWMAllocate(uint8_t pin, uint32_t frequency, uint8_t resolution) {
+  if (frequency == 0 || resolution < 1 || resolution > 16)
+    return -1;
+  for (int i = 0; i < MAX_PWM_CHANNELS; i++) {
+    if (pwm_channels[i].allocated && pwm_channels[i].pin == pin)
+      return -1;
+  }
+
+  int channel = -1;
+  int timer = -1;
+  for (uint8_t t = 0; t < PWM_GROUPS * PWM_TIMERS_PER_GROUP && timer < 0; t++) {
+    if (pwm_timers[t].users && pwm_timers[t].frequency == frequency &&
+        pwm_timers[t].resolution == resolution) {
+      channel = pwm_free_channel(t / PWM_TIMERS_PER_GROUP);
+      if (channel >= 0)
+        timer = t;
+    }
+  }
+  for (uint8_t t = 0; t < PWM_GROUPS * PWM_TIMERS_PER_GROUP && timer < 0; t++) {
+    if (pwm_timers[t].users == 0) {
+      channel = pwm_free_channel(t / PWM_TIMERS_PER_GROUP);
+      if (channel >= 0)
+        timer = t;
+    }
+  }
+  if (timer < 0)
+    return -1;
+
+  pwm_timers[timer].users++;
+  pwm_timers[timer].frequency = frequency;
+  pwm_timers[timer].resolution = resolution;
+  NativePWMChannel *c = &pwm_channels[channel];
+  memset(c, 0, sizeof(*c));
+  c->allocated = true;
+  c->pin = pin;
+  c->timer = timer;
+  c->frequency = frequency;
+  c->resolution = resolution;
+  return channel;
+}
+
+int HAL_PWMAllocateMax(uint8_t pin, uint32_t frequency) {
+  uint8_t resolution = PinMap_pwmMaxResolution(frequency);
+  return resolution ? HAL_PWMAllocate(pin, frequency, resolution) : -1;
+}
+
+bool HAL_PWMWrite(uint8_t channel, uint32_t duty) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated)
+    return false;
+  uint32_t max = 1UL << pwm_channels[channel].resolution;
+  pwm_channels[channel].duty = duty > max ? max : duty;
+  return true;
+}
+
+bool HAL_PWMWriteQ15(uint8_t channel, uint16_t q15) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated)
+    return false;
+  return HAL_PWMWrite(channel, PinMap_dutyFromQ15(q15, pwm_channels[channel].resolution));
+}
+
+uint8_t HAL_PWMGetResolution(uint8_t channel) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated)
+    return 0;
+  return pwm_channels[channel].resolution;
+}
+
+bool HAL_PWMGetChannelInfo(uint8_t channel, HAL_PWMChannelInfo *info) {
+  if (channel >= MAX_PWM_CHANNELS || !info)
+    return false;
+  info->allocated = pwm_channels[channel].allocated;
+  info->pin = pwm_channels[channel].pin;
+  info->timer = pwm_channels[channel].timer;
+  info->frequency = pwm_channels[channel].frequency;
+  info->resolution = pwm_channels[channel].resolution;
+  info->duty = pwm_channels[channel].duty;
+  return true;
+}
+
+int HAL_TimerAllocate(uint8_t pin, uint32_t frequency, uint8_t initialDuty) {
+  int channel = HAL_PWMAllocateMax(pin, frequency);
+  if (channel >= 0 && initialDuty)
+    HAL_TimerSetDuty(channel, initialDuty);
+  return channel;
+}
+
+bool HAL_TimerSetDuty(uint8_t channel, uint8_t dutyCycle) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated)
+    return false;
+  if (dutyCycle > 100)
+    dutyCycle = 100;
+  HAL_PWMWriteQ15(channel, (uint16_t)((dutyCycle * PINMAP_Q15_ONE + 50) / 100));
+  pwm_channels[channel].dutyCycle = dutyCycle;
+  return true;
+}
+
+int HAL_TimerGetDuty(uint8_t channel) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated)
+    return -1;
+  return pwm_channels[channel].dutyCycle;
+}
+
+bool HAL_TimerSetFrequency(uint8_t channel, uint32_t frequency) {
+  (void)channel;
+  (void)frequency;
+  return false; // Shared timers, not supported on the target either
+}
+
+bool HAL_TimerRelease(uint8_t channel) {
+  if (channel >= MAX_PWM_CHANNELS || !pwm_channels[channel].allocated)
+    return false;
+  pwm_timers[pwm_channels[channel].timer].users--;
+  memset(&pwm_channels[channel], 0, sizeof(pwm_channels[channel]));
+  return true;
+}
+
+uint8_t HAL_TimerReleaseAll(void) {
+  uint8_t released = 0;
+  for (uint8_t ch = 0; ch < MAX_PWM_CHANNELS; ch++) {
+    if (HAL_TimerRelease(ch))
+      released++;
+  }
+  return released;
+}
+
+void HAL_PWMEmergencyStop(void) {
+  for (uint8_t ch = 0; ch < MAX_PWM_CHANNELS; ch++)
+    pwm_channels[ch].duty = 0;
+}
+
+// ============================================================================
+// I2C (device models from NativeI2C_attach)
+// ============================================================================
+
+static HAL_I2CQueueStats i2c_stats;
+
+static struct {
+  uint8_t addr;
+  NativeI2CDevice device;
+  void *ctx;
+} i2c_devices[NATIVE_I2C_MAX_DEVICES];
+
+bool NativeI2C_attach(uint8_t addr, NativeI2CDevice device, void *ctx) {
+  int slot = -1;
+  for (int i = 0; i < NATIVE_I2C_MAX_DEVICES; i++) {
+    if (i2c_devices[i].device && i2c_devices[i].addr == addr) slot = i;
+    else if (slot < 0 && !i2c_devices[i].device) slot = i;
+  }
+  if (slot < 0) return device == NULL;
+  i2c_devices[slot].addr = addr;
+  i2c_devices[slot].device = device;
+  i2c_devices[slot].ctx = ctx;
+  return true;
+}
+
+void NativeI2C_detachAll(void) { memset(i2c_devices, 0, sizeof(i2c_devices)); }
+
+static HAL_I2CError i2c_transfer(uint8_t addr, const uint8_t *tx, uint8_t txLen, uint8_t *rx,
+                                 uint8_t rxLen) {
+  for (int i = 0; i < NATIVE_I2C_MAX_DEVICES; i++) {
+    if (i2c_devices[i].device && i2c_devices[i].addr == addr)
+      return i2c_devices[i].device(tx, txLen, rx, rxLen, i2c_devices[i].ctx) ? HAL_I2C_OK
+                                                                             : HAL_I2C_NO_ACK;
+  }
+  return HAL_I2C_NO_ACK;
+}
+
+bool HAL_I2CInit(uint8_t sda, uint8_t scl, uint32_t frequency) {
+  (void)sda;
+  (void)scl;
+  (void)frequency;
+  return true;
+}
+
+uint8_t HAL_I2CScan(uint8_t *addresses) {
+  uint8_t found = 0;
+  for (uint8_t addr = 0x08; addr < 0x78; addr++) {
+    if (HAL_I2CProbe(addr, 10) == HAL_I2C_OK) {
+      if (addresses) addresses[found] = addr;
+      found++;
+    }
+  }
+  return found;
+}
+
+HAL_I2CError HAL_I2CProbe(uint8_t slaveAddr, uint32_t timeout) {
+  (void)timeout;
+  return i2c_transfer(slaveAddr, NULL, 0, NULL, 0);
+}
+
+HAL_I2CError HAL_I2CWrite(uint8_t slaveAddr, const uint8_t *data, uint8_t length,
+                          uint32_t timeout) {
+  (void)timeout;
+  return i2c_transfer(slaveAddr, data, length, NULL, 0);
+}
+
+int HAL_I2CRead(uint8_t slaveAddr, uint8_t *buffer, uint8_t length, uint32_t timeout) {
+  (void)timeout;
+  return i2c_transfer(slaveAddr, NULL, 0, buffer, length) == HAL_I2C_OK ? length : -1;
+}
+
+int HAL_I2CReadReg(uint8_t slaveAddr, uint8_t regAddr, uint8_t *buffer, uint8_t length,
+                   uint32_t timeout) {
+  (void)timeout;
+  return i2c_transfer(slaveAddr, &regAddr, 1, buffer, length) == HAL_I2C_OK ? length : -1;
+}
+
+bool HAL_I2CDeinit(void) { return true; }
+
+bool HAL_I2CStartQueue(uint8_t priority, uint8_t core) {
+  (void)priority;
+  (void)core;
+  return true;
+}
+
+// Completes inline, before HAL_I2CSubmit returns
+bool HAL_I2CSubmit(const HAL_I2CTransaction *txn) {
+  const uint8_t *tx = txn->txExt ? txn->txExt : txn->tx;
+  HAL_I2CError result = i2c_transfer(txn->slaveAddr, tx, txn->txLen, txn->rx, txn->rxLen);
+  if (result == HAL_I2C_OK)
+    i2c_stats.completed++;
+  else
+    i2c_stats.failed++;
+  if (txn->callback)
+    txn->callback(result, txn->ctx);
+  return true;
+}
+
+HAL_I2CQueueStats HAL_I2CGetQueueStats(void) { return i2c_stats; }
+
+// ============================================================================
+// Quadrature Encoders
+// ============================================================================
+
+static uint8_t encoder_count = 0;
+static int32_t encoder_values[HAL_ENCODER_MAX];
+
+int HAL_EncoderAttach(uint8_t pinA, uint8_t pinB, uint16_t filterNs) {
+  (void)pinA;
+  (void)pinB;
+  (void)filterNs;
+  return encoder_count < HAL_ENCODER_MAX ? encoder_count++ : -1;
+}
+
+int32_t HAL_EncoderRead(uint8_t encoder) {
+  return encoder < encoder_count ? encoder_values[encoder] : 0;
+}
+
+void NativeEncoder_set(uint8_t encoder, int32_t count) {
+  if (encoder < HAL_ENCODER_MAX) encoder_values[encoder] = count;
+}
+
+// ============================================================================
+// Serial
+// ============================================================================
+
+bool HAL_SerialInit(uint32_t baudRate) {
+  Serial.begin(baudRate);
+  return true;
+}
+
+uint16_t HAL_SerialWrite(const uint8_t *data, uint16_t length) {
+  return Serial.write(data, length);
+}
+
+uint16_t HAL_SerialRead(uint8_t *buffer, uint16_t maxLength) {
+  return Serial.readBytes(buffer, maxLength);
+}
+
+uint16_t HAL_SerialAvailable(void) { return Serial.available(); }
+
+bool HAL_SerialFlush(void) {
+  Serial.flush();
+  return true;
+}
+
+bool HAL_SerialDeinit(void) { return true; }
+
+// ============================================================================
+// Time
+// ============================================================================
+
+uint32_t HAL_GetMillis(void) { return millis(); }
+
+uint32_t HAL_GetMicros(void) { return micros(); }
+
+HAL_Micros HAL_Now(void) { return esp_timer_get_time(); }
+
+// One "cycle" per microsecond: deltas convert 1:1
+uint32_t HAL_GetCycles(void) { return micros(); }
+
+uint32_t HAL_CyclesToMicros(uint32_t cycles) { return cycles; }
+
+void HAL_Delay(uint32_t milliseconds) { delay(milliseconds); }
+
+void HAL_DelayMicros(uint32_t microseconds) { delayMicroseconds(microseconds); }
+
+const char *HAL_GetPlatformName(void) { return "native"; }
+
+const char *HAL_GetPlatformInfo(void) { return "Host build (env:native)"; }
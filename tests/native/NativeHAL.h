@@ -0,0 +1,43 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include "HAL.h"
+
+/**
+ * Hooks into the native HAL (HAL_native.cpp) for tests and the SITL build
+ *
+ * The host I2C bus is empty until a device model is attached; each
+ * attached address then answers every HAL I2C call, blocking or queued,
+ * with one call to its model per transaction. Encoders count only what
+ * is injected.
+ *
+ * @file NativeHAL.h
+ */
+
+#define NATIVE_I2C_MAX_DEVICES 8
+
+/**
+ * One bus transaction at a device: tx written first, then rx read after
+ * a repeated start (either may be empty)
+ * @return false to NACK
+ */
+typedef bool (*NativeI2CDevice)(const uint8_t* tx, uint8_t txLen, uint8_t* rx,
+                                uint8_t rxLen, void* ctx);
+
+/**
+ * Put a device model on the bus (NULL removes it)
+ * @return false if all NATIVE_I2C_MAX_DEVICES slots are taken
+ */
+bool NativeI2C_attach(uint8_t addr, NativeI2CDevice device, void* ctx);
+
+/**
+ * Remove every device model
+ */
+void NativeI2C_detachAll(void);
+
+/**
+ * Set the count an attached encoder reads
+ */
+void NativeEncoder_set(uint8_t encoder, int32_t count);
+
+#endif // NATIVE_HAL_H
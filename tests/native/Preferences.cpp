@@ -0,0 +1,130 @@
+#include "Preferences.h"
+#include <map>
+#include <string>
+#include <string.h>
+#include <vector>
+
+/**
+ * Preferences shim - Implementation
+ *
+ * Keys are stored as "<namespace>/<key>". NVS limits (15-character names,
+ * read-only handles) are kept so code that breaks them fails here too.
+ *
+ * @file Preferences.cpp
+ */
+
+#define NVS_KEY_MAX_LEN 15
+
+static std::map<std::string, std::vector<uint8_t>>& store(void) {
+    static std::map<std::string, std::vector<uint8_t>> entries;
+    return entries;
+}
+
+static bool valid_key(const char* key) {
+    return key && key[0] && strlen(key) <= NVS_KEY_MAX_LEN;
+}
+
+void NativePreferences_clearAll(void) { store().clear(); }
+
+// ============================================================================
+// Namespace
+// ============================================================================
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+    (void)partition;
+    if (_open || !valid_key(name)) return false;
+    strncpy(_namespace, name, sizeof(_namespace) - 1);
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() { _open = false; }
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) return false;
+    std::string prefix = std::string(_namespace) + "/";
+    auto& s = store();
+    for (auto it = s.begin(); it != s.end();) {
+        it = it->first.compare(0, prefix.size(), prefix) == 0 ? s.erase(it) : std::next(it);
+    }
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly || !valid_key(key)) return false;
+    return store().erase(std::string(_namespace) + "/" + key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    return _open && valid_key(key) && store().count(std::string(_namespace) + "/" + key) > 0;
+}
+
+// ============================================================================
+// Values
+// ============================================================================
+
+size_t Preferences::put(const char* key, const void* value, size_t len) {
+    if (!_open || _readOnly || !valid_key(key)) return 0;
+    const uint8_t* p = (const uint8_t*)value;
+    store()[std::string(_namespace) + "/" + key] = std::vector<uint8_t>(p, p + len);
+    return len;
+}
+
+bool Preferences::get(const char* key, void* value, size_t len) {
+    if (!_open || !valid_key(key)) return false;
+    auto it = store().find(std::string(_namespace) + "/" + key);
+    if (it == store().end() || it->second.size() != len) return false;
+    memcpy(value, it->second.data(), len);
+    return true;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    return put(key, value, len);
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    size_t len = getBytesLength(key);
+    if (len == 0 || len > maxLen) return 0;
+    return get(key, buf, len) ? len : 0;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!_open || !valid_key(key)) return 0;
+    auto it = store().find(std::string(_namespace) + "/" + key);
+    return it == store().end() ? 0 : it->second.size();
+}
+
+#define PREFS_SCALAR(Name, Type)                                          \
+    size_t Preferences::put##Name(const char* key, Type value) {          \
+        return put(key, &value, sizeof(value));                           \
+    }                                                                     \
+    Type Preferences::get##Name(const char* key, Type defaultValue) {     \
+        Type value;                                                       \
+        return get(key, &value, sizeof(value)) ? value : defaultValue;    \
+    }
+
+PREFS_SCALAR(UChar, uint8_t)
+PREFS_SCALAR(Short, int16_t)
+PREFS_SCALAR(UShort, uint16_t)
+PREFS_SCALAR(Int, int32_t)
+PREFS_SCALAR(UInt, uint32_t)
+PREFS_SCALAR(Float, float)
+PREFS_SCALAR(Bool, bool)
+
+size_t Preferences::putString(const char* key, const char* value) {
+    return value ? put(key, value, strlen(value) + 1) : 0;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+    size_t len = getBytesLength(key);
+    if (len == 0 || !value || len > maxLen) return 0;
+    return get(key, value, len) ? len : 0;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    size_t len = getBytesLength(key);
+    if (len == 0) return defaultValue;
+    std::vector<char> buf(len);
+    return get(key, buf.data(), len) ? String(buf.data()) : defaultValue;
+}
@@ -0,0 +1,63 @@
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+#include <Arduino.h>
+
+/**
+ * Preferences (NVS) shim for the native build
+ *
+ * Same calls as the ESP32 Preferences library, backed by an in-memory
+ * store shared by every instance (like the real flash partition), so a
+ * value written through one object is read back through another.
+ * NativePreferences_clearAll() wipes it between tests. Strings are
+ * stored with their terminator, as NVS does.
+ *
+ * @file Preferences.h
+ */
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partition = NULL);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t getBytesLength(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value);
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+    size_t putShort(const char* key, int16_t value);
+    int16_t getShort(const char* key, int16_t defaultValue = 0);
+    size_t putUShort(const char* key, uint16_t value);
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0);
+    size_t putInt(const char* key, int32_t value);
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    size_t putUInt(const char* key, uint32_t value);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    size_t putFloat(const char* key, float value);
+    float getFloat(const char* key, float defaultValue = 0.0f);
+    size_t putBool(const char* key, bool value);
+    bool getBool(const char* key, bool defaultValue = false);
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getString(const char* key, char* value, size_t maxLen);
+
+private:
+    char _namespace[16] = {0};
+    bool _open = false;
+    bool _readOnly = false;
+
+    size_t put(const char* key, const void* value, size_t len);
+    bool get(const char* key, void* value, size_t len);
+};
+
+/**
+ * Erase every namespace
+ */
+void NativePreferences_clearAll(void);
+
+#endif // NATIVE_PREFERENCES_H
@@ -0,0 +1,15 @@
+#ifndef NATIVE_ESP_TIMER_H
+#define NATIVE_ESP_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * esp_timer shim for the native build: the clock only, no timers
+ * (same clock as micros(), see Arduino.h)
+ *
+ * @file esp_timer.h
+ */
+
+int64_t esp_timer_get_time(void);
+
+#endif // NATIVE_ESP_TIMER_H
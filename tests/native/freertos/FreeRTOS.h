@@ -0,0 +1,28 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+/**
+ * FreeRTOS shim for the native build
+ *
+ * Types and constants only, for headers that declare task handles or
+ * critical sections. No scheduler: the host build is single-threaded, and
+ * anything that really creates a task stays out of env:native.
+ *
+ * @file freertos/FreeRTOS.h
+ */
+
+#include <Arduino.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif // NATIVE_FREERTOS_H
@@ -0,0 +1,14 @@
+#ifndef NATIVE_FREERTOS_TASK_H
+#define NATIVE_FREERTOS_TASK_H
+
+/**
+ * FreeRTOS task shim: handle type only (see freertos/FreeRTOS.h)
+ *
+ * @file freertos/task.h
+ */
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+
+#endif // NATIVE_FREERTOS_TASK_H
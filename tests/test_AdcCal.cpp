@@ -0,0 +1,108 @@
+/**
+ * Unit Tests for AdcCal
+ * Tests table linearization against a curved characterization, the
+ * linear fallback, range clamping, oversample averaging and divider
+ * scaling
+ *
+ * @file test_AdcCal.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "AdcCal.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static AdcCalLut lut;
+
+// Shaped like an 11 dB ESP32 curve: offset at the bottom, compressed top
+static uint32_t curved(uint32_t raw, void* ctx) {
+    (void)ctx;
+    uint32_t mv = 142 + raw * 3 / 4;
+    if (raw > 3000)
+        mv += (raw - 3000) * (raw - 3000) / 4000;
+    return mv;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Table Tests
+// ============================================================================
+
+void test_table_follows_the_curve(void) {
+    AdcCal_build(&lut, curved, NULL);
+    int32_t worst = 0;
+    for (uint32_t raw = 0; raw <= ADC_CAL_RAW_MAX; raw++) {
+        int32_t err = (int32_t)AdcCal_toMillivolts(&lut, (uint16_t)raw) - (int32_t)curved(raw, NULL);
+        if (err < 0) err = -err;
+        if (err > worst) worst = err;
+    }
+    // Curvature within one 64-code segment stays below a millivolt or two
+    TEST_ASSERT_TRUE(worst <= 2);
+    TEST_ASSERT_EQUAL_UINT16(curved(0, NULL), AdcCal_toMillivolts(&lut, 0));
+    TEST_ASSERT_EQUAL_UINT16(curved(2048, NULL), AdcCal_toMillivolts(&lut, 2048));
+}
+
+void test_linear_table(void) {
+    AdcCal_buildLinear(&lut, 3300);
+    TEST_ASSERT_EQUAL_UINT16(0, AdcCal_toMillivolts(&lut, 0));
+    TEST_ASSERT_UINT_WITHIN(1, 1650, AdcCal_toMillivolts(&lut, 2048));
+    TEST_ASSERT_EQUAL_UINT16(3300, AdcCal_toMillivolts(&lut, ADC_CAL_RAW_MAX));
+}
+
+void test_out_of_range_code_is_clamped(void) {
+    AdcCal_buildLinear(&lut, 3300);
+    TEST_ASSERT_EQUAL_UINT16(3300, AdcCal_toMillivolts(&lut, 0xFFFF));
+}
+
+// ============================================================================
+// Arithmetic Tests
+// ============================================================================
+
+void test_average_rounds(void) {
+    TEST_ASSERT_EQUAL_UINT16(3, AdcCal_average(10, 4));     // 2.5 -> 3
+    TEST_ASSERT_EQUAL_UINT16(2, AdcCal_average(9, 4));      // 2.25 -> 2
+    TEST_ASSERT_EQUAL_UINT16(4095, AdcCal_average(4095u * 64, 64));
+    TEST_ASSERT_EQUAL_UINT16(0, AdcCal_average(100, 0));
+}
+
+void test_oversample_limits(void) {
+    TEST_ASSERT_EQUAL_UINT8(1, AdcCal_sanitizeOversample(0));
+    TEST_ASSERT_EQUAL_UINT8(16, AdcCal_sanitizeOversample(16));
+    TEST_ASSERT_EQUAL_UINT8(ADC_CAL_MAX_OVERSAMPLE, AdcCal_sanitizeOversample(200));
+}
+
+void test_divider_scale(void) {
+    // 3.5:1 divider as 7 / 2
+    TEST_ASSERT_EQUAL_UINT16(3850, AdcCal_scale(1100, 7, 2));
+    TEST_ASSERT_EQUAL_UINT16(4, AdcCal_scale(1, 7, 2));     // 3.5 -> 4
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, AdcCal_scale(30000, 7, 2));
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, AdcCal_scale(1, 1, 0));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Table Tests
+    RUN_TEST(test_table_follows_the_curve);
+    RUN_TEST(test_linear_table);
+    RUN_TEST(test_out_of_range_code_is_clamped);
+
+    // Arithmetic Tests
+    RUN_TEST(test_average_rounds);
+    RUN_TEST(test_oversample_limits);
+    RUN_TEST(test_divider_scale);
+
+    return UNITY_END();
+}
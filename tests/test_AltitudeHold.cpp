@@ -0,0 +1,148 @@
+/**
+ * Unit Tests for AltitudeHold
+ * Tests the stick mapping, the target leash, tilt compensation, the
+ * integrator bounds and a hold against a point-mass copter model
+ *
+ * @file test_AltitudeHold.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "AltitudeHold.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DT  0.02f
+#define G   9.80665f
+
+static AltitudeHold hold;
+static AltHoldConfig config;
+
+// Point mass: hovers at `hover` throttle
+typedef struct {
+    float h, v, hover;
+} Model;
+
+static void step(Model* m, float throttle) {
+    float a = (throttle / m->hover - 1.0f) * G;
+    m->h += (m->v + 0.5f * a * DT) * DT;
+    m->v += a * DT;
+}
+
+void setUp(void) {
+    AltitudeHold_defaultConfig(&config);
+    config.enabled = true;
+    AltitudeHold_init(&hold, &config);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Stick Tests
+// ============================================================================
+
+void test_stick_deadband(void) {
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, AltitudeHold_stickRate(&config, 0.5f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, AltitudeHold_stickRate(&config, 0.59f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, AltitudeHold_stickRate(&config, 0.41f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, config.maxClimbMps, AltitudeHold_stickRate(&config, 1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -config.maxSinkMps, AltitudeHold_stickRate(&config, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, config.maxClimbMps * 0.5f, AltitudeHold_stickRate(&config, 0.8f));
+}
+
+// ============================================================================
+// Controller Tests
+// ============================================================================
+
+void test_engage_starts_at_hover(void) {
+    AltitudeHold_engage(&hold, 3.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.0f, hold.target);
+    float t = AltitudeHold_update(&hold, 0.0f, 3.0f, 0.0f, 1.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, config.hoverThrottle, t);
+}
+
+void test_not_engaged_does_nothing(void) {
+    float t = AltitudeHold_update(&hold, 1.0f, 3.0f, 0.0f, 1.0f, DT);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, t);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, hold.target);
+}
+
+void test_tilt_compensation(void) {
+    AltitudeHold_engage(&hold, 0.0f);
+    float level = AltitudeHold_update(&hold, 0.0f, 0.0f, 0.0f, 1.0f, DT);
+    AltitudeHold_engage(&hold, 0.0f);
+    float tilted = AltitudeHold_update(&hold, 0.0f, 0.0f, 0.0f, cosf(0.5f), DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, level / cosf(0.5f), tilted);
+    AltitudeHold_engage(&hold, 0.0f);
+    float inverted = AltitudeHold_update(&hold, 0.0f, 0.0f, 0.0f, -1.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, level / ALT_HOLD_MIN_COS_TILT, inverted);
+}
+
+void test_target_leash(void) {
+    // Pilot asks to climb while the airframe stays put: target runs ahead
+    // only as far as a full-rate position command
+    AltitudeHold_engage(&hold, 0.0f);
+    for (int i = 0; i < 500; i++) AltitudeHold_update(&hold, config.maxClimbMps, 0.0f, 0.0f, 1.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, config.maxClimbMps / config.posKp, hold.target);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, config.maxClimbMps, hold.climbSp);
+}
+
+void test_integrator_bounded(void) {
+    AltitudeHold_engage(&hold, 0.0f);
+    for (int i = 0; i < 5000; i++) AltitudeHold_update(&hold, 0.0f, 0.0f, -0.5f, 1.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, config.iLimit, hold.integral);
+    config.iLimit = 0.05f;
+    AltitudeHold_setConfig(&hold, &config);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.05f, hold.integral);
+}
+
+void test_holds_with_wrong_hover_guess(void) {
+    // Real hover is 0.55, the config says 0.45: the integrator takes it up
+    Model m = {10.0f, 0.0f, 0.55f};
+    AltitudeHold_engage(&hold, m.h);
+    for (int i = 0; i < 1500; i++)
+        step(&m, AltitudeHold_update(&hold, 0.0f, m.h, m.v, 1.0f, DT));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 10.0f, m.h);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.1f, hold.integral);
+}
+
+void test_mission_step_rate_limited(void) {
+    // 10 m step up: climbs at the limit, then settles without overshoot
+    Model m = {0.0f, 0.0f, 0.45f};
+    AltitudeHold_engage(&hold, m.h);
+    AltitudeHold_setTarget(&hold, 10.0f);
+    float peakV = 0.0f, peakH = 0.0f;
+    for (int i = 0; i < 1500; i++) {
+        step(&m, AltitudeHold_update(&hold, 0.0f, m.h, m.v, 1.0f, DT));
+        peakV = fmaxf(peakV, m.v);
+        peakH = fmaxf(peakH, m.h);
+    }
+    TEST_ASSERT_TRUE(peakV < config.maxClimbMps * 1.2f);
+    TEST_ASSERT_TRUE(peakH < 10.3f);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 10.0f, m.h);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Stick Tests
+    RUN_TEST(test_stick_deadband);
+
+    // Controller Tests
+    RUN_TEST(test_engage_starts_at_hover);
+    RUN_TEST(test_not_engaged_does_nothing);
+    RUN_TEST(test_tilt_compensation);
+    RUN_TEST(test_target_leash);
+    RUN_TEST(test_integrator_bounded);
+    RUN_TEST(test_holds_with_wrong_hover_guess);
+    RUN_TEST(test_mission_step_rate_limited);
+
+    return UNITY_END();
+}
@@ -0,0 +1,128 @@
+/**
+ * Unit Tests for AttitudeEstimator
+ * Tests accel convergence, gyro integration and accel rejection
+ * (build with -DATTITUDE_FIXED_POINT=1 to run them against the Q30 path)
+ *
+ * @file test_AttitudeEstimator.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "AttitudeEstimator.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define G 9.80665f
+#define DT 0.001f
+#define DEG (3.14159265f / 180.0f)
+
+static AttitudeEstimator est;
+
+static void run(const float gyro[3], const float accel[3], int samples) {
+    for (int i = 0; i < samples; i++) AttitudeEstimator_update(&est, gyro, accel, DT);
+}
+
+void setUp(void) {
+    AttitudeEstimator_init(&est, ATTITUDE_DEFAULT_KP, ATTITUDE_DEFAULT_KI);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Accelerometer Correction Tests
+// ============================================================================
+
+void test_level_stays_level(void) {
+    const float gyro[3] = {0, 0, 0};
+    const float accel[3] = {0, 0, G};
+    run(gyro, accel, 1000);
+
+    float roll, pitch, yaw;
+    AttitudeEstimator_getEuler(&est, &roll, &pitch, &yaw);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * DEG, 0.0f, roll);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * DEG, 0.0f, pitch);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * DEG, 0.0f, yaw);
+}
+
+void test_converges_to_tilt(void) {
+    // 20 deg roll, 10 deg pitch, held still
+    float r = 20.0f * DEG, p = 10.0f * DEG;
+    const float gyro[3] = {0, 0, 0};
+    const float accel[3] = {-sinf(p) * G, sinf(r) * cosf(p) * G, cosf(r) * cosf(p) * G};
+    run(gyro, accel, 10000);
+
+    float roll, pitch, yaw;
+    AttitudeEstimator_getEuler(&est, &roll, &pitch, &yaw);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f * DEG, r, roll);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f * DEG, p, pitch);
+}
+
+void test_rejects_non_gravity_accel(void) {
+    // 3 g is not gravity: attitude must not move toward it
+    const float gyro[3] = {0, 0, 0};
+    const float accel[3] = {3.0f * G, 0, 0};
+    run(gyro, accel, 500);
+
+    float roll, pitch, yaw;
+    AttitudeEstimator_getEuler(&est, &roll, &pitch, &yaw);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, pitch);
+    TEST_ASSERT_EQUAL_UINT32(500, est.accelRejected);
+}
+
+// ============================================================================
+// Gyro Integration Tests
+// ============================================================================
+
+void test_integrates_yaw_rate(void) {
+    // 90 deg/s about z for 1 s while level: yaw is gyro-only
+    const float gyro[3] = {0, 0, 90.0f * DEG};
+    const float accel[3] = {0, 0, G};
+    run(gyro, accel, 1000);
+
+    float roll, pitch, yaw;
+    AttitudeEstimator_getEuler(&est, &roll, &pitch, &yaw);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f * DEG, 90.0f * DEG, yaw);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f * DEG, 0.0f, roll);
+}
+
+void test_quaternion_stays_unit(void) {
+    const float gyro[3] = {3.0f, -2.0f, 5.0f};
+    const float accel[3] = {0, 0, G};
+    run(gyro, accel, 5000);
+
+    float q[4];
+    AttitudeEstimator_getQuaternion(&est, q);
+    float n = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, n);
+}
+
+void test_counts_updates_and_cycles(void) {
+    const float gyro[3] = {0, 0, 0};
+    const float accel[3] = {0, 0, G};
+    run(gyro, accel, 10);
+    TEST_ASSERT_EQUAL_UINT32(10, est.updates);
+    TEST_ASSERT_TRUE(est.maxCycles >= AttitudeEstimator_getAvgCycles(&est));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Accelerometer Correction Tests
+    RUN_TEST(test_level_stays_level);
+    RUN_TEST(test_converges_to_tilt);
+    RUN_TEST(test_rejects_non_gravity_accel);
+
+    // Gyro Integration Tests
+    RUN_TEST(test_integrates_yaw_rate);
+    RUN_TEST(test_quaternion_stays_unit);
+    RUN_TEST(test_counts_updates_and_cycles);
+
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+/**
+ * Unit Tests for BaroAltitude
+ * Tests the pressure / height conversion, the ground reference, and the
+ * complementary filter against a simulated climb with a biased, noisy
+ * accelerometer
+ *
+ * @file test_BaroAltitude.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdlib.h>
+#include "BaroAltitude.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DT          0.02f
+#define GROUND_PA   101325.0f
+
+static BaroAltitude f;
+
+// Pressure at a height above GROUND_PA (inverse of the ISA formula)
+static float pressureAt(float h) {
+    return GROUND_PA * powf(1.0f - h / 44330.0f, 1.0f / 0.190263f);
+}
+
+static float noise(float amplitude) {
+    return amplitude * (2.0f * rand() / (float)RAND_MAX - 1.0f);
+}
+
+static void settleGround(void) {
+    for (int i = 0; i < BARO_ALT_GROUND_SAMPLES; i++)
+        BaroAltitude_updateBaro(&f, GROUND_PA);
+}
+
+void setUp(void) {
+    srand(1);
+    BaroAltitude_init(&f, BARO_ALT_TIME_CONST_S);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Conversion Tests
+// ============================================================================
+
+void test_pressure_altitude(void) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, BaroAltitude_pressureAltitude(GROUND_PA, GROUND_PA));
+    // ~12 Pa per metre near sea level
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 10.0f, BaroAltitude_pressureAltitude(GROUND_PA - 120.1f, GROUND_PA));
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1000.0f, BaroAltitude_pressureAltitude(pressureAt(1000.0f), GROUND_PA));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, BaroAltitude_pressureAltitude(0.0f, GROUND_PA));
+}
+
+void test_ground_reference(void) {
+    for (int i = 0; i < BARO_ALT_GROUND_SAMPLES - 1; i++) {
+        BaroAltitude_updateBaro(&f, GROUND_PA + (i & 1 ? 6.0f : -6.0f));
+        TEST_ASSERT_FALSE(BaroAltitude_isReady(&f));
+    }
+    BaroAltitude_updateBaro(&f, GROUND_PA + 6.0f);
+    TEST_ASSERT_TRUE(BaroAltitude_isReady(&f));
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, GROUND_PA, f.groundPa);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, f.altitude);     // Starts on the reference
+}
+
+void test_zero_takes_new_reference(void) {
+    settleGround();
+    for (int i = 0; i < 1000; i++) {
+        BaroAltitude_updateBaro(&f, pressureAt(5.0f));
+        BaroAltitude_predict(&f, 0.0f, DT);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 5.0f, f.altitude);
+
+    BaroAltitude_zero(&f);
+    TEST_ASSERT_FALSE(BaroAltitude_isReady(&f));
+    for (int i = 0; i < BARO_ALT_GROUND_SAMPLES; i++)
+        BaroAltitude_updateBaro(&f, pressureAt(5.0f));
+    TEST_ASSERT_TRUE(BaroAltitude_isReady(&f));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, f.altitude);
+}
+
+// ============================================================================
+// Filter Tests
+// ============================================================================
+
+void test_no_prediction_before_ready(void) {
+    BaroAltitude_predict(&f, 5.0f, DT);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, f.altitude);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, f.climbRate);
+}
+
+void test_learns_accel_bias(void) {
+    // Standing still, accelerometer reads 0.3 m/s^2 up
+    settleGround();
+    for (int i = 0; i < 3000; i++) {
+        if (i % 2 == 0) BaroAltitude_updateBaro(&f, GROUND_PA);
+        BaroAltitude_predict(&f, 0.3f, DT);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -0.3f, f.accelBias);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.0f, f.altitude);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, f.climbRate);
+}
+
+void test_bias_bounded(void) {
+    settleGround();
+    for (int i = 0; i < 3000; i++) {
+        BaroAltitude_updateBaro(&f, GROUND_PA);
+        BaroAltitude_predict(&f, 9.0f, DT);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -BARO_ALT_MAX_BIAS, f.accelBias);
+}
+
+void test_tracks_climb_through_noise(void) {
+    // 10 s: accelerate to 2 m/s, climb, stop. Baro at 50 Hz with 30 cm of
+    // noise, accelerometer biased 0.2 m/s^2 with 0.5 m/s^2 of vibration
+    settleGround();
+    for (int i = 0; i < 500; i++) {
+        BaroAltitude_updateBaro(&f, GROUND_PA);
+        BaroAltitude_predict(&f, 0.2f + noise(0.5f), DT);
+    }
+
+    float h = 0.0f, v = 0.0f, worstH = 0.0f, worstV = 0.0f;
+    for (int i = 0; i < 500; i++) {
+        float t = i * DT;
+        float a = t < 1.0f ? 2.0f : (t >= 4.0f && t < 5.0f ? -2.0f : 0.0f);
+        h += (v + 0.5f * a * DT) * DT;
+        v += a * DT;
+        BaroAltitude_updateBaro(&f, pressureAt(h + noise(0.3f)));
+        BaroAltitude_predict(&f, a + 0.2f + noise(0.5f), DT);
+        if (t > 1.0f) {
+            worstH = fmaxf(worstH, fabsf(f.altitude - h));
+            worstV = fmaxf(worstV, fabsf(f.climbRate - v));
+        }
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 8.0f, h);
+    TEST_ASSERT_TRUE(worstH < 0.3f);     // Smoother than the baro itself
+    TEST_ASSERT_TRUE(worstV < 0.3f);
+}
+
+void test_climb_rate_leads_baro(void) {
+    // A step in vertical speed shows in the climb rate within a tick or
+    // two, long before the barometer has moved far enough to see it
+    settleGround();
+    for (int i = 0; i < 100; i++) {
+        BaroAltitude_updateBaro(&f, GROUND_PA);
+        BaroAltitude_predict(&f, 0.0f, DT);
+    }
+    for (int i = 0; i < 5; i++) BaroAltitude_predict(&f, 10.0f, DT);    // 0.1 s kick
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1.0f, f.climbRate);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Conversion Tests
+    RUN_TEST(test_pressure_altitude);
+    RUN_TEST(test_ground_reference);
+    RUN_TEST(test_zero_takes_new_reference);
+
+    // Filter Tests
+    RUN_TEST(test_no_prediction_before_ready);
+    RUN_TEST(test_learns_accel_bias);
+    RUN_TEST(test_bias_bounded);
+    RUN_TEST(test_tracks_climb_through_noise);
+    RUN_TEST(test_climb_rate_leads_baro);
+
+    return UNITY_END();
+}
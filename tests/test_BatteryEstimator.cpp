@@ -0,0 +1,136 @@
+/**
+ * Unit Tests for BatteryEstimator
+ * Tests the LiPo curve, sag learning, RTL hysteresis and time remaining
+ *
+ * @file test_BatteryEstimator.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "BatteryEstimator.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define STEP_MS 100     // BatteryManager block rate
+
+static BatteryEstimator est;
+static uint32_t nowMs;
+
+/**
+ * Run the estimator against a pack with a resting voltage and sag
+ */
+static void run(float ocvMv, float sagMv, float load, uint32_t durationMs) {
+    for (uint32_t t = 0; t < durationMs; t += STEP_MS) {
+        BatteryEstimator_update(&est, ocvMv - sagMv * load, load, nowMs);
+        nowMs += STEP_MS;
+    }
+}
+
+void setUp(void) {
+    BatteryEstimator_init(&est, 1);
+    nowMs = 1000;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Discharge Curve Tests
+// ============================================================================
+
+void test_curve_endpoints_and_interpolation(void) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, BatteryEstimator_socFromCellMv(3000.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 100.0f, BatteryEstimator_socFromCellMv(4300.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 50.0f, BatteryEstimator_socFromCellMv(3840.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 55.0f, BatteryEstimator_socFromCellMv(3855.0f));
+}
+
+// ============================================================================
+// Sag Compensation Tests
+// ============================================================================
+
+void test_learns_sag_from_throttle_changes(void) {
+    // Throttle steps between 0 and 2 motors' worth every 2 s
+    for (int i = 0; i < 30; i++) {
+        run(3900.0f, 300.0f, (i & 1) ? 2.0f : 0.0f, 2000);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(30.0f, 300.0f, est.sagMv);
+    TEST_ASSERT_FLOAT_WITHIN(20.0f, 3900.0f, est.ocvMv);
+}
+
+void test_throttle_punch_does_not_trigger_rtl(void) {
+    for (int i = 0; i < 30; i++) {
+        run(3870.0f, 300.0f, (i & 1) ? 1.0f : 0.0f, 2000);
+    }
+    // 2 s punch: loaded voltage 3270 mV, far below the old 3400 mV trigger
+    run(3870.0f, 300.0f, 2.0f, 2000);
+    TEST_ASSERT_FALSE(BatteryEstimator_rtlRequired(&est));
+    TEST_ASSERT_TRUE(BatteryEstimator_getPercent(&est) > 40);
+}
+
+// ============================================================================
+// RTL Decision Tests
+// ============================================================================
+
+void test_sustained_low_triggers_after_hold(void) {
+    run(3850.0f, 0.0f, 0.0f, 2000);
+    run(3600.0f, 0.0f, 0.0f, 2000);
+    TEST_ASSERT_FALSE(BatteryEstimator_rtlRequired(&est));
+    run(3600.0f, 0.0f, 0.0f, 30000);
+    TEST_ASSERT_TRUE(BatteryEstimator_rtlRequired(&est));
+}
+
+void test_rtl_hysteresis(void) {
+    run(3600.0f, 0.0f, 0.0f, 30000);
+    TEST_ASSERT_TRUE(BatteryEstimator_rtlRequired(&est));
+
+    // Resting recovery to ~12 % is inside the band: stays latched
+    run(3698.0f, 0.0f, 0.0f, 30000);
+    TEST_ASSERT_TRUE(BatteryEstimator_rtlRequired(&est));
+
+    // Fresh pack: released
+    run(4150.0f, 0.0f, 0.0f, 30000);
+    TEST_ASSERT_FALSE(BatteryEstimator_rtlRequired(&est));
+}
+
+// ============================================================================
+// Time Remaining Tests
+// ============================================================================
+
+void test_remaining_time_from_discharge_rate(void) {
+    TEST_ASSERT_EQUAL_INT32(-1, BatteryEstimator_getRemainingSeconds(&est));
+
+    // 80 % -> 70 % in 100 s: 0.1 %/s, ~700 s left
+    run(4020.0f, 0.0f, 0.0f, 10000);
+    for (uint32_t t = 0; t < 100000; t += STEP_MS) {
+        BatteryEstimator_update(&est, 4020.0f - 70.0f * t / 100000.0f, 0.0f, nowMs);
+        nowMs += STEP_MS;
+    }
+    int32_t remaining = BatteryEstimator_getRemainingSeconds(&est);
+    TEST_ASSERT_TRUE(remaining > 600 && remaining < 800);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Discharge Curve Tests
+    RUN_TEST(test_curve_endpoints_and_interpolation);
+
+    // Sag Compensation Tests
+    RUN_TEST(test_learns_sag_from_throttle_changes);
+    RUN_TEST(test_throttle_punch_does_not_trigger_rtl);
+
+    // RTL Decision Tests
+    RUN_TEST(test_sustained_low_triggers_after_hold);
+    RUN_TEST(test_rtl_hysteresis);
+
+    // Time Remaining Tests
+    RUN_TEST(test_remaining_time_from_discharge_rate);
+
+    return UNITY_END();
+}
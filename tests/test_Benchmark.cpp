@@ -0,0 +1,159 @@
+/**
+ * Unit Tests for Benchmark
+ * Tests sample reduction (median / nearest-rank p99), the run harness,
+ * the JSON result line and budget checks
+ *
+ * @file test_Benchmark.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "Benchmark.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint32_t calls;
+
+static void countCalls(void* ctx) {
+    calls += *(uint32_t*)ctx;
+}
+
+void setUp(void) {
+    calls = 0;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Stats Tests
+// ============================================================================
+
+void test_stats_of_unsorted_samples(void) {
+    uint32_t samples[] = {50, 10, 40, 20, 30};
+    BenchStats stats;
+    Bench_computeStats(samples, 5, &stats);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.min);
+    TEST_ASSERT_EQUAL_UINT32(30, stats.median);
+    TEST_ASSERT_EQUAL_UINT32(50, stats.p99);
+    TEST_ASSERT_EQUAL_UINT32(50, stats.max);
+}
+
+void test_p99_ignores_one_outlier_in_a_hundred(void) {
+    uint32_t samples[100];
+    for (uint32_t i = 0; i < 100; i++) samples[i] = 100 + i % 3;
+    samples[37] = 90000;
+    BenchStats stats;
+    Bench_computeStats(samples, 100, &stats);
+    TEST_ASSERT_EQUAL_UINT32(102, stats.p99);
+    TEST_ASSERT_EQUAL_UINT32(90000, stats.max);
+    TEST_ASSERT_EQUAL_UINT32(101, stats.median);
+}
+
+void test_no_samples_gives_zero_stats(void) {
+    BenchStats stats;
+    stats.max = 7;
+    Bench_computeStats(NULL, 0, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.max);
+}
+
+// ============================================================================
+// Run Tests
+// ============================================================================
+
+void test_run_warms_up_then_times_each_call(void) {
+    uint32_t step = 1;
+    BenchStats stats;
+    TEST_ASSERT_TRUE(Bench_run(countCalls, &step, 50, &stats));
+    TEST_ASSERT_EQUAL_UINT32(51, calls);
+    TEST_ASSERT_EQUAL_UINT32(50, stats.count);
+    TEST_ASSERT_TRUE(stats.min <= stats.median);
+    TEST_ASSERT_TRUE(stats.median <= stats.p99);
+    TEST_ASSERT_TRUE(stats.p99 <= stats.max);
+}
+
+void test_run_rejects_bad_iterations(void) {
+    uint32_t step = 1;
+    BenchStats stats;
+    TEST_ASSERT_FALSE(Bench_run(countCalls, &step, 0, &stats));
+    TEST_ASSERT_FALSE(Bench_run(countCalls, &step, BENCH_MAX_SAMPLES + 1, &stats));
+    TEST_ASSERT_FALSE(Bench_run(NULL, &step, 10, &stats));
+    TEST_ASSERT_EQUAL_UINT32(0, calls);
+}
+
+// ============================================================================
+// JSON Tests
+// ============================================================================
+
+void test_json_line(void) {
+    BenchStats stats = {1000, 412, 418, 440, 2210};
+    char line[160];
+    size_t len = Bench_formatJson("crc16", &stats, 240, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("{\"bench\":\"crc16\",\"n\":1000,\"min\":412,\"med\":418,"
+                             "\"p99\":440,\"max\":2210,\"med_us\":1.741}", line);
+    TEST_ASSERT_EQUAL(strlen(line), len);
+}
+
+void test_json_rejects_small_buffer(void) {
+    BenchStats stats = {1, 1, 1, 1, 1};
+    char line[16];
+    TEST_ASSERT_EQUAL(0, Bench_formatJson("crc16", &stats, 240, line, sizeof(line)));
+}
+
+// ============================================================================
+// Budget Tests
+// ============================================================================
+
+void test_budget_allows_margin(void) {
+    // Median 1200 cycles at 240 MHz = 5 us
+    BenchStats stats = {100, 1000, 1200, 1500, 3000};
+    TEST_ASSERT_TRUE(Bench_withinBudget(&stats, 240, 5000, 25));
+    TEST_ASSERT_TRUE(Bench_withinBudget(&stats, 240, 4000, 25));
+    TEST_ASSERT_FALSE(Bench_withinBudget(&stats, 240, 3999, 25));
+    // Margin 0: check off
+    TEST_ASSERT_TRUE(Bench_withinBudget(&stats, 240, 1, 0));
+}
+
+void test_check_budget_reports_line(void) {
+    uint32_t step = 1;
+    char msg[BENCH_LINE_MAX];
+    TEST_ASSERT_TRUE(Bench_checkBudget("count", countCalls, &step, 20, 1000000, msg,
+                                       sizeof(msg)));
+    TEST_ASSERT_EQUAL_UINT32(21, calls);
+    TEST_ASSERT_NOT_NULL(strstr(msg, "{\"bench\":\"count\",\"n\":20,"));
+    TEST_ASSERT_NOT_NULL(strstr(msg, ",\"budget_us\":1000.000}"));
+
+    TEST_ASSERT_FALSE(Bench_checkBudget("count", countCalls, &step, 0, 1000000, msg,
+                                        sizeof(msg)));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Stats Tests
+    RUN_TEST(test_stats_of_unsorted_samples);
+    RUN_TEST(test_p99_ignores_one_outlier_in_a_hundred);
+    RUN_TEST(test_no_samples_gives_zero_stats);
+
+    // Run Tests
+    RUN_TEST(test_run_warms_up_then_times_each_call);
+    RUN_TEST(test_run_rejects_bad_iterations);
+
+    // JSON Tests
+    RUN_TEST(test_json_line);
+    RUN_TEST(test_json_rejects_small_buffer);
+
+    // Budget Tests
+    RUN_TEST(test_budget_allows_margin);
+    RUN_TEST(test_check_budget_reports_line);
+
+    return UNITY_END();
+}
@@ -0,0 +1,257 @@
+/**
+ * Unit Tests for BiquadFilter
+ * Tests the low-pass and notch designs through their response, block
+ * filtering against frame-by-frame filtering, channel independence, the
+ * steady-state seed, the fixed-point cascade against the float one and
+ * chain configuration limits
+ *
+ * @file test_BiquadFilter.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "BiquadFilter.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define FS 1000.0f
+#define TWO_PI_F 6.28318531f
+
+static BiquadCascade cascade;
+
+// Steady-state amplitude of a sine through one channel of the cascade
+static float sineAmplitude(BiquadCascade* f, float freqHz) {
+    float peak = 0.0f;
+    for (int i = 0; i < 2000; i++) {
+        float x = sinf(TWO_PI_F * freqHz * (float)i / FS);
+        BiquadCascade_apply(f, &x);
+        if (i >= 1000 && fabsf(x) > peak) peak = fabsf(x);
+    }
+    return peak;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Design Tests
+// ============================================================================
+
+void test_lowpass_response(void) {
+    BiquadCoefs c;
+    TEST_ASSERT_TRUE(Biquad_lowpass(&c, 100.0f, FS, BIQUAD_Q_BUTTERWORTH));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, Biquad_gain(&c, 0.0f, FS));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.7071f, Biquad_gain(&c, 100.0f, FS));   // -3 dB
+    TEST_ASSERT_TRUE(Biquad_gain(&c, 400.0f, FS) < 0.05f);
+}
+
+void test_notch_response(void) {
+    BiquadCoefs c;
+    TEST_ASSERT_TRUE(Biquad_notch(&c, 150.0f, FS, 5.0f));
+    TEST_ASSERT_TRUE(Biquad_gain(&c, 150.0f, FS) < 1e-3f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, Biquad_gain(&c, 0.0f, FS));
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 1.0f, Biquad_gain(&c, 50.0f, FS));
+
+    BiquadCascade_init(&cascade, 1);
+    BiquadCascade_addStage(&cascade, &c);
+    TEST_ASSERT_TRUE(sineAmplitude(&cascade, 150.0f) < 0.01f);
+}
+
+void test_invalid_corner_passes_through(void) {
+    BiquadCoefs c;
+    TEST_ASSERT_FALSE(Biquad_lowpass(&c, 600.0f, FS, BIQUAD_Q_BUTTERWORTH));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, c.b0);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.a1);
+    TEST_ASSERT_FALSE(Biquad_notch(&c, 0.0f, FS, 5.0f));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, c.b0);
+}
+
+// ============================================================================
+// Cascade Tests
+// ============================================================================
+
+void test_block_matches_frames(void) {
+    BiquadChainConfig config;
+    BiquadChain_defaultConfig(&config);
+    config.lowpassHz = 80.0f;
+    config.lowpassStages = 2;
+    config.notchHz = 200.0f;
+
+    float block[25][3], frames[25][3];
+    for (int i = 0; i < 25; i++)
+        for (int ch = 0; ch < 3; ch++)
+            block[i][ch] = frames[i][ch] = (float)((i * 7 + ch * 3) % 13) - 6.0f;
+
+    BiquadCascade byBlock, byFrame;
+    BiquadChain_build(&byBlock, &config, FS, 3);
+    BiquadChain_build(&byFrame, &config, FS, 3);
+    TEST_ASSERT_EQUAL_UINT8(3, byBlock.stages);
+
+    BiquadCascade_applyBlock(&byBlock, &block[0][0], 10);     // Bursts of 10 and 15
+    BiquadCascade_applyBlock(&byBlock, &block[10][0], 15);
+    for (int i = 0; i < 25; i++) BiquadCascade_apply(&byFrame, frames[i]);
+
+    for (int i = 0; i < 25; i++)
+        for (int ch = 0; ch < 3; ch++)
+            TEST_ASSERT_FLOAT_WITHIN(1e-5f, frames[i][ch], block[i][ch]);
+}
+
+void test_channels_are_independent(void) {
+    BiquadCoefs c;
+    Biquad_lowpass(&c, 50.0f, FS, BIQUAD_Q_BUTTERWORTH);
+    BiquadCascade_init(&cascade, 3);
+    BiquadCascade_addStage(&cascade, &c);
+
+    float frames[50][3];
+    for (int i = 0; i < 50; i++) {
+        frames[i][0] = 0.0f;
+        frames[i][1] = 10.0f;
+        frames[i][2] = 0.0f;
+    }
+    BiquadCascade_applyBlock(&cascade, &frames[0][0], 50);
+    for (int i = 0; i < 50; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, frames[i][0]);
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, frames[i][2]);
+    }
+    TEST_ASSERT_TRUE(frames[49][1] > 5.0f);
+}
+
+void test_settle_starts_at_steady_state(void) {
+    BiquadChainConfig config;
+    BiquadChain_defaultConfig(&config);
+    config.lowpassHz = 30.0f;
+    config.lowpassStages = 2;
+    config.notchHz = 120.0f;
+    BiquadChain_build(&cascade, &config, FS, 3);
+
+    const float level[3] = {1.5f, -20.0f, 300.0f};
+    BiquadCascade_settle(&cascade, level);
+    for (int i = 0; i < 5; i++) {
+        float frame[3] = {level[0], level[1], level[2]};
+        BiquadCascade_apply(&cascade, frame);
+        for (int ch = 0; ch < 3; ch++)
+            TEST_ASSERT_FLOAT_WITHIN(fabsf(level[ch]) * 1e-4f, level[ch], frame[ch]);
+    }
+}
+
+void test_cascade_full(void) {
+    BiquadCoefs c;
+    Biquad_passthrough(&c);
+    BiquadCascade_init(&cascade, 1);
+    for (int i = 0; i < BIQUAD_MAX_STAGES; i++)
+        TEST_ASSERT_TRUE(BiquadCascade_addStage(&cascade, &c));
+    TEST_ASSERT_FALSE(BiquadCascade_addStage(&cascade, &c));
+    TEST_ASSERT_FALSE(BiquadCascade_setStage(&cascade, BIQUAD_MAX_STAGES, &c));
+}
+
+// ============================================================================
+// Fixed-Point Tests
+// ============================================================================
+
+void test_fixed_matches_float(void) {
+    BiquadCoefs lp, notch;
+    Biquad_lowpass(&lp, 80.0f, FS, BIQUAD_Q_BUTTERWORTH);
+    Biquad_notch(&notch, 200.0f, FS, 3.0f);
+
+    BiquadCascadeQ fixed;
+    BiquadCascadeQ_init(&fixed, 3);
+    BiquadCascadeQ_addStage(&fixed, &lp);
+    BiquadCascadeQ_addStage(&fixed, &notch);
+    BiquadCascade_init(&cascade, 3);
+    BiquadCascade_addStage(&cascade, &lp);
+    BiquadCascade_addStage(&cascade, &notch);
+
+    // Raw gyro counts, full 16-bit range
+    int32_t q[300][3];
+    float f[300][3];
+    for (int i = 0; i < 300; i++) {
+        for (int ch = 0; ch < 3; ch++) {
+            float v = 30000.0f * sinf(TWO_PI_F * (20.0f + 70.0f * ch) * (float)i / FS);
+            q[i][ch] = (int32_t)lrintf(v);
+            f[i][ch] = (float)q[i][ch];
+        }
+    }
+    for (int i = 0; i < 300; i += 10) {
+        BiquadCascadeQ_applyBlock(&fixed, q[i], 10);
+        BiquadCascade_applyBlock(&cascade, f[i], 10);
+    }
+    // Output rounding circulates through the poles: a few counts of 30000
+    for (int i = 0; i < 300; i++)
+        for (int ch = 0; ch < 3; ch++)
+            TEST_ASSERT_FLOAT_WITHIN(4.0f, f[i][ch], (float)q[i][ch]);
+}
+
+void test_fixed_coefficients(void) {
+    BiquadCoefs c = {1.0f, -1.5f, 0.25f, -1.9f, 0.9f};
+    BiquadCoefsQ q;
+    Biquad_toFixed(&c, &q);
+    TEST_ASSERT_EQUAL_INT32(1 << BIQUAD_FRAC_BITS, q.b0);
+    TEST_ASSERT_EQUAL_INT32(-3 << (BIQUAD_FRAC_BITS - 1), q.b1);
+    TEST_ASSERT_EQUAL_INT32(1 << (BIQUAD_FRAC_BITS - 2), q.b2);
+    TEST_ASSERT_INT_WITHIN(1, (int32_t)(c.a1 * (float)(1 << BIQUAD_FRAC_BITS)), q.a1);
+}
+
+// ============================================================================
+// Configuration Tests
+// ============================================================================
+
+void test_default_config_is_empty(void) {
+    BiquadChainConfig config;
+    BiquadChain_defaultConfig(&config);
+    BiquadChain_build(&cascade, &config, FS, 3);
+    TEST_ASSERT_EQUAL_UINT8(0, cascade.stages);
+
+    float frame[3] = {1.0f, 2.0f, 3.0f};
+    BiquadCascade_apply(&cascade, frame);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, frame[1]);
+}
+
+void test_sanitize(void) {
+    BiquadChainConfig config = {NAN, 0, 900.0f, 100.0f};
+    BiquadChain_sanitize(&config, FS);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, config.lowpassHz);
+    TEST_ASSERT_EQUAL_UINT8(1, config.lowpassStages);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 450.0f, config.notchHz);
+    TEST_ASSERT_EQUAL_FLOAT(BIQUAD_MAX_NOTCH_Q, config.notchQ);
+
+    config = (BiquadChainConfig){-5.0f, 9, 0.0f, NAN};
+    BiquadChain_sanitize(&config, FS);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, config.lowpassHz);
+    TEST_ASSERT_EQUAL_UINT8(BIQUAD_MAX_LOWPASS_STAGES, config.lowpassStages);
+    TEST_ASSERT_EQUAL_FLOAT(BIQUAD_MIN_NOTCH_Q, config.notchQ);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Design Tests
+    RUN_TEST(test_lowpass_response);
+    RUN_TEST(test_notch_response);
+    RUN_TEST(test_invalid_corner_passes_through);
+
+    // Cascade Tests
+    RUN_TEST(test_block_matches_frames);
+    RUN_TEST(test_channels_are_independent);
+    RUN_TEST(test_settle_starts_at_steady_state);
+    RUN_TEST(test_cascade_full);
+
+    // Fixed-Point Tests
+    RUN_TEST(test_fixed_matches_float);
+    RUN_TEST(test_fixed_coefficients);
+
+    // Configuration Tests
+    RUN_TEST(test_default_config_is_empty);
+    RUN_TEST(test_sanitize);
+
+    return UNITY_END();
+}
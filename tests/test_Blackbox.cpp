@@ -0,0 +1,246 @@
+/**
+ * Unit Tests for Blackbox
+ * Tests the sector format: schema table against the record layout,
+ * record packing, packed blocks, sealing / validation and the head scan
+ *
+ * @file test_Blackbox.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "Blackbox.h"
+#include "BlackboxCodec.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t sector[BLACKBOX_SECTOR_SIZE];
+
+static BlackboxRecord makeRecord(uint32_t i) {
+    BlackboxRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.timeMs = 1000 + i * 20;
+    rec.sequence = i;
+    rec.throttle = (int16_t)(i * 3);
+    rec.outputs[2] = 55;
+    rec.battery = 11870;
+    return rec;
+}
+
+static BlackboxSectorHeader headerAt(uint32_t sequence, uint16_t session) {
+    BlackboxSectorHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = BLACKBOX_MAGIC;
+    h.version = BLACKBOX_VERSION;
+    h.sequence = sequence;
+    h.session = session;
+    return h;
+}
+
+void setUp(void) {
+    memset(sector, 0, sizeof(sector));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Schema Tests
+// ============================================================================
+
+void test_schema_covers_the_record(void) {
+    uint8_t count = 0;
+    const BlackboxField* fields = Blackbox_getSchema(&count);
+    size_t bytes = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        TEST_ASSERT_NOT_EQUAL(0, Blackbox_typeSize(fields[i].type));
+        TEST_ASSERT_TRUE(strlen(fields[i].name) < BLACKBOX_FIELD_NAME_LEN);
+        bytes += Blackbox_typeSize(fields[i].type) * fields[i].count;
+    }
+    TEST_ASSERT_EQUAL(sizeof(BlackboxRecord), bytes);
+}
+
+void test_schema_sector_checks(void) {
+    Blackbox_writeSchema(sector, 3, 10);
+    Blackbox_sealSector(sector);
+    BlackboxSectorHeader h;
+    TEST_ASSERT_TRUE(Blackbox_checkSector(sector, &h));
+    TEST_ASSERT_EQUAL(BLACKBOX_KIND_SCHEMA, h.kind);
+    TEST_ASSERT_EQUAL_UINT16(3, h.session);
+    uint8_t count;
+    Blackbox_getSchema(&count);
+    TEST_ASSERT_EQUAL(count, h.count);
+    TEST_ASSERT_EQUAL_STRING("time_ms", (const char*)(sector + sizeof(h)));
+}
+
+// ============================================================================
+// Data Sector Tests
+// ============================================================================
+
+void test_records_fill_a_sector(void) {
+    Blackbox_startSector(sector, BLACKBOX_KIND_DATA, 1, 0);
+    uint32_t n = 0;
+    while (true) {
+        BlackboxRecord rec = makeRecord(n);
+        if (!Blackbox_appendRecord(sector, &rec)) break;
+        n++;
+    }
+    TEST_ASSERT_EQUAL(BLACKBOX_RECORDS_PER_SECTOR, n);
+    TEST_ASSERT_EQUAL(55, n);
+    // Schema sectors take no records
+    uint8_t other[BLACKBOX_SECTOR_SIZE];
+    Blackbox_writeSchema(other, 1, 0);
+    BlackboxRecord rec = makeRecord(0);
+    TEST_ASSERT_FALSE(Blackbox_appendRecord(other, &rec));
+}
+
+void test_sealed_sector_round_trip(void) {
+    Blackbox_startSector(sector, BLACKBOX_KIND_DATA, 2, 77);
+    for (uint32_t i = 0; i < 5; i++) {
+        BlackboxRecord rec = makeRecord(i);
+        Blackbox_appendRecord(sector, &rec);
+    }
+    Blackbox_sealSector(sector);
+
+    BlackboxSectorHeader h;
+    TEST_ASSERT_TRUE(Blackbox_checkSector(sector, &h));
+    TEST_ASSERT_EQUAL_UINT32(77, h.sequence);
+    TEST_ASSERT_EQUAL(5, h.count);
+    TEST_ASSERT_EQUAL(sizeof(BlackboxRecord), h.recordSize);
+
+    const BlackboxRecord* rec = Blackbox_sectorRecord(sector, 4);
+    TEST_ASSERT_NOT_NULL(rec);
+    TEST_ASSERT_EQUAL_UINT32(1080, rec->timeMs);
+    TEST_ASSERT_EQUAL_INT16(12, rec->throttle);
+    TEST_ASSERT_EQUAL_UINT8(55, rec->outputs[2]);
+    TEST_ASSERT_NULL(Blackbox_sectorRecord(sector, 5));
+    // Unused space stays erased
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sector[BLACKBOX_SECTOR_SIZE - 1]);
+}
+
+void test_damaged_sector_rejected(void) {
+    Blackbox_startSector(sector, BLACKBOX_KIND_DATA, 2, 1);
+    BlackboxRecord rec = makeRecord(1);
+    Blackbox_appendRecord(sector, &rec);
+    Blackbox_sealSector(sector);
+    sector[sizeof(BlackboxSectorHeader) + 3] ^= 0x10;
+    TEST_ASSERT_FALSE(Blackbox_checkSector(sector, NULL));
+
+    // Erased flash and unsealed images are not sectors
+    memset(sector, 0xFF, sizeof(sector));
+    TEST_ASSERT_FALSE(Blackbox_checkSector(sector, NULL));
+}
+
+// ============================================================================
+// Packed Sector Tests
+// ============================================================================
+
+void test_packed_sector_round_trip(void) {
+    static BlackboxCodec codec;
+    Blackbox_startPacked(sector, &codec, 2, 78);
+    uint32_t n = 0;
+    while (true) {
+        BlackboxRecord rec = makeRecord(n);
+        if (!Blackbox_appendPacked(sector, &codec, &rec)) break;
+        n++;
+    }
+    TEST_ASSERT_TRUE(n > 4 * BLACKBOX_RECORDS_PER_SECTOR);
+    Blackbox_sealSector(sector);
+
+    BlackboxSectorHeader h;
+    TEST_ASSERT_TRUE(Blackbox_checkSector(sector, &h));
+    TEST_ASSERT_EQUAL(BLACKBOX_KIND_PACKED, h.kind);
+    TEST_ASSERT_EQUAL(sizeof(BlackboxRecord), h.recordSize);
+    TEST_ASSERT_NULL(Blackbox_sectorRecord(sector, 0));
+
+    // Count and time span from the block header alone
+    uint16_t count;
+    uint32_t firstMs, lastMs;
+    TEST_ASSERT_TRUE(Blackbox_sectorSpan(sector, &count, &firstMs, &lastMs));
+    TEST_ASSERT_EQUAL_UINT16(n, count);
+    TEST_ASSERT_EQUAL_UINT32(1000, firstMs);
+    TEST_ASSERT_EQUAL_UINT32(1000 + (n - 1) * 20, lastMs);
+
+    TEST_ASSERT_TRUE(Blackbox_openPacked(sector, &codec));
+    BlackboxRecord out;
+    for (uint32_t i = 0; i < n; i++) {
+        BlackboxRecord expected = makeRecord(i);
+        TEST_ASSERT_TRUE(BlackboxCodec_next(&codec, (uint8_t*)&out));
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &out, sizeof(out));
+    }
+    TEST_ASSERT_FALSE(BlackboxCodec_next(&codec, (uint8_t*)&out));
+
+    // Bit stream damage fails the CRC like any other sector
+    sector[sizeof(BlackboxSectorHeader) + sizeof(BlackboxBlockHeader) + 5] ^= 0x01;
+    TEST_ASSERT_FALSE(Blackbox_checkSector(sector, NULL));
+}
+
+void test_packed_sector_takes_no_raw_records(void) {
+    static BlackboxCodec codec;
+    BlackboxRecord rec = makeRecord(0);
+    Blackbox_startPacked(sector, &codec, 1, 0);
+    TEST_ASSERT_FALSE(Blackbox_appendRecord(sector, &rec));
+    Blackbox_startSector(sector, BLACKBOX_KIND_DATA, 1, 0);
+    TEST_ASSERT_FALSE(Blackbox_appendPacked(sector, &codec, &rec));
+
+    // An empty block has no span
+    uint16_t count;
+    uint32_t firstMs, lastMs;
+    Blackbox_startPacked(sector, &codec, 1, 0);
+    TEST_ASSERT_FALSE(Blackbox_sectorSpan(sector, &count, &firstMs, &lastMs));
+}
+
+// ============================================================================
+// Scan Tests
+// ============================================================================
+
+void test_scan_finds_newest_sector(void) {
+    BlackboxScan scan = {};
+    // Circular log: the head wrapped, so the newest is in the middle
+    uint32_t sequences[] = {400, 401, 402, 303, 304, 305};
+    for (uint16_t i = 0; i < 6; i++) {
+        BlackboxSectorHeader h = headerAt(sequences[i], sequences[i] >= 400 ? 9 : 8);
+        Blackbox_scan(&scan, i, &h);
+    }
+    TEST_ASSERT_TRUE(scan.found);
+    TEST_ASSERT_EQUAL_UINT16(2, scan.index);
+    TEST_ASSERT_EQUAL_UINT32(402, scan.sequence);
+    TEST_ASSERT_EQUAL_UINT16(9, scan.session);
+}
+
+void test_scan_skips_erased_headers(void) {
+    BlackboxScan scan = {};
+    BlackboxSectorHeader erased;
+    memset(&erased, 0xFF, sizeof(erased));
+    Blackbox_scan(&scan, 0, &erased);
+    Blackbox_scan(&scan, 1, NULL);
+    TEST_ASSERT_FALSE(scan.found);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Schema Tests
+    RUN_TEST(test_schema_covers_the_record);
+    RUN_TEST(test_schema_sector_checks);
+
+    // Data Sector Tests
+    RUN_TEST(test_records_fill_a_sector);
+    RUN_TEST(test_sealed_sector_round_trip);
+    RUN_TEST(test_damaged_sector_rejected);
+
+    // Packed Sector Tests
+    RUN_TEST(test_packed_sector_round_trip);
+    RUN_TEST(test_packed_sector_takes_no_raw_records);
+
+    // Scan Tests
+    RUN_TEST(test_scan_finds_newest_sector);
+    RUN_TEST(test_scan_skips_erased_headers);
+
+    return UNITY_END();
+}
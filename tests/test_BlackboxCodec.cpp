@@ -0,0 +1,285 @@
+/**
+ * Unit Tests for BlackboxCodec
+ * Tests lossless round trips (flight records, bucket edges, wrapping,
+ * F32 XOR), the cost of steady values, block overflow rollback and the
+ * compression of a simulated flight against raw DATA sectors
+ *
+ * @file test_BlackboxCodec.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <math.h>
+#include "BlackboxCodec.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t block[BLACKBOX_BLOCK_CAPACITY];
+static BlackboxCodec enc;
+static BlackboxCodec dec;
+static const BlackboxField* schema;
+static uint8_t schemaCount;
+static uint32_t noise = 1;
+
+// Small deterministic noise, -amp..amp
+static int32_t jitter(int32_t amp) {
+    noise = noise * 1103515245u + 12345u;
+    return (int32_t)((noise >> 16) % (uint32_t)(2 * amp + 1)) - amp;
+}
+
+// Tick i of a rover-like flight: smooth sticks and attitude, noisy gyro
+static BlackboxRecord flightRecord(uint32_t i) {
+    BlackboxRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    float t = i * 0.02f;
+    rec.timeMs = 5000 + i * 20;
+    rec.sequence = 100 + i / 2;
+    rec.throttle = (int16_t)(600 + 200 * sinf(t * 0.5f));
+    rec.roll = (int16_t)(300 * sinf(t * 0.8f));
+    rec.pitch = (int16_t)(50 * cosf(t * 0.3f));
+    rec.mode = 0x04;
+    for (int k = 0; k < 4; k++)
+        rec.outputs[k] = (uint8_t)(50 + 20 * sinf(t * 0.5f + k));
+    rec.attRoll = (int16_t)(150 * sinf(t * 0.8f) + jitter(3));
+    rec.attPitch = (int16_t)(40 * cosf(t * 0.3f) + jitter(3));
+    rec.heading = (uint16_t)((uint32_t)(9000 + i * 3) % 36000);
+    rec.navDistance = (uint16_t)(1200 - i / 10);
+    rec.waypoint = 2;
+    rec.navFlags = BLACKBOX_NAV_MISSION;
+    rec.battery = (uint16_t)(11800 - i / 50 + jitter(2));
+    rec.loopUs = (uint16_t)(850 + jitter(40));
+    rec.timeSync = 2;
+    rec.utcS = 1760000000 + (5000 + i * 20) / 1000;
+    rec.utcMs = (uint16_t)((5000 + i * 20) % 1000);
+    rec.pilot[0] = rec.throttle;
+    rec.pilot[1] = rec.roll;
+    rec.pilot[2] = rec.pitch;
+    rec.pilotMode = rec.mode;
+    rec.linkAgeMs = (uint16_t)(10 + jitter(8));
+    rec.navLat = 137563210 + (int32_t)(i * 7);
+    rec.navLng = 1005012345 + (int32_t)(i * 5);
+    for (int k = 0; k < 3; k++)
+        rec.gyro[k] = (int16_t)(jitter(25) + (k == 2 ? 120 * sinf(t) : 0));
+    rec.inputs = BLACKBOX_IN_GPS | BLACKBOX_IN_ATTITUDE;
+    return rec;
+}
+
+// Encode records until the block is full; returns how many fit
+static uint32_t fillBlock(uint32_t first) {
+    if (!BlackboxCodec_begin(&enc, schema, schemaCount, block, sizeof(block)))
+        return 0;
+    uint32_t n = 0;
+    while (true) {
+        BlackboxRecord rec = flightRecord(first + n);
+        if (!BlackboxCodec_append(&enc, (const uint8_t*)&rec))
+            break;
+        n++;
+    }
+    return n;
+}
+
+void setUp(void) {
+    memset(block, 0xFF, sizeof(block));
+    schema = Blackbox_getSchema(&schemaCount);
+    noise = 1;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Round Trip Tests
+// ============================================================================
+
+void test_flight_block_round_trip(void) {
+    uint32_t n = fillBlock(0);
+    TEST_ASSERT_TRUE(n > 0);
+
+    noise = 1;
+    TEST_ASSERT_TRUE(BlackboxCodec_open(&dec, schema, schemaCount, block,
+                                        BlackboxCodec_size(&enc), enc.count));
+    TEST_ASSERT_EQUAL(sizeof(BlackboxRecord), dec.recordSize);
+    BlackboxRecord out;
+    for (uint32_t i = 0; i < n; i++) {
+        BlackboxRecord expected = flightRecord(i);
+        TEST_ASSERT_TRUE(BlackboxCodec_next(&dec, (uint8_t*)&out));
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &out, sizeof(out));
+    }
+    TEST_ASSERT_FALSE(BlackboxCodec_next(&dec, (uint8_t*)&out));
+}
+
+void test_bucket_edges_and_wrap(void) {
+    static const BlackboxField fields[] = {
+        {"t", BLACKBOX_TYPE_U32, 1}, {"a", BLACKBOX_TYPE_I16, 1},
+        {"b", BLACKBOX_TYPE_U8, 1},  {"c", BLACKBOX_TYPE_I32, 1},
+        {"d", BLACKBOX_TYPE_I8, 2},
+    };
+#pragma pack(push, 1)
+    struct Row { uint32_t t; int16_t a; uint8_t b; int32_t c; int8_t d[2]; };
+#pragma pack(pop)
+    static const Row rows[] = {
+        {0xFFFFFFF0u, 0, 0, 0, {0, 0}},
+        {0xFFFFFFF8u, 7, 255, 2147483647, {127, -128}},     // Clock wraps next
+        {0x00000000u, -8, 0, -2147483647 - 1, {-128, 127}},
+        {0x00000008u, 127, 16, 1, {0, 0}},
+        {0x00000010u, -128, 15, 0, {1, -1}},
+        {0x00000000u, 32767, 255, 65536, {0, 0}},           // Clock backwards
+        {0x12345678u, -32768, 1, -65536, {0, 0}},
+        {0x12345678u, -32768, 1, -65536, {0, 0}},
+    };
+    const int count = sizeof(rows) / sizeof(rows[0]);
+    TEST_ASSERT_TRUE(BlackboxCodec_begin(&enc, fields, 5, block, sizeof(block)));
+    for (int i = 0; i < count; i++)
+        TEST_ASSERT_TRUE(BlackboxCodec_append(&enc, (const uint8_t*)&rows[i]));
+
+    TEST_ASSERT_TRUE(BlackboxCodec_open(&dec, fields, 5, block, BlackboxCodec_size(&enc), count));
+    TEST_ASSERT_EQUAL(sizeof(Row), dec.recordSize);
+    Row out;
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(BlackboxCodec_next(&dec, (uint8_t*)&out));
+        TEST_ASSERT_EQUAL_MEMORY(&rows[i], &out, sizeof(out));
+    }
+}
+
+void test_float_xor_round_trip(void) {
+    static const BlackboxField fields[] = {
+        {"t", BLACKBOX_TYPE_U32, 1}, {"x", BLACKBOX_TYPE_F32, 2},
+    };
+#pragma pack(push, 1)
+    struct Row { uint32_t t; float x[2]; };
+#pragma pack(pop)
+    Row rows[200];
+    for (int i = 0; i < 200; i++) {
+        rows[i].t = (uint32_t)(i * 20);
+        rows[i].x[0] = 12.5f + 0.001f * sinf(i * 0.1f);
+        rows[i].x[1] = i < 100 ? -3.25f : -1e-20f * i;    // Steady, then far off
+    }
+    TEST_ASSERT_TRUE(BlackboxCodec_begin(&enc, fields, 2, block, sizeof(block)));
+    for (int i = 0; i < 200; i++)
+        TEST_ASSERT_TRUE(BlackboxCodec_append(&enc, (const uint8_t*)&rows[i]));
+    // Far less than the raw 12 bytes a row
+    TEST_ASSERT_TRUE(BlackboxCodec_size(&enc) < 200 * 12 / 2);
+
+    TEST_ASSERT_TRUE(BlackboxCodec_open(&dec, fields, 2, block, BlackboxCodec_size(&enc), 200));
+    Row out;
+    for (int i = 0; i < 200; i++) {
+        TEST_ASSERT_TRUE(BlackboxCodec_next(&dec, (uint8_t*)&out));
+        TEST_ASSERT_EQUAL_MEMORY(&rows[i], &out, sizeof(out));
+    }
+}
+
+// ============================================================================
+// Cost Tests
+// ============================================================================
+
+void test_steady_record_costs_a_bit_per_value(void) {
+    BlackboxRecord rec = flightRecord(0);
+    TEST_ASSERT_TRUE(BlackboxCodec_begin(&enc, schema, schemaCount, block, sizeof(block)));
+    TEST_ASSERT_TRUE(BlackboxCodec_append(&enc, (const uint8_t*)&rec));
+    rec.timeMs += 20;
+    TEST_ASSERT_TRUE(BlackboxCodec_append(&enc, (const uint8_t*)&rec));
+    uint32_t before = enc.bitPos;
+    rec.timeMs += 20;   // Same step: delta-of-delta 0
+    TEST_ASSERT_TRUE(BlackboxCodec_append(&enc, (const uint8_t*)&rec));
+    TEST_ASSERT_EQUAL_UINT32(enc.values, enc.bitPos - before);
+}
+
+void test_flight_compresses(void) {
+    // A DATA sector holds 55 records; a packed one about 230 moving
+    uint32_t packed = fillBlock(0);
+    TEST_ASSERT_TRUE(packed >= 3 * BLACKBOX_RECORDS_PER_SECTOR);
+
+    // Parked: nothing moves but the clock and the loop time (about 780)
+    TEST_ASSERT_TRUE(BlackboxCodec_begin(&enc, schema, schemaCount, block, sizeof(block)));
+    BlackboxRecord rec = flightRecord(0);
+    uint32_t idle = 0;
+    while (true) {
+        rec.timeMs += 20;
+        rec.loopUs = (uint16_t)(850 + jitter(3));
+        if (!BlackboxCodec_append(&enc, (const uint8_t*)&rec))
+            break;
+        idle++;
+    }
+    TEST_ASSERT_TRUE(idle >= 10 * BLACKBOX_RECORDS_PER_SECTOR);
+}
+
+// ============================================================================
+// Block Tests
+// ============================================================================
+
+void test_full_block_rolls_back(void) {
+    TEST_ASSERT_TRUE(BlackboxCodec_begin(&enc, schema, schemaCount, block, 96));
+    uint32_t n = 0;
+    BlackboxRecord rec;
+    while (true) {
+        rec = flightRecord(n);
+        if (!BlackboxCodec_append(&enc, (const uint8_t*)&rec))
+            break;
+        n++;
+    }
+    uint16_t size = BlackboxCodec_size(&enc);
+    TEST_ASSERT_TRUE(size <= 96);
+    TEST_ASSERT_EQUAL_UINT16(n, enc.count);
+    // The rejected record left nothing behind
+    for (uint16_t i = size; i < 96; i++)
+        TEST_ASSERT_EQUAL_HEX8(0xFF, block[i]);
+    if (enc.bitPos & 7)
+        TEST_ASSERT_EQUAL_HEX8(0, block[size - 1] & (0xFF >> (enc.bitPos & 7)));
+
+    // ...and the block still decodes in full
+    noise = 1;
+    TEST_ASSERT_TRUE(BlackboxCodec_open(&dec, schema, schemaCount, block, size, enc.count));
+    BlackboxRecord out;
+    for (uint32_t i = 0; i < n; i++) {
+        BlackboxRecord expected = flightRecord(i);
+        TEST_ASSERT_TRUE(BlackboxCodec_next(&dec, (uint8_t*)&out));
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &out, sizeof(out));
+    }
+}
+
+void test_truncated_block_stops(void) {
+    uint32_t n = fillBlock(0);
+    uint16_t size = BlackboxCodec_size(&enc);
+    TEST_ASSERT_TRUE(BlackboxCodec_open(&dec, schema, schemaCount, block, size / 2, enc.count));
+    BlackboxRecord out;
+    uint32_t decoded = 0;
+    while (BlackboxCodec_next(&dec, (uint8_t*)&out))
+        decoded++;
+    TEST_ASSERT_TRUE(decoded > 0);
+    TEST_ASSERT_TRUE(decoded < n);
+}
+
+void test_rejects_uncodable_schema(void) {
+    static const BlackboxField unknown[] = {{"t", BLACKBOX_TYPE_U32, 1}, {"q", 42, 1}};
+    static const BlackboxField wide[] = {{"t", BLACKBOX_TYPE_U32, 1},
+                                         {"v", BLACKBOX_TYPE_U8, BLACKBOX_CODEC_MAX_VALUES}};
+    TEST_ASSERT_FALSE(BlackboxCodec_begin(&enc, unknown, 2, block, sizeof(block)));
+    TEST_ASSERT_FALSE(BlackboxCodec_begin(&enc, wide, 2, block, sizeof(block)));
+    TEST_ASSERT_FALSE(BlackboxCodec_open(&dec, unknown, 2, block, sizeof(block), 1));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Round Trip Tests
+    RUN_TEST(test_flight_block_round_trip);
+    RUN_TEST(test_bucket_edges_and_wrap);
+    RUN_TEST(test_float_xor_round_trip);
+
+    // Cost Tests
+    RUN_TEST(test_steady_record_costs_a_bit_per_value);
+    RUN_TEST(test_flight_compresses);
+
+    // Block Tests
+    RUN_TEST(test_full_block_rolls_back);
+    RUN_TEST(test_truncated_block_stops);
+    RUN_TEST(test_rejects_uncodable_schema);
+
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+/**
+ * Unit Tests for BlackboxReader
+ * Tests the flight index over a wrapped partition image, flight byte
+ * offsets across the partition end and Range header parsing
+ *
+ * @file test_BlackboxReader.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "BlackboxReader.h"
+#include "BlackboxCodec.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define TEST_SECTORS 8
+
+static uint8_t partition[TEST_SECTORS * BLACKBOX_SECTOR_SIZE];
+static BlackboxIndex index_;
+
+static uint8_t* sectorAt(uint16_t i) {
+    return partition + (uint32_t)i * BLACKBOX_SECTOR_SIZE;
+}
+
+static void writeSchema(uint16_t i, uint16_t session, uint32_t sequence) {
+    Blackbox_writeSchema(sectorAt(i), session, sequence);
+    Blackbox_sealSector(sectorAt(i));
+}
+
+// Data sector with records timed startMs, startMs + 20, ...
+static void writeData(uint16_t i, uint16_t session, uint32_t sequence, uint32_t startMs,
+                      uint8_t records) {
+    Blackbox_startSector(sectorAt(i), BLACKBOX_KIND_DATA, session, sequence);
+    for (uint8_t r = 0; r < records; r++) {
+        BlackboxRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.timeMs = startMs + r * 20;
+        Blackbox_appendRecord(sectorAt(i), &rec);
+    }
+    Blackbox_sealSector(sectorAt(i));
+}
+
+// Packed sector with the same timing
+static void writePacked(uint16_t i, uint16_t session, uint32_t sequence, uint32_t startMs,
+                        uint16_t records) {
+    static BlackboxCodec codec;
+    Blackbox_startPacked(sectorAt(i), &codec, session, sequence);
+    for (uint16_t r = 0; r < records; r++) {
+        BlackboxRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.timeMs = startMs + r * 20;
+        Blackbox_appendPacked(sectorAt(i), &codec, &rec);
+    }
+    Blackbox_sealSector(sectorAt(i));
+}
+
+void setUp(void) {
+    memset(partition, 0xFF, sizeof(partition));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Index Tests
+// ============================================================================
+
+void test_empty_partition_has_no_flights(void) {
+    BlackboxReader_buildIndex(&index_, partition, TEST_SECTORS);
+    TEST_ASSERT_EQUAL(0, index_.count);
+    TEST_ASSERT_EQUAL_UINT16(TEST_SECTORS, index_.sectors);
+}
+
+void test_index_of_wrapped_partition(void) {
+    // Session 4 wrapped into sectors 0-1, sector 2 erased ahead,
+    // sectors 3-4 are what is left of session 3 (schema overwritten)
+    writeData(3, 3, 11, 5000, 10);
+    writeData(4, 3, 12, 5200, 5);
+    writeSchema(5, 4, 13);
+    writeData(6, 4, 14, 100, 55);
+    writeData(7, 4, 15, 1200, 55);
+    writeData(0, 4, 16, 2300, 55);
+    writeData(1, 4, 17, 3400, 3);
+
+    BlackboxReader_buildIndex(&index_, partition, TEST_SECTORS);
+    TEST_ASSERT_EQUAL(2, index_.count);
+
+    const BlackboxFlight* old = &index_.flights[0];
+    TEST_ASSERT_EQUAL_UINT16(3, old->session);
+    TEST_ASSERT_EQUAL_UINT16(3, old->firstSector);
+    TEST_ASSERT_EQUAL_UINT16(2, old->sectorCount);
+    TEST_ASSERT_FALSE(old->hasSchema);
+    TEST_ASSERT_EQUAL_UINT32(15, old->records);
+    TEST_ASSERT_EQUAL_UINT32(5000, old->startMs);
+    TEST_ASSERT_EQUAL_UINT32(5280, old->endMs);
+
+    const BlackboxFlight* cur = BlackboxReader_findFlight(&index_, 4);
+    TEST_ASSERT_NOT_NULL(cur);
+    TEST_ASSERT_EQUAL_UINT16(5, cur->firstSector);
+    TEST_ASSERT_EQUAL_UINT16(5, cur->sectorCount);
+    TEST_ASSERT_EQUAL_UINT32(13, cur->firstSequence);
+    TEST_ASSERT_TRUE(cur->hasSchema);
+    TEST_ASSERT_EQUAL_UINT32(168, cur->records);
+    TEST_ASSERT_EQUAL_UINT32(100, cur->startMs);
+    TEST_ASSERT_EQUAL_UINT32(3440, cur->endMs);
+
+    TEST_ASSERT_NULL(BlackboxReader_findFlight(&index_, 5));
+}
+
+void test_half_programmed_sector_not_listed(void) {
+    writeSchema(0, 1, 0);
+    writeData(1, 1, 1, 0, 55);
+    // Pages programmed but the header page not yet: still erased magic
+    writeData(2, 1, 2, 1100, 50);
+    memset(sectorAt(2), 0xFF, BLACKBOX_PAGE_SIZE);
+
+    BlackboxReader_buildIndex(&index_, partition, TEST_SECTORS);
+    TEST_ASSERT_EQUAL(1, index_.count);
+    TEST_ASSERT_EQUAL_UINT16(2, index_.flights[0].sectorCount);
+}
+
+void test_index_keeps_newest_flights(void) {
+    // One sector per boot, more boots than index slots
+    uint16_t sectors = BLACKBOX_MAX_FLIGHTS + 4;
+    static uint8_t big[(BLACKBOX_MAX_FLIGHTS + 4) * BLACKBOX_SECTOR_SIZE];
+    memset(big, 0xFF, sizeof(big));
+    for (uint16_t i = 0; i < sectors; i++) {
+        Blackbox_writeSchema(big + (uint32_t)i * BLACKBOX_SECTOR_SIZE, i + 1, i);
+        Blackbox_sealSector(big + (uint32_t)i * BLACKBOX_SECTOR_SIZE);
+    }
+    BlackboxReader_buildIndex(&index_, big, sectors);
+    TEST_ASSERT_EQUAL(BLACKBOX_MAX_FLIGHTS, index_.count);
+    TEST_ASSERT_EQUAL_UINT16(5, index_.flights[0].session);
+    TEST_ASSERT_EQUAL_UINT16(sectors, index_.flights[BLACKBOX_MAX_FLIGHTS - 1].session);
+}
+
+void test_index_of_packed_flight(void) {
+    // An older DATA sector, then packed ones of the same session
+    writeSchema(0, 2, 0);
+    writeData(1, 2, 1, 0, 55);
+    writePacked(2, 2, 2, 1100, 600);
+    writePacked(3, 2, 3, 13100, 7);
+
+    BlackboxReader_buildIndex(&index_, partition, TEST_SECTORS);
+    TEST_ASSERT_EQUAL(1, index_.count);
+    const BlackboxFlight* f = &index_.flights[0];
+    TEST_ASSERT_EQUAL_UINT16(4, f->sectorCount);
+    TEST_ASSERT_EQUAL_UINT32(662, f->records);
+    TEST_ASSERT_EQUAL_UINT32(0, f->startMs);
+    TEST_ASSERT_EQUAL_UINT32(13220, f->endMs);
+}
+
+// ============================================================================
+// Offset Tests
+// ============================================================================
+
+void test_flight_offset_wraps(void) {
+    BlackboxFlight f = {};
+    f.firstSector = 6;
+    f.sectorCount = 4;
+    TEST_ASSERT_EQUAL_UINT32(6 * BLACKBOX_SECTOR_SIZE + 10,
+                             BlackboxReader_flightOffset(&f, TEST_SECTORS, 10));
+    TEST_ASSERT_EQUAL_UINT32(7 * BLACKBOX_SECTOR_SIZE + BLACKBOX_SECTOR_SIZE - 1,
+                             BlackboxReader_flightOffset(&f, TEST_SECTORS, 2 * BLACKBOX_SECTOR_SIZE - 1));
+    TEST_ASSERT_EQUAL_UINT32(0, BlackboxReader_flightOffset(&f, TEST_SECTORS, 2 * BLACKBOX_SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(BLACKBOX_SECTOR_SIZE + 5,
+                             BlackboxReader_flightOffset(&f, TEST_SECTORS, 3 * BLACKBOX_SECTOR_SIZE + 5));
+}
+
+// ============================================================================
+// Range Tests
+// ============================================================================
+
+void test_range_forms(void) {
+    uint32_t first, last;
+    TEST_ASSERT_TRUE(BlackboxReader_parseRange("bytes=0-99", 1000, &first, &last));
+    TEST_ASSERT_EQUAL_UINT32(0, first);
+    TEST_ASSERT_EQUAL_UINT32(99, last);
+
+    TEST_ASSERT_TRUE(BlackboxReader_parseRange("bytes=900-", 1000, &first, &last));
+    TEST_ASSERT_EQUAL_UINT32(900, first);
+    TEST_ASSERT_EQUAL_UINT32(999, last);
+
+    TEST_ASSERT_TRUE(BlackboxReader_parseRange("bytes=-100", 1000, &first, &last));
+    TEST_ASSERT_EQUAL_UINT32(900, first);
+    TEST_ASSERT_EQUAL_UINT32(999, last);
+
+    // Past the end is clamped
+    TEST_ASSERT_TRUE(BlackboxReader_parseRange("bytes=500-5000", 1000, &first, &last));
+    TEST_ASSERT_EQUAL_UINT32(999, last);
+    TEST_ASSERT_TRUE(BlackboxReader_parseRange("bytes=-5000", 1000, &first, &last));
+    TEST_ASSERT_EQUAL_UINT32(0, first);
+}
+
+void test_range_rejects(void) {
+    uint32_t first, last;
+    TEST_ASSERT_FALSE(BlackboxReader_parseRange("bytes=1000-", 1000, &first, &last));
+    TEST_ASSERT_FALSE(BlackboxReader_parseRange("bytes=50-10", 1000, &first, &last));
+    TEST_ASSERT_FALSE(BlackboxReader_parseRange("bytes=0-1,5-9", 1000, &first, &last));
+    TEST_ASSERT_FALSE(BlackboxReader_parseRange("bytes=-0", 1000, &first, &last));
+    TEST_ASSERT_FALSE(BlackboxReader_parseRange("bytes=-", 1000, &first, &last));
+    TEST_ASSERT_FALSE(BlackboxReader_parseRange("items=0-9", 1000, &first, &last));
+    TEST_ASSERT_FALSE(BlackboxReader_parseRange("bytes=0-9", 0, &first, &last));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Index Tests
+    RUN_TEST(test_empty_partition_has_no_flights);
+    RUN_TEST(test_index_of_wrapped_partition);
+    RUN_TEST(test_half_programmed_sector_not_listed);
+    RUN_TEST(test_index_keeps_newest_flights);
+    RUN_TEST(test_index_of_packed_flight);
+
+    // Offset Tests
+    RUN_TEST(test_flight_offset_wraps);
+
+    // Range Tests
+    RUN_TEST(test_range_forms);
+    RUN_TEST(test_range_rejects);
+
+    return UNITY_END();
+}
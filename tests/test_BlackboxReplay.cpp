@@ -0,0 +1,288 @@
+/**
+ * Unit Tests for BlackboxReplay
+ * Tests the record cursor over flight downloads and partition images
+ * (schema, packed and corrupt sectors, wrapping) and the tick comparison
+ *
+ * @file test_BlackboxReplay.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "BlackboxReplay.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define TEST_SECTORS 6
+
+static uint8_t image[TEST_SECTORS * BLACKBOX_SECTOR_SIZE];
+static BlackboxReplayCursor cursor;
+static BlackboxReplayStats stats;
+static const BlackboxReplayTolerance tol = {2, 0};
+
+static uint8_t* sectorAt(uint16_t i) {
+    return image + (uint32_t)i * BLACKBOX_SECTOR_SIZE;
+}
+
+static void writeSchema(uint16_t i, uint16_t session, uint32_t sequence) {
+    Blackbox_writeSchema(sectorAt(i), session, sequence);
+    Blackbox_sealSector(sectorAt(i));
+}
+
+// Data sector with records timed startMs, startMs + 20, ...
+static void writeData(uint16_t i, uint16_t session, uint32_t sequence, uint32_t startMs,
+                      uint8_t records) {
+    Blackbox_startSector(sectorAt(i), BLACKBOX_KIND_DATA, session, sequence);
+    for (uint8_t r = 0; r < records; r++) {
+        BlackboxRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.timeMs = startMs + r * 20;
+        rec.sequence = sequence * 100 + r;
+        Blackbox_appendRecord(sectorAt(i), &rec);
+    }
+    Blackbox_sealSector(sectorAt(i));
+}
+
+// Packed sector with the same timing and sequences
+static void writePacked(uint16_t i, uint16_t session, uint32_t sequence, uint32_t startMs,
+                        uint16_t records) {
+    static BlackboxCodec codec;
+    Blackbox_startPacked(sectorAt(i), &codec, session, sequence);
+    for (uint16_t r = 0; r < records; r++) {
+        BlackboxRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.timeMs = startMs + r * 20;
+        rec.sequence = sequence * 100 + r;
+        Blackbox_appendPacked(sectorAt(i), &codec, &rec);
+    }
+    Blackbox_sealSector(sectorAt(i));
+}
+
+// Times of every record the cursor returns, count returned
+static int walk(uint32_t* times, int max) {
+    int n = 0;
+    const BlackboxRecord* rec;
+    while ((rec = BlackboxReplay_next(&cursor)) != NULL) {
+        if (n < max) times[n] = rec->timeMs;
+        n++;
+    }
+    return n;
+}
+
+static BlackboxRecord tick(uint32_t timeMs) {
+    BlackboxRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.timeMs = timeMs;
+    rec.throttle = 500;
+    rec.outputs[0] = 50;
+    rec.outputs[1] = 40;
+    rec.failsafe = 0;
+    rec.waypoint = 1;
+    rec.navFlags = BLACKBOX_NAV_MISSION;
+    return rec;
+}
+
+void setUp(void) {
+    memset(image, 0xFF, sizeof(image));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Cursor Tests
+// ============================================================================
+
+void test_flight_download_in_order(void) {
+    writeSchema(0, 7, 20);
+    writeData(1, 7, 21, 0, 3);
+    writeData(2, 7, 22, 60, 2);
+
+    TEST_ASSERT_TRUE(BlackboxReplay_openFlight(&cursor, image, 3 * BLACKBOX_SECTOR_SIZE));
+    uint32_t times[8];
+    TEST_ASSERT_EQUAL(5, walk(times, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, times[0]);
+    TEST_ASSERT_EQUAL_UINT32(40, times[2]);
+    TEST_ASSERT_EQUAL_UINT32(80, times[4]);
+    TEST_ASSERT_EQUAL_UINT32(5, cursor.records);
+    TEST_ASSERT_EQUAL_UINT32(0, cursor.skipped);
+    TEST_ASSERT_NULL(BlackboxReplay_next(&cursor));
+}
+
+void test_packed_sectors_decoded(void) {
+    writeSchema(0, 7, 20);
+    writeData(1, 7, 21, 0, 2);
+    writePacked(2, 7, 22, 40, 300);
+    writePacked(3, 7, 23, 6040, 2);
+    // Corrupt block: skipped whole
+    writePacked(4, 7, 24, 6080, 50);
+    sectorAt(4)[sizeof(BlackboxSectorHeader) + sizeof(BlackboxBlockHeader) + 9] ^= 0x04;
+
+    TEST_ASSERT_TRUE(BlackboxReplay_openFlight(&cursor, image, 5 * BLACKBOX_SECTOR_SIZE));
+    static uint32_t times[400];
+    TEST_ASSERT_EQUAL(304, walk(times, 400));
+    for (int i = 0; i < 304; i++)
+        TEST_ASSERT_EQUAL_UINT32(i * 20, times[i]);
+    TEST_ASSERT_EQUAL_UINT32(1, cursor.skipped);
+
+    // Sequences survive the delta coding
+    BlackboxReplay_openFlight(&cursor, image, 3 * BLACKBOX_SECTOR_SIZE);
+    BlackboxReplay_next(&cursor);
+    BlackboxReplay_next(&cursor);
+    const BlackboxRecord* rec = BlackboxReplay_next(&cursor);
+    TEST_ASSERT_NOT_NULL(rec);
+    TEST_ASSERT_EQUAL_UINT32(2200, rec->sequence);
+}
+
+void test_flight_rejects_partial_sector(void) {
+    TEST_ASSERT_FALSE(BlackboxReplay_openFlight(&cursor, image, BLACKBOX_SECTOR_SIZE + 16));
+    TEST_ASSERT_FALSE(BlackboxReplay_openFlight(&cursor, image, 0));
+}
+
+void test_corrupt_sector_skipped(void) {
+    writeData(0, 7, 21, 0, 2);
+    writeData(1, 7, 22, 40, 2);
+    writeData(2, 7, 23, 80, 2);
+    sectorAt(1)[sizeof(BlackboxSectorHeader) + 3] ^= 0x10;     // Payload bit flip
+
+    TEST_ASSERT_TRUE(BlackboxReplay_openFlight(&cursor, image, 3 * BLACKBOX_SECTOR_SIZE));
+    uint32_t times[8];
+    TEST_ASSERT_EQUAL(4, walk(times, 8));
+    TEST_ASSERT_EQUAL_UINT32(20, times[1]);
+    TEST_ASSERT_EQUAL_UINT32(80, times[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, cursor.skipped);
+}
+
+void test_other_layout_skipped(void) {
+    writeData(0, 7, 21, 0, 2);
+    writeData(1, 7, 22, 40, 2);
+    // A writer with a different record size (header patched, CRC redone)
+    ((BlackboxSectorHeader*)sectorAt(1))->recordSize = sizeof(BlackboxRecord) - 4;
+    Blackbox_sealSector(sectorAt(1));
+
+    TEST_ASSERT_TRUE(BlackboxReplay_openFlight(&cursor, image, 2 * BLACKBOX_SECTOR_SIZE));
+    uint32_t times[8];
+    TEST_ASSERT_EQUAL(2, walk(times, 8));
+    TEST_ASSERT_EQUAL_UINT32(1, cursor.skipped);
+}
+
+void test_session_of_wrapped_partition(void) {
+    // Session 5 runs from sector 4 around into sector 1; session 4 before it
+    writeData(2, 4, 10, 9000, 2);
+    writeData(3, 4, 11, 9040, 2);
+    writeSchema(4, 5, 12);
+    writeData(5, 5, 13, 100, 2);
+    writeData(0, 5, 14, 140, 2);
+    writeData(1, 5, 15, 180, 1);
+
+    TEST_ASSERT_TRUE(BlackboxReplay_openSession(&cursor, image, sizeof(image), 5));
+    uint32_t times[8];
+    TEST_ASSERT_EQUAL(5, walk(times, 8));
+    TEST_ASSERT_EQUAL_UINT32(100, times[0]);
+    TEST_ASSERT_EQUAL_UINT32(160, times[3]);
+    TEST_ASSERT_EQUAL_UINT32(180, times[4]);
+
+    TEST_ASSERT_TRUE(BlackboxReplay_openSession(&cursor, image, sizeof(image), 4));
+    TEST_ASSERT_EQUAL(4, walk(times, 8));
+    TEST_ASSERT_EQUAL_UINT32(9000, times[0]);
+
+    TEST_ASSERT_FALSE(BlackboxReplay_openSession(&cursor, image, sizeof(image), 6));
+}
+
+// ============================================================================
+// Comparison Tests
+// ============================================================================
+
+void test_identical_ticks_match(void) {
+    BlackboxRecord a = tick(100);
+    BlackboxRecord b = tick(100);
+    TEST_ASSERT_EQUAL_UINT8(0, BlackboxReplay_compare(&stats, &tol, &a, &b));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.ticks);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.mismatches);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.firstDiff);
+}
+
+void test_output_within_tolerance(void) {
+    BlackboxRecord a = tick(100);
+    BlackboxRecord b = tick(100);
+    b.outputs[1] = 42;
+    TEST_ASSERT_EQUAL_UINT8(0, BlackboxReplay_compare(&stats, &tol, &a, &b));
+    TEST_ASSERT_EQUAL_UINT8(2, stats.maxOutput[1]);
+
+    b.outputs[1] = 37;
+    TEST_ASSERT_EQUAL_UINT8(BLACKBOX_REPLAY_DIFF_OUTPUTS,
+                            BlackboxReplay_compare(&stats, &tol, &a, &b));
+    TEST_ASSERT_EQUAL_UINT8(3, stats.maxOutput[1]);
+    // sqrt((4 + 9) / 2)
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.5495f, BlackboxReplay_outputRms(&stats, 1));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, BlackboxReplay_outputRms(&stats, 0));
+}
+
+void test_first_mismatch_recorded(void) {
+    BlackboxRecord a = tick(100);
+    BlackboxRecord b = tick(100);
+    BlackboxReplay_compare(&stats, &tol, &a, &b);
+
+    a = tick(120);
+    b = tick(120);
+    b.roll = 10;
+    b.failsafe = 1;
+    uint8_t diff = BlackboxReplay_compare(&stats, &tol, &a, &b);
+    TEST_ASSERT_EQUAL_UINT8(BLACKBOX_REPLAY_DIFF_INPUTS | BLACKBOX_REPLAY_DIFF_FAILSAFE, diff);
+
+    a = tick(140);
+    b = tick(140);
+    b.navFlags |= BLACKBOX_NAV_RTL;
+    TEST_ASSERT_EQUAL_UINT8(BLACKBOX_REPLAY_DIFF_NAV, BlackboxReplay_compare(&stats, &tol, &a, &b));
+
+    TEST_ASSERT_EQUAL_UINT32(3, stats.ticks);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.mismatches);
+    TEST_ASSERT_EQUAL_UINT32(120, stats.firstMs);
+    TEST_ASSERT_EQUAL_UINT8(diff, stats.firstDiff);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.kinds[0]);    // Inputs
+    TEST_ASSERT_EQUAL_UINT32(0, stats.kinds[1]);    // Outputs
+    TEST_ASSERT_EQUAL_UINT32(1, stats.kinds[2]);    // Failsafe
+    TEST_ASSERT_EQUAL_UINT32(1, stats.kinds[3]);    // Nav
+    TEST_ASSERT_EQUAL_INT16(10, stats.maxInput);
+}
+
+void test_mode_change_is_an_input_diff(void) {
+    BlackboxRecord a = tick(100);
+    BlackboxRecord b = tick(100);
+    b.mode = 0x04;
+    TEST_ASSERT_EQUAL_UINT8(BLACKBOX_REPLAY_DIFF_INPUTS,
+                            BlackboxReplay_compare(&stats, &tol, &a, &b));
+}
+
+void test_diff_names(void) {
+    TEST_ASSERT_EQUAL_STRING("outputs", BlackboxReplay_diffName(BLACKBOX_REPLAY_DIFF_OUTPUTS));
+    TEST_ASSERT_EQUAL_STRING("nav", BlackboxReplay_diffName(BLACKBOX_REPLAY_DIFF_NAV));
+    TEST_ASSERT_EQUAL_STRING("?", BlackboxReplay_diffName(0x03));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Cursor Tests
+    RUN_TEST(test_flight_download_in_order);
+    RUN_TEST(test_packed_sectors_decoded);
+    RUN_TEST(test_flight_rejects_partial_sector);
+    RUN_TEST(test_corrupt_sector_skipped);
+    RUN_TEST(test_other_layout_skipped);
+    RUN_TEST(test_session_of_wrapped_partition);
+
+    // Comparison Tests
+    RUN_TEST(test_identical_ticks_match);
+    RUN_TEST(test_output_within_tolerance);
+    RUN_TEST(test_first_mismatch_recorded);
+    RUN_TEST(test_mode_change_is_an_input_diff);
+    RUN_TEST(test_diff_names);
+
+    return UNITY_END();
+}
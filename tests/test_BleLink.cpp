@@ -0,0 +1,205 @@
+/**
+ * Unit Tests for BleLink
+ * Tests telemetry batching per notification, command lines from split
+ * writes and reply chunking
+ *
+ * @file test_BleLink.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "BleLink.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static BleBatch batch;
+static BleLineReader reader;
+static BleReply reply;
+static uint8_t frame[BLE_LINK_MAX_PAYLOAD + 1];
+
+void setUp(void) {
+    BleBatch_init(&batch);
+    BleLineReader_init(&reader);
+    BleReply_init(&reply);
+    memset(frame, 0xA5, sizeof(frame));
+}
+
+void tearDown(void) {}
+
+static size_t feedText(const char* text, const char** line, uint16_t* len) {
+    return BleLineReader_feed(&reader, (const uint8_t*)text, strlen(text), line, len);
+}
+
+static void writeText(const char* text) {
+    BleReply_write(&reply, (const uint8_t*)text, strlen(text));
+}
+
+// ============================================================================
+// Batch Tests
+// ============================================================================
+
+void test_batch_default_mtu_holds_one_small_frame(void) {
+    TEST_ASSERT_EQUAL(20, batch.payload);
+    TEST_ASSERT_TRUE(BleBatch_add(&batch, frame, 12, 0));
+    TEST_ASSERT_FALSE(BleBatch_fits(&batch, 12));
+}
+
+void test_batch_packs_frames_after_mtu_exchange(void) {
+    BleBatch_setMtu(&batch, BLE_LINK_MTU);
+    TEST_ASSERT_EQUAL(BLE_LINK_MAX_PAYLOAD, batch.payload);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(BleBatch_add(&batch, frame, 50, 100));
+        TEST_ASSERT_FALSE(BleBatch_due(&batch, 100));
+    }
+    TEST_ASSERT_TRUE(BleBatch_add(&batch, frame, 50, 150));
+    TEST_ASSERT_TRUE(BleBatch_due(&batch, 150));
+    TEST_ASSERT_EQUAL(200, batch.len);
+
+    BleBatch_clear(&batch);
+    TEST_ASSERT_EQUAL(0, batch.len);
+    TEST_ASSERT_EQUAL(1, batch.batches);
+    TEST_ASSERT_EQUAL(4, batch.framesIn);
+}
+
+void test_batch_due_by_age(void) {
+    BleBatch_setMtu(&batch, BLE_LINK_MTU);
+    BleBatch_add(&batch, frame, 30, 1000);
+    BleBatch_add(&batch, frame, 30, 1150);
+    TEST_ASSERT_FALSE(BleBatch_due(&batch, 1000 + BLE_BATCH_MAX_AGE_MS - 1));
+    TEST_ASSERT_TRUE(BleBatch_due(&batch, 1000 + BLE_BATCH_MAX_AGE_MS));
+}
+
+void test_batch_empty_never_due(void) {
+    TEST_ASSERT_FALSE(BleBatch_due(&batch, 100000));
+    BleBatch_clear(&batch);
+    TEST_ASSERT_EQUAL(0, batch.batches);
+}
+
+void test_batch_drops_oversize_frame(void) {
+    TEST_ASSERT_FALSE(BleBatch_add(&batch, frame, 21, 0));
+    BleBatch_setMtu(&batch, 1000);  // Clamped to what is requested
+    TEST_ASSERT_FALSE(BleBatch_add(&batch, frame, BLE_LINK_MAX_PAYLOAD + 1, 0));
+    TEST_ASSERT_EQUAL(2, batch.oversize);
+    TEST_ASSERT_EQUAL(0, batch.frames);
+}
+
+// ============================================================================
+// Line Reader Tests
+// ============================================================================
+
+void test_reader_joins_split_writes(void) {
+    const char* line;
+    uint16_t len;
+    feedText("{\"cmd\":\"get_", &line, &len);
+    TEST_ASSERT_NULL(line);
+    feedText("status\"}\n", &line, &len);
+    TEST_ASSERT_NOT_NULL(line);
+    TEST_ASSERT_EQUAL_STRING("{\"cmd\":\"get_status\"}", line);
+    TEST_ASSERT_EQUAL(20, len);
+}
+
+void test_reader_splits_lines_in_one_write(void) {
+    const char* text = "{\"a\":1}\r\n{\"b\":2}\n";
+    const uint8_t* data = (const uint8_t*)text;
+    size_t left = strlen(text);
+    const char* line;
+    uint16_t len;
+
+    size_t used = BleLineReader_feed(&reader, data, left, &line, &len);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1}", line);
+    data += used;
+    left -= used;
+    used = BleLineReader_feed(&reader, data, left, &line, &len);
+    TEST_ASSERT_EQUAL_STRING("{\"b\":2}", line);  // CRLF: no empty line between
+    TEST_ASSERT_EQUAL(left, used);
+    TEST_ASSERT_EQUAL(2, reader.lines);
+}
+
+void test_reader_drops_overlong_line(void) {
+    static char longLine[BLE_LINE_MAX + 8];
+    memset(longLine, 'x', sizeof(longLine) - 1);
+    longLine[sizeof(longLine) - 1] = '\0';
+    const char* line;
+    uint16_t len;
+
+    feedText(longLine, &line, &len);
+    TEST_ASSERT_NULL(line);
+    feedText("tail\n", &line, &len);
+    TEST_ASSERT_NULL(line);     // The rest of the long line, not a command
+    TEST_ASSERT_EQUAL(1, reader.overflowed);
+
+    feedText("{\"ok\":1}\n", &line, &len);
+    TEST_ASSERT_EQUAL_STRING("{\"ok\":1}", line);
+}
+
+// ============================================================================
+// Reply Tests
+// ============================================================================
+
+void test_reply_chunks_by_payload(void) {
+    BleReply_begin(&reply);
+    writeText("{\"status\":\"ok\",\"value\":12345}\r\n");  // 31 bytes
+    BleReply_end(&reply);
+    TEST_ASSERT_FALSE(BleReply_idle(&reply));
+
+    const uint8_t* chunk;
+    TEST_ASSERT_EQUAL(20, BleReply_next(&reply, 20, &chunk));
+    TEST_ASSERT_EQUAL_MEMORY("{\"status\":\"ok\",\"valu", chunk, 20);
+    TEST_ASSERT_EQUAL(11, BleReply_next(&reply, 20, &chunk));
+    TEST_ASSERT_TRUE(BleReply_idle(&reply));
+    TEST_ASSERT_EQUAL(0, BleReply_next(&reply, 20, &chunk));
+}
+
+void test_reply_overflow_becomes_error(void) {
+    static uint8_t big[BLE_REPLY_MAX];
+    memset(big, 'y', sizeof(big));
+    BleReply_begin(&reply);
+    writeText("{");
+    BleReply_write(&reply, big, sizeof(big));
+    writeText("}\r\n");
+    BleReply_end(&reply);
+
+    const uint8_t* chunk;
+    size_t n = BleReply_next(&reply, BLE_LINK_MAX_PAYLOAD, &chunk);
+    const char* err = "{\"err\":\"Reply too long for BLE\"}\r\n";
+    TEST_ASSERT_EQUAL(strlen(err), n);
+    TEST_ASSERT_EQUAL_MEMORY(err, chunk, n);
+    TEST_ASSERT_TRUE(BleReply_idle(&reply));
+    TEST_ASSERT_EQUAL(1, reply.truncated);
+
+    // The next reply starts clean
+    BleReply_begin(&reply);
+    writeText("{}\r\n");
+    BleReply_end(&reply);
+    TEST_ASSERT_EQUAL(4, BleReply_next(&reply, BLE_LINK_MAX_PAYLOAD, &chunk));
+    TEST_ASSERT_EQUAL(2, reply.replies);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Batch Tests
+    RUN_TEST(test_batch_default_mtu_holds_one_small_frame);
+    RUN_TEST(test_batch_packs_frames_after_mtu_exchange);
+    RUN_TEST(test_batch_due_by_age);
+    RUN_TEST(test_batch_empty_never_due);
+    RUN_TEST(test_batch_drops_oversize_frame);
+
+    // Line Reader Tests
+    RUN_TEST(test_reader_joins_split_writes);
+    RUN_TEST(test_reader_splits_lines_in_one_write);
+    RUN_TEST(test_reader_drops_overlong_line);
+
+    // Reply Tests
+    RUN_TEST(test_reply_chunks_by_payload);
+    RUN_TEST(test_reply_overflow_becomes_error);
+
+    return UNITY_END();
+}
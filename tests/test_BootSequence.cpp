@@ -0,0 +1,181 @@
+/**
+ * Unit Tests for BootSequence
+ * Tests stage table validation, lane order, cross-lane dependencies,
+ * critical failures and the recorded stage timing
+ *
+ * @file test_BootSequence.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "BootSequence.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static BootSequence seq;
+
+static bool stageOk(void) { return true; }
+
+// serial(0) -> radio(1, critical) on MAIN; i2c(2) -> imu(3) on BACKGROUND,
+// web(4) on BACKGROUND after radio
+enum { SERIAL_, RADIO, I2C, IMU, WEB };
+static const BootStage TABLE[] = {
+    {"serial", stageOk, BOOT_LANE_MAIN, 0, 0},
+    {"radio", stageOk, BOOT_LANE_MAIN, BOOT_FLAG_CRITICAL, BOOT_AFTER(SERIAL_)},
+    {"i2c", stageOk, BOOT_LANE_BACKGROUND, 0, 0},
+    {"imu", stageOk, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(I2C)},
+    {"web", stageOk, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(RADIO)},
+};
+#define TABLE_COUNT (sizeof(TABLE) / sizeof(TABLE[0]))
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(BootSequence_init(&seq, TABLE, TABLE_COUNT));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+void test_init_rejects_bad_tables(void) {
+    BootSequence s;
+    BootStage bad[2] = {
+        {"a", stageOk, BOOT_LANE_MAIN, 0, 0},
+        {"b", stageOk, BOOT_LANE_COUNT, 0, 0},
+    };
+    TEST_ASSERT_FALSE(BootSequence_init(&s, bad, 2));      // Lane out of range
+
+    bad[1].lane = BOOT_LANE_MAIN;
+    bad[1].after = BOOT_AFTER(2);
+    TEST_ASSERT_FALSE(BootSequence_init(&s, bad, 2));      // Unknown dependency
+
+    bad[1].after = BOOT_AFTER(1);
+    TEST_ASSERT_FALSE(BootSequence_init(&s, bad, 2));      // Self dependency
+
+    bad[1].after = 0;
+    bad[1].fn = NULL;
+    TEST_ASSERT_FALSE(BootSequence_init(&s, bad, 2));      // No body
+
+    TEST_ASSERT_FALSE(BootSequence_init(&s, TABLE, 0));
+    TEST_ASSERT_FALSE(BootSequence_init(&s, TABLE, BOOT_MAX_STAGES + 1));
+}
+
+void test_init_rejects_cycle(void) {
+    BootSequence s;
+    const BootStage cyc[3] = {
+        {"a", stageOk, BOOT_LANE_MAIN, 0, BOOT_AFTER(2)},
+        {"b", stageOk, BOOT_LANE_BACKGROUND, 0, BOOT_AFTER(0)},
+        {"c", stageOk, BOOT_LANE_MAIN, 0, BOOT_AFTER(1)},
+    };
+    TEST_ASSERT_FALSE(BootSequence_init(&s, cyc, 3));
+}
+
+// ============================================================================
+// Scheduling Tests
+// ============================================================================
+
+void test_lanes_run_in_table_order(void) {
+    TEST_ASSERT_EQUAL(SERIAL_, BootSequence_claim(&seq, BOOT_LANE_MAIN, 0));
+    TEST_ASSERT_EQUAL(I2C, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 0));
+
+    // Radio waits for serial, imu for i2c
+    TEST_ASSERT_EQUAL(BOOT_NEXT_WAIT, BootSequence_claim(&seq, BOOT_LANE_MAIN, 1));
+    BootSequence_finish(&seq, SERIAL_, true, 10);
+    TEST_ASSERT_EQUAL(RADIO, BootSequence_claim(&seq, BOOT_LANE_MAIN, 10));
+    TEST_ASSERT_EQUAL(BOOT_NEXT_DONE, BootSequence_claim(&seq, BOOT_LANE_MAIN, 11));
+}
+
+void test_background_waits_on_main_lane(void) {
+    TEST_ASSERT_EQUAL(I2C, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 0));
+    BootSequence_finish(&seq, I2C, true, 5);
+    TEST_ASSERT_EQUAL(IMU, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 5));
+    BootSequence_finish(&seq, IMU, true, 8);
+
+    // Web needs the radio from the other lane
+    TEST_ASSERT_EQUAL(BOOT_NEXT_WAIT, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 8));
+    BootSequence_claim(&seq, BOOT_LANE_MAIN, 0);
+    BootSequence_finish(&seq, SERIAL_, true, 2);
+    BootSequence_claim(&seq, BOOT_LANE_MAIN, 2);
+    TEST_ASSERT_EQUAL(BOOT_NEXT_WAIT, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 9));
+    BootSequence_finish(&seq, RADIO, true, 20);
+    TEST_ASSERT_EQUAL(WEB, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 20));
+    TEST_ASSERT_FALSE(BootSequence_isComplete(&seq));
+    BootSequence_finish(&seq, WEB, true, 30);
+    TEST_ASSERT_TRUE(BootSequence_isComplete(&seq));
+}
+
+void test_failed_stage_still_releases_dependents(void) {
+    BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 0);
+    BootSequence_finish(&seq, I2C, false, 1);
+    TEST_ASSERT_FALSE(seq.halted);
+    TEST_ASSERT_EQUAL(BOOT_STAGE_FAILED, seq.state[I2C]);
+    TEST_ASSERT_EQUAL(IMU, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 1));
+}
+
+void test_critical_failure_halts_boot(void) {
+    BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 0);      // i2c running
+    BootSequence_claim(&seq, BOOT_LANE_MAIN, 0);
+    BootSequence_finish(&seq, SERIAL_, true, 1);
+    BootSequence_claim(&seq, BOOT_LANE_MAIN, 1);
+    BootSequence_finish(&seq, RADIO, false, 2);
+
+    TEST_ASSERT_TRUE(seq.halted);
+    TEST_ASSERT_EQUAL(BOOT_STAGE_SKIPPED, seq.state[IMU]);
+    TEST_ASSERT_EQUAL(BOOT_STAGE_SKIPPED, seq.state[WEB]);
+    TEST_ASSERT_EQUAL(BOOT_NEXT_DONE, BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 3));
+
+    // The stage already running still reports in
+    TEST_ASSERT_FALSE(BootSequence_isComplete(&seq));
+    BootSequence_finish(&seq, I2C, true, 4);
+    TEST_ASSERT_TRUE(BootSequence_isComplete(&seq));
+}
+
+// ============================================================================
+// Timing Tests
+// ============================================================================
+
+void test_stage_timing_and_lane_end(void) {
+    BootSequence_claim(&seq, BOOT_LANE_MAIN, 100);
+    BootSequence_finish(&seq, SERIAL_, true, 400);
+    BootSequence_claim(&seq, BOOT_LANE_MAIN, 450);
+    BootSequence_finish(&seq, RADIO, true, 9450);
+    BootSequence_claim(&seq, BOOT_LANE_BACKGROUND, 120);
+    BootSequence_finish(&seq, I2C, true, 2120);
+
+    TEST_ASSERT_EQUAL_UINT32(100, seq.startUs[SERIAL_]);
+    TEST_ASSERT_EQUAL_UINT32(300, seq.durationUs[SERIAL_]);
+    TEST_ASSERT_EQUAL_UINT32(9000, seq.durationUs[RADIO]);
+    TEST_ASSERT_EQUAL_UINT32(9450, BootSequence_laneEndUs(&seq, BOOT_LANE_MAIN));
+    TEST_ASSERT_EQUAL_UINT32(2120, BootSequence_laneEndUs(&seq, BOOT_LANE_BACKGROUND));
+
+    // Finishing a stage twice does not rewrite it
+    BootSequence_finish(&seq, SERIAL_, false, 9999);
+    TEST_ASSERT_EQUAL(BOOT_STAGE_OK, seq.state[SERIAL_]);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Validation Tests
+    RUN_TEST(test_init_rejects_bad_tables);
+    RUN_TEST(test_init_rejects_cycle);
+
+    // Scheduling Tests
+    RUN_TEST(test_lanes_run_in_table_order);
+    RUN_TEST(test_background_waits_on_main_lane);
+    RUN_TEST(test_failed_stage_still_releases_dependents);
+    RUN_TEST(test_critical_failure_halts_boot);
+
+    // Timing Tests
+    RUN_TEST(test_stage_timing_and_lane_end);
+
+    return UNITY_END();
+}
@@ -0,0 +1,206 @@
+/**
+ * Unit Tests for ClockSync
+ * Tests the offset of one exchange, the min-rtt filter against queueing
+ * delay, drift tracking, stale and forged replies and the wire format
+ *
+ * @file test_ClockSync.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "ClockSync.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define US_PER_S 1000000LL
+#define OFFSET_US (-123456789LL)    // Controller booted long before us
+
+static ClockSync cs;
+static int32_t controllerPpm;
+
+// Controller clock at a vehicle time
+static int64_t controller_at(HAL_Micros localUs) {
+    return localUs + OFFSET_US + localUs * controllerPpm / 1000000;
+}
+
+// One full exchange started at t1: up / down air time, controller turnaround
+static bool exchange(HAL_Micros t1, int64_t upUs, int64_t downUs) {
+    ClockSyncFrame frame;
+    if (!ClockSync_takeRequest(&cs, t1, &frame))
+        return false;
+    frame.flags = CLOCK_SYNC_FLAG_REPLY;
+    frame.t2 = controller_at(t1 + upUs);
+    frame.t3 = controller_at(t1 + upUs + 300);
+    return ClockSync_onReply(&cs, &frame, t1 + upUs + 300 + downUs);
+}
+
+void setUp(void) {
+    ClockSync_init(&cs);
+    controllerPpm = 0;
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Estimate Tests
+// ============================================================================
+
+void test_symmetric_exchange_is_exact(void) {
+    HAL_Micros t = 10 * US_PER_S;
+    for (int i = 0; i < CLOCK_SYNC_MIN_SAMPLES; i++)
+        TEST_ASSERT_TRUE(exchange(t + i * CLOCK_SYNC_FAST_PERIOD_US, 1500, 1500));
+    TEST_ASSERT_TRUE(ClockSync_isValid(&cs, t + US_PER_S));
+    TEST_ASSERT_TRUE(cs.offsetUs == OFFSET_US);
+    TEST_ASSERT_EQUAL_UINT32(3000, cs.rttUs);
+
+    int64_t remote;
+    TEST_ASSERT_TRUE(ClockSync_toRemote(&cs, t + US_PER_S, &remote));
+    TEST_ASSERT_TRUE(remote == controller_at(t + US_PER_S));
+    HAL_Micros local;
+    TEST_ASSERT_TRUE(ClockSync_toLocal(&cs, remote, &local));
+    TEST_ASSERT_TRUE(local == t + US_PER_S);
+}
+
+void test_not_valid_before_min_samples(void) {
+    HAL_Micros t = 10 * US_PER_S;
+    exchange(t, 1500, 1500);
+    exchange(t + CLOCK_SYNC_FAST_PERIOD_US, 1500, 1500);
+    int64_t remote = 7;
+    TEST_ASSERT_FALSE(ClockSync_toRemote(&cs, t + US_PER_S, &remote));
+    TEST_ASSERT_TRUE(remote == 7);
+}
+
+void test_min_rtt_sample_wins(void) {
+    // Queueing on the way up skews every sample but one
+    HAL_Micros t = 10 * US_PER_S;
+    int64_t up[CLOCK_SYNC_WINDOW] = {9000, 4000, 12000, 1200, 7000, 20000, 5000, 8000};
+    for (int i = 0; i < CLOCK_SYNC_WINDOW; i++)
+        exchange(t + i * CLOCK_SYNC_PERIOD_US, up[i], 1000);
+    TEST_ASSERT_EQUAL_UINT32(2200, cs.rttUs);
+    // Error of the chosen sample: half its asymmetry
+    TEST_ASSERT_TRUE(cs.offsetUs == OFFSET_US + 100);
+}
+
+void test_drift_is_tracked(void) {
+    // Controller crystal 30 ppm fast, clean link
+    controllerPpm = 30;
+    HAL_Micros t = 10 * US_PER_S;
+    for (int i = 0; i < 120; i++)
+        exchange(t + i * CLOCK_SYNC_PERIOD_US, 1000 + (i % 5) * 700, 1000);
+    TEST_ASSERT_TRUE(cs.driftKnown);
+    TEST_ASSERT_INT_WITHIN(2000, 30000, cs.driftPpb);
+
+    // Three seconds past the last exchange, well under the rtt bound
+    HAL_Micros later = t + 122 * US_PER_S;
+    int64_t remote;
+    TEST_ASSERT_TRUE(ClockSync_toRemote(&cs, later, &remote));
+    TEST_ASSERT_INT_WITHIN(100, 0, remote - controller_at(later));
+}
+
+void test_estimate_goes_stale(void) {
+    HAL_Micros t = 10 * US_PER_S;
+    for (int i = 0; i < CLOCK_SYNC_MIN_SAMPLES; i++)
+        exchange(t + i * CLOCK_SYNC_FAST_PERIOD_US, 1500, 1500);
+    int64_t remote;
+    TEST_ASSERT_FALSE(ClockSync_toRemote(&cs, cs.anchorUs + CLOCK_SYNC_STALE_US, &remote));
+}
+
+// ============================================================================
+// Request Tests
+// ============================================================================
+
+void test_request_pacing_and_estimate(void) {
+    ClockSyncFrame frame;
+    HAL_Micros t = 10 * US_PER_S;
+    TEST_ASSERT_TRUE(ClockSync_takeRequest(&cs, t, &frame));
+    TEST_ASSERT_EQUAL_HEX8(0, frame.flags);
+    TEST_ASSERT_FALSE(ClockSync_takeRequest(&cs, t + CLOCK_SYNC_FAST_PERIOD_US - 1, &frame));
+
+    setUp();
+    for (int i = 0; i < CLOCK_SYNC_MIN_SAMPLES; i++)
+        exchange(t + i * CLOCK_SYNC_FAST_PERIOD_US, 1500, 1500);
+    HAL_Micros next = t + 2 * CLOCK_SYNC_FAST_PERIOD_US + CLOCK_SYNC_FAST_PERIOD_US;
+    TEST_ASSERT_FALSE(ClockSync_takeRequest(&cs, next, &frame));
+    TEST_ASSERT_TRUE(ClockSync_takeRequest(&cs, next - CLOCK_SYNC_FAST_PERIOD_US +
+                                                    CLOCK_SYNC_PERIOD_US, &frame));
+    TEST_ASSERT_EQUAL_HEX8(CLOCK_SYNC_FLAG_VALID, frame.flags);
+    TEST_ASSERT_TRUE(frame.t2 == OFFSET_US);
+    TEST_ASSERT_TRUE(frame.t3 == 3000);
+}
+
+void test_stale_and_forged_replies_rejected(void) {
+    ClockSyncFrame first, second;
+    HAL_Micros t = 10 * US_PER_S;
+    ClockSync_takeRequest(&cs, t, &first);
+    ClockSync_takeRequest(&cs, t + CLOCK_SYNC_FAST_PERIOD_US, &second);
+
+    // Answer to the superseded request
+    first.flags = CLOCK_SYNC_FLAG_REPLY;
+    first.t2 = first.t3 = controller_at(t + 1000);
+    TEST_ASSERT_FALSE(ClockSync_onReply(&cs, &first, t + CLOCK_SYNC_FAST_PERIOD_US + 500));
+
+    // Right sequence, wrong t1
+    ClockSyncFrame forged = second;
+    forged.flags = CLOCK_SYNC_FLAG_REPLY;
+    forged.t1 += 1;
+    TEST_ASSERT_FALSE(ClockSync_onReply(&cs, &forged, t + CLOCK_SYNC_FAST_PERIOD_US + 500));
+
+    // Our own request reflected back
+    TEST_ASSERT_FALSE(ClockSync_onReply(&cs, &second, t + CLOCK_SYNC_FAST_PERIOD_US + 500));
+
+    // Too slow to mean anything
+    second.flags = CLOCK_SYNC_FLAG_REPLY;
+    second.t2 = second.t3 = controller_at(second.t1 + 30000);
+    TEST_ASSERT_FALSE(ClockSync_onReply(&cs, &second, second.t1 + 60000 + 1));
+    TEST_ASSERT_EQUAL_UINT32(4, cs.rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, cs.replies);
+}
+
+// ============================================================================
+// Wire Format Tests
+// ============================================================================
+
+void test_frame_round_trip(void) {
+    ClockSyncFrame in = {CLOCK_SYNC_FLAG_REPLY, 0xBEEF, 123456789012LL, -42LL, INT64_MAX};
+    uint8_t buf[CLOCK_SYNC_FRAME_SIZE];
+    TEST_ASSERT_EQUAL(CLOCK_SYNC_FRAME_SIZE, ClockSync_encode(&in, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(CLOCK_SYNC_TYPE, buf[0]);
+
+    ClockSyncFrame out;
+    TEST_ASSERT_TRUE(ClockSync_decode(buf, sizeof(buf), &out));
+    TEST_ASSERT_EQUAL_HEX8(in.flags, out.flags);
+    TEST_ASSERT_EQUAL_HEX16(in.sequence, out.sequence);
+    TEST_ASSERT_TRUE(out.t1 == in.t1 && out.t2 == in.t2 && out.t3 == in.t3);
+
+    buf[10] ^= 0x01;
+    TEST_ASSERT_FALSE(ClockSync_decode(buf, sizeof(buf), &out));
+    TEST_ASSERT_FALSE(ClockSync_decode(buf, sizeof(buf) - 1, &out));
+    TEST_ASSERT_EQUAL(0, ClockSync_encode(&in, buf, sizeof(buf) - 1));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Estimate Tests
+    RUN_TEST(test_symmetric_exchange_is_exact);
+    RUN_TEST(test_not_valid_before_min_samples);
+    RUN_TEST(test_min_rtt_sample_wins);
+    RUN_TEST(test_drift_is_tracked);
+    RUN_TEST(test_estimate_goes_stale);
+
+    // Request Tests
+    RUN_TEST(test_request_pacing_and_estimate);
+    RUN_TEST(test_stale_and_forged_replies_rejected);
+
+    // Wire Format Tests
+    RUN_TEST(test_frame_round_trip);
+
+    return UNITY_END();
+}
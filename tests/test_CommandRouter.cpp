@@ -0,0 +1,170 @@
+/**
+ * Unit Tests for CommandRouter
+ * Tests compile-time hashing, lookup of known / unknown names, duplicate
+ * rejection, per-command accounting and the name peek / parse filter
+ *
+ * @file test_CommandRouter.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <string.h>
+#include "CommandRouter.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static int lastHandler = -1;
+
+static void handlerA(JsonDocument& doc) { lastHandler = 0; }
+static void handlerB(JsonDocument& doc) { lastHandler = 1; }
+static void handlerC(JsonDocument& doc) { lastHandler = 2; }
+
+static constexpr CommandSpec SPECS[] = {
+    {"sm",          handlerA, 0, COMMAND_AUTH_NONE, "t s p y"},
+    {"ping",        handlerB, 1, COMMAND_AUTH_NONE},
+    {"set_ota_key", handlerC, 1, COMMAND_AUTH_HMAC, "key"},
+};
+static constexpr uint8_t SPEC_COUNT = sizeof(SPECS) / sizeof(SPECS[0]);
+
+static_assert(CommandRouter_hash("") == 2166136261u, "FNV-1a offset basis");
+static_assert(CommandRouter_hash("a") == 0xE40C292Cu, "FNV-1a of \"a\"");
+static_assert(CommandRouter_uniqueHashes(SPECS, SPEC_COUNT), "table hashes unique");
+
+static CommandRouter router;
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(CommandRouter_init(&router, SPECS, SPEC_COUNT));
+    lastHandler = -1;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Lookup Tests
+// ============================================================================
+
+void test_finds_every_command(void) {
+    for (uint8_t i = 0; i < SPEC_COUNT; i++) {
+        int index = CommandRouter_find(&router, SPECS[i].name);
+        TEST_ASSERT_EQUAL_INT(i, index);
+        JsonDocument doc;
+        SPECS[index].handler(doc);
+        TEST_ASSERT_EQUAL_INT(i, lastHandler);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, router.unknown);
+}
+
+void test_unknown_names_are_counted(void) {
+    TEST_ASSERT_EQUAL_INT(-1, CommandRouter_find(&router, "pin"));
+    TEST_ASSERT_EQUAL_INT(-1, CommandRouter_find(&router, "pingg"));
+    TEST_ASSERT_EQUAL_INT(-1, CommandRouter_find(&router, ""));
+    TEST_ASSERT_EQUAL_UINT32(3, router.unknown);
+}
+
+void test_duplicate_name_rejected(void) {
+    static const CommandSpec dup[] = {
+        {"ping", handlerA, 0, COMMAND_AUTH_NONE},
+        {"ping", handlerB, 0, COMMAND_AUTH_NONE},
+    };
+    TEST_ASSERT_FALSE(CommandRouter_uniqueHashes(dup, 2));
+    TEST_ASSERT_FALSE(CommandRouter_init(&router, dup, 2));
+}
+
+void test_full_table(void) {
+    static char names[COMMAND_ROUTER_MAX][8];
+    static CommandSpec many[COMMAND_ROUTER_MAX + 1];
+    for (int i = 0; i < COMMAND_ROUTER_MAX; i++) {
+        snprintf(names[i], sizeof(names[i]), "c%d", i);
+        many[i].name = names[i];
+        many[i].handler = handlerA;
+    }
+    TEST_ASSERT_TRUE(CommandRouter_init(&router, many, COMMAND_ROUTER_MAX));
+    for (int i = 0; i < COMMAND_ROUTER_MAX; i++) {
+        TEST_ASSERT_EQUAL_INT(i, CommandRouter_find(&router, names[i]));
+    }
+    many[COMMAND_ROUTER_MAX] = many[0];
+    TEST_ASSERT_FALSE(CommandRouter_init(&router, many, COMMAND_ROUTER_MAX + 1));
+}
+
+// ============================================================================
+// Stats Tests
+// ============================================================================
+
+void test_stats(void) {
+    int ping = CommandRouter_find(&router, "ping");
+    CommandRouter_recordCall(&router, ping, 100);
+    CommandRouter_recordCall(&router, ping, 300);
+    CommandRouter_recordReject(&router, ping);
+    CommandRouter_recordReject(&router, -1);        // Unknown: ignored
+    TEST_ASSERT_EQUAL_UINT32(2, router.stats[ping].calls);
+    TEST_ASSERT_EQUAL_UINT32(1, router.stats[ping].rejected);
+    TEST_ASSERT_EQUAL_UINT32(400, router.stats[ping].totalUs);
+    TEST_ASSERT_EQUAL_UINT32(300, router.stats[ping].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(0, router.stats[0].calls);
+}
+
+// ============================================================================
+// Filter Tests
+// ============================================================================
+
+void test_peek_name(void) {
+    char name[COMMAND_NAME_MAX];
+    const char* line = "{\"seq\":{\"c\":\"x\",\"a\":[1,\"}\"]},\"s\":\"a\\\"b\", \"c\" : \"sm\"}";
+    TEST_ASSERT_TRUE(CommandRouter_peekName(line, strlen(line), name, sizeof(name)));
+    TEST_ASSERT_EQUAL_STRING("sm", name);
+    TEST_ASSERT_EQUAL_PTR(&SPECS[0], CommandRouter_spec(&router, name));
+    TEST_ASSERT_NULL(CommandRouter_spec(&router, "pin"));
+    TEST_ASSERT_EQUAL_UINT32(0, router.unknown);
+
+    const char* escaped = "{\"c\":\"s\\u006d\"}";
+    TEST_ASSERT_FALSE(CommandRouter_peekName(escaped, strlen(escaped), name, sizeof(name)));
+    const char* none = "{\"t\":1}";
+    TEST_ASSERT_FALSE(CommandRouter_peekName(none, strlen(none), name, sizeof(name)));
+    const char* ping = "{\"c\":\"ping\"}";
+    TEST_ASSERT_FALSE(CommandRouter_peekName(ping, strlen(ping), name, 4));
+    TEST_ASSERT_FALSE(CommandRouter_peekName("[\"c\"]", 5, name, sizeof(name)));
+}
+
+void test_filtered_parse_keeps_listed_members(void) {
+    JsonDocument filter;
+    TEST_ASSERT_FALSE(CommandRouter_buildFilter(&SPECS[1], filter));   // Reads all
+    TEST_ASSERT_FALSE(CommandRouter_buildFilter(NULL, filter));
+    TEST_ASSERT_TRUE(CommandRouter_buildFilter(&SPECS[0], filter));
+
+    const char* line = "{\"c\":\"sm\",\"t\":1500,\"note\":\"configurator\","
+                       "\"y\":[1,2],\"hmac\":\"QUJD\"}";
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, line, strlen(line),
+                                      DeserializationOption::Filter(filter)));
+    TEST_ASSERT_EQUAL_STRING("sm", doc["c"]);
+    TEST_ASSERT_EQUAL_INT(1500, doc["t"] | 0);
+    TEST_ASSERT_EQUAL_INT(2, doc["y"].size());
+    TEST_ASSERT_EQUAL_STRING("QUJD", doc["hmac"]);
+    TEST_ASSERT_TRUE(doc["note"].isNull());
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Lookup Tests
+    RUN_TEST(test_finds_every_command);
+    RUN_TEST(test_unknown_names_are_counted);
+    RUN_TEST(test_duplicate_name_rejected);
+    RUN_TEST(test_full_table);
+
+    // Stats Tests
+    RUN_TEST(test_stats);
+
+    // Filter Tests
+    RUN_TEST(test_peek_name);
+    RUN_TEST(test_filtered_parse_keeps_listed_members);
+
+    return UNITY_END();
+}
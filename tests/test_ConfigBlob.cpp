@@ -0,0 +1,143 @@
+/**
+ * Unit Tests for ConfigBlob
+ * Tests round trip, CRC rejection and migration hooks (runs on target NVS)
+ *
+ * @file test_ConfigBlob.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "ConfigBlob.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static Preferences prefs;
+
+typedef struct {
+    uint16_t a;
+    uint16_t b;
+} TestSectionV1;
+
+typedef struct {
+    uint16_t a;
+    uint16_t b;
+    uint16_t c;
+} TestSectionV2;
+
+static size_t migrate_v1_to_v2(uint8_t fromVersion, const uint8_t* oldData,
+                               size_t oldLen, void* out, size_t outSize) {
+    if (fromVersion != 1 || oldLen != sizeof(TestSectionV1) ||
+        outSize < sizeof(TestSectionV2))
+        return 0;
+    TestSectionV2* v2 = (TestSectionV2*)out;
+    memcpy(v2, oldData, oldLen);   // a, b unchanged; c keeps caller default
+    return sizeof(TestSectionV2);
+}
+
+void setUp(void) {
+    prefs.begin("cfg_test", false);
+    prefs.clear();
+}
+
+void tearDown(void) {
+    prefs.end();
+}
+
+// ============================================================================
+// Round Trip Tests
+// ============================================================================
+
+void test_missing_key_reported(void) {
+    TestSectionV1 s;
+    TEST_ASSERT_EQUAL(CONFIG_BLOB_MISSING,
+                      ConfigBlob_load(prefs, "sec", 1, &s, sizeof(s), NULL, NULL));
+}
+
+void test_save_load_round_trip(void) {
+    TestSectionV1 in = {0x1234, 0xBEEF};
+    TestSectionV1 out = {0, 0};
+    size_t len = 0;
+
+    TEST_ASSERT_TRUE(ConfigBlob_save(prefs, "sec", 1, &in, sizeof(in)));
+    TEST_ASSERT_EQUAL(CONFIG_BLOB_OK,
+                      ConfigBlob_load(prefs, "sec", 1, &out, sizeof(out), &len, NULL));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(in), len);
+    TEST_ASSERT_EQUAL_UINT16(0x1234, out.a);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, out.b);
+}
+
+void test_oversized_payload_rejected(void) {
+    static uint8_t big[CONFIG_BLOB_MAX_PAYLOAD + 1];
+    TEST_ASSERT_FALSE(ConfigBlob_save(prefs, "sec", 1, big, sizeof(big)));
+}
+
+// ============================================================================
+// Integrity Tests
+// ============================================================================
+
+void test_corrupted_payload_rejected(void) {
+    TestSectionV1 in = {1, 2};
+    TEST_ASSERT_TRUE(ConfigBlob_save(prefs, "sec", 1, &in, sizeof(in)));
+
+    uint8_t raw[sizeof(ConfigBlobHeader) + sizeof(in)];
+    TEST_ASSERT_EQUAL_UINT32(sizeof(raw), prefs.getBytes("sec", raw, sizeof(raw)));
+    raw[sizeof(raw) - 1] ^= 0x01;
+    prefs.putBytes("sec", raw, sizeof(raw));
+
+    TestSectionV1 out;
+    TEST_ASSERT_EQUAL(CONFIG_BLOB_CORRUPT,
+                      ConfigBlob_load(prefs, "sec", 1, &out, sizeof(out), NULL, NULL));
+}
+
+// ============================================================================
+// Migration Tests
+// ============================================================================
+
+void test_version_mismatch_without_hook_rejected(void) {
+    TestSectionV1 in = {1, 2};
+    TEST_ASSERT_TRUE(ConfigBlob_save(prefs, "sec", 1, &in, sizeof(in)));
+
+    TestSectionV2 out;
+    TEST_ASSERT_EQUAL(CONFIG_BLOB_CORRUPT,
+                      ConfigBlob_load(prefs, "sec", 2, &out, sizeof(out), NULL, NULL));
+}
+
+void test_migration_hook_upgrades_payload(void) {
+    TestSectionV1 in = {7, 9};
+    TEST_ASSERT_TRUE(ConfigBlob_save(prefs, "sec", 1, &in, sizeof(in)));
+
+    TestSectionV2 out = {0, 0, 42};
+    size_t len = 0;
+    TEST_ASSERT_EQUAL(CONFIG_BLOB_MIGRATED,
+                      ConfigBlob_load(prefs, "sec", 2, &out, sizeof(out), &len,
+                                      migrate_v1_to_v2));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(TestSectionV2), len);
+    TEST_ASSERT_EQUAL_UINT16(7, out.a);
+    TEST_ASSERT_EQUAL_UINT16(9, out.b);
+    TEST_ASSERT_EQUAL_UINT16(42, out.c);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Round Trip Tests
+    RUN_TEST(test_missing_key_reported);
+    RUN_TEST(test_save_load_round_trip);
+    RUN_TEST(test_oversized_payload_rejected);
+
+    // Integrity Tests
+    RUN_TEST(test_corrupted_payload_rejected);
+
+    // Migration Tests
+    RUN_TEST(test_version_mismatch_without_hook_rejected);
+    RUN_TEST(test_migration_hook_upgrades_payload);
+
+    return UNITY_END();
+}
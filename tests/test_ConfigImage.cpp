@@ -0,0 +1,155 @@
+/**
+ * Unit Tests for ConfigImage
+ * Tests the image round trip, adding blobs from the buffer's tail, and
+ * rejection of corrupt, truncated and duplicate-key images
+ *
+ * @file test_ConfigImage.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "ConfigImage.h"
+#include "ConfigBlob.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t image[512];
+static uint8_t blobA[64];
+static uint8_t blobB[64];
+static size_t lenA;
+static size_t lenB;
+
+static size_t buildImage(void) {
+    ConfigImageWriter w;
+    ConfigImage_begin(&w, image, sizeof(image));
+    ConfigImage_add(&w, "cfg_pid", blobA, lenA);
+    ConfigImage_add(&w, "mission_v3", blobB, lenB);
+    return ConfigImage_finish(&w);
+}
+
+void setUp(void) {
+    const uint32_t a[3] = {1, 2, 3};
+    const uint16_t b[5] = {10, 20, 30, 40, 50};
+    lenA = ConfigBlob_encode(1, a, sizeof(a), blobA, sizeof(blobA));
+    lenB = ConfigBlob_encode(3, b, sizeof(b), blobB, sizeof(blobB));
+    memset(image, 0, sizeof(image));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Round Trip Tests
+// ============================================================================
+
+void test_round_trip(void) {
+    size_t len = buildImage();
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_HEADER + 2 * 3 + 7 + 10 + lenA + lenB, len);
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_OK, ConfigImage_validate(image, len));
+
+    ConfigImageReader r;
+    ConfigImageEntry e;
+    ConfigImage_open(&r, image, len);
+    TEST_ASSERT_TRUE(ConfigImage_next(&r, &e));
+    TEST_ASSERT_EQUAL_STRING("cfg_pid", e.key);
+    TEST_ASSERT_EQUAL(lenA, e.blobLen);
+    TEST_ASSERT_EQUAL_MEMORY(blobA, e.blob, lenA);
+    TEST_ASSERT_TRUE(ConfigImage_next(&r, &e));
+    TEST_ASSERT_EQUAL_STRING("mission_v3", e.key);
+    TEST_ASSERT_EQUAL_MEMORY(blobB, e.blob, lenB);
+    TEST_ASSERT_FALSE(ConfigImage_next(&r, &e));
+}
+
+void test_add_from_buffer_tail(void) {
+    // The blob sits where the next entry's key will go
+    ConfigImageWriter w;
+    ConfigImage_begin(&w, image, sizeof(image));
+    uint8_t* tail = image + w.len + CONFIG_IMAGE_ENTRY_MAX_OVERHEAD;
+    memcpy(tail, blobA, lenA);
+    TEST_ASSERT_TRUE(ConfigImage_add(&w, "cfg_pid", tail, lenA));
+    size_t len = ConfigImage_finish(&w);
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_OK, ConfigImage_validate(image, len));
+
+    ConfigImageReader r;
+    ConfigImageEntry e;
+    ConfigImage_open(&r, image, len);
+    TEST_ASSERT_TRUE(ConfigImage_next(&r, &e));
+    TEST_ASSERT_EQUAL_MEMORY(blobA, e.blob, lenA);
+}
+
+void test_add_rejects_bad_input(void) {
+    ConfigImageWriter w;
+    ConfigImage_begin(&w, image, sizeof(image));
+    TEST_ASSERT_FALSE(ConfigImage_add(&w, "a_key_far_too_long", blobA, lenA));
+    blobA[lenA - 1] ^= 0xFF;
+    TEST_ASSERT_FALSE(ConfigImage_add(&w, "cfg_pid", blobA, lenA));
+    TEST_ASSERT_EQUAL(0, w.count);
+
+    // Full: finish refuses to produce a partial image
+    ConfigImage_begin(&w, image, CONFIG_IMAGE_HEADER + 8);
+    TEST_ASSERT_FALSE(ConfigImage_add(&w, "cfg_mot", blobB, lenB));
+    TEST_ASSERT_EQUAL(0, ConfigImage_finish(&w));
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+void test_rejects_corruption(void) {
+    size_t len = buildImage();
+    image[len - 1] ^= 0x01;
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_BAD_CRC, ConfigImage_validate(image, len));
+    image[len - 1] ^= 0x01;
+
+    image[0] ^= 0xFF;
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_BAD_MAGIC, ConfigImage_validate(image, len));
+    image[0] ^= 0xFF;
+
+    image[2] = CONFIG_IMAGE_VERSION + 1;
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_BAD_VERSION, ConfigImage_validate(image, len));
+}
+
+void test_rejects_truncation(void) {
+    size_t len = buildImage();
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_TRUNCATED, ConfigImage_validate(image, len - 1));
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_TRUNCATED, ConfigImage_validate(image, 4));
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_TRUNCATED, ConfigImage_validate(NULL, len));
+}
+
+void test_rejects_duplicate_key(void) {
+    ConfigImageWriter w;
+    ConfigImage_begin(&w, image, sizeof(image));
+    ConfigImage_add(&w, "cfg_pid", blobA, lenA);
+    ConfigImage_add(&w, "cfg_pid", blobB, lenB);
+    size_t len = ConfigImage_finish(&w);
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_BAD_ENTRY, ConfigImage_validate(image, len));
+}
+
+void test_status_names(void) {
+    TEST_ASSERT_EQUAL_STRING("ok", ConfigImage_statusName(CONFIG_IMAGE_OK));
+    TEST_ASSERT_EQUAL_STRING("write_failed", ConfigImage_statusName(CONFIG_IMAGE_WRITE_FAILED));
+    TEST_ASSERT_EQUAL_STRING("?", ConfigImage_statusName((ConfigImageStatus)99));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Round Trip Tests
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_add_from_buffer_tail);
+    RUN_TEST(test_add_rejects_bad_input);
+
+    // Validation Tests
+    RUN_TEST(test_rejects_corruption);
+    RUN_TEST(test_rejects_truncation);
+    RUN_TEST(test_rejects_duplicate_key);
+    RUN_TEST(test_status_names);
+
+    return UNITY_END();
+}
@@ -0,0 +1,264 @@
+/**
+ * Unit Tests for ConfigManager change observers and backup / restore
+ * Tests that set / reset / import reach only the observers of the
+ * section, with the old and the new value, and that a backup image
+ * clones sections and registered keys without the shared secret; the
+ * paired MAC round-trips through fixed buffers
+ *
+ * @file test_ConfigManager.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "ConfigManager.h"
+#include "ConfigBlob.h"
+#include <Preferences.h>
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+typedef struct {
+    int calls;
+    ConfigManager::Section section;
+    ConfigManager::SecurityConfig before;
+    ConfigManager::SecurityConfig after;
+} SecurityLog;
+
+static int pidCalls;
+static float pidBeforeKp;
+static float pidAfterKp;
+
+static void onPid(const ConfigManager::Change& change, void* ctx) {
+    (void)ctx;
+    pidCalls++;
+    pidBeforeKp = change.before.pid->kp;
+    pidAfterKp = change.after.pid->kp;
+}
+
+static void onSecurity(const ConfigManager::Change& change, void* ctx) {
+    SecurityLog* log = (SecurityLog*)ctx;
+    log->calls++;
+    log->section = change.section;
+    log->before = *change.before.security;
+    log->after = *change.after.security;
+}
+
+static void noop(const ConfigManager::Change& change, void* ctx) {
+    (void)change;
+    (void)ctx;
+}
+
+void setUp(void) {
+    pidCalls = 0;
+    pidBeforeKp = 0.0f;
+    pidAfterKp = 0.0f;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Observer Tests
+// ============================================================================
+
+void test_set_reaches_section_observers_only(void) {
+    ConfigManager config;
+    SecurityLog log = {};
+    TEST_ASSERT_TRUE(config.addObserver(ConfigManager::SECTION_PID, onPid, nullptr));
+    TEST_ASSERT_TRUE(config.addObserver(ConfigManager::SECTION_SECURITY, onSecurity, &log));
+
+    ConfigManager::PIDConfig pid;
+    pid.kp = 2.5f;
+    config.setPIDConfig(pid);
+    TEST_ASSERT_EQUAL(1, pidCalls);
+    TEST_ASSERT_EQUAL_FLOAT(1.2f, pidBeforeKp);
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, pidAfterKp);
+    TEST_ASSERT_EQUAL(0, log.calls);
+
+    ConfigManager::SecurityConfig sec = config.getSecurityConfig();
+    sec.rateLimitCPS = 40;
+    config.setSecurityConfig(sec);
+    TEST_ASSERT_EQUAL(1, log.calls);
+    TEST_ASSERT_EQUAL(ConfigManager::SECTION_SECURITY, log.section);
+    TEST_ASSERT_EQUAL_UINT16(100, log.before.rateLimitCPS);
+    TEST_ASSERT_EQUAL_UINT16(40, log.after.rateLimitCPS);
+    TEST_ASSERT_EQUAL(1, pidCalls);
+}
+
+void test_reset_notifies_defaults(void) {
+    ConfigManager config;
+    config.addObserver(ConfigManager::SECTION_PID, onPid, nullptr);
+    ConfigManager::PIDConfig pid;
+    pid.kp = 3.0f;
+    config.setPIDConfig(pid);
+
+    config.resetPIDConfig();
+    TEST_ASSERT_EQUAL(2, pidCalls);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, pidBeforeKp);
+    TEST_ASSERT_EQUAL_FLOAT(1.2f, pidAfterKp);
+}
+
+void test_import_keeps_secret(void) {
+    // The export has no secret, so an import must not wipe it
+    ConfigManager config;
+    SecurityLog log = {};
+    config.addObserver(ConfigManager::SECTION_SECURITY, onSecurity, &log);
+    ConfigManager::SecurityConfig sec = config.getSecurityConfig();
+    memset(sec.sharedSecret, 0x5A, sizeof(sec.sharedSecret));
+    config.setSecurityConfig(sec);
+
+    JsonDocument doc;
+    doc["security"]["cps"] = 50;
+    config.importFromJSON(doc);
+    TEST_ASSERT_EQUAL(2, log.calls);
+    TEST_ASSERT_EQUAL_MEMORY(log.before.sharedSecret, log.after.sharedSecret,
+                             sizeof(sec.sharedSecret));
+    TEST_ASSERT_EQUAL_UINT16(50, log.after.rateLimitCPS);
+}
+
+void test_observer_table_full(void) {
+    ConfigManager config;
+    for (int i = 0; i < CONFIG_MAX_OBSERVERS; i++)
+        TEST_ASSERT_TRUE(config.addObserver(ConfigManager::SECTION_MOTOR, noop, nullptr));
+    TEST_ASSERT_FALSE(config.addObserver(ConfigManager::SECTION_MOTOR, noop, nullptr));
+    TEST_ASSERT_FALSE(config.addObserver(ConfigManager::SECTION_COUNT, noop, nullptr));
+}
+
+// ============================================================================
+// Backup / Restore Tests
+// ============================================================================
+
+static uint8_t image[2048];
+
+static void wipeStore(void) {
+    Preferences prefs;
+    prefs.begin("na_config", false);
+    prefs.clear();
+    prefs.end();
+}
+
+void test_backup_restore_clones_config(void) {
+    wipeStore();
+    const uint8_t fence[6] = {1, 2, 3, 4, 5, 6};
+    uint8_t fenceBlob[32];
+    size_t fenceLen = ConfigBlob_encode(1, fence, sizeof(fence), fenceBlob, sizeof(fenceBlob));
+
+    size_t len;
+    {
+        ConfigManager source;
+        source.begin();
+        TEST_ASSERT_TRUE(source.addBackupKey("fence"));
+        ConfigManager::PIDConfig pid;
+        pid.kp = 2.0f;
+        source.setPIDConfig(pid);
+        ConfigManager::SecurityConfig sec = source.getSecurityConfig();
+        memset(sec.sharedSecret, 0x11, sizeof(sec.sharedSecret));
+        sec.rateLimitCPS = 25;
+        source.setSecurityConfig(sec);
+        source.flush();
+        Preferences prefs;
+        prefs.begin("na_config", false);
+        prefs.putBytes("fence", fenceBlob, fenceLen);
+        prefs.end();
+        len = source.backup(image, sizeof(image));
+    }
+    TEST_ASSERT_TRUE(len > CONFIG_IMAGE_HEADER);
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_OK, ConfigImage_validate(image, len));
+    // No secret in the image
+    for (size_t i = 0; i + 4 <= len; i++) {
+        const uint8_t ones[4] = {0x11, 0x11, 0x11, 0x11};
+        TEST_ASSERT_FALSE(memcmp(image + i, ones, sizeof(ones)) == 0);
+    }
+
+    // A different vehicle: own secret, no fence yet
+    wipeStore();
+    ConfigManager target;
+    target.begin();
+    target.addBackupKey("fence");
+    ConfigManager::SecurityConfig own = target.getSecurityConfig();
+    memset(own.sharedSecret, 0x22, sizeof(own.sharedSecret));
+    target.setSecurityConfig(own);
+    target.flush();
+
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_OK, target.restore(image, len));
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, target.getPIDConfig().kp);
+    ConfigManager::SecurityConfig sec = target.getSecurityConfig();
+    TEST_ASSERT_EQUAL_UINT16(25, sec.rateLimitCPS);
+    TEST_ASSERT_EQUAL_MEMORY(own.sharedSecret, sec.sharedSecret, sizeof(sec.sharedSecret));
+    Preferences prefs;
+    prefs.begin("na_config", true);
+    uint8_t stored[32];
+    TEST_ASSERT_EQUAL(fenceLen, prefs.getBytes("fence", stored, sizeof(stored)));
+    TEST_ASSERT_EQUAL_MEMORY(fenceBlob, stored, fenceLen);
+    prefs.end();
+}
+
+void test_restore_rejects_unregistered_key(void) {
+    // An image from a vehicle that backs up "fence", restored on one that does not
+    wipeStore();
+    ConfigManager config;
+    config.begin();
+    uint8_t blob[16];
+    const uint8_t data[2] = {7, 8};
+    size_t blobLen = ConfigBlob_encode(1, data, sizeof(data), blob, sizeof(blob));
+    ConfigImageWriter w;
+    ConfigImage_begin(&w, image, sizeof(image));
+    ConfigImage_add(&w, "fence", blob, blobLen);
+    size_t len = ConfigImage_finish(&w);
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_UNKNOWN_KEY, config.restore(image, len));
+
+    image[len - 1] ^= 0xFF;
+    TEST_ASSERT_EQUAL(CONFIG_IMAGE_BAD_CRC, config.restore(image, len));
+}
+
+// ============================================================================
+// Pairing Tests
+// ============================================================================
+
+void test_paired_mac_survives_reboot(void) {
+    wipeStore();
+    {
+        ConfigManager config;
+        config.begin();
+        config.setPairedMACAddress("AA:BB:CC:DD:EE:FF");
+        config.flush();
+    }
+    ConfigManager config;
+    config.begin();
+    char mac[ConfigManager::MAC_STRING_LEN];
+    config.getPairedMACAddress(mac, sizeof(mac));
+    TEST_ASSERT_EQUAL_STRING("AA:BB:CC:DD:EE:FF", mac);
+
+    // Short buffer: truncated, still terminated
+    char part[6];
+    config.getPairedMACAddress(part, sizeof(part));
+    TEST_ASSERT_EQUAL_STRING("AA:BB", part);
+
+    config.clearPairing();
+    config.getPairedMACAddress(mac, sizeof(mac));
+    TEST_ASSERT_EQUAL_STRING("", mac);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Observer Tests
+    RUN_TEST(test_set_reaches_section_observers_only);
+    RUN_TEST(test_reset_notifies_defaults);
+    RUN_TEST(test_import_keeps_secret);
+    RUN_TEST(test_observer_table_full);
+
+    // Backup / Restore Tests
+    RUN_TEST(test_backup_restore_clones_config);
+    RUN_TEST(test_restore_rejects_unregistered_key);
+
+    // Pairing Tests
+    RUN_TEST(test_paired_mac_survives_reboot);
+
+    return UNITY_END();
+}
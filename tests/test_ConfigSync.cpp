@@ -0,0 +1,77 @@
+/**
+ * Unit Tests for ConfigSync
+ * Tests the section hash and that the manifest follows every input
+ *
+ * @file test_ConfigSync.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ConfigSync.h"
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Section Hash Tests
+// ============================================================================
+
+void test_hash_known_vectors(void) {
+    TEST_ASSERT_EQUAL_HEX32(0x811C9DC5, ConfigSync_hash("", 0));
+    TEST_ASSERT_EQUAL_HEX32(0xE40C292C, ConfigSync_hash("a", 1));
+    TEST_ASSERT_EQUAL_HEX32(0xBF9CF968, ConfigSync_hash("foobar", 6));
+}
+
+void test_hash_follows_content(void) {
+    const char* a = "{\"kp\":1.2,\"ki\":0.05,\"kd\":0.4}";
+    const char* b = "{\"kp\":1.3,\"ki\":0.05,\"kd\":0.4}";
+    TEST_ASSERT_EQUAL_HEX32(ConfigSync_hash(a, strlen(a)), ConfigSync_hash(a, strlen(a)));
+    TEST_ASSERT_NOT_EQUAL(ConfigSync_hash(a, strlen(a)), ConfigSync_hash(b, strlen(b)));
+}
+
+// ============================================================================
+// Manifest Tests
+// ============================================================================
+
+void test_manifest_follows_sections(void) {
+    uint32_t hashes[3] = {0x11111111, 0x22222222, 0x33333333};
+    uint32_t base = ConfigSync_manifest(1, hashes, 3);
+    TEST_ASSERT_EQUAL_HEX32(base, ConfigSync_manifest(1, hashes, 3));
+
+    hashes[2] ^= 0x100;
+    TEST_ASSERT_NOT_EQUAL(base, ConfigSync_manifest(1, hashes, 3));
+    hashes[2] ^= 0x100;
+
+    // Order matters: a swapped pair is a different config
+    uint32_t swapped[3] = {0x22222222, 0x11111111, 0x33333333};
+    TEST_ASSERT_NOT_EQUAL(base, ConfigSync_manifest(1, swapped, 3));
+
+    TEST_ASSERT_NOT_EQUAL(base, ConfigSync_manifest(1, hashes, 2));
+}
+
+void test_manifest_follows_schema_version(void) {
+    uint32_t hashes[2] = {0xDEADBEEF, 0x01234567};
+    TEST_ASSERT_NOT_EQUAL(ConfigSync_manifest(1, hashes, 2), ConfigSync_manifest(2, hashes, 2));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Section Hash Tests
+    RUN_TEST(test_hash_known_vectors);
+    RUN_TEST(test_hash_follows_content);
+
+    // Manifest Tests
+    RUN_TEST(test_manifest_follows_sections);
+    RUN_TEST(test_manifest_follows_schema_version);
+
+    return UNITY_END();
+}
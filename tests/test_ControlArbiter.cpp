@@ -0,0 +1,217 @@
+/**
+ * Unit Tests for ControlArbiter
+ * Tests newest-wins and priority selection, sequence de-duplication
+ * across links of one domain and per sender, stale frame rejection,
+ * link health and the config sanitizer
+ *
+ * @file test_ControlArbiter.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ControlArbiter.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static ControlArbiter arb;
+static ControlArbiterConfig config;
+
+void setUp(void) {
+    ControlArbiter_init(&arb);
+    ControlArbiter_defaultConfig(&config);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Selection Tests
+// ============================================================================
+
+void test_nothing_offered(void) {
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_NONE, ControlArbiter_select(&arb, &config));
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_NONE, arb.lastLink);
+}
+
+void test_newest_arrival_wins(void) {
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_RC, 0, 10, 1000));
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 50, 1500));
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_SERIAL, 0, 7, 1200));
+    TEST_ASSERT_EQUAL(CONTROL_LINK_RADIO, ControlArbiter_select(&arb, &config));
+    TEST_ASSERT_EQUAL(1, arb.links[CONTROL_LINK_RADIO].applied);
+
+    // Offers are cleared by select
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_NONE, ControlArbiter_select(&arb, &config));
+}
+
+void test_priority_mode(void) {
+    config.mode = CONTROL_ARBITER_PRIORITY;
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 50, 1500);
+    ControlArbiter_offer(&arb, CONTROL_LINK_SERIAL, 0, 7, 1200);
+    TEST_ASSERT_EQUAL(CONTROL_LINK_SERIAL, ControlArbiter_select(&arb, &config));
+
+    ControlArbiter_offer(&arb, CONTROL_LINK_WS, 0, 51, 1600);
+    TEST_ASSERT_EQUAL(CONTROL_LINK_WS, ControlArbiter_select(&arb, &config));
+}
+
+void test_switch_counted(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 1, 1000);
+    ControlArbiter_select(&arb, &config);
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 2, 2000);
+    ControlArbiter_select(&arb, &config);
+    TEST_ASSERT_EQUAL(0, arb.switches);
+
+    ControlArbiter_offer(&arb, CONTROL_LINK_RC, 0, 1, 3000);
+    ControlArbiter_select(&arb, &config);
+    TEST_ASSERT_EQUAL(1, arb.switches);
+    TEST_ASSERT_EQUAL(CONTROL_LINK_RC, arb.lastLink);
+}
+
+// ============================================================================
+// De-duplication Tests
+// ============================================================================
+
+void test_same_frame_on_two_links(void) {
+    // ESP-NOW copy first, the /ws copy of the same frame arrives later
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 100, 1000);
+    TEST_ASSERT_EQUAL(CONTROL_LINK_RADIO, ControlArbiter_select(&arb, &config));
+    TEST_ASSERT_FALSE(ControlArbiter_offer(&arb, CONTROL_LINK_WS, 0, 100, 3000));
+    TEST_ASSERT_EQUAL(1, arb.links[CONTROL_LINK_WS].duplicates);
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_NONE, ControlArbiter_select(&arb, &config));
+}
+
+void test_both_copies_in_one_tick(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 100, 1000);
+    ControlArbiter_offer(&arb, CONTROL_LINK_WS, 0, 100, 1400);
+    TEST_ASSERT_EQUAL(CONTROL_LINK_WS, ControlArbiter_select(&arb, &config));
+    TEST_ASSERT_EQUAL(1, arb.links[CONTROL_LINK_RADIO].duplicates);
+    TEST_ASSERT_EQUAL_UINT32(100, arb.domainSeq[0]);
+}
+
+void test_older_sequence_rejected(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_WS, 0, 101, 1000);
+    ControlArbiter_select(&arb, &config);
+    // Delayed ESP-NOW frame with an older sequence
+    TEST_ASSERT_FALSE(ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 99, 2000));
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 102, 2000));
+}
+
+void test_other_sender_not_compared(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 1, 9000, 1000);
+    ControlArbiter_select(&arb, &config);
+    // Relay with its own counter takes over without waiting for a timeout
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 2, 40, 2000));
+    TEST_ASSERT_FALSE(ControlArbiter_offer(&arb, CONTROL_LINK_WS, 1, 9000, 2000));
+}
+
+void test_domains_independent(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 500, 1000);
+    ControlArbiter_select(&arb, &config);
+    // Serial counts on its own
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_SERIAL, 0, 3, 2000));
+}
+
+void test_sequence_wrap(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_RC, 0, 0xFFFFFFFF, 1000);
+    ControlArbiter_select(&arb, &config);
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_RC, 0, 0, 2000));
+}
+
+void test_stale_arrival_rejected(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_SERIAL, 0, 5, 5000);
+    ControlArbiter_select(&arb, &config);
+    TEST_ASSERT_FALSE(ControlArbiter_offer(&arb, CONTROL_LINK_RC, 0, 1, 4000));
+    TEST_ASSERT_EQUAL(1, arb.links[CONTROL_LINK_RC].stale);
+}
+
+// ============================================================================
+// Health Tests
+// ============================================================================
+
+void test_health_and_failover(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 1, 1000);
+    ControlArbiter_offer(&arb, CONTROL_LINK_RC, 0, 1, 1000);
+    ControlArbiter_select(&arb, &config);
+    TEST_ASSERT_EQUAL_HEX8((1 << CONTROL_LINK_RADIO) | (1 << CONTROL_LINK_RC),
+                           ControlArbiter_update(&arb, &config, 2000));
+
+    // Radio goes quiet; RC keeps driving every tick
+    int64_t t = 2000;
+    for (int i = 0; i < 30; i++) {
+        t += 10000;
+        ControlArbiter_offer(&arb, CONTROL_LINK_RC, 0, 2 + i, t);
+        TEST_ASSERT_EQUAL(CONTROL_LINK_RC, ControlArbiter_select(&arb, &config));
+        ControlArbiter_update(&arb, &config, t);
+    }
+    TEST_ASSERT_EQUAL_HEX8(1 << CONTROL_LINK_RC, ControlArbiter_healthyMask(&arb));
+    TEST_ASSERT_EQUAL(1, arb.links[CONTROL_LINK_RADIO].outages);
+}
+
+void test_restarted_sender_after_timeout(void) {
+    ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 9000, 1000);
+    ControlArbiter_select(&arb, &config);
+    ControlArbiter_update(&arb, &config, 1000);
+
+    // Controller reboots: counting starts again once the link timed out
+    ControlArbiter_update(&arb, &config, 1000 + (CONTROL_ARBITER_TIMEOUT_MS + 1) * 1000);
+    TEST_ASSERT_TRUE(ControlArbiter_offer(&arb, CONTROL_LINK_RADIO, 0, 1, 400000));
+}
+
+// ============================================================================
+// Config Tests
+// ============================================================================
+
+void test_sanitize(void) {
+    config.mode = 9;
+    config.timeoutMs = 1;
+    ControlArbiter_sanitize(&config);
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_NEWEST, config.mode);
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_TIMEOUT_MIN_MS, config.timeoutMs);
+    config.timeoutMs = 60000;
+    ControlArbiter_sanitize(&config);
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_TIMEOUT_MAX_MS, config.timeoutMs);
+}
+
+void test_names(void) {
+    ControlArbiterMode mode;
+    TEST_ASSERT_TRUE(ControlArbiter_parseMode("priority", &mode));
+    TEST_ASSERT_EQUAL(CONTROL_ARBITER_PRIORITY, mode);
+    TEST_ASSERT_FALSE(ControlArbiter_parseMode("first", &mode));
+    TEST_ASSERT_EQUAL_STRING("newest", ControlArbiter_modeName(CONTROL_ARBITER_NEWEST));
+    TEST_ASSERT_EQUAL_STRING("rc", ControlArbiter_linkName(CONTROL_LINK_RC));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Selection Tests
+    RUN_TEST(test_nothing_offered);
+    RUN_TEST(test_newest_arrival_wins);
+    RUN_TEST(test_priority_mode);
+    RUN_TEST(test_switch_counted);
+
+    // De-duplication Tests
+    RUN_TEST(test_same_frame_on_two_links);
+    RUN_TEST(test_both_copies_in_one_tick);
+    RUN_TEST(test_older_sequence_rejected);
+    RUN_TEST(test_other_sender_not_compared);
+    RUN_TEST(test_domains_independent);
+    RUN_TEST(test_sequence_wrap);
+    RUN_TEST(test_stale_arrival_rejected);
+
+    // Health Tests
+    RUN_TEST(test_health_and_failover);
+    RUN_TEST(test_restarted_sender_after_timeout);
+
+    // Config Tests
+    RUN_TEST(test_sanitize);
+    RUN_TEST(test_names);
+
+    return UNITY_END();
+}
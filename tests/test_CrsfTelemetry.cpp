@@ -0,0 +1,163 @@
+/**
+ * Unit Tests for CrsfTelemetry
+ * Tests that every stream encodes into a CRSF frame the receiver-side
+ * parser accepts, field scaling and byte order, the flight mode text and
+ * the streams without a frame
+ *
+ * @file test_CrsfTelemetry.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "CrsfTelemetry.h"
+#include "RcInput.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static TelemetrySnapshot snap;
+static RcParser parser;
+static uint8_t out[CRSF_TELEMETRY_MAX_FRAME];
+static RcFrame frame;
+
+/**
+ * Encode one stream and parse it back; frame.payload is NULL unless the
+ * parser took exactly the encoded bytes as one frame
+ */
+static size_t encode(TelemetryStreamId id) {
+    memset(out, 0xAA, sizeof(out));
+    size_t len = CrsfTelemetry_encode(id, &snap, out, sizeof(out));
+    frame.payload = NULL;
+    if (len && RcInput_feed(&parser, out, len, &frame) != len)
+        frame.payload = NULL;
+    return len;
+}
+
+static uint16_t be16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t be32(const uint8_t* p) {
+    return ((uint32_t)be16(p) << 16) | be16(p + 2);
+}
+
+void setUp(void) {
+    memset(&snap, 0, sizeof(snap));
+    RcInput_init(&parser, RC_PROTOCOL_CRSF);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Frame Tests
+// ============================================================================
+
+void test_attitude_frame(void) {
+    snap.roll = -90.0f;
+    snap.pitch = 45.0f;
+    snap.heading = 270.0f;     // -90 degrees
+    TEST_ASSERT_EQUAL(10, encode(TELEMETRY_STREAM_ATTITUDE));
+    TEST_ASSERT_NOT_NULL(frame.payload);
+    TEST_ASSERT_EQUAL_HEX8(CRSF_TELEMETRY_TYPE_ATTITUDE, frame.type);
+    TEST_ASSERT_EQUAL(6, frame.length);
+    TEST_ASSERT_EQUAL_INT16(7854, (int16_t)be16(frame.payload));
+    TEST_ASSERT_EQUAL_INT16(-15708, (int16_t)be16(frame.payload + 2));
+    TEST_ASSERT_EQUAL_INT16(-15708, (int16_t)be16(frame.payload + 4));
+}
+
+void test_gps_frame(void) {
+    snap.latE7 = 137563000;
+    snap.lngE7 = -1005018000;
+    snap.groundSpeed = 5.0f;   // 18 km/h
+    snap.heading = 359.998f;   // Rounds to north
+    TEST_ASSERT_EQUAL(19, encode(TELEMETRY_STREAM_POSITION));
+    TEST_ASSERT_NOT_NULL(frame.payload);
+    TEST_ASSERT_EQUAL_HEX8(CRSF_TELEMETRY_TYPE_GPS, frame.type);
+    TEST_ASSERT_EQUAL(15, frame.length);
+    TEST_ASSERT_EQUAL_INT32(137563000, (int32_t)be32(frame.payload));
+    TEST_ASSERT_EQUAL_INT32(-1005018000, (int32_t)be32(frame.payload + 4));
+    TEST_ASSERT_EQUAL_UINT16(180, be16(frame.payload + 8));
+    TEST_ASSERT_EQUAL_UINT16(0, be16(frame.payload + 10));
+    TEST_ASSERT_EQUAL_UINT16(1000, be16(frame.payload + 12));
+}
+
+void test_battery_frame(void) {
+    snap.batteryMv = 11870;
+    TEST_ASSERT_EQUAL(12, encode(TELEMETRY_STREAM_BATTERY));
+    TEST_ASSERT_NOT_NULL(frame.payload);
+    TEST_ASSERT_EQUAL_HEX8(CRSF_TELEMETRY_TYPE_BATTERY, frame.type);
+    TEST_ASSERT_EQUAL_UINT16(119, be16(frame.payload));
+    TEST_ASSERT_EQUAL_UINT16(0, be16(frame.payload + 2));
+}
+
+void test_depth_as_negative_altitude(void) {
+    snap.depth = 2.5f;
+    TEST_ASSERT_EQUAL(8, encode(TELEMETRY_STREAM_DEPTH));
+    TEST_ASSERT_NOT_NULL(frame.payload);
+    TEST_ASSERT_EQUAL_HEX8(CRSF_TELEMETRY_TYPE_BARO, frame.type);
+    TEST_ASSERT_EQUAL_UINT16(10000 - 25, be16(frame.payload));
+}
+
+void test_flight_mode_frame(void) {
+    snap.navFlags = TELEMETRY_NAV_MISSION_ACTIVE;
+    size_t len = encode(TELEMETRY_STREAM_NAV);
+    TEST_ASSERT_EQUAL(4 + 5, len);
+    TEST_ASSERT_NOT_NULL(frame.payload);
+    TEST_ASSERT_EQUAL_HEX8(CRSF_TELEMETRY_TYPE_MODE, frame.type);
+    TEST_ASSERT_EQUAL_STRING("AUTO", (const char*)frame.payload);
+
+    // Events carry the same frame
+    TEST_ASSERT_EQUAL(len, encode(TELEMETRY_STREAM_EVENTS));
+    TEST_ASSERT_EQUAL_HEX8(CRSF_TELEMETRY_TYPE_MODE, frame.type);
+}
+
+// ============================================================================
+// Mode and Limit Tests
+// ============================================================================
+
+void test_flight_mode_order(void) {
+    TEST_ASSERT_EQUAL_STRING("MANU", CrsfTelemetry_flightMode(&snap));
+    snap.navFlags = TELEMETRY_NAV_MISSION_ACTIVE | TELEMETRY_NAV_RTL_ACTIVE;
+    TEST_ASSERT_EQUAL_STRING("RTL", CrsfTelemetry_flightMode(&snap));
+    snap.failsafe = 1;         // Armed
+    TEST_ASSERT_EQUAL_STRING("RTL", CrsfTelemetry_flightMode(&snap));
+    snap.failsafe = 2;         // Signal loss
+    TEST_ASSERT_EQUAL_STRING("!FS!", CrsfTelemetry_flightMode(&snap));
+}
+
+void test_streams_without_frame(void) {
+    TEST_ASSERT_EQUAL(0, encode(TELEMETRY_STREAM_PERF));
+    TEST_ASSERT_EQUAL(0, encode(TELEMETRY_STREAM_COUNT));
+    TEST_ASSERT_FALSE(CRSF_TELEMETRY_STREAMS & (1 << TELEMETRY_STREAM_PERF));
+    TEST_ASSERT_TRUE(CRSF_TELEMETRY_STREAMS & (1 << TELEMETRY_STREAM_EVENTS));
+}
+
+void test_short_buffer(void) {
+    TEST_ASSERT_EQUAL(0, CrsfTelemetry_encode(TELEMETRY_STREAM_POSITION, &snap, out, 18));
+    TEST_ASSERT_EQUAL(19, CrsfTelemetry_encode(TELEMETRY_STREAM_POSITION, &snap, out, 19));
+    TEST_ASSERT_EQUAL(0, CrsfTelemetry_encode(TELEMETRY_STREAM_ATTITUDE, &snap, out, 3));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Frame Tests
+    RUN_TEST(test_attitude_frame);
+    RUN_TEST(test_gps_frame);
+    RUN_TEST(test_battery_frame);
+    RUN_TEST(test_depth_as_negative_altitude);
+    RUN_TEST(test_flight_mode_frame);
+
+    // Mode and Limit Tests
+    RUN_TEST(test_flight_mode_order);
+    RUN_TEST(test_streams_without_frame);
+    RUN_TEST(test_short_buffer);
+
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * Unit Tests for CryptoBackend
+ * Tests AES-256-CTR and HMAC-SHA256 against published test vectors
+ *
+ * @file test_CryptoBackend.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "CryptoBackend.h"
+#include <string.h>
+
+// ============================================================================
+// Test Vectors
+// ============================================================================
+
+// NIST SP 800-38A F.5.5 (CTR-AES256.Encrypt), first block
+static const uint8_t kAesKey[32] = {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae,
+    0xf0, 0x85, 0x7d, 0x77, 0x81, 0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61,
+    0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4};
+static const uint8_t kAesCounter[16] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5,
+                                        0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+                                        0xfc, 0xfd, 0xfe, 0xff};
+static const uint8_t kAesPlain[16] = {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40,
+                                      0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+                                      0x73, 0x93, 0x17, 0x2a};
+static const uint8_t kAesCipher[16] = {0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57,
+                                       0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04,
+                                       0xbb, 0xf3, 0xd2, 0x28};
+
+// RFC 4231 Test Case 1
+static const uint8_t kHmacMac[32] = {
+    0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53, 0x5c, 0xa8, 0xaf,
+    0xce, 0xaf, 0x0b, 0xf1, 0x2b, 0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83,
+    0x3d, 0xa7, 0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7};
+
+static CryptoAesContext aesCtx;
+static CryptoHmacKey hmacKey;
+
+void setUp(void) {
+    CryptoBackend_resetStats();
+    memset(&aesCtx, 0, sizeof(aesCtx));
+    memset(&hmacKey, 0, sizeof(hmacKey));
+}
+
+void tearDown(void) {
+    CryptoBackend_aesFree(&aesCtx);
+    CryptoBackend_hmacFree(&hmacKey);
+}
+
+// ============================================================================
+// AES-CTR Tests
+// ============================================================================
+
+void test_aes_ctr_matches_nist_vector(void) {
+    uint8_t out[16];
+    TEST_ASSERT_EQUAL_INT(0, CryptoBackend_aesSetKey(&aesCtx, kAesKey));
+    TEST_ASSERT_EQUAL_INT(0, CryptoBackend_aesCtr(&aesCtx, kAesCounter,
+                                                  kAesPlain, 16, out));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(kAesCipher, out, 16);
+}
+
+void test_aes_ctr_does_not_modify_iv(void) {
+    uint8_t iv[16];
+    uint8_t out[16];
+    memcpy(iv, kAesCounter, 16);
+    CryptoBackend_aesSetKey(&aesCtx, kAesKey);
+    CryptoBackend_aesCtr(&aesCtx, iv, kAesPlain, 16, out);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(kAesCounter, iv, 16);
+}
+
+void test_aes_ctr_in_place_roundtrip(void) {
+    uint8_t buf[16];
+    memcpy(buf, kAesPlain, 16);
+    CryptoBackend_aesSetKey(&aesCtx, kAesKey);
+    CryptoBackend_aesCtr(&aesCtx, kAesCounter, buf, 16, buf);
+    CryptoBackend_aesCtr(&aesCtx, kAesCounter, buf, 16, buf);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(kAesPlain, buf, 16);
+}
+
+// ============================================================================
+// HMAC Tests
+// ============================================================================
+
+void test_hmac_matches_rfc4231_case1(void) {
+    uint8_t key[20];
+    uint8_t mac[32];
+    memset(key, 0x0b, sizeof(key));
+    const char *data = "Hi There";
+
+    TEST_ASSERT_EQUAL_INT(0, CryptoBackend_hmacSetKey(&hmacKey, key, 20));
+    TEST_ASSERT_EQUAL_INT(0, CryptoBackend_hmacSha256(&hmacKey,
+                                                      (const uint8_t *)data,
+                                                      8, mac));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(kHmacMac, mac, 32);
+}
+
+void test_hmac_key_reusable(void) {
+    uint8_t key[20];
+    uint8_t mac1[32], mac2[32];
+    memset(key, 0x0b, sizeof(key));
+    const char *data = "Hi There";
+
+    CryptoBackend_hmacSetKey(&hmacKey, key, 20);
+    CryptoBackend_hmacSha256(&hmacKey, (const uint8_t *)data, 8, mac1);
+    CryptoBackend_hmacSha256(&hmacKey, (const uint8_t *)data, 8, mac2);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(mac1, mac2, 32);
+}
+
+void test_hmac_rejects_oversized_key(void) {
+    uint8_t key[65] = {0};
+    TEST_ASSERT_NOT_EQUAL(0, CryptoBackend_hmacSetKey(&hmacKey, key, 65));
+}
+
+// ============================================================================
+// Statistics Tests
+// ============================================================================
+
+void test_stats_count_bytes(void) {
+    uint8_t out[16];
+    CryptoBackend_aesSetKey(&aesCtx, kAesKey);
+    CryptoBackend_aesCtr(&aesCtx, kAesCounter, kAesPlain, 16, out);
+    CryptoBackend_aesCtr(&aesCtx, kAesCounter, kAesPlain, 10, out);
+
+    CryptoBackendStats stats = CryptoBackend_getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.aesCalls);
+    TEST_ASSERT_EQUAL_UINT32(26, (uint32_t)stats.aesBytes);
+    TEST_ASSERT_NOT_NULL(stats.backend);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // AES-CTR Tests
+    RUN_TEST(test_aes_ctr_matches_nist_vector);
+    RUN_TEST(test_aes_ctr_does_not_modify_iv);
+    RUN_TEST(test_aes_ctr_in_place_roundtrip);
+
+    // HMAC Tests
+    RUN_TEST(test_hmac_matches_rfc4231_case1);
+    RUN_TEST(test_hmac_key_reusable);
+    RUN_TEST(test_hmac_rejects_oversized_key);
+
+    // Statistics Tests
+    RUN_TEST(test_stats_count_bytes);
+
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+/**
+ * Unit Tests for DShot
+ * Tests frame CRC, throttle mapping, bit timing and eRPM reply decoding
+ *
+ * @file test_DShot.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "drivers/DShot.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static const uint8_t GCR_ENCODE[16] = {
+    0x19, 0x1B, 0x12, 0x13, 0x1D, 0x15, 0x16, 0x17,
+    0x1A, 0x09, 0x0A, 0x0B, 0x1E, 0x0D, 0x0E, 0x0F,
+};
+
+/**
+ * Build the line levels an ESC would send for a 12-bit e-period,
+ * as runs of telemetryBitTicks-long bits
+ */
+static uint8_t buildReply(uint16_t value, uint16_t bitTicks, DShotRun* runs) {
+    uint16_t csum = value ^ (value >> 4) ^ (value >> 8);
+    uint16_t data = (uint16_t)((value << 4) | (~csum & 0x0F));
+    uint32_t gcr = 0;
+    for (int8_t shift = 12; shift >= 0; shift -= 4) {
+        gcr = (gcr << 5) | GCR_ENCODE[(data >> shift) & 0x0F];
+    }
+
+    // Start bit low, then a transition for every 1
+    uint8_t level = 0, count = 0;
+    runs[0].level = 0;
+    runs[0].ticks = bitTicks;
+    for (int8_t bit = 19; bit >= 0; bit--) {
+        if ((gcr >> bit) & 1) {
+            level = !level;
+            count++;
+            runs[count].level = level;
+            runs[count].ticks = 0;
+        }
+        runs[count].ticks += bitTicks;
+    }
+    return count + 1;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Frame Tests
+// ============================================================================
+
+void test_frame_crc(void) {
+    // Throttle 1046, no telemetry: packet 0x82C, CRC 0x6
+    TEST_ASSERT_EQUAL_HEX16(0x82C6, DShot_encodeFrame(1046, false, false));
+    // Bidirectional inverts the CRC
+    TEST_ASSERT_EQUAL_HEX16(0x82C9, DShot_encodeFrame(1046, false, true));
+}
+
+void test_throttle_mapping(void) {
+    TEST_ASSERT_EQUAL_UINT16(0, DShot_throttleValue(0));
+    TEST_ASSERT_EQUAL_UINT16(0, DShot_throttleValue(-50));
+    TEST_ASSERT_EQUAL_UINT16(DSHOT_THROTTLE_MIN + 19, DShot_throttleValue(1));
+    TEST_ASSERT_EQUAL_UINT16(DSHOT_THROTTLE_MAX, DShot_throttleValue(100));
+    TEST_ASSERT_EQUAL_UINT16(DSHOT_THROTTLE_MAX, DShot_throttleValue(150));
+}
+
+void test_timing(void) {
+    DShotTiming t;
+    DShot_timing(DSHOT600, &t);
+    TEST_ASSERT_EQUAL_UINT16(133, t.bitTicks);      // 1.67 us
+    TEST_ASSERT_EQUAL_UINT16(99, t.oneHighTicks);
+    TEST_ASSERT_EQUAL_UINT16(49, t.zeroHighTicks);
+    DShot_timing(DSHOT150, &t);
+    TEST_ASSERT_EQUAL_UINT16(533, t.bitTicks);
+}
+
+// ============================================================================
+// Telemetry Tests
+// ============================================================================
+
+void test_decode_erpm(void) {
+    DShotTiming t;
+    DShot_timing(DSHOT300, &t);
+    DShotRun runs[DSHOT_TELEMETRY_BITS];
+
+    // Period 1000 us = 250 << 2 -> 60000 eRPM
+    uint8_t n = buildReply((2 << 9) | 250, t.telemetryBitTicks, runs);
+    uint32_t erpm = 0;
+    TEST_ASSERT_TRUE(DShot_decodeERPM(DShot_collectBits(runs, n, t.telemetryBitTicks), &erpm));
+    TEST_ASSERT_EQUAL_UINT32(60000, erpm);
+}
+
+void test_decode_tolerates_jitter(void) {
+    DShotTiming t;
+    DShot_timing(DSHOT600, &t);
+    DShotRun runs[DSHOT_TELEMETRY_BITS];
+    uint8_t n = buildReply((1 << 9) | 300, t.telemetryBitTicks, runs);
+    for (uint8_t i = 0; i < n; i++) {
+        runs[i].ticks += (i & 1) ? 20 : -20;    // +-20% of a bit
+    }
+    uint32_t erpm = 0;
+    TEST_ASSERT_TRUE(DShot_decodeERPM(DShot_collectBits(runs, n, t.telemetryBitTicks), &erpm));
+    TEST_ASSERT_EQUAL_UINT32(100000, erpm);
+}
+
+void test_decode_stopped_motor(void) {
+    DShotTiming t;
+    DShot_timing(DSHOT300, &t);
+    DShotRun runs[DSHOT_TELEMETRY_BITS];
+    uint8_t n = buildReply(0x0FFF, t.telemetryBitTicks, runs);
+    uint32_t erpm = 1;
+    TEST_ASSERT_TRUE(DShot_decodeERPM(DShot_collectBits(runs, n, t.telemetryBitTicks), &erpm));
+    TEST_ASSERT_EQUAL_UINT32(0, erpm);
+}
+
+void test_decode_rejects_corruption(void) {
+    DShotTiming t;
+    DShot_timing(DSHOT300, &t);
+    DShotRun runs[DSHOT_TELEMETRY_BITS];
+    uint8_t n = buildReply((2 << 9) | 250, t.telemetryBitTicks, runs);
+    uint32_t raw = DShot_collectBits(runs, n, t.telemetryBitTicks);
+    uint32_t erpm;
+    TEST_ASSERT_FALSE(DShot_decodeERPM(raw ^ (1UL << 7), &erpm));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Frame Tests
+    RUN_TEST(test_frame_crc);
+    RUN_TEST(test_throttle_mapping);
+    RUN_TEST(test_timing);
+
+    // Telemetry Tests
+    RUN_TEST(test_decode_erpm);
+    RUN_TEST(test_decode_tolerates_jitter);
+    RUN_TEST(test_decode_stopped_motor);
+    RUN_TEST(test_decode_rejects_corruption);
+
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**
+ * Unit Tests for DepthEstimator
+ * Tests priming, the rate of a noisy descent against plain differencing,
+ * prediction between samples with and without the IMU's acceleration,
+ * and accelerometer bias learning
+ *
+ * @file test_DepthEstimator.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdlib.h>
+#include "DepthEstimator.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DT              0.02f   // Control tick
+#define SAMPLE_TICKS    2       // A pressure sample every other tick
+#define NOISE_M         0.005f
+
+static DepthEstimator est;
+
+static float noise(float amplitude) {
+    return amplitude * (2.0f * rand() / (float)RAND_MAX - 1.0f);
+}
+
+/**
+ * Run a trajectory: depth(t) with acceleration accel(t), sampled with
+ * noise every SAMPLE_TICKS; returns the RMS rate error over the last half
+ */
+static float run(float (*depthAt)(float), float (*rateAt)(float), float (*accelAt)(float),
+                 bool useAccel, float accelBias, int ticks) {
+    double sq = 0.0;
+    int n = 0;
+    for (int i = 0; i < ticks; i++) {
+        float t = i * DT;
+        DepthEstimator_predict(&est, accelAt(t) + accelBias, useAccel, DT);
+        if (i % SAMPLE_TICKS == 0)
+            DepthEstimator_correct(&est, depthAt(t) + noise(NOISE_M));
+        if (i >= ticks / 2) {
+            float e = est.rate - rateAt(t);
+            sq += e * e;
+            n++;
+        }
+    }
+    return (float)sqrt(sq / n);
+}
+
+static float descentDepth(float t) { return 1.0f + 0.3f * t; }
+static float descentRate(float t) { (void)t; return 0.3f; }
+static float zeroAccel(float t) { (void)t; return 0.0f; }
+
+// Bobbing: 0.2 m amplitude at 0.5 Hz
+#define BOB_W (2.0f * 3.14159265f * 0.5f)
+static float bobDepth(float t) { return 2.0f + 0.2f * sinf(BOB_W * t); }
+static float bobRate(float t) { return 0.2f * BOB_W * cosf(BOB_W * t); }
+static float bobAccel(float t) { return -0.2f * BOB_W * BOB_W * sinf(BOB_W * t); }
+
+void setUp(void) {
+    srand(1);
+    DepthEstimator_init(&est, NOISE_M);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Filter Tests
+// ============================================================================
+
+void test_primes_at_rest_on_first_sample(void) {
+    DepthEstimator_predict(&est, 1.0f, true, DT);
+    TEST_ASSERT_FALSE(est.primed);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, est.rate);
+
+    DepthEstimator_correct(&est, 3.0f);
+    TEST_ASSERT_TRUE(est.primed);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, est.depth);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, est.rate);
+
+    DepthEstimator_reset(&est);
+    TEST_ASSERT_FALSE(est.primed);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9f, NOISE_M * NOISE_M, est.noiseVar);
+}
+
+void test_descent_rate_cleaner_than_differencing(void) {
+    float rms = run(descentDepth, descentRate, zeroAccel, false, 0.0f, 1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, 0.3f, est.rate);
+    // Differencing samples 40 ms apart: noise sqrt(2) * 0.005 / sqrt(3) / 0.04 ~ 0.1 m/s
+    TEST_ASSERT_TRUE(rms < 0.04f);
+}
+
+void test_predicts_between_samples(void) {
+    run(descentDepth, descentRate, zeroAccel, false, 0.0f, 500);
+    // No sample for a few ticks: depth keeps moving at the rate
+    float before = est.depth;
+    for (int i = 0; i < 5; i++) DepthEstimator_predict(&est, 0.0f, false, DT);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, before + 0.3f * 5 * DT, est.depth);
+}
+
+// ============================================================================
+// Acceleration Tests
+// ============================================================================
+
+void test_accel_tracks_manoeuvre_better(void) {
+    float without = run(bobDepth, bobRate, bobAccel, false, 0.0f, 1500);
+    DepthEstimator_init(&est, NOISE_M);
+    srand(1);
+    float with = run(bobDepth, bobRate, bobAccel, true, 0.0f, 1500);
+    TEST_ASSERT_TRUE(with < without);
+    TEST_ASSERT_TRUE(with < 0.02f);
+}
+
+void test_accel_bias_learnt(void) {
+    // Steady descent, the accelerometer reads 0.2 m/s^2 too far down
+    float rms = run(descentDepth, descentRate, zeroAccel, true, 0.2f, 2000);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, -0.2f, est.accelBias);
+    TEST_ASSERT_TRUE(rms < 0.03f);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Filter Tests
+    RUN_TEST(test_primes_at_rest_on_first_sample);
+    RUN_TEST(test_descent_rate_cleaner_than_differencing);
+    RUN_TEST(test_predicts_between_samples);
+
+    // Acceleration Tests
+    RUN_TEST(test_accel_tracks_manoeuvre_better);
+    RUN_TEST(test_accel_bias_learnt);
+
+    return UNITY_END();
+}
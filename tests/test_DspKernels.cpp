@@ -0,0 +1,183 @@
+/**
+ * Unit Tests for DspKernels
+ * Tests the matrix product against hand-computed values (including
+ * non-square shapes), the dot product, and the biquad: DC gain of the
+ * low-pass design, state carried across blocks and in-place filtering,
+ * and the FFT against a direct DFT
+ *
+ * @file test_DspKernels.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "DspKernels.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define TOL 1e-5f
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Matrix Tests
+// ============================================================================
+
+void test_mat_mul_rectangular(void) {
+    const float A[2 * 3] = {1, 2, 3,
+                            4, 5, 6};
+    const float B[3 * 2] = {7, 8,
+                            9, 10,
+                            11, 12};
+    float C[2 * 2];
+    Dsp_matMul(A, B, C, 2, 3, 2);
+    TEST_ASSERT_FLOAT_WITHIN(TOL, 58.0f, C[0]);
+    TEST_ASSERT_FLOAT_WITHIN(TOL, 64.0f, C[1]);
+    TEST_ASSERT_FLOAT_WITHIN(TOL, 139.0f, C[2]);
+    TEST_ASSERT_FLOAT_WITHIN(TOL, 154.0f, C[3]);
+}
+
+void test_mat_mul_identity(void) {
+    float I[4 * 4] = {0};
+    float M[4 * 4];
+    float C[4 * 4];
+    for (int i = 0; i < 4; i++) I[i * 5] = 1.0f;
+    for (int i = 0; i < 16; i++) M[i] = 0.25f * i - 1.0f;
+    Dsp_matMul(I, M, C, 4, 4, 4);
+    for (int i = 0; i < 16; i++) TEST_ASSERT_EQUAL_FLOAT(M[i], C[i]);
+    Dsp_matMul(M, I, C, 4, 4, 4);
+    for (int i = 0; i < 16; i++) TEST_ASSERT_EQUAL_FLOAT(M[i], C[i]);
+}
+
+void test_dot(void) {
+    const float a[5] = {1, -2, 3, -4, 5};
+    const float b[5] = {0.5f, 0.5f, 0.5f, 0.5f, 2.0f};
+    TEST_ASSERT_FLOAT_WITHIN(TOL, 9.0f, Dsp_dot(a, b, 5));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, Dsp_dot(a, b, 0));
+}
+
+// ============================================================================
+// Biquad Tests
+// ============================================================================
+
+void test_lowpass_passes_dc(void) {
+    float coef[DSP_BIQUAD_COEFS];
+    Dsp_biquadLowpass(coef, 0.05f, 0.7071f);
+    // DC gain (b0 + b1 + b2) / (1 + a1 + a2) is 1
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f,
+                             (coef[0] + coef[1] + coef[2]) / (1.0f + coef[3] + coef[4]));
+
+    float w[2] = {0, 0};
+    float x[200];
+    for (int i = 0; i < 200; i++) x[i] = 3.0f;
+    Dsp_biquad(x, x, 200, coef, w);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 3.0f, x[199]);
+}
+
+void test_lowpass_stops_nyquist(void) {
+    float coef[DSP_BIQUAD_COEFS];
+    Dsp_biquadLowpass(coef, 0.05f, 0.7071f);
+    float w[2] = {0, 0};
+    float x[200];
+    for (int i = 0; i < 200; i++) x[i] = (i & 1) ? -1.0f : 1.0f;
+    Dsp_biquad(x, x, 200, coef, w);
+    for (int i = 150; i < 200; i++) TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, x[i]);
+}
+
+void test_state_carries_across_blocks(void) {
+    float coef[DSP_BIQUAD_COEFS];
+    Dsp_biquadLowpass(coef, 0.1f, 0.7071f);
+    float in[32];
+    for (int i = 0; i < 32; i++) in[i] = (float)((i * 7) % 11) - 5.0f;
+
+    float whole[32], split[32];
+    float w1[2] = {0, 0}, w2[2] = {0, 0};
+    Dsp_biquad(in, whole, 32, coef, w1);
+    Dsp_biquad(in, split, 13, coef, w2);
+    Dsp_biquad(in + 13, split + 13, 19, coef, w2);
+    for (int i = 0; i < 32; i++) TEST_ASSERT_FLOAT_WITHIN(TOL, whole[i], split[i]);
+}
+
+// ============================================================================
+// FFT Tests
+// ============================================================================
+
+void test_fft_matches_dft(void) {
+    const int N = 32;
+    float data[2 * N], in[2 * N];
+    for (int i = 0; i < N; i++) {
+        in[2 * i] = (float)((i * 11) % 7) - 3.0f;
+        in[2 * i + 1] = (float)((i * 5) % 3) - 1.0f;
+    }
+    memcpy(data, in, sizeof(data));
+    TEST_ASSERT_TRUE(Dsp_fftInit(64));
+    Dsp_fft(data, N);
+
+    for (int k = 0; k < N; k++) {
+        double re = 0.0, im = 0.0;
+        for (int n = 0; n < N; n++) {
+            double a = -2.0 * M_PI * k * n / N;
+            re += in[2 * n] * cos(a) - in[2 * n + 1] * sin(a);
+            im += in[2 * n] * sin(a) + in[2 * n + 1] * cos(a);
+        }
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, (float)re, data[2 * k]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, (float)im, data[2 * k + 1]);
+    }
+}
+
+void test_fft_tone_lands_in_its_bin(void) {
+    const int N = 128;
+    float data[2 * N];
+    for (int i = 0; i < N; i++) {
+        data[2 * i] = cosf(6.28318531f * 9.0f * (float)i / (float)N);
+        data[2 * i + 1] = 0.0f;
+    }
+    Dsp_fftInit(N);
+    Dsp_fft(data, N);
+    // A real cosine splits between bins k and N - k, N / 2 each
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 64.0f, data[2 * 9]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 64.0f, data[2 * (N - 9)]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 0.0f, data[2 * 10]);
+}
+
+void test_fft_init_rejects_bad_length(void) {
+    TEST_ASSERT_FALSE(Dsp_fftInit(0));
+    TEST_ASSERT_FALSE(Dsp_fftInit(96));
+}
+
+void test_impl_name(void) {
+    TEST_ASSERT_EQUAL_STRING("scalar", Dsp_implName());     // Host build
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Matrix Tests
+    RUN_TEST(test_mat_mul_rectangular);
+    RUN_TEST(test_mat_mul_identity);
+    RUN_TEST(test_dot);
+
+    // Biquad Tests
+    RUN_TEST(test_lowpass_passes_dc);
+    RUN_TEST(test_lowpass_stops_nyquist);
+    RUN_TEST(test_state_carries_across_blocks);
+
+    // FFT Tests
+    RUN_TEST(test_fft_matches_dft);
+    RUN_TEST(test_fft_tone_lands_in_its_bin);
+    RUN_TEST(test_fft_init_rejects_bad_length);
+    RUN_TEST(test_impl_name);
+
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+/**
+ * Unit Tests for DynamicNotch
+ * Tests the analysis cadence, tracking of a tone on either axis, a
+ * moving tone, the hold on a flat spectrum and the configuration limits
+ *
+ * @file test_DynamicNotch.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "DynamicNotch.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define FS 1000.0f
+#define TWO_PI_F 6.28318531f
+
+static DynamicNotch dn;
+static DynNotchConfig config;
+static uint32_t seed;
+
+static float noise(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / 16777216.0f - 0.5f;
+}
+
+// Feed samples of a tone (rad/s) on roll and / or pitch plus a little noise
+static void feed(int count, float hz, float rollAmp, float pitchAmp, int* start) {
+    for (int i = 0; i < count; i++, (*start)++) {
+        float phase = TWO_PI_F * hz * (float)*start / FS;
+        float rates[3] = {rollAmp * sinf(phase) + 0.02f * noise(),
+                          pitchAmp * cosf(phase) + 0.02f * noise(), 0.0f};
+        if (DynamicNotch_push(&dn, rates))
+            DynamicNotch_analyze(&dn);
+    }
+}
+
+void setUp(void) {
+    seed = 12345;
+    DynamicNotch_defaultConfig(&config);
+    config.enabled = true;
+    DynamicNotch_init(&dn, &config, FS);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Tracking Tests
+// ============================================================================
+
+void test_analysis_every_hop_once_full(void) {
+    float rates[3] = {0, 0, 0};
+    for (int i = 0; i < DYN_NOTCH_FFT_SIZE - 1; i++)
+        TEST_ASSERT_FALSE(DynamicNotch_push(&dn, rates));
+    TEST_ASSERT_TRUE(DynamicNotch_push(&dn, rates));
+    DynamicNotch_analyze(&dn);
+    for (int i = 0; i < DYN_NOTCH_HOP - 1; i++)
+        TEST_ASSERT_FALSE(DynamicNotch_push(&dn, rates));
+    TEST_ASSERT_TRUE(DynamicNotch_push(&dn, rates));
+}
+
+void test_tracks_roll_tone(void) {
+    int t = 0;
+    feed(2000, 230.0f, 1.0f, 0.0f, &t);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 230.0f, dn.centerHz);
+    TEST_ASSERT_TRUE(dn.locks > 0);
+}
+
+void test_tracks_pitch_tone(void) {
+    int t = 0;
+    feed(2000, 142.0f, 0.0f, 0.5f, &t);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 142.0f, dn.centerHz);
+}
+
+void test_follows_a_moving_tone(void) {
+    int t = 0;
+    feed(2000, 300.0f, 1.0f, 1.0f, &t);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 300.0f, dn.centerHz);
+    feed(2000, 180.0f, 1.0f, 1.0f, &t);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 180.0f, dn.centerHz);
+}
+
+void test_holds_without_a_peak(void) {
+    int t = 0;
+    feed(2000, 200.0f, 0.0f, 0.0f, &t);     // Noise only
+    TEST_ASSERT_EQUAL_FLOAT(config.maxHz, dn.centerHz);
+    TEST_ASSERT_TRUE(dn.analyses > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, dn.locks);
+}
+
+void test_ignores_tone_outside_band(void) {
+    int t = 0;
+    feed(2000, 40.0f, 2.0f, 2.0f, &t);      // Below minHz (80)
+    TEST_ASSERT_EQUAL_UINT32(0, dn.locks);
+}
+
+void test_coefs_notch_the_center(void) {
+    int t = 0;
+    feed(2000, 250.0f, 1.0f, 0.0f, &t);
+    BiquadCoefs c;
+    DynamicNotch_coefs(&dn, &c);
+    TEST_ASSERT_TRUE(Biquad_gain(&c, dn.centerHz, FS) < 1e-3f);
+    TEST_ASSERT_TRUE(Biquad_gain(&c, 250.0f, FS) < 0.1f);
+}
+
+// ============================================================================
+// Configuration Tests
+// ============================================================================
+
+void test_sanitize(void) {
+    DynNotchConfig c = {true, NAN, 900.0f, 50.0f};
+    DynamicNotch_sanitize(&c, FS);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f * FS / DYN_NOTCH_FFT_SIZE, c.minHz);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 450.0f, c.maxHz);
+    TEST_ASSERT_EQUAL_FLOAT(DYN_NOTCH_MAX_Q, c.q);
+
+    c = (DynNotchConfig){true, 300.0f, 200.0f, 0.0f};
+    DynamicNotch_sanitize(&c, FS);
+    TEST_ASSERT_EQUAL_FLOAT(300.0f, c.minHz);
+    TEST_ASSERT_TRUE(c.maxHz > c.minHz);
+    TEST_ASSERT_EQUAL_FLOAT(DYN_NOTCH_MIN_Q, c.q);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Tracking Tests
+    RUN_TEST(test_analysis_every_hop_once_full);
+    RUN_TEST(test_tracks_roll_tone);
+    RUN_TEST(test_tracks_pitch_tone);
+    RUN_TEST(test_follows_a_moving_tone);
+    RUN_TEST(test_holds_without_a_peak);
+    RUN_TEST(test_ignores_tone_outside_band);
+    RUN_TEST(test_coefs_notch_the_center);
+
+    // Configuration Tests
+    RUN_TEST(test_sanitize);
+
+    return UNITY_END();
+}
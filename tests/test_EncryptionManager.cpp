@@ -79,6 +79,46 @@ void test_EncryptionManager_generateIV_null_buffer(void) {
     TEST_ASSERT_FALSE(EncryptionManager_generateIV(NULL));
 }
 
+void test_EncryptionManager_generateIV_counter_mode(void) {
+    // Counter IVs share the session prefix and step by AES_CTR_BLOCKS_PER_IV
+    uint8_t iv1[AES_IV_SIZE];
+    uint8_t iv2[AES_IV_SIZE];
+
+    EncryptionManager_setIVMode(EM_IV_MODE_COUNTER);
+    TEST_ASSERT_TRUE(EncryptionManager_init(testKey));
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)EncryptionManager_getIVCounter());
+
+    TEST_ASSERT_TRUE(EncryptionManager_generateIV(iv1));
+    TEST_ASSERT_TRUE(EncryptionManager_generateIV(iv2));
+
+    TEST_ASSERT_EQUAL_MEMORY(iv1, iv2, AES_IV_PREFIX_SIZE);
+    TEST_ASSERT_EQUAL_UINT8(0, iv1[AES_IV_SIZE - 1]);
+    TEST_ASSERT_EQUAL_UINT8(AES_CTR_BLOCKS_PER_IV, iv2[AES_IV_SIZE - 1]);
+    TEST_ASSERT_EQUAL_UINT32(2 * AES_CTR_BLOCKS_PER_IV,
+                             (uint32_t)EncryptionManager_getIVCounter());
+
+    EncryptionManager_setIVMode(EM_IV_MODE_RANDOM);
+}
+
+void test_EncryptionManager_generateIV_counter_reinit_new_prefix(void) {
+    // Re-init (boot / key exchange) draws a new prefix and restarts the counter
+    uint8_t iv1[AES_IV_SIZE];
+    uint8_t iv2[AES_IV_SIZE];
+
+    EncryptionManager_setIVMode(EM_IV_MODE_COUNTER);
+    TEST_ASSERT_TRUE(EncryptionManager_init(testKey));
+    TEST_ASSERT_TRUE(EncryptionManager_generateIV(iv1));
+
+    TEST_ASSERT_TRUE(EncryptionManager_init(testKey));
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)EncryptionManager_getIVCounter());
+    TEST_ASSERT_TRUE(EncryptionManager_generateIV(iv2));
+
+    TEST_ASSERT_NOT_EQUAL(0, memcmp(iv1, iv2, AES_IV_PREFIX_SIZE));
+    TEST_ASSERT_EQUAL(EM_IV_MODE_COUNTER, EncryptionManager_getIVMode());
+
+    EncryptionManager_setIVMode(EM_IV_MODE_RANDOM);
+}
+
 // ============================================================================
 // Encryption/Decryption Tests
 // ============================================================================
@@ -136,6 +176,85 @@ void test_EncryptionManager_encrypt_payload_too_large(void) {
     TEST_ASSERT_FALSE(EncryptionManager_encrypt(plaintext, AES_MAX_PAYLOAD + 1, iv, ciphertext));
 }
 
+// ============================================================================
+// AEAD (AES-256-GCM) Tests
+// ============================================================================
+
+void test_EncryptionManager_aead_roundtrip(void) {
+    // GCM encrypt then decrypt should restore plaintext and verify the tag
+    uint8_t nonce[AES_GCM_NONCE_SIZE];
+    uint8_t aad[7] = {2, 1, 2, 0x10, 0x00, 0x00, 0x00};
+    uint8_t tag[AES_GCM_TAG_SIZE];
+
+    memset(nonce, 0x24, AES_GCM_NONCE_SIZE);
+    memset(plaintext, 0x42, 10);
+
+    TEST_ASSERT_TRUE(EncryptionManager_aeadEncrypt(plaintext, 10, nonce, aad,
+                                                   sizeof(aad), ciphertext, tag));
+    TEST_ASSERT_NOT_EQUAL(0, memcmp(plaintext, ciphertext, 10));
+    TEST_ASSERT_TRUE(EncryptionManager_aeadDecrypt(ciphertext, 10, nonce, aad,
+                                                   sizeof(aad), tag, decrypted));
+    TEST_ASSERT_EQUAL_MEMORY(plaintext, decrypted, 10);
+}
+
+void test_EncryptionManager_aead_rejects_tampered_ciphertext(void) {
+    // A flipped ciphertext bit must fail authentication
+    uint8_t nonce[AES_GCM_NONCE_SIZE];
+    uint8_t tag[AES_GCM_TAG_SIZE];
+
+    memset(nonce, 0x24, AES_GCM_NONCE_SIZE);
+    memset(plaintext, 0x42, 10);
+    memset(decrypted, 0x99, 10);
+
+    TEST_ASSERT_TRUE(EncryptionManager_aeadEncrypt(plaintext, 10, nonce, NULL, 0,
+                                                   ciphertext, tag));
+    ciphertext[3] ^= 0x01;
+    TEST_ASSERT_FALSE(EncryptionManager_aeadDecrypt(ciphertext, 10, nonce, NULL,
+                                                    0, tag, decrypted));
+
+    // Output buffer untouched on failure
+    TEST_ASSERT_EQUAL_UINT8(0x99, decrypted[0]);
+}
+
+void test_EncryptionManager_aead_rejects_tampered_aad(void) {
+    // Changing the clear header (e.g. sequence number) must fail authentication
+    uint8_t nonce[AES_GCM_NONCE_SIZE];
+    uint8_t aad[7] = {2, 1, 2, 0x10, 0x00, 0x00, 0x00};
+    uint8_t tag[AES_GCM_TAG_SIZE];
+
+    memset(nonce, 0x24, AES_GCM_NONCE_SIZE);
+    memset(plaintext, 0x42, 10);
+
+    TEST_ASSERT_TRUE(EncryptionManager_aeadEncrypt(plaintext, 10, nonce, aad,
+                                                   sizeof(aad), ciphertext, tag));
+    aad[3] = 0x11;
+    TEST_ASSERT_FALSE(EncryptionManager_aeadDecrypt(ciphertext, 10, nonce, aad,
+                                                    sizeof(aad), tag, decrypted));
+}
+
+void test_EncryptionManager_aead_truncated_tag(void) {
+    // Compact frames carry the leading 8 bytes of the tag
+    uint8_t nonce[AES_GCM_NONCE_SIZE];
+    uint8_t tag[AES_GCM_TAG_SIZE];
+
+    memset(nonce, 0x24, AES_GCM_NONCE_SIZE);
+    memset(plaintext, 0x42, 8);
+    TEST_ASSERT_TRUE(EncryptionManager_setPeerKey(0, testKey));
+    TEST_ASSERT_TRUE(EncryptionManager_aeadEncrypt(plaintext, 8, nonce, NULL, 0,
+                                                   ciphertext, tag));
+    TEST_ASSERT_TRUE(EncryptionManager_aeadDecryptFromTruncated(0, ciphertext, 8, nonce,
+                                                                NULL, 0, tag, 8, decrypted));
+    TEST_ASSERT_EQUAL_MEMORY(plaintext, decrypted, 8);
+
+    tag[7] ^= 0x01;
+    TEST_ASSERT_FALSE(EncryptionManager_aeadDecryptFromTruncated(0, ciphertext, 8, nonce,
+                                                                 NULL, 0, tag, 8, decrypted));
+    // Below 32 bits is refused outright
+    TEST_ASSERT_FALSE(EncryptionManager_aeadDecryptFromTruncated(0, ciphertext, 8, nonce,
+                                                                 NULL, 0, tag, 3, decrypted));
+    EncryptionManager_clearPeerKey(0);
+}
+
 void test_EncryptionManager_deriveKey_success(void) {
     // Key derivation should produce 32-byte key
     const char* password = "test_password_123";
@@ -187,10 +306,16 @@ void test_group_encryption_setup(void) {
     RUN_TEST(test_EncryptionManager_init_null_key);
     RUN_TEST(test_EncryptionManager_generateIV_success);
     RUN_TEST(test_EncryptionManager_generateIV_null_buffer);
+    RUN_TEST(test_EncryptionManager_generateIV_counter_mode);
+    RUN_TEST(test_EncryptionManager_generateIV_counter_reinit_new_prefix);
     RUN_TEST(test_EncryptionManager_encrypt_decrypt_roundtrip);
     RUN_TEST(test_EncryptionManager_encrypt_different_iv_different_ciphertext);
     RUN_TEST(test_EncryptionManager_encrypt_null_plaintext);
     RUN_TEST(test_EncryptionManager_encrypt_payload_too_large);
+    RUN_TEST(test_EncryptionManager_aead_roundtrip);
+    RUN_TEST(test_EncryptionManager_aead_rejects_tampered_ciphertext);
+    RUN_TEST(test_EncryptionManager_aead_rejects_tampered_aad);
+    RUN_TEST(test_EncryptionManager_aead_truncated_tag);
     RUN_TEST(test_EncryptionManager_deriveKey_success);
     RUN_TEST(test_EncryptionManager_deriveKey_insufficient_iterations);
 }
@@ -0,0 +1,172 @@
+/**
+ * Unit Tests for EscTelemetry
+ * Tests the KISS CRC and frame decoding, merging samples from the two
+ * paths, and the stale / stalled / hot health checks
+ *
+ * @file test_EscTelemetry.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "EscTelemetry.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static EscTelemetry telem;
+
+// 45 C, 16.20 V, 12.34 A, 321 mAh, 42000 eRPM
+static void kissFrame(uint8_t* frame) {
+    const uint8_t body[9] = {45, 0x06, 0x54, 0x04, 0xD2, 0x01, 0x41, 0x01, 0xA4};
+    memcpy(frame, body, sizeof(body));
+    frame[9] = EscTelemetry_crc8(body, sizeof(body));
+}
+
+static EscSample rpmSample(uint32_t erpm) {
+    EscSample s = {};
+    s.fields = ESC_FIELD_ERPM;
+    s.erpm = erpm;
+    return s;
+}
+
+void setUp(void) {
+    EscTelemetry_init(&telem, 4);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Decoding Tests
+// ============================================================================
+
+void test_crc8_check_value(void) {
+    TEST_ASSERT_EQUAL_HEX8(0xF4, EscTelemetry_crc8((const uint8_t*)"123456789", 9));
+}
+
+void test_parse_kiss_frame(void) {
+    uint8_t frame[ESC_KISS_FRAME_LEN];
+    kissFrame(frame);
+    EscSample s;
+    TEST_ASSERT_TRUE(EscTelemetry_parseKiss(frame, &s));
+    TEST_ASSERT_EQUAL_INT16(45, s.tempC);
+    TEST_ASSERT_EQUAL_UINT16(1620, s.centiVolts);
+    TEST_ASSERT_EQUAL_UINT16(1234, s.centiAmps);
+    TEST_ASSERT_EQUAL_UINT16(321, s.mAh);
+    TEST_ASSERT_EQUAL_UINT32(42000, s.erpm);
+    TEST_ASSERT_EQUAL_HEX8(0x1F, s.fields);
+}
+
+void test_parse_rejects_bad_crc(void) {
+    uint8_t frame[ESC_KISS_FRAME_LEN];
+    kissFrame(frame);
+    frame[3] ^= 0x10;
+    EscSample s = {};
+    TEST_ASSERT_FALSE(EscTelemetry_parseKiss(frame, &s));
+    TEST_ASSERT_EQUAL_HEX8(0, s.fields);
+}
+
+// ============================================================================
+// State Tests
+// ============================================================================
+
+void test_record_merges_fields(void) {
+    uint8_t frame[ESC_KISS_FRAME_LEN];
+    kissFrame(frame);
+    EscSample kiss;
+    EscTelemetry_parseKiss(frame, &kiss);
+    EscTelemetry_record(&telem, 2, &kiss, 100);
+
+    EscSample dshot = rpmSample(50000);
+    EscTelemetry_record(&telem, 2, &dshot, 110);
+    const EscMotorTelemetry* m = &telem.motors[2];
+    TEST_ASSERT_EQUAL_UINT32(50000, m->last.erpm);      // Newer eRPM
+    TEST_ASSERT_EQUAL_INT16(45, m->last.tempC);         // Kept from KISS
+    TEST_ASSERT_EQUAL_UINT32(2, m->samples);
+    TEST_ASSERT_EQUAL_UINT32(110, m->erpmMs);
+
+    EscTelemetry_record(&telem, 7, &dshot, 120);        // Out of range
+    EscTelemetry_recordError(&telem, 2);
+    TEST_ASSERT_EQUAL_UINT32(1, m->errors);
+}
+
+// ============================================================================
+// Health Tests
+// ============================================================================
+
+void test_no_telemetry_is_not_a_fault(void) {
+    const int16_t cmd[4] = {50, 50, 50, 50};
+    TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_OK, EscTelemetry_checkHealth(&telem, cmd, 10000));
+}
+
+void test_stale(void) {
+    EscSample s = rpmSample(20000);
+    EscTelemetry_record(&telem, 1, &s, 1000);
+    const int16_t cmd[4] = {0, 0, 0, 0};
+    TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_OK, EscTelemetry_checkHealth(&telem, cmd, 1400));
+    TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_STALE, EscTelemetry_checkHealth(&telem, cmd, 1600));
+    TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_STALE, telem.motors[1].health);
+}
+
+void test_stalled_after_spin_up_time(void) {
+    const int16_t cmd[4] = {0, 0, 0, 40};
+    uint32_t now = 1000;
+    for (; now < 1000 + ESC_STALL_MS; now += 20) {
+        EscSample s = rpmSample(0);
+        EscTelemetry_record(&telem, 3, &s, now);
+        TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_OK, EscTelemetry_checkHealth(&telem, cmd, now));
+    }
+    EscSample s = rpmSample(0);
+    EscTelemetry_record(&telem, 3, &s, now);
+    TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_STALLED, EscTelemetry_checkHealth(&telem, cmd, now));
+
+    // Spins up: clears at once
+    s = rpmSample(30000);
+    EscTelemetry_record(&telem, 3, &s, now + 20);
+    TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_OK, EscTelemetry_checkHealth(&telem, cmd, now + 20));
+}
+
+void test_idle_motor_is_not_stalled(void) {
+    const int16_t cmd[4] = {5, 5, 5, 5};
+    for (uint32_t now = 0; now < 1000; now += 20) {
+        EscSample s = rpmSample(0);
+        EscTelemetry_record(&telem, 0, &s, now);
+        TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_OK, EscTelemetry_checkHealth(&telem, cmd, now));
+    }
+}
+
+void test_hot(void) {
+    EscSample s = {};
+    s.fields = ESC_FIELD_TEMP;
+    s.tempC = ESC_HOT_C;
+    EscTelemetry_record(&telem, 0, &s, 500);
+    const int16_t cmd[4] = {0, 0, 0, 0};
+    TEST_ASSERT_EQUAL_HEX8(ESC_HEALTH_HOT, EscTelemetry_checkHealth(&telem, cmd, 510));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Decoding Tests
+    RUN_TEST(test_crc8_check_value);
+    RUN_TEST(test_parse_kiss_frame);
+    RUN_TEST(test_parse_rejects_bad_crc);
+
+    // State Tests
+    RUN_TEST(test_record_merges_fields);
+
+    // Health Tests
+    RUN_TEST(test_no_telemetry_is_not_a_fault);
+    RUN_TEST(test_stale);
+    RUN_TEST(test_stalled_after_spin_up_time);
+    RUN_TEST(test_idle_motor_is_not_stalled);
+    RUN_TEST(test_hot);
+
+    return UNITY_END();
+}
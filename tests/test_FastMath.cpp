@@ -0,0 +1,137 @@
+/**
+ * Unit Tests for FastMath
+ * Sweeps each kernel against double-precision libm and checks the
+ * documented worst-case error, wrap ranges and quadrant handling
+ *
+ * @file test_FastMath.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "FastMath.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define SWEEP_STEPS 200000
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Wrap Tests
+// ============================================================================
+
+void test_wrap_pi_range_and_identity(void) {
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, FastMath_wrapPi(1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -FAST_MATH_PI + 0.5f, FastMath_wrapPi(FAST_MATH_PI + 0.5f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, FAST_MATH_PI - 0.5f, FastMath_wrapPi(-FAST_MATH_PI - 0.5f));
+
+    for (int i = 0; i <= SWEEP_STEPS; i++) {
+        float a = -1000.0f + 2000.0f * i / SWEEP_STEPS;
+        float w = FastMath_wrapPi(a);
+        TEST_ASSERT_TRUE(w >= -FAST_MATH_PI && w <= FAST_MATH_PI);
+        // Same angle: differs by a whole number of turns
+        double turns = ((double)a - w) / (2.0 * M_PI);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, round(turns), turns);
+    }
+}
+
+void test_wrap_180_matches_loop_version(void) {
+    TEST_ASSERT_EQUAL_FLOAT(-170.0f, FastMath_wrap180(190.0f));
+    TEST_ASSERT_EQUAL_FLOAT(170.0f, FastMath_wrap180(-190.0f));
+    TEST_ASSERT_EQUAL_FLOAT(-180.0f, FastMath_wrap180(180.0f));
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, FastMath_wrap180(730.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, FastMath_wrap180(0.0f));
+}
+
+// ============================================================================
+// Trig Tests
+// ============================================================================
+
+void test_sin_cos_error_bound(void) {
+    double worst = 0.0;
+    for (int i = 0; i <= SWEEP_STEPS; i++) {
+        float a = -20.0f + 40.0f * i / SWEEP_STEPS;
+        float s, c;
+        FastMath_sinCos(a, &s, &c);
+        double es = fabs(s - sin((double)a));
+        double ec = fabs(c - cos((double)a));
+        if (es > worst) worst = es;
+        if (ec > worst) worst = ec;
+    }
+    TEST_ASSERT_TRUE(worst < FAST_MATH_SIN_MAX_ERR);
+}
+
+void test_atan2_error_bound_all_quadrants(void) {
+    double worst = 0.0;
+    for (int i = 0; i < SWEEP_STEPS; i++) {
+        double a = -M_PI + 2.0 * M_PI * i / SWEEP_STEPS;
+        for (int k = 0; k < 3; k++) {
+            double r = k == 0 ? 1e-3 : (k == 1 ? 1.0 : 5e4);
+            float y = (float)(r * sin(a)), x = (float)(r * cos(a));
+            double e = fabs(FastMath_atan2(y, x) - atan2((double)y, (double)x));
+            if (e > M_PI) e = 2.0 * M_PI - e;     // +/-pi are the same angle
+            if (e > worst) worst = e;
+        }
+    }
+    TEST_ASSERT_TRUE(worst < FAST_MATH_ATAN2_MAX_ERR);
+}
+
+void test_atan2_axes(void) {
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, FastMath_atan2(0.0f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, FastMath_atan2(0.0f, 2.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, FAST_MATH_HALF_PI, FastMath_atan2(3.0f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -FAST_MATH_HALF_PI, FastMath_atan2(-3.0f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, FAST_MATH_PI, FastMath_atan2(0.0f, -1.0f));
+}
+
+// ============================================================================
+// Square Root Tests
+// ============================================================================
+
+void test_inv_sqrt_relative_error_bound(void) {
+    double worst = 0.0;
+    for (int i = 0; i <= SWEEP_STEPS; i++) {
+        // Log sweep 1e-6 .. 1e6
+        float x = (float)pow(10.0, -6.0 + 12.0 * i / SWEEP_STEPS);
+        double ref = 1.0 / sqrt((double)x);
+        double e = fabs(FastMath_invSqrt(x) - ref) / ref;
+        if (e > worst) worst = e;
+    }
+    TEST_ASSERT_TRUE(worst < FAST_MATH_INV_SQRT_MAX_ERR);
+}
+
+void test_sqrt_zero_and_negative(void) {
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, FastMath_sqrt(0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, FastMath_sqrt(-4.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.0f, FastMath_sqrt(9.0f));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Wrap Tests
+    RUN_TEST(test_wrap_pi_range_and_identity);
+    RUN_TEST(test_wrap_180_matches_loop_version);
+
+    // Trig Tests
+    RUN_TEST(test_sin_cos_error_bound);
+    RUN_TEST(test_atan2_error_bound_all_quadrants);
+    RUN_TEST(test_atan2_axes);
+
+    // Square Root Tests
+    RUN_TEST(test_inv_sqrt_relative_error_bound);
+    RUN_TEST(test_sqrt_zero_and_negative);
+
+    return UNITY_END();
+}
@@ -0,0 +1,261 @@
+/**
+ * Unit Tests for FleetOta
+ * Tests chunking, the sender's pass and repair queue, the receiver's
+ * NACK timing and suppression, and a lossy fleet update end to end
+ *
+ * @file test_FleetOta.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "FleetOta.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define IMAGE_ID    0x1234ABCDu
+#define FLEET_SIZE  20
+
+static FleetOtaTx tx;
+static FleetOtaRx rx;
+static FleetOtaRx fleet[FLEET_SIZE];
+static uint8_t bits[FLEET_OTA_NACK_BITS / 8];
+
+static uint32_t lcg = 1;
+static uint32_t nextRandom(void) {
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+void setUp(void) {
+    FleetOtaTx_init(&tx);
+    FleetOtaRx_init(&rx);
+    memset(bits, 0, sizeof(bits));
+    lcg = 1;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Chunking Tests
+// ============================================================================
+
+void test_chunk_count_and_length(void) {
+    TEST_ASSERT_EQUAL_UINT16(5, FleetOta_chunkCount(5 * FLEET_OTA_CHUNK_SIZE));
+    TEST_ASSERT_EQUAL_UINT16(6, FleetOta_chunkCount(5 * FLEET_OTA_CHUNK_SIZE + 1));
+    TEST_ASSERT_EQUAL_UINT16(0, FleetOta_chunkCount(0));
+    TEST_ASSERT_EQUAL_UINT16(0, FleetOta_chunkCount(FLEET_OTA_MAX_CHUNKS * FLEET_OTA_CHUNK_SIZE + 1));
+
+    uint32_t size = 5 * FLEET_OTA_CHUNK_SIZE + 1;
+    TEST_ASSERT_EQUAL_UINT16(FLEET_OTA_CHUNK_SIZE, FleetOta_chunkLength(size, 4));
+    TEST_ASSERT_EQUAL_UINT16(1, FleetOta_chunkLength(size, 5));
+    TEST_ASSERT_EQUAL_UINT16(0, FleetOta_chunkLength(size, 6));
+}
+
+// ============================================================================
+// Sender Tests
+// ============================================================================
+
+void test_sender_full_pass_in_order(void) {
+    TEST_ASSERT_TRUE(FleetOtaTx_begin(&tx, 21 * FLEET_OTA_CHUNK_SIZE - 7));
+    TEST_ASSERT_EQUAL_UINT16(21, tx.pendingCount);
+    uint16_t index;
+    for (uint16_t i = 0; i < 21; i++) {
+        TEST_ASSERT_TRUE(FleetOtaTx_next(&tx, &index));
+        TEST_ASSERT_EQUAL_UINT16(i, index);
+    }
+    TEST_ASSERT_FALSE(FleetOtaTx_next(&tx, &index));
+    TEST_ASSERT_FALSE(FleetOtaTx_begin(&tx, 0));
+}
+
+void test_sender_repairs_nacked_chunks(void) {
+    FleetOtaTx_begin(&tx, 40 * FLEET_OTA_CHUNK_SIZE);
+    uint16_t index;
+    while (FleetOtaTx_next(&tx, &index)) {}
+
+    // Window from chunk 8: 8 + 3 and 8 + 20 missing, bit past the end ignored
+    bits[0] = 1u << 3;
+    bits[2] = 1u << 4;
+    bits[10] = 0xFF;
+    TEST_ASSERT_EQUAL_UINT16(2, FleetOtaTx_nack(&tx, 8, bits));
+    TEST_ASSERT_EQUAL_UINT16(1, tx.round);
+    TEST_ASSERT_EQUAL_UINT16(0, FleetOtaTx_nack(&tx, 8, bits));   // Already queued
+    TEST_ASSERT_EQUAL_UINT16(1, tx.round);
+
+    TEST_ASSERT_TRUE(FleetOtaTx_next(&tx, &index));
+    TEST_ASSERT_EQUAL_UINT16(11, index);
+    TEST_ASSERT_TRUE(FleetOtaTx_next(&tx, &index));
+    TEST_ASSERT_EQUAL_UINT16(28, index);
+    TEST_ASSERT_FALSE(FleetOtaTx_next(&tx, &index));
+    TEST_ASSERT_EQUAL_UINT32(2, tx.repairs);
+}
+
+// ============================================================================
+// Receiver Tests
+// ============================================================================
+
+void test_receiver_accept(void) {
+    TEST_ASSERT_EQUAL(FLEET_CHUNK_FOREIGN, FleetOtaRx_accept(&rx, IMAGE_ID, 0, 0));
+    TEST_ASSERT_TRUE(FleetOtaRx_begin(&rx, IMAGE_ID, 3 * FLEET_OTA_CHUNK_SIZE, 0));
+    TEST_ASSERT_EQUAL(FLEET_CHUNK_NEW, FleetOtaRx_accept(&rx, IMAGE_ID, 1, 10));
+    TEST_ASSERT_EQUAL(FLEET_CHUNK_DUPLICATE, FleetOtaRx_accept(&rx, IMAGE_ID, 1, 11));
+    TEST_ASSERT_EQUAL(FLEET_CHUNK_FOREIGN, FleetOtaRx_accept(&rx, IMAGE_ID + 1, 0, 12));
+    TEST_ASSERT_EQUAL(FLEET_CHUNK_FOREIGN, FleetOtaRx_accept(&rx, IMAGE_ID, 3, 12));
+    FleetOtaRx_accept(&rx, IMAGE_ID, 0, 13);
+    TEST_ASSERT_FALSE(FleetOtaRx_complete(&rx));
+    FleetOtaRx_accept(&rx, IMAGE_ID, 2, 14);
+    TEST_ASSERT_TRUE(FleetOtaRx_complete(&rx));
+    FleetOtaRx_drop(&rx, 2);
+    TEST_ASSERT_FALSE(FleetOtaRx_complete(&rx));
+    TEST_ASSERT_EQUAL_UINT32(1, rx.duplicates);
+}
+
+void test_receiver_nacks_after_quiet(void) {
+    // 300 chunks; everything but 17 and 299 arrives
+    FleetOtaRx_begin(&rx, IMAGE_ID, 300 * FLEET_OTA_CHUNK_SIZE, 0);
+    for (uint16_t i = 0; i < 300; i++)
+        if (i != 17 && i != 299) FleetOtaRx_accept(&rx, IMAGE_ID, i, 1000);
+
+    uint16_t base;
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&rx, 1000 + FLEET_OTA_QUIET_MS - 1, 0, &base, bits));
+    // Quiet: the burst starts after the random delay
+    uint32_t t = 1000 + FLEET_OTA_QUIET_MS;
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&rx, t, 50, &base, bits));
+    t += 50;
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&rx, t, 0, &base, bits));
+    TEST_ASSERT_EQUAL_UINT16(16, base);
+    TEST_ASSERT_EQUAL_HEX8(0x02, bits[0]);
+    for (int j = 1; j < FLEET_OTA_NACK_BITS / 8; j++) TEST_ASSERT_EQUAL_HEX8(0, bits[j]);
+
+    // 299 is in the next window: clipped at the last chunk
+    t += FLEET_OTA_NACK_GAP_MS;
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&rx, t, 0, &base, bits));
+    TEST_ASSERT_EQUAL_UINT16(296, base);
+    TEST_ASSERT_EQUAL_HEX8(0x08, bits[0]);
+    TEST_ASSERT_EQUAL_HEX8(0, bits[1]);
+
+    // Nothing answered: asked again only after the retry interval
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&rx, t + FLEET_OTA_NACK_RETRY_MS - 1, 0, &base, bits));
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&rx, t + FLEET_OTA_NACK_RETRY_MS, 0, &base, bits));
+    TEST_ASSERT_EQUAL_UINT16(16, base);
+}
+
+void test_receiver_reports_every_window(void) {
+    // Gaps in three windows: one burst, FLEET_OTA_NACK_GAP_MS apart
+    FleetOtaRx_begin(&rx, IMAGE_ID, 1000 * FLEET_OTA_CHUNK_SIZE, 0);
+    for (uint16_t i = 0; i < 1000; i++)
+        if (i != 5 && i != 400 && i != 999) FleetOtaRx_accept(&rx, IMAGE_ID, i, 0);
+
+    uint16_t base;
+    uint32_t t = FLEET_OTA_QUIET_MS;
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&rx, t, 0, &base, bits));
+    TEST_ASSERT_EQUAL_UINT16(0, base);
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&rx, t + FLEET_OTA_NACK_GAP_MS - 1, 0, &base, bits));
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&rx, t + FLEET_OTA_NACK_GAP_MS, 0, &base, bits));
+    TEST_ASSERT_EQUAL_UINT16(400, base);
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&rx, t + 2 * FLEET_OTA_NACK_GAP_MS, 0, &base, bits));
+    TEST_ASSERT_EQUAL_UINT16(992, base);
+    TEST_ASSERT_EQUAL_HEX8(0x80, bits[0]);
+    // Burst over
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&rx, t + 3 * FLEET_OTA_NACK_GAP_MS, 0, &base, bits));
+    TEST_ASSERT_EQUAL_UINT32(3, rx.nacksSent);
+}
+
+void test_overheard_nack_suppresses(void) {
+    FleetOtaRx other;
+    FleetOtaRx_begin(&rx, IMAGE_ID, 100 * FLEET_OTA_CHUNK_SIZE, 0);
+    FleetOtaRx_begin(&other, IMAGE_ID, 100 * FLEET_OTA_CHUNK_SIZE, 0);
+    for (uint16_t i = 0; i < 100; i++) {
+        if (i != 40) FleetOtaRx_accept(&rx, IMAGE_ID, i, 0);
+        if (i != 40 && i != 41) FleetOtaRx_accept(&other, IMAGE_ID, i, 0);
+    }
+
+    // Both go quiet together; ours is due later
+    uint16_t base;
+    uint8_t ours[FLEET_OTA_NACK_BITS / 8];
+    uint32_t t = FLEET_OTA_QUIET_MS;
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&rx, t, 100, &base, ours));
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&other, t, 0, &base, bits));
+
+    // The other receiver asks for 40 and 41: covers our gap, we skip it
+    FleetOtaRx_overhear(&rx, IMAGE_ID, base, bits, t);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.nacksSuppressed);
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&rx, t + 100, 0, &base, ours));
+
+    // Ours (40 only) does not cover theirs
+    t += FLEET_OTA_NACK_RETRY_MS;
+    TEST_ASSERT_FALSE(FleetOtaRx_poll(&other, t, 100, &base, bits));
+    TEST_ASSERT_TRUE(FleetOtaRx_poll(&rx, t, 0, &base, ours));
+    FleetOtaRx_overhear(&other, IMAGE_ID, base, ours, t);
+    TEST_ASSERT_EQUAL_UINT32(0, other.nacksSuppressed);
+}
+
+// ============================================================================
+// Fleet Tests
+// ============================================================================
+
+// One sender, FLEET_SIZE receivers, every frame lost independently with
+// 20% chance; one chunk per ms
+void test_lossy_fleet_update(void) {
+    const uint16_t chunks = 600;
+    FleetOtaTx_begin(&tx, chunks * FLEET_OTA_CHUNK_SIZE);
+    for (int v = 0; v < FLEET_SIZE; v++)
+        FleetOtaRx_begin(&fleet[v], IMAGE_ID, chunks * FLEET_OTA_CHUNK_SIZE, 0);
+
+    uint32_t nacks = 0;
+    uint32_t now = 0;
+    int done = 0;
+    for (; now < 60000 && done < FLEET_SIZE; now++) {
+        uint16_t index;
+        if (FleetOtaTx_next(&tx, &index)) {
+            for (int v = 0; v < FLEET_SIZE; v++)
+                if (nextRandom() % 100 >= 20) FleetOtaRx_accept(&fleet[v], IMAGE_ID, index, now);
+        }
+        done = 0;
+        for (int v = 0; v < FLEET_SIZE; v++) {
+            uint16_t base;
+            if (FleetOtaRx_poll(&fleet[v], now, nextRandom(), &base, bits)) {
+                nacks++;
+                if (nextRandom() % 100 >= 20) FleetOtaTx_nack(&tx, base, bits);
+                for (int o = 0; o < FLEET_SIZE; o++)
+                    if (o != v && nextRandom() % 100 >= 20)
+                        FleetOtaRx_overhear(&fleet[o], IMAGE_ID, base, bits, now);
+            }
+            done += FleetOtaRx_complete(&fleet[v]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(FLEET_SIZE, done);
+    // Each chunk is missed by someone almost every pass, so it goes out a
+    // few times; one at a time the fleet would take FLEET_SIZE / 0.8 times
+    TEST_ASSERT_TRUE(tx.sent < 4u * chunks);
+    TEST_ASSERT_TRUE(now < 10u * chunks);
+    TEST_ASSERT_TRUE(nacks < 20u * FLEET_SIZE);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Chunking Tests
+    RUN_TEST(test_chunk_count_and_length);
+
+    // Sender Tests
+    RUN_TEST(test_sender_full_pass_in_order);
+    RUN_TEST(test_sender_repairs_nacked_chunks);
+
+    // Receiver Tests
+    RUN_TEST(test_receiver_accept);
+    RUN_TEST(test_receiver_nacks_after_quiet);
+    RUN_TEST(test_receiver_reports_every_window);
+    RUN_TEST(test_overheard_nack_suppresses);
+
+    // Fleet Tests
+    RUN_TEST(test_lossy_fleet_update);
+
+    return UNITY_END();
+}
@@ -0,0 +1,160 @@
+/**
+ * Unit Tests for FlyByWire
+ * Tests the angle -> rate cascade, turn coordination, slew limiting and
+ * a closed loop against a simple roll model
+ *
+ * @file test_FlyByWire.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "FlyByWire.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DEG 0.0174532925f
+
+static FlyByWire fbw;
+static FbwConfig config;
+
+void setUp(void) {
+    FlyByWire_defaultConfig(&config);
+    FlyByWire_init(&fbw, &config);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Angle Loop Tests
+// ============================================================================
+
+void test_stick_commands_bank_angle(void) {
+    // Level, half right stick: 22.5 deg bank wanted
+    FlyByWire_updateAngle(&fbw, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 4.0f * 22.5f * DEG, fbw.rateSetpoint[FBW_AXIS_ROLL]);
+
+    // Already there: no more roll rate
+    FlyByWire_updateAngle(&fbw, 0.5f, 0.0f, 22.5f * DEG, 0.0f, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, fbw.rateSetpoint[FBW_AXIS_ROLL]);
+}
+
+void test_rate_setpoint_clamped(void) {
+    FlyByWire_updateAngle(&fbw, 1.0f, -1.0f, -40.0f * DEG, 30.0f * DEG, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 120.0f * DEG, fbw.rateSetpoint[FBW_AXIS_ROLL]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -60.0f * DEG, fbw.rateSetpoint[FBW_AXIS_PITCH]);
+}
+
+void test_turn_coordination(void) {
+    // 30 deg bank at 12 m/s: psi' = g tan(30) / 12
+    float turn = 9.80665f * tanf(30.0f * DEG) / 12.0f;
+    FlyByWire_updateAngle(&fbw, 30.0f / 45.0f, 0.0f, 30.0f * DEG, 0.0f, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, turn * sinf(30.0f * DEG), fbw.rateSetpoint[FBW_AXIS_PITCH]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, turn * cosf(30.0f * DEG), fbw.turnYawRate);
+
+    // Left bank: nose still up, yaw left; faster = gentler turn
+    FlyByWire_updateAngle(&fbw, -30.0f / 45.0f, 0.0f, -30.0f * DEG, 0.0f, 24.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.5f * turn * sinf(30.0f * DEG),
+                             fbw.rateSetpoint[FBW_AXIS_PITCH]);
+    TEST_ASSERT_TRUE(fbw.turnYawRate < 0.0f);
+}
+
+// ============================================================================
+// Output Tests
+// ============================================================================
+
+void test_surfaces_slew_limited(void) {
+    FlyByWire_updateAngle(&fbw, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    float rates[FBW_AXIS_COUNT] = {0.0f, 0.0f};
+    FlyByWire_updateRate(&fbw, rates, 0.001f, true);
+    TEST_ASSERT_TRUE(fbw.rateOutput[FBW_AXIS_ROLL] > 0.5f);
+
+    float out[FBW_SURFACE_COUNT];
+    FlyByWire_output(&fbw, 0.0f, 0.02f, out);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.08f, out[FBW_SURFACE_AILERON]);  // 4/s * 20 ms
+    FlyByWire_output(&fbw, 0.0f, 0.02f, out);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.16f, out[FBW_SURFACE_AILERON]);
+}
+
+void test_rudder_mix(void) {
+    config.slewPerSec = 0.0f;
+    config.turnYawGain = 0.0f;
+    FlyByWire_init(&fbw, &config);
+    fbw.rateOutput[FBW_AXIS_ROLL] = 0.5f;
+    float out[FBW_SURFACE_COUNT];
+    FlyByWire_output(&fbw, 0.1f, 0.02f, out);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, out[FBW_SURFACE_AILERON]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.1f + 0.2f * 0.5f, out[FBW_SURFACE_RUDDER]);
+}
+
+void test_sanitize(void) {
+    FbwConfig c = config;
+    c.maxBankDeg = 90.0f;
+    c.cruiseMps = 0.0f;
+    c.rateKp = -1.0f;
+    FlyByWire_sanitize(&c);
+    TEST_ASSERT_EQUAL_FLOAT(70.0f, c.maxBankDeg);
+    TEST_ASSERT_EQUAL_FLOAT(FBW_MIN_SPEED_MPS, c.cruiseMps);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.rateKp);
+}
+
+void test_retune_has_no_step(void) {
+    FlyByWire_updateAngle(&fbw, 0.3f, 0.0f, 0.0f, 0.0f, 0.0f);
+    float rates[FBW_AXIS_COUNT] = {0.1f, 0.0f};
+    for (int i = 0; i < 50; i++) FlyByWire_updateRate(&fbw, rates, 0.001f, true);
+    float before = fbw.rateOutput[FBW_AXIS_ROLL];
+
+    FbwConfig next = config;
+    next.rateKp = 1.0f;
+    FlyByWire_setConfig(&fbw, &next);
+    FlyByWire_updateRate(&fbw, rates, 0.001f, true);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, before, fbw.rateOutput[FBW_AXIS_ROLL]);
+}
+
+// ============================================================================
+// Closed Loop Tests
+// ============================================================================
+
+void test_holds_commanded_bank(void) {
+    // Roll rate follows aileron with a 0.1 s lag, 3 rad/s at full throw
+    float bank = 0.0f, rate = 0.0f;
+    for (int tick = 0; tick < 150; tick++) {            // 3 s at 50 Hz
+        FlyByWire_updateAngle(&fbw, 2.0f / 3.0f, 0.0f, bank, 0.0f, 0.0f);
+        for (int s = 0; s < 20; s++) {                  // 1 kHz rate loop
+            float rates[FBW_AXIS_COUNT] = {rate, 0.0f};
+            FlyByWire_updateRate(&fbw, rates, 0.001f, true);
+            float ail = fbw.surface[FBW_SURFACE_AILERON];
+            rate += (3.0f * ail - rate) * (0.001f / 0.1f);
+            bank += rate * 0.001f;
+        }
+        float out[FBW_SURFACE_COUNT];
+        FlyByWire_output(&fbw, 0.0f, 0.02f, out);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0f * DEG, 30.0f * DEG, bank);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Angle Loop Tests
+    RUN_TEST(test_stick_commands_bank_angle);
+    RUN_TEST(test_rate_setpoint_clamped);
+    RUN_TEST(test_turn_coordination);
+
+    // Output Tests
+    RUN_TEST(test_surfaces_slew_limited);
+    RUN_TEST(test_rudder_mix);
+    RUN_TEST(test_sanitize);
+    RUN_TEST(test_retune_has_no_step);
+
+    // Closed Loop Tests
+    RUN_TEST(test_holds_commanded_bank);
+
+    return UNITY_END();
+}
@@ -0,0 +1,149 @@
+/**
+ * Unit Tests for FormationTable
+ * Tests neighbour tracking, sequence / timeout rules, the bounded table,
+ * the airtime budget and the follower slot geometry
+ *
+ * @file test_FormationTable.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "FormationTable.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static FormationTable table;
+static FormationState state;
+
+static const uint8_t* macOf(uint8_t n) {
+    static uint8_t mac[FORMATION_MAC_SIZE];
+    const uint8_t base[FORMATION_MAC_SIZE] = {0x24, 0x6F, 0x28, 0x20, 0x00, 0x00};
+    memcpy(mac, base, sizeof(mac));
+    mac[5] = n;
+    return mac;
+}
+
+void setUp(void) {
+    FormationTable_init(&table);
+    memset(&state, 0, sizeof(state));
+    state.flags = FORMATION_FLAG_POSITION;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Neighbour Tests
+// ============================================================================
+
+void test_new_then_updated(void) {
+    state.missionIndex = 3;
+    TEST_ASSERT_EQUAL(FORMATION_RX_NEW, FormationTable_update(&table, macOf(1), 10, &state, 1000));
+    state.missionIndex = 4;
+    TEST_ASSERT_EQUAL(FORMATION_RX_UPDATED, FormationTable_update(&table, macOf(1), 11, &state, 1200));
+
+    const FormationNeighbor* n = FormationTable_find(&table, macOf(1), 1300);
+    TEST_ASSERT_NOT_NULL(n);
+    TEST_ASSERT_EQUAL_UINT16(4, n->state.missionIndex);
+    TEST_ASSERT_EQUAL_UINT32(2, n->beacons);
+    TEST_ASSERT_NULL(FormationTable_find(&table, macOf(2), 1300));
+}
+
+void test_stale_sequence_ignored(void) {
+    FormationTable_update(&table, macOf(1), 10, &state, 1000);
+    TEST_ASSERT_EQUAL(FORMATION_RX_STALE, FormationTable_update(&table, macOf(1), 10, &state, 1100));
+    TEST_ASSERT_EQUAL(FORMATION_RX_STALE, FormationTable_update(&table, macOf(1), 9, &state, 1100));
+    TEST_ASSERT_EQUAL_UINT32(2, table.stale);
+    TEST_ASSERT_EQUAL_UINT32(1000, FormationTable_find(&table, macOf(1), 1100)->lastSeenMs);
+}
+
+void test_timeout_allows_restart(void) {
+    FormationTable_update(&table, macOf(1), 500, &state, 1000);
+    uint32_t later = 1000 + FORMATION_NEIGHBOR_TIMEOUT_MS;
+    TEST_ASSERT_NULL(FormationTable_find(&table, macOf(1), later));
+    TEST_ASSERT_EQUAL(0, FormationTable_liveCount(&table, later));
+
+    // Rebooted neighbour: counter back at 1
+    TEST_ASSERT_EQUAL(FORMATION_RX_NEW, FormationTable_update(&table, macOf(1), 1, &state, later));
+    TEST_ASSERT_EQUAL(1, FormationTable_liveCount(&table, later));
+}
+
+void test_full_table_keeps_live_neighbours(void) {
+    for (uint8_t n = 0; n < FORMATION_MAX_NEIGHBORS; n++)
+        FormationTable_update(&table, macOf(n), 1, &state, 1000 + n);
+    TEST_ASSERT_EQUAL(FORMATION_RX_FULL, FormationTable_update(&table, macOf(99), 1, &state, 1500));
+    TEST_ASSERT_EQUAL_UINT32(1, table.dropped);
+
+    // Keep all but neighbour 0 alive; the newcomer takes its entry
+    uint32_t now = 1000 + FORMATION_NEIGHBOR_TIMEOUT_MS;
+    for (uint8_t n = 1; n < FORMATION_MAX_NEIGHBORS; n++)
+        FormationTable_update(&table, macOf(n), 2, &state, now - 10);
+    TEST_ASSERT_EQUAL(FORMATION_RX_NEW, FormationTable_update(&table, macOf(99), 1, &state, now));
+    TEST_ASSERT_NULL(FormationTable_find(&table, macOf(0), now));
+    TEST_ASSERT_NOT_NULL(FormationTable_find(&table, macOf(99), now));
+    TEST_ASSERT_EQUAL(FORMATION_MAX_NEIGHBORS, FormationTable_liveCount(&table, now));
+}
+
+// ============================================================================
+// Budget Tests
+// ============================================================================
+
+void test_interval_follows_rate_when_alone(void) {
+    TEST_ASSERT_EQUAL_UINT16(200, FormationTable_intervalMs(5, FORMATION_DEFAULT_BUDGET_BPS, 0));
+    TEST_ASSERT_EQUAL_UINT16(50, FormationTable_intervalMs(50, 0, 0));   // Clamped to max rate
+}
+
+void test_interval_stretches_with_swarm(void) {
+    uint32_t budget = FORMATION_DEFAULT_BUDGET_BPS;
+    for (uint8_t n = 0; n < FORMATION_MAX_NEIGHBORS; n++) {
+        uint16_t interval = FormationTable_intervalMs(10, budget, n);
+        // Everyone in range at this interval stays within the budget
+        uint32_t load = (uint32_t)(n + 1) * FORMATION_FRAME_AIR_BYTES * 1000 / interval;
+        TEST_ASSERT_TRUE(load <= budget);
+        TEST_ASSERT_TRUE(interval >= 100);
+    }
+    // Starved budget: never slower than the cap
+    TEST_ASSERT_EQUAL_UINT16(FORMATION_MAX_INTERVAL_MS, FormationTable_intervalMs(5, 100, 7));
+}
+
+// ============================================================================
+// Follow Geometry Tests
+// ============================================================================
+
+void test_follow_target_in_leader_frame(void) {
+    NavVector leader = {100.0f, 50.0f};
+    state.heading = 90.0f;                  // Leader heading east
+    NavVector slot = Formation_followTarget(leader, &state, 3.0f, 5.0f, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 95.0f, slot.east);     // 5 m behind = west
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 47.0f, slot.north);    // 3 m right = south
+
+    state.velEast = 2.0f;
+    slot = Formation_followTarget(leader, &state, 0.0f, 0.0f, 0.5f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 101.0f, slot.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, slot.north);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Neighbour Tests
+    RUN_TEST(test_new_then_updated);
+    RUN_TEST(test_stale_sequence_ignored);
+    RUN_TEST(test_timeout_allows_restart);
+    RUN_TEST(test_full_table_keeps_live_neighbours);
+
+    // Budget Tests
+    RUN_TEST(test_interval_follows_rate_when_alone);
+    RUN_TEST(test_interval_stretches_with_swarm);
+
+    // Follow Geometry Tests
+    RUN_TEST(test_follow_target_in_leader_frame);
+
+    return UNITY_END();
+}
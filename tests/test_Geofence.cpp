@@ -0,0 +1,150 @@
+/**
+ * Unit Tests for Geofence
+ * Tests point-in-polygon, inclusion / exclusion, the distance limit and
+ * frame re-anchoring
+ *
+ * @file test_Geofence.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "Geofence.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define HOME_LAT 137563000      // Bangkok, deg * 1e7
+#define HOME_LNG 1005018000
+#define E7_PER_M 90             // ~1.1 cm per LSB, close enough for 1 m steps
+
+static Geofence fence;
+static NavFrame frame;
+
+void setUp(void) {
+    Geofence_init(&fence);
+    NavFrame_init(&frame, HOME_LAT, HOME_LNG);
+}
+
+void tearDown(void) {}
+
+/**
+ * Square of side 2 * half meters around an offset from home
+ */
+static void addSquare(GeofenceType type, int32_t east, int32_t north, int32_t half) {
+    int32_t lat[4], lng[4];
+    const int32_t corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (int i = 0; i < 4; i++) {
+        lat[i] = HOME_LAT + (north + corners[i][1] * half) * E7_PER_M;
+        lng[i] = HOME_LNG + (east + corners[i][0] * half) * E7_PER_M;
+    }
+    TEST_ASSERT_TRUE(Geofence_addPolygon(&fence, type, lat, lng, 4));
+}
+
+static NavVector at(float east, float north) {
+    NavVector v = {east, north};
+    return v;
+}
+
+// ============================================================================
+// Polygon Tests
+// ============================================================================
+
+void test_inclusion_square(void) {
+    addSquare(GEOFENCE_INCLUSION, 0, 0, 100);
+    Geofence_setFrame(&fence, &frame);
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(0, 0), NULL));
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(90, -90), NULL));
+    TEST_ASSERT_EQUAL(GEOFENCE_BREACH_INCLUSION, Geofence_check(&fence, at(120, 0), NULL));
+    TEST_ASSERT_EQUAL(GEOFENCE_BREACH_INCLUSION, Geofence_check(&fence, at(0, -130), NULL));
+}
+
+void test_exclusion_inside_inclusion(void) {
+    addSquare(GEOFENCE_INCLUSION, 0, 0, 100);
+    addSquare(GEOFENCE_EXCLUSION, 50, 50, 10);
+    Geofence_setFrame(&fence, &frame);
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(30, 50), NULL));
+    TEST_ASSERT_EQUAL(GEOFENCE_BREACH_EXCLUSION, Geofence_check(&fence, at(52, 47), NULL));
+}
+
+void test_concave_polygon(void) {
+    // "U" shape: notch between east 20..80 above north 20
+    const float pts[8][2] = {{0, 0}, {100, 0}, {100, 100}, {80, 100},
+                             {80, 20}, {20, 20}, {20, 100}, {0, 100}};
+    int32_t lat[8], lng[8];
+    for (int i = 0; i < 8; i++) {
+        lng[i] = HOME_LNG + (int32_t)(pts[i][0] * E7_PER_M);
+        lat[i] = HOME_LAT + (int32_t)(pts[i][1] * E7_PER_M);
+    }
+    Geofence_addPolygon(&fence, GEOFENCE_INCLUSION, lat, lng, 8);
+    Geofence_setFrame(&fence, &frame);
+
+    const GeofencePolygon* p = &fence.polygons[0];
+    TEST_ASSERT_TRUE(Geofence_contains(p, at(10, 80)));
+    TEST_ASSERT_TRUE(Geofence_contains(p, at(50, 10)));
+    TEST_ASSERT_FALSE(Geofence_contains(p, at(50, 60)));     // In the notch
+    TEST_ASSERT_TRUE(Geofence_contains(p, at(90, 80)));
+}
+
+void test_bad_polygons_refused(void) {
+    int32_t lat[3] = {0, 1, 2};
+    int32_t lng[3] = {0, 1, 0};
+    TEST_ASSERT_FALSE(Geofence_addPolygon(&fence, GEOFENCE_INCLUSION, lat, lng, 2));
+    for (int i = 0; i < GEOFENCE_MAX_POLYGONS; i++) {
+        TEST_ASSERT_TRUE(Geofence_addPolygon(&fence, GEOFENCE_EXCLUSION, lat, lng, 3));
+    }
+    TEST_ASSERT_FALSE(Geofence_addPolygon(&fence, GEOFENCE_EXCLUSION, lat, lng, 3));
+}
+
+// ============================================================================
+// Distance / Frame Tests
+// ============================================================================
+
+void test_max_distance_from_home(void) {
+    NavVector home = at(10, 10);
+    Geofence_setMaxDistance(&fence, 50.0f);
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(40, 50), &home));
+    TEST_ASSERT_EQUAL(GEOFENCE_BREACH_DISTANCE, Geofence_check(&fence, at(50, 50), &home));
+    // No home: not checked
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(500, 500), NULL));
+    Geofence_setMaxDistance(&fence, 0.0f);
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(500, 500), &home));
+}
+
+void test_reanchor_rebuilds_edges(void) {
+    addSquare(GEOFENCE_INCLUSION, 0, 0, 100);
+    Geofence_setFrame(&fence, &frame);
+
+    // Frame moved 200 m north: the same square is now 200 m south of origin
+    NavFrame moved;
+    NavFrame_init(&moved, HOME_LAT + 200 * E7_PER_M, HOME_LNG);
+    Geofence_setFrame(&fence, &moved);
+    TEST_ASSERT_EQUAL(GEOFENCE_BREACH_INCLUSION, Geofence_check(&fence, at(0, 0), NULL));
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(0, -200), NULL));
+}
+
+void test_unbuilt_fence_never_breaches(void) {
+    addSquare(GEOFENCE_INCLUSION, 0, 0, 10);
+    TEST_ASSERT_EQUAL(GEOFENCE_OK, Geofence_check(&fence, at(1000, 0), NULL));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Polygon Tests
+    RUN_TEST(test_inclusion_square);
+    RUN_TEST(test_exclusion_inside_inclusion);
+    RUN_TEST(test_concave_polygon);
+    RUN_TEST(test_bad_polygons_refused);
+
+    // Distance / Frame Tests
+    RUN_TEST(test_max_distance_from_home);
+    RUN_TEST(test_reanchor_rebuilds_edges);
+    RUN_TEST(test_unbuilt_fence_never_breaches);
+
+    return UNITY_END();
+}
@@ -0,0 +1,102 @@
+/**
+ * Unit Tests for the HAL time base
+ * Tests that the 64-bit clock runs past the 32-bit microsecond wrap, that
+ * the millisecond and microsecond reads come from the same clock, and the
+ * duration helpers (saturation, integrator step fallback and clamp)
+ *
+ * @file test_HAL.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "HAL.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define WRAP_US 4294967296LL    // 2^32 us, ~71.6 min
+
+void setUp(void) {
+    NativeClock_setMicros(0);
+}
+
+void tearDown(void) {
+    NativeClock_useHostTime();
+}
+
+// ============================================================================
+// Clock Tests
+// ============================================================================
+
+void test_clock_runs_past_the_32_bit_wrap(void) {
+    NativeClock_setMicros(WRAP_US - 500);
+    HAL_Micros before = HAL_Now();
+    uint32_t before32 = HAL_GetMicros();
+    NativeClock_advanceMicros(1000);
+
+    TEST_ASSERT_TRUE(HAL_Now() > before);
+    TEST_ASSERT_TRUE(HAL_Elapsed(before, HAL_Now()) == 1000);
+    TEST_ASSERT_TRUE(HAL_GetMicros() < before32);             // 32-bit read wrapped
+    TEST_ASSERT_EQUAL_UINT32(1000, HAL_GetMicros() - before32); // Interval still right
+}
+
+void test_millis_and_micros_share_the_clock(void) {
+    NativeClock_setMicros(3 * WRAP_US + 123456789LL);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(HAL_Now() / 1000), HAL_GetMillis());
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)HAL_Now(), HAL_GetMicros());
+}
+
+void test_cycles_convert_to_micros(void) {
+    uint32_t start = HAL_GetCycles();
+    NativeClock_advanceMicros(250);
+    TEST_ASSERT_EQUAL_UINT32(250, HAL_CyclesToMicros(HAL_GetCycles() - start));
+}
+
+// ============================================================================
+// Duration Tests
+// ============================================================================
+
+void test_elapsed_never_negative(void) {
+    TEST_ASSERT_TRUE(HAL_Elapsed(2000, 1000) == 0);
+    TEST_ASSERT_TRUE(HAL_Elapsed(WRAP_US, 6 * WRAP_US) == 5 * WRAP_US);
+}
+
+void test_millis_conversion_saturates(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, HAL_MicrosToMillis(-5));
+    TEST_ASSERT_EQUAL_UINT32(4294967, HAL_MicrosToMillis(WRAP_US));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFUL, HAL_MicrosToMillis(2000 * WRAP_US));
+}
+
+void test_step_seconds(void) {
+    HAL_Micros last = 0;
+    TEST_ASSERT_EQUAL_FLOAT(0.01f, HAL_StepSeconds(&last, WRAP_US, 0.01f, 0.1f));
+    TEST_ASSERT_TRUE(last == WRAP_US);
+
+    // Across the 32-bit wrap
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.02f, HAL_StepSeconds(&last, WRAP_US + 20000, 0.01f, 0.1f));
+
+    // A stall is clamped
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, HAL_StepSeconds(&last, WRAP_US + 5000000, 0.01f, 0.1f));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Clock Tests
+    RUN_TEST(test_clock_runs_past_the_32_bit_wrap);
+    RUN_TEST(test_millis_and_micros_share_the_clock);
+    RUN_TEST(test_cycles_convert_to_micros);
+
+    // Duration Tests
+    RUN_TEST(test_elapsed_never_negative);
+    RUN_TEST(test_millis_conversion_saturates);
+    RUN_TEST(test_step_seconds);
+
+    return UNITY_END();
+}
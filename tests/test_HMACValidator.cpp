@@ -8,6 +8,8 @@
 
 #include <unity.h>
 #include "../HMACValidator.h"
+#include "mbedtls/base64.h"
+#include <stdio.h>
 #include <string.h>
 
 // ============================================================================
@@ -208,6 +210,75 @@ void test_HMACValidator_error_message_on_large_payload(void) {
     TEST_ASSERT_NOT_EQUAL(0, strlen(error));
 }
 
+// ============================================================================
+// JSON Line Tests
+// ============================================================================
+
+static void signCanonical(const char* canonical, char* b64, size_t b64Size) {
+    uint8_t mac[HMAC_SHA256_SIZE];
+    size_t outLen = 0;
+    HMACValidator_generate((const uint8_t*)canonical, strlen(canonical), mac);
+    mbedtls_base64_encode((unsigned char*)b64, b64Size, &outLen, mac, sizeof(mac));
+}
+
+void test_HMACValidator_validateJsonLine_trailing_member(void) {
+    // MAC covers the line with ,"hmac":"..." cut out
+    char b64[64];
+    char line[160];
+    signCanonical("{\"c\":\"sm\",\"t\":5}", b64, sizeof(b64));
+    snprintf(line, sizeof(line), "{\"c\":\"sm\",\"t\":5,\"hmac\":\"%s\"}", b64);
+
+    size_t len = strlen(line);
+    TEST_ASSERT_TRUE(HMACValidator_validateJsonLine(line, &len));
+    TEST_ASSERT_EQUAL_STRING("{\"c\":\"sm\",\"t\":5}", line);
+    TEST_ASSERT_EQUAL(strlen(line), len);
+}
+
+void test_HMACValidator_validateJsonLine_leading_member(void) {
+    // First member: the following comma is removed instead
+    char b64[64];
+    char line[160];
+    signCanonical("{\"c\":\"es\"}", b64, sizeof(b64));
+    snprintf(line, sizeof(line), "{\"hmac\":\"%s\",\"c\":\"es\"}", b64);
+
+    size_t len = strlen(line);
+    TEST_ASSERT_TRUE(HMACValidator_validateJsonLine(line, &len));
+    TEST_ASSERT_EQUAL_STRING("{\"c\":\"es\"}", line);
+}
+
+void test_HMACValidator_validateJsonLine_tampered(void) {
+    // Changing any other byte of the line invalidates the MAC
+    char b64[64];
+    char line[160];
+    signCanonical("{\"c\":\"sm\",\"t\":5}", b64, sizeof(b64));
+    snprintf(line, sizeof(line), "{\"c\":\"sm\",\"t\":9,\"hmac\":\"%s\"}", b64);
+
+    size_t len = strlen(line);
+    TEST_ASSERT_FALSE(HMACValidator_validateJsonLine(line, &len));
+}
+
+void test_HMACValidator_validateJsonLine_missing_member(void) {
+    // No hmac member: nothing to validate against
+    char line[] = "{\"c\":\"sm\",\"note\":\"hmac\"}";
+    size_t len = strlen(line);
+    TEST_ASSERT_FALSE(HMACValidator_validateJsonLine(line, &len));
+}
+
+void test_HMACValidator_validateBase64(void) {
+    // Same MAC as generate(), sent apart from the data
+    char b64[64];
+    signCanonical("config image", b64, sizeof(b64));
+    TEST_ASSERT_TRUE(HMACValidator_validateBase64((const uint8_t*)"config image", 12, b64));
+    TEST_ASSERT_FALSE(HMACValidator_validateBase64((const uint8_t*)"config imagf", 12, b64));
+    TEST_ASSERT_FALSE(HMACValidator_validateBase64((const uint8_t*)"config image", 12, "AAAA"));
+
+    // Past HMAC_MAX_PAYLOAD: computed, just not matching
+    uint8_t big[4 * HMAC_MAX_PAYLOAD];
+    memset(big, 0x5A, sizeof(big));
+    TEST_ASSERT_FALSE(HMACValidator_validateBase64(big, sizeof(big), b64));
+    TEST_ASSERT_FALSE(HMACValidator_validateBase64(big, sizeof(big), NULL));
+}
+
 // ============================================================================
 // Integration Tests
 // ============================================================================
@@ -260,6 +331,11 @@ void test_group_hmac_validation_setup(void) {
     RUN_TEST(test_HMACValidator_reinit_after_reset);
     RUN_TEST(test_HMACValidator_error_message_on_null_secret);
     RUN_TEST(test_HMACValidator_error_message_on_large_payload);
+    RUN_TEST(test_HMACValidator_validateJsonLine_trailing_member);
+    RUN_TEST(test_HMACValidator_validateJsonLine_leading_member);
+    RUN_TEST(test_HMACValidator_validateJsonLine_tampered);
+    RUN_TEST(test_HMACValidator_validateJsonLine_missing_member);
+    RUN_TEST(test_HMACValidator_validateBase64);
     RUN_TEST(test_HMACValidator_multiple_validations);
     RUN_TEST(test_HMACValidator_attack_detection);
 }
@@ -0,0 +1,127 @@
+/**
+ * Unit Tests for HostProtocol
+ * Tests COBS encoding and CRC-checked binary framing
+ *
+ * @file test_HostProtocol.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "HostProtocol.h"
+#include "NAPacket.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t encoded[HOST_FRAME_MAX_ENCODED];
+static uint8_t decoded[HOST_FRAME_MAX_ENCODED];
+
+void setUp(void) {
+    memset(encoded, 0xEE, sizeof(encoded));
+    memset(decoded, 0xEE, sizeof(decoded));
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// COBS Tests
+// ============================================================================
+
+void test_cobs_encode_known_vector(void) {
+    const uint8_t in[] = {0x11, 0x22, 0x00, 0x33};
+    const uint8_t expected[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+
+    size_t len = HostProtocol_cobsEncode(in, sizeof(in), encoded);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, encoded, sizeof(expected));
+}
+
+void test_cobs_roundtrip_with_zeros(void) {
+    const uint8_t in[] = {0x00, 0x00, 0x01, 0x0A, 0x00};
+
+    size_t encLen = HostProtocol_cobsEncode(in, sizeof(in), encoded);
+    for (size_t i = 0; i < encLen; i++) {
+        TEST_ASSERT_NOT_EQUAL(0x00, encoded[i]);
+    }
+
+    size_t decLen = HostProtocol_cobsDecode(encoded, encLen, decoded);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(in), decLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, decoded, sizeof(in));
+}
+
+void test_cobs_decode_rejects_truncated(void) {
+    const uint8_t bad[] = {0x05, 0x11, 0x22};
+    TEST_ASSERT_EQUAL_UINT32(0, HostProtocol_cobsDecode(bad, sizeof(bad), decoded));
+}
+
+// ============================================================================
+// Framing Tests
+// ============================================================================
+
+void test_frame_roundtrip_telemetry(void) {
+    NATelemetry tel;
+    memset(&tel, 0, sizeof(tel));
+    tel.protocolVersion = PROTOCOL_VERSION;
+    tel.batteryVoltage = 12.6f;
+    tel.uptime = 123456;
+
+    size_t frameLen = HostProtocol_buildFrame(HOST_FRAME_TELEMETRY, &tel,
+                                              sizeof(tel), encoded,
+                                              sizeof(encoded));
+    TEST_ASSERT_TRUE(frameLen > sizeof(tel));
+    TEST_ASSERT_EQUAL_UINT8(0x00, encoded[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, encoded[frameLen - 1]);
+
+    uint8_t type = 0;
+    NATelemetry out;
+    int payloadLen = HostProtocol_parseFrame(&encoded[1], frameLen - 2, &type,
+                                             (uint8_t *)&out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT((int)sizeof(tel), payloadLen);
+    TEST_ASSERT_EQUAL_UINT8(HOST_FRAME_TELEMETRY, type);
+    TEST_ASSERT_EQUAL_MEMORY(&tel, &out, sizeof(tel));
+}
+
+void test_frame_crc_mismatch_rejected(void) {
+    const uint8_t payload[] = {1, 2, 3, 4};
+    size_t frameLen = HostProtocol_buildFrame(HOST_FRAME_CONTROL, payload,
+                                              sizeof(payload), encoded,
+                                              sizeof(encoded));
+
+    // Corrupt one payload byte (stays non-zero so COBS is still valid)
+    encoded[3] ^= 0x40;
+
+    uint8_t type;
+    TEST_ASSERT_EQUAL_INT(-1, HostProtocol_parseFrame(&encoded[1], frameLen - 2,
+                                                      &type, decoded,
+                                                      sizeof(decoded)));
+}
+
+void test_frame_payload_too_large_rejected(void) {
+    static uint8_t big[HOST_FRAME_MAX_PAYLOAD + 1];
+    TEST_ASSERT_EQUAL_UINT32(0, HostProtocol_buildFrame(HOST_FRAME_CONTROL, big,
+                                                        sizeof(big), encoded,
+                                                        sizeof(encoded)));
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // COBS Tests
+    RUN_TEST(test_cobs_encode_known_vector);
+    RUN_TEST(test_cobs_roundtrip_with_zeros);
+    RUN_TEST(test_cobs_decode_rejects_truncated);
+
+    // Framing Tests
+    RUN_TEST(test_frame_roundtrip_telemetry);
+    RUN_TEST(test_frame_crc_mismatch_rejected);
+    RUN_TEST(test_frame_payload_too_large_rejected);
+
+    return UNITY_END();
+}
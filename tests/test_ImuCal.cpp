@@ -0,0 +1,225 @@
+/**
+ * Unit Tests for ImuCal
+ * Tests correction from a stored record, first-window bias, stillness
+ * detection, temperature slope fitting, turn rejection, level accel
+ * offsets, record sanitizing and the save decision
+ *
+ * @file test_ImuCal.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "ImuCal.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static ImuCal cal;
+static ImuCalRecord rec;
+static const float LEVEL[3] = {0.0f, 0.0f, IMU_CAL_GRAVITY};
+
+// Feed one window of constant samples; returns the last feed() result
+static bool feedWindow(const float gyro[3], const float accel[3], float tempC) {
+    bool changed = false;
+    for (int i = 0; i < IMU_CAL_WINDOW; i++)
+        changed = ImuCal_feed(&cal, gyro, accel, tempC);
+    return changed;
+}
+
+// Feed one window alternating +-amp on every gyro axis around gyro
+static bool feedShaking(const float gyro[3], float amp) {
+    bool changed = false;
+    for (int i = 0; i < IMU_CAL_WINDOW; i++) {
+        float s = (i & 1) ? amp : -amp;
+        float g[3] = {gyro[0] + s, gyro[1] + s, gyro[2] + s};
+        changed = ImuCal_feed(&cal, g, LEVEL, 25.0f);
+    }
+    return changed;
+}
+
+void setUp(void) {
+    ImuCal_defaultRecord(&rec);
+    ImuCal_init(&cal, &rec);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Correction Tests
+// ============================================================================
+
+void test_default_applies_nothing(void) {
+    float g[3] = {0.1f, -0.2f, 0.3f};
+    float a[3] = {1.0f, 2.0f, 9.0f};
+    ImuCal_apply(&cal, g, a, 30.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, g[0]);
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, a[2]);
+}
+
+void test_stored_record_applies_from_first_sample(void) {
+    rec.flags = IMU_CAL_HAVE_GYRO | IMU_CAL_HAVE_SLOPE | IMU_CAL_HAVE_ACCEL;
+    rec.refTempC = 25.0f;
+    rec.gyroBias[0] = 0.01f;
+    rec.gyroSlope[0] = 0.001f;
+    rec.accelOffset[2] = 0.2f;
+    ImuCal_init(&cal, &rec);
+    float g[3] = {0.02f, 0.0f, 0.0f};
+    float a[3] = {0.0f, 0.0f, 10.0f};
+    ImuCal_apply(&cal, g, a, 35.0f);            // Bias 0.01 + 10 * 0.001
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, g[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 9.8f, a[2]);
+}
+
+// ============================================================================
+// Learning Tests
+// ============================================================================
+
+void test_first_still_window_sets_bias(void) {
+    float bias[3] = {0.004f, -0.003f, 0.002f};
+    TEST_ASSERT_TRUE(feedWindow(bias, LEVEL, 30.0f));
+    TEST_ASSERT_TRUE(cal.cal.flags & IMU_CAL_HAVE_GYRO);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -0.003f, cal.cal.gyroBias[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 30.0f, cal.cal.refTempC);
+    TEST_ASSERT_EQUAL(1, cal.stillWindows);
+}
+
+void test_moving_window_not_learned(void) {
+    float zero[3] = {0.0f, 0.0f, 0.0f};
+    TEST_ASSERT_FALSE(feedShaking(zero, 0.05f));
+    TEST_ASSERT_FALSE(cal.still);
+    TEST_ASSERT_EQUAL(1, cal.movingWindows);
+    TEST_ASSERT_FALSE(cal.cal.flags & IMU_CAL_HAVE_GYRO);
+}
+
+void test_not_one_g_is_not_still(void) {
+    float zero[3] = {0.0f, 0.0f, 0.0f};
+    float falling[3] = {0.0f, 0.0f, 2.0f};
+    TEST_ASSERT_FALSE(feedWindow(zero, falling, 25.0f));
+    TEST_ASSERT_EQUAL(1, cal.movingWindows);
+}
+
+void test_small_noise_is_still(void) {
+    float bias[3] = {0.01f, 0.0f, 0.0f};
+    TEST_ASSERT_TRUE(feedShaking(bias, 0.002f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.01f, cal.cal.gyroBias[0]);
+}
+
+void test_bias_tracks_drift(void) {
+    float bias[3] = {0.01f, 0.0f, 0.0f};
+    feedWindow(bias, LEVEL, 25.0f);
+    float drifted[3] = {0.02f, 0.0f, 0.0f};
+    for (int i = 0; i < 30; i++)
+        feedWindow(drifted, LEVEL, 25.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.02f, cal.cal.gyroBias[0]);
+}
+
+void test_slow_turn_rejected(void) {
+    float bias[3] = {0.01f, 0.0f, 0.0f};
+    feedWindow(bias, LEVEL, 25.0f);
+    float turning[3] = {0.01f, 0.0f, 0.2f};
+    TEST_ASSERT_FALSE(feedWindow(turning, LEVEL, 25.0f));
+    TEST_ASSERT_EQUAL(1, cal.rejectedWindows);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, cal.cal.gyroBias[2]);
+}
+
+void test_temperature_slope_fitted(void) {
+    // Bias 0.01 + 0.0005 per degC above 20 degC, warming 20 -> 30 degC
+    for (int i = 0; i <= 20; i++) {
+        float t = 20.0f + i * 0.5f;
+        float g[3] = {0.01f + 0.0005f * (t - 20.0f), 0.0f, 0.0f};
+        feedWindow(g, LEVEL, t);
+    }
+    TEST_ASSERT_TRUE(cal.cal.flags & IMU_CAL_HAVE_SLOPE);
+    TEST_ASSERT_FLOAT_WITHIN(2e-5f, 0.0005f, cal.cal.gyroSlope[0]);
+    float b[3];
+    ImuCal_gyroBias(&cal, 40.0f, b);
+    TEST_ASSERT_FLOAT_WITHIN(5e-4f, 0.02f, b[0]);
+}
+
+void test_level_sets_accel_offset(void) {
+    float zero[3] = {0.0f, 0.0f, 0.0f};
+    float tilted[3] = {0.3f, -0.2f, IMU_CAL_GRAVITY + 0.1f};
+    feedWindow(zero, tilted, 25.0f);
+    TEST_ASSERT_FALSE(cal.cal.flags & IMU_CAL_HAVE_ACCEL);
+    ImuCal_requestLevel(&cal);
+    TEST_ASSERT_TRUE(feedWindow(zero, tilted, 25.0f));
+    TEST_ASSERT_TRUE(cal.cal.flags & IMU_CAL_HAVE_ACCEL);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.3f, cal.cal.accelOffset[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.1f, cal.cal.accelOffset[2]);
+    TEST_ASSERT_FALSE(cal.levelRequested);
+}
+
+void test_reset_forgets_model(void) {
+    float bias[3] = {0.01f, 0.0f, 0.0f};
+    feedWindow(bias, LEVEL, 25.0f);
+    ImuCal_reset(&cal);
+    TEST_ASSERT_EQUAL(0, cal.cal.flags);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, cal.cal.gyroBias[0]);
+}
+
+// ============================================================================
+// Storage Tests
+// ============================================================================
+
+void test_sanitize_rejects_bad_record(void) {
+    rec.flags = IMU_CAL_HAVE_GYRO;
+    rec.gyroBias[1] = NAN;
+    TEST_ASSERT_FALSE(ImuCal_sanitize(&rec));
+    TEST_ASSERT_EQUAL(0, rec.flags);
+    ImuCal_defaultRecord(&rec);
+    rec.version = IMU_CAL_VERSION + 1;
+    TEST_ASSERT_FALSE(ImuCal_sanitize(&rec));
+    ImuCal_defaultRecord(&rec);
+    rec.gyroSlope[0] = 1.0f;
+    TEST_ASSERT_FALSE(ImuCal_sanitize(&rec));
+    ImuCal_defaultRecord(&rec);
+    rec.flags = 0xFF;
+    TEST_ASSERT_TRUE(ImuCal_sanitize(&rec));
+    TEST_ASSERT_EQUAL(IMU_CAL_HAVE_GYRO | IMU_CAL_HAVE_SLOPE | IMU_CAL_HAVE_ACCEL, rec.flags);
+}
+
+void test_needs_save_on_first_bias_then_drift(void) {
+    TEST_ASSERT_FALSE(ImuCal_needsSave(&cal));
+    float bias[3] = {0.01f, 0.0f, 0.0f};
+    feedWindow(bias, LEVEL, 25.0f);
+    TEST_ASSERT_TRUE(ImuCal_needsSave(&cal));
+    ImuCal_markSaved(&cal);
+    TEST_ASSERT_FALSE(ImuCal_needsSave(&cal));
+    float close[3] = {0.011f, 0.0f, 0.0f};
+    feedWindow(close, LEVEL, 25.0f);
+    TEST_ASSERT_FALSE(ImuCal_needsSave(&cal));
+    float drifted[3] = {0.03f, 0.0f, 0.0f};
+    feedWindow(drifted, LEVEL, 25.0f);
+    TEST_ASSERT_TRUE(ImuCal_needsSave(&cal));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Correction Tests
+    RUN_TEST(test_default_applies_nothing);
+    RUN_TEST(test_stored_record_applies_from_first_sample);
+
+    // Learning Tests
+    RUN_TEST(test_first_still_window_sets_bias);
+    RUN_TEST(test_moving_window_not_learned);
+    RUN_TEST(test_not_one_g_is_not_still);
+    RUN_TEST(test_small_noise_is_still);
+    RUN_TEST(test_bias_tracks_drift);
+    RUN_TEST(test_slow_turn_rejected);
+    RUN_TEST(test_temperature_slope_fitted);
+    RUN_TEST(test_level_sets_accel_offset);
+    RUN_TEST(test_reset_forgets_model);
+
+    // Storage Tests
+    RUN_TEST(test_sanitize_rejects_bad_record);
+    RUN_TEST(test_needs_save_on_first_bias_then_drift);
+
+    return UNITY_END();
+}
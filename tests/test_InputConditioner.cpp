@@ -0,0 +1,178 @@
+/**
+ * Unit Tests for InputConditioner
+ * Tests hold, extrapolation and slew between samples, the gap bound,
+ * restarting after a gap, the low-pass and configuration limits
+ *
+ * @file test_InputConditioner.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "InputConditioner.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define MS 1000LL
+#define TICK_S 0.01f
+
+static InputConditioner ic;
+static InputCondConfig config;
+
+static void sample(int16_t throttle, int16_t roll, HAL_Micros at) {
+    int16_t axes[INPUT_COND_AXES] = {throttle, roll, 0, 0};
+    InputConditioner_sample(&ic, axes, at);
+}
+
+static int16_t roll_at(HAL_Micros now) {
+    int16_t axes[INPUT_COND_AXES] = {0};
+    InputConditioner_output(&ic, now, TICK_S, axes);
+    return axes[1];
+}
+
+static void use_mode(InputCondMode mode) {
+    config.mode = mode;
+    InputConditioner_init(&ic, &config);
+}
+
+void setUp(void) {
+    InputConditioner_defaultConfig(&config);
+    InputConditioner_init(&ic, &config);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Mode Tests
+// ============================================================================
+
+void test_nothing_before_first_sample(void) {
+    int16_t axes[INPUT_COND_AXES] = {7, 7, 7, 7};
+    TEST_ASSERT_FALSE(InputConditioner_output(&ic, 1000 * MS, TICK_S, axes));
+    TEST_ASSERT_EQUAL_INT16(7, axes[0]);
+}
+
+void test_hold_is_the_newest_sample(void) {
+    sample(100, 0, 1000 * MS);
+    sample(200, 100, 1040 * MS);
+    TEST_ASSERT_EQUAL_INT16(100, roll_at(1070 * MS));
+    TEST_ASSERT_EQUAL_UINT32(0, ic.shapedTicks);
+}
+
+void test_extrapolate_carries_the_slope(void) {
+    use_mode(INPUT_COND_EXTRAPOLATE);
+    sample(0, 0, 1000 * MS);
+    sample(0, 100, 1040 * MS);                      // +100 per 40 ms
+    TEST_ASSERT_EQUAL_INT16(100, roll_at(1040 * MS));
+    TEST_ASSERT_EQUAL_INT16(150, roll_at(1060 * MS));
+    // At most one interval ahead
+    TEST_ASSERT_EQUAL_INT16(200, roll_at(1080 * MS));
+    TEST_ASSERT_EQUAL_INT16(200, roll_at(1095 * MS));
+    TEST_ASSERT_TRUE(ic.shapedTicks > 0);
+}
+
+void test_extrapolate_stays_in_range(void) {
+    use_mode(INPUT_COND_EXTRAPOLATE);
+    sample(0, 600, 1000 * MS);
+    sample(0, 950, 1040 * MS);
+    TEST_ASSERT_EQUAL_INT16(INPUT_COND_MAX, roll_at(1080 * MS));
+}
+
+void test_slew_ramps_between_samples(void) {
+    use_mode(INPUT_COND_SLEW);
+    sample(0, 0, 1000 * MS);
+    sample(0, 100, 1040 * MS);
+    TEST_ASSERT_EQUAL_INT16(0, roll_at(1040 * MS));
+    TEST_ASSERT_EQUAL_INT16(50, roll_at(1060 * MS));
+    TEST_ASSERT_EQUAL_INT16(100, roll_at(1080 * MS));
+}
+
+// ============================================================================
+// Gap Tests
+// ============================================================================
+
+void test_gap_holds_and_reports(void) {
+    use_mode(INPUT_COND_EXTRAPOLATE);
+    sample(0, 0, 1000 * MS);
+    sample(0, 100, 1040 * MS);
+    int16_t axes[INPUT_COND_AXES];
+    TEST_ASSERT_TRUE(InputConditioner_output(&ic, 1040 * MS + config.maxGapMs * MS, TICK_S, axes));
+    TEST_ASSERT_FALSE(InputConditioner_output(&ic, 1041 * MS + config.maxGapMs * MS, TICK_S, axes));
+    TEST_ASSERT_EQUAL_INT16(100, axes[1]);
+    InputConditioner_output(&ic, 1100 * MS + config.maxGapMs * MS, TICK_S, axes);
+    TEST_ASSERT_EQUAL_UINT32(1, ic.expiredGaps);
+}
+
+void test_no_slope_across_a_gap(void) {
+    use_mode(INPUT_COND_EXTRAPOLATE);
+    sample(0, 0, 1000 * MS);
+    sample(0, 100, 1040 * MS);
+    sample(0, 300, 1040 * MS + config.maxGapMs * MS + 1);
+    TEST_ASSERT_EQUAL_INT16(300, roll_at(1060 * MS + config.maxGapMs * MS));
+}
+
+// ============================================================================
+// Filter / Config Tests
+// ============================================================================
+
+void test_lowpass_smooths_a_step(void) {
+    config.cutoffHz = 5.0f;
+    InputConditioner_init(&ic, &config);
+    sample(0, 0, 1000 * MS);
+    TEST_ASSERT_EQUAL_INT16(0, roll_at(1000 * MS));
+    sample(0, 1000, 1010 * MS);
+    // alpha = 0.01 / (1 / (2 pi 5) + 0.01) = 0.239
+    TEST_ASSERT_INT_WITHIN(2, 239, roll_at(1010 * MS));
+    int16_t roll = 0;
+    for (int t = 1; t <= 50; t++) {
+        sample(0, 1000, (1010 + 10 * t) * MS);
+        roll = roll_at((1010 + 10 * t) * MS);
+    }
+    TEST_ASSERT_INT_WITHIN(2, 1000, roll);
+}
+
+void test_sanitize_limits(void) {
+    InputCondConfig bad = {9, 5000, 400.0f};
+    InputConditioner_sanitize(&bad);
+    TEST_ASSERT_EQUAL(INPUT_COND_HOLD, bad.mode);
+    TEST_ASSERT_EQUAL_UINT16(INPUT_COND_MAX_GAP_MS, bad.maxGapMs);
+    TEST_ASSERT_EQUAL_FLOAT(INPUT_COND_MAX_CUTOFF_HZ, bad.cutoffHz);
+    bad.cutoffHz = -1.0f;
+    InputConditioner_sanitize(&bad);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, bad.cutoffHz);
+    TEST_ASSERT_EQUAL_STRING("slew", InputConditioner_modeName(INPUT_COND_SLEW));
+
+    InputCondMode mode = INPUT_COND_SLEW;
+    TEST_ASSERT_TRUE(InputConditioner_parseMode("extrapolate", &mode));
+    TEST_ASSERT_EQUAL(INPUT_COND_EXTRAPOLATE, mode);
+    TEST_ASSERT_FALSE(InputConditioner_parseMode("smooth", &mode));
+    TEST_ASSERT_FALSE(InputConditioner_parseMode(NULL, &mode));
+    TEST_ASSERT_EQUAL(INPUT_COND_EXTRAPOLATE, mode);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Mode Tests
+    RUN_TEST(test_nothing_before_first_sample);
+    RUN_TEST(test_hold_is_the_newest_sample);
+    RUN_TEST(test_extrapolate_carries_the_slope);
+    RUN_TEST(test_extrapolate_stays_in_range);
+    RUN_TEST(test_slew_ramps_between_samples);
+
+    // Gap Tests
+    RUN_TEST(test_gap_holds_and_reports);
+    RUN_TEST(test_no_slope_across_a_gap);
+
+    // Filter / Config Tests
+    RUN_TEST(test_lowpass_smooths_a_step);
+    RUN_TEST(test_sanitize_limits);
+
+    return UNITY_END();
+}
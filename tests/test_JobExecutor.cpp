@@ -0,0 +1,168 @@
+/**
+ * Unit Tests for JobExecutor
+ * Tests due ordering, budget fitting against the slice, deferral while
+ * the control loop is busy, the one-period starvation bound and overrun
+ * accounting
+ *
+ * @file test_JobExecutor.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "JobExecutor.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+// Fake clock: each job advances it by its cost
+static uint32_t clockUs;
+static uint32_t cost[3];
+static char order[8];
+static uint8_t orderLen;
+
+static uint32_t fakeClock(void) {
+    return clockUs;
+}
+
+static void jobA(uint32_t nowMs) { (void)nowMs; clockUs += cost[0]; order[orderLen++] = 'A'; }
+static void jobB(uint32_t nowMs) { (void)nowMs; clockUs += cost[1]; order[orderLen++] = 'B'; }
+static void jobC(uint32_t nowMs) { (void)nowMs; clockUs += cost[2]; order[orderLen++] = 'C'; }
+
+static JobExecutor ex;
+
+void setUp(void) {
+    clockUs = 0;
+    memset(cost, 0, sizeof(cost));
+    memset(order, 0, sizeof(order));
+    orderLen = 0;
+    JobExecutor_init(&ex, fakeClock);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Scheduling Tests
+// ============================================================================
+
+void test_add_rejects_bad_and_full(void) {
+    TEST_ASSERT_EQUAL(-1, JobExecutor_add(&ex, "zero", jobA, 0, 100, 0));
+    for (int i = 0; i < JOB_EXECUTOR_MAX_JOBS; i++)
+        TEST_ASSERT_EQUAL(i, JobExecutor_add(&ex, "a", jobA, 100, 100, 0));
+    TEST_ASSERT_EQUAL(-1, JobExecutor_add(&ex, "full", jobA, 100, 100, 0));
+}
+
+void test_runs_when_due_most_overdue_first(void) {
+    JobExecutor_add(&ex, "b", jobB, 60, 500, 0);
+    JobExecutor_add(&ex, "a", jobA, 100, 500, 0);
+    TEST_ASSERT_EQUAL(0, JobExecutor_run(&ex, 40, 5000, false));
+    TEST_ASSERT_EQUAL(1, JobExecutor_run(&ex, 80, 5000, false));
+    TEST_ASSERT_EQUAL_STRING("B", order);
+
+    // At 135 a is 35 ms late, b (due 120) only 15: a goes first
+    TEST_ASSERT_EQUAL(2, JobExecutor_run(&ex, 135, 5000, false));
+    TEST_ASSERT_EQUAL_STRING("BAB", order);
+    TEST_ASSERT_EQUAL_UINT32(35, ex.jobs[1].maxLateMs);
+}
+
+void test_phase_kept_and_missed_periods_skipped(void) {
+    JobExecutor_add(&ex, "a", jobA, 100, 500, 0);
+    JobExecutor_run(&ex, 110, 5000, false);
+    TEST_ASSERT_EQUAL_UINT32(200, ex.jobs[0].dueMs);
+    // Three periods missed: next one is a period from now, not a burst
+    JobExecutor_run(&ex, 530, 5000, false);
+    TEST_ASSERT_EQUAL_UINT32(630, ex.jobs[0].dueMs);
+    TEST_ASSERT_EQUAL_UINT32(2, ex.jobs[0].runs);
+}
+
+// ============================================================================
+// Budget Tests
+// ============================================================================
+
+void test_only_what_fits_the_slice(void) {
+    JobExecutor_add(&ex, "a", jobA, 100, 600, 0);
+    JobExecutor_add(&ex, "b", jobB, 100, 600, 0);
+    cost[0] = 550;
+    cost[1] = 550;
+    TEST_ASSERT_EQUAL(1, JobExecutor_run(&ex, 100, 1000, false));
+    TEST_ASSERT_EQUAL_UINT32(1, ex.jobs[1].deferrals);
+    // Next tick has room for the deferred one
+    TEST_ASSERT_EQUAL(1, JobExecutor_run(&ex, 110, 1000, false));
+    TEST_ASSERT_EQUAL_STRING("AB", order);
+    TEST_ASSERT_EQUAL_UINT32(0, ex.jobs[1].forced);
+}
+
+void test_overrun_counted(void) {
+    JobExecutor_add(&ex, "a", jobA, 100, 200, 0);
+    cost[0] = 900;
+    JobExecutor_run(&ex, 100, 5000, false);
+    TEST_ASSERT_EQUAL_UINT32(1, ex.jobs[0].overruns);
+    TEST_ASSERT_EQUAL_UINT32(900, ex.jobs[0].maxUs);
+    cost[0] = 100;
+    JobExecutor_run(&ex, 200, 5000, false);
+    TEST_ASSERT_EQUAL_UINT32(1, ex.jobs[0].overruns);
+    TEST_ASSERT_EQUAL_UINT32(100, ex.jobs[0].lastUs);
+    TEST_ASSERT_EQUAL_UINT32(900, ex.jobs[0].maxUs);
+}
+
+// ============================================================================
+// Control Loop Tests
+// ============================================================================
+
+void test_deferred_while_control_busy(void) {
+    JobExecutor_add(&ex, "a", jobA, 100, 200, 0);
+    for (uint32_t t = 100; t < 200; t += 10)
+        TEST_ASSERT_EQUAL(0, JobExecutor_run(&ex, t, 5000, true));
+    TEST_ASSERT_EQUAL_UINT32(10, ex.jobs[0].deferrals);
+    TEST_ASSERT_EQUAL_UINT32(10, ex.busyPasses);
+    TEST_ASSERT_EQUAL(1, JobExecutor_run(&ex, 190, 5000, false));
+}
+
+void test_starved_job_forced_one_per_pass(void) {
+    JobExecutor_add(&ex, "a", jobA, 100, 200, 0);
+    JobExecutor_add(&ex, "b", jobB, 100, 200, 0);
+    JobExecutor_add(&ex, "c", jobC, 1000, 200, 0);
+    // All held back a whole period: only the most overdue goes
+    TEST_ASSERT_EQUAL(1, JobExecutor_run(&ex, 205, 5000, true));
+    TEST_ASSERT_EQUAL_STRING("A", order);
+    TEST_ASSERT_EQUAL_UINT32(1, ex.jobs[0].forced);
+    TEST_ASSERT_EQUAL(1, JobExecutor_run(&ex, 215, 5000, true));
+    TEST_ASSERT_EQUAL_STRING("AB", order);
+    // c is not a period late yet
+    TEST_ASSERT_EQUAL(0, JobExecutor_run(&ex, 225, 5000, true));
+    TEST_ASSERT_EQUAL_UINT32(0, ex.jobs[2].runs);
+}
+
+void test_reset_keeps_schedule(void) {
+    JobExecutor_add(&ex, "a", jobA, 100, 200, 0);
+    JobExecutor_run(&ex, 150, 5000, false);
+    JobExecutor_resetStats(&ex);
+    TEST_ASSERT_EQUAL_UINT32(0, ex.jobs[0].runs);
+    TEST_ASSERT_EQUAL_UINT32(0, ex.passes);
+    TEST_ASSERT_EQUAL_UINT32(200, ex.jobs[0].dueMs);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Scheduling Tests
+    RUN_TEST(test_add_rejects_bad_and_full);
+    RUN_TEST(test_runs_when_due_most_overdue_first);
+    RUN_TEST(test_phase_kept_and_missed_periods_skipped);
+
+    // Budget Tests
+    RUN_TEST(test_only_what_fits_the_slice);
+    RUN_TEST(test_overrun_counted);
+
+    // Control Loop Tests
+    RUN_TEST(test_deferred_while_control_busy);
+    RUN_TEST(test_starved_job_forced_one_per_pass);
+    RUN_TEST(test_reset_keeps_schedule);
+
+    return UNITY_END();
+}
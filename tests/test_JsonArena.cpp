@@ -0,0 +1,139 @@
+/**
+ * Unit Tests for JsonArena
+ * Tests bump allocation, in-place resize of the newest block, the cap and
+ * ArduinoJson documents parsed / built from the arena
+ *
+ * @file test_JsonArena.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <string.h>
+#include "JsonArena.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define ARENA_SIZE 16384         // Above one variant pool on 64-bit hosts too
+
+alignas(JSON_ARENA_ALIGN) static uint8_t buffer[ARENA_SIZE];
+static JsonArena arena(buffer, ARENA_SIZE);
+
+void setUp(void) {
+    arena.reset();
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Allocator Tests
+// ============================================================================
+
+void test_allocations_are_aligned_and_disjoint(void) {
+    uint8_t* a = (uint8_t*)arena.allocate(3);
+    uint8_t* b = (uint8_t*)arena.allocate(10);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)a % JSON_ARENA_ALIGN);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)b % JSON_ARENA_ALIGN);
+    TEST_ASSERT_TRUE(b >= a + 3);
+    TEST_ASSERT_TRUE(b + 10 <= buffer + ARENA_SIZE);
+}
+
+void test_newest_block_resizes_in_place(void) {
+    char* s = (char*)arena.allocate(16);
+    strcpy(s, "hello");
+    size_t used = arena.used();
+
+    TEST_ASSERT_EQUAL_PTR(s, arena.reallocate(s, 200));
+    TEST_ASSERT_EQUAL_STRING("hello", s);
+    TEST_ASSERT_TRUE(arena.used() > used);
+
+    TEST_ASSERT_EQUAL_PTR(s, arena.reallocate(s, 16));
+    TEST_ASSERT_EQUAL(used, arena.used());
+
+    arena.deallocate(s);
+    TEST_ASSERT_EQUAL(0, arena.used());
+}
+
+void test_older_block_moves_when_growing(void) {
+    char* a = (char*)arena.allocate(8);
+    strcpy(a, "abc");
+    arena.allocate(8);
+
+    char* moved = (char*)arena.reallocate(a, 64);
+    TEST_ASSERT_NOT_NULL(moved);
+    TEST_ASSERT_TRUE(moved != a);
+    TEST_ASSERT_EQUAL_STRING("abc", moved);
+
+    // Freeing an older block only leaves a hole
+    size_t used = arena.used();
+    arena.deallocate(a);
+    TEST_ASSERT_EQUAL(used, arena.used());
+}
+
+void test_cap_fails_and_counts(void) {
+    TEST_ASSERT_NULL(arena.allocate(ARENA_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(1, arena.failures());
+    TEST_ASSERT_EQUAL(0, arena.used());
+
+    void* p = arena.allocate(ARENA_SIZE / 2);
+    TEST_ASSERT_NULL(arena.reallocate(p, ARENA_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(2, arena.failures());
+}
+
+// ============================================================================
+// Document Tests
+// ============================================================================
+
+void test_document_round_trip(void) {
+    {
+        JsonArenaScope scope(arena);
+        JsonDocument doc(&arena);
+        const char* line = "{\"c\":\"set_pid\",\"kp\":1.25,\"name\":\"a long string value\"}";
+        TEST_ASSERT_FALSE(deserializeJson(doc, line));
+        TEST_ASSERT_EQUAL_STRING("set_pid", doc["c"]);
+        TEST_ASSERT_EQUAL_STRING("a long string value", doc["name"]);
+
+        JsonDocument res(&arena);
+        res["c"] = "set_pid";
+        res["kp"] = doc["kp"];
+        char out[64];
+        serializeJson(res, out, sizeof(out));
+        TEST_ASSERT_EQUAL_STRING("{\"c\":\"set_pid\",\"kp\":1.25}", out);
+        TEST_ASSERT_TRUE(arena.used() > 0);
+    }
+    TEST_ASSERT_EQUAL(0, arena.used());
+    TEST_ASSERT_TRUE(arena.highWater() > 0);
+}
+
+void test_document_overflow_reported(void) {
+    JsonArenaScope scope(arena);
+    JsonDocument doc(&arena);
+    JsonArray arr = doc.to<JsonArray>();
+    for (int i = 0; i < 5000; i++) arr.add(i);
+    TEST_ASSERT_TRUE(doc.overflowed());
+    TEST_ASSERT_TRUE(arena.failures() > 0);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Allocator Tests
+    RUN_TEST(test_allocations_are_aligned_and_disjoint);
+    RUN_TEST(test_newest_block_resizes_in_place);
+    RUN_TEST(test_older_block_moves_when_growing);
+    RUN_TEST(test_cap_fails_and_counts);
+
+    // Document Tests
+    RUN_TEST(test_document_round_trip);
+    RUN_TEST(test_document_overflow_reported);
+
+    return UNITY_END();
+}
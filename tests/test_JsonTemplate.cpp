@@ -0,0 +1,148 @@
+/**
+ * Unit Tests for JsonTemplate
+ * Tests pattern layout, fixed-point formatting, padding, clamping, that
+ * patched lines stay valid JSON, and the time budget of a patch
+ *
+ * @file test_JsonTemplate.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <math.h>
+#include <string.h>
+#include "Benchmark.h"
+#include "JsonTemplate.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static const char* PATTERN = "{\"t\":2,\"v\":##.###,\"r\":###,\"heap\":###}";
+static JsonTemplate tpl;
+
+void setUp(void) {
+    JsonTemplate_init(&tpl, PATTERN);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Layout Tests
+// ============================================================================
+
+void test_init_lays_out_fields(void) {
+    TEST_ASSERT_EQUAL(3, tpl.fieldCount);
+    TEST_ASSERT_EQUAL(strlen(PATTERN), tpl.len);
+    TEST_ASSERT_EQUAL(6, tpl.fields[0].width);
+    TEST_ASSERT_EQUAL(3, tpl.fields[0].decimals);
+    TEST_ASSERT_EQUAL(0, tpl.fields[1].decimals);
+    TEST_ASSERT_EQUAL_STRING("{\"t\":2,\"v\": 0.000,\"r\":  0,\"heap\":  0}", tpl.text);
+}
+
+void test_init_rejects_bad_patterns(void) {
+    JsonTemplate t;
+    char manyFields[2 * JSON_TEMPLATE_MAX_FIELDS + 3];
+    for (int i = 0; i <= JSON_TEMPLATE_MAX_FIELDS; i++) memcpy(&manyFields[2 * i], "#,", 2);
+    manyFields[2 * JSON_TEMPLATE_MAX_FIELDS + 2] = '\0';
+    TEST_ASSERT_FALSE(JsonTemplate_init(&t, manyFields));
+    TEST_ASSERT_TRUE(JsonTemplate_init(&t, manyFields + 2));
+    char longPattern[JSON_TEMPLATE_MAX_LEN + 1];
+    memset(longPattern, 'x', JSON_TEMPLATE_MAX_LEN);
+    longPattern[JSON_TEMPLATE_MAX_LEN] = '\0';
+    TEST_ASSERT_FALSE(JsonTemplate_init(&t, longPattern));
+}
+
+// ============================================================================
+// Formatting Tests
+// ============================================================================
+
+void test_fixed_point_and_padding(void) {
+    JsonTemplate_setInt(&tpl, 0, 12345);
+    JsonTemplate_setInt(&tpl, 1, 87);
+    JsonTemplate_setInt(&tpl, 2, 5);
+    TEST_ASSERT_EQUAL_STRING("{\"t\":2,\"v\":12.345,\"r\": 87,\"heap\":  5}", tpl.text);
+
+    JsonTemplate_setInt(&tpl, 0, 7);
+    TEST_ASSERT_EQUAL_STRING("{\"t\":2,\"v\": 0.007,\"r\": 87,\"heap\":  5}", tpl.text);
+}
+
+void test_negative_values(void) {
+    JsonTemplate_setInt(&tpl, 0, -1500);
+    JsonTemplate_setInt(&tpl, 1, -3);
+    TEST_ASSERT_EQUAL_STRING("{\"t\":2,\"v\":-1.500,\"r\": -3,\"heap\":  0}", tpl.text);
+}
+
+void test_overflow_clamps(void) {
+    JsonTemplate_setInt(&tpl, 0, 1000000);
+    JsonTemplate_setInt(&tpl, 1, -5000);
+    JsonTemplate_setInt(&tpl, 2, INT32_MAX);
+    TEST_ASSERT_EQUAL_STRING("{\"t\":2,\"v\":99.999,\"r\":-99,\"heap\":999}", tpl.text);
+    TEST_ASSERT_EQUAL(strlen(PATTERN), strlen(tpl.text));
+}
+
+void test_float_rounds(void) {
+    JsonTemplate_setFloat(&tpl, 0, 3.14159f);
+    JsonTemplate_setFloat(&tpl, 1, NAN);
+    JsonTemplate_setFloat(&tpl, 2, 41.6f);
+    TEST_ASSERT_EQUAL_STRING("{\"t\":2,\"v\": 3.142,\"r\":  0,\"heap\": 42}", tpl.text);
+}
+
+void test_patched_line_parses(void) {
+    JsonTemplate_setInt(&tpl, 0, 11872);
+    JsonTemplate_setInt(&tpl, 1, 64);
+    JsonTemplate_setInt(&tpl, 2, -12);
+
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, tpl.text, tpl.len));
+    TEST_ASSERT_EQUAL(2, doc["t"].as<int>());
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 11.872f, doc["v"].as<float>());
+    TEST_ASSERT_EQUAL(64, doc["r"].as<int>());
+    TEST_ASSERT_EQUAL(-12, doc["heap"].as<int>());
+}
+
+// ============================================================================
+// Budget Tests
+// ============================================================================
+
+static volatile size_t sink;
+
+// One telemetry line, as the JSON stream sends it every tick
+static void patchLine(void* ctx) {
+    (void)ctx;
+    JsonTemplate_setInt(&tpl, 0, 11872);
+    JsonTemplate_setInt(&tpl, 1, 87);
+    JsonTemplate_setInt(&tpl, 2, 42);
+    sink = tpl.len;
+}
+
+void test_patch_budget(void) {
+    char msg[BENCH_LINE_MAX];
+    TEST_ASSERT_TRUE_MESSAGE(Bench_checkBudget("telemetry_template", patchLine, NULL, 500,
+                                               BENCH_BUDGET_NS(3000, 250), msg,
+                                               sizeof(msg)), msg);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Layout Tests
+    RUN_TEST(test_init_lays_out_fields);
+    RUN_TEST(test_init_rejects_bad_patterns);
+
+    // Formatting Tests
+    RUN_TEST(test_fixed_point_and_padding);
+    RUN_TEST(test_negative_values);
+    RUN_TEST(test_overflow_clamps);
+    RUN_TEST(test_float_rounds);
+    RUN_TEST(test_patched_line_parses);
+
+    // Budget Tests
+    RUN_TEST(test_patch_budget);
+
+    return UNITY_END();
+}
@@ -0,0 +1,178 @@
+/**
+ * Unit Tests for LatencyProbe
+ * Tests stage differences, log2 histograms and percentiles, the
+ * take-once echo and the echo frame round trip
+ *
+ * @file test_LatencyProbe.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "LatencyProbe.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static LatencyProbe probe;
+
+static LatencyTrace makeTrace(uint32_t seq, uint32_t rx, uint32_t filter, uint32_t queue,
+                              uint32_t verify, uint32_t apply, uint32_t commit) {
+    LatencyTrace t;
+    t.sequence = seq;
+    t.stampUs[LATENCY_POINT_RX] = rx;
+    t.stampUs[LATENCY_POINT_QUEUED] = rx + filter;
+    t.stampUs[LATENCY_POINT_DEQUEUED] = rx + filter + queue;
+    t.stampUs[LATENCY_POINT_VERIFIED] = rx + filter + queue + verify;
+    t.stampUs[LATENCY_POINT_INPUTS] = rx + filter + queue + verify + apply;
+    t.stampUs[LATENCY_POINT_COMMIT] = rx + filter + queue + verify + apply + commit;
+    return t;
+}
+
+void setUp(void) {
+    LatencyProbe_init(&probe);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Histogram Tests
+// ============================================================================
+
+void test_bucket_edges(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, LatencyProbe_bucket(0));
+    TEST_ASSERT_EQUAL_UINT8(0, LatencyProbe_bucket(1));
+    TEST_ASSERT_EQUAL_UINT8(1, LatencyProbe_bucket(2));
+    TEST_ASSERT_EQUAL_UINT8(1, LatencyProbe_bucket(3));
+    TEST_ASSERT_EQUAL_UINT8(10, LatencyProbe_bucket(1024));
+    TEST_ASSERT_EQUAL_UINT8(LATENCY_HIST_BUCKETS - 1, LatencyProbe_bucket(32768));
+    TEST_ASSERT_EQUAL_UINT8(LATENCY_HIST_BUCKETS - 1, LatencyProbe_bucket(0xFFFFFFFF));
+}
+
+void test_record_splits_stages(void) {
+    LatencyTrace t = makeTrace(7, 1000, 12, 9000, 250, 40, 60);
+    LatencyProbe_record(&probe, &t);
+    TEST_ASSERT_EQUAL_UINT32(12, probe.stages[LATENCY_STAGE_FILTER].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(9000, probe.stages[LATENCY_STAGE_QUEUE].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(250, probe.stages[LATENCY_STAGE_VERIFY].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(40, probe.stages[LATENCY_STAGE_APPLY].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(60, probe.stages[LATENCY_STAGE_COMMIT].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(9362, probe.stages[LATENCY_STAGE_TOTAL].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(1, probe.stages[LATENCY_STAGE_TOTAL].count);
+}
+
+void test_stamps_across_wrap(void) {
+    LatencyTrace t = makeTrace(1, 0xFFFFFF00UL, 100, 200, 10, 10, 10);
+    LatencyProbe_record(&probe, &t);
+    TEST_ASSERT_EQUAL_UINT32(200, probe.stages[LATENCY_STAGE_QUEUE].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(330, probe.stages[LATENCY_STAGE_TOTAL].maxUs);
+}
+
+void test_backwards_stamp_counts_zero(void) {
+    LatencyTrace t = makeTrace(1, 5000, 10, 10, 10, 10, 10);
+    t.stampUs[LATENCY_POINT_QUEUED] = 4990;
+    LatencyProbe_record(&probe, &t);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.stages[LATENCY_STAGE_FILTER].maxUs);
+}
+
+void test_percentiles(void) {
+    // 99 frames waiting ~5 ms for the tick, one waiting 19 ms
+    for (uint32_t i = 0; i < 99; i++) {
+        LatencyTrace t = makeTrace(i, 0, 10, 5000, 10, 10, 10);
+        LatencyProbe_record(&probe, &t);
+    }
+    LatencyTrace slow = makeTrace(99, 0, 10, 19000, 10, 10, 10);
+    LatencyProbe_record(&probe, &slow);
+
+    const LatencyHistogram* q = &probe.stages[LATENCY_STAGE_QUEUE];
+    TEST_ASSERT_EQUAL_UINT32(8192, LatencyProbe_percentile(q, 50));
+    TEST_ASSERT_EQUAL_UINT32(8192, LatencyProbe_percentile(q, 99));
+    TEST_ASSERT_EQUAL_UINT32(19000, LatencyProbe_percentile(q, 100));
+    // Bucket edge above everything seen is capped at the maximum
+    TEST_ASSERT_EQUAL_UINT32(10, LatencyProbe_percentile(&probe.stages[LATENCY_STAGE_FILTER], 50));
+}
+
+void test_percentile_of_empty_histogram(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, LatencyProbe_percentile(&probe.stages[LATENCY_STAGE_TOTAL], 99));
+}
+
+void test_add_to_own_histogram(void) {
+    // Latencies measured outside a trace (e.g. a wired receiver)
+    LatencyHistogram h;
+    memset(&h, 0, sizeof(h));
+    LatencyProbe_add(&h, 3000);
+    LatencyProbe_add(&h, 700);
+    TEST_ASSERT_EQUAL_UINT32(2, h.count);
+    TEST_ASSERT_EQUAL_UINT32(3000, h.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(1, h.buckets[LatencyProbe_bucket(700)]);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.stages[LATENCY_STAGE_TOTAL].count);
+}
+
+// ============================================================================
+// Echo Tests
+// ============================================================================
+
+void test_echo_taken_once(void) {
+    LatencyEcho echo;
+    TEST_ASSERT_FALSE(LatencyProbe_takeEcho(&probe, &echo));
+
+    LatencyTrace t = makeTrace(41, 0, 1, 2, 3, 4, 5);
+    LatencyProbe_record(&probe, &t);
+    t = makeTrace(42, 0, 12, 9000, 250, 40, 70000);
+    LatencyProbe_record(&probe, &t);
+
+    TEST_ASSERT_TRUE(LatencyProbe_takeEcho(&probe, &echo));
+    TEST_ASSERT_EQUAL_UINT32(42, echo.sequence);
+    TEST_ASSERT_EQUAL_UINT16(9000, echo.stageUs[LATENCY_STAGE_QUEUE]);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, echo.stageUs[LATENCY_STAGE_COMMIT]);
+    TEST_ASSERT_FALSE(LatencyProbe_takeEcho(&probe, &echo));
+}
+
+void test_echo_frame_round_trip(void) {
+    LatencyEcho echo = {0x01020304UL, {12, 9000, 250, 40, 60}};
+    uint8_t frame[LATENCY_ECHO_SIZE];
+    TEST_ASSERT_EQUAL(LATENCY_ECHO_SIZE, LatencyProbe_encodeEcho(&echo, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_HEX8(LATENCY_ECHO_TYPE, frame[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x04, frame[1]);
+
+    LatencyEcho decoded;
+    TEST_ASSERT_TRUE(LatencyProbe_decodeEcho(frame, sizeof(frame), &decoded));
+    TEST_ASSERT_EQUAL_UINT32(echo.sequence, decoded.sequence);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(echo.stageUs, decoded.stageUs, LATENCY_ECHO_STAGES);
+}
+
+void test_echo_frame_rejects_damage(void) {
+    LatencyEcho echo = {5, {1, 2, 3, 4, 5}};
+    uint8_t frame[LATENCY_ECHO_SIZE];
+    LatencyEcho decoded;
+    TEST_ASSERT_EQUAL(0, LatencyProbe_encodeEcho(&echo, frame, sizeof(frame) - 1));
+    LatencyProbe_encodeEcho(&echo, frame, sizeof(frame));
+    TEST_ASSERT_FALSE(LatencyProbe_decodeEcho(frame, sizeof(frame) - 1, &decoded));
+    frame[6] ^= 0x01;
+    TEST_ASSERT_FALSE(LatencyProbe_decodeEcho(frame, sizeof(frame), &decoded));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Histogram Tests
+    RUN_TEST(test_bucket_edges);
+    RUN_TEST(test_record_splits_stages);
+    RUN_TEST(test_stamps_across_wrap);
+    RUN_TEST(test_backwards_stamp_counts_zero);
+    RUN_TEST(test_percentiles);
+    RUN_TEST(test_percentile_of_empty_histogram);
+    RUN_TEST(test_add_to_own_histogram);
+
+    // Echo Tests
+    RUN_TEST(test_echo_taken_once);
+    RUN_TEST(test_echo_frame_round_trip);
+    RUN_TEST(test_echo_frame_rejects_damage);
+
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+/**
+ * Unit Tests for LeakDetector
+ * Tests the edge / debounce / latch sequence and the handler call
+ *
+ * @file test_LeakDetector.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "LeakDetector.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static LeakDetector det;
+static int handlerCalls;
+static bool handlerSawLatch;
+
+static void onLeak(void* arg) {
+    handlerCalls++;
+    handlerSawLatch = LeakDetector_isLatched((LeakDetector*)arg);
+}
+
+void setUp(void) {
+    LeakDetector_init(&det, onLeak, &det);
+    handlerCalls = 0;
+    handlerSawLatch = false;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void test_wet_input_latches_and_calls_handler_once(void) {
+    TEST_ASSERT_TRUE(LeakDetector_edge(&det, 1000));
+    TEST_ASSERT_TRUE(LeakDetector_confirm(&det, true, 1000 + LEAK_DEBOUNCE_US));
+    TEST_ASSERT_TRUE(LeakDetector_isLatched(&det));
+    TEST_ASSERT_EQUAL_INT(1, handlerCalls);
+    TEST_ASSERT_TRUE(handlerSawLatch);
+    TEST_ASSERT_EQUAL_UINT32(1000, det.latchUs);
+    TEST_ASSERT_EQUAL_UINT32(LEAK_DEBOUNCE_US, det.reactionUs);
+
+    // Later edges and checks change nothing
+    TEST_ASSERT_FALSE(LeakDetector_edge(&det, 9000));
+    TEST_ASSERT_FALSE(LeakDetector_confirm(&det, true, 9000 + LEAK_DEBOUNCE_US));
+    TEST_ASSERT_EQUAL_INT(1, handlerCalls);
+    TEST_ASSERT_EQUAL_UINT32(2, det.edges);
+}
+
+void test_bounce_is_rejected(void) {
+    TEST_ASSERT_TRUE(LeakDetector_edge(&det, 1000));
+    TEST_ASSERT_FALSE(LeakDetector_edge(&det, 1100));       // Bounce while pending
+    TEST_ASSERT_FALSE(LeakDetector_edge(&det, 1200));
+    TEST_ASSERT_FALSE(LeakDetector_confirm(&det, false, 1000 + LEAK_DEBOUNCE_US));
+    TEST_ASSERT_FALSE(LeakDetector_isLatched(&det));
+    TEST_ASSERT_EQUAL_INT(0, handlerCalls);
+    TEST_ASSERT_EQUAL_UINT32(1, det.rejected);
+    TEST_ASSERT_EQUAL_UINT32(3, det.edges);
+}
+
+void test_rearms_after_rejected_check(void) {
+    LeakDetector_edge(&det, 1000);
+    LeakDetector_confirm(&det, false, 3000);
+    TEST_ASSERT_TRUE(LeakDetector_edge(&det, 50000));       // Water for real
+    TEST_ASSERT_TRUE(LeakDetector_confirm(&det, true, 52000));
+    TEST_ASSERT_EQUAL_UINT32(50000, det.latchUs);
+}
+
+void test_without_handler(void) {
+    LeakDetector_init(&det, nullptr, nullptr);
+    LeakDetector_edge(&det, 0);
+    TEST_ASSERT_TRUE(LeakDetector_confirm(&det, true, LEAK_DEBOUNCE_US));
+    TEST_ASSERT_TRUE(LeakDetector_isLatched(&det));
+}
+
+void test_start_without_pin_never_latches(void) {
+    TEST_ASSERT_FALSE(LeakDetector_start(&det, -1, true));
+    TEST_ASSERT_FALSE(LeakDetector_isLatched(&det));
+    TEST_ASSERT_EQUAL_INT8(-1, det.pin);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_wet_input_latches_and_calls_handler_once);
+    RUN_TEST(test_bounce_is_rejected);
+    RUN_TEST(test_rearms_after_rejected_check);
+    RUN_TEST(test_without_handler);
+    RUN_TEST(test_start_without_pin_never_latches);
+
+    return UNITY_END();
+}
@@ -0,0 +1,355 @@
+/**
+ * Unit Tests for LinkRate
+ * Tests link grading, the fast-down / slow-up tier policy, the long-range
+ * PHY rung and its capability exchange, the compact control frame
+ * capability, the proposal retry / ack handshake and the frame round trip
+ *
+ * @file test_LinkRate.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "LinkRate.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static LinkRate lr;
+
+static LinkSample sample(uint8_t loss, int8_t rssi, uint32_t sent = 20, uint32_t failed = 0) {
+    LinkSample s;
+    s.lossPercent = loss;
+    s.rssiDbm = rssi;
+    s.signalLost = false;
+    s.txSent = sent;
+    s.txFailed = failed;
+    return s;
+}
+
+static const LinkSample CLEAN = sample(0, -55);
+static const LinkSample NOISY = sample(20, -70);
+
+static bool ackPending(uint8_t tier, uint8_t flags = 0) {
+    LinkRateFrame ack;
+    memset(&ack, 0, sizeof(ack));
+    ack.flags = LINK_RATE_FLAG_ACK | flags;
+    ack.epoch = lr.epoch;
+    ack.tier = tier;
+    return LinkRate_onAck(&lr, &ack);
+}
+
+// Both ends LR capable, at ROBUST on the fast PHY, nothing pending
+static void robustWithLongRange(void) {
+    LinkRate_setLongRange(&lr, true);
+    ackPending(LINK_TIER_FAST, LINK_RATE_FLAG_LR_CAPABLE);
+    LinkSample s = sample(50, -80);
+    LinkRate_evaluate(&lr, &s);
+    ackPending(LINK_TIER_ROBUST, LINK_RATE_FLAG_LR_CAPABLE);
+}
+
+void setUp(void) {
+    LinkRate_init(&lr);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Grade Tests
+// ============================================================================
+
+void test_grades(void) {
+    LinkSample s = CLEAN;
+    TEST_ASSERT_EQUAL(LINK_GRADE_GOOD, LinkRate_grade(&s));
+    s = sample(5, -60);
+    TEST_ASSERT_EQUAL(LINK_GRADE_FAIR, LinkRate_grade(&s));
+    s = sample(0, -90);
+    TEST_ASSERT_EQUAL(LINK_GRADE_BAD, LinkRate_grade(&s));
+    s = sample(0, -55, 20, 6);                  // Retries exhausted on 30 %
+    TEST_ASSERT_EQUAL(LINK_GRADE_BAD, LinkRate_grade(&s));
+    s = sample(0, -55, 2, 2);                   // Too few sends to judge
+    TEST_ASSERT_EQUAL(LINK_GRADE_GOOD, LinkRate_grade(&s));
+    s = CLEAN;
+    s.signalLost = true;
+    TEST_ASSERT_EQUAL(LINK_GRADE_BAD, LinkRate_grade(&s));
+}
+
+// ============================================================================
+// Tier Policy Tests
+// ============================================================================
+
+void test_downgrade_applies_at_once(void) {
+    LinkSample s = NOISY;
+    TEST_ASSERT_TRUE(LinkRate_evaluate(&lr, &s));
+    TEST_ASSERT_EQUAL(LINK_TIER_NORMAL, lr.tier);
+    TEST_ASSERT_TRUE(lr.pending);
+    TEST_ASSERT_EQUAL_UINT8(2, LinkRate_telemetryDivider(&lr, 20));
+
+    s = sample(50, -70);                        // Nearly gone: straight down
+    LinkRate_init(&lr);
+    TEST_ASSERT_TRUE(LinkRate_evaluate(&lr, &s));
+    TEST_ASSERT_EQUAL(LINK_TIER_ROBUST, lr.tier);
+    TEST_ASSERT_EQUAL_UINT8(4, LinkRate_telemetryDivider(&lr, 20));
+}
+
+void test_upgrade_needs_clean_streak(void) {
+    LinkSample s = NOISY;
+    LinkRate_evaluate(&lr, &s);
+    ackPending(LINK_TIER_NORMAL);
+
+    s = CLEAN;
+    for (int i = 0; i < LINK_RATE_UPGRADE_EVALS - 1; i++)
+        TEST_ASSERT_FALSE(LinkRate_evaluate(&lr, &s));
+    LinkSample fair = sample(5, -60);           // A fair period restarts it
+    LinkRate_evaluate(&lr, &fair);
+    for (int i = 0; i < LINK_RATE_UPGRADE_EVALS - 1; i++)
+        TEST_ASSERT_FALSE(LinkRate_evaluate(&lr, &s));
+    TEST_ASSERT_TRUE(LinkRate_evaluate(&lr, &s));
+    TEST_ASSERT_EQUAL(LINK_TIER_FAST, lr.proposed);
+}
+
+void test_upgrade_waits_for_ack_when_negotiating(void) {
+    LinkSample s = NOISY;
+    LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_NORMAL));
+    TEST_ASSERT_TRUE(lr.negotiating);
+
+    s = CLEAN;
+    for (int i = 0; i < LINK_RATE_UPGRADE_EVALS; i++)
+        LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_TRUE(lr.pending);
+    TEST_ASSERT_EQUAL(LINK_TIER_NORMAL, lr.tier);
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_FAST));
+    TEST_ASSERT_EQUAL(LINK_TIER_FAST, lr.tier);
+    TEST_ASSERT_EQUAL(LINK_TIER_FAST, lr.agreed);
+}
+
+void test_legacy_controller_follows_local_grade(void) {
+    LinkSample s = NOISY;
+    LinkRate_evaluate(&lr, &s);
+    s = CLEAN;
+    for (int i = 0; i < LINK_RATE_UPGRADE_EVALS * 3 && lr.tier != LINK_TIER_FAST; i++) {
+        LinkRateFrame f;
+        while (LinkRate_takeProposal(&lr, i * 1000 + lr.attempts * LINK_RATE_RETRY_MS, &f)) {}
+        LinkRate_evaluate(&lr, &s);
+    }
+    TEST_ASSERT_FALSE(lr.negotiating);
+    TEST_ASSERT_EQUAL(LINK_TIER_FAST, lr.tier);
+}
+
+void test_bad_during_upgrade_reproposes_current(void) {
+    LinkSample s = NOISY;
+    LinkRate_evaluate(&lr, &s);
+    LinkRate_evaluate(&lr, &s);
+    ackPending(LINK_TIER_ROBUST);
+    s = CLEAN;
+    for (int i = 0; i < LINK_RATE_UPGRADE_EVALS; i++)
+        LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_EQUAL(LINK_TIER_NORMAL, lr.proposed);
+
+    s = NOISY;
+    TEST_ASSERT_TRUE(LinkRate_evaluate(&lr, &s));
+    TEST_ASSERT_EQUAL(LINK_TIER_ROBUST, lr.proposed);
+    TEST_ASSERT_EQUAL(LINK_TIER_ROBUST, lr.tier);
+}
+
+// ============================================================================
+// Long-Range PHY Tests
+// ============================================================================
+
+void test_long_range_needs_both_ends(void) {
+    // Not capable here: ROBUST is the bottom
+    LinkSample s = sample(50, -80);
+    LinkRate_evaluate(&lr, &s);
+    LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_EQUAL(LINK_PHY_FAST, lr.phy);
+
+    // Capable: the current rates go out with the capability
+    LinkRate_init(&lr);
+    LinkRate_setLongRange(&lr, true);
+    LinkRateFrame f;
+    TEST_ASSERT_TRUE(LinkRate_takeProposal(&lr, 0, &f));
+    TEST_ASSERT_EQUAL_HEX8(LINK_RATE_FLAG_LR_CAPABLE, f.flags);
+    TEST_ASSERT_EQUAL_UINT8(LINK_TIER_FAST, f.tier);
+
+    // A controller that acks without it is never sent LR
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_FAST));
+    TEST_ASSERT_FALSE(lr.peerLr);
+    LinkRate_evaluate(&lr, &s);
+    ackPending(LINK_TIER_ROBUST);
+    LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_EQUAL(LINK_PHY_FAST, lr.phy);
+}
+
+void test_bad_at_robust_switches_to_long_range(void) {
+    robustWithLongRange();
+    TEST_ASSERT_TRUE(lr.peerLr);
+    TEST_ASSERT_EQUAL(LINK_TIER_ROBUST, lr.tier);
+
+    LinkSample s = sample(50, -88);
+    TEST_ASSERT_TRUE(LinkRate_evaluate(&lr, &s));
+    TEST_ASSERT_EQUAL(LINK_PHY_LONG_RANGE, lr.phy);    // At once
+    TEST_ASSERT_EQUAL(LINK_TIER_ROBUST, lr.proposed);
+    LinkRateFrame f;
+    TEST_ASSERT_TRUE(LinkRate_takeProposal(&lr, 0, &f));
+    TEST_ASSERT_EQUAL_HEX8(LINK_RATE_FLAG_LR_CAPABLE | LINK_RATE_FLAG_PHY_LR, f.flags);
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_ROBUST,
+                                LINK_RATE_FLAG_LR_CAPABLE | LINK_RATE_FLAG_PHY_LR));
+    TEST_ASSERT_EQUAL(LINK_PHY_LONG_RANGE, lr.agreedPhy);
+
+    // Still bad: nothing further to give
+    TEST_ASSERT_FALSE(LinkRate_evaluate(&lr, &s));
+}
+
+void test_fast_phy_before_tier_up(void) {
+    robustWithLongRange();
+    LinkSample s = sample(50, -88);
+    LinkRate_evaluate(&lr, &s);
+    ackPending(LINK_TIER_ROBUST, LINK_RATE_FLAG_LR_CAPABLE | LINK_RATE_FLAG_PHY_LR);
+
+    s = CLEAN;
+    for (int i = 0; i < LINK_RATE_UPGRADE_EVALS; i++)
+        LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_TRUE(lr.pending);
+    TEST_ASSERT_EQUAL(LINK_PHY_FAST, lr.proposedPhy);
+    TEST_ASSERT_EQUAL(LINK_TIER_ROBUST, lr.proposed);
+    TEST_ASSERT_EQUAL(LINK_PHY_LONG_RANGE, lr.phy);    // Waits for the ack
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_ROBUST, LINK_RATE_FLAG_LR_CAPABLE));
+    TEST_ASSERT_EQUAL(LINK_PHY_FAST, lr.phy);
+
+    for (int i = 0; i < LINK_RATE_UPGRADE_EVALS; i++)
+        LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_EQUAL(LINK_TIER_NORMAL, lr.proposed);
+}
+
+void test_controller_declines_long_range(void) {
+    robustWithLongRange();
+    LinkSample s = sample(50, -88);
+    LinkRate_evaluate(&lr, &s);
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_ROBUST, LINK_RATE_FLAG_LR_CAPABLE));
+    TEST_ASSERT_EQUAL(LINK_PHY_FAST, lr.phy);
+    TEST_ASSERT_EQUAL_UINT32(2, lr.phySwitches);
+}
+
+// ============================================================================
+// Handshake Tests
+// ============================================================================
+
+void test_compact_capability_exchange(void) {
+    LinkRate_setCompact(&lr, true);
+    LinkRateFrame f;
+    TEST_ASSERT_TRUE(LinkRate_takeProposal(&lr, 0, &f));
+    TEST_ASSERT_EQUAL_HEX8(LINK_RATE_FLAG_COMPACT, f.flags);
+    TEST_ASSERT_EQUAL_UINT8(LINK_TIER_FAST, f.tier);
+
+    // Controller that will not send them
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_FAST));
+    TEST_ASSERT_FALSE(lr.peerCompact);
+    // Any later ack carries the answer
+    ackPending(LINK_TIER_FAST, LINK_RATE_FLAG_COMPACT);
+    TEST_ASSERT_TRUE(lr.peerCompact);
+
+    // Turned off here: forgotten, and no longer advertised
+    LinkRate_setCompact(&lr, false);
+    TEST_ASSERT_FALSE(lr.peerCompact);
+    LinkRate_setLongRange(&lr, true);
+    TEST_ASSERT_TRUE(LinkRate_takeProposal(&lr, 0, &f));
+    TEST_ASSERT_EQUAL_HEX8(LINK_RATE_FLAG_LR_CAPABLE, f.flags);
+}
+
+void test_proposal_retries_then_gives_up(void) {
+    LinkSample s = NOISY;
+    LinkRate_evaluate(&lr, &s);
+    LinkRateFrame f;
+    TEST_ASSERT_TRUE(LinkRate_takeProposal(&lr, 1000, &f));
+    TEST_ASSERT_EQUAL_UINT8(LINK_TIER_NORMAL, f.tier);
+    TEST_ASSERT_EQUAL_UINT8(25, f.controlHz);
+    TEST_ASSERT_EQUAL_UINT8(20, f.lossPercent);
+    TEST_ASSERT_FALSE(LinkRate_takeProposal(&lr, 1000 + LINK_RATE_RETRY_MS - 1, &f));
+
+    uint32_t now = 1000;
+    for (int i = 1; i < LINK_RATE_MAX_ATTEMPTS; i++) {
+        now += LINK_RATE_RETRY_MS;
+        TEST_ASSERT_TRUE(LinkRate_takeProposal(&lr, now, &f));
+    }
+    TEST_ASSERT_FALSE(LinkRate_takeProposal(&lr, now + LINK_RATE_RETRY_MS, &f));
+    TEST_ASSERT_FALSE(lr.pending);
+    TEST_ASSERT_EQUAL_UINT32(1, lr.unanswered);
+}
+
+void test_ack_must_match(void) {
+    LinkSample s = NOISY;
+    LinkRate_evaluate(&lr, &s);
+    LinkRateFrame ack;
+    memset(&ack, 0, sizeof(ack));
+    ack.flags = LINK_RATE_FLAG_ACK;
+    ack.epoch = lr.epoch + 1;                   // Old / forged epoch
+    ack.tier = LINK_TIER_NORMAL;
+    TEST_ASSERT_FALSE(LinkRate_onAck(&lr, &ack));
+    ack.epoch = lr.epoch;
+    ack.tier = LINK_TIER_FAST;                  // Higher than proposed
+    TEST_ASSERT_FALSE(LinkRate_onAck(&lr, &ack));
+    ack.flags = 0;
+    ack.tier = LINK_TIER_NORMAL;                // Not an ack
+    TEST_ASSERT_FALSE(LinkRate_onAck(&lr, &ack));
+
+    TEST_ASSERT_TRUE(ackPending(LINK_TIER_ROBUST));     // Settles lower
+    TEST_ASSERT_EQUAL(LINK_TIER_ROBUST, lr.tier);
+    TEST_ASSERT_FALSE(ackPending(LINK_TIER_ROBUST));    // Only once
+}
+
+// ============================================================================
+// Frame Tests
+// ============================================================================
+
+void test_frame_round_trip(void) {
+    LinkRateFrame in = {LINK_RATE_FLAG_ACK, 7, LINK_TIER_NORMAL, 25, 10, 3, -67};
+    uint8_t buf[LINK_RATE_FRAME_SIZE];
+    TEST_ASSERT_EQUAL(0, LinkRate_encode(&in, buf, sizeof(buf) - 1));
+    TEST_ASSERT_EQUAL(LINK_RATE_FRAME_SIZE, LinkRate_encode(&in, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(LINK_RATE_TYPE, buf[0]);
+
+    LinkRateFrame out;
+    TEST_ASSERT_TRUE(LinkRate_decode(buf, sizeof(buf), &out));
+    TEST_ASSERT_EQUAL_MEMORY(&in, &out, sizeof(in));
+
+    buf[4] ^= 0x01;
+    TEST_ASSERT_FALSE(LinkRate_decode(buf, sizeof(buf), &out));
+    buf[4] ^= 0x01;
+    TEST_ASSERT_FALSE(LinkRate_decode(buf, sizeof(buf) - 1, &out));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Grade Tests
+    RUN_TEST(test_grades);
+
+    // Tier Policy Tests
+    RUN_TEST(test_downgrade_applies_at_once);
+    RUN_TEST(test_upgrade_needs_clean_streak);
+    RUN_TEST(test_upgrade_waits_for_ack_when_negotiating);
+    RUN_TEST(test_legacy_controller_follows_local_grade);
+    RUN_TEST(test_bad_during_upgrade_reproposes_current);
+
+    // Long-Range PHY Tests
+    RUN_TEST(test_long_range_needs_both_ends);
+    RUN_TEST(test_bad_at_robust_switches_to_long_range);
+    RUN_TEST(test_fast_phy_before_tier_up);
+    RUN_TEST(test_controller_declines_long_range);
+
+    // Handshake Tests
+    RUN_TEST(test_compact_capability_exchange);
+    RUN_TEST(test_proposal_retries_then_gives_up);
+    RUN_TEST(test_ack_must_match);
+
+    // Frame Tests
+    RUN_TEST(test_frame_round_trip);
+
+    return UNITY_END();
+}
@@ -0,0 +1,222 @@
+/**
+ * Unit Tests for Log
+ * Tests message framing, partial drains, overflow accounting and
+ * ordering under concurrent producers
+ *
+ * @file test_Log.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "Log.h"
+#include <string.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+// Drain the oldest message in one piece into buf (NUL terminated)
+static size_t drainOne(char *buf, size_t size) {
+    const uint8_t *data;
+    size_t n = Log_peek(&data);
+    if (n == 0 || n >= size) return 0;
+    memcpy(buf, data, n);
+    buf[n] = '\0';
+    Log_consume(n);
+    return n;
+}
+
+void setUp(void) {
+    Log_init();
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Queue Tests
+// ============================================================================
+
+void test_empty_queue_has_nothing(void) {
+    const uint8_t *data;
+    TEST_ASSERT_EQUAL(0, Log_peek(&data));
+    Log_consume(5);     // Ignored on an empty queue
+    TEST_ASSERT_EQUAL_UINT32(0, Log_getStats().written);
+}
+
+void test_messages_leave_in_order(void) {
+    TEST_ASSERT_TRUE(Log_printf("[Nav] WP %d reached\n", 3));
+    const uint8_t frame[] = {0xAA, 0x00, 0x55};
+    TEST_ASSERT_TRUE(Log_write(frame, sizeof(frame)));
+
+    char buf[LOG_SLOT_SIZE + 1];
+    TEST_ASSERT_EQUAL(19, drainOne(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("[Nav] WP 3 reached\n", buf);
+
+    const uint8_t *data;
+    TEST_ASSERT_EQUAL(3, Log_peek(&data));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, data, 3);
+    Log_consume(3);
+    TEST_ASSERT_EQUAL(0, Log_peek(&data));
+
+    LogStats s = Log_getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, s.queued);
+    TEST_ASSERT_EQUAL_UINT32(2, s.written);
+}
+
+void test_partial_consume_resumes_mid_message(void) {
+    Log_printf("abcdef\n");
+    const uint8_t *data;
+    TEST_ASSERT_EQUAL(7, Log_peek(&data));
+    Log_consume(4);     // UART only took four bytes
+
+    TEST_ASSERT_EQUAL(3, Log_peek(&data));
+    TEST_ASSERT_EQUAL_MEMORY("ef\n", data, 3);
+    TEST_ASSERT_EQUAL_UINT32(0, Log_getStats().written);
+    Log_consume(3);
+    TEST_ASSERT_EQUAL_UINT32(1, Log_getStats().written);
+}
+
+// ============================================================================
+// Overflow Tests
+// ============================================================================
+
+void test_full_queue_drops_and_counts(void) {
+    for (int i = 0; i < LOG_SLOTS; i++) {
+        TEST_ASSERT_TRUE(Log_printf("%d\n", i));
+    }
+    TEST_ASSERT_FALSE(Log_printf("lost\n"));
+    TEST_ASSERT_FALSE(Log_printf("lost\n"));
+
+    LogStats s = Log_getStats();
+    TEST_ASSERT_EQUAL_UINT32(LOG_SLOTS, s.queued);
+    TEST_ASSERT_EQUAL_UINT32(2, s.dropped);
+    TEST_ASSERT_EQUAL_UINT32(LOG_SLOTS, s.highWater);
+
+    // One slot freed makes room for exactly one more
+    char buf[LOG_SLOT_SIZE + 1];
+    drainOne(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("0\n", buf);
+    TEST_ASSERT_TRUE(Log_printf("again\n"));
+    TEST_ASSERT_FALSE(Log_printf("lost\n"));
+}
+
+void test_long_text_is_cut_with_newline(void) {
+    char longText[LOG_SLOT_SIZE * 2];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    TEST_ASSERT_TRUE(Log_printf("%s\n", longText));
+
+    const uint8_t *data;
+    TEST_ASSERT_EQUAL(LOG_SLOT_SIZE, Log_peek(&data));
+    TEST_ASSERT_EQUAL('x', data[0]);
+    TEST_ASSERT_EQUAL('\n', data[LOG_SLOT_SIZE - 1]);
+    TEST_ASSERT_EQUAL_UINT32(1, Log_getStats().truncated);
+}
+
+void test_oversize_frame_is_refused(void) {
+    uint8_t frame[LOG_SLOT_SIZE + 1] = {0};
+    TEST_ASSERT_FALSE(Log_write(frame, sizeof(frame)));
+    TEST_ASSERT_TRUE(Log_write(frame, LOG_SLOT_SIZE));
+
+    LogStats s = Log_getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, s.oversize);
+    TEST_ASSERT_EQUAL_UINT32(1, s.queued);
+    TEST_ASSERT_EQUAL_UINT32(0, s.dropped);
+}
+
+// ============================================================================
+// Level Tests
+// ============================================================================
+
+void test_debug_compiled_out_at_default_level(void) {
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INFO, LOG_LEVEL);
+    LOG_DEBUG("hidden %d\n", 1);
+    LOG_INFO("shown %d\n", 2);
+    LOG_ERROR("shown %d\n", 3);
+
+    char buf[LOG_SLOT_SIZE + 1];
+    drainOne(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("shown 2\n", buf);
+    drainOne(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("shown 3\n", buf);
+    TEST_ASSERT_EQUAL_UINT32(2, Log_getStats().queued);
+}
+
+// ============================================================================
+// Concurrency Tests
+// ============================================================================
+
+void test_concurrent_producers_keep_messages_whole(void) {
+    const int producers = 4;
+    const int perProducer = 20000;
+    std::atomic<int> running(producers);
+    std::thread threads[producers];
+    for (int p = 0; p < producers; p++) {
+        threads[p] = std::thread([&, p]() {
+            for (int i = 0; i < perProducer; i++) {
+                Log_printf("p%d %06d ........................\n", p, i);
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    // Single drain: each message whole and per-producer order preserved
+    int last[producers];
+    for (int p = 0; p < producers; p++) last[p] = -1;
+    uint32_t received = 0, malformed = 0, reordered = 0;
+    char buf[LOG_SLOT_SIZE + 1];
+    for (;;) {
+        bool idle = running.load() == 0;
+        size_t n = drainOne(buf, sizeof(buf));
+        if (n == 0) {
+            if (idle) break;
+            continue;
+        }
+        int p, i;
+        if (n != 35 || sscanf(buf, "p%d %d", &p, &i) != 2 || p < 0 || p >= producers) {
+            malformed++;
+            continue;
+        }
+        if (i <= last[p]) reordered++;
+        last[p] = i;
+        received++;
+    }
+    for (int p = 0; p < producers; p++) threads[p].join();
+
+    LogStats s = Log_getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, malformed);
+    TEST_ASSERT_EQUAL_UINT32(0, reordered);
+    TEST_ASSERT_EQUAL_UINT32(s.queued, received);
+    TEST_ASSERT_EQUAL_UINT32(s.queued, s.written);
+    TEST_ASSERT_EQUAL_UINT32(producers * perProducer, s.queued + s.dropped);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Queue Tests
+    RUN_TEST(test_empty_queue_has_nothing);
+    RUN_TEST(test_messages_leave_in_order);
+    RUN_TEST(test_partial_consume_resumes_mid_message);
+
+    // Overflow Tests
+    RUN_TEST(test_full_queue_drops_and_counts);
+    RUN_TEST(test_long_text_is_cut_with_newline);
+    RUN_TEST(test_oversize_frame_is_refused);
+
+    // Level Tests
+    RUN_TEST(test_debug_compiled_out_at_default_level);
+
+    // Concurrency Tests
+    RUN_TEST(test_concurrent_producers_keep_messages_whole);
+
+    return UNITY_END();
+}
@@ -0,0 +1,115 @@
+/**
+ * Unit Tests for LoopTiming
+ * Tests log2 bucketing, period / execution / jitter recording and cycle
+ * counter wraparound
+ *
+ * @file test_LoopTiming.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "LoopTiming.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define MHZ 240
+#define US(x) ((uint32_t)(x) * MHZ)
+
+static LoopTimer timer;
+
+void setUp(void) {
+    LoopTiming_init(&timer, 20000, MHZ);    // 50 Hz
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Bucket Tests
+// ============================================================================
+
+void test_bucket_boundaries(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, LoopTiming_bucket(0));
+    TEST_ASSERT_EQUAL_UINT8(1, LoopTiming_bucket(1));
+    TEST_ASSERT_EQUAL_UINT8(2, LoopTiming_bucket(2));
+    TEST_ASSERT_EQUAL_UINT8(2, LoopTiming_bucket(3));
+    TEST_ASSERT_EQUAL_UINT8(11, LoopTiming_bucket(1024));
+    TEST_ASSERT_EQUAL_UINT8(LOOP_HIST_BUCKETS - 1, LoopTiming_bucket(0xFFFFFFFF));
+}
+
+// ============================================================================
+// Recording Tests
+// ============================================================================
+
+void test_first_iteration_has_no_period(void) {
+    LoopTiming_begin(&timer, US(1000));
+    LoopTiming_end(&timer, US(1500));
+
+    TEST_ASSERT_EQUAL_UINT32(1, timer.count);
+    TEST_ASSERT_EQUAL_UINT32(500, timer.lastExecUs);
+    TEST_ASSERT_EQUAL_UINT32(1, timer.execHist[LoopTiming_bucket(500)]);
+    for (int b = 0; b < LOOP_HIST_BUCKETS; b++) {
+        TEST_ASSERT_EQUAL_UINT32(0, timer.periodHist[b]);
+        TEST_ASSERT_EQUAL_UINT32(0, timer.jitterHist[b]);
+    }
+}
+
+void test_period_and_jitter(void) {
+    LoopTiming_begin(&timer, US(0));
+    LoopTiming_end(&timer, US(100));
+    LoopTiming_begin(&timer, US(20300));    // 300 us late
+    LoopTiming_end(&timer, US(20400));
+    LoopTiming_begin(&timer, US(40100));    // 200 us early
+
+    TEST_ASSERT_EQUAL_UINT32(19800, timer.lastPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(20300, timer.maxPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(200, timer.lastJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(300, timer.maxJitterUs);
+    TEST_ASSERT_EQUAL_UINT32(2, timer.periodHist[LoopTiming_bucket(20000)]);
+    TEST_ASSERT_EQUAL_UINT32(1, timer.jitterHist[LoopTiming_bucket(200)]);
+    TEST_ASSERT_EQUAL_UINT32(1, timer.jitterHist[LoopTiming_bucket(300)]);
+}
+
+void test_cycle_counter_wraparound(void) {
+    uint32_t start = 0xFFFFFFFF - US(50) + 1;
+    LoopTiming_begin(&timer, start);
+    LoopTiming_end(&timer, start + US(120));  // Wraps past zero
+    TEST_ASSERT_EQUAL_UINT32(120, timer.lastExecUs);
+}
+
+void test_end_without_begin_ignored(void) {
+    LoopTiming_end(&timer, US(100));
+    TEST_ASSERT_EQUAL_UINT32(0, timer.count);
+}
+
+void test_reset_keeps_configuration(void) {
+    LoopTiming_begin(&timer, US(0));
+    LoopTiming_end(&timer, US(10));
+    LoopTiming_resetStats(&timer);
+
+    TEST_ASSERT_EQUAL_UINT32(0, timer.count);
+    TEST_ASSERT_EQUAL_UINT32(0, timer.execHist[LoopTiming_bucket(10)]);
+    TEST_ASSERT_EQUAL_UINT32(20000, timer.nominalPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(MHZ, timer.cyclesPerUs);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Bucket Tests
+    RUN_TEST(test_bucket_boundaries);
+
+    // Recording Tests
+    RUN_TEST(test_first_iteration_has_no_period);
+    RUN_TEST(test_period_and_jitter);
+    RUN_TEST(test_cycle_counter_wraparound);
+    RUN_TEST(test_end_without_begin_ignored);
+    RUN_TEST(test_reset_keeps_configuration);
+
+    return UNITY_END();
+}
@@ -0,0 +1,98 @@
+/**
+ * Unit Tests for MS4525Async
+ * Tests decoding of the 4-byte reading and the airspeed conversion
+ *
+ * @file test_MS4525Async.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "drivers/MS4525Async.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static void encode(uint8_t status, uint16_t pCounts, uint16_t tCounts, uint8_t* raw) {
+    raw[0] = (uint8_t)(status << 6) | (uint8_t)(pCounts >> 8);
+    raw[1] = (uint8_t)pCounts;
+    raw[2] = (uint8_t)(tCounts >> 3);
+    raw[3] = (uint8_t)(tCounts << 5);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Decode Tests
+// ============================================================================
+
+void test_mid_scale_is_zero_pressure(void) {
+    uint8_t raw[4];
+    float pa, celsius;
+    encode(0, 8192, 0, raw);
+    TEST_ASSERT_EQUAL(MS4525Async::STATUS_OK, MS4525Async::parse(raw, &pa, &celsius));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, pa);
+}
+
+void test_full_scale_pressure(void) {
+    uint8_t raw[4];
+    float pa, celsius;
+    encode(0, 14746, 0, raw);                   // 90 %: +1 psi
+    MS4525Async::parse(raw, &pa, &celsius);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, 6894.757f, pa);
+    encode(0, 1638, 0, raw);                    // 10 %: -1 psi
+    MS4525Async::parse(raw, &pa, &celsius);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, -6894.757f, pa);
+}
+
+void test_temperature(void) {
+    uint8_t raw[4];
+    float pa, celsius;
+    encode(0, 8192, 0, raw);
+    MS4525Async::parse(raw, &pa, &celsius);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, -50.0f, celsius);
+    encode(0, 8192, 767, raw);                  // 767 * 200 / 2047 - 50 = 24.9 C
+    MS4525Async::parse(raw, &pa, &celsius);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 24.9f, celsius);
+}
+
+void test_status_bits(void) {
+    uint8_t raw[4];
+    float pa, celsius;
+    encode(2, 8192, 0, raw);
+    TEST_ASSERT_EQUAL(MS4525Async::STATUS_STALE, MS4525Async::parse(raw, &pa, &celsius));
+    encode(3, 8192, 0, raw);
+    TEST_ASSERT_EQUAL(MS4525Async::STATUS_FAULT, MS4525Async::parse(raw, &pa, &celsius));
+}
+
+// ============================================================================
+// Airspeed Tests
+// ============================================================================
+
+void test_airspeed_from_pressure(void) {
+    // 15 m/s at sea level: q = 0.5 * 1.225 * 225 = 137.8 Pa
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, MS4525Async::airspeedFromPa(137.8125f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, MS4525Async::airspeedFromPa(-137.8125f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, MS4525Async::airspeedFromPa(0.0f));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Decode Tests
+    RUN_TEST(test_mid_scale_is_zero_pressure);
+    RUN_TEST(test_full_scale_pressure);
+    RUN_TEST(test_temperature);
+    RUN_TEST(test_status_bits);
+
+    // Airspeed Tests
+    RUN_TEST(test_airspeed_from_pressure);
+
+    return UNITY_END();
+}
@@ -0,0 +1,90 @@
+/**
+ * Unit Tests for MS5611Async
+ * Tests the compensation against the datasheet example, the cold second
+ * order terms and the PROM CRC
+ *
+ * @file test_MS5611Async.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "drivers/MS5611Async.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+// Datasheet example: C1..C6, D1 9085466, D2 8569150 -> 20.07 C, 1000.09 mbar
+static const uint16_t DATASHEET_PROM[8] = {0, 40127, 36924, 23317, 23282, 33464, 28312, 0};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Compensation Tests
+// ============================================================================
+
+void test_datasheet_example(void) {
+    float mbar, celsius;
+    MS5611Async::compute(DATASHEET_PROM, 9085466, 8569150, &mbar, &celsius);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 20.07f, celsius);
+    TEST_ASSERT_FLOAT_WITHIN(0.015f, 1000.09f, mbar);
+}
+
+void test_cold_second_order(void) {
+    // dT -997634 -> -13.67 C before the correction, T2 = dT^2 / 2^31 = 4.63
+    float mbar, celsius, firstOrder;
+    uint32_t d2 = 8569150 - 1000000;
+    MS5611Async::compute(DATASHEET_PROM, 9085466, d2, &mbar, &celsius);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, -18.30f, celsius);
+
+    // Same reading, first order only: OFF / SENS by hand
+    int32_t dT = (int32_t)d2 - 33464 * 256;
+    int64_t off = 36924LL * 65536 + (23282LL * dT) / 128;
+    int64_t sens = 40127LL * 32768 + (23317LL * dT) / 256;
+    firstOrder = ((((int64_t)9085466 * sens) / 2097152 - off) / 32768) / 100.0f;
+    TEST_ASSERT_TRUE(mbar != firstOrder);
+}
+
+// ============================================================================
+// CRC Tests
+// ============================================================================
+
+void test_crc_in_word7(void) {
+    uint16_t prom[8];
+    for (int i = 0; i < 8; i++) prom[i] = DATASHEET_PROM[i];
+    prom[7] = 0x1200;
+    uint8_t crc = MS5611Async::crc4(prom);
+    prom[7] |= crc;
+    TEST_ASSERT_EQUAL_UINT8(crc, MS5611Async::crc4(prom));     // Own nibble ignored
+    TEST_ASSERT_EQUAL_UINT8(prom[7] & 0x0F, MS5611Async::crc4(prom));
+
+    prom[3] ^= 0x0100;
+    TEST_ASSERT_NOT_EQUAL(prom[7] & 0x0F, MS5611Async::crc4(prom));
+}
+
+void test_conversion_times(void) {
+    TEST_ASSERT_TRUE(MS5611Async::conversionTimeUs(MS5611Async::OSR_4096) >= 9040);
+    TEST_ASSERT_TRUE(MS5611Async::conversionTimeUs(MS5611Async::OSR_256) >= 540);
+    TEST_ASSERT_EQUAL_UINT32(MS5611Async::conversionTimeUs(MS5611Async::OSR_4096),
+                             MS5611Async::conversionTimeUs((MS5611Async::Osr)9));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Compensation Tests
+    RUN_TEST(test_datasheet_example);
+    RUN_TEST(test_cold_second_order);
+
+    // CRC Tests
+    RUN_TEST(test_crc_in_word7);
+    RUN_TEST(test_conversion_times);
+
+    return UNITY_END();
+}
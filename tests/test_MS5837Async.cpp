@@ -0,0 +1,73 @@
+/**
+ * Unit Tests for MS5837Async
+ * Tests compensation math against the datasheet example and OSR timing
+ *
+ * @file test_MS5837Async.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "drivers/MS5837Async.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+// MS5837-30BA datasheet example calibration (C0 = CRC/factory word)
+static const uint16_t kProm30BA[7] = {0, 34982, 36352, 20328, 22354, 26646, 26146};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Compensation Tests
+// ============================================================================
+
+void test_datasheet_example_30BA(void) {
+    float mbar, celsius;
+    MS5837Async::compute(MS5837Async::MODEL_30BA, kProm30BA, 4958179, 6815414,
+                         &mbar, &celsius);
+    // Datasheet: 19.81 C, 3999.8 mbar (first order; second order is < 0.5 mbar here)
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 19.81f, celsius);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 3999.8f, mbar);
+}
+
+void test_pressure_rises_with_d1(void) {
+    float low, high, celsius;
+    MS5837Async::compute(MS5837Async::MODEL_30BA, kProm30BA, 4958179, 6815414,
+                         &low, &celsius);
+    MS5837Async::compute(MS5837Async::MODEL_30BA, kProm30BA, 5058179, 6815414,
+                         &high, &celsius);
+    TEST_ASSERT_TRUE(high > low);
+}
+
+// ============================================================================
+// Timing Tests
+// ============================================================================
+
+void test_conversion_time_grows_with_osr(void) {
+    for (uint8_t osr = MS5837Async::OSR_256; osr < MS5837Async::OSR_8192; osr++) {
+        TEST_ASSERT_TRUE(MS5837Async::conversionTimeUs((MS5837Async::Osr)osr) <
+                         MS5837Async::conversionTimeUs((MS5837Async::Osr)(osr + 1)));
+    }
+    // Longest conversion still fits in the 20ms control period
+    TEST_ASSERT_TRUE(MS5837Async::conversionTimeUs(MS5837Async::OSR_8192) < 20000);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Compensation Tests
+    RUN_TEST(test_datasheet_example_30BA);
+    RUN_TEST(test_pressure_rises_with_d1);
+
+    // Timing Tests
+    RUN_TEST(test_conversion_time_grows_with_osr);
+
+    return UNITY_END();
+}
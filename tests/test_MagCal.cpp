@@ -0,0 +1,273 @@
+/**
+ * Unit Tests for MagCal
+ * Tests hard / soft-iron recovery from tumbling, the planar fit for level
+ * turns with the origin outside the ellipse, coverage and step gating,
+ * following a payload change, the disturbance gate, heading math and
+ * config / record sanitizing
+ *
+ * @file test_MagCal.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "MagCal.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static MagCal mc;
+static MagCalRecord rec;
+static const float EARTH[3] = {20.0f, 0.0f, -40.0f};     // North on x, pointing down
+static float softIron[3][3];
+static float hardIron[3];
+
+static void setIron(float ox, float oy, float oz, float sx, float sy, float sxy) {
+    hardIron[0] = ox; hardIron[1] = oy; hardIron[2] = oz;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            softIron[i][j] = i == j ? 1.0f : 0.0f;
+    softIron[0][0] = sx;
+    softIron[1][1] = sy;
+    softIron[0][1] = softIron[1][0] = sxy;
+}
+
+// Body field for yaw (CCW), pitch, roll: R' * EARTH, R = Rz Ry Rx
+static void bodyField(float yaw, float pitch, float roll, float b[3]) {
+    float cy = cosf(yaw), sy = sinf(yaw), cp = cosf(pitch), sp = sinf(pitch);
+    float cr = cosf(roll), sr = sinf(roll);
+    float R[3][3] = {{cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr},
+                     {sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr},
+                     {-sp, cp * sr, cp * cr}};
+    for (int i = 0; i < 3; i++)
+        b[i] = R[0][i] * EARTH[0] + R[1][i] * EARTH[1] + R[2][i] * EARTH[2];
+}
+
+// What the sensor reads: soft * b + hard, with a small deterministic ripple
+static void sensor(const float b[3], int n, float m[3]) {
+    for (int i = 0; i < 3; i++) {
+        m[i] = hardIron[i] + 0.2f * sinf(n * 1.7f + i);
+        for (int j = 0; j < 3; j++)
+            m[i] += softIron[i][j] * b[j];
+    }
+}
+
+// Feed a motion; returns the number of fits taken
+static int feedMotion(int samples, bool tumble, float yawSpan) {
+    int fits = 0;
+    for (int n = 0; n < samples; n++) {
+        float yaw = yawSpan * n / samples;
+        float pitch = tumble ? 0.9f * sinf(n * 0.0071f) : 0.0f;
+        float roll = tumble ? 1.2f * sinf(n * 0.0053f) : 0.0f;
+        float b[3], m[3];
+        bodyField(yaw, pitch, roll, b);
+        sensor(b, n, m);
+        if (MagCal_feed(&mc, m))
+            fits++;
+    }
+    return fits;
+}
+
+// Largest heading error over a level turn, deg
+static float levelHeadingError(void) {
+    float worst = 0.0f;
+    for (int d = 0; d < 360; d += 10) {
+        float yaw = d * 0.0174533f;
+        float b[3], m[3], c[3];
+        bodyField(yaw, 0.0f, 0.0f, b);
+        sensor(b, d, m);
+        MagCal_correct(&mc, m, c);
+        // Estimator earth frame: body turned by yaw, gyro heading -yaw
+        float e[3] = {cosf(yaw) * c[0] - sinf(yaw) * c[1], sinf(yaw) * c[0] + cosf(yaw) * c[1], c[2]};
+        float h = MagCal_heading(e, (float)-d, 0.0f);
+        float err = fabsf(fmodf(h - (float)(360 - d) + 540.0f, 360.0f) - 180.0f);
+        if (err > worst)
+            worst = err;
+    }
+    return worst;
+}
+
+void setUp(void) {
+    setIron(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f);
+    MagCal_defaultRecord(&rec);
+    MagCal_init(&mc, &rec);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Fit Tests
+// ============================================================================
+
+void test_default_passes_raw_through(void) {
+    float raw[3] = {10.0f, -5.0f, 30.0f}, out[3];
+    MagCal_correct(&mc, raw, out);
+    TEST_ASSERT_EQUAL_FLOAT(-5.0f, out[1]);
+    TEST_ASSERT_TRUE(MagCal_disturbed(&mc, out));
+}
+
+void test_tumble_recovers_hard_and_soft_iron(void) {
+    setIron(25.0f, -40.0f, 12.0f, 1.1f, 0.92f, 0.05f);
+    TEST_ASSERT_TRUE(feedMotion(20000, true, 260.0f) > 0);
+    TEST_ASSERT_TRUE(mc.cal.valid);
+    TEST_ASSERT_FALSE(mc.cal.planar);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 25.0f, mc.cal.offset[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, -40.0f, mc.cal.offset[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 12.0f, mc.cal.offset[2]);
+    TEST_ASSERT_TRUE(mc.cal.residual < 0.01f);
+    // Any attitude: corrected strength within 1 % of the fitted radius
+    for (int n = 0; n < 50; n++) {
+        float b[3], m[3], c[3];
+        bodyField(n * 0.7f, sinf(n * 1.3f), 2.0f * sinf(n * 0.9f), b);
+        sensor(b, n, m);
+        MagCal_correct(&mc, m, c);
+        float norm = sqrtf(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f * mc.cal.radiusUt, mc.cal.radiusUt, norm);
+    }
+    TEST_ASSERT_TRUE(levelHeadingError() < 2.0f);
+}
+
+void test_level_turns_fit_planar(void) {
+    // Offset larger than the horizontal field: origin outside the ellipse
+    setIron(25.0f, -40.0f, 12.0f, 1.1f, 0.92f, 0.05f);
+    TEST_ASSERT_TRUE(feedMotion(3000, false, 6.0f * 6.2832f) > 0);
+    TEST_ASSERT_TRUE(mc.cal.valid);
+    TEST_ASSERT_TRUE(mc.cal.planar);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 25.0f, mc.cal.offset[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, -40.0f, mc.cal.offset[1]);
+    TEST_ASSERT_TRUE(levelHeadingError() < 2.0f);
+}
+
+void test_half_turn_not_enough(void) {
+    TEST_ASSERT_EQUAL(0, feedMotion(3000, false, 3.1416f));
+    TEST_ASSERT_FALSE(mc.cal.valid);
+    TEST_ASSERT_TRUE(MagCal_coverageCount(mc.coverage) < MAG_CAL_MIN_SECTORS);
+}
+
+void test_parked_samples_skipped(void) {
+    float raw[3] = {20.0f, 0.0f, -40.0f};
+    for (int i = 0; i < 1000; i++) {
+        raw[0] = 20.0f + 0.1f * (i & 1);
+        MagCal_feed(&mc, raw);
+    }
+    TEST_ASSERT_EQUAL(1, mc.accepted);
+}
+
+void test_follows_payload_change(void) {
+    setIron(10.0f, 5.0f, 0.0f, 1.0f, 1.0f, 0.0f);
+    feedMotion(20000, true, 260.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 10.0f, mc.cal.offset[0]);
+    // Old samples fade by MAG_CAL_FORGET per accepted sample
+    setIron(-15.0f, 5.0f, 0.0f, 1.0f, 1.0f, 0.0f);
+    for (int i = 0; i < 3; i++)
+        feedMotion(20000, true, 260.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, -15.0f, mc.cal.offset[0]);
+}
+
+void test_stored_record_applies_from_start(void) {
+    setIron(25.0f, -40.0f, 12.0f, 1.0f, 1.0f, 0.0f);
+    feedMotion(20000, true, 260.0f);
+    rec = mc.cal;
+    TEST_ASSERT_TRUE(MagCal_sanitizeRecord(&rec));
+    MagCal_init(&mc, &rec);
+    TEST_ASSERT_EQUAL(0, mc.accepted);
+    TEST_ASSERT_TRUE(levelHeadingError() < 2.0f);
+}
+
+void test_reset_forgets_fit(void) {
+    feedMotion(20000, true, 260.0f);
+    TEST_ASSERT_TRUE(mc.cal.valid);
+    MagCal_reset(&mc);
+    TEST_ASSERT_FALSE(mc.cal.valid);
+    TEST_ASSERT_EQUAL(0, mc.accepted);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, mc.weight);
+}
+
+// ============================================================================
+// Heading Tests
+// ============================================================================
+
+void test_disturbed_gate(void) {
+    feedMotion(20000, true, 260.0f);
+    float b[3], m[3], c[3];
+    bodyField(0.3f, 0.0f, 0.0f, b);
+    sensor(b, 0, m);
+    MagCal_correct(&mc, m, c);
+    TEST_ASSERT_FALSE(MagCal_disturbed(&mc, c));
+    for (int i = 0; i < 3; i++)
+        c[i] *= 1.0f + 2.0f * MAG_CAL_FIELD_GATE;
+    TEST_ASSERT_TRUE(MagCal_disturbed(&mc, c));
+}
+
+void test_heading_math(void) {
+    float north[3] = {20.0f, 0.0f, -40.0f};
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, MagCal_heading(north, 0.0f, 0.0f));
+    // North 90 deg left of the estimator's x axis: facing east
+    float left[3] = {0.0f, 20.0f, -40.0f};
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, MagCal_heading(left, 0.0f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 120.0f, MagCal_heading(left, 30.0f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 355.0f, MagCal_heading(north, 0.0f, -5.0f));
+}
+
+// ============================================================================
+// Config Tests
+// ============================================================================
+
+void test_sanitize_config(void) {
+    MagConfig config;
+    MagCal_defaultConfig(&config);
+    TEST_ASSERT_EQUAL(1, config.enabled);
+    TEST_ASSERT_EQUAL(1, config.learn);
+    config.enabled = 7;
+    config.declinationDeg = 190.0f;
+    MagCal_sanitize(&config);
+    TEST_ASSERT_EQUAL(1, config.enabled);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -170.0f, config.declinationDeg);
+    config.declinationDeg = NAN;
+    MagCal_sanitize(&config);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, config.declinationDeg);
+}
+
+void test_sanitize_record(void) {
+    rec.valid = 1;
+    rec.radiusUt = 45.0f;
+    TEST_ASSERT_TRUE(MagCal_sanitizeRecord(&rec));
+    rec.radiusUt = 5.0f;
+    TEST_ASSERT_FALSE(MagCal_sanitizeRecord(&rec));
+    TEST_ASSERT_EQUAL(0, rec.valid);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, rec.soft[2][2]);
+    rec.offset[1] = NAN;
+    TEST_ASSERT_FALSE(MagCal_sanitizeRecord(&rec));
+    rec.version = MAG_CAL_VERSION + 1;
+    TEST_ASSERT_FALSE(MagCal_sanitizeRecord(&rec));
+    TEST_ASSERT_EQUAL(MAG_CAL_VERSION, rec.version);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Fit Tests
+    RUN_TEST(test_default_passes_raw_through);
+    RUN_TEST(test_tumble_recovers_hard_and_soft_iron);
+    RUN_TEST(test_level_turns_fit_planar);
+    RUN_TEST(test_half_turn_not_enough);
+    RUN_TEST(test_parked_samples_skipped);
+    RUN_TEST(test_follows_payload_change);
+    RUN_TEST(test_stored_record_applies_from_start);
+    RUN_TEST(test_reset_forgets_fit);
+
+    // Heading Tests
+    RUN_TEST(test_disturbed_gate);
+    RUN_TEST(test_heading_math);
+
+    // Config Tests
+    RUN_TEST(test_sanitize_config);
+    RUN_TEST(test_sanitize_record);
+
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+/**
+ * Unit Tests for MavLink
+ * Tests the CRC, frame sealing with trailing-zero truncation and the
+ * in-place parse
+ *
+ * @file test_MavLink.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "MavLink.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t frame[MAVLINK_MAX_FRAME];
+static MavLinkTx tx;
+
+void setUp(void) {
+    memset(frame, 0, sizeof(frame));
+    tx.systemId = 1;
+    tx.componentId = 1;
+    tx.seq = 0;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Framing Tests
+// ============================================================================
+
+void test_crc_check_value(void) {
+    // CRC-16/MCRF4XX check value
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_HEX16(0x6F91, MavLink_crc(data, sizeof(data), 0xFFFF));
+}
+
+void test_struct_sizes_match_wire(void) {
+    TEST_ASSERT_EQUAL(9, sizeof(MavHeartbeat));
+    TEST_ASSERT_EQUAL(31, sizeof(MavSysStatus));
+    TEST_ASSERT_EQUAL(25, sizeof(MavParamValue));
+    TEST_ASSERT_EQUAL(28, sizeof(MavGlobalPositionInt));
+    TEST_ASSERT_EQUAL(38, sizeof(MavMissionItemInt));
+    TEST_ASSERT_EQUAL(33, sizeof(MavCommandLong));
+}
+
+void test_heartbeat_frame_truncated(void) {
+    MavHeartbeat* hb = (MavHeartbeat*)MavLink_payload(frame);
+    hb->type = MAV_TYPE_GROUND_ROVER;
+    hb->autopilot = MAV_AUTOPILOT_GENERIC;
+    hb->baseMode = MAV_MODE_FLAG_MANUAL_INPUT_ENABLED;
+    hb->systemStatus = MAV_STATE_STANDBY;
+    hb->mavlinkVersion = 3;
+
+    size_t len = MavLink_finish(&tx, frame, MAVLINK_MSG_HEARTBEAT, sizeof(MavHeartbeat));
+    TEST_ASSERT_EQUAL(MAVLINK_HEADER_LEN + 9 + MAVLINK_CHECKSUM_LEN, len);
+    TEST_ASSERT_EQUAL_UINT8(MAVLINK_STX, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(9, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(1, tx.seq);
+
+    // An all-zero tail is cut down to a single byte
+    memset(frame, 0, sizeof(frame));
+    len = MavLink_finish(&tx, frame, MAVLINK_MSG_MISSION_ACK, sizeof(MavMissionAck));
+    TEST_ASSERT_EQUAL_UINT8(1, frame[1]);
+    TEST_ASSERT_EQUAL(MAVLINK_HEADER_LEN + 1 + MAVLINK_CHECKSUM_LEN, len);
+}
+
+void test_round_trip_restores_zeros(void) {
+    MavMissionCount* count = (MavMissionCount*)MavLink_payload(frame);
+    count->count = 3;
+    count->targetSystem = 1;
+    size_t len = MavLink_finish(&tx, frame, MAVLINK_MSG_MISSION_COUNT, sizeof(MavMissionCount));
+    TEST_ASSERT_EQUAL_UINT8(3, frame[1]);
+
+    // Stale bytes past the truncated payload must not leak into the view
+    frame[len] = 0xAA;
+    frame[len + 1] = 0xBB;
+    MavLinkView view;
+    TEST_ASSERT_EQUAL(MAVLINK_PARSE_OK, MavLink_parse(frame, len, &view));
+    TEST_ASSERT_EQUAL_UINT32(MAVLINK_MSG_MISSION_COUNT, view.msgid);
+    TEST_ASSERT_EQUAL_UINT8(1, view.systemId);
+    const MavMissionCount* got = (const MavMissionCount*)view.payload;
+    TEST_ASSERT_EQUAL_UINT16(3, got->count);
+    TEST_ASSERT_EQUAL_UINT8(0, got->targetComponent);
+    TEST_ASSERT_EQUAL_UINT8(0, got->missionType);
+}
+
+void test_parse_rejects_bad_frames(void) {
+    MavLink_payload(frame)[0] = 1;
+    size_t len = MavLink_finish(&tx, frame, MAVLINK_MSG_PARAM_REQUEST_LIST,
+                                sizeof(MavParamRequestList));
+    MavLinkView view;
+
+    TEST_ASSERT_EQUAL(MAVLINK_PARSE_SHORT, MavLink_parse(frame, len - 1, &view));
+
+    frame[len - 1] ^= 0x01;
+    TEST_ASSERT_EQUAL(MAVLINK_PARSE_CRC, MavLink_parse(frame, len, &view));
+    frame[len - 1] ^= 0x01;
+
+    frame[7] = 200; // No CRC_EXTRA for this id
+    TEST_ASSERT_EQUAL(MAVLINK_PARSE_UNKNOWN, MavLink_parse(frame, len, &view));
+
+    frame[2] = MAVLINK_IFLAG_SIGNED;
+    TEST_ASSERT_EQUAL(MAVLINK_PARSE_SIGNED,
+                      MavLink_parse(frame, len + MAVLINK_SIGNATURE_LEN, &view));
+}
+
+void test_finish_unknown_message(void) {
+    TEST_ASSERT_EQUAL(0, MavLink_finish(&tx, frame, 9999, 4));
+    TEST_ASSERT_EQUAL_UINT8(0, tx.seq);
+}
+
+// ============================================================================
+// Helper Tests
+// ============================================================================
+
+void test_param_id(void) {
+    char id[MAVLINK_PARAM_ID_LEN];
+    MavLink_setParamId(id, "PID_KP");
+    TEST_ASSERT_TRUE(MavLink_paramIdEquals(id, "PID_KP"));
+    TEST_ASSERT_FALSE(MavLink_paramIdEquals(id, "PID_K"));
+    TEST_ASSERT_FALSE(MavLink_paramIdEquals(id, "PID_KPX"));
+
+    // Sixteen characters fill the field with no terminator
+    MavLink_setParamId(id, "ABCDEFGHIJKLMNOP");
+    TEST_ASSERT_TRUE(MavLink_paramIdEquals(id, "ABCDEFGHIJKLMNOP"));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Framing Tests
+    RUN_TEST(test_crc_check_value);
+    RUN_TEST(test_struct_sizes_match_wire);
+    RUN_TEST(test_heartbeat_frame_truncated);
+    RUN_TEST(test_round_trip_restores_zeros);
+    RUN_TEST(test_parse_rejects_bad_frames);
+    RUN_TEST(test_finish_unknown_message);
+
+    // Helper Tests
+    RUN_TEST(test_param_id);
+
+    return UNITY_END();
+}
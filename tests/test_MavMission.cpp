@@ -0,0 +1,178 @@
+/**
+ * Unit Tests for MavMission
+ * Tests the item mapping both ways and the upload request / retry flow
+ *
+ * @file test_MavMission.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "MavMission.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static MavMissionUpload up;
+static WaypointRecord buffer[4];
+
+static MavMissionItemInt makeItem(uint16_t seq, uint16_t command, uint8_t frame) {
+    MavMissionItemInt item;
+    memset(&item, 0, sizeof(item));
+    item.seq = seq;
+    item.command = command;
+    item.frame = frame;
+    return item;
+}
+
+static MavMissionItemInt waypoint(uint16_t seq) {
+    MavMissionItemInt item = makeItem(seq, MAV_CMD_NAV_WAYPOINT,
+                                      MAV_FRAME_GLOBAL_RELATIVE_ALT_INT);
+    item.x = 137000000 + seq;
+    item.y = 1005000000;
+    item.z = 12.3f;
+    return item;
+}
+
+void setUp(void) {
+    memset(&up, 0, sizeof(up));
+    memset(buffer, 0, sizeof(buffer));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Conversion Tests
+// ============================================================================
+
+void test_waypoint_round_trip(void) {
+    MavMissionItemInt item = waypoint(2);
+    WaypointRecord rec;
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_ACCEPTED, MavMission_fromItem(&item, &rec));
+    TEST_ASSERT_EQUAL_UINT8(MISSION_CMD_WAYPOINT, rec.cmd);
+    TEST_ASSERT_EQUAL_INT32(137000002, rec.lat);
+    TEST_ASSERT_EQUAL_INT16(123, rec.alt);
+
+    MavMissionItemInt back;
+    MavMission_toItem(&rec, 2, &back);
+    TEST_ASSERT_EQUAL_UINT16(MAV_CMD_NAV_WAYPOINT, back.command);
+    TEST_ASSERT_EQUAL_UINT8(MAV_FRAME_GLOBAL_RELATIVE_ALT_INT, back.frame);
+    TEST_ASSERT_EQUAL_INT32(1005000000, back.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 12.3f, back.z);
+    TEST_ASSERT_EQUAL_UINT16(2, back.seq);
+}
+
+void test_command_items(void) {
+    WaypointRecord rec;
+    MavMissionItemInt item = makeItem(0, MAV_CMD_DO_CHANGE_SPEED, MAV_FRAME_MISSION);
+    item.param3 = 40.0f;
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_ACCEPTED, MavMission_fromItem(&item, &rec));
+    TEST_ASSERT_EQUAL_UINT8(MISSION_CMD_SET_SPEED, rec.cmd);
+    TEST_ASSERT_EQUAL_UINT16(1400, rec.param);
+
+    item = makeItem(0, MAV_CMD_DO_JUMP, MAV_FRAME_MISSION);
+    item.param1 = 1.0f;
+    item.param2 = -1.0f;
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_ACCEPTED, MavMission_fromItem(&item, &rec));
+    TEST_ASSERT_EQUAL_UINT8(0, rec.arg);
+    MavMissionItemInt back;
+    MavMission_toItem(&rec, 0, &back);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, back.param2);
+
+    item = makeItem(0, MAV_CMD_DO_CHANGE_ALTITUDE, MAV_FRAME_MISSION);
+    item.param1 = -2.5f;
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_ACCEPTED, MavMission_fromItem(&item, &rec));
+    TEST_ASSERT_EQUAL_UINT8(MISSION_CMD_SET_DEPTH, rec.cmd);
+    TEST_ASSERT_EQUAL_INT16(25, rec.alt);
+}
+
+void test_rejected_items(void) {
+    WaypointRecord rec;
+    MavMissionItemInt item = waypoint(0);
+    item.frame = 0; // AMSL: our altitudes are relative to home
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_UNSUPPORTED_FRAME, MavMission_fromItem(&item, &rec));
+
+    item = waypoint(0);
+    item.x = 950000000;
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_INVALID_PARAM5_X, MavMission_fromItem(&item, &rec));
+
+    item = makeItem(0, 22, MAV_FRAME_GLOBAL_RELATIVE_ALT); // NAV_TAKEOFF
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_UNSUPPORTED, MavMission_fromItem(&item, &rec));
+
+    item = makeItem(0, MAV_CMD_DO_JUMP, MAV_FRAME_MISSION);
+    item.param2 = 0.0f;
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_INVALID_PARAM2, MavMission_fromItem(&item, &rec));
+}
+
+// ============================================================================
+// Upload Tests
+// ============================================================================
+
+void test_upload_requests_in_order(void) {
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_REQUEST,
+                      MavMissionUpload_begin(&up, buffer, 3, 255, 190, 1000));
+    TEST_ASSERT_EQUAL_UINT16(0, up.next);
+
+    MavMissionItemInt item = waypoint(0);
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_REQUEST, MavMissionUpload_item(&up, &item, 1010));
+    TEST_ASSERT_EQUAL_UINT16(1, up.next);
+
+    // Out of order: ask for the expected item again
+    item = waypoint(2);
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_REQUEST, MavMissionUpload_item(&up, &item, 1020));
+    TEST_ASSERT_EQUAL_UINT16(1, up.next);
+
+    item = waypoint(1);
+    MavMissionUpload_item(&up, &item, 1030);
+    item = makeItem(2, MAV_CMD_NAV_RETURN_TO_LAUNCH, MAV_FRAME_MISSION);
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_COMPLETE, MavMissionUpload_item(&up, &item, 1040));
+    TEST_ASSERT_EQUAL_UINT8(MISSION_CMD_RTL, buffer[2].cmd);
+    TEST_ASSERT_EQUAL_INT32(137000001, buffer[1].lat);
+}
+
+void test_upload_rejects_bad_jump_target(void) {
+    MavMissionUpload_begin(&up, buffer, 2, 255, 190, 0);
+    MavMissionItemInt item = makeItem(0, MAV_CMD_DO_JUMP, MAV_FRAME_MISSION);
+    item.param1 = 2.0f;
+    item.param2 = 3.0f;
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_ABORT, MavMissionUpload_item(&up, &item, 10));
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_INVALID_PARAM1, up.result);
+    TEST_ASSERT_FALSE(up.active);
+}
+
+void test_upload_retries_then_cancels(void) {
+    MavMissionUpload_begin(&up, buffer, 2, 255, 190, 0);
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_NONE,
+                      MavMissionUpload_poll(&up, MAV_MISSION_RETRY_MS - 1));
+
+    uint32_t now = 0;
+    for (int i = 0; i < MAV_MISSION_RETRIES; i++) {
+        now += MAV_MISSION_RETRY_MS;
+        TEST_ASSERT_EQUAL(MAV_MISSION_STEP_REQUEST, MavMissionUpload_poll(&up, now));
+    }
+    now += MAV_MISSION_RETRY_MS;
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_ABORT, MavMissionUpload_poll(&up, now));
+    TEST_ASSERT_EQUAL_UINT8(MAV_MISSION_OPERATION_CANCELLED, up.result);
+    TEST_ASSERT_EQUAL(MAV_MISSION_STEP_NONE, MavMissionUpload_poll(&up, now * 2));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Conversion Tests
+    RUN_TEST(test_waypoint_round_trip);
+    RUN_TEST(test_command_items);
+    RUN_TEST(test_rejected_items);
+
+    // Upload Tests
+    RUN_TEST(test_upload_requests_in_order);
+    RUN_TEST(test_upload_rejects_bad_jump_target);
+    RUN_TEST(test_upload_retries_then_cancels);
+
+    return UNITY_END();
+}
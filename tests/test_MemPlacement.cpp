@@ -0,0 +1,111 @@
+/**
+ * Unit Tests for MemPlacement
+ * Tests the placement ledger: allocations and noted statics, totals and
+ * a full table (on the host every region is internal)
+ *
+ * @file test_MemPlacement.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "MemPlacement.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t staticBuffer[512];
+
+void setUp(void) {
+    MemPlacement_reset();
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Ledger Tests
+// ============================================================================
+
+void test_alloc_is_listed_until_freed(void) {
+    void* p = MemPlacement_alloc("ota_dict", 1024, MEM_CLASS_BULK);
+    TEST_ASSERT_NOT_NULL(p);
+
+    MemPlacementEntry entries[MEM_PLACEMENT_MAX_ENTRIES];
+    TEST_ASSERT_EQUAL_UINT8(1, MemPlacement_getEntries(entries, MEM_PLACEMENT_MAX_ENTRIES));
+    TEST_ASSERT_EQUAL_STRING("ota_dict", entries[0].tag);
+    TEST_ASSERT_EQUAL_UINT32(1024, entries[0].size);
+    TEST_ASSERT_EQUAL_UINT8(MEM_CLASS_BULK, entries[0].memClass);
+    TEST_ASSERT_EQUAL_UINT8(MEM_REGION_INTERNAL, entries[0].region);
+    TEST_ASSERT_TRUE(entries[0].heap);
+    TEST_ASSERT_EQUAL_UINT32(1024, MemPlacement_getStats().internalBytes);
+
+    MemPlacement_free(p);
+    TEST_ASSERT_EQUAL_UINT8(0, MemPlacement_getEntries(entries, MEM_PLACEMENT_MAX_ENTRIES));
+    TEST_ASSERT_EQUAL_UINT32(0, MemPlacement_getStats().internalBytes);
+}
+
+void test_note_static_once(void) {
+    MemPlacement_note("trace", staticBuffer, sizeof(staticBuffer), MEM_CLASS_INTERNAL);
+    MemPlacement_note("trace", staticBuffer, sizeof(staticBuffer), MEM_CLASS_INTERNAL);
+
+    MemPlacementEntry entries[MEM_PLACEMENT_MAX_ENTRIES];
+    TEST_ASSERT_EQUAL_UINT8(1, MemPlacement_getEntries(entries, MEM_PLACEMENT_MAX_ENTRIES));
+    TEST_ASSERT_FALSE(entries[0].heap);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(staticBuffer), MemPlacement_getStats().internalBytes);
+}
+
+void test_zero_size_alloc(void) {
+    // A save of an empty mission still gets a valid pointer
+    void* p = MemPlacement_alloc("mission_save", 0, MEM_CLASS_BULK);
+    TEST_ASSERT_NOT_NULL(p);
+    MemPlacement_free(p);
+    MemPlacement_free(NULL);
+    TEST_ASSERT_EQUAL_UINT32(0, MemPlacement_getStats().failures);
+}
+
+void test_full_ledger_still_allocates(void) {
+    void* blocks[MEM_PLACEMENT_MAX_ENTRIES + 2];
+    for (int i = 0; i < MEM_PLACEMENT_MAX_ENTRIES + 2; i++) {
+        blocks[i] = MemPlacement_alloc("block", 16, MEM_CLASS_INTERNAL);
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+    }
+    MemPlacementStats stats = MemPlacement_getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.untracked);
+    TEST_ASSERT_EQUAL_UINT32(16 * MEM_PLACEMENT_MAX_ENTRIES, stats.internalBytes);
+
+    // A freed listed block makes room again
+    MemPlacement_free(blocks[0]);
+    void* again = MemPlacement_alloc("again", 8, MEM_CLASS_DMA);
+    MemPlacementEntry entries[MEM_PLACEMENT_MAX_ENTRIES];
+    TEST_ASSERT_EQUAL_UINT8(MEM_PLACEMENT_MAX_ENTRIES,
+                            MemPlacement_getEntries(entries, MEM_PLACEMENT_MAX_ENTRIES));
+    TEST_ASSERT_EQUAL_STRING("again", entries[0].tag);
+
+    MemPlacement_free(again);
+    for (int i = 1; i < MEM_PLACEMENT_MAX_ENTRIES + 2; i++) MemPlacement_free(blocks[i]);
+    TEST_ASSERT_EQUAL_UINT32(0, MemPlacement_getStats().internalBytes);
+}
+
+void test_host_has_no_psram(void) {
+    TEST_ASSERT_FALSE(MemPlacement_hasPsram());
+    TEST_ASSERT_EQUAL_STRING("internal", MemPlacement_regionName(MEM_REGION_INTERNAL));
+    TEST_ASSERT_EQUAL_STRING("psram", MemPlacement_regionName(MEM_REGION_PSRAM));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Ledger Tests
+    RUN_TEST(test_alloc_is_listed_until_freed);
+    RUN_TEST(test_note_static_once);
+    RUN_TEST(test_zero_size_alloc);
+    RUN_TEST(test_full_ledger_still_allocates);
+    RUN_TEST(test_host_has_no_psram);
+
+    return UNITY_END();
+}
@@ -1,6 +1,7 @@
 #ifdef UNIT_TESTING
 
 #include <unity.h>
+#include <Arduino.h>
 #include "MemoryProfiler.h"
 #include <string.h>
 
@@ -267,6 +268,134 @@ void test_MemoryProfiler_MemoryStatsConsistency(void) {
     TEST_ASSERT_LESS_THAN(5000, diff);  // Less than 5KB difference
 }
 
+/**
+ * Test 19: Registered Slot Is Stable
+ */
+void test_MemoryProfiler_RegisterTaskReturnsSameSlot(void) {
+    uint8_t a = MemoryProfiler_registerTask("nav_update");
+    uint8_t b = MemoryProfiler_registerTask("imu_read");
+    TEST_ASSERT_NOT_EQUAL(PROFILE_INVALID_SLOT, a);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+    TEST_ASSERT_EQUAL_UINT8(a, MemoryProfiler_registerTask("nav_update"));
+
+    // Name-keyed recording lands in the same slot
+    MemoryProfiler_recordTaskTime("nav_update", 700);
+    TEST_ASSERT_EQUAL_INT(1, MemoryProfiler_getTaskTiming(a)->callCount);
+    TEST_ASSERT_EQUAL_INT(2, MemoryProfiler_getTaskCount());
+}
+
+/**
+ * Test 20: Mean and EWMA
+ */
+void test_MemoryProfiler_MeanAndEwma(void) {
+    MemoryProfiler_recordTaskTime("stats_task", 1000);
+    MemoryProfiler_recordTaskTime("stats_task", 3000);
+
+    TaskTimingInfo* task = MemoryProfiler_getTaskTiming(0);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 2000.0f, task->meanExecutionTimeUs);
+    // First sample seeds the EWMA, the second moves it by alpha
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1000.0f + PROFILE_EWMA_ALPHA * 2000.0f,
+                             task->ewmaExecutionTimeUs);
+}
+
+/**
+ * Test 21: Scope Timer
+ */
+void test_MemoryProfiler_ProfileScopeRecords(void) {
+    for (int i = 0; i < 3; i++) {
+        PROFILE_SCOPE("scoped");
+        delayMicroseconds(200);
+    }
+
+    TaskTimingInfo* task = MemoryProfiler_getTaskTiming(0);
+    TEST_ASSERT_NOT_NULL(task);
+    TEST_ASSERT_EQUAL_STRING("scoped", task->taskName);
+    TEST_ASSERT_EQUAL_INT(3, task->callCount);
+    TEST_ASSERT_GREATER_OR_EQUAL(200, task->minExecutionTimeUs);
+}
+
+/**
+ * Test 22: Reset Re-Registers Scope Sites
+ */
+void test_MemoryProfiler_ResetInvalidatesSites(void) {
+    static ProfileSite site = {"site_task", PROFILE_INVALID_SLOT, 0};
+    MemoryProfiler_registerTask("other_task");
+    uint8_t before = MemoryProfiler_resolveSite(&site);
+    TEST_ASSERT_EQUAL_UINT8(1, before);
+
+    MemoryProfiler_reset();
+    TEST_ASSERT_EQUAL_UINT8(0, MemoryProfiler_resolveSite(&site));
+    TEST_ASSERT_EQUAL_STRING("site_task", MemoryProfiler_getTaskTiming(0)->taskName);
+}
+
+/**
+ * Test 23: Allocation Sites Ranked By Count
+ */
+void test_MemoryProfiler_AllocSitesRanked(void) {
+    MemoryProfiler_recordAlloc(0x400d1000, 64, true);
+    MemoryProfiler_recordAlloc(0x400d2000, 32, true);
+    MemoryProfiler_recordAlloc(0x400d2000, 32, true);
+    MemoryProfiler_recordAlloc(0x400d3000, 16, false);
+    MemoryProfiler_recordFree();
+
+    AllocStats stats = MemoryProfiler_getAllocStats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.allocCount);
+    TEST_ASSERT_EQUAL_UINT32(128, stats.allocBytes);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.failedCount);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.freeCount);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.siteCount);
+
+    AllocSite top[ALLOC_TOP_SITES];
+    TEST_ASSERT_EQUAL_UINT8(2, MemoryProfiler_getTopAllocSites(top, ALLOC_TOP_SITES));
+    TEST_ASSERT_EQUAL_HEX32(0x400d2000, top[0].caller);
+    TEST_ASSERT_EQUAL_UINT32(2, top[0].count);
+    TEST_ASSERT_EQUAL_UINT32(64, top[1].bytes);
+    TEST_ASSERT_EQUAL_UINT8(1, MemoryProfiler_getTopAllocSites(top, 1));
+}
+
+/**
+ * Test 24: Allocations Counted Per Loop Iteration
+ */
+void test_MemoryProfiler_LoopAllocCount(void) {
+    MemoryProfiler_recordLoop(1000);        // Binds the loop to this task
+    MemoryProfiler_recordAlloc(0x400d1000, 8, true);
+    MemoryProfiler_recordAlloc(0x400d1000, 8, true);
+    MemoryProfiler_recordLoop(1000);
+    MemoryProfiler_recordLoop(1000);        // Steady state: none
+
+    AllocStats stats = MemoryProfiler_getAllocStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lastLoopAllocs);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.maxLoopAllocs);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.loopsWithAllocs);
+
+    MemoryProfiler_reset();
+    TEST_ASSERT_EQUAL_UINT32(0, MemoryProfiler_getAllocStats().maxLoopAllocs);
+}
+
+/**
+ * Test 25: Task Scan Lists The Calling Task
+ */
+void test_MemoryProfiler_ScanTasksFindsSelf(void) {
+    const char* self = pcTaskGetName(NULL);
+    MemoryProfiler_setTaskStackSize(self, 8192);
+    TEST_ASSERT_GREATER_THAN(0, MemoryProfiler_scanTasks());
+
+    const TaskStackInfo* found = NULL;
+    for (uint8_t i = 0; i < MemoryProfiler_getSystemTaskCount(); i++) {
+        if (strcmp(MemoryProfiler_getSystemTask(i)->name, self) == 0)
+            found = MemoryProfiler_getSystemTask(i);
+    }
+    TEST_ASSERT_NOT_NULL(found);
+    TEST_ASSERT_EQUAL_UINT32(8192, found->stackSize);
+    TEST_ASSERT_GREATER_THAN(0, found->stackHighWater);
+    TEST_ASSERT_LESS_THAN(8192, found->stackHighWater);
+
+    // Stack totals cover registered tasks only
+    MemoryStats stats = MemoryProfiler_getMemoryStats();
+    TEST_ASSERT_GREATER_OR_EQUAL(8192 - found->stackHighWater, stats.stackUsed);
+    TEST_ASSERT_NULL(MemoryProfiler_getSystemTask(MemoryProfiler_getSystemTaskCount()));
+}
+
 // ============================================================================
 // Test Runner
 // ============================================================================
@@ -292,6 +421,13 @@ int runMemoryProfilerTests(void) {
     RUN_TEST(test_MemoryProfiler_MaxTasksLimit);
     RUN_TEST(test_MemoryProfiler_TaskTimingInfoAccuracy);
     RUN_TEST(test_MemoryProfiler_MemoryStatsConsistency);
+    RUN_TEST(test_MemoryProfiler_RegisterTaskReturnsSameSlot);
+    RUN_TEST(test_MemoryProfiler_MeanAndEwma);
+    RUN_TEST(test_MemoryProfiler_ProfileScopeRecords);
+    RUN_TEST(test_MemoryProfiler_ResetInvalidatesSites);
+    RUN_TEST(test_MemoryProfiler_AllocSitesRanked);
+    RUN_TEST(test_MemoryProfiler_LoopAllocCount);
+    RUN_TEST(test_MemoryProfiler_ScanTasksFindsSelf);
     
     return UNITY_END();
 }
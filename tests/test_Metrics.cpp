@@ -0,0 +1,144 @@
+/**
+ * Unit Tests for Metrics
+ * Tests the Prometheus exposition format and that a render split across
+ * arbitrarily small buffers produces the same bytes as a single pass
+ *
+ * @file test_Metrics.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "Metrics.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static MetricsSnapshot snap;
+static char text[8192];
+
+static void fill_snapshot(void) {
+    memset(&snap, 0, sizeof(snap));
+    snap.uptimeS = 123;
+    snap.heapFree = 150000;
+    snap.coreLoad[0] = 0.25f;
+    snap.coreLoad[1] = NAN;
+    snap.taskCount = 2;
+    strcpy(snap.taskNames[0], "control");
+    strcpy(snap.taskNames[1], "sensor");
+    snap.taskRuns[0] = 5000;
+    snap.taskOverruns[1] = 3;
+    snap.rxRejected[3] = 7;     // checksum
+    snap.linkRssiDbm = -67;
+    snap.cryptoAesBytes = 5000000000ULL;
+}
+
+static size_t render_all(size_t chunk) {
+    MetricsCursor cursor;
+    Metrics_startRender(&cursor);
+    size_t total = 0;
+    for (;;) {
+        size_t room = sizeof(text) - 1 - total;
+        size_t n = Metrics_render(&snap, &cursor, text + total, room < chunk ? room : chunk);
+        if (n == 0)
+            break;
+        total += n;
+    }
+    text[total] = '\0';
+    return total;
+}
+
+void setUp(void) {
+    fill_snapshot();
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Format Tests
+// ============================================================================
+
+void test_help_type_and_sample(void) {
+    render_all(sizeof(text));
+    TEST_ASSERT_NOT_NULL(strstr(text,
+        "# HELP na_uptime_seconds Time since boot\n"
+        "# TYPE na_uptime_seconds counter\n"
+        "na_uptime_seconds 123\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE na_heap_free_bytes gauge\nna_heap_free_bytes 150000\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\nna_link_rssi_dbm -67\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\nna_log_dropped_total 0\n"));
+    TEST_ASSERT_EQUAL('\n', text[strlen(text) - 1]);
+}
+
+void test_labelled_families(void) {
+    render_all(sizeof(text));
+    TEST_ASSERT_NOT_NULL(strstr(text, "na_cpu_load_ratio{core=\"0\"} 0.2500\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "na_cpu_load_ratio{core=\"1\"} NaN\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "na_task_runs_total{task=\"control\"} 5000\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "na_task_overruns_total{task=\"sensor\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "na_rx_rejected_total{stage=\"checksum\"} 7\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "na_rx_rejected_total{stage=\"rate\"} 0\n"));
+}
+
+void test_task_family_follows_task_count(void) {
+    render_all(sizeof(text));
+    TEST_ASSERT_NULL(strstr(text, "na_task_runs_total{task=\"\"}"));
+
+    snap.taskCount = 0;
+    render_all(sizeof(text));
+    TEST_ASSERT_NULL(strstr(text, "na_task_runs_total{"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE na_task_runs_total counter\n"));
+}
+
+void test_u64_counter(void) {
+    render_all(sizeof(text));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\nna_crypto_aes_bytes_total 5000000000\n"));
+}
+
+// ============================================================================
+// Chunking Tests
+// ============================================================================
+
+void test_chunked_render_matches_single_pass(void) {
+    size_t whole = render_all(sizeof(text));
+    static char reference[sizeof(text)];
+    memcpy(reference, text, whole + 1);
+
+    const size_t chunks[] = {1, 7, 64, 159, 160, 161, 1436};
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        TEST_ASSERT_EQUAL(whole, render_all(chunks[i]));
+        TEST_ASSERT_EQUAL_STRING(reference, text);
+    }
+}
+
+void test_finished_render_returns_zero(void) {
+    MetricsCursor cursor;
+    Metrics_startRender(&cursor);
+    while (Metrics_render(&snap, &cursor, text, 512) > 0) {
+    }
+    TEST_ASSERT_EQUAL(0, Metrics_render(&snap, &cursor, text, 512));
+    TEST_ASSERT_EQUAL(0, Metrics_render(&snap, &cursor, text, 0));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Format Tests
+    RUN_TEST(test_help_type_and_sample);
+    RUN_TEST(test_labelled_families);
+    RUN_TEST(test_task_family_follows_task_count);
+    RUN_TEST(test_u64_counter);
+
+    // Chunking Tests
+    RUN_TEST(test_chunked_render_matches_single_pass);
+    RUN_TEST(test_finished_render_returns_zero);
+
+    return UNITY_END();
+}
@@ -0,0 +1,173 @@
+/**
+ * Unit Tests for MissionLibrary
+ * Tests the boot index (torn saves, duplicate names), save / read round
+ * trips on the host flash image, replacing and removing missions
+ *
+ * @file test_MissionLibrary.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "MissionLibrary.h"
+#include "Crc16.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MISSION_RECORDS 256             // Largest mission (MAX_WAYPOINTS)
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static WaypointRecord records[MISSION_RECORDS];
+
+static void fillRecords(uint16_t count, int32_t seed) {
+    for (uint16_t i = 0; i < count; i++) {
+        records[i].lat = seed + i;
+        records[i].lng = -seed - i;
+        records[i].alt = (int16_t)i;
+        records[i].param = 1500;
+        records[i].cmd = MISSION_CMD_WAYPOINT;
+        records[i].arg = 0;
+    }
+}
+
+void setUp(void) {
+    // Start every test from an empty library
+    MissionLibrary_begin();
+    const MissionLibraryIndex* index = MissionLibrary_getIndex();
+    for (uint8_t i = 0; i < index->slotCount; i++) {
+        if (index->slots[i].used) MissionLibrary_remove(i);
+    }
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Index Tests
+// ============================================================================
+
+void test_name_rules(void) {
+    TEST_ASSERT_TRUE(MissionLibrary_nameValid("harbour"));
+    TEST_ASSERT_TRUE(MissionLibrary_nameValid("123456789012345"));
+    TEST_ASSERT_FALSE(MissionLibrary_nameValid("1234567890123456"));
+    TEST_ASSERT_FALSE(MissionLibrary_nameValid(""));
+    TEST_ASSERT_FALSE(MissionLibrary_nameValid("tab\there"));
+    TEST_ASSERT_FALSE(MissionLibrary_nameValid(NULL));
+}
+
+void test_torn_header_is_free(void) {
+    MissionLibraryIndex index;
+    MissionLibrary_initIndex(&index, 4);
+    MissionLibraryHeader header;
+    MissionLibrary_makeHeader(&header, "survey", 10, 0x1234, 5);
+    header.count = 11;  // Header CRC no longer matches
+    TEST_ASSERT_EQUAL(-1, MissionLibrary_scanSlot(&index, 0, &header));
+    TEST_ASSERT_FALSE(index.slots[0].used);
+
+    memset(&header, 0xFF, sizeof(header));  // Erased sector
+    TEST_ASSERT_EQUAL(-1, MissionLibrary_scanSlot(&index, 1, &header));
+    TEST_ASSERT_EQUAL(0, MissionLibrary_freeSlot(&index));
+}
+
+void test_duplicate_name_newer_wins(void) {
+    MissionLibraryIndex index;
+    MissionLibrary_initIndex(&index, 4);
+    MissionLibraryHeader older, newer;
+    MissionLibrary_makeHeader(&older, "survey", 10, 0x1111, 7);
+    MissionLibrary_makeHeader(&newer, "survey", 12, 0x2222, 8);
+
+    // Newer found after the older copy: the older slot is stale
+    TEST_ASSERT_EQUAL(-1, MissionLibrary_scanSlot(&index, 0, &older));
+    TEST_ASSERT_EQUAL(0, MissionLibrary_scanSlot(&index, 2, &newer));
+    TEST_ASSERT_EQUAL(2, MissionLibrary_find(&index, "survey"));
+    TEST_ASSERT_FALSE(index.slots[0].used);
+
+    // Older found after the newer one: itself is stale
+    MissionLibrary_initIndex(&index, 4);
+    MissionLibrary_scanSlot(&index, 0, &newer);
+    TEST_ASSERT_EQUAL(3, MissionLibrary_scanSlot(&index, 3, &older));
+    TEST_ASSERT_EQUAL(0, MissionLibrary_find(&index, "survey"));
+    TEST_ASSERT_EQUAL_UINT16(12, index.slots[0].count);
+    TEST_ASSERT_EQUAL_UINT32(9, index.nextSequence);
+}
+
+// ============================================================================
+// Flash Tests
+// ============================================================================
+
+void test_save_and_read_round_trip(void) {
+    fillRecords(MISSION_RECORDS, 100);
+    uint8_t slot = 0xFF;
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK,
+                      MissionLibrary_save("harbour", records, MISSION_RECORDS, &slot));
+
+    // Index survives a reboot
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK, MissionLibrary_begin());
+    const MissionLibraryIndex* index = MissionLibrary_getIndex();
+    TEST_ASSERT_EQUAL(slot, MissionLibrary_find(index, "harbour"));
+    TEST_ASSERT_EQUAL_UINT16(MISSION_RECORDS, index->slots[slot].count);
+    TEST_ASSERT_EQUAL_HEX16(Crc16_compute((const uint8_t*)records,
+                                          MISSION_RECORDS * sizeof(WaypointRecord)),
+                            index->slots[slot].crc);
+
+    WaypointRecord chunk[16];
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK, MissionLibrary_read(slot, 240, chunk, 16));
+    TEST_ASSERT_EQUAL_MEMORY(&records[240], chunk, sizeof(chunk));
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_TOO_LARGE, MissionLibrary_read(slot, 250, chunk, 16));
+}
+
+void test_save_replaces_same_name(void) {
+    fillRecords(20, 1);
+    uint8_t first, second;
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK, MissionLibrary_save("survey", records, 20, &first));
+    fillRecords(5, 2);
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK, MissionLibrary_save("survey", records, 5, &second));
+    TEST_ASSERT_NOT_EQUAL(first, second);
+
+    MissionLibrary_begin();
+    const MissionLibraryIndex* index = MissionLibrary_getIndex();
+    TEST_ASSERT_FALSE(index->slots[first].used);
+    TEST_ASSERT_EQUAL(second, MissionLibrary_find(index, "survey"));
+    TEST_ASSERT_EQUAL_UINT16(5, index->slots[second].count);
+}
+
+void test_full_and_remove(void) {
+    fillRecords(3, 9);
+    char name[8];
+    for (uint8_t i = 0; i < MISSION_LIBRARY_MAX_SLOTS; i++) {
+        snprintf(name, sizeof(name), "m%u", i);
+        TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK, MissionLibrary_save(name, records, 3, NULL));
+    }
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_FULL, MissionLibrary_save("extra", records, 3, NULL));
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_BAD_NAME, MissionLibrary_save("", records, 3, NULL));
+
+    int slot = MissionLibrary_find(MissionLibrary_getIndex(), "m4");
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK, MissionLibrary_remove((uint8_t)slot));
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_NOT_FOUND, MissionLibrary_remove((uint8_t)slot));
+    TEST_ASSERT_EQUAL(MISSION_LIBRARY_OK, MissionLibrary_save("extra", records, 3, NULL));
+
+    MissionLibrary_begin();
+    TEST_ASSERT_EQUAL(-1, MissionLibrary_find(MissionLibrary_getIndex(), "m4"));
+    TEST_ASSERT_EQUAL(slot, MissionLibrary_find(MissionLibrary_getIndex(), "extra"));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Index Tests
+    RUN_TEST(test_name_rules);
+    RUN_TEST(test_torn_header_is_free);
+    RUN_TEST(test_duplicate_name_newer_wins);
+
+    // Flash Tests
+    RUN_TEST(test_save_and_read_round_trip);
+    RUN_TEST(test_save_replaces_same_name);
+    RUN_TEST(test_full_and_remove);
+
+    return UNITY_END();
+}
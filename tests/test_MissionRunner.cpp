@@ -0,0 +1,175 @@
+/**
+ * Unit Tests for MissionRunner
+ * Tests instant item execution, jumps / repeats, loiter and RTL steps
+ *
+ * @file test_MissionRunner.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "MissionRunner.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define MAX_ITEMS 16
+
+static uint8_t cmd[MAX_ITEMS];
+static uint16_t param[MAX_ITEMS];
+static uint8_t arg[MAX_ITEMS];
+static int16_t alt[MAX_ITEMS];
+static MissionView view;
+static MissionRunner runner;
+
+static void add(uint8_t c, uint16_t p, uint8_t a, int16_t dm) {
+    cmd[view.count] = c;
+    param[view.count] = p;
+    arg[view.count] = a;
+    alt[view.count] = dm;
+    view.count++;
+}
+
+void setUp(void) {
+    memset(&view, 0, sizeof(view));
+    view.cmd = cmd;
+    view.param = param;
+    view.arg = arg;
+    view.alt = alt;
+    MissionRunner_init(&runner, 1500);
+}
+
+void tearDown(void) {}
+
+/**
+ * Fly the mission: resolve, "reach" each GOTO, record the order
+ */
+static int flyAll(uint16_t* order, int maxSteps) {
+    int n = 0;
+    while (n < maxSteps) {
+        MissionStep step = MissionRunner_resolve(&runner, &view);
+        if (step.type != MISSION_STEP_GOTO) break;
+        order[n++] = step.index;
+        MissionRunner_complete(&runner, step.index);
+    }
+    return n;
+}
+
+// ============================================================================
+// Item Tests
+// ============================================================================
+
+void test_waypoints_in_order_then_done(void) {
+    add(MISSION_CMD_WAYPOINT, 1600, 0, 0);
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+
+    MissionStep step = MissionRunner_resolve(&runner, &view);
+    TEST_ASSERT_EQUAL(MISSION_STEP_GOTO, step.type);
+    TEST_ASSERT_EQUAL_UINT16(0, step.index);
+    TEST_ASSERT_EQUAL_UINT16(1600, step.speed);
+    MissionRunner_complete(&runner, 0);
+
+    // Speed 0 follows the mission speed
+    step = MissionRunner_resolve(&runner, &view);
+    TEST_ASSERT_EQUAL_UINT16(1, step.index);
+    TEST_ASSERT_EQUAL_UINT16(1500, step.speed);
+    MissionRunner_complete(&runner, 1);
+
+    TEST_ASSERT_EQUAL(MISSION_STEP_DONE, MissionRunner_resolve(&runner, &view).type);
+}
+
+void test_set_speed_and_depth_run_instantly(void) {
+    add(MISSION_CMD_SET_SPEED, 1700, 0, 0);
+    add(MISSION_CMD_SET_DEPTH, 0, 0, 25);
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+
+    MissionStep step = MissionRunner_resolve(&runner, &view);
+    TEST_ASSERT_EQUAL(MISSION_STEP_GOTO, step.type);
+    TEST_ASSERT_EQUAL_UINT16(2, step.index);
+    TEST_ASSERT_EQUAL_UINT16(1700, step.speed);
+    TEST_ASSERT_TRUE(step.setDepth);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.5f, step.depth);
+
+    // The depth is reported once, not on every later resolve
+    MissionRunner_complete(&runner, 2);
+    step = MissionRunner_resolve(&runner, &view);
+    TEST_ASSERT_FALSE(step.setDepth);
+}
+
+void test_loiter_reports_hold_time(void) {
+    add(MISSION_CMD_SET_SPEED, 1650, 0, 0);
+    add(MISSION_CMD_LOITER, 30, 0, 0);
+
+    MissionStep step = MissionRunner_resolve(&runner, &view);
+    TEST_ASSERT_EQUAL_UINT16(1, step.index);
+    TEST_ASSERT_EQUAL_UINT16(30, step.loiterS);
+    TEST_ASSERT_EQUAL_UINT16(1650, step.speed);
+}
+
+void test_jump_repeats_then_falls_through(void) {
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+    add(MISSION_CMD_JUMP, 0, 3, 0);         // Fly 0,1 three more times
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+
+    uint16_t order[16];
+    int n = flyAll(order, 16);
+    const uint16_t expected[] = {0, 1, 0, 1, 0, 1, 0, 1, 3};
+    TEST_ASSERT_EQUAL_INT(9, n);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, order, 9);
+}
+
+void test_jump_forever_and_runaway_loop(void) {
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+    add(MISSION_CMD_JUMP, 0, 0, 0);
+
+    uint16_t order[10];
+    TEST_ASSERT_EQUAL_INT(10, flyAll(order, 10));
+
+    // A loop with nothing to fly ends the mission instead of spinning
+    setUp();
+    add(MISSION_CMD_SET_SPEED, 1600, 0, 0);
+    add(MISSION_CMD_JUMP, 0, 0, 0);
+    TEST_ASSERT_EQUAL(MISSION_STEP_DONE, MissionRunner_resolve(&runner, &view).type);
+}
+
+void test_bad_jump_target_skipped(void) {
+    add(MISSION_CMD_JUMP, 9, 1, 0);
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+
+    TEST_ASSERT_EQUAL_UINT16(1, MissionRunner_resolve(&runner, &view).index);
+}
+
+void test_rtl_item(void) {
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+    add(MISSION_CMD_RTL, 0, 0, 0);
+    add(MISSION_CMD_WAYPOINT, 0, 0, 0);
+
+    MissionRunner_resolve(&runner, &view);
+    MissionRunner_complete(&runner, 0);
+    TEST_ASSERT_EQUAL(MISSION_STEP_RTL, MissionRunner_resolve(&runner, &view).type);
+}
+
+void test_record_is_14_bytes(void) {
+    TEST_ASSERT_EQUAL_UINT32(14, sizeof(WaypointRecord));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_waypoints_in_order_then_done);
+    RUN_TEST(test_set_speed_and_depth_run_instantly);
+    RUN_TEST(test_loiter_reports_hold_time);
+    RUN_TEST(test_jump_repeats_then_falls_through);
+    RUN_TEST(test_jump_forever_and_runaway_loop);
+    RUN_TEST(test_bad_jump_target_skipped);
+    RUN_TEST(test_rtl_item);
+    RUN_TEST(test_record_is_14_bytes);
+
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+/**
+ * Unit Tests for MissionUpload
+ * Tests staged chunked upload, ordering, bounds and the mission CRC
+ *
+ * @file test_MissionUpload.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "MissionUpload.h"
+#include "NAPacket.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define MISSION_SIZE 20
+
+static MissionUpload up;
+static WaypointRecord shadow[MISSION_SIZE];
+static WaypointRecord mission[MISSION_SIZE];
+static uint16_t missionCrc;
+
+void setUp(void) {
+    memset(&up, 0, sizeof(up));
+    memset(shadow, 0, sizeof(shadow));
+    for (int i = 0; i < MISSION_SIZE; i++) {
+        mission[i].lat = 137563000 + i * 100;
+        mission[i].lng = 1005018000 - i * 100;
+        mission[i].alt = (int16_t)(i * 10);
+        mission[i].param = 1500 + i;
+        mission[i].cmd = MISSION_CMD_WAYPOINT;
+    }
+    missionCrc = NA_CRC16((const uint8_t*)mission, sizeof(mission));
+}
+
+void tearDown(void) {}
+
+static void sendAll(uint16_t chunk) {
+    for (uint16_t i = 0; i < MISSION_SIZE; i += chunk) {
+        uint16_t n = MISSION_SIZE - i < chunk ? MISSION_SIZE - i : chunk;
+        TEST_ASSERT_EQUAL(MISSION_UPLOAD_OK, MissionUpload_add(&up, i, &mission[i], n));
+    }
+}
+
+// ============================================================================
+// Upload Tests
+// ============================================================================
+
+void test_chunked_upload_commits(void) {
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OK,
+                      MissionUpload_begin(&up, shadow, MISSION_SIZE, MISSION_SIZE, missionCrc));
+    sendAll(7);
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OK, MissionUpload_finish(&up));
+    TEST_ASSERT_EQUAL_MEMORY(mission, shadow, sizeof(mission));
+    TEST_ASSERT_FALSE(up.active);
+}
+
+void test_out_of_order_chunk_refused(void) {
+    MissionUpload_begin(&up, shadow, MISSION_SIZE, MISSION_SIZE, missionCrc);
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OK, MissionUpload_add(&up, 0, mission, 7));
+    // Lost chunk 7..13: host is told to resume at 7
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OUT_OF_ORDER, MissionUpload_add(&up, 14, &mission[14], 6));
+    TEST_ASSERT_EQUAL_UINT16(7, up.received);
+    // Duplicate of an accepted chunk is refused too
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OUT_OF_ORDER, MissionUpload_add(&up, 0, mission, 7));
+}
+
+void test_finish_requires_every_record(void) {
+    MissionUpload_begin(&up, shadow, MISSION_SIZE, MISSION_SIZE, missionCrc);
+    MissionUpload_add(&up, 0, mission, 7);
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_INCOMPLETE, MissionUpload_finish(&up));
+    TEST_ASSERT_TRUE(up.active);
+}
+
+void test_bad_crc_restarts_upload(void) {
+    MissionUpload_begin(&up, shadow, MISSION_SIZE, MISSION_SIZE, missionCrc ^ 1);
+    sendAll(7);
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_BAD_CRC, MissionUpload_finish(&up));
+    TEST_ASSERT_EQUAL_UINT16(0, up.received);
+}
+
+void test_bounds(void) {
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_TOO_LARGE,
+                      MissionUpload_begin(&up, shadow, MISSION_SIZE, MISSION_SIZE + 1, 0));
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_IDLE, MissionUpload_add(&up, 0, mission, 1));
+
+    MissionUpload_begin(&up, shadow, MISSION_SIZE, 5, 0);
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OVERFLOW, MissionUpload_add(&up, 0, mission, 7));
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_NO_MEMORY, MissionUpload_begin(&up, NULL, 5, 5, 0));
+}
+
+void test_empty_mission(void) {
+    uint16_t emptyCrc = NA_CRC16((const uint8_t*)mission, 0);
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OK, MissionUpload_begin(&up, NULL, 0, 0, emptyCrc));
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_OK, MissionUpload_finish(&up));
+}
+
+void test_abort(void) {
+    MissionUpload_begin(&up, shadow, MISSION_SIZE, MISSION_SIZE, missionCrc);
+    MissionUpload_add(&up, 0, mission, 7);
+    MissionUpload_abort(&up);
+    TEST_ASSERT_EQUAL(MISSION_UPLOAD_IDLE, MissionUpload_finish(&up));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_chunked_upload_commits);
+    RUN_TEST(test_out_of_order_chunk_refused);
+    RUN_TEST(test_finish_requires_every_record);
+    RUN_TEST(test_bad_crc_restarts_upload);
+    RUN_TEST(test_bounds);
+    RUN_TEST(test_empty_mission);
+    RUN_TEST(test_abort);
+
+    return UNITY_END();
+}
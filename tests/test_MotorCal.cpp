@@ -0,0 +1,153 @@
+/**
+ * Unit Tests for MotorCal
+ * Tests the breakaway staircase on encoder and on current feedback, the
+ * give-up limit and the per-motor trim table
+ *
+ * @file test_MotorCal.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "MotorCal.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static MotorCal cal;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// Simulated brushed motor: stalled below breakawayDuty (current rises
+// with duty), turning above it (back-EMF halves the current)
+static float simAmps(uint8_t duty, uint8_t breakawayDuty) {
+    float idle = 0.20f;
+    float stall = duty * 0.01f;
+    return idle + (duty >= breakawayDuty ? stall * 0.5f : stall);
+}
+
+/**
+ * Run the calibration at 50 Hz, a current sample every 100 ms
+ * @return ms until it finished
+ */
+static uint32_t runSim(uint8_t breakawayDuty, bool encoder) {
+    uint32_t now = 1000;
+    int32_t counts = 0;
+    MotorCal_start(&cal, encoder ? MOTOR_CAL_FEEDBACK_ENCODER : MOTOR_CAL_FEEDBACK_CURRENT,
+                   now, counts);
+    uint8_t duty = cal.duty;
+    while (MotorCal_isRunning(&cal) && now < 1000 + 120000) {
+        now += 20;
+        if (duty >= breakawayDuty) counts += 2;     // 100 edges/s once turning
+        float amps = now % 100 == 0 ? simAmps(duty, breakawayDuty) : NAN;
+        duty = MotorCal_update(&cal, now, counts, amps);
+    }
+    return now - 1000;
+}
+
+// ============================================================================
+// Calibration Tests
+// ============================================================================
+
+void test_encoder_finds_breakaway(void) {
+    runSim(40, true);
+    TEST_ASSERT_EQUAL(MOTOR_CAL_DONE, cal.state);
+    TEST_ASSERT_EQUAL(40, cal.breakaway);
+    TEST_ASSERT_EQUAL(40 + MOTOR_CAL_MARGIN, MotorCal_minPwm(&cal));
+    TEST_ASSERT_EQUAL(0, cal.duty);
+}
+
+void test_current_finds_breakaway(void) {
+    runSim(60, false);
+    TEST_ASSERT_EQUAL(MOTOR_CAL_DONE, cal.state);
+    TEST_ASSERT_EQUAL(60, cal.breakaway);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.20f, cal.baselineAmps);
+}
+
+void test_current_ignores_sample_noise_below_floor(void) {
+    // Motor not wired: only the idle current, no peak to fall from
+    uint32_t now = 0;
+    MotorCal_start(&cal, MOTOR_CAL_FEEDBACK_CURRENT, now, 0);
+    while (MotorCal_isRunning(&cal) && now < 120000) {
+        now += 20;
+        float amps = now % 100 == 0 ? (now % 200 == 0 ? 0.21f : 0.19f) : NAN;
+        MotorCal_update(&cal, now, 0, amps);
+    }
+    TEST_ASSERT_EQUAL(MOTOR_CAL_FAILED, cal.state);
+}
+
+void test_gives_up_at_max_duty(void) {
+    uint32_t ms = runSim(250, true);
+    TEST_ASSERT_EQUAL(MOTOR_CAL_FAILED, cal.state);
+    uint32_t steps = (MOTOR_CAL_MAX_DUTY - MOTOR_CAL_START_DUTY) / MOTOR_CAL_STEP_DUTY + 1;
+    TEST_ASSERT_UINT_WITHIN(40, steps * MOTOR_CAL_STEP_MS, ms);
+}
+
+void test_holds_step_until_sample(void) {
+    MotorCal_start(&cal, MOTOR_CAL_FEEDBACK_CURRENT, 0, 0);
+    // No current sample at all: the baseline step is held, not judged
+    TEST_ASSERT_EQUAL(0, MotorCal_update(&cal, 1000, 0, NAN));
+    TEST_ASSERT_EQUAL(MOTOR_CAL_BASELINE, cal.state);
+    // A sample before the settle time does not count
+    MotorCal_start(&cal, MOTOR_CAL_FEEDBACK_CURRENT, 0, 0);
+    MotorCal_update(&cal, MOTOR_CAL_SETTLE_MS - 1, 0, 5.0f);
+    TEST_ASSERT_EQUAL(0, cal.ampSamples);
+}
+
+void test_abort_stops(void) {
+    MotorCal_start(&cal, MOTOR_CAL_FEEDBACK_ENCODER, 0, 0);
+    TEST_ASSERT_EQUAL(MOTOR_CAL_START_DUTY, MotorCal_update(&cal, 20, 0, NAN));
+    MotorCal_abort(&cal);
+    TEST_ASSERT_FALSE(MotorCal_isRunning(&cal));
+    TEST_ASSERT_EQUAL(0, MotorCal_update(&cal, 40, 0, NAN));
+}
+
+// ============================================================================
+// Trim Tests
+// ============================================================================
+
+void test_trim_defaults_inherit(void) {
+    MotorTrimTable table;
+    MotorTrim_defaults(&table);
+    for (int i = 0; i < MOTOR_TRIM_MAX; i++) {
+        TEST_ASSERT_EQUAL(40, MotorTrim_resolve(table.motors[i].minPWM, 40));
+        TEST_ASSERT_EQUAL(10, MotorTrim_resolve(table.motors[i].deadband, 10));
+    }
+    TEST_ASSERT_EQUAL(55, MotorTrim_resolve(55, 40));
+}
+
+void test_trim_sanitize(void) {
+    MotorTrimTable table;
+    MotorTrim_defaults(&table);
+    table.motors[0].deadband = 90;
+    table.motors[1].deadband = 5;
+    MotorTrim_sanitize(&table);
+    TEST_ASSERT_EQUAL(MOTOR_TRIM_MAX_DEADBAND, table.motors[0].deadband);
+    TEST_ASSERT_EQUAL(5, table.motors[1].deadband);
+    TEST_ASSERT_EQUAL(MOTOR_TRIM_INHERIT, table.motors[2].deadband);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Calibration Tests
+    RUN_TEST(test_encoder_finds_breakaway);
+    RUN_TEST(test_current_finds_breakaway);
+    RUN_TEST(test_current_ignores_sample_noise_below_floor);
+    RUN_TEST(test_gives_up_at_max_duty);
+    RUN_TEST(test_holds_step_until_sample);
+    RUN_TEST(test_abort_stops);
+
+    // Trim Tests
+    RUN_TEST(test_trim_defaults_inherit);
+    RUN_TEST(test_trim_sanitize);
+
+    return UNITY_END();
+}
@@ -0,0 +1,147 @@
+/**
+ * Unit Tests for MotorMixer
+ * Tests frame tables, yaw-preserving desaturation and integer outputs
+ *
+ * @file test_MotorMixer.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "MotorMixer.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static void axes(float* in, float roll, float pitch, float yaw, float thrust,
+                 float forward = 0.0f, float lateral = 0.0f) {
+    in[MIXER_ROLL] = roll;
+    in[MIXER_PITCH] = pitch;
+    in[MIXER_YAW] = yaw;
+    in[MIXER_THRUST] = thrust;
+    in[MIXER_FORWARD] = forward;
+    in[MIXER_LATERAL] = lateral;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Frame Table Tests
+// ============================================================================
+
+void test_quad_x_matches_linear_mix(void) {
+    MotorMixer<MixerFrameQuadX> mixer;
+    float in[MIXER_AXIS_COUNT], out[4];
+    axes(in, 0.1f, 0.2f, 0.05f, 0.3f);
+    mixer.mix(in, out);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f - 0.1f + 0.2f - 0.05f, out[0]);   // FR
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f + 0.1f + 0.2f + 0.05f, out[1]);   // FL
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f + 0.1f - 0.2f - 0.05f, out[2]);   // BL
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f - 0.1f - 0.2f + 0.05f, out[3]);   // BR
+    TEST_ASSERT_FALSE(mixer.isSaturated());
+}
+
+void test_hex_yaw_keeps_total_thrust(void) {
+    MotorMixer<MixerFrameHexX> mixer;
+    float in[MIXER_AXIS_COUNT], out[6];
+    axes(in, 0.0f, 0.0f, 0.5f, 0.5f);
+    mixer.mix(in, out);
+
+    // Pure yaw: total thrust unchanged
+    float sum = 0.0f;
+    for (int i = 0; i < 6; i++) sum += out[i];
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.0f, sum);
+}
+
+void test_vectored_sub_lateral(void) {
+    MotorMixer<MixerFrameSubVectored> mixer;
+    float in[MIXER_AXIS_COUNT], out[6];
+    axes(in, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f);
+    mixer.mix(in, out);
+
+    // Strafe: diagonal pairs oppose, verticals idle, no net forward thrust
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, out[0] + out[1] + out[2] + out[3]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, out[4]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, out[5]);
+}
+
+// ============================================================================
+// Desaturation Tests
+// ============================================================================
+
+void test_quad_keeps_yaw_at_full_throttle(void) {
+    MotorMixer<MixerFrameQuadX> mixer;
+    float in[MIXER_AXIS_COUNT], out[4];
+    axes(in, 0.0f, 0.0f, 0.4f, 1.0f);
+    mixer.mix(in, out);
+
+    // Thrust gives way, the yaw differential survives intact
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, out[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.8f, out[1] - out[0]);
+    TEST_ASSERT_TRUE(mixer.isSaturated());
+}
+
+void test_quad_scales_wide_attitude_command(void) {
+    MotorMixer<MixerFrameQuadX> mixer(0.0f, 1.0f);
+    float in[MIXER_AXIS_COUNT], out[4];
+    axes(in, 1.0f, 0.0f, 1.0f, 0.5f);
+    mixer.mix(in, out);
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(out[i] >= -1e-5f && out[i] <= 1.0f + 1e-5f);
+    }
+    // Roll + yaw spread of 4 scaled into the 0..1 range as a whole
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, out[1] - out[0]);
+}
+
+void test_rover_keeps_steering(void) {
+    MotorMixer<MixerFrameRover> mixer;
+    float in[MIXER_AXIS_COUNT], out[2];
+    axes(in, 0.0f, 0.0f, 0.5f, 0.0f, 1.0f);
+    mixer.mix(in, out);
+
+    // Clamping each side would give 1.0 / 0.5 and lose half the turn
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, out[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, out[1]);
+}
+
+// ============================================================================
+// Output Type Tests
+// ============================================================================
+
+void test_int_output_in_motor_units(void) {
+    MotorMixer<MixerFrameRover, int16_t> mixer;
+    float in[MIXER_AXIS_COUNT];
+    int16_t out[2];
+    axes(in, 0.0f, 0.0f, -0.25f, 0.0f, 0.5f);
+    mixer.mix(in, out);
+
+    TEST_ASSERT_EQUAL_INT16(25, out[0]);
+    TEST_ASSERT_EQUAL_INT16(75, out[1]);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Frame Table Tests
+    RUN_TEST(test_quad_x_matches_linear_mix);
+    RUN_TEST(test_hex_yaw_keeps_total_thrust);
+    RUN_TEST(test_vectored_sub_lateral);
+
+    // Desaturation Tests
+    RUN_TEST(test_quad_keeps_yaw_at_full_throttle);
+    RUN_TEST(test_quad_scales_wide_attitude_command);
+    RUN_TEST(test_rover_keeps_steering);
+
+    // Output Type Tests
+    RUN_TEST(test_int_output_in_motor_units);
+
+    return UNITY_END();
+}
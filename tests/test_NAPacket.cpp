@@ -1,6 +1,7 @@
 /**
  * Unit Tests for NAPacket
- * Tests CRC-16, packet validation, and serialization
+ * Tests CRC-16 (NA_CRC16 and the Crc16 fast path), packet validation,
+ * and serialization
  *
  * @file test_NAPacket.cpp
  * @framework Unity Test Framework (PlatformIO)
@@ -9,6 +10,7 @@
 #include <NAPacket.h>
 #include <string.h>
 #include <unity.h>
+#include "Crc16.h"
 
 // ============================================================================
 // Test Fixtures
@@ -81,6 +83,52 @@ void test_CRC16_packet(void) {
   TEST_ASSERT_EQUAL_UINT16(crc, crc2);
 }
 
+void test_CRC16_check_value(void) {
+  // CRC-16/CCITT-FALSE check value
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  TEST_ASSERT_EQUAL_HEX16(0x29B1, NA_CRC16(check, sizeof(check)));
+  TEST_ASSERT_EQUAL_HEX16(0x29B1, Crc16_compute(check, sizeof(check)));
+}
+
+void test_CRC16_fast_path_matches(void) {
+  // Every length 0..300 at every alignment 0..3 (slicing tail and head)
+  static uint8_t data[304];
+  uint32_t x = 0x12345678;
+  for (size_t i = 0; i < sizeof(data); i++) {
+    x = x * 1103515245u + 12345u;
+    data[i] = (uint8_t)(x >> 16);
+  }
+  for (size_t align = 0; align < 4; align++) {
+    for (size_t len = 0; len + align <= 300; len++) {
+      TEST_ASSERT_EQUAL_HEX16(NA_CRC16(data + align, len),
+                              Crc16_compute(data + align, len));
+    }
+  }
+}
+
+void test_CRC16_fast_path_continues(void) {
+  // Split anywhere: update(update(a), b) == crc(a + b)
+  uint8_t data[64];
+  for (size_t i = 0; i < sizeof(data); i++)
+    data[i] = (uint8_t)(i * 37 + 11);
+  uint16_t whole = NA_CRC16(data, sizeof(data));
+  for (size_t split = 0; split <= sizeof(data); split++) {
+    uint16_t crc = Crc16_update(CRC16_INIT, data, split);
+    TEST_ASSERT_EQUAL_HEX16(whole, Crc16_update(crc, data + split, sizeof(data) - split));
+  }
+}
+
+void test_CRC16_fast_path_packet(void) {
+  NA_UPDATE_PACKET_CHECKSUM(&testPacket);
+  const uint8_t *raw = (const uint8_t *)&testPacket;
+  TEST_ASSERT_EQUAL_HEX16(NA_CRC16(raw, sizeof(NAPacket)),
+                          Crc16_compute(raw, sizeof(NAPacket)));
+  NA_UPDATE_TELEMETRY_CHECKSUM(&testTelemetry);
+  raw = (const uint8_t *)&testTelemetry;
+  TEST_ASSERT_EQUAL_HEX16(NA_CRC16(raw, sizeof(NATelemetry)),
+                          Crc16_compute(raw, sizeof(NATelemetry)));
+}
+
 // ============================================================================
 // Packet Validation Tests
 // ============================================================================
@@ -200,6 +248,10 @@ int main(int argc, char **argv) {
   RUN_TEST(test_CRC16_different_data);
   RUN_TEST(test_CRC16_empty_data);
   RUN_TEST(test_CRC16_packet);
+  RUN_TEST(test_CRC16_check_value);
+  RUN_TEST(test_CRC16_fast_path_matches);
+  RUN_TEST(test_CRC16_fast_path_continues);
+  RUN_TEST(test_CRC16_fast_path_packet);
 
   // Packet Validation Tests
   RUN_TEST(test_packet_checksum_update);
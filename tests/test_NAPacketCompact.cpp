@@ -0,0 +1,154 @@
+/**
+ * Unit Tests for NAPacketCompact
+ * Tests the 12-bit stick packing, clamping, sequence expansion around
+ * the replay window's highest sequence and the unpacked layout handed
+ * to the control task
+ *
+ * @file test_NAPacketCompact.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "NAPacketCompact.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static NAPacket in;
+static NAPacket out;
+static uint8_t payload[NA_COMPACT_PAYLOAD_SIZE];
+
+static void roundTrip(void) {
+    NA_Compact_packSticks(&in, payload);
+    memset(&out, 0, sizeof(out));
+    NA_Compact_unpackSticks(payload, &out);
+}
+
+void setUp(void) {
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Packing Tests
+// ============================================================================
+
+void test_frame_size(void) {
+    TEST_ASSERT_EQUAL(19, sizeof(NAPacketCompact));
+}
+
+void test_sticks_round_trip(void) {
+    in.throttle = 1000;
+    in.roll = -1000;
+    in.pitch = 0;
+    in.yaw = -1;
+    in.mode = 0x85;
+    in.buttons = 0x3C;
+    roundTrip();
+    TEST_ASSERT_EQUAL_UINT16(1000, out.throttle);
+    TEST_ASSERT_EQUAL_INT16(-1000, out.roll);
+    TEST_ASSERT_EQUAL_INT16(0, out.pitch);
+    TEST_ASSERT_EQUAL_INT16(-1, out.yaw);
+    TEST_ASSERT_EQUAL_HEX8(0x85, out.mode);
+    TEST_ASSERT_EQUAL_HEX8(0x3C, out.buttons);
+}
+
+void test_centered_throttle_keeps_sign(void) {
+    in.throttle = (uint16_t)-750;  // Rover / Sub reverse
+    roundTrip();
+    TEST_ASSERT_EQUAL_INT16(-750, (int16_t)out.throttle);
+}
+
+void test_axes_clamped(void) {
+    in.throttle = 3000;
+    in.roll = -3000;
+    in.pitch = NA_COMPACT_AXIS_MAX;
+    in.yaw = NA_COMPACT_AXIS_MIN;
+    roundTrip();
+    TEST_ASSERT_EQUAL_UINT16(NA_COMPACT_AXIS_MAX, out.throttle);
+    TEST_ASSERT_EQUAL_INT16(NA_COMPACT_AXIS_MIN, out.roll);
+    TEST_ASSERT_EQUAL_INT16(NA_COMPACT_AXIS_MAX, out.pitch);
+    TEST_ASSERT_EQUAL_INT16(NA_COMPACT_AXIS_MIN, out.yaw);
+}
+
+// ============================================================================
+// Sequence Tests
+// ============================================================================
+
+void test_expand_forward_and_back(void) {
+    TEST_ASSERT_EQUAL_HEX32(0x12345679, NA_Compact_expandSequence(0x12345678, 0x5679));
+    TEST_ASSERT_EQUAL_HEX32(0x12345600, NA_Compact_expandSequence(0x12345678, 0x5600));
+}
+
+void test_expand_across_low_wrap(void) {
+    // Ahead past 0xFFFF, and a late frame from before it
+    TEST_ASSERT_EQUAL_HEX32(0x00020005, NA_Compact_expandSequence(0x0001FFF0, 0x0005));
+    TEST_ASSERT_EQUAL_HEX32(0x0001FFF0, NA_Compact_expandSequence(0x00020005, 0xFFF0));
+}
+
+void test_expand_across_full_wrap(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFE, NA_Compact_expandSequence(5, 0xFFFE));
+    TEST_ASSERT_EQUAL_HEX32(0x00000002, NA_Compact_expandSequence(0xFFFFFFF0, 0x0002));
+}
+
+// ============================================================================
+// Frame Tests
+// ============================================================================
+
+void test_to_packet_layout(void) {
+    NAPacketCompact frame;
+    frame.type = NA_COMPACT_TYPE;
+    frame.sequence = 0xBEEF;
+    memset(frame.payload, 0x11, sizeof(frame.payload));
+    memset(frame.tag, 0x22, sizeof(frame.tag));
+    NA_Compact_toPacket(&frame, &out);
+    TEST_ASSERT_EQUAL(PROTOCOL_VERSION, out.protocolVersion);
+    TEST_ASSERT_EQUAL(NA_ENCRYPTION_COMPACT, out.encryptionFlag);
+    TEST_ASSERT_EQUAL_HEX32(0xBEEF, out.sequenceNumber);
+    TEST_ASSERT_EQUAL_MEMORY(frame.payload, out.iv, NA_COMPACT_PAYLOAD_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(frame.tag, out.hmac, NA_COMPACT_TAG_SIZE);
+    TEST_ASSERT_EQUAL(0, out.throttle);     // Sticks only after verification
+}
+
+void test_nonce_and_aad_bind_sequence(void) {
+    uint8_t a[AES_GCM_NONCE_SIZE], b[AES_GCM_NONCE_SIZE];
+    NA_Compact_buildNonce(0x00010005, a);
+    NA_Compact_buildNonce(0x00020005, b);
+    TEST_ASSERT_EQUAL_MEMORY("NACF", a, 4);
+    TEST_ASSERT_NOT_EQUAL(0, memcmp(a, b, sizeof(a)));
+
+    uint8_t aad[NA_COMPACT_AAD_SIZE];
+    NA_Compact_buildAAD(0x00010005, aad);
+    TEST_ASSERT_EQUAL_HEX8(NA_COMPACT_TYPE, aad[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x05, aad[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, aad[4]);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Packing Tests
+    RUN_TEST(test_frame_size);
+    RUN_TEST(test_sticks_round_trip);
+    RUN_TEST(test_centered_throttle_keeps_sign);
+    RUN_TEST(test_axes_clamped);
+
+    // Sequence Tests
+    RUN_TEST(test_expand_forward_and_back);
+    RUN_TEST(test_expand_across_low_wrap);
+    RUN_TEST(test_expand_across_full_wrap);
+
+    // Frame Tests
+    RUN_TEST(test_to_packet_layout);
+    RUN_TEST(test_nonce_and_aad_bind_sequence);
+
+    return UNITY_END();
+}
@@ -0,0 +1,235 @@
+/**
+ * Unit Tests for NavFrame
+ * Tests the local tangent plane against double-precision Haversine,
+ * centimetre resolution, bearings, the antimeridian, pure pursuit and
+ * the time budget of a navigation tick
+ *
+ * @file test_NavFrame.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "Benchmark.h"
+#include "NavFrame.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define HOME_LAT 13.7563        // Bangkok
+#define HOME_LNG 100.5018
+
+static NavFrame frame;
+
+/**
+ * Reference great-circle distance in double precision
+ */
+static double haversine(double lat1, double lng1, double lat2, double lng2) {
+    const double r = M_PI / 180.0;
+    double dLat = (lat2 - lat1) * r;
+    double dLng = (lng2 - lng1) * r;
+    double a = sin(dLat / 2) * sin(dLat / 2) +
+               cos(lat1 * r) * cos(lat2 * r) * sin(dLng / 2) * sin(dLng / 2);
+    return 6371000.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+}
+
+static NavVector local(double lat, double lng) {
+    return NavFrame_toLocal(&frame, NavFrame_toE7(lat), NavFrame_toE7(lng));
+}
+
+void setUp(void) {
+    NavFrame_init(&frame, NavFrame_toE7(HOME_LAT), NavFrame_toE7(HOME_LNG));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Projection Tests
+// ============================================================================
+
+void test_origin_is_zero(void) {
+    NavVector v = local(HOME_LAT, HOME_LNG);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, v.east);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, v.north);
+}
+
+void test_matches_haversine_within_mission_range(void) {
+    const double offsets[][2] = {{0.001, 0.0}, {0.0, 0.002}, {-0.004, 0.003},
+                                 {0.02, -0.015}, {0.05, 0.05}};
+    for (unsigned i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        double lat = HOME_LAT + offsets[i][0];
+        double lng = HOME_LNG + offsets[i][1];
+        float expected = (float)haversine(HOME_LAT, HOME_LNG, lat, lng);
+        float got = NavFrame_distance(local(HOME_LAT, HOME_LNG), local(lat, lng));
+        // 0.1% of the range, at least 1 cm
+        TEST_ASSERT_FLOAT_WITHIN(fmaxf(expected * 0.001f, 0.01f), expected, got);
+    }
+}
+
+void test_centimetre_resolution_far_from_equator(void) {
+    NavFrame_init(&frame, NavFrame_toE7(47.3977), NavFrame_toE7(8.5456));
+    NavVector a = local(47.3977 + 0.01, 8.5456 + 0.01);
+    NavVector b = NavFrame_toLocal(&frame, NavFrame_toE7(47.3977 + 0.01) + 1,
+                                   NavFrame_toE7(8.5456 + 0.01));
+    // One LSB north, ~1 km out, still resolves
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, 0.0111f, b.north - a.north);
+}
+
+void test_antimeridian_takes_short_way(void) {
+    NavFrame_init(&frame, 0, NavFrame_toE7(179.9999));
+    NavVector v = local(0.0, -179.9999);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 22.24f, v.east);
+}
+
+void test_to_global_round_trips(void) {
+    int32_t lat = NavFrame_toE7(HOME_LAT + 0.0123);
+    int32_t lng = NavFrame_toE7(HOME_LNG - 0.0456);
+    int32_t backLat, backLng;
+    NavFrame_toGlobal(&frame, NavFrame_toLocal(&frame, lat, lng), &backLat, &backLng);
+    // Within a few 1e-7 deg (float metres ~5 km out)
+    TEST_ASSERT_INT_WITHIN(5, lat, backLat);
+    TEST_ASSERT_INT_WITHIN(5, lng, backLng);
+}
+
+// ============================================================================
+// Bearing Tests
+// ============================================================================
+
+void test_cardinal_bearings(void) {
+    NavVector o = {0.0f, 0.0f};
+    NavVector n = {0.0f, 10.0f};
+    NavVector e = {10.0f, 0.0f};
+    NavVector s = {0.0f, -10.0f};
+    NavVector w = {-10.0f, 0.0f};
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, NavFrame_bearing(o, n));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, NavFrame_bearing(o, e));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 180.0f, fabsf(NavFrame_bearing(o, s)));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -90.0f, NavFrame_bearing(o, w));
+}
+
+void test_bearing_north_east_of_home(void) {
+    NavVector target = local(HOME_LAT + 0.001, HOME_LNG + 0.001 / cos(HOME_LAT * M_PI / 180.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 45.0f, NavFrame_bearing(local(HOME_LAT, HOME_LNG), target));
+}
+
+// ============================================================================
+// Pure Pursuit Tests
+// ============================================================================
+
+void test_pursuit_on_track_aims_lookahead_ahead(void) {
+    NavVector start = {0.0f, 0.0f};
+    NavVector end = {0.0f, 100.0f};
+    NavVector pos = {0.0f, 20.0f};
+    NavPursuit p = NavFrame_pursuit(start, end, pos, 10.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, p.legLength);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.0f, p.alongTrack);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, p.crossTrack);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, p.aim.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f, p.aim.north);
+}
+
+void test_pursuit_converges_from_off_track(void) {
+    NavVector start = {0.0f, 0.0f};
+    NavVector end = {0.0f, 100.0f};
+    NavVector pos = {6.0f, 20.0f};          // Right of a northbound leg
+    NavPursuit p = NavFrame_pursuit(start, end, pos, 10.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 6.0f, p.crossTrack);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 28.0f, p.aim.north);  // sqrt(10^2 - 6^2) ahead
+    // Steers back left of north, not at the far end point
+    float bearing = NavFrame_bearing(pos, p.aim);
+    TEST_ASSERT_TRUE(bearing < -30.0f);
+    TEST_ASSERT_TRUE(bearing < NavFrame_bearing(pos, end));
+}
+
+void test_pursuit_far_off_track_aims_at_nearest_point(void) {
+    NavVector start = {0.0f, 0.0f};
+    NavVector end = {100.0f, 0.0f};         // Eastbound
+    NavVector pos = {40.0f, 30.0f};         // Left of track, beyond lookahead
+    NavPursuit p = NavFrame_pursuit(start, end, pos, 10.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -30.0f, p.crossTrack);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 40.0f, p.aim.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, p.aim.north);
+}
+
+void test_pursuit_aim_stops_at_leg_end(void) {
+    NavVector start = {0.0f, 0.0f};
+    NavVector end = {0.0f, 100.0f};
+    NavVector pos = {0.0f, 95.0f};
+    NavPursuit p = NavFrame_pursuit(start, end, pos, 10.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, p.aim.north);
+
+    NavVector same = NavFrame_pursuit(end, end, pos, 10.0f).aim;
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, same.north);
+}
+
+void test_leg_precomputes_length_and_bearing(void) {
+    NavVector start = {0.0f, 0.0f};
+    NavVector end = {30.0f, 40.0f};
+    NavLeg leg = NavFrame_leg(start, end);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, leg.length);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.6f, leg.dirEast);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.8f, leg.dirNorth);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 36.87f, leg.bearing);
+
+    NavVector pos = {10.0f, 5.0f};
+    NavPursuit a = NavFrame_pursuitLeg(&leg, pos, 10.0f);
+    NavPursuit b = NavFrame_pursuit(start, end, pos, 10.0f);
+    TEST_ASSERT_EQUAL_FLOAT(b.crossTrack, a.crossTrack);
+    TEST_ASSERT_EQUAL_FLOAT(b.aim.east, a.aim.east);
+    TEST_ASSERT_EQUAL_FLOAT(b.aim.north, a.aim.north);
+}
+
+// ============================================================================
+// Budget Tests
+// ============================================================================
+
+static volatile float sink;
+
+// One navigation tick: project the fix, pursue the leg, steer at the aim
+static void navTick(void* ctx) {
+    (void)ctx;
+    NavVector start = NavFrame_toLocal(&frame, 137571000, 1005027000);
+    NavVector end = NavFrame_toLocal(&frame, 137602000, 1005049000);
+    NavVector pos = NavFrame_toLocal(&frame, 137583000, 1005041000);
+    NavPursuit p = NavFrame_pursuit(start, end, pos, 5.0f);
+    sink = NavFrame_bearing(pos, p.aim) + p.crossTrack;
+}
+
+void test_nav_tick_budget(void) {
+    char msg[BENCH_LINE_MAX];
+    TEST_ASSERT_TRUE_MESSAGE(Bench_checkBudget("nav_tick", navTick, NULL, 500,
+                                               BENCH_BUDGET_NS(8000, 300), msg,
+                                               sizeof(msg)), msg);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Projection Tests
+    RUN_TEST(test_origin_is_zero);
+    RUN_TEST(test_matches_haversine_within_mission_range);
+    RUN_TEST(test_centimetre_resolution_far_from_equator);
+    RUN_TEST(test_antimeridian_takes_short_way);
+    RUN_TEST(test_to_global_round_trips);
+
+    // Bearing Tests
+    RUN_TEST(test_cardinal_bearings);
+    RUN_TEST(test_bearing_north_east_of_home);
+
+    // Pure Pursuit Tests
+    RUN_TEST(test_pursuit_on_track_aims_lookahead_ahead);
+    RUN_TEST(test_pursuit_converges_from_off_track);
+    RUN_TEST(test_pursuit_far_off_track_aims_at_nearest_point);
+    RUN_TEST(test_pursuit_aim_stops_at_leg_end);
+    RUN_TEST(test_leg_precomputes_length_and_bearing);
+
+    // Budget Tests
+    RUN_TEST(test_nav_tick_budget);
+
+    return UNITY_END();
+}
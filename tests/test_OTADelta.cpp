@@ -0,0 +1,196 @@
+/**
+ * Unit Tests for OTADelta
+ * Tests patch reconstruction, chunked feeding and malformed patch rejection
+ *
+ * @file test_OTADelta.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "OTADelta.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t source[1024];
+static uint8_t target[1024];
+static uint32_t targetLen;
+static uint8_t patch[2048];
+static uint32_t patchLen;
+static OTADelta delta;
+
+static bool readSource(void* ctx, uint32_t offset, uint8_t* buf, uint32_t len) {
+    if (offset + len > sizeof(source)) return false;
+    memcpy(buf, source + offset, len);
+    return true;
+}
+
+static bool writeTarget(void* ctx, const uint8_t* data, uint32_t len) {
+    if (targetLen + len > sizeof(target)) return false;
+    memcpy(target + targetLen, data, len);
+    targetLen += len;
+    return true;
+}
+
+static void putByte(uint8_t b) { patch[patchLen++] = b; }
+
+static void putLE32(uint32_t v) {
+    for (int i = 0; i < 4; i++) putByte((uint8_t)(v >> (8 * i)));
+}
+
+static void putVarint(uint32_t v) {
+    while (v >= 0x80) {
+        putByte((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    putByte((uint8_t)v);
+}
+
+static void putHeader(uint32_t targetSize, uint32_t sourceSize) {
+    memcpy(patch + patchLen, OTA_DELTA_MAGIC, 4);
+    patchLen += 4;
+    putLE32(targetSize);
+    putLE32(sourceSize);
+    for (int i = 0; i < 32; i++) putByte((uint8_t)i);
+}
+
+// Diff run against source[oldPos], literal run, then seek
+static void putRecord(const uint8_t* want, uint32_t oldPos, uint32_t diffLen,
+                      const uint8_t* extra, uint32_t extraLen, int32_t seek) {
+    putVarint(diffLen);
+    putVarint(extraLen);
+    putVarint(((uint32_t)seek << 1) ^ (uint32_t)(seek >> 31));
+    for (uint32_t i = 0; i < diffLen; i++) putByte((uint8_t)(want[i] - source[oldPos + i]));
+    for (uint32_t i = 0; i < extraLen; i++) putByte(extra[i]);
+}
+
+// New image: source[100..399] with a few bytes patched, 20 new bytes,
+// then source[0..99] moved to the end
+static uint32_t buildPatch(uint8_t* expected) {
+    uint32_t n = 0;
+    memcpy(expected, source + 100, 300);
+    expected[10] ^= 0x5A;
+    expected[299] = 0;
+    n = 300;
+    uint8_t extra[20];
+    for (int i = 0; i < 20; i++) extra[i] = (uint8_t)(0xA0 + i);
+    memcpy(expected + n, extra, 20);
+    n += 20;
+    memcpy(expected + n, source, 100);
+    n += 100;
+
+    putHeader(n, sizeof(source));
+    putRecord(NULL, 0, 0, NULL, 0, 100);
+    putRecord(expected, 100, 300, extra, 20, -400);
+    putRecord(expected + 320, 0, 100, NULL, 0, 0);
+    return n;
+}
+
+void setUp(void) {
+    for (uint32_t i = 0; i < sizeof(source); i++) source[i] = (uint8_t)(i * 7 + (i >> 3));
+    targetLen = 0;
+    patchLen = 0;
+    OTADelta_init(&delta, readSource, writeTarget, NULL);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Reconstruction Tests
+// ============================================================================
+
+void test_patch_rebuilds_target(void) {
+    uint8_t expected[512];
+    uint32_t n = buildPatch(expected);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_OK, OTADelta_feed(&delta, patch, patchLen));
+    TEST_ASSERT_TRUE(OTADelta_isComplete(&delta));
+    TEST_ASSERT_EQUAL_UINT32(n, targetLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, target, n);
+}
+
+void test_byte_at_a_time_matches(void) {
+    uint8_t expected[512];
+    uint32_t n = buildPatch(expected);
+
+    for (uint32_t i = 0; i < patchLen; i++) {
+        TEST_ASSERT_EQUAL(OTA_DELTA_OK, OTADelta_feed(&delta, patch + i, 1));
+        if (i + 1 < patchLen) TEST_ASSERT_FALSE(OTADelta_isComplete(&delta));
+    }
+    TEST_ASSERT_TRUE(OTADelta_isComplete(&delta));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, target, n);
+}
+
+void test_header_fields(void) {
+    uint8_t expected[512];
+    buildPatch(expected);
+
+    OTADelta_feed(&delta, patch, OTA_DELTA_HEADER_SIZE - 1);
+    TEST_ASSERT_FALSE(OTADelta_headerReady(&delta));
+    OTADelta_feed(&delta, patch + OTA_DELTA_HEADER_SIZE - 1, 1);
+    TEST_ASSERT_TRUE(OTADelta_headerReady(&delta));
+    TEST_ASSERT_EQUAL_UINT32(420, delta.targetSize);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(source), delta.sourceSize);
+    TEST_ASSERT_EQUAL_UINT8(31, delta.sourceSHA256[31]);
+    TEST_ASSERT_EQUAL_UINT32(0, targetLen);
+}
+
+// ============================================================================
+// Malformed Patch Tests
+// ============================================================================
+
+void test_raw_image_rejected(void) {
+    const uint8_t image[8] = {0xE9, 0x03, 0x02, 0x20, 0, 0, 0, 0};
+    TEST_ASSERT_FALSE(OTADelta_isPatch(image, sizeof(image)));
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_MAGIC, OTADelta_feed(&delta, image, sizeof(image)));
+}
+
+void test_seek_outside_source_rejected(void) {
+    uint8_t want[4] = {1, 2, 3, 4};
+    putHeader(8, sizeof(source));
+    putRecord(want, 0, 4, NULL, 0, -10);
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_FORMAT, OTADelta_feed(&delta, patch, patchLen));
+    TEST_ASSERT_EQUAL_UINT32(0, targetLen);
+}
+
+void test_target_overrun_rejected(void) {
+    uint8_t extra[16] = {0};
+    putHeader(8, sizeof(source));
+    putRecord(NULL, 0, 0, extra, 16, 0);
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_FORMAT, OTADelta_feed(&delta, patch, patchLen));
+
+    // Errors are sticky
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_FORMAT, OTADelta_feed(&delta, patch, 1));
+    TEST_ASSERT_FALSE(OTADelta_isComplete(&delta));
+}
+
+void test_truncated_patch_incomplete(void) {
+    uint8_t expected[512];
+    buildPatch(expected);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_OK, OTADelta_feed(&delta, patch, patchLen - 1));
+    TEST_ASSERT_FALSE(OTADelta_isComplete(&delta));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Reconstruction Tests
+    RUN_TEST(test_patch_rebuilds_target);
+    RUN_TEST(test_byte_at_a_time_matches);
+    RUN_TEST(test_header_fields);
+
+    // Malformed Patch Tests
+    RUN_TEST(test_raw_image_rejected);
+    RUN_TEST(test_seek_outside_source_rejected);
+    RUN_TEST(test_target_overrun_rejected);
+    RUN_TEST(test_truncated_patch_incomplete);
+
+    return UNITY_END();
+}
@@ -0,0 +1,157 @@
+/**
+ * Unit Tests for OTAManifest
+ * Tests version ordering, URL resolution, choosing the smallest usable
+ * image and the conditional-request cache
+ *
+ * @file test_OTAManifest.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "OTAManifest.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define MANIFEST_URL "https://fw.example.com/na/stable/manifest.json"
+#define SHA_HEX "00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff"
+
+static const char* MANIFEST =
+    "{\"name\":\"NA Core\",\"version\":\"1.2.0\","
+    "\"builds\":[{\"chip\":\"ESP32\",\"parts\":[{\"address\":\"0x10000\",\"path\":\"a.bin\"}]}],"
+    "\"ota\":{\"sha256\":\"" SHA_HEX "\",\"images\":["
+    "{\"url\":\"NA_Core_v1.2.0.bin.z\",\"size\":803210},"
+    "{\"from\":\"1.1.0-security\",\"url\":\"delta/1.1.0-security.nad\",\"size\":41872},"
+    "{\"from\":\"1.0.0\",\"url\":\"https://cdn.example.com/1.0.0.nad\",\"size\":90000}]}}";
+
+static OTAManifestChoice choice;
+
+void setUp(void) {
+    memset(&choice, 0, sizeof(choice));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Versions and URLs
+// ============================================================================
+
+void test_compare_versions(void) {
+    TEST_ASSERT_TRUE(OTAManifest_compareVersions("1.2.0", "1.1.0-security") > 0);
+    TEST_ASSERT_TRUE(OTAManifest_compareVersions("1.9.2", "1.10.0") < 0);
+    TEST_ASSERT_EQUAL(0, OTAManifest_compareVersions("1.2", "1.2.0"));
+    TEST_ASSERT_EQUAL(0, OTAManifest_compareVersions("1.1.0-security", "1.1.0"));
+    TEST_ASSERT_TRUE(OTAManifest_compareVersions("2", "1.99.99") > 0);
+}
+
+void test_resolve_url(void) {
+    char out[OTA_MANIFEST_URL_MAX];
+    TEST_ASSERT_TRUE(OTAManifest_resolveUrl(MANIFEST_URL, "a.bin", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("https://fw.example.com/na/stable/a.bin", out);
+    TEST_ASSERT_TRUE(OTAManifest_resolveUrl(MANIFEST_URL, "/b.bin", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("https://fw.example.com/b.bin", out);
+    TEST_ASSERT_TRUE(OTAManifest_resolveUrl(MANIFEST_URL, "http://x/c.bin", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("http://x/c.bin", out);
+    TEST_ASSERT_TRUE(OTAManifest_resolveUrl("https://host", "d.bin", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("https://host/d.bin", out);
+    TEST_ASSERT_FALSE(OTAManifest_resolveUrl(MANIFEST_URL, "a.bin", out, 20));
+}
+
+// ============================================================================
+// Selection Tests
+// ============================================================================
+
+void test_delta_chosen_when_smaller(void) {
+    TEST_ASSERT_EQUAL(OTA_MANIFEST_UPDATE,
+                      OTAManifest_select(MANIFEST, strlen(MANIFEST), MANIFEST_URL,
+                                         "1.1.0-security", &choice));
+    TEST_ASSERT_TRUE(choice.delta);
+    TEST_ASSERT_EQUAL_UINT32(41872, choice.size);
+    TEST_ASSERT_EQUAL_STRING("https://fw.example.com/na/stable/delta/1.1.0-security.nad",
+                             choice.url);
+    TEST_ASSERT_EQUAL_STRING("1.2.0", choice.version);
+    TEST_ASSERT_TRUE(choice.hasSha256);
+    TEST_ASSERT_FALSE(choice.hasSignature);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, choice.sha256[15]);
+}
+
+void test_full_image_without_matching_delta(void) {
+    TEST_ASSERT_EQUAL(OTA_MANIFEST_UPDATE,
+                      OTAManifest_select(MANIFEST, strlen(MANIFEST), MANIFEST_URL, "1.1.5",
+                                         &choice));
+    TEST_ASSERT_FALSE(choice.delta);
+    TEST_ASSERT_EQUAL_UINT32(803210, choice.size);
+}
+
+void test_up_to_date_and_bad(void) {
+    TEST_ASSERT_EQUAL(OTA_MANIFEST_UP_TO_DATE,
+                      OTAManifest_select(MANIFEST, strlen(MANIFEST), MANIFEST_URL, "1.2.0",
+                                         &choice));
+    const char* flasherOnly = "{\"version\":\"1.3.0\",\"builds\":[]}";
+    TEST_ASSERT_EQUAL(OTA_MANIFEST_NO_IMAGE,
+                      OTAManifest_select(flasherOnly, strlen(flasherOnly), MANIFEST_URL,
+                                         "1.2.0", &choice));
+    const char* badSha = "{\"version\":\"1.3.0\",\"ota\":{\"sha256\":\"xyz\",\"images\":[]}}";
+    TEST_ASSERT_EQUAL(OTA_MANIFEST_BAD,
+                      OTAManifest_select(badSha, strlen(badSha), MANIFEST_URL, "1.2.0", &choice));
+    TEST_ASSERT_EQUAL(OTA_MANIFEST_BAD,
+                      OTAManifest_select("<html>", 6, MANIFEST_URL, "1.2.0", &choice));
+}
+
+// ============================================================================
+// Cache Tests
+// ============================================================================
+
+void test_cache_follows_url_and_version(void) {
+    OTAManifestCache cache;
+    memset(&cache, 0, sizeof(cache));
+    TEST_ASSERT_FALSE(OTAManifest_cacheMatches(&cache, MANIFEST_URL, "1.1.0"));
+
+    OTAManifest_select(MANIFEST, strlen(MANIFEST), MANIFEST_URL, "1.1.0", &choice);
+    OTAManifest_cacheStore(&cache, MANIFEST_URL, "1.1.0", "\"5e1f-61c2\"",
+                           "Wed, 14 Oct 2026 08:00:00 GMT", OTA_MANIFEST_UPDATE, &choice);
+    TEST_ASSERT_TRUE(OTAManifest_cacheMatches(&cache, MANIFEST_URL, "1.1.0"));
+    TEST_ASSERT_EQUAL_STRING("\"5e1f-61c2\"", cache.etag);
+    TEST_ASSERT_EQUAL_UINT32(803210, cache.choice.size);
+
+    // Another manifest or a new running image: ask unconditionally
+    TEST_ASSERT_FALSE(OTAManifest_cacheMatches(&cache, MANIFEST_URL "?beta", "1.1.0"));
+    TEST_ASSERT_FALSE(OTAManifest_cacheMatches(&cache, MANIFEST_URL, "1.2.0"));
+}
+
+void test_cache_drops_oversized_validator(void) {
+    OTAManifestCache cache;
+    char etag[OTA_MANIFEST_ETAG_MAX + 8];
+    memset(etag, 'a', sizeof(etag) - 1);
+    etag[sizeof(etag) - 1] = '\0';
+    OTAManifest_cacheStore(&cache, MANIFEST_URL, "1.1.0", etag, "", OTA_MANIFEST_UP_TO_DATE,
+                           NULL);
+    TEST_ASSERT_EQUAL_STRING("", cache.etag);
+    // Nothing left to send: not usable for a conditional request
+    TEST_ASSERT_FALSE(OTAManifest_cacheMatches(&cache, MANIFEST_URL, "1.1.0"));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Versions and URLs
+    RUN_TEST(test_compare_versions);
+    RUN_TEST(test_resolve_url);
+
+    // Selection Tests
+    RUN_TEST(test_delta_chosen_when_smaller);
+    RUN_TEST(test_full_image_without_matching_delta);
+    RUN_TEST(test_up_to_date_and_bad);
+
+    // Cache Tests
+    RUN_TEST(test_cache_follows_url_and_version);
+    RUN_TEST(test_cache_drops_oversized_validator);
+
+    return UNITY_END();
+}
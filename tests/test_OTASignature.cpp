@@ -0,0 +1,106 @@
+/**
+ * Unit Tests for OTASignature
+ * Tests ECDSA P-256 image signature checks against an OpenSSL-made vector
+ *
+ * @file test_OTASignature.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "OTASignature.h"
+#include <string.h>
+
+// ============================================================================
+// Test Vectors
+// ============================================================================
+
+// openssl ecparam -name prime256v1 -genkey; openssl dgst -sha256 -sign
+// over the 23 bytes "micro-NA firmware image"
+static const uint8_t kPublicKey[64] = {
+    0xc1, 0xa7, 0xa2, 0x00, 0xc8, 0x3e, 0xa9, 0xa8, 0xc8, 0x38, 0x3b, 0x1f,
+    0x97, 0xa9, 0x46, 0xd3, 0xd2, 0x05, 0x71, 0xd9, 0xc9, 0x21, 0xc9, 0x53,
+    0x98, 0xfd, 0x6a, 0xde, 0x56, 0xcc, 0x6c, 0xc7, 0xf1, 0x38, 0x5a, 0xda,
+    0xa9, 0x60, 0x24, 0x25, 0x55, 0x52, 0x73, 0x47, 0xe0, 0x45, 0xea, 0xf2,
+    0x12, 0xc2, 0xa9, 0xbe, 0x93, 0x42, 0xef, 0xe7, 0x25, 0x01, 0xd0, 0x2a,
+    0x13, 0x56, 0x44, 0x81,
+};
+static const uint8_t kImageHash[32] = {
+    0xb0, 0xd2, 0x37, 0x50, 0x81, 0x0c, 0xdd, 0xe0, 0xfa, 0x95, 0x2c, 0x73,
+    0xf3, 0x91, 0x56, 0x96, 0xae, 0x0f, 0x99, 0x94, 0x4f, 0x2a, 0xb3, 0x5e,
+    0x69, 0xbd, 0xa7, 0xd3, 0xdd, 0xea, 0xe8, 0xb0,
+};
+static const uint8_t kSignature[64] = {
+    0x0a, 0x53, 0x96, 0xeb, 0x39, 0xfe, 0x72, 0x9a, 0x4b, 0xcc, 0x76, 0x3d,
+    0x52, 0x8d, 0x76, 0xf3, 0x5a, 0x2b, 0xac, 0x6e, 0xd8, 0xc4, 0xee, 0x83,
+    0x9d, 0x80, 0xfd, 0x46, 0x4b, 0x70, 0x6a, 0xe9, 0x5d, 0xa0, 0xb8, 0xf6,
+    0x29, 0x02, 0x21, 0xec, 0x1d, 0x4a, 0x3f, 0xce, 0x66, 0x41, 0xe8, 0x9b,
+    0x45, 0xb4, 0xb2, 0x10, 0x6a, 0x7f, 0x28, 0xc0, 0xc1, 0x70, 0x7b, 0x4e,
+    0x03, 0x23, 0x2a, 0xda,
+};
+
+static OTASignatureKey key;
+
+void setUp(void) { OTASignature_initKey(&key); }
+
+void tearDown(void) { OTASignature_freeKey(&key); }
+
+// ============================================================================
+// Key Tests
+// ============================================================================
+
+void test_key_loads(void) {
+    TEST_ASSERT_TRUE(OTASignature_loadKey(&key, kPublicKey));
+    TEST_ASSERT_TRUE(key.loaded);
+}
+
+void test_off_curve_key_rejected(void) {
+    uint8_t bad[64];
+    memcpy(bad, kPublicKey, sizeof(bad));
+    bad[63] ^= 0x01;
+    TEST_ASSERT_FALSE(OTASignature_loadKey(&key, bad));
+    TEST_ASSERT_FALSE(OTASignature_verify(&key, kImageHash, kSignature));
+}
+
+// ============================================================================
+// Signature Tests
+// ============================================================================
+
+void test_valid_signature_accepted(void) {
+    OTASignature_loadKey(&key, kPublicKey);
+    TEST_ASSERT_TRUE(OTASignature_verify(&key, kImageHash, kSignature));
+}
+
+void test_other_image_rejected(void) {
+    uint8_t hash[32];
+    memcpy(hash, kImageHash, sizeof(hash));
+    hash[0] ^= 0x80;
+    OTASignature_loadKey(&key, kPublicKey);
+    TEST_ASSERT_FALSE(OTASignature_verify(&key, hash, kSignature));
+}
+
+void test_tampered_signature_rejected(void) {
+    uint8_t sig[64];
+    memcpy(sig, kSignature, sizeof(sig));
+    sig[40] ^= 0x01;
+    OTASignature_loadKey(&key, kPublicKey);
+    TEST_ASSERT_FALSE(OTASignature_verify(&key, kImageHash, sig));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Key Tests
+    RUN_TEST(test_key_loads);
+    RUN_TEST(test_off_curve_key_rejected);
+
+    // Signature Tests
+    RUN_TEST(test_valid_signature_accepted);
+    RUN_TEST(test_other_image_rejected);
+    RUN_TEST(test_tampered_signature_rejected);
+
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+/**
+ * Unit Tests for OccupancyGrid
+ * Tests cell addressing around the origin, polygon fill, row transfer,
+ * the stored record and the segment line-of-sight walk
+ *
+ * @file test_OccupancyGrid.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "OccupancyGrid.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define HOME_LAT 137000000L
+#define HOME_LNG 1005000000L
+
+static OccupancyGrid grid;
+
+static NavVector at(float north, float east) {
+    NavVector v = {east, north};
+    return v;
+}
+
+// Blocked square of cells spanning north / east [lo, hi) meters
+static void blockBox(float lo, float hi) {
+    NavVector box[4] = {at(lo, lo), at(lo, hi), at(hi, hi), at(hi, lo)};
+    OccupancyGrid_fillPolygon(&grid, box, 4, true);
+}
+
+void setUp(void) {
+    OccupancyGrid_anchor(&grid, HOME_LAT, HOME_LNG, 2.0f);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Map Tests
+// ============================================================================
+
+void test_cells_around_origin(void) {
+    int row, col;
+    TEST_ASSERT_TRUE(OccupancyGrid_cellOf(&grid, at(0.5f, 0.5f), &row, &col));
+    TEST_ASSERT_EQUAL_INT(OCC_GRID_DIM / 2, row);
+    TEST_ASSERT_EQUAL_INT(OCC_GRID_DIM / 2, col);
+    TEST_ASSERT_TRUE(OccupancyGrid_cellOf(&grid, at(-0.5f, 3.0f), &row, &col));
+    TEST_ASSERT_EQUAL_INT(OCC_GRID_DIM / 2 - 1, row);
+    TEST_ASSERT_EQUAL_INT(OCC_GRID_DIM / 2 + 1, col);
+    TEST_ASSERT_FALSE(OccupancyGrid_cellOf(&grid, at(OCC_GRID_DIM + 1.0f, 0.0f), &row, &col));
+
+    NavVector c = OccupancyGrid_cellCenter(&grid, OCC_GRID_DIM / 2, OCC_GRID_DIM / 2 + 1);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, c.north);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, c.east);
+}
+
+void test_fill_polygon(void) {
+    blockBox(0.0f, 10.0f);
+    TEST_ASSERT_EQUAL_UINT16(25, grid.blocked);
+    TEST_ASSERT_TRUE(OccupancyGrid_isBlocked(&grid, OCC_GRID_DIM / 2 + 4, OCC_GRID_DIM / 2));
+    TEST_ASSERT_FALSE(OccupancyGrid_isBlocked(&grid, OCC_GRID_DIM / 2 + 5, OCC_GRID_DIM / 2));
+
+    // Freeing the same area undoes it
+    NavVector box[4] = {at(0, 0), at(0, 10), at(10, 10), at(10, 0)};
+    TEST_ASSERT_EQUAL_INT(25, OccupancyGrid_fillPolygon(&grid, box, 4, false));
+    TEST_ASSERT_EQUAL_UINT16(0, grid.blocked);
+    TEST_ASSERT_EQUAL_INT(-1, OccupancyGrid_fillPolygon(&grid, box, 2, true));
+}
+
+void test_outside_is_free(void) {
+    TEST_ASSERT_FALSE(OccupancyGrid_isBlocked(&grid, -1, 0));
+    TEST_ASSERT_FALSE(OccupancyGrid_isBlocked(&grid, 0, OCC_GRID_DIM));
+    OccupancyGrid_set(&grid, OCC_GRID_DIM, 0, true);
+    TEST_ASSERT_EQUAL_UINT16(0, grid.blocked);
+}
+
+void test_row_transfer_and_record(void) {
+    uint8_t row[OCC_GRID_ROW_BYTES] = {0x81};
+    TEST_ASSERT_TRUE(OccupancyGrid_setRow(&grid, 3, row));
+    TEST_ASSERT_TRUE(OccupancyGrid_isBlocked(&grid, 3, 0));
+    TEST_ASSERT_TRUE(OccupancyGrid_isBlocked(&grid, 3, 7));
+    TEST_ASSERT_EQUAL_UINT16(2, grid.blocked);
+    uint8_t back[OCC_GRID_ROW_BYTES];
+    OccupancyGrid_getRow(&grid, 3, back);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(row, back, OCC_GRID_ROW_BYTES);
+
+    OccupancyGrid loaded;
+    TEST_ASSERT_TRUE(OccupancyGrid_load(&loaded, &grid.map));
+    TEST_ASSERT_EQUAL_UINT16(2, loaded.blocked);
+    TEST_ASSERT_EQUAL_INT32(HOME_LAT, loaded.frame.originLat);
+
+    OccupancyGridRecord bad = grid.map;
+    bad.cellM = 0.0f;
+    TEST_ASSERT_FALSE(OccupancyGrid_load(&loaded, &bad));
+    TEST_ASSERT_FALSE(loaded.anchored);
+}
+
+// ============================================================================
+// Line of Sight Tests
+// ============================================================================
+
+void test_segment_through_block(void) {
+    blockBox(10.0f, 20.0f);
+    TEST_ASSERT_FALSE(OccupancyGrid_segmentClear(&grid, at(0, 0), at(30, 30)));
+    TEST_ASSERT_FALSE(OccupancyGrid_segmentClear(&grid, at(15, -40), at(15, 40)));
+    TEST_ASSERT_TRUE(OccupancyGrid_segmentClear(&grid, at(0, 0), at(0, 30)));
+    TEST_ASSERT_TRUE(OccupancyGrid_segmentClear(&grid, at(21, 0), at(21, 30)));
+    // Far outside the map on both ends, crossing it
+    TEST_ASSERT_FALSE(OccupancyGrid_segmentClear(&grid, at(15, -5000), at(15, 5000)));
+    TEST_ASSERT_TRUE(OccupancyGrid_segmentClear(&grid, at(500, -5000), at(500, 5000)));
+}
+
+void test_segment_through_corner(void) {
+    // Two cells touching at a corner: a line through the corner is blocked
+    OccupancyGrid_set(&grid, OCC_GRID_DIM / 2, OCC_GRID_DIM / 2 + 1, true);
+    TEST_ASSERT_FALSE(OccupancyGrid_segmentClear(&grid, at(1.0f, 1.0f), at(3.0f, 3.0f)));
+    TEST_ASSERT_TRUE(OccupancyGrid_segmentClear(&grid, at(1.0f, 1.0f), at(1.0f, -5.0f)));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Map Tests
+    RUN_TEST(test_cells_around_origin);
+    RUN_TEST(test_fill_polygon);
+    RUN_TEST(test_outside_is_free);
+    RUN_TEST(test_row_transfer_and_record);
+
+    // Line of Sight Tests
+    RUN_TEST(test_segment_through_block);
+    RUN_TEST(test_segment_through_corner);
+
+    return UNITY_END();
+}
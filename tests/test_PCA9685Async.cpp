@@ -0,0 +1,119 @@
+/**
+ * Unit Tests for PCA9685Async
+ * Tests prescaler selection, pulse width to duty conversion and the
+ * auto-increment burst encoding
+ *
+ * @file test_PCA9685Async.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "drivers/PCA9685Async.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Prescaler Tests
+// ============================================================================
+
+void test_prescale_for_servo_rate(void) {
+    // 25 MHz / (4096 * 50) = 122.07 -> 121
+    TEST_ASSERT_EQUAL_UINT8(121, PCA9685Async::prescaleFor(50));
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 50.0f, PCA9685Async::frequencyFor(121));
+}
+
+void test_prescale_limits(void) {
+    TEST_ASSERT_EQUAL_UINT8(3, PCA9685Async::prescaleFor(PCA9685_MAX_HZ));
+    TEST_ASSERT_EQUAL_UINT8(3, PCA9685Async::prescaleFor(5000));
+    TEST_ASSERT_EQUAL_UINT8(253, PCA9685Async::prescaleFor(1));  // Clamped to 24 Hz
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 1526.0f, PCA9685Async::frequencyFor(3));
+}
+
+// ============================================================================
+// Duty Tests
+// ============================================================================
+
+void test_servo_pulse_duty(void) {
+    // 1500 us of a 20 ms period = 307.2 counts
+    TEST_ASSERT_EQUAL_UINT16(307, PCA9685Async::dutyForMicroseconds(1500.0f, 50.0f));
+    TEST_ASSERT_EQUAL_UINT16(205, PCA9685Async::dutyForMicroseconds(1000.0f, 50.0f));
+}
+
+void test_duty_clamps(void) {
+    TEST_ASSERT_EQUAL_UINT16(0, PCA9685Async::dutyForMicroseconds(-5.0f, 50.0f));
+    TEST_ASSERT_EQUAL_UINT16(PCA9685_DUTY_FULL,
+                             PCA9685Async::dutyForMicroseconds(30000.0f, 50.0f));
+    TEST_ASSERT_EQUAL_UINT16(0, PCA9685Async::dutyForMicroseconds(1500.0f, 0.0f));
+}
+
+// ============================================================================
+// Burst Encoding Tests
+// ============================================================================
+
+void test_frame_layout(void) {
+    uint16_t duty[PCA9685_CHANNELS] = {0};
+    duty[0] = 307;
+    duty[15] = 0x0ABC;
+    uint8_t frame[PCA9685_FRAME_BYTES];
+    PCA9685Async::buildFrame(duty, frame);
+
+    TEST_ASSERT_EQUAL_HEX8(0x06, frame[0]);     // LED0_ON_L, then auto-increment
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[2]);
+    TEST_ASSERT_EQUAL_HEX8(307 & 0xFF, frame[3]);
+    TEST_ASSERT_EQUAL_HEX8(307 >> 8, frame[4]);
+    TEST_ASSERT_EQUAL_HEX8(0xBC, frame[1 + 15 * 4 + 2]);
+    TEST_ASSERT_EQUAL_HEX8(0x0A, frame[1 + 15 * 4 + 3]);
+}
+
+void test_frame_full_off_and_on(void) {
+    uint16_t duty[PCA9685_CHANNELS] = {0};
+    duty[2] = PCA9685_DUTY_FULL;
+    uint8_t frame[PCA9685_FRAME_BYTES];
+    PCA9685Async::buildFrame(duty, frame);
+
+    // Channel 1 off: OFF_H bit 4
+    TEST_ASSERT_EQUAL_HEX8(0x10, frame[1 + 4 + 3]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[1 + 4 + 1]);
+    // Channel 2 on: ON_H bit 4, OFF_H clear
+    TEST_ASSERT_EQUAL_HEX8(0x10, frame[1 + 8 + 1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[1 + 8 + 3]);
+}
+
+void test_set_before_begin_is_held(void) {
+    PCA9685Async pwm;
+    pwm.setDuty(4, 5000);
+    pwm.setDuty(PCA9685_CHANNELS, 100);         // Ignored
+    TEST_ASSERT_EQUAL_UINT16(PCA9685_DUTY_FULL, pwm.getDuty(4));
+    TEST_ASSERT_EQUAL_UINT16(0, pwm.getDuty(PCA9685_CHANNELS));
+    TEST_ASSERT_FALSE(pwm.flush());             // Not begun: nothing on the bus
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Prescaler Tests
+    RUN_TEST(test_prescale_for_servo_rate);
+    RUN_TEST(test_prescale_limits);
+
+    // Duty Tests
+    RUN_TEST(test_servo_pulse_duty);
+    RUN_TEST(test_duty_clamps);
+
+    // Burst Encoding Tests
+    RUN_TEST(test_frame_layout);
+    RUN_TEST(test_frame_full_off_and_on);
+    RUN_TEST(test_set_before_begin_is_held);
+
+    return UNITY_END();
+}
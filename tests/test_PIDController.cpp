@@ -0,0 +1,112 @@
+/**
+ * Unit Tests for PIDController
+ * Tests D on measurement, D from a supplied rate, the D filter, integral
+ * clamping and bumpless retune / transfer (the update path is also
+ * covered by test_RateController)
+ *
+ * @file test_PIDController.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "PIDController.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DT 0.02f
+
+static PIDGains gains;
+static PIDState state;
+
+void setUp(void) {
+    gains.kp = 1.0f;
+    gains.ki = 0.5f;
+    gains.kd = 0.2f;
+    gains.kff = 0.0f;
+    gains.dCutoffHz = 0.0f;
+    gains.iLimit = 0.3f;
+    gains.outLimit = 1.0f;
+    PID_reset(&state);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Update Tests
+// ============================================================================
+
+void test_setpoint_step_has_no_derivative_kick(void) {
+    PID_update(&gains, &state, 0.0f, 0.0f, DT, false);
+    float out = PID_update(&gains, &state, 0.5f, 0.0f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, out);     // P only
+}
+
+void test_derivative_filtered(void) {
+    gains.dCutoffHz = 2.0f;
+    PID_update(&gains, &state, 0.0f, 0.0f, DT, false);
+    PID_update(&gains, &state, 0.0f, 0.01f, DT, false);
+    // Raw D would be -0.2 * 0.5 = -0.1; the 2 Hz filter passes ~20% on the first step
+    TEST_ASSERT_TRUE(state.dTerm < 0.0f);
+    TEST_ASSERT_TRUE(state.dTerm > -0.03f);
+}
+
+void test_derivative_from_supplied_rate(void) {
+    // Measurement jumps but the supplied rate says steady: no D at all
+    PID_updateRate(&gains, &state, 0.0f, 0.0f, 0.0f, DT, false);
+    float out = PID_updateRate(&gains, &state, 0.0f, 0.1f, 0.0f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, -0.1f, out);
+    out = PID_updateRate(&gains, &state, 0.0f, 0.1f, 0.5f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, -0.1f - 0.2f * 0.5f, out);
+}
+
+void test_integral_clamped(void) {
+    gains.kp = 0.1f;
+    for (int i = 0; i < 1000; i++) PID_update(&gains, &state, 1.0f, 0.0f, DT, true);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.3f, state.integral);
+}
+
+// ============================================================================
+// Bumpless Tests
+// ============================================================================
+
+void test_retune_keeps_output(void) {
+    gains.kd = 0.0f;
+    for (int i = 0; i < 5; i++) PID_update(&gains, &state, 0.2f, 0.0f, DT, true);
+    float before = PID_update(&gains, &state, 0.2f, 0.0f, DT, false);
+
+    PIDGains next = gains;
+    next.kp = 2.0f;
+    PID_setGains(&gains, &state, &next);
+    float after = PID_update(&gains, &state, 0.2f, 0.0f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, before, after);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f, gains.kp);
+}
+
+void test_transfer_continues_from_output(void) {
+    gains.kd = 0.0f;
+    PID_transfer(&gains, &state, 0.1f, 0.0f, 0.25f);
+    float out = PID_update(&gains, &state, 0.1f, 0.0f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.25f, out);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Update Tests
+    RUN_TEST(test_setpoint_step_has_no_derivative_kick);
+    RUN_TEST(test_derivative_filtered);
+    RUN_TEST(test_derivative_from_supplied_rate);
+    RUN_TEST(test_integral_clamped);
+
+    // Bumpless Tests
+    RUN_TEST(test_retune_keeps_output);
+    RUN_TEST(test_transfer_continues_from_output);
+
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+/**
+ * Unit Tests for PathPlanner
+ * Tests direct legs, detours around a wall and through a gap, blocked
+ * ends, unreachable goals, and that every planned leg stays clear
+ *
+ * @file test_PathPlanner.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <time.h>
+#include "PathPlanner.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static OccupancyGrid grid;
+static PathPlanner planner;
+static NavVector points[PLANNER_MAX_POINTS];
+static uint8_t count;
+
+static NavVector at(float north, float east) {
+    NavVector v = {east, north};
+    return v;
+}
+
+static void block(float north0, float east0, float north1, float east1) {
+    NavVector box[4] = {at(north0, east0), at(north0, east1), at(north1, east1), at(north1, east0)};
+    OccupancyGrid_fillPolygon(&grid, box, 4, true);
+}
+
+// Every leg start -> points -> goal avoids the blocked cells
+static bool routeClear(NavVector start, NavVector goal) {
+    NavVector from = start;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!OccupancyGrid_segmentClear(&grid, from, points[i])) return false;
+        from = points[i];
+    }
+    return OccupancyGrid_segmentClear(&grid, from, goal);
+}
+
+static float routeLength(NavVector start, NavVector goal) {
+    float length = 0.0f;
+    NavVector from = start;
+    for (uint8_t i = 0; i < count; i++) {
+        length += NavFrame_distance(from, points[i]);
+        from = points[i];
+    }
+    return length + NavFrame_distance(from, goal);
+}
+
+void setUp(void) {
+    OccupancyGrid_anchor(&grid, 137000000L, 1005000000L, 2.0f);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Planning Tests
+// ============================================================================
+
+void test_direct_when_clear(void) {
+    block(20, 20, 30, 30);
+    TEST_ASSERT_EQUAL(PLAN_DIRECT, PathPlanner_plan(&planner, &grid, at(0, 0), at(0, 40), points, &count));
+    TEST_ASSERT_EQUAL_UINT8(0, count);
+
+    OccupancyGrid empty;
+    OccupancyGrid_init(&empty);
+    TEST_ASSERT_EQUAL(PLAN_DIRECT, PathPlanner_plan(&planner, &empty, at(0, 0), at(50, 50), points, &count));
+}
+
+void test_detour_around_wall(void) {
+    // Wall across the leg, 30 m wide, leg goes through its middle
+    block(10, -15, 14, 15);
+    NavVector start = at(0, 0), goal = at(30, 0);
+    TEST_ASSERT_EQUAL(PLAN_OK, PathPlanner_plan(&planner, &grid, start, goal, points, &count));
+    TEST_ASSERT_TRUE(count >= 1 && count <= 2);
+    TEST_ASSERT_TRUE(routeClear(start, goal));
+    // Close to the shortest way round the end of the wall
+    float best = 2.0f * sqrtf(12.0f * 12.0f + 15.0f * 15.0f);
+    TEST_ASSERT_TRUE(routeLength(start, goal) < best * 1.15f);
+}
+
+void test_through_gap(void) {
+    // Wall right across the map with a 6 m gap at east 20
+    block(10, -64, 14, 17);
+    block(10, 23, 14, 64);
+    NavVector start = at(0, 0), goal = at(30, 0);
+    TEST_ASSERT_EQUAL(PLAN_OK, PathPlanner_plan(&planner, &grid, start, goal, points, &count));
+    TEST_ASSERT_TRUE(routeClear(start, goal));
+    bool nearGap = false;
+    for (uint8_t i = 0; i < count; i++)
+        nearGap |= fabsf(points[i].east - 20.0f) < 4.0f;
+    TEST_ASSERT_TRUE(nearGap);
+}
+
+void test_blocked_ends(void) {
+    block(10, -10, 20, 10);
+    TEST_ASSERT_EQUAL(PLAN_GOAL_BLOCKED, PathPlanner_plan(&planner, &grid, at(0, 0), at(15, 0), points, &count));
+    TEST_ASSERT_EQUAL(PLAN_START_BLOCKED, PathPlanner_plan(&planner, &grid, at(15, 0), at(30, 0), points, &count));
+    TEST_ASSERT_EQUAL(PLAN_OUTSIDE, PathPlanner_plan(&planner, &grid, at(-500, 0), at(30, 0), points, &count));
+}
+
+void test_no_path(void) {
+    // Goal boxed in by a ring
+    block(20, -10, 22, 10);
+    block(38, -10, 40, 10);
+    block(20, -10, 40, -8);
+    block(20, 8, 40, 10);
+    TEST_ASSERT_EQUAL(PLAN_NO_PATH, PathPlanner_plan(&planner, &grid, at(0, 0), at(30, 0), points, &count));
+}
+
+void test_no_corner_cutting(void) {
+    // Two walls across the map whose ends touch only at a corner: the
+    // one way through would squeeze diagonally between them
+    int mid = OCC_GRID_DIM / 2;
+    for (int col = 0; col < OCC_GRID_DIM; col++)
+        OccupancyGrid_set(&grid, col < mid ? mid : mid + 1, col, true);
+    TEST_ASSERT_EQUAL(PLAN_NO_PATH, PathPlanner_plan(&planner, &grid, at(-10, 1), at(10, 1), points, &count));
+
+    // Open one cell next to the corner and it goes through
+    OccupancyGrid_set(&grid, mid + 1, mid, false);
+    NavVector start = at(-10, -3), goal = at(10, -3);
+    TEST_ASSERT_EQUAL(PLAN_OK, PathPlanner_plan(&planner, &grid, start, goal, points, &count));
+    TEST_ASSERT_TRUE(routeClear(start, goal));
+}
+
+void test_full_map_search_time(void) {
+    // Serpentine: worst case for the open list and the path length
+    for (int k = 0; k < 6; k++) {
+        float north = -50.0f + k * 18.0f;
+        if (k % 2 == 0) block(north, -64, north + 2, 56);
+        else block(north, -56, north + 2, 64);
+    }
+    NavVector start = at(-60, 0), goal = at(60, 0);
+    clock_t t0 = clock();
+    PlanResult r = PathPlanner_plan(&planner, &grid, start, goal, points, &count);
+    double ms = (clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+    TEST_ASSERT_EQUAL(PLAN_OK, r);
+    TEST_ASSERT_TRUE(routeClear(start, goal));
+    TEST_ASSERT_TRUE(planner.openPeak < PLANNER_OPEN_MAX);
+    TEST_ASSERT_TRUE(ms < 50.0);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Planning Tests
+    RUN_TEST(test_direct_when_clear);
+    RUN_TEST(test_detour_around_wall);
+    RUN_TEST(test_through_gap);
+    RUN_TEST(test_blocked_ends);
+    RUN_TEST(test_no_path);
+    RUN_TEST(test_no_corner_cutting);
+    RUN_TEST(test_full_map_search_time);
+
+    return UNITY_END();
+}
@@ -0,0 +1,162 @@
+/**
+ * Unit Tests for PeerSessionTable
+ * Tests MAC lookup, slot reuse, LRU eviction rules (pinned and keyed
+ * slots) and key clearing
+ *
+ * @file test_PeerSessionTable.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "PeerSessionTable.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static PeerSessionTable table;
+
+static const uint8_t* macOf(uint8_t n) {
+    static uint8_t mac[PEER_SESSION_MAC_SIZE];
+    const uint8_t base[PEER_SESSION_MAC_SIZE] = {0x24, 0x6F, 0x28, 0x10, 0x00, 0x00};
+    memcpy(mac, base, sizeof(mac));
+    mac[5] = n;
+    return mac;
+}
+
+static int add(uint8_t n, bool forKeys) {
+    int slot = PeerSessionTable_acquire(&table, macOf(n), forKeys, NULL, NULL);
+    if (slot != PEER_SESSION_NONE && forKeys)
+        table.peers[slot].keyed = true;
+    return slot;
+}
+
+void setUp(void) {
+    PeerSessionTable_init(&table);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Lookup Tests
+// ============================================================================
+
+void test_empty_table_finds_nothing(void) {
+    TEST_ASSERT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(1)));
+    TEST_ASSERT_EQUAL(0, PeerSessionTable_count(&table));
+}
+
+void test_acquire_then_find(void) {
+    int a = add(1, false);
+    int b = add(2, true);
+    TEST_ASSERT_NOT_EQUAL(PEER_SESSION_NONE, a);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+    TEST_ASSERT_EQUAL(a, PeerSessionTable_find(&table, macOf(1)));
+    TEST_ASSERT_EQUAL(b, PeerSessionTable_find(&table, macOf(2)));
+    TEST_ASSERT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(3)));
+
+    // Acquiring again returns the same slot
+    TEST_ASSERT_EQUAL(a, add(1, false));
+    TEST_ASSERT_EQUAL(2, PeerSessionTable_count(&table));
+}
+
+void test_remove_keeps_other_lookups(void) {
+    for (uint8_t n = 1; n <= PEER_SESSION_MAX; n++)
+        add(n, false);
+    int gone = PeerSessionTable_find(&table, macOf(2));
+    PeerSessionTable_remove(&table, gone);
+    TEST_ASSERT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(2)));
+    for (uint8_t n = 1; n <= PEER_SESSION_MAX; n++) {
+        if (n != 2)
+            TEST_ASSERT_NOT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(n)));
+    }
+    // Freed slot is reused before anything is evicted
+    TEST_ASSERT_EQUAL(gone, add(9, false));
+    TEST_ASSERT_EQUAL_UINT32(0, table.evictions);
+}
+
+// ============================================================================
+// Eviction Tests
+// ============================================================================
+
+void test_full_table_evicts_least_recent(void) {
+    for (uint8_t n = 1; n <= PEER_SESSION_MAX; n++)
+        add(n, true);
+    PeerSessionTable_touch(&table, PeerSessionTable_find(&table, macOf(1)));
+
+    uint8_t evicted[PEER_SESSION_MAC_SIZE];
+    bool didEvict = false;
+    int slot = PeerSessionTable_acquire(&table, macOf(9), true, evicted, &didEvict);
+    TEST_ASSERT_NOT_EQUAL(PEER_SESSION_NONE, slot);
+    TEST_ASSERT_TRUE(didEvict);
+    TEST_ASSERT_EQUAL_MEMORY(macOf(2), evicted, PEER_SESSION_MAC_SIZE);
+    TEST_ASSERT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(2)));
+    TEST_ASSERT_EQUAL(slot, PeerSessionTable_find(&table, macOf(9)));
+    TEST_ASSERT_FALSE(table.peers[slot].keyed);     // Fresh slot
+    TEST_ASSERT_EQUAL_UINT32(1, table.evictions);
+}
+
+void test_pinned_slot_never_evicted(void) {
+    for (uint8_t n = 1; n <= PEER_SESSION_MAX; n++)
+        add(n, true);
+    PeerSessionTable_setPinned(&table, PeerSessionTable_find(&table, macOf(1)), true);
+
+    add(9, true);
+    TEST_ASSERT_NOT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(1)));
+    TEST_ASSERT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(2)));
+}
+
+void test_keyless_sender_cannot_evict_sessions(void) {
+    for (uint8_t n = 1; n <= PEER_SESSION_MAX; n++)
+        add(n, true);
+    TEST_ASSERT_EQUAL(PEER_SESSION_NONE, add(9, false));
+    TEST_ASSERT_EQUAL_UINT32(1, table.rejected);
+
+    // A keyless slot goes before an older keyed one
+    PeerSessionTable_remove(&table, PeerSessionTable_find(&table, macOf(4)));
+    add(5, false);
+    add(6, true);
+    TEST_ASSERT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(5)));
+    TEST_ASSERT_NOT_EQUAL(PEER_SESSION_NONE, PeerSessionTable_find(&table, macOf(1)));
+}
+
+// ============================================================================
+// Key Tests
+// ============================================================================
+
+void test_clear_keys_keeps_slots(void) {
+    int slot = add(1, true);
+    ReplayWindow_accept(&table.peers[slot].replay, 100, 0);
+    table.peers[slot].keys.valid = true;
+    table.peers[slot].linkCipher = true;
+    PeerSessionTable_clearKeys(&table);
+    TEST_ASSERT_EQUAL(slot, PeerSessionTable_find(&table, macOf(1)));
+    TEST_ASSERT_FALSE(table.peers[slot].keyed);
+    TEST_ASSERT_FALSE(table.peers[slot].linkCipher);
+    TEST_ASSERT_FALSE(table.peers[slot].keys.valid);
+    TEST_ASSERT_FALSE(table.peers[slot].replay.haveSeq);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Lookup Tests
+    RUN_TEST(test_empty_table_finds_nothing);
+    RUN_TEST(test_acquire_then_find);
+    RUN_TEST(test_remove_keeps_other_lookups);
+
+    // Eviction Tests
+    RUN_TEST(test_full_table_evicts_least_recent);
+    RUN_TEST(test_pinned_slot_never_evicted);
+    RUN_TEST(test_keyless_sender_cannot_evict_sessions);
+
+    // Key Tests
+    RUN_TEST(test_clear_keys_keeps_slots);
+
+    return UNITY_END();
+}
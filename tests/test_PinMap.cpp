@@ -0,0 +1,155 @@
+/**
+ * Unit Tests for PinMap
+ * Tests the GPIO / reserved pin tables, LEDC frequency-resolution limits,
+ * Q15 duty scaling and whole-profile validation
+ *
+ * @file test_PinMap.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "PinMap.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static PinMapProfile profile;
+static uint8_t badOutput;
+static int8_t badPin;
+
+void setUp(void) {
+    // Rover defaults
+    profile = (PinMapProfile){2, {{26, 27, 14, 0, 0}, {25, 13, 12, 0, 0}}};
+    badOutput = 0xFF;
+    badPin = 0;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Pin Table Tests
+// ============================================================================
+
+void test_output_capable_pins(void) {
+    TEST_ASSERT_TRUE(PinMap_isOutput(0));
+    TEST_ASSERT_TRUE(PinMap_isOutput(33));
+    TEST_ASSERT_FALSE(PinMap_isOutput(34));     // Input only
+    TEST_ASSERT_FALSE(PinMap_isOutput(39));
+    TEST_ASSERT_FALSE(PinMap_isOutput(6));      // SPI flash
+    TEST_ASSERT_FALSE(PinMap_isOutput(11));
+    TEST_ASSERT_FALSE(PinMap_isOutput(20));     // Not bonded out
+    TEST_ASSERT_FALSE(PinMap_isOutput(-1));
+    TEST_ASSERT_FALSE(PinMap_isOutput(40));
+}
+
+void test_reserved_pins(void) {
+    TEST_ASSERT_EQUAL_STRING("gps", PinMap_reservedBy(16));
+    TEST_ASSERT_EQUAL_STRING("i2c", PinMap_reservedBy(22));
+    TEST_ASSERT_EQUAL_STRING("uart0", PinMap_reservedBy(1));
+    TEST_ASSERT_NULL(PinMap_reservedBy(26));
+}
+
+void test_pwm_limits(void) {
+    TEST_ASSERT_TRUE(PinMap_pwmFits(0, 0));             // Driver defaults
+    TEST_ASSERT_TRUE(PinMap_pwmFits(20000, 10));        // 20 kHz, 1024 steps
+    TEST_ASSERT_TRUE(PinMap_pwmFits(1000, 16));
+    TEST_ASSERT_FALSE(PinMap_pwmFits(20000, 12));       // 81.9 MHz
+    TEST_ASSERT_FALSE(PinMap_pwmFits(50, 17));
+}
+
+void test_pwm_max_resolution(void) {
+    TEST_ASSERT_EQUAL_UINT8(11, PinMap_pwmMaxResolution(20000));   // 4000 steps
+    TEST_ASSERT_EQUAL_UINT8(16, PinMap_pwmMaxResolution(1000));    // Capped
+    TEST_ASSERT_EQUAL_UINT8(16, PinMap_pwmMaxResolution(50));
+    TEST_ASSERT_EQUAL_UINT8(1, PinMap_pwmMaxResolution(40000000));
+    TEST_ASSERT_EQUAL_UINT8(0, PinMap_pwmMaxResolution(50000000));
+    TEST_ASSERT_EQUAL_UINT8(0, PinMap_pwmMaxResolution(0));
+    // Every result fits, one more bit does not
+    for (uint32_t f = 1250; f <= 10000000; f = f * 3 / 2) {
+        uint8_t bits = PinMap_pwmMaxResolution(f);
+        TEST_ASSERT_TRUE(PinMap_pwmFits(f, bits));
+        if (bits < PINMAP_MAX_RESOLUTION) TEST_ASSERT_FALSE(PinMap_pwmFits(f, bits + 1));
+    }
+}
+
+void test_duty_from_q15(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, PinMap_dutyFromQ15(0, 11));
+    TEST_ASSERT_EQUAL_UINT32(1024, PinMap_dutyFromQ15(PINMAP_Q15_ONE / 2, 11));
+    TEST_ASSERT_EQUAL_UINT32(2048, PinMap_dutyFromQ15(PINMAP_Q15_ONE, 11));    // Always high
+    TEST_ASSERT_EQUAL_UINT32(65536, PinMap_dutyFromQ15(0xFFFF, 16));           // Clamped
+    TEST_ASSERT_EQUAL_UINT32(1, PinMap_dutyFromQ15(64, 8));                    // 0.5 tick rounds up
+    TEST_ASSERT_EQUAL_UINT32(0, PinMap_dutyFromQ15(63, 8));
+}
+
+// ============================================================================
+// Profile Tests
+// ============================================================================
+
+void test_default_profile_valid(void) {
+    TEST_ASSERT_EQUAL(PINMAP_OK, PinMap_validate(&profile, &badOutput, &badPin));
+    TEST_ASSERT_EQUAL(-1, badPin);
+}
+
+void test_input_only_direction_pin_rejected(void) {
+    profile.outputs[1].dir2 = 35;
+    TEST_ASSERT_EQUAL(PINMAP_NOT_OUTPUT, PinMap_validate(&profile, &badOutput, &badPin));
+    TEST_ASSERT_EQUAL(1, badOutput);
+    TEST_ASSERT_EQUAL(35, badPin);
+}
+
+void test_reserved_pin_rejected(void) {
+    profile.outputs[0].pin = 17;
+    TEST_ASSERT_EQUAL(PINMAP_RESERVED, PinMap_validate(&profile, &badOutput, &badPin));
+    TEST_ASSERT_EQUAL(0, badOutput);
+    TEST_ASSERT_EQUAL(17, badPin);
+}
+
+void test_duplicate_across_outputs_rejected(void) {
+    profile.outputs[1].dir1 = 27;
+    TEST_ASSERT_EQUAL(PINMAP_DUPLICATE, PinMap_validate(&profile, &badOutput, &badPin));
+    TEST_ASSERT_EQUAL(1, badOutput);
+    TEST_ASSERT_EQUAL(27, badPin);
+}
+
+void test_unfitted_output_and_servo_accepted(void) {
+    profile.outputs[0] = (PinMapOutput){-1, 35, 35, 0, 0};     // Ignored
+    profile.outputs[1] = (PinMapOutput){25, -1, -1, 16, 50};    // Servo
+    TEST_ASSERT_EQUAL(PINMAP_OK, PinMap_validate(&profile, &badOutput, &badPin));
+}
+
+void test_bad_pwm_and_count_rejected(void) {
+    profile.outputs[1].frequency = 40000;
+    profile.outputs[1].resolution = 12;
+    TEST_ASSERT_EQUAL(PINMAP_BAD_PWM, PinMap_validate(&profile, &badOutput, &badPin));
+    TEST_ASSERT_EQUAL(1, badOutput);
+    TEST_ASSERT_EQUAL(-1, badPin);
+
+    profile.count = PINMAP_MAX_OUTPUTS + 1;
+    TEST_ASSERT_EQUAL(PINMAP_BAD_COUNT, PinMap_validate(&profile, &badOutput, &badPin));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Pin Table Tests
+    RUN_TEST(test_output_capable_pins);
+    RUN_TEST(test_reserved_pins);
+    RUN_TEST(test_pwm_limits);
+    RUN_TEST(test_pwm_max_resolution);
+    RUN_TEST(test_duty_from_q15);
+
+    // Profile Tests
+    RUN_TEST(test_default_profile_valid);
+    RUN_TEST(test_input_only_direction_pin_rejected);
+    RUN_TEST(test_reserved_pin_rejected);
+    RUN_TEST(test_duplicate_across_outputs_rejected);
+    RUN_TEST(test_unfitted_output_and_servo_accepted);
+    RUN_TEST(test_bad_pwm_and_count_rejected);
+
+    return UNITY_END();
+}
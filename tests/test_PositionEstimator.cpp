@@ -0,0 +1,248 @@
+/**
+ * Unit Tests for PositionEstimator
+ * Tests GPS initialization and convergence, coasting between fixes,
+ * heading alignment from GPS course, innovation gating and health,
+ * and velocity aiding (odometry) through a GPS outage
+ *
+ * @file test_PositionEstimator.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "PositionEstimator.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define TICK_S 0.02f            // 50 Hz control loop
+
+static PositionEstimator est;
+static const float still[3] = {0.0f, 0.0f, 0.0f};
+
+static PositionGPSInput fixAt(float east, float north) {
+    PositionGPSInput gps;
+    memset(&gps, 0, sizeof(gps));
+    gps.position.east = east;
+    gps.position.north = north;
+    gps.hAcc = 2.0f;
+    gps.sAcc = 0.3f;
+    return gps;
+}
+
+static void coast(const float accel[3], float seconds) {
+    for (float t = 0.0f; t < seconds - 0.001f; t += TICK_S) {
+        PositionEstimator_predict(&est, accel, TICK_S);
+    }
+}
+
+void setUp(void) {
+    PositionEstimator_init(&est);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// GPS Tests
+// ============================================================================
+
+void test_first_fix_initializes(void) {
+    TEST_ASSERT_FALSE(PositionEstimator_isHealthy(&est));
+    PositionGPSInput gps = fixAt(12.0f, -4.0f);
+    TEST_ASSERT_EQUAL_UINT8(4, PositionEstimator_updateGPS(&est, &gps));
+
+    NavVector p = PositionEstimator_getPosition(&est);
+    TEST_ASSERT_EQUAL_FLOAT(12.0f, p.east);
+    TEST_ASSERT_EQUAL_FLOAT(-4.0f, p.north);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0f, PositionEstimator_getPositionSigma(&est));
+    TEST_ASSERT_TRUE(PositionEstimator_isHealthy(&est));
+}
+
+void test_repeated_fixes_shrink_uncertainty(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    for (int i = 0; i < 50; i++) {
+        PositionEstimator_updateGPS(&est, &gps);
+        coast(still, 0.1f);
+    }
+    TEST_ASSERT_TRUE(PositionEstimator_getPositionSigma(&est) < 1.0f);
+    TEST_ASSERT_EQUAL_UINT32(0, est.rejected);
+}
+
+void test_rtk_fix_lowers_sigma_floor(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    gps.hAcc = 0.014f;
+    PositionEstimator_updateGPS(&est, &gps);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, POS_EST_MIN_POS_SIGMA, PositionEstimator_getPositionSigma(&est));
+
+    PositionEstimator_init(&est);
+    gps.rtkFixed = true;
+    PositionEstimator_updateGPS(&est, &gps);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, POS_EST_RTK_MIN_POS_SIGMA, PositionEstimator_getPositionSigma(&est));
+}
+
+void test_coasts_on_velocity_between_fixes(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    gps.velE = 2.0f;
+    PositionEstimator_updateGPS(&est, &gps);
+    coast(still, 1.0f);
+
+    NavVector p = PositionEstimator_getPosition(&est);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 2.0f, p.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, p.north);
+}
+
+void test_outlier_is_gated(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    for (int i = 0; i < 20; i++) {
+        PositionEstimator_updateGPS(&est, &gps);
+        coast(still, 0.1f);
+    }
+
+    PositionGPSInput jump = fixAt(100.0f, 0.0f);
+    PositionEstimator_updateGPS(&est, &jump);
+    TEST_ASSERT_TRUE(est.rejected >= 1);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, PositionEstimator_getPosition(&est).east);
+}
+
+void test_persistent_offset_resets_to_gps(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    for (int i = 0; i < 20; i++) {
+        PositionEstimator_updateGPS(&est, &gps);
+        coast(still, 0.1f);
+    }
+
+    PositionGPSInput moved = fixAt(100.0f, 0.0f);
+    for (int i = 0; i < 10; i++) {
+        PositionEstimator_updateGPS(&est, &moved);
+        coast(still, 0.1f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 100.0f, PositionEstimator_getPosition(&est).east);
+}
+
+void test_unhealthy_after_long_outage(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    PositionEstimator_updateGPS(&est, &gps);
+    TEST_ASSERT_TRUE(PositionEstimator_isHealthy(&est));
+
+    coast(still, 30.0f);
+    TEST_ASSERT_FALSE(PositionEstimator_isHealthy(&est));
+}
+
+// ============================================================================
+// Heading Tests
+// ============================================================================
+
+void test_first_course_aligns_heading(void) {
+    TEST_ASSERT_FALSE(est.headingAligned);
+    TEST_ASSERT_TRUE(PositionEstimator_updateHeading(&est, 10.0f, 100.0f, 5.0f));
+    TEST_ASSERT_TRUE(est.headingAligned);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, PositionEstimator_getHeading(&est, 10.0f));
+    // Follows the gyro from there
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, PositionEstimator_getHeading(&est, -80.0f));
+}
+
+void test_acceleration_rotated_by_heading(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    PositionEstimator_updateGPS(&est, &gps);
+
+    // Accel is ignored until the heading offset is known
+    const float forward[3] = {1.0f, 0.0f, 0.0f};
+    coast(forward, 0.5f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, est.x[POS_EST_VE]);
+
+    // Attitude x axis points east
+    PositionEstimator_updateHeading(&est, 0.0f, 90.0f, 2.0f);
+    coast(forward, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1.0f, est.x[POS_EST_VE]);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, est.x[POS_EST_VN]);
+}
+
+void test_heading_update_wraps(void) {
+    PositionEstimator_updateHeading(&est, 0.0f, 359.0f, 5.0f);
+    TEST_ASSERT_TRUE(PositionEstimator_updateHeading(&est, 0.0f, 1.0f, 5.0f));
+    float heading = PositionEstimator_getHeading(&est, 0.0f);
+    TEST_ASSERT_TRUE(heading > 359.0f || heading < 1.0f);
+}
+
+// ============================================================================
+// Velocity Aiding Tests
+// ============================================================================
+
+void test_velocity_aiding_through_outage(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, PositionEstimator_updateVelocity(&est, 1.0f, 0.0f, 0.1f));
+
+    // Driving east at 1 m/s with GPS
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    gps.velE = 1.0f;
+    for (int i = 0; i < 20; i++) {
+        gps.position.east = 0.1f * i;
+        PositionEstimator_updateGPS(&est, &gps);
+        coast(still, 0.1f);
+    }
+
+    // Then 10 s under trees at 1 m/s east, wheel speed every tick
+    for (int i = 0; i < 500; i++) {
+        PositionEstimator_predict(&est, still, TICK_S);
+        TEST_ASSERT_EQUAL_UINT8(2, PositionEstimator_updateVelocity(&est, 1.0f, 0.0f, 0.1f));
+    }
+    NavVector p = PositionEstimator_getPosition(&est);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 12.0f, p.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, p.north);
+
+    // Uncertainty grows far slower than coasting without aiding
+    float aided = PositionEstimator_getPositionSigma(&est);
+    setUp();
+    for (int i = 0; i < 20; i++) {
+        gps.position.east = 0.1f * i;
+        PositionEstimator_updateGPS(&est, &gps);
+        coast(still, 0.1f);
+    }
+    coast(still, 10.0f);
+    TEST_ASSERT_TRUE(aided < 0.5f * PositionEstimator_getPositionSigma(&est));
+}
+
+// ============================================================================
+// Height Tests
+// ============================================================================
+
+void test_height_without_gps_vertical(void) {
+    PositionGPSInput gps = fixAt(0.0f, 0.0f);
+    TEST_ASSERT_FALSE(PositionEstimator_updateHeight(&est, -1.0f, 0.05f));
+
+    PositionEstimator_updateGPS(&est, &gps);
+    TEST_ASSERT_TRUE(PositionEstimator_updateHeight(&est, -1.5f, 0.05f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -1.5f, est.x[POS_EST_PU]);
+    TEST_ASSERT_TRUE(PositionEstimator_updateHeight(&est, -1.6f, 0.05f));
+    TEST_ASSERT_TRUE(est.x[POS_EST_PU] < -1.5f);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // GPS Tests
+    RUN_TEST(test_first_fix_initializes);
+    RUN_TEST(test_repeated_fixes_shrink_uncertainty);
+    RUN_TEST(test_rtk_fix_lowers_sigma_floor);
+    RUN_TEST(test_coasts_on_velocity_between_fixes);
+    RUN_TEST(test_outlier_is_gated);
+    RUN_TEST(test_persistent_offset_resets_to_gps);
+    RUN_TEST(test_unhealthy_after_long_outage);
+
+    // Heading Tests
+    RUN_TEST(test_first_course_aligns_heading);
+    RUN_TEST(test_acceleration_rotated_by_heading);
+    RUN_TEST(test_heading_update_wraps);
+
+    // Velocity Aiding Tests
+    RUN_TEST(test_velocity_aiding_through_outage);
+
+    // Height Tests
+    RUN_TEST(test_height_without_gps_vertical);
+
+    return UNITY_END();
+}
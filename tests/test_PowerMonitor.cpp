@@ -0,0 +1,167 @@
+/**
+ * Unit Tests for PowerMonitor
+ * Tests the sensor conversion, mAh / Wh integration, per-leg booking
+ * and the return budget
+ *
+ * @file test_PowerMonitor.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "PowerMonitor.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define STEP_MS 100     // BatteryManager block rate
+
+static PowerMonitor pm;
+static PowerConfig config;
+static uint32_t nowMs;
+
+static void run(float packMv, float amps, float speedMps, uint32_t durationMs) {
+    for (uint32_t t = 0; t < durationMs; t += STEP_MS) {
+        PowerMonitor_update(&pm, packMv, amps, speedMps, nowMs);
+        nowMs += STEP_MS;
+    }
+}
+
+void setUp(void) {
+    PowerMonitor_defaultConfig(&config);
+    config.capacityMah = 2000;
+    PowerMonitor_init(&pm, &config);
+    nowMs = 1000;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Conversion Tests
+// ============================================================================
+
+void test_amps_from_sensor_mv(void) {
+    // Hall sensor: 330 mV at 0 A, 40 mV per A
+    PowerConfig c = {330.0f, 25.0f, 0, 20, 1.3f};
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, PowerMonitor_ampsFromMv(&c, 330.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 10.0f, PowerMonitor_ampsFromMv(&c, 730.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, PowerMonitor_ampsFromMv(&c, 300.0f));   // Noise below 0 A
+}
+
+void test_sanitize(void) {
+    PowerConfig c = {-5.0f, -1.0f, 1000, 90, 0.5f};
+    PowerMonitor_sanitize(&c);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.offsetMv);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.ampsPerVolt);
+    TEST_ASSERT_EQUAL_UINT8(50, c.reservePercent);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, c.returnMargin);
+}
+
+// ============================================================================
+// Integration Tests
+// ============================================================================
+
+void test_integrates_mah_and_wh(void) {
+    // 10 A at 12 V for 36 s = 100 mAh, 1.2 Wh (first reading only primes)
+    run(12000.0f, 10.0f, 0.0f, 36000 + STEP_MS);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 100.0f, pm.mAh);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.2f, pm.wh);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 120.0f, pm.watts);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pm.meters);       // Standing still
+}
+
+void test_gap_is_not_integrated(void) {
+    run(12000.0f, 10.0f, 0.0f, 1000);
+    float before = pm.mAh;
+    nowMs += 5000;                                  // Task stalled
+    run(12000.0f, 10.0f, 0.0f, STEP_MS);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, before, pm.mAh);
+}
+
+void test_legs_book_their_own_energy(void) {
+    run(12000.0f, 0.0f, 0.0f, STEP_MS);             // Prime
+    PowerMonitor_startLeg(&pm, 3);
+    run(12000.0f, 10.0f, 5.0f, 10000);              // 50 m
+    PowerMonitor_startLeg(&pm, 4);
+    run(12000.0f, 20.0f, 10.0f, 10000);             // 100 m at twice the current
+    PowerMonitor_endLeg(&pm);
+    run(12000.0f, 20.0f, 10.0f, 10000);             // Booked to no leg
+
+    const PowerLeg* last = PowerMonitor_getLeg(&pm, 0);
+    const PowerLeg* first = PowerMonitor_getLeg(&pm, 1);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NULL(PowerMonitor_getLeg(&pm, 2));
+    TEST_ASSERT_EQUAL_UINT16(3, first->item);
+    TEST_ASSERT_EQUAL_UINT16(4, last->item);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 50.0f, first->meters);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 100.0f, last->meters);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 2.0f * first->mAh, last->mAh);
+    TEST_ASSERT_UINT_WITHIN(STEP_MS, 10000, last->ms);
+}
+
+void test_leg_ring_keeps_most_recent(void) {
+    for (uint16_t i = 0; i < POWER_MAX_LEGS + 3; i++) PowerMonitor_startLeg(&pm, i);
+    TEST_ASSERT_EQUAL_UINT16(POWER_MAX_LEGS + 2, PowerMonitor_getLeg(&pm, 0)->item);
+    TEST_ASSERT_EQUAL_UINT16(3, PowerMonitor_getLeg(&pm, POWER_MAX_LEGS - 1)->item);
+    TEST_ASSERT_NULL(PowerMonitor_getLeg(&pm, POWER_MAX_LEGS));
+}
+
+// ============================================================================
+// Return Budget Tests
+// ============================================================================
+
+void test_no_budget_before_travel(void) {
+    run(12000.0f, 10.0f, 5.0f, 10000);              // 50 m
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, PowerMonitor_mahPerMeter(&pm));
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 1e6f, nowMs));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, pm.returnMah);
+}
+
+void test_return_budget_triggers_after_hold(void) {
+    // 36 A at 10 m/s: 1 mAh per m; 1600 mAh usable (20 % reserve)
+    run(12000.0f, 36.0f, 10.0f, 100000);            // 1000 m, 1000 mAh
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 1.0f, PowerMonitor_mahPerMeter(&pm));
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, 600.0f, PowerMonitor_availableMah(&pm));
+
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 400.0f, nowMs));    // 520 mAh home
+    TEST_ASSERT_FLOAT_WITHIN(10.0f, 520.0f, pm.returnMah);
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 500.0f, nowMs));    // 650: short, holding
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 500.0f, nowMs + POWER_RTL_HOLD_MS - 1));
+    TEST_ASSERT_TRUE(PowerMonitor_checkReturn(&pm, 500.0f, nowMs + POWER_RTL_HOLD_MS));
+
+    // Latched while flying home
+    TEST_ASSERT_TRUE(PowerMonitor_checkReturn(&pm, 50.0f, nowMs + POWER_RTL_HOLD_MS + 100));
+}
+
+void test_short_blip_does_not_trigger(void) {
+    run(12000.0f, 36.0f, 10.0f, 100000);
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 500.0f, nowMs));
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 400.0f, nowMs + 1000));
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 500.0f, nowMs + 2000));
+    TEST_ASSERT_FALSE(PowerMonitor_checkReturn(&pm, 500.0f, nowMs + 4000));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Conversion Tests
+    RUN_TEST(test_amps_from_sensor_mv);
+    RUN_TEST(test_sanitize);
+
+    // Integration Tests
+    RUN_TEST(test_integrates_mah_and_wh);
+    RUN_TEST(test_gap_is_not_integrated);
+    RUN_TEST(test_legs_book_their_own_energy);
+    RUN_TEST(test_leg_ring_keeps_most_recent);
+
+    // Return Budget Tests
+    RUN_TEST(test_no_budget_before_travel);
+    RUN_TEST(test_return_budget_triggers_after_hold);
+    RUN_TEST(test_short_blip_does_not_trigger);
+
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+/**
+ * Unit Tests for PowerPolicy
+ * Tests the idle delay before ECO, waking on a busy tick or a control
+ * frame, wake latency accounting, ECO time and the config sanitizer
+ *
+ * @file test_PowerPolicy.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "PowerPolicy.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static PowerPolicy pp;
+static PowerPolicyConfig config;
+
+// Run idle ticks every 20 ms until ECO is applied; returns the time
+static uint32_t goEco(uint32_t t) {
+    while (PowerPolicy_update(&pp, &config, false, t) != POWER_MODE_ECO)
+        t += 20;
+    PowerPolicy_applied(&pp, POWER_MODE_ECO, t, (int64_t)t * 1000);
+    return t;
+}
+
+void setUp(void) {
+    PowerPolicy_defaultConfig(&config);
+    PowerPolicy_init(&pp, 0);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Mode Tests
+// ============================================================================
+
+void test_full_until_idle_delay(void) {
+    TEST_ASSERT_EQUAL(POWER_MODE_FULL, PowerPolicy_update(&pp, &config, false, 9999));
+    TEST_ASSERT_EQUAL(POWER_MODE_ECO, PowerPolicy_update(&pp, &config, false, 10000));
+}
+
+void test_busy_restarts_delay(void) {
+    PowerPolicy_update(&pp, &config, true, 5000);
+    TEST_ASSERT_EQUAL(POWER_MODE_FULL, PowerPolicy_update(&pp, &config, false, 14999));
+    TEST_ASSERT_EQUAL(POWER_MODE_ECO, PowerPolicy_update(&pp, &config, false, 15000));
+}
+
+void test_disabled_stays_full(void) {
+    config.enabled = 0;
+    TEST_ASSERT_EQUAL(POWER_MODE_FULL, PowerPolicy_update(&pp, &config, false, 100000));
+}
+
+void test_busy_wakes_eco(void) {
+    uint32_t t = goEco(0);
+    TEST_ASSERT_EQUAL(POWER_MODE_FULL, PowerPolicy_update(&pp, &config, true, t + 20));
+}
+
+// ============================================================================
+// Wake Tests
+// ============================================================================
+
+void test_frame_wakes_same_tick(void) {
+    uint32_t t = goEco(0);
+    int64_t arrived = (int64_t)(t + 15) * 1000;
+    PowerPolicy_frame(&pp, arrived);
+    TEST_ASSERT_EQUAL(POWER_MODE_FULL, PowerPolicy_update(&pp, &config, false, t + 20));
+    PowerPolicy_applied(&pp, POWER_MODE_FULL, t + 20, arrived + 6500);
+    TEST_ASSERT_EQUAL(1, pp.wakes);
+    TEST_ASSERT_EQUAL_UINT32(6500, pp.lastWakeUs);
+    TEST_ASSERT_EQUAL(0, pp.slowWakes);
+}
+
+void test_first_frame_of_wake_counts(void) {
+    uint32_t t = goEco(0);
+    int64_t first = (int64_t)t * 1000 + 1000;
+    PowerPolicy_frame(&pp, first);
+    PowerPolicy_frame(&pp, first + 5000);
+    PowerPolicy_update(&pp, &config, false, t + 20);
+    PowerPolicy_applied(&pp, POWER_MODE_FULL, t + 20, first + POWER_POLICY_WAKE_BOUND_US + 1);
+    TEST_ASSERT_EQUAL_UINT32(POWER_POLICY_WAKE_BOUND_US + 1, pp.maxWakeUs);
+    TEST_ASSERT_EQUAL(1, pp.slowWakes);
+}
+
+void test_frames_at_full_not_wakes(void) {
+    PowerPolicy_frame(&pp, 1000);
+    PowerPolicy_update(&pp, &config, false, 20);
+    TEST_ASSERT_EQUAL(0, pp.wakeFrameUs);
+    TEST_ASSERT_EQUAL(0, pp.wakes);
+}
+
+void test_frame_restarts_delay(void) {
+    PowerPolicy_frame(&pp, 9000000);
+    PowerPolicy_update(&pp, &config, false, 9000);
+    TEST_ASSERT_EQUAL(POWER_MODE_FULL, PowerPolicy_update(&pp, &config, false, 18999));
+}
+
+// ============================================================================
+// Accounting Tests
+// ============================================================================
+
+void test_eco_time(void) {
+    uint32_t t = goEco(0);
+    TEST_ASSERT_EQUAL(1, pp.ecoEntries);
+    TEST_ASSERT_EQUAL_UINT32(500, (uint32_t)PowerPolicy_ecoMs(&pp, t + 500));
+    PowerPolicy_update(&pp, &config, true, t + 1000);
+    PowerPolicy_applied(&pp, POWER_MODE_FULL, t + 1000, (int64_t)(t + 1000) * 1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, (uint32_t)PowerPolicy_ecoMs(&pp, t + 5000));
+    TEST_ASSERT_EQUAL(0, pp.wakes);     // Woken by a busy tick, not a frame
+}
+
+// ============================================================================
+// Config Tests
+// ============================================================================
+
+void test_sanitize(void) {
+    config.minMhz = 40;
+    config.idleDelayMs = 10;
+    config.lightSleep = 7;
+    PowerPolicy_sanitize(&config);
+    TEST_ASSERT_EQUAL(POWER_POLICY_MIN_MHZ, config.minMhz);
+    TEST_ASSERT_EQUAL(POWER_POLICY_IDLE_DELAY_MIN_MS, config.idleDelayMs);
+    TEST_ASSERT_EQUAL(1, config.lightSleep);
+    config.minMhz = 160;
+    config.idleDelayMs = 0xFFFFFFFF;
+    PowerPolicy_sanitize(&config);
+    TEST_ASSERT_EQUAL(160, config.minMhz);
+    TEST_ASSERT_EQUAL(POWER_POLICY_IDLE_DELAY_MAX_MS, config.idleDelayMs);
+}
+
+void test_mode_names(void) {
+    TEST_ASSERT_EQUAL_STRING("full", PowerPolicy_modeName(POWER_MODE_FULL));
+    TEST_ASSERT_EQUAL_STRING("eco", PowerPolicy_modeName(POWER_MODE_ECO));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Mode Tests
+    RUN_TEST(test_full_until_idle_delay);
+    RUN_TEST(test_busy_restarts_delay);
+    RUN_TEST(test_disabled_stays_full);
+    RUN_TEST(test_busy_wakes_eco);
+
+    // Wake Tests
+    RUN_TEST(test_frame_wakes_same_tick);
+    RUN_TEST(test_first_frame_of_wake_counts);
+    RUN_TEST(test_frames_at_full_not_wakes);
+    RUN_TEST(test_frame_restarts_delay);
+
+    // Accounting Tests
+    RUN_TEST(test_eco_time);
+
+    // Config Tests
+    RUN_TEST(test_sanitize);
+    RUN_TEST(test_mode_names);
+
+    return UNITY_END();
+}
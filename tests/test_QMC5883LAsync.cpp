@@ -0,0 +1,74 @@
+/**
+ * Unit Tests for QMC5883LAsync
+ * Tests decoding of the 7-byte reading: byte order, sign, scale and the
+ * overflow flag
+ *
+ * @file test_QMC5883LAsync.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "drivers/QMC5883LAsync.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static void encode(int16_t x, int16_t y, int16_t z, uint8_t status, uint8_t* raw) {
+    int16_t v[3] = {x, y, z};
+    for (int axis = 0; axis < 3; axis++) {
+        raw[axis * 2] = (uint8_t)((uint16_t)v[axis] & 0xFF);
+        raw[axis * 2 + 1] = (uint8_t)((uint16_t)v[axis] >> 8);
+    }
+    raw[6] = status;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Decode Tests
+// ============================================================================
+
+void test_little_endian_axes(void) {
+    uint8_t raw[7];
+    float field[3];
+    encode(3000, -1500, 300, 0x01, raw);        // DRDY set, ignored
+    TEST_ASSERT_EQUAL(QMC5883LAsync::STATUS_OK, QMC5883LAsync::parse(raw, field));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, field[0]);     // 3000 LSB = 1 G = 100 uT
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -50.0f, field[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, field[2]);
+}
+
+void test_full_range(void) {
+    uint8_t raw[7];
+    float field[3];
+    encode(32767, -32768, 0, 0x00, raw);
+    QMC5883LAsync::parse(raw, field);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1092.2f, field[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, -1092.3f, field[1]);
+}
+
+void test_overflow_rejected(void) {
+    uint8_t raw[7];
+    float field[3] = {1.0f, 2.0f, 3.0f};
+    encode(100, 100, 100, 0x02, raw);
+    TEST_ASSERT_EQUAL(QMC5883LAsync::STATUS_OVERFLOW, QMC5883LAsync::parse(raw, field));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, field[0]);    // Untouched
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Decode Tests
+    RUN_TEST(test_little_endian_axes);
+    RUN_TEST(test_full_range);
+    RUN_TEST(test_overflow_rejected);
+
+    return UNITY_END();
+}
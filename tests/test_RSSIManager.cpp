@@ -0,0 +1,105 @@
+/**
+ * Unit Tests for RSSIManager link quality
+ * Tests windowed RSSI and sequence-gap packet loss accounting
+ *
+ * @file test_RSSIManager.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "RSSIManager.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// RSSI Window Tests
+// ============================================================================
+
+void test_average_rssi_over_window(void) {
+    RSSIManager rm;
+    for (uint32_t i = 0; i < RSSI_WINDOW_SIZE; i++) {
+        rm.recordFrame(i % 2 ? -50 : -70, i);
+    }
+    TEST_ASSERT_EQUAL_INT(-60, rm.getAverageRSSI_dBm());
+    TEST_ASSERT_EQUAL_INT(-50, rm.getRSSI_dBm());
+}
+
+void test_old_samples_leave_window(void) {
+    RSSIManager rm;
+    uint32_t seq = 0;
+    for (int i = 0; i < RSSI_WINDOW_SIZE; i++) rm.recordFrame(-90, seq++);
+    for (int i = 0; i < RSSI_WINDOW_SIZE; i++) rm.recordFrame(-40, seq++);
+    TEST_ASSERT_EQUAL_INT(-40, rm.getAverageRSSI_dBm());
+}
+
+// ============================================================================
+// Packet Loss Tests
+// ============================================================================
+
+void test_no_gaps_no_loss(void) {
+    RSSIManager rm;
+    for (uint32_t seq = 1; seq <= LINK_LOSS_WINDOW * 2; seq++) {
+        rm.recordFrame(-60, seq);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, rm.getPacketLossPercent());
+    TEST_ASSERT_EQUAL_UINT32(0, rm.getLinkStats().lost);
+}
+
+void test_every_other_frame_lost(void) {
+    RSSIManager rm;
+    for (uint32_t seq = 0; seq < LINK_LOSS_WINDOW * 4; seq += 2) {
+        rm.recordFrame(-60, seq);
+    }
+    TEST_ASSERT_EQUAL_UINT8(50, rm.getPacketLossPercent());
+    TEST_ASSERT_TRUE(rm.getLinkQuality() < 50);
+}
+
+void test_duplicate_and_late_frames(void) {
+    RSSIManager rm;
+    rm.recordFrame(-60, 10);
+    rm.recordFrame(-60, 12);    // 11 counted lost
+    rm.recordFrame(-60, 12);    // duplicate
+    rm.recordFrame(-60, 11);    // late: no longer lost
+
+    LinkStats stats = rm.getLinkStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.late);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.received);
+}
+
+void test_sender_restart_is_not_loss(void) {
+    RSSIManager rm;
+    rm.recordFrame(-60, 50000);
+    rm.recordFrame(-60, 1);     // Controller rebooted
+
+    LinkStats stats = rm.getLinkStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.resyncs);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // RSSI Window Tests
+    RUN_TEST(test_average_rssi_over_window);
+    RUN_TEST(test_old_samples_leave_window);
+
+    // Packet Loss Tests
+    RUN_TEST(test_no_gaps_no_loss);
+    RUN_TEST(test_every_other_frame_lost);
+    RUN_TEST(test_duplicate_and_late_frames);
+    RUN_TEST(test_sender_restart_is_not_loss);
+
+    return UNITY_END();
+}
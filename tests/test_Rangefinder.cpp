@@ -0,0 +1,131 @@
+/**
+ * Unit Tests for Rangefinder
+ * Tests echo timing to range, the median filter against single spikes
+ * and the slow-down / stop envelope
+ *
+ * @file test_Rangefinder.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "Rangefinder.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static RangeFilter filter;
+static RangeEnvelope env;
+
+void setUp(void) {
+    RangeFilter_init(&filter);
+    RangeEnvelope_defaults(&env);
+    env.slowM = 2.0f;
+    env.stopM = 0.5f;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Echo Tests
+// ============================================================================
+
+void test_echo_to_meters(void) {
+    // 1 m and back at 343 m/s
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, Rangefinder_echoToMeters(5831));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.1715f, Rangefinder_echoToMeters(1000));
+}
+
+void test_no_echo_reads_clear(void) {
+    TEST_ASSERT_EQUAL_FLOAT(RANGE_MAX_M, Rangefinder_echoToMeters(0));
+    TEST_ASSERT_EQUAL_FLOAT(RANGE_MAX_M, Rangefinder_echoToMeters(RANGE_ECHO_TIMEOUT_US));
+    TEST_ASSERT_EQUAL_FLOAT(RANGE_MAX_M, Rangefinder_echoToMeters(RANGE_ECHO_TIMEOUT_US - 1));
+}
+
+// ============================================================================
+// Filter Tests
+// ============================================================================
+
+void test_filter_starts_clear_and_takes_first_reading(void) {
+    TEST_ASSERT_EQUAL_FLOAT(RANGE_MAX_M, filter.range);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, RangeFilter_add(&filter, 1.5f));
+}
+
+void test_filter_rejects_single_spike(void) {
+    RangeFilter_add(&filter, 1.5f);
+    RangeFilter_add(&filter, 1.5f);
+    // Crosstalk: one short echo does not stop the vehicle ...
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, RangeFilter_add(&filter, 0.1f));
+    // ... and one missed echo does not hide the wall
+    RangeFilter_add(&filter, 1.4f);
+    TEST_ASSERT_EQUAL_FLOAT(1.4f, RangeFilter_add(&filter, RANGE_MAX_M));
+    TEST_ASSERT_EQUAL(1, filter.noEcho);
+}
+
+void test_filter_follows_approach(void) {
+    float r = 0.0f;
+    for (int i = 0; i < 10; i++) r = RangeFilter_add(&filter, 3.0f - i * 0.25f);
+    // Median of the last three: one reading behind
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, r);
+    TEST_ASSERT_EQUAL(10, filter.samples);
+}
+
+void test_filter_clamps_ring_down(void) {
+    TEST_ASSERT_EQUAL_FLOAT(RANGE_MIN_M, RangeFilter_add(&filter, 0.0f));
+}
+
+// ============================================================================
+// Envelope Tests
+// ============================================================================
+
+void test_envelope_scale(void) {
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, Rangefinder_speedScale(&env, RANGE_MAX_M));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, Rangefinder_speedScale(&env, 2.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, Rangefinder_speedScale(&env, 1.25f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, Rangefinder_speedScale(&env, 0.5f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, Rangefinder_speedScale(&env, 0.1f));
+}
+
+void test_envelope_off_keeps_speed(void) {
+    env.enabled = false;
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, Rangefinder_speedScale(&env, 0.1f));
+}
+
+void test_envelope_sanitize(void) {
+    env.stopM = 3.0f;
+    env.slowM = 1.0f;   // Inside the stop distance
+    RangeEnvelope_sanitize(&env);
+    TEST_ASSERT_TRUE(env.slowM > env.stopM);
+    TEST_ASSERT_TRUE(env.slowM <= RANGE_MAX_M);
+
+    env.stopM = -1.0f;
+    env.slowM = 100.0f;
+    RangeEnvelope_sanitize(&env);
+    TEST_ASSERT_EQUAL_FLOAT(RANGE_MIN_M, env.stopM);
+    TEST_ASSERT_EQUAL_FLOAT(RANGE_MAX_M, env.slowM);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Echo Tests
+    RUN_TEST(test_echo_to_meters);
+    RUN_TEST(test_no_echo_reads_clear);
+
+    // Filter Tests
+    RUN_TEST(test_filter_starts_clear_and_takes_first_reading);
+    RUN_TEST(test_filter_rejects_single_spike);
+    RUN_TEST(test_filter_follows_approach);
+    RUN_TEST(test_filter_clamps_ring_down);
+
+    // Envelope Tests
+    RUN_TEST(test_envelope_scale);
+    RUN_TEST(test_envelope_off_keeps_speed);
+    RUN_TEST(test_envelope_sanitize);
+
+    return UNITY_END();
+}
@@ -0,0 +1,161 @@
+/**
+ * Unit Tests for RateController
+ * Tests P / feed-forward response, anti-windup, D filtering and gain swaps
+ *
+ * @file test_RateController.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "RateController.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DT 0.02f
+
+static RatePIDGains gains;
+static RatePIDState state;
+
+void setUp(void) {
+    RatePID_defaultGains(&gains, 1.0f, 0.5f, 0.0f);
+    gains.kff = 0.0f;
+    RatePIDState zero = {};
+    state = zero;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Proportional / Feed-Forward Tests
+// ============================================================================
+
+void test_proportional_on_error(void) {
+    float out = RatePID_update(&gains, &state, 0.5f, 0.2f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f, out);
+}
+
+void test_feed_forward_adds_setpoint(void) {
+    gains.kp = 0.0f;
+    gains.kff = 0.2f;
+    float out = RatePID_update(&gains, &state, 0.5f, 0.5f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.1f, out);
+}
+
+void test_output_clamped(void) {
+    gains.kp = 10.0f;
+    float out = RatePID_update(&gains, &state, 1.0f, 0.0f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, gains.outLimit, out);
+}
+
+// ============================================================================
+// Integrator Tests
+// ============================================================================
+
+void test_integral_clamped(void) {
+    gains.kp = 0.0f;
+    for (int i = 0; i < 1000; i++) RatePID_update(&gains, &state, 0.5f, 0.0f, DT, true);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, gains.iLimit, state.integral);
+}
+
+void test_integral_holds_when_saturated(void) {
+    gains.kp = 5.0f;    // P alone saturates
+    for (int i = 0; i < 100; i++) RatePID_update(&gains, &state, 1.0f, 0.0f, DT, true);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, state.integral);
+}
+
+void test_integral_holds_on_ground(void) {
+    for (int i = 0; i < 100; i++) RatePID_update(&gains, &state, 0.5f, 0.0f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, state.integral);
+}
+
+// ============================================================================
+// Derivative Tests
+// ============================================================================
+
+void test_derivative_opposes_motion_and_is_filtered(void) {
+    gains.kp = 0.0f;
+    gains.ki = 0.0f;
+    gains.kd = 0.01f;
+    RatePID_update(&gains, &state, 0.0f, 0.0f, DT, false);
+    float out = RatePID_update(&gains, &state, 0.0f, 0.1f, DT, false);
+    // Unfiltered D would be -kd * 0.1 / DT = -0.05
+    TEST_ASSERT_TRUE(out < 0.0f);
+    TEST_ASSERT_TRUE(out > -0.05f);
+}
+
+void test_no_derivative_kick_on_setpoint_step(void) {
+    gains.kp = 0.0f;
+    gains.ki = 0.0f;
+    gains.kd = 0.01f;
+    RatePID_update(&gains, &state, 0.0f, 0.0f, DT, false);
+    float out = RatePID_update(&gains, &state, 1.0f, 0.0f, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, out);
+}
+
+// ============================================================================
+// Controller Bank Tests
+// ============================================================================
+
+void test_bank_normalizes_rates(void) {
+    RateController rc;
+    RateController_init(&rc, 4.0f, 2.0f);
+    RatePID_defaultGains(&gains, 1.0f, 0.0f, 0.0f);
+    gains.kff = 0.0f;
+    for (uint8_t axis = 0; axis < RATE_AXIS_COUNT; axis++) RateController_setGains(&rc, axis, &gains);
+
+    const float command[3] = {0.5f, 0.5f, 0.5f};
+    const float rates[3] = {2.0f, 0.0f, 1.0f};  // Half of full-stick on roll and yaw
+    RateController_update(&rc, command, rates, DT, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, rc.output[RATE_AXIS_ROLL]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, rc.output[RATE_AXIS_PITCH]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, rc.output[RATE_AXIS_YAW]);
+}
+
+void test_gain_swap_keeps_integral(void) {
+    RateController rc;
+    RateController_init(&rc, 4.0f, 2.0f);
+    RateController_setGains(&rc, RATE_AXIS_ROLL, &gains);
+
+    const float command[3] = {0.2f, 0.0f, 0.0f};
+    const float rates[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 10; i++) RateController_update(&rc, command, rates, DT, true);
+    float integral = rc.state[RATE_AXIS_ROLL].integral;
+    TEST_ASSERT_TRUE(integral > 0.0f);
+
+    gains.kp = 2.0f;
+    RateController_setGains(&rc, RATE_AXIS_ROLL, &gains);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, integral, rc.state[RATE_AXIS_ROLL].integral);
+
+    RateController_reset(&rc);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, rc.state[RATE_AXIS_ROLL].integral);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Proportional / Feed-Forward Tests
+    RUN_TEST(test_proportional_on_error);
+    RUN_TEST(test_feed_forward_adds_setpoint);
+    RUN_TEST(test_output_clamped);
+
+    // Integrator Tests
+    RUN_TEST(test_integral_clamped);
+    RUN_TEST(test_integral_holds_when_saturated);
+    RUN_TEST(test_integral_holds_on_ground);
+
+    // Derivative Tests
+    RUN_TEST(test_derivative_opposes_motion_and_is_filtered);
+    RUN_TEST(test_no_derivative_kick_on_setpoint_step);
+
+    // Controller Bank Tests
+    RUN_TEST(test_bank_normalizes_rates);
+    RUN_TEST(test_gain_swap_keeps_integral);
+
+    return UNITY_END();
+}
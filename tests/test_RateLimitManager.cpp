@@ -7,6 +7,7 @@
  */
 
 #include <unity.h>
+#include <Arduino.h>
 #include "../RateLimitManager.h"
 
 // ============================================================================
@@ -204,6 +205,112 @@ void test_RateLimitManager_refill_prevents_sustained_dos(void) {
     TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, status2);
 }
 
+// ============================================================================
+// Per-Peer / Per-Class Tests
+// ============================================================================
+
+static const uint8_t PEER_A[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+static const uint8_t PEER_B[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x02};
+
+void test_RateLimitManager_noisy_peer_isolated(void) {
+    // Peer A floods control frames until its own bucket is empty
+    int allowed = 0;
+    for (int i = 0; i < RATE_LIMIT_CAPACITY; i++) {
+        if (RateLimitManager_check(PEER_A, RATE_CLASS_CONTROL) == RATE_LIMIT_ALLOWED) allowed++;
+    }
+    TEST_ASSERT_EQUAL(RATE_LIMIT_PEER_PER_SEC, allowed);
+
+    // The global budget it could not reach still serves peer B
+    TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_check(PEER_B, RATE_CLASS_CONTROL));
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMIT_CAPACITY - RATE_LIMIT_PEER_PER_SEC - 1,
+                            RateLimitManager_getTokens());
+
+    RateLimitStats stats = RateLimitManager_getStats();
+    TEST_ASSERT_EQUAL_UINT32(RATE_LIMIT_CAPACITY - RATE_LIMIT_PEER_PER_SEC, stats.peerBlocked);
+    TEST_ASSERT_EQUAL_UINT8(2, stats.bucketsUsed);
+}
+
+void test_RateLimitManager_command_class_does_not_starve_control(void) {
+    // Serial command flood from the host link (NULL peer)
+    int allowed = 0;
+    for (int i = 0; i < 40; i++) {
+        if (RateLimitManager_check(NULL, RATE_CLASS_COMMAND) == RATE_LIMIT_ALLOWED) allowed++;
+    }
+    TEST_ASSERT_EQUAL(20, allowed);
+    TEST_ASSERT_EQUAL_UINT32(20, RateLimitManager_getStats().classBlocked);
+
+    // Control class has its own bucket
+    TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_check(NULL, RATE_CLASS_CONTROL));
+}
+
+void test_RateLimitManager_command_limit_enforced(void) {
+    TEST_ASSERT_TRUE(RateLimitManager_setCommandLimit(5, 10));
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_checkCommand(5));
+    }
+    TEST_ASSERT_EQUAL(RATE_LIMIT_EXCEEDED, RateLimitManager_checkCommand(5));
+
+    // Other commands and a cleared limit are unaffected
+    TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_checkCommand(6));
+    TEST_ASSERT_TRUE(RateLimitManager_setCommandLimit(5, 0));
+    TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_checkCommand(5));
+}
+
+void test_RateLimitManager_buckets_allocated_on_use(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, RateLimitManager_getStats().bucketsUsed);
+
+    // Fill the table with busy peers (none has refilled, none reusable)
+    uint8_t mac[6] = {0x02, 0, 0, 0, 0, 0};
+    for (int i = 0; i < RATE_LIMIT_TABLE_SIZE; i++) {
+        mac[5] = (uint8_t)i;
+        TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_check(mac, RATE_CLASS_CONTROL));
+    }
+    TEST_ASSERT_EQUAL_UINT8(RATE_LIMIT_TABLE_SIZE, RateLimitManager_getStats().bucketsUsed);
+
+    // A new peer finds no slot; known peers are still found
+    mac[5] = 0xFF;
+    TEST_ASSERT_EQUAL(RATE_LIMIT_EXCEEDED, RateLimitManager_check(mac, RATE_CLASS_CONTROL));
+    mac[5] = 7;
+    TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_check(mac, RATE_CLASS_CONTROL));
+}
+
+// ============================================================================
+// Fractional Refill Tests
+// ============================================================================
+
+void test_RateLimitManager_set_rate_above_255(void) {
+    TEST_ASSERT_FALSE(RateLimitManager_setRate(0));
+    TEST_ASSERT_TRUE(RateLimitManager_setRate(500));
+    TEST_ASSERT_EQUAL_UINT16(500, RateLimitManager_getStats().capacity);
+
+    // Tokens are kept, not topped up to the new burst
+    TEST_ASSERT_EQUAL_UINT16(RATE_LIMIT_CAPACITY, RateLimitManager_getTokens());
+    for (int i = 0; i < RATE_LIMIT_CAPACITY; i++) RateLimitManager_checkCommand(0);
+    TEST_ASSERT_EQUAL(RATE_LIMIT_EXCEEDED, RateLimitManager_checkCommand(0));
+
+    // 20 ms at 500/s = 10 tokens (a 10 ms whole-token refill gave 2)
+    delay(20);
+    int allowed = 0;
+    for (int i = 0; i < 20; i++) {
+        if (RateLimitManager_checkCommand(0) == RATE_LIMIT_ALLOWED) allowed++;
+    }
+    TEST_ASSERT_INT_WITHIN(1, 10, allowed);
+}
+
+void test_RateLimitManager_sub_token_rate_accrues(void) {
+    // Handshake class: 2/s, burst 4
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_check(NULL, RATE_CLASS_HANDSHAKE));
+    }
+    TEST_ASSERT_EQUAL(RATE_LIMIT_EXCEEDED, RateLimitManager_check(NULL, RATE_CLASS_HANDSHAKE));
+
+    // Half a token is not enough, the second half completes it
+    delay(250);
+    TEST_ASSERT_EQUAL(RATE_LIMIT_EXCEEDED, RateLimitManager_check(NULL, RATE_CLASS_HANDSHAKE));
+    delay(260);
+    TEST_ASSERT_EQUAL(RATE_LIMIT_ALLOWED, RateLimitManager_check(NULL, RATE_CLASS_HANDSHAKE));
+}
+
 // ============================================================================
 // Test Suite Registration
 // ============================================================================
@@ -223,4 +330,10 @@ void test_group_rate_limiting_setup(void) {
     RUN_TEST(test_RateLimitManager_set_command_limit_invalid);
     RUN_TEST(test_RateLimitManager_simple_dos_attack);
     RUN_TEST(test_RateLimitManager_refill_prevents_sustained_dos);
+    RUN_TEST(test_RateLimitManager_noisy_peer_isolated);
+    RUN_TEST(test_RateLimitManager_command_class_does_not_starve_control);
+    RUN_TEST(test_RateLimitManager_command_limit_enforced);
+    RUN_TEST(test_RateLimitManager_buckets_allocated_on_use);
+    RUN_TEST(test_RateLimitManager_set_rate_above_255);
+    RUN_TEST(test_RateLimitManager_sub_token_rate_accrues);
 }
@@ -0,0 +1,176 @@
+/**
+ * Unit Tests for RateProfile
+ * Tests the per-vehicle table, inner / outer division, deferral of the
+ * outer loop after a deadline miss, its one-period bound and the miss
+ * accounting
+ *
+ * @file test_RateProfile.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "RateProfile.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static RateSchedule sched;
+static const RateProfile COPTER = {2, 10};
+
+// One tick of execUs; returns whether the outer loop ran
+static bool tick(uint32_t execUs) {
+    bool outer = RateSchedule_begin(&sched);
+    RateSchedule_end(&sched, outer, execUs);
+    return outer;
+}
+
+void setUp(void) {
+    RateSchedule_init(&sched, &COPTER);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Profile Tests
+// ============================================================================
+
+void test_copter_fast_inner_others_flat(void) {
+    const RateProfile* copter = RateProfile_forVehicle(3);
+    TEST_ASSERT_EQUAL_UINT8(2, copter->innerPeriodMs);
+    TEST_ASSERT_EQUAL_UINT8(10, copter->outerDiv);
+    for (uint8_t type = 0; type < RATE_PROFILE_COUNT; type++) {
+        const RateProfile* p = RateProfile_forVehicle(type);
+        // Outer loop at 50 Hz on every vehicle
+        TEST_ASSERT_EQUAL(20, p->innerPeriodMs * p->outerDiv);
+    }
+    const RateProfile* unknown = RateProfile_forVehicle(RATE_PROFILE_COUNT);
+    TEST_ASSERT_EQUAL_UINT8(20, unknown->innerPeriodMs);
+    TEST_ASSERT_EQUAL_UINT8(1, unknown->outerDiv);
+}
+
+void test_zero_fields_sanitized(void) {
+    RateProfile bad = {0, 0};
+    RateSchedule_init(&sched, &bad);
+    TEST_ASSERT_EQUAL_UINT32(1000, sched.innerPeriodUs);
+    TEST_ASSERT_TRUE(tick(0));
+    TEST_ASSERT_TRUE(tick(0));
+}
+
+// ============================================================================
+// Division Tests
+// ============================================================================
+
+void test_first_tick_outer_then_every_div(void) {
+    TEST_ASSERT_TRUE(RateSchedule_begin(&sched));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.020f, RateSchedule_outerDt(&sched));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.002f, RateSchedule_innerDt(&sched));
+    RateSchedule_end(&sched, true, 500);
+    int outer = 0;
+    for (int i = 0; i < 100; i++) {
+        bool ran = tick(500);
+        if (ran) outer++;
+        TEST_ASSERT_EQUAL(i % 10 == 9, ran);
+    }
+    TEST_ASSERT_EQUAL(10, outer);
+    TEST_ASSERT_EQUAL_UINT32(101, sched.ticks);
+    TEST_ASSERT_EQUAL_UINT32(11, sched.outerRuns);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.innerMisses + sched.outerMisses);
+}
+
+void test_flat_profile_outer_every_tick(void) {
+    const RateProfile* flat = RateProfile_forVehicle(0);
+    RateSchedule_init(&sched, flat);
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(RateSchedule_begin(&sched));
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.020f, RateSchedule_outerDt(&sched));
+        RateSchedule_end(&sched, true, 5000);
+    }
+}
+
+// ============================================================================
+// Deadline Tests
+// ============================================================================
+
+void test_miss_defers_outer_one_tick(void) {
+    tick(500);                              // Outer
+    for (int i = 0; i < 8; i++) tick(500);
+    tick(2500);                             // Inner miss right before outer is due
+    TEST_ASSERT_EQUAL_UINT32(1, sched.innerMisses);
+    TEST_ASSERT_FALSE(tick(500));           // Due, held back
+    TEST_ASSERT_EQUAL_UINT32(1, sched.outerDeferred);
+    TEST_ASSERT_TRUE(RateSchedule_begin(&sched));
+    // Covers the held-back tick too
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.022f, RateSchedule_outerDt(&sched));
+    RateSchedule_end(&sched, true, 500);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.outerForced);
+}
+
+void test_outer_forced_after_one_period(void) {
+    tick(500);                              // Outer
+    for (int i = 0; i < 8; i++) tick(500);
+    tick(2500);
+    // Every tick from here misses its deadline
+    int held = 0;
+    while (!tick(3000)) held++;
+    // Held back until a whole outer period late, never skipped for good
+    TEST_ASSERT_EQUAL(10, held);
+    TEST_ASSERT_EQUAL_UINT32(10, sched.outerDeferred);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.outerForced);
+    TEST_ASSERT_EQUAL_UINT32(11, sched.innerMisses);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.outerMisses);
+}
+
+void test_flat_profile_miss_holds_one_tick(void) {
+    RateSchedule_init(&sched, RateProfile_forVehicle(2));
+    TEST_ASSERT_TRUE(tick(25000));
+    TEST_ASSERT_FALSE(tick(1000));          // Inner only: catch up
+    TEST_ASSERT_TRUE(RateSchedule_begin(&sched));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.040f, RateSchedule_outerDt(&sched));
+    RateSchedule_end(&sched, true, 25000);
+    // Still overrunning: outer at half rate, inner every tick
+    TEST_ASSERT_FALSE(tick(1000));
+    TEST_ASSERT_TRUE(tick(1000));
+    TEST_ASSERT_EQUAL_UINT32(2, sched.outerForced);
+}
+
+void test_max_times_and_reset(void) {
+    tick(1500);
+    tick(700);
+    tick(300);
+    TEST_ASSERT_EQUAL_UINT32(1500, sched.maxOuterUs);
+    TEST_ASSERT_EQUAL_UINT32(700, sched.maxInnerUs);
+    RateSchedule_resetStats(&sched);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.ticks);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.maxOuterUs);
+    TEST_ASSERT_EQUAL_UINT32(0, sched.outerRuns);
+    // Phase kept: outer still due 10 ticks after the first
+    int n = 0;
+    while (!tick(100)) n++;
+    TEST_ASSERT_EQUAL(7, n);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Profile Tests
+    RUN_TEST(test_copter_fast_inner_others_flat);
+    RUN_TEST(test_zero_fields_sanitized);
+
+    // Division Tests
+    RUN_TEST(test_first_tick_outer_then_every_div);
+    RUN_TEST(test_flat_profile_outer_every_tick);
+
+    // Deadline Tests
+    RUN_TEST(test_miss_defers_outer_one_tick);
+    RUN_TEST(test_outer_forced_after_one_period);
+    RUN_TEST(test_flat_profile_miss_holds_one_tick);
+    RUN_TEST(test_max_times_and_reset);
+
+    return UNITY_END();
+}
@@ -0,0 +1,352 @@
+/**
+ * Unit Tests for RcInput
+ * Tests SBUS / CRSF framing (in place, split across reads, resync after
+ * noise and bad frames), channel and link statistics decoding and the
+ * mapping of channels onto sticks
+ *
+ * @file test_RcInput.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "RcInput.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static RcParser parser;
+static RcConfig config;
+static uint16_t channels[RC_MAX_CHANNELS];
+
+/**
+ * Feed a whole buffer, return the number of frames seen
+ */
+static int feed_all(const uint8_t* data, size_t len, RcFrame* last) {
+    int frames = 0;
+    size_t off = 0;
+    while (off < len) {
+        RcFrame f;
+        off += RcInput_feed(&parser, &data[off], len - off, &f);
+        if (f.payload) {
+            frames++;
+            if (last) *last = f;
+        }
+    }
+    return frames;
+}
+
+/**
+ * CRSF frame of any type
+ */
+static size_t build_crsf(uint8_t type, const uint8_t* payload, uint8_t len, uint8_t* out) {
+    out[0] = RC_CRSF_ADDR_FC;
+    out[1] = (uint8_t)(len + 2);
+    out[2] = type;
+    memcpy(&out[3], payload, len);
+    out[3 + len] = RcInput_crc8(&out[2], len + 1);
+    return len + 4;
+}
+
+static void all_channels(uint16_t ticks) {
+    for (uint8_t c = 0; c < RC_MAX_CHANNELS; c++) channels[c] = ticks;
+}
+
+void setUp(void) {
+    RcInput_init(&parser, RC_PROTOCOL_CRSF);
+    RcInput_defaultConfig(&config);
+    // Every channel different, full 11-bit range at the ends
+    for (uint8_t c = 0; c < RC_MAX_CHANNELS; c++) channels[c] = (uint16_t)(172 + c * 109);
+    channels[14] = 0;
+    channels[15] = 2047;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Framing Tests
+// ============================================================================
+
+void test_crc8_check_value(void) {
+    // CRC-8/DVB-S2 check value
+    TEST_ASSERT_EQUAL_HEX8(0xBC, RcInput_crc8((const uint8_t*)"123456789", 9));
+}
+
+void test_crsf_frame_in_one_read_is_not_copied(void) {
+    uint8_t buf[32];
+    size_t n = RcInput_buildChannels(RC_PROTOCOL_CRSF, channels, 0, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(26, n);
+    RcFrame f;
+    TEST_ASSERT_EQUAL(n, RcInput_feed(&parser, buf, n, &f));
+    TEST_ASSERT_EQUAL_PTR(&buf[3], f.payload);
+    TEST_ASSERT_EQUAL(RC_CRSF_TYPE_CHANNELS, f.type);
+    TEST_ASSERT_EQUAL(RC_CHANNELS_LEN, f.length);
+
+    RcChannels ch;
+    TEST_ASSERT_TRUE(RcInput_decodeChannels(&f, &ch));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, ch.channels, RC_MAX_CHANNELS);
+    TEST_ASSERT_EQUAL(0, ch.flags);
+    TEST_ASSERT_EQUAL(1, parser.frames);
+}
+
+void test_sbus_frame_in_one_read_is_not_copied(void) {
+    RcInput_init(&parser, RC_PROTOCOL_SBUS);
+    uint8_t buf[32];
+    size_t n = RcInput_buildChannels(RC_PROTOCOL_SBUS, channels, 0, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(RC_SBUS_FRAME_LEN, n);
+    RcFrame f;
+    TEST_ASSERT_EQUAL(n, RcInput_feed(&parser, buf, n, &f));
+    TEST_ASSERT_EQUAL_PTR(&buf[1], f.payload);
+
+    RcChannels ch;
+    TEST_ASSERT_TRUE(RcInput_decodeChannels(&f, &ch));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, ch.channels, RC_MAX_CHANNELS);
+    TEST_ASSERT_EQUAL(0, ch.flags);
+}
+
+void test_frames_split_across_reads(void) {
+    for (uint8_t p = 0; p < RC_PROTOCOL_COUNT; p++) {
+        uint8_t buf[32];
+        size_t n = RcInput_buildChannels((RcProtocol)p, channels, 0, buf, sizeof(buf));
+        // Every split point, including between address and length
+        for (size_t cut = 1; cut < n; cut++) {
+            RcInput_init(&parser, (RcProtocol)p);
+            RcFrame f;
+            TEST_ASSERT_EQUAL(cut, RcInput_feed(&parser, buf, cut, &f));
+            TEST_ASSERT_NULL(f.payload);
+            TEST_ASSERT_EQUAL(n - cut, RcInput_feed(&parser, &buf[cut], n - cut, &f));
+            TEST_ASSERT_NOT_NULL(f.payload);
+            RcChannels ch;
+            TEST_ASSERT_TRUE(RcInput_decodeChannels(&f, &ch));
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, ch.channels, RC_MAX_CHANNELS);
+        }
+    }
+}
+
+void test_several_frames_and_noise(void) {
+    uint8_t stream[128];
+    size_t n = 0;
+    // Noise holding both addresses, a bad length and a truncated header
+    const uint8_t noise[] = {0x00, 0xC8, 0x01, 0x55, 0xEE, 0x7F, 0x12};
+    memcpy(stream, noise, sizeof(noise));
+    n += sizeof(noise);
+    n += RcInput_buildChannels(RC_PROTOCOL_CRSF, channels, 0, &stream[n], sizeof(stream) - n);
+    stream[n++] = 0xAA;
+    n += RcInput_buildChannels(RC_PROTOCOL_CRSF, channels, 0, &stream[n], sizeof(stream) - n);
+
+    RcFrame last;
+    TEST_ASSERT_EQUAL(2, feed_all(stream, n, &last));
+    TEST_ASSERT_EQUAL(2, parser.badLength);
+
+    // Byte by byte gives the same frames
+    RcInput_init(&parser, RC_PROTOCOL_CRSF);
+    int frames = 0;
+    for (size_t i = 0; i < n; i++) {
+        RcFrame f;
+        TEST_ASSERT_EQUAL(1, RcInput_feed(&parser, &stream[i], 1, &f));
+        if (f.payload) frames++;
+    }
+    TEST_ASSERT_EQUAL(2, frames);
+}
+
+void test_bad_crc_resyncs(void) {
+    uint8_t stream[64];
+    size_t n = RcInput_buildChannels(RC_PROTOCOL_CRSF, channels, 0, stream, sizeof(stream));
+    stream[10] ^= 0x01;
+    n += RcInput_buildChannels(RC_PROTOCOL_CRSF, channels, 0, &stream[n], sizeof(stream) - n);
+
+    RcFrame last;
+    TEST_ASSERT_EQUAL(1, feed_all(stream, n, &last));
+    TEST_ASSERT_EQUAL(1, parser.crcErrors);
+    RcChannels ch;
+    TEST_ASSERT_TRUE(RcInput_decodeChannels(&last, &ch));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(channels, ch.channels, RC_MAX_CHANNELS);
+}
+
+void test_sbus_footer_and_flags(void) {
+    RcInput_init(&parser, RC_PROTOCOL_SBUS);
+    uint8_t buf[32];
+    size_t n = RcInput_buildChannels(RC_PROTOCOL_SBUS, channels,
+                                     RC_SBUS_FLAG_FRAME_LOST | RC_SBUS_FLAG_FAILSAFE | 0x03,
+                                     buf, sizeof(buf));
+    RcFrame f;
+    RcChannels ch;
+    TEST_ASSERT_EQUAL(1, feed_all(buf, n, &f));
+    TEST_ASSERT_TRUE(RcInput_decodeChannels(&f, &ch));
+    TEST_ASSERT_EQUAL(RC_FLAG_FRAME_LOST | RC_FLAG_FAILSAFE, ch.flags);
+
+    // SBUS2 telemetry slot footers are frames too
+    buf[24] = 0x24;
+    TEST_ASSERT_EQUAL(1, feed_all(buf, n, &f));
+    // Anything else is not
+    buf[24] = 0x55;
+    TEST_ASSERT_EQUAL(0, feed_all(buf, n, &f));
+    TEST_ASSERT_EQUAL(1, parser.crcErrors);
+}
+
+void test_decode_link_statistics(void) {
+    // Antennas at -72 / -65 dBm, LQ 98 %, SNR -3 dB
+    const uint8_t link[RC_CRSF_LINK_LEN] = {72, 65, 98, (uint8_t)-3, 1, 4, 3, 80, 100, 9};
+    uint8_t buf[32];
+    size_t n = build_crsf(RC_CRSF_TYPE_LINK, link, sizeof(link), buf);
+    RcFrame f;
+    TEST_ASSERT_EQUAL(1, feed_all(buf, n, &f));
+    RcLink out;
+    TEST_ASSERT_TRUE(RcInput_decodeLink(&f, &out));
+    TEST_ASSERT_EQUAL(-65, out.rssiDbm);
+    TEST_ASSERT_EQUAL(98, out.lq);
+    TEST_ASSERT_EQUAL(-3, out.snr);
+
+    RcChannels ch;
+    TEST_ASSERT_FALSE(RcInput_decodeChannels(&f, &ch));
+    n = RcInput_buildChannels(RC_PROTOCOL_CRSF, channels, 0, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(1, feed_all(buf, n, &f));
+    TEST_ASSERT_FALSE(RcInput_decodeLink(&f, &out));
+}
+
+void test_build_rejects_small_buffer(void) {
+    uint8_t buf[32];
+    TEST_ASSERT_EQUAL(0, RcInput_buildChannels(RC_PROTOCOL_SBUS, channels, 0, buf, 24));
+    TEST_ASSERT_EQUAL(0, RcInput_buildChannels(RC_PROTOCOL_CRSF, channels, 0, buf, 25));
+}
+
+// ============================================================================
+// Mapping Tests
+// ============================================================================
+
+void test_default_map_is_aetr(void) {
+    RcChannels ch;
+    memset(&ch, 0, sizeof(ch));
+    for (uint8_t c = 0; c < RC_MAX_CHANNELS; c++) ch.channels[c] = RC_TICKS_CENTER;
+    ch.channels[0] = RC_TICKS_MAX;      // Aileron right
+    ch.channels[1] = RC_TICKS_MIN;      // Elevator down
+    ch.channels[2] = RC_TICKS_MIN;      // Throttle closed
+    int16_t sticks[RC_AXES];
+    TEST_ASSERT_FALSE(RcInput_toSticks(&config, &ch, sticks));
+    TEST_ASSERT_EQUAL(0, sticks[0]);
+    TEST_ASSERT_EQUAL(1000, sticks[1]);
+    TEST_ASSERT_EQUAL(-1000, sticks[2]);
+    TEST_ASSERT_EQUAL(0, sticks[3]);
+
+    ch.channels[2] = RC_TICKS_MAX;
+    ch.channels[3] = (RC_TICKS_CENTER + RC_TICKS_MAX) / 2 + 1;
+    RcInput_toSticks(&config, &ch, sticks);
+    TEST_ASSERT_EQUAL(1000, sticks[0]);
+    TEST_ASSERT_INT_WITHIN(2, 500, sticks[3]);
+}
+
+void test_out_of_range_ticks_clamp(void) {
+    RcChannels ch;
+    memset(&ch, 0, sizeof(ch));
+    ch.channels[0] = 2047;
+    ch.channels[1] = 0;
+    ch.channels[2] = 2047;
+    ch.channels[3] = 0;
+    int16_t sticks[RC_AXES];
+    RcInput_toSticks(&config, &ch, sticks);
+    TEST_ASSERT_EQUAL(1000, sticks[0]);
+    TEST_ASSERT_EQUAL(1000, sticks[1]);
+    TEST_ASSERT_EQUAL(-1000, sticks[2]);
+    TEST_ASSERT_EQUAL(-1000, sticks[3]);
+}
+
+void test_reverse_and_centered_throttle(void) {
+    RcChannels ch;
+    memset(&ch, 0, sizeof(ch));
+    all_channels(RC_TICKS_MIN);
+    memcpy(ch.channels, channels, sizeof(channels));
+    int16_t sticks[RC_AXES];
+
+    config.reverse = 0x01 | 0x04;       // Throttle, pitch
+    RcInput_toSticks(&config, &ch, sticks);
+    TEST_ASSERT_EQUAL(1000, sticks[0]);
+    TEST_ASSERT_EQUAL(-1000, sticks[1]);
+    TEST_ASSERT_EQUAL(1000, sticks[2]);
+
+    config.reverse = 0;
+    config.throttleCentered = 1;
+    RcInput_toSticks(&config, &ch, sticks);
+    TEST_ASSERT_EQUAL(-1000, sticks[0]);
+    ch.channels[2] = RC_TICKS_CENTER;
+    RcInput_toSticks(&config, &ch, sticks);
+    TEST_ASSERT_EQUAL(0, sticks[0]);
+}
+
+void test_auto_switch_and_unmapped_axis(void) {
+    RcChannels ch;
+    memset(&ch, 0, sizeof(ch));
+    all_channels(RC_TICKS_MAX);
+    memcpy(ch.channels, channels, sizeof(channels));
+    int16_t sticks[RC_AXES];
+    TEST_ASSERT_TRUE(RcInput_toSticks(&config, &ch, sticks));
+    ch.channels[4] = RC_TICKS_CENTER;   // Middle of a 3-position switch
+    TEST_ASSERT_FALSE(RcInput_toSticks(&config, &ch, sticks));
+
+    config.autoChannel = RC_CHANNEL_NONE;
+    config.axes[3] = RC_CHANNEL_NONE;
+    ch.channels[4] = RC_TICKS_MAX;
+    TEST_ASSERT_FALSE(RcInput_toSticks(&config, &ch, sticks));
+    TEST_ASSERT_EQUAL(0, sticks[3]);
+}
+
+void test_sanitize(void) {
+    config.enabled = 7;
+    config.protocol = 9;
+    config.axes[0] = 16;
+    config.axes[1] = RC_CHANNEL_NONE;
+    config.reverse = 0xFF;
+    config.autoChannel = 40;
+    config.throttleCentered = 3;
+    config.telemetry = 2;
+    RcInput_sanitize(&config);
+    TEST_ASSERT_EQUAL(1, config.enabled);
+    TEST_ASSERT_EQUAL(RC_PROTOCOL_CRSF, config.protocol);
+    TEST_ASSERT_EQUAL(2, config.axes[0]);
+    TEST_ASSERT_EQUAL(RC_CHANNEL_NONE, config.axes[1]);
+    TEST_ASSERT_EQUAL(0x0F, config.reverse);
+    TEST_ASSERT_EQUAL(RC_CHANNEL_NONE, config.autoChannel);
+    TEST_ASSERT_EQUAL(1, config.throttleCentered);
+    TEST_ASSERT_EQUAL(1, config.telemetry);
+}
+
+void test_protocol_names(void) {
+    RcProtocol p;
+    TEST_ASSERT_TRUE(RcInput_parseProtocol("sbus", &p));
+    TEST_ASSERT_EQUAL(RC_PROTOCOL_SBUS, p);
+    TEST_ASSERT_TRUE(RcInput_parseProtocol("crsf", &p));
+    TEST_ASSERT_EQUAL(RC_PROTOCOL_CRSF, p);
+    TEST_ASSERT_FALSE(RcInput_parseProtocol("ppm", &p));
+    TEST_ASSERT_FALSE(RcInput_parseProtocol(NULL, &p));
+    TEST_ASSERT_EQUAL_STRING("crsf", RcInput_protocolName(RC_PROTOCOL_CRSF));
+    TEST_ASSERT_EQUAL_STRING("?", RcInput_protocolName(RC_PROTOCOL_COUNT));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Framing
+    RUN_TEST(test_crc8_check_value);
+    RUN_TEST(test_crsf_frame_in_one_read_is_not_copied);
+    RUN_TEST(test_sbus_frame_in_one_read_is_not_copied);
+    RUN_TEST(test_frames_split_across_reads);
+    RUN_TEST(test_several_frames_and_noise);
+    RUN_TEST(test_bad_crc_resyncs);
+    RUN_TEST(test_sbus_footer_and_flags);
+    RUN_TEST(test_decode_link_statistics);
+    RUN_TEST(test_build_rejects_small_buffer);
+
+    // Mapping
+    RUN_TEST(test_default_map_is_aetr);
+    RUN_TEST(test_out_of_range_ticks_clamp);
+    RUN_TEST(test_reverse_and_centered_throttle);
+    RUN_TEST(test_auto_switch_and_unmapped_axis);
+    RUN_TEST(test_sanitize);
+    RUN_TEST(test_protocol_names);
+
+    return UNITY_END();
+}
@@ -0,0 +1,122 @@
+/**
+ * Unit Tests for ReplayWindow
+ * Tests duplicate / stale rejection, loss and reorder accounting, resync
+ *
+ * @file test_ReplayWindow.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "ReplayWindow.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+ReplayWindow win;
+
+void setUp(void) {
+    ReplayWindow_init(&win);
+}
+
+void tearDown(void) {}
+
+// Check + accept, as the receive path does for an authenticated frame
+static ReplayStatus receive(uint32_t seq, uint32_t nowMs) {
+    ReplayStatus status = ReplayWindow_check(&win, seq, nowMs);
+    if (status == REPLAY_OK)
+        ReplayWindow_accept(&win, seq, nowMs);
+    return status;
+}
+
+// ============================================================================
+// Rejection Tests
+// ============================================================================
+
+void test_first_frame_accepted(void) {
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, receive(1000, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, win.stats.accepted);
+}
+
+void test_duplicate_rejected(void) {
+    receive(5, 10);
+    TEST_ASSERT_EQUAL_INT(REPLAY_DUPLICATE, receive(5, 20));
+    TEST_ASSERT_EQUAL_UINT32(1, win.stats.duplicates);
+}
+
+void test_frame_below_window_rejected(void) {
+    receive(200, 10);
+    TEST_ASSERT_EQUAL_INT(REPLAY_TOO_OLD, receive(200 - REPLAY_WINDOW_SIZE, 20));
+    TEST_ASSERT_EQUAL_UINT32(1, win.stats.tooOld);
+}
+
+void test_check_does_not_move_window(void) {
+    receive(10, 10);
+    // Forged frame that fails authentication: checked, never accepted
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, ReplayWindow_check(&win, 100000, 20));
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, receive(11, 30));
+    TEST_ASSERT_EQUAL_UINT32(0, win.stats.lost);
+}
+
+// ============================================================================
+// Accounting Tests
+// ============================================================================
+
+void test_gap_counts_lost(void) {
+    receive(1, 10);
+    receive(5, 20);
+    TEST_ASSERT_EQUAL_UINT32(3, win.stats.lost);
+}
+
+void test_late_frame_moves_lost_to_reordered(void) {
+    receive(1, 10);
+    receive(3, 20);
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, receive(2, 30));
+    TEST_ASSERT_EQUAL_UINT32(0, win.stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, win.stats.reordered);
+    TEST_ASSERT_EQUAL_INT(REPLAY_DUPLICATE, receive(2, 40));
+}
+
+void test_sequence_wraparound(void) {
+    receive(0xFFFFFFFEUL, 10);
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, receive(0xFFFFFFFFUL, 20));
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, receive(0, 30));
+    TEST_ASSERT_EQUAL_UINT32(0, win.stats.lost);
+}
+
+// ============================================================================
+// Resync Tests
+// ============================================================================
+
+void test_restart_rejected_until_resync(void) {
+    receive(5000, 10);
+    TEST_ASSERT_EQUAL_INT(REPLAY_TOO_OLD, receive(1, 100));
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, receive(2, 10 + REPLAY_RESYNC_MS));
+    TEST_ASSERT_EQUAL_UINT32(1, win.stats.resyncs);
+    TEST_ASSERT_EQUAL_INT(REPLAY_OK, receive(3, 20 + REPLAY_RESYNC_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, win.stats.lost);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Rejection Tests
+    RUN_TEST(test_first_frame_accepted);
+    RUN_TEST(test_duplicate_rejected);
+    RUN_TEST(test_frame_below_window_rejected);
+    RUN_TEST(test_check_does_not_move_window);
+
+    // Accounting Tests
+    RUN_TEST(test_gap_counts_lost);
+    RUN_TEST(test_late_frame_moves_lost_to_reordered);
+    RUN_TEST(test_sequence_wraparound);
+
+    // Resync Tests
+    RUN_TEST(test_restart_rejected_until_resync);
+
+    return UNITY_END();
+}
@@ -0,0 +1,126 @@
+/**
+ * Unit Tests for RpmFilter
+ * Tests eRPM conversion, removal of a motor's fundamental and harmonics
+ * with the rest of the band passed, notches that follow a changing RPM
+ * and the passthrough below the floor
+ *
+ * @file test_RpmFilter.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "RpmFilter.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define FS 1000.0f
+#define TWO_PI_F 6.28318531f
+
+static RpmFilter filter;
+static RpmFilterConfig config;
+
+// Peak on the x axis over the second half of n samples of a sine
+static float amplitudeThrough(float hz, int n) {
+    float peak = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float frame[3] = {sinf(TWO_PI_F * hz * (float)i / FS), 0.0f, 0.0f};
+        RpmFilter_applyBlock(&filter, frame, 1);
+        if (i >= n / 2 && fabsf(frame[0]) > peak) peak = fabsf(frame[0]);
+    }
+    return peak;
+}
+
+void setUp(void) {
+    RpmFilter_defaultConfig(&config);
+    config.enabled = true;
+    RpmFilter_init(&filter, &config, 4, FS);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void test_erpm_to_hz(void) {
+    // 14 poles = 7 pole pairs: 42000 eRPM = 6000 RPM = 100 Hz
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 100.0f, RpmFilter_erpmToHz(42000, 14));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, RpmFilter_erpmToHz(42000, 0));
+}
+
+void test_starts_as_passthrough(void) {
+    float frame[3] = {1.0f, -2.0f, 3.0f};
+    RpmFilter_applyBlock(&filter, frame, 1);
+    TEST_ASSERT_EQUAL_FLOAT(-2.0f, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(3, filter.notches[0].stages);
+}
+
+void test_removes_fundamental_and_harmonics(void) {
+    const float hz[4] = {110.0f, 120.0f, 130.0f, 140.0f};
+    RpmFilter_update(&filter, hz);
+    TEST_ASSERT_TRUE(amplitudeThrough(120.0f, 2000) < 0.02f);
+    TEST_ASSERT_TRUE(amplitudeThrough(260.0f, 2000) < 0.02f);     // 2nd of motor 3
+    TEST_ASSERT_TRUE(amplitudeThrough(330.0f, 2000) < 0.02f);     // 3rd of motor 2
+    TEST_ASSERT_TRUE(amplitudeThrough(30.0f, 2000) > 0.95f);      // Stick band
+}
+
+void test_follows_rpm(void) {
+    float hz[4] = {150.0f, 150.0f, 150.0f, 150.0f};
+    RpmFilter_update(&filter, hz);
+    TEST_ASSERT_TRUE(amplitudeThrough(150.0f, 2000) < 0.02f);
+    for (int m = 0; m < 4; m++) hz[m] = 200.0f;
+    RpmFilter_update(&filter, hz);
+    TEST_ASSERT_TRUE(amplitudeThrough(150.0f, 2000) > 0.7f);
+    TEST_ASSERT_TRUE(amplitudeThrough(200.0f, 2000) < 0.02f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 200.0f, filter.motorHz[3]);
+}
+
+void test_below_floor_and_above_nyquist_pass(void) {
+    const float hz[4] = {50.0f, 50.0f, 50.0f, 50.0f};    // 150 Hz 3rd harmonic only
+    RpmFilter_update(&filter, hz);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, filter.notches[0].coefs[0].b0);   // 50 Hz < 80 Hz
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.notches[0].coefs[0].a1);
+    TEST_ASSERT_TRUE(filter.notches[0].coefs[1].a1 != 0.0f);         // 100 Hz
+
+    const float fast[4] = {200.0f, 200.0f, 200.0f, 200.0f};          // 3rd = 600 Hz
+    RpmFilter_update(&filter, fast);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, filter.notches[0].coefs[2].b0);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.notches[0].coefs[2].a2);
+}
+
+void test_sanitize(void) {
+    RpmFilterConfig c = {true, 9, NAN, 100.0f, 13};
+    RpmFilter_sanitize(&c, FS);
+    TEST_ASSERT_EQUAL_UINT8(RPM_FILTER_MAX_HARMONICS, c.harmonics);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, c.minHz);
+    TEST_ASSERT_EQUAL_FLOAT(RPM_FILTER_MAX_Q, c.q);
+    TEST_ASSERT_EQUAL_UINT8(12, c.motorPoles);
+
+    c = (RpmFilterConfig){true, 0, 900.0f, 0.0f, 0};
+    RpmFilter_sanitize(&c, FS);
+    TEST_ASSERT_EQUAL_UINT8(1, c.harmonics);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 450.0f, c.minHz);
+    TEST_ASSERT_EQUAL_FLOAT(RPM_FILTER_MIN_Q, c.q);
+    TEST_ASSERT_EQUAL_UINT8(2, c.motorPoles);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_erpm_to_hz);
+    RUN_TEST(test_starts_as_passthrough);
+    RUN_TEST(test_removes_fundamental_and_harmonics);
+    RUN_TEST(test_follows_rpm);
+    RUN_TEST(test_below_floor_and_above_nyquist_pass);
+    RUN_TEST(test_sanitize);
+
+    return UNITY_END();
+}
@@ -0,0 +1,242 @@
+/**
+ * Unit Tests for RtcmRelay
+ * Tests CRC-24Q against a reference frame, framing out of a stream mixed
+ * with UBX, and fragment / reassembly round trips with loss and reorder
+ *
+ * @file test_RtcmRelay.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "RtcmRelay.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+// Message 1005 (base station position), from the RTCM 10403 examples
+static const uint8_t MSG_1005[] = {
+    0xD3, 0x00, 0x13, 0x3E, 0xD7, 0xD3, 0x02, 0x02, 0x98, 0x0E, 0xDE, 0xEF, 0x34,
+    0xB4, 0xBD, 0x62, 0xAC, 0x09, 0x41, 0x98, 0x6F, 0x33, 0x36, 0x0B, 0x98,
+};
+
+static RtcmFramer framer;
+static RtcmReassembler reasm;
+static uint8_t big[700];
+static size_t bigLen;
+
+/**
+ * Valid frame of payloadLen bytes (message 1077 header, then a pattern)
+ */
+static size_t makeFrame(uint8_t* out, uint16_t payloadLen, uint8_t fill) {
+    out[0] = RTCM_PREAMBLE;
+    out[1] = (uint8_t)(payloadLen >> 8);
+    out[2] = (uint8_t)payloadLen;
+    for (uint16_t i = 0; i < payloadLen; i++) out[3 + i] = (uint8_t)(fill + i * 7);
+    out[3] = 1077 >> 4;
+    out[4] = (uint8_t)((1077 & 0x0F) << 4);
+    uint32_t crc = Rtcm_crc24q(out, 3 + payloadLen);
+    out[3 + payloadLen] = (uint8_t)(crc >> 16);
+    out[4 + payloadLen] = (uint8_t)(crc >> 8);
+    out[5 + payloadLen] = (uint8_t)crc;
+    return 6 + payloadLen;
+}
+
+/**
+ * Offer fragment index of big to the reassembler
+ */
+static bool addFragment(uint8_t seq, uint8_t index, const uint8_t** frame, uint16_t* frameLen) {
+    size_t offset = (size_t)index * RTCM_FRAGMENT_DATA;
+    size_t n = bigLen - offset < RTCM_FRAGMENT_DATA ? bigLen - offset : RTCM_FRAGMENT_DATA;
+    return RtcmReassembler_add(&reasm, seq, index, RtcmRelay_fragmentCount(bigLen),
+                               big + offset, n, frame, frameLen);
+}
+
+void setUp(void) {
+    RtcmFramer_init(&framer);
+    RtcmReassembler_init(&reasm);
+    bigLen = makeFrame(big, 600, 0x11);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Frame Tests
+// ============================================================================
+
+void test_reference_frame(void) {
+    TEST_ASSERT_EQUAL_HEX32(0x360B98, Rtcm_crc24q(MSG_1005, sizeof(MSG_1005) - 3));
+    TEST_ASSERT_TRUE(Rtcm_frameValid(MSG_1005, sizeof(MSG_1005)));
+    TEST_ASSERT_EQUAL(1005, Rtcm_messageType(MSG_1005));
+    TEST_ASSERT_EQUAL(1077, Rtcm_messageType(big));
+}
+
+void test_frame_rejects_damage(void) {
+    uint8_t frame[sizeof(MSG_1005)];
+    memcpy(frame, MSG_1005, sizeof(frame));
+    frame[10] ^= 0x01;
+    TEST_ASSERT_FALSE(Rtcm_frameValid(frame, sizeof(frame)));
+    TEST_ASSERT_FALSE(Rtcm_frameValid(MSG_1005, sizeof(MSG_1005) - 1));
+    memcpy(frame, MSG_1005, sizeof(frame));
+    frame[1] |= 0x80;   // Reserved bits
+    TEST_ASSERT_FALSE(Rtcm_frameValid(frame, sizeof(frame)));
+}
+
+// ============================================================================
+// Framer Tests
+// ============================================================================
+
+void test_framer_finds_frames_between_ubx(void) {
+    // NAV-PVT-like noise carrying a false preamble, then two frames back to back
+    uint8_t stream[300];
+    size_t len = 0;
+    const uint8_t ubx[] = {0xB5, 0x62, 0x01, 0x07, 0xD3, 0x00, 0x40, 0x12, 0x34};
+    memcpy(stream + len, ubx, sizeof(ubx));
+    len += sizeof(ubx);
+    memcpy(stream + len, MSG_1005, sizeof(MSG_1005));
+    len += sizeof(MSG_1005);
+    len += makeFrame(stream + len, 100, 0x40);
+
+    int found = 0;
+    uint16_t lens[2] = {0, 0};
+    size_t off = 0;
+    while (off < len) {
+        const uint8_t* frame;
+        uint16_t frameLen;
+        off += RtcmFramer_feed(&framer, stream + off, len - off, &frame, &frameLen);
+        if (frame) {
+            TEST_ASSERT_TRUE(Rtcm_frameValid(frame, frameLen));
+            if (found < 2) lens[found] = frameLen;
+            found++;
+        }
+    }
+    TEST_ASSERT_EQUAL(2, found);
+    TEST_ASSERT_EQUAL(sizeof(MSG_1005), lens[0]);
+    TEST_ASSERT_EQUAL(106, lens[1]);
+    TEST_ASSERT_EQUAL(2, framer.frames);
+}
+
+void test_framer_across_reads(void) {
+    const uint8_t* frame;
+    uint16_t frameLen;
+    size_t off = 0;
+    int found = 0;
+    while (off < bigLen) {
+        size_t chunk = bigLen - off < 64 ? bigLen - off : 64;
+        size_t used = RtcmFramer_feed(&framer, big + off, chunk, &frame, &frameLen);
+        off += used;
+        if (frame) {
+            found++;
+            TEST_ASSERT_EQUAL(bigLen, frameLen);
+            TEST_ASSERT_EQUAL_MEMORY(big, frame, bigLen);
+        }
+    }
+    TEST_ASSERT_EQUAL(1, found);
+}
+
+void test_framer_counts_crc_errors(void) {
+    uint8_t frame[sizeof(MSG_1005)];
+    memcpy(frame, MSG_1005, sizeof(frame));
+    frame[sizeof(frame) - 1] ^= 0xFF;
+    const uint8_t* out;
+    uint16_t outLen;
+    size_t used = RtcmFramer_feed(&framer, frame, sizeof(frame), &out, &outLen);
+    TEST_ASSERT_EQUAL(sizeof(frame), used);
+    TEST_ASSERT_NULL(out);
+    TEST_ASSERT_EQUAL(1, framer.crcErrors);
+
+    // Its own 0xD3 at byte 5 now claims 514 bytes: the good frame behind
+    // it comes out late, once that candidate has failed too, not never
+    uint8_t stream[sizeof(MSG_1005) + sizeof(big)];
+    memcpy(stream, MSG_1005, sizeof(MSG_1005));
+    memcpy(stream + sizeof(MSG_1005), big, bigLen);
+    size_t len = sizeof(MSG_1005) + bigLen;
+    size_t off = 0;
+    int found = 0;
+    while (off < len) {
+        off += RtcmFramer_feed(&framer, stream + off, len - off, &out, &outLen);
+        if (out && found++ == 0) TEST_ASSERT_EQUAL_MEMORY(MSG_1005, out, sizeof(MSG_1005));
+    }
+    TEST_ASSERT_EQUAL(2, found);
+}
+
+// ============================================================================
+// Reassembly Tests
+// ============================================================================
+
+void test_reassembly_round_trip(void) {
+    TEST_ASSERT_EQUAL(4, RtcmRelay_fragmentCount(bigLen));
+    const uint8_t* frame = NULL;
+    uint16_t frameLen = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        bool done = addFragment(7, i, &frame, &frameLen);
+        TEST_ASSERT_EQUAL(i == 3, done);
+    }
+    TEST_ASSERT_EQUAL(bigLen, frameLen);
+    TEST_ASSERT_EQUAL_MEMORY(big, frame, bigLen);
+    TEST_ASSERT_EQUAL(1, reasm.frames);
+}
+
+void test_reassembly_drops_frame_with_gap(void) {
+    const uint8_t* frame;
+    uint16_t frameLen;
+    addFragment(1, 0, &frame, &frameLen);
+    addFragment(1, 1, &frame, &frameLen);
+    TEST_ASSERT_FALSE(addFragment(1, 3, &frame, &frameLen));   // 2 lost
+    TEST_ASSERT_EQUAL(1, reasm.lost);
+
+    // The next frame starts clean
+    for (uint8_t i = 0; i < 4; i++) addFragment(2, i, &frame, &frameLen);
+    TEST_ASSERT_NOT_NULL(frame);
+    TEST_ASSERT_EQUAL(1, reasm.frames);
+}
+
+void test_reassembly_new_frame_interrupts(void) {
+    const uint8_t* frame;
+    uint16_t frameLen;
+    addFragment(1, 0, &frame, &frameLen);
+    addFragment(2, 0, &frame, &frameLen);
+    TEST_ASSERT_EQUAL(1, reasm.lost);
+    TEST_ASSERT_FALSE(addFragment(1, 1, &frame, &frameLen));   // Old sequence
+    TEST_ASSERT_EQUAL(2, reasm.lost);
+}
+
+void test_reassembly_rejects_bad_fragments(void) {
+    const uint8_t* frame;
+    uint16_t frameLen;
+    uint8_t data[4] = {0};
+    TEST_ASSERT_FALSE(RtcmReassembler_add(&reasm, 0, 0, 0, data, 4, &frame, &frameLen));
+    TEST_ASSERT_FALSE(RtcmReassembler_add(&reasm, 0, 2, 2, data, 4, &frame, &frameLen));
+    TEST_ASSERT_FALSE(RtcmReassembler_add(&reasm, 0, 0, 16, data, 4, &frame, &frameLen));
+    TEST_ASSERT_EQUAL(3, reasm.malformed);
+
+    // Complete but not a frame: counted, not delivered
+    TEST_ASSERT_FALSE(RtcmReassembler_add(&reasm, 0, 0, 1, data, 4, &frame, &frameLen));
+    TEST_ASSERT_EQUAL(1, reasm.crcErrors);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Frame Tests
+    RUN_TEST(test_reference_frame);
+    RUN_TEST(test_frame_rejects_damage);
+
+    // Framer Tests
+    RUN_TEST(test_framer_finds_frames_between_ubx);
+    RUN_TEST(test_framer_across_reads);
+    RUN_TEST(test_framer_counts_crc_errors);
+
+    // Reassembly Tests
+    RUN_TEST(test_reassembly_round_trip);
+    RUN_TEST(test_reassembly_drops_frame_with_gap);
+    RUN_TEST(test_reassembly_new_frame_interrupts);
+    RUN_TEST(test_reassembly_rejects_bad_fragments);
+
+    return UNITY_END();
+}
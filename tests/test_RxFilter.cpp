@@ -0,0 +1,151 @@
+/**
+ * Unit Tests for RxFilter
+ * Tests stage ordering, the peer allowlist, clear-frame CRC and
+ * per-stage counters
+ *
+ * @file test_RxFilter.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "NAPacket.h"
+#include "NAPacketAEAD.h"
+#include "RxFilter.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static const uint8_t PAIRED[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+static const uint8_t STRANGER[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x02};
+static const uint8_t RELAY[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x03};
+static NAPacket pkt;
+
+void setUp(void) {
+    RxFilter_init();
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.protocolVersion = PROTOCOL_VERSION;
+    pkt.encryptionFlag = NA_ENCRYPTION_NONE;
+    pkt.throttle = 1500;
+    pkt.sequenceNumber = 42;
+    NA_UPDATE_PACKET_CHECKSUM(&pkt);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Stage Tests
+// ============================================================================
+
+void test_valid_frame_passes(void) {
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(PAIRED, &pkt));
+    RxFilter_record(RX_FILTER_PASS);
+    TEST_ASSERT_EQUAL_UINT32(1, RxFilter_getStats().passed);
+}
+
+void test_format_rejected_first(void) {
+    RxFilter_setPeer(PAIRED);
+    pkt.protocolVersion = PROTOCOL_VERSION + 1;
+    // Wrong version from a stranger: the cheaper FORMAT stage rejects it
+    TEST_ASSERT_EQUAL(RX_FILTER_FORMAT, RxFilter_checkControl(STRANGER, &pkt));
+
+    pkt.protocolVersion = PROTOCOL_VERSION;
+    pkt.encryptionFlag = 0x7F;
+    TEST_ASSERT_EQUAL(RX_FILTER_FORMAT, RxFilter_checkControl(PAIRED, &pkt));
+    TEST_ASSERT_EQUAL_UINT32(2, RxFilter_getStats().rejected[RX_FILTER_FORMAT]);
+}
+
+void test_source_allowlist(void) {
+    // Unpaired: any sender
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(STRANGER, &pkt));
+
+    RxFilter_setPeer(PAIRED);
+    TEST_ASSERT_EQUAL(RX_FILTER_SOURCE, RxFilter_checkControl(STRANGER, &pkt));
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(PAIRED, &pkt));
+
+    RxFilter_setPeer(NULL);
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(STRANGER, &pkt));
+    TEST_ASSERT_EQUAL_UINT32(1, RxFilter_getStats().rejected[RX_FILTER_SOURCE]);
+}
+
+void test_extra_peers_allowed(void) {
+    RxFilter_setPeer(PAIRED);
+    TEST_ASSERT_TRUE(RxFilter_addPeer(RELAY));
+    TEST_ASSERT_TRUE(RxFilter_addPeer(RELAY));         // Already listed
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(RELAY, &pkt));
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(PAIRED, &pkt));
+    TEST_ASSERT_EQUAL(RX_FILTER_SOURCE, RxFilter_checkControl(STRANGER, &pkt));
+
+    // Removing every peer closes the filter instead of opening it
+    RxFilter_removePeer(PAIRED);
+    RxFilter_removePeer(RELAY);
+    TEST_ASSERT_EQUAL(RX_FILTER_SOURCE, RxFilter_checkControl(RELAY, &pkt));
+
+    // Full list
+    uint8_t mac[6];
+    memcpy(mac, STRANGER, sizeof(mac));
+    for (uint8_t i = 0; i < RX_FILTER_MAX_PEERS; i++) {
+        mac[5] = 0x10 + i;
+        TEST_ASSERT_TRUE(RxFilter_addPeer(mac));
+    }
+    TEST_ASSERT_FALSE(RxFilter_addPeer(RELAY));
+}
+
+void test_checksum_clear_frames_only(void) {
+    pkt.checksum ^= 0x1234;
+    TEST_ASSERT_EQUAL(RX_FILTER_CHECKSUM, RxFilter_checkControl(PAIRED, &pkt));
+
+    // Encrypted frames: CRC covers the plaintext, checked after decryption
+    pkt.encryptionFlag = NA_ENCRYPTION_CTR_HMAC;
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(PAIRED, &pkt));
+    pkt.encryptionFlag = NA_ENCRYPTION_AEAD;
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(PAIRED, &pkt));
+    pkt.encryptionFlag = NA_ENCRYPTION_COMPACT;
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(PAIRED, &pkt));
+
+    // Link-layer CCMP: clear above the MAC, so the CRC still counts
+    pkt.encryptionFlag = NA_ENCRYPTION_LINK;
+    TEST_ASSERT_EQUAL(RX_FILTER_CHECKSUM, RxFilter_checkControl(PAIRED, &pkt));
+}
+
+void test_caller_stages_counted(void) {
+    RxFilter_record(RX_FILTER_LENGTH);
+    RxFilter_record(RX_FILTER_SEQUENCE);
+    RxFilter_record(RX_FILTER_RATE);
+    RxFilter_record(RX_FILTER_RATE);
+
+    RxFilterStats stats = RxFilter_getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rejected[RX_FILTER_LENGTH]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rejected[RX_FILTER_SEQUENCE]);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.rejected[RX_FILTER_RATE]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.passed);
+}
+
+void test_init_clears_peer_and_counters(void) {
+    RxFilter_setPeer(PAIRED);
+    RxFilter_checkControl(STRANGER, &pkt);
+    RxFilter_init();
+
+    TEST_ASSERT_EQUAL(RX_FILTER_PASS, RxFilter_checkControl(STRANGER, &pkt));
+    TEST_ASSERT_EQUAL_UINT32(0, RxFilter_getStats().rejected[RX_FILTER_SOURCE]);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Stage Tests
+    RUN_TEST(test_valid_frame_passes);
+    RUN_TEST(test_format_rejected_first);
+    RUN_TEST(test_source_allowlist);
+    RUN_TEST(test_extra_peers_allowed);
+    RUN_TEST(test_checksum_clear_frames_only);
+    RUN_TEST(test_caller_stages_counted);
+    RUN_TEST(test_init_clears_peer_and_counters);
+
+    return UNITY_END();
+}
@@ -0,0 +1,320 @@
+/**
+ * Unit Tests for RxStress
+ * Tests the traffic mix, per-kind frame damage, and a host-side flood
+ * through the receive stages (RxFilter -> ReplayWindow -> RateLimitManager
+ * -> verify) on the manual clock, reporting where each kind is dropped
+ *
+ * @file test_RxStress.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <Arduino.h>
+#include "NAPacket.h"
+#include "RxStress.h"
+#include "RxFilter.h"
+#include "ReplayWindow.h"
+#include "RateLimitManager.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static const uint8_t PAIRED[6] = {0x24, 0x6F, 0x28, 0x00, 0x00, 0x01};
+static NAPacket templ;
+static RxStressGen gen;
+static uint8_t frame[RX_STRESS_FRAME_MAX];
+
+/**
+ * Stand-in for CTR+HMAC without mbedtls: a keyed CRC over the payload as
+ * the "HMAC", payload left readable. Enough for the stages to tell a
+ * damaged tag from a good one.
+ */
+static uint16_t fakeTag(const NAPacket* pkt) {
+    return NA_CRC16((const uint8_t*)&pkt->throttle, 10) ^ 0xA5C3;
+}
+
+static void sealFake(NAPacket* pkt, bool encrypted, void* ctx) {
+    (void)ctx;
+    memset(pkt->hmac, 0, sizeof(pkt->hmac));
+    if (!encrypted) {
+        RxStress_sealClear(pkt, false, NULL);
+        return;
+    }
+    pkt->encryptionFlag = NA_ENCRYPTION_CTR_HMAC;
+    uint16_t tag = fakeTag(pkt);
+    pkt->hmac[0] = (uint8_t)tag;
+    pkt->hmac[1] = (uint8_t)(tag >> 8);
+    NA_UPDATE_PACKET_CHECKSUM(pkt);
+}
+
+void setUp(void) {
+    memset(&templ, 0, sizeof(templ));
+    templ.protocolVersion = PROTOCOL_VERSION;
+    RxFilter_init();
+    RxFilter_setPeer(PAIRED);
+}
+
+void tearDown(void) {
+    NativeClock_useHostTime();
+}
+
+static void initMix(uint8_t valid, uint8_t crc, uint8_t hmac, uint8_t replay,
+                    uint8_t big, uint8_t enc) {
+    RxStressMix mix;
+    mix.weights[RX_STRESS_VALID] = valid;
+    mix.weights[RX_STRESS_BAD_CRC] = crc;
+    mix.weights[RX_STRESS_BAD_HMAC] = hmac;
+    mix.weights[RX_STRESS_REPLAY] = replay;
+    mix.weights[RX_STRESS_OVERSIZED] = big;
+    mix.encryptedPercent = enc;
+    TEST_ASSERT_TRUE(RxStress_init(&gen, &mix, &templ, 1234, sealFake, NULL));
+}
+
+// ============================================================================
+// Generator Tests
+// ============================================================================
+
+void test_empty_mix_rejected(void) {
+    RxStressMix mix;
+    memset(&mix, 0, sizeof(mix));
+    TEST_ASSERT_FALSE(RxStress_init(&gen, &mix, &templ, 1, NULL, NULL));
+}
+
+void test_default_mix_proportions(void) {
+    RxStressMix mix;
+    RxStress_defaultMix(&mix);
+    RxStress_init(&gen, &mix, &templ, 99, NULL, NULL);
+    uint16_t len;
+    for (int i = 0; i < 10000; i++) RxStress_next(&gen, frame, &len, NULL);
+
+    TEST_ASSERT_UINT_WITHIN(300, 7000, gen.generated[RX_STRESS_VALID]);
+    TEST_ASSERT_UINT_WITHIN(200, 1000, gen.generated[RX_STRESS_BAD_CRC]);
+    TEST_ASSERT_UINT_WITHIN(200, 500, gen.generated[RX_STRESS_OVERSIZED]);
+}
+
+void test_valid_frames_count_up(void) {
+    initMix(1, 0, 0, 0, 0, 0);
+    uint16_t len;
+    bool enc = true;
+    for (uint32_t i = 1; i <= 3; i++) {
+        TEST_ASSERT_EQUAL(RX_STRESS_VALID, RxStress_next(&gen, frame, &len, &enc));
+        NAPacket pkt;
+        memcpy(&pkt, frame, sizeof(pkt));
+        TEST_ASSERT_EQUAL_UINT16(sizeof(NAPacket), len);
+        TEST_ASSERT_FALSE(enc);
+        TEST_ASSERT_EQUAL_UINT32(i, pkt.sequenceNumber);
+        TEST_ASSERT_TRUE(NA_PACKET_IS_VALID(&pkt));
+        TEST_ASSERT_EQUAL_INT16(0, pkt.roll);       // Neutral template
+    }
+}
+
+void test_damaged_kinds(void) {
+    uint16_t len;
+    NAPacket pkt;
+
+    initMix(0, 1, 0, 0, 0, 0);
+    TEST_ASSERT_EQUAL(RX_STRESS_BAD_CRC, RxStress_next(&gen, frame, &len, NULL));
+    memcpy(&pkt, frame, sizeof(pkt));
+    TEST_ASSERT_FALSE(NA_PACKET_IS_VALID(&pkt));
+
+    bool enc = false;
+    initMix(0, 0, 1, 0, 0, 0);
+    TEST_ASSERT_EQUAL(RX_STRESS_BAD_HMAC, RxStress_next(&gen, frame, &len, &enc));
+    TEST_ASSERT_TRUE(enc);                          // Even with a clear-only mix
+    memcpy(&pkt, frame, sizeof(pkt));
+    uint16_t tag = pkt.hmac[0] | (pkt.hmac[1] << 8);
+    TEST_ASSERT_NOT_EQUAL(fakeTag(&pkt), tag);
+
+    initMix(0, 0, 0, 0, 1, 0);
+    TEST_ASSERT_EQUAL(RX_STRESS_OVERSIZED, RxStress_next(&gen, frame, &len, NULL));
+    TEST_ASSERT_EQUAL_UINT16(RX_STRESS_FRAME_MAX, len);
+}
+
+void test_replay_repeats_last_valid(void) {
+    initMix(1, 0, 0, 1, 0, 50);
+    uint16_t len;
+    uint8_t last[sizeof(NAPacket)];
+    bool haveLast = false;
+    int replays = 0;
+    for (int i = 0; i < 200; i++) {
+        RxStressKind kind = RxStress_next(&gen, frame, &len, NULL);
+        if (kind == RX_STRESS_REPLAY && haveLast) {
+            TEST_ASSERT_EQUAL_MEMORY(last, frame, sizeof(NAPacket));
+            replays++;
+        } else {
+            memcpy(last, frame, sizeof(NAPacket));
+            haveLast = true;
+        }
+    }
+    TEST_ASSERT_TRUE(replays > 50);
+}
+
+void test_same_seed_same_traffic(void) {
+    initMix(5, 2, 2, 1, 1, 50);
+    uint8_t a[RX_STRESS_FRAME_MAX];
+    uint16_t lenA, lenB;
+    RxStressGen other = gen;
+    for (int i = 0; i < 50; i++) {
+        RxStress_next(&gen, a, &lenA, NULL);
+        RxStress_next(&other, frame, &lenB, NULL);
+        TEST_ASSERT_EQUAL_UINT16(lenA, lenB);
+        TEST_ASSERT_EQUAL_MEMORY(a, frame, lenA);
+    }
+}
+
+// ============================================================================
+// Flood Tests
+// ============================================================================
+
+/**
+ * Receive path of main.cpp minus the radio and the crypto: the same
+ * stage order and modules as OnDataRecv + processControlPacket
+ */
+typedef struct {
+    ReplayWindow window;
+    uint32_t dropped[RX_STRESS_KINDS][RX_FILTER_STAGE_COUNT];
+    uint32_t verifyFailed[RX_STRESS_KINDS];
+    uint32_t accepted[RX_STRESS_KINDS];
+    uint64_t ns[3];             // accept, sequence + rate, verify
+    uint32_t frames;
+} Flood;
+
+static Flood flood;
+
+// Wall time, not the manual clock the flood runs on
+static uint32_t hostNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+static void floodFrame(RxStressKind kind, const uint8_t* data, uint16_t len) {
+    uint32_t t0 = hostNs();
+    RxFilterStage stage = RX_FILTER_PASS;
+    NAPacket pkt;
+    if (len != sizeof(NAPacket)) {
+        stage = RX_FILTER_LENGTH;
+    } else {
+        memcpy(&pkt, data, sizeof(pkt));
+        stage = RxFilter_checkControl(PAIRED, &pkt);
+    }
+    uint32_t t1 = hostNs();
+    if (stage == RX_FILTER_PASS) {
+        if (ReplayWindow_check(&flood.window, pkt.sequenceNumber, millis()) != REPLAY_OK) {
+            stage = RX_FILTER_SEQUENCE;
+        } else if (RateLimitManager_check(PAIRED, RATE_CLASS_CONTROL) != RATE_LIMIT_ALLOWED) {
+            stage = RX_FILTER_RATE;
+        }
+    }
+    if (stage != RX_FILTER_CHECKSUM && stage != RX_FILTER_FORMAT &&
+        stage != RX_FILTER_SOURCE) {
+        // checkControl counts its own rejects
+        RxFilter_record(stage);
+    }
+    uint32_t t2 = hostNs();
+    flood.ns[0] += t1 - t0;
+    flood.ns[1] += t2 - t1;
+    flood.frames++;
+
+    if (stage != RX_FILTER_PASS) {
+        flood.dropped[kind][stage]++;
+        return;
+    }
+
+    // Control task side: tag, then CRC over the plaintext
+    bool ok = true;
+    if (pkt.encryptionFlag == NA_ENCRYPTION_CTR_HMAC) {
+        uint16_t tag = pkt.hmac[0] | (pkt.hmac[1] << 8);
+        ok = tag == fakeTag(&pkt);
+    }
+    ok = ok && NA_PACKET_IS_VALID(&pkt);
+    if (ok) {
+        ReplayWindow_accept(&flood.window, pkt.sequenceNumber, millis());
+        flood.accepted[kind]++;
+    } else {
+        flood.verifyFailed[kind]++;
+    }
+    flood.ns[2] += hostNs() - t2;
+}
+
+static void runFlood(uint32_t pps, uint32_t seconds) {
+    memset(&flood, 0, sizeof(flood));
+    ReplayWindow_init(&flood.window);
+    RateLimitManager_init(RATE_LIMIT_CAPACITY);
+    NativeClock_setMicros(1000000);
+
+    uint32_t gapUs = 1000000 / pps;
+    uint16_t len;
+    for (uint32_t i = 0; i < pps * seconds; i++) {
+        RxStressKind kind = RxStress_next(&gen, frame, &len, NULL);
+        floodFrame(kind, frame, len);
+        NativeClock_advanceMicros(gapUs);
+    }
+}
+
+void test_flood_stage_attribution(void) {
+    // 50 pps: below every rate limit, so only the damage decides
+    initMix(70, 10, 10, 5, 5, 50);
+    runFlood(50, 20);
+
+    TEST_ASSERT_EQUAL_UINT32(0, flood.accepted[RX_STRESS_BAD_CRC]);
+    TEST_ASSERT_EQUAL_UINT32(0, flood.accepted[RX_STRESS_BAD_HMAC]);
+    TEST_ASSERT_EQUAL_UINT32(0, flood.accepted[RX_STRESS_OVERSIZED]);
+    TEST_ASSERT_EQUAL_UINT32(gen.generated[RX_STRESS_OVERSIZED],
+                             flood.dropped[RX_STRESS_OVERSIZED][RX_FILTER_LENGTH]);
+    TEST_ASSERT_EQUAL_UINT32(gen.generated[RX_STRESS_VALID],
+                             flood.accepted[RX_STRESS_VALID]);
+
+    // Clear frames with a bad CRC die in the Wi-Fi task, encrypted ones
+    // only after decryption
+    TEST_ASSERT_TRUE(flood.dropped[RX_STRESS_BAD_CRC][RX_FILTER_CHECKSUM] > 0);
+    TEST_ASSERT_TRUE(flood.verifyFailed[RX_STRESS_BAD_CRC] > 0);
+
+    // Replays never reach verification (except one sent before any valid frame)
+    TEST_ASSERT_TRUE(flood.accepted[RX_STRESS_REPLAY] <= 1);
+    TEST_ASSERT_TRUE(flood.dropped[RX_STRESS_REPLAY][RX_FILTER_SEQUENCE] > 0);
+}
+
+void test_flood_rate_cap(void) {
+    // 2000 pps of good frames: the limiter, not the verifier, takes the load
+    initMix(1, 0, 0, 0, 0, 100);
+    runFlood(2000, 5);
+
+    // Peer bucket: one burst, then its refill rate
+    uint32_t accepted = flood.accepted[RX_STRESS_VALID];
+    TEST_ASSERT_TRUE(accepted <= RATE_LIMIT_PEER_PER_SEC * (5 + 1) + 5);
+    TEST_ASSERT_TRUE(flood.dropped[RX_STRESS_VALID][RX_FILTER_RATE] > 9000);
+
+    printf("{\"pps\":2000,\"frames\":%lu,\"accept_ns\":%lu,\"seq_rate_ns\":%lu,"
+           "\"verify_ns\":%lu}\n",
+           (unsigned long)flood.frames,
+           (unsigned long)(flood.ns[0] / flood.frames),
+           (unsigned long)(flood.ns[1] / flood.frames),
+           (unsigned long)(accepted ? flood.ns[2] / accepted : 0));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Generator Tests
+    RUN_TEST(test_empty_mix_rejected);
+    RUN_TEST(test_default_mix_proportions);
+    RUN_TEST(test_valid_frames_count_up);
+    RUN_TEST(test_damaged_kinds);
+    RUN_TEST(test_replay_repeats_last_valid);
+    RUN_TEST(test_same_seed_same_traffic);
+
+    // Flood Tests
+    RUN_TEST(test_flood_stage_attribution);
+    RUN_TEST(test_flood_rate_cap);
+
+    return UNITY_END();
+}
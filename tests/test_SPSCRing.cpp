@@ -0,0 +1,167 @@
+/**
+ * Unit Tests for SPSCRing
+ * Tests latest-value handoff, drop accounting and wrap-around
+ *
+ * @file test_SPSCRing.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "SPSCRing.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+typedef struct {
+    uint32_t seq;
+    int16_t axes[4];
+} TestFrame;
+
+static SPSCRing<TestFrame, 4> *ring = nullptr;
+
+static TestFrame makeFrame(uint32_t seq) {
+    TestFrame f;
+    f.seq = seq;
+    for (int i = 0; i < 4; i++) {
+        f.axes[i] = (int16_t)(seq * 10 + i);
+    }
+    return f;
+}
+
+void setUp(void) {
+    // Fresh ring for every test
+    ring = new SPSCRing<TestFrame, 4>();
+}
+
+void tearDown(void) {
+    delete ring;
+    ring = nullptr;
+}
+
+// ============================================================================
+// Handoff Tests
+// ============================================================================
+
+void test_empty_ring_returns_false(void) {
+    TestFrame out;
+    TEST_ASSERT_FALSE(ring->readLatest(out));
+}
+
+void test_single_frame_roundtrip(void) {
+    TestFrame in = makeFrame(1);
+    ring->push(in);
+
+    TestFrame out;
+    memset(&out, 0, sizeof(out));
+    TEST_ASSERT_TRUE(ring->readLatest(out));
+    TEST_ASSERT_EQUAL_MEMORY(&in, &out, sizeof(TestFrame));
+}
+
+void test_frame_consumed_only_once(void) {
+    ring->push(makeFrame(1));
+
+    TestFrame out;
+    TEST_ASSERT_TRUE(ring->readLatest(out));
+    TEST_ASSERT_FALSE(ring->readLatest(out));
+}
+
+void test_consumer_gets_newest_frame(void) {
+    ring->push(makeFrame(1));
+    ring->push(makeFrame(2));
+    ring->push(makeFrame(3));
+
+    TestFrame out;
+    TEST_ASSERT_TRUE(ring->readLatest(out));
+    TEST_ASSERT_EQUAL_UINT32(3, out.seq);
+    TEST_ASSERT_EQUAL_INT16(32, out.axes[2]);
+}
+
+// ============================================================================
+// Accounting Tests
+// ============================================================================
+
+void test_superseded_frames_are_counted(void) {
+    ring->push(makeFrame(1));
+    ring->push(makeFrame(2));
+    ring->push(makeFrame(3));
+
+    TestFrame out;
+    ring->readLatest(out);
+
+    TEST_ASSERT_EQUAL_UINT32(3, ring->getPushCount());
+    TEST_ASSERT_EQUAL_UINT32(2, ring->getDroppedCount());
+}
+
+void test_wraparound_keeps_newest(void) {
+    TestFrame out;
+    // Push well past the slot count, reading occasionally
+    for (uint32_t i = 1; i <= 11; i++) {
+        ring->push(makeFrame(i));
+        if (i % 5 == 0) {
+            TEST_ASSERT_TRUE(ring->readLatest(out));
+            TEST_ASSERT_EQUAL_UINT32(i, out.seq);
+        }
+    }
+
+    TEST_ASSERT_TRUE(ring->readLatest(out));
+    TEST_ASSERT_EQUAL_UINT32(11, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(11 - 3, ring->getDroppedCount());
+}
+
+// ============================================================================
+// In-Order Drain Tests
+// ============================================================================
+
+void test_read_next_drains_in_order(void) {
+    ring->push(makeFrame(1));
+    ring->push(makeFrame(2));
+    ring->push(makeFrame(3));
+
+    TestFrame out;
+    for (uint32_t i = 1; i <= 3; i++) {
+        TEST_ASSERT_TRUE(ring->readNext(out));
+        TEST_ASSERT_EQUAL_UINT32(i, out.seq);
+    }
+    TEST_ASSERT_FALSE(ring->readNext(out));
+    TEST_ASSERT_EQUAL_UINT32(0, ring->getDroppedCount());
+}
+
+void test_read_next_skips_lapped_frames(void) {
+    for (uint32_t i = 1; i <= 10; i++) {
+        ring->push(makeFrame(i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, ring->available());
+
+    TestFrame out;
+    // Only the last 4 survive
+    TEST_ASSERT_TRUE(ring->readNext(out));
+    TEST_ASSERT_EQUAL_UINT32(7, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(6, ring->getDroppedCount());
+    TEST_ASSERT_EQUAL_UINT32(3, ring->available());
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Handoff Tests
+    RUN_TEST(test_empty_ring_returns_false);
+    RUN_TEST(test_single_frame_roundtrip);
+    RUN_TEST(test_frame_consumed_only_once);
+    RUN_TEST(test_consumer_gets_newest_frame);
+
+    // Accounting Tests
+    RUN_TEST(test_superseded_frames_are_counted);
+    RUN_TEST(test_wraparound_keeps_newest);
+
+    // In-Order Drain Tests
+    RUN_TEST(test_read_next_drains_in_order);
+    RUN_TEST(test_read_next_skips_lapped_frames);
+
+    return UNITY_END();
+}
@@ -0,0 +1,107 @@
+/**
+ * Unit Tests for SSD1306Async
+ * Tests text rendering into the framebuffer and the dirty column
+ * tracking that decides what goes over the bus
+ *
+ * @file test_SSD1306Async.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "drivers/SSD1306Async.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Rendering Tests
+// ============================================================================
+
+void test_starts_clean(void) {
+    SSD1306Async oled;
+    uint8_t page, first, last;
+    TEST_ASSERT_FALSE(oled.nextDirty(&page, &first, &last));
+}
+
+void test_glyph_in_its_cell(void) {
+    SSD1306Async oled;
+    oled.setLine(2, " A");
+    // 'A' in the second 6-pixel cell of page 2
+    TEST_ASSERT_EQUAL_HEX8(0x7E, oled.getByte(2, 6));
+    TEST_ASSERT_EQUAL_HEX8(0x11, oled.getByte(2, 7));
+    TEST_ASSERT_EQUAL_HEX8(0x7E, oled.getByte(2, 10));
+    TEST_ASSERT_EQUAL_HEX8(0x00, oled.getByte(2, 11));      // Spacing column
+    TEST_ASSERT_EQUAL_HEX8(0x00, oled.getByte(1, 6));
+}
+
+void test_unprintable_drawn_as_question_mark(void) {
+    SSD1306Async oled;
+    oled.setLine(0, "\x01");
+    TEST_ASSERT_EQUAL_HEX8(0x02, oled.getByte(0, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x51, oled.getByte(0, 2));
+}
+
+// ============================================================================
+// Dirty Tracking Tests
+// ============================================================================
+
+void test_blank_text_changes_nothing(void) {
+    SSD1306Async oled;
+    oled.setLine(3, "     ");
+    oled.setLine(4, nullptr);
+    oled.clear();
+    uint8_t page, first, last;
+    TEST_ASSERT_FALSE(oled.nextDirty(&page, &first, &last));
+}
+
+void test_dirty_range_covers_changed_columns_only(void) {
+    SSD1306Async oled;
+    oled.setLine(5, "   1");           // Cell 3: columns 18-22
+    uint8_t page, first, last;
+    TEST_ASSERT_TRUE(oled.nextDirty(&page, &first, &last));
+    TEST_ASSERT_EQUAL_UINT8(5, page);
+    TEST_ASSERT_EQUAL_UINT8(19, first);     // '1' leaves its first column blank
+    TEST_ASSERT_EQUAL_UINT8(21, last);
+}
+
+void test_lowest_dirty_page_first(void) {
+    SSD1306Async oled;
+    oled.setLine(6, "B");
+    oled.setLine(1, "B");
+    uint8_t page, first, last;
+    TEST_ASSERT_TRUE(oled.nextDirty(&page, &first, &last));
+    TEST_ASSERT_EQUAL_UINT8(1, page);
+}
+
+void test_flush_needs_begin(void) {
+    SSD1306Async oled;
+    oled.setLine(0, "X");
+    TEST_ASSERT_FALSE(oled.flush());
+    TEST_ASSERT_FALSE(oled.begin());        // No panel on the host bus
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Rendering Tests
+    RUN_TEST(test_starts_clean);
+    RUN_TEST(test_glyph_in_its_cell);
+    RUN_TEST(test_unprintable_drawn_as_question_mark);
+
+    // Dirty Tracking Tests
+    RUN_TEST(test_blank_text_changes_nothing);
+    RUN_TEST(test_dirty_range_covers_changed_columns_only);
+    RUN_TEST(test_lowest_dirty_page_first);
+    RUN_TEST(test_flush_needs_begin);
+
+    return UNITY_END();
+}
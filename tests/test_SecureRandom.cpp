@@ -0,0 +1,80 @@
+/**
+ * Unit Tests for SecureRandom
+ * Tests the shared DRBG: output, the mbedtls callback and the central
+ * reseed interval
+ *
+ * @file test_SecureRandom.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "SecureRandom.h"
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Output Tests
+// ============================================================================
+
+void test_init_is_idempotent(void) {
+    TEST_ASSERT_TRUE(SecureRandom_init());
+    TEST_ASSERT_TRUE(SecureRandom_init());
+}
+
+void test_draws_differ(void) {
+    uint8_t a[32], b[32], zero[32];
+    memset(zero, 0, sizeof(zero));
+    TEST_ASSERT_EQUAL(0, SecureRandom_fill(a, sizeof(a)));
+    TEST_ASSERT_EQUAL(0, SecureRandom_fill(b, sizeof(b)));
+    TEST_ASSERT_TRUE(memcmp(a, b, sizeof(a)) != 0);
+    TEST_ASSERT_TRUE(memcmp(a, zero, sizeof(a)) != 0);
+}
+
+void test_mbedtls_callback_counts_requests(void) {
+    uint8_t buf[16];
+    uint32_t before = SecureRandom_getStats().requests;
+    TEST_ASSERT_EQUAL(0, SecureRandom_mbedtls(NULL, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT32(before + 1, SecureRandom_getStats().requests);
+}
+
+// ============================================================================
+// Reseed Tests
+// ============================================================================
+
+void test_reseeds_every_interval(void) {
+    uint8_t buf[1];
+    // Run up to a reseed, wherever the counter stands
+    uint32_t reseeds = SecureRandom_getStats().reseeds;
+    for (uint32_t i = 0; i <= SECURE_RANDOM_RESEED_INTERVAL &&
+                         SecureRandom_getStats().reseeds == reseeds; i++)
+        TEST_ASSERT_EQUAL(0, SecureRandom_fill(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT32(reseeds + 1, SecureRandom_getStats().reseeds);
+
+    // That draw counted; the next reseed is one interval later
+    for (uint32_t i = 0; i < SECURE_RANDOM_RESEED_INTERVAL - 1; i++)
+        SecureRandom_fill(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(reseeds + 1, SecureRandom_getStats().reseeds);
+    TEST_ASSERT_EQUAL(0, SecureRandom_fill(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_UINT32(reseeds + 2, SecureRandom_getStats().reseeds);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Output Tests
+    RUN_TEST(test_init_is_idempotent);
+    RUN_TEST(test_draws_differ);
+    RUN_TEST(test_mbedtls_callback_counts_requests);
+
+    // Reseed Tests
+    RUN_TEST(test_reseeds_every_interval);
+
+    return UNITY_END();
+}
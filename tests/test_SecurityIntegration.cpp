@@ -14,9 +14,11 @@
  * 3. HMAC authentication (valid vs forged HMAC)
  * 4. End-to-end secure packet handling
  * 5. Graceful degradation under attack
+ * 6. Time budget of validating and decrypting a control packet
  */
 
 #include <unity.h>
+#include "Benchmark.h"
 #include "EncryptionManager.h"
 #include "RateLimitManager.h"
 #include "HMACValidator.h"
@@ -424,6 +426,51 @@ void test_SecurityIntegration_encrypted_packet_structure_validation(void) {
     TEST_ASSERT_NOT_EQUAL(0, packet.hmac[0]);
 }
 
+// ============================================================================
+// Test Group 6: Hot Path Budget
+// ============================================================================
+
+typedef struct {
+    uint8_t iv[16];
+    uint8_t ciphertext[sizeof(MockPayload)];
+    uint8_t hmac[32];
+    uint8_t plaintext[sizeof(MockPayload)];
+    bool ok;
+} ControlFrame;
+
+// Receiver side of one control packet: authenticate, then decrypt
+static void receiveControl(void* ctx) {
+    ControlFrame* frame = (ControlFrame*)ctx;
+    frame->ok = HMACValidator_validate(frame->ciphertext, sizeof(frame->ciphertext),
+                                       frame->hmac) &&
+                EncryptionManager_decrypt(frame->ciphertext, sizeof(frame->ciphertext),
+                                          frame->iv, frame->plaintext);
+}
+
+void test_SecurityIntegration_control_packet_budget(void) {
+    // Keys are scheduled once at init: a key setup per packet blows this
+    uint8_t key[32];
+    uint8_t secret[32];
+    memset(key, 0x42, 32);
+    memset(secret, 0xAA, 32);
+    EncryptionManager_init(key);
+    HMACValidator_init(secret);
+
+    ControlFrame frame;
+    MockPayload command = {100, 50, 30, 0};
+    EncryptionManager_generateIV(frame.iv);
+    EncryptionManager_encrypt((uint8_t*)&command, sizeof(command), frame.iv,
+                              frame.ciphertext);
+    HMACValidator_generate(frame.ciphertext, sizeof(frame.ciphertext), frame.hmac);
+
+    char msg[BENCH_LINE_MAX];
+    TEST_ASSERT_TRUE_MESSAGE(Bench_checkBudget("control_rx", receiveControl, &frame, 500,
+                                               BENCH_BUDGET_NS(60000, 3000), msg,
+                                               sizeof(msg)), msg);
+    TEST_ASSERT_TRUE(frame.ok);
+    TEST_ASSERT_EQUAL_MEMORY(&command, frame.plaintext, sizeof(command));
+}
+
 // ============================================================================
 // Test Run Configuration
 // ============================================================================
@@ -454,6 +501,9 @@ int main(void) {
     RUN_TEST(test_SecurityIntegration_managers_handle_null_inputs_gracefully);
     RUN_TEST(test_SecurityIntegration_rate_limit_gracefully_handles_zero_capacity);
     RUN_TEST(test_SecurityIntegration_encrypted_packet_structure_validation);
+
+    // Hot Path Budget Tests
+    RUN_TEST(test_SecurityIntegration_control_packet_budget);
     
     return UNITY_END();
 }
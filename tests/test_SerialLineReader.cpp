@@ -0,0 +1,163 @@
+/**
+ * Unit Tests for SerialLineReader
+ * Tests line assembly, partial lines and overflow handling
+ *
+ * @file test_SerialLineReader.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "SerialLineReader.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static char line[SERIAL_LINE_MAX];
+
+static void feedString(const char *s) {
+    SerialLineReader_feed((const uint8_t *)s, strlen(s));
+}
+
+void setUp(void) {
+    SerialLineReader_reset();
+    memset(line, 0, sizeof(line));
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Assembly Tests
+// ============================================================================
+
+void test_no_data_returns_zero(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, SerialLineReader_readLine(line, sizeof(line)));
+}
+
+void test_complete_line_returned(void) {
+    feedString("{\"c\":\"ping\"}\n");
+    TEST_ASSERT_EQUAL_UINT32(12, SerialLineReader_readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("{\"c\":\"ping\"}", line);
+}
+
+void test_partial_line_waits_for_newline(void) {
+    feedString("{\"c\":");
+    TEST_ASSERT_EQUAL_UINT32(0, SerialLineReader_readLine(line, sizeof(line)));
+
+    feedString("\"es\"}\r\n");
+    TEST_ASSERT_EQUAL_UINT32(10, SerialLineReader_readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("{\"c\":\"es\"}", line);
+}
+
+void test_multiple_lines_one_per_call(void) {
+    feedString("a\n\n  b  \n");
+    TEST_ASSERT_EQUAL_UINT32(1, SerialLineReader_readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("a", line);
+
+    // Empty line skipped, whitespace trimmed
+    TEST_ASSERT_EQUAL_UINT32(1, SerialLineReader_readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("b", line);
+
+    TEST_ASSERT_EQUAL_UINT32(0, SerialLineReader_readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_UINT32(2, SerialLineReader_getStats().linesCompleted);
+}
+
+void test_binary_frame_between_lines(void) {
+    // 0x00-delimited frame may contain '\n'; text resumes after it
+    const uint8_t stream[] = {'a', '\n', 0x00, 0x05, 0x0A, 0x22, 0x0A, 0x33,
+                              0x00, 'b', '\n'};
+    SerialLineReader_feed(stream, sizeof(stream));
+
+    uint8_t buf[16];
+    SerialFrameType type;
+    TEST_ASSERT_EQUAL_UINT32(1, SerialLineReader_readFrame(buf, sizeof(buf), &type));
+    TEST_ASSERT_EQUAL(SERIAL_FRAME_TEXT, type);
+
+    TEST_ASSERT_EQUAL_UINT32(5, SerialLineReader_readFrame(buf, sizeof(buf), &type));
+    TEST_ASSERT_EQUAL(SERIAL_FRAME_BINARY, type);
+    TEST_ASSERT_EQUAL_UINT8(0x0A, buf[1]);
+
+    TEST_ASSERT_EQUAL_UINT32(1, SerialLineReader_readFrame(buf, sizeof(buf), &type));
+    TEST_ASSERT_EQUAL(SERIAL_FRAME_TEXT, type);
+    TEST_ASSERT_EQUAL_UINT8('b', buf[0]);
+}
+
+void test_mavlink_frame_between_lines(void) {
+    // Partial text is dropped at STX; 0x00 and '\n' inside are payload
+    const uint8_t stream[] = {'x', 'y', 0xFD, 0x03, 0x00, 0x00, 0x07, 0x01, 0x01,
+                              0x00, 0x00, 0x00, 0x0A, 0x00, 0x0A, 0x12, 0x34,
+                              'b', '\n'};
+    SerialLineReader_feed(stream, sizeof(stream));
+
+    uint8_t buf[32];
+    SerialFrameType type;
+    TEST_ASSERT_EQUAL_UINT32(15, SerialLineReader_readFrame(buf, sizeof(buf), &type));
+    TEST_ASSERT_EQUAL(SERIAL_FRAME_MAVLINK, type);
+    TEST_ASSERT_EQUAL_UINT8(0xFD, buf[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x34, buf[14]);
+
+    TEST_ASSERT_EQUAL_UINT32(1, SerialLineReader_readFrame(buf, sizeof(buf), &type));
+    TEST_ASSERT_EQUAL(SERIAL_FRAME_TEXT, type);
+    TEST_ASSERT_EQUAL_UINT8('b', buf[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, SerialLineReader_getStats().mavlinkFrames);
+}
+
+// ============================================================================
+// Overflow Tests
+// ============================================================================
+
+void test_oversized_line_discarded(void) {
+    static char big[SERIAL_LINE_MAX + 16];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+
+    feedString(big);
+    feedString("\nok\n");
+
+    TEST_ASSERT_EQUAL_UINT32(2, SerialLineReader_readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("ok", line);
+    TEST_ASSERT_EQUAL_UINT32(1, SerialLineReader_getStats().linesOverflowed);
+}
+
+void test_line_longer_than_output_buffer_skipped(void) {
+    char small[4];
+    feedString("abcdef\nxy\n");
+
+    TEST_ASSERT_EQUAL_UINT32(2, SerialLineReader_readLine(small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("xy", small);
+}
+
+void test_full_ring_drops_bytes(void) {
+    static uint8_t blob[SERIAL_RX_RING_SIZE + 10];
+    memset(blob, 'z', sizeof(blob));
+
+    SerialLineReader_feed(blob, sizeof(blob));
+    SerialLineReaderStats stats = SerialLineReader_getStats();
+    TEST_ASSERT_EQUAL_UINT32(SERIAL_RX_RING_SIZE, stats.bytesReceived);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.bytesDropped);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Assembly Tests
+    RUN_TEST(test_no_data_returns_zero);
+    RUN_TEST(test_complete_line_returned);
+    RUN_TEST(test_partial_line_waits_for_newline);
+    RUN_TEST(test_multiple_lines_one_per_call);
+    RUN_TEST(test_binary_frame_between_lines);
+    RUN_TEST(test_mavlink_frame_between_lines);
+
+    // Overflow Tests
+    RUN_TEST(test_oversized_line_discarded);
+    RUN_TEST(test_line_longer_than_output_buffer_skipped);
+    RUN_TEST(test_full_ring_drops_bytes);
+
+    return UNITY_END();
+}
@@ -0,0 +1,182 @@
+/**
+ * Unit Tests for SessionKeys
+ * Tests HKDF-SHA256 against RFC 5869, key separation, the ratchet and
+ * epoch tracking from sequence numbers
+ *
+ * @file test_SessionKeys.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "SessionKeys.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static uint8_t secret[32];
+static SessionKeys keys;
+
+void setUp(void) {
+    for (int i = 0; i < 32; i++) secret[i] = (uint8_t)(i * 13 + 7);
+    SessionKeys_wipe(&keys);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// HKDF Tests (RFC 5869 Appendix A)
+// ============================================================================
+
+void test_hkdf_rfc5869_case1(void) {
+    uint8_t ikm[22], salt[13], info[10], okm[42];
+    memset(ikm, 0x0b, sizeof(ikm));
+    for (int i = 0; i < 13; i++) salt[i] = (uint8_t)i;
+    for (int i = 0; i < 10; i++) info[i] = (uint8_t)(0xf0 + i);
+    const uint8_t expected[42] = {
+        0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64, 0xd0, 0x36,
+        0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56,
+        0xec, 0xc4, 0xc5, 0xbf, 0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65};
+
+    TEST_ASSERT_TRUE(SessionKeys_hkdf(salt, sizeof(salt), ikm, sizeof(ikm), info, sizeof(info),
+                                      okm, sizeof(okm)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, okm, sizeof(okm));
+}
+
+void test_hkdf_rfc5869_case3_no_salt_no_info(void) {
+    uint8_t ikm[22], okm[42];
+    memset(ikm, 0x0b, sizeof(ikm));
+    const uint8_t expected[42] = {
+        0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f, 0x71, 0x5f, 0x80, 0x2a, 0x06, 0x3c,
+        0x5a, 0x31, 0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1, 0x87, 0x9e, 0xc3, 0x45, 0x4e, 0x5f,
+        0x3c, 0x73, 0x8d, 0x2d, 0x9d, 0x20, 0x13, 0x95, 0xfa, 0xa4, 0xb6, 0x1a, 0x96, 0xc8};
+
+    TEST_ASSERT_TRUE(SessionKeys_hkdf(NULL, 0, ikm, sizeof(ikm), NULL, 0, okm, sizeof(okm)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, okm, sizeof(okm));
+}
+
+// ============================================================================
+// Derivation Tests
+// ============================================================================
+
+void test_derive_separates_keys(void) {
+    TEST_ASSERT_TRUE(SessionKeys_derive(&keys, secret, sizeof(secret)));
+    TEST_ASSERT_TRUE(keys.valid);
+    TEST_ASSERT_EQUAL_UINT32(0, keys.epoch);
+
+    const uint8_t* all[5] = {keys.chain, keys.c2vEnc, keys.c2vMac, keys.v2cEnc, keys.v2cMac};
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_FALSE(memcmp(all[i], secret, SESSION_KEY_SIZE) == 0);
+        for (int j = i + 1; j < 5; j++) TEST_ASSERT_FALSE(memcmp(all[i], all[j], SESSION_KEY_SIZE) == 0);
+    }
+}
+
+void test_derive_is_deterministic(void) {
+    SessionKeys other;
+    TEST_ASSERT_TRUE(SessionKeys_derive(&keys, secret, sizeof(secret)));
+    TEST_ASSERT_TRUE(SessionKeys_derive(&other, secret, sizeof(secret)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(keys.c2vEnc, other.c2vEnc, SESSION_KEY_SIZE);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(keys.v2cMac, other.v2cMac, SESSION_KEY_SIZE);
+}
+
+// ============================================================================
+// Ratchet Tests
+// ============================================================================
+
+void test_ratchet_replaces_keys(void) {
+    TEST_ASSERT_TRUE(SessionKeys_derive(&keys, secret, sizeof(secret)));
+    SessionKeys before = keys;
+
+    TEST_ASSERT_TRUE(SessionKeys_ratchet(&keys));
+    TEST_ASSERT_EQUAL_UINT32(1, keys.epoch);
+    TEST_ASSERT_FALSE(memcmp(before.chain, keys.chain, SESSION_KEY_SIZE) == 0);
+    TEST_ASSERT_FALSE(memcmp(before.c2vEnc, keys.c2vEnc, SESSION_KEY_SIZE) == 0);
+    TEST_ASSERT_FALSE(memcmp(before.v2cMac, keys.v2cMac, SESSION_KEY_SIZE) == 0);
+
+    // Both ends reach the same keys after the same number of steps
+    TEST_ASSERT_TRUE(SessionKeys_ratchet(&before));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(before.c2vMac, keys.c2vMac, SESSION_KEY_SIZE);
+}
+
+void test_ratchet_requires_session(void) {
+    TEST_ASSERT_FALSE(SessionKeys_ratchet(&keys));
+    TEST_ASSERT_EQUAL_INT32(-1, SessionKeys_stepsFor(&keys, 0));
+}
+
+// ============================================================================
+// Epoch Tracking Tests
+// ============================================================================
+
+void test_epoch_anchors_on_first_frame(void) {
+    const uint32_t interval = 1UL << SESSION_RATCHET_SHIFT;
+    uint32_t seq = 5 * interval + 100;
+    TEST_ASSERT_TRUE(SessionKeys_derive(&keys, secret, sizeof(secret)));
+
+    // Unanchored: any frame is tried with epoch-0 keys
+    TEST_ASSERT_EQUAL_INT32(0, SessionKeys_stepsFor(&keys, seq));
+    SessionKeys_accept(&keys, seq);
+    TEST_ASSERT_TRUE(keys.anchored);
+
+    TEST_ASSERT_EQUAL_INT32(0, SessionKeys_stepsFor(&keys, 6 * interval - 1));
+    TEST_ASSERT_EQUAL_INT32(1, SessionKeys_stepsFor(&keys, 6 * interval));
+    TEST_ASSERT_EQUAL_INT32(2, SessionKeys_stepsFor(&keys, 7 * interval));
+    TEST_ASSERT_EQUAL_INT32(-1, SessionKeys_stepsFor(&keys, 5 * interval - 1));
+
+    TEST_ASSERT_TRUE(SessionKeys_ratchet(&keys));
+    TEST_ASSERT_EQUAL_INT32(0, SessionKeys_stepsFor(&keys, 6 * interval));
+    TEST_ASSERT_EQUAL_INT32(-1, SessionKeys_stepsFor(&keys, 6 * interval - 1));
+}
+
+void test_link_key_follows_session(void) {
+    uint8_t a[SESSION_LINK_KEY_SIZE], b[SESSION_LINK_KEY_SIZE];
+    TEST_ASSERT_FALSE(SessionKeys_linkKey(&keys, a));
+    TEST_ASSERT_TRUE(SessionKeys_derive(&keys, secret, sizeof(secret)));
+    TEST_ASSERT_TRUE(SessionKeys_linkKey(&keys, a));
+    TEST_ASSERT_FALSE(memcmp(a, keys.c2vEnc, SESSION_LINK_KEY_SIZE) == 0);
+
+    // Same session, same key on both ends; a new one changes it
+    SessionKeys other;
+    TEST_ASSERT_TRUE(SessionKeys_derive(&other, secret, sizeof(secret)));
+    TEST_ASSERT_TRUE(SessionKeys_linkKey(&other, b));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(a, b, SESSION_LINK_KEY_SIZE);
+    TEST_ASSERT_TRUE(SessionKeys_ratchet(&other));
+    TEST_ASSERT_TRUE(SessionKeys_linkKey(&other, b));
+    TEST_ASSERT_FALSE(memcmp(a, b, SESSION_LINK_KEY_SIZE) == 0);
+}
+
+void test_wipe_clears_keys(void) {
+    uint8_t zero[SESSION_KEY_SIZE] = {0};
+    TEST_ASSERT_TRUE(SessionKeys_derive(&keys, secret, sizeof(secret)));
+    SessionKeys_wipe(&keys);
+    TEST_ASSERT_FALSE(keys.valid);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(zero, keys.chain, SESSION_KEY_SIZE);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(zero, keys.c2vEnc, SESSION_KEY_SIZE);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // HKDF Tests
+    RUN_TEST(test_hkdf_rfc5869_case1);
+    RUN_TEST(test_hkdf_rfc5869_case3_no_salt_no_info);
+
+    // Derivation Tests
+    RUN_TEST(test_derive_separates_keys);
+    RUN_TEST(test_derive_is_deterministic);
+
+    // Ratchet Tests
+    RUN_TEST(test_ratchet_replaces_keys);
+    RUN_TEST(test_ratchet_requires_session);
+
+    // Epoch Tracking Tests
+    RUN_TEST(test_epoch_anchors_on_first_frame);
+    RUN_TEST(test_link_key_follows_session);
+    RUN_TEST(test_wipe_clears_keys);
+
+    return UNITY_END();
+}
@@ -0,0 +1,200 @@
+/**
+ * Unit Tests for SessionResume
+ * Tests that controller and vehicle derive the same resumed session, that
+ * tickets are single use, bound to their MAC and expire, and that a bad
+ * binder is rejected without burning the ticket
+ *
+ * @file test_SessionResume.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "SessionResume.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static const uint8_t MAC[6] = {0x24, 0x6F, 0x28, 0x01, 0x02, 0x03};
+static const uint8_t OTHER_MAC[6] = {0x24, 0x6F, 0x28, 0x0A, 0x0B, 0x0C};
+
+static SessionResumeTable table;
+static SessionKeys handshake;       // Epoch-0 session both ends share
+static uint8_t cNonce[SESSION_RESUME_NONCE_SIZE];
+static uint8_t vNonce[SESSION_RESUME_NONCE_SIZE];
+
+// Controller side of a resume request
+static void controller_request(uint8_t id[SESSION_RESUME_ID_SIZE],
+                               uint8_t secret[SESSION_KEY_SIZE],
+                               uint8_t binder[SESSION_RESUME_TAG_SIZE]) {
+    TEST_ASSERT_TRUE(SessionResume_deriveTicket(&handshake, secret, id));
+    TEST_ASSERT_TRUE(SessionResume_binder(secret, id, cNonce, binder));
+}
+
+void setUp(void) {
+    uint8_t secret[32];
+    for (int i = 0; i < 32; i++) secret[i] = (uint8_t)(i * 7 + 1);
+    TEST_ASSERT_TRUE(SessionKeys_derive(&handshake, secret, sizeof(secret)));
+    memset(cNonce, 0xC1, sizeof(cNonce));
+    memset(vNonce, 0x5E, sizeof(vNonce));
+    SessionResume_init(&table);
+    TEST_ASSERT_TRUE(SessionResume_issue(&table, MAC, &handshake, 1000));
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Derivation Tests
+// ============================================================================
+
+void test_both_ends_derive_the_same_session(void) {
+    uint8_t id[SESSION_RESUME_ID_SIZE], secret[SESSION_KEY_SIZE], binder[SESSION_RESUME_TAG_SIZE];
+    controller_request(id, secret, binder);
+
+    SessionKeys vehicle;
+    uint8_t accept[SESSION_RESUME_TAG_SIZE];
+    TEST_ASSERT_EQUAL(SESSION_RESUME_OK, SessionResume_redeem(&table, MAC, id, cNonce, binder,
+                                                              vNonce, 2000, &vehicle, accept));
+
+    // Controller checks the answer and derives the same keys
+    uint8_t expected[SESSION_RESUME_TAG_SIZE];
+    TEST_ASSERT_TRUE(SessionResume_acceptTag(secret, id, cNonce, vNonce, expected));
+    TEST_ASSERT_EQUAL_MEMORY(expected, accept, sizeof(accept));
+    SessionKeys controller;
+    TEST_ASSERT_TRUE(SessionResume_deriveSession(secret, cNonce, vNonce, &controller));
+    TEST_ASSERT_EQUAL_MEMORY(controller.c2vEnc, vehicle.c2vEnc, SESSION_KEY_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(controller.v2cMac, vehicle.v2cMac, SESSION_KEY_SIZE);
+    TEST_ASSERT_TRUE(vehicle.valid);
+    TEST_ASSERT_EQUAL_UINT32(0, vehicle.epoch);
+
+    // Fresh keys, not the handshake's
+    TEST_ASSERT_FALSE(memcmp(handshake.c2vEnc, vehicle.c2vEnc, SESSION_KEY_SIZE) == 0);
+}
+
+void test_nonces_change_the_session(void) {
+    uint8_t secret[SESSION_KEY_SIZE], id[SESSION_RESUME_ID_SIZE];
+    TEST_ASSERT_TRUE(SessionResume_deriveTicket(&handshake, secret, id));
+    SessionKeys a, b;
+    TEST_ASSERT_TRUE(SessionResume_deriveSession(secret, cNonce, vNonce, &a));
+    vNonce[0] ^= 1;
+    TEST_ASSERT_TRUE(SessionResume_deriveSession(secret, cNonce, vNonce, &b));
+    TEST_ASSERT_FALSE(memcmp(a.c2vEnc, b.c2vEnc, SESSION_KEY_SIZE) == 0);
+}
+
+void test_no_ticket_after_ratchet_or_raw_keys(void) {
+    uint8_t secret[SESSION_KEY_SIZE], id[SESSION_RESUME_ID_SIZE];
+    SessionKeys ratcheted = handshake;
+    TEST_ASSERT_TRUE(SessionKeys_ratchet(&ratcheted));
+    TEST_ASSERT_FALSE(SessionResume_deriveTicket(&ratcheted, secret, id));
+
+    SessionKeys raw;
+    SessionKeys_wipe(&raw);     // Raw-secret sessions are not HKDF (valid = false)
+    TEST_ASSERT_FALSE(SessionResume_issue(&table, OTHER_MAC, &raw, 1000));
+}
+
+// ============================================================================
+// Ticket Tests
+// ============================================================================
+
+void test_ticket_is_single_use(void) {
+    uint8_t id[SESSION_RESUME_ID_SIZE], secret[SESSION_KEY_SIZE], binder[SESSION_RESUME_TAG_SIZE];
+    controller_request(id, secret, binder);
+    SessionKeys keys;
+    uint8_t accept[SESSION_RESUME_TAG_SIZE];
+    TEST_ASSERT_EQUAL(SESSION_RESUME_OK, SessionResume_redeem(&table, MAC, id, cNonce, binder,
+                                                              vNonce, 2000, &keys, accept));
+    // Replayed request
+    TEST_ASSERT_EQUAL(SESSION_RESUME_UNKNOWN, SessionResume_redeem(&table, MAC, id, cNonce,
+                                                                   binder, vNonce, 2100, &keys,
+                                                                   accept));
+
+    // The resumed session carries the next ticket
+    uint8_t nextSecret[SESSION_KEY_SIZE], nextId[SESSION_RESUME_ID_SIZE];
+    TEST_ASSERT_TRUE(SessionResume_deriveTicket(&keys, nextSecret, nextId));
+    TEST_ASSERT_TRUE(SessionResume_binder(nextSecret, nextId, cNonce, binder));
+    TEST_ASSERT_EQUAL(SESSION_RESUME_OK, SessionResume_redeem(&table, MAC, nextId, cNonce,
+                                                              binder, vNonce, 2200, &keys,
+                                                              accept));
+    TEST_ASSERT_EQUAL_UINT32(2, table.resumed);
+}
+
+void test_ticket_bound_to_mac(void) {
+    uint8_t id[SESSION_RESUME_ID_SIZE], secret[SESSION_KEY_SIZE], binder[SESSION_RESUME_TAG_SIZE];
+    controller_request(id, secret, binder);
+    SessionKeys keys;
+    uint8_t accept[SESSION_RESUME_TAG_SIZE];
+    TEST_ASSERT_EQUAL(SESSION_RESUME_UNKNOWN, SessionResume_redeem(&table, OTHER_MAC, id, cNonce,
+                                                                   binder, vNonce, 2000, &keys,
+                                                                   accept));
+}
+
+void test_bad_binder_keeps_ticket(void) {
+    uint8_t id[SESSION_RESUME_ID_SIZE], secret[SESSION_KEY_SIZE], binder[SESSION_RESUME_TAG_SIZE];
+    controller_request(id, secret, binder);
+    SessionKeys keys;
+    uint8_t accept[SESSION_RESUME_TAG_SIZE];
+    uint8_t forged[SESSION_RESUME_TAG_SIZE];
+    memcpy(forged, binder, sizeof(forged));
+    forged[5] ^= 0x80;
+    TEST_ASSERT_EQUAL(SESSION_RESUME_BAD_TAG, SessionResume_redeem(&table, MAC, id, cNonce,
+                                                                   forged, vNonce, 2000, &keys,
+                                                                   accept));
+    TEST_ASSERT_EQUAL(SESSION_RESUME_OK, SessionResume_redeem(&table, MAC, id, cNonce, binder,
+                                                              vNonce, 2000, &keys, accept));
+}
+
+void test_ticket_expires(void) {
+    uint8_t id[SESSION_RESUME_ID_SIZE], secret[SESSION_KEY_SIZE], binder[SESSION_RESUME_TAG_SIZE];
+    controller_request(id, secret, binder);
+    SessionKeys keys;
+    uint8_t accept[SESSION_RESUME_TAG_SIZE];
+    TEST_ASSERT_EQUAL(SESSION_RESUME_EXPIRED,
+                      SessionResume_redeem(&table, MAC, id, cNonce, binder, vNonce,
+                                           1000 + SESSION_RESUME_LIFETIME_MS + 1, &keys, accept));
+    TEST_ASSERT_EQUAL(SESSION_RESUME_UNKNOWN,
+                      SessionResume_redeem(&table, MAC, id, cNonce, binder, vNonce, 2000, &keys,
+                                           accept));
+}
+
+void test_full_table_drops_oldest(void) {
+    SessionKeys other;
+    uint8_t secret[32];
+    for (uint8_t n = 0; n < SESSION_RESUME_MAX; n++) {
+        uint8_t mac[6] = {0x02, 0, 0, 0, 0, n};
+        memset(secret, n + 1, sizeof(secret));
+        TEST_ASSERT_TRUE(SessionKeys_derive(&other, secret, sizeof(secret)));
+        TEST_ASSERT_TRUE(SessionResume_issue(&table, mac, &other, 2000 + n));
+    }
+    // MAC's ticket (issued at 1000) was the oldest
+    uint8_t id[SESSION_RESUME_ID_SIZE], binder[SESSION_RESUME_TAG_SIZE];
+    controller_request(id, secret, binder);
+    SessionKeys keys;
+    uint8_t accept[SESSION_RESUME_TAG_SIZE];
+    TEST_ASSERT_EQUAL(SESSION_RESUME_UNKNOWN, SessionResume_redeem(&table, MAC, id, cNonce,
+                                                                   binder, vNonce, 3000, &keys,
+                                                                   accept));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Derivation Tests
+    RUN_TEST(test_both_ends_derive_the_same_session);
+    RUN_TEST(test_nonces_change_the_session);
+    RUN_TEST(test_no_ticket_after_ratchet_or_raw_keys);
+
+    // Ticket Tests
+    RUN_TEST(test_ticket_is_single_use);
+    RUN_TEST(test_ticket_bound_to_mac);
+    RUN_TEST(test_bad_binder_keeps_ticket);
+    RUN_TEST(test_ticket_expires);
+    RUN_TEST(test_full_table_drops_oldest);
+
+    return UNITY_END();
+}
@@ -0,0 +1,273 @@
+/**
+ * Unit Tests for SimModel
+ * Tests the vehicle dynamics (direction conventions, steady states,
+ * limits) and the synthetic sensors
+ *
+ * @file test_SimModel.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "SimModel.h"
+
+#define ORIGIN_LAT 137000000    // 13.7 N
+#define ORIGIN_LNG 1005000000   // 100.5 E
+#define DT 0.02f
+
+static SimModel model;
+
+static void start(SimKind kind) {
+    SimParams params;
+    SimModel_defaultParams(kind, &params);
+    SimModel_init(&model, &params, ORIGIN_LAT, ORIGIN_LNG, 1234);
+}
+
+static void run(const float* outputs, uint8_t count, float seconds) {
+    int steps = (int)(seconds / DT + 0.5f);
+    for (int i = 0; i < steps; i++) SimModel_step(&model, outputs, count, DT);
+}
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Rover Tests
+// ============================================================================
+
+void test_rover_drives_straight_north(void) {
+    start(SIM_ROVER);
+    float out[2] = {1.0f, 1.0f};
+    run(out, 2, 10.0f);
+    // 1.5 m/s for 10 s, less the motor lag at the start
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 14.8f, model.state.north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, model.state.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.5f, model.state.velN);
+}
+
+void test_rover_left_faster_turns_right(void) {
+    start(SIM_ROVER);
+    float out[2] = {1.0f, 0.5f};
+    run(out, 2, 1.0f);
+    TEST_ASSERT_TRUE(model.state.rates[2] > 0.0f);      // Clockwise
+    TEST_ASSERT_TRUE(model.state.yaw > 0.5f);
+    TEST_ASSERT_TRUE(model.state.east > 0.0f);
+}
+
+void test_rover_spins_in_place(void) {
+    start(SIM_ROVER);
+    float out[2] = {-0.5f, 0.5f};
+    run(out, 2, 2.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, model.state.north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -6.0f, model.state.rates[2]); // 1.5 m/s over 0.25 m
+    TEST_ASSERT_TRUE(model.state.yaw >= 0.0f && model.state.yaw < 2.0f * M_PI);
+}
+
+// ============================================================================
+// Boat Tests
+// ============================================================================
+
+void test_boat_reaches_drag_limited_speed(void) {
+    start(SIM_BOAT);
+    float out[2] = {1.0f, 1.0f};
+    run(out, 2, 20.0f);
+    float top = 2.0f * model.params.maxThrust / model.params.surgeDrag;
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, top, model.state.velN);
+}
+
+void test_boat_drifts_with_current(void) {
+    start(SIM_BOAT);
+    model.params.currentE = 0.5f;
+    run(NULL, 0, 20.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, model.state.velE);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 10.0f, model.state.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, model.state.yaw);
+}
+
+void test_boat_differential_thrust_yaws(void) {
+    start(SIM_BOAT);
+    float out[2] = {0.5f, -0.5f};
+    run(out, 2, 2.0f);
+    TEST_ASSERT_TRUE(model.state.rates[2] > 0.5f);
+}
+
+// ============================================================================
+// Sub Tests
+// ============================================================================
+
+void test_sub_floats_at_the_surface(void) {
+    start(SIM_SUB);
+    run(NULL, 0, 10.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, model.state.down);
+}
+
+void test_sub_dives_on_the_vertical_thruster(void) {
+    start(SIM_SUB);
+    float out[3] = {0.0f, 0.0f, -1.0f};                 // Thruster 2 pushes up
+    run(out, 3, 20.0f);
+    // Terminal rate (20 N - 2 N buoyancy) / 40 N per m/s
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.45f, model.state.velD);
+    TEST_ASSERT_TRUE(model.state.down > 7.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, model.state.north);
+}
+
+void test_sub_bow_thruster_yaws_right(void) {
+    start(SIM_SUB);
+    float out[3] = {0.0f, 0.5f, 0.0f};
+    run(out, 3, 2.0f);
+    TEST_ASSERT_TRUE(model.state.rates[2] > 0.0f);
+}
+
+// ============================================================================
+// Copter Tests
+// ============================================================================
+
+void test_copter_stays_down_without_thrust(void) {
+    start(SIM_COPTER);
+    run(NULL, 0, 2.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, model.state.down);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, model.state.velD);
+}
+
+void test_copter_climbs_and_hovers(void) {
+    start(SIM_COPTER);
+    float hover = model.params.mass * SIM_GRAVITY / (4.0f * model.params.maxThrust);
+    float climb[4] = {0.8f, 0.8f, 0.8f, 0.8f};
+    run(climb, 4, 1.0f);
+    TEST_ASSERT_TRUE(model.state.down < -1.0f);
+
+    float level[4] = {hover, hover, hover, hover};
+    run(level, 4, 20.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, model.state.velD);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, model.state.roll);
+}
+
+void test_copter_mixer_directions(void) {
+    start(SIM_COPTER);
+    float climb[4] = {0.8f, 0.8f, 0.8f, 0.8f};
+    run(climb, 4, 1.0f);
+    // MotorMixer QuadX rows: roll right = FL + BL up, nose up = FR + FL up
+    float roll[4] = {0.7f, 0.8f, 0.8f, 0.7f};
+    run(roll, 4, 0.2f);
+    TEST_ASSERT_TRUE(model.state.rates[0] > 0.0f);
+    TEST_ASSERT_TRUE(model.state.roll > 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, model.state.rates[1]);
+
+    start(SIM_COPTER);
+    run(climb, 4, 1.0f);
+    float yaw[4] = {0.7f, 0.8f, 0.7f, 0.8f};            // Nose right: FL + BR up
+    run(yaw, 4, 0.2f);
+    TEST_ASSERT_TRUE(model.state.rates[2] > 0.0f);
+}
+
+void test_copter_tilt_moves_toward_the_low_side(void) {
+    start(SIM_COPTER);
+    float climb[4] = {0.8f, 0.8f, 0.8f, 0.8f};
+    run(climb, 4, 1.0f);
+    model.state.pitch = -0.2f;                          // Nose down
+    float hover[4] = {0.55f, 0.55f, 0.55f, 0.55f};
+    run(hover, 4, 0.5f);
+    TEST_ASSERT_TRUE(model.state.velN > 0.3f);
+}
+
+// ============================================================================
+// Sensor Tests
+// ============================================================================
+
+void test_gps_fix_at_origin(void) {
+    start(SIM_ROVER);
+    model.gpsNoiseM = 0.0f;
+    GPSFix fix;
+    SimModel_gps(&model, 1000, &fix);
+    TEST_ASSERT_TRUE(fix.valid);
+    TEST_ASSERT_EQUAL_UINT8(3, fix.fixType);
+    TEST_ASSERT_INT_WITHIN(1, ORIGIN_LAT, fix.lat);
+    TEST_ASSERT_INT_WITHIN(1, ORIGIN_LNG, fix.lng);
+    TEST_ASSERT_EQUAL_UINT32(1000, fix.timeMs);
+}
+
+void test_gps_position_and_course_follow_motion(void) {
+    start(SIM_ROVER);
+    model.gpsNoiseM = 0.0f;
+    model.state.yaw = (float)M_PI / 2.0f;               // East
+    float out[2] = {1.0f, 1.0f};
+    run(out, 2, 10.0f);
+    GPSFix fix;
+    SimModel_gps(&model, 0, &fix);
+    NavVector p = NavFrame_toLocal(&model.frame, fix.lat, fix.lng);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, model.state.east, p.east);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, p.north);
+    TEST_ASSERT_INT_WITHIN(10000, 9000000, fix.course);    // 90 deg +- 0.1
+    TEST_ASSERT_INT_WITHIN(10, 1500, fix.groundSpeed);
+
+    // Stopped: the receiver keeps the last heading of motion
+    float stop[2] = {0.0f, 0.0f};
+    run(stop, 2, 2.0f);
+    SimModel_gps(&model, 0, &fix);
+    TEST_ASSERT_INT_WITHIN(10000, 9000000, fix.course);
+}
+
+void test_noise_is_seeded(void) {
+    SimParams params;
+    SimModel_defaultParams(SIM_SUB, &params);
+    SimModel a, b;
+    SimModel_init(&a, &params, ORIGIN_LAT, ORIGIN_LNG, 99);
+    SimModel_init(&b, &params, ORIGIN_LAT, ORIGIN_LNG, 99);
+    float spread = 0.0f;
+    for (int i = 0; i < 100; i++) {
+        float da = SimModel_depth(&a);
+        TEST_ASSERT_EQUAL_FLOAT(da, SimModel_depth(&b));
+        spread += fabsf(da);
+    }
+    TEST_ASSERT_TRUE(spread > 0.0f);
+    TEST_ASSERT_TRUE(spread / 100.0f < 3.0f * a.depthNoiseM);
+}
+
+void test_kind_names(void) {
+    TEST_ASSERT_EQUAL(SIM_BOAT, SimModel_kindFromName("boat"));
+    TEST_ASSERT_EQUAL(SIM_COPTER, SimModel_kindFromName("Copter"));
+    TEST_ASSERT_EQUAL(SIM_KIND_COUNT, SimModel_kindFromName("plane"));
+    TEST_ASSERT_EQUAL(SIM_KIND_COUNT, SimModel_kindFromName(NULL));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Rover Tests
+    RUN_TEST(test_rover_drives_straight_north);
+    RUN_TEST(test_rover_left_faster_turns_right);
+    RUN_TEST(test_rover_spins_in_place);
+
+    // Boat Tests
+    RUN_TEST(test_boat_reaches_drag_limited_speed);
+    RUN_TEST(test_boat_drifts_with_current);
+    RUN_TEST(test_boat_differential_thrust_yaws);
+
+    // Sub Tests
+    RUN_TEST(test_sub_floats_at_the_surface);
+    RUN_TEST(test_sub_dives_on_the_vertical_thruster);
+    RUN_TEST(test_sub_bow_thruster_yaws_right);
+
+    // Copter Tests
+    RUN_TEST(test_copter_stays_down_without_thrust);
+    RUN_TEST(test_copter_climbs_and_hovers);
+    RUN_TEST(test_copter_mixer_directions);
+    RUN_TEST(test_copter_tilt_moves_toward_the_low_side);
+
+    // Sensor Tests
+    RUN_TEST(test_gps_fix_at_origin);
+    RUN_TEST(test_gps_position_and_course_follow_motion);
+    RUN_TEST(test_noise_is_seeded);
+    RUN_TEST(test_kind_names);
+
+    return UNITY_END();
+}
@@ -0,0 +1,136 @@
+/**
+ * Unit Tests for SpeedProfile
+ * Tests corner speeds from the turn angle, the braking curve ahead of a
+ * turn and the acceleration / jerk limits of the commanded speed
+ *
+ * @file test_SpeedProfile.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "SpeedProfile.h"
+#include <math.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DT 0.02f
+
+static SpeedProfileConfig config;
+static SpeedProfileState state;
+
+void setUp(void) {
+    SpeedProfile_defaults(&config);
+    config.minFraction = 0.4f;
+    SpeedProfile_reset(&state, 0.0f);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Planning Tests
+// ============================================================================
+
+void test_corner_fraction_follows_turn(void) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, SpeedProfile_cornerFraction(&config, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.7f, SpeedProfile_cornerFraction(&config, 90.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.7f, SpeedProfile_cornerFraction(&config, -90.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.4f, SpeedProfile_cornerFraction(&config, 180.0f));
+    TEST_ASSERT_TRUE(SpeedProfile_cornerFraction(&config, 20.0f) > 0.95f);
+}
+
+void test_plan_leg(void) {
+    SpeedLegPlan plan;
+    // 1500 saturates the mixer: planned as full scale; slower next leg caps the corner
+    SpeedProfile_planLeg(&config, 1500.0f, 600.0f, 0.0f, &plan);
+    TEST_ASSERT_EQUAL_FLOAT(SPEED_PROFILE_MAX, plan.speed);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 600.0f, plan.cornerSpeed);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, config.brakeM * 0.64f, plan.brakeM);
+
+    // Path end: entered at minFraction
+    SpeedProfile_planLeg(&config, 500.0f, -1.0f, 0.0f, &plan);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 200.0f, plan.cornerSpeed);
+
+    // Straight on at the same speed: no braking at all
+    SpeedProfile_planLeg(&config, 800.0f, 800.0f, 0.0f, &plan);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, plan.brakeM);
+    TEST_ASSERT_EQUAL_FLOAT(800.0f, SpeedProfile_target(&plan, 0.5f));
+}
+
+void test_target_brakes_towards_corner(void) {
+    SpeedLegPlan plan;
+    SpeedProfile_planLeg(&config, 1000.0f, 1000.0f, 90.0f, &plan);
+    TEST_ASSERT_EQUAL_FLOAT(1000.0f, SpeedProfile_target(&plan, plan.brakeM + 1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 700.0f, SpeedProfile_target(&plan, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 700.0f, SpeedProfile_target(&plan, -3.0f));
+    // Constant deceleration: v^2 halfway between the ends
+    float mid = SpeedProfile_target(&plan, plan.brakeM * 0.5f);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, (1000.0f * 1000.0f + 700.0f * 700.0f) * 0.5f, mid * mid);
+}
+
+// ============================================================================
+// Follower Tests
+// ============================================================================
+
+void test_step_respects_accel_and_jerk(void) {
+    float prevSpeed = 0.0f;
+    float prevAccel = 0.0f;
+    float maxAccel = 0.0f;
+    int ticks = 0;
+    while (state.speed < 1000.0f && ticks < 1000) {
+        float v = SpeedProfile_step(&config, &state, 1000.0f, DT);
+        float a = (v - prevSpeed) / DT;
+        TEST_ASSERT_TRUE(a <= config.accel + 1e-2f);
+        if (v < 1000.0f)
+            TEST_ASSERT_TRUE(fabsf(a - prevAccel) <= config.jerk * DT + 1e-2f);
+        if (a > maxAccel) maxAccel = a;
+        prevSpeed = v;
+        prevAccel = a;
+        ticks++;
+    }
+    TEST_ASSERT_EQUAL_FLOAT(1000.0f, state.speed);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, config.accel, maxAccel);
+    // Accel phase 1000 / 800 s plus the jerk ramps: well under two seconds
+    TEST_ASSERT_TRUE(ticks * DT < 2.0f);
+}
+
+void test_step_settles_without_overshoot(void) {
+    SpeedProfile_reset(&state, 1000.0f);
+    for (int i = 0; i < 200; i++) {
+        float v = SpeedProfile_step(&config, &state, 400.0f, DT);
+        TEST_ASSERT_TRUE(v >= 400.0f);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(400.0f, state.speed);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, state.accel);
+}
+
+void test_sanitize(void) {
+    config.accel = -5.0f;
+    config.minFraction = 3.0f;
+    config.brakeM = 1e6f;
+    SpeedProfile_sanitize(&config);
+    TEST_ASSERT_TRUE(config.accel > 0.0f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, config.minFraction);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, config.brakeM);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Planning Tests
+    RUN_TEST(test_corner_fraction_follows_turn);
+    RUN_TEST(test_plan_leg);
+    RUN_TEST(test_target_brakes_towards_corner);
+
+    // Follower Tests
+    RUN_TEST(test_step_respects_accel_and_jerk);
+    RUN_TEST(test_step_settles_without_overshoot);
+    RUN_TEST(test_sanitize);
+
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**
+ * Unit Tests for StatusScreen
+ * Tests the row layout, mode priority and the placeholders for state
+ * that is not known yet
+ *
+ * @file test_StatusScreen.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "StatusScreen.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static StatusScreenData data;
+static char lines[STATUS_SCREEN_ROWS][STATUS_SCREEN_COLUMNS + 1];
+
+void setUp(void) {
+    memset(&data, 0, sizeof(data));
+    data.vehicle = "ROVER";
+    memset(lines, 'x', sizeof(lines));
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Layout Tests
+// ============================================================================
+
+void test_nothing_known_yet(void) {
+    StatusScreen_format(&data, lines);
+    TEST_ASSERT_EQUAL_STRING("ROVER          MANUAL", lines[0]);
+    TEST_ASSERT_EQUAL_STRING("BAT --", lines[1]);
+    TEST_ASSERT_EQUAL_STRING("LINK --", lines[2]);
+    TEST_ASSERT_EQUAL_STRING("GPS --", lines[3]);
+    TEST_ASSERT_EQUAL_STRING("WP --", lines[4]);
+    TEST_ASSERT_EQUAL_STRING("", lines[5]);
+    TEST_ASSERT_EQUAL_STRING("UP 00:00:00", lines[7]);
+}
+
+void test_full_status(void) {
+    data.link = STATUS_LINK_OK;
+    data.batteryValid = true;
+    data.millivolts = 11843;
+    data.percent = 78;
+    data.gpsValid = true;
+    data.fixType = 3;
+    data.numSV = 12;
+    data.hAccMm = 1380;
+    data.missionActive = true;
+    data.waypointIndex = 2;
+    data.waypointCount = 12;
+    data.distanceM = 45.4f;
+    data.uptimeS = 3723;
+    StatusScreen_format(&data, lines);
+    TEST_ASSERT_EQUAL_STRING("ROVER            AUTO", lines[0]);
+    TEST_ASSERT_EQUAL_STRING("BAT 11.84V  78%", lines[1]);
+    TEST_ASSERT_EQUAL_STRING("LINK OK", lines[2]);
+    TEST_ASSERT_EQUAL_STRING("GPS 3D 12sv 1.4m", lines[3]);
+    TEST_ASSERT_EQUAL_STRING("WP 3/12 45m", lines[4]);
+    TEST_ASSERT_EQUAL_STRING("UP 01:02:03", lines[7]);
+}
+
+void test_rows_fit_the_display(void) {
+    data.vehicle = "A VERY LONG VEHICLE NAME";
+    data.rtlActive = true;
+    data.distanceM = 1.0e9f;
+    data.gpsValid = true;
+    data.fixType = 3;
+    data.numSV = 255;
+    data.hAccMm = 4000000000u;
+    data.uptimeS = 0xFFFFFFFFu;
+    StatusScreen_format(&data, lines);
+    for (int i = 0; i < STATUS_SCREEN_ROWS; i++)
+        TEST_ASSERT_TRUE(strlen(lines[i]) <= STATUS_SCREEN_COLUMNS);
+    TEST_ASSERT_EQUAL_STRING("A VERY LONG VEHIC RTL", lines[0]);
+    TEST_ASSERT_EQUAL_STRING("HOME 99999m", lines[4]);
+}
+
+// ============================================================================
+// Mode Tests
+// ============================================================================
+
+void test_mode_priority(void) {
+    data.missionActive = true;
+    data.loitering = true;
+    TEST_ASSERT_EQUAL_STRING("LOITER", StatusScreen_mode(&data));
+    data.following = true;
+    TEST_ASSERT_EQUAL_STRING("FOLLOW", StatusScreen_mode(&data));
+    data.rtlActive = true;
+    TEST_ASSERT_EQUAL_STRING("RTL", StatusScreen_mode(&data));
+}
+
+void test_link_and_fix_states(void) {
+    data.link = STATUS_LINK_FAILSAFE;
+    data.gpsValid = true;
+    data.numSV = 4;
+    data.waypointCount = 6;
+    StatusScreen_format(&data, lines);
+    TEST_ASSERT_EQUAL_STRING("LINK FAILSAFE", lines[2]);
+    TEST_ASSERT_EQUAL_STRING("GPS NO FIX 4sv", lines[3]);
+    TEST_ASSERT_EQUAL_STRING("WP 6 loaded", lines[4]);
+}
+
+void test_rtk_fix_states(void) {
+    data.gpsValid = true;
+    data.fixType = 3;
+    data.numSV = 18;
+    data.hAccMm = 340;
+    data.carrSoln = 1;
+    StatusScreen_format(&data, lines);
+    TEST_ASSERT_EQUAL_STRING("GPS FLT 18sv 0.3m", lines[3]);
+    data.carrSoln = 2;
+    data.hAccMm = 14;
+    StatusScreen_format(&data, lines);
+    TEST_ASSERT_EQUAL_STRING("GPS RTK 18sv 1cm", lines[3]);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Layout Tests
+    RUN_TEST(test_nothing_known_yet);
+    RUN_TEST(test_full_status);
+    RUN_TEST(test_rows_fit_the_display);
+
+    // Mode Tests
+    RUN_TEST(test_mode_priority);
+    RUN_TEST(test_link_and_fix_states);
+    RUN_TEST(test_rtk_fix_states);
+
+    return UNITY_END();
+}
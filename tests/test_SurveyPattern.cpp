@@ -0,0 +1,152 @@
+/**
+ * Unit Tests for SurveyPattern
+ * Tests lawnmower tracks, spacing, heading, polygons and the spiral
+ *
+ * @file test_SurveyPattern.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "SurveyPattern.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define MAX_POINTS 64
+
+static SurveyPattern survey;
+static NavVector points[MAX_POINTS];
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static int generate(void) {
+    int n = 0;
+    while (n < MAX_POINTS && SurveyPattern_next(&survey, &points[n])) n++;
+    return n;
+}
+
+// ============================================================================
+// Lawnmower Tests
+// ============================================================================
+
+void test_rectangle_north_tracks(void) {
+    // 40 m wide (east), 100 m long (north), 10 m spacing: 4 tracks at 5, 15, 25, 35
+    NavVector center = {20.0f, 50.0f};
+    TEST_ASSERT_TRUE(SurveyPattern_initRect(&survey, SURVEY_LAWNMOWER, center, 40.0f, 100.0f, 10.0f, 0.0f));
+    TEST_ASSERT_EQUAL_INT(8, generate());
+
+    const float east[4] = {5.0f, 15.0f, 25.0f, 35.0f};
+    for (int t = 0; t < 4; t++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, east[t], points[2 * t].east);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, east[t], points[2 * t + 1].east);
+    }
+    // Out north, back south
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, points[0].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, points[1].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, points[2].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, points[3].north);
+    TEST_ASSERT_FALSE(SurveyPattern_next(&survey, &points[0]));
+}
+
+void test_spacing_never_exceeded(void) {
+    // 45 m wide: 5 tracks 8.75 m apart rather than a 10 m grid that misses 5 m
+    NavVector center = {0.0f, 0.0f};
+    SurveyPattern_initRect(&survey, SURVEY_LAWNMOWER, center, 45.0f, 20.0f, 10.0f, 0.0f);
+    int n = generate();
+    TEST_ASSERT_EQUAL_INT(10, n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -17.5f, points[0].east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 17.5f, points[n - 1].east);
+    for (int i = 2; i < n; i += 2) {
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 8.75f, points[i].east - points[i - 2].east);
+    }
+}
+
+void test_heading_rotates_tracks(void) {
+    // Tracks along 90 deg (east), stepping south (right of track)
+    NavVector center = {0.0f, 0.0f};
+    SurveyPattern_initRect(&survey, SURVEY_LAWNMOWER, center, 20.0f, 60.0f, 10.0f, 90.0f);
+    TEST_ASSERT_EQUAL_INT(4, generate());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -30.0f, points[0].east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, points[0].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, points[1].east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -5.0f, points[2].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, points[2].east);
+}
+
+void test_triangle_tracks_follow_edges(void) {
+    // Right triangle, legs 40 m east and 40 m north: tracks shorten eastwards
+    NavVector tri[3] = {{0.0f, 0.0f}, {40.0f, 0.0f}, {0.0f, 40.0f}};
+    TEST_ASSERT_TRUE(SurveyPattern_initPolygon(&survey, SURVEY_LAWNMOWER, tri, 3, 10.0f, 0.0f));
+    TEST_ASSERT_EQUAL_INT(8, generate());
+    // Track at east = 5: north 0..35; at east = 35: north 0..5
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 35.0f, points[1].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, points[6].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, points[7].north);
+}
+
+void test_narrow_area_is_one_track(void) {
+    NavVector center = {0.0f, 0.0f};
+    SurveyPattern_initRect(&survey, SURVEY_LAWNMOWER, center, 4.0f, 50.0f, 10.0f, 0.0f);
+    TEST_ASSERT_EQUAL_INT(2, generate());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, points[0].east);
+}
+
+void test_restart_and_bad_input(void) {
+    NavVector center = {0.0f, 0.0f};
+    SurveyPattern_initRect(&survey, SURVEY_LAWNMOWER, center, 40.0f, 100.0f, 10.0f, 0.0f);
+    generate();
+    SurveyPattern_restart(&survey);
+    TEST_ASSERT_EQUAL_INT(8, generate());
+
+    NavVector two[2] = {{0.0f, 0.0f}, {1.0f, 1.0f}};
+    TEST_ASSERT_FALSE(SurveyPattern_initPolygon(&survey, SURVEY_LAWNMOWER, two, 2, 10.0f, 0.0f));
+    TEST_ASSERT_FALSE(SurveyPattern_initRect(&survey, SURVEY_LAWNMOWER, center, 10.0f, 10.0f, 0.0f, 0.0f));
+}
+
+// ============================================================================
+// Spiral Tests
+// ============================================================================
+
+void test_spiral_laps_inward(void) {
+    // 40 x 40 m, 10 m laps: insets 5 and 15, then the centre is reached
+    NavVector center = {0.0f, 0.0f};
+    SurveyPattern_initRect(&survey, SURVEY_SPIRAL, center, 40.0f, 40.0f, 10.0f, 0.0f);
+    TEST_ASSERT_EQUAL_INT(8, generate());
+
+    // Lap 0 (heading north, cross = east): SW, NW, NE, SE corners at 15 m
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -15.0f, points[0].east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -15.0f, points[0].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, points[1].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, points[2].east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -15.0f, points[3].north);
+
+    // Lap 1 starts on lap 0's last side, 10 m in
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -5.0f, points[4].east);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -15.0f, points[4].north);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, points[5].north);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Lawnmower Tests
+    RUN_TEST(test_rectangle_north_tracks);
+    RUN_TEST(test_spacing_never_exceeded);
+    RUN_TEST(test_heading_rotates_tracks);
+    RUN_TEST(test_triangle_tracks_follow_edges);
+    RUN_TEST(test_narrow_area_is_one_track);
+    RUN_TEST(test_restart_and_bad_input);
+
+    // Spiral Tests
+    RUN_TEST(test_spiral_laps_inward);
+
+    return UNITY_END();
+}
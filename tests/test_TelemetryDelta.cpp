@@ -0,0 +1,163 @@
+/**
+ * Unit Tests for TelemetryDelta
+ * Tests keyframe / delta round trip, key references and corruption handling
+ *
+ * @file test_TelemetryDelta.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "TelemetryDelta.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static TelemetryDeltaEncoder enc;
+static TelemetryDeltaDecoder dec;
+static uint8_t frame[sizeof(NATelemetry)];
+
+static NATelemetry makeTelemetry(uint32_t uptime) {
+    NATelemetry t;
+    memset(&t, 0, sizeof(t));
+    t.protocolVersion = PROTOCOL_VERSION;
+    t.batteryVoltage = 11.1f;
+    t.rssi = -60;
+    t.uptime = uptime;
+    t.latitude = 13.756331f;
+    t.longitude = 100.501762f;
+    t.status = 0x02;
+    NA_UPDATE_TELEMETRY_CHECKSUM(&t);
+    return t;
+}
+
+void setUp(void) {
+    TelemetryDelta_initEncoder(&enc);
+    TelemetryDelta_initDecoder(&dec);
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Round Trip Tests
+// ============================================================================
+
+void test_first_frame_is_keyframe(void) {
+    NATelemetry t = makeTelemetry(1000);
+    bool isKey = false;
+
+    size_t len = TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), &isKey);
+    TEST_ASSERT_TRUE(isKey);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(NATelemetry), len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY((uint8_t*)&t, frame, sizeof(t));
+}
+
+void test_delta_round_trip(void) {
+    NATelemetry key = makeTelemetry(1000);
+    NATelemetry out;
+    size_t len = TelemetryDelta_encode(&enc, &key, frame, sizeof(frame), NULL);
+    TEST_ASSERT_TRUE(TelemetryDelta_decode(&dec, frame, len, &out));
+
+    NATelemetry t = makeTelemetry(1050);
+    t.batteryVoltage = 11.05f;
+    t.rssi = -63;
+    t.latitude = 13.756341f;
+    NA_UPDATE_TELEMETRY_CHECKSUM(&t);
+
+    bool isKey = true;
+    len = TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), &isKey);
+    TEST_ASSERT_FALSE(isKey);
+    TEST_ASSERT_TRUE(len <= TELEMETRY_DELTA_MAX_FRAME);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_DELTA_TYPE, frame[0]);
+
+    TEST_ASSERT_TRUE(TelemetryDelta_decode(&dec, frame, len, &out));
+    TEST_ASSERT_EQUAL_UINT32(1050, out.uptime);
+    TEST_ASSERT_EQUAL_INT(-63, out.rssi);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 11.05f, out.batteryVoltage);
+    TEST_ASSERT_FLOAT_WITHIN(0.000002f, 13.756341f, out.latitude);
+    TEST_ASSERT_EQUAL_FLOAT(key.longitude, out.longitude);
+    TEST_ASSERT_TRUE(NA_VERIFY_TELEMETRY(&out));
+}
+
+void test_uptime_only_delta_is_small(void) {
+    NATelemetry t = makeTelemetry(1000);
+    TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), NULL);
+
+    t = makeTelemetry(1050);
+    size_t len = TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), NULL);
+    // header(4) + 1-byte varint + crc(2)
+    TEST_ASSERT_EQUAL_UINT32(7, len);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_DELTA_F_UPTIME, frame[3]);
+}
+
+void test_keyframe_interval(void) {
+    bool isKey = false;
+    for (uint32_t i = 0; i < TELEMETRY_DELTA_KEYFRAME_INTERVAL; i++) {
+        NATelemetry t = makeTelemetry(1000 + i * 50);
+        TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), &isKey);
+        TEST_ASSERT_EQUAL(i == 0, isKey);
+    }
+    NATelemetry t = makeTelemetry(5000);
+    TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), &isKey);
+    TEST_ASSERT_TRUE(isKey);
+}
+
+void test_encrypted_always_keyframe(void) {
+    NATelemetry t = makeTelemetry(1000);
+    t.encryptionFlag = 1;
+    bool isKey = false;
+
+    TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), &isKey);
+    t.uptime = 1050;
+    TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), &isKey);
+    TEST_ASSERT_TRUE(isKey);
+}
+
+// ============================================================================
+// Rejection Tests
+// ============================================================================
+
+void test_delta_without_keyframe_rejected(void) {
+    NATelemetry t = makeTelemetry(1000);
+    NATelemetry out;
+    TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), NULL);
+
+    t = makeTelemetry(1050);
+    size_t len = TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), NULL);
+    TEST_ASSERT_FALSE(TelemetryDelta_decode(&dec, frame, len, &out));
+}
+
+void test_corrupted_delta_rejected(void) {
+    NATelemetry t = makeTelemetry(1000);
+    NATelemetry out;
+    size_t len = TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), NULL);
+    TelemetryDelta_decode(&dec, frame, len, &out);
+
+    t = makeTelemetry(1050);
+    len = TelemetryDelta_encode(&enc, &t, frame, sizeof(frame), NULL);
+    frame[4] ^= 0x01;
+    TEST_ASSERT_FALSE(TelemetryDelta_decode(&dec, frame, len, &out));
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Round Trip Tests
+    RUN_TEST(test_first_frame_is_keyframe);
+    RUN_TEST(test_delta_round_trip);
+    RUN_TEST(test_uptime_only_delta_is_small);
+    RUN_TEST(test_keyframe_interval);
+    RUN_TEST(test_encrypted_always_keyframe);
+
+    // Rejection Tests
+    RUN_TEST(test_delta_without_keyframe_rejected);
+    RUN_TEST(test_corrupted_delta_rejected);
+
+    return UNITY_END();
+}
@@ -0,0 +1,121 @@
+/**
+ * Unit Tests for TelemetryHistory
+ * Tests decimation, fixed-point records and the oldest-first copy across
+ * the ring wrap
+ *
+ * @file test_TelemetryHistory.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "TelemetryHistory.h"
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static TelemetryHistory history;
+static TelemetryHistoryRecord records[4];
+
+static TelemetrySnapshot snapAt(uint32_t uptime) {
+    TelemetrySnapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    snap.uptime = uptime;
+    return snap;
+}
+
+void setUp(void) {
+    memset(records, 0, sizeof(records));
+    TelemetryHistory_init(&history, records, 4);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Ring Tests
+// ============================================================================
+
+void test_decimates_by_uptime(void) {
+    // 50 ms ticks: every 5th one is kept
+    uint16_t kept = 0;
+    for (uint32_t t = 1000; t < 1500; t += 50) {
+        TelemetrySnapshot snap = snapAt(t);
+        if (TelemetryHistory_push(&history, &snap)) kept++;
+    }
+    TEST_ASSERT_EQUAL_UINT16(2, kept);
+    TEST_ASSERT_EQUAL_UINT16(2, history.count);
+    TEST_ASSERT_EQUAL_UINT32(1250, history.lastUptime);
+}
+
+void test_record_fixed_point(void) {
+    TelemetrySnapshot snap = snapAt(100);
+    snap.batteryMv = 12600;
+    snap.rssi = -61;
+    snap.latE7 = 137563000;
+    snap.lngE7 = 1005018000;
+    snap.depth = -1.234f;
+    snap.heading = -90.0f;
+    snap.groundSpeed = 1.5f;
+    snap.wpIndex = 3;
+    snap.navFlags = TELEMETRY_NAV_MISSION_ACTIVE;
+    snap.cpuPct = 140.0f;
+    TelemetryHistory_push(&history, &snap);
+
+    TelemetryHistoryRecord r;
+    TEST_ASSERT_EQUAL_UINT16(1, TelemetryHistory_copy(&history, &r, 1));
+    TEST_ASSERT_EQUAL_UINT16(12600, r.batteryMv);
+    TEST_ASSERT_EQUAL_INT8(-61, r.rssi);
+    TEST_ASSERT_EQUAL_INT32(137563000, r.latE7);
+    TEST_ASSERT_EQUAL_INT16(-123, r.depthCm);
+    TEST_ASSERT_EQUAL_UINT16(2700, r.headingDeci);
+    TEST_ASSERT_EQUAL_UINT16(150, r.speedCms);
+    TEST_ASSERT_EQUAL_UINT16(3, r.wpIndex);
+    TEST_ASSERT_EQUAL_UINT8(100, r.cpuPct);
+}
+
+void test_copy_oldest_first_after_wrap(void) {
+    for (uint32_t i = 0; i < 6; i++) {
+        TelemetrySnapshot snap = snapAt(i * TELEMETRY_HISTORY_INTERVAL_MS);
+        TelemetryHistory_push(&history, &snap);
+    }
+    TEST_ASSERT_EQUAL_UINT16(4, history.count);
+
+    // Unaligned destination, as behind the frame header
+    uint8_t out[1 + 4 * sizeof(TelemetryHistoryRecord)];
+    TEST_ASSERT_EQUAL_UINT16(4, TelemetryHistory_copy(&history, out + 1, 4));
+    for (uint32_t i = 0; i < 4; i++) {
+        TelemetryHistoryRecord r;
+        memcpy(&r, out + 1 + i * sizeof(r), sizeof(r));
+        TEST_ASSERT_EQUAL_UINT32((i + 2) * TELEMETRY_HISTORY_INTERVAL_MS, r.uptime);
+    }
+
+    // Fewer than stored: the newest ones
+    TelemetryHistoryRecord two[2];
+    TEST_ASSERT_EQUAL_UINT16(2, TelemetryHistory_copy(&history, two, 2));
+    TEST_ASSERT_EQUAL_UINT32(4 * TELEMETRY_HISTORY_INTERVAL_MS, two[0].uptime);
+    TEST_ASSERT_EQUAL_UINT32(5 * TELEMETRY_HISTORY_INTERVAL_MS, two[1].uptime);
+}
+
+void test_no_buffer_keeps_nothing(void) {
+    TelemetryHistory_init(&history, NULL, 4);
+    TelemetrySnapshot snap = snapAt(0);
+    TEST_ASSERT_FALSE(TelemetryHistory_push(&history, &snap));
+    TEST_ASSERT_EQUAL_UINT16(0, TelemetryHistory_copy(&history, records, 4));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Ring Tests
+    RUN_TEST(test_decimates_by_uptime);
+    RUN_TEST(test_record_fixed_point);
+    RUN_TEST(test_copy_oldest_first_after_wrap);
+    RUN_TEST(test_no_buffer_keeps_nothing);
+
+    return UNITY_END();
+}
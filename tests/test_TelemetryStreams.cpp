@@ -0,0 +1,355 @@
+/**
+ * Unit Tests for TelemetryStreams
+ * Tests per-stream rates, budget packing by priority, backlog aging,
+ * one-record slots, event pre-emption, snapshot change events and the
+ * frame round trip
+ *
+ * @file test_TelemetryStreams.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "TelemetryStreams.h"
+#include "Crc16.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define TICK_MS 50  // 20 Hz telemetry task
+
+static TelemetryStreams ts;
+static TelemetryStreamsConfig config;
+static TelemetrySnapshot snap;
+static uint8_t frame[TELEMETRY_STREAM_MAX_FRAME];
+static size_t frameLen;
+static TelemetryStreamFrame decoded;
+
+// Tick and pack once; decoded holds the frame (present = 0 if none)
+static void step(uint8_t budget) {
+    TelemetryStreams_tick(&ts, &config, TICK_MS);
+    frameLen = TelemetryStreams_pack(&ts, &config, &snap, budget, frame, sizeof(frame));
+    memset(&decoded, 0, sizeof(decoded));
+    if (frameLen)
+        TEST_ASSERT_TRUE(TelemetryStreams_decode(frame, frameLen, &decoded));
+}
+
+static bool has(TelemetryStreamId id) {
+    return (decoded.present & (1 << id)) != 0;
+}
+
+static void onlyStream(TelemetryStreamId id, uint8_t hz) {
+    memset(config.hz, 0, sizeof(config.hz));
+    config.hz[id] = hz;
+}
+
+void setUp(void) {
+    TelemetryStreams_defaultConfig(&config);
+    TelemetryStreams_init(&ts);
+    memset(&snap, 0, sizeof(snap));
+    snap.uptime = 12345;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Rate Tests
+// ============================================================================
+
+void test_rates_over_one_second(void) {
+    uint32_t frames = 0;
+    for (int i = 0; i < 20; i++) {
+        step(TELEMETRY_STREAM_MAX_FRAME);
+        frames += frameLen ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, ts.sent[TELEMETRY_STREAM_ATTITUDE]);
+    TEST_ASSERT_EQUAL_UINT32(5, ts.sent[TELEMETRY_STREAM_POSITION]);
+    TEST_ASSERT_EQUAL_UINT32(2, ts.sent[TELEMETRY_STREAM_NAV]);
+    TEST_ASSERT_EQUAL_UINT32(1, ts.sent[TELEMETRY_STREAM_BATTERY]);
+    TEST_ASSERT_EQUAL_UINT32(1, ts.sent[TELEMETRY_STREAM_PERF]);
+    TEST_ASSERT_EQUAL_UINT32(10, frames);   // Only ticks with something due
+    TEST_ASSERT_EQUAL_UINT32(frames, ts.frames);
+}
+
+void test_nothing_due_sends_nothing(void) {
+    onlyStream(TELEMETRY_STREAM_BATTERY, 1);
+    step(TELEMETRY_STREAM_MAX_FRAME);
+    TEST_ASSERT_EQUAL(0, frameLen);
+    TEST_ASSERT_EQUAL(0, ts.frames);
+}
+
+void test_skipped_ticks_collapse_to_latest(void) {
+    // A slower link tier packs every fourth tick: 10 Hz attitude gets
+    // one record per frame, not a burst of stale ones
+    onlyStream(TELEMETRY_STREAM_ATTITUDE, 10);
+    for (int f = 0; f < 5; f++) {
+        for (int i = 0; i < 3; i++)
+            TelemetryStreams_tick(&ts, &config, TICK_MS);
+        step(TELEMETRY_STREAM_MAX_FRAME);
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, ts.sent[TELEMETRY_STREAM_ATTITUDE]);
+    TEST_ASSERT_TRUE(ts.credit[TELEMETRY_STREAM_ATTITUDE] <=
+                     TELEMETRY_STREAM_MAX_BACKLOG * 1000);
+}
+
+// ============================================================================
+// Budget Tests
+// ============================================================================
+
+void test_budget_keeps_high_priority(void) {
+    // Everything due at once; 24 bytes hold the header, CRC and one record
+    for (int i = 0; i < TELEMETRY_STREAM_COUNT; i++)
+        config.hz[i] = 20;
+    config.hz[TELEMETRY_STREAM_EVENTS] = 0;
+    step(TELEMETRY_STREAM_MIN_BUDGET);
+    TEST_ASSERT_TRUE(frameLen <= TELEMETRY_STREAM_MIN_BUDGET);
+    TEST_ASSERT_TRUE(has(TELEMETRY_STREAM_ATTITUDE));   // Priority 1
+    TEST_ASSERT_FALSE(has(TELEMETRY_STREAM_POSITION));  // 11 bytes: no room left
+    TEST_ASSERT_TRUE(ts.deferred[TELEMETRY_STREAM_POSITION] > 0);
+}
+
+void test_smaller_record_fills_the_gap(void) {
+    onlyStream(TELEMETRY_STREAM_POSITION, 20);
+    config.hz[TELEMETRY_STREAM_ATTITUDE] = 20;
+    config.hz[TELEMETRY_STREAM_BATTERY] = 20;
+    config.priority[TELEMETRY_STREAM_POSITION] = 0;
+    // 6 + 2 + (2 + 11) = 21: a 4-byte battery record does not fit, but
+    // 27 bytes leave room for it and not for attitude (8)
+    step(27);
+    TEST_ASSERT_TRUE(has(TELEMETRY_STREAM_POSITION));
+    TEST_ASSERT_FALSE(has(TELEMETRY_STREAM_ATTITUDE));
+    TEST_ASSERT_TRUE(has(TELEMETRY_STREAM_BATTERY));
+}
+
+void test_backlog_ages_low_priority_in(void) {
+    // Room for one record per frame: attitude (priority 1) would win every
+    // time, but perf gains a level per frame it is left out of
+    onlyStream(TELEMETRY_STREAM_ATTITUDE, 20);
+    config.hz[TELEMETRY_STREAM_PERF] = 20;
+    config.priority[TELEMETRY_STREAM_PERF] = 3;
+    for (int i = 0; i < 40; i++)
+        step(18);
+    TEST_ASSERT_TRUE(ts.sent[TELEMETRY_STREAM_PERF] >= 10);
+    TEST_ASSERT_TRUE(ts.sent[TELEMETRY_STREAM_ATTITUDE] > ts.sent[TELEMETRY_STREAM_PERF]);
+    TEST_ASSERT_EQUAL_UINT32(40, ts.frames);
+}
+
+void test_next_picks_one_per_slot(void) {
+    // A link with one record per slot and no perf stream
+    onlyStream(TELEMETRY_STREAM_POSITION, 20);
+    config.hz[TELEMETRY_STREAM_ATTITUDE] = 20;
+    config.hz[TELEMETRY_STREAM_PERF] = 20;
+    config.priority[TELEMETRY_STREAM_PERF] = 0;
+    uint8_t mask = (uint8_t)~(1 << TELEMETRY_STREAM_PERF);
+    TelemetryStreams_postEvent(&ts, TELEMETRY_EVENT_RTL, 1);
+    TelemetryStreams_postEvent(&ts, TELEMETRY_EVENT_MISSION, 0);
+    TelemetryStreams_tick(&ts, &config, TICK_MS);
+
+    TEST_ASSERT_EQUAL(TELEMETRY_STREAM_EVENTS, TelemetryStreams_next(&ts, &config, mask));
+    TEST_ASSERT_EQUAL(0, ts.eventCount);
+    TEST_ASSERT_EQUAL_UINT32(2, ts.sent[TELEMETRY_STREAM_EVENTS]);
+    TEST_ASSERT_EQUAL(TELEMETRY_STREAM_ATTITUDE, TelemetryStreams_next(&ts, &config, mask));
+    TEST_ASSERT_EQUAL_UINT32(1, ts.deferred[TELEMETRY_STREAM_POSITION]);
+    TEST_ASSERT_EQUAL(TELEMETRY_STREAM_POSITION, TelemetryStreams_next(&ts, &config, mask));
+    TEST_ASSERT_EQUAL(TELEMETRY_STREAM_COUNT, TelemetryStreams_next(&ts, &config, mask));
+    TEST_ASSERT_EQUAL_UINT32(0, ts.sent[TELEMETRY_STREAM_PERF]);
+}
+
+// ============================================================================
+// Event Tests
+// ============================================================================
+
+void test_events_preempt_streams(void) {
+    onlyStream(TELEMETRY_STREAM_POSITION, 20);
+    TelemetryStreams_postEvent(&ts, TELEMETRY_EVENT_FAILSAFE, 3);
+    TelemetryStreams_postEvent(&ts, TELEMETRY_EVENT_RTL, 1);
+    // 6 + 2 + (2 + 6) = 16: the events and no room for the position (13)
+    step(21);
+    TEST_ASSERT_TRUE(has(TELEMETRY_STREAM_EVENTS));
+    TEST_ASSERT_FALSE(has(TELEMETRY_STREAM_POSITION));
+    TEST_ASSERT_EQUAL(2, decoded.eventCount);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_EVENT_FAILSAFE, decoded.events[0].code);
+    TEST_ASSERT_EQUAL_UINT16(3, decoded.events[0].arg);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_EVENT_RTL, decoded.events[1].code);
+    TEST_ASSERT_EQUAL(0, ts.eventCount);
+
+    // Position waited: next frame
+    step(21);
+    TEST_ASSERT_TRUE(has(TELEMETRY_STREAM_POSITION));
+}
+
+void test_event_queue_drops_oldest(void) {
+    onlyStream(TELEMETRY_STREAM_ATTITUDE, 0);
+    for (int i = 0; i < TELEMETRY_STREAM_EVENT_QUEUE + 2; i++)
+        TelemetryStreams_postEvent(&ts, TELEMETRY_EVENT_WAYPOINT, (uint16_t)i);
+    TEST_ASSERT_EQUAL_UINT32(2, ts.eventsDropped);
+    step(TELEMETRY_STREAM_MAX_FRAME);
+    TEST_ASSERT_EQUAL(TELEMETRY_STREAM_EVENT_QUEUE, decoded.eventCount);
+    TEST_ASSERT_EQUAL_UINT16(2, decoded.events[0].arg);
+}
+
+void test_watch_reports_changes(void) {
+    TelemetryEventWatch watch;
+    memset(&watch, 0, sizeof(watch));
+    snap.failsafe = 1;
+    TelemetryStreams_watch(&ts, &watch, &snap);
+    TEST_ASSERT_EQUAL(0, ts.eventCount);            // Baseline only
+
+    snap.navFlags = TELEMETRY_NAV_MISSION_ACTIVE;
+    snap.status = TELEMETRY_STATUS_GPS_LOCK;
+    TelemetryStreams_watch(&ts, &watch, &snap);
+    snap.wpIndex = 1;
+    snap.failsafe = 2;
+    TelemetryStreams_watch(&ts, &watch, &snap);
+    TelemetryStreams_watch(&ts, &watch, &snap);     // No change
+
+    onlyStream(TELEMETRY_STREAM_ATTITUDE, 0);
+    step(TELEMETRY_STREAM_MAX_FRAME);
+    TEST_ASSERT_EQUAL(4, decoded.eventCount);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_EVENT_MISSION, decoded.events[0].code);
+    TEST_ASSERT_EQUAL_UINT16(1, decoded.events[0].arg);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_EVENT_GPS, decoded.events[1].code);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_EVENT_FAILSAFE, decoded.events[2].code);
+    TEST_ASSERT_EQUAL_UINT16(2, decoded.events[2].arg);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_EVENT_WAYPOINT, decoded.events[3].code);
+    TEST_ASSERT_EQUAL_UINT16(0, decoded.events[3].arg);  // The one reached
+}
+
+// ============================================================================
+// Frame Tests
+// ============================================================================
+
+void test_frame_round_trip(void) {
+    for (int i = 0; i < TELEMETRY_STREAM_COUNT; i++)
+        config.hz[i] = 20;
+    snap.roll = -12.34f;
+    snap.pitch = 5.5f;
+    snap.heading = 359.99f;
+    snap.latE7 = 137563210;
+    snap.lngE7 = -1005012345;
+    snap.groundSpeed = 1.23f;
+    snap.status = TELEMETRY_STATUS_GPS_LOCK;
+    snap.wpIndex = 7;
+    snap.navFlags = TELEMETRY_NAV_RTL_ACTIVE;
+    snap.dist = 123.4f;
+    snap.headingError = -45.5f;
+    snap.batteryMv = 11870;
+    snap.rssi = -71;
+    snap.linkQuality = 93;
+    snap.depth = 2.37f;
+    snap.targetDepth = 2.5f;
+    snap.diving = true;
+    snap.heapPct = 41.6f;
+    snap.cpuPct = 63.2f;
+    snap.maxLoopUs = 70000;
+
+    step(TELEMETRY_STREAM_MAX_FRAME);
+    TEST_ASSERT_EQUAL(8 + 6 * 2 + 6 + 11 + 7 + 4 + 5 + 4, frameLen);
+    TEST_ASSERT_EQUAL_UINT32(12345, decoded.uptime);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, -12.34f, decoded.roll);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, 5.5f, decoded.pitch);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, 359.99f, decoded.heading);
+    TEST_ASSERT_EQUAL_INT32(137563210, decoded.latE7);
+    TEST_ASSERT_EQUAL_INT32(-1005012345, decoded.lngE7);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, 1.23f, decoded.groundSpeed);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_STATUS_GPS_LOCK, decoded.status);
+    TEST_ASSERT_EQUAL_UINT16(7, decoded.wpIndex);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_NAV_RTL_ACTIVE, decoded.navFlags);
+    TEST_ASSERT_FLOAT_WITHIN(0.06f, 123.4f, decoded.dist);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, -45.5f, decoded.headingError);
+    TEST_ASSERT_EQUAL_UINT16(11870, decoded.batteryMv);
+    TEST_ASSERT_EQUAL_INT8(-71, decoded.rssi);
+    TEST_ASSERT_EQUAL_UINT8(93, decoded.linkQuality);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, 2.37f, decoded.depth);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, 2.5f, decoded.targetDepth);
+    TEST_ASSERT_TRUE(decoded.diving);
+    TEST_ASSERT_EQUAL_UINT8(42, decoded.heapPct);
+    TEST_ASSERT_EQUAL_UINT8(63, decoded.cpuPct);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, decoded.maxLoopUs);  // Saturated
+}
+
+void test_decode_rejects_corruption(void) {
+    onlyStream(TELEMETRY_STREAM_ATTITUDE, 20);
+    step(TELEMETRY_STREAM_MAX_FRAME);
+    TEST_ASSERT_TRUE(frameLen > 0);
+    frame[7] ^= 0x01;
+    TEST_ASSERT_FALSE(TelemetryStreams_decode(frame, frameLen, &decoded));
+    frame[7] ^= 0x01;
+    TEST_ASSERT_FALSE(TelemetryStreams_decode(frame, frameLen - 1, &decoded));
+    frame[0] = 0xD1;
+    TEST_ASSERT_FALSE(TelemetryStreams_decode(frame, frameLen, &decoded));
+}
+
+void test_decode_skips_unknown_stream(void) {
+    // A newer sender's record id 12 between two known ones
+    uint8_t f[32] = {TELEMETRY_STREAM_TYPE, 9, 1, 0, 0, 0,
+                     TELEMETRY_STREAM_BATTERY, 4, 0x10, 0x27, 0xC0, 50,
+                     12, 3, 1, 2, 3,
+                     TELEMETRY_STREAM_PERF, 4, 10, 20, 0xE8, 0x03};
+    size_t len = 23;
+    uint16_t crc = Crc16_compute(f, len);
+    f[len++] = (uint8_t)(crc & 0xFF);
+    f[len++] = (uint8_t)(crc >> 8);
+    TEST_ASSERT_TRUE(TelemetryStreams_decode(f, len, &decoded));
+    TEST_ASSERT_EQUAL_UINT8((1 << TELEMETRY_STREAM_BATTERY) | (1 << TELEMETRY_STREAM_PERF),
+                            decoded.present);
+    TEST_ASSERT_EQUAL_UINT16(10000, decoded.batteryMv);
+    TEST_ASSERT_EQUAL_UINT16(1000, decoded.maxLoopUs);
+}
+
+// ============================================================================
+// Config Tests
+// ============================================================================
+
+void test_sanitize_and_names(void) {
+    config.radioBudget = 4;
+    config.serialBudget = 250;
+    config.hz[TELEMETRY_STREAM_NAV] = 200;
+    config.hz[TELEMETRY_STREAM_EVENTS] = 5;
+    config.priority[TELEMETRY_STREAM_EVENTS] = 9;
+    TelemetryStreams_sanitize(&config);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_STREAM_MIN_BUDGET, config.radioBudget);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_STREAM_MAX_FRAME, config.serialBudget);
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_STREAM_MAX_HZ, config.hz[TELEMETRY_STREAM_NAV]);
+    TEST_ASSERT_EQUAL_UINT8(0, config.priority[TELEMETRY_STREAM_EVENTS]);
+
+    TEST_ASSERT_EQUAL_STRING("depth", TelemetryStreams_name(TELEMETRY_STREAM_DEPTH));
+    TEST_ASSERT_EQUAL(TELEMETRY_STREAM_PERF, TelemetryStreams_parse("Perf"));
+    TEST_ASSERT_EQUAL(TELEMETRY_STREAM_COUNT, TelemetryStreams_parse("gyro"));
+    TEST_ASSERT_NULL(TelemetryStreams_name(TELEMETRY_STREAM_COUNT));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Rate Tests
+    RUN_TEST(test_rates_over_one_second);
+    RUN_TEST(test_nothing_due_sends_nothing);
+    RUN_TEST(test_skipped_ticks_collapse_to_latest);
+
+    // Budget Tests
+    RUN_TEST(test_budget_keeps_high_priority);
+    RUN_TEST(test_smaller_record_fills_the_gap);
+    RUN_TEST(test_backlog_ages_low_priority_in);
+    RUN_TEST(test_next_picks_one_per_slot);
+
+    // Event Tests
+    RUN_TEST(test_events_preempt_streams);
+    RUN_TEST(test_event_queue_drops_oldest);
+    RUN_TEST(test_watch_reports_changes);
+
+    // Frame Tests
+    RUN_TEST(test_frame_round_trip);
+    RUN_TEST(test_decode_rejects_corruption);
+    RUN_TEST(test_decode_skips_unknown_stream);
+
+    // Config Tests
+    RUN_TEST(test_sanitize_and_names);
+
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+/**
+ * Unit Tests for TelemetryTrend
+ * Tests window statistics, metrics without a source, the stream record
+ * round trip and the JSON log line
+ *
+ * @file test_TelemetryTrend.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "TelemetryTrend.h"
+#include <math.h>
+#include <string.h>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static TelemetryTrend trend;
+static TelemetryTrendConfig config;
+
+static TelemetrySnapshot snapAt(uint32_t uptime, float depth) {
+    TelemetrySnapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    snap.uptime = uptime;
+    snap.depth = depth;
+    snap.batteryMv = 12600;
+    snap.maxLoopUs = 800;
+    return snap;
+}
+
+void setUp(void) {
+    TelemetryTrend_init(&trend);
+    TelemetryTrend_defaultConfig(&config);
+    config.enabled = true;
+    config.windowMs = 1000;
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Aggregation Tests
+// ============================================================================
+
+void test_window_min_max_mean(void) {
+    TelemetryTrendWindow w;
+    // 20 samples at 50 ms, depth 1.0 .. 2.9 m
+    for (uint32_t i = 0; i < 20; i++) {
+        TelemetrySnapshot snap = snapAt(i * 50, 1.0f + i * 0.1f);
+        TEST_ASSERT_FALSE(TelemetryTrend_update(&trend, &config, &snap, NAN, &w));
+    }
+    TelemetrySnapshot next = snapAt(1000, 5.0f);
+    TEST_ASSERT_TRUE(TelemetryTrend_update(&trend, &config, &next, NAN, &w));
+
+    TEST_ASSERT_EQUAL_UINT32(0, w.start);
+    TEST_ASSERT_EQUAL_UINT16(20, w.samples);
+    TEST_ASSERT_EQUAL_UINT16(1000, w.durationMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, w.stat[TELEMETRY_TREND_DEPTH].min);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.9f, w.stat[TELEMETRY_TREND_DEPTH].max);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.95f, w.stat[TELEMETRY_TREND_DEPTH].mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 12.6f, w.stat[TELEMETRY_TREND_VOLTAGE].mean);
+
+    // The closing sample opened the next window
+    TEST_ASSERT_EQUAL_UINT32(1000, trend.start);
+    TEST_ASSERT_EQUAL_UINT16(1, trend.samples);
+    TEST_ASSERT_EQUAL_UINT32(1, trend.windows);
+}
+
+void test_metrics_without_source_left_out(void) {
+    TelemetryTrendWindow w;
+    TelemetrySnapshot snap = snapAt(0, 0.0f);
+    snap.headingError = 30.0f;  // Not navigating: ignored
+    TelemetryTrend_update(&trend, &config, &snap, NAN, &w);
+    snap = snapAt(1000, 0.0f);
+    TEST_ASSERT_TRUE(TelemetryTrend_update(&trend, &config, &snap, 2.5f, &w));
+    TEST_ASSERT_FALSE(w.present & (1 << TELEMETRY_TREND_CURRENT));
+    TEST_ASSERT_FALSE(w.present & (1 << TELEMETRY_TREND_HEADING_ERROR));
+    TEST_ASSERT_TRUE(w.present & (1 << TELEMETRY_TREND_LOOP));
+
+    // The next window has the current reading
+    snap = snapAt(2000, 0.0f);
+    TEST_ASSERT_TRUE(TelemetryTrend_update(&trend, &config, &snap, NAN, &w));
+    TEST_ASSERT_TRUE(w.present & (1 << TELEMETRY_TREND_CURRENT));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.5f, w.stat[TELEMETRY_TREND_CURRENT].max);
+}
+
+void test_disabled_keeps_nothing(void) {
+    TelemetryTrendWindow w;
+    config.enabled = false;
+    for (uint32_t t = 0; t <= 3000; t += 500) {
+        TelemetrySnapshot snap = snapAt(t, 1.0f);
+        TEST_ASSERT_FALSE(TelemetryTrend_update(&trend, &config, &snap, NAN, &w));
+    }
+    TEST_ASSERT_FALSE(trend.open);
+}
+
+void test_sanitize_clamps_window(void) {
+    config.windowMs = 10;
+    TelemetryTrend_sanitize(&config);
+    TEST_ASSERT_EQUAL_UINT16(TELEMETRY_TREND_MIN_WINDOW_MS, config.windowMs);
+    config.windowMs = 65000;
+    TelemetryTrend_sanitize(&config);
+    TEST_ASSERT_EQUAL_UINT16(TELEMETRY_TREND_MAX_WINDOW_MS, config.windowMs);
+}
+
+// ============================================================================
+// Encoding Tests
+// ============================================================================
+
+static TelemetryTrendWindow sampleWindow(void) {
+    TelemetryTrendWindow w;
+    memset(&w, 0, sizeof(w));
+    w.start = 120000;
+    w.durationMs = 10000;
+    w.samples = 200;
+    w.present = (1 << TELEMETRY_TREND_DEPTH) | (1 << TELEMETRY_TREND_HEADING_ERROR);
+    w.stat[TELEMETRY_TREND_DEPTH] = {-12.34f, -10.0f, -11.02f};
+    w.stat[TELEMETRY_TREND_HEADING_ERROR] = {-5.5f, 7.25f, 0.5f};
+    return w;
+}
+
+void test_pack_round_trip(void) {
+    TelemetryTrendWindow w = sampleWindow();
+    uint8_t frame[TELEMETRY_STREAM_MAX_FRAME];
+    size_t len = TelemetryTrend_pack(&w, 7, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL(6 + 2 + 5 + 12 + 2, len);
+
+    TelemetryTrendWindow back;
+    TEST_ASSERT_TRUE(TelemetryTrend_decode(frame, len, &back));
+    TEST_ASSERT_EQUAL_UINT32(120000, back.start);
+    TEST_ASSERT_EQUAL_UINT16(200, back.samples);
+    TEST_ASSERT_EQUAL_UINT8(w.present, back.present);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, -12.34f, back.stat[TELEMETRY_TREND_DEPTH].min);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, 7.25f, back.stat[TELEMETRY_TREND_HEADING_ERROR].max);
+
+    // Older receivers: a valid stream frame with nothing they know
+    TelemetryStreamFrame f;
+    TEST_ASSERT_TRUE(TelemetryStreams_decode(frame, len, &f));
+    TEST_ASSERT_EQUAL_UINT8(0, f.present);
+    TEST_ASSERT_EQUAL_UINT8(7, f.sequence);
+
+    frame[10] ^= 0x01;
+    TEST_ASSERT_FALSE(TelemetryTrend_decode(frame, len, &back));
+}
+
+void test_pack_needs_room(void) {
+    TelemetryTrendWindow w = sampleWindow();
+    uint8_t frame[16];
+    TEST_ASSERT_EQUAL(0, TelemetryTrend_pack(&w, 0, frame, sizeof(frame)));
+}
+
+void test_json_line(void) {
+    TelemetryTrendWindow w = sampleWindow();
+    char line[TELEMETRY_TREND_JSON_MAX];
+    size_t n = TelemetryTrend_jsonLine(&w, TELEMETRY_TREND_DEPTH, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"t\":3,\"m\":\"depth\",\"u\":120000,\"w\":10000,\"n\":200,"
+        "\"min\":-12.34,\"max\":-10.00,\"avg\":-11.02}\r\n", line);
+    TEST_ASSERT_EQUAL(strlen(line), n);
+    TEST_ASSERT_EQUAL(0, TelemetryTrend_jsonLine(&w, TELEMETRY_TREND_VOLTAGE, line, sizeof(line)));
+
+    // Widest line still fits
+    w.start = 4294967295UL;
+    w.durationMs = 60000;
+    w.samples = 65535;
+    w.stat[TELEMETRY_TREND_DEPTH] = {-32768.0f, -32768.0f, -32768.0f};
+    TEST_ASSERT_NOT_EQUAL(0, TelemetryTrend_jsonLine(&w, TELEMETRY_TREND_DEPTH, line, sizeof(line)));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Aggregation Tests
+    RUN_TEST(test_window_min_max_mean);
+    RUN_TEST(test_metrics_without_source_left_out);
+    RUN_TEST(test_disabled_keeps_nothing);
+    RUN_TEST(test_sanitize_clamps_window);
+
+    // Encoding Tests
+    RUN_TEST(test_pack_round_trip);
+    RUN_TEST(test_pack_needs_room);
+    RUN_TEST(test_json_line);
+
+    return UNITY_END();
+}
@@ -0,0 +1,248 @@
+/**
+ * Unit Tests for ThrustAllocator
+ * Tests the effectiveness columns, the pseudo-inverse on full and
+ * rank-deficient layouts, and the desaturation
+ *
+ * @file test_ThrustAllocator.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "ThrustAllocator.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static ThrustConfig config;
+static ThrustAllocator alloc;
+
+static void axes(float* in, float roll, float pitch, float yaw, float thrust,
+                 float forward = 0.0f, float lateral = 0.0f) {
+    in[MIXER_ROLL] = roll;
+    in[MIXER_PITCH] = pitch;
+    in[MIXER_YAW] = yaw;
+    in[MIXER_THRUST] = thrust;
+    in[MIXER_FORWARD] = forward;
+    in[MIXER_LATERAL] = lateral;
+}
+
+// BlueROV2 Heavy style: 4 vectored horizontals at 45 deg, 4 verticals at the corners
+static void heavyLayout(ThrustConfig* c) {
+    const float h = 0.7071068f;
+    c->count = 8;
+    c->thrusters[0] = { 0.15f, 0.10f, 0.0f,  h, -h, 0.0f};     // Front right
+    c->thrusters[1] = { 0.15f,-0.10f, 0.0f,  h,  h, 0.0f};     // Front left
+    c->thrusters[2] = {-0.15f, 0.10f, 0.0f,  h,  h, 0.0f};     // Back right
+    c->thrusters[3] = {-0.15f,-0.10f, 0.0f,  h, -h, 0.0f};     // Back left
+    c->thrusters[4] = { 0.12f, 0.22f, 0.0f, 0.0f, 0.0f, -1.0f};
+    c->thrusters[5] = { 0.12f,-0.22f, 0.0f, 0.0f, 0.0f, -1.0f};
+    c->thrusters[6] = {-0.12f, 0.22f, 0.0f, 0.0f, 0.0f, -1.0f};
+    c->thrusters[7] = {-0.12f,-0.22f, 0.0f, 0.0f, 0.0f, -1.0f};
+}
+
+// Wrench the thruster commands produce (B * out)
+static void wrench(const ThrustConfig* c, const float* out, float* w) {
+    for (int a = 0; a < MIXER_AXIS_COUNT; a++) w[a] = 0.0f;
+    for (uint8_t i = 0; i < c->count; i++) {
+        float col[MIXER_AXIS_COUNT];
+        ThrustAllocator_effectiveness(&c->thrusters[i], col);
+        for (int a = 0; a < MIXER_AXIS_COUNT; a++) w[a] += col[a] * out[i];
+    }
+}
+
+void setUp(void) {
+    ThrustAllocator_defaultConfig(&config);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Geometry Tests
+// ============================================================================
+
+void test_effectiveness_signs(void) {
+    // Left thruster pushing up rolls the right side down
+    ThrusterGeometry t = {0.0f, -0.2f, 0.0f, 0.0f, 0.0f, -1.0f};
+    float col[MIXER_AXIS_COUNT];
+    ThrustAllocator_effectiveness(&t, col);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.2f, col[MIXER_ROLL]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, col[MIXER_THRUST]);
+
+    // Bow thruster pushing right yaws the nose right
+    ThrusterGeometry bow = {0.3f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    ThrustAllocator_effectiveness(&bow, col);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.3f, col[MIXER_YAW]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, col[MIXER_LATERAL]);
+
+    // Forward thruster above the centre of mass pitches the nose down
+    ThrusterGeometry top = {0.0f, 0.0f, -0.1f, 1.0f, 0.0f, 0.0f};
+    ThrustAllocator_effectiveness(&top, col);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, -0.1f, col[MIXER_PITCH]);
+}
+
+void test_sanitize(void) {
+    config.thrusters[0].dx = 2.0f;
+    TEST_ASSERT_TRUE(ThrustAllocator_sanitize(&config));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, config.thrusters[0].dx);
+
+    config.count = THRUST_MAX_THRUSTERS + 4;
+    ThrustAllocator_sanitize(&config);
+    TEST_ASSERT_EQUAL_UINT8(THRUST_MAX_THRUSTERS, config.count);
+
+    ThrustAllocator_defaultConfig(&config);
+    config.thrusters[1] = {0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    TEST_ASSERT_FALSE(ThrustAllocator_sanitize(&config));
+    config.count = 0;
+    TEST_ASSERT_FALSE(ThrustAllocator_sanitize(&config));
+}
+
+// ============================================================================
+// Pseudo-inverse Tests
+// ============================================================================
+
+void test_default_matches_sub3_mixer(void) {
+    TEST_ASSERT_TRUE(ThrustAllocator_init(&alloc, &config));
+    TEST_ASSERT_EQUAL_UINT8(3, alloc.rank);
+
+    MotorMixer<MixerFrameSub3> mixer;
+    float in[MIXER_AXIS_COUNT], out[3], ref[3];
+    axes(in, 0.0f, 0.0f, 0.4f, -0.3f, 0.6f);
+    ThrustAllocator_allocate(&alloc, in, out);
+    mixer.mix(in, ref);
+    for (int i = 0; i < 3; i++) TEST_ASSERT_FLOAT_WITHIN(1e-4f, ref[i], out[i]);
+}
+
+void test_full_rank_layout_realizes_each_axis(void) {
+    heavyLayout(&config);
+    TEST_ASSERT_TRUE(ThrustAllocator_sanitize(&config));
+    TEST_ASSERT_TRUE(ThrustAllocator_init(&alloc, &config));
+    TEST_ASSERT_EQUAL_UINT8(6, alloc.rank);
+    TEST_ASSERT_EQUAL_HEX8(0x3F, alloc.axisMask);
+
+    for (int a = 0; a < MIXER_AXIS_COUNT; a++) {
+        float in[MIXER_AXIS_COUNT] = {}, out[THRUST_MAX_THRUSTERS], w[MIXER_AXIS_COUNT];
+        in[a] = 0.5f;
+        ThrustAllocator_allocate(&alloc, in, out);
+        wrench(&config, out, w);
+
+        // Only the commanded axis, most loaded thruster at the command
+        float peak = 0.0f;
+        for (uint8_t i = 0; i < config.count; i++) peak = fmaxf(peak, fabsf(out[i]));
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, peak);
+        TEST_ASSERT_TRUE(w[a] > 0.0f);
+        for (int b = 0; b < MIXER_AXIS_COUNT; b++) {
+            if (b != a) TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, w[b]);
+        }
+    }
+}
+
+void test_forward_uses_all_vectored_thrusters(void) {
+    heavyLayout(&config);
+    ThrustAllocator_sanitize(&config);
+    ThrustAllocator_init(&alloc, &config);
+    float in[MIXER_AXIS_COUNT], out[THRUST_MAX_THRUSTERS];
+    axes(in, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    ThrustAllocator_allocate(&alloc, in, out);
+    for (int i = 0; i < 4; i++) TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, out[i]);
+    for (int i = 4; i < 8; i++) TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, out[i]);
+}
+
+void test_rank_deficient_layout_drops_axes(void) {
+    // Two side-by-side forward thrusters: surge and yaw only
+    config.count = 2;
+    config.thrusters[0] = {0.0f, -0.2f, 0.0f, 1.0f, 0.0f, 0.0f};
+    config.thrusters[1] = {0.0f,  0.2f, 0.0f, 1.0f, 0.0f, 0.0f};
+    TEST_ASSERT_TRUE(ThrustAllocator_init(&alloc, &config));
+    TEST_ASSERT_EQUAL_UINT8(2, alloc.rank);
+    TEST_ASSERT_EQUAL_HEX8((1 << MIXER_YAW) | (1 << MIXER_FORWARD), alloc.axisMask);
+
+    float in[MIXER_AXIS_COUNT], out[2];
+    axes(in, 0.5f, 0.5f, 0.5f, 0.5f, 0.0f, 0.5f);   // Only yaw is reachable
+    ThrustAllocator_allocate(&alloc, in, out);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, out[0]);  // Left pushes: nose right
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -0.5f, out[1]);
+}
+
+void test_empty_layout_fails(void) {
+    config.count = 0;
+    TEST_ASSERT_FALSE(ThrustAllocator_init(&alloc, &config));
+}
+
+// ============================================================================
+// Desaturation Tests
+// ============================================================================
+
+void test_yaw_kept_forward_gives_way(void) {
+    heavyLayout(&config);
+    ThrustAllocator_sanitize(&config);
+    ThrustAllocator_init(&alloc, &config);
+    float in[MIXER_AXIS_COUNT], out[THRUST_MAX_THRUSTERS], w[MIXER_AXIS_COUNT];
+    axes(in, 0.0f, 0.0f, 0.6f, 0.0f, 1.0f);
+    ThrustAllocator_allocate(&alloc, in, out);
+    TEST_ASSERT_TRUE(alloc.saturated);
+    for (int i = 0; i < 8; i++) TEST_ASSERT_TRUE(fabsf(out[i]) <= 1.0f + 1e-5f);
+
+    // Full yaw authority survives; forward is what was cut
+    float yawOnly[MIXER_AXIS_COUNT], ref[THRUST_MAX_THRUSTERS], wRef[MIXER_AXIS_COUNT];
+    axes(yawOnly, 0.0f, 0.0f, 0.6f, 0.0f);
+    ThrustAllocator_allocate(&alloc, yawOnly, ref);
+    wrench(&config, out, w);
+    wrench(&config, ref, wRef);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, wRef[MIXER_YAW], w[MIXER_YAW]);
+    TEST_ASSERT_TRUE(w[MIXER_FORWARD] > 0.0f);
+}
+
+void test_attitude_overload_keeps_ratios(void) {
+    heavyLayout(&config);
+    ThrustAllocator_sanitize(&config);
+    ThrustAllocator_init(&alloc, &config);
+    float in[MIXER_AXIS_COUNT], out[THRUST_MAX_THRUSTERS], w[MIXER_AXIS_COUNT];
+    axes(in, 1.0f, 0.0f, 0.0f, 1.0f, 0.5f);
+    ThrustAllocator_allocate(&alloc, in, out);
+    TEST_ASSERT_TRUE(alloc.saturated);
+    wrench(&config, out, w);
+
+    float ref[THRUST_MAX_THRUSTERS], wRef[MIXER_AXIS_COUNT];
+    axes(in, 1.0f, 0.0f, 0.0f, 1.0f);
+    ThrustAllocator_allocate(&alloc, in, ref);
+    wrench(&config, ref, wRef);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, w[MIXER_ROLL] / w[MIXER_THRUST],
+                             wRef[MIXER_ROLL] / wRef[MIXER_THRUST]);
+    for (int i = 0; i < 8; i++) TEST_ASSERT_TRUE(fabsf(out[i]) <= 1.0f + 1e-5f);
+}
+
+void test_small_command_not_saturated(void) {
+    ThrustAllocator_init(&alloc, &config);
+    float in[MIXER_AXIS_COUNT], out[3];
+    axes(in, 0.0f, 0.0f, 0.2f, 0.2f, 0.2f);
+    ThrustAllocator_allocate(&alloc, in, out);
+    TEST_ASSERT_FALSE(alloc.saturated);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Geometry Tests
+    RUN_TEST(test_effectiveness_signs);
+    RUN_TEST(test_sanitize);
+
+    // Pseudo-inverse Tests
+    RUN_TEST(test_default_matches_sub3_mixer);
+    RUN_TEST(test_full_rank_layout_realizes_each_axis);
+    RUN_TEST(test_forward_uses_all_vectored_thrusters);
+    RUN_TEST(test_rank_deficient_layout_drops_axes);
+    RUN_TEST(test_empty_layout_fails);
+
+    // Desaturation Tests
+    RUN_TEST(test_yaw_kept_forward_gives_way);
+    RUN_TEST(test_attitude_overload_keeps_ratios);
+    RUN_TEST(test_small_command_not_saturated);
+
+    return UNITY_END();
+}
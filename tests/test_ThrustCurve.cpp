@@ -0,0 +1,137 @@
+/**
+ * Unit Tests for ThrustCurve
+ * Tests the linearization table against the expo thrust model, the
+ * mirrored reversible range, and the voltage scale with its filter,
+ * clamps and missing-sense fallback
+ *
+ * @file test_ThrustCurve.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "ThrustCurve.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static ThrustCurveConfig cfg;
+static ThrustCurve tc;
+
+// Thrust the modelled propeller makes for a command
+static float thrustOf(float command, float expo) {
+    return (1.0f - expo) * command + expo * command * command;
+}
+
+void setUp(void) {
+    ThrustCurve_defaultConfig(&cfg);
+    cfg.linearize = true;
+    ThrustCurve_init(&tc, &cfg);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Linearization Tests
+// ============================================================================
+
+void test_linearizes_expo_model(void) {
+    for (int i = 0; i <= 100; i++) {
+        float want = i / 100.0f;
+        float c = ThrustCurve_apply(&tc, want);
+        TEST_ASSERT_FLOAT_WITHIN(0.002f, want, thrustOf(c, cfg.expo));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ThrustCurve_apply(&tc, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, ThrustCurve_apply(&tc, 1.0f));
+}
+
+void test_low_thrust_needs_more_command(void) {
+    // Half thrust needs well over half command on a square-ish prop
+    TEST_ASSERT_TRUE(ThrustCurve_apply(&tc, 0.5f) > 0.6f);
+}
+
+void test_identity_when_off(void) {
+    cfg.linearize = false;
+    ThrustCurve_setConfig(&tc, &cfg);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.37f, ThrustCurve_apply(&tc, 0.37f));
+
+    cfg.linearize = true;
+    cfg.expo = 0.0f;
+    ThrustCurve_setConfig(&tc, &cfg);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.37f, ThrustCurve_apply(&tc, 0.37f));
+}
+
+void test_reversible_is_mirrored(void) {
+    TEST_ASSERT_EQUAL_FLOAT(-ThrustCurve_apply(&tc, 0.3f), ThrustCurve_apply(&tc, -0.3f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -1.0f, ThrustCurve_apply(&tc, -1.5f));
+}
+
+void test_sanitize(void) {
+    cfg.expo = 3.0f;
+    cfg.maxBoost = 0.5f;
+    cfg.voltageTauS = 0.0f;
+    ThrustCurve_sanitize(&cfg);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, cfg.expo);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, cfg.maxBoost);
+    TEST_ASSERT_TRUE(cfg.voltageTauS > 0.0f);
+}
+
+// ============================================================================
+// Voltage Tests
+// ============================================================================
+
+void test_sag_scales_command(void) {
+    ThrustCurve_updateVoltage(&tc, 3500.0f, 0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 4200.0f / 3500.0f, tc.scale);
+    float c = ThrustCurve_apply(&tc, 0.5f);
+    cfg.voltageComp = false;
+    ThrustCurve_setConfig(&tc, &cfg);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, c / (4200.0f / 3500.0f), ThrustCurve_apply(&tc, 0.5f));
+}
+
+void test_scale_clamped_and_output_capped(void) {
+    ThrustCurve_updateVoltage(&tc, 3000.0f, 0);
+    TEST_ASSERT_EQUAL_FLOAT(cfg.maxBoost, tc.scale);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, ThrustCurve_apply(&tc, 0.95f));
+}
+
+void test_voltage_filtered(void) {
+    ThrustCurve_updateVoltage(&tc, 4000.0f, 0);
+    ThrustCurve_updateVoltage(&tc, 3000.0f, 100);     // A 0.1 s load spike
+    TEST_ASSERT_TRUE(tc.cellMv > 3850.0f);
+    for (uint32_t t = 200; t <= 10000; t += 100)
+        ThrustCurve_updateVoltage(&tc, 3600.0f, t);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 3600.0f, tc.cellMv);
+}
+
+void test_no_sense_leaves_scale_one(void) {
+    ThrustCurve_updateVoltage(&tc, 3600.0f, 0);
+    ThrustCurve_updateVoltage(&tc, 0.0f, 100);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, tc.scale);
+    ThrustCurve_updateVoltage(&tc, 4200.0f, 200);       // Restarts unfiltered
+    TEST_ASSERT_EQUAL_FLOAT(4200.0f, tc.cellMv);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Linearization Tests
+    RUN_TEST(test_linearizes_expo_model);
+    RUN_TEST(test_low_thrust_needs_more_command);
+    RUN_TEST(test_identity_when_off);
+    RUN_TEST(test_reversible_is_mirrored);
+    RUN_TEST(test_sanitize);
+
+    // Voltage Tests
+    RUN_TEST(test_sag_scales_command);
+    RUN_TEST(test_scale_clamped_and_output_capped);
+    RUN_TEST(test_voltage_filtered);
+    RUN_TEST(test_no_sense_leaves_scale_one);
+
+    return UNITY_END();
+}
@@ -0,0 +1,166 @@
+/**
+ * Unit Tests for TimeSync
+ * Tests the calendar conversion, coarse UTC from time messages alone,
+ * locking to the PPS edge, drift tracking between pulses and holdover
+ *
+ * @file test_TimeSync.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "TimeSync.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define US_PER_S 1000000LL
+
+static TimeSync ts;
+static int64_t utc0;            // 2026-03-14 12:00:00 UTC
+
+// Local clock running 'ppm' fast: local time of a true interval
+static HAL_Micros local_at(HAL_Micros start, int64_t trueUs, int32_t ppm) {
+    return start + trueUs + trueUs * ppm / 1000000;
+}
+
+// Pulse at the top of second n, its NAV-PVT 60 ms later
+static void second(int n, HAL_Micros edgeUs) {
+    TimeSync_onPulse(&ts, edgeUs);
+    TimeSync_onUtc(&ts, utc0 + n * US_PER_S, 30, edgeUs + 60000);
+}
+
+void setUp(void) {
+    TimeSync_init(&ts);
+    utc0 = TimeSync_unixSeconds(2026, 3, 14, 12, 0, 0) * US_PER_S;
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Calendar Tests
+// ============================================================================
+
+void test_unix_seconds(void) {
+    TEST_ASSERT_TRUE(TimeSync_unixSeconds(1970, 1, 1, 0, 0, 0) == 0);
+    TEST_ASSERT_TRUE(TimeSync_unixSeconds(2000, 3, 1, 0, 0, 0) == 951868800LL);
+    TEST_ASSERT_TRUE(TimeSync_unixSeconds(2024, 2, 29, 23, 59, 59) == 1709251199LL);
+    TEST_ASSERT_TRUE(TimeSync_unixSeconds(2106, 2, 7, 6, 28, 16) == 4294967296LL);
+}
+
+// ============================================================================
+// Discipline Tests
+// ============================================================================
+
+void test_no_time_before_any_message(void) {
+    int64_t utc = 1;
+    TEST_ASSERT_FALSE(TimeSync_toUtc(&ts, 5000000, &utc));
+    TEST_ASSERT_TRUE(utc == 1);
+    TEST_ASSERT_EQUAL(TIME_SYNC_NONE, TimeSync_state(&ts, 5000000));
+}
+
+void test_messages_alone_give_coarse_time(void) {
+    // Solution at .2 s, read 80 ms late
+    TimeSync_onUtc(&ts, utc0 + 200000, 30, 10000000);
+    TEST_ASSERT_EQUAL(TIME_SYNC_COARSE, TimeSync_state(&ts, 10000000));
+
+    int64_t utc;
+    TEST_ASSERT_TRUE(TimeSync_toUtc(&ts, 10000000, &utc));
+    TEST_ASSERT_TRUE(utc == utc0 + 200000);
+}
+
+void test_pulse_locks_to_the_edge(void) {
+    TimeSync_onUtc(&ts, utc0 + 500000, 30, 9580000);     // Coarse first
+    second(1, 10000000);
+    TEST_ASSERT_EQUAL(TIME_SYNC_PPS, TimeSync_state(&ts, 10100000));
+
+    int64_t utc;
+    TEST_ASSERT_TRUE(TimeSync_toUtc(&ts, 10000000, &utc));
+    TEST_ASSERT_TRUE(utc == utc0 + US_PER_S);
+    TEST_ASSERT_TRUE(TimeSync_toUtc(&ts, 10250000, &utc));
+    TEST_ASSERT_TRUE(utc == utc0 + US_PER_S + 250000);
+    TEST_ASSERT_EQUAL_UINT32(1, ts.locks);
+}
+
+void test_solution_off_the_second_does_not_lock(void) {
+    TimeSync_onPulse(&ts, 10000000);
+    TimeSync_onUtc(&ts, utc0 + 100000, 30, 10160000);    // 10 Hz, the .1 solution
+    TEST_ASSERT_EQUAL(TIME_SYNC_COARSE, TimeSync_state(&ts, 10160000));
+    TEST_ASSERT_EQUAL_UINT32(0, ts.locks);
+
+    // Nor does a stale pulse or a poor time estimate
+    TimeSync_onUtc(&ts, utc0 + US_PER_S, 30, 11060000);
+    TEST_ASSERT_EQUAL_UINT32(0, ts.locks);
+    TimeSync_onPulse(&ts, 12000000);
+    TimeSync_onUtc(&ts, utc0 + 2 * US_PER_S, TIME_SYNC_MAX_TACC_NS + 1, 12060000);
+    TEST_ASSERT_EQUAL_UINT32(0, ts.locks);
+}
+
+void test_drift_is_tracked_between_pulses(void) {
+    // Crystal 40 ppm fast: each true second is 1000040 local us
+    HAL_Micros start = 20000000;
+    for (int n = 0; n < 60; n++) second(n, local_at(start, n * US_PER_S, 40));
+    TEST_ASSERT_INT_WITHIN(2000, -40000, ts.driftPpb);
+
+    // Half a second after the last pulse: within a microsecond or two
+    HAL_Micros local = local_at(start, 59 * US_PER_S + 500000, 40);
+    int64_t utc;
+    TEST_ASSERT_TRUE(TimeSync_toUtc(&ts, local, &utc));
+    int64_t err = utc - (utc0 + 59 * US_PER_S + 500000);
+    TEST_ASSERT_TRUE(err < 3 && err > -3);
+    TEST_ASSERT_EQUAL_UINT32(0, ts.steps);
+}
+
+void test_jump_restarts_drift(void) {
+    second(0, 10000000);
+    second(1, 11000000);
+    second(2, 12005000);        // 5 ms jump
+    TEST_ASSERT_EQUAL_UINT32(1, ts.steps);
+    TEST_ASSERT_EQUAL_INT32(0, ts.driftPpb);
+    TEST_ASSERT_EQUAL_INT32(-5000, ts.lastErrorUs);
+
+    int64_t utc;
+    TimeSync_toUtc(&ts, 12005000, &utc);
+    TEST_ASSERT_TRUE(utc == utc0 + 2 * US_PER_S);
+}
+
+void test_holdover_then_coarse(void) {
+    second(0, 10000000);
+    HAL_Micros later = 10000000 + TIME_SYNC_HOLDOVER_US / 2;
+
+    // Messages without pulses do not override the lock in holdover
+    TimeSync_onUtc(&ts, utc0 + TIME_SYNC_HOLDOVER_US / 2 + 100000, 30, later + 100000);
+    TEST_ASSERT_EQUAL(TIME_SYNC_PPS, TimeSync_state(&ts, later + 100000));
+    int64_t utc;
+    TimeSync_toUtc(&ts, later, &utc);
+    TEST_ASSERT_TRUE(utc == utc0 + TIME_SYNC_HOLDOVER_US / 2);
+
+    // Past the holdover they do
+    HAL_Micros expired = 10000000 + TIME_SYNC_HOLDOVER_US + 1;
+    TEST_ASSERT_EQUAL(TIME_SYNC_COARSE, TimeSync_state(&ts, expired));
+    TimeSync_onUtc(&ts, utc0 + 7 * US_PER_S, 30, expired);
+    TEST_ASSERT_EQUAL(TIME_SYNC_COARSE, ts.state);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Calendar Tests
+    RUN_TEST(test_unix_seconds);
+
+    // Discipline Tests
+    RUN_TEST(test_no_time_before_any_message);
+    RUN_TEST(test_messages_alone_give_coarse_time);
+    RUN_TEST(test_pulse_locks_to_the_edge);
+    RUN_TEST(test_solution_off_the_second_does_not_lock);
+    RUN_TEST(test_drift_is_tracked_between_pulses);
+    RUN_TEST(test_jump_restarts_drift);
+    RUN_TEST(test_holdover_then_coarse);
+
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * Unit Tests for Topic
+ * Tests latest-value publish, per-reader change notification and
+ * consistent copies under a concurrent writer
+ *
+ * @file test_Topic.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "Topic.h"
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+typedef struct {
+    uint32_t seq;
+    float values[15];
+} TestMsg;
+
+static Topic<TestMsg> *topic = nullptr;
+
+static TestMsg makeMsg(uint32_t seq) {
+    TestMsg m;
+    m.seq = seq;
+    for (int i = 0; i < 15; i++) {
+        m.values[i] = (float)(seq * 16 + i);
+    }
+    return m;
+}
+
+static bool consistent(const TestMsg &m) {
+    for (int i = 0; i < 15; i++) {
+        if (m.values[i] != (float)(m.seq * 16 + i)) return false;
+    }
+    return true;
+}
+
+void setUp(void) {
+    topic = new Topic<TestMsg>();
+}
+
+void tearDown(void) {
+    delete topic;
+    topic = nullptr;
+}
+
+// ============================================================================
+// Publish / Read Tests
+// ============================================================================
+
+void test_empty_topic_returns_false(void) {
+    TestMsg out = makeMsg(99);
+    TEST_ASSERT_FALSE(topic->read(out));
+    TEST_ASSERT_EQUAL_UINT32(99, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(0, topic->getGeneration());
+}
+
+void test_read_returns_newest(void) {
+    for (uint32_t i = 1; i <= 5; i++) {
+        topic->publish(makeMsg(i));
+    }
+    TestMsg out;
+    TEST_ASSERT_TRUE(topic->read(out));
+    TEST_ASSERT_EQUAL_UINT32(5, out.seq);
+    TEST_ASSERT_TRUE(consistent(out));
+
+    // read() does not consume: every reader sees the latest value
+    TEST_ASSERT_TRUE(topic->read(out));
+    TEST_ASSERT_EQUAL_UINT32(5, out.seq);
+    TEST_ASSERT_EQUAL_UINT32(5, topic->getGeneration());
+}
+
+// ============================================================================
+// Change Notification Tests
+// ============================================================================
+
+void test_updated_tracks_each_reader(void) {
+    TopicSub a, b;
+    TestMsg out;
+    TEST_ASSERT_FALSE(topic->updated(a));
+    TEST_ASSERT_FALSE(topic->readIfUpdated(a, out));
+
+    topic->publish(makeMsg(1));
+    TEST_ASSERT_TRUE(topic->updated(a));
+    TEST_ASSERT_TRUE(topic->readIfUpdated(a, out));
+    TEST_ASSERT_EQUAL_UINT32(1, out.seq);
+    TEST_ASSERT_FALSE(topic->readIfUpdated(a, out));
+
+    // Reader b has its own cursor
+    TEST_ASSERT_TRUE(topic->updated(b));
+    topic->publish(makeMsg(2));
+    topic->publish(makeMsg(3));
+    TEST_ASSERT_TRUE(topic->readIfUpdated(b, out));
+    TEST_ASSERT_EQUAL_UINT32(3, out.seq);
+    TEST_ASSERT_TRUE(topic->readIfUpdated(a, out));
+    TEST_ASSERT_EQUAL_UINT32(3, out.seq);
+}
+
+// ============================================================================
+// Concurrency Tests
+// ============================================================================
+
+void test_concurrent_reads_are_never_torn(void) {
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (uint32_t i = 1; i <= 200000; i++) {
+            topic->publish(makeMsg(i));
+        }
+        done.store(true);
+    });
+
+    uint32_t torn = 0, backwards = 0, last = 0;
+    TopicSub sub;
+    while (!done.load()) {
+        TestMsg out;
+        if (!topic->readIfUpdated(sub, out)) continue;
+        if (!consistent(out)) torn++;
+        if (out.seq < last) backwards++;
+        last = out.seq;
+    }
+    writer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TestMsg out;
+    TEST_ASSERT_TRUE(topic->read(out));
+    TEST_ASSERT_EQUAL_UINT32(200000, out.seq);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Publish / Read Tests
+    RUN_TEST(test_empty_topic_returns_false);
+    RUN_TEST(test_read_returns_newest);
+
+    // Change Notification Tests
+    RUN_TEST(test_updated_tracks_each_reader);
+
+    // Concurrency Tests
+    RUN_TEST(test_concurrent_reads_are_never_torn);
+
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * Unit Tests for TotalEnergy
+ * Tests the throttle / pitch split, underspeed handling, integrator
+ * bounds and a climb against a point-mass model
+ *
+ * @file test_TotalEnergy.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "TotalEnergy.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DEG 0.0174532925f
+#define DT  0.02f
+
+static TotalEnergy tecs;
+static TecsConfig config;
+
+void setUp(void) {
+    TotalEnergy_defaultConfig(&config);
+    TotalEnergy_init(&tecs, &config);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Setpoint Tests
+// ============================================================================
+
+void test_on_target_flies_trim(void) {
+    for (int i = 0; i < 10; i++) TotalEnergy_update(&tecs, 100.0f, 15.0f, 100.0f, 0.0f, 15.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, tecs.throttle);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, tecs.pitch);
+}
+
+void test_climb_uses_throttle_and_pitch(void) {
+    // 50 m low: 5 m/s climb wanted (clamped), at 15 m/s that is 1/3 rad
+    TotalEnergy_update(&tecs, 150.0f, 15.0f, 100.0f, 0.0f, 15.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 5.0f, tecs.heightRateSp);
+    TEST_ASSERT_TRUE(tecs.throttle > 0.9f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 15.0f * DEG, tecs.pitch);   // Clamped
+
+    // Too high: throttle back, nose down
+    setUp();
+    TotalEnergy_update(&tecs, 80.0f, 15.0f, 100.0f, 0.0f, 15.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -4.0f, tecs.heightRateSp);
+    TEST_ASSERT_TRUE(tecs.throttle < 0.5f);
+    TEST_ASSERT_TRUE(tecs.pitch < 0.0f);
+}
+
+void test_speed_change_is_throttle_first(void) {
+    // Slow at the right height: more throttle, nose slightly down
+    TotalEnergy_update(&tecs, 100.0f, 20.0f, 100.0f, 0.0f, 15.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, tecs.speedRateSp);
+    TEST_ASSERT_TRUE(tecs.throttle > 0.5f);
+    TEST_ASSERT_TRUE(tecs.pitch < 0.0f);
+
+    // Height only: pitch ignores the speed error
+    config.speedWeight = 0.0f;
+    TotalEnergy_init(&tecs, &config);
+    TotalEnergy_update(&tecs, 100.0f, 20.0f, 100.0f, 0.0f, 15.0f, DT);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, tecs.pitch);
+}
+
+void test_underspeed_protection(void) {
+    // Climb wanted but 7 m/s: full throttle, and the nose comes down
+    TotalEnergy_update(&tecs, 150.0f, 15.0f, 100.0f, 0.0f, 7.0f, DT);
+    TEST_ASSERT_TRUE(tecs.underspeed);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, tecs.throttle);
+    TEST_ASSERT_TRUE(tecs.pitch < 0.0f);
+}
+
+// ============================================================================
+// Integrator Tests
+// ============================================================================
+
+void test_integrators_bounded(void) {
+    // Stuck sinking at 15 m/s for a minute
+    for (int i = 0; i < 3000; i++) TotalEnergy_update(&tecs, 100.0f, 15.0f, 100.0f, -3.0f, 15.0f, DT);
+    TEST_ASSERT_TRUE(tecs.throttleI <= config.throttleILimit + 1e-6f);
+    TEST_ASSERT_TRUE(fabsf(tecs.pitchI) <= config.pitchILimitDeg * DEG + 1e-6f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, tecs.throttle);
+
+    // Tighter limits apply to what is already held
+    config.throttleILimit = 0.1f;
+    TotalEnergy_setConfig(&tecs, &config);
+    TEST_ASSERT_TRUE(tecs.throttleI <= 0.1f + 1e-6f);
+
+    TotalEnergy_reset(&tecs);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, tecs.throttleI);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, tecs.pitchI);
+}
+
+void test_sanitize(void) {
+    TecsConfig c = config;
+    c.speedWeight = 3.0f;
+    c.minSpeedMps = 30.0f;
+    c.maxSpeedMps = 20.0f;
+    c.minPitchDeg = 10.0f;
+    TotalEnergy_sanitize(&c);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, c.speedWeight);
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, c.maxSpeedMps);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, c.minPitchDeg);
+}
+
+// ============================================================================
+// Closed Loop Tests
+// ============================================================================
+
+void test_climbs_to_height_holding_speed(void) {
+    // Point mass: thrust 6 m/s^2 per unit throttle, trimmed at 0.5 / 15 m/s,
+    // flight path follows pitch with a 0.5 s lag
+    float h = 0.0f, v = 15.0f, gamma = 0.0f, minSpeed = v;
+    for (int i = 0; i < 3000; i++) {                    // 60 s at 50 Hz
+        TotalEnergy_update(&tecs, 30.0f, 15.0f, h, v * sinf(gamma), v, DT);
+        float accel = 6.0f * (tecs.throttle - 0.5f) - 0.3f * (v - 15.0f) - 9.80665f * sinf(gamma);
+        gamma += (tecs.pitch - gamma) * (DT / 0.5f);
+        v += accel * DT;
+        h += v * sinf(gamma) * DT;
+        if (v < minSpeed) minSpeed = v;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 30.0f, h);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 15.0f, v);
+    TEST_ASSERT_TRUE(minSpeed > 12.0f);                 // Did not trade speed for the climb
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Setpoint Tests
+    RUN_TEST(test_on_target_flies_trim);
+    RUN_TEST(test_climb_uses_throttle_and_pitch);
+    RUN_TEST(test_speed_change_is_throttle_first);
+    RUN_TEST(test_underspeed_protection);
+
+    // Integrator Tests
+    RUN_TEST(test_integrators_bounded);
+    RUN_TEST(test_sanitize);
+
+    // Closed Loop Tests
+    RUN_TEST(test_climbs_to_height_holding_speed);
+
+    return UNITY_END();
+}
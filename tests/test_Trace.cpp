@@ -0,0 +1,115 @@
+/**
+ * Unit Tests for Trace
+ * Tests record layout, ring wraparound, oldest-first readout, pausing and
+ * the scope macro
+ *
+ * @file test_Trace.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "Trace.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static TraceRecord out[TRACE_RING_SIZE];
+
+void setUp(void) {
+    Trace_init(240);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Recording Tests
+// ============================================================================
+
+void test_record_layout(void) {
+    TEST_ASSERT_EQUAL(8, sizeof(TraceRecord));
+
+    Trace_record(TRACE_EV_RADIO_RX, TRACE_PHASE_INSTANT, 250);
+    TEST_ASSERT_EQUAL_UINT32(1, Trace_read(0, 0, out, TRACE_RING_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(TRACE_EV_RADIO_RX, out[0].event);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_PHASE_INSTANT, out[0].phase);
+    TEST_ASSERT_EQUAL_UINT16(250, out[0].arg);
+}
+
+void test_wraparound_keeps_newest(void) {
+    for (uint32_t i = 0; i < TRACE_RING_SIZE + 10; i++) {
+        Trace_record(TRACE_EV_CONTROL, TRACE_PHASE_INSTANT, (uint16_t)i);
+    }
+
+    TraceCoreInfo info;
+    TEST_ASSERT_TRUE(Trace_getCoreInfo(0, &info));
+    TEST_ASSERT_EQUAL_UINT32(TRACE_RING_SIZE + 10, info.written);
+    TEST_ASSERT_EQUAL_UINT32(TRACE_RING_SIZE, info.available);
+
+    TEST_ASSERT_EQUAL_UINT32(TRACE_RING_SIZE, Trace_read(0, 0, out, TRACE_RING_SIZE));
+    TEST_ASSERT_EQUAL_UINT16(10, out[0].arg);
+    TEST_ASSERT_EQUAL_UINT16(TRACE_RING_SIZE + 9, out[TRACE_RING_SIZE - 1].arg);
+}
+
+void test_chunked_read(void) {
+    for (uint16_t i = 0; i < 5; i++) {
+        Trace_record(TRACE_EV_NAV, TRACE_PHASE_INSTANT, i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(2, Trace_read(0, 0, out, 2));
+    TEST_ASSERT_EQUAL_UINT16(1, out[1].arg);
+    TEST_ASSERT_EQUAL_UINT32(3, Trace_read(0, 2, out, 8));
+    TEST_ASSERT_EQUAL_UINT16(2, out[0].arg);
+    TEST_ASSERT_EQUAL_UINT32(0, Trace_read(0, 5, out, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, Trace_read(TRACE_CORES, 0, out, 8));
+}
+
+void test_paused_trace_drops_events(void) {
+    Trace_setEnabled(false);
+    Trace_record(TRACE_EV_DEPTH, TRACE_PHASE_INSTANT, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, Trace_read(0, 0, out, TRACE_RING_SIZE));
+
+    Trace_setEnabled(true);
+    Trace_record(TRACE_EV_DEPTH, TRACE_PHASE_INSTANT, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, Trace_read(0, 0, out, TRACE_RING_SIZE));
+}
+
+void test_scope_emits_begin_end(void) {
+    {
+        TRACE_SCOPE(TRACE_EV_TELEMETRY);
+        TRACE_INSTANT(TRACE_EV_RADIO_RX, 7);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(3, Trace_read(0, 0, out, TRACE_RING_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(TRACE_PHASE_BEGIN, out[0].phase);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_PHASE_INSTANT, out[1].phase);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_PHASE_END, out[2].phase);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_EV_TELEMETRY, out[2].event);
+    TEST_ASSERT_TRUE(out[2].cycles - out[0].cycles < 0x80000000u);
+}
+
+void test_sync_point_recorded(void) {
+    Trace_sync();
+    TraceCoreInfo info;
+    Trace_getCoreInfo(0, &info);
+    TEST_ASSERT_TRUE(info.syncUs > 0);
+    TEST_ASSERT_EQUAL_UINT32(240, Trace_getCyclesPerUs());
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Recording Tests
+    RUN_TEST(test_record_layout);
+    RUN_TEST(test_wraparound_keeps_newest);
+    RUN_TEST(test_chunked_read);
+    RUN_TEST(test_paused_trace_drops_events);
+    RUN_TEST(test_scope_emits_begin_end);
+    RUN_TEST(test_sync_point_recorded);
+
+    return UNITY_END();
+}
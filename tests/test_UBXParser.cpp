@@ -0,0 +1,252 @@
+/**
+ * Unit Tests for UBXParser
+ * Tests framing, in-place frames, frames split across reads, resync after
+ * noise / bad checksums, oversized frames and NAV-PVT decoding
+ *
+ * @file test_UBXParser.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "UBXParser.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static UBXParser parser;
+static uint8_t pvt[UBX_NAV_PVT_LEN];
+
+static void put32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+}
+
+/**
+ * NAV-PVT payload for a 3D fix in Bangkok, 1.5 m/s north-east
+ */
+static void make_pvt(void) {
+    memset(pvt, 0, sizeof(pvt));
+    put32(&pvt[0], 345600000);          // iTOW
+    pvt[20] = 3;                        // 3D fix
+    pvt[21] = 0x01;                     // gnssFixOK
+    pvt[23] = 14;                       // numSV
+    put32(&pvt[24], 1005018123);        // lon
+    put32(&pvt[28], (uint32_t)-137563456); // lat (southern, exercises sign)
+    put32(&pvt[36], 12345);             // hMSL mm
+    put32(&pvt[40], 850);               // hAcc mm
+    put32(&pvt[44], 1200);              // vAcc mm
+    put32(&pvt[48], 1061);              // velN
+    put32(&pvt[52], 1061);              // velE
+    put32(&pvt[56], (uint32_t)-20);     // velD
+    put32(&pvt[60], 1500);              // gSpeed
+    put32(&pvt[64], 4500000);           // headMot 45 deg
+    put32(&pvt[68], 150);               // sAcc
+    pvt[4] = 2026 & 0xFF;               // 2026-03-14 12:00:01.25 UTC
+    pvt[5] = 2026 >> 8;
+    pvt[6] = 3;
+    pvt[7] = 14;
+    pvt[8] = 12;
+    pvt[10] = 1;
+    pvt[11] = 0x07;                     // validDate | validTime | fullyResolved
+    put32(&pvt[12], 25);                // tAcc ns
+    put32(&pvt[16], 250000000);         // nano
+}
+
+/**
+ * Feed a whole buffer, return the number of frames seen
+ */
+static int feed_all(const uint8_t* data, size_t len, UBXFrame* last) {
+    int frames = 0;
+    size_t off = 0;
+    while (off < len) {
+        UBXFrame f;
+        off += UBXParser_feed(&parser, &data[off], len - off, &f);
+        if (f.payload) {
+            frames++;
+            if (last) *last = f;
+        }
+    }
+    return frames;
+}
+
+void setUp(void) {
+    UBXParser_init(&parser);
+    make_pvt();
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Framing Tests
+// ============================================================================
+
+void test_build_frame_checksum(void) {
+    // CFG-RATE 100 ms, navRate 1, GPS time (checksum from u-center)
+    const uint8_t rate[6] = {0x64, 0x00, 0x01, 0x00, 0x01, 0x00};
+    const uint8_t expected[] = {0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0x64, 0x00,
+                                0x01, 0x00, 0x01, 0x00, 0x7A, 0x12};
+    uint8_t out[32];
+    TEST_ASSERT_EQUAL(sizeof(expected), UBXParser_buildFrame(UBX_CLASS_CFG, UBX_ID_CFG_RATE, rate, 6, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, sizeof(expected));
+    TEST_ASSERT_EQUAL(0, UBXParser_buildFrame(UBX_CLASS_CFG, UBX_ID_CFG_RATE, rate, 6, out, 10));
+}
+
+void test_frame_in_one_read_is_not_copied(void) {
+    uint8_t buf[128];
+    size_t n = UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), buf, sizeof(buf));
+    UBXFrame f;
+    TEST_ASSERT_EQUAL(n, UBXParser_feed(&parser, buf, n, &f));
+    TEST_ASSERT_EQUAL_PTR(&buf[UBX_HEADER_LEN], f.payload);
+    TEST_ASSERT_EQUAL(UBX_CLASS_NAV, f.msgClass);
+    TEST_ASSERT_EQUAL(UBX_ID_NAV_PVT, f.msgId);
+    TEST_ASSERT_EQUAL(UBX_NAV_PVT_LEN, f.length);
+}
+
+void test_frame_split_across_reads(void) {
+    uint8_t buf[128];
+    size_t n = UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), buf, sizeof(buf));
+    // Every split point, including inside the header and checksum
+    for (size_t cut = 1; cut < n; cut++) {
+        UBXParser_init(&parser);
+        UBXFrame f;
+        TEST_ASSERT_EQUAL(cut, UBXParser_feed(&parser, buf, cut, &f));
+        TEST_ASSERT_NULL(f.payload);
+        TEST_ASSERT_EQUAL(n - cut, UBXParser_feed(&parser, &buf[cut], n - cut, &f));
+        TEST_ASSERT_NOT_NULL(f.payload);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(pvt, f.payload, sizeof(pvt));
+    }
+}
+
+void test_several_frames_and_noise(void) {
+    uint8_t buf[300];
+    size_t n = 0;
+    const char* nmea = "$GPGGA,,,*56\r\n";
+    memcpy(buf, nmea, strlen(nmea));
+    n += strlen(nmea);
+    buf[n++] = UBX_SYNC_1;              // Stray sync byte
+    n += UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), &buf[n], sizeof(buf) - n);
+    const uint8_t ack[2] = {UBX_CLASS_CFG, UBX_ID_CFG_RATE};
+    n += UBXParser_buildFrame(UBX_CLASS_ACK, UBX_ID_ACK_ACK, ack, 2, &buf[n], sizeof(buf) - n);
+
+    UBXFrame last;
+    TEST_ASSERT_EQUAL(2, feed_all(buf, n, &last));
+    TEST_ASSERT_EQUAL(UBX_CLASS_ACK, last.msgClass);
+    TEST_ASSERT_EQUAL(2, parser.frames);
+}
+
+void test_bad_checksum_resyncs(void) {
+    uint8_t buf[256];
+    size_t n = UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), buf, sizeof(buf));
+    buf[40] ^= 0xFF;                    // Corrupt the first copy
+    n += UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), &buf[n], sizeof(buf) - n);
+
+    TEST_ASSERT_EQUAL(1, feed_all(buf, n, NULL));
+    TEST_ASSERT_EQUAL(1, parser.checksumErrors);
+}
+
+void test_oversized_frame_skipped(void) {
+    static uint8_t big[400];
+    static uint8_t buf[600];
+    memset(big, UBX_SYNC_1, sizeof(big));  // Sync bytes inside must not resync
+    size_t n = UBXParser_buildFrame(0x0A, 0x04, big, sizeof(big), buf, sizeof(buf));
+    n += UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), &buf[n], sizeof(buf) - n);
+
+    UBXFrame last;
+    TEST_ASSERT_EQUAL(1, feed_all(buf, n, &last));
+    TEST_ASSERT_EQUAL(UBX_ID_NAV_PVT, last.msgId);
+    TEST_ASSERT_EQUAL(1, parser.oversized);
+}
+
+// ============================================================================
+// NAV-PVT Tests
+// ============================================================================
+
+void test_decode_nav_pvt(void) {
+    uint8_t buf[128];
+    size_t n = UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), buf, sizeof(buf));
+    UBXFrame f;
+    UBXParser_feed(&parser, buf, n, &f);
+
+    GPSFix fix;
+    memset(&fix, 0, sizeof(fix));
+    TEST_ASSERT_TRUE(UBXParser_decodeNavPvt(&f, &fix));
+    TEST_ASSERT_TRUE(fix.valid);
+    TEST_ASSERT_EQUAL(3, fix.fixType);
+    TEST_ASSERT_EQUAL(14, fix.numSV);
+    TEST_ASSERT_EQUAL_INT32(-137563456, fix.lat);
+    TEST_ASSERT_EQUAL_INT32(1005018123, fix.lng);
+    TEST_ASSERT_EQUAL_INT32(12345, fix.altMsl);
+    TEST_ASSERT_EQUAL_UINT32(850, fix.hAcc);
+    TEST_ASSERT_EQUAL_INT32(-20, fix.velD);
+    TEST_ASSERT_EQUAL_INT32(1500, fix.groundSpeed);
+    TEST_ASSERT_EQUAL_INT32(4500000, fix.course);
+    TEST_ASSERT_EQUAL_UINT32(345600000, fix.iTOW);
+    TEST_ASSERT_TRUE(fix.utcUs == 1773489601250000LL);
+    TEST_ASSERT_EQUAL_UINT32(25, fix.tAcc);
+    TEST_ASSERT_EQUAL(GPS_CARR_NONE, fix.carrSoln);
+}
+
+void test_decode_rtk_solution(void) {
+    pvt[21] |= 0x80;                    // carrSoln = fixed
+    uint8_t buf[128];
+    size_t n = UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), buf, sizeof(buf));
+    UBXFrame f;
+    UBXParser_feed(&parser, buf, n, &f);
+    GPSFix fix;
+    TEST_ASSERT_TRUE(UBXParser_decodeNavPvt(&f, &fix));
+    TEST_ASSERT_TRUE(fix.valid);
+    TEST_ASSERT_EQUAL(GPS_CARR_FIXED, fix.carrSoln);
+}
+
+void test_decode_unresolved_time(void) {
+    pvt[11] = 0x03;                     // Date and time, not fully resolved
+    uint8_t buf[128];
+    size_t n = UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), buf, sizeof(buf));
+    UBXFrame f;
+    UBXParser_feed(&parser, buf, n, &f);
+    GPSFix fix;
+    TEST_ASSERT_TRUE(UBXParser_decodeNavPvt(&f, &fix));
+    TEST_ASSERT_TRUE(fix.utcUs == 0);
+}
+
+void test_decode_rejects_no_fix_and_other_messages(void) {
+    pvt[21] = 0;                        // gnssFixOK clear
+    uint8_t buf[128];
+    size_t n = UBXParser_buildFrame(UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt), buf, sizeof(buf));
+    UBXFrame f;
+    UBXParser_feed(&parser, buf, n, &f);
+    GPSFix fix;
+    TEST_ASSERT_TRUE(UBXParser_decodeNavPvt(&f, &fix));
+    TEST_ASSERT_FALSE(fix.valid);
+
+    f.msgId = UBX_ID_ACK_ACK;
+    TEST_ASSERT_FALSE(UBXParser_decodeNavPvt(&f, &fix));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Framing Tests
+    RUN_TEST(test_build_frame_checksum);
+    RUN_TEST(test_frame_in_one_read_is_not_copied);
+    RUN_TEST(test_frame_split_across_reads);
+    RUN_TEST(test_several_frames_and_noise);
+    RUN_TEST(test_bad_checksum_resyncs);
+    RUN_TEST(test_oversized_frame_skipped);
+
+    // NAV-PVT Tests
+    RUN_TEST(test_decode_nav_pvt);
+    RUN_TEST(test_decode_unresolved_time);
+    RUN_TEST(test_decode_rtk_solution);
+    RUN_TEST(test_decode_rejects_no_fix_and_other_messages);
+
+    return UNITY_END();
+}
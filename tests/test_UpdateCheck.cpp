@@ -0,0 +1,136 @@
+/**
+ * Unit Tests for UpdateCheck
+ * Tests the pass / fail / deadline verdicts, the control timing window
+ * and the sensor mask comparison
+ *
+ * @file test_UpdateCheck.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "UpdateCheck.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static UpdateCheck check;
+
+static void passAllBut(UpdateCheckItem skip) {
+    for (int i = 0; i < UPDATE_CHECK_COUNT; i++)
+        if (i != skip) UpdateCheck_report(&check, (UpdateCheckItem)i, true);
+}
+
+void setUp(void) {
+    UpdateCheck_begin(&check, 200);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Verdict Tests
+// ============================================================================
+
+void test_pass_when_all_items_pass(void) {
+    passAllBut(UPDATE_CHECK_TIMING);
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_PENDING, UpdateCheck_update(&check, 1000));
+    UpdateCheck_report(&check, UPDATE_CHECK_TIMING, true);
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_PASS, UpdateCheck_update(&check, 2500));
+    TEST_ASSERT_EQUAL_UINT32(2300, check.verdictMs);
+    TEST_ASSERT_EQUAL_UINT8(UPDATE_CHECK_COUNT, check.cause);
+}
+
+void test_first_failure_decides(void) {
+    UpdateCheck_report(&check, UPDATE_CHECK_RADIO, true);
+    UpdateCheck_report(&check, UPDATE_CHECK_ACTUATORS, false);
+    UpdateCheck_report(&check, UPDATE_CHECK_SENSORS, false);
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_FAIL, UpdateCheck_update(&check, 600));
+    TEST_ASSERT_EQUAL_UINT8(UPDATE_CHECK_ACTUATORS, check.cause);
+    TEST_ASSERT_FALSE(check.timedOut);
+}
+
+void test_result_and_verdict_latched(void) {
+    UpdateCheck_report(&check, UPDATE_CHECK_CONFIG, false);
+    UpdateCheck_report(&check, UPDATE_CHECK_CONFIG, true);
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_FAIL, UpdateCheck_update(&check, 300));
+
+    passAllBut(UPDATE_CHECK_COUNT);
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_FAIL, UpdateCheck_update(&check, 400));
+}
+
+void test_deadline_fails_open_item(void) {
+    passAllBut(UPDATE_CHECK_SENSORS);
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_PENDING,
+                      UpdateCheck_update(&check, 200 + UPDATE_CHECK_DEADLINE_MS - 1));
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_FAIL,
+                      UpdateCheck_update(&check, 200 + UPDATE_CHECK_DEADLINE_MS));
+    TEST_ASSERT_TRUE(check.timedOut);
+    TEST_ASSERT_EQUAL_UINT8(UPDATE_CHECK_SENSORS, check.cause);
+    TEST_ASSERT_EQUAL_STRING("sensors", UpdateCheck_itemName((UpdateCheckItem)check.cause));
+}
+
+// ============================================================================
+// Timing Tests
+// ============================================================================
+
+void test_timing_passes_after_window(void) {
+    // Counters already running when the check starts
+    UpdateCheck_timing(&check, 40, 1);
+    UpdateCheck_timing(&check, 40 + UPDATE_CHECK_TIMING_TICKS - 1, 1 + UPDATE_CHECK_MAX_OVERRUNS);
+    TEST_ASSERT_FALSE(check.passed & (1u << UPDATE_CHECK_TIMING));
+    UpdateCheck_timing(&check, 40 + UPDATE_CHECK_TIMING_TICKS, 1 + UPDATE_CHECK_MAX_OVERRUNS);
+    TEST_ASSERT_TRUE(check.passed & (1u << UPDATE_CHECK_TIMING));
+}
+
+void test_timing_fails_on_overruns(void) {
+    UpdateCheck_timing(&check, 0, 0);
+    UpdateCheck_timing(&check, 10, UPDATE_CHECK_MAX_OVERRUNS + 1);
+    TEST_ASSERT_EQUAL(UPDATE_VERDICT_FAIL, UpdateCheck_update(&check, 500));
+    TEST_ASSERT_EQUAL_UINT8(UPDATE_CHECK_TIMING, check.cause);
+}
+
+void test_timing_counter_reset_reopens_window(void) {
+    UpdateCheck_timing(&check, 50, 5);
+    // get_perf reset: counters back to zero, no false overrun or pass
+    UpdateCheck_timing(&check, 3, 0);
+    UpdateCheck_timing(&check, 3 + UPDATE_CHECK_TIMING_TICKS - 1, 0);
+    TEST_ASSERT_EQUAL_UINT8(0, check.passed | check.failed);
+    UpdateCheck_timing(&check, 3 + UPDATE_CHECK_TIMING_TICKS, 0);
+    TEST_ASSERT_TRUE(check.passed & (1u << UPDATE_CHECK_TIMING));
+}
+
+// ============================================================================
+// Sensor Tests
+// ============================================================================
+
+void test_sensor_mask(void) {
+    uint8_t before = UPDATE_SENSOR_IMU | UPDATE_SENSOR_BARO;
+    TEST_ASSERT_TRUE(UpdateCheck_sensorsOk(before, before));
+    TEST_ASSERT_TRUE(UpdateCheck_sensorsOk(before, before | UPDATE_SENSOR_MAG));
+    TEST_ASSERT_TRUE(UpdateCheck_sensorsOk(0, 0));
+    TEST_ASSERT_FALSE(UpdateCheck_sensorsOk(before, UPDATE_SENSOR_IMU));
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Verdict Tests
+    RUN_TEST(test_pass_when_all_items_pass);
+    RUN_TEST(test_first_failure_decides);
+    RUN_TEST(test_result_and_verdict_latched);
+    RUN_TEST(test_deadline_fails_open_item);
+
+    // Timing Tests
+    RUN_TEST(test_timing_passes_after_window);
+    RUN_TEST(test_timing_fails_on_overruns);
+    RUN_TEST(test_timing_counter_reset_reopens_window);
+
+    // Sensor Tests
+    RUN_TEST(test_sensor_mask);
+
+    return UNITY_END();
+}
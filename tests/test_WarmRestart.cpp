@@ -0,0 +1,166 @@
+/**
+ * Unit Tests for WarmRestart
+ * Tests the two-slot record store: newest record wins, a torn or foreign
+ * record is ignored and the older slot survives it
+ *
+ * @file test_WarmRestart.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <stddef.h>
+#include <string.h>
+#include "Crc16.h"
+#include "WarmRestart.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define BUILD_ID 0x1234ABCDUL
+
+static WarmRestartStore store;
+
+static WarmRestartRecord make_record(uint16_t waypoint) {
+    WarmRestartRecord r;
+    memset(&r, 0, sizeof(r));
+    r.failsafeState = 1;
+    r.sincePacketMs = 20;
+    r.nav.homeLat = 13.7563f;
+    r.nav.homeLng = 100.5018f;
+    r.nav.homeSet = true;
+    r.nav.missionActive = true;
+    r.nav.waypointIndex = waypoint;
+    r.nav.missionCount = 12;
+    r.nav.missionCrc = 0xBEEF;
+    r.ticket.valid = true;
+    r.ticket.haveSeq = true;
+    r.ticket.highestSeq = 4000 + waypoint;
+    return r;
+}
+
+// Stamp a sequence number the store would only reach after years
+static void reseal(WarmRestartRecord* r, uint32_t sequence) {
+    r->sequence = sequence;
+    r->crc = Crc16_compute((const uint8_t*)r, offsetof(WarmRestartRecord, crc));
+}
+
+void setUp(void) {
+    memset(&store, 0xA5, sizeof(store));    // RTC memory after power-up
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Store Tests
+// ============================================================================
+
+void test_garbage_has_no_record(void) {
+    TEST_ASSERT_NULL(WarmRestart_latest(&store, BUILD_ID));
+    WarmRestart_clear(&store);
+    TEST_ASSERT_NULL(WarmRestart_latest(&store, BUILD_ID));
+}
+
+void test_write_then_read_back(void) {
+    WarmRestartRecord r = make_record(3);
+    WarmRestart_write(&store, &r, BUILD_ID);
+
+    const WarmRestartRecord* got = WarmRestart_latest(&store, BUILD_ID);
+    TEST_ASSERT_NOT_NULL(got);
+    TEST_ASSERT_EQUAL_UINT32(WARM_RESTART_MAGIC, got->magic);
+    TEST_ASSERT_EQUAL(3, got->nav.waypointIndex);
+    TEST_ASSERT_EQUAL_FLOAT(13.7563f, got->nav.homeLat);
+    TEST_ASSERT_EQUAL_UINT32(4003, got->ticket.highestSeq);
+}
+
+void test_newest_slot_wins(void) {
+    for (uint16_t i = 1; i <= 5; i++) {
+        WarmRestartRecord r = make_record(i);
+        WarmRestart_write(&store, &r, BUILD_ID);
+        TEST_ASSERT_EQUAL(i, WarmRestart_latest(&store, BUILD_ID)->nav.waypointIndex);
+    }
+    // Alternating slots
+    TEST_ASSERT_EQUAL(5, store.slots[0].nav.waypointIndex);
+    TEST_ASSERT_EQUAL(4, store.slots[1].nav.waypointIndex);
+}
+
+void test_sequence_wraps(void) {
+    WarmRestartRecord r = make_record(1);
+    WarmRestart_write(&store, &r, BUILD_ID);
+    reseal(&store.slots[0], 0xFFFFFFFFUL);
+
+    WarmRestartRecord next = make_record(2);
+    WarmRestart_write(&store, &next, BUILD_ID);
+    TEST_ASSERT_EQUAL_UINT32(0, store.slots[1].sequence);
+    TEST_ASSERT_EQUAL(2, WarmRestart_latest(&store, BUILD_ID)->nav.waypointIndex);
+}
+
+// ============================================================================
+// Integrity Tests
+// ============================================================================
+
+void test_torn_write_falls_back_to_older_slot(void) {
+    WarmRestartRecord a = make_record(7);
+    WarmRestartRecord b = make_record(8);
+    WarmRestart_write(&store, &a, BUILD_ID);
+    WarmRestart_write(&store, &b, BUILD_ID);
+
+    // Reset halfway through sealing slot 1
+    store.slots[1].nav.waypointIndex = 9;
+    const WarmRestartRecord* got = WarmRestart_latest(&store, BUILD_ID);
+    TEST_ASSERT_NOT_NULL(got);
+    TEST_ASSERT_EQUAL(7, got->nav.waypointIndex);
+
+    // The next write replaces the torn slot, not the good one
+    WarmRestartRecord c = make_record(10);
+    WarmRestart_write(&store, &c, BUILD_ID);
+    TEST_ASSERT_EQUAL(7, store.slots[0].nav.waypointIndex);
+    TEST_ASSERT_EQUAL(10, WarmRestart_latest(&store, BUILD_ID)->nav.waypointIndex);
+}
+
+void test_other_build_is_ignored(void) {
+    WarmRestartRecord r = make_record(2);
+    WarmRestart_write(&store, &r, BUILD_ID);
+    TEST_ASSERT_NULL(WarmRestart_latest(&store, BUILD_ID + 1));
+}
+
+void test_layout_version_checked(void) {
+    WarmRestartRecord r = make_record(2);
+    WarmRestart_write(&store, &r, BUILD_ID);
+    store.slots[0].version++;
+    TEST_ASSERT_FALSE(WarmRestart_isValid(&store.slots[0], BUILD_ID));
+}
+
+void test_clear_wipes_keys(void) {
+    WarmRestartRecord r = make_record(2);
+    memset(r.ticket.keys.c2vEnc, 0x5A, sizeof(r.ticket.keys.c2vEnc));
+    r.ticket.keyed = true;
+    WarmRestart_write(&store, &r, BUILD_ID);
+    WarmRestart_clear(&store);
+    TEST_ASSERT_NULL(WarmRestart_latest(&store, BUILD_ID));
+    for (size_t i = 0; i < sizeof(store.slots[0].ticket.keys.c2vEnc); i++)
+        TEST_ASSERT_EQUAL_HEX8(0, store.slots[0].ticket.keys.c2vEnc[i]);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Store Tests
+    RUN_TEST(test_garbage_has_no_record);
+    RUN_TEST(test_write_then_read_back);
+    RUN_TEST(test_newest_slot_wins);
+    RUN_TEST(test_sequence_wraps);
+
+    // Integrity Tests
+    RUN_TEST(test_torn_write_falls_back_to_older_slot);
+    RUN_TEST(test_other_build_is_ignored);
+    RUN_TEST(test_layout_version_checked);
+    RUN_TEST(test_clear_wipes_keys);
+
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+/**
+ * Unit Tests for Watchdog
+ * Tests per-slot deadlines, arming on first check-in, the blackout grace
+ * and the post-mortem record
+ *
+ * @file test_Watchdog.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "Watchdog.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static WatchdogTable table;
+static int control;
+static int comms;
+
+void setUp(void) {
+    Watchdog_init(&table);
+    control = Watchdog_register(&table, "control", 60);
+    comms = Watchdog_register(&table, "comms", 500);
+}
+
+void tearDown(void) {}
+
+/**
+ * Poll every WATCHDOG_POLL_MS from `from` to `to`, checking in the given
+ * slot every `period` ms (0 = never)
+ * @return First overdue slot, -1 if none
+ */
+static int run(uint32_t from, uint32_t to, int slot, uint32_t period) {
+    for (uint32_t t = from; t <= to; t += WATCHDOG_POLL_MS) {
+        if (period && (t - from) % period == 0) Watchdog_checkIn(&table, slot, t);
+        int late = Watchdog_poll(&table, t, NULL);
+        if (late >= 0) return late;
+    }
+    return -1;
+}
+
+// ============================================================================
+// Deadline Tests
+// ============================================================================
+
+void test_register_limits(void) {
+    TEST_ASSERT_EQUAL(0, control);
+    TEST_ASSERT_EQUAL(1, comms);
+    TEST_ASSERT_EQUAL(-1, Watchdog_register(&table, "zero", 0));
+    for (int i = 2; i < WATCHDOG_MAX_TASKS; i++) {
+        TEST_ASSERT_EQUAL(i, Watchdog_register(&table, "x", 10));
+    }
+    TEST_ASSERT_EQUAL(-1, Watchdog_register(&table, "full", 10));
+}
+
+void test_unarmed_slot_never_trips(void) {
+    TEST_ASSERT_EQUAL(-1, run(0, 5000, control, 0));
+}
+
+void test_live_task_does_not_trip(void) {
+    Watchdog_checkIn(&table, comms, 0);
+    for (uint32_t t = 0; t < 2000; t += 20) {
+        Watchdog_checkIn(&table, control, t);
+        if (t % 400 == 0) Watchdog_checkIn(&table, comms, t);
+        TEST_ASSERT_EQUAL(-1, Watchdog_poll(&table, t, NULL));
+    }
+    TEST_ASSERT_EQUAL_UINT32(20, table.slots[control].maxGapMs);
+}
+
+void test_stalled_task_trips_at_its_deadline(void) {
+    TEST_ASSERT_EQUAL(-1, run(0, 100, control, 20));
+    Watchdog_checkIn(&table, comms, 100);
+    // Control stops checking in at 100 ms; comms keeps going
+    uint32_t late = 0;
+    int slot = -1;
+    uint32_t t = 110;
+    for (; t < 400 && slot < 0; t += WATCHDOG_POLL_MS) {
+        Watchdog_checkIn(&table, comms, t);
+        slot = Watchdog_poll(&table, t, &late);
+    }
+    TEST_ASSERT_EQUAL(control, slot);
+    TEST_ASSERT_TRUE(late > 60 && late <= 60 + WATCHDOG_POLL_MS);
+}
+
+void test_blackout_not_charged_to_tasks(void) {
+    TEST_ASSERT_EQUAL(-1, run(0, 100, control, 20));
+    // Supervisor and task both held off 200 ms (flash erase)
+    TEST_ASSERT_EQUAL(-1, Watchdog_poll(&table, 300, NULL));
+    Watchdog_checkIn(&table, control, 305);
+    TEST_ASSERT_EQUAL(-1, run(310, 400, control, 20));
+}
+
+void test_stall_after_blackout_still_trips(void) {
+    TEST_ASSERT_EQUAL(-1, run(0, 100, control, 20));
+    TEST_ASSERT_EQUAL(-1, Watchdog_poll(&table, 300, NULL));
+    // No check-in after the blackout
+    TEST_ASSERT_EQUAL(control, run(310, 400, control, 0));
+}
+
+// ============================================================================
+// Post-Mortem Tests
+// ============================================================================
+
+void test_post_mortem_record(void) {
+    WatchdogPostMortem pm;
+    memset(&pm, 0, sizeof(pm));
+    Watchdog_recordPostMortem(&pm, &table.slots[control], WATCHDOG_CAUSE_DEADLINE, 1234, 70);
+    TEST_ASSERT_EQUAL_STRING("control", pm.task);
+    TEST_ASSERT_EQUAL_UINT32(1, pm.resetCount);
+    TEST_ASSERT_EQUAL_UINT32(70, pm.lateMs);
+    TEST_ASSERT_EQUAL_UINT32(60, pm.deadlineMs);
+    TEST_ASSERT_EQUAL_UINT32(1234, pm.uptimeMs);
+    TEST_ASSERT_TRUE(pm.pending);
+
+    // Long names truncated, count accumulates, no slot allowed
+    Watchdog_register(&table, "a_very_long_task_name", 10);
+    Watchdog_recordPostMortem(&pm, &table.slots[2], WATCHDOG_CAUSE_TWDT, 0, 0);
+    TEST_ASSERT_EQUAL(WATCHDOG_NAME_LEN - 1, (int)strlen(pm.task));
+    Watchdog_recordPostMortem(&pm, NULL, WATCHDOG_CAUSE_TWDT, 0, 0);
+    TEST_ASSERT_EQUAL_STRING("", pm.task);
+    TEST_ASSERT_EQUAL_UINT32(3, pm.resetCount);
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Deadline Tests
+    RUN_TEST(test_register_limits);
+    RUN_TEST(test_unarmed_slot_never_trips);
+    RUN_TEST(test_live_task_does_not_trip);
+    RUN_TEST(test_stalled_task_trips_at_its_deadline);
+    RUN_TEST(test_blackout_not_charged_to_tasks);
+    RUN_TEST(test_stall_after_blackout_still_trips);
+
+    // Post-Mortem Tests
+    RUN_TEST(test_post_mortem_record);
+
+    return UNITY_END();
+}
@@ -0,0 +1,103 @@
+/**
+ * Unit Tests for WebAssets
+ * Tests path lookup, If-None-Match handling and the cache policy of the
+ * embedded configurator
+ *
+ * @file test_WebAssets.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include "WebAssets.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static const uint8_t DATA_JS[] = {0x1f, 0x8b, 0x08};
+static const uint8_t DATA_INDEX[] = {0x1f, 0x8b, 0x08, 0x00};
+
+static const WebAsset TABLE[] = {
+    {"/assets/app-1a2b.js", "application/javascript", DATA_JS, sizeof(DATA_JS),
+     "\"0f668e0cbb3da393\"", true},
+    {"/index.html", "text/html", DATA_INDEX, sizeof(DATA_INDEX),
+     "\"513cd5d2fe5b69f6\"", false},
+};
+#define TABLE_COUNT (sizeof(TABLE) / sizeof(TABLE[0]))
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+// ============================================================================
+// Lookup Tests
+// ============================================================================
+
+void test_find_exact_path(void) {
+    TEST_ASSERT_EQUAL_PTR(&TABLE[0], WebAssets_find(TABLE, TABLE_COUNT, "/assets/app-1a2b.js"));
+    TEST_ASSERT_EQUAL_PTR(&TABLE[1], WebAssets_find(TABLE, TABLE_COUNT, "/index.html"));
+    TEST_ASSERT_NULL(WebAssets_find(TABLE, TABLE_COUNT, "/assets/app-1a2b.j"));
+    TEST_ASSERT_NULL(WebAssets_find(TABLE, TABLE_COUNT, "/assets/app-1a2b.js.map"));
+    TEST_ASSERT_NULL(WebAssets_find(TABLE, TABLE_COUNT, ""));
+}
+
+void test_root_and_query_string(void) {
+    TEST_ASSERT_EQUAL_PTR(&TABLE[1], WebAssets_find(TABLE, TABLE_COUNT, "/"));
+    TEST_ASSERT_EQUAL_PTR(&TABLE[1], WebAssets_find(TABLE, TABLE_COUNT, "/?ap=1"));
+    TEST_ASSERT_EQUAL_PTR(&TABLE[0], WebAssets_find(TABLE, TABLE_COUNT, "/assets/app-1a2b.js?v=3"));
+    TEST_ASSERT_NULL(WebAssets_find(TABLE, 0, "/"));
+}
+
+// ============================================================================
+// ETag Tests
+// ============================================================================
+
+void test_etag_exact_and_weak(void) {
+    const char* etag = TABLE[0].etag;
+    TEST_ASSERT_TRUE(WebAssets_etagMatches("\"0f668e0cbb3da393\"", etag));
+    TEST_ASSERT_TRUE(WebAssets_etagMatches("W/\"0f668e0cbb3da393\"", etag));
+    TEST_ASSERT_FALSE(WebAssets_etagMatches("\"0f668e0cbb3da394\"", etag));
+    TEST_ASSERT_FALSE(WebAssets_etagMatches("0f668e0cbb3da393", etag));  // Unquoted
+    TEST_ASSERT_FALSE(WebAssets_etagMatches("", etag));
+    TEST_ASSERT_FALSE(WebAssets_etagMatches(NULL, etag));
+}
+
+void test_etag_list_and_wildcard(void) {
+    const char* etag = TABLE[1].etag;
+    TEST_ASSERT_TRUE(WebAssets_etagMatches("\"aaaa\", \"513cd5d2fe5b69f6\"", etag));
+    TEST_ASSERT_TRUE(WebAssets_etagMatches("\"aaaa\" ,W/\"513cd5d2fe5b69f6\" ", etag));
+    TEST_ASSERT_FALSE(WebAssets_etagMatches("\"aaaa\", \"bbbb\"", etag));
+    TEST_ASSERT_TRUE(WebAssets_etagMatches("*", etag));
+}
+
+// ============================================================================
+// Cache Policy Tests
+// ============================================================================
+
+void test_cache_control_by_asset(void) {
+    TEST_ASSERT_EQUAL_STRING(WEB_ASSETS_CACHE_IMMUTABLE, WebAssets_cacheControl(&TABLE[0]));
+    TEST_ASSERT_EQUAL_STRING(WEB_ASSETS_CACHE_REVALIDATE, WebAssets_cacheControl(&TABLE[1]));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Lookup Tests
+    RUN_TEST(test_find_exact_path);
+    RUN_TEST(test_root_and_query_string);
+
+    // ETag Tests
+    RUN_TEST(test_etag_exact_and_weak);
+    RUN_TEST(test_etag_list_and_wildcard);
+
+    // Cache Policy Tests
+    RUN_TEST(test_cache_control_by_asset);
+
+    return UNITY_END();
+}
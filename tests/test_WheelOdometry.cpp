@@ -0,0 +1,170 @@
+/**
+ * Unit Tests for WheelOdometry
+ * Tests count to travel scaling, pose integration for straight runs,
+ * spins and arcs, and wheel speed control against a loaded motor model
+ *
+ * @file test_WheelOdometry.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "WheelOdometry.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+#define DT      0.02f
+#define PI_F    3.14159265f
+
+static WheelOdometry odo;
+static OdometryConfig config;
+static int32_t counts[ODOM_WHEELS];
+
+// Counts for a wheel travel in metres (default 120 mm wheel, 1440 per turn)
+static int32_t toCounts(float meters) {
+    return (int32_t)lroundf(meters / (PI_F * 0.12f) * 1440.0f);
+}
+
+static void drive(float left, float right, int ticks) {
+    // Per-tick wheel travel in metres
+    float l = 0.0f, r = 0.0f;
+    int32_t base[ODOM_WHEELS] = {counts[ODOM_LEFT], counts[ODOM_RIGHT]};
+    for (int i = 1; i <= ticks; i++) {
+        l += left;
+        r += right;
+        counts[ODOM_LEFT] = base[ODOM_LEFT] + toCounts(l);
+        counts[ODOM_RIGHT] = base[ODOM_RIGHT] + toCounts(r);
+        WheelOdometry_update(&odo, counts, DT);
+    }
+}
+
+void setUp(void) {
+    WheelOdometry_defaultConfig(&config);
+    WheelOdometry_init(&odo, &config);
+    counts[ODOM_LEFT] = 123456;     // Counter starts anywhere
+    counts[ODOM_RIGHT] = -98765;
+    WheelOdometry_update(&odo, counts, DT);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Odometry Tests
+// ============================================================================
+
+void test_first_reading_only_primes(void) {
+    TEST_ASSERT_TRUE(odo.primed);
+    TEST_ASSERT_EQUAL_UINT32(0, odo.samples);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, odo.x);
+}
+
+void test_straight_run(void) {
+    drive(0.01f, 0.01f, 100);                   // 0.5 m/s for 2 s
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 1.0f, odo.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.0f, odo.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, odo.speed);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.5f, odo.wheelSpeed[ODOM_LEFT]);   // Filter settled
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 1.0f, odo.distance);
+}
+
+void test_spin_in_place(void) {
+    // Quarter turn left: each wheel travels track * pi / 4
+    float arc = 0.30f * PI_F / 4.0f;
+    drive(-arc / 50.0f, arc / 50.0f, 50);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, PI_F / 2.0f, odo.heading);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.0f, odo.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.0f, odo.y);
+    TEST_ASSERT_TRUE(odo.yawRate > 0.0f);
+}
+
+void test_arc_ends_on_circle(void) {
+    // Half circle of radius 1 m to the left: left wheel on r = 0.85, right 1.15
+    drive(0.85f * PI_F / 200.0f, 1.15f * PI_F / 200.0f, 200);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.0f, odo.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 2.0f, odo.y);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, PI_F, fabsf(odo.heading));
+}
+
+void test_reset_pose(void) {
+    drive(0.01f, 0.01f, 10);
+    WheelOdometry_resetPose(&odo);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, odo.x);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, odo.distance);
+    drive(0.01f, 0.01f, 10);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.1f, odo.x);
+}
+
+// ============================================================================
+// Speed Control Tests
+// ============================================================================
+
+void test_holds_speed_under_load(void) {
+    // Motor: 2 m/s at full command, minus 0.4 m/s of load, 0.1 s lag
+    float speed = 0.0f, travel = 0.0f;
+    int32_t base = counts[ODOM_LEFT];
+    float target[ODOM_WHEELS] = {0.8f, 0.8f};
+    for (int i = 0; i < 150; i++) {
+        float out[ODOM_WHEELS];
+        WheelOdometry_control(&odo, target, DT, out);
+        speed += (2.0f * out[ODOM_LEFT] - 0.4f - speed) * (DT / 0.1f);
+        travel += speed * DT;
+        counts[ODOM_LEFT] = counts[ODOM_RIGHT] = base + toCounts(travel);
+        WheelOdometry_update(&odo, counts, DT);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, 0.8f, speed);
+}
+
+void test_stopped_drops_integrator(void) {
+    odo.pid[ODOM_LEFT].integral = 0.3f;
+    float target[ODOM_WHEELS] = {0.0f, 0.0f};
+    float out[ODOM_WHEELS];
+    WheelOdometry_control(&odo, target, DT, out);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, out[ODOM_LEFT]);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, odo.pid[ODOM_LEFT].integral);
+}
+
+void test_open_loop_passthrough(void) {
+    config.speedControl = false;
+    WheelOdometry_setConfig(&odo, &config);
+    float target[ODOM_WHEELS] = {0.75f, -3.0f};
+    float out[ODOM_WHEELS];
+    WheelOdometry_control(&odo, target, DT, out);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, out[ODOM_LEFT]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -1.0f, out[ODOM_RIGHT]);
+}
+
+void test_sanitize(void) {
+    OdometryConfig c = config;
+    c.countsPerRev = 0.0f;
+    c.trackWidthM = -1.0f;
+    c.kff = 5.0f;
+    WheelOdometry_sanitize(&c);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, c.countsPerRev);
+    TEST_ASSERT_EQUAL_FLOAT(0.05f, c.trackWidthM);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, c.kff);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Odometry Tests
+    RUN_TEST(test_first_reading_only_primes);
+    RUN_TEST(test_straight_run);
+    RUN_TEST(test_spin_in_place);
+    RUN_TEST(test_arc_ends_on_circle);
+    RUN_TEST(test_reset_pose);
+
+    // Speed Control Tests
+    RUN_TEST(test_holds_speed_under_load);
+    RUN_TEST(test_stopped_drops_integrator);
+    RUN_TEST(test_open_loop_passthrough);
+    RUN_TEST(test_sanitize);
+
+    return UNITY_END();
+}
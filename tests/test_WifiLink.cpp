@@ -0,0 +1,125 @@
+/**
+ * Unit Tests for WifiLink
+ * Tests configuration defaults and sanitizing, the mode names and the
+ * STA reconnect backoff
+ *
+ * @file test_WifiLink.cpp
+ * @framework Unity Test Framework (PlatformIO)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "WifiLink.h"
+
+// ============================================================================
+// Test Fixtures
+// ============================================================================
+
+static WifiLinkConfig config;
+
+void setUp(void) {
+    WifiLink_defaults(&config);
+}
+
+void tearDown(void) {}
+
+// ============================================================================
+// Configuration Tests
+// ============================================================================
+
+void test_defaults_keep_espnow_low_latency(void) {
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_ESPNOW, config.mode);
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_DEFAULT_CHANNEL, config.channel);
+    TEST_ASSERT_EQUAL_UINT8(1, config.lowLatency);
+    TEST_ASSERT_TRUE(WifiLink_sanitize(&config));
+}
+
+void test_sanitize_clamps(void) {
+    config.channel = 14;
+    config.txPower = 200;
+    config.lowLatency = 7;
+    TEST_ASSERT_TRUE(WifiLink_sanitize(&config));
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_DEFAULT_CHANNEL, config.channel);
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_TX_POWER_MAX, config.txPower);
+    TEST_ASSERT_EQUAL_UINT8(1, config.lowLatency);
+
+    config.txPower = 0;
+    WifiLink_sanitize(&config);
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_TX_POWER_MIN, config.txPower);
+}
+
+void test_ap_requires_wpa2_password(void) {
+    config.mode = WIFI_LINK_AP;
+    TEST_ASSERT_FALSE(WifiLink_sanitize(&config));      // Open AP refused
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_ESPNOW, config.mode);
+
+    config.mode = WIFI_LINK_AP;
+    strcpy(config.pass, "short");
+    TEST_ASSERT_FALSE(WifiLink_sanitize(&config));
+
+    config.mode = WIFI_LINK_AP;
+    strcpy(config.pass, "vehicle-ws");
+    TEST_ASSERT_TRUE(WifiLink_sanitize(&config));
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_AP, config.mode);
+}
+
+void test_sta_requires_network(void) {
+    config.mode = WIFI_LINK_STA;
+    TEST_ASSERT_FALSE(WifiLink_sanitize(&config));
+    TEST_ASSERT_EQUAL_UINT8(WIFI_LINK_ESPNOW, config.mode);
+
+    config.mode = WIFI_LINK_STA;
+    strcpy(config.ssid, "field-net");
+    TEST_ASSERT_TRUE(WifiLink_sanitize(&config));       // Open network allowed
+}
+
+void test_sanitize_terminates_strings(void) {
+    memset(config.ssid, 'A', sizeof(config.ssid));
+    memset(config.pass, 'B', sizeof(config.pass));
+    config.mode = WIFI_LINK_AP;
+    TEST_ASSERT_TRUE(WifiLink_sanitize(&config));
+    TEST_ASSERT_EQUAL(WIFI_LINK_SSID_MAX, strlen(config.ssid));
+    TEST_ASSERT_EQUAL(WIFI_LINK_PASS_MAX, strlen(config.pass));
+}
+
+// ============================================================================
+// Helper Tests
+// ============================================================================
+
+void test_mode_names(void) {
+    WifiLinkMode mode;
+    TEST_ASSERT_TRUE(WifiLink_parseMode("AP", &mode));
+    TEST_ASSERT_EQUAL(WIFI_LINK_AP, mode);
+    TEST_ASSERT_TRUE(WifiLink_parseMode("sta", &mode));
+    TEST_ASSERT_EQUAL_STRING("sta", WifiLink_modeName(mode));
+    TEST_ASSERT_FALSE(WifiLink_parseMode("mesh", &mode));
+    TEST_ASSERT_FALSE(WifiLink_parseMode(NULL, &mode));
+}
+
+void test_retry_backoff(void) {
+    TEST_ASSERT_EQUAL_UINT32(WIFI_LINK_RETRY_MIN_MS, WifiLink_retryDelayMs(0));
+    TEST_ASSERT_EQUAL_UINT32(2 * WIFI_LINK_RETRY_MIN_MS, WifiLink_retryDelayMs(1));
+    TEST_ASSERT_EQUAL_UINT32(WIFI_LINK_RETRY_MAX_MS, WifiLink_retryDelayMs(10));
+    TEST_ASSERT_EQUAL_UINT32(WIFI_LINK_RETRY_MAX_MS, WifiLink_retryDelayMs(255));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Configuration Tests
+    RUN_TEST(test_defaults_keep_espnow_low_latency);
+    RUN_TEST(test_sanitize_clamps);
+    RUN_TEST(test_ap_requires_wpa2_password);
+    RUN_TEST(test_sta_requires_network);
+    RUN_TEST(test_sanitize_terminates_strings);
+
+    // Helper Tests
+    RUN_TEST(test_mode_names);
+    RUN_TEST(test_retry_backoff);
+
+    return UNITY_END();
+}
@@ -0,0 +1,334 @@
+#!/usr/bin/env python3
+"""Decode blackbox logs on the host: flight summary and CSV export.
+
+Usage: blackbox.py LOG [--session N] [--from MS] [--to MS] [--csv OUT]
+
+LOG is a /log/flight download or a /log/raw image. Without --csv, prints
+one line per flight: sectors, records, time span, bytes on flash against
+raw records (the compression of PACKED sectors) and sectors skipped for a
+bad CRC. --csv writes the records of one session ("-" for stdout), named
+by the session's SCHEMA sector. --from / --to select by time_ms: PACKED
+sectors outside the range are skipped on their block header alone.
+
+Also a library: read_log() and decode_sector() for other tools. The
+format is src/Blackbox.h, the bit stream src/BlackboxCodec.h.
+"""
+import argparse
+import csv
+import struct
+import sys
+
+SECTOR_SIZE = 4096
+MAGIC = 0x4242414E
+VERSION = 3
+
+KIND_SCHEMA = 1
+KIND_DATA = 2
+KIND_PACKED = 3
+
+HEADER = struct.Struct("<IIHBBBBH")     # BlackboxSectorHeader
+BLOCK = struct.Struct("<HHII")          # BlackboxBlockHeader
+FIELD = struct.Struct("<10sBB")         # BlackboxField
+
+# BLACKBOX_TYPE_* -> (struct format, signed)
+TYPES = {
+    1: ("B", False),
+    2: ("b", True),
+    3: ("H", False),
+    4: ("h", True),
+    5: ("I", False),
+    6: ("i", True),
+    7: ("f", False),
+}
+TYPE_F32 = 7
+
+
+def crc16(data):
+    """NA_CRC16: CCITT, init 0xFFFF, no final xor."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+    return crc
+
+
+class Sector:
+    def __init__(self, index, raw):
+        (self.magic, self.sequence, self.session, self.kind, self.count,
+         self.version, self.record_size, self.crc) = HEADER.unpack_from(raw)
+        self.index = index
+        self.raw = raw
+        self.block = BLOCK.unpack_from(raw, HEADER.size) if self.kind == KIND_PACKED else None
+
+    def payload_size(self):
+        if self.kind == KIND_SCHEMA:
+            return self.count * FIELD.size
+        if self.kind == KIND_PACKED:
+            return BLOCK.size + self.block[1]
+        return self.count * self.record_size
+
+    def valid(self):
+        if self.magic != MAGIC or self.version != VERSION:
+            return False
+        if self.kind not in (KIND_SCHEMA, KIND_DATA, KIND_PACKED):
+            return False
+        size = self.payload_size()
+        if HEADER.size + size > SECTOR_SIZE:
+            return False
+        return crc16(self.raw[HEADER.size:HEADER.size + size]) == self.crc
+
+    def span(self, schema):
+        """(records, first_ms, last_ms) without decoding a PACKED block."""
+        if self.kind == KIND_PACKED:
+            return self.block[0], self.block[2], self.block[3]
+        if self.count == 0:
+            return 0, None, None
+        first = struct.unpack_from("<I", self.raw, HEADER.size)[0]
+        last = struct.unpack_from("<I", self.raw, HEADER.size + (self.count - 1) * self.record_size)[0]
+        return self.count, first, last
+
+
+def parse_schema(sector):
+    """[(name, type, count)] of a SCHEMA sector."""
+    fields = []
+    for i in range(sector.count):
+        name, kind, count = FIELD.unpack_from(sector.raw, HEADER.size + i * FIELD.size)
+        fields.append((name.split(b"\0")[0].decode(), kind, count))
+    return fields
+
+
+def record_size(schema):
+    return sum(struct.calcsize(TYPES[t][0]) * n for _, t, n in schema)
+
+
+def columns(schema):
+    out = []
+    for name, _, n in schema:
+        out += [name] if n == 1 else ["%s_%d" % (name, i) for i in range(n)]
+    return out
+
+
+# ============================================================================
+# PACKED bit stream (BlackboxCodec.cpp)
+# ============================================================================
+
+class Bits:
+    def __init__(self, data):
+        self.value = int.from_bytes(data, "big")
+        self.length = len(data) * 8
+        self.pos = 0
+
+    def read(self, n):
+        if self.pos + n > self.length:
+            raise EOFError
+        self.pos += n
+        return (self.value >> (self.length - self.pos)) & ((1 << n) - 1)
+
+    def varint(self):
+        out = 0
+        for shift in range(0, 35, 7):
+            byte = self.read(8)
+            out |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return out & 0xFFFFFFFF
+        raise EOFError
+
+    def bucket(self):
+        ones = 0
+        while ones < 4 and self.read(1):
+            ones += 1
+        return 0 if ones == 0 else self.read((4, 8, 16, 32)[ones - 1])
+
+
+def unzigzag(z):
+    return ((z >> 1) ^ -(z & 1)) & 0xFFFFFFFF
+
+
+def to_value(v, kind):
+    fmt, signed = TYPES[kind]
+    size = struct.calcsize(fmt)
+    raw = (v & ((1 << (8 * size)) - 1)).to_bytes(size, "little")
+    return struct.unpack("<" + fmt, raw)[0]
+
+
+def decode_block(schema, data, count):
+    """Records of a PACKED block as lists of values; stops at a truncated one."""
+    kinds = [t for _, t, n in schema for _ in range(n)]
+    prev = [0] * len(kinds)
+    lead = [None] * len(kinds)
+    trail = [0] * len(kinds)
+    prev_delta = 0
+    bits = Bits(data)
+    records = []
+    try:
+        for r in range(count):
+            for k, kind in enumerate(kinds):
+                if r == 0:
+                    if kind == TYPE_F32:
+                        v = bits.read(32)
+                    else:
+                        v = bits.varint()
+                        if TYPES[kind][1]:
+                            v = unzigzag(v)
+                elif kind == TYPE_F32:
+                    if not bits.read(1):
+                        x = 0
+                    elif not bits.read(1):
+                        if lead[k] is None:
+                            raise EOFError
+                        x = bits.read(32 - lead[k] - trail[k]) << trail[k]
+                    else:
+                        lz = bits.read(5)
+                        length = bits.read(5) + 1
+                        if lz + length > 32:
+                            raise EOFError
+                        lead[k], trail[k] = lz, 32 - lz - length
+                        x = bits.read(length) << trail[k]
+                    v = prev[k] ^ x
+                elif k == 0:
+                    prev_delta = (prev_delta + unzigzag(bits.bucket())) & 0xFFFFFFFF
+                    v = (prev[k] + prev_delta) & 0xFFFFFFFF
+                else:
+                    v = (prev[k] + unzigzag(bits.bucket())) & 0xFFFFFFFF
+                prev[k] = v
+            records.append(list(prev))
+    except EOFError:
+        pass
+    return [[to_value(v, kind) for v, kind in zip(rec, kinds)] for rec in records]
+
+
+def decode_sector(sector, schema):
+    """Records of a DATA or PACKED sector as lists of values."""
+    if sector.kind == KIND_PACKED:
+        count, size = sector.block[0], sector.block[1]
+        start = HEADER.size + BLOCK.size
+        return decode_block(schema, sector.raw[start:start + size], count)
+    fmt = "<" + "".join(TYPES[t][0] * n for _, t, n in schema)
+    return [list(struct.unpack_from(fmt, sector.raw, HEADER.size + i * sector.record_size))
+            for i in range(sector.count)]
+
+
+# ============================================================================
+# Log
+# ============================================================================
+
+def read_log(data):
+    """Valid sectors grouped by session, in write order; and the bad count.
+
+    Returns ({session: [Sector]}, {session: schema}, skipped).
+    """
+    sessions, schemas, skipped = {}, {}, 0
+    for i in range(len(data) // SECTOR_SIZE):
+        sector = Sector(i, data[i * SECTOR_SIZE:(i + 1) * SECTOR_SIZE])
+        if sector.magic != MAGIC:
+            continue    # Erased
+        if not sector.valid():
+            skipped += 1
+            continue
+        if sector.kind == KIND_SCHEMA:
+            schemas[sector.session] = parse_schema(sector)
+        else:
+            sessions.setdefault(sector.session, []).append(sector)
+    for sectors in sessions.values():
+        sectors.sort(key=lambda s: s.sequence)
+    return sessions, schemas, skipped
+
+
+def schema_for(session, sectors, schemas):
+    """The session's schema, else another one of the same record size."""
+    if session in schemas:
+        return schemas[session]
+    size = sectors[0].record_size
+    for other in sorted(schemas, reverse=True):
+        if record_size(schemas[other]) == size:
+            return schemas[other]
+    return None
+
+
+def in_range(first, last, lo, hi):
+    return first is not None and (lo is None or last >= lo) and (hi is None or first <= hi)
+
+
+def summary(session, sectors, schema):
+    records, first, last, flash, packed = 0, None, None, 0, 0
+    for s in sectors:
+        n, a, b = s.span(schema)
+        records += n
+        first = a if first is None else first
+        last = b if b is not None else last
+        flash += HEADER.size + s.payload_size()
+        packed += s.kind == KIND_PACKED
+    raw = records * sectors[0].record_size
+    return {
+        "s": session,
+        "sectors": len(sectors),
+        "packed": packed,
+        "schema": schema is not None,
+        "rec": records,
+        "start_ms": first,
+        "end_ms": last,
+        "bytes": flash,
+        "raw": raw,
+        "ratio": round(raw / flash, 2) if flash else 0,
+    }
+
+
+def write_csv(out, sectors, schema, lo, hi):
+    writer = csv.writer(out)
+    writer.writerow(columns(schema))
+    rows = 0
+    for s in sectors:
+        n, first, last = s.span(schema)
+        if not in_range(first, last, lo, hi):
+            continue
+        for rec in decode_sector(s, schema):
+            if (lo is None or rec[0] >= lo) and (hi is None or rec[0] <= hi):
+                writer.writerow(rec)
+                rows += 1
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log")
+    parser.add_argument("--session", type=int)
+    parser.add_argument("--from", dest="lo", type=int, metavar="MS")
+    parser.add_argument("--to", dest="hi", type=int, metavar="MS")
+    parser.add_argument("--csv", metavar="OUT")
+    args = parser.parse_args()
+
+    with open(args.log, "rb") as f:
+        data = f.read()
+    sessions, schemas, skipped = read_log(data)
+    if args.session is not None:
+        sessions = {k: v for k, v in sessions.items() if k == args.session}
+    if not sessions:
+        sys.exit("no flight found")
+
+    if args.csv is None:
+        for session in sorted(sessions):
+            info = summary(session, sessions[session], schema_for(session, sessions[session], schemas))
+            print(" ".join("%s=%s" % kv for kv in info.items()))
+        print("skipped=%d" % skipped)
+        return 0
+
+    if len(sessions) > 1:
+        sys.exit("several flights in the log: pick one with --session (%s)"
+                 % ", ".join(str(s) for s in sorted(sessions)))
+    session, sectors = next(iter(sessions.items()))
+    schema = schema_for(session, sectors, schemas)
+    if schema is None:
+        sys.exit("no schema for session %d" % session)
+    if args.csv == "-":
+        rows = write_csv(sys.stdout, sectors, schema, args.lo, args.hi)
+    else:
+        with open(args.csv, "w", newline="") as out:
+            rows = write_csv(out, sectors, schema, args.lo, args.hi)
+    print("%d records, %d sectors skipped" % (rows, skipped), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Fail the firmware build if a hot-path symbol was placed in flash.
+
+Usage: check_iram.py [--nm NM] [--chip esp32|esp32s3] firmware.elf
+       (the board envs run it after linking, as a post extra_script)
+
+Functions marked HOT_IRAM (src/HotPath.h) must link into internal IRAM and
+tables marked HOT_DRAM into internal DRAM; a missing IRAM_ATTR, a header
+that drops the macro, or -ffunction-sections moving a copy into .text
+would put them back behind the flash cache without any other symptom.
+Symbols that are absent were inlined into their (checked) callers and
+are skipped. Builds with -DHOT_PATH_IRAM=0 are not checked.
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+# Internal (IRAM, DRAM) windows per chip (technical reference manuals:
+# ESP32 1.3.2, ESP32-S3 4.3.2)
+WINDOWS = {
+    "esp32": ((0x40070000, 0x400C0000), (0x3FF80000, 0x40000000)),
+    "esp32s3": ((0x40370000, 0x403E0000), (0x3FC88000, 0x3FD00000)),
+}
+
+# Demangled name prefixes (nm -C)
+HOT_IRAM = [
+    "Motor::prepare(",
+    "Motor::setSpeed(",
+    "Motor::setSpeeds(",
+    "Motor::applyDeadband(",
+    "Motor::applyRamping(",
+    "Motor::prepareNow(",
+    "Motor::queueOutput(",
+    "MotorBatch::MotorBatch(",
+    "MotorBatch::setPin(",
+    "MotorBatch::setDuty(",
+    "MotorBatch::commit(",
+    "Crc16_update(",
+    "HAL_PWMEmergencyStop(",
+    "LeakDetector_edge(",
+    "LeakDetector_confirm(",
+    "Sub::surfaceNow(",
+]
+HOT_DRAM = [
+    "CRC16_TABLE",
+]
+
+
+def read_symbols(nm, elf):
+    """Demangled name -> address of every defined symbol."""
+    out = subprocess.run([nm, "-C", "--defined-only", elf], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        parts = line.split(" ", 2)
+        if len(parts) == 3:
+            try:
+                symbols[parts[2]] = int(parts[0], 16)
+            except ValueError:
+                pass
+    return symbols
+
+
+def check(symbols, chip="esp32"):
+    """Error lines for misplaced symbols (empty if all placed)."""
+    iram, dram = WINDOWS[chip]
+    errors = []
+    found = 0
+    for prefixes, (lo, hi), where in ((HOT_IRAM, iram, "IRAM"), (HOT_DRAM, dram, "DRAM")):
+        for prefix in prefixes:
+            for name, addr in symbols.items():
+                if name != prefix and not name.startswith(prefix):
+                    continue
+                found += 1
+                if not lo <= addr < hi:
+                    errors.append("%s at 0x%08x, expected %s" % (name, addr, where))
+    if found == 0:
+        errors.append("no hot-path symbol found (wrong nm or ELF?)")
+    return errors
+
+
+def run(nm, elf, chip="esp32"):
+    errors = check(read_symbols(nm, elf), chip)
+    for e in errors:
+        print("check_iram: %s" % e)
+    if not errors:
+        print("check_iram: hot paths in IRAM / DRAM")
+    return 1 if errors else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf")
+    parser.add_argument("--nm", default="xtensa-esp32-elf-nm")
+    parser.add_argument("--chip", default="esp32", choices=sorted(WINDOWS))
+    args = parser.parse_args()
+    return run(args.nm, args.elf, args.chip)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO extra_script
+except NameError:
+    env = None
+
+if env is not None:
+    def _hot_path_disabled():
+        for define in env.get("CPPDEFINES", []):
+            if isinstance(define, (tuple, list)) and define[0] == "HOT_PATH_IRAM":
+                return str(define[1]) == "0"
+        return False
+
+    def _check_iram(target, source, env):
+        nm = env.subst("$CC").replace("-gcc", "-nm")
+        chip = env.BoardConfig().get("build.mcu", "esp32")
+        return run(nm, str(target[0]), chip)
+
+    if not _hot_path_disabled():
+        env.AddPostAction(os.path.join("$BUILD_DIR", "${PROGNAME}.elf"), _check_iram)
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Embed the web configurator in the firmware as pre-gzipped assets.
+
+Usage: embed_web.py [--web DIR] OUT_HEADER
+       (env:esp32dev runs it before compiling, as a pre extra_script,
+       writing $BUILD_DIR/generated/WebAssetsData.h)
+
+Every file under web/ (the configurator's build output, e.g. the dist/
+of rn-configurator) is gzipped once here at maximum level with a zero
+timestamp, so the same input always gives the same bytes and the same
+ETag. The firmware serves the arrays straight from flash with
+Content-Encoding: gzip (src/WebAssets.h); nothing is compressed or
+copied at run time.
+
+- ETag: first 16 hex digits of SHA-256 of the gzipped bytes (strong)
+- Files under assets/ are treated as content-hashed by the bundler and
+  marked immutable; everything else (index.html) is revalidated
+- Without a web/ directory the table is empty and no route is added
+"""
+import argparse
+import gzip
+import hashlib
+import os
+import sys
+
+# Project root: __file__ is not defined when SCons runs this script
+try:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+except NameError:
+    ROOT = os.getcwd()
+WEB = os.path.join(ROOT, "web")
+
+MIME = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".mjs": "application/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".webmanifest": "application/manifest+json",
+    ".svg": "image/svg+xml",
+    ".png": "image/png",
+    ".ico": "image/x-icon",
+    ".woff2": "font/woff2",
+    ".txt": "text/plain",
+}
+SKIP = (".gz", ".map", ".DS_Store")
+
+
+def collect(web):
+    """(url path, file path) of every asset, sorted for a stable table."""
+    files = []
+    for dirpath, _, names in os.walk(web):
+        for name in names:
+            if name.startswith(".") or name.endswith(SKIP):
+                continue
+            full = os.path.join(dirpath, name)
+            rel = os.path.relpath(full, web).replace(os.sep, "/")
+            files.append(("/" + rel, full))
+    return sorted(files)
+
+
+def compress(path):
+    with open(path, "rb") as f:
+        raw = f.read()
+    return raw, gzip.compress(raw, compresslevel=9, mtime=0)
+
+
+def c_array(name, data):
+    lines = ["static const uint8_t %s[%d] = {" % (name, len(data))]
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def render(assets):
+    out = ["// Generated by tools/embed_web.py - do not edit",
+           "#ifndef WEB_ASSETS_DATA_H",
+           "#define WEB_ASSETS_DATA_H",
+           "",
+           '#include "WebAssets.h"',
+           ""]
+    rows = []
+    for i, (url, gz, etag, immutable) in enumerate(assets):
+        ext = os.path.splitext(url)[1].lower()
+        out.append(c_array("WEB_ASSET_%d" % i, gz))
+        rows.append('    {"%s", "%s", WEB_ASSET_%d, %d, "\\"%s\\"", %s},'
+                    % (url, MIME.get(ext, "application/octet-stream"), i, len(gz), etag,
+                       "true" if immutable else "false"))
+    out.append("")
+    out.append("#define WEB_ASSET_COUNT %d" % len(assets))
+    out.append("static const WebAsset WEB_ASSETS[] = {")
+    out.extend(rows or ['    {"", "", nullptr, 0, "", false},'])
+    out.append("};")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_DATA_H")
+    return "\n".join(out) + "\n"
+
+
+def generate(web, header):
+    assets = []
+    raw_total = gz_total = 0
+    if os.path.isdir(web):
+        for url, path in collect(web):
+            raw, gz = compress(path)
+            etag = hashlib.sha256(gz).hexdigest()[:16]
+            assets.append((url, gz, etag, url.startswith("/assets/")))
+            raw_total += len(raw)
+            gz_total += len(gz)
+    text = render(assets)
+    os.makedirs(os.path.dirname(header), exist_ok=True)
+    # Leave the header untouched when nothing changed (no rebuild)
+    if os.path.isfile(header):
+        with open(header) as f:
+            if f.read() == text:
+                text = None
+    if text is not None:
+        with open(header, "w") as f:
+            f.write(text)
+    print("embed_web: %d assets, %d -> %d bytes gzipped" % (len(assets), raw_total, gz_total))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("header")
+    parser.add_argument("--web", default=WEB)
+    args = parser.parse_args()
+    return generate(args.web, args.header)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO extra_script
+except NameError:
+    env = None
+
+if env is not None:
+    _generated = os.path.join(env.subst("$BUILD_DIR"), "generated")
+    generate(os.path.join(env.subst("$PROJECT_DIR"), "web"),
+             os.path.join(_generated, "WebAssetsData.h"))
+    env.Append(CPPPATH=[_generated])
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Build and run the Unity tests on the host (env:native).
+
+Usage: native_test.py [-v] [--list] [NAME ...]
+       pio run -e native -t native_tests [TESTS="PinMap Watchdog"]
+
+NAME is a test file in tests/ with or without the test_ prefix; no NAME
+runs them all. Each tests/test_X.cpp is its own program: the runner
+follows its #includes, links the src/ (and na-shared) .cpp next to every
+header it reaches, plus the shims in tests/native/ (Arduino core,
+Preferences, HAL), Unity and the host mbedtls. Prints one line per test
+with its run time, exit status 1 if any test failed to build or pass.
+
+Unity and ArduinoJson come from env:native's lib_deps
+(.pio/libdeps/native); UNITY_DIR / ARDUINOJSON_DIR override them.
+"""
+import argparse
+import os
+import re
+import subprocess
+import sys
+import time
+
+try:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+except NameError:  # PlatformIO extra_script: run from the project dir
+    ROOT = os.getcwd()
+TESTS = os.path.join(ROOT, "tests")
+SHIMS = os.path.join(TESTS, "native")
+SRC = os.path.join(ROOT, "src")
+LIBDEPS = os.path.join(ROOT, ".pio", "libdeps", "native")
+SHARED = os.path.normpath(os.path.join(ROOT, "..", "..", "na-shared"))
+BUILD = os.path.join(ROOT, ".pio", "build", "native_tests")
+
+# Firmware entry points and the target HAL (replaced by tests/native)
+EXCLUDE = {"main.cpp", "minimal_handshake.cpp", "HAL.cpp"}
+INCLUDE_RE = re.compile(r'^\s*#\s*include\s*[<"]([^>"]+)[>"]', re.M)
+TIMEOUT_S = 60
+
+
+def source_dirs():
+    dirs = [SRC]
+    if os.path.isdir(SHARED):
+        dirs.append(SHARED)
+    return dirs
+
+
+def index_headers():
+    """Header basename -> paths, over src/ and na-shared."""
+    index = {}
+    for base in source_dirs():
+        for dirpath, _, files in os.walk(base):
+            for f in files:
+                if f.endswith((".h", ".hpp")):
+                    index.setdefault(f, []).append(os.path.join(dirpath, f))
+    return index
+
+
+def include_dirs():
+    dirs = [SHIMS, SRC, os.path.join(SRC, "drivers"), os.path.join(SRC, "vehicles")]
+    if os.path.isdir(SHARED):
+        for dirpath, _, files in os.walk(SHARED):
+            if any(f.endswith((".h", ".hpp")) for f in files):
+                dirs.append(dirpath)
+    dirs.append(os.environ.get("ARDUINOJSON_DIR", os.path.join(LIBDEPS, "ArduinoJson", "src")))
+    return dirs
+
+
+def unity_dir():
+    return os.environ.get("UNITY_DIR", os.path.join(LIBDEPS, "Unity", "src"))
+
+
+def collect_sources(test_path, headers, exclude=EXCLUDE):
+    """Module .cpp files reachable from the test (and the shims) through
+    their includes, and whether any of them uses mbedtls. A file in
+    exclude is neither linked nor followed."""
+    sources = []
+    mbedtls = False
+    seen = set()
+    pending = [test_path] + shim_sources()
+    while pending:
+        path = pending.pop()
+        if path in seen:
+            continue
+        seen.add(path)
+        with open(path, errors="replace") as f:
+            text = f.read()
+        for name in INCLUDE_RE.findall(text):
+            mbedtls = mbedtls or name.startswith("mbedtls/")
+            for header in headers.get(os.path.basename(name), []):
+                pending.append(header)
+                cpp = os.path.splitext(header)[0] + ".cpp"
+                if os.path.isfile(cpp) and os.path.basename(cpp) not in exclude:
+                    if cpp not in sources:
+                        sources.append(cpp)
+                    pending.append(cpp)
+    return sources, mbedtls
+
+
+def shim_sources():
+    return sorted(os.path.join(SHIMS, f) for f in os.listdir(SHIMS) if f.endswith(".cpp"))
+
+
+def list_tests():
+    return sorted(f[len("test_"):-len(".cpp")] for f in os.listdir(TESTS)
+                  if f.startswith("test_") and f.endswith(".cpp"))
+
+
+def build(name, headers, cxx, verbose):
+    test_path = os.path.join(TESTS, "test_%s.cpp" % name)
+    out = os.path.join(BUILD, "test_" + name)
+    cmd = [cxx, "-std=gnu++17", "-O2", "-g", "-Wall", "-DNATIVE_BUILD",
+           "-DUNITY_INCLUDE_DOUBLE"]
+    cmd += ["-I" + d for d in include_dirs() + [unity_dir()]]
+    sources, mbedtls = collect_sources(test_path, headers)
+    cmd += [test_path] + sources + shim_sources()
+    cmd += [os.path.join(unity_dir(), "unity.c"), "-o", out, "-pthread"]
+    if mbedtls:
+        cmd.append("-lmbedcrypto")
+    if verbose:
+        print(" ".join(cmd))
+    result = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return out if result.returncode == 0 else None, result.stdout
+
+
+def run(names, verbose=False, cxx=None):
+    cxx = cxx or os.environ.get("CXX", "c++")
+    if not os.path.isfile(os.path.join(unity_dir(), "unity.c")):
+        print("Unity not found in %s (pio pkg install -e native, or set UNITY_DIR)"
+              % unity_dir())
+        return 1
+    os.makedirs(BUILD, exist_ok=True)
+    headers = index_headers()
+    failed = 0
+    for name in names:
+        name = name[len("test_"):] if name.startswith("test_") else name
+        binary, log = build(name, headers, cxx, verbose)
+        if not binary:
+            print("%-24s BUILD FAILED" % name)
+            print(log)
+            failed += 1
+            continue
+        start = time.monotonic()
+        try:
+            result = subprocess.run([binary], stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                    text=True, timeout=TIMEOUT_S)
+            ok, output = result.returncode == 0, result.stdout
+        except subprocess.TimeoutExpired as e:
+            ok, output = False, (e.stdout or "") + "\n[timeout]"
+        elapsed = time.monotonic() - start
+        print("%-24s %-6s %8.3f s" % (name, "PASS" if ok else "FAIL", elapsed))
+        if verbose or not ok:
+            print(output)
+        failed += 0 if ok else 1
+    print("%d tests, %d failed" % (len(names), failed))
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("names", nargs="*")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    parser.add_argument("--list", action="store_true")
+    args = parser.parse_args()
+    if args.list:
+        print("\n".join(list_tests()))
+        return 0
+    return run(args.names or list_tests(), args.verbose)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO extra_script
+except NameError:
+    env = None
+
+if env is not None:
+    def _native_tests(target, source, env):
+        names = os.environ.get("TESTS", "").split() or list_tests()
+        return run(names, cxx=env.subst("$CXX"))
+
+    env.AddCustomTarget("native_tests", None, _native_tests,
+                        title="Native tests", description="Build and run tests/ on the host")
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Replay a blackbox flight through the control stack on the host (env:native).
+
+Usage: replay.py [-D NAME=VALUE ...] [-v] LOG [--session N] [--vehicle NAME]
+                 [--mission wp.json] [--tol PCT] [--diffs N]
+       pio run -e native -t replay REPLAY_ARGS="flight.bin --vehicle sub"
+
+src/replay_main.cpp is built like the simulator (see sitl.py) and run on
+LOG, a /log/flight download or a /log/raw image with --session. The
+remaining arguments go to the replay unchanged. -D overrides a tunable
+#define for the build, to see whether a gain change would have flown the
+log differently. Exit status 1 if the replay differs from the log past
+the tolerance, 2 if the log could not be read and 125 if the build
+failed (git bisect skips those commits): `git bisect run tools/replay.py
+LOG` finds the commit that changed how a flight is flown.
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+try:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+except NameError:  # PlatformIO extra_script: run from the project dir
+    ROOT = os.getcwd()
+sys.path.insert(0, os.path.join(ROOT, "tools"))
+import native_test  # noqa: E402
+import sitl  # noqa: E402
+
+MAIN = os.path.join(native_test.SRC, "replay_main.cpp")
+
+
+def run(args, defines=(), verbose=False, cxx=None):
+    cxx = cxx or os.environ.get("CXX", "c++")
+    binary, log = sitl.build(list(defines), cxx, verbose, main=MAIN, name="replay")
+    if not binary:
+        print("BUILD FAILED")
+        print(log)
+        return 125
+    return subprocess.run([binary] + list(args)).returncode
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        metavar="NAME=VALUE")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args, rest = parser.parse_known_args()
+    if not rest:
+        parser.error("no log given")
+    return run(rest, args.defines, args.verbose)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO extra_script
+except NameError:
+    env = None
+
+if env is not None:
+    def _replay(target, source, env):
+        args = os.environ.get("REPLAY_ARGS", "").split()
+        defines = os.environ.get("REPLAY_DEFINES", "").split()
+        return run(args, defines, cxx=env.subst("$CXX"))
+
+    env.AddCustomTarget("replay", None, _replay,
+                        title="Replay", description="Replay a blackbox flight on the host")
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Build and run the software-in-the-loop simulator (env:native).
+
+Usage: sitl.py [-D NAME=VALUE ...] [--sweep NAME=V1,V2,...] [-j N] [-v] [SCENARIO ...]
+       pio run -e native -t sitl [SCENARIOS="rover_square"] [SITL_DEFINES="NAV_YAW_KP=3"]
+
+src/sitl_main.cpp is linked like a native test (see native_test.py):
+the real vehicle classes and managers against the shims in tests/native,
+with SimModel physics in place of the hardware. SCENARIO is a JSON file
+in tools/sitl_scenarios with or without the .json; no SCENARIO runs
+them all. -D overrides a tunable #define for the whole build (NAV_YAW_KP,
+WP_RADIUS_METERS, DEPTH_KP ...); --sweep builds once per value and runs
+every scenario against each, for a side-by-side table. Each scenario's
+"expect" object holds its limits: numbers are maxima of the summary
+field, booleans must match. Exit status 1 if a build or a limit failed.
+"""
+import argparse
+import concurrent.futures
+import hashlib
+import json
+import os
+import subprocess
+import sys
+
+try:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+except NameError:  # PlatformIO extra_script: run from the project dir
+    ROOT = os.getcwd()
+sys.path.insert(0, os.path.join(ROOT, "tools"))
+import native_test  # noqa: E402
+
+SCENARIOS = os.path.join(ROOT, "tools", "sitl_scenarios")
+BUILD = os.path.join(ROOT, ".pio", "build", "sitl")
+MAIN = os.path.join(native_test.SRC, "sitl_main.cpp")
+
+# Target-only drivers the SITL does not run: the IMU task (the sim feeds
+# attitude straight to the vehicle), the RMT DShot driver (Copter uses
+# brushed outputs unless COPTER_DSHOT) and the session key code (only
+# its struct is reached, through WarmRestart.h)
+EXCLUDE = native_test.EXCLUDE | {"IMUManager.cpp", "DShotESC.cpp", "SessionKeys.cpp"}
+TIMEOUT_S = 300
+
+
+def build(defines, cxx, verbose, main=MAIN, name="sitl"):
+    """One binary per set of -D overrides, reused while the sources are unchanged.
+
+    main / name also build the other host entry points (replay.py)."""
+    tag = hashlib.sha1(" ".join([cxx] + sorted(defines)).encode()).hexdigest()[:10]
+    out = os.path.join(BUILD, name + "_" + tag)
+    cmd = [cxx, "-std=gnu++17", "-O2", "-g", "-Wall", "-DNATIVE_BUILD"]
+    cmd += ["-D" + d for d in defines]
+    cmd += ["-I" + d for d in native_test.include_dirs()]
+    sources, mbedtls = native_test.collect_sources(main, native_test.index_headers(), EXCLUDE)
+    inputs = [main] + sources + native_test.shim_sources()
+    cmd += inputs + ["-o", out, "-pthread"]
+    if mbedtls:
+        cmd.append("-lmbedcrypto")
+    if os.path.isfile(out):
+        built = os.path.getmtime(out)
+        if all(os.path.getmtime(p) < built for p in inputs + header_paths()):
+            return out, ""
+    if verbose:
+        print(" ".join(cmd))
+    os.makedirs(BUILD, exist_ok=True)
+    result = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    return out if result.returncode == 0 else None, result.stdout
+
+
+def header_paths():
+    return [p for paths in native_test.index_headers().values() for p in paths]
+
+
+def list_scenarios():
+    return sorted(f[:-len(".json")] for f in os.listdir(SCENARIOS) if f.endswith(".json"))
+
+
+def scenario_path(name):
+    if os.path.isfile(name):
+        return name
+    name = name[:-len(".json")] if name.endswith(".json") else name
+    return os.path.join(SCENARIOS, name + ".json")
+
+
+def check(summary, expect):
+    """Failed limits as 'field=value (limit)' strings."""
+    failures = []
+    for key, limit in expect.items():
+        value = summary.get(key)
+        if isinstance(limit, bool):
+            ok = value == limit
+        else:
+            ok = value is not None and value <= limit
+        if not ok:
+            failures.append("%s=%s (%s)" % (key, value, limit))
+    return failures
+
+
+def run_one(binary, path):
+    """Summary dict (None if the run produced none) and the firmware log."""
+    try:
+        result = subprocess.run([binary, path], stdout=subprocess.PIPE,
+                                stderr=subprocess.STDOUT, text=True, timeout=TIMEOUT_S)
+        log = result.stdout
+    except subprocess.TimeoutExpired as e:
+        return None, (e.stdout or "") + "\n[timeout]"
+    for line in reversed(log.splitlines()):
+        if line.startswith('{"sitl"'):
+            return json.loads(line)["sitl"], log
+    return None, log
+
+
+def run(names, defines=(), sweep=None, jobs=None, verbose=False, cxx=None):
+    cxx = cxx or os.environ.get("CXX", "c++")
+    variants = [list(defines)]
+    if sweep:
+        name, values = sweep.split("=", 1)
+        variants = [list(defines) + ["%s=%s" % (name, v)] for v in values.split(",")]
+
+    failed = 0
+    for variant in variants:
+        if variant:
+            print("== " + " ".join("-D" + d for d in variant))
+        binary, log = build(variant, cxx, verbose)
+        if not binary:
+            print("BUILD FAILED")
+            print(log)
+            failed += 1
+            continue
+        paths = [scenario_path(n) for n in names]
+        with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+            results = list(pool.map(lambda p: run_one(binary, p), paths))
+        print("%-20s %-4s %5s %8s %8s %8s %8s %8s %9s" % (
+            "scenario", "ok", "done", "time_s", "xtrk_rms", "xtrk_max", "dpth_rms",
+            "rate_rms", "speedup"))
+        for path, (summary, log) in zip(paths, results):
+            name = os.path.splitext(os.path.basename(path))[0]
+            if summary is None:
+                print("%-20s FAIL (no summary)" % name)
+                print(log)
+                failed += 1
+                continue
+            with open(path) as f:
+                expect = json.load(f).get("expect", {})
+            failures = check(summary, expect)
+            print("%-20s %-4s %5s %8.1f %8.3f %8.3f %8.3f %8.4f %8.0fx" % (
+                name, "FAIL" if failures else "PASS", "yes" if summary["complete"] else "no",
+                summary["mission_s"] if summary["complete"] else summary["sim_s"],
+                summary["xtrack_rms"], summary["xtrack_max"], summary["depth_rms"],
+                summary["rate_rms"], summary["speedup"]))
+            if failures:
+                print("    " + ", ".join(failures))
+            if verbose:
+                print(log)
+            failed += 1 if failures else 0
+    print("%d scenarios x %d builds, %d failed" % (len(names), len(variants), failed))
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("names", nargs="*")
+    parser.add_argument("-D", dest="defines", action="append", default=[],
+                        metavar="NAME=VALUE")
+    parser.add_argument("--sweep", metavar="NAME=V1,V2,...")
+    parser.add_argument("-j", "--jobs", type=int)
+    parser.add_argument("-v", "--verbose", action="store_true")
+    parser.add_argument("--list", action="store_true")
+    args = parser.parse_args()
+    if args.list:
+        print("\n".join(list_scenarios()))
+        return 0
+    return run(args.names or list_scenarios(), args.defines, args.sweep, args.jobs,
+               args.verbose)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO extra_script
+except NameError:
+    env = None
+
+if env is not None:
+    def _sitl(target, source, env):
+        names = os.environ.get("SCENARIOS", "").split() or list_scenarios()
+        defines = os.environ.get("SITL_DEFINES", "").split()
+        return run(names, defines, cxx=env.subst("$CXX"))
+
+    env.AddCustomTarget("sitl", None, _sitl,
+                        title="SITL", description="Run the simulator scenarios on the host")
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Convert a {"c":"trace_dump"} serial capture to Chrome trace JSON.
+
+Usage: trace2chrome.py capture.log > trace.json
+Open the output in chrome://tracing or https://ui.perfetto.dev
+
+Records are (uint32 cycles, uint8 event, uint8 phase, uint16 arg), little
+endian, see src/Trace.h. Each core is aligned to microseconds through its
+own (sync_cyc, sync_us) pair.
+"""
+import base64
+import json
+import struct
+import sys
+
+EVENTS = {
+    1: "radio_rx",
+    2: "rx_verify",
+    3: "control",
+    4: "nav",
+    5: "depth",
+    6: "telemetry",
+    7: "kx",
+    8: "imu_irq",
+}
+
+
+def signed32(v):
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def main(path):
+    header = None
+    chunks = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            try:
+                msg = json.loads(line)
+            except ValueError:
+                continue
+            if msg.get("c") != "trace":
+                continue
+            if "cores" in msg:
+                header = msg
+                chunks = {}
+            elif "d" in msg and header is not None:
+                chunks.setdefault(msg["core"], []).append((msg["seq"], msg["d"]))
+
+    if header is None:
+        sys.exit("no trace header found")
+
+    mhz = header["mhz"] or 1
+    events = []
+    for core, parts in chunks.items():
+        info = header["cores"][core]
+        raw = b"".join(base64.b64decode(d) for _, d in sorted(parts))
+        for cycles, ev, phase, arg in struct.iter_unpack("<IBBH", raw):
+            ts = info["sync_us"] + signed32((cycles - info["sync_cyc"]) & 0xFFFFFFFF) / mhz
+            e = {
+                "name": EVENTS.get(ev, "ev%d" % ev),
+                "ph": chr(phase),
+                "ts": ts,
+                "pid": 0,
+                "tid": core,
+            }
+            if phase == ord("i"):
+                e["s"] = "t"
+                e["args"] = {"arg": arg}
+            events.append(e)
+
+    events.sort(key=lambda e: e["ts"])
+    for core in range(len(header["cores"])):
+        events.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": core,
+                       "args": {"name": "core %d" % core}})
+    json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, sys.stdout)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    main(sys.argv[1])